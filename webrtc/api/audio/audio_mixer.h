@@ -14,6 +14,7 @@
 #include <memory>
 
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/refcount.h"
 
 namespace webrtc {
@@ -48,6 +49,17 @@ class AudioMixer : public rtc::RefCountInterface {
     // with this sample rate or higher will not cause quality loss.
     virtual int PreferredSampleRate() const = 0;
 
+    // Returns the level of the latest received audio in -dBov, as carried by
+    // the RTP audio level header extension (RFC 6464): 0 is the loudest and
+    // 127 the quietest level. Returns an empty value if the level isn't
+    // known. A mixer may use the level to skip calling
+    // GetAudioFrameWithInfo() when the source can't be among the mixed ones,
+    // so sources that return a level must cope with not being asked for
+    // audio every 10 ms.
+    virtual rtc::Optional<int> LatestReceivedAudioLevel() const {
+      return rtc::Optional<int>();
+    }
+
     virtual ~Source() {}
   };
 
@@ -16,6 +16,7 @@
 
 #include "webrtc/common_types.h"
 #include "webrtc/modules/audio_coding/codecs/opus/audio_decoder_opus.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_state_pool.h"
 #include "webrtc/rtc_base/ptr_util.h"
 
 namespace webrtc {
@@ -56,7 +57,8 @@ void AudioDecoderOpus::AppendSupportedDecoders(
 
 std::unique_ptr<AudioDecoder> AudioDecoderOpus::MakeAudioDecoder(
     Config config) {
-  return rtc::MakeUnique<AudioDecoderOpusImpl>(config.num_channels);
+  return rtc::MakeUnique<AudioDecoderOpusImpl>(config.num_channels,
+                                               OpusStatePool::Default());
 }
 
 }  // namespace webrtc
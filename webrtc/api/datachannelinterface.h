@@ -91,6 +91,9 @@ class DataChannelObserver {
   virtual void OnMessage(const DataBuffer& buffer) = 0;
   // The data channel's buffered_amount has changed.
   virtual void OnBufferedAmountChange(uint64_t previous_amount) {}
+  // The data channel's buffered_amount has dropped from above its
+  // buffered_amount_low_threshold to at or below it.
+  virtual void OnBufferedAmountLow() {}
 
  protected:
   virtual ~DataChannelObserver() {}
@@ -160,6 +163,14 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // the SCTP level. See comment above Send below.
   virtual uint64_t buffered_amount() const = 0;
 
+  // C++ version of RTCDataChannel.bufferedAmountLowThreshold. When
+  // buffered_amount() drops to this value or below, OnBufferedAmountLow is
+  // called, so that an application can keep buffered_amount() between this
+  // and a high watermark of its own without polling. Defaults to 0.
+  // TODO(deadbeef): Make these pure virtual once all classes implement them.
+  virtual uint64_t buffered_amount_low_threshold() const { return 0; }
+  virtual void SetBufferedAmountLowThreshold(uint64_t threshold) {}
+
   // Begins the graceful data channel closing procedure. See:
   // https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.7
   virtual void Close() = 0;
@@ -169,9 +180,9 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // up to a maximum of 16MB. If Send is called while this buffer is full, the
   // data channel will be closed abruptly.
   //
-  // So, it's important to use buffered_amount() and OnBufferedAmountChange to
-  // ensure the data channel is used efficiently but without filling this
-  // buffer.
+  // So, it's important to use buffered_amount() and OnBufferedAmountChange, or
+  // OnBufferedAmountLow, to ensure the data channel is used efficiently but
+  // without filling this buffer.
   virtual bool Send(const DataBuffer& buffer) = 0;
 
  protected:
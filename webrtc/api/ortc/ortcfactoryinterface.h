@@ -14,6 +14,7 @@
 #include <memory>
 #include <string>
 #include <utility>  // For std::move.
+#include <vector>
 
 #include "webrtc/api/mediaconstraintsinterface.h"
 #include "webrtc/api/mediastreaminterface.h"
@@ -159,6 +160,25 @@ class OrtcFactoryInterface {
       cricket::MediaType kind,
       RtpTransportInterface* transport) = 0;
 
+  // Creates an RTP sender of type |kind| for each of |transports|. This is
+  // equivalent to calling CreateRtpSender for each transport, but makes a
+  // single thread hop for the whole batch, which matters when setting up many
+  // senders at once.
+  //
+  // Returns one result per transport, in the same order.
+  virtual std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpSenderInterface>>>
+  CreateRtpSenders(cricket::MediaType kind,
+                   const std::vector<RtpTransportInterface*>& transports) = 0;
+
+  // Calls Send on each of |senders| with the parameters at the same index in
+  // |parameters|, making a single thread hop for the whole batch.
+  //
+  // |senders| and |parameters| must be of the same size. Returns one error per
+  // sender, in the same order.
+  virtual std::vector<RTCError> SendBatch(
+      const std::vector<OrtcRtpSenderInterface*>& senders,
+      const std::vector<RtpParameters>& parameters) = 0;
+
   // Returns the capabilities of an RTP receiver of type |kind|. These
   // capabilities can be used to determine what RtpParameters to use to create
   // an RtpReceiver.
@@ -177,6 +197,16 @@ class OrtcFactoryInterface {
   CreateRtpReceiver(cricket::MediaType kind,
                     RtpTransportInterface* transport) = 0;
 
+  // Batch version of CreateRtpReceiver; see CreateRtpSenders.
+  virtual std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpReceiverInterface>>>
+  CreateRtpReceivers(cricket::MediaType kind,
+                     const std::vector<RtpTransportInterface*>& transports) = 0;
+
+  // Batch version of OrtcRtpReceiverInterface::Receive; see SendBatch.
+  virtual std::vector<RTCError> ReceiveBatch(
+      const std::vector<OrtcRtpReceiverInterface*>& receivers,
+      const std::vector<RtpParameters>& parameters) = 0;
+
   // Create a UDP transport with IP address family |family|, using a port
   // within the specified range.
   //
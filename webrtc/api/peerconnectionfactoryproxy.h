@@ -66,6 +66,9 @@ BEGIN_SIGNALING_PROXY_MAP(PeerConnectionFactory)
                 CreateAudioTrack, const std::string&,  AudioSourceInterface*)
   PROXY_METHOD2(bool, StartAecDump, rtc::PlatformFile, int64_t)
   PROXY_METHOD0(void, StopAecDump)
+  PROXY_METHOD0(void, StartThreadCpuAccounting)
+  PROXY_METHOD0(void, StopThreadCpuAccounting)
+  PROXY_METHOD0(std::vector<rtc::ThreadCpuStats>, GetThreadCpuStats)
   // TODO(ivoc): Remove the StartRtcEventLog and StopRtcEventLog functions as
   // soon as they are removed from PeerConnectionFactoryInterface.
   PROXY_METHOD1(bool, StartRtcEventLog, rtc::PlatformFile)
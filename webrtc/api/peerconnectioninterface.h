@@ -68,6 +68,7 @@
 #define WEBRTC_API_PEERCONNECTIONINTERFACE_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -95,6 +96,7 @@
 #include "webrtc/rtc_base/rtccertificategenerator.h"
 #include "webrtc/rtc_base/socketaddress.h"
 #include "webrtc/rtc_base/sslstreamadapter.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
 
 namespace rtc {
 class SSLIdentity;
@@ -620,6 +622,22 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
   // break third party projects. As soon as they have been updated this should
   // be changed to "= 0;".
   virtual void GetStats(RTCStatsCollectorCallback* callback) {}
+  // Delivers reports of the stats of |stats_types|, e.g.
+  // RTCInboundRTPStreamStats::kType, or of all types if it's empty, to
+  // |callback| every |interval_ms|. If |stats_ids| isn't empty, only the stats
+  // with these IDs are included. Only the subscribed stats are gathered, and a
+  // report only has the stats that are new or have changed since the previous
+  // report to |callback|; it isn't delivered at all if none have. Subscribing
+  // a subscribed |callback| replaces its subscription. Returns false if
+  // |interval_ms| isn't positive.
+  // TODO(hbos): Make pure virtual when third party projects implement it.
+  virtual bool SubscribeStats(RTCStatsCollectorCallback* callback,
+                              const std::set<std::string>& stats_types,
+                              const std::set<std::string>& stats_ids,
+                              int interval_ms) {
+    return false;
+  }
+  virtual void UnsubscribeStats(RTCStatsCollectorCallback* callback) {}
 
   // Create a data channel with the provided config, or default config if none
   // is provided. Note that an offer/answer negotiation is still necessary
@@ -923,6 +941,13 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
 
     // Sets crypto related options, e.g. enabled cipher suites.
     rtc::CryptoOptions crypto_options;
+
+    // If positive, this many DTLS certificates of |certificate_pool_key_type|
+    // are generated ahead of time and refilled in the background, so that
+    // PeerConnections created in a burst don't each wait for one. Only used
+    // by PeerConnections created without a certificate generator.
+    int certificate_pool_size = 0;
+    rtc::KeyType certificate_pool_key_type = rtc::KT_DEFAULT;
   };
 
   // Set the options to be used for subsequently created PeerConnections.
@@ -1024,6 +1049,17 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
   // Stops logging the AEC dump.
   virtual void StopAecDump() = 0;
 
+  // Starts accounting the CPU time spent by the threads, task queues and
+  // process threads of WebRTC running their tasks, to see which of them are
+  // saturated. The accounting is process wide, so it's shared by all factories.
+  virtual void StartThreadCpuAccounting() {}
+
+  // Stops accounting CPU time. What has been accounted so far is kept.
+  virtual void StopThreadCpuAccounting() {}
+
+  // Returns the CPU time accounted per thread name, busiest first.
+  virtual std::vector<rtc::ThreadCpuStats> GetThreadCpuStats() { return {}; }
+
   // This function is deprecated and will be removed when Chrome is updated to
   // use the equivalent function on PeerConnectionInterface.
   // TODO(ivoc) Remove after Chrome is updated.
@@ -49,6 +49,13 @@ BEGIN_SIGNALING_PROXY_MAP(PeerConnection)
                 MediaStreamTrackInterface*,
                 StatsOutputLevel)
   PROXY_METHOD1(void, GetStats, RTCStatsCollectorCallback*)
+  PROXY_METHOD4(bool,
+                SubscribeStats,
+                RTCStatsCollectorCallback*,
+                const std::set<std::string>&,
+                const std::set<std::string>&,
+                int)
+  PROXY_METHOD1(void, UnsubscribeStats, RTCStatsCollectorCallback*)
   PROXY_METHOD2(rtc::scoped_refptr<DataChannelInterface>,
                 CreateDataChannel,
                 const std::string&,
@@ -614,6 +614,8 @@ const char* StatsReport::Value::display_name() const {
       return "googTrackId";
     case kStatsValueNameTimingFrameInfo:
       return "googTimingFrameInfo";
+    case kStatsValueNameTimingFrameStageDelays:
+      return "googTimingFrameStageDelays";
     case kStatsValueNameTypingNoiseState:
       return "googTypingNoiseState";
     case kStatsValueNameWritable:
@@ -693,48 +695,53 @@ const char* StatsReport::TypeToString() const {
   return InternalTypeToString(id_->type());
 }
 
+template <typename T>
+bool StatsReport::ReuseValue(StatsValueName name, const T& value) {
+  const Value* found = FindValue(name);
+  if (found && *found == value)
+    return true;
+  Values::iterator it = previous_values_.find(name);
+  if (it == previous_values_.end() || !(*it->second == value))
+    return false;
+  values_[name] = it->second;
+  return true;
+}
+
 void StatsReport::AddString(StatsReport::StatsValueName name,
                             const std::string& value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  if (!ReuseValue(name, value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddString(StatsReport::StatsValueName name,
                             const char* value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  if (!ReuseValue(name, value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddInt64(StatsReport::StatsValueName name, int64_t value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  if (!ReuseValue(name, value))
     values_[name] = ValuePtr(new Value(name, value, Value::kInt64));
 }
 
 void StatsReport::AddInt(StatsReport::StatsValueName name, int value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == static_cast<int64_t>(value)))
+  if (!ReuseValue(name, static_cast<int64_t>(value)))
     values_[name] = ValuePtr(new Value(name, value, Value::kInt));
 }
 
 void StatsReport::AddFloat(StatsReport::StatsValueName name, float value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  if (!ReuseValue(name, value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddBoolean(StatsReport::StatsValueName name, bool value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  if (!ReuseValue(name, value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddId(StatsReport::StatsValueName name,
                         const Id& value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  if (!ReuseValue(name, value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
@@ -743,6 +750,11 @@ const StatsReport::Value* StatsReport::FindValue(StatsValueName name) const {
   return it == values_.end() ? nullptr : it->second.get();
 }
 
+void StatsReport::ResetValues() {
+  previous_values_.swap(values_);
+  values_.clear();
+}
+
 StatsCollection::StatsCollection() {
 }
 
@@ -787,14 +799,28 @@ StatsReport* StatsCollection::ReplaceOrAddNew(const StatsReport::Id& id) {
   Container::iterator it = std::find_if(list_.begin(), list_.end(),
       [&id](const StatsReport* r)->bool { return r->id()->Equals(id); });
   if (it != end()) {
-    StatsReport* report = new StatsReport((*it)->id());
-    delete *it;
-    *it = report;
+    // Reuse the report object, so that unchanged values can be reused too.
+    StatsReport* report = *it;
+    report->ResetValues();
+    report->set_timestamp(0.0);
     return report;
   }
   return InsertNew(id);
 }
 
+void StatsCollection::RemoveStale(StatsReport::StatsType type,
+                                  double timestamp) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  for (Container::iterator it = list_.begin(); it != list_.end();) {
+    if ((*it)->type() == type && (*it)->timestamp() < timestamp) {
+      delete *it;
+      it = list_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 // Looks for a report with the given |id|.  If one is not found, null
 // will be returned.
 StatsReport* StatsCollection::Find(const StatsReport::Id& id) {
@@ -218,6 +218,8 @@ class StatsReport {
     kStatsValueNameTargetDelayMs,
     kStatsValueNameTargetEncBitrate,
     kStatsValueNameTimingFrameInfo,  // Result of |TimingFrameInfo::ToString|
+    // Result of |TimingFrameStageDelays::ToString|.
+    kStatsValueNameTimingFrameStageDelays,
     kStatsValueNameTrackId,
     kStatsValueNameTransmitBitrate,
     kStatsValueNameTransportType,
@@ -383,13 +385,26 @@ class StatsReport {
 
   const Value* FindValue(StatsValueName name) const;
 
+  // Starts over with no values, for when the report is rebuilt. Values that
+  // are added again unchanged reuse the previous Value objects rather than
+  // allocating new ones.
+  void ResetValues();
+
  private:
+  // Makes the value for |name| the existing one, or the one from before
+  // ResetValues(), if that is equal to |value|. Returns false if there is no
+  // such value.
+  template <typename T>
+  bool ReuseValue(StatsValueName name, const T& value);
+
   // The unique identifier for this object.
   // This is used as a key for this report in ordered containers,
   // so it must never be changed.
   const Id id_;
   double timestamp_;  // Time since 1970-01-01T00:00:00Z in milliseconds.
   Values values_;
+  // The values from before the last ResetValues(), kept for reuse.
+  Values previous_values_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(StatsReport);
 };
@@ -423,6 +438,10 @@ class StatsCollection {
   StatsReport* FindOrAddNew(const StatsReport::Id& id);
   StatsReport* ReplaceOrAddNew(const StatsReport::Id& id);
 
+  // Removes the reports of type |type| whose timestamp is before |timestamp|,
+  // i.e. that haven't been updated since then.
+  void RemoveStale(StatsReport::StatsType type, double timestamp);
+
   // Looks for a report with the given |id|.  If one is not found, null
   // will be returned.
   StatsReport* Find(const StatsReport::Id& id);
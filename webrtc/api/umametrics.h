@@ -73,6 +73,7 @@ enum PeerConnectionMetricsName {
   kTimeToConnect,           // In milliseconds.
   kLocalCandidates_IPv4,    // Number of IPv4 local candidates.
   kLocalCandidates_IPv6,    // Number of IPv6 local candidates.
+  kDtlsHandshakeTime,       // In milliseconds, per DTLS transport.
   kPeerConnectionMetricsName_Max
 };
 
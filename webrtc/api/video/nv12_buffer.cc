@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "webrtc/api/video/nv12_buffer.h"
+
+#include <string.h>
+
+#include "libyuv/convert_from.h"
+#include "libyuv/planar_functions.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+
+// Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
+static const int kBufferAlignment = 64;
+
+namespace webrtc {
+
+NV12Buffer::NV12Buffer(int width, int height)
+    : NV12Buffer(width, height, width, 2 * ((width + 1) / 2)) {}
+
+NV12Buffer::NV12Buffer(int width, int height, int stride_y, int stride_uv)
+    : width_(width),
+      height_(height),
+      stride_y_(stride_y),
+      stride_uv_(stride_uv),
+      data_(static_cast<uint8_t*>(
+          AlignedMalloc(stride_y * height + stride_uv * ((height + 1) / 2),
+                        kBufferAlignment))) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  RTC_DCHECK_GE(stride_y, width);
+  RTC_DCHECK_GE(stride_uv, 2 * ((width + 1) / 2));
+}
+
+NV12Buffer::~NV12Buffer() {}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width, int height) {
+  return new rtc::RefCountedObject<NV12Buffer>(width, height);
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width,
+                                                  int height,
+                                                  int stride_y,
+                                                  int stride_uv) {
+  return new rtc::RefCountedObject<NV12Buffer>(width, height, stride_y,
+                                               stride_uv);
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(
+    const NV12BufferInterface& source) {
+  rtc::scoped_refptr<NV12Buffer> buffer =
+      Create(source.width(), source.height());
+  libyuv::CopyPlane(source.DataY(), source.StrideY(), buffer->MutableDataY(),
+                    buffer->StrideY(), source.width(), source.height());
+  libyuv::CopyPlane(source.DataUV(), source.StrideUV(),
+                    buffer->MutableDataUV(), buffer->StrideUV(),
+                    2 * source.ChromaWidth(), source.ChromaHeight());
+  return buffer;
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(
+    const I420BufferInterface& source) {
+  rtc::scoped_refptr<NV12Buffer> buffer =
+      Create(source.width(), source.height());
+  RTC_CHECK_EQ(0, libyuv::I420ToNV12(
+                      source.DataY(), source.StrideY(), source.DataU(),
+                      source.StrideU(), source.DataV(), source.StrideV(),
+                      buffer->MutableDataY(), buffer->StrideY(),
+                      buffer->MutableDataUV(), buffer->StrideUV(),
+                      source.width(), source.height()));
+  return buffer;
+}
+
+void NV12Buffer::InitializeData() {
+  memset(data_.get(), 0, DataSize());
+}
+
+int NV12Buffer::width() const {
+  return width_;
+}
+
+int NV12Buffer::height() const {
+  return height_;
+}
+
+const uint8_t* NV12Buffer::DataY() const {
+  return data_.get();
+}
+
+const uint8_t* NV12Buffer::DataUV() const {
+  return data_.get() + stride_y_ * height_;
+}
+
+int NV12Buffer::StrideY() const {
+  return stride_y_;
+}
+
+int NV12Buffer::StrideUV() const {
+  return stride_uv_;
+}
+
+uint8_t* NV12Buffer::MutableDataY() {
+  return const_cast<uint8_t*>(DataY());
+}
+
+uint8_t* NV12Buffer::MutableDataUV() {
+  return const_cast<uint8_t*>(DataUV());
+}
+
+size_t NV12Buffer::DataSize() const {
+  return stride_y_ * height_ + stride_uv_ * ((height_ + 1) / 2);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_API_VIDEO_NV12_BUFFER_H_
+#define WEBRTC_API_VIDEO_NV12_BUFFER_H_
+
+#include <memory>
+
+#include "webrtc/api/video/video_frame_buffer.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+// Plain NV12 buffer in standard memory.
+class NV12Buffer : public NV12BufferInterface {
+ public:
+  static rtc::scoped_refptr<NV12Buffer> Create(int width, int height);
+  static rtc::scoped_refptr<NV12Buffer> Create(int width,
+                                               int height,
+                                               int stride_y,
+                                               int stride_uv);
+
+  // Create a new buffer and copy the pixel data.
+  static rtc::scoped_refptr<NV12Buffer> Copy(const NV12BufferInterface& buffer);
+  // Create a new buffer with the pixel data of an I420 buffer.
+  static rtc::scoped_refptr<NV12Buffer> Copy(const I420BufferInterface& buffer);
+
+  // Sets both planes to all zeros.
+  void InitializeData();
+
+  int width() const override;
+  int height() const override;
+  const uint8_t* DataY() const override;
+  const uint8_t* DataUV() const override;
+
+  int StrideY() const override;
+  int StrideUV() const override;
+
+  uint8_t* MutableDataY();
+  uint8_t* MutableDataUV();
+
+ protected:
+  NV12Buffer(int width, int height);
+  NV12Buffer(int width, int height, int stride_y, int stride_uv);
+
+  ~NV12Buffer() override;
+
+ private:
+  size_t DataSize() const;
+
+  const int width_;
+  const int height_;
+  const int stride_y_;
+  const int stride_uv_;
+  const std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_API_VIDEO_NV12_BUFFER_H_
@@ -10,11 +10,28 @@
 
 #include "webrtc/api/video/video_frame.h"
 
+#include <algorithm>
+
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/timeutils.h"
 
 namespace webrtc {
 
+void VideoFrame::UpdateRect::Union(const UpdateRect& other) {
+  if (other.IsEmpty())
+    return;
+  if (IsEmpty()) {
+    *this = other;
+    return;
+  }
+  int right = std::max(offset_x + width, other.offset_x + other.width);
+  int bottom = std::max(offset_y + height, other.offset_y + other.height);
+  offset_x = std::min(offset_x, other.offset_x);
+  offset_y = std::min(offset_y, other.offset_y);
+  width = right - offset_x;
+  height = bottom - offset_y;
+}
+
 VideoFrame::VideoFrame(const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
                        webrtc::VideoRotation rotation,
                        int64_t timestamp_us)
@@ -63,4 +80,10 @@ int64_t VideoFrame::render_time_ms() const {
   return timestamp_us() / rtc::kNumMicrosecsPerMillisec;
 }
 
+VideoFrame::UpdateRect VideoFrame::update_rect() const {
+  if (update_rect_)
+    return *update_rect_;
+  return UpdateRect{0, 0, width(), height()};
+}
+
 }  // namespace webrtc
@@ -15,11 +15,24 @@
 
 #include "webrtc/api/video/video_rotation.h"
 #include "webrtc/api/video/video_frame_buffer.h"
+#include "webrtc/rtc_base/optional.h"
 
 namespace webrtc {
 
 class VideoFrame {
  public:
+  // A rectangle in pixels, e.g. the area of a frame which changed.
+  struct UpdateRect {
+    int offset_x;
+    int offset_y;
+    int width;
+    int height;
+
+    bool IsEmpty() const { return width <= 0 || height <= 0; }
+    // Makes this the smallest rectangle which covers both this and |other|.
+    void Union(const UpdateRect& other);
+  };
+
   // TODO(nisse): This constructor is consistent with the now deleted
   // cricket::WebRtcVideoFrame. We should consider whether or not we
   // want to stick to this style and deprecate the other constructor.
@@ -91,6 +104,17 @@ class VideoFrame {
   // TODO(nisse): Deprecated. Migrate all users to timestamp_us().
   int64_t render_time_ms() const;
 
+  // The area which changed since the previous frame of the same source, e.g.
+  // as found by a screen capturer. It may be empty if nothing changed. Frames
+  // without one are assumed to have changed entirely, in which case
+  // update_rect() returns the whole frame.
+  bool has_update_rect() const { return static_cast<bool>(update_rect_); }
+  UpdateRect update_rect() const;
+  void set_update_rect(const UpdateRect& update_rect) {
+    update_rect_.emplace(update_rect);
+  }
+  void clear_update_rect() { update_rect_.reset(); }
+
   // Return the underlying buffer. Never nullptr for a properly
   // initialized VideoFrame.
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> video_frame_buffer() const;
@@ -108,6 +132,7 @@ class VideoFrame {
   int64_t ntp_time_ms_;
   int64_t timestamp_us_;
   VideoRotation rotation_;
+  rtc::Optional<UpdateRect> update_rect_;
 };
 
 }  // namespace webrtc
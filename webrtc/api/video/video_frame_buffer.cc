@@ -16,6 +16,26 @@
 
 namespace webrtc {
 
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::CropAndScale(
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  rtc::scoped_refptr<I420Buffer> result =
+      I420Buffer::Create(scaled_width, scaled_height);
+  result->CropAndScaleFrom(*ToI420(), offset_x, offset_y, crop_width,
+                           crop_height);
+  return result;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::Scale(
+    int scaled_width,
+    int scaled_height) {
+  return CropAndScale(0, 0, width(), height(), scaled_width, scaled_height);
+}
+
 rtc::scoped_refptr<I420BufferInterface> VideoFrameBuffer::GetI420() {
   RTC_CHECK(type() == Type::kI420);
   return static_cast<I420BufferInterface*>(this);
@@ -37,6 +57,16 @@ const I444BufferInterface* VideoFrameBuffer::GetI444() const {
   return static_cast<const I444BufferInterface*>(this);
 }
 
+NV12BufferInterface* VideoFrameBuffer::GetNV12() {
+  RTC_CHECK(type() == Type::kNV12);
+  return static_cast<NV12BufferInterface*>(this);
+}
+
+const NV12BufferInterface* VideoFrameBuffer::GetNV12() const {
+  RTC_CHECK(type() == Type::kNV12);
+  return static_cast<const NV12BufferInterface*>(this);
+}
+
 VideoFrameBuffer::Type I420BufferInterface::type() const {
   return Type::kI420;
 }
@@ -76,4 +106,27 @@ rtc::scoped_refptr<I420BufferInterface> I444BufferInterface::ToI420() {
   return i420_buffer;
 }
 
+VideoFrameBuffer::Type NV12BufferInterface::type() const {
+  return Type::kNV12;
+}
+
+int NV12BufferInterface::ChromaWidth() const {
+  return (width() + 1) / 2;
+}
+
+int NV12BufferInterface::ChromaHeight() const {
+  return (height() + 1) / 2;
+}
+
+rtc::scoped_refptr<I420BufferInterface> NV12BufferInterface::ToI420() {
+  rtc::scoped_refptr<I420Buffer> i420_buffer =
+      I420Buffer::Create(width(), height());
+  libyuv::NV12ToI420(DataY(), StrideY(), DataUV(), StrideUV(),
+                     i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+                     i420_buffer->MutableDataU(), i420_buffer->StrideU(),
+                     i420_buffer->MutableDataV(), i420_buffer->StrideV(),
+                     width(), height());
+  return i420_buffer;
+}
+
 }  // namespace webrtc
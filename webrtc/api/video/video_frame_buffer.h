@@ -20,6 +20,7 @@ namespace webrtc {
 
 class I420BufferInterface;
 class I444BufferInterface;
+class NV12BufferInterface;
 
 // Base class for frame buffers of different types of pixel format and storage.
 // The tag in type() indicates how the data is represented, and each type is
@@ -45,6 +46,7 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
     kNative,
     kI420,
     kI444,
+    kNV12,
   };
 
   // This function specifies in what pixel format the data is stored in.
@@ -61,6 +63,23 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   // software encoders.
   virtual rtc::scoped_refptr<I420BufferInterface> ToI420() = 0;
 
+  // Returns a buffer of size |scaled_width| x |scaled_height| with the given
+  // crop rectangle of this buffer. The default implementation converts to
+  // I420 and scales right away. Native buffers should override it to record
+  // the crop and scale along with the underlying handle instead, so that e.g.
+  // a hardware encoder can scale without reading the pixels back, and only
+  // scale in ToI420().
+  virtual rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(int offset_x,
+                                                            int offset_y,
+                                                            int crop_width,
+                                                            int crop_height,
+                                                            int scaled_width,
+                                                            int scaled_height);
+
+  // Scales all of this buffer, with no cropping.
+  rtc::scoped_refptr<VideoFrameBuffer> Scale(int scaled_width,
+                                             int scaled_height);
+
   // These functions should only be called if type() is of the correct type.
   // Calling with a different type will result in a crash.
   // TODO(magjed): Return raw pointers for GetI420 once deprecated interface is
@@ -69,6 +88,8 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   rtc::scoped_refptr<const I420BufferInterface> GetI420() const;
   I444BufferInterface* GetI444();
   const I444BufferInterface* GetI444() const;
+  NV12BufferInterface* GetNV12();
+  const NV12BufferInterface* GetNV12() const;
 
  protected:
   ~VideoFrameBuffer() override {}
@@ -121,6 +142,42 @@ class I444BufferInterface : public PlanarYuvBuffer {
   ~I444BufferInterface() override {}
 };
 
+// This interface represents formats with a full resolution luma plane and one
+// plane with interleaved chroma samples, i.e. Type::kNV12.
+class BiplanarYuvBuffer : public VideoFrameBuffer {
+ public:
+  virtual int ChromaWidth() const = 0;
+  virtual int ChromaHeight() const = 0;
+
+  // Returns pointer to the pixel data for a given plane. The memory is owned by
+  // the VideoFrameBuffer object and must not be freed by the caller.
+  virtual const uint8_t* DataY() const = 0;
+  virtual const uint8_t* DataUV() const = 0;
+
+  // Returns the number of bytes between successive rows for a given plane.
+  virtual int StrideY() const = 0;
+  virtual int StrideUV() const = 0;
+
+ protected:
+  ~BiplanarYuvBuffer() override {}
+};
+
+// NV12 is the native format of many hardware capturers and decoders. The UV
+// plane has 2x2 subsampled chroma with U and V interleaved, so it has the same
+// number of bytes per row as the Y plane.
+class NV12BufferInterface : public BiplanarYuvBuffer {
+ public:
+  Type type() const final;
+
+  int ChromaWidth() const final;
+  int ChromaHeight() const final;
+
+  rtc::scoped_refptr<I420BufferInterface> ToI420() final;
+
+ protected:
+  ~NV12BufferInterface() override {}
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_API_VIDEO_VIDEO_FRAME_BUFFER_H_
@@ -75,4 +75,23 @@ std::string TimingFrameInfo::ToString() const {
   return out.str();
 }
 
+TimingFrameStageDelays::TimingFrameStageDelays()
+    : num_frames(0),
+      capture_to_encode_ms(-1),
+      encode_ms(-1),
+      packetization_ms(-1),
+      pacing_ms(-1),
+      network_ms(-1),
+      frame_buffer_ms(-1),
+      decode_ms(-1),
+      render_wait_ms(-1) {}
+
+std::string TimingFrameStageDelays::ToString() const {
+  std::stringstream out;
+  out << num_frames << ',' << capture_to_encode_ms << ',' << encode_ms << ','
+      << packetization_ms << ',' << pacing_ms << ',' << network_ms << ','
+      << frame_buffer_ms << ',' << decode_ms << ',' << render_wait_ms;
+  return out.str();
+}
+
 }  // namespace webrtc
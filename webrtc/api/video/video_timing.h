@@ -115,6 +115,27 @@ struct TimingFrameInfo {
   uint8_t flags;  // Flags indicating validity and/or why tracing was triggered.
 };
 
+// Time spent by timing frames in each stage of the send and receive pipeline,
+// in ms, averaged over all timing frames of a stream. Stages which couldn't be
+// measured are -1. Reported as a string via GetStats().
+struct TimingFrameStageDelays {
+  TimingFrameStageDelays();
+
+  std::string ToString() const;
+
+  int num_frames;            // Number of timing frames averaged.
+  int capture_to_encode_ms;  // Capture time to encode start.
+  int encode_ms;             // Encode start to encode completion.
+  int packetization_ms;      // Encode completion to passing frame to pacer.
+  int pacing_ms;             // Time in pacer queue, until last packet left.
+  // Last packet leaving the pacer to last packet received. Only measured once
+  // the sender clock is estimated.
+  int network_ms;
+  int frame_buffer_ms;  // Last packet received to decode start.
+  int decode_ms;        // Decode start to decode completion.
+  int render_wait_ms;   // Decode completion to proposed render time.
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_API_VIDEO_VIDEO_TIMING_H_
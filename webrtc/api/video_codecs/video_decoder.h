@@ -27,6 +27,17 @@ class RTPFragmentationHeader;
 struct CodecSpecificInfo;
 class VideoCodec;
 
+// Why a decoder stopped using the decoder it was created with, in favour of a
+// software fallback decoder.
+enum class DecoderFallbackReason {
+  // The decoder failed to initialize.
+  kInitDecode,
+  // The decoder failed to decode a frame.
+  kDecode,
+  // The decoder could not keep up with the frame rate of the stream.
+  kSlowDecoding,
+};
+
 class DecodedImageCallback {
  public:
   virtual ~DecodedImageCallback() {}
@@ -54,6 +65,9 @@ class DecodedImageCallback {
   }
 
   virtual int32_t ReceivedDecodedFrame(const uint64_t pictureId) { return -1; }
+
+  // Called when a wrapping decoder switches to a software fallback decoder.
+  virtual void OnDecoderFallback(DecoderFallbackReason reason) {}
 };
 
 class VideoDecoder {
@@ -270,6 +270,25 @@ void AudioSendStream::SetMuted(bool muted) {
   channel_proxy_->SetInputMute(muted);
 }
 
+bool AudioSendStream::ShareEncoderWith(const AudioSendStream* source) {
+  RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  if (!source) {
+    return channel_proxy_->SetEncodeFanoutSource(nullptr);
+  }
+  RTC_DCHECK_NE(source, this);
+  if (config_.send_codec_spec != source->config_.send_codec_spec ||
+      config_.audio_network_adaptor_config !=
+          source->config_.audio_network_adaptor_config ||
+      config_.encoder_factory != source->config_.encoder_factory) {
+    LOG(LS_WARNING) << "Stream " << config_.rtp.ssrc
+                    << " can't share the encoder of stream "
+                    << source->config_.rtp.ssrc
+                    << ": the encoder configurations differ.";
+    return false;
+  }
+  return channel_proxy_->SetEncodeFanoutSource(source->channel_proxy_.get());
+}
+
 webrtc::AudioSendStream::Stats AudioSendStream::GetStats() const {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
   webrtc::AudioSendStream::Stats stats;
@@ -75,6 +75,14 @@ class AudioSendStream final : public webrtc::AudioSendStream,
 
   void SetTransportOverhead(int transport_overhead_per_packet);
 
+  // Sends the encoded output of |source| on this stream instead of encoding
+  // the same audio again, or encodes the audio of this stream again if
+  // |source| is null. The streams must have the same send codec
+  // configuration; returns false otherwise. The encoder of |source| is the
+  // only one adapted to the network, and this stream's own encoder is idle
+  // while sharing.
+  bool ShareEncoderWith(const AudioSendStream* source);
+
   RtpState GetRtpState() const;
   const TimeInterval& GetActiveLifetime() const;
 
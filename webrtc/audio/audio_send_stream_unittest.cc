@@ -408,6 +408,17 @@ TEST(AudioSendStreamTest, SetMuted) {
   send_stream.SetMuted(true);
 }
 
+TEST(AudioSendStreamTest, ShareEncoderWith) {
+  ConfigHelper helper(false, true);
+  internal::AudioSendStream send_stream(
+      helper.config(), helper.audio_state(), helper.worker_queue(),
+      helper.transport(), helper.bitrate_allocator(), helper.event_log(),
+      helper.rtcp_rtt_stats(), rtc::Optional<RtpState>());
+  EXPECT_CALL(*helper.channel_proxy(), SetEncodeFanoutSource(nullptr))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(send_stream.ShareEncoderWith(nullptr));
+}
+
 TEST(AudioSendStreamTest, AudioBweCorrectObjectsOnChannelProxy) {
   ConfigHelper helper(true, true);
   internal::AudioSendStream send_stream(
@@ -56,7 +56,11 @@ BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
       clock_(Clock::GetRealTimeClock()),
       last_bwe_log_time_(0),
       total_requested_padding_bitrate_(0),
-      total_requested_min_bitrate_(0) {
+      total_requested_min_bitrate_(0),
+      sum_min_bitrates_(0),
+      sum_max_bitrates_(0),
+      cached_allocation_bitrate_bps_(0),
+      cached_allocation_valid_(false) {
   sequenced_checker_.Detach();
 }
 
@@ -86,8 +90,9 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
 
   ObserverAllocation allocation = AllocateBitrates(target_bitrate_bps);
 
-  for (auto& config : bitrate_observer_configs_) {
-    uint32_t allocated_bitrate = allocation[config.observer];
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    ObserverConfig& config = bitrate_observer_configs_[i];
+    uint32_t allocated_bitrate = allocation[i];
     uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
         allocated_bitrate, last_fraction_loss_, last_rtt_,
         last_bwe_period_ms_);
@@ -139,13 +144,15 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
         ObserverConfig(observer, min_bitrate_bps, max_bitrate_bps,
                        pad_up_bitrate_bps, enforce_min_bitrate));
   }
+  OnObserverConfigsChanged();
 
   ObserverAllocation allocation;
   if (last_bitrate_bps_ > 0) {
     // Calculate a new allocation and update all observers.
     allocation = AllocateBitrates(last_bitrate_bps_);
-    for (auto& config : bitrate_observer_configs_) {
-      uint32_t allocated_bitrate = allocation[config.observer];
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      ObserverConfig& config = bitrate_observer_configs_[i];
+      uint32_t allocated_bitrate = allocation[i];
       uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
           allocated_bitrate, last_fraction_loss_, last_rtt_,
           last_bwe_period_ms_);
@@ -201,6 +208,7 @@ void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
   auto it = FindObserverConfig(observer);
   if (it != bitrate_observer_configs_.end()) {
     bitrate_observer_configs_.erase(it);
+    OnObserverConfigsChanged();
   }
 
   UpdateAllocationLimits();
@@ -234,6 +242,25 @@ BitrateAllocator::FindObserverConfig(const BitrateAllocatorObserver* observer) {
   return bitrate_observer_configs_.end();
 }
 
+void BitrateAllocator::OnObserverConfigsChanged() {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  sum_min_bitrates_ = 0;
+  sum_max_bitrates_ = 0;
+  for (const auto& observer_config : bitrate_observer_configs_) {
+    sum_min_bitrates_ += observer_config.min_bitrate_bps;
+    sum_max_bitrates_ += observer_config.max_bitrate_bps;
+  }
+  max_bitrate_order_.resize(bitrate_observer_configs_.size());
+  for (size_t i = 0; i < max_bitrate_order_.size(); ++i)
+    max_bitrate_order_[i] = i;
+  std::stable_sort(max_bitrate_order_.begin(), max_bitrate_order_.end(),
+                   [this](size_t a, size_t b) {
+                     return bitrate_observer_configs_[a].max_bitrate_bps <
+                            bitrate_observer_configs_[b].max_bitrate_bps;
+                   });
+  cached_allocation_valid_ = false;
+}
+
 BitrateAllocator::ObserverAllocation BitrateAllocator::AllocateBitrates(
     uint32_t bitrate) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
@@ -243,61 +270,70 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::AllocateBitrates(
   if (bitrate == 0)
     return ZeroRateAllocation();
 
-  uint32_t sum_min_bitrates = 0;
-  uint32_t sum_max_bitrates = 0;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    sum_min_bitrates += observer_config.min_bitrate_bps;
-    sum_max_bitrates += observer_config.max_bitrate_bps;
-  }
-
   // Not enough for all observers to get an allocation, allocate according to:
   // enforced min bitrate -> allocated bitrate previous round -> restart paused
   // streams.
-  if (!EnoughBitrateForAllObservers(bitrate, sum_min_bitrates))
+  if (!EnoughBitrateForAllObservers(bitrate, sum_min_bitrates_))
     return LowRateAllocation(bitrate);
 
-  // All observers will get their min bitrate plus an even share of the rest.
-  if (bitrate <= sum_max_bitrates)
-    return NormalRateAllocation(bitrate, sum_min_bitrates);
-
-  // All observers will get up to kTransmissionMaxBitrateMultiplier x max.
-  return MaxRateAllocation(bitrate, sum_max_bitrates);
+  if (cached_allocation_valid_ && bitrate == cached_allocation_bitrate_bps_)
+    return cached_allocation_;
+
+  if (bitrate <= sum_max_bitrates_) {
+    // All observers will get their min bitrate plus an even share of the rest.
+    cached_allocation_ = NormalRateAllocation(bitrate, sum_min_bitrates_);
+  } else if (bitrate >=
+             static_cast<uint64_t>(kTransmissionMaxBitrateMultiplier) *
+                 sum_max_bitrates_) {
+    // Every observer is capped at kTransmissionMaxBitrateMultiplier x max,
+    // which is what MaxRateAllocation() would end up with too.
+    cached_allocation_.resize(bitrate_observer_configs_.size());
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      cached_allocation_[i] = kTransmissionMaxBitrateMultiplier *
+                              bitrate_observer_configs_[i].max_bitrate_bps;
+    }
+  } else {
+    // All observers will get up to kTransmissionMaxBitrateMultiplier x max.
+    cached_allocation_ = MaxRateAllocation(bitrate, sum_max_bitrates_);
+  }
+  cached_allocation_bitrate_bps_ = bitrate;
+  cached_allocation_valid_ = true;
+  return cached_allocation_;
 }
 
 BitrateAllocator::ObserverAllocation BitrateAllocator::ZeroRateAllocation() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
-  for (const auto& observer_config : bitrate_observer_configs_)
-    allocation[observer_config.observer] = 0;
-  return allocation;
+  return ObserverAllocation(bitrate_observer_configs_.size(), 0);
 }
 
 BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
     uint32_t bitrate) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
+  ObserverAllocation allocation(bitrate_observer_configs_.size());
   // Start by allocating bitrate to observers enforcing a min bitrate, hence
   // remaining_bitrate might turn negative.
   int64_t remaining_bitrate = bitrate;
-  for (const auto& observer_config : bitrate_observer_configs_) {
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    const ObserverConfig& observer_config = bitrate_observer_configs_[i];
     int32_t allocated_bitrate = 0;
     if (observer_config.enforce_min_bitrate)
       allocated_bitrate = observer_config.min_bitrate_bps;
 
-    allocation[observer_config.observer] = allocated_bitrate;
+    allocation[i] = allocated_bitrate;
     remaining_bitrate -= allocated_bitrate;
   }
 
   // Allocate bitrate to all previously active streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : bitrate_observer_configs_) {
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      const ObserverConfig& observer_config = bitrate_observer_configs_[i];
       if (observer_config.enforce_min_bitrate ||
           LastAllocatedBitrate(observer_config) == 0)
         continue;
 
       uint32_t required_bitrate = MinBitrateWithHysteresis(observer_config);
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        allocation[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -305,14 +341,15 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
 
   // Allocate bitrate to previously paused streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : bitrate_observer_configs_) {
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      const ObserverConfig& observer_config = bitrate_observer_configs_[i];
       if (LastAllocatedBitrate(observer_config) != 0)
         continue;
 
       // Add a hysteresis to avoid toggling.
       uint32_t required_bitrate = MinBitrateWithHysteresis(observer_config);
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        allocation[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -330,9 +367,9 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::NormalRateAllocation(
     uint32_t bitrate,
     uint32_t sum_min_bitrates) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
-  for (const auto& observer_config : bitrate_observer_configs_)
-    allocation[observer_config.observer] = observer_config.min_bitrate_bps;
+  ObserverAllocation allocation(bitrate_observer_configs_.size());
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i)
+    allocation[i] = bitrate_observer_configs_[i].min_bitrate_bps;
 
   bitrate -= sum_min_bitrates;
   if (bitrate > 0)
@@ -345,11 +382,10 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::MaxRateAllocation(
     uint32_t bitrate,
     uint32_t sum_max_bitrates) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
-
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    allocation[observer_config.observer] = observer_config.max_bitrate_bps;
-    bitrate -= observer_config.max_bitrate_bps;
+  ObserverAllocation allocation(bitrate_observer_configs_.size());
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    allocation[i] = bitrate_observer_configs_[i].max_bitrate_bps;
+    bitrate -= bitrate_observer_configs_[i].max_bitrate_bps;
   }
   DistributeBitrateEvenly(bitrate, true, kTransmissionMaxBitrateMultiplier,
                           &allocation);
@@ -392,31 +428,30 @@ void BitrateAllocator::DistributeBitrateEvenly(uint32_t bitrate,
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   RTC_DCHECK_EQ(allocation->size(), bitrate_observer_configs_.size());
 
-  ObserverSortingMap list_max_bitrates;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    if (include_zero_allocations ||
-        allocation->at(observer_config.observer) != 0) {
-      list_max_bitrates.insert(std::pair<uint32_t, const ObserverConfig*>(
-          observer_config.max_bitrate_bps, &observer_config));
-    }
+  uint32_t num_remaining = 0;
+  for (uint32_t allocated_bitrate : *allocation) {
+    if (include_zero_allocations || allocated_bitrate != 0)
+      ++num_remaining;
   }
-  auto it = list_max_bitrates.begin();
-  while (it != list_max_bitrates.end()) {
+  // Visit the observers in order of increasing max bitrate.
+  for (size_t index : max_bitrate_order_) {
+    uint32_t& allocated_bitrate = (*allocation)[index];
+    if (!include_zero_allocations && allocated_bitrate == 0)
+      continue;
     RTC_DCHECK_GT(bitrate, 0);
-    uint32_t extra_allocation =
-        bitrate / static_cast<uint32_t>(list_max_bitrates.size());
-    uint32_t total_allocation =
-        extra_allocation + allocation->at(it->second->observer);
+    const uint32_t max_bitrate =
+        max_multiplier * bitrate_observer_configs_[index].max_bitrate_bps;
+    uint32_t extra_allocation = bitrate / num_remaining--;
+    uint32_t total_allocation = extra_allocation + allocated_bitrate;
     bitrate -= extra_allocation;
-    if (total_allocation > max_multiplier * it->first) {
+    if (total_allocation > max_bitrate) {
       // There is more than we can fit for this observer, carry over to the
       // remaining observers.
-      bitrate += total_allocation - max_multiplier * it->first;
-      total_allocation = max_multiplier * it->first;
+      bitrate += total_allocation - max_bitrate;
+      total_allocation = max_bitrate;
     }
     // Finally, update the allocation for this observer.
-    allocation->at(it->second->observer) = total_allocation;
-    it = list_max_bitrates.erase(it);
+    allocated_bitrate = total_allocation;
   }
 }
 
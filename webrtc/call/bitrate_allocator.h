@@ -13,8 +13,6 @@
 
 #include <stdint.h>
 
-#include <map>
-#include <utility>
 #include <vector>
 
 #include "webrtc/rtc_base/sequenced_task_checker.h"
@@ -125,8 +123,14 @@ class BitrateAllocator {
   ObserverConfigs::iterator FindObserverConfig(
       const BitrateAllocatorObserver* observer);
 
-  typedef std::multimap<uint32_t, const ObserverConfig*> ObserverSortingMap;
-  typedef std::map<BitrateAllocatorObserver*, int> ObserverAllocation;
+  // The allocated bitrate of each observer, in the order of
+  // |bitrate_observer_configs_|.
+  typedef std::vector<uint32_t> ObserverAllocation;
+
+  // Updates the sums of the min and max bitrates and the order in which
+  // DistributeBitrateEvenly() visits the observers, and drops the cached
+  // allocation. Must be called whenever |bitrate_observer_configs_| changes.
+  void OnObserverConfigsChanged();
 
   ObserverAllocation AllocateBitrates(uint32_t bitrate);
 
@@ -167,6 +171,17 @@ class BitrateAllocator {
   int64_t last_bwe_log_time_ GUARDED_BY(&sequenced_checker_);
   uint32_t total_requested_padding_bitrate_ GUARDED_BY(&sequenced_checker_);
   uint32_t total_requested_min_bitrate_ GUARDED_BY(&sequenced_checker_);
+  uint32_t sum_min_bitrates_ GUARDED_BY(&sequenced_checker_);
+  uint32_t sum_max_bitrates_ GUARDED_BY(&sequenced_checker_);
+  // Indices into |bitrate_observer_configs_|, sorted by max bitrate and then
+  // by insertion order.
+  std::vector<size_t> max_bitrate_order_ GUARDED_BY(&sequenced_checker_);
+  // Above the point where every observer has its min bitrate, the allocation
+  // only depends on the estimate and the observer configs, so it is reused
+  // for as long as neither changes.
+  ObserverAllocation cached_allocation_ GUARDED_BY(&sequenced_checker_);
+  uint32_t cached_allocation_bitrate_bps_ GUARDED_BY(&sequenced_checker_);
+  bool cached_allocation_valid_ GUARDED_BY(&sequenced_checker_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_CALL_BITRATE_ALLOCATOR_H_
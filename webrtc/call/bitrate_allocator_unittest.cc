@@ -14,6 +14,7 @@
 
 #include "webrtc/call/bitrate_allocator.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 
@@ -519,4 +520,75 @@ TEST_F(BitrateAllocatorTest, PassProbingInterval) {
   allocator_->RemoveObserver(&observer);
 }
 
+TEST_F(BitrateAllocatorTest, ManyObservers) {
+  const size_t kNumObservers = 50;
+  std::vector<TestBitrateObserver> observers(kNumObservers);
+  uint32_t sum_max_bitrates = 0;
+  for (size_t i = 0; i < kNumObservers; ++i) {
+    const uint32_t max_bitrate_bps = 100000 + 20000 * ((i * 7) % 13);
+    allocator_->AddObserver(&observers[i], 30000, max_bitrate_bps, 0, true);
+    sum_max_bitrates += max_bitrate_bps;
+  }
+
+  // Below the sum of the max bitrates, all of the estimate is allocated and
+  // no observer is above its max bitrate.
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    allocator_->OnNetworkChanged(sum_max_bitrates / 2, 0, 50,
+                                 kDefaultProbingIntervalMs);
+    uint32_t sum_allocated = 0;
+    for (size_t i = 0; i < kNumObservers; ++i) {
+      EXPECT_GE(observers[i].last_bitrate_bps_, 30000u);
+      EXPECT_LE(observers[i].last_bitrate_bps_,
+                100000 + 20000 * ((i * 7) % 13));
+      sum_allocated += observers[i].last_bitrate_bps_;
+    }
+    EXPECT_NEAR(sum_max_bitrates / 2, sum_allocated, kNumObservers);
+  }
+
+  // Well above it, every observer is capped at twice its max bitrate.
+  allocator_->OnNetworkChanged(3 * sum_max_bitrates, 0, 50,
+                               kDefaultProbingIntervalMs);
+  for (size_t i = 0; i < kNumObservers; ++i) {
+    EXPECT_EQ(2 * (100000 + 20000 * ((i * 7) % 13)),
+              observers[i].last_bitrate_bps_);
+  }
+
+  // Changing the config of an observer reallocates, even if the estimate is
+  // the same.
+  allocator_->AddObserver(&observers[0], 30000, 50000, 0, true);
+  EXPECT_EQ(100000u, observers[0].last_bitrate_bps_);
+
+  for (auto& observer : observers)
+    allocator_->RemoveObserver(&observer);
+}
+
+// Measures the time of an allocation over many observers, when the estimate
+// changes with every update and when it stays the same.
+TEST_F(BitrateAllocatorTest, DISABLED_Benchmark) {
+  const size_t kNumObservers = 500;
+  const int kIterations = 20000;
+  std::vector<TestBitrateObserver> observers(kNumObservers);
+  uint32_t sum_max_bitrates = 0;
+  for (size_t i = 0; i < kNumObservers; ++i) {
+    const uint32_t max_bitrate_bps = 100000 + 1000 * (i % 100);
+    allocator_->AddObserver(&observers[i], 30000, max_bitrate_bps, 0,
+                            i % 2 == 0);
+    sum_max_bitrates += max_bitrate_bps;
+  }
+  for (bool changing_estimate : {true, false}) {
+    const int64_t start = rtc::TimeNanos();
+    for (int i = 0; i < kIterations; ++i) {
+      const uint32_t bitrate_bps =
+          sum_max_bitrates / 2 + (changing_estimate ? 1000 * (i % 100) : 0);
+      allocator_->OnNetworkChanged(bitrate_bps, 0, 50,
+                                   kDefaultProbingIntervalMs);
+    }
+    printf("%s estimate: %.1f us per update with %zu observers.\n",
+           changing_estimate ? "Changing" : "Constant",
+           (rtc::TimeNanos() - start) / 1000.0 / kIterations, kNumObservers);
+  }
+  for (auto& observer : observers)
+    allocator_->RemoveObserver(&observer);
+}
+
 }  // namespace webrtc
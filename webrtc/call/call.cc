@@ -10,6 +10,7 @@
 
 #include <string.h>
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -49,10 +50,13 @@
 #include "webrtc/rtc_base/trace_event.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/cpu_info.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/system_wrappers/include/metrics.h"
 #include "webrtc/system_wrappers/include/rw_lock_wrapper.h"
 #include "webrtc/system_wrappers/include/trace.h"
 #include "webrtc/video/call_stats.h"
+#include "webrtc/video/decode_scheduler.h"
+#include "webrtc/video/encoder_admission_controller.h"
 #include "webrtc/video/send_delay_stats.h"
 #include "webrtc/video/stats_counter.h"
 #include "webrtc/video/video_receive_stream.h"
@@ -62,6 +66,15 @@ namespace webrtc {
 
 namespace {
 
+// If enabled, the video send streams of a call share their CPU budget and
+// adapt in order of their priority, instead of each adapting on its own.
+const char kEncoderAdmissionControlFieldTrial[] =
+    "WebRTC-EncoderAdmissionControl";
+
+// If enabled, the video receive streams of a call decode on a pool of one
+// thread per core, instead of on a thread each.
+const char kSharedDecodeThreadsFieldTrial[] = "WebRTC-SharedDecodeThreads";
+
 // TODO(nisse): This really begs for a shared context struct.
 bool UseSendSideBwe(const std::vector<RtpExtension>& extensions,
                     bool transport_cc) {
@@ -86,6 +99,10 @@ bool UseSendSideBwe(const FlexfecReceiveStream::Config& config) {
   return UseSendSideBwe(config.rtp_header_extensions, config.transport_cc);
 }
 
+bool UseSendSideBwe(const RtpForwardingStream::Config& config) {
+  return UseSendSideBwe(config.rtp_header_extensions, config.transport_cc);
+}
+
 const int* FindKeyByValue(const std::map<int, int>& m, int v) {
   for (const auto& kv : m) {
     if (kv.second == v)
@@ -192,6 +209,16 @@ class Call : public webrtc::Call,
   void DestroyFlexfecReceiveStream(
       FlexfecReceiveStream* receive_stream) override;
 
+  RtpForwardingStream* CreateRtpForwardingStream(
+      const RtpForwardingStream::Config& config) override;
+  void DestroyRtpForwardingStream(
+      RtpForwardingStream* forwarding_stream) override;
+  RtpForwardingDestination* CreateRtpForwardingDestination(
+      uint32_t ssrc,
+      Transport* transport) override;
+  void DestroyRtpForwardingDestination(
+      RtpForwardingDestination* destination) override;
+
   Stats GetStats() const override;
 
   // Implements PacketReceiver.
@@ -199,6 +226,9 @@ class Call : public webrtc::Call,
                                const uint8_t* packet,
                                size_t length,
                                const PacketTime& packet_time) override;
+  DeliveryStatus DeliverPacketBuffer(MediaType media_type,
+                                     rtc::CopyOnWriteBuffer packet,
+                                     const PacketTime& packet_time) override;
 
   // Implements RecoveredPacketReceiver.
   void OnRecoveredPacket(const uint8_t* packet, size_t length) override;
@@ -233,8 +263,7 @@ class Call : public webrtc::Call,
   DeliveryStatus DeliverRtcp(MediaType media_type, const uint8_t* packet,
                              size_t length);
   DeliveryStatus DeliverRtp(MediaType media_type,
-                            const uint8_t* packet,
-                            size_t length,
+                            rtc::CopyOnWriteBuffer packet,
                             const PacketTime& packet_time);
   void ConfigureSync(const std::string& sync_group)
       EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
@@ -247,6 +276,9 @@ class Call : public webrtc::Call,
       const uint8_t* packet,
       size_t length,
       const PacketTime* packet_time) const;
+  rtc::Optional<RtpPacketReceived> ParseRtpPacket(
+      rtc::CopyOnWriteBuffer packet,
+      const PacketTime* packet_time) const;
 
   void UpdateSendHistograms(int64_t first_sent_packet_ms)
       EXCLUSIVE_LOCKS_REQUIRED(&bitrate_crit_);
@@ -316,6 +348,8 @@ class Call : public webrtc::Call,
   std::map<uint32_t, AudioSendStream*> audio_send_ssrcs_ GUARDED_BY(send_crit_);
   std::map<uint32_t, VideoSendStream*> video_send_ssrcs_ GUARDED_BY(send_crit_);
   std::set<VideoSendStream*> video_send_streams_ GUARDED_BY(send_crit_);
+  std::set<RtpForwardingDestination*> rtp_forwarding_destinations_
+      GUARDED_BY(send_crit_);
 
   using RtpStateMap = std::map<uint32_t, RtpState>;
   RtpStateMap suspended_audio_send_ssrcs_
@@ -329,6 +363,9 @@ class Call : public webrtc::Call,
   // from the destructor, and therefore doesn't need any explicit
   // synchronization.
   RateCounter received_bytes_per_second_counter_;
+  // Written on the worker thread, read by GetStats() from any thread.
+  std::atomic<int64_t> rtp_packets_received_{0};
+  std::atomic<int64_t> rtp_bytes_copied_on_receive_{0};
   RateCounter received_audio_bytes_per_second_counter_;
   RateCounter received_video_bytes_per_second_counter_;
   RateCounter received_rtcp_bytes_per_second_counter_;
@@ -351,6 +388,10 @@ class Call : public webrtc::Call,
   std::unique_ptr<RtpTransportControllerSendInterface> transport_send_;
   ReceiveSideCongestionController receive_side_cc_;
   const std::unique_ptr<SendDelayStats> video_send_delay_stats_;
+  // Null unless kEncoderAdmissionControlFieldTrial is enabled.
+  const std::unique_ptr<EncoderAdmissionController> admission_controller_;
+  // Null unless kSharedDecodeThreadsFieldTrial is enabled.
+  const std::unique_ptr<DecodeScheduler> decode_scheduler_;
   const int64_t start_ms_;
   // TODO(perkj): |worker_queue_| is supposed to replace
   // |module_process_thread_|.
@@ -377,7 +418,9 @@ std::string Call::Stats::ToString(int64_t time_ms) const {
   ss << "recv_bw_bps: " << recv_bandwidth_bps << ", ";
   ss << "max_pad_bps: " << max_padding_bitrate_bps << ", ";
   ss << "pacer_delay_ms: " << pacer_delay_ms << ", ";
-  ss << "rtt_ms: " << rtt_ms;
+  ss << "rtt_ms: " << rtt_ms << ", ";
+  ss << "rtp_packets_received: " << rtp_packets_received << ", ";
+  ss << "rtp_bytes_copied_on_receive: " << rtp_bytes_copied_on_receive;
   ss << '}';
   return ss.str();
 }
@@ -420,6 +463,13 @@ Call::Call(const Call::Config& config,
       pacer_bitrate_kbps_counter_(clock_, nullptr, true),
       receive_side_cc_(clock_, transport_send->packet_router()),
       video_send_delay_stats_(new SendDelayStats(clock_)),
+      admission_controller_(
+          field_trial::IsEnabled(kEncoderAdmissionControlFieldTrial)
+              ? new EncoderAdmissionController()
+              : nullptr),
+      decode_scheduler_(field_trial::IsEnabled(kSharedDecodeThreadsFieldTrial)
+                            ? new DecodeScheduler(num_cpu_cores_)
+                            : nullptr),
       start_ms_(clock_->TimeInMilliseconds()),
       worker_queue_("call_worker_queue"),
       base_bitrate_config_(config.bitrate_config) {
@@ -463,6 +513,7 @@ Call::~Call() {
   RTC_CHECK(audio_send_ssrcs_.empty());
   RTC_CHECK(video_send_ssrcs_.empty());
   RTC_CHECK(video_send_streams_.empty());
+  RTC_CHECK(rtp_forwarding_destinations_.empty());
   RTC_CHECK(audio_receive_streams_.empty());
   RTC_CHECK(video_receive_streams_.empty());
 
@@ -486,7 +537,7 @@ Call::~Call() {
   // Only update histograms after process threads have been shut down, so that
   // they won't try to concurrently update stats.
   {
-    rtc::CritScope lock(&bitrate_crit_);
+    rtc::CritScope lock(&bitrate_crit_, RTC_FROM_HERE);
     UpdateSendHistograms(first_sent_packet_ms);
   }
   UpdateReceiveHistograms();
@@ -499,8 +550,14 @@ rtc::Optional<RtpPacketReceived> Call::ParseRtpPacket(
     const uint8_t* packet,
     size_t length,
     const PacketTime* packet_time) const {
+  return ParseRtpPacket(rtc::CopyOnWriteBuffer(packet, length), packet_time);
+}
+
+rtc::Optional<RtpPacketReceived> Call::ParseRtpPacket(
+    rtc::CopyOnWriteBuffer packet,
+    const PacketTime* packet_time) const {
   RtpPacketReceived parsed_packet;
-  if (!parsed_packet.Parse(packet, length))
+  if (!parsed_packet.Parse(std::move(packet)))
     return rtc::Optional<RtpPacketReceived>();
 
   int64_t arrival_time_ms;
@@ -743,8 +800,9 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
   VideoSendStream* send_stream = new VideoSendStream(
       num_cpu_cores_, module_process_thread_.get(), &worker_queue_,
       call_stats_.get(), transport_send_.get(), bitrate_allocator_.get(),
-      video_send_delay_stats_.get(), event_log_, std::move(config),
-      std::move(encoder_config), suspended_video_send_ssrcs_);
+      video_send_delay_stats_.get(), event_log_, admission_controller_.get(),
+      std::move(config), std::move(encoder_config),
+      suspended_video_send_ssrcs_);
 
   {
     WriteLockScoped write_lock(*send_crit_);
@@ -803,7 +861,8 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
       &video_receiver_controller_, num_cpu_cores_,
       transport_send_->packet_router(), std::move(configuration),
-      module_process_thread_.get(), call_stats_.get());
+      module_process_thread_.get(), call_stats_.get(),
+      decode_scheduler_.get());
 
   const webrtc::VideoReceiveStream::Config& config = receive_stream->config();
   ReceiveRtpConfig receive_config(config.rtp.extensions,
@@ -909,6 +968,76 @@ void Call::DestroyFlexfecReceiveStream(FlexfecReceiveStream* receive_stream) {
   delete receive_stream;
 }
 
+RtpForwardingStream* Call::CreateRtpForwardingStream(
+    const RtpForwardingStream::Config& config) {
+  TRACE_EVENT0("webrtc", "Call::CreateRtpForwardingStream");
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&configuration_sequence_checker_);
+
+  RtpForwardingStream* forwarding_stream;
+  {
+    WriteLockScoped write_lock(*receive_crit_);
+    // Like FlexfecReceiveStreamImpl, the forwarding stream registers itself
+    // with |video_receiver_controller_| in its constructor.
+    forwarding_stream =
+        new RtpForwardingStream(&video_receiver_controller_, config);
+    for (uint32_t ssrc : config.layer_ssrcs) {
+      RTC_DCHECK(receive_rtp_config_.find(ssrc) == receive_rtp_config_.end());
+      receive_rtp_config_[ssrc] =
+          ReceiveRtpConfig(config.rtp_header_extensions, UseSendSideBwe(config));
+    }
+  }
+  return forwarding_stream;
+}
+
+void Call::DestroyRtpForwardingStream(RtpForwardingStream* forwarding_stream) {
+  TRACE_EVENT0("webrtc", "Call::DestroyRtpForwardingStream");
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&configuration_sequence_checker_);
+
+  RTC_DCHECK(forwarding_stream != nullptr);
+  {
+    WriteLockScoped write_lock(*receive_crit_);
+    const RtpForwardingStream::Config& config = forwarding_stream->config();
+    for (uint32_t ssrc : config.layer_ssrcs) {
+      receive_rtp_config_.erase(ssrc);
+      receive_side_cc_.GetRemoteBitrateEstimator(UseSendSideBwe(config))
+          ->RemoveStream(ssrc);
+    }
+  }
+  delete forwarding_stream;
+}
+
+RtpForwardingDestination* Call::CreateRtpForwardingDestination(
+    uint32_t ssrc,
+    Transport* transport) {
+  TRACE_EVENT0("webrtc", "Call::CreateRtpForwardingDestination");
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&configuration_sequence_checker_);
+
+  RtpForwardingDestination* destination = new RtpForwardingDestination(
+      clock_, ssrc, transport, transport_send_->pacer(),
+      transport_send_->packet_router());
+  call_stats_->RegisterStatsObserver(destination);
+  {
+    WriteLockScoped write_lock(*send_crit_);
+    rtp_forwarding_destinations_.insert(destination);
+  }
+  return destination;
+}
+
+void Call::DestroyRtpForwardingDestination(
+    RtpForwardingDestination* destination) {
+  TRACE_EVENT0("webrtc", "Call::DestroyRtpForwardingDestination");
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&configuration_sequence_checker_);
+
+  RTC_DCHECK(destination != nullptr);
+  {
+    WriteLockScoped write_lock(*send_crit_);
+    size_t removed = rtp_forwarding_destinations_.erase(destination);
+    RTC_DCHECK_EQ(removed, 1);
+  }
+  call_stats_->DeregisterStatsObserver(destination);
+  delete destination;
+}
+
 Call::Stats Call::GetStats() const {
   // TODO(solenberg): Some test cases in EndToEndTest use this from a different
   // thread. Re-enable once that is fixed.
@@ -928,9 +1057,13 @@ Call::Stats Call::GetStats() const {
       transport_send_->send_side_cc()->GetPacerQueuingDelayMs();
   stats.rtt_ms = call_stats_->rtcp_rtt_stats()->LastProcessedRtt();
   {
-    rtc::CritScope cs(&bitrate_crit_);
+    rtc::CritScope cs(&bitrate_crit_, RTC_FROM_HERE);
     stats.max_padding_bitrate_bps = configured_max_padding_bitrate_bps_;
   }
+  stats.rtp_packets_received =
+      rtp_packets_received_.load(std::memory_order_relaxed);
+  stats.rtp_bytes_copied_on_receive =
+      rtp_bytes_copied_on_receive_.load(std::memory_order_relaxed);
   return stats;
 }
 
@@ -1174,7 +1307,7 @@ void Call::OnNetworkChanged(uint32_t target_bitrate_bps,
 
   // Ignore updates if bitrate is zero (the aggregate network state is down).
   if (target_bitrate_bps == 0) {
-    rtc::CritScope lock(&bitrate_crit_);
+    rtc::CritScope lock(&bitrate_crit_, RTC_FROM_HERE);
     estimated_send_bitrate_kbps_counter_.ProcessAndPause();
     pacer_bitrate_kbps_counter_.ProcessAndPause();
     return;
@@ -1186,7 +1319,7 @@ void Call::OnNetworkChanged(uint32_t target_bitrate_bps,
     sending_video = !video_send_streams_.empty();
   }
 
-  rtc::CritScope lock(&bitrate_crit_);
+  rtc::CritScope lock(&bitrate_crit_, RTC_FROM_HERE);
   if (!sending_video) {
     // Do not update the stats if we are not sending video.
     estimated_send_bitrate_kbps_counter_.ProcessAndPause();
@@ -1204,7 +1337,7 @@ void Call::OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
                                      uint32_t max_padding_bitrate_bps) {
   transport_send_->SetAllocatedSendBitrateLimits(min_send_bitrate_bps,
                                                  max_padding_bitrate_bps);
-  rtc::CritScope lock(&bitrate_crit_);
+  rtc::CritScope lock(&bitrate_crit_, RTC_FROM_HERE);
   min_allocated_send_bitrate_bps_ = min_send_bitrate_bps;
   configured_max_padding_bitrate_bps_ = max_padding_bitrate_bps;
 }
@@ -1290,6 +1423,10 @@ PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
       if (stream->DeliverRtcp(packet, length))
         rtcp_delivered = true;
     }
+    for (RtpForwardingDestination* destination : rtp_forwarding_destinations_) {
+      if (destination->DeliverRtcp(packet, length))
+        rtcp_delivered = true;
+    }
   }
   if (media_type == MediaType::ANY || media_type == MediaType::AUDIO) {
     ReadLockScoped read_lock(*send_crit_);
@@ -1306,15 +1443,16 @@ PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
 }
 
 PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
-                                                const uint8_t* packet,
-                                                size_t length,
+                                                rtc::CopyOnWriteBuffer packet,
                                                 const PacketTime& packet_time) {
   TRACE_EVENT0("webrtc", "Call::DeliverRtp");
 
+  rtp_packets_received_.fetch_add(1, std::memory_order_relaxed);
+  const size_t length = packet.size();
   // TODO(nisse): We should parse the RTP header only here, and pass
   // on parsed_packet to the receive streams.
   rtc::Optional<RtpPacketReceived> parsed_packet =
-      ParseRtpPacket(packet, length, &packet_time);
+      ParseRtpPacket(std::move(packet), &packet_time);
 
   // We might get RTP keep-alive packets in accordance with RFC6263 section 4.6.
   // These are empty (zero length payload) RTP packets with an unsignaled
@@ -1349,7 +1487,8 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
     if (audio_receiver_controller_.OnRtpPacket(*parsed_packet)) {
       received_bytes_per_second_counter_.Add(static_cast<int>(length));
       received_audio_bytes_per_second_counter_.Add(static_cast<int>(length));
-      event_log_->LogRtpHeader(kIncomingPacket, packet, length);
+      event_log_->LogRtpHeader(kIncomingPacket, parsed_packet->data(),
+                               length);
       const int64_t arrival_time_ms = parsed_packet->arrival_time_ms();
       if (!first_received_rtp_audio_ms_) {
         first_received_rtp_audio_ms_.emplace(arrival_time_ms);
@@ -1361,7 +1500,8 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
     if (video_receiver_controller_.OnRtpPacket(*parsed_packet)) {
       received_bytes_per_second_counter_.Add(static_cast<int>(length));
       received_video_bytes_per_second_counter_.Add(static_cast<int>(length));
-      event_log_->LogRtpHeader(kIncomingPacket, packet, length);
+      event_log_->LogRtpHeader(kIncomingPacket, parsed_packet->data(),
+                               length);
       const int64_t arrival_time_ms = parsed_packet->arrival_time_ms();
       if (!first_received_rtp_video_ms_) {
         first_received_rtp_video_ms_.emplace(arrival_time_ms);
@@ -1382,7 +1522,20 @@ PacketReceiver::DeliveryStatus Call::DeliverPacket(
   if (RtpHeaderParser::IsRtcp(packet, length))
     return DeliverRtcp(media_type, packet, length);
 
-  return DeliverRtp(media_type, packet, length, packet_time);
+  rtp_bytes_copied_on_receive_.fetch_add(length, std::memory_order_relaxed);
+  return DeliverRtp(media_type, rtc::CopyOnWriteBuffer(packet, length),
+                    packet_time);
+}
+
+PacketReceiver::DeliveryStatus Call::DeliverPacketBuffer(
+    MediaType media_type,
+    rtc::CopyOnWriteBuffer packet,
+    const PacketTime& packet_time) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&configuration_sequence_checker_);
+  if (RtpHeaderParser::IsRtcp(packet.cdata(), packet.size()))
+    return DeliverRtcp(media_type, packet.cdata(), packet.size());
+
+  return DeliverRtp(media_type, std::move(packet), packet_time);
 }
 
 void Call::OnRecoveredPacket(const uint8_t* packet, size_t length) {
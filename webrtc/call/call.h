@@ -20,10 +20,12 @@
 #include "webrtc/call/audio_send_stream.h"
 #include "webrtc/call/audio_state.h"
 #include "webrtc/call/flexfec_receive_stream.h"
+#include "webrtc/call/rtp_forwarding_stream.h"
 #include "webrtc/call/rtp_transport_controller_send_interface.h"
 #include "webrtc/call/video_receive_stream.h"
 #include "webrtc/call/video_send_stream.h"
 #include "webrtc/common_types.h"
+#include "webrtc/rtc_base/copyonwritebuffer.h"
 #include "webrtc/rtc_base/networkroute.h"
 #include "webrtc/rtc_base/platform_file.h"
 #include "webrtc/rtc_base/socket.h"
@@ -66,6 +68,16 @@ class PacketReceiver {
                                        size_t length,
                                        const PacketTime& packet_time) = 0;
 
+  // Like DeliverPacket, but lets the receiver keep a reference to |packet|
+  // rather than copying it. Receivers that don't support this copy the packet
+  // as usual.
+  virtual DeliveryStatus DeliverPacketBuffer(MediaType media_type,
+                                             rtc::CopyOnWriteBuffer packet,
+                                             const PacketTime& packet_time) {
+    return DeliverPacket(media_type, packet.cdata(), packet.size(),
+                         packet_time);
+  }
+
  protected:
   virtual ~PacketReceiver() {}
 };
@@ -122,6 +134,11 @@ class Call {
     int recv_bandwidth_bps = 0;       // Estimated available receive bandwidth.
     int64_t pacer_delay_ms = 0;
     int64_t rtt_ms = -1;
+    // Number of RTP packets delivered to the call, and the number of bytes
+    // that had to be copied while handing them over. Packets delivered with
+    // PacketReceiver::DeliverPacketBuffer are not copied.
+    int64_t rtp_packets_received = 0;
+    int64_t rtp_bytes_copied_on_receive = 0;
   };
 
   static Call* Create(const Call::Config& config);
@@ -158,6 +175,20 @@ class Call {
   virtual void DestroyFlexfecReceiveStream(
       FlexfecReceiveStream* receive_stream) = 0;
 
+  // Forwarding streams relay the received packets of a simulcast stream,
+  // without decoding them, to destinations which may belong to other calls.
+  // A destination sends the packets through the pacer of the call that
+  // created it, and resends those NACKed in the RTCP received by that call.
+  virtual RtpForwardingStream* CreateRtpForwardingStream(
+      const RtpForwardingStream::Config& config) = 0;
+  virtual void DestroyRtpForwardingStream(
+      RtpForwardingStream* forwarding_stream) = 0;
+  virtual RtpForwardingDestination* CreateRtpForwardingDestination(
+      uint32_t ssrc,
+      Transport* transport) = 0;
+  virtual void DestroyRtpForwardingDestination(
+      RtpForwardingDestination* destination) = 0;
+
   // All received RTP and RTCP packets for the call should be inserted to this
   // PacketReceiver. The PacketReceiver pointer is valid as long as the
   // Call instance exists.
@@ -0,0 +1,324 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "webrtc/call/call.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/rtc_base/cpu_time.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/memory_usage.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/call_test.h"
+#include "webrtc/test/direct_transport.h"
+#include "webrtc/test/encoder_settings.h"
+#include "webrtc/test/fake_encoder.h"
+#include "webrtc/test/fake_videorenderer.h"
+#include "webrtc/test/frame_generator_capturer.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kRunTimeMs = 10000;
+constexpr uint32_t kFirstSendSsrc = 0x1000;
+
+// Matches the RTP packets delivered to the receiving Calls with the time they
+// were handed to the send transport, and counts them.
+class PacketLatencyRecorder {
+ public:
+  void OnPacketSent(const uint8_t* packet, size_t length) {
+    if (RtpHeaderParser::IsRtcp(packet, length))
+      return;
+    int64_t now_us = rtc::TimeMicros();
+    rtc::CritScope lock(&crit_);
+    send_times_us_[PacketId(packet)] = now_us;
+  }
+
+  void OnPacketDelivered(const uint8_t* packet, size_t length) {
+    if (RtpHeaderParser::IsRtcp(packet, length))
+      return;
+    int64_t now_us = rtc::TimeMicros();
+    rtc::CritScope lock(&crit_);
+    auto it = send_times_us_.find(PacketId(packet));
+    if (it == send_times_us_.end())
+      return;
+    latencies_us_.push_back(now_us - it->second);
+    send_times_us_.erase(it);
+  }
+
+  // Returns the latencies of the packets delivered so far, sorted.
+  std::vector<int64_t> GetSortedLatencies() {
+    std::vector<int64_t> latencies;
+    {
+      rtc::CritScope lock(&crit_);
+      latencies = latencies_us_;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+  }
+
+  size_t num_delivered_packets() {
+    rtc::CritScope lock(&crit_);
+    return latencies_us_.size();
+  }
+
+ private:
+  static uint64_t PacketId(const uint8_t* packet) {
+    uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet[8]);
+    uint16_t sequence_number = ByteReader<uint16_t>::ReadBigEndian(&packet[2]);
+    return (static_cast<uint64_t>(ssrc) << 16) | sequence_number;
+  }
+
+  rtc::CriticalSection crit_;
+  std::unordered_map<uint64_t, int64_t> send_times_us_ GUARDED_BY(crit_);
+  std::vector<int64_t> latencies_us_ GUARDED_BY(crit_);
+};
+
+class RecordingSendTransport : public test::DirectTransport {
+ public:
+  RecordingSendTransport(test::SingleThreadedTaskQueueForTesting* task_queue,
+                         Call* send_call,
+                         PacketLatencyRecorder* recorder)
+      : test::DirectTransport(task_queue,
+                              send_call,
+                              test::CallTest::payload_type_map_),
+        recorder_(recorder) {}
+
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override {
+    recorder_->OnPacketSent(packet, length);
+    return test::DirectTransport::SendRtp(packet, length, options);
+  }
+
+ private:
+  PacketLatencyRecorder* const recorder_;
+};
+
+class RecordingReceiver : public PacketReceiver {
+ public:
+  RecordingReceiver(PacketReceiver* receiver, PacketLatencyRecorder* recorder)
+      : receiver_(receiver), recorder_(recorder) {}
+
+  DeliveryStatus DeliverPacket(MediaType media_type,
+                               const uint8_t* packet,
+                               size_t length,
+                               const PacketTime& packet_time) override {
+    DeliveryStatus status =
+        receiver_->DeliverPacket(media_type, packet, length, packet_time);
+    recorder_->OnPacketDelivered(packet, length);
+    return status;
+  }
+
+ private:
+  PacketReceiver* const receiver_;
+  PacketLatencyRecorder* const recorder_;
+};
+
+}  // namespace
+
+// Runs |num_calls| pairs of sending and receiving Calls, each with
+// |streams_per_call| video streams from fake encoders, and reports the CPU and
+// memory used, the packet rate and how long packets take from the send
+// transport until the receiving Call has handled them.
+class CallLoadTest : public test::CallTest {
+ protected:
+  struct CallPair {
+    std::unique_ptr<Call> sender_call;
+    std::unique_ptr<Call> receiver_call;
+    std::unique_ptr<RecordingSendTransport> send_transport;
+    std::unique_ptr<test::DirectTransport> receive_transport;
+    std::unique_ptr<RecordingReceiver> receiver;
+    std::vector<std::unique_ptr<test::FakeEncoder>> encoders;
+    std::vector<std::unique_ptr<VideoDecoder>> decoders;
+    std::vector<std::unique_ptr<test::FrameGeneratorCapturer>> capturers;
+    std::vector<VideoSendStream*> send_streams;
+    std::vector<VideoReceiveStream*> receive_streams;
+  };
+
+  void RunLoadTest(size_t num_calls,
+                   size_t streams_per_call,
+                   int max_bitrate_kbps) {
+    std::vector<std::unique_ptr<CallPair>> calls;
+    task_queue_.SendTask([&]() {
+      for (size_t i = 0; i < num_calls; ++i) {
+        calls.push_back(CreateCallPair(calls.size() * streams_per_call,
+                                       streams_per_call, max_bitrate_kbps));
+      }
+    });
+    int64_t start_memory_bytes = rtc::GetProcessResidentSizeBytes();
+
+    int64_t start_thread_cpu_ns = 0;
+    task_queue_.SendTask(
+        [&]() { start_thread_cpu_ns = rtc::GetThreadCpuTimeNanos(); });
+    int64_t start_process_cpu_ns = rtc::GetProcessCpuTimeNanos();
+    int64_t start_time_ns = rtc::TimeNanos();
+
+    rtc::Event done(false, false);
+    done.Wait(kRunTimeMs);
+
+    int64_t thread_cpu_ns = 0;
+    task_queue_.SendTask([&]() {
+      thread_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_thread_cpu_ns;
+    });
+    int64_t process_cpu_ns = rtc::GetProcessCpuTimeNanos() -
+                             start_process_cpu_ns;
+    int64_t elapsed_ns = rtc::TimeNanos() - start_time_ns;
+    int64_t memory_bytes = rtc::GetProcessResidentSizeBytes();
+    size_t num_packets = recorder_.num_delivered_packets();
+
+    task_queue_.SendTask([&]() {
+      for (const std::unique_ptr<CallPair>& call : calls)
+        DestroyCallPair(call.get());
+      calls.clear();
+    });
+
+    std::string trace = "calls_" + std::to_string(num_calls) + "_streams_" +
+                        std::to_string(streams_per_call);
+    test::PrintResult("call_load_process_cpu", "", trace,
+                      static_cast<size_t>(process_cpu_ns * 100 / elapsed_ns),
+                      "%", true);
+    // The thread DirectTransport delivers packets to the receiving Calls on.
+    test::PrintResult("call_load_delivery_thread_cpu", "", trace,
+                      static_cast<size_t>(thread_cpu_ns * 100 / elapsed_ns),
+                      "%", false);
+    test::PrintResult("call_load_packet_rate", "", trace,
+                      static_cast<size_t>(num_packets *
+                                          rtc::kNumNanosecsPerSec /
+                                          elapsed_ns),
+                      "packets/s", true);
+    std::vector<int64_t> latencies = recorder_.GetSortedLatencies();
+    ASSERT_FALSE(latencies.empty());
+    for (int percentile : {50, 90, 99}) {
+      size_t index = (latencies.size() - 1) * percentile / 100;
+      test::PrintResult("call_load_packet_latency",
+                        "_p" + std::to_string(percentile), trace,
+                        static_cast<size_t>(latencies[index]), "us", false);
+    }
+    if (memory_bytes >= 0) {
+      test::PrintResult("call_load_memory", "", trace,
+                        static_cast<size_t>(memory_bytes), "bytes", false);
+    }
+    if (memory_bytes >= 0 && start_memory_bytes >= 0) {
+      test::PrintResult(
+          "call_load_memory_growth", "", trace,
+          static_cast<size_t>(std::max<int64_t>(
+              memory_bytes - start_memory_bytes, 0)),
+          "bytes", false);
+    }
+  }
+
+ private:
+  std::unique_ptr<CallPair> CreateCallPair(size_t first_stream,
+                                           size_t num_streams,
+                                           int max_bitrate_kbps) {
+    std::unique_ptr<CallPair> call(new CallPair());
+    Call::Config config(event_log_.get());
+    call->sender_call.reset(Call::Create(config));
+    call->receiver_call.reset(Call::Create(config));
+    call->send_transport.reset(new RecordingSendTransport(
+        &task_queue_, call->sender_call.get(), &recorder_));
+    call->receive_transport.reset(new test::DirectTransport(
+        &task_queue_, call->receiver_call.get(), payload_type_map_));
+    call->receiver.reset(
+        new RecordingReceiver(call->receiver_call->Receiver(), &recorder_));
+    call->send_transport->SetReceiver(call->receiver.get());
+    call->receive_transport->SetReceiver(call->sender_call->Receiver());
+
+    for (size_t i = 0; i < num_streams; ++i) {
+      uint32_t ssrc = kFirstSendSsrc + static_cast<uint32_t>(first_stream + i);
+      call->encoders.push_back(rtc::MakeUnique<test::FakeEncoder>(clock_));
+      call->encoders.back()->SetMaxBitrate(max_bitrate_kbps);
+
+      VideoSendStream::Config send_config(call->send_transport.get());
+      send_config.rtp.ssrcs.push_back(ssrc);
+      send_config.encoder_settings.encoder = call->encoders.back().get();
+      send_config.encoder_settings.payload_name = "FAKE";
+      send_config.encoder_settings.payload_type = kFakeVideoSendPayloadType;
+      VideoEncoderConfig encoder_config;
+      test::FillEncoderConfiguration(1, &encoder_config);
+      encoder_config.max_bitrate_bps = max_bitrate_kbps * 1000;
+      VideoSendStream* send_stream = call->sender_call->CreateVideoSendStream(
+          send_config.Copy(), encoder_config.Copy());
+      call->send_streams.push_back(send_stream);
+
+      VideoReceiveStream::Config receive_config(
+          call->receive_transport.get());
+      receive_config.rtp.remote_ssrc = ssrc;
+      receive_config.rtp.local_ssrc = kReceiverLocalVideoSsrc;
+      receive_config.renderer = &renderer_;
+      VideoReceiveStream::Decoder decoder =
+          test::CreateMatchingDecoder(send_config.encoder_settings);
+      call->decoders.push_back(std::unique_ptr<VideoDecoder>(decoder.decoder));
+      receive_config.decoders.push_back(decoder);
+      VideoReceiveStream* receive_stream =
+          call->receiver_call->CreateVideoReceiveStream(
+              std::move(receive_config));
+      call->receive_streams.push_back(receive_stream);
+
+      call->capturers.emplace_back(test::FrameGeneratorCapturer::Create(
+          kDefaultWidth, kDefaultHeight, kDefaultFramerate, clock_));
+      send_stream->SetSource(
+          call->capturers.back().get(),
+          VideoSendStream::DegradationPreference::kMaintainFramerate);
+
+      receive_stream->Start();
+      send_stream->Start();
+      call->capturers.back()->Start();
+    }
+    return call;
+  }
+
+  void DestroyCallPair(CallPair* call) {
+    for (const auto& capturer : call->capturers)
+      capturer->Stop();
+    for (VideoSendStream* send_stream : call->send_streams) {
+      send_stream->Stop();
+      call->sender_call->DestroyVideoSendStream(send_stream);
+    }
+    for (VideoReceiveStream* receive_stream : call->receive_streams) {
+      receive_stream->Stop();
+      call->receiver_call->DestroyVideoReceiveStream(receive_stream);
+    }
+    call->capturers.clear();
+    call->send_transport.reset();
+    call->receive_transport.reset();
+    call->sender_call.reset();
+    call->receiver_call.reset();
+  }
+
+  PacketLatencyRecorder recorder_;
+  test::FakeVideoRenderer renderer_;
+};
+
+TEST_F(CallLoadTest, OneCallWithOneStream) {
+  RunLoadTest(1, 1, 1000);
+}
+
+TEST_F(CallLoadTest, FourCallsWithFourStreams) {
+  RunLoadTest(4, 4, 500);
+}
+
+TEST_F(CallLoadTest, SixteenCallsWithFourStreams) {
+  RunLoadTest(16, 4, 300);
+}
+
+}  // namespace webrtc
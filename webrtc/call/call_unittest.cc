@@ -63,6 +63,31 @@ TEST(CallTest, ConstructDestruct) {
   CallHelper call;
 }
 
+TEST(CallTest, CountsBytesCopiedOnReceive) {
+  CallHelper call;
+  // Minimal RTP header, SSRC 0x11223344, followed by a payload.
+  const uint8_t kPacket[] = {0x80, 0x60, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+                             0x11, 0x22, 0x33, 0x44, 0xde, 0xad, 0xbe, 0xef};
+  PacketReceiver* receiver = call->Receiver();
+
+  EXPECT_EQ(PacketReceiver::DELIVERY_UNKNOWN_SSRC,
+            receiver->DeliverPacket(MediaType::VIDEO, kPacket,
+                                    sizeof(kPacket), PacketTime()));
+  Call::Stats stats = call->GetStats();
+  EXPECT_EQ(1, stats.rtp_packets_received);
+  EXPECT_EQ(static_cast<int64_t>(sizeof(kPacket)),
+            stats.rtp_bytes_copied_on_receive);
+
+  EXPECT_EQ(PacketReceiver::DELIVERY_UNKNOWN_SSRC,
+            receiver->DeliverPacketBuffer(
+                MediaType::VIDEO, rtc::CopyOnWriteBuffer(kPacket),
+                PacketTime()));
+  stats = call->GetStats();
+  EXPECT_EQ(2, stats.rtp_packets_received);
+  EXPECT_EQ(static_cast<int64_t>(sizeof(kPacket)),
+            stats.rtp_bytes_copied_on_receive);
+}
+
 TEST(CallTest, CreateDestroy_AudioSendStream) {
   CallHelper call;
   AudioSendStream::Config config(nullptr);
@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_FLAT_SSRC_MAP_H_
+#define WEBRTC_CALL_FLAT_SSRC_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+// Open addressing hash map from SSRC to a small value type (typically a sink
+// pointer), stored in a single flat array with linear probing. Lookups touch
+// one or two cache lines regardless of the number of entries, which matters
+// when a single RtpDemuxer has thousands of SSRCs bound.
+//
+// The most recently found entry is remembered, so that back to back packets
+// of the same stream skip hashing altogether. This can be turned off with
+// |cache_last_hit|.
+//
+// Pointers returned by Find() and Emplace() are invalidated by any subsequent
+// Emplace() or Erase().
+template <typename V>
+class FlatSsrcMap {
+ public:
+  explicit FlatSsrcMap(bool cache_last_hit = true)
+      : cache_last_hit_(cache_last_hit) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  V* Find(uint32_t ssrc) {
+    return const_cast<V*>(static_cast<const FlatSsrcMap*>(this)->Find(ssrc));
+  }
+
+  const V* Find(uint32_t ssrc) const {
+    if (size_ == 0)
+      return nullptr;
+    if (cache_last_hit_ && last_hit_ != kNoSlot &&
+        slots_[last_hit_].key == ssrc && slots_[last_hit_].used) {
+      return &slots_[last_hit_].value;
+    }
+    for (size_t i = SlotFor(ssrc);; i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      if (!slot.used)
+        return nullptr;
+      if (slot.key == ssrc) {
+        last_hit_ = i;
+        return &slot.value;
+      }
+    }
+  }
+
+  // Inserts |value| unless |ssrc| is already present. Returns the stored value
+  // and whether an insertion took place, like std::map::emplace.
+  std::pair<V*, bool> Emplace(uint32_t ssrc, const V& value) {
+    if ((size_ + 1) * 2 > slots_.size())
+      Rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+    size_t i = SlotFor(ssrc);
+    for (; slots_[i].used; i = (i + 1) & mask_) {
+      if (slots_[i].key == ssrc)
+        return std::make_pair(&slots_[i].value, false);
+    }
+    slots_[i].used = true;
+    slots_[i].key = ssrc;
+    slots_[i].value = value;
+    ++size_;
+    return std::make_pair(&slots_[i].value, true);
+  }
+
+  // Returns true if |ssrc| was present.
+  bool Erase(uint32_t ssrc) {
+    if (size_ == 0)
+      return false;
+    for (size_t i = SlotFor(ssrc); slots_[i].used; i = (i + 1) & mask_) {
+      if (slots_[i].key == ssrc) {
+        EraseSlot(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Removes all entries whose value compares equal to |value|. Returns the
+  // number removed.
+  template <typename T>
+  size_t EraseValue(const T& value) {
+    size_t count = 0;
+    for (size_t i = 0; i < slots_.size();) {
+      if (slots_[i].used && slots_[i].value == value) {
+        // Backward shifting may move an unvisited entry into slot |i|, so
+        // look at it again.
+        EraseSlot(i);
+        ++count;
+      } else {
+        ++i;
+      }
+    }
+    return count;
+  }
+
+  template <typename T>
+  bool ContainsValue(const T& value) const {
+    for (const Slot& slot : slots_) {
+      if (slot.used && slot.value == value)
+        return true;
+    }
+    return false;
+  }
+
+  void Clear() {
+    slots_.clear();
+    mask_ = 0;
+    shift_ = 32;
+    size_ = 0;
+    last_hit_ = kNoSlot;
+  }
+
+ private:
+  struct Slot {
+    uint32_t key = 0;
+    bool used = false;
+    V value = V();
+  };
+
+  static constexpr size_t kMinCapacity = 16;
+  static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+  size_t SlotFor(uint32_t ssrc) const {
+    // SSRCs are random, but may be chosen sequentially by test code or by
+    // misbehaving endpoints; Fibonacci hashing spreads those out. The top bits
+    // of the product depend on all bits of the SSRC.
+    return static_cast<uint32_t>(ssrc * 0x9E3779B1u) >> shift_;
+  }
+
+  void EraseSlot(size_t i) {
+    // Backward shift deletion: move later entries of the probe sequence into
+    // the hole so that lookups never stop early.
+    slots_[i].used = false;
+    --size_;
+    last_hit_ = kNoSlot;
+    for (size_t j = (i + 1) & mask_; slots_[j].used; j = (j + 1) & mask_) {
+      size_t home = SlotFor(slots_[j].key);
+      // Move the entry at |j| if its home slot is not in (i, j].
+      bool in_range = (i <= j) ? (i < home && home <= j)
+                               : (i < home || home <= j);
+      if (!in_range) {
+        slots_[i] = slots_[j];
+        slots_[j].used = false;
+        i = j;
+      }
+    }
+  }
+
+  void Rehash(size_t capacity) {
+    RTC_DCHECK_EQ(0, capacity & (capacity - 1));
+    std::vector<Slot> old_slots(capacity);
+    old_slots.swap(slots_);
+    mask_ = capacity - 1;
+    shift_ = 32;
+    for (size_t c = capacity; c > 1; c >>= 1)
+      --shift_;
+    size_ = 0;
+    last_hit_ = kNoSlot;
+    for (const Slot& slot : old_slots) {
+      if (slot.used)
+        Emplace(slot.key, slot.value);
+    }
+  }
+
+  const bool cache_last_hit_;
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  int shift_ = 32;
+  size_t size_ = 0;
+  mutable size_t last_hit_ = kNoSlot;
+};
+
+template <typename V>
+constexpr size_t FlatSsrcMap<V>::kMinCapacity;
+template <typename V>
+constexpr size_t FlatSsrcMap<V>::kNoSlot;
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_FLAT_SSRC_MAP_H_
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/flat_ssrc_map.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kLookupsPerRun = 1000000;
+
+std::vector<uint32_t> RandomSsrcs(size_t count) {
+  Random random(0x12345678);
+  std::map<uint32_t, bool> seen;
+  std::vector<uint32_t> ssrcs;
+  while (ssrcs.size() < count) {
+    uint32_t ssrc = random.Rand<uint32_t>();
+    if (seen.emplace(ssrc, true).second)
+      ssrcs.push_back(ssrc);
+  }
+  return ssrcs;
+}
+
+// Returns the order in which SSRCs are looked up: packets of a stream
+// typically arrive in short bursts, modelled here as runs of four.
+std::vector<uint32_t> LookupOrder(const std::vector<uint32_t>& ssrcs) {
+  Random random(0x87654321);
+  std::vector<uint32_t> order;
+  order.reserve(kLookupsPerRun);
+  while (order.size() < kLookupsPerRun) {
+    uint32_t ssrc = ssrcs[random.Rand(0, static_cast<int>(ssrcs.size()) - 1)];
+    for (int i = 0; i < 4 && order.size() < kLookupsPerRun; ++i)
+      order.push_back(ssrc);
+  }
+  return order;
+}
+
+}  // namespace
+
+TEST(FlatSsrcMapTest, EmptyMapFindsNothing) {
+  FlatSsrcMap<int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find(1));
+  EXPECT_FALSE(map.Erase(1));
+  EXPECT_EQ(0u, map.EraseValue(1));
+}
+
+TEST(FlatSsrcMapTest, EmplaceAndFind) {
+  FlatSsrcMap<int> map;
+  auto result = map.Emplace(111, 1);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(1, *result.first);
+  EXPECT_EQ(1u, map.size());
+
+  ASSERT_NE(nullptr, map.Find(111));
+  EXPECT_EQ(1, *map.Find(111));
+  EXPECT_EQ(nullptr, map.Find(222));
+}
+
+TEST(FlatSsrcMapTest, EmplaceDoesNotOverwrite) {
+  FlatSsrcMap<int> map;
+  map.Emplace(111, 1);
+  auto result = map.Emplace(111, 2);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(1, *result.first);
+  EXPECT_EQ(1u, map.size());
+
+  *result.first = 3;
+  EXPECT_EQ(3, *map.Find(111));
+}
+
+TEST(FlatSsrcMapTest, SsrcZeroIsAValidKey) {
+  FlatSsrcMap<int> map;
+  EXPECT_EQ(nullptr, map.Find(0));
+  map.Emplace(0, 5);
+  ASSERT_NE(nullptr, map.Find(0));
+  EXPECT_EQ(5, *map.Find(0));
+}
+
+TEST(FlatSsrcMapTest, Erase) {
+  FlatSsrcMap<int> map;
+  map.Emplace(111, 1);
+  map.Emplace(222, 2);
+  EXPECT_TRUE(map.Erase(111));
+  EXPECT_FALSE(map.Erase(111));
+  EXPECT_EQ(nullptr, map.Find(111));
+  ASSERT_NE(nullptr, map.Find(222));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(FlatSsrcMapTest, EraseValueRemovesAllMatchingEntries) {
+  FlatSsrcMap<int> map;
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc)
+    map.Emplace(ssrc, ssrc % 3);
+  EXPECT_TRUE(map.ContainsValue(1));
+  EXPECT_EQ(33u, map.EraseValue(1));
+  EXPECT_FALSE(map.ContainsValue(1));
+  EXPECT_EQ(67u, map.size());
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc) {
+    if (ssrc % 3 == 1) {
+      EXPECT_EQ(nullptr, map.Find(ssrc));
+    } else {
+      ASSERT_NE(nullptr, map.Find(ssrc));
+      EXPECT_EQ(static_cast<int>(ssrc % 3), *map.Find(ssrc));
+    }
+  }
+}
+
+TEST(FlatSsrcMapTest, ManyEntriesSurviveGrowthAndErasure) {
+  const std::vector<uint32_t> ssrcs = RandomSsrcs(5000);
+  FlatSsrcMap<size_t> map;
+  for (size_t i = 0; i < ssrcs.size(); ++i)
+    EXPECT_TRUE(map.Emplace(ssrcs[i], i).second);
+  EXPECT_EQ(ssrcs.size(), map.size());
+
+  // Erase every other entry; the rest must still be reachable even though
+  // their probe sequences went through the erased slots.
+  for (size_t i = 0; i < ssrcs.size(); i += 2)
+    EXPECT_TRUE(map.Erase(ssrcs[i]));
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    const size_t* value = map.Find(ssrcs[i]);
+    if (i % 2 == 0) {
+      EXPECT_EQ(nullptr, value);
+    } else {
+      ASSERT_NE(nullptr, value);
+      EXPECT_EQ(i, *value);
+    }
+  }
+}
+
+TEST(FlatSsrcMapTest, SequentialSsrcs) {
+  FlatSsrcMap<uint32_t> map;
+  for (uint32_t ssrc = 1000; ssrc < 3000; ++ssrc)
+    map.Emplace(ssrc, ssrc);
+  for (uint32_t ssrc = 1000; ssrc < 3000; ++ssrc) {
+    ASSERT_NE(nullptr, map.Find(ssrc));
+    EXPECT_EQ(ssrc, *map.Find(ssrc));
+  }
+  EXPECT_EQ(nullptr, map.Find(999));
+  EXPECT_EQ(nullptr, map.Find(3000));
+}
+
+TEST(FlatSsrcMapTest, CachedHitIsForgottenOnErase) {
+  FlatSsrcMap<int> map;
+  map.Emplace(111, 1);
+  ASSERT_NE(nullptr, map.Find(111));
+  EXPECT_TRUE(map.Erase(111));
+  EXPECT_EQ(nullptr, map.Find(111));
+  map.Emplace(222, 2);
+  EXPECT_EQ(nullptr, map.Find(111));
+  ASSERT_NE(nullptr, map.Find(222));
+  EXPECT_EQ(2, *map.Find(222));
+}
+
+TEST(FlatSsrcMapTest, WorksWithoutCache) {
+  FlatSsrcMap<int> map(false);
+  map.Emplace(111, 1);
+  map.Emplace(222, 2);
+  EXPECT_EQ(1, *map.Find(111));
+  EXPECT_EQ(1, *map.Find(111));
+  EXPECT_EQ(2, *map.Find(222));
+}
+
+TEST(FlatSsrcMapTest, Clear) {
+  FlatSsrcMap<int> map;
+  map.Emplace(111, 1);
+  map.Find(111);
+  map.Clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find(111));
+  map.Emplace(111, 2);
+  EXPECT_EQ(2, *map.Find(111));
+}
+
+// Compares SSRC lookup cost of std::map, which RtpDemuxer used before, with
+// FlatSsrcMap. Run with --gtest_also_run_disabled_tests.
+TEST(FlatSsrcMapTest, DISABLED_LookupPerf) {
+  for (size_t num_ssrcs : {10, 100, 1000, 10000}) {
+    const std::vector<uint32_t> ssrcs = RandomSsrcs(num_ssrcs);
+    const std::vector<uint32_t> order = LookupOrder(ssrcs);
+    const std::string trace = std::to_string(num_ssrcs) + "_ssrcs";
+
+    std::map<uint32_t, size_t> tree_map;
+    FlatSsrcMap<size_t> flat_map;
+    FlatSsrcMap<size_t> uncached_flat_map(false);
+    for (size_t i = 0; i < ssrcs.size(); ++i) {
+      tree_map.emplace(ssrcs[i], i);
+      flat_map.Emplace(ssrcs[i], i);
+      uncached_flat_map.Emplace(ssrcs[i], i);
+    }
+
+    // The sums keep the lookups from being optimized away.
+    size_t tree_sum = 0;
+    int64_t start_ns = rtc::TimeNanos();
+    for (uint32_t ssrc : order)
+      tree_sum += tree_map.find(ssrc)->second;
+    int64_t tree_ns = rtc::TimeNanos() - start_ns;
+
+    size_t uncached_sum = 0;
+    start_ns = rtc::TimeNanos();
+    for (uint32_t ssrc : order)
+      uncached_sum += *uncached_flat_map.Find(ssrc);
+    int64_t uncached_ns = rtc::TimeNanos() - start_ns;
+
+    size_t flat_sum = 0;
+    start_ns = rtc::TimeNanos();
+    for (uint32_t ssrc : order)
+      flat_sum += *flat_map.Find(ssrc);
+    int64_t flat_ns = rtc::TimeNanos() - start_ns;
+
+    EXPECT_EQ(tree_sum, uncached_sum);
+    EXPECT_EQ(tree_sum, flat_sum);
+
+    test::PrintResult("ssrc_lookup", "_std_map", trace,
+                      static_cast<double>(tree_ns) / order.size(), "ns",
+                      false);
+    test::PrintResult("ssrc_lookup", "_flat_map", trace,
+                      static_cast<double>(uncached_ns) / order.size(), "ns",
+                      false);
+    test::PrintResult("ssrc_lookup", "_flat_map_cached", trace,
+                      static_cast<double>(flat_ns) / order.size(), "ns",
+                      false);
+  }
+}
+
+}  // namespace webrtc
@@ -63,7 +63,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    sink_by_ssrc_.emplace(ssrc, sink);
+    sink_by_ssrc_.Emplace(ssrc, sink);
   }
 
   for (uint8_t payload_type : criteria.payload_types) {
@@ -103,7 +103,7 @@ bool RtpDemuxer::CriteriaWouldConflict(
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    if (sink_by_ssrc_.find(ssrc) != sink_by_ssrc_.end()) {
+    if (sink_by_ssrc_.Find(ssrc)) {
       return true;
     }
   }
@@ -143,7 +143,7 @@ void RtpDemuxer::AddSink(const std::string& rsid,
 bool RtpDemuxer::RemoveSink(const RtpPacketSinkInterface* sink) {
   RTC_DCHECK(sink);
   size_t num_removed = RemoveFromMapByValue(&sink_by_mid_, sink) +
-                       RemoveFromMapByValue(&sink_by_ssrc_, sink) +
+                       sink_by_ssrc_.EraseValue(sink) +
                        RemoveFromMultimapByValue(&sinks_by_pt_, sink) +
                        RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
                        RemoveFromMapByValue(&sink_by_rsid_, sink);
@@ -250,9 +250,9 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
 
   // We trust signaled SSRC more than payload type which is likely to conflict
   // between streams.
-  const auto ssrc_sink_it = sink_by_ssrc_.find(ssrc);
-  if (ssrc_sink_it != sink_by_ssrc_.end()) {
-    return ssrc_sink_it->second;
+  RtpPacketSinkInterface* const* sink_by_ssrc = sink_by_ssrc_.Find(ssrc);
+  if (sink_by_ssrc) {
+    return *sink_by_ssrc;
   }
 
   // Legacy senders will only signal payload type, support that as last resort.
@@ -345,14 +345,14 @@ bool RtpDemuxer::AddSsrcSinkBinding(uint32_t ssrc,
     return false;
   }
 
-  auto result = sink_by_ssrc_.emplace(ssrc, sink);
-  auto it = result.first;
+  auto result = sink_by_ssrc_.Emplace(ssrc, sink);
+  RtpPacketSinkInterface** bound_sink = result.first;
   bool inserted = result.second;
   if (inserted) {
     return true;
   }
-  if (it->second != sink) {
-    it->second = sink;
+  if (*bound_sink != sink) {
+    *bound_sink = sink;
     return true;
   }
   return false;
@@ -0,0 +1,427 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/rtp_forwarding_stream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "webrtc/modules/pacing/packet_router.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+// Same as the send side history of RTPSender.
+constexpr uint16_t kPacketHistorySize = 600;
+// Offsets of the fields rewritten in the fixed RTP header.
+constexpr size_t kSequenceNumberOffset = 2;
+constexpr size_t kTimestampOffset = 4;
+constexpr size_t kSsrcOffset = 8;
+}  // namespace
+
+// The fields of the VP8 payload descriptor (RFC 7741) a forwarding stream
+// looks at. The offsets are from the start of the RTP payload.
+struct RtpForwardingStream::Vp8PayloadDescriptor {
+  // The packet starts the first partition of a frame.
+  bool beginning_of_frame = false;
+  bool key_frame = false;
+  // -1 if the field isn't present.
+  int picture_id_offset = -1;
+  bool picture_id_15_bits = false;
+  uint16_t picture_id = 0;
+  int tl0_pic_idx_offset = -1;
+  uint8_t tl0_pic_idx = 0;
+
+  // Returns false if |payload| is too short to hold the descriptor.
+  bool Parse(rtc::ArrayView<const uint8_t> payload) {
+    if (payload.empty())
+      return false;
+    size_t offset = 0;
+    const uint8_t first = payload[offset++];
+    // S bit set and partition index 0.
+    beginning_of_frame = (first & 0x10) && (first & 0x07) == 0;
+    if (first & 0x80) {
+      if (offset >= payload.size())
+        return false;
+      const uint8_t extension = payload[offset++];
+      if (extension & 0x80) {
+        if (offset >= payload.size())
+          return false;
+        picture_id_offset = static_cast<int>(offset);
+        picture_id_15_bits = (payload[offset] & 0x80) != 0;
+        if (picture_id_15_bits) {
+          if (offset + 1 >= payload.size())
+            return false;
+          picture_id = ((payload[offset] & 0x7F) << 8) | payload[offset + 1];
+          offset += 2;
+        } else {
+          picture_id = payload[offset] & 0x7F;
+          offset += 1;
+        }
+      }
+      if (extension & 0x40) {
+        if (offset >= payload.size())
+          return false;
+        tl0_pic_idx_offset = static_cast<int>(offset);
+        tl0_pic_idx = payload[offset++];
+      }
+      // TID/Y/KEYIDX byte, present if either of the T or K bits is set.
+      if (extension & 0x30)
+        ++offset;
+    }
+    if (beginning_of_frame) {
+      if (offset >= payload.size())
+        return false;
+      // Inverse key frame flag (P bit) of the VP8 payload header.
+      key_frame = (payload[offset] & 0x01) == 0;
+    }
+    return true;
+  }
+};
+
+RtpForwardingDestination::RtpForwardingDestination(
+    Clock* clock,
+    uint32_t ssrc,
+    Transport* transport,
+    RtpPacketSender* pacer,
+    PacketRouter* packet_router)
+    : clock_(clock),
+      ssrc_(ssrc),
+      transport_(transport),
+      pacer_(pacer),
+      packet_router_(packet_router),
+      packet_history_(clock),
+      rtt_ms_(0) {
+  RTC_DCHECK(transport_);
+  RTC_DCHECK_EQ(pacer_ == nullptr, packet_router_ == nullptr);
+  packet_history_.SetStorePacketsStatus(true, kPacketHistorySize);
+  if (packet_router_)
+    packet_router_->AddForwardedStream(ssrc_, this);
+}
+
+RtpForwardingDestination::~RtpForwardingDestination() {
+  if (packet_router_)
+    packet_router_->RemoveForwardedStream(ssrc_);
+}
+
+void RtpForwardingDestination::SendPacket(
+    std::unique_ptr<RtpPacketToSend> packet) {
+  RTC_DCHECK_EQ(packet->Ssrc(), ssrc_);
+  {
+    rtc::CritScope lock(&crit_);
+    if (layer_filter_ &&
+        !layer_filter_->FilterPacket(packet.get(),
+                                     clock_->TimeInMilliseconds())) {
+      return;
+    }
+  }
+  if (!pacer_) {
+    SendToTransport(*packet);
+    packet_history_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                                 true);
+    return;
+  }
+  const uint16_t sequence_number = packet->SequenceNumber();
+  const int64_t capture_time_ms = packet->capture_time_ms();
+  const size_t packet_size = packet->size();
+  packet_history_.PutRtpPacket(std::move(packet), kAllowRetransmission, false);
+  pacer_->InsertPacket(RtpPacketSender::kNormalPriority, ssrc_,
+                       sequence_number, capture_time_ms, packet_size, false);
+}
+
+void RtpForwardingDestination::SetLayerFilter(
+    std::unique_ptr<RtpLayerFilter> layer_filter) {
+  rtc::CritScope lock(&crit_);
+  layer_filter_ = std::move(layer_filter);
+}
+
+void RtpForwardingDestination::SetTargetBitrate(uint32_t bitrate_bps) {
+  rtc::CritScope lock(&crit_);
+  if (layer_filter_)
+    layer_filter_->SetTargetBitrate(bitrate_bps);
+}
+
+bool RtpForwardingDestination::DeliverRtcp(const uint8_t* packet,
+                                           size_t length) {
+  bool has_nack = false;
+  const uint8_t* const packet_end = packet + length;
+  rtcp::CommonHeader header;
+  for (const uint8_t* next = packet; next < packet_end;
+       next = header.NextPacket()) {
+    if (!header.Parse(next, packet_end - next))
+      break;
+    if (header.type() != rtcp::Rtpfb::kPacketType ||
+        header.fmt() != rtcp::Nack::kFeedbackMessageType) {
+      continue;
+    }
+    rtcp::Nack nack;
+    if (!nack.Parse(header) || nack.media_ssrc() != ssrc_)
+      continue;
+    OnReceivedNack(nack.packet_ids());
+    has_nack = true;
+  }
+  return has_nack;
+}
+
+void RtpForwardingDestination::OnReceivedNack(
+    const std::vector<uint16_t>& sequence_numbers) {
+  int64_t rtt_ms;
+  {
+    rtc::CritScope lock(&crit_);
+    rtt_ms = rtt_ms_;
+  }
+  for (uint16_t sequence_number : sequence_numbers) {
+    if (!pacer_) {
+      std::unique_ptr<RtpPacketToSend> packet =
+          packet_history_.GetPacketAndSetSendTime(sequence_number, rtt_ms,
+                                                  true);
+      if (packet)
+        SendToTransport(*packet);
+      continue;
+    }
+    rtc::Optional<RtpPacketHistory::PacketState> state =
+        packet_history_.GetPacketStateAndSetSendTime(sequence_number, rtt_ms,
+                                                     true);
+    if (state) {
+      pacer_->InsertPacket(RtpPacketSender::kNormalPriority, ssrc_,
+                           sequence_number, state->capture_time_ms,
+                           state->packet_size, true);
+    }
+  }
+}
+
+bool RtpForwardingDestination::TimeToSendPacket(
+    uint32_t ssrc,
+    uint16_t sequence_number,
+    int64_t capture_time_ms,
+    bool retransmission,
+    const PacedPacketInfo& cluster_info) {
+  RTC_DCHECK_EQ(ssrc, ssrc_);
+  std::unique_ptr<RtpPacketToSend> packet =
+      packet_history_.GetPacketAndSetSendTime(sequence_number, 0,
+                                              retransmission);
+  if (!packet) {
+    // Already dropped from the history; don't let the pacer retry it.
+    return true;
+  }
+  return SendToTransport(*packet);
+}
+
+size_t RtpForwardingDestination::TimeToSendPadding(
+    size_t bytes,
+    const PacedPacketInfo& cluster_info) {
+  return 0;
+}
+
+void RtpForwardingDestination::OnRttUpdate(int64_t avg_rtt_ms,
+                                           int64_t max_rtt_ms) {
+  rtc::CritScope lock(&crit_);
+  rtt_ms_ = avg_rtt_ms;
+}
+
+bool RtpForwardingDestination::SendToTransport(const RtpPacketToSend& packet) {
+  return transport_->SendRtp(packet.data(), packet.size(), PacketOptions());
+}
+
+RtpForwardingStream::Config::Config() = default;
+RtpForwardingStream::Config::Config(const Config&) = default;
+RtpForwardingStream::Config::~Config() = default;
+
+RtpForwardingStream::RtpForwardingStream(
+    RtpStreamReceiverControllerInterface* receiver_controller,
+    const Config& config)
+    : config_(config),
+      target_layer_(0),
+      frame_ended_(config.layer_ssrcs.size(), false),
+      switch_sequence_number_(0),
+      sequence_number_offset_(0),
+      timestamp_offset_(0),
+      picture_id_offset_(0),
+      tl0_pic_idx_offset_(0),
+      has_forwarded_(false),
+      last_sequence_number_(0),
+      last_timestamp_(0),
+      last_arrival_time_ms_(0),
+      last_picture_id_(0),
+      last_tl0_pic_idx_(0) {
+  RTC_DCHECK(!config_.layer_ssrcs.empty());
+  for (uint32_t layer_ssrc : config_.layer_ssrcs)
+    receivers_.push_back(receiver_controller->CreateReceiver(layer_ssrc, this));
+}
+
+RtpForwardingStream::~RtpForwardingStream() = default;
+
+void RtpForwardingStream::AddDestination(
+    RtpForwardingDestination* destination) {
+  RTC_DCHECK_EQ(destination->ssrc(), config_.ssrc);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(std::find(destinations_.begin(), destinations_.end(),
+                       destination) == destinations_.end());
+  destinations_.push_back(destination);
+}
+
+void RtpForwardingStream::RemoveDestination(
+    RtpForwardingDestination* destination) {
+  rtc::CritScope lock(&crit_);
+  auto it = std::find(destinations_.begin(), destinations_.end(), destination);
+  RTC_DCHECK(it != destinations_.end());
+  if (it != destinations_.end())
+    destinations_.erase(it);
+}
+
+void RtpForwardingStream::SetTargetLayer(size_t layer) {
+  RTC_DCHECK_LT(layer, config_.layer_ssrcs.size());
+  rtc::CritScope lock(&crit_);
+  target_layer_ = layer;
+}
+
+rtc::Optional<size_t> RtpForwardingStream::active_layer() const {
+  rtc::CritScope lock(&crit_);
+  return active_layer_;
+}
+
+void RtpForwardingStream::OnRtpPacket(const RtpPacketReceived& packet) {
+  auto it = std::find(config_.layer_ssrcs.begin(), config_.layer_ssrcs.end(),
+                      packet.Ssrc());
+  if (it == config_.layer_ssrcs.end())
+    return;
+  const size_t layer = it - config_.layer_ssrcs.begin();
+
+  // Padding only packets are probes of the publisher's bandwidth, not media.
+  if (packet.payload_size() == 0)
+    return;
+
+  Vp8PayloadDescriptor vp8_descriptor;
+  const Vp8PayloadDescriptor* vp8 = nullptr;
+  if (packet.PayloadType() == config_.vp8_payload_type) {
+    if (!vp8_descriptor.Parse(packet.payload())) {
+      LOG(LS_WARNING) << "Dropping VP8 packet with a truncated descriptor.";
+      return;
+    }
+    vp8 = &vp8_descriptor;
+  }
+
+  rtc::CritScope lock(&crit_);
+  const bool frame_start = frame_ended_[layer];
+  frame_ended_[layer] = packet.Marker();
+
+  if (layer == target_layer_ && active_layer_ != rtc::Optional<size_t>(layer) &&
+      IsSwitchPoint(vp8, frame_start)) {
+    SwitchToLayer(layer, packet, vp8);
+  }
+  if (active_layer_ != rtc::Optional<size_t>(layer))
+    return;
+  // Reordered packets from before the switch would overlap with the
+  // sequence numbers of the previous layer.
+  if (IsNewerSequenceNumber(switch_sequence_number_, packet.SequenceNumber()))
+    return;
+
+  std::unique_ptr<RtpPacketToSend> forwarded = RewritePacket(packet, vp8);
+  for (RtpForwardingDestination* destination : destinations_)
+    destination->SendPacket(rtc::MakeUnique<RtpPacketToSend>(*forwarded));
+}
+
+bool RtpForwardingStream::IsSwitchPoint(const Vp8PayloadDescriptor* vp8,
+                                        bool frame_start) const {
+  if (vp8)
+    return vp8->beginning_of_frame && vp8->key_frame;
+  return frame_start;
+}
+
+void RtpForwardingStream::SwitchToLayer(size_t layer,
+                                        const RtpPacketReceived& packet,
+                                        const Vp8PayloadDescriptor* vp8) {
+  LOG(LS_INFO) << "Forwarding layer " << layer << " of ssrc "
+               << config_.layer_ssrcs[0] << " as ssrc " << config_.ssrc;
+  active_layer_ = rtc::Optional<size_t>(layer);
+  switch_sequence_number_ = packet.SequenceNumber();
+  if (!has_forwarded_)
+    return;
+  sequence_number_offset_ = last_sequence_number_ + 1 - packet.SequenceNumber();
+  // Let the new frame follow the last forwarded one by the time elapsed in
+  // between, and by at least one tick.
+  const int64_t elapsed_ms =
+      std::max<int64_t>(packet.arrival_time_ms() - last_arrival_time_ms_, 0);
+  const uint32_t elapsed_ticks = std::max<uint32_t>(
+      static_cast<uint32_t>(elapsed_ms * (kVideoPayloadTypeFrequency / 1000)),
+      1);
+  timestamp_offset_ = last_timestamp_ + elapsed_ticks - packet.Timestamp();
+  if (vp8 && vp8->picture_id_offset >= 0)
+    picture_id_offset_ = last_picture_id_ + 1 - vp8->picture_id;
+  if (vp8 && vp8->tl0_pic_idx_offset >= 0)
+    tl0_pic_idx_offset_ = last_tl0_pic_idx_ + 1 - vp8->tl0_pic_idx;
+}
+
+std::unique_ptr<RtpPacketToSend> RtpForwardingStream::RewritePacket(
+    const RtpPacketReceived& packet,
+    const Vp8PayloadDescriptor* vp8) {
+  const uint16_t sequence_number =
+      packet.SequenceNumber() + sequence_number_offset_;
+  const uint32_t timestamp = packet.Timestamp() + timestamp_offset_;
+
+  // Shares the received buffer until written to below.
+  rtc::CopyOnWriteBuffer buffer = packet.Buffer();
+  uint8_t* data = buffer.data();
+  ByteWriter<uint16_t>::WriteBigEndian(data + kSequenceNumberOffset,
+                                       sequence_number);
+  ByteWriter<uint32_t>::WriteBigEndian(data + kTimestampOffset, timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(data + kSsrcOffset, config_.ssrc);
+
+  const bool newest = !has_forwarded_ ||
+                      IsNewerSequenceNumber(sequence_number,
+                                            last_sequence_number_);
+  if (vp8) {
+    uint8_t* payload = data + packet.headers_size();
+    if (vp8->picture_id_offset >= 0) {
+      const uint16_t picture_id =
+          (vp8->picture_id + picture_id_offset_) & 0x7FFF;
+      uint8_t* field = payload + vp8->picture_id_offset;
+      if (vp8->picture_id_15_bits) {
+        field[0] = 0x80 | (picture_id >> 8);
+        field[1] = picture_id & 0xFF;
+      } else {
+        field[0] = picture_id & 0x7F;
+      }
+      if (newest)
+        last_picture_id_ = picture_id;
+    }
+    if (vp8->tl0_pic_idx_offset >= 0) {
+      const uint8_t tl0_pic_idx = vp8->tl0_pic_idx + tl0_pic_idx_offset_;
+      payload[vp8->tl0_pic_idx_offset] = tl0_pic_idx;
+      if (newest)
+        last_tl0_pic_idx_ = tl0_pic_idx;
+    }
+  }
+  if (newest) {
+    has_forwarded_ = true;
+    last_sequence_number_ = sequence_number;
+    last_timestamp_ = timestamp;
+    last_arrival_time_ms_ = packet.arrival_time_ms();
+  }
+
+  std::unique_ptr<RtpPacketToSend> forwarded =
+      rtc::MakeUnique<RtpPacketToSend>(nullptr);
+  bool parsed = forwarded->Parse(std::move(buffer));
+  RTC_DCHECK(parsed);
+  forwarded->set_capture_time_ms(packet.arrival_time_ms());
+  return forwarded;
+}
+
+}  // namespace webrtc
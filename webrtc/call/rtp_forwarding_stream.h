@@ -0,0 +1,200 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_RTP_FORWARDING_STREAM_H_
+#define WEBRTC_CALL_RTP_FORWARDING_STREAM_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/api/call/transport.h"
+#include "webrtc/call/rtp_layer_filter.h"
+#include "webrtc/call/rtp_packet_sink_interface.h"
+#include "webrtc/call/rtp_stream_receiver_controller_interface.h"
+#include "webrtc/common_types.h"
+#include "webrtc/config.h"
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/optional.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class Clock;
+class PacketRouter;
+class RtpPacketToSend;
+
+// Sends the packets of one forwarded stream on a transport, paced by the
+// pacer of the sending call, and resends them when they are NACKed. The
+// packets are stored in an RtpPacketHistory until the pacer lets them go and
+// for as long as they may be retransmitted.
+class RtpForwardingDestination : public PacedSender::PacketSender,
+                                 public CallStatsObserver {
+ public:
+  // |pacer| and |packet_router| may be null, in which case the packets are
+  // sent on |transport| right away. Otherwise the destination registers
+  // itself as the sender of |ssrc| with |packet_router|, which must be the
+  // router |pacer| sends its packets through.
+  RtpForwardingDestination(Clock* clock,
+                           uint32_t ssrc,
+                           Transport* transport,
+                           RtpPacketSender* pacer,
+                           PacketRouter* packet_router);
+  ~RtpForwardingDestination() override;
+
+  uint32_t ssrc() const { return ssrc_; }
+
+  void SendPacket(std::unique_ptr<RtpPacketToSend> packet);
+
+  // Drops the layers of the forwarded packets which the receiver doesn't have
+  // the bandwidth for, as told by SetTargetBitrate().
+  void SetLayerFilter(std::unique_ptr<RtpLayerFilter> layer_filter);
+  void SetTargetBitrate(uint32_t bitrate_bps);
+
+  // Resends the packets NACKed by |packet|, if it is an RTCP (compound)
+  // packet with NACKs for ssrc(). Returns true if there were any.
+  bool DeliverRtcp(const uint8_t* packet, size_t length);
+  void OnReceivedNack(const std::vector<uint16_t>& sequence_numbers);
+
+  // Implements PacedSender::PacketSender.
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission,
+                        const PacedPacketInfo& cluster_info) override;
+  size_t TimeToSendPadding(size_t bytes,
+                           const PacedPacketInfo& cluster_info) override;
+
+  // Implements CallStatsObserver.
+  void OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) override;
+
+ private:
+  bool SendToTransport(const RtpPacketToSend& packet);
+
+  Clock* const clock_;
+  const uint32_t ssrc_;
+  Transport* const transport_;
+  RtpPacketSender* const pacer_;
+  PacketRouter* const packet_router_;
+  RtpPacketHistory packet_history_;
+
+  rtc::CriticalSection crit_;
+  // A packet isn't resent again within one round trip time.
+  int64_t rtt_ms_ GUARDED_BY(crit_);
+  std::unique_ptr<RtpLayerFilter> layer_filter_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpForwardingDestination);
+};
+
+// Relays the RTP packets of one of the simulcast layers of a received stream
+// to any number of destinations, without decoding them. The packets are
+// rewritten into a single outgoing stream: the SSRC is replaced, and the
+// sequence numbers, RTP timestamps and, for VP8, the picture ids and
+// TL0PICIDX are offset so that they stay continuous when switching between
+// layers.
+//
+// Switching to another layer happens at the next key frame of that layer;
+// requesting it is up to the owner, which also handles the RTCP of the
+// publisher. For codecs other than VP8, the key frame can't be recognized in
+// the packets and the switch happens at the next frame start. Header
+// extensions are forwarded as they are, so the destinations must have
+// negotiated the same extension ids as the publisher.
+class RtpForwardingStream : public RtpPacketSinkInterface {
+ public:
+  struct Config {
+    Config();
+    Config(const Config&);
+    ~Config();
+
+    // The SSRCs of the received layers, lowest layer first.
+    std::vector<uint32_t> layer_ssrcs;
+    // The SSRC the packets are forwarded with.
+    uint32_t ssrc = 0;
+    // Payload type of VP8, for parsing the VP8 payload descriptor. -1 if VP8
+    // isn't used.
+    int vp8_payload_type = -1;
+
+    // Of the received layers, for the bandwidth estimation of the receiving
+    // call.
+    std::vector<RtpExtension> rtp_header_extensions;
+    bool transport_cc = false;
+  };
+
+  RtpForwardingStream(RtpStreamReceiverControllerInterface* receiver_controller,
+                      const Config& config);
+  ~RtpForwardingStream() override;
+
+  const Config& config() const { return config_; }
+
+  // Destinations must be removed before they are destroyed.
+  void AddDestination(RtpForwardingDestination* destination);
+  void RemoveDestination(RtpForwardingDestination* destination);
+
+  // Forwards layer |layer|, an index into |config.layer_ssrcs|, from its next
+  // key frame on. Until then, the current layer keeps being forwarded.
+  void SetTargetLayer(size_t layer);
+  // The layer currently forwarded, if any.
+  rtc::Optional<size_t> active_layer() const;
+
+  // Implements RtpPacketSinkInterface.
+  void OnRtpPacket(const RtpPacketReceived& packet) override;
+
+ private:
+  struct Vp8PayloadDescriptor;
+
+  // Whether the output can switch to the layer at a packet with |vp8|, its
+  // VP8 payload descriptor if any. |frame_start| tells if the previous packet
+  // of the layer ended a frame.
+  bool IsSwitchPoint(const Vp8PayloadDescriptor* vp8, bool frame_start) const;
+  void SwitchToLayer(size_t layer,
+                     const RtpPacketReceived& packet,
+                     const Vp8PayloadDescriptor* vp8)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  std::unique_ptr<RtpPacketToSend> RewritePacket(
+      const RtpPacketReceived& packet,
+      const Vp8PayloadDescriptor* vp8) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const Config config_;
+  std::vector<std::unique_ptr<RtpStreamReceiverInterface>> receivers_;
+
+  rtc::CriticalSection crit_;
+  std::vector<RtpForwardingDestination*> destinations_ GUARDED_BY(crit_);
+  size_t target_layer_ GUARDED_BY(crit_);
+  rtc::Optional<size_t> active_layer_ GUARDED_BY(crit_);
+  // Per layer, whether the last received packet ended a frame.
+  std::vector<bool> frame_ended_ GUARDED_BY(crit_);
+
+  // Sequence number of the first forwarded packet of the active layer. Older
+  // packets of the layer are dropped.
+  uint16_t switch_sequence_number_ GUARDED_BY(crit_);
+  // Added to the values of the active layer to get the forwarded ones.
+  uint16_t sequence_number_offset_ GUARDED_BY(crit_);
+  uint32_t timestamp_offset_ GUARDED_BY(crit_);
+  uint16_t picture_id_offset_ GUARDED_BY(crit_);
+  uint8_t tl0_pic_idx_offset_ GUARDED_BY(crit_);
+
+  // The newest forwarded values, from which the offsets continue after a
+  // switch.
+  bool has_forwarded_ GUARDED_BY(crit_);
+  uint16_t last_sequence_number_ GUARDED_BY(crit_);
+  uint32_t last_timestamp_ GUARDED_BY(crit_);
+  int64_t last_arrival_time_ms_ GUARDED_BY(crit_);
+  uint16_t last_picture_id_ GUARDED_BY(crit_);
+  uint8_t last_tl0_pic_idx_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpForwardingStream);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_RTP_FORWARDING_STREAM_H_
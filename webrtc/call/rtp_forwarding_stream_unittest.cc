@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/call/rtp_forwarding_stream.h"
+#include "webrtc/call/rtp_stream_receiver_controller.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gmock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/mock_transport.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+constexpr int kVp8PayloadType = 100;
+constexpr uint32_t kLowSsrc = 1111;
+constexpr uint32_t kHighSsrc = 2222;
+constexpr uint32_t kForwardedSsrc = 3333;
+
+struct ForwardedPacket {
+  uint32_t ssrc;
+  uint16_t sequence_number;
+  uint32_t timestamp;
+  uint16_t picture_id;
+};
+
+RtpPacketReceived CreateVp8Packet(uint32_t ssrc,
+                                  uint16_t sequence_number,
+                                  uint32_t timestamp,
+                                  uint16_t picture_id,
+                                  bool beginning_of_frame,
+                                  bool key_frame,
+                                  int64_t arrival_time_ms) {
+  RtpPacketToSend packet(nullptr);
+  packet.SetPayloadType(kVp8PayloadType);
+  packet.SetSsrc(ssrc);
+  packet.SetSequenceNumber(sequence_number);
+  packet.SetTimestamp(timestamp);
+  packet.SetMarker(true);
+  uint8_t* payload = packet.AllocatePayload(5);
+  // X bit, and S bit if beginning a frame.
+  payload[0] = beginning_of_frame ? 0x90 : 0x80;
+  // I bit: 15 bit picture id follows.
+  payload[1] = 0x80;
+  payload[2] = 0x80 | (picture_id >> 8);
+  payload[3] = picture_id & 0xFF;
+  // Inverse key frame flag.
+  payload[4] = key_frame ? 0x00 : 0x01;
+
+  RtpPacketReceived received;
+  EXPECT_TRUE(received.Parse(packet.Buffer()));
+  received.set_arrival_time_ms(arrival_time_ms);
+  return received;
+}
+
+class RtpForwardingStreamTest : public ::testing::Test {
+ protected:
+  RtpForwardingStreamTest() : clock_(123456) {
+    RtpForwardingStream::Config config;
+    config.layer_ssrcs = {kLowSsrc, kHighSsrc};
+    config.ssrc = kForwardedSsrc;
+    config.vp8_payload_type = kVp8PayloadType;
+    stream_.reset(new RtpForwardingStream(&receiver_controller_, config));
+    destination_.reset(new RtpForwardingDestination(
+        &clock_, kForwardedSsrc, &transport_, nullptr, nullptr));
+    stream_->AddDestination(destination_.get());
+
+    ON_CALL(transport_, SendRtp(_, _, _))
+        .WillByDefault(Invoke([this](const uint8_t* data, size_t length,
+                                     const PacketOptions& options) {
+          RtpPacketReceived packet;
+          EXPECT_TRUE(packet.Parse(data, length));
+          rtc::ArrayView<const uint8_t> payload = packet.payload();
+          sent_.push_back(
+              {packet.Ssrc(), packet.SequenceNumber(), packet.Timestamp(),
+               static_cast<uint16_t>(((payload[2] & 0x7F) << 8) |
+                                     payload[3])});
+          return true;
+        }));
+  }
+
+  ~RtpForwardingStreamTest() override {
+    stream_->RemoveDestination(destination_.get());
+  }
+
+  void Receive(const RtpPacketReceived& packet) {
+    receiver_controller_.OnRtpPacket(packet);
+  }
+
+  SimulatedClock clock_;
+  ::testing::NiceMock<MockTransport> transport_;
+  RtpStreamReceiverController receiver_controller_;
+  std::unique_ptr<RtpForwardingStream> stream_;
+  std::unique_ptr<RtpForwardingDestination> destination_;
+  std::vector<ForwardedPacket> sent_;
+};
+
+}  // namespace
+
+TEST_F(RtpForwardingStreamTest, WaitsForKeyFrameOfTargetLayer) {
+  Receive(CreateVp8Packet(kLowSsrc, 10, 9000, 100, true, false, 0));
+  Receive(CreateVp8Packet(kHighSsrc, 20, 9000, 200, true, true, 0));
+  EXPECT_TRUE(sent_.empty());
+  EXPECT_FALSE(stream_->active_layer());
+
+  Receive(CreateVp8Packet(kLowSsrc, 11, 12000, 101, true, true, 33));
+  ASSERT_EQ(1u, sent_.size());
+  EXPECT_EQ(rtc::Optional<size_t>(0), stream_->active_layer());
+  EXPECT_EQ(kForwardedSsrc, sent_[0].ssrc);
+  EXPECT_EQ(11, sent_[0].sequence_number);
+  EXPECT_EQ(12000u, sent_[0].timestamp);
+  EXPECT_EQ(101, sent_[0].picture_id);
+  // Other layers aren't forwarded.
+  Receive(CreateVp8Packet(kHighSsrc, 21, 12000, 201, true, true, 33));
+  EXPECT_EQ(1u, sent_.size());
+}
+
+TEST_F(RtpForwardingStreamTest, KeepsForwardedStreamContinuousOnSwitch) {
+  Receive(CreateVp8Packet(kLowSsrc, 10, 9000, 100, true, true, 0));
+  Receive(CreateVp8Packet(kLowSsrc, 11, 12000, 101, true, false, 33));
+
+  stream_->SetTargetLayer(1);
+  // Keeps forwarding the low layer until the high layer has a key frame.
+  Receive(CreateVp8Packet(kHighSsrc, 500, 70000, 7000, true, false, 66));
+  Receive(CreateVp8Packet(kLowSsrc, 12, 15000, 102, true, false, 66));
+  Receive(CreateVp8Packet(kHighSsrc, 501, 73000, 7001, true, true, 100));
+  Receive(CreateVp8Packet(kLowSsrc, 13, 18000, 103, true, false, 100));
+  Receive(CreateVp8Packet(kHighSsrc, 502, 76000, 7002, true, false, 133));
+
+  EXPECT_EQ(rtc::Optional<size_t>(1), stream_->active_layer());
+  ASSERT_EQ(5u, sent_.size());
+  for (size_t i = 0; i < sent_.size(); ++i) {
+    EXPECT_EQ(kForwardedSsrc, sent_[i].ssrc);
+    EXPECT_EQ(10 + i, sent_[i].sequence_number);
+    EXPECT_EQ(100 + i, sent_[i].picture_id);
+  }
+  // The key frame follows by the 34 ms between the arrivals.
+  EXPECT_EQ(15000u + 34 * 90, sent_[3].timestamp);
+  EXPECT_EQ(15000u + 34 * 90 + 3000, sent_[4].timestamp);
+}
+
+TEST_F(RtpForwardingStreamTest, DestinationResendsNackedPackets) {
+  Receive(CreateVp8Packet(kLowSsrc, 10, 9000, 100, true, true, 0));
+  Receive(CreateVp8Packet(kLowSsrc, 11, 12000, 101, true, false, 33));
+  ASSERT_EQ(2u, sent_.size());
+
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(4444);
+  nack.SetMediaSsrc(kForwardedSsrc);
+  const uint16_t kNackedSequenceNumber = 10;
+  nack.SetPacketIds(&kNackedSequenceNumber, 1);
+  rtc::Buffer rtcp = nack.Build();
+  EXPECT_TRUE(destination_->DeliverRtcp(rtcp.data(), rtcp.size()));
+  ASSERT_EQ(3u, sent_.size());
+  EXPECT_EQ(10, sent_[2].sequence_number);
+  EXPECT_EQ(100, sent_[2].picture_id);
+
+  // NACKs for other streams are ignored.
+  nack.SetMediaSsrc(kLowSsrc);
+  rtcp = nack.Build();
+  EXPECT_FALSE(destination_->DeliverRtcp(rtcp.data(), rtcp.size()));
+  EXPECT_EQ(3u, sent_.size());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/rtp_layer_filter.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet.h"
+
+namespace webrtc {
+namespace {
+constexpr int64_t kBitrateWindowMs = 1000;
+
+int LayerIndex(uint8_t index, uint8_t no_index, int max_layers) {
+  if (index == no_index)
+    return 0;
+  return std::min<int>(index, max_layers - 1);
+}
+}  // namespace
+
+RtpLayerFilter::RtpLayerFilter(int vp8_payload_type, int vp9_payload_type)
+    : vp8_payload_type_(vp8_payload_type),
+      vp9_payload_type_(vp9_payload_type),
+      vp8_depacketizer_(RtpDepacketizer::Create(kRtpVideoVp8)),
+      vp9_depacketizer_(RtpDepacketizer::Create(kRtpVideoVp9)),
+      target_bitrate_bps_(std::numeric_limits<uint32_t>::max()),
+      window_start_ms_(-1),
+      target_spatial_layer_(kMaxSpatialLayers - 1),
+      target_temporal_layer_(kMaxTemporalStreams - 1),
+      spatial_layer_(kMaxSpatialLayers - 1),
+      temporal_layer_(kMaxTemporalStreams - 1),
+      num_dropped_packets_(0) {
+  std::fill(&layer_bytes_[0][0],
+            &layer_bytes_[0][0] + kMaxSpatialLayers * kMaxTemporalStreams, 0);
+  std::fill(&layer_bitrates_bps_[0][0],
+            &layer_bitrates_bps_[0][0] +
+                kMaxSpatialLayers * kMaxTemporalStreams,
+            0);
+}
+
+RtpLayerFilter::~RtpLayerFilter() = default;
+
+void RtpLayerFilter::SetTargetBitrate(uint32_t bitrate_bps) {
+  rtc::CritScope lock(&crit_);
+  target_bitrate_bps_ = bitrate_bps;
+  SelectTargetLayers();
+}
+
+bool RtpLayerFilter::FilterPacket(rtp::Packet* packet, int64_t now_ms) {
+  const int payload_type = packet->PayloadType();
+  const bool is_vp8 = payload_type == vp8_payload_type_;
+  const bool is_vp9 = payload_type == vp9_payload_type_;
+  RtpDepacketizer::ParsedPayload parsed;
+  rtc::ArrayView<const uint8_t> payload = packet->payload();
+  const bool parsed_descriptor =
+      (is_vp8 || is_vp9) && !payload.empty() &&
+      (is_vp8 ? vp8_depacketizer_ : vp9_depacketizer_)
+          ->Parse(&parsed, payload.data(), payload.size());
+
+  rtc::CritScope lock(&crit_);
+  if (parsed_descriptor) {
+    int spatial_idx = 0;
+    int temporal_idx;
+    bool picture_start;
+    bool up_switch;
+    bool end_of_layer_frame = false;
+    if (is_vp8) {
+      const RTPVideoHeaderVP8& vp8 = parsed.type.Video.codecHeader.VP8;
+      temporal_idx =
+          LayerIndex(vp8.temporalIdx, kNoTemporalIdx, kMaxTemporalStreams);
+      picture_start = vp8.beginningOfPartition && vp8.partitionId == 0;
+      up_switch = vp8.layerSync;
+    } else {
+      const RTPVideoHeaderVP9& vp9 = parsed.type.Video.codecHeader.VP9;
+      spatial_idx =
+          LayerIndex(vp9.spatial_idx, kNoSpatialIdx, kMaxSpatialLayers);
+      temporal_idx =
+          LayerIndex(vp9.temporal_idx, kNoTemporalIdx, kMaxTemporalStreams);
+      picture_start = vp9.beginning_of_frame && spatial_idx == 0;
+      up_switch = vp9.temporal_up_switch;
+      end_of_layer_frame = vp9.end_of_frame;
+    }
+
+    layer_bytes_[spatial_idx][temporal_idx] += packet->size();
+    UpdateLayerBitrates(now_ms);
+
+    // Layers change between pictures only, so that a picture is either
+    // forwarded with all the layers selected or not at all.
+    if (picture_start) {
+      if (target_temporal_layer_ < temporal_layer_) {
+        temporal_layer_ = target_temporal_layer_;
+      } else if (temporal_idx > temporal_layer_ &&
+                 temporal_idx <= target_temporal_layer_ && up_switch) {
+        temporal_layer_ = temporal_idx;
+      }
+      if (target_spatial_layer_ < spatial_layer_ ||
+          (target_spatial_layer_ > spatial_layer_ &&
+           parsed.frame_type == kVideoFrameKey)) {
+        spatial_layer_ = target_spatial_layer_;
+      }
+    }
+
+    if (spatial_idx > spatial_layer_ || temporal_idx > temporal_layer_) {
+      ++num_dropped_packets_;
+      return false;
+    }
+    if (is_vp9 && spatial_idx == spatial_layer_ && end_of_layer_frame)
+      packet->SetMarker(true);
+  }
+
+  if (num_dropped_packets_ != 0)
+    packet->SetSequenceNumber(packet->SequenceNumber() - num_dropped_packets_);
+  return true;
+}
+
+int RtpLayerFilter::spatial_layer() const {
+  rtc::CritScope lock(&crit_);
+  return spatial_layer_;
+}
+
+int RtpLayerFilter::temporal_layer() const {
+  rtc::CritScope lock(&crit_);
+  return temporal_layer_;
+}
+
+void RtpLayerFilter::UpdateLayerBitrates(int64_t now_ms) {
+  if (window_start_ms_ < 0) {
+    window_start_ms_ = now_ms;
+    return;
+  }
+  const int64_t elapsed_ms = now_ms - window_start_ms_;
+  if (elapsed_ms < kBitrateWindowMs)
+    return;
+  for (int s = 0; s < kMaxSpatialLayers; ++s) {
+    for (int t = 0; t < kMaxTemporalStreams; ++t) {
+      layer_bitrates_bps_[s][t] =
+          static_cast<uint32_t>(layer_bytes_[s][t] * 8000 / elapsed_ms);
+      layer_bytes_[s][t] = 0;
+    }
+  }
+  window_start_ms_ = now_ms;
+  SelectTargetLayers();
+}
+
+void RtpLayerFilter::SelectTargetLayers() {
+  // The highest spatial layer of which at least the base temporal layer
+  // fits, all the layers below included, and the highest temporal layer that
+  // fits with it. Not fitting at all still leaves the base layers.
+  int best_spatial_layer = 0;
+  int best_temporal_layer = 0;
+  for (int s = 0; s < kMaxSpatialLayers; ++s) {
+    for (int t = 0; t < kMaxTemporalStreams; ++t) {
+      uint64_t bitrate_bps = 0;
+      for (int lower_s = 0; lower_s <= s; ++lower_s) {
+        for (int lower_t = 0; lower_t <= t; ++lower_t)
+          bitrate_bps += layer_bitrates_bps_[lower_s][lower_t];
+      }
+      if (bitrate_bps > target_bitrate_bps_)
+        break;
+      best_spatial_layer = s;
+      best_temporal_layer = t;
+    }
+  }
+  target_spatial_layer_ = best_spatial_layer;
+  target_temporal_layer_ = best_temporal_layer;
+}
+
+}  // namespace webrtc
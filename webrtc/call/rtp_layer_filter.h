@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_RTP_LAYER_FILTER_H_
+#define WEBRTC_CALL_RTP_LAYER_FILTER_H_
+
+#include <memory>
+
+#include "webrtc/common_types.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace rtp {
+class Packet;
+}  // namespace rtp
+
+// Selects the temporal and spatial layers of a forwarded VP8 or VP9 stream
+// that fit in the bandwidth estimate of one receiver, and drops the packets of
+// the layers above. The bitrate of each layer is measured from the packets
+// passing through the filter, and the selection follows the target bitrate.
+//
+// Only the payload descriptor of the packets is parsed. Dropping a temporal
+// layer happens at the next frame start, adding one back at the next frame of
+// that layer that allows switching up. Spatial layers are added back at key
+// frames only; requesting one is up to the owner. The sequence numbers of the
+// packets which are let through are rewritten to stay continuous, and for VP9
+// the marker bit is set on the last packet of the highest forwarded spatial
+// layer, as the receiver expects it at the end of each picture.
+class RtpLayerFilter {
+ public:
+  // Packets of other payload types are forwarded untouched. Either payload
+  // type may be -1 if the codec isn't used.
+  RtpLayerFilter(int vp8_payload_type, int vp9_payload_type);
+  ~RtpLayerFilter();
+
+  void SetTargetBitrate(uint32_t bitrate_bps);
+
+  // Returns false if |packet| should be dropped. Otherwise |packet| may have
+  // been rewritten, and is to be sent.
+  bool FilterPacket(rtp::Packet* packet, int64_t now_ms);
+
+  // The layers currently forwarded.
+  int spatial_layer() const;
+  int temporal_layer() const;
+
+ private:
+  // Updates the layer bitrates once a measurement window has passed.
+  void UpdateLayerBitrates(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void SelectTargetLayers() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const int vp8_payload_type_;
+  const int vp9_payload_type_;
+  const std::unique_ptr<RtpDepacketizer> vp8_depacketizer_;
+  const std::unique_ptr<RtpDepacketizer> vp9_depacketizer_;
+
+  rtc::CriticalSection crit_;
+  uint32_t target_bitrate_bps_ GUARDED_BY(crit_);
+  // Incoming bytes per spatial and temporal layer since |window_start_ms_|,
+  // and the bitrates measured in the previous window.
+  int64_t window_start_ms_ GUARDED_BY(crit_);
+  size_t layer_bytes_[kMaxSpatialLayers][kMaxTemporalStreams]
+      GUARDED_BY(crit_);
+  uint32_t layer_bitrates_bps_[kMaxSpatialLayers][kMaxTemporalStreams]
+      GUARDED_BY(crit_);
+  int target_spatial_layer_ GUARDED_BY(crit_);
+  int target_temporal_layer_ GUARDED_BY(crit_);
+  int spatial_layer_ GUARDED_BY(crit_);
+  int temporal_layer_ GUARDED_BY(crit_);
+  // Subtracted from the sequence numbers of forwarded packets.
+  uint16_t num_dropped_packets_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpLayerFilter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_RTP_LAYER_FILTER_H_
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/call/rtp_layer_filter.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kVp8PayloadType = 100;
+constexpr int kVp9PayloadType = 101;
+constexpr size_t kPayloadSize = 100;
+constexpr int64_t kFrameIntervalMs = 33;
+
+RtpPacketToSend CreatePacket(int payload_type,
+                             uint16_t sequence_number,
+                             bool marker,
+                             const std::vector<uint8_t>& descriptor) {
+  RtpPacketToSend packet(nullptr);
+  packet.SetPayloadType(payload_type);
+  packet.SetSequenceNumber(sequence_number);
+  packet.SetMarker(marker);
+  uint8_t* payload = packet.AllocatePayload(kPayloadSize);
+  memset(payload, 0, kPayloadSize);
+  memcpy(payload, descriptor.data(), descriptor.size());
+  return packet;
+}
+
+// A single packet VP8 frame of temporal layer |tid|.
+RtpPacketToSend CreateVp8Packet(uint16_t sequence_number,
+                                int tid,
+                                bool layer_sync,
+                                bool key_frame) {
+  std::vector<uint8_t> descriptor = {
+      0x90,  // X and S bits, partition 0.
+      0x20,  // T bit.
+      static_cast<uint8_t>((tid << 6) | (layer_sync ? 0x20 : 0)),
+      // VP8 payload header, with the P bit cleared for key frames, and the
+      // start code and size of a key frame.
+      static_cast<uint8_t>(key_frame ? 0x00 : 0x01), 0x00, 0x00, 0x9d, 0x01,
+      0x2a, 0x40, 0x01, 0xf0, 0x00};
+  return CreatePacket(kVp8PayloadType, sequence_number, true, descriptor);
+}
+
+// A single packet VP9 layer frame, in non-flexible mode.
+RtpPacketToSend CreateVp9Packet(uint16_t sequence_number,
+                                int sid,
+                                bool end_of_picture,
+                                bool key_frame) {
+  std::vector<uint8_t> descriptor = {
+      // P, L, B and E bits.
+      static_cast<uint8_t>((key_frame ? 0x00 : 0x40) | 0x20 | 0x08 | 0x04),
+      // TID 0, U bit, SID and D bit for the upper spatial layers.
+      static_cast<uint8_t>(0x10 | (sid << 1) | (sid > 0 ? 0x01 : 0x00)),
+      // TL0PICIDX.
+      0x00};
+  return CreatePacket(kVp9PayloadType, sequence_number, end_of_picture,
+                      descriptor);
+}
+
+}  // namespace
+
+TEST(RtpLayerFilterTest, ForwardsEverythingWithoutTargetBitrate) {
+  RtpLayerFilter filter(kVp8PayloadType, kVp9PayloadType);
+  for (uint16_t i = 0; i < 8; ++i) {
+    RtpPacketToSend packet = CreateVp8Packet(i, i % 4 == 0 ? 0 : 2 - (i % 2),
+                                             false, i == 0);
+    EXPECT_TRUE(filter.FilterPacket(&packet, i * kFrameIntervalMs));
+    EXPECT_EQ(i, packet.SequenceNumber());
+  }
+}
+
+TEST(RtpLayerFilterTest, DropsTemporalLayersAboveTargetBitrate) {
+  RtpLayerFilter filter(kVp8PayloadType, kVp9PayloadType);
+  // Temporal layers 0, 2, 1, 2 of equal size, so that the base layer has a
+  // quarter of the bitrate.
+  const int kPattern[] = {0, 2, 1, 2};
+  uint16_t sequence_number = 0;
+  int64_t now_ms = 0;
+  size_t bytes = 0;
+  for (; now_ms <= 1000; now_ms += kFrameIntervalMs) {
+    RtpPacketToSend packet =
+        CreateVp8Packet(sequence_number, kPattern[sequence_number % 4], false,
+                        sequence_number == 0);
+    bytes += packet.size();
+    EXPECT_TRUE(filter.FilterPacket(&packet, now_ms));
+    ++sequence_number;
+  }
+  const uint32_t bitrate_bps = static_cast<uint32_t>(bytes * 8);
+  // Leaves room for the base layer only.
+  filter.SetTargetBitrate(bitrate_bps / 3);
+
+  uint16_t expected_sequence_number = sequence_number;
+  for (uint16_t i = 0; i < 8; ++i, now_ms += kFrameIntervalMs) {
+    const int tid = kPattern[sequence_number % 4];
+    RtpPacketToSend packet =
+        CreateVp8Packet(sequence_number++, tid, false, false);
+    EXPECT_EQ(tid == 0, filter.FilterPacket(&packet, now_ms));
+    if (tid == 0)
+      EXPECT_EQ(expected_sequence_number++, packet.SequenceNumber());
+  }
+  EXPECT_EQ(0, filter.temporal_layer());
+
+  // Switching up waits for a layer sync frame.
+  filter.SetTargetBitrate(bitrate_bps * 2);
+  while (kPattern[sequence_number % 4] != 1) {
+    RtpPacketToSend packet = CreateVp8Packet(
+        sequence_number, kPattern[sequence_number % 4], false, false);
+    ++sequence_number;
+    filter.FilterPacket(&packet, now_ms);
+  }
+  RtpPacketToSend packet = CreateVp8Packet(sequence_number++, 1, false, false);
+  EXPECT_FALSE(filter.FilterPacket(&packet, now_ms));
+  while (kPattern[sequence_number % 4] != 1) {
+    packet = CreateVp8Packet(sequence_number, kPattern[sequence_number % 4],
+                             false, false);
+    ++sequence_number;
+    filter.FilterPacket(&packet, now_ms);
+  }
+  packet = CreateVp8Packet(sequence_number++, 1, true, false);
+  EXPECT_TRUE(filter.FilterPacket(&packet, now_ms));
+  EXPECT_EQ(1, filter.temporal_layer());
+}
+
+TEST(RtpLayerFilterTest, SetsMarkerBitOnHighestForwardedSpatialLayer) {
+  RtpLayerFilter filter(kVp8PayloadType, kVp9PayloadType);
+  uint16_t sequence_number = 0;
+  int64_t now_ms = 0;
+  size_t base_layer_bytes = 0;
+  for (; now_ms <= 1000; now_ms += kFrameIntervalMs) {
+    for (int sid = 0; sid < 3; ++sid) {
+      RtpPacketToSend packet =
+          CreateVp9Packet(sequence_number++, sid, sid == 2, now_ms == 0);
+      if (sid == 0)
+        base_layer_bytes += packet.size();
+      EXPECT_TRUE(filter.FilterPacket(&packet, now_ms));
+    }
+  }
+  // Room for about two of the three spatial layers.
+  filter.SetTargetBitrate(static_cast<uint32_t>(base_layer_bytes * 8 * 2.5));
+
+  uint16_t expected_sequence_number = sequence_number;
+  for (int sid = 0; sid < 3; ++sid) {
+    RtpPacketToSend packet =
+        CreateVp9Packet(sequence_number++, sid, sid == 2, false);
+    EXPECT_EQ(sid < 2, filter.FilterPacket(&packet, now_ms));
+    if (sid < 2) {
+      EXPECT_EQ(expected_sequence_number++, packet.SequenceNumber());
+      EXPECT_EQ(sid == 1, packet.Marker());
+    }
+  }
+  EXPECT_EQ(1, filter.spatial_layer());
+
+  // The dropped spatial layer is added back at the next key frame only.
+  filter.SetTargetBitrate(static_cast<uint32_t>(base_layer_bytes * 8 * 10));
+  RtpPacketToSend packet = CreateVp9Packet(sequence_number++, 0, false, false);
+  EXPECT_TRUE(filter.FilterPacket(&packet, now_ms));
+  EXPECT_EQ(1, filter.spatial_layer());
+  packet = CreateVp9Packet(sequence_number++, 0, false, true);
+  EXPECT_TRUE(filter.FilterPacket(&packet, now_ms));
+  EXPECT_EQ(kMaxSpatialLayers - 1, filter.spatial_layer());
+}
+
+}  // namespace webrtc
@@ -11,7 +11,6 @@
 #include <utility>
 
 #include "webrtc/call/rtx_receive_stream.h"
-#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
 
 namespace webrtc {
 
@@ -36,23 +35,23 @@ void RtxReceiveStream::OnRtpPacket(const RtpPacketReceived& rtx_packet) {
   if (it == rtx_payload_type_map_.end()) {
     return;
   }
-  RtpPacketReceived media_packet;
-  media_packet.CopyHeaderFrom(rtx_packet);
+  media_packet_.CopyHeaderFrom(rtx_packet);
 
-  media_packet.SetSsrc(media_ssrc_);
-  media_packet.SetSequenceNumber((payload[0] << 8) + payload[1]);
-  media_packet.SetPayloadType(it->second);
+  media_packet_.SetSsrc(media_ssrc_);
+  media_packet_.SetSequenceNumber((payload[0] << 8) + payload[1]);
+  media_packet_.SetPayloadType(it->second);
+  media_packet_.set_arrival_time_ms(rtx_packet.arrival_time_ms());
 
   // Skip the RTX header.
   rtc::ArrayView<const uint8_t> rtx_payload =
       payload.subview(kRtxHeaderSize);
 
-  uint8_t* media_payload = media_packet.AllocatePayload(rtx_payload.size());
+  uint8_t* media_payload = media_packet_.AllocatePayload(rtx_payload.size());
   RTC_DCHECK(media_payload != nullptr);
 
   memcpy(media_payload, rtx_payload.data(), rtx_payload.size());
 
-  media_sink_->OnRtpPacket(media_packet);
+  media_sink_->OnRtpPacket(media_packet_);
 }
 
 }  // namespace webrtc
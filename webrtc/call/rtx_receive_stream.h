@@ -14,6 +14,7 @@
 #include <map>
 
 #include "webrtc/call/rtp_packet_sink_interface.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
 
 namespace webrtc {
 
@@ -33,6 +34,10 @@ class RtxReceiveStream : public RtpPacketSinkInterface {
   // TODO(nisse): Ultimately, the media receive stream shouldn't care about the
   // ssrc, and we should delete this.
   const uint32_t media_ssrc_;
+  // Reused for each restored packet, so that its buffer is allocated once. A
+  // media sink holding on to a copy of the packet makes the buffer shared,
+  // which then has it copied on the next write.
+  RtpPacketReceived media_packet_;
 };
 
 }  // namespace webrtc
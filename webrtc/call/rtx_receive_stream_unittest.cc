@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include "webrtc/call/rtx_receive_stream.h"
 #include "webrtc/call/test/mock_rtp_packet_sink_interface.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_extension_map.h"
@@ -128,4 +130,32 @@ TEST(RtxReceiveStreamTest, CopiesRtpHeaderExtensions) {
   rtx_sink.OnRtpPacket(rtx_packet);
 }
 
+TEST(RtxReceiveStreamTest, RestoredPacketsHeldBySinkAreNotOverwritten) {
+  StrictMock<MockRtpPacketSink> media_sink;
+  RtxReceiveStream rtx_sink(&media_sink, PayloadTypeMapping(), kMediaSSRC);
+  RtpPacketReceived rtx_packet;
+  EXPECT_TRUE(rtx_packet.Parse(rtc::ArrayView<const uint8_t>(kRtxPacket)));
+  rtx_packet.set_arrival_time_ms(123);
+
+  RtpPacketReceived held_packet;
+  EXPECT_CALL(media_sink, OnRtpPacket(_))
+      .WillOnce(testing::SaveArg<0>(&held_packet))
+      .WillOnce(testing::Invoke([](const RtpPacketReceived& packet) {
+        EXPECT_EQ(packet.SequenceNumber(), kMediaSeqno + 1);
+        EXPECT_THAT(packet.payload(), testing::ElementsAre(0xef));
+      }));
+  rtx_sink.OnRtpPacket(rtx_packet);
+
+  uint8_t next_packet[sizeof(kRtxPacket)];
+  memcpy(next_packet, kRtxPacket, sizeof(kRtxPacket));
+  next_packet[13] = kMediaSeqno + 1;
+  next_packet[14] = 0xef;
+  EXPECT_TRUE(rtx_packet.Parse(rtc::ArrayView<const uint8_t>(next_packet)));
+  rtx_sink.OnRtpPacket(rtx_packet);
+
+  EXPECT_EQ(held_packet.SequenceNumber(), kMediaSeqno);
+  EXPECT_EQ(held_packet.arrival_time_ms(), 123);
+  EXPECT_THAT(held_packet.payload(), testing::ElementsAre(0xee));
+}
+
 }  // namespace webrtc
@@ -46,11 +46,15 @@ std::string VideoReceiveStream::Stats::ToString(int64_t time_ms) const {
   ss << "render_fps: " << render_frame_rate << ", ";
   ss << "decode_ms: " << decode_ms << ", ";
   ss << "max_decode_ms: " << max_decode_ms << ", ";
+  ss << "decoder_fallbacks: {init_error: " << decoder_fallbacks_init_error
+     << ", decode_error: " << decoder_fallbacks_decode_error
+     << ", slow_decoding: " << decoder_fallbacks_slow_decoding << "}, ";
   ss << "cur_delay_ms: " << current_delay_ms << ", ";
   ss << "targ_delay_ms: " << target_delay_ms << ", ";
   ss << "jb_delay_ms: " << jitter_buffer_ms << ", ";
   ss << "min_playout_delay_ms: " << min_playout_delay_ms << ", ";
   ss << "discarded: " << discarded_packets << ", ";
+  ss << "packet_buffer_bytes: " << packet_buffer_bytes << ", ";
   ss << "sync_offset_ms: " << sync_offset_ms << ", ";
   ss << "cum_loss: " << rtcp_stats.packets_lost << ", ";
   ss << "max_ext_seq: " << rtcp_stats.extended_highest_sequence_number << ", ";
@@ -87,6 +91,10 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", pre_decode_callback: "
      << (pre_decode_callback ? "(EncodedFrameObserver)" : "nullptr");
   ss << ", target_delay_ms: " << target_delay_ms;
+  if (max_decode_framerate > 0)
+    ss << ", max_decode_framerate: " << max_decode_framerate;
+  if (max_decode_pixels > 0)
+    ss << ", max_decode_pixels: " << max_decode_pixels;
   ss << '}';
 
   return ss.str();
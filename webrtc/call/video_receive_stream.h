@@ -67,6 +67,10 @@ class VideoReceiveStream {
 
     // Decoder stats.
     std::string decoder_implementation_name = "unknown";
+    // Number of times the decoder fell back to software decoding, by reason.
+    uint32_t decoder_fallbacks_init_error = 0;
+    uint32_t decoder_fallbacks_decode_error = 0;
+    uint32_t decoder_fallbacks_slow_decoding = 0;
     FrameCounts frame_counts;
     int decode_ms = 0;
     int max_decode_ms = 0;
@@ -83,6 +87,8 @@ class VideoReceiveStream {
 
     int total_bitrate_bps = 0;
     int discarded_packets = 0;
+    // Bytes held by the packet buffer, including not yet decoded payloads.
+    size_t packet_buffer_bytes = 0;
 
     int width = 0;
     int height = 0;
@@ -100,6 +106,8 @@ class VideoReceiveStream {
     // Timing frame info: all important timestamps for a full lifetime of a
     // single 'timing frame'.
     rtc::Optional<webrtc::TimingFrameInfo> timing_frame_info;
+    // Average time spent by the timing frames in each stage of the pipeline.
+    rtc::Optional<webrtc::TimingFrameStageDelays> timing_frame_stage_delays;
   };
 
   struct Config {
@@ -215,6 +223,15 @@ class VideoReceiveStream {
     // Target delay in milliseconds. A positive value indicates this stream is
     // used for streaming instead of a real-time call.
     int target_delay_ms = 0;
+
+    // Limits for receivers that don't need every frame, e.g. for thumbnails
+    // or recording at a reduced framerate. Frames of the upper temporal
+    // layers are skipped before decoding to stay at about
+    // |max_decode_framerate|, and VP9 spatial layers above
+    // |max_decode_pixels| are not decoded. The base layers are always
+    // decoded, so the limits may not be met. 0 means no limit.
+    int max_decode_framerate = 0;
+    int max_decode_pixels = 0;
   };
 
   // Starts stream activity.
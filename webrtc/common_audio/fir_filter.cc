@@ -14,12 +14,24 @@
 
 #include <memory>
 
+#include "webrtc/common_audio/fir_filter_avx2.h"
+#include "webrtc/common_audio/fir_filter_fft.h"
 #include "webrtc/common_audio/fir_filter_neon.h"
 #include "webrtc/common_audio/fir_filter_sse.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
+namespace {
+
+// Filters with at least this many coefficients, fed with chunks of at least
+// this many samples, are faster to compute by block convolution. The AVX2
+// version of the direct convolution keeps up with it for longer filters.
+const size_t kMinFFTCoefficientsLength = 256;
+const size_t kMinFFTCoefficientsLengthAVX2 = 512;
+const size_t kMinFFTInputLength = 128;
+
+}  // namespace
 
 class FIRFilterC : public FIRFilter {
  public:
@@ -43,9 +55,25 @@ FIRFilter* FIRFilter::Create(const float* coefficients,
     return nullptr;
   }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const bool use_avx2 = WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3);
+#else
+  const bool use_avx2 = false;
+#endif
+  if (coefficients_length >= (use_avx2 ? kMinFFTCoefficientsLengthAVX2
+                                       : kMinFFTCoefficientsLength) &&
+      max_input_length >= kMinFFTInputLength) {
+    return new FIRFilterFFT(coefficients, coefficients_length,
+                            max_input_length);
+  }
+
   FIRFilter* filter = nullptr;
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2) {
+    return new FIRFilterAVX2(coefficients, coefficients_length,
+                             max_input_length);
+  }
 #if defined(__SSE2__)
   filter =
       new FIRFilterSSE2(coefficients, coefficients_length, max_input_length);
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/fir_filter_avx2.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+FIRFilterAVX2::FIRFilterAVX2(const float* coefficients,
+                             size_t coefficients_length,
+                             size_t max_input_length)
+    :  // Closest higher multiple of eight.
+      coefficients_length_((coefficients_length + 7) & ~0x07),
+      state_length_(coefficients_length_ - 1),
+      coefficients_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * coefficients_length_, 32))),
+      state_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * (max_input_length + state_length_),
+                        32))) {
+  // Add zeros at the end of the coefficients.
+  size_t padding = coefficients_length_ - coefficients_length;
+  memset(coefficients_.get(), 0, padding * sizeof(coefficients_[0]));
+  // The coefficients are reversed to compensate for the order in which the
+  // input samples are acquired (most recent last).
+  for (size_t i = 0; i < coefficients_length; ++i) {
+    coefficients_[i + padding] = coefficients[coefficients_length - i - 1];
+  }
+  memset(state_.get(),
+         0,
+         (max_input_length + state_length_) * sizeof(state_[0]));
+}
+
+void FIRFilterAVX2::Filter(const float* in, size_t length, float* out) {
+  RTC_DCHECK_GT(length, 0);
+
+  memcpy(&state_[state_length_], in, length * sizeof(*in));
+
+  // Convolves the input signal |in| with the filter kernel |coefficients_|
+  // taking into account the previous state. Long filters are split over two
+  // sums, to not be bound by the latency of the additions.
+  for (size_t i = 0; i < length; ++i) {
+    float* in_ptr = &state_[i];
+    float* coef_ptr = coefficients_.get();
+
+    __m256 m_sum = _mm256_setzero_ps();
+    __m256 m_sum2 = _mm256_setzero_ps();
+    size_t j = 0;
+    for (; j + 16 <= coefficients_length_; j += 16) {
+      m_sum = _mm256_fmadd_ps(_mm256_loadu_ps(in_ptr + j),
+                              _mm256_load_ps(coef_ptr + j), m_sum);
+      m_sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(in_ptr + j + 8),
+                               _mm256_load_ps(coef_ptr + j + 8), m_sum2);
+    }
+    if (j < coefficients_length_) {
+      m_sum = _mm256_fmadd_ps(_mm256_loadu_ps(in_ptr + j),
+                              _mm256_load_ps(coef_ptr + j), m_sum);
+    }
+    m_sum = _mm256_add_ps(m_sum, m_sum2);
+    __m128 m_sum4 = _mm_add_ps(_mm256_castps256_ps128(m_sum),
+                               _mm256_extractf128_ps(m_sum, 1));
+    m_sum4 = _mm_add_ps(_mm_movehl_ps(m_sum4, m_sum4), m_sum4);
+    _mm_store_ss(out + i,
+                 _mm_add_ss(m_sum4, _mm_shuffle_ps(m_sum4, m_sum4, 1)));
+  }
+
+  // Update current state.
+  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
+}
+
+}  // namespace webrtc
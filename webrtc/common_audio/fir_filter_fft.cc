@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/fir_filter_fft.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+FIRFilterFFT::FIRFilterFFT(const float* coefficients,
+                           size_t coefficients_length,
+                           size_t max_input_length)
+    : state_length_(coefficients_length - 1),
+      max_input_length_(max_input_length),
+      // The circular convolution wraps around into the first |state_length_|
+      // outputs only, which are not used.
+      fft_(RealFourier::Create(
+          RealFourier::FftOrder(state_length_ + max_input_length))),
+      fft_length_(RealFourier::FftLength(fft_->order())),
+      complex_length_(RealFourier::ComplexLength(fft_->order())),
+      coefficients_spectrum_(
+          RealFourier::AllocCplxBuffer(static_cast<int>(complex_length_))),
+      input_(RealFourier::AllocRealBuffer(static_cast<int>(fft_length_))),
+      spectrum_(
+          RealFourier::AllocCplxBuffer(static_cast<int>(complex_length_))),
+      output_(RealFourier::AllocRealBuffer(static_cast<int>(fft_length_))) {
+  memset(input_.get(), 0, fft_length_ * sizeof(input_[0]));
+  memcpy(input_.get(), coefficients, coefficients_length * sizeof(input_[0]));
+  fft_->Forward(input_.get(), coefficients_spectrum_.get());
+  memset(input_.get(), 0, fft_length_ * sizeof(input_[0]));
+}
+
+FIRFilterFFT::~FIRFilterFFT() {}
+
+void FIRFilterFFT::Filter(const float* in, size_t length, float* out) {
+  RTC_DCHECK_GT(length, 0);
+  RTC_DCHECK_LE(length, max_input_length_);
+
+  memcpy(&input_[state_length_], in, length * sizeof(*in));
+  // Clear what is left of a longer previous chunk.
+  std::fill(input_.get() + state_length_ + length, input_.get() + fft_length_,
+            0.f);
+
+  fft_->Forward(input_.get(), spectrum_.get());
+  for (size_t k = 0; k < complex_length_; ++k) {
+    const std::complex<float> x = spectrum_[k];
+    const std::complex<float> h = coefficients_spectrum_[k];
+    // Multiplied out, to skip the special cases of std::complex<float>.
+    spectrum_[k] = std::complex<float>(
+        x.real() * h.real() - x.imag() * h.imag(),
+        x.real() * h.imag() + x.imag() * h.real());
+  }
+  fft_->Inverse(spectrum_.get(), output_.get());
+  memcpy(out, &output_[state_length_], length * sizeof(*out));
+
+  // Update current state.
+  memmove(input_.get(), &input_[length], state_length_ * sizeof(input_[0]));
+}
+
+}  // namespace webrtc
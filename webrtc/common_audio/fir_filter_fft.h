@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_FIR_FILTER_FFT_H_
+#define WEBRTC_COMMON_AUDIO_FIR_FILTER_FFT_H_
+
+#include <memory>
+
+#include "webrtc/common_audio/fir_filter.h"
+#include "webrtc/common_audio/real_fourier.h"
+
+namespace webrtc {
+
+// Filters each chunk with one overlap-save block convolution: the state and
+// the chunk are transformed together, multiplied with the spectrum of the
+// coefficients and transformed back. The cost of a Filter() call therefore
+// depends on |max_input_length| and not on the length of the chunk, and it
+// only pays off for long filters fed with chunks of about |max_input_length|.
+class FIRFilterFFT : public FIRFilter {
+ public:
+  FIRFilterFFT(const float* coefficients,
+               size_t coefficients_length,
+               size_t max_input_length);
+  ~FIRFilterFFT() override;
+
+  void Filter(const float* in, size_t length, float* out) override;
+
+ private:
+  const size_t state_length_;
+  const size_t max_input_length_;
+  const std::unique_ptr<RealFourier> fft_;
+  const size_t fft_length_;
+  const size_t complex_length_;
+  RealFourier::fft_cplx_scoper coefficients_spectrum_;
+  // The state followed by the chunk and zero padding.
+  RealFourier::fft_real_scoper input_;
+  RealFourier::fft_cplx_scoper spectrum_;
+  RealFourier::fft_real_scoper output_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_FIR_FILTER_FFT_H_
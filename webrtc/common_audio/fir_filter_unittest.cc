@@ -10,11 +10,23 @@
 
 #include "webrtc/common_audio/fir_filter.h"
 
+#include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "webrtc/common_audio/fir_filter_fft.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gtest.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/common_audio/fir_filter_avx2.h"
+#include "webrtc/common_audio/fir_filter_sse.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#endif
 
 namespace webrtc {
 namespace {
@@ -36,6 +48,34 @@ void VerifyOutput(const float* expected_output,
                       length * sizeof(expected_output[0])));
 }
 
+std::vector<float> RandomVector(size_t length) {
+  std::vector<float> x(length);
+  for (float& value : x) {
+    value = static_cast<float>(rand()) / RAND_MAX * 2.f - 1.f;  // NOLINT
+  }
+  return x;
+}
+
+// Filters |input| in chunks of varying length, up to |max_input_length|, and
+// compares the output with a direct convolution in double precision.
+void VerifyAgainstConvolution(const std::vector<float>& coefficients,
+                              const std::vector<float>& input,
+                              size_t max_input_length,
+                              FIRFilter* filter) {
+  std::vector<float> output(input.size());
+  for (size_t i = 0, chunk = 0; i < input.size(); i += chunk) {
+    chunk = std::min(input.size() - i, (i * 7 + 1) % max_input_length + 1);
+    filter->Filter(&input[i], chunk, &output[i]);
+  }
+  for (size_t i = 0; i < input.size(); ++i) {
+    double expected = 0.0;
+    for (size_t j = 0; j < coefficients.size() && j <= i; ++j) {
+      expected += static_cast<double>(coefficients[j]) * input[i - j];
+    }
+    ASSERT_NEAR(expected, output[i], 1e-4) << i;
+  }
+}
+
 }  // namespace
 
 TEST(FIRFilterTest, FilterAsIdentity) {
@@ -208,4 +248,72 @@ TEST(FIRFilterTest, SameOutputWhenSwapedCoefficientsAndInput) {
   }
 }
 
+TEST(FIRFilterTest, LongFiltersMatchConvolution) {
+  srand(42);
+  const size_t kMaxInputLength = 480;
+  for (size_t coefficients_length : {1, 5, 8, 17, 127, 128, 300, 1000}) {
+    SCOPED_TRACE(coefficients_length);
+    const std::vector<float> coefficients = RandomVector(coefficients_length);
+    const std::vector<float> input = RandomVector(4000);
+    std::unique_ptr<FIRFilter> filter(FIRFilter::Create(
+        coefficients.data(), coefficients_length, kMaxInputLength));
+    VerifyAgainstConvolution(coefficients, input, kMaxInputLength,
+                             filter.get());
+    filter.reset(new FIRFilterFFT(coefficients.data(), coefficients_length,
+                                  kMaxInputLength));
+    VerifyAgainstConvolution(coefficients, input, kMaxInputLength,
+                             filter.get());
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+      filter.reset(new FIRFilterAVX2(coefficients.data(), coefficients_length,
+                                     kMaxInputLength));
+      VerifyAgainstConvolution(coefficients, input, kMaxInputLength,
+                               filter.get());
+    }
+#endif
+  }
+}
+
+// Measures the throughput of each implementation by filter length, for
+// 10 ms chunks at 48 kHz.
+TEST(FIRFilterTest, DISABLED_Benchmark) {
+  const size_t kChunkLength = 480;
+  const size_t kNumChunks = 2000;
+  const std::vector<float> input = RandomVector(kChunkLength);
+  std::vector<float> output(kChunkLength);
+  for (size_t coefficients_length = 4; coefficients_length <= 4096;
+       coefficients_length *= 2) {
+    const std::vector<float> coefficients = RandomVector(coefficients_length);
+    std::vector<std::pair<const char*, std::unique_ptr<FIRFilter>>> filters;
+    filters.emplace_back(
+        "Create", std::unique_ptr<FIRFilter>(FIRFilter::Create(
+                      coefficients.data(), coefficients_length, kChunkLength)));
+    filters.emplace_back(
+        "FFT", std::unique_ptr<FIRFilter>(new FIRFilterFFT(
+                   coefficients.data(), coefficients_length, kChunkLength)));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    filters.emplace_back(
+        "SSE2", std::unique_ptr<FIRFilter>(new FIRFilterSSE2(
+                    coefficients.data(), coefficients_length, kChunkLength)));
+    if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+      filters.emplace_back(
+          "AVX2", std::unique_ptr<FIRFilter>(new FIRFilterAVX2(
+                      coefficients.data(), coefficients_length, kChunkLength)));
+    }
+#endif
+    printf("%4d coefficients:", static_cast<int>(coefficients_length));
+    for (const auto& filter : filters) {
+      const int64_t start = rtc::TimeNanos();
+      for (size_t i = 0; i < kNumChunks; ++i) {
+        filter.second->Filter(input.data(), kChunkLength, output.data());
+      }
+      const double seconds = static_cast<double>(rtc::TimeNanos() - start) /
+                             rtc::kNumNanosecsPerSec;
+      printf(" %s %.1f Msamples/s;", filter.first,
+             kChunkLength * kNumChunks / seconds / 1e6);
+    }
+    printf("\n");
+  }
+}
+
 }  // namespace webrtc
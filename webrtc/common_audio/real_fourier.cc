@@ -12,6 +12,7 @@
 
 #include "webrtc/common_audio/real_fourier_ooura.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
+#include "webrtc/common_audio/real_fourier_simd.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/rtc_base/checks.h"
 
@@ -25,6 +26,9 @@ std::unique_ptr<RealFourier> RealFourier::Create(int fft_order) {
 #if defined(RTC_USE_OPENMAX_DL)
   return std::unique_ptr<RealFourier>(new RealFourierOpenmax(fft_order));
 #else
+  if (RealFourierSimd::IsSupported()) {
+    return std::unique_ptr<RealFourier>(new RealFourierSimd(fft_order));
+  }
   return std::unique_ptr<RealFourier>(new RealFourierOoura(fft_order));
 #endif
 }
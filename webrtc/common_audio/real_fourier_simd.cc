@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier_simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+using std::complex;
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+}  // namespace
+
+// static
+RealFourierSimd::StageProc RealFourierSimd::SelectStageProc() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    return Stage_AVX2;
+  }
+#if defined(__SSE2__)
+  return Stage_SSE;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? Stage_SSE : Stage_C;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return Stage_NEON;
+#else
+  return Stage_C;
+#endif
+}
+
+// static
+bool RealFourierSimd::IsSupported() {
+  return SelectStageProc() != Stage_C;
+}
+
+RealFourierSimd::RealFourierSimd(int fft_order)
+    : order_(fft_order),
+      length_(FftLength(order_)),
+      complex_length_(ComplexLength(order_)),
+      stage_proc_(SelectStageProc()),
+      twiddle_re_(AllocRealBuffer(static_cast<int>(length_ / 2))),
+      twiddle_im_(AllocRealBuffer(static_cast<int>(length_ / 2))),
+      split_re_(AllocRealBuffer(static_cast<int>(length_ / 4 + 1))),
+      split_im_(AllocRealBuffer(static_cast<int>(length_ / 4 + 1))),
+      work_(AllocRealBuffer(static_cast<int>(2 * length_))) {
+  RTC_CHECK_GE(fft_order, 1);
+  const size_t half_length = length_ / 2;
+
+  // The stage with stride s has half_length / (2 * s) blocks, each twiddled by
+  // exp(-2 pi i p s / half_length) for the block p.
+  float* twiddle_re = twiddle_re_.get();
+  float* twiddle_im = twiddle_im_.get();
+  for (size_t stride = 1; stride < half_length; stride *= 2) {
+    const size_t num_blocks = half_length / (2 * stride);
+    for (size_t p = 0; p < num_blocks; ++p) {
+      const double angle = -kPi * p / num_blocks;
+      *twiddle_re++ = static_cast<float>(std::cos(angle));
+      *twiddle_im++ = static_cast<float>(std::sin(angle));
+    }
+  }
+
+  for (size_t k = 0; k <= half_length / 2; ++k) {
+    const double angle = -kPi * k / half_length;
+    split_re_[k] = static_cast<float>(std::cos(angle));
+    split_im_[k] = static_cast<float>(std::sin(angle));
+  }
+}
+
+RealFourierSimd::~RealFourierSimd() {}
+
+void RealFourierSimd::Forward(const float* src, complex<float>* dest) const {
+  const size_t half_length = complex_length_ - 1;
+  float* re = work_.get();
+  float* im = re + half_length;
+  for (size_t k = 0; k < half_length; ++k) {
+    re[k] = src[2 * k];
+    im[k] = src[2 * k + 1];
+  }
+
+  const float* z_re = ComplexFft();
+  const float* z_im = z_re + half_length;
+
+  // With Z the FFT of the packed input, the FFTs of the even and odd samples
+  // are E[k] = (Z[k] + Z*[M - k]) / 2 and O[k] = (Z[k] - Z*[M - k]) / 2i, and
+  // X[k] = E[k] + exp(-2 pi i k / N) O[k]. The values for M - k follow from
+  // the same E[k] and O[k].
+  dest[0] = complex<float>(z_re[0] + z_im[0], 0.f);
+  dest[half_length] = complex<float>(z_re[0] - z_im[0], 0.f);
+  for (size_t k = 1; k <= half_length / 2; ++k) {
+    const size_t l = half_length - k;
+    const float even_re = 0.5f * (z_re[k] + z_re[l]);
+    const float even_im = 0.5f * (z_im[k] - z_im[l]);
+    const float odd_re = 0.5f * (z_im[k] + z_im[l]);
+    const float odd_im = -0.5f * (z_re[k] - z_re[l]);
+    const float twiddled_re = split_re_[k] * odd_re - split_im_[k] * odd_im;
+    const float twiddled_im = split_re_[k] * odd_im + split_im_[k] * odd_re;
+    dest[k] = complex<float>(even_re + twiddled_re, even_im + twiddled_im);
+    dest[l] = complex<float>(even_re - twiddled_re, twiddled_im - even_im);
+  }
+}
+
+void RealFourierSimd::Inverse(const complex<float>* src, float* dest) const {
+  const size_t half_length = complex_length_ - 1;
+  float* re = work_.get();
+  float* im = re + half_length;
+
+  // Packs the spectra E[k] and O[k] of the even and odd samples back into
+  // Z[k] = E[k] + i O[k]. The inverse FFT is computed as the conjugate of the
+  // forward FFT of the conjugate, which is scaled here by 1 / M already.
+  const float scale = 0.5f / half_length;
+  re[0] = scale * (src[0].real() + src[half_length].real());
+  im[0] = -scale * (src[0].real() - src[half_length].real());
+  for (size_t k = 1; k <= half_length / 2; ++k) {
+    const size_t l = half_length - k;
+    const float even_re = scale * (src[k].real() + src[l].real());
+    const float even_im = scale * (src[k].imag() - src[l].imag());
+    const float diff_re = scale * (src[k].real() - src[l].real());
+    const float diff_im = scale * (src[k].imag() + src[l].imag());
+    const float odd_re = diff_re * split_re_[k] + diff_im * split_im_[k];
+    const float odd_im = diff_im * split_re_[k] - diff_re * split_im_[k];
+    re[k] = even_re - odd_im;
+    im[k] = -(even_im + odd_re);
+    re[l] = even_re + odd_im;
+    im[l] = even_im - odd_re;
+  }
+
+  const float* z_re = ComplexFft();
+  const float* z_im = z_re + half_length;
+  for (size_t k = 0; k < half_length; ++k) {
+    dest[2 * k] = z_re[k];
+    dest[2 * k + 1] = -z_im[k];
+  }
+}
+
+const float* RealFourierSimd::ComplexFft() const {
+  const size_t length = complex_length_ - 1;
+  float* x = work_.get();
+  float* y = x + 2 * length;
+  const float* twiddle_re = twiddle_re_.get();
+  const float* twiddle_im = twiddle_im_.get();
+  for (size_t stride = 1; stride < length; stride *= 2) {
+    stage_proc_(length, stride, twiddle_re, twiddle_im, x, x + length, y,
+                y + length);
+    twiddle_re += length / (2 * stride);
+    twiddle_im += length / (2 * stride);
+    std::swap(x, y);
+  }
+  return x;
+}
+
+// static
+void RealFourierSimd::Stage_C(size_t length,
+                              size_t stride,
+                              const float* twiddle_re,
+                              const float* twiddle_im,
+                              const float* x_re,
+                              const float* x_im,
+                              float* y_re,
+                              float* y_im) {
+  const size_t half_length = length / 2;
+  const size_t num_blocks = half_length / stride;
+  for (size_t p = 0; p < num_blocks; ++p) {
+    const float w_re = twiddle_re[p];
+    const float w_im = twiddle_im[p];
+    for (size_t q = 0; q < stride; ++q) {
+      const size_t j = p * stride + q;
+      const size_t out = j + p * stride;
+      const float a_re = x_re[j];
+      const float a_im = x_im[j];
+      const float b_re = x_re[j + half_length];
+      const float b_im = x_im[j + half_length];
+      const float diff_re = a_re - b_re;
+      const float diff_im = a_im - b_im;
+      y_re[out] = a_re + b_re;
+      y_im[out] = a_im + b_im;
+      y_re[out + stride] = diff_re * w_re - diff_im * w_im;
+      y_im[out + stride] = diff_re * w_im + diff_im * w_re;
+    }
+  }
+}
+
+}  // namespace webrtc
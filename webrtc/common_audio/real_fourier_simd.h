@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_REAL_FOURIER_SIMD_H_
+#define WEBRTC_COMMON_AUDIO_REAL_FOURIER_SIMD_H_
+
+#include <complex>
+
+#include "webrtc/common_audio/real_fourier.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/gtest_prod_util.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Computes the real DFT of length N through a complex FFT of length N / 2,
+// which packs the even and odd input samples into the real and imaginary
+// parts. The complex FFT is a radix-2 Stockham FFT on separate arrays of real
+// and imaginary parts, so that each of its stages is a pass of straight vector
+// operations. The twiddle factors of all the stages are computed once at
+// construction. On x86 and ARM the stages are vectorized with SSE2, AVX2 or
+// NEON, chosen at run time.
+class RealFourierSimd : public RealFourier {
+ public:
+  explicit RealFourierSimd(int fft_order);
+  ~RealFourierSimd() override;
+
+  // Whether the stages are vectorized on this CPU. Otherwise, they fall back
+  // to plain C, which is slower than RealFourierOoura.
+  static bool IsSupported();
+
+  void Forward(const float* src, std::complex<float>* dest) const override;
+  void Inverse(const std::complex<float>* src, float* dest) const override;
+
+  int order() const override { return order_; }
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(RealFourierSimdTest, Stage);
+
+  // Computes one stage of the complex FFT of |length| values, in which the
+  // sub-transforms are interleaved with |stride|. With the |length| / 2 inputs
+  // pairs half a transform apart, |x| and |x + length / 2|, the sums go to the
+  // even and the twiddled differences to the odd blocks of |stride| outputs in
+  // |y|. |twiddle_re| and |twiddle_im| hold one factor per block.
+  typedef void (*StageProc)(size_t length,
+                            size_t stride,
+                            const float* twiddle_re,
+                            const float* twiddle_im,
+                            const float* x_re,
+                            const float* x_im,
+                            float* y_re,
+                            float* y_im);
+  static void Stage_C(size_t length,
+                      size_t stride,
+                      const float* twiddle_re,
+                      const float* twiddle_im,
+                      const float* x_re,
+                      const float* x_im,
+                      float* y_re,
+                      float* y_im);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void Stage_SSE(size_t length,
+                        size_t stride,
+                        const float* twiddle_re,
+                        const float* twiddle_im,
+                        const float* x_re,
+                        const float* x_im,
+                        float* y_re,
+                        float* y_im);
+  static void Stage_AVX2(size_t length,
+                         size_t stride,
+                         const float* twiddle_re,
+                         const float* twiddle_im,
+                         const float* x_re,
+                         const float* x_im,
+                         float* y_re,
+                         float* y_im);
+#elif defined(WEBRTC_HAS_NEON)
+  static void Stage_NEON(size_t length,
+                         size_t stride,
+                         const float* twiddle_re,
+                         const float* twiddle_im,
+                         const float* x_re,
+                         const float* x_im,
+                         float* y_re,
+                         float* y_im);
+#endif
+
+  static StageProc SelectStageProc();
+
+  // Computes the complex FFT of the |complex_length_ - 1| values in the first
+  // two quarters of |work_|, real parts first. Returns the real parts of the
+  // result, which are followed by the imaginary parts.
+  const float* ComplexFft() const;
+
+  const int order_;
+  const size_t length_;
+  const size_t complex_length_;
+  const StageProc stage_proc_;
+  // The twiddle factors of the complex FFT, for each stage back to back.
+  const fft_real_scoper twiddle_re_;
+  const fft_real_scoper twiddle_im_;
+  // exp(-2 pi i k / N) for k in [0, N / 4], to split up the complex FFT.
+  const fft_real_scoper split_re_;
+  const fft_real_scoper split_im_;
+  // Two buffers for the complex FFT to alternate between.
+  const fft_real_scoper work_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RealFourierSimd);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_REAL_FOURIER_SIMD_H_
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier_simd.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+namespace {
+
+// Computes the sums and the twiddled differences of the eight complex values
+// at |x| and |x + half_length|.
+void Butterfly(const float* x_re,
+               const float* x_im,
+               size_t half_length,
+               __m256 w_re,
+               __m256 w_im,
+               __m256* sum_re,
+               __m256* sum_im,
+               __m256* diff_re,
+               __m256* diff_im) {
+  const __m256 a_re = _mm256_loadu_ps(x_re);
+  const __m256 a_im = _mm256_loadu_ps(x_im);
+  const __m256 b_re = _mm256_loadu_ps(x_re + half_length);
+  const __m256 b_im = _mm256_loadu_ps(x_im + half_length);
+  *sum_re = _mm256_add_ps(a_re, b_re);
+  *sum_im = _mm256_add_ps(a_im, b_im);
+  const __m256 d_re = _mm256_sub_ps(a_re, b_re);
+  const __m256 d_im = _mm256_sub_ps(a_im, b_im);
+  *diff_re = _mm256_fmsub_ps(d_re, w_re, _mm256_mul_ps(d_im, w_im));
+  *diff_im = _mm256_fmadd_ps(d_re, w_im, _mm256_mul_ps(d_im, w_re));
+}
+
+// Stores |sums| and |diffs| at |y| with the 128-bit halves interleaved.
+void StoreInterleavedHalves(__m256 sums, __m256 diffs, float* y) {
+  _mm256_storeu_ps(y, _mm256_permute2f128_ps(sums, diffs, 0x20));
+  _mm256_storeu_ps(y + 8, _mm256_permute2f128_ps(sums, diffs, 0x31));
+}
+
+}  // namespace
+
+void RealFourierSimd::Stage_AVX2(size_t length,
+                                 size_t stride,
+                                 const float* twiddle_re,
+                                 const float* twiddle_im,
+                                 const float* x_re,
+                                 const float* x_im,
+                                 float* y_re,
+                                 float* y_im) {
+  const size_t half_length = length / 2;
+  if (half_length < 8) {
+    Stage_SSE(length, stride, twiddle_re, twiddle_im, x_re, x_im, y_re, y_im);
+    return;
+  }
+
+  __m256 sum_re, sum_im, diff_re, diff_im;
+  if (stride == 1) {
+    // Every value has its own twiddle factor, and the sums and differences
+    // are interleaved.
+    for (size_t j = 0; j < half_length; j += 8) {
+      Butterfly(x_re + j, x_im + j, half_length,
+                _mm256_loadu_ps(twiddle_re + j),
+                _mm256_loadu_ps(twiddle_im + j), &sum_re, &sum_im, &diff_re,
+                &diff_im);
+      StoreInterleavedHalves(_mm256_unpacklo_ps(sum_re, diff_re),
+                             _mm256_unpackhi_ps(sum_re, diff_re), y_re + 2 * j);
+      StoreInterleavedHalves(_mm256_unpacklo_ps(sum_im, diff_im),
+                             _mm256_unpackhi_ps(sum_im, diff_im), y_im + 2 * j);
+    }
+  } else if (stride == 2) {
+    // The sums and differences alternate in pairs.
+    const __m256i pairs = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    for (size_t j = 0; j < half_length; j += 8) {
+      const __m256 w_re = _mm256_permutevar8x32_ps(
+          _mm256_castps128_ps256(_mm_loadu_ps(twiddle_re + j / 2)), pairs);
+      const __m256 w_im = _mm256_permutevar8x32_ps(
+          _mm256_castps128_ps256(_mm_loadu_ps(twiddle_im + j / 2)), pairs);
+      Butterfly(x_re + j, x_im + j, half_length, w_re, w_im, &sum_re, &sum_im,
+                &diff_re, &diff_im);
+      StoreInterleavedHalves(
+          _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(sum_re),
+                                              _mm256_castps_pd(diff_re))),
+          _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(sum_re),
+                                              _mm256_castps_pd(diff_re))),
+          y_re + 2 * j);
+      StoreInterleavedHalves(
+          _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(sum_im),
+                                              _mm256_castps_pd(diff_im))),
+          _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(sum_im),
+                                              _mm256_castps_pd(diff_im))),
+          y_im + 2 * j);
+    }
+  } else if (stride == 4) {
+    // The sums and differences alternate in groups of four.
+    for (size_t j = 0; j < half_length; j += 8) {
+      const __m256 w_re = _mm256_insertf128_ps(
+          _mm256_castps128_ps256(_mm_set1_ps(twiddle_re[j / 4])),
+          _mm_set1_ps(twiddle_re[j / 4 + 1]), 1);
+      const __m256 w_im = _mm256_insertf128_ps(
+          _mm256_castps128_ps256(_mm_set1_ps(twiddle_im[j / 4])),
+          _mm_set1_ps(twiddle_im[j / 4 + 1]), 1);
+      Butterfly(x_re + j, x_im + j, half_length, w_re, w_im, &sum_re, &sum_im,
+                &diff_re, &diff_im);
+      StoreInterleavedHalves(sum_re, diff_re, y_re + 2 * j);
+      StoreInterleavedHalves(sum_im, diff_im, y_im + 2 * j);
+    }
+  } else {
+    const size_t num_blocks = half_length / stride;
+    for (size_t p = 0; p < num_blocks; ++p) {
+      const __m256 w_re = _mm256_set1_ps(twiddle_re[p]);
+      const __m256 w_im = _mm256_set1_ps(twiddle_im[p]);
+      const size_t in = p * stride;
+      const size_t out = 2 * p * stride;
+      for (size_t q = 0; q < stride; q += 8) {
+        Butterfly(x_re + in + q, x_im + in + q, half_length, w_re, w_im,
+                  &sum_re, &sum_im, &diff_re, &diff_im);
+        _mm256_storeu_ps(y_re + out + q, sum_re);
+        _mm256_storeu_ps(y_im + out + q, sum_im);
+        _mm256_storeu_ps(y_re + out + stride + q, diff_re);
+        _mm256_storeu_ps(y_im + out + stride + q, diff_im);
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
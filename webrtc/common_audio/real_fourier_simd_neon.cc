@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier_simd.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+namespace {
+
+// Computes the sums and the twiddled differences of the four complex values
+// at |x| and |x + half_length|.
+void Butterfly(const float* x_re,
+               const float* x_im,
+               size_t half_length,
+               float32x4_t w_re,
+               float32x4_t w_im,
+               float32x4_t* sum_re,
+               float32x4_t* sum_im,
+               float32x4_t* diff_re,
+               float32x4_t* diff_im) {
+  const float32x4_t a_re = vld1q_f32(x_re);
+  const float32x4_t a_im = vld1q_f32(x_im);
+  const float32x4_t b_re = vld1q_f32(x_re + half_length);
+  const float32x4_t b_im = vld1q_f32(x_im + half_length);
+  *sum_re = vaddq_f32(a_re, b_re);
+  *sum_im = vaddq_f32(a_im, b_im);
+  const float32x4_t d_re = vsubq_f32(a_re, b_re);
+  const float32x4_t d_im = vsubq_f32(a_im, b_im);
+  *diff_re = vmlsq_f32(vmulq_f32(d_re, w_re), d_im, w_im);
+  *diff_im = vmlaq_f32(vmulq_f32(d_re, w_im), d_im, w_re);
+}
+
+// Loads the two twiddle factors at |w|, each repeated twice.
+float32x4_t LoadTwiddlePair(const float* w) {
+  const float32x2_t m_w = vld1_f32(w);
+  const float32x2x2_t m_pairs = vzip_f32(m_w, m_w);
+  return vcombine_f32(m_pairs.val[0], m_pairs.val[1]);
+}
+
+}  // namespace
+
+void RealFourierSimd::Stage_NEON(size_t length,
+                                 size_t stride,
+                                 const float* twiddle_re,
+                                 const float* twiddle_im,
+                                 const float* x_re,
+                                 const float* x_im,
+                                 float* y_re,
+                                 float* y_im) {
+  const size_t half_length = length / 2;
+  if (half_length < 4) {
+    Stage_C(length, stride, twiddle_re, twiddle_im, x_re, x_im, y_re, y_im);
+    return;
+  }
+
+  float32x4_t sum_re, sum_im, diff_re, diff_im;
+  if (stride == 1) {
+    // Every value has its own twiddle factor, and the sums and differences
+    // are interleaved.
+    for (size_t j = 0; j < half_length; j += 4) {
+      Butterfly(x_re + j, x_im + j, half_length, vld1q_f32(twiddle_re + j),
+                vld1q_f32(twiddle_im + j), &sum_re, &sum_im, &diff_re,
+                &diff_im);
+      const float32x4x2_t re = vzipq_f32(sum_re, diff_re);
+      const float32x4x2_t im = vzipq_f32(sum_im, diff_im);
+      vst1q_f32(y_re + 2 * j, re.val[0]);
+      vst1q_f32(y_re + 2 * j + 4, re.val[1]);
+      vst1q_f32(y_im + 2 * j, im.val[0]);
+      vst1q_f32(y_im + 2 * j + 4, im.val[1]);
+    }
+  } else if (stride == 2) {
+    // The sums and differences alternate in pairs.
+    for (size_t j = 0; j < half_length; j += 4) {
+      Butterfly(x_re + j, x_im + j, half_length,
+                LoadTwiddlePair(twiddle_re + j / 2),
+                LoadTwiddlePair(twiddle_im + j / 2), &sum_re, &sum_im,
+                &diff_re, &diff_im);
+      vst1q_f32(y_re + 2 * j,
+                vcombine_f32(vget_low_f32(sum_re), vget_low_f32(diff_re)));
+      vst1q_f32(y_re + 2 * j + 4,
+                vcombine_f32(vget_high_f32(sum_re), vget_high_f32(diff_re)));
+      vst1q_f32(y_im + 2 * j,
+                vcombine_f32(vget_low_f32(sum_im), vget_low_f32(diff_im)));
+      vst1q_f32(y_im + 2 * j + 4,
+                vcombine_f32(vget_high_f32(sum_im), vget_high_f32(diff_im)));
+    }
+  } else {
+    const size_t num_blocks = half_length / stride;
+    for (size_t p = 0; p < num_blocks; ++p) {
+      const float32x4_t w_re = vdupq_n_f32(twiddle_re[p]);
+      const float32x4_t w_im = vdupq_n_f32(twiddle_im[p]);
+      const size_t in = p * stride;
+      const size_t out = 2 * p * stride;
+      for (size_t q = 0; q < stride; q += 4) {
+        Butterfly(x_re + in + q, x_im + in + q, half_length, w_re, w_im,
+                  &sum_re, &sum_im, &diff_re, &diff_im);
+        vst1q_f32(y_re + out + q, sum_re);
+        vst1q_f32(y_im + out + q, sum_im);
+        vst1q_f32(y_re + out + stride + q, diff_re);
+        vst1q_f32(y_im + out + stride + q, diff_im);
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
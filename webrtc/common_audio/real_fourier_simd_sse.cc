@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier_simd.h"
+
+#include <xmmintrin.h>
+
+namespace webrtc {
+namespace {
+
+// Computes the sums and the twiddled differences of the four complex values
+// at |x| and |x + half_length|.
+void Butterfly(const float* x_re,
+               const float* x_im,
+               size_t half_length,
+               __m128 w_re,
+               __m128 w_im,
+               __m128* sum_re,
+               __m128* sum_im,
+               __m128* diff_re,
+               __m128* diff_im) {
+  const __m128 a_re = _mm_loadu_ps(x_re);
+  const __m128 a_im = _mm_loadu_ps(x_im);
+  const __m128 b_re = _mm_loadu_ps(x_re + half_length);
+  const __m128 b_im = _mm_loadu_ps(x_im + half_length);
+  *sum_re = _mm_add_ps(a_re, b_re);
+  *sum_im = _mm_add_ps(a_im, b_im);
+  const __m128 d_re = _mm_sub_ps(a_re, b_re);
+  const __m128 d_im = _mm_sub_ps(a_im, b_im);
+  *diff_re = _mm_sub_ps(_mm_mul_ps(d_re, w_re), _mm_mul_ps(d_im, w_im));
+  *diff_im = _mm_add_ps(_mm_mul_ps(d_re, w_im), _mm_mul_ps(d_im, w_re));
+}
+
+// Loads the two twiddle factors at |w|, each repeated twice.
+__m128 LoadTwiddlePair(const float* w) {
+  const __m128 m_w =
+      _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(w));
+  return _mm_unpacklo_ps(m_w, m_w);
+}
+
+}  // namespace
+
+void RealFourierSimd::Stage_SSE(size_t length,
+                                size_t stride,
+                                const float* twiddle_re,
+                                const float* twiddle_im,
+                                const float* x_re,
+                                const float* x_im,
+                                float* y_re,
+                                float* y_im) {
+  const size_t half_length = length / 2;
+  if (half_length < 4) {
+    Stage_C(length, stride, twiddle_re, twiddle_im, x_re, x_im, y_re, y_im);
+    return;
+  }
+
+  __m128 sum_re, sum_im, diff_re, diff_im;
+  if (stride == 1) {
+    // Every value has its own twiddle factor, and the sums and differences
+    // are interleaved.
+    for (size_t j = 0; j < half_length; j += 4) {
+      Butterfly(x_re + j, x_im + j, half_length, _mm_loadu_ps(twiddle_re + j),
+                _mm_loadu_ps(twiddle_im + j), &sum_re, &sum_im, &diff_re,
+                &diff_im);
+      _mm_storeu_ps(y_re + 2 * j, _mm_unpacklo_ps(sum_re, diff_re));
+      _mm_storeu_ps(y_re + 2 * j + 4, _mm_unpackhi_ps(sum_re, diff_re));
+      _mm_storeu_ps(y_im + 2 * j, _mm_unpacklo_ps(sum_im, diff_im));
+      _mm_storeu_ps(y_im + 2 * j + 4, _mm_unpackhi_ps(sum_im, diff_im));
+    }
+  } else if (stride == 2) {
+    // The sums and differences alternate in pairs.
+    for (size_t j = 0; j < half_length; j += 4) {
+      Butterfly(x_re + j, x_im + j, half_length,
+                LoadTwiddlePair(twiddle_re + j / 2),
+                LoadTwiddlePair(twiddle_im + j / 2), &sum_re, &sum_im,
+                &diff_re, &diff_im);
+      _mm_storeu_ps(y_re + 2 * j, _mm_movelh_ps(sum_re, diff_re));
+      _mm_storeu_ps(y_re + 2 * j + 4, _mm_movehl_ps(diff_re, sum_re));
+      _mm_storeu_ps(y_im + 2 * j, _mm_movelh_ps(sum_im, diff_im));
+      _mm_storeu_ps(y_im + 2 * j + 4, _mm_movehl_ps(diff_im, sum_im));
+    }
+  } else {
+    const size_t num_blocks = half_length / stride;
+    for (size_t p = 0; p < num_blocks; ++p) {
+      const __m128 w_re = _mm_set1_ps(twiddle_re[p]);
+      const __m128 w_im = _mm_set1_ps(twiddle_im[p]);
+      const size_t in = p * stride;
+      const size_t out = 2 * p * stride;
+      for (size_t q = 0; q < stride; q += 4) {
+        Butterfly(x_re + in + q, x_im + in + q, half_length, w_re, w_im,
+                  &sum_re, &sum_im, &diff_re, &diff_im);
+        _mm_storeu_ps(y_re + out + q, sum_re);
+        _mm_storeu_ps(y_im + out + q, sum_im);
+        _mm_storeu_ps(y_re + out + stride + q, diff_re);
+        _mm_storeu_ps(y_im + out + stride + q, diff_im);
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
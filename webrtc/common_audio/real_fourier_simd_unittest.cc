@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier_simd.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <vector>
+
+#include "webrtc/common_audio/real_fourier_ooura.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+const int kMaxOrder = 12;
+
+void FillRandom(float* x, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<float>(rand()) / RAND_MAX * 2.f - 1.f;  // NOLINT
+  }
+}
+
+}  // namespace
+
+TEST(RealFourierSimdTest, MatchesOoura) {
+  srand(42);
+  for (int order = 1; order <= kMaxOrder; ++order) {
+    SCOPED_TRACE(order);
+    const size_t length = RealFourier::FftLength(order);
+    const size_t complex_length = RealFourier::ComplexLength(order);
+    RealFourierSimd simd(order);
+    RealFourierOoura ooura(order);
+    RealFourier::fft_real_scoper real =
+        RealFourier::AllocRealBuffer(static_cast<int>(length));
+    RealFourier::fft_real_scoper real_result =
+        RealFourier::AllocRealBuffer(static_cast<int>(length));
+    RealFourier::fft_cplx_scoper expected =
+        RealFourier::AllocCplxBuffer(static_cast<int>(complex_length));
+    RealFourier::fft_cplx_scoper result =
+        RealFourier::AllocCplxBuffer(static_cast<int>(complex_length));
+    FillRandom(real.get(), length);
+
+    // The rounding errors grow with the order.
+    const float tolerance = 1e-5f * (order + 1) * std::sqrt(length);
+    ooura.Forward(real.get(), expected.get());
+    simd.Forward(real.get(), result.get());
+    for (size_t k = 0; k < complex_length; ++k) {
+      EXPECT_NEAR(expected[k].real(), result[k].real(), tolerance);
+      EXPECT_NEAR(expected[k].imag(), result[k].imag(), tolerance);
+    }
+
+    simd.Inverse(result.get(), real_result.get());
+    for (size_t i = 0; i < length; ++i) {
+      EXPECT_NEAR(real[i], real_result[i], 1e-5f * (order + 1));
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(RealFourierSimdTest, Stage) {
+  const bool avx2 = WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3);
+  if (!avx2) {
+    printf("Skipping AVX2 test: AVX2 or FMA3 is not supported.\n");
+  }
+  srand(42);
+  for (size_t length = 2; length <= 1024; length *= 2) {
+    std::vector<float> twiddle_re(length / 2);
+    std::vector<float> twiddle_im(length / 2);
+    std::vector<float> x(2 * length);
+    FillRandom(twiddle_re.data(), twiddle_re.size());
+    FillRandom(twiddle_im.data(), twiddle_im.size());
+    FillRandom(x.data(), x.size());
+    for (size_t stride = 1; stride < length; stride *= 2) {
+      SCOPED_TRACE(length);
+      SCOPED_TRACE(stride);
+      std::vector<float> expected(2 * length);
+      std::vector<float> output(2 * length);
+      RealFourierSimd::Stage_C(length, stride, twiddle_re.data(),
+                               twiddle_im.data(), &x[0], &x[length],
+                               &expected[0], &expected[length]);
+      RealFourierSimd::Stage_SSE(length, stride, twiddle_re.data(),
+                                 twiddle_im.data(), &x[0], &x[length],
+                                 &output[0], &output[length]);
+      for (size_t i = 0; i < output.size(); ++i) {
+        EXPECT_NEAR(expected[i], output[i], 1e-6f);
+      }
+      if (avx2) {
+        std::fill(output.begin(), output.end(), 0.f);
+        RealFourierSimd::Stage_AVX2(length, stride, twiddle_re.data(),
+                                    twiddle_im.data(), &x[0], &x[length],
+                                    &output[0], &output[length]);
+        for (size_t i = 0; i < output.size(); ++i) {
+          EXPECT_NEAR(expected[i], output[i], 1e-6f);
+        }
+      }
+    }
+  }
+}
+#endif
+
+// Compares the time of a forward and an inverse transform with
+// RealFourierOoura for each order.
+TEST(RealFourierSimdTest, DISABLED_Benchmark) {
+  const int kIterations = 100000;
+  for (int order = 1; order <= kMaxOrder; ++order) {
+    const size_t length = RealFourier::FftLength(order);
+    RealFourierSimd simd(order);
+    RealFourierOoura ooura(order);
+    RealFourier::fft_real_scoper real =
+        RealFourier::AllocRealBuffer(static_cast<int>(length));
+    RealFourier::fft_cplx_scoper cplx =
+        RealFourier::AllocCplxBuffer(
+        static_cast<int>(RealFourier::ComplexLength(order)));
+    FillRandom(real.get(), length);
+
+    const RealFourier* const transforms[] = {&ooura, &simd};
+    double times_ns[2];
+    for (size_t i = 0; i < 2; ++i) {
+      const int64_t start = rtc::TimeNanos();
+      for (int j = 0; j < kIterations; ++j) {
+        transforms[i]->Forward(real.get(), cplx.get());
+        transforms[i]->Inverse(cplx.get(), real.get());
+      }
+      times_ns[i] =
+          static_cast<double>(rtc::TimeNanos() - start) / kIterations;
+    }
+    printf("Order %2d: RealFourierOoura %8.1f ns, RealFourierSimd %8.1f ns; "
+           "%.2fx faster.\n",
+           order, times_ns[0], times_ns[1], times_ns[0] / times_ns[1]);
+  }
+}
+
+}  // namespace webrtc
@@ -14,6 +14,7 @@
 
 #include "webrtc/common_audio/real_fourier_ooura.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
+#include "webrtc/common_audio/real_fourier_simd.h"
 #include "webrtc/test/gtest.h"
 
 namespace webrtc {
@@ -73,7 +74,8 @@ using FftTypes = ::testing::Types<
 #if defined(RTC_USE_OPENMAX_DL)
     RealFourierOpenmax,
 #endif
-    RealFourierOoura>;
+    RealFourierOoura,
+    RealFourierSimd>;
 TYPED_TEST_CASE(RealFourierTest, FftTypes);
 
 TYPED_TEST(RealFourierTest, SimpleForwardTransform) {
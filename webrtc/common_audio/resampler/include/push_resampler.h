@@ -17,10 +17,15 @@
 
 namespace webrtc {
 
+class MultiChannelSincResampler;
+class PolyphaseResampler;
 class PushSincResampler;
 
-// Wraps PushSincResampler to provide stereo support.
-// TODO(ajm): add support for an arbitrary number of channels.
+// Resamples interleaved audio with any number of channels. Mono audio uses
+// PushSincResampler, and multi-channel audio uses MultiChannelSincResampler,
+// which resamples all channels in one pass. Rates with a small integer ratio,
+// like 48 kHz and 16 kHz, use the faster PolyphaseResampler instead. They all
+// have the same kernel and delay.
 template <typename T>
 class PushResampler {
  public:
@@ -38,14 +43,11 @@ class PushResampler {
 
  private:
   std::unique_ptr<PushSincResampler> sinc_resampler_;
-  std::unique_ptr<PushSincResampler> sinc_resampler_right_;
+  std::unique_ptr<MultiChannelSincResampler> multi_channel_sinc_resampler_;
+  std::unique_ptr<PolyphaseResampler> polyphase_resampler_;
   int src_sample_rate_hz_;
   int dst_sample_rate_hz_;
   size_t num_channels_;
-  std::unique_ptr<T[]> src_left_;
-  std::unique_ptr<T[]> src_right_;
-  std::unique_ptr<T[]> dst_left_;
-  std::unique_ptr<T[]> dst_right_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/multi_channel_sinc_resampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/common_audio/resampler/sinc_kernel.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kKernelSize = SincResampler::kKernelSize;
+constexpr size_t kKernelOffsetCount = SincResampler::kKernelOffsetCount;
+
+}  // namespace
+
+MultiChannelSincResampler::ConvolveProc
+MultiChannelSincResampler::SelectConvolveProc() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    return Convolve_AVX2;
+  }
+#if defined(__SSE2__)
+  return Convolve_SSE;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
+#endif
+#else
+  // There is no NEON version yet, unlike for SincResampler.
+  return Convolve_C;
+#endif
+}
+
+MultiChannelSincResampler::MultiChannelSincResampler(size_t source_frames,
+                                                     size_t destination_frames,
+                                                     size_t num_channels)
+    : source_frames_(source_frames),
+      destination_frames_(destination_frames),
+      num_channels_(num_channels),
+      io_sample_rate_ratio_(source_frames * 1.0 / destination_frames),
+      history_frames_(kKernelSize + 1 +
+                      static_cast<size_t>(ceil(io_sample_rate_ratio_))),
+      convolve_proc_(SelectConvolveProc()),
+      block_size_(source_frames - kKernelSize / 2),
+      virtual_source_idx_(0.0),
+      kernels_((kKernelOffsetCount + 1) * kKernelSize),
+      buffer_((history_frames_ + source_frames) * num_channels, 0.f) {
+  RTC_DCHECK_GT(num_channels, 0);
+  RTC_DCHECK_GT(destination_frames, 0);
+  RTC_DCHECK_GT(source_frames, kKernelSize);
+  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
+    InitializeSincKernel(io_sample_rate_ratio_,
+                         static_cast<float>(offset_idx) / kKernelOffsetCount,
+                         &kernels_[offset_idx * kKernelSize]);
+  }
+
+  // PushSincResampler primes SincResampler with SincResampler::ChunkSize()
+  // output frames from a first block of zeros. Advance the index the same way,
+  // so that the outputs are computed at exactly the same positions.
+  const size_t chunk_size =
+      static_cast<size_t>(block_size_ / io_sample_rate_ratio_);
+  for (size_t i = 0; i < chunk_size; ++i) {
+    virtual_source_idx_ += io_sample_rate_ratio_;
+  }
+}
+
+MultiChannelSincResampler::~MultiChannelSincResampler() {}
+
+size_t MultiChannelSincResampler::Resample(const int16_t* source,
+                                           size_t source_length,
+                                           int16_t* destination,
+                                           size_t destination_capacity) {
+  const size_t source_samples = source_frames_ * num_channels_;
+  const size_t destination_samples = destination_frames_ * num_channels_;
+  RTC_CHECK_EQ(source_length, source_samples);
+  RTC_CHECK_GE(destination_capacity, destination_samples);
+  if (!float_source_) {
+    float_source_.reset(new float[source_samples]);
+    float_destination_.reset(new float[destination_samples]);
+  }
+  for (size_t i = 0; i < source_samples; ++i) {
+    float_source_[i] = static_cast<float>(source[i]);
+  }
+  Resample(float_source_.get(), source_samples, float_destination_.get(),
+           destination_samples);
+  FloatS16ToS16(float_destination_.get(), destination_samples, destination);
+  return destination_samples;
+}
+
+size_t MultiChannelSincResampler::Resample(const float* source,
+                                           size_t source_length,
+                                           float* destination,
+                                           size_t destination_capacity) {
+  const size_t num_channels = num_channels_;
+  RTC_CHECK_EQ(source_length, source_frames_ * num_channels);
+  RTC_CHECK_GE(destination_capacity, destination_frames_ * num_channels);
+
+  memcpy(&buffer_[history_frames_ * num_channels], source,
+         source_length * sizeof(*source));
+
+  // The outputs first continue in the previous block, where SincResampler
+  // would be before it requests the current block, and then proceed into the
+  // current block once |virtual_source_idx_| wraps around. The frames of the
+  // previous block are found in the history, |block_size_| frames earlier.
+  bool wrapped = false;
+  for (size_t n = 0; n < destination_frames_; ++n) {
+    if (!wrapped && virtual_source_idx_ >= block_size_) {
+      virtual_source_idx_ -= block_size_;
+      wrapped = true;
+    }
+    const size_t source_idx = static_cast<size_t>(virtual_source_idx_);
+    const double virtual_offset_idx =
+        (virtual_source_idx_ - source_idx) * kKernelOffsetCount;
+    const size_t offset_idx = static_cast<size_t>(virtual_offset_idx);
+    const float kernel_interpolation_factor =
+        static_cast<float>(virtual_offset_idx - offset_idx);
+
+    // Use the two kernels which straddle |virtual_source_idx_|.
+    const float* const k1 = &kernels_[offset_idx * kKernelSize];
+    const float* const k2 = k1 + kKernelSize;
+
+    const size_t input_frame = source_idx + history_frames_ - kKernelSize -
+                               (wrapped ? 0 : block_size_);
+    RTC_DCHECK_LE(input_frame + kKernelSize, history_frames_ + source_frames_);
+    convolve_proc_(&buffer_[input_frame * num_channels], k1, k2,
+                   kernel_interpolation_factor, num_channels,
+                   &destination[n * num_channels]);
+
+    virtual_source_idx_ += io_sample_rate_ratio_;
+  }
+  // As in PushSincResampler, every call consumes exactly one block.
+  RTC_DCHECK(wrapped);
+  block_size_ = source_frames_;
+
+  // Keep the history for the next block.
+  memmove(buffer_.data(), &buffer_[source_length],
+          history_frames_ * num_channels * sizeof(buffer_[0]));
+  return destination_frames_ * num_channels;
+}
+
+void MultiChannelSincResampler::Convolve_C(const float* input,
+                                           const float* k1,
+                                           const float* k2,
+                                           float kernel_interpolation_factor,
+                                           size_t num_channels,
+                                           float* output) {
+  float kernel[kKernelSize];
+  for (size_t i = 0; i < kKernelSize; ++i) {
+    kernel[i] = k1[i] + kernel_interpolation_factor * (k2[i] - k1[i]);
+  }
+  for (size_t c = 0; c < num_channels; ++c) {
+    float sum = 0.f;
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      sum += kernel[i] * input[i * num_channels + c];
+    }
+    output[c] = sum;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_RESAMPLER_MULTI_CHANNEL_SINC_RESAMPLER_H_
+#define WEBRTC_COMMON_AUDIO_RESAMPLER_MULTI_CHANNEL_SINC_RESAMPLER_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/gtest_prod_util.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// A push-based resampler of interleaved multi-channel audio, with the same
+// windowed sinc() kernels, and the same delay, as one PushSincResampler per
+// channel. The kernel of each output frame is interpolated once and applied to
+// all channels in a single pass over the interleaved input, instead of
+// deinterleaving, resampling and interleaving each channel separately.
+class MultiChannelSincResampler {
+ public:
+  // Provide the size of the source and destination blocks in frames. These
+  // must correspond to the same time duration (typically 10 ms) as the sample
+  // ratio is inferred from them.
+  MultiChannelSincResampler(size_t source_frames,
+                            size_t destination_frames,
+                            size_t num_channels);
+  ~MultiChannelSincResampler();
+
+  // Resamples one interleaved block of |source_length| = source_frames *
+  // num_channels samples. Returns the number of samples written to
+  // |destination|, destination_frames * num_channels, which must fit in
+  // |destination_capacity|.
+  size_t Resample(const int16_t* source,
+                  size_t source_length,
+                  int16_t* destination,
+                  size_t destination_capacity);
+  size_t Resample(const float* source,
+                  size_t source_length,
+                  float* destination,
+                  size_t destination_capacity);
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(MultiChannelSincResamplerTest, Convolve);
+
+  // Applies the kernel interpolated between |k1| and |k2| by
+  // |kernel_interpolation_factor| to the SincResampler::kKernelSize
+  // interleaved frames of |num_channels| channels at |input|, writing one
+  // output frame to |output|. The kernel is interpolated once for all the
+  // channels. On x86 the implementation is chosen at run time.
+  static void Convolve_C(const float* input,
+                         const float* k1,
+                         const float* k2,
+                         float kernel_interpolation_factor,
+                         size_t num_channels,
+                         float* output);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void Convolve_SSE(const float* input,
+                           const float* k1,
+                           const float* k2,
+                           float kernel_interpolation_factor,
+                           size_t num_channels,
+                           float* output);
+  static void Convolve_AVX2(const float* input,
+                            const float* k1,
+                            const float* k2,
+                            float kernel_interpolation_factor,
+                            size_t num_channels,
+                            float* output);
+#endif
+
+  typedef void (*ConvolveProc)(const float*,
+                               const float*,
+                               const float*,
+                               float,
+                               size_t,
+                               float*);
+  // Selects runtime specific CPU features like SSE and AVX2.
+  static ConvolveProc SelectConvolveProc();
+
+  const size_t source_frames_;
+  const size_t destination_frames_;
+  const size_t num_channels_;
+  // The ratio of input / output sample rates.
+  const double io_sample_rate_ratio_;
+  // The frames kept from the previous block: enough for the kernel, and for
+  // the outputs that continue in the previous block.
+  const size_t history_frames_;
+  const ConvolveProc convolve_proc_;
+
+  // The number of frames SincResampler processes from the previous block.
+  // It's shorter for the first block, which primes the delay.
+  size_t block_size_;
+
+  // The index of the first input frame of the next output, with sub-sample
+  // precision, as in SincResampler: relative to the previous block until it
+  // wraps around past |block_size_|. It must be double precision to avoid
+  // drift.
+  double virtual_source_idx_;
+
+  // The SincResampler::kKernelOffsetCount + 1 kernels for the sub-sample
+  // offsets from 0.0 to 1.0, back-to-back.
+  std::vector<float> kernels_;
+  // The last |history_frames_| of the previous block, followed by the current
+  // block, interleaved.
+  std::vector<float> buffer_;
+
+  std::unique_ptr<float[]> float_source_;
+  std::unique_ptr<float[]> float_destination_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MultiChannelSincResampler);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_RESAMPLER_MULTI_CHANNEL_SINC_RESAMPLER_H_
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/multi_channel_sinc_resampler.h"
+
+#include <xmmintrin.h>
+
+namespace webrtc {
+namespace {
+
+// Interpolates the four kernel taps at |k1| and |k2|.
+__m128 InterpolateKernel(const float* k1, const float* k2, __m128 m_factor) {
+  const __m128 m_k1 = _mm_loadu_ps(k1);
+  return _mm_add_ps(m_k1,
+                    _mm_mul_ps(m_factor, _mm_sub_ps(_mm_loadu_ps(k2), m_k1)));
+}
+
+// Loads the two channels at |input| of two frames, |stride| samples apart.
+__m128 LoadChannelPair(const float* input, size_t stride) {
+  const __m128 m_first =
+      _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(input));
+  return _mm_loadh_pi(m_first,
+                      reinterpret_cast<const __m64*>(input + stride));
+}
+
+}  // namespace
+
+void MultiChannelSincResampler::Convolve_SSE(const float* input,
+                                             const float* k1,
+                                             const float* k2,
+                                             float kernel_interpolation_factor,
+                                             size_t num_channels,
+                                             float* output) {
+  const size_t kKernelSize = SincResampler::kKernelSize;
+  const __m128 m_factor = _mm_set1_ps(kernel_interpolation_factor);
+  __m128 m_sums1 = _mm_setzero_ps();
+  __m128 m_sums2 = _mm_setzero_ps();
+
+  if (num_channels == 1) {
+    for (size_t i = 0; i < kKernelSize; i += 8) {
+      m_sums1 = _mm_add_ps(
+          m_sums1, _mm_mul_ps(_mm_loadu_ps(input + i),
+                              InterpolateKernel(k1 + i, k2 + i, m_factor)));
+      m_sums2 = _mm_add_ps(
+          m_sums2,
+          _mm_mul_ps(_mm_loadu_ps(input + i + 4),
+                     InterpolateKernel(k1 + i + 4, k2 + i + 4, m_factor)));
+    }
+    m_sums1 = _mm_add_ps(m_sums1, m_sums2);
+    m_sums1 = _mm_add_ps(_mm_movehl_ps(m_sums1, m_sums1), m_sums1);
+    _mm_store_ss(output,
+                 _mm_add_ss(m_sums1, _mm_shuffle_ps(m_sums1, m_sums1, 1)));
+    return;
+  }
+
+  if (num_channels == 2) {
+    // Each load holds two frames, so each kernel tap is duplicated for the
+    // two channels.
+    for (size_t i = 0; i < kKernelSize; i += 4) {
+      const __m128 m_kernel = InterpolateKernel(k1 + i, k2 + i, m_factor);
+      m_sums1 = _mm_add_ps(m_sums1,
+                           _mm_mul_ps(_mm_loadu_ps(input + 2 * i),
+                                      _mm_unpacklo_ps(m_kernel, m_kernel)));
+      m_sums2 = _mm_add_ps(m_sums2,
+                           _mm_mul_ps(_mm_loadu_ps(input + 2 * i + 4),
+                                      _mm_unpackhi_ps(m_kernel, m_kernel)));
+    }
+    // Lanes 0 and 2 hold the sums of the first channel, and lanes 1 and 3
+    // those of the second.
+    m_sums1 = _mm_add_ps(m_sums1, m_sums2);
+    _mm_storel_pi(reinterpret_cast<__m64*>(output),
+                  _mm_add_ps(_mm_movehl_ps(m_sums1, m_sums1), m_sums1));
+    return;
+  }
+
+  // Four channels at a time, with each tap of the interpolated kernel
+  // broadcast.
+  float kernel[kKernelSize];
+  for (size_t i = 0; i < kKernelSize; i += 4) {
+    _mm_storeu_ps(kernel + i, InterpolateKernel(k1 + i, k2 + i, m_factor));
+  }
+  size_t c = 0;
+  for (; c + 4 <= num_channels; c += 4) {
+    const float* const channel_input = input + c;
+    m_sums1 = _mm_setzero_ps();
+    m_sums2 = _mm_setzero_ps();
+    for (size_t i = 0; i < kKernelSize; i += 2) {
+      m_sums1 = _mm_add_ps(
+          m_sums1, _mm_mul_ps(_mm_loadu_ps(channel_input + i * num_channels),
+                              _mm_set1_ps(kernel[i])));
+      m_sums2 = _mm_add_ps(
+          m_sums2,
+          _mm_mul_ps(_mm_loadu_ps(channel_input + (i + 1) * num_channels),
+                     _mm_set1_ps(kernel[i + 1])));
+    }
+    _mm_storeu_ps(output + c, _mm_add_ps(m_sums1, m_sums2));
+  }
+  // Then two channels at a time, from pairs of frames.
+  for (; c + 2 <= num_channels; c += 2) {
+    const float* const channel_input = input + c;
+    __m128 m_sum1 = _mm_setzero_ps();
+    __m128 m_sum2 = _mm_setzero_ps();
+    for (size_t i = 0; i < kKernelSize; i += 4) {
+      const __m128 m_kernel = _mm_loadu_ps(kernel + i);
+      m_sum1 = _mm_add_ps(
+          m_sum1,
+          _mm_mul_ps(
+              LoadChannelPair(channel_input + i * num_channels, num_channels),
+              _mm_unpacklo_ps(m_kernel, m_kernel)));
+      m_sum2 = _mm_add_ps(
+          m_sum2, _mm_mul_ps(LoadChannelPair(
+                                 channel_input + (i + 2) * num_channels,
+                                 num_channels),
+                             _mm_unpackhi_ps(m_kernel, m_kernel)));
+    }
+    m_sum1 = _mm_add_ps(m_sum1, m_sum2);
+    _mm_storel_pi(reinterpret_cast<__m64*>(output + c),
+                  _mm_add_ps(_mm_movehl_ps(m_sum1, m_sum1), m_sum1));
+  }
+  for (; c < num_channels; ++c) {
+    float sum = 0.f;
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      sum += kernel[i] * input[i * num_channels + c];
+    }
+    output[c] = sum;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,257 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "webrtc/common_audio/resampler/multi_channel_sinc_resampler.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "webrtc/common_audio/resampler/push_sinc_resampler.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+struct RatePair {
+  int source_rate_hz;
+  int destination_rate_hz;
+};
+
+// Ratios without a polyphase resampler, and a few with one.
+const RatePair kRatePairs[] = {
+    {44100, 48000}, {48000, 44100}, {44100, 16000}, {16000, 44100},
+    {44100, 32000}, {32000, 44100}, {22050, 8000},  {8000, 22050},
+    {48000, 16000}, {16000, 48000},
+};
+
+const size_t kChannelCounts[] = {1, 2, 3, 4, 6, 8};
+
+std::string ProduceDebugText(const RatePair& rates, size_t num_channels) {
+  std::ostringstream ss;
+  ss << "Source rate: " << rates.source_rate_hz
+     << ", destination rate: " << rates.destination_rate_hz
+     << ", channels: " << num_channels;
+  return ss.str();
+}
+
+// Fills |block| with the next block of a sum of two sines for each of the
+// interleaved channels, with a different amplitude and frequency for each.
+void GenerateBlock(int sample_rate_hz,
+                   size_t block_index,
+                   size_t num_channels,
+                   std::vector<float>* block) {
+  const size_t frames = block->size() / num_channels;
+  for (size_t i = 0; i < frames; ++i) {
+    const double t =
+        static_cast<double>(block_index * frames + i) / sample_rate_hz;
+    for (size_t c = 0; c < num_channels; ++c) {
+      (*block)[i * num_channels + c] = static_cast<float>(
+          10000 / (c + 1) * sin(2 * M_PI * (440 + 100 * c) * t) +
+          5000 * sin(2 * M_PI * (1900 - 100 * c) * t));
+    }
+  }
+}
+
+// Resamples each channel of |source| with its own PushSincResampler.
+void ResamplePerChannel(
+    const std::vector<float>& source,
+    std::vector<std::unique_ptr<PushSincResampler>>* resamplers,
+    std::vector<float>* destination) {
+  const size_t num_channels = resamplers->size();
+  std::vector<float> channel_source(source.size() / num_channels);
+  std::vector<float> channel_destination(destination->size() / num_channels);
+  for (size_t c = 0; c < num_channels; ++c) {
+    for (size_t i = 0; i < channel_source.size(); ++i) {
+      channel_source[i] = source[i * num_channels + c];
+    }
+    (*resamplers)[c]->Resample(channel_source.data(), channel_source.size(),
+                               channel_destination.data(),
+                               channel_destination.size());
+    for (size_t i = 0; i < channel_destination.size(); ++i) {
+      (*destination)[i * num_channels + c] = channel_destination[i];
+    }
+  }
+}
+
+}  // namespace
+
+// The kernels, and the positions they are applied at, are the same as for one
+// PushSincResampler per channel. The outputs only differ by rounding, since
+// the kernels are interpolated instead of the convolutions.
+TEST(MultiChannelSincResamplerTest, MatchesPushSincResamplerPerChannel) {
+  for (const auto& rates : kRatePairs) {
+    for (size_t num_channels : kChannelCounts) {
+      SCOPED_TRACE(ProduceDebugText(rates, num_channels));
+      const size_t source_frames = rates.source_rate_hz / 100;
+      const size_t destination_frames = rates.destination_rate_hz / 100;
+      MultiChannelSincResampler resampler(source_frames, destination_frames,
+                                          num_channels);
+      std::vector<std::unique_ptr<PushSincResampler>> per_channel(
+          num_channels);
+      for (auto& channel_resampler : per_channel) {
+        channel_resampler.reset(
+            new PushSincResampler(source_frames, destination_frames));
+      }
+
+      std::vector<float> source(source_frames * num_channels);
+      std::vector<float> output(destination_frames * num_channels);
+      std::vector<float> expected_output(destination_frames * num_channels);
+      float max_difference = 0.f;
+      for (size_t block = 0; block < 10; ++block) {
+        GenerateBlock(rates.source_rate_hz, block, num_channels, &source);
+        EXPECT_EQ(output.size(),
+                  resampler.Resample(source.data(), source.size(),
+                                     output.data(), output.size()));
+        ResamplePerChannel(source, &per_channel, &expected_output);
+        for (size_t i = 0; i < output.size(); ++i) {
+          max_difference =
+              std::max(max_difference, fabsf(output[i] - expected_output[i]));
+        }
+      }
+      EXPECT_LT(max_difference, 0.01f);
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure the optimized Convolve() methods return the same values as
+// Convolve_C(), for all the channel layouts they handle differently.
+TEST(MultiChannelSincResamplerTest, Convolve) {
+  const size_t kMaxChannels = 13;
+  const size_t kKernelSize = SincResampler::kKernelSize;
+  const float kKernelInterpolationFactor = 0.3f;
+  std::vector<float> kernels(2 * kKernelSize);
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    kernels[i] = sinf(0.3f * i) / (1.f + i);
+  }
+  const float* const k1 = kernels.data();
+  const float* const k2 = k1 + kKernelSize;
+  std::vector<float> input(kKernelSize * kMaxChannels + 1);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 1000.f * cosf(0.7f * i);
+  }
+
+  const bool avx2 = WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3);
+  if (!avx2) {
+    printf("Skipping AVX2 test: AVX2 or FMA3 is not supported.\n");
+  }
+  for (size_t num_channels = 1; num_channels <= kMaxChannels;
+       ++num_channels) {
+    SCOPED_TRACE(num_channels);
+    // Start at an odd offset to check that unaligned input is handled.
+    const float* const input_ptr = &input[1];
+    std::vector<float> expected(num_channels);
+    std::vector<float> output(num_channels);
+    MultiChannelSincResampler::Convolve_C(input_ptr, k1, k2,
+                                          kKernelInterpolationFactor,
+                                          num_channels, expected.data());
+    MultiChannelSincResampler::Convolve_SSE(input_ptr, k1, k2,
+                                            kKernelInterpolationFactor,
+                                            num_channels, output.data());
+    for (size_t c = 0; c < num_channels; ++c) {
+      EXPECT_NEAR(expected[c], output[c], 0.001f);
+    }
+    if (avx2) {
+      MultiChannelSincResampler::Convolve_AVX2(input_ptr, k1, k2,
+                                               kKernelInterpolationFactor,
+                                               num_channels, output.data());
+      for (size_t c = 0; c < num_channels; ++c) {
+        EXPECT_NEAR(expected[c], output[c], 0.001f);
+      }
+    }
+  }
+}
+#endif
+
+TEST(MultiChannelSincResamplerTest, Int16MatchesFloat) {
+  const size_t kNumChannels = 2;
+  MultiChannelSincResampler float_resampler(441, 480, kNumChannels);
+  MultiChannelSincResampler int16_resampler(441, 480, kNumChannels);
+  std::vector<float> source(441 * kNumChannels);
+  std::vector<int16_t> source_int16(source.size());
+  std::vector<float> output(480 * kNumChannels);
+  std::vector<int16_t> output_int16(output.size());
+  for (size_t block = 0; block < 3; ++block) {
+    GenerateBlock(44100, block, kNumChannels, &source);
+    for (size_t i = 0; i < source.size(); ++i) {
+      source[i] = roundf(source[i]);
+      source_int16[i] = static_cast<int16_t>(source[i]);
+    }
+    float_resampler.Resample(source.data(), source.size(), output.data(),
+                             output.size());
+    EXPECT_EQ(output_int16.size(),
+              int16_resampler.Resample(source_int16.data(),
+                                       source_int16.size(),
+                                       output_int16.data(),
+                                       output_int16.size()));
+    for (size_t i = 0; i < output.size(); ++i) {
+      EXPECT_NEAR(output[i], output_int16[i], 0.5f);
+    }
+  }
+}
+
+// Compares the time to resample one second of interleaved audio with
+// MultiChannelSincResampler, and with deinterleaving, one PushSincResampler
+// per channel and interleaving.
+TEST(MultiChannelSincResamplerTest, DISABLED_Benchmark) {
+  const int kIterations = 100;
+  for (const auto& rates : kRatePairs) {
+    for (size_t num_channels : {2, 6}) {
+      const size_t source_frames = rates.source_rate_hz / 100;
+      const size_t destination_frames = rates.destination_rate_hz / 100;
+      MultiChannelSincResampler resampler(source_frames, destination_frames,
+                                          num_channels);
+      std::vector<std::unique_ptr<PushSincResampler>> per_channel(
+          num_channels);
+      for (auto& channel_resampler : per_channel) {
+        channel_resampler.reset(
+            new PushSincResampler(source_frames, destination_frames));
+      }
+      std::vector<float> source(source_frames * num_channels);
+      GenerateBlock(rates.source_rate_hz, 0, num_channels, &source);
+      std::vector<float> destination(destination_frames * num_channels);
+
+      int64_t start = rtc::TimeNanos();
+      for (int i = 0; i < kIterations * 100; ++i) {
+        ResamplePerChannel(source, &per_channel, &destination);
+      }
+      const double per_channel_time_us =
+          static_cast<double>(rtc::TimeNanos() - start) /
+          rtc::kNumNanosecsPerMicrosec / kIterations;
+
+      start = rtc::TimeNanos();
+      for (int i = 0; i < kIterations * 100; ++i) {
+        resampler.Resample(source.data(), source.size(), destination.data(),
+                           destination.size());
+      }
+      const double multi_channel_time_us =
+          static_cast<double>(rtc::TimeNanos() - start) /
+          rtc::kNumNanosecsPerMicrosec / kIterations;
+
+      printf("%d -> %d Hz, %d channels: per channel %.1f us/s, "
+             "MultiChannelSincResampler %.1f us/s; %.2fx faster.\n",
+             rates.source_rate_hz, rates.destination_rate_hz,
+             static_cast<int>(num_channels), per_channel_time_us,
+             multi_channel_time_us,
+             per_channel_time_us / multi_channel_time_us);
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/polyphase_resampler.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/common_audio/resampler/sinc_kernel.h"
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kKernelSize = SincResampler::kKernelSize;
+
+size_t GreatestCommonDivisor(size_t a, size_t b) {
+  while (b != 0) {
+    const size_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+// Resamples by |kUp| / |kDown|. Output sample n is computed from the input at
+// (n * kDown - extra_delay) / kUp, delayed by kKernelSize / 2 input samples.
+// The sub-sample offset of that position is one of kUp values, so there is one
+// kernel per output phase p = n % kUp.
+//
+// |extra_delay|, in units of 1 / kUp input samples, matches the delay beyond
+// kKernelSize / 2 that PushSincResampler gets when it primes SincResampler
+// with ChunkSize() frames: the part of its first block that doesn't fit a
+// whole number of output samples.
+//
+// To let the compiler vectorize the filter, blocks of kBlockSize consecutive
+// outputs of a phase are computed together, one kernel tap at a time. The
+// interleaved input is first split into the kDown streams of every kDown:th
+// frame of each channel, so that the inputs of such a block are contiguous for
+// every tap. The outputs are written interleaved directly, so multi-channel
+// audio needs no separate deinterleaving or interleaving passes.
+template <size_t kUp, size_t kDown>
+class PolyphaseResamplerImpl final : public PolyphaseResampler {
+ public:
+  // Enough history for the kernel, and for delaying by up to kDown / kUp
+  // input samples.
+  static constexpr size_t kHistorySize = kKernelSize + kDown;
+  // The number of outputs of a phase that are computed together.
+  static constexpr size_t kBlockSize = 8;
+
+  PolyphaseResamplerImpl(size_t source_frames,
+                         size_t destination_frames,
+                         size_t num_channels)
+      : PolyphaseResampler(source_frames, destination_frames, num_channels),
+        outputs_per_phase_(destination_frames / kUp),
+        use_streams_(kDown > 1 || num_channels > 1),
+        buffer_((kHistorySize + source_frames) * num_channels, 0.f),
+        tap_inputs_(num_channels) {
+    RTC_DCHECK_EQ(outputs_per_phase_ * kUp, destination_frames);
+    RTC_DCHECK_EQ(outputs_per_phase_ * kDown, source_frames);
+    RTC_DCHECK_GE(source_frames, kHistorySize);
+    const size_t extra_delay =
+        ((source_frames - kKernelSize / 2) * kUp) % kDown;
+    for (size_t p = 0; p < kUp; ++p) {
+      // Output p + kUp * g starts at input frame g * kDown + offsets_[p] of
+      // |buffer_|, which begins kHistorySize frames before the current block.
+      const size_t position = p * kDown + kDown * kUp - extra_delay;
+      offsets_[p] = position / kUp;
+      InitializeSincKernel(static_cast<double>(kDown) / kUp,
+                           static_cast<float>(position % kUp) / kUp,
+                           kernels_[p].data());
+    }
+    if (use_streams_) {
+      const size_t stream_size = (kHistorySize + source_frames + kDown - 1) /
+                                 kDown;
+      streams_.resize(kDown * num_channels, std::vector<float>(stream_size));
+    }
+    for (size_t c = 0; c < num_channels; ++c) {
+      for (size_t p = 0; p < kUp; ++p) {
+        for (size_t i = 0; i < kKernelSize; ++i) {
+          const size_t j = offsets_[p] + i;
+          tap_inputs_[c][p][i] =
+              use_streams_ ? &streams_[c * kDown + j % kDown][j / kDown]
+                           : &buffer_[j];
+        }
+      }
+    }
+  }
+
+  size_t Resample(const float* source,
+                  size_t source_length,
+                  float* destination,
+                  size_t destination_capacity) override {
+    const size_t num_channels = num_channels_;
+    RTC_CHECK_EQ(source_length, source_frames_ * num_channels);
+    RTC_CHECK_GE(destination_capacity, destination_frames_ * num_channels);
+
+    // |buffer_| holds the last kHistorySize frames of the previous block,
+    // followed by the current block.
+    memcpy(&buffer_[kHistorySize * num_channels], source,
+           source_length * sizeof(*source));
+
+    if (use_streams_) {
+      const size_t num_frames = kHistorySize + source_frames_;
+      const float* input = buffer_.data();
+      size_t frame = 0;
+      for (size_t q = 0; frame < num_frames; ++q) {
+        for (size_t r = 0; r < kDown && frame < num_frames; ++r, ++frame) {
+          for (size_t c = 0; c < num_channels; ++c) {
+            streams_[c * kDown + r][q] = *input++;
+          }
+        }
+      }
+    }
+
+    for (size_t c = 0; c < num_channels; ++c) {
+      for (size_t p = 0; p < kUp; ++p) {
+        const std::array<float, kKernelSize>& kernel = kernels_[p];
+        const std::array<const float*, kKernelSize>& inputs = tap_inputs_[c][p];
+        float* const output = destination + p * num_channels + c;
+        const size_t stride = kUp * num_channels;
+        size_t g = 0;
+        for (; g + kBlockSize <= outputs_per_phase_; g += kBlockSize) {
+          std::array<float, kBlockSize> sums = {};
+          for (size_t i = 0; i < kKernelSize; ++i) {
+            const float* const input = inputs[i] + g;
+            for (size_t k = 0; k < kBlockSize; ++k) {
+              sums[k] += kernel[i] * input[k];
+            }
+          }
+          for (size_t k = 0; k < kBlockSize; ++k) {
+            output[stride * (g + k)] = sums[k];
+          }
+        }
+        for (; g < outputs_per_phase_; ++g) {
+          float sum = 0.f;
+          for (size_t i = 0; i < kKernelSize; ++i) {
+            sum += kernel[i] * inputs[i][g];
+          }
+          output[stride * g] = sum;
+        }
+      }
+    }
+
+    memmove(buffer_.data(), &buffer_[source_length],
+            kHistorySize * num_channels * sizeof(buffer_[0]));
+    return destination_frames_ * num_channels;
+  }
+
+ private:
+  const size_t outputs_per_phase_;
+  // Mono audio without decimation is filtered directly from |buffer_|.
+  const bool use_streams_;
+  std::array<size_t, kUp> offsets_;
+  std::array<std::array<float, kKernelSize>, kUp> kernels_;
+  std::vector<float> buffer_;
+  // The stream of channel c and residue r is at index c * kDown + r.
+  std::vector<std::vector<float>> streams_;
+  // The first input of each kernel tap, for the first output of each phase,
+  // for each channel.
+  std::vector<std::array<std::array<const float*, kKernelSize>, kUp>>
+      tap_inputs_;
+};
+
+template <size_t kUp, size_t kDown>
+constexpr size_t PolyphaseResamplerImpl<kUp, kDown>::kHistorySize;
+template <size_t kUp, size_t kDown>
+constexpr size_t PolyphaseResamplerImpl<kUp, kDown>::kBlockSize;
+
+template <size_t kUp, size_t kDown>
+std::unique_ptr<PolyphaseResampler> CreateResampler(
+    size_t source_frames,
+    size_t destination_frames,
+    size_t num_channels) {
+  return std::unique_ptr<PolyphaseResampler>(
+      new PolyphaseResamplerImpl<kUp, kDown>(source_frames, destination_frames,
+                                             num_channels));
+}
+
+// The ratios between the native rates of APM, the mixer and the codecs.
+const struct {
+  size_t up;
+  size_t down;
+  std::unique_ptr<PolyphaseResampler> (*create)(size_t, size_t, size_t);
+} kSupportedRatios[] = {
+    {1, 2, &CreateResampler<1, 2>}, {2, 1, &CreateResampler<2, 1>},
+    {1, 3, &CreateResampler<1, 3>}, {3, 1, &CreateResampler<3, 1>},
+    {1, 4, &CreateResampler<1, 4>}, {4, 1, &CreateResampler<4, 1>},
+    {1, 6, &CreateResampler<1, 6>}, {6, 1, &CreateResampler<6, 1>},
+    {2, 3, &CreateResampler<2, 3>}, {3, 2, &CreateResampler<3, 2>},
+};
+
+}  // namespace
+
+std::unique_ptr<PolyphaseResampler> PolyphaseResampler::Create(
+    size_t source_frames,
+    size_t destination_frames,
+    size_t num_channels) {
+  // The history is taken from a single block.
+  if (source_frames < 2 * kKernelSize || destination_frames == 0 ||
+      num_channels == 0) {
+    return nullptr;
+  }
+  const size_t divisor =
+      GreatestCommonDivisor(source_frames, destination_frames);
+  const size_t up = destination_frames / divisor;
+  const size_t down = source_frames / divisor;
+  for (const auto& ratio : kSupportedRatios) {
+    if (ratio.up == up && ratio.down == down) {
+      return ratio.create(source_frames, destination_frames, num_channels);
+    }
+  }
+  return nullptr;
+}
+
+PolyphaseResampler::PolyphaseResampler(size_t source_frames,
+                                       size_t destination_frames,
+                                       size_t num_channels)
+    : source_frames_(source_frames),
+      destination_frames_(destination_frames),
+      num_channels_(num_channels) {}
+
+PolyphaseResampler::~PolyphaseResampler() {}
+
+size_t PolyphaseResampler::Resample(const int16_t* source,
+                                    size_t source_length,
+                                    int16_t* destination,
+                                    size_t destination_capacity) {
+  const size_t source_samples = source_frames_ * num_channels_;
+  const size_t destination_samples = destination_frames_ * num_channels_;
+  RTC_CHECK_EQ(source_length, source_samples);
+  RTC_CHECK_GE(destination_capacity, destination_samples);
+  if (!float_source_) {
+    float_source_.reset(new float[source_samples]);
+    float_destination_.reset(new float[destination_samples]);
+  }
+  for (size_t i = 0; i < source_samples; ++i) {
+    float_source_[i] = static_cast<float>(source[i]);
+  }
+  Resample(float_source_.get(), source_samples, float_destination_.get(),
+           destination_samples);
+  FloatS16ToS16(float_destination_.get(), destination_samples, destination);
+  return destination_samples;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+#define WEBRTC_COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+
+#include <memory>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// A push-based resampler for source and destination rates with a small integer
+// ratio, like 48 kHz -> 16 kHz or 16 kHz -> 48 kHz. It uses the same windowed
+// sinc() kernel, and has the same delay, as PushSincResampler. Since the
+// sub-sample offsets repeat for these ratios, it precomputes one kernel per
+// offset instead of interpolating between kernels for every output sample.
+// Multi-channel audio is resampled in its interleaved form.
+class PolyphaseResampler {
+ public:
+  // Returns a resampler from blocks of |source_frames| to blocks of
+  // |destination_frames| with |num_channels| interleaved channels, or null if
+  // their ratio isn't supported. The blocks must correspond to the same time
+  // duration (typically 10 ms).
+  static std::unique_ptr<PolyphaseResampler> Create(size_t source_frames,
+                                                    size_t destination_frames,
+                                                    size_t num_channels);
+
+  virtual ~PolyphaseResampler();
+
+  // Resamples one interleaved block of |source_length| = source_frames *
+  // num_channels samples. Returns the number of samples written to
+  // |destination|, destination_frames * num_channels, which must fit in
+  // |destination_capacity|.
+  size_t Resample(const int16_t* source,
+                  size_t source_length,
+                  int16_t* destination,
+                  size_t destination_capacity);
+  virtual size_t Resample(const float* source,
+                          size_t source_length,
+                          float* destination,
+                          size_t destination_capacity) = 0;
+
+ protected:
+  PolyphaseResampler(size_t source_frames,
+                     size_t destination_frames,
+                     size_t num_channels);
+
+  const size_t source_frames_;
+  const size_t destination_frames_;
+  const size_t num_channels_;
+
+ private:
+  std::unique_ptr<float[]> float_source_;
+  std::unique_ptr<float[]> float_destination_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PolyphaseResampler);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "webrtc/common_audio/resampler/polyphase_resampler.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "webrtc/common_audio/resampler/push_sinc_resampler.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+struct RatePair {
+  int source_rate_hz;
+  int destination_rate_hz;
+};
+
+const RatePair kSupportedRatePairs[] = {
+    {16000, 8000},  {8000, 16000},  {32000, 16000}, {16000, 32000},
+    {48000, 16000}, {16000, 48000}, {24000, 8000},  {8000, 24000},
+    {32000, 8000},  {8000, 32000},  {48000, 8000},  {8000, 48000},
+    {48000, 32000}, {32000, 48000}, {96000, 48000}, {48000, 96000},
+};
+
+std::string ProduceDebugText(const RatePair& rates) {
+  std::ostringstream ss;
+  ss << "Source rate: " << rates.source_rate_hz
+     << ", destination rate: " << rates.destination_rate_hz;
+  return ss.str();
+}
+
+// Fills |block| with the next block of a sum of two sines, which both pass
+// through the resampling filters.
+void GenerateBlock(int sample_rate_hz,
+                   size_t block_index,
+                   std::vector<float>* block) {
+  for (size_t i = 0; i < block->size(); ++i) {
+    const double t =
+        static_cast<double>(block_index * block->size() + i) / sample_rate_hz;
+    (*block)[i] = static_cast<float>(10000 * sin(2 * M_PI * 440 * t) +
+                                     5000 * sin(2 * M_PI * 1900 * t));
+  }
+}
+
+}  // namespace
+
+TEST(PolyphaseResamplerTest, UnsupportedRatiosAreRejected) {
+  // 44.1 kHz -> 48 kHz.
+  EXPECT_FALSE(PolyphaseResampler::Create(441, 480, 1));
+  // Equal rates are handled without a resampler.
+  EXPECT_FALSE(PolyphaseResampler::Create(480, 480, 1));
+  // 8 kHz -> 40 kHz.
+  EXPECT_FALSE(PolyphaseResampler::Create(80, 400, 1));
+  // Too short to hold the kernel history.
+  EXPECT_FALSE(PolyphaseResampler::Create(16, 32, 1));
+}
+
+// The polyphase resampler uses the same kernels and delay as
+// PushSincResampler, so their outputs only differ by rounding, and by the
+// interpolation between kernels in PushSincResampler.
+TEST(PolyphaseResamplerTest, MatchesPushSincResampler) {
+  for (const auto& rates : kSupportedRatePairs) {
+    SCOPED_TRACE(ProduceDebugText(rates));
+    const size_t source_frames = rates.source_rate_hz / 100;
+    const size_t destination_frames = rates.destination_rate_hz / 100;
+    std::unique_ptr<PolyphaseResampler> polyphase =
+        PolyphaseResampler::Create(source_frames, destination_frames, 1);
+    ASSERT_TRUE(polyphase);
+    PushSincResampler sinc(source_frames, destination_frames);
+
+    std::vector<float> source(source_frames);
+    std::vector<float> polyphase_output(destination_frames);
+    std::vector<float> sinc_output(destination_frames);
+    float max_difference = 0.f;
+    for (size_t block = 0; block < 10; ++block) {
+      GenerateBlock(rates.source_rate_hz, block, &source);
+      EXPECT_EQ(destination_frames,
+                polyphase->Resample(source.data(), source.size(),
+                                    polyphase_output.data(),
+                                    polyphase_output.size()));
+      sinc.Resample(source.data(), source.size(), sinc_output.data(),
+                    sinc_output.size());
+      for (size_t i = 0; i < destination_frames; ++i) {
+        max_difference = std::max(
+            max_difference, fabsf(polyphase_output[i] - sinc_output[i]));
+      }
+    }
+    // About -77 dB relative to the peak input.
+    EXPECT_LT(max_difference, 2.f);
+  }
+}
+
+// Each interleaved channel is resampled exactly as on its own.
+TEST(PolyphaseResamplerTest, MultiChannelMatchesMono) {
+  const size_t kNumChannels = 3;
+  for (const auto& rates : kSupportedRatePairs) {
+    SCOPED_TRACE(ProduceDebugText(rates));
+    const size_t source_frames = rates.source_rate_hz / 100;
+    const size_t destination_frames = rates.destination_rate_hz / 100;
+    std::unique_ptr<PolyphaseResampler> multi_channel =
+        PolyphaseResampler::Create(source_frames, destination_frames,
+                                   kNumChannels);
+    ASSERT_TRUE(multi_channel);
+    std::vector<std::unique_ptr<PolyphaseResampler>> mono(kNumChannels);
+    for (auto& resampler : mono) {
+      resampler =
+          PolyphaseResampler::Create(source_frames, destination_frames, 1);
+    }
+
+    std::vector<float> source(source_frames);
+    std::vector<float> interleaved_source(source_frames * kNumChannels);
+    std::vector<float> mono_output(destination_frames);
+    std::vector<float> output(destination_frames * kNumChannels);
+    for (size_t block = 0; block < 3; ++block) {
+      GenerateBlock(rates.source_rate_hz, block, &source);
+      for (size_t i = 0; i < source_frames; ++i) {
+        for (size_t c = 0; c < kNumChannels; ++c) {
+          interleaved_source[i * kNumChannels + c] = source[i] / (c + 1);
+        }
+      }
+      EXPECT_EQ(output.size(),
+                multi_channel->Resample(interleaved_source.data(),
+                                        interleaved_source.size(),
+                                        output.data(), output.size()));
+      for (size_t c = 0; c < kNumChannels; ++c) {
+        for (size_t i = 0; i < source_frames; ++i) {
+          source[i] = interleaved_source[i * kNumChannels + c];
+        }
+        mono[c]->Resample(source.data(), source.size(), mono_output.data(),
+                          mono_output.size());
+        for (size_t i = 0; i < destination_frames; ++i) {
+          ASSERT_EQ(mono_output[i], output[i * kNumChannels + c]);
+        }
+      }
+    }
+  }
+}
+
+TEST(PolyphaseResamplerTest, Int16MatchesFloat) {
+  std::unique_ptr<PolyphaseResampler> float_resampler =
+      PolyphaseResampler::Create(480, 160, 1);
+  std::unique_ptr<PolyphaseResampler> int16_resampler =
+      PolyphaseResampler::Create(480, 160, 1);
+  std::vector<float> source(480);
+  std::vector<int16_t> source_int16(480);
+  std::vector<float> output(160);
+  std::vector<int16_t> output_int16(160);
+  for (size_t block = 0; block < 3; ++block) {
+    GenerateBlock(48000, block, &source);
+    for (size_t i = 0; i < source.size(); ++i) {
+      source[i] = roundf(source[i]);
+      source_int16[i] = static_cast<int16_t>(source[i]);
+    }
+    float_resampler->Resample(source.data(), source.size(), output.data(),
+                              output.size());
+    EXPECT_EQ(output_int16.size(),
+              int16_resampler->Resample(source_int16.data(),
+                                        source_int16.size(),
+                                        output_int16.data(),
+                                        output_int16.size()));
+    for (size_t i = 0; i < output.size(); ++i) {
+      EXPECT_NEAR(output[i], output_int16[i], 0.5f);
+    }
+  }
+}
+
+// Compares the time to resample one second of audio with PushSincResampler
+// and PolyphaseResampler.
+TEST(PolyphaseResamplerTest, DISABLED_Benchmark) {
+  const int kIterations = 100;
+  for (const auto& rates : kSupportedRatePairs) {
+    const size_t source_frames = rates.source_rate_hz / 100;
+    const size_t destination_frames = rates.destination_rate_hz / 100;
+    std::unique_ptr<PolyphaseResampler> polyphase =
+        PolyphaseResampler::Create(source_frames, destination_frames, 1);
+    PushSincResampler sinc(source_frames, destination_frames);
+    std::vector<float> source(source_frames);
+    GenerateBlock(rates.source_rate_hz, 0, &source);
+    std::vector<float> destination(destination_frames);
+
+    int64_t start = rtc::TimeNanos();
+    for (int i = 0; i < kIterations * 100; ++i) {
+      sinc.Resample(source.data(), source.size(), destination.data(),
+                    destination.size());
+    }
+    const double sinc_time_us = static_cast<double>(rtc::TimeNanos() - start) /
+                                rtc::kNumNanosecsPerMicrosec / kIterations;
+
+    start = rtc::TimeNanos();
+    for (int i = 0; i < kIterations * 100; ++i) {
+      polyphase->Resample(source.data(), source.size(), destination.data(),
+                          destination.size());
+    }
+    const double polyphase_time_us =
+        static_cast<double>(rtc::TimeNanos() - start) /
+        rtc::kNumNanosecsPerMicrosec / kIterations;
+
+    printf("%d -> %d Hz: PushSincResampler %.1f us/s, PolyphaseResampler "
+           "%.1f us/s; %.2fx faster.\n",
+           rates.source_rate_hz, rates.destination_rate_hz, sinc_time_us,
+           polyphase_time_us, sinc_time_us / polyphase_time_us);
+  }
+}
+
+}  // namespace webrtc
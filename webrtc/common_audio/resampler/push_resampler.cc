@@ -12,8 +12,9 @@
 
 #include <string.h>
 
-#include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/common_audio/resampler/include/resampler.h"
+#include "webrtc/common_audio/resampler/multi_channel_sinc_resampler.h"
+#include "webrtc/common_audio/resampler/polyphase_resampler.h"
 #include "webrtc/common_audio/resampler/push_sinc_resampler.h"
 #include "webrtc/rtc_base/checks.h"
 
@@ -33,7 +34,6 @@ void CheckValidInitParams(int src_sample_rate_hz, int dst_sample_rate_hz,
   RTC_DCHECK_GT(src_sample_rate_hz, 0);
   RTC_DCHECK_GT(dst_sample_rate_hz, 0);
   RTC_DCHECK_GT(num_channels, 0);
-  RTC_DCHECK_LE(num_channels, 2);
 #endif
 }
 
@@ -79,8 +79,7 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
     return 0;
   }
 
-  if (src_sample_rate_hz <= 0 || dst_sample_rate_hz <= 0 || num_channels <= 0 ||
-      num_channels > 2) {
+  if (src_sample_rate_hz <= 0 || dst_sample_rate_hz <= 0 || num_channels <= 0) {
     return -1;
   }
 
@@ -92,15 +91,19 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
       static_cast<size_t>(src_sample_rate_hz / 100);
   const size_t dst_size_10ms_mono =
       static_cast<size_t>(dst_sample_rate_hz / 100);
-  sinc_resampler_.reset(new PushSincResampler(src_size_10ms_mono,
-                                              dst_size_10ms_mono));
-  if (num_channels_ == 2) {
-    src_left_.reset(new T[src_size_10ms_mono]);
-    src_right_.reset(new T[src_size_10ms_mono]);
-    dst_left_.reset(new T[dst_size_10ms_mono]);
-    dst_right_.reset(new T[dst_size_10ms_mono]);
-    sinc_resampler_right_.reset(new PushSincResampler(src_size_10ms_mono,
-                                                      dst_size_10ms_mono));
+  // Prefer a polyphase resampler when the ratio is supported.
+  sinc_resampler_.reset();
+  multi_channel_sinc_resampler_.reset();
+  polyphase_resampler_ = PolyphaseResampler::Create(
+      src_size_10ms_mono, dst_size_10ms_mono, num_channels_);
+  if (!polyphase_resampler_) {
+    if (num_channels_ == 1) {
+      sinc_resampler_.reset(
+          new PushSincResampler(src_size_10ms_mono, dst_size_10ms_mono));
+    } else {
+      multi_channel_sinc_resampler_.reset(new MultiChannelSincResampler(
+          src_size_10ms_mono, dst_size_10ms_mono, num_channels_));
+    }
   }
 
   return 0;
@@ -118,26 +121,16 @@ int PushResampler<T>::Resample(const T* src, size_t src_length, T* dst,
     memcpy(dst, src, src_length * sizeof(T));
     return static_cast<int>(src_length);
   }
-  if (num_channels_ == 2) {
-    const size_t src_length_mono = src_length / num_channels_;
-    const size_t dst_capacity_mono = dst_capacity / num_channels_;
-    T* deinterleaved[] = {src_left_.get(), src_right_.get()};
-    Deinterleave(src, src_length_mono, num_channels_, deinterleaved);
-
-    size_t dst_length_mono =
-        sinc_resampler_->Resample(src_left_.get(), src_length_mono,
-                                  dst_left_.get(), dst_capacity_mono);
-    sinc_resampler_right_->Resample(src_right_.get(), src_length_mono,
-                                    dst_right_.get(), dst_capacity_mono);
-
-    deinterleaved[0] = dst_left_.get();
-    deinterleaved[1] = dst_right_.get();
-    Interleave(deinterleaved, dst_length_mono, num_channels_, dst);
-    return static_cast<int>(dst_length_mono * num_channels_);
-  } else {
+  if (polyphase_resampler_) {
     return static_cast<int>(
-        sinc_resampler_->Resample(src, src_length, dst, dst_capacity));
+        polyphase_resampler_->Resample(src, src_length, dst, dst_capacity));
   }
+  if (multi_channel_sinc_resampler_) {
+    return static_cast<int>(multi_channel_sinc_resampler_->Resample(
+        src, src_length, dst, dst_capacity));
+  }
+  return static_cast<int>(
+      sinc_resampler_->Resample(src, src_length, dst, dst_capacity));
 }
 
 // Explictly generate required instantiations.
@@ -25,6 +25,7 @@ TEST(PushResamplerTest, VerifiesInputParameters) {
   PushResampler<int16_t> resampler;
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 1));
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 2));
+  EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 3));
 }
 
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
@@ -44,11 +45,6 @@ TEST(PushResamplerTest, VerifiesBadInputParameters3) {
   PushResampler<int16_t> resampler;
   EXPECT_DEATH(resampler.InitializeIfNeeded(16000, 16000, 0), "num_channels");
 }
-
-TEST(PushResamplerTest, VerifiesBadInputParameters4) {
-  PushResampler<int16_t> resampler;
-  EXPECT_DEATH(resampler.InitializeIfNeeded(16000, 16000, 3), "num_channels");
-}
 #endif
 #endif
 
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "webrtc/common_audio/resampler/sinc_kernel.h"
+
+#include <math.h>
+
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+
+namespace webrtc {
+
+void InitializeSincKernel(double io_sample_rate_ratio,
+                          float subsample_offset,
+                          float* kernel) {
+  constexpr size_t kKernelSize = SincResampler::kKernelSize;
+
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  // The normalized cutoff frequency of the low-pass filter, lowered slightly
+  // to avoid aliasing. See SincScaleFactor() in sinc_resampler.cc.
+  const double sinc_scale_factor =
+      0.9 * (io_sample_rate_ratio > 1.0 ? 1.0 / io_sample_rate_ratio : 1.0);
+
+  for (size_t i = 0; i < kKernelSize; ++i) {
+    const float pre_sinc = static_cast<float>(
+        M_PI * (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
+                subsample_offset));
+    const float x = (i - subsample_offset) / kKernelSize;
+    const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
+                                            kA2 * cos(4.0 * M_PI * x));
+    kernel[i] = static_cast<float>(
+        window * ((pre_sinc == 0) ? sinc_scale_factor
+                                  : (sin(sinc_scale_factor * pre_sinc) /
+                                     pre_sinc)));
+  }
+}
+
+}  // namespace webrtc
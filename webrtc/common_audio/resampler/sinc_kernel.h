@@ -0,0 +1,27 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_RESAMPLER_SINC_KERNEL_H_
+#define WEBRTC_COMMON_AUDIO_RESAMPLER_SINC_KERNEL_H_
+
+#include <stddef.h>
+
+namespace webrtc {
+
+// Fills the SincResampler::kKernelSize taps of |kernel| with the windowed
+// sinc() that SincResampler uses for the sub-sample offset |subsample_offset|,
+// for the given ratio of input / output sample rates.
+void InitializeSincKernel(double io_sample_rate_ratio,
+                          float subsample_offset,
+                          float* kernel);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_RESAMPLER_SINC_KERNEL_H_
@@ -122,19 +122,22 @@ const size_t SincResampler::kKernelSize;
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
-// x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// x86 CPU detection required, since AVX2 is never part of the baseline.
+// Function will be set by InitializeCPUSpecificFeatures().
 #define CONVOLVE_FUNC convolve_proc_
 
 void SincResampler::InitializeCPUSpecificFeatures() {
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    convolve_proc_ = Convolve_AVX2;
+    return;
+  }
+#if defined(__SSE2__)
+  convolve_proc_ = Convolve_SSE;
+#else
+  // TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
   convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
-}
 #endif
+}
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
@@ -87,13 +87,14 @@ class SincResampler {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveAvx2);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
 
   void InitializeKernel();
   void UpdateRegions(bool second_load);
 
-  // Selects runtime specific CPU features like SSE.  Must be called before
-  // using SincResampler.
+  // Selects runtime specific CPU features like SSE and AVX2.  Must be called
+  // before using SincResampler.
   // TODO(ajm): Currently managed by the class internally. See the note with
   // |convolve_proc_| below.
   void InitializeCPUSpecificFeatures();
@@ -107,6 +108,9 @@ class SincResampler {
   static float Convolve_SSE(const float* input_ptr, const float* k1,
                             const float* k2,
                             double kernel_interpolation_factor);
+  static float Convolve_AVX2(const float* input_ptr, const float* k1,
+                             const float* k2,
+                             double kernel_interpolation_factor);
 #elif defined(WEBRTC_HAS_NEON)
   static float Convolve_NEON(const float* input_ptr, const float* k1,
                              const float* k2,
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace webrtc {
+namespace {
+constexpr int kInputRate = 44100;
+constexpr int kOutputRate = 48000;
+// 10 ms at the output rate.
+constexpr size_t kOutputFrames = kOutputRate / 100;
+
+class SineSource : public SincResamplerCallback {
+ public:
+  void Run(size_t frames, float* destination) override {
+    for (size_t i = 0; i < frames; ++i)
+      destination[i] = sinf(0.05f * static_cast<float>(position_++ % 1000));
+  }
+
+ private:
+  size_t position_ = 0;
+};
+}  // namespace
+
+// Resamples 10 ms blocks from 44.1 to 48 kHz, as done for each played out
+// block of audio from a 44.1 kHz source.
+TEST(SincResamplerBenchmark, Resample44100To48000) {
+  SineSource source;
+  SincResampler resampler(static_cast<double>(kInputRate) / kOutputRate,
+                          SincResampler::kDefaultRequestSize, &source);
+  std::vector<float> output(kOutputFrames);
+  test::RunBenchmark("SincResampler_Resample44100To48000",
+                     kOutputFrames * sizeof(float),
+                     [&] { resampler.Resample(kOutputFrames, output.data()); });
+  for (float sample : output)
+    EXPECT_LE(fabsf(sample), 1.1f);
+}
+
+}  // namespace webrtc
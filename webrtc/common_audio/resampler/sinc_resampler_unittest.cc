@@ -164,6 +164,39 @@ TEST(SincResamplerTest, Convolve) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure Convolve_AVX2() returns the same value as Convolve_C(), when the CPU
+// supports it.
+TEST(SincResamplerTest, ConvolveAvx2) {
+  if (!WebRtc_GetCPUInfo(kAVX2) || !WebRtc_GetCPUInfo(kFMA3)) {
+    printf("Skipping AVX2 test: AVX2 or FMA3 is not supported.\n");
+    return;
+  }
+
+  // Initialize a dummy resampler.
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+
+  // Fused multiply-adds are more precise than Convolve_C(), so comparison must
+  // be done using an epsilon.
+  static const double kEpsilon = 0.00000005;
+
+  for (const size_t input_offset : {0, 1, 4}) {
+    const float* const input = resampler.kernel_storage_.get() + input_offset;
+    const double result = resampler.Convolve_C(
+        input, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get() + SincResampler::kKernelSize,
+        kKernelInterpolationFactor);
+    const double result2 = resampler.Convolve_AVX2(
+        input, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get() + SincResampler::kKernelSize,
+        kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon);
+  }
+}
+#endif
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that RTC_DCHECKs are compiled out when benchmarking.
 // Original benchmarks were run with --convolve-iterations=50000000.
@@ -226,6 +259,43 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
          total_time_c_us / total_time_optimized_aligned_us,
          total_time_optimized_unaligned_us / total_time_optimized_aligned_us);
 #endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    // Benchmark Convolve_AVX2() with unaligned and aligned input pointers.
+    start = rtc::TimeNanos();
+    for (int j = 0; j < kConvolveIterations; ++j) {
+      resampler.Convolve_AVX2(
+          resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    }
+    const double total_time_avx2_unaligned_us =
+        (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
+    printf("Convolve_AVX2 (unaligned) took %.2fms; which is %.2fx faster than "
+           "Convolve_C and %.2fx faster than " STRINGIZE(CONVOLVE_FUNC)
+           " (unaligned).\n",
+           total_time_avx2_unaligned_us / 1000,
+           total_time_c_us / total_time_avx2_unaligned_us,
+           total_time_optimized_unaligned_us / total_time_avx2_unaligned_us);
+
+    start = rtc::TimeNanos();
+    for (int j = 0; j < kConvolveIterations; ++j) {
+      resampler.Convolve_AVX2(
+          resampler.kernel_storage_.get(), resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    }
+    const double total_time_avx2_aligned_us =
+        (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
+    printf("Convolve_AVX2 (aligned) took %.2fms; which is %.2fx faster than "
+           "Convolve_C and %.2fx faster than " STRINGIZE(CONVOLVE_FUNC)
+           " (aligned).\n",
+           total_time_avx2_aligned_us / 1000,
+           total_time_c_us / total_time_avx2_aligned_us,
+           total_time_optimized_aligned_us / total_time_avx2_aligned_us);
+  } else {
+    printf("Skipping Convolve_AVX2: AVX2 or FMA3 is not supported.\n");
+  }
+#endif
 }
 
 #undef CONVOLVE_FUNC
@@ -351,7 +421,7 @@ INSTANTIATE_TEST_CASE_P(
         std::tr1::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::tr1::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::tr1::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::tr1::make_tuple(48000, 44100, -15.01, -64.04),
         std::tr1::make_tuple(96000, 44100, -18.49, -25.51),
         std::tr1::make_tuple(192000, 44100, -20.50, -13.31),
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// Returns the 32-bit products of the eight pairs in |a| and |b|, shifted right
+// by |shift|, summed pairwise into four lanes. Like the C version, every
+// product is shifted before it is added, so the result is bit-exact.
+static inline __m128i MultiplyAndShift(__m128i a, __m128i b, __m128i shift) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  const __m128i high = _mm_mulhi_epi16(a, b);
+  return _mm_add_epi32(_mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift),
+                       _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift));
+}
+
+static inline int32_t DotProductWithScaleSSE2(const int16_t* vector1,
+                                              const int16_t* vector2,
+                                              size_t length,
+                                              int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m128i sum0 = _mm_setzero_si128();
+  __m128i sum1 = _mm_setzero_si128();
+  size_t i = 0;
+  int32_t sum;
+
+  for (; i + 16 <= length; i += 16) {
+    sum0 = _mm_add_epi32(
+        sum0, MultiplyAndShift(
+                  _mm_loadu_si128((const __m128i*)&vector1[i]),
+                  _mm_loadu_si128((const __m128i*)&vector2[i]), shift));
+    sum1 = _mm_add_epi32(
+        sum1, MultiplyAndShift(
+                  _mm_loadu_si128((const __m128i*)&vector1[i + 8]),
+                  _mm_loadu_si128((const __m128i*)&vector2[i + 8]), shift));
+  }
+  if (i + 8 <= length) {
+    sum0 = _mm_add_epi32(
+        sum0, MultiplyAndShift(
+                  _mm_loadu_si128((const __m128i*)&vector1[i]),
+                  _mm_loadu_si128((const __m128i*)&vector2[i]), shift));
+    i += 8;
+  }
+
+  // Horizontal add. The 32-bit additions wrap around like the C version.
+  sum0 = _mm_add_epi32(sum0, sum1);
+  sum0 = _mm_add_epi32(sum0, _mm_shuffle_epi32(sum0, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum0 = _mm_add_epi32(sum0, _mm_shuffle_epi32(sum0, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(sum0);
+
+  for (; i < length; i++) {
+    sum += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return sum;
+}
+
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ =
+        DotProductWithScaleSSE2(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+}
@@ -154,6 +154,9 @@ int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t* vector, size_t length);
 #if defined(WEBRTC_HAS_NEON)
 int16_t WebRtcSpl_MaxAbsValueW16Neon(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length);
+#endif
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxAbsValueW16_mips(const int16_t* vector, size_t length);
 #endif
@@ -538,6 +541,15 @@ void WebRtcSpl_CrossCorrelationNeon(int32_t* cross_correlation,
                                     int right_shifts,
                                     int step_seq2);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2);
+#endif
 #if defined(MIPS32_LE)
 void WebRtcSpl_CrossCorrelation_mips(int32_t* cross_correlation,
                                      const int16_t* seq1,
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stdlib.h>
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// Maximum absolute value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i max0 = zero;
+  __m128i max1 = zero;
+  size_t i = 0;
+  int absolute = 0, maximum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  // The saturating negation maps -32768 to 32767, which is also where the C
+  // version clamps the result.
+  for (; i + 16 <= length; i += 16) {
+    const __m128i in0 = _mm_loadu_si128((const __m128i*)&vector[i]);
+    const __m128i in1 = _mm_loadu_si128((const __m128i*)&vector[i + 8]);
+    max0 = _mm_max_epi16(max0, _mm_max_epi16(in0, _mm_subs_epi16(zero, in0)));
+    max1 = _mm_max_epi16(max1, _mm_max_epi16(in1, _mm_subs_epi16(zero, in1)));
+  }
+  max0 = _mm_max_epi16(max0, max1);
+  max0 = _mm_max_epi16(max0, _mm_shuffle_epi32(max0, _MM_SHUFFLE(1, 0, 3, 2)));
+  max0 = _mm_max_epi16(max0, _mm_shuffle_epi32(max0, _MM_SHUFFLE(2, 3, 0, 1)));
+  max0 = _mm_max_epi16(max0, _mm_shufflelo_epi16(max0, _MM_SHUFFLE(2, 3, 0, 1)));
+  maximum = (int16_t)_mm_extract_epi16(max0, 0);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
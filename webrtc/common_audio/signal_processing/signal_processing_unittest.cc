@@ -12,6 +12,7 @@
 #include <sstream>
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/test/gtest.h"
 
 static const size_t kVector16Size = 9;
@@ -473,22 +474,66 @@ TEST_F(SplTest, CrossCorrelationTest) {
                              kCrossCorrelationDimension, kShift, kStep);
 
   // WebRtcSpl_CrossCorrelationC() and WebRtcSpl_CrossCorrelationNeon()
-  // are not bit-exact.
+  // are not bit-exact. WebRtcSpl_CrossCorrelationSSE2() is bit-exact with the
+  // C version.
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
-    expected = kExpectedNeon;
-  }
+  expected = kExpectedNeon;
 #endif
   for (size_t i = 0; i < kCrossCorrelationDimension; ++i) {
     EXPECT_EQ(expected[i], vector32[i]);
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST_F(SplTest, Sse2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  const size_t kMaxLength = 300;
+  int16_t vector1[kMaxLength];
+  int16_t vector2[2 * kMaxLength];
+  int32_t result_c[kMaxLength];
+  int32_t result_sse2[kMaxLength];
+  uint32_t seed = 17;
+  for (size_t length = 1; length <= kMaxLength; length += 13) {
+    for (size_t i = 0; i < length; ++i) {
+      vector1[i] = WebRtcSpl_RandU(&seed) - 16384;
+    }
+    for (size_t i = 0; i < 2 * length; ++i) {
+      vector2[i] = 2 * WebRtcSpl_RandU(&seed) - 32768;
+    }
+    vector2[length / 2] = WEBRTC_SPL_WORD16_MIN;
+    for (int shift = 0; shift < 16; shift += 5) {
+      WebRtcSpl_CrossCorrelationC(result_c, vector1, vector2, length, length,
+                                  shift, 1);
+      WebRtcSpl_CrossCorrelationSSE2(result_sse2, vector1, vector2, length,
+                                     length, shift, 1);
+      for (size_t i = 0; i < length; ++i) {
+        ASSERT_EQ(result_c[i], result_sse2[i])
+            << "length " << length << ", shift " << shift << ", lag " << i;
+      }
+      WebRtcSpl_CrossCorrelationC(result_c, vector1, &vector2[length], length,
+                                  length, shift, -1);
+      WebRtcSpl_CrossCorrelationSSE2(result_sse2, vector1, &vector2[length],
+                                     length, length, shift, -1);
+      for (size_t i = 0; i < length; ++i) {
+        ASSERT_EQ(result_c[i], result_sse2[i])
+            << "length " << length << ", shift " << shift << ", lag " << i;
+      }
+    }
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector1, length),
+              WebRtcSpl_MaxAbsValueW16SSE2(vector1, length));
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector2, 2 * length),
+              WebRtcSpl_MaxAbsValueW16SSE2(vector2, 2 * length));
+  }
+}
+#endif
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
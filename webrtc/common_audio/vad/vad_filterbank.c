@@ -70,43 +70,11 @@ static void HighPassFilter(const int16_t* data_in, size_t data_length,
   }
 }
 
-// All pass filtering of |data_in|, used before splitting the signal into two
-// frequency bands (low pass vs high pass).
-// Note that |data_in| and |data_out| can NOT correspond to the same address.
-//
-// - data_in            [i]   : Input audio signal given in Q0.
-// - data_length        [i]   : Length of input and output data.
-// - filter_coefficient [i]   : Given in Q15.
-// - filter_state       [i/o] : State of the filter given in Q(-1).
-// - data_out           [o]   : Output audio signal given in Q(-1).
-static void AllPassFilter(const int16_t* data_in, size_t data_length,
-                          int16_t filter_coefficient, int16_t* filter_state,
-                          int16_t* data_out) {
-  // The filter can only cause overflow (in the w16 output variable)
-  // if more than 4 consecutive input numbers are of maximum value and
-  // has the the same sign as the impulse responses first taps.
-  // First 6 taps of the impulse response:
-  // 0.6399 0.5905 -0.3779 0.2418 -0.1547 0.0990
-
-  size_t i;
-  int16_t tmp16 = 0;
-  int32_t tmp32 = 0;
-  int32_t state32 = ((int32_t) (*filter_state) << 16);  // Q15
-
-  for (i = 0; i < data_length; i++) {
-    tmp32 = state32 + filter_coefficient * *data_in;
-    tmp16 = (int16_t) (tmp32 >> 16);  // Q(-1)
-    *data_out++ = tmp16;
-    state32 = (*data_in << 14) - filter_coefficient * tmp16;  // Q14
-    state32 <<= 1;  // Q15.
-    data_in += 2;
-  }
-
-  *filter_state = (int16_t) (state32 >> 16);  // Q(-1)
-}
-
 // Splits |data_in| into |hp_data_out| and |lp_data_out| corresponding to
-// an upper (high pass) part and a lower (low pass) part respectively.
+// an upper (high pass) part and a lower (low pass) part respectively. The even
+// samples are all-pass filtered with the upper coefficient and the odd samples
+// with the lower one. Both branches are filtered in the same loop, since they
+// are independent of each other.
 //
 // - data_in      [i]   : Input audio data to be split into two frequency bands.
 // - data_length  [i]   : Length of |data_in|.
@@ -119,24 +87,38 @@ static void AllPassFilter(const int16_t* data_in, size_t data_length,
 static void SplitFilter(const int16_t* data_in, size_t data_length,
                         int16_t* upper_state, int16_t* lower_state,
                         int16_t* hp_data_out, int16_t* lp_data_out) {
+  // The all-pass filters can only cause overflow (in the int16_t outputs) if
+  // more than 4 consecutive input numbers are of maximum value and have the
+  // same sign as the first taps of the impulse response.
+  // First 6 taps of the impulse response of the upper filter:
+  // 0.6399 0.5905 -0.3779 0.2418 -0.1547 0.0990
   size_t i;
   size_t half_length = data_length >> 1;  // Downsampling by 2.
-  int16_t tmp_out;
-
-  // All-pass filtering upper branch.
-  AllPassFilter(&data_in[0], half_length, kAllPassCoefsQ15[0], upper_state,
-                hp_data_out);
+  int16_t upper_out, lower_out;
+  int32_t upper_state32 = ((int32_t) (*upper_state) << 16);  // Q15
+  int32_t lower_state32 = ((int32_t) (*lower_state) << 16);  // Q15
 
-  // All-pass filtering lower branch.
-  AllPassFilter(&data_in[1], half_length, kAllPassCoefsQ15[1], lower_state,
-                lp_data_out);
-
-  // Make LP and HP signals.
   for (i = 0; i < half_length; i++) {
-    tmp_out = *hp_data_out;
-    *hp_data_out++ -= *lp_data_out;
-    *lp_data_out++ += tmp_out;
+    // All-pass filtering upper branch, output in Q(-1).
+    upper_out = (int16_t) ((upper_state32 +
+        kAllPassCoefsQ15[0] * data_in[0]) >> 16);
+    upper_state32 = (data_in[0] << 14) - kAllPassCoefsQ15[0] * upper_out;
+    upper_state32 <<= 1;  // Q14 -> Q15.
+
+    // All-pass filtering lower branch, output in Q(-1).
+    lower_out = (int16_t) ((lower_state32 +
+        kAllPassCoefsQ15[1] * data_in[1]) >> 16);
+    lower_state32 = (data_in[1] << 14) - kAllPassCoefsQ15[1] * lower_out;
+    lower_state32 <<= 1;  // Q14 -> Q15.
+    data_in += 2;
+
+    // Make LP and HP signals.
+    *hp_data_out++ = upper_out - lower_out;
+    *lp_data_out++ = upper_out + lower_out;
   }
+
+  *upper_state = (int16_t) (upper_state32 >> 16);  // Q(-1)
+  *lower_state = (int16_t) (lower_state32 >> 16);  // Q(-1)
 }
 
 // Calculates the energy of |data_in| in dB, and also updates an overall
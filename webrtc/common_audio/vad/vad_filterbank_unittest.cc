@@ -90,5 +90,39 @@ TEST_F(VadTest, vad_filterbank) {
 
   free(self);
 }
+
+TEST_F(VadTest, vad_filterbank_full_scale) {
+  VadInstT* self = reinterpret_cast<VadInstT*>(malloc(sizeof(VadInstT)));
+  static const int16_t kFeatures[kNumValidFrameLengths * kNumChannels] = {
+      915, 1204, 1723, 1675, 1630, 1620,
+      716, 728, 1785, 1717, 1700, 1686,
+      566, 368, 1816, 1741, 1728, 1717
+  };
+  int16_t features[kNumChannels];
+
+  // A full scale square wave, which makes the all-pass filters in the split
+  // filters wrap around.
+  int16_t speech[kMaxFrameLength];
+  for (size_t i = 0; i < kMaxFrameLength; ++i) {
+    speech[i] = (i & 4) ? 32767 : -32768;
+  }
+
+  int frame_length_index = 0;
+  ASSERT_EQ(0, WebRtcVad_InitCore(self));
+  for (size_t j = 0; j < kFrameLengthsSize; ++j) {
+    if (ValidRatesAndFrameLengths(8000, kFrameLengths[j])) {
+      EXPECT_EQ(11, WebRtcVad_CalculateFeatures(self, speech, kFrameLengths[j],
+                                                features));
+      for (int k = 0; k < kNumChannels; ++k) {
+        EXPECT_EQ(kFeatures[k + frame_length_index * kNumChannels],
+                  features[k]);
+      }
+      frame_length_index++;
+    }
+  }
+  EXPECT_EQ(kNumValidFrameLengths, frame_length_index);
+
+  free(self);
+}
 }  // namespace test
 }  // namespace webrtc
@@ -15,6 +15,11 @@
 #include <limits>
 #include <sstream>
 
+#if defined(WEBRTC_POSIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/common_audio/wav_header.h"
 #include "webrtc/rtc_base/checks.h"
@@ -26,6 +31,9 @@ namespace webrtc {
 static const WavFormat kWavFormat = kWavFormatPcm;
 static const size_t kBytesPerSample = 2;
 
+// Size of the stdio buffer used by WavWriter.
+static const size_t kWriteBufferSize = 1 << 16;
+
 // Doesn't take ownership of the file handle and won't close it.
 class ReadableWavFile : public ReadableWav {
  public:
@@ -47,7 +55,10 @@ std::string WavFile::FormatAsString() const {
 }
 
 WavReader::WavReader(const std::string& filename)
-    : file_handle_(fopen(filename.c_str(), "rb")) {
+    : file_handle_(fopen(filename.c_str(), "rb")),
+      mapping_(nullptr),
+      mapping_size_(0),
+      mapped_samples_(nullptr) {
   RTC_CHECK(file_handle_) << "Could not open wav file for reading.";
 
   ReadableWavFile readable(file_handle_);
@@ -58,6 +69,7 @@ WavReader::WavReader(const std::string& filename)
   num_samples_remaining_ = num_samples_;
   RTC_CHECK_EQ(kWavFormat, format);
   RTC_CHECK_EQ(kBytesPerSample, bytes_per_sample);
+  MapSamples();
 }
 
 WavReader::~WavReader() {
@@ -82,6 +94,12 @@ size_t WavReader::ReadSamples(size_t num_samples, int16_t* samples) {
 #endif
   // There could be metadata after the audio; ensure we don't read it.
   num_samples = std::min(num_samples, num_samples_remaining_);
+  if (mapped_samples_) {
+    std::copy(mapped_samples_, mapped_samples_ + num_samples, samples);
+    mapped_samples_ += num_samples;
+    num_samples_remaining_ -= num_samples;
+    return num_samples;
+  }
   const size_t read =
       fread(samples, sizeof(*samples), num_samples, file_handle_);
   // If we didn't read what was requested, ensure we've reached the EOF.
@@ -92,6 +110,12 @@ size_t WavReader::ReadSamples(size_t num_samples, int16_t* samples) {
 }
 
 size_t WavReader::ReadSamples(size_t num_samples, float* samples) {
+  if (mapped_samples_) {
+    // Convert directly from the mapping.
+    const rtc::ArrayView<const int16_t> view = ReadSamplesView(num_samples);
+    std::copy(view.begin(), view.end(), samples);
+    return view.size();
+  }
   static const size_t kChunksize = 4096 / sizeof(uint16_t);
   size_t read = 0;
   for (size_t i = 0; i < num_samples; i += kChunksize) {
@@ -105,7 +129,56 @@ size_t WavReader::ReadSamples(size_t num_samples, float* samples) {
   return read;
 }
 
+rtc::ArrayView<const int16_t> WavReader::ReadSamplesView(size_t num_samples) {
+  num_samples = std::min(num_samples, num_samples_remaining_);
+  if (mapped_samples_) {
+    const rtc::ArrayView<const int16_t> view(mapped_samples_, num_samples);
+    mapped_samples_ += num_samples;
+    num_samples_remaining_ -= num_samples;
+    return view;
+  }
+  view_buffer_.resize(num_samples);
+  const size_t read = ReadSamples(num_samples, view_buffer_.data());
+  return rtc::ArrayView<const int16_t>(view_buffer_.data(), read);
+}
+
+void WavReader::MapSamples() {
+#if defined(WEBRTC_POSIX)
+  // The samples must be 16-bit aligned in the mapping, which is the case for
+  // all files with a valid chunk layout.
+  const long data_offset = ftell(file_handle_);
+  struct stat file_stat;
+  if (data_offset < 0 || data_offset % sizeof(int16_t) != 0 ||
+      fstat(fileno(file_handle_), &file_stat) != 0 ||
+      file_stat.st_size <= data_offset) {
+    return;
+  }
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE,
+                       fileno(file_handle_), 0);
+  if (mapping == MAP_FAILED)
+    return;
+  // The samples are usually read once from start to end.
+  madvise(mapping, file_size, MADV_SEQUENTIAL);
+  mapping_ = mapping;
+  mapping_size_ = file_size;
+  mapped_samples_ = reinterpret_cast<const int16_t*>(
+      static_cast<const uint8_t*>(mapping) + data_offset);
+  // A truncated file holds fewer samples than its header says.
+  num_samples_remaining_ =
+      std::min(num_samples_remaining_,
+               (file_size - data_offset) / sizeof(int16_t));
+#endif
+}
+
 void WavReader::Close() {
+#if defined(WEBRTC_POSIX)
+  if (mapping_) {
+    RTC_CHECK_EQ(0, munmap(mapping_, mapping_size_));
+    mapping_ = nullptr;
+    mapped_samples_ = nullptr;
+  }
+#endif
   RTC_CHECK_EQ(0, fclose(file_handle_));
   file_handle_ = nullptr;
 }
@@ -117,6 +190,7 @@ WavWriter::WavWriter(const std::string& filename, int sample_rate,
       num_samples_(0),
       file_handle_(fopen(filename.c_str(), "wb")) {
   RTC_CHECK(file_handle_) << "Could not open wav file for writing.";
+  RTC_CHECK_EQ(0, setvbuf(file_handle_, nullptr, _IOFBF, kWriteBufferSize));
   RTC_CHECK(CheckWavParameters(num_channels_, sample_rate_, kWavFormat,
                                kBytesPerSample, num_samples_));
 
@@ -16,7 +16,9 @@
 #include <stdint.h>
 #include <cstddef>
 #include <string>
+#include <vector>
 
+#include "webrtc/rtc_base/array_view.h"
 #include "webrtc/rtc_base/constructormagic.h"
 
 namespace webrtc {
@@ -36,6 +38,8 @@ class WavFile {
 
 // Simple C++ class for writing 16-bit PCM WAV files. All error handling is
 // by calls to RTC_CHECK(), making it unsuitable for anything but debug code.
+// Writes are buffered in large blocks, so many small WriteSamples() calls are
+// cheap.
 class WavWriter final : public WavFile {
  public:
   // Open a new WAV file for writing.
@@ -64,7 +68,8 @@ class WavWriter final : public WavFile {
   RTC_DISALLOW_COPY_AND_ASSIGN(WavWriter);
 };
 
-// Follows the conventions of WavWriter.
+// Follows the conventions of WavWriter. On POSIX platforms the file is memory
+// mapped, so the samples are read without any copies through the file API.
 class WavReader final : public WavFile {
  public:
   // Opens an existing WAV file for reading.
@@ -78,17 +83,30 @@ class WavReader final : public WavFile {
   size_t ReadSamples(size_t num_samples, float* samples);
   size_t ReadSamples(size_t num_samples, int16_t* samples);
 
+  // Reads up to |num_samples| samples like ReadSamples() but returns a view of
+  // them instead of copying them. When the file is memory mapped, the view
+  // points into the mapping; otherwise it points to an internal buffer. The
+  // view is valid until the next read or until the reader is destroyed.
+  rtc::ArrayView<const int16_t> ReadSamplesView(size_t num_samples);
+
   int sample_rate() const override;
   size_t num_channels() const override;
   size_t num_samples() const override;
 
  private:
+  // Maps the file into memory if supported, and points |mapped_samples_| to
+  // the first sample.
+  void MapSamples();
   void Close();
   int sample_rate_;
   size_t num_channels_;
   size_t num_samples_;  // Total number of samples in the file.
   size_t num_samples_remaining_;
   FILE* file_handle_;  // Input file, owned by this class.
+  void* mapping_;  // Mapping of the whole file, or null if not mapped.
+  size_t mapping_size_;
+  const int16_t* mapped_samples_;  // Next sample to read from |mapping_|.
+  std::vector<int16_t> view_buffer_;  // Used by ReadSamplesView() if unmapped.
 
   RTC_DISALLOW_COPY_AND_ASSIGN(WavReader);
 };
@@ -11,6 +11,7 @@
 // MSVC++ requires this to be set before any other includes to get M_PI.
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -174,4 +175,62 @@ TEST(WavWriterTest, LargeFile) {
   }
 }
 
+// Read a WAV file in chunks through the views returned by ReadSamplesView().
+TEST(WavReaderTest, ReadSamplesView) {
+  const std::string outfile = test::OutputPath() + "wavtest4.wav";
+  static const size_t kNumSamples = 1000;
+  int16_t samples[kNumSamples];
+  for (size_t i = 0; i < kNumSamples; ++i)
+    samples[i] = static_cast<int16_t>(i * 31 - 10000);
+  {
+    WavWriter w(outfile, 8000, 1);
+    w.WriteSamples(samples, kNumSamples);
+  }
+
+  WavReader r(outfile);
+  static const size_t kChunkSize = 300;
+  size_t num_read = 0;
+  for (rtc::ArrayView<const int16_t> view = r.ReadSamplesView(kChunkSize);
+       !view.empty(); view = r.ReadSamplesView(kChunkSize)) {
+    EXPECT_EQ(std::min(kChunkSize, kNumSamples - num_read), view.size());
+    for (size_t i = 0; i < view.size(); ++i)
+      EXPECT_EQ(samples[num_read + i], view[i]);
+    num_read += view.size();
+  }
+  EXPECT_EQ(kNumSamples, num_read);
+  int16_t sample;
+  EXPECT_EQ(0u, r.ReadSamples(1, &sample));
+}
+
+// Read a WAV file that holds fewer samples than its header says.
+TEST(WavReaderTest, TruncatedFile) {
+  const std::string outfile = test::OutputPath() + "wavtest5.wav";
+  static const size_t kNumSamples = 4;
+  static const size_t kNumTruncatedSamples = 3;
+  {
+    WavWriter w(outfile, 8000, 1);
+    w.WriteSamples(kSamples, kNumSamples);
+  }
+  static const size_t kTruncatedSize =
+      kWavHeaderSize + kNumTruncatedSamples * sizeof(int16_t);
+  uint8_t contents[kTruncatedSize];
+  FILE* f = fopen(outfile.c_str(), "rb");
+  ASSERT_TRUE(f);
+  ASSERT_EQ(1u, fread(contents, kTruncatedSize, 1, f));
+  EXPECT_EQ(0, fclose(f));
+  f = fopen(outfile.c_str(), "wb");
+  ASSERT_TRUE(f);
+  ASSERT_EQ(1u, fwrite(contents, kTruncatedSize, 1, f));
+  EXPECT_EQ(0, fclose(f));
+
+  WavReader r(outfile);
+  EXPECT_EQ(kNumSamples, r.num_samples());
+  float samples[kNumSamples];
+  EXPECT_EQ(kNumTruncatedSamples, r.ReadSamples(kNumSamples, samples));
+  EXPECT_EQ(0, samples[0]);
+  EXPECT_EQ(10, samples[1]);
+  EXPECT_EQ(32767, samples[2]);
+  EXPECT_EQ(0u, r.ReadSamples(kNumSamples, samples));
+}
+
 }  // namespace webrtc
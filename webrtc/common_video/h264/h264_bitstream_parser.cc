@@ -9,6 +9,7 @@
  */
 #include "webrtc/common_video/h264/h264_bitstream_parser.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -22,6 +23,10 @@ namespace {
 const int kMaxAbsQpDeltaValue = 51;
 const int kMinQpValue = 0;
 const int kMaxQpValue = 51;
+// Only the slice header, up to the QP delta, is parsed from a slice. It is
+// normally a few bytes long, so only this many bytes of the slice are
+// unescaped at first, rather than the whole slice data.
+const size_t kSliceHeaderPrefixSize = 256;
 }
 
 namespace webrtc {
@@ -287,7 +292,12 @@ void H264BitstreamParser::ParseSlice(const uint8_t* slice, size_t length) {
     case H264::NaluType::kSei:
       break;  // Ignore these nalus, as we don't care about their contents.
     default:
-      Result res = ParseNonParameterSetNalu(slice, length, nalu_type);
+      Result res = ParseNonParameterSetNalu(
+          slice, std::min(length, kSliceHeaderPrefixSize), nalu_type);
+      // Retry with the whole slice in case the header was longer than the
+      // prefix, e.g. with long reference picture list modifications.
+      if (res == kInvalidStream && length > kSliceHeaderPrefixSize)
+        res = ParseNonParameterSetNalu(slice, length, nalu_type);
       if (res != kOk)
         LOG(LS_INFO) << "Failed to parse bitstream. Error: " << res;
       break;
@@ -10,6 +10,8 @@
 
 #include "webrtc/common_video/h264/h264_bitstream_parser.h"
 
+#include <vector>
+
 #include "webrtc/test/gtest.h"
 
 namespace webrtc {
@@ -85,4 +87,18 @@ TEST(H264BitstreamParserTest, ReportsLastSliceQpForCABACImageSlices) {
   EXPECT_EQ(24, qp);
 }
 
+TEST(H264BitstreamParserTest, ReportsLastSliceQpForLargeImageSlices) {
+  // Append a long slice payload without start codes or emulation prevention
+  // bytes, so that only a prefix of the slice has to be unescaped.
+  std::vector<uint8_t> bitstream(
+      kH264BitstreamChunk, kH264BitstreamChunk + sizeof(kH264BitstreamChunk));
+  for (size_t i = 0; i < 4096; ++i)
+    bitstream.push_back(static_cast<uint8_t>(1 + i % 255));
+  H264BitstreamParser h264_parser;
+  h264_parser.ParseBitstream(bitstream.data(), bitstream.size());
+  int qp;
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(35, qp);
+}
+
 }  // namespace webrtc
@@ -10,8 +10,21 @@
 
 #include "webrtc/common_video/h264/h264_common.h"
 
+#include <string.h>
+
 namespace webrtc {
 namespace H264 {
+namespace {
+
+// Returns true if any of the eight bytes at |bytes| is zero, checking the whole
+// word at once rather than byte by byte.
+bool HasZeroByte(const uint8_t* bytes) {
+  uint64_t word;
+  memcpy(&word, bytes, sizeof(word));
+  return ((word - 0x0101010101010101ull) & ~word & 0x8080808080808080ull) != 0;
+}
+
+}  // namespace
 
 const uint8_t kNaluTypeMask = 0x1F;
 
@@ -20,14 +33,17 @@ std::vector<NaluIndex> FindNaluIndices(const uint8_t* buffer,
   // This is sorta like Boyer-Moore, but with only the first optimization step:
   // given a 3-byte sequence we're looking at, if the 3rd byte isn't 1 or 0,
   // skip ahead to the next 3-byte sequence. 0s and 1s are relatively rare, so
-  // this will skip the majority of reads/checks.
+  // this will skip the majority of reads/checks. Since every start sequence
+  // begins with a 0, eight bytes without any 0 among them are skipped at once.
   std::vector<NaluIndex> sequences;
   if (buffer_size < kNaluShortStartSequenceSize)
     return sequences;
 
   const size_t end = buffer_size - kNaluShortStartSequenceSize;
   for (size_t i = 0; i < end;) {
-    if (buffer[i + 2] > 1) {
+    if (i + sizeof(uint64_t) <= end && !HasZeroByte(&buffer[i])) {
+      i += sizeof(uint64_t);
+    } else if (buffer[i + 2] > 1) {
       i += 3;
     } else if (buffer[i + 2] == 1 && buffer[i + 1] == 0 && buffer[i] == 0) {
       // We found a start sequence, now check if it was a 3 of 4 byte one.
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/h264/h264_common.h"
+
+#include <vector>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace H264 {
+
+TEST(H264CommonTest, FindsNoNalusWithoutStartSequence) {
+  std::vector<uint8_t> buffer(64, 0xAB);
+  EXPECT_TRUE(FindNaluIndices(buffer.data(), buffer.size()).empty());
+  EXPECT_TRUE(FindNaluIndices(buffer.data(), 2).empty());
+}
+
+TEST(H264CommonTest, FindsShortAndLongStartSequences) {
+  const uint8_t kBuffer[] = {0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x80,
+                             0x00, 0x00, 0x01, 0x68, 0xce, 0x00, 0x00,
+                             0x00, 0x01, 0x65, 0xb8, 0x40, 0xf0};
+  std::vector<NaluIndex> indices = FindNaluIndices(kBuffer, sizeof(kBuffer));
+  ASSERT_EQ(3u, indices.size());
+  EXPECT_EQ(0u, indices[0].start_offset);
+  EXPECT_EQ(4u, indices[0].payload_start_offset);
+  EXPECT_EQ(3u, indices[0].payload_size);
+  EXPECT_EQ(7u, indices[1].start_offset);
+  EXPECT_EQ(10u, indices[1].payload_start_offset);
+  EXPECT_EQ(2u, indices[1].payload_size);
+  EXPECT_EQ(12u, indices[2].start_offset);
+  EXPECT_EQ(16u, indices[2].payload_start_offset);
+  EXPECT_EQ(4u, indices[2].payload_size);
+}
+
+// Places a start sequence at every offset of a long buffer, so that it is
+// found whether it starts within, or straddles, the words that are skipped.
+TEST(H264CommonTest, FindsStartSequenceAtAnyOffset) {
+  const size_t kBufferSize = 48;
+  for (size_t offset = 1; offset + 4 <= kBufferSize; ++offset) {
+    std::vector<uint8_t> buffer(kBufferSize, 0xAB);
+    buffer[offset] = 0x00;
+    buffer[offset + 1] = 0x00;
+    buffer[offset + 2] = 0x01;
+    std::vector<NaluIndex> indices =
+        FindNaluIndices(buffer.data(), buffer.size());
+    ASSERT_EQ(1u, indices.size()) << "offset " << offset;
+    EXPECT_EQ(offset, indices[0].start_offset);
+    EXPECT_EQ(offset + 3, indices[0].payload_start_offset);
+    EXPECT_EQ(kBufferSize - offset - 3, indices[0].payload_size);
+  }
+}
+
+}  // namespace H264
+}  // namespace webrtc
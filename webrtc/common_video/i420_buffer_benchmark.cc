@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace webrtc {
+
+// Scales a 720p frame to half the size, as done for the lower layers of
+// simulcast.
+TEST(I420BufferBenchmark, ScaleFrom720pToHalfSize) {
+  rtc::scoped_refptr<I420Buffer> source = I420Buffer::Create(1280, 720);
+  for (int y = 0; y < source->height(); ++y)
+    memset(source->MutableDataY() + y * source->StrideY(), y, source->width());
+  memset(source->MutableDataU(), 100,
+         source->StrideU() * source->ChromaHeight());
+  memset(source->MutableDataV(), 200,
+         source->StrideV() * source->ChromaHeight());
+  rtc::scoped_refptr<I420Buffer> destination = I420Buffer::Create(640, 360);
+  test::RunBenchmark("I420Buffer_ScaleFrom720pToHalfSize",
+                     1280 * 720 * 3 / 2,
+                     [&] { destination->ScaleFrom(*source); });
+  EXPECT_EQ(100, destination->DataU()[0]);
+  EXPECT_EQ(200, destination->DataV()[0]);
+}
+
+}  // namespace webrtc
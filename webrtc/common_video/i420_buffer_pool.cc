@@ -10,48 +10,210 @@
 
 #include "webrtc/common_video/include/i420_buffer_pool.h"
 
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/refcount.h"
+#include "webrtc/rtc_base/refcountedobject.h"
 
 namespace webrtc {
 
+namespace {
+
+// Free buffers of a resolution are dropped when it hasn't been requested in
+// this many calls to CreateBuffer, about ten seconds of 30 fps video.
+const int64_t kMaxIdleRequests = 300;
+
+size_t BufferSize(const I420Buffer& buffer) {
+  return static_cast<size_t>(buffer.StrideY()) * buffer.height() +
+         static_cast<size_t>(buffer.StrideU() + buffer.StrideV()) *
+             buffer.ChromaHeight();
+}
+
+}  // namespace
+
+// A buffer that goes back to its pool's free list instead of being deleted
+// when its reference count drops to zero.
+class I420BufferPool::PooledI420Buffer : public I420Buffer {
+ public:
+  PooledI420Buffer(FreeLists* free_lists, int width, int height)
+      : I420Buffer(width, height), free_lists_(free_lists) {}
+  ~PooledI420Buffer() override {}
+
+  int AddRef() const override { return rtc::AtomicOps::Increment(&ref_count_); }
+  int Release() const override;
+
+ private:
+  const rtc::scoped_refptr<FreeLists> free_lists_;
+  mutable volatile int ref_count_ = 0;
+};
+
+// The free buffers of a pool, per resolution. Owned by the pool and all of
+// its pending buffers.
+class I420BufferPool::FreeLists : public rtc::RefCountInterface {
+ public:
+  FreeLists(size_t max_number_of_buffers, size_t max_pooled_bytes)
+      : max_number_of_buffers_(max_number_of_buffers),
+        max_pooled_bytes_(max_pooled_bytes) {}
+
+  // Reserves a pending buffer of the given resolution. Returns false if there
+  // are already |max_number_of_buffers_| pending. Otherwise |*buffer| is set to
+  // a free buffer, or to null if one has to be allocated.
+  bool Take(int width, int height, PooledI420Buffer** buffer) {
+    std::vector<PooledI420Buffer*> dropped;
+    {
+      rtc::CritScope lock(&crit_);
+      if (num_pending_ >= max_number_of_buffers_)
+        return false;
+      ++num_pending_;
+      ++num_requests_;
+      FreeList& free_list = free_lists_[std::make_pair(width, height)];
+      free_list.last_request = num_requests_;
+      if (!free_list.buffers.empty()) {
+        ++stats_.hits;
+        *buffer = free_list.buffers.back();
+        free_list.buffers.pop_back();
+        stats_.pooled_bytes -= BufferSize(**buffer);
+        return true;
+      }
+      ++stats_.misses;
+      *buffer = nullptr;
+      // A miss is usually a resolution change; free what's no longer used.
+      for (auto it = free_lists_.begin(); it != free_lists_.end();) {
+        if (num_requests_ - it->second.last_request > kMaxIdleRequests) {
+          DropLocked(&it->second, &dropped);
+          it = free_lists_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (PooledI420Buffer* dropped_buffer : dropped)
+      delete dropped_buffer;
+    return true;
+  }
+
+  // Called when the last reference to |buffer| is dropped. May delete this
+  // object, through |buffer|'s reference.
+  void Return(PooledI420Buffer* buffer) {
+    std::vector<PooledI420Buffer*> dropped;
+    {
+      rtc::CritScope lock(&crit_);
+      RTC_DCHECK_GT(num_pending_, 0);
+      --num_pending_;
+      auto it = free_lists_.find(std::make_pair(buffer->width(),
+                                                buffer->height()));
+      const size_t size = BufferSize(*buffer);
+      // Make room by dropping free buffers of other resolutions first.
+      for (auto other = free_lists_.begin();
+           other != free_lists_.end() &&
+           stats_.pooled_bytes + size > max_pooled_bytes_;
+           ++other) {
+        if (other != it)
+          DropLocked(&other->second, &dropped);
+      }
+      if (it != free_lists_.end() &&
+          stats_.pooled_bytes + size <= max_pooled_bytes_) {
+        it->second.buffers.push_back(buffer);
+        stats_.pooled_bytes += size;
+      } else {
+        dropped.push_back(buffer);
+      }
+    }
+    for (PooledI420Buffer* dropped_buffer : dropped)
+      delete dropped_buffer;
+  }
+
+  // Frees all free buffers. Pending buffers are freed when returned, as their
+  // resolution has no free list until it's requested again.
+  void Clear() {
+    std::vector<PooledI420Buffer*> dropped;
+    {
+      rtc::CritScope lock(&crit_);
+      for (auto& free_list : free_lists_)
+        DropLocked(&free_list.second, &dropped);
+      free_lists_.clear();
+    }
+    for (PooledI420Buffer* dropped_buffer : dropped)
+      delete dropped_buffer;
+  }
+
+  Stats GetStats() const {
+    rtc::CritScope lock(&crit_);
+    return stats_;
+  }
+
+ private:
+  struct FreeList {
+    std::vector<PooledI420Buffer*> buffers;
+    // Value of |num_requests_| when this resolution was last requested.
+    int64_t last_request = 0;
+  };
+
+  // The buffers are deleted by the caller, after releasing |crit_|; each of
+  // them holds a reference to this object.
+  void DropLocked(FreeList* free_list,
+                  std::vector<PooledI420Buffer*>* dropped)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    for (PooledI420Buffer* buffer : free_list->buffers)
+      stats_.pooled_bytes -= BufferSize(*buffer);
+    dropped->insert(dropped->end(), free_list->buffers.begin(),
+                    free_list->buffers.end());
+    free_list->buffers.clear();
+  }
+
+  const size_t max_number_of_buffers_;
+  const size_t max_pooled_bytes_;
+  rtc::CriticalSection crit_;
+  std::map<std::pair<int, int>, FreeList> free_lists_ GUARDED_BY(crit_);
+  size_t num_pending_ GUARDED_BY(crit_) = 0;
+  int64_t num_requests_ GUARDED_BY(crit_) = 0;
+  Stats stats_ GUARDED_BY(crit_);
+};
+
+int I420BufferPool::PooledI420Buffer::Release() const {
+  int count = rtc::AtomicOps::Decrement(&ref_count_);
+  if (!count) {
+    PooledI420Buffer* self = const_cast<PooledI420Buffer*>(this);
+    free_lists_->Return(self);
+  }
+  return count;
+}
+
 I420BufferPool::I420BufferPool(bool zero_initialize,
-                               size_t max_number_of_buffers)
-    : zero_initialize_(zero_initialize),
-      max_number_of_buffers_(max_number_of_buffers) {}
+                               size_t max_number_of_buffers,
+                               size_t max_pooled_bytes)
+    : free_lists_(new rtc::RefCountedObject<FreeLists>(max_number_of_buffers,
+                                                       max_pooled_bytes)),
+      zero_initialize_(zero_initialize) {}
+
+I420BufferPool::~I420BufferPool() {
+  free_lists_->Clear();
+}
 
 void I420BufferPool::Release() {
-  buffers_.clear();
+  free_lists_->Clear();
 }
 
 rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
                                                             int height) {
-  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
-  // Release buffers with wrong resolution.
-  for (auto it = buffers_.begin(); it != buffers_.end();) {
-    if ((*it)->width() != width || (*it)->height() != height)
-      it = buffers_.erase(it);
-    else
-      ++it;
-  }
-  // Look for a free buffer.
-  for (const rtc::scoped_refptr<PooledI420Buffer>& buffer : buffers_) {
-    // If the buffer is in use, the ref count will be >= 2, one from the list we
-    // are looping over and one from the application. If the ref count is 1,
-    // then the list we are looping over holds the only reference and it's safe
-    // to reuse.
-    if (buffer->HasOneRef())
-      return buffer;
-  }
-
-  if (buffers_.size() >= max_number_of_buffers_)
+  PooledI420Buffer* buffer;
+  if (!free_lists_->Take(width, height, &buffer))
     return nullptr;
-  // Allocate new buffer.
-  rtc::scoped_refptr<PooledI420Buffer> buffer =
-      new PooledI420Buffer(width, height);
-  if (zero_initialize_)
-    buffer->InitializeData();
-  buffers_.push_back(buffer);
+  if (!buffer) {
+    buffer = new PooledI420Buffer(free_lists_.get(), width, height);
+    if (zero_initialize_)
+      buffer->InitializeData();
+  }
   return buffer;
 }
 
+I420BufferPool::Stats I420BufferPool::GetStats() const {
+  return free_lists_->GetStats();
+}
+
 }  // namespace webrtc
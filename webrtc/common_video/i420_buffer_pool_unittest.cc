@@ -9,8 +9,10 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "webrtc/common_video/include/i420_buffer_pool.h"
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/test/gtest.h"
 
 namespace webrtc {
@@ -70,4 +72,81 @@ TEST(TestI420BufferPool, MaxNumberOfBuffers) {
   EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
 }
 
+TEST(TestI420BufferPool, ReusesBuffersOfSeveralResolutions) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<I420Buffer> small = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<I420Buffer> large = pool.CreateBuffer(32, 32);
+  const uint8_t* small_y_ptr = small->DataY();
+  const uint8_t* large_y_ptr = large->DataY();
+  small = nullptr;
+  large = nullptr;
+
+  // Switching resolution back and forth doesn't allocate.
+  EXPECT_EQ(large_y_ptr, pool.CreateBuffer(32, 32)->DataY());
+  EXPECT_EQ(small_y_ptr, pool.CreateBuffer(16, 16)->DataY());
+  EXPECT_EQ(large_y_ptr, pool.CreateBuffer(32, 32)->DataY());
+
+  I420BufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(3, stats.hits);
+  EXPECT_EQ(2, stats.misses);
+  EXPECT_GT(stats.pooled_bytes, 0u);
+  pool.Release();
+  EXPECT_EQ(0u, pool.GetStats().pooled_bytes);
+}
+
+TEST(TestI420BufferPool, FreesIdleResolutions) {
+  I420BufferPool pool;
+  pool.CreateBuffer(16, 16);
+  for (int i = 0; i < 400; ++i)
+    pool.CreateBuffer(32, 32);
+  // The next miss frees the 16x16 buffer, which has been idle for too long.
+  pool.CreateBuffer(8, 8);
+  const int64_t misses = pool.GetStats().misses;
+  pool.CreateBuffer(16, 16);
+  EXPECT_EQ(misses + 1, pool.GetStats().misses);
+}
+
+TEST(TestI420BufferPool, MaxPooledBytes) {
+  rtc::scoped_refptr<I420Buffer> buffer1 = I420Buffer::Create(16, 16);
+  const size_t buffer_size = buffer1->StrideY() * 16 +
+                             (buffer1->StrideU() + buffer1->StrideV()) * 8;
+  I420BufferPool pool(false, std::numeric_limits<size_t>::max(), buffer_size);
+  buffer1 = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<I420Buffer> buffer2 = pool.CreateBuffer(16, 16);
+  buffer1 = nullptr;
+  buffer2 = nullptr;
+  // Only one of the buffers fits.
+  EXPECT_EQ(buffer_size, pool.GetStats().pooled_bytes);
+
+  // Returning a buffer of another resolution drops the pooled one.
+  buffer1 = pool.CreateBuffer(8, 8);
+  buffer1 = nullptr;
+  EXPECT_LT(pool.GetStats().pooled_bytes, buffer_size);
+}
+
+TEST(TestI420BufferPool, BuffersReturnedFromOtherThreads) {
+  struct ReleaseBuffers {
+    static void Run(void* obj) {
+      auto* buffers =
+          static_cast<std::vector<rtc::scoped_refptr<I420Buffer>>*>(obj);
+      buffers->clear();
+    }
+  };
+
+  const int kNumBuffers = 20;
+  I420BufferPool pool;
+  std::vector<rtc::scoped_refptr<I420Buffer>> buffers;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < kNumBuffers; ++i)
+      buffers.push_back(pool.CreateBuffer(16 + 16 * (i % 2), 16));
+    rtc::PlatformThread thread(&ReleaseBuffers::Run, &buffers, "Releaser");
+    thread.Start();
+    thread.Stop();
+    EXPECT_TRUE(buffers.empty());
+  }
+  I420BufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(kNumBuffers, stats.misses);
+  EXPECT_EQ(9 * kNumBuffers, stats.hits);
+}
+
 }  // namespace webrtc
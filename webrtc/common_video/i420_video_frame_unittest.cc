@@ -203,6 +203,48 @@ TEST(TestVideoFrame, TextureInitialValues) {
   EXPECT_EQ(20, frame.timestamp_us());
 }
 
+TEST(TestVideoFrame, UpdateRectDefaultsToWholeFrame) {
+  VideoFrame frame(I420Buffer::Create(64, 48), webrtc::kVideoRotation_0, 0);
+  EXPECT_FALSE(frame.has_update_rect());
+  VideoFrame::UpdateRect rect = frame.update_rect();
+  EXPECT_EQ(0, rect.offset_x);
+  EXPECT_EQ(0, rect.offset_y);
+  EXPECT_EQ(64, rect.width);
+  EXPECT_EQ(48, rect.height);
+
+  frame.set_update_rect(VideoFrame::UpdateRect{16, 8, 4, 2});
+  VideoFrame copy(frame);
+  ASSERT_TRUE(copy.has_update_rect());
+  EXPECT_EQ(16, copy.update_rect().offset_x);
+  EXPECT_EQ(8, copy.update_rect().offset_y);
+  EXPECT_EQ(4, copy.update_rect().width);
+  EXPECT_EQ(2, copy.update_rect().height);
+
+  copy.clear_update_rect();
+  EXPECT_FALSE(copy.has_update_rect());
+  EXPECT_EQ(64, copy.update_rect().width);
+}
+
+TEST(TestVideoFrame, UpdateRectUnion) {
+  VideoFrame::UpdateRect rect{0, 0, 0, 0};
+  EXPECT_TRUE(rect.IsEmpty());
+  rect.Union(VideoFrame::UpdateRect{10, 20, 5, 5});
+  EXPECT_EQ(10, rect.offset_x);
+  EXPECT_EQ(20, rect.offset_y);
+  EXPECT_EQ(5, rect.width);
+  EXPECT_EQ(5, rect.height);
+
+  // Empty rectangles don't grow the union.
+  rect.Union(VideoFrame::UpdateRect{100, 100, 0, 10});
+  EXPECT_EQ(5, rect.width);
+
+  rect.Union(VideoFrame::UpdateRect{0, 30, 2, 10});
+  EXPECT_EQ(0, rect.offset_x);
+  EXPECT_EQ(20, rect.offset_y);
+  EXPECT_EQ(15, rect.width);
+  EXPECT_EQ(20, rect.height);
+}
+
 TEST(TestI420FrameBuffer, Copy) {
   rtc::scoped_refptr<I420Buffer> buf1(
       I420Buffer::Create(20, 10));
@@ -279,6 +321,28 @@ TEST(TestI420FrameBuffer, CropAndScale16x9) {
   CheckCrop(*scaled_buffer, 0.0, 0.125, 1.0, 0.75);
 }
 
+TEST(TestI420FrameBuffer, CropAndScaleThroughVideoFrameBuffer) {
+  rtc::scoped_refptr<VideoFrameBuffer> buf = CreateGradient(200, 100);
+
+  rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer =
+      buf->CropAndScale(50, 0, 100, 100, 50, 50);
+  ASSERT_EQ(VideoFrameBuffer::Type::kI420, scaled_buffer->type());
+  EXPECT_EQ(50, scaled_buffer->width());
+  EXPECT_EQ(50, scaled_buffer->height());
+  CheckCrop(*scaled_buffer->GetI420(), 0.25, 0.0, 0.5, 1.0);
+}
+
+TEST(TestVideoFrame, CropAndScaleKeepsNativeBuffer) {
+  VideoFrame frame = test::FakeNativeBuffer::CreateFrame(
+      640, 480, 100, 10, webrtc::kVideoRotation_0);
+
+  rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer =
+      frame.video_frame_buffer()->CropAndScale(0, 60, 640, 360, 320, 180);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNative, scaled_buffer->type());
+  EXPECT_EQ(320, scaled_buffer->width());
+  EXPECT_EQ(180, scaled_buffer->height());
+}
+
 class TestI420BufferRotate
     : public ::testing::TestWithParam<webrtc::VideoRotation> {};
 
@@ -11,52 +11,69 @@
 #ifndef WEBRTC_COMMON_VIDEO_INCLUDE_I420_BUFFER_POOL_H_
 #define WEBRTC_COMMON_VIDEO_INCLUDE_I420_BUFFER_POOL_H_
 
-#include <list>
 #include <limits>
 
 #include "webrtc/api/video/i420_buffer.h"
-#include "webrtc/rtc_base/race_checker.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
-// Simple buffer pool to avoid unnecessary allocations of I420Buffer objects.
+// Thread-safe pool to avoid unnecessary allocations of I420Buffer objects.
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
-// When the I420Buffer is destructed, the memory is returned to the pool for use
-// by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
-// Note that CreateBuffer will crash if more than kMaxNumberOfFramesBeforeCrash
-// are created. This is to prevent memory leaks where frames are not returned.
+// When the last reference to such a buffer is dropped, on any thread, its
+// memory is returned to a free list for its resolution and reused by
+// subsequent calls to CreateBuffer with the same resolution. Free buffers of a
+// resolution that hasn't been asked for in a while are freed, as are free
+// buffers that would exceed |max_pooled_bytes|.
+// Buffers stay valid after the pool is destroyed.
 class I420BufferPool {
  public:
-  I420BufferPool()
-      : I420BufferPool(false) {}
+  struct Stats {
+    // Calls to CreateBuffer that did and did not find a free buffer.
+    int64_t hits = 0;
+    int64_t misses = 0;
+    // Memory held by free buffers.
+    size_t pooled_bytes = 0;
+  };
+
+  I420BufferPool() : I420BufferPool(false) {}
   explicit I420BufferPool(bool zero_initialize)
       : I420BufferPool(zero_initialize, std::numeric_limits<size_t>::max()) {}
-  I420BufferPool(bool zero_initialze, size_t max_number_of_buffers);
+  I420BufferPool(bool zero_initialze, size_t max_number_of_buffers)
+      : I420BufferPool(zero_initialze,
+                       max_number_of_buffers,
+                       std::numeric_limits<size_t>::max()) {}
+  I420BufferPool(bool zero_initialze,
+                 size_t max_number_of_buffers,
+                 size_t max_pooled_bytes);
+  ~I420BufferPool();
 
   // Returns a buffer from the pool. If no suitable buffer exist in the pool
   // and there are less than |max_number_of_buffers| pending, a buffer is
   // created. Returns null otherwise.
   rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height);
-  // Clears buffers_ and detaches the thread checker so that it can be reused
-  // later from another thread.
+  // Frees all buffers currently in the pool. Pending buffers are freed when
+  // released, unless their resolution is requested again before that.
   void Release();
 
+  Stats GetStats() const;
+
  private:
-  // Explicitly use a RefCountedObject to get access to HasOneRef,
-  // needed by the pool to check exclusive access.
-  using PooledI420Buffer = rtc::RefCountedObject<I420Buffer>;
+  class FreeLists;
+  class PooledI420Buffer;
 
-  rtc::RaceChecker race_checker_;
-  std::list<rtc::scoped_refptr<PooledI420Buffer>> buffers_;
+  // Shared with the pending buffers, so that they can be returned from any
+  // thread, also after the pool is gone.
+  const rtc::scoped_refptr<FreeLists> free_lists_;
   // If true, newly allocated buffers are zero-initialized. Note that recycled
   // buffers are not zero'd before reuse. This is required of buffers used by
   // FFmpeg according to http://crbug.com/390941, which only requires it for the
   // initial allocation (as shown by FFmpeg's own buffer allocation code). It
   // has to do with "Use-of-uninitialized-value" on "Linux_msan_chrome".
   const bool zero_initialize_;
-  // Max number of buffers this pool can have pending.
-  const size_t max_number_of_buffers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(I420BufferPool);
 };
 
 }  // namespace webrtc
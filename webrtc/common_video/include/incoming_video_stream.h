@@ -13,11 +13,16 @@
 
 #include "webrtc/common_video/video_render_frames.h"
 #include "webrtc/media/base/videosinkinterface.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/race_checker.h"
 #include "webrtc/rtc_base/task_queue.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
+// Passes frames on to |callback| on a task queue of its own, at their render
+// time. Frames are queued from the decoding thread without posting a task each;
+// the task queue only runs when the first queued frame is due.
 class IncomingVideoStream : public rtc::VideoSinkInterface<VideoFrame> {
  public:
   IncomingVideoStream(int32_t delay_ms,
@@ -27,14 +32,17 @@ class IncomingVideoStream : public rtc::VideoSinkInterface<VideoFrame> {
  private:
   void OnFrame(const VideoFrame& video_frame) override;
   void Dequeue();
-
-  // Fwd decl of a QueuedTask implementation for carrying frames over to the TQ.
-  class NewFrameTask;
+  // Posts Dequeue() for when the first queued frame is due, unless it is
+  // posted already.
+  void ScheduleDequeue() EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   rtc::ThreadChecker main_thread_checker_;
   rtc::RaceChecker decoder_race_checker_;
 
-  VideoRenderFrames render_buffers_;  // Only touched on the TaskQueue.
+  rtc::CriticalSection crit_;
+  VideoRenderFrames render_buffers_ GUARDED_BY(crit_);
+  // Whether Dequeue() is posted to |incoming_render_queue_|.
+  bool dequeue_scheduled_ GUARDED_BY(crit_);
   rtc::VideoSinkInterface<VideoFrame>* const callback_;
   rtc::TaskQueue incoming_render_queue_;
 };
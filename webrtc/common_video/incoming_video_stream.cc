@@ -22,35 +22,11 @@ namespace {
 const char kIncomingQueueName[] = "IncomingVideoStream";
 }
 
-// Capture by moving (std::move) into a lambda isn't possible in C++11
-// (supported in C++14). This class provides the functionality of what would be
-// something like (inside OnFrame):
-// VideoFrame frame(video_frame);
-// incoming_render_queue_.PostTask([this, frame = std::move(frame)](){
-//   if (render_buffers_.AddFrame(std::move(frame)) == 1)
-//     Dequeue();
-// });
-class IncomingVideoStream::NewFrameTask : public rtc::QueuedTask {
- public:
-  NewFrameTask(IncomingVideoStream* stream, VideoFrame frame)
-      : stream_(stream), frame_(std::move(frame)) {}
-
- private:
-  bool Run() override {
-    RTC_DCHECK(rtc::TaskQueue::IsCurrent(kIncomingQueueName));
-    if (stream_->render_buffers_.AddFrame(std::move(frame_)) == 1)
-      stream_->Dequeue();
-    return true;
-  }
-
-  IncomingVideoStream* stream_;
-  VideoFrame frame_;
-};
-
 IncomingVideoStream::IncomingVideoStream(
     int32_t delay_ms,
     rtc::VideoSinkInterface<VideoFrame>* callback)
     : render_buffers_(delay_ms),
+      dequeue_scheduled_(false),
       callback_(callback),
       incoming_render_queue_(kIncomingQueueName,
                              rtc::TaskQueue::Priority::HIGH) {}
@@ -63,20 +39,38 @@ void IncomingVideoStream::OnFrame(const VideoFrame& video_frame) {
   TRACE_EVENT0("webrtc", "IncomingVideoStream::OnFrame");
   RTC_CHECK_RUNS_SERIALIZED(&decoder_race_checker_);
   RTC_DCHECK(!incoming_render_queue_.IsCurrent());
-  incoming_render_queue_.PostTask(
-      std::unique_ptr<rtc::QueuedTask>(new NewFrameTask(this, video_frame)));
+  VideoFrame frame(video_frame);
+  rtc::CritScope lock(&crit_);
+  // Frames queued behind the first one are picked up when it is rendered.
+  if (render_buffers_.AddFrame(std::move(frame)) == 1)
+    ScheduleDequeue();
 }
 
 void IncomingVideoStream::Dequeue() {
   TRACE_EVENT0("webrtc", "IncomingVideoStream::Dequeue");
   RTC_DCHECK(incoming_render_queue_.IsCurrent());
-  rtc::Optional<VideoFrame> frame_to_render = render_buffers_.FrameToRender();
+  rtc::Optional<VideoFrame> frame_to_render;
+  {
+    rtc::CritScope lock(&crit_);
+    dequeue_scheduled_ = false;
+    frame_to_render = render_buffers_.FrameToRender();
+    if (render_buffers_.HasPendingFrames())
+      ScheduleDequeue();
+  }
   if (frame_to_render)
     callback_->OnFrame(*frame_to_render);
+}
 
-  if (render_buffers_.HasPendingFrames()) {
-    uint32_t wait_time = render_buffers_.TimeToNextFrameRelease();
-    incoming_render_queue_.PostDelayedTask([this]() { Dequeue(); }, wait_time);
+void IncomingVideoStream::ScheduleDequeue() {
+  if (dequeue_scheduled_)
+    return;
+  dequeue_scheduled_ = true;
+  uint32_t wait_time = render_buffers_.TimeToNextFrameRelease();
+  if (wait_time == 0) {
+    incoming_render_queue_.PostTask([this]() { Dequeue(); });
+  } else {
+    incoming_render_queue_.PostDelayedTask([this]() { Dequeue(); },
+                                           wait_time);
   }
 }
 
@@ -16,15 +16,19 @@
 #define WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_WEBRTC_LIBYUV_H_
 
 #include <stdio.h>
+#include <memory>
 #include <vector>
 
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/common_types.h"  // VideoTypes.
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/function_view.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
 class I420Buffer;
+class NV12Buffer;
 
 // This is the max PSNR value our algorithms can return.
 const double kPerfectPSNR = 48.0f;
@@ -129,6 +133,18 @@ void NV12Scale(uint8_t* tmp_buffer,
                uint8_t* dst_uv, int dst_stride_uv,
                int dst_width, int dst_height);
 
+// Crops |src| to the |crop_width| x |crop_height| rectangle at (|offset_x|,
+// |offset_y|) and scales it to the size of |dst|. The offsets are rounded down
+// to even numbers so that the UV plane stays aligned. |tmp_buffer| is resized
+// as needed and can be reused between calls to avoid allocations.
+void NV12CropAndScale(const NV12BufferInterface& src,
+                      int offset_x,
+                      int offset_y,
+                      int crop_width,
+                      int crop_height,
+                      NV12Buffer* dst,
+                      std::vector<uint8_t>* tmp_buffer);
+
 // Helper class for directly converting and scaling NV12 to I420. The Y-plane
 // will be scaled directly to the I420 destination, which makes this faster
 // than separate NV12->I420 + I420->I420 scaling.
@@ -143,10 +159,83 @@ class NV12ToI420Scaler {
                        uint8_t* dst_u, int dst_stride_u,
                        uint8_t* dst_v, int dst_stride_v,
                        int dst_width, int dst_height);
+
+  // Crops and scales |src| to the size of |dst|, with the same rounding of the
+  // offsets as NV12CropAndScale().
+  void NV12ToI420CropAndScale(const NV12BufferInterface& src,
+                              int offset_x,
+                              int offset_y,
+                              int crop_width,
+                              int crop_height,
+                              I420Buffer* dst);
+  void NV12ToI420Scale(const NV12BufferInterface& src, I420Buffer* dst);
+
  private:
   std::vector<uint8_t> tmp_uv_planes_;
 };
 
+// Helper class for converting and scaling large frames on several threads. The
+// frames are split into bands of rows, which are processed by libyuv in
+// parallel on the calling thread and num_threads() - 1 worker threads.
+// Bands are only used where they give the same result as the single-threaded
+// functions: ConvertToI420() without rotation and from uncompressed formats,
+// ConvertFromI420() to packed formats, and scaling down by a vertical factor
+// which libyuv steps through exactly (e.g. 3/2, 2 or 3) and which bands of
+// whole row pairs can keep. Anything else, as well as small frames, is
+// processed on the calling thread only.
+// Not thread-safe, one conversion runs at a time.
+class ParallelI420Converter {
+ public:
+  explicit ParallelI420Converter(int num_threads);
+  ~ParallelI420Converter();
+
+  int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Same as the ConvertToI420() function.
+  int ConvertToI420(VideoType src_video_type,
+                    const uint8_t* src_frame,
+                    int crop_x,
+                    int crop_y,
+                    int src_width,
+                    int src_height,
+                    size_t sample_size,
+                    VideoRotation rotation,
+                    I420Buffer* dst_buffer);
+
+  // Same as the ConvertFromI420() function.
+  int ConvertFromI420(const VideoFrame& src_frame,
+                      VideoType dst_video_type,
+                      int dst_sample_size,
+                      uint8_t* dst_frame);
+
+  // Same as dst->CropAndScaleFrom(src, offset_x, offset_y, crop_width,
+  // crop_height).
+  void CropAndScale(const I420BufferInterface& src,
+                    int offset_x,
+                    int offset_y,
+                    int crop_width,
+                    int crop_height,
+                    I420Buffer* dst);
+
+  // Same as dst->ScaleFrom(src).
+  void Scale(const I420BufferInterface& src, I420Buffer* dst);
+
+ private:
+  struct Worker;
+
+  // Returns how many bands a |width| x |height| image should be split into.
+  int NumBands(int width, int height) const;
+
+  // Runs |process_band| for each band in [0, |num_bands|), the first one on
+  // the calling thread, and waits for all of them. Returns the first non-zero
+  // result, or 0.
+  int ProcessBands(int num_bands, rtc::FunctionView<int(int)> process_band);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ParallelI420Converter);
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_WEBRTC_LIBYUV_H_
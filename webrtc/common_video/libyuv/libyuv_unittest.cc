@@ -12,14 +12,18 @@
 #include <string.h>
 
 #include <memory>
+#include <string>
 
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/nv12_buffer.h"
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/frame_utils.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 
@@ -29,6 +33,28 @@ void Calc16ByteAlignedStride(int width, int* stride_y, int* stride_uv) {
   *stride_uv = 16 * ((width + 31) / 32);
 }
 
+// Returns a frame with a deterministic pattern which doesn't repeat along
+// either axis, so that misplaced rows or columns show up in comparisons.
+rtc::scoped_refptr<I420Buffer> CreatePatternBuffer(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  uint32_t state = 1;
+  auto next = [&state]() {
+    state = state * 1103515245 + 12345;
+    return static_cast<uint8_t>(state >> 16);
+  };
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x)
+      buffer->MutableDataY()[y * buffer->StrideY() + x] = next();
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] = next();
+      buffer->MutableDataV()[y * buffer->StrideV() + x] = next();
+    }
+  }
+  return buffer;
+}
+
 }  // Anonymous namespace
 
 class TestLibYuv : public ::testing::Test {
@@ -325,4 +351,170 @@ TEST_F(TestLibYuv, NV12Scale4x4to2x2) {
               ::testing::ElementsAre(Average(0, 2, 4, 6), Average(1, 3, 5, 7)));
 }
 
+TEST_F(TestLibYuv, NV12BufferToI420) {
+  rtc::scoped_refptr<NV12Buffer> nv12 = NV12Buffer::Create(4, 2);
+  const uint8_t src_y[] = {0, 1, 2, 3,
+                           4, 5, 6, 7};
+  const uint8_t src_uv[] = {10, 20, 30, 40};
+  memcpy(nv12->MutableDataY(), src_y, sizeof(src_y));
+  memcpy(nv12->MutableDataUV(), src_uv, sizeof(src_uv));
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12, nv12->type());
+  EXPECT_EQ(2, nv12->ChromaWidth());
+  EXPECT_EQ(1, nv12->ChromaHeight());
+
+  rtc::scoped_refptr<I420BufferInterface> i420 = nv12->ToI420();
+  EXPECT_EQ(0, memcmp(src_y, i420->DataY(), 4));
+  EXPECT_EQ(0, memcmp(src_y + 4, i420->DataY() + i420->StrideY(), 4));
+  EXPECT_EQ(10, i420->DataU()[0]);
+  EXPECT_EQ(30, i420->DataU()[1]);
+  EXPECT_EQ(20, i420->DataV()[0]);
+  EXPECT_EQ(40, i420->DataV()[1]);
+
+  // And back again.
+  rtc::scoped_refptr<NV12Buffer> copy = NV12Buffer::Copy(*i420);
+  EXPECT_EQ(0, memcmp(src_y, copy->DataY(), 4));
+  EXPECT_EQ(0, memcmp(src_uv, copy->DataUV(), sizeof(src_uv)));
+}
+
+TEST_F(TestLibYuv, NV12CropAndScale) {
+  rtc::scoped_refptr<NV12Buffer> src = NV12Buffer::Create(6, 4);
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 6; ++x)
+      src->MutableDataY()[y * src->StrideY() + x] = 10 * y + x;
+  }
+  for (int i = 0; i < src->StrideUV() * src->ChromaHeight(); ++i)
+    src->MutableDataUV()[i] = 100 + i;
+
+  // The offset is rounded down to (2, 2).
+  rtc::scoped_refptr<NV12Buffer> dst = NV12Buffer::Create(2, 2);
+  std::vector<uint8_t> tmp_buffer;
+  NV12CropAndScale(*src, 3, 2, 2, 2, dst.get(), &tmp_buffer);
+  EXPECT_THAT(std::vector<uint8_t>(dst->DataY(), dst->DataY() + 2),
+              ::testing::ElementsAre(22, 23));
+  EXPECT_THAT(std::vector<uint8_t>(dst->DataY() + dst->StrideY(),
+                                   dst->DataY() + dst->StrideY() + 2),
+              ::testing::ElementsAre(32, 33));
+  EXPECT_THAT(std::vector<uint8_t>(dst->DataUV(), dst->DataUV() + 2),
+              ::testing::ElementsAre(108, 109));
+
+  NV12ToI420Scaler scaler;
+  rtc::scoped_refptr<I420Buffer> i420 = I420Buffer::Create(2, 2);
+  scaler.NV12ToI420CropAndScale(*src, 3, 2, 2, 2, i420.get());
+  EXPECT_EQ(22, i420->DataY()[0]);
+  EXPECT_EQ(33, i420->DataY()[i420->StrideY() + 1]);
+  EXPECT_EQ(108, i420->DataU()[0]);
+  EXPECT_EQ(109, i420->DataV()[0]);
+}
+
+TEST_F(TestLibYuv, ParallelConvertMatchesSingleThreaded) {
+  const int kWidth = 1920;
+  const int kHeight = 1080;
+  ParallelI420Converter converter(4);
+  EXPECT_EQ(4, converter.num_threads());
+  VideoFrame frame(CreatePatternBuffer(kWidth, kHeight), kVideoRotation_0, 0);
+
+  const size_t argb_size = CalcBufferSize(VideoType::kARGB, kWidth, kHeight);
+  std::vector<uint8_t> argb(argb_size);
+  std::vector<uint8_t> parallel_argb(argb_size);
+  EXPECT_EQ(0, ConvertFromI420(frame, VideoType::kARGB, 0, argb.data()));
+  EXPECT_EQ(0, converter.ConvertFromI420(frame, VideoType::kARGB, 0,
+                                         parallel_argb.data()));
+  EXPECT_EQ(argb, parallel_argb);
+
+  rtc::scoped_refptr<I420Buffer> i420 = I420Buffer::Create(kWidth, kHeight);
+  rtc::scoped_refptr<I420Buffer> parallel_i420 =
+      I420Buffer::Create(kWidth, kHeight);
+  EXPECT_EQ(0, ConvertToI420(VideoType::kARGB, argb.data(), 0, 0, kWidth,
+                             kHeight, argb_size, kVideoRotation_0, i420.get()));
+  EXPECT_EQ(0, converter.ConvertToI420(VideoType::kARGB, argb.data(), 0, 0,
+                                       kWidth, kHeight, argb_size,
+                                       kVideoRotation_0, parallel_i420.get()));
+  EXPECT_TRUE(test::FrameBufsEqual(i420, parallel_i420));
+
+  // Rotated conversions run on the calling thread, and must still work.
+  rtc::scoped_refptr<I420Buffer> rotated = I420Buffer::Create(kHeight, kWidth);
+  rtc::scoped_refptr<I420Buffer> parallel_rotated =
+      I420Buffer::Create(kHeight, kWidth);
+  EXPECT_EQ(0,
+            ConvertToI420(VideoType::kARGB, argb.data(), 0, 0, kWidth, kHeight,
+                          argb_size, kVideoRotation_90, rotated.get()));
+  EXPECT_EQ(0, converter.ConvertToI420(
+                   VideoType::kARGB, argb.data(), 0, 0, kWidth, kHeight,
+                   argb_size, kVideoRotation_90, parallel_rotated.get()));
+  EXPECT_TRUE(test::FrameBufsEqual(rotated, parallel_rotated));
+}
+
+TEST_F(TestLibYuv, ParallelScaleMatchesSingleThreaded) {
+  rtc::scoped_refptr<I420Buffer> src = CreatePatternBuffer(1920, 1080);
+  ParallelI420Converter converter(4);
+  // Exact factors of 2 and 3/2, a factor which can't be split into bands, and
+  // an upscale.
+  const struct {
+    int width;
+    int height;
+  } kSizes[] = {{960, 540}, {1280, 720}, {1000, 600}, {2560, 1440}};
+  for (const auto& size : kSizes) {
+    rtc::scoped_refptr<I420Buffer> scaled =
+        I420Buffer::Create(size.width, size.height);
+    rtc::scoped_refptr<I420Buffer> parallel_scaled =
+        I420Buffer::Create(size.width, size.height);
+    scaled->ScaleFrom(*src);
+    converter.Scale(*src, parallel_scaled.get());
+    EXPECT_TRUE(test::FrameBufsEqual(scaled, parallel_scaled))
+        << size.width << "x" << size.height;
+  }
+
+  rtc::scoped_refptr<I420Buffer> cropped = I420Buffer::Create(640, 360);
+  rtc::scoped_refptr<I420Buffer> parallel_cropped =
+      I420Buffer::Create(640, 360);
+  cropped->CropAndScaleFrom(*src, 160, 90, 1280, 720);
+  converter.CropAndScale(*src, 160, 90, 1280, 720, parallel_cropped.get());
+  EXPECT_TRUE(test::FrameBufsEqual(cropped, parallel_cropped));
+}
+
+// Reports the time per frame of converting and scaling 4K frames with
+// different numbers of threads.
+TEST_F(TestLibYuv, DISABLED_ParallelConvertAndScalePerf) {
+  const int kWidth = 3840;
+  const int kHeight = 2160;
+  const int kNumFrames = 20;
+  VideoFrame frame(CreatePatternBuffer(kWidth, kHeight), kVideoRotation_0, 0);
+  const size_t argb_size = CalcBufferSize(VideoType::kARGB, kWidth, kHeight);
+  std::vector<uint8_t> argb(argb_size);
+  rtc::scoped_refptr<I420Buffer> i420 = I420Buffer::Create(kWidth, kHeight);
+  rtc::scoped_refptr<I420Buffer> scaled = I420Buffer::Create(1280, 720);
+
+  for (int num_threads : {1, 2, 4, 8}) {
+    ParallelI420Converter converter(num_threads);
+    const std::string trace = std::to_string(num_threads) + "_threads";
+
+    int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; ++i)
+      converter.ConvertFromI420(frame, VideoType::kARGB, 0, argb.data());
+    test::PrintResult("i420_to_argb_4k", "", trace,
+                      static_cast<size_t>((rtc::TimeMicros() - start_us) /
+                                          kNumFrames),
+                      "us", false);
+
+    start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; ++i) {
+      converter.ConvertToI420(VideoType::kARGB, argb.data(), 0, 0, kWidth,
+                              kHeight, argb_size, kVideoRotation_0,
+                              i420.get());
+    }
+    test::PrintResult("argb_to_i420_4k", "", trace,
+                      static_cast<size_t>((rtc::TimeMicros() - start_us) /
+                                          kNumFrames),
+                      "us", false);
+
+    start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; ++i)
+      converter.Scale(*i420, scaled.get());
+    test::PrintResult("scale_4k_to_720p", "", trace,
+                      static_cast<size_t>((rtc::TimeMicros() - start_us) /
+                                          kNumFrames),
+                      "us", false);
+  }
+}
+
 }  // namespace webrtc
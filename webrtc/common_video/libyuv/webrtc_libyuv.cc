@@ -12,9 +12,14 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/task_queue.h"
 // TODO(nisse): Only needed for the deprecated ConvertToI420.
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/nv12_buffer.h"
 
 // NOTE(ajm): Path provided by gn.
 #include "libyuv.h"  // NOLINT
@@ -360,6 +365,51 @@ void NV12Scale(uint8_t* tmp_buffer,
                        dst_chroma_width, dst_chroma_height);
 }
 
+namespace {
+
+// Returns pointers to the top left corner of the crop rectangle of |src|,
+// after rounding the offsets down to even numbers.
+void CropNV12(const NV12BufferInterface& src,
+              int offset_x,
+              int offset_y,
+              int crop_width,
+              int crop_height,
+              const uint8_t** y_plane,
+              const uint8_t** uv_plane) {
+  RTC_CHECK_GE(offset_x, 0);
+  RTC_CHECK_GE(offset_y, 0);
+  RTC_CHECK_LE(crop_width + offset_x, src.width());
+  RTC_CHECK_LE(crop_height + offset_y, src.height());
+
+  const int uv_offset_x = offset_x / 2;
+  const int uv_offset_y = offset_y / 2;
+  *y_plane = src.DataY() + src.StrideY() * uv_offset_y * 2 + uv_offset_x * 2;
+  *uv_plane = src.DataUV() + src.StrideUV() * uv_offset_y + uv_offset_x * 2;
+}
+
+}  // namespace
+
+void NV12CropAndScale(const NV12BufferInterface& src,
+                      int offset_x,
+                      int offset_y,
+                      int crop_width,
+                      int crop_height,
+                      NV12Buffer* dst,
+                      std::vector<uint8_t>* tmp_buffer) {
+  const uint8_t* y_plane;
+  const uint8_t* uv_plane;
+  CropNV12(src, offset_x, offset_y, crop_width, crop_height, &y_plane,
+           &uv_plane);
+  if (crop_width != dst->width() || crop_height != dst->height()) {
+    tmp_buffer->resize(((crop_width + 1) / 2) * ((crop_height + 1) / 2) * 2 +
+                       dst->ChromaWidth() * dst->ChromaHeight() * 2);
+  }
+  NV12Scale(tmp_buffer->data(), y_plane, src.StrideY(), uv_plane,
+            src.StrideUV(), crop_width, crop_height, dst->MutableDataY(),
+            dst->StrideY(), dst->MutableDataUV(), dst->StrideUV(),
+            dst->width(), dst->height());
+}
+
 NV12ToI420Scaler::NV12ToI420Scaler() = default;
 NV12ToI420Scaler::~NV12ToI420Scaler() = default;
 
@@ -412,4 +462,262 @@ void NV12ToI420Scaler::NV12ToI420Scale(
                     libyuv::kFilterBox);
 }
 
+void NV12ToI420Scaler::NV12ToI420CropAndScale(const NV12BufferInterface& src,
+                                              int offset_x,
+                                              int offset_y,
+                                              int crop_width,
+                                              int crop_height,
+                                              I420Buffer* dst) {
+  const uint8_t* y_plane;
+  const uint8_t* uv_plane;
+  CropNV12(src, offset_x, offset_y, crop_width, crop_height, &y_plane,
+           &uv_plane);
+  NV12ToI420Scale(y_plane, src.StrideY(), uv_plane, src.StrideUV(), crop_width,
+                  crop_height, dst->MutableDataY(), dst->StrideY(),
+                  dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(),
+                  dst->StrideV(), dst->width(), dst->height());
+}
+
+void NV12ToI420Scaler::NV12ToI420Scale(const NV12BufferInterface& src,
+                                       I420Buffer* dst) {
+  NV12ToI420CropAndScale(src, 0, 0, src.width(), src.height(), dst);
+}
+
+namespace {
+
+// Frames are only split into bands of at least this many pixels, so that each
+// band takes long enough to be worth a thread hop.
+const int kMinPixelsPerBand = 320 * 180;
+
+// Returns the first row of |band| out of |num_bands| bands of an image of
+// |height| rows. The bands have an even number of rows, except the last one if
+// |height| is odd, so that they start at the same row of the chroma planes.
+int BandTop(int band, int num_bands, int height) {
+  if (band == num_bands)
+    return height;
+  return band * (height / 2) / num_bands * 2;
+}
+
+// Returns the number of bytes per pixel of |video_type| if it packs all
+// components into a single plane, or 0 if it doesn't.
+int PackedBytesPerPixel(VideoType video_type) {
+  switch (video_type) {
+    case VideoType::kRGB24:
+      return 3;
+    case VideoType::kABGR:
+    case VideoType::kARGB:
+    case VideoType::kBGRA:
+      return 4;
+    case VideoType::kARGB4444:
+    case VideoType::kRGB565:
+    case VideoType::kARGB1555:
+    case VideoType::kYUY2:
+    case VideoType::kUYVY:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+int GreatestCommonDivisor(int a, int b) {
+  while (b != 0) {
+    int remainder = a % b;
+    a = b;
+    b = remainder;
+  }
+  return a;
+}
+
+}  // namespace
+
+struct ParallelI420Converter::Worker {
+  Worker() : queue("I420ConverterWorker"), done(false, false) {}
+
+  rtc::TaskQueue queue;
+  rtc::Event done;
+  int result = 0;
+};
+
+ParallelI420Converter::ParallelI420Converter(int num_threads) {
+  RTC_DCHECK_GE(num_threads, 1);
+  for (int i = 1; i < num_threads; ++i)
+    workers_.emplace_back(new Worker());
+}
+
+ParallelI420Converter::~ParallelI420Converter() = default;
+
+int ParallelI420Converter::NumBands(int width, int height) const {
+  return std::max(1, std::min(num_threads(),
+                              width * height / kMinPixelsPerBand));
+}
+
+int ParallelI420Converter::ProcessBands(
+    int num_bands,
+    rtc::FunctionView<int(int)> process_band) {
+  RTC_DCHECK_LE(num_bands, num_threads());
+  for (int band = 1; band < num_bands; ++band) {
+    Worker* worker = workers_[band - 1].get();
+    worker->queue.PostTask([worker, band, &process_band]() {
+      worker->result = process_band(band);
+      worker->done.Set();
+    });
+  }
+  int result = process_band(0);
+  for (int band = 1; band < num_bands; ++band) {
+    Worker* worker = workers_[band - 1].get();
+    worker->done.Wait(rtc::Event::kForever);
+    if (result == 0)
+      result = worker->result;
+  }
+  return result;
+}
+
+int ParallelI420Converter::ConvertToI420(VideoType src_video_type,
+                                         const uint8_t* src_frame,
+                                         int crop_x,
+                                         int crop_y,
+                                         int src_width,
+                                         int src_height,
+                                         size_t sample_size,
+                                         VideoRotation rotation,
+                                         I420Buffer* dst_buffer) {
+  const int num_bands = NumBands(dst_buffer->width(), dst_buffer->height());
+  // MJPEG is decoded as a whole, rotation moves rows across bands and an
+  // inverted source is read from the bottom up.
+  if (num_bands == 1 || src_video_type == VideoType::kMJPEG ||
+      rotation != kVideoRotation_0 || src_height < 0) {
+    return webrtc::ConvertToI420(src_video_type, src_frame, crop_x, crop_y,
+                                 src_width, src_height, sample_size, rotation,
+                                 dst_buffer);
+  }
+
+  return ProcessBands(num_bands, [&](int band) {
+    const int top = BandTop(band, num_bands, dst_buffer->height());
+    const int bottom = BandTop(band + 1, num_bands, dst_buffer->height());
+    return libyuv::ConvertToI420(
+        src_frame, sample_size,
+        dst_buffer->MutableDataY() + top * dst_buffer->StrideY(),
+        dst_buffer->StrideY(),
+        dst_buffer->MutableDataU() + top / 2 * dst_buffer->StrideU(),
+        dst_buffer->StrideU(),
+        dst_buffer->MutableDataV() + top / 2 * dst_buffer->StrideV(),
+        dst_buffer->StrideV(),
+        crop_x, crop_y + top,
+        src_width, src_height,
+        dst_buffer->width(), bottom - top,
+        libyuv::kRotate0,
+        ConvertVideoType(src_video_type));
+  });
+}
+
+int ParallelI420Converter::ConvertFromI420(const VideoFrame& src_frame,
+                                           VideoType dst_video_type,
+                                           int dst_sample_size,
+                                           uint8_t* dst_frame) {
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer =
+      src_frame.video_frame_buffer()->ToI420();
+  const int width = src_frame.width();
+  const int height = src_frame.height();
+  const int bytes_per_pixel = PackedBytesPerPixel(dst_video_type);
+  // Planar formats store the planes one after the other, so their rows can't
+  // be addressed by band.
+  const int num_bands = bytes_per_pixel > 0 ? NumBands(width, height) : 1;
+  const int dst_stride =
+      dst_sample_size > 0 ? dst_sample_size : width * bytes_per_pixel;
+
+  return ProcessBands(num_bands, [&](int band) {
+    const int top = BandTop(band, num_bands, height);
+    const int bottom = BandTop(band + 1, num_bands, height);
+    return libyuv::ConvertFromI420(
+        i420_buffer->DataY() + top * i420_buffer->StrideY(),
+        i420_buffer->StrideY(),
+        i420_buffer->DataU() + top / 2 * i420_buffer->StrideU(),
+        i420_buffer->StrideU(),
+        i420_buffer->DataV() + top / 2 * i420_buffer->StrideV(),
+        i420_buffer->StrideV(),
+        dst_frame + top * dst_stride, dst_sample_size, width, bottom - top,
+        ConvertVideoType(dst_video_type));
+  });
+}
+
+void ParallelI420Converter::CropAndScale(const I420BufferInterface& src,
+                                         int offset_x,
+                                         int offset_y,
+                                         int crop_width,
+                                         int crop_height,
+                                         I420Buffer* dst) {
+  RTC_CHECK_LE(crop_width, src.width());
+  RTC_CHECK_LE(crop_height, src.height());
+  RTC_CHECK_LE(crop_width + offset_x, src.width());
+  RTC_CHECK_LE(crop_height + offset_y, src.height());
+  RTC_CHECK_GE(offset_x, 0);
+  RTC_CHECK_GE(offset_y, 0);
+
+  // The bands have to keep the scale factor of the frame, so they are made of
+  // units of |dst_unit| destination rows scaled from |src_unit| source rows.
+  // Both are even to keep the chroma planes aligned.
+  const int divisor = GreatestCommonDivisor(crop_height, dst->height());
+  int src_unit = crop_height / divisor;
+  int dst_unit = dst->height() / divisor;
+  if (src_unit % 2 != 0 || dst_unit % 2 != 0) {
+    src_unit *= 2;
+    dst_unit *= 2;
+  }
+  const int num_units = dst->height() / dst_unit;
+  int num_bands = std::min(NumBands(dst->width(), dst->height()), num_units);
+  // The filters read source rows across band edges when upscaling, and rows
+  // are weighted differently past the first band if the fixed-point vertical
+  // step of libyuv is not exact.
+  if (dst->height() > crop_height ||
+      (static_cast<int64_t>(crop_height) << 16) % dst->height() != 0) {
+    num_bands = 1;
+  }
+  if (num_bands == 1) {
+    dst->CropAndScaleFrom(src, offset_x, offset_y, crop_width, crop_height);
+    return;
+  }
+
+  // Make sure offset is even so that u/v plane becomes aligned.
+  const int uv_offset_x = offset_x / 2;
+  const int uv_offset_y = offset_y / 2;
+  offset_x = uv_offset_x * 2;
+  offset_y = uv_offset_y * 2;
+
+  int res = ProcessBands(num_bands, [&](int band) {
+    // The last band ends at the bottom of both frames, which keeps the scale
+    // factor even if it has a partial unit.
+    const int first_unit = band * num_units / num_bands;
+    const int src_top = first_unit * src_unit;
+    const int dst_top = first_unit * dst_unit;
+    int src_bottom = crop_height;
+    int dst_bottom = dst->height();
+    if (band + 1 < num_bands) {
+      const int end_unit = (band + 1) * num_units / num_bands;
+      src_bottom = end_unit * src_unit;
+      dst_bottom = end_unit * dst_unit;
+    }
+    return libyuv::I420Scale(
+        src.DataY() + src.StrideY() * (offset_y + src_top) + offset_x,
+        src.StrideY(),
+        src.DataU() + src.StrideU() * (uv_offset_y + src_top / 2) +
+            uv_offset_x,
+        src.StrideU(),
+        src.DataV() + src.StrideV() * (uv_offset_y + src_top / 2) +
+            uv_offset_x,
+        src.StrideV(),
+        crop_width, src_bottom - src_top,
+        dst->MutableDataY() + dst->StrideY() * dst_top, dst->StrideY(),
+        dst->MutableDataU() + dst->StrideU() * (dst_top / 2), dst->StrideU(),
+        dst->MutableDataV() + dst->StrideV() * (dst_top / 2), dst->StrideV(),
+        dst->width(), dst_bottom - dst_top, libyuv::kFilterBox);
+  });
+
+  RTC_DCHECK_EQ(res, 0);
+}
+
+void ParallelI420Converter::Scale(const I420BufferInterface& src,
+                                  I420Buffer* dst) {
+  CropAndScale(src, 0, 0, src.width(), src.height(), dst);
+}
+
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
 
@@ -26,7 +27,8 @@ const int kFutureRenderTimestampMS = 10000;
 const uint32_t kEventMaxWaitTimeMs = 200;
 const uint32_t kMinRenderDelayMs = 10;
 const uint32_t kMaxRenderDelayMs = 500;
-const size_t kMaxIncomingFramesBeforeLogged = 100;
+// Frames queued beyond this many are far behind their render time.
+const size_t kMaxIncomingFrames = 100;
 
 uint32_t EnsureValidRenderDelay(uint32_t render_delay) {
   return (render_delay < kMinRenderDelayMs || render_delay > kMaxRenderDelayMs)
@@ -36,14 +38,15 @@ uint32_t EnsureValidRenderDelay(uint32_t render_delay) {
 }  // namespace
 
 VideoRenderFrames::VideoRenderFrames(uint32_t render_delay_ms)
-    : render_delay_ms_(EnsureValidRenderDelay(render_delay_ms)) {}
+    : frames_(kMaxIncomingFrames),
+      render_delay_ms_(EnsureValidRenderDelay(render_delay_ms)) {}
 
 int32_t VideoRenderFrames::AddFrame(VideoFrame&& new_frame) {
   const int64_t time_now = rtc::TimeMillis();
 
   // Drop old frames only when there are other frames in the queue, otherwise, a
   // really slow system never renders any frames.
-  if (!incoming_frames_.empty() &&
+  if (num_frames_ != 0 &&
       new_frame.render_time_ms() + kOldRenderTimestampMS < time_now) {
     LOG(LS_WARNING) << "Too old frame, timestamp=" << new_frame.timestamp();
     return -1;
@@ -64,37 +67,52 @@ int32_t VideoRenderFrames::AddFrame(VideoFrame&& new_frame) {
     return -1;
   }
 
-  last_render_time_ms_ = new_frame.render_time_ms();
-  incoming_frames_.emplace_back(std::move(new_frame));
+  if (num_frames_ == frames_.size()) {
+    LOG(LS_WARNING) << "Stored incoming frames: " << num_frames_
+                    << ", dropping the oldest, timestamp="
+                    << front().timestamp();
+    PopFront();
+  }
 
-  if (incoming_frames_.size() > kMaxIncomingFramesBeforeLogged)
-    LOG(LS_WARNING) << "Stored incoming frames: " << incoming_frames_.size();
-  return static_cast<int32_t>(incoming_frames_.size());
+  last_render_time_ms_ = new_frame.render_time_ms();
+  frames_[(first_ + num_frames_) % frames_.size()].emplace(
+      std::move(new_frame));
+  ++num_frames_;
+  return static_cast<int32_t>(num_frames_);
 }
 
 rtc::Optional<VideoFrame> VideoRenderFrames::FrameToRender() {
   rtc::Optional<VideoFrame> render_frame;
+  const int64_t now_ms = rtc::TimeMillis();
   // Get the newest frame that can be released for rendering.
-  while (!incoming_frames_.empty() && TimeToNextFrameRelease() <= 0) {
-    render_frame =
-        rtc::Optional<VideoFrame>(std::move(incoming_frames_.front()));
-    incoming_frames_.pop_front();
+  while (num_frames_ != 0 && NextFrameReleaseTimeMs() <= now_ms) {
+    render_frame = std::move(frames_[first_]);
+    PopFront();
   }
   return render_frame;
 }
 
 uint32_t VideoRenderFrames::TimeToNextFrameRelease() {
-  if (incoming_frames_.empty()) {
+  if (num_frames_ == 0) {
     return kEventMaxWaitTimeMs;
   }
-  const int64_t time_to_release = incoming_frames_.front().render_time_ms() -
-                                  render_delay_ms_ -
-                                  rtc::TimeMillis();
+  const int64_t time_to_release = NextFrameReleaseTimeMs() - rtc::TimeMillis();
   return time_to_release < 0 ? 0u : static_cast<uint32_t>(time_to_release);
 }
 
+int64_t VideoRenderFrames::NextFrameReleaseTimeMs() const {
+  RTC_DCHECK_NE(num_frames_, 0);
+  return front().render_time_ms() - render_delay_ms_;
+}
+
 bool VideoRenderFrames::HasPendingFrames() const {
-  return !incoming_frames_.empty();
+  return num_frames_ != 0;
+}
+
+void VideoRenderFrames::PopFront() {
+  frames_[first_].reset();
+  first_ = (first_ + 1) % frames_.size();
+  --num_frames_;
 }
 
 }  // namespace webrtc
@@ -13,7 +13,7 @@
 
 #include <stdint.h>
 
-#include <list>
+#include <vector>
 
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/rtc_base/optional.h"
@@ -35,11 +35,23 @@ class VideoRenderFrames {
   // Returns the number of ms to next frame to render
   uint32_t TimeToNextFrameRelease();
 
+  // Returns when the next frame is to be released for rendering, in
+  // rtc::TimeMillis() time. Must only be called with pending frames.
+  int64_t NextFrameReleaseTimeMs() const;
+
   bool HasPendingFrames() const;
 
  private:
-  // Sorted list with framed to be rendered, oldest first.
-  std::list<VideoFrame> incoming_frames_;
+  VideoFrame& front() { return *frames_[first_]; }
+  const VideoFrame& front() const { return *frames_[first_]; }
+  void PopFront();
+
+  // Frames to be rendered, oldest first, in a ring of fixed capacity so that
+  // queueing a frame doesn't allocate. The oldest frame is dropped when the
+  // ring is full.
+  std::vector<rtc::Optional<VideoFrame>> frames_;
+  size_t first_ = 0;
+  size_t num_frames_ = 0;
 
   // Estimated delay from a frame is released until it's rendered.
   const uint32_t render_delay_ms_;
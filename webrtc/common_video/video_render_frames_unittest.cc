@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/video_render_frames.h"
+
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/rtc_base/fakeclock.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kRenderDelayMs = 10;
+
+VideoFrame CreateFrame(uint32_t timestamp, int64_t render_time_ms) {
+  return VideoFrame(I420Buffer::Create(2, 2), timestamp, render_time_ms,
+                    kVideoRotation_0);
+}
+
+class VideoRenderFramesTest : public ::testing::Test {
+ protected:
+  VideoRenderFramesTest() : render_frames_(kRenderDelayMs) {
+    clock_.SetTimeMicros(1000 * rtc::kNumMicrosecsPerMillisec);
+  }
+
+  int64_t NowMs() const { return rtc::TimeMillis(); }
+  void AdvanceTimeMs(int64_t ms) {
+    clock_.AdvanceTimeMicros(ms * rtc::kNumMicrosecsPerMillisec);
+  }
+
+  rtc::ScopedFakeClock clock_;
+  VideoRenderFrames render_frames_;
+};
+
+}  // namespace
+
+TEST_F(VideoRenderFramesTest, ReleasesFramesAtRenderTime) {
+  EXPECT_EQ(1, render_frames_.AddFrame(CreateFrame(1, NowMs() + 50)));
+  EXPECT_EQ(2, render_frames_.AddFrame(CreateFrame(2, NowMs() + 80)));
+  EXPECT_EQ(50 - kRenderDelayMs, render_frames_.TimeToNextFrameRelease());
+  EXPECT_FALSE(render_frames_.FrameToRender());
+
+  AdvanceTimeMs(50 - kRenderDelayMs);
+  rtc::Optional<VideoFrame> frame = render_frames_.FrameToRender();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(1u, frame->timestamp());
+  EXPECT_TRUE(render_frames_.HasPendingFrames());
+
+  // Only the newest of the frames that are due is released.
+  render_frames_.AddFrame(CreateFrame(3, NowMs() + 100));
+  AdvanceTimeMs(100);
+  frame = render_frames_.FrameToRender();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(3u, frame->timestamp());
+  EXPECT_FALSE(render_frames_.HasPendingFrames());
+}
+
+TEST_F(VideoRenderFramesTest, DropsOldestFrameWhenFull) {
+  // Adds and releases frames to wrap around the ring a few times.
+  uint32_t timestamp = 0;
+  for (int i = 0; i < 250; ++i) {
+    render_frames_.AddFrame(CreateFrame(timestamp++, NowMs() + kRenderDelayMs));
+    rtc::Optional<VideoFrame> frame = render_frames_.FrameToRender();
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(timestamp - 1, frame->timestamp());
+  }
+
+  const uint32_t first_timestamp = timestamp;
+  int last_num_frames = 0;
+  for (int i = 0; i < 150; ++i) {
+    last_num_frames =
+        render_frames_.AddFrame(CreateFrame(timestamp++, NowMs() + 1000 + i));
+  }
+  EXPECT_EQ(100, last_num_frames);
+  // The first 50 frames have been dropped.
+  AdvanceTimeMs(1000 + 50 - kRenderDelayMs);
+  rtc::Optional<VideoFrame> frame = render_frames_.FrameToRender();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(first_timestamp + 50, frame->timestamp());
+}
+
+}  // namespace webrtc
@@ -252,6 +252,10 @@ class VideoEncoderConfig {
   int min_transmit_bitrate_bps;
   int max_bitrate_bps;
 
+  // Relative priority of this stream when encoders of the same Call compete
+  // for CPU, see EncoderAdmissionController. 1.0 is the normal priority.
+  double bitrate_priority;
+
   // Max number of encoded VideoStreams to produce.
   size_t number_of_streams;
 
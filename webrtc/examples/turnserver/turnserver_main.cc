@@ -10,9 +10,7 @@
 
 #include <iostream>  // NOLINT
 
-#include "webrtc/p2p/base/basicpacketsocketfactory.h"
-#include "webrtc/p2p/base/turnserver.h"
-#include "webrtc/rtc_base/asyncudpsocket.h"
+#include "webrtc/p2p/base/shardedturnserver.h"
 #include "webrtc/rtc_base/optionsfile.h"
 #include "webrtc/rtc_base/stringencode.h"
 #include "webrtc/rtc_base/thread.h"
@@ -42,8 +40,8 @@ class TurnFileAuth : public cricket::TurnAuthInterface {
 };
 
 int main(int argc, char **argv) {
-  if (argc != 5) {
-    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file"
+  if (argc != 5 && argc != 6) {
+    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file [threads]"
               << std::endl;
     return 1;
   }
@@ -60,26 +58,29 @@ int main(int argc, char **argv) {
     return 1;
   }
 
-  rtc::Thread* main = rtc::Thread::Current();
-  rtc::AsyncUDPSocket* int_socket =
-      rtc::AsyncUDPSocket::Create(main->socketserver(), int_addr);
-  if (!int_socket) {
-    std::cerr << "Failed to create a UDP socket bound at"
-              << int_addr.ToString() << std::endl;
+  int num_threads = 1;
+  if (argc == 6 && (!rtc::FromString(argv[5], &num_threads) ||
+                    num_threads < 1)) {
+    std::cerr << "Invalid number of threads: " << argv[5] << std::endl;
     return 1;
   }
 
-  cricket::TurnServer server(main);
+  // The allocations are spread over the threads, which all share the port of
+  // |int_addr|.
+  cricket::ShardedTurnServer server(num_threads);
   TurnFileAuth auth(argv[4]);
   server.set_realm(argv[3]);
   server.set_software(kSoftware);
   server.set_auth_hook(&auth);
-  server.AddInternalSocket(int_socket, cricket::PROTO_UDP);
-  server.SetExternalSocketFactory(new rtc::BasicPacketSocketFactory(),
-                                  rtc::SocketAddress(ext_addr, 0));
+  if (!server.AddInternalSocket(int_addr, cricket::PROTO_UDP)) {
+    std::cerr << "Failed to create a UDP socket bound at"
+              << int_addr.ToString() << std::endl;
+    return 1;
+  }
+  server.SetExternalAddress(rtc::SocketAddress(ext_addr, 0));
 
   std::cout << "Listening internally at " << int_addr.ToString() << std::endl;
 
-  main->Run();
+  rtc::Thread::Current()->Run();
   return 0;
 }
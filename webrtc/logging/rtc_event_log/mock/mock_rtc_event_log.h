@@ -29,6 +29,8 @@ class MockRtcEventLog : public RtcEventLog {
 
   MOCK_METHOD0(StopLogging, void());
 
+  MOCK_METHOD1(SetColumnarFormat, void(bool enable));
+
   MOCK_METHOD1(LogVideoReceiveStreamConfig,
                void(const rtclog::StreamConfig& config));
 
@@ -76,6 +78,8 @@ class MockRtcEventLog : public RtcEventLog {
   MOCK_METHOD2(LogProbeResultSuccess, void(int id, int bitrate_bps));
   MOCK_METHOD2(LogProbeResultFailure,
                void(int id, ProbeFailureReason failure_reason));
+
+  MOCK_METHOD1(LogAlrState, void(bool in_alr));
 };
 
 }  // namespace webrtc
@@ -64,6 +64,7 @@ class RtcEventLogImpl final : public RtcEventLog {
   bool StartLogging(rtc::PlatformFile platform_file,
                     int64_t max_size_bytes) override;
   void StopLogging() override;
+  void SetColumnarFormat(bool enable) override;
   void LogVideoReceiveStreamConfig(const rtclog::StreamConfig& config) override;
   void LogVideoSendStreamConfig(const rtclog::StreamConfig& config) override;
   void LogAudioReceiveStreamConfig(const rtclog::StreamConfig& config) override;
@@ -93,6 +94,7 @@ class RtcEventLogImpl final : public RtcEventLog {
   void LogProbeResultSuccess(int id, int bitrate_bps) override;
   void LogProbeResultFailure(int id,
                              ProbeFailureReason failure_reason) override;
+  void LogAlrState(bool in_alr) override;
 
  private:
   // Private constructor to ensure that creation is done by RtcEventLog::Create.
@@ -111,9 +113,14 @@ class RtcEventLogImpl final : public RtcEventLog {
   // Message queue for passing events to the logging thread.
   SwapQueue<std::unique_ptr<rtclog::Event> > event_queue_;
 
+  // The RTP events that the logging thread is done with.
+  RtpEventPool rtp_event_pool_;
+
   RtcEventLogHelperThread helper_thread_;
   rtc::ThreadChecker thread_checker_;
 
+  bool columnar_format_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcEventLogImpl);
 };
 
@@ -177,8 +184,10 @@ RtcEventLogImpl::RtcEventLogImpl()
     // Allocate buffers for roughly one second of history.
     : message_queue_(kControlMessagesPerSecond),
       event_queue_(kEventsPerSecond),
-      helper_thread_(&message_queue_, &event_queue_),
-      thread_checker_() {
+      rtp_event_pool_(kEventsPerSecond),
+      helper_thread_(&message_queue_, &event_queue_, &rtp_event_pool_),
+      thread_checker_(),
+      columnar_format_(false) {
   thread_checker_.DetachFromThread();
 }
 
@@ -199,6 +208,7 @@ bool RtcEventLogImpl::StartLogging(const std::string& file_name,
                                : max_size_bytes;
   message.start_time = rtc::TimeMicros();
   message.stop_time = std::numeric_limits<int64_t>::max();
+  message.columnar_format = columnar_format_;
   message.file.reset(FileWrapper::Create());
   if (!message.file->OpenFile(file_name.c_str(), false)) {
     LOG(LS_ERROR) << "Can't open file. WebRTC event log not started.";
@@ -223,6 +233,7 @@ bool RtcEventLogImpl::StartLogging(rtc::PlatformFile platform_file,
                                : max_size_bytes;
   message.start_time = rtc::TimeMicros();
   message.stop_time = std::numeric_limits<int64_t>::max();
+  message.columnar_format = columnar_format_;
   message.file.reset(FileWrapper::Create());
   FILE* file_handle = rtc::FdopenPlatformFileForWriting(platform_file);
   if (!file_handle) {
@@ -267,6 +278,11 @@ void RtcEventLogImpl::StopLogging() {
   helper_thread_.WaitForFileFinished();
 }
 
+void RtcEventLogImpl::SetColumnarFormat(bool enable) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  columnar_format_ = enable;
+}
+
 void RtcEventLogImpl::LogVideoReceiveStreamConfig(
     const rtclog::StreamConfig& config) {
   std::unique_ptr<rtclog::Event> event(new rtclog::Event());
@@ -408,7 +424,7 @@ void RtcEventLogImpl::LogRtpHeader(PacketDirection direction,
     header_length += (x_len + 1) * 4;
   }
 
-  std::unique_ptr<rtclog::Event> rtp_event(new rtclog::Event());
+  std::unique_ptr<rtclog::Event> rtp_event = rtp_event_pool_.Get();
   rtp_event->set_timestamp_us(rtc::TimeMicros());
   rtp_event->set_type(rtclog::Event::RTP_EVENT);
   rtp_event->mutable_rtp_packet()->set_incoming(direction == kIncomingPacket);
@@ -565,6 +581,14 @@ void RtcEventLogImpl::LogProbeResult(int id,
   StoreEvent(std::move(event));
 }
 
+void RtcEventLogImpl::LogAlrState(bool in_alr) {
+  std::unique_ptr<rtclog::Event> event(new rtclog::Event());
+  event->set_timestamp_us(rtc::TimeMicros());
+  event->set_type(rtclog::Event::ALR_STATE_EVENT);
+  event->mutable_alr_state()->set_in_alr(in_alr);
+  StoreEvent(std::move(event));
+}
+
 void RtcEventLogImpl::StoreEvent(std::unique_ptr<rtclog::Event> event) {
   RTC_DCHECK(event.get() != nullptr);
   if (!event_queue_.Insert(&event)) {
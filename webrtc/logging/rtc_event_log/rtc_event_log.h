@@ -109,6 +109,12 @@ class RtcEventLog {
   // Stops logging to file and waits until the thread has finished.
   virtual void StopLogging() = 0;
 
+  // If enabled, the logs started afterwards write runs of RTP, RTCP, audio
+  // playout and BWE events in batches, with each field delta encoded in a
+  // column of its own. This is smaller and faster to write, but can only be
+  // read by a parser that knows the format. Off by default.
+  virtual void SetColumnarFormat(bool enable) = 0;
+
   // Logs configuration information for a video receive stream.
   virtual void LogVideoReceiveStreamConfig(
       const rtclog::StreamConfig& config) = 0;
@@ -170,6 +176,9 @@ class RtcEventLog {
   virtual void LogProbeResultFailure(int id,
                                      ProbeFailureReason failure_reason) = 0;
 
+  // Logs when the sender enters or leaves an application limited region.
+  virtual void LogAlrState(bool in_alr) = 0;
+
   // Reads an RtcEventLog file and returns true when reading was successful.
   // The result is stored in the given EventStream object.
   // The order of the events in the EventStream is implementation defined.
@@ -193,6 +202,7 @@ class RtcEventLogNullImpl : public RtcEventLog {
     return false;
   }
   void StopLogging() override {}
+  void SetColumnarFormat(bool enable) override {}
   void LogVideoReceiveStreamConfig(
       const rtclog::StreamConfig& config) override {}
   void LogVideoSendStreamConfig(const rtclog::StreamConfig& config) override {}
@@ -224,6 +234,7 @@ class RtcEventLogNullImpl : public RtcEventLog {
   void LogProbeResultSuccess(int id, int bitrate_bps) override{};
   void LogProbeResultFailure(int id,
                              ProbeFailureReason failure_reason) override{};
+  void LogAlrState(bool in_alr) override {}
 };
 
 }  // namespace webrtc
@@ -160,6 +160,10 @@ std::string EventTypeToString(webrtc::rtclog::Event::EventType event_type) {
       return "BWE_PROBE_CREATED";
     case webrtc::rtclog::Event::BWE_PROBE_RESULT_EVENT:
       return "BWE_PROBE_RESULT";
+    case webrtc::rtclog::Event::EVENT_BATCH:
+      return "EVENT_BATCH";
+    case webrtc::rtclog::Event::ALR_STATE_EVENT:
+      return "ALR_STATE";
   }
   RTC_NOTREACHED();
   return "UNKNOWN_EVENT";
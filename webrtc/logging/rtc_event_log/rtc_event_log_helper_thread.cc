@@ -10,11 +10,15 @@
 
 #include "webrtc/logging/rtc_event_log/rtc_event_log_helper_thread.h"
 
+#include <string.h>
+
 #include <algorithm>
 
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/metrics.h"
 
 #ifdef ENABLE_RTC_EVENT_LOG
 
@@ -23,6 +27,37 @@ namespace webrtc {
 namespace {
 const int kEventsInHistory = 10000;
 
+// The tag of the stream field of EventStream, (1 << 3) | length-delimited.
+const uint8_t kEventStreamTag = (1 << 3) | 2;
+// The length of the fixed part of an RTP header.
+const size_t kFixedRtpHeaderSize = 12;
+// The most that the fields of one event add to an EVENT_BATCH, apart from
+// the RTP header tail or RTCP packet.
+const size_t kMaxBatchBytesPerEvent = 64;
+// Keeps the batches well below the largest event that the parser reads.
+const size_t kMaxBatchSizeBytes = 32000;
+
+// Writes |value| as a protobuf varint to |out|, and returns the end of it.
+uint8_t* WriteVarint(uint64_t value, uint8_t* out) {
+  while (value >= 0x80) {
+    *out++ = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(value);
+  return out;
+}
+
+// Returns true for the event types that are frequent enough to be batched in
+// the columnar format.
+bool IsBatchedEvent(const rtclog::Event& event) {
+  rtclog::Event_EventType event_type = event.type();
+  return event_type == rtclog::Event::RTP_EVENT ||
+         event_type == rtclog::Event::RTCP_EVENT ||
+         event_type == rtclog::Event::AUDIO_PLAYOUT_EVENT ||
+         event_type == rtclog::Event::LOSS_BASED_BWE_UPDATE ||
+         event_type == rtclog::Event::DELAY_BASED_BWE_UPDATE;
+}
+
 bool IsConfigEvent(const rtclog::Event& event) {
   rtclog::Event_EventType event_type = event.type();
   return event_type == rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT ||
@@ -32,24 +67,61 @@ bool IsConfigEvent(const rtclog::Event& event) {
 }
 }  // namespace
 
+RtpEventPool::RtpEventPool(size_t max_size) : max_size_(max_size) {}
+
+RtpEventPool::~RtpEventPool() = default;
+
+std::unique_ptr<rtclog::Event> RtpEventPool::Get() {
+  {
+    rtc::CritScope lock(&crit_);
+    if (!events_.empty()) {
+      std::unique_ptr<rtclog::Event> event = std::move(events_.back());
+      events_.pop_back();
+      return event;
+    }
+  }
+  return std::unique_ptr<rtclog::Event>(new rtclog::Event());
+}
+
+void RtpEventPool::Put(std::unique_ptr<rtclog::Event> event) {
+  RTC_DCHECK_EQ(rtclog::Event::RTP_EVENT, event->type());
+  // The other fields are always set by the logger.
+  event->mutable_rtp_packet()->clear_probe_cluster_id();
+  rtc::CritScope lock(&crit_);
+  if (events_.size() < max_size_) {
+    events_.push_back(std::move(event));
+  }
+}
+
 // RtcEventLogImpl member functions.
 RtcEventLogHelperThread::RtcEventLogHelperThread(
     SwapQueue<ControlMessage>* message_queue,
-    SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue)
+    SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue,
+    RtpEventPool* rtp_event_pool)
     : message_queue_(message_queue),
       event_queue_(event_queue),
+      rtp_event_pool_(rtp_event_pool),
       file_(FileWrapper::Create()),
       thread_(&ThreadOutputFunction, this, "RtcEventLog thread"),
       max_size_bytes_(std::numeric_limits<int64_t>::max()),
       written_bytes_(0),
       start_time_(0),
       stop_time_(std::numeric_limits<int64_t>::max()),
+      columnar_format_(false),
       has_recent_event_(false),
+      batch_last_timestamp_us_(0),
+      batch_last_loss_bitrate_bps_(0),
+      batch_last_total_packets_(0),
+      batch_last_delay_bitrate_bps_(0),
+      batch_max_size_bytes_(0),
+      num_serialized_events_(0),
+      serialization_time_ns_(0),
       wake_periodically_(false, false),
       wake_from_hibernation_(false, false),
       file_finished_(false, false) {
   RTC_DCHECK(message_queue_);
   RTC_DCHECK(event_queue_);
+  RTC_DCHECK(rtp_event_pool_);
   thread_.Start();
 }
 
@@ -81,25 +153,185 @@ void RtcEventLogHelperThread::SignalNewEvent() {
   wake_from_hibernation_.Set();
 }
 
-bool RtcEventLogHelperThread::AppendEventToString(rtclog::Event* event) {
-  rtclog::EventStream event_stream;
-  event_stream.add_stream();
-  event_stream.mutable_stream(0)->Swap(event);
-  // We create a new event stream per event but because of the way protobufs
+bool RtcEventLogHelperThread::AppendEventToString(const rtclog::Event& event) {
+  ++num_serialized_events_;
+  if (columnar_format_ && IsBatchedEvent(event)) {
+    AddToBatch(event);
+    if (batch_max_size_bytes_ < kMaxBatchSizeBytes) {
+      return false;
+    }
+    return FlushBatch();
+  }
+  if (FlushBatch()) {
+    return true;
+  }
+  return SerializeEvent(event);
+}
+
+bool RtcEventLogHelperThread::SerializeEvent(const rtclog::Event& event) {
+  // We write an event stream per event but because of the way protobufs
   // are encoded, events can be merged by concatenating them. Therefore,
-  // it will look like a single stream when we read it back from file.
-  bool stop = true;
+  // it will look like a single stream when we read it back from file. An
+  // event stream with one event is the tag and length of its stream field
+  // followed by the event, so we write that directly.
+  const size_t event_size = event.ByteSizeLong();
+  uint8_t prefix[11];
+  prefix[0] = kEventStreamTag;
+  const size_t prefix_size = WriteVarint(event_size, prefix + 1) - prefix;
   if (written_bytes_ + static_cast<int64_t>(output_string_.size()) +
-          event_stream.ByteSize() <=
+          static_cast<int64_t>(prefix_size + event_size) >
       max_size_bytes_) {
-    event_stream.AppendToString(&output_string_);
-    stop = false;
+    return true;
   }
-  // Swap the event back so that we don't mix event types in the queues.
-  event_stream.mutable_stream(0)->Swap(event);
+  const size_t offset = output_string_.size();
+  output_string_.resize(offset + prefix_size + event_size);
+  uint8_t* out = reinterpret_cast<uint8_t*>(&output_string_[offset]);
+  memcpy(out, prefix, prefix_size);
+  // ByteSizeLong() has cached the sizes of the nested messages.
+  event.SerializeWithCachedSizesToArray(out + prefix_size);
+  return false;
+}
+
+void RtcEventLogHelperThread::AddToBatch(const rtclog::Event& event) {
+  rtclog::EventBatch* batch = batch_event_.mutable_event_batch();
+  if (batch->types_size() == 0) {
+    batch_event_.set_timestamp_us(event.timestamp_us());
+    batch_event_.set_type(rtclog::Event::EVENT_BATCH);
+    batch_last_timestamp_us_ = event.timestamp_us();
+  }
+  batch->add_types(event.type());
+  batch->add_timestamp_deltas_us(event.timestamp_us() -
+                                 batch_last_timestamp_us_);
+  batch_last_timestamp_us_ = event.timestamp_us();
+  batch_max_size_bytes_ += kMaxBatchBytesPerEvent;
+
+  switch (event.type()) {
+    case rtclog::Event::RTP_EVENT:
+      AddRtpPacketToBatch(event.rtp_packet(), batch->mutable_rtp_packets());
+      break;
+    case rtclog::Event::RTCP_EVENT: {
+      rtclog::RtcpPacketColumns* columns = batch->mutable_rtcp_packets();
+      columns->add_incoming(event.rtcp_packet().incoming());
+      columns->add_packet_data(event.rtcp_packet().packet_data());
+      batch_max_size_bytes_ += event.rtcp_packet().packet_data().size();
+      break;
+    }
+    case rtclog::Event::AUDIO_PLAYOUT_EVENT: {
+      rtclog::AudioPlayoutColumns* columns = batch->mutable_audio_playouts();
+      const uint32_t ssrc = event.audio_playout_event().local_ssrc();
+      // There are only a few streams, so a linear search is fast.
+      size_t ssrc_index =
+          std::find(batch_playout_ssrcs_.begin(), batch_playout_ssrcs_.end(),
+                    ssrc) -
+          batch_playout_ssrcs_.begin();
+      if (ssrc_index == batch_playout_ssrcs_.size()) {
+        batch_playout_ssrcs_.push_back(ssrc);
+        columns->add_ssrcs(ssrc);
+      }
+      columns->add_ssrc_indices(ssrc_index);
+      break;
+    }
+    case rtclog::Event::LOSS_BASED_BWE_UPDATE: {
+      rtclog::LossBasedBweUpdateColumns* columns =
+          batch->mutable_loss_based_bwe_updates();
+      const rtclog::LossBasedBweUpdate& update = event.loss_based_bwe_update();
+      const uint32_t bitrate_bps = update.bitrate_bps();
+      const uint32_t total_packets = update.total_packets();
+      columns->add_bitrate_deltas_bps(
+          static_cast<int32_t>(bitrate_bps - batch_last_loss_bitrate_bps_));
+      columns->add_fraction_losses(update.fraction_loss());
+      columns->add_total_packets_deltas(
+          static_cast<int32_t>(total_packets - batch_last_total_packets_));
+      batch_last_loss_bitrate_bps_ = bitrate_bps;
+      batch_last_total_packets_ = total_packets;
+      break;
+    }
+    case rtclog::Event::DELAY_BASED_BWE_UPDATE: {
+      rtclog::DelayBasedBweUpdateColumns* columns =
+          batch->mutable_delay_based_bwe_updates();
+      const rtclog::DelayBasedBweUpdate& update =
+          event.delay_based_bwe_update();
+      const uint32_t bitrate_bps = update.bitrate_bps();
+      columns->add_bitrate_deltas_bps(
+          static_cast<int32_t>(bitrate_bps - batch_last_delay_bitrate_bps_));
+      columns->add_detector_states(update.detector_state());
+      batch_last_delay_bitrate_bps_ = bitrate_bps;
+      break;
+    }
+    default:
+      RTC_NOTREACHED();
+  }
+}
+
+void RtcEventLogHelperThread::AddRtpPacketToBatch(
+    const rtclog::RtpPacket& rtp_packet,
+    rtclog::RtpPacketColumns* columns) {
+  const ProtoString& header = rtp_packet.header();
+  RTC_DCHECK_GE(header.size(), kFixedRtpHeaderSize);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(header.data());
+  const uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(data + 8);
+
+  // There are only a few streams, so a linear search is fast.
+  size_t stream_index = 0;
+  while (stream_index < batch_rtp_streams_.size() &&
+         (batch_rtp_streams_[stream_index].ssrc != ssrc ||
+          batch_rtp_streams_[stream_index].incoming != rtp_packet.incoming())) {
+    ++stream_index;
+  }
+  if (stream_index == batch_rtp_streams_.size()) {
+    batch_rtp_streams_.push_back({ssrc, rtp_packet.incoming(), 0, 0, 0});
+    columns->add_stream_ssrcs(ssrc);
+    columns->add_stream_incoming(rtp_packet.incoming());
+  }
+  RtpBatchStream* stream = &batch_rtp_streams_[stream_index];
+
+  const uint16_t first_bytes = ByteReader<uint16_t>::ReadBigEndian(data);
+  const uint16_t sequence_number =
+      ByteReader<uint16_t>::ReadBigEndian(data + 2);
+  const uint32_t rtp_timestamp = ByteReader<uint32_t>::ReadBigEndian(data + 4);
+  columns->add_stream_indices(stream_index);
+  columns->add_packet_lengths(rtp_packet.packet_length());
+  columns->add_first_bytes_xors(first_bytes ^ stream->first_bytes);
+  columns->add_sequence_number_deltas(
+      static_cast<int16_t>(sequence_number - stream->sequence_number));
+  columns->add_rtp_timestamp_deltas(
+      static_cast<int32_t>(rtp_timestamp - stream->rtp_timestamp));
+  columns->add_header_tails(header.data() + kFixedRtpHeaderSize,
+                            header.size() - kFixedRtpHeaderSize);
+  columns->add_probe_cluster_ids(
+      rtp_packet.has_probe_cluster_id() ? rtp_packet.probe_cluster_id() + 1
+                                        : 0);
+
+  stream->first_bytes = first_bytes;
+  stream->sequence_number = sequence_number;
+  stream->rtp_timestamp = rtp_timestamp;
+  batch_max_size_bytes_ += header.size();
+}
+
+bool RtcEventLogHelperThread::FlushBatch() {
+  if (batch_max_size_bytes_ == 0) {
+    return false;
+  }
+  bool stop = SerializeEvent(batch_event_);
+  // Clearing the batch, rather than the event, keeps its buffers for the next
+  // batch.
+  batch_event_.mutable_event_batch()->Clear();
+  batch_rtp_streams_.clear();
+  batch_playout_ssrcs_.clear();
+  batch_last_loss_bitrate_bps_ = 0;
+  batch_last_total_packets_ = 0;
+  batch_last_delay_bitrate_bps_ = 0;
+  batch_max_size_bytes_ = 0;
   return stop;
 }
 
+void RtcEventLogHelperThread::ReleaseEvent(
+    std::unique_ptr<rtclog::Event> event) {
+  if (event->type() == rtclog::Event::RTP_EVENT) {
+    rtp_event_pool_->Put(std::move(event));
+  }
+}
+
 bool RtcEventLogHelperThread::LogToMemory() {
   RTC_DCHECK(!file_->is_open());
   bool message_received = false;
@@ -116,8 +348,10 @@ bool RtcEventLogHelperThread::LogToMemory() {
       config_history_.push_back(std::move(most_recent_event_));
     } else {
       history_.push_back(std::move(most_recent_event_));
-      if (history_.size() > kEventsInHistory)
+      if (history_.size() > kEventsInHistory) {
+        ReleaseEvent(std::move(history_.front()));
         history_.pop_front();
+      }
     }
     has_recent_event_ = event_queue_->Remove(&most_recent_event_);
     message_received = true;
@@ -129,25 +363,29 @@ void RtcEventLogHelperThread::StartLogFile() {
   RTC_DCHECK(file_->is_open());
   bool stop = false;
   output_string_.clear();
+  int64_t start_ns = rtc::TimeNanos();
 
   // Create and serialize the LOG_START event.
   rtclog::Event start_event;
   start_event.set_timestamp_us(start_time_);
   start_event.set_type(rtclog::Event::LOG_START);
-  AppendEventToString(&start_event);
+  AppendEventToString(start_event);
 
   // Serialize the config information for all old streams.
   for (auto& event : config_history_) {
-    AppendEventToString(event.get());
+    AppendEventToString(*event);
   }
 
   // Serialize the events in the event queue.
   while (!history_.empty() && !stop) {
-    stop = AppendEventToString(history_.front().get());
+    stop = AppendEventToString(*history_.front());
     if (!stop) {
+      ReleaseEvent(std::move(history_.front()));
       history_.pop_front();
     }
   }
+  stop |= FlushBatch();
+  serialization_time_ns_ += rtc::TimeNanos() - start_ns;
 
   // Write to file.
   if (!file_->Write(output_string_.data(), output_string_.size())) {
@@ -173,6 +411,7 @@ bool RtcEventLogHelperThread::LogToFile() {
   RTC_DCHECK(file_->is_open());
   output_string_.clear();
   bool message_received = false;
+  int64_t start_ns = rtc::TimeNanos();
 
   // Append each event older than both the current time and the stop time
   // to the output_string_.
@@ -184,15 +423,19 @@ bool RtcEventLogHelperThread::LogToFile() {
   bool stop = false;
   while (!stop && has_recent_event_ &&
          most_recent_event_->timestamp_us() <= time_limit) {
-    stop = AppendEventToString(most_recent_event_.get());
+    stop = AppendEventToString(*most_recent_event_);
     if (!stop) {
       if (IsConfigEvent(*most_recent_event_)) {
         config_history_.push_back(std::move(most_recent_event_));
+      } else {
+        ReleaseEvent(std::move(most_recent_event_));
       }
       has_recent_event_ = event_queue_->Remove(&most_recent_event_);
     }
     message_received = true;
   }
+  stop |= FlushBatch();
+  serialization_time_ns_ += rtc::TimeNanos() - start_ns;
 
   // Write string to file.
   if (!file_->Write(output_string_.data(), output_string_.size())) {
@@ -226,7 +469,7 @@ void RtcEventLogHelperThread::StopLogFile() {
   end_event.set_timestamp_us(
       std::min(stop_time_, rtc::TimeMicros()));
   end_event.set_type(rtclog::Event::LOG_END);
-  AppendEventToString(&end_event);
+  AppendEventToString(end_event);
 
   if (written_bytes_ + static_cast<int64_t>(output_string_.size()) <=
       max_size_bytes_) {
@@ -238,10 +481,27 @@ void RtcEventLogHelperThread::StopLogFile() {
     written_bytes_ += output_string_.size();
   }
 
+  // The cost on the output thread, and in the file, of an average event.
+  RTC_HISTOGRAM_COUNTS_100000(
+      "WebRTC.RtcEventLog.SerializationTimePerEventInNs",
+      static_cast<int>(serialization_time_ns_ / num_serialized_events_));
+  const int bytes_per_event =
+      static_cast<int>(written_bytes_ / num_serialized_events_);
+  if (columnar_format_) {
+    RTC_HISTOGRAM_COUNTS_1000("WebRTC.RtcEventLog.Columnar.BytesPerEvent",
+                              bytes_per_event);
+  } else {
+    RTC_HISTOGRAM_COUNTS_1000("WebRTC.RtcEventLog.BytesPerEvent",
+                              bytes_per_event);
+  }
+
   max_size_bytes_ = std::numeric_limits<int64_t>::max();
   written_bytes_ = 0;
   start_time_ = 0;
   stop_time_ = std::numeric_limits<int64_t>::max();
+  columnar_format_ = false;
+  num_serialized_events_ = 0;
+  serialization_time_ns_ = 0;
   output_string_.clear();
   file_->CloseFile();
   RTC_DCHECK(!file_->is_open());
@@ -260,6 +520,7 @@ void RtcEventLogHelperThread::ProcessEvents() {
             max_size_bytes_ = message.max_size_bytes;
             start_time_ = message.start_time;
             stop_time_ = message.stop_time;
+            columnar_format_ = message.columnar_format;
             file_.swap(message.file);
             StartLogFile();
           } else {
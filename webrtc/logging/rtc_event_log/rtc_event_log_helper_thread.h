@@ -18,11 +18,13 @@
 #include <vector>
 
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/ignore_wundef.h"
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/protobuf_utils.h"
 #include "webrtc/rtc_base/swap_queue.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
 
 #ifdef ENABLE_RTC_EVENT_LOG
@@ -40,6 +42,29 @@ RTC_POP_IGNORING_WUNDEF()
 
 namespace webrtc {
 
+// Keeps the RTP events that the output thread is done with, so that logging
+// an RTP header can reuse one, with its packet and header buffer, instead of
+// allocating them for every packet. Thread-safe.
+class RtpEventPool final {
+ public:
+  explicit RtpEventPool(size_t max_size);
+  ~RtpEventPool();
+
+  // Returns a recycled RTP event, or a new event if there are none. The
+  // caller must set the timestamp, the type and all the fields of the
+  // rtp_packet except probe_cluster_id, which is cleared.
+  std::unique_ptr<rtclog::Event> Get();
+  // Recycles an RTP event; other events must be freed instead.
+  void Put(std::unique_ptr<rtclog::Event> event);
+
+ private:
+  const size_t max_size_;
+  rtc::CriticalSection crit_;
+  std::vector<std::unique_ptr<rtclog::Event>> events_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpEventPool);
+};
+
 class RtcEventLogHelperThread final {
  public:
   struct ControlMessage {
@@ -48,13 +73,15 @@ class RtcEventLogHelperThread final {
           file(nullptr),
           max_size_bytes(0),
           start_time(0),
-          stop_time(0) {}
+          stop_time(0),
+          columnar_format(false) {}
     enum { START_FILE, STOP_FILE, TERMINATE_THREAD } message_type;
 
     std::unique_ptr<FileWrapper> file;  // Only used with START_FILE.
     int64_t max_size_bytes;             // Only used with START_FILE.
     int64_t start_time;                 // Only used with START_FILE.
     int64_t stop_time;                  // Used with all 3 message types.
+    bool columnar_format;               // Only used with START_FILE.
 
     friend void swap(ControlMessage& lhs, ControlMessage& rhs) {
       using std::swap;
@@ -63,12 +90,14 @@ class RtcEventLogHelperThread final {
       swap(lhs.max_size_bytes, rhs.max_size_bytes);
       swap(lhs.start_time, rhs.start_time);
       swap(lhs.stop_time, rhs.stop_time);
+      swap(lhs.columnar_format, rhs.columnar_format);
     }
   };
 
   RtcEventLogHelperThread(
       SwapQueue<ControlMessage>* message_queue,
-      SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue);
+      SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue,
+      RtpEventPool* rtp_event_pool);
   ~RtcEventLogHelperThread();
 
   // This function MUST be called once a STOP_FILE message is added to the
@@ -81,9 +110,30 @@ class RtcEventLogHelperThread final {
   void SignalNewEvent();
 
  private:
+  // The state of an RTP stream while its packets are added to an EVENT_BATCH.
+  struct RtpBatchStream {
+    uint32_t ssrc;
+    bool incoming;
+    uint16_t first_bytes;
+    uint16_t sequence_number;
+    uint32_t rtp_timestamp;
+  };
+
   static void ThreadOutputFunction(void* obj);
 
-  bool AppendEventToString(rtclog::Event* event);
+  // Appends |event| to |output_string_|, or to |batch_event_| if the log is in
+  // the columnar format and the event can be batched. Returns true, and drops
+  // the event, if it would make the log larger than |max_size_bytes_|.
+  bool AppendEventToString(const rtclog::Event& event);
+  bool SerializeEvent(const rtclog::Event& event);
+  void AddToBatch(const rtclog::Event& event);
+  void AddRtpPacketToBatch(const rtclog::RtpPacket& rtp_packet,
+                           rtclog::RtpPacketColumns* columns);
+  // Appends |batch_event_| to |output_string_|, if it has any events, and
+  // empties it. Returns true if it didn't fit in the log.
+  bool FlushBatch();
+  // Frees |event|, or recycles it if it is an RTP event.
+  void ReleaseEvent(std::unique_ptr<rtclog::Event> event);
   bool LogToMemory();
   void StartLogFile();
   bool LogToFile();
@@ -93,6 +143,7 @@ class RtcEventLogHelperThread final {
   // Message queues for passing events to the logging thread.
   SwapQueue<ControlMessage>* message_queue_;
   SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue_;
+  RtpEventPool* rtp_event_pool_;
 
   // History containing the most recent events (~ 10 s).
   std::deque<std::unique_ptr<rtclog::Event>> history_;
@@ -108,12 +159,30 @@ class RtcEventLogHelperThread final {
   int64_t start_time_;
   int64_t stop_time_;
 
+  bool columnar_format_;
+
   bool has_recent_event_;
   std::unique_ptr<rtclog::Event> most_recent_event_;
 
   // Temporary space for serializing profobuf data.
   ProtoString output_string_;
 
+  // The events that haven't been appended to |output_string_| yet, when
+  // logging in the columnar format, and what the next events of each type
+  // are delta encoded against.
+  rtclog::Event batch_event_;
+  std::vector<RtpBatchStream> batch_rtp_streams_;
+  std::vector<uint32_t> batch_playout_ssrcs_;
+  int64_t batch_last_timestamp_us_;
+  uint32_t batch_last_loss_bitrate_bps_;
+  uint32_t batch_last_total_packets_;
+  uint32_t batch_last_delay_bitrate_bps_;
+  size_t batch_max_size_bytes_;
+
+  // For the metrics of the current log file.
+  int64_t num_serialized_events_;
+  int64_t serialization_time_ns_;
+
   rtc::Event wake_periodically_;
   rtc::Event wake_from_hibernation_;
   rtc::Event file_finished_;
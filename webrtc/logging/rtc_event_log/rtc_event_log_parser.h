@@ -18,6 +18,7 @@
 #include "webrtc/call/video_receive_stream.h"
 #include "webrtc/call/video_send_stream.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_reader.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/rtc_base/ignore_wundef.h"
@@ -54,6 +55,11 @@ class ParsedRtcEventLog {
     rtc::Optional<ProbeFailureReason> failure_reason;
   };
 
+  struct AlrStateEvent {
+    uint64_t timestamp;
+    bool in_alr;
+  };
+
   struct BweDelayBasedUpdate {
     uint64_t timestamp;
     int32_t bitrate_bps;
@@ -75,7 +81,8 @@ class ParsedRtcEventLog {
     AUDIO_SENDER_CONFIG_EVENT = 11,
     AUDIO_NETWORK_ADAPTATION_EVENT = 16,
     BWE_PROBE_CLUSTER_CREATED_EVENT = 17,
-    BWE_PROBE_RESULT_EVENT = 18
+    BWE_PROBE_RESULT_EVENT = 18,
+    ALR_STATE_EVENT = 20
   };
 
   enum class MediaType { ANY, AUDIO, VIDEO, DATA };
@@ -89,6 +96,14 @@ class ParsedRtcEventLog {
   // Reads an RtcEventLog from an istream and returns true if successful.
   bool ParseStream(std::istream& stream);
 
+  // Reads at most |max_events| events from |reader|, in place of the events
+  // read before, and returns how many it read. The stream configurations are
+  // kept from one call to the next, so a log can be processed a chunk of
+  // events at a time, e.g. to analyze a log too large to keep in memory.
+  // Fewer events than |max_events| are read at the end of the log, or if
+  // reader->failed().
+  size_t ParseEvents(RtcEventLogReader* reader, size_t max_events);
+
   // Returns the number of events in an EventStream.
   size_t GetNumberOfEvents() const;
 
@@ -172,6 +187,8 @@ class ParsedRtcEventLog {
 
   BweProbeResultEvent GetBweProbeResult(size_t index) const;
 
+  AlrStateEvent GetAlrState(size_t index) const;
+
   MediaType GetMediaType(uint32_t ssrc, PacketDirection direction) const;
 
  private:
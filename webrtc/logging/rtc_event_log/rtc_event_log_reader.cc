@@ -0,0 +1,311 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/logging/rtc_event_log/rtc_event_log_reader.h"
+
+#include <stdint.h>
+
+#include <tuple>
+#include <utility>
+
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/protobuf_utils.h"
+
+namespace webrtc {
+
+namespace {
+const size_t kMaxEventSize = (1u << 16) - 1;
+const size_t kFixedRtpHeaderSize = 12;
+
+std::pair<uint64_t, bool> ParseVarInt(std::istream& stream) {
+  uint64_t varint = 0;
+  for (size_t bytes_read = 0; bytes_read < 10; ++bytes_read) {
+    // The most significant bit of each byte is 0 if it is the last byte in
+    // the varint and 1 otherwise. Thus, we take the 7 least significant bits
+    // of each byte and shift them 7 bits for each byte read previously to get
+    // the (unsigned) integer.
+    int byte = stream.get();
+    if (stream.eof()) {
+      return std::make_pair(varint, false);
+    }
+    RTC_DCHECK_GE(byte, 0);
+    RTC_DCHECK_LE(byte, 255);
+    varint |= static_cast<uint64_t>(byte & 0x7F) << (7 * bytes_read);
+    if ((byte & 0x80) == 0) {
+      return std::make_pair(varint, true);
+    }
+  }
+  return std::make_pair(varint, false);
+}
+
+bool HasConsistentSizes(const rtclog::RtpPacketColumns& columns) {
+  const int num_packets = columns.stream_indices_size();
+  return columns.stream_incoming_size() == columns.stream_ssrcs_size() &&
+         columns.packet_lengths_size() == num_packets &&
+         columns.first_bytes_xors_size() == num_packets &&
+         columns.sequence_number_deltas_size() == num_packets &&
+         columns.rtp_timestamp_deltas_size() == num_packets &&
+         columns.header_tails_size() == num_packets &&
+         columns.probe_cluster_ids_size() == num_packets;
+}
+
+bool HasConsistentSizes(const rtclog::LossBasedBweUpdateColumns& columns) {
+  const int num_updates = columns.bitrate_deltas_bps_size();
+  return columns.fraction_losses_size() == num_updates &&
+         columns.total_packets_deltas_size() == num_updates;
+}
+
+// The header fields of the previous packet of an RTP stream in a batch.
+struct RtpStream {
+  uint16_t first_bytes = 0;
+  uint16_t sequence_number = 0;
+  uint32_t rtp_timestamp = 0;
+};
+
+// Decodes the packet at |index| of |columns| into |rtp_packet|.
+bool DecodeRtpPacket(const rtclog::RtpPacketColumns& columns,
+                     int index,
+                     std::vector<RtpStream>* streams,
+                     rtclog::RtpPacket* rtp_packet) {
+  const uint32_t stream_index = columns.stream_indices(index);
+  if (stream_index >= streams->size() ||
+      kFixedRtpHeaderSize + columns.header_tails(index).size() >
+          static_cast<size_t>(IP_PACKET_SIZE)) {
+    return false;
+  }
+  RtpStream& stream = (*streams)[stream_index];
+  stream.first_bytes ^= static_cast<uint16_t>(columns.first_bytes_xors(index));
+  stream.sequence_number += columns.sequence_number_deltas(index);
+  stream.rtp_timestamp += columns.rtp_timestamp_deltas(index);
+
+  uint8_t header[kFixedRtpHeaderSize];
+  ByteWriter<uint16_t>::WriteBigEndian(header, stream.first_bytes);
+  ByteWriter<uint16_t>::WriteBigEndian(header + 2, stream.sequence_number);
+  ByteWriter<uint32_t>::WriteBigEndian(header + 4, stream.rtp_timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(header + 8,
+                                       columns.stream_ssrcs(stream_index));
+
+  rtp_packet->set_incoming(columns.stream_incoming(stream_index));
+  rtp_packet->set_packet_length(columns.packet_lengths(index));
+  ProtoString* rtp_header = rtp_packet->mutable_header();
+  rtp_header->assign(reinterpret_cast<const char*>(header),
+                     kFixedRtpHeaderSize);
+  rtp_header->append(columns.header_tails(index));
+  if (columns.probe_cluster_ids(index) != 0) {
+    rtp_packet->set_probe_cluster_id(columns.probe_cluster_ids(index) - 1);
+  }
+  return true;
+}
+}  // namespace
+
+RtcEventLogReader::RtcEventLogReader(std::istream* stream)
+    : stream_(stream),
+      buffer_(kMaxEventSize),
+      next_batch_event_(0),
+      failed_(false) {
+  RTC_DCHECK(stream_);
+}
+
+RtcEventLogReader::~RtcEventLogReader() = default;
+
+bool RtcEventLogReader::ReadEvent(rtclog::Event* event) {
+  while (next_batch_event_ == batch_events_.size()) {
+    if (failed_ || !ReadMessage(event)) {
+      return false;
+    }
+    if (event->type() != rtclog::Event::EVENT_BATCH) {
+      return true;
+    }
+    if (!ExpandBatch(*event)) {
+      LOG(LS_WARNING) << "Failed to parse batch of events.";
+      batch_events_.clear();
+      next_batch_event_ = 0;
+      failed_ = true;
+      return false;
+    }
+  }
+  event->Swap(&batch_events_[next_batch_event_++]);
+  return true;
+}
+
+bool RtcEventLogReader::ReadMessage(rtclog::Event* event) {
+  // Check whether we have reached end of file.
+  stream_->peek();
+  if (stream_->eof()) {
+    return false;
+  }
+
+  // Read the next message tag. The tag number is defined as
+  // (fieldnumber << 3) | wire_type. In our case, the field number is
+  // supposed to be 1 and the wire type for an
+  // length-delimited field is 2.
+  const uint64_t kExpectedTag = (1 << 3) | 2;
+  uint64_t tag;
+  bool success;
+  std::tie(tag, success) = ParseVarInt(*stream_);
+  if (!success) {
+    LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
+    failed_ = true;
+    return false;
+  } else if (tag != kExpectedTag) {
+    LOG(LS_WARNING) << "Unexpected field tag at beginning of protobuf event.";
+    failed_ = true;
+    return false;
+  }
+
+  // Read the length field.
+  uint64_t message_length;
+  std::tie(message_length, success) = ParseVarInt(*stream_);
+  if (!success) {
+    LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
+    failed_ = true;
+    return false;
+  } else if (message_length > kMaxEventSize) {
+    LOG(LS_WARNING) << "Protobuf message length is too large.";
+    failed_ = true;
+    return false;
+  }
+
+  // Read the next protobuf event to a temporary char buffer.
+  stream_->read(buffer_.data(), message_length);
+  if (stream_->gcount() != static_cast<int>(message_length)) {
+    LOG(LS_WARNING) << "Failed to read protobuf message from file.";
+    failed_ = true;
+    return false;
+  }
+
+  // Parse the protobuf event from the buffer.
+  if (!event->ParseFromArray(buffer_.data(), message_length)) {
+    LOG(LS_WARNING) << "Failed to parse protobuf message.";
+    failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool RtcEventLogReader::ExpandBatch(const rtclog::Event& event) {
+  if (!event.has_timestamp_us() || !event.has_event_batch()) {
+    return false;
+  }
+  const rtclog::EventBatch& batch = event.event_batch();
+  const rtclog::RtpPacketColumns& rtp_packets = batch.rtp_packets();
+  const rtclog::RtcpPacketColumns& rtcp_packets = batch.rtcp_packets();
+  const rtclog::AudioPlayoutColumns& audio_playouts = batch.audio_playouts();
+  const rtclog::LossBasedBweUpdateColumns& loss_based_bwe_updates =
+      batch.loss_based_bwe_updates();
+  const rtclog::DelayBasedBweUpdateColumns& delay_based_bwe_updates =
+      batch.delay_based_bwe_updates();
+  const int num_events = batch.types_size();
+  if (batch.timestamp_deltas_us_size() != num_events ||
+      !HasConsistentSizes(rtp_packets) ||
+      rtcp_packets.packet_data_size() != rtcp_packets.incoming_size() ||
+      !HasConsistentSizes(loss_based_bwe_updates) ||
+      delay_based_bwe_updates.detector_states_size() !=
+          delay_based_bwe_updates.bitrate_deltas_bps_size()) {
+    return false;
+  }
+
+  std::vector<RtpStream> rtp_streams(rtp_packets.stream_ssrcs_size());
+  int rtp_index = 0;
+  int rtcp_index = 0;
+  int playout_index = 0;
+  int loss_index = 0;
+  int delay_index = 0;
+  uint32_t loss_bitrate_bps = 0;
+  uint32_t total_packets = 0;
+  uint32_t delay_bitrate_bps = 0;
+  int64_t timestamp_us = event.timestamp_us();
+  // Resizing, rather than clearing, reuses the events of the last batch.
+  batch_events_.resize(num_events);
+  next_batch_event_ = 0;
+  for (int i = 0; i < num_events; ++i) {
+    timestamp_us += batch.timestamp_deltas_us(i);
+    rtclog::Event* batch_event = &batch_events_[i];
+    batch_event->Clear();
+    batch_event->set_timestamp_us(timestamp_us);
+    batch_event->set_type(batch.types(i));
+    switch (batch.types(i)) {
+      case rtclog::Event::RTP_EVENT:
+        if (rtp_index == rtp_packets.stream_indices_size() ||
+            !DecodeRtpPacket(rtp_packets, rtp_index++, &rtp_streams,
+                             batch_event->mutable_rtp_packet())) {
+          return false;
+        }
+        break;
+      case rtclog::Event::RTCP_EVENT: {
+        if (rtcp_index == rtcp_packets.incoming_size()) {
+          return false;
+        }
+        rtclog::RtcpPacket* rtcp_packet = batch_event->mutable_rtcp_packet();
+        rtcp_packet->set_incoming(rtcp_packets.incoming(rtcp_index));
+        rtcp_packet->set_packet_data(rtcp_packets.packet_data(rtcp_index));
+        ++rtcp_index;
+        break;
+      }
+      case rtclog::Event::AUDIO_PLAYOUT_EVENT: {
+        if (playout_index == audio_playouts.ssrc_indices_size()) {
+          return false;
+        }
+        const uint32_t ssrc_index = audio_playouts.ssrc_indices(playout_index);
+        if (ssrc_index >=
+            static_cast<uint32_t>(audio_playouts.ssrcs_size())) {
+          return false;
+        }
+        batch_event->mutable_audio_playout_event()->set_local_ssrc(
+            audio_playouts.ssrcs(ssrc_index));
+        ++playout_index;
+        break;
+      }
+      case rtclog::Event::LOSS_BASED_BWE_UPDATE: {
+        if (loss_index == loss_based_bwe_updates.bitrate_deltas_bps_size()) {
+          return false;
+        }
+        loss_bitrate_bps +=
+            loss_based_bwe_updates.bitrate_deltas_bps(loss_index);
+        total_packets +=
+            loss_based_bwe_updates.total_packets_deltas(loss_index);
+        rtclog::LossBasedBweUpdate* update =
+            batch_event->mutable_loss_based_bwe_update();
+        update->set_bitrate_bps(static_cast<int32_t>(loss_bitrate_bps));
+        update->set_fraction_loss(
+            loss_based_bwe_updates.fraction_losses(loss_index));
+        update->set_total_packets(static_cast<int32_t>(total_packets));
+        ++loss_index;
+        break;
+      }
+      case rtclog::Event::DELAY_BASED_BWE_UPDATE: {
+        if (delay_index == delay_based_bwe_updates.bitrate_deltas_bps_size()) {
+          return false;
+        }
+        delay_bitrate_bps +=
+            delay_based_bwe_updates.bitrate_deltas_bps(delay_index);
+        rtclog::DelayBasedBweUpdate* update =
+            batch_event->mutable_delay_based_bwe_update();
+        update->set_bitrate_bps(static_cast<int32_t>(delay_bitrate_bps));
+        update->set_detector_state(
+            delay_based_bwe_updates.detector_states(delay_index));
+        ++delay_index;
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return rtp_index == rtp_packets.stream_indices_size() &&
+         rtcp_index == rtcp_packets.incoming_size() &&
+         playout_index == audio_playouts.ssrc_indices_size() &&
+         loss_index == loss_based_bwe_updates.bitrate_deltas_bps_size() &&
+         delay_index == delay_based_bwe_updates.bitrate_deltas_bps_size();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_READER_H_
+#define WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_READER_H_
+
+#include <istream>
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/ignore_wundef.h"
+
+// Files generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
+#else
+#include "webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+// Reads the events of an RtcEventLog one at a time, so that a log of any size
+// can be processed in bounded memory. The batches of the columnar format are
+// expanded, i.e. their events are read as if they had been logged one by one.
+class RtcEventLogReader {
+ public:
+  // |stream| must outlive the reader.
+  explicit RtcEventLogReader(std::istream* stream);
+  ~RtcEventLogReader();
+
+  // Reads the next event into |event|. Returns false at the end of the log,
+  // or if the rest of it can't be parsed, in which case failed() is true.
+  bool ReadEvent(rtclog::Event* event);
+
+  bool failed() const { return failed_; }
+
+ private:
+  // Reads the next message of the EventStream into |event|.
+  bool ReadMessage(rtclog::Event* event);
+  // Decodes the events of an EVENT_BATCH into |batch_events_|. Returns false
+  // if the batch is malformed.
+  bool ExpandBatch(const rtclog::Event& event);
+
+  std::istream* const stream_;
+  std::vector<char> buffer_;
+  // The events of the last batch, of which those from |next_batch_event_| on
+  // haven't been read yet.
+  std::vector<rtclog::Event> batch_events_;
+  size_t next_batch_event_;
+  bool failed_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtcEventLogReader);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_READER_H_
@@ -8,8 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -17,6 +23,7 @@
 #include "webrtc/call/call.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_reader.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log_unittest_helper.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/bwe_defines.h"
@@ -25,10 +32,12 @@
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/rtc_base/arraysize.h"
 #include "webrtc/rtc_base/buffer.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/fakeclock.h"
 #include "webrtc/rtc_base/random.h"
+#include "webrtc/system_wrappers/include/metrics_default.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -239,7 +248,8 @@ void LogSessionAndReadBack(size_t rtp_count,
                            size_t bwe_loss_count,
                            uint32_t extensions_bitvector,
                            uint32_t csrcs_count,
-                           unsigned int random_seed) {
+                           unsigned int random_seed,
+                           bool columnar_format) {
   ASSERT_LE(rtcp_count, rtp_count);
   ASSERT_LE(playout_count, rtp_count);
   ASSERT_LE(bwe_loss_count, rtp_count);
@@ -296,6 +306,7 @@ void LogSessionAndReadBack(size_t rtp_count,
     rtc::ScopedFakeClock fake_clock;
     fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
     std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create());
+    log_dumper->SetColumnarFormat(columnar_format);
     log_dumper->LogVideoReceiveStreamConfig(receiver_config);
     fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
     log_dumper->LogVideoSendStreamConfig(sender_config);
@@ -400,7 +411,7 @@ void LogSessionAndReadBack(size_t rtp_count,
 TEST(RtcEventLogTest, LogSessionAndReadBack) {
   // Log 5 RTP, 2 RTCP, 0 playout events and 0 BWE events
   // with no header extensions or CSRCS.
-  LogSessionAndReadBack(5, 2, 0, 0, 0, 0, 321);
+  LogSessionAndReadBack(5, 2, 0, 0, 0, 0, 321, false);
 
   // Enable AbsSendTime and TransportSequenceNumbers.
   uint32_t extensions = 0;
@@ -411,10 +422,10 @@ TEST(RtcEventLogTest, LogSessionAndReadBack) {
       extensions |= 1u << i;
     }
   }
-  LogSessionAndReadBack(8, 2, 0, 0, extensions, 0, 3141592653u);
+  LogSessionAndReadBack(8, 2, 0, 0, extensions, 0, 3141592653u, false);
 
   extensions = (1u << kNumExtensions) - 1;  // Enable all header extensions.
-  LogSessionAndReadBack(9, 2, 3, 2, extensions, 2, 2718281828u);
+  LogSessionAndReadBack(9, 2, 3, 2, extensions, 2, 2718281828u, false);
 
   // Try all combinations of header extensions and up to 2 CSRCS.
   for (extensions = 0; extensions < (1u << kNumExtensions); extensions++) {
@@ -425,9 +436,217 @@ TEST(RtcEventLogTest, LogSessionAndReadBack) {
                             1 + csrcs_count,  // Number of BWE loss events.
                             extensions,       // Bit vector choosing extensions.
                             csrcs_count,      // Number of contributing sources.
-                            extensions * 3 + csrcs_count + 1);  // Random seed.
+                            extensions * 3 + csrcs_count + 1,  // Seed.
+                            false);  // Columnar format.
+    }
+  }
+}
+
+TEST(RtcEventLogTest, LogSessionInColumnarFormatAndReadBack) {
+  LogSessionAndReadBack(5, 2, 0, 0, 0, 0, 321, true);
+  uint32_t extensions = (1u << kNumExtensions) - 1;
+  LogSessionAndReadBack(9, 2, 3, 2, extensions, 2, 2718281828u, true);
+  // Long runs of RTP packets, with only a few other events.
+  LogSessionAndReadBack(200, 1, 1, 1, extensions, 1, 1618033988u, true);
+  LogSessionAndReadBack(200, 0, 0, 0, 0, 0, 1414213562u, true);
+}
+
+TEST(RtcEventLogTest, ColumnarFormatIsSmaller) {
+  metrics::Reset();
+  Random prng(271828);
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<AbsoluteSendTime>(1);
+  extensions.Register<TransportSequenceNumber>(2);
+
+  // The packets of one stream, as they would be sent.
+  const size_t kNumPackets = 500;
+  std::vector<RtpPacketToSend> rtp_packets;
+  RtpPacketToSend first_packet =
+      GenerateRtpPacket(&extensions, 0, prng.Rand(1000, 1100), &prng);
+  for (size_t i = 0; i < kNumPackets; i++) {
+    RtpPacketToSend rtp_packet = first_packet;
+    rtp_packet.SetSequenceNumber(first_packet.SequenceNumber() + i);
+    rtp_packet.SetTimestamp(first_packet.Timestamp() + 3000 * (i / 3));
+    rtp_packet.SetMarker(i % 3 == 2);
+    rtp_packet.SetExtension<TransportSequenceNumber>(i);
+    rtp_packets.push_back(rtp_packet);
+  }
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  size_t file_sizes[2];
+  for (bool columnar_format : {false, true}) {
+    const std::string temp_filename = test::OutputPath() +
+                                      test_info->test_case_name() +
+                                      test_info->name();
+    rtc::ScopedFakeClock fake_clock;
+    fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+    std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create());
+    log_dumper->SetColumnarFormat(columnar_format);
+    log_dumper->StartLogging(temp_filename, 10000000);
+    for (const RtpPacketToSend& rtp_packet : rtp_packets) {
+      log_dumper->LogRtpHeader(kOutgoingPacket, rtp_packet.data(),
+                               rtp_packet.size());
+      fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+    }
+    log_dumper->StopLogging();
+
+    ParsedRtcEventLog parsed_log;
+    ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+    ASSERT_EQ(kNumPackets + 2, parsed_log.GetNumberOfEvents());
+    RtcEventLogTestHelper::VerifyLogStartEvent(parsed_log, 0);
+    for (size_t i = 0; i < kNumPackets; i++) {
+      RtcEventLogTestHelper::VerifyRtpEvent(
+          parsed_log, i + 1, kOutgoingPacket, rtp_packets[i].data(),
+          rtp_packets[i].headers_size(), rtp_packets[i].size());
+    }
+    RtcEventLogTestHelper::VerifyLogEndEvent(parsed_log, kNumPackets + 1);
+
+    file_sizes[columnar_format] = test::GetFileSize(temp_filename);
+    remove(temp_filename.c_str());
+  }
+  EXPECT_LT(file_sizes[1], file_sizes[0] * 3 / 4);
+
+  EXPECT_EQ(2, metrics::NumSamples(
+                   "WebRTC.RtcEventLog.SerializationTimePerEventInNs"));
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.RtcEventLog.BytesPerEvent"));
+  EXPECT_EQ(1,
+            metrics::NumSamples("WebRTC.RtcEventLog.Columnar.BytesPerEvent"));
+}
+
+TEST(RtcEventLogTest, LogBweUpdatesInColumnarFormatAndReadBack) {
+  // The bitrates are delta encoded, so include the extremes.
+  const int32_t kBitrates[] = {0, 300000, std::numeric_limits<int32_t>::max(),
+                               std::numeric_limits<int32_t>::min(), 299000};
+  const BandwidthUsage kDetectorStates[] = {
+      BandwidthUsage::kBwNormal, BandwidthUsage::kBwOverusing,
+      BandwidthUsage::kBwUnderusing, BandwidthUsage::kBwNormal,
+      BandwidthUsage::kBwOverusing};
+  const size_t kNumUpdates = arraysize(kBitrates);
+  Random prng(31415);
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  rtc::ScopedFakeClock fake_clock;
+  fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+  std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create());
+  log_dumper->SetColumnarFormat(true);
+  log_dumper->StartLogging(temp_filename, 10000000);
+  for (size_t i = 0; i < kNumUpdates; i++) {
+    fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+    log_dumper->LogDelayBasedBweUpdate(kBitrates[i], kDetectorStates[i]);
+    fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+    log_dumper->LogLossBasedBweUpdate(kBitrates[kNumUpdates - 1 - i],
+                                      static_cast<uint8_t>(i * 50), 100 - i);
+  }
+  fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+  log_dumper->StopLogging();
+
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+  ASSERT_EQ(2 * kNumUpdates + 2, parsed_log.GetNumberOfEvents());
+  RtcEventLogTestHelper::VerifyLogStartEvent(parsed_log, 0);
+  for (size_t i = 0; i < kNumUpdates; i++) {
+    RtcEventLogTestHelper::VerifyBweDelayEvent(
+        parsed_log, 2 * i + 1, kBitrates[i], kDetectorStates[i]);
+    RtcEventLogTestHelper::VerifyBweLossEvent(
+        parsed_log, 2 * i + 2, kBitrates[kNumUpdates - 1 - i],
+        static_cast<uint8_t>(i * 50), 100 - i);
+  }
+  RtcEventLogTestHelper::VerifyLogEndEvent(parsed_log, 2 * kNumUpdates + 1);
+
+  remove(temp_filename.c_str());
+}
+
+TEST(RtcEventLogTest, ParseEventsInChunks) {
+  Random prng(141421);
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransportSequenceNumber>(1);
+  rtclog::StreamConfig sender_config;
+  GenerateVideoSendConfig(0, &sender_config, &prng);
+  sender_config.rtp_extensions.push_back(
+      RtpExtension(RtpExtension::kTransportSequenceNumberUri, 1));
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  const size_t kNumPackets = 100;
+  {
+    rtc::ScopedFakeClock fake_clock;
+    fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+    std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create());
+    log_dumper->SetColumnarFormat(true);
+    log_dumper->LogVideoSendStreamConfig(sender_config);
+    fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+    log_dumper->StartLogging(temp_filename, 10000000);
+    for (size_t i = 0; i < kNumPackets; i++) {
+      RtpPacketToSend rtp_packet =
+          GenerateRtpPacket(&extensions, 0, prng.Rand(1000, 1100), &prng);
+      rtp_packet.SetSsrc(sender_config.local_ssrc);
+      log_dumper->LogRtpHeader(kOutgoingPacket, rtp_packet.data(),
+                               rtp_packet.size());
+      fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+      if (i % 10 == 0) {
+        log_dumper->LogAudioPlayout(prng.Rand<uint32_t>());
+        fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+      }
     }
+    log_dumper->StopLogging();
   }
+
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+  const size_t event_count = parsed_log.GetNumberOfEvents();
+  ASSERT_EQ(kNumPackets + kNumPackets / 10 + 3, event_count);
+
+  // Each chunk holds the next events of the log, and the RTP headers of all
+  // of them can be parsed with the extensions of the config in the first.
+  std::ifstream file(temp_filename, std::ios_base::in | std::ios_base::binary);
+  ASSERT_TRUE(file.good());
+  RtcEventLogReader reader(&file);
+  ParsedRtcEventLog chunk;
+  const size_t kChunkSize = 7;
+  size_t num_events = 0;
+  while (size_t num_chunk_events = chunk.ParseEvents(&reader, kChunkSize)) {
+    ASSERT_EQ(num_chunk_events, chunk.GetNumberOfEvents());
+    ASSERT_LE(num_events + num_chunk_events, event_count);
+    for (size_t i = 0; i < num_chunk_events; i++) {
+      const size_t index = num_events + i;
+      EXPECT_EQ(parsed_log.GetTimestamp(index), chunk.GetTimestamp(i));
+      ASSERT_EQ(parsed_log.GetEventType(index), chunk.GetEventType(i));
+      if (chunk.GetEventType(i) == ParsedRtcEventLog::RTP_EVENT) {
+        uint8_t header[IP_PACKET_SIZE];
+        size_t header_length;
+        uint8_t expected_header[IP_PACKET_SIZE];
+        size_t expected_header_length;
+        EXPECT_NE(nullptr, chunk.GetRtpHeader(i, nullptr, header,
+                                              &header_length, nullptr));
+        parsed_log.GetRtpHeader(index, nullptr, expected_header,
+                                &expected_header_length, nullptr);
+        ASSERT_EQ(expected_header_length, header_length);
+        EXPECT_EQ(0, memcmp(expected_header, header, header_length));
+      }
+    }
+    num_events += num_chunk_events;
+  }
+  EXPECT_EQ(event_count, num_events);
+  EXPECT_FALSE(reader.failed());
+
+  // A truncated log can be read up to where it is cut off.
+  std::ifstream log_file(temp_filename,
+                         std::ios_base::in | std::ios_base::binary);
+  const std::string log((std::istreambuf_iterator<char>(log_file)),
+                        std::istreambuf_iterator<char>());
+  std::istringstream truncated_log(log.substr(0, log.size() - 1),
+                                   std::ios_base::in | std::ios_base::binary);
+  RtcEventLogReader truncated_reader(&truncated_log);
+  EXPECT_EQ(event_count - 1,
+            chunk.ParseEvents(&truncated_reader, event_count));
+  EXPECT_TRUE(truncated_reader.failed());
+
+  remove(temp_filename.c_str());
 }
 
 TEST(RtcEventLogTest, LogEventAndReadBack) {
@@ -716,6 +935,44 @@ TEST(RtcEventLogTest, LogProbeResultFailureAndReadBack) {
   remove(temp_filename.c_str());
 }
 
+TEST(RtcEventLogTest, LogAlrStateAndReadBack) {
+  Random prng(564738);
+
+  // Find the name of the current test, in order to use it as a temporary
+  // filename.
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  rtc::ScopedFakeClock fake_clock;
+  fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+  std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create());
+
+  log_dumper->StartLogging(temp_filename, 10000000);
+  log_dumper->LogAlrState(true);
+  fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+  log_dumper->LogAlrState(false);
+  fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
+  log_dumper->StopLogging();
+
+  // Read the generated file from disk.
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+
+  EXPECT_EQ(4u, parsed_log.GetNumberOfEvents());
+  RtcEventLogTestHelper::VerifyLogStartEvent(parsed_log, 0);
+  ASSERT_EQ(ParsedRtcEventLog::ALR_STATE_EVENT, parsed_log.GetEventType(1));
+  EXPECT_TRUE(parsed_log.GetAlrState(1).in_alr);
+  ASSERT_EQ(ParsedRtcEventLog::ALR_STATE_EVENT, parsed_log.GetEventType(2));
+  EXPECT_FALSE(parsed_log.GetAlrState(2).in_alr);
+  EXPECT_LT(parsed_log.GetAlrState(1).timestamp,
+            parsed_log.GetAlrState(2).timestamp);
+  RtcEventLogTestHelper::VerifyLogEndEvent(parsed_log, 3);
+
+  // Clean up temporary file - can be pretty slow.
+  remove(temp_filename.c_str());
+}
+
 class ConfigReadWriteTest {
  public:
   ConfigReadWriteTest() : prng(987654321) {}
@@ -147,6 +147,16 @@ rtclog::BweProbeResult::ResultType GetProbeResultType(
            << "Event of type " << type << " has "
            << (event.has_probe_result() ? "" : "no ") << "bwe probe result";
   }
+  if ((type == rtclog::Event::ALR_STATE_EVENT) != event.has_alr_state()) {
+    return ::testing::AssertionFailure()
+           << "Event of type " << type << " has "
+           << (event.has_alr_state() ? "" : "no ") << "ALR state";
+  }
+  if ((type == rtclog::Event::EVENT_BATCH) != event.has_event_batch()) {
+    return ::testing::AssertionFailure()
+           << "Event of type " << type << " has "
+           << (event.has_event_batch() ? "" : "no ") << "event batch";
+  }
   return ::testing::AssertionSuccess();
 }
 
@@ -114,4 +114,30 @@ bool AdaptedVideoTrackSource::AdaptFrame(int width,
   return true;
 }
 
+bool AdaptedVideoTrackSource::AdaptAndDeliverFrame(
+    const webrtc::VideoFrame& frame) {
+  int adapted_width;
+  int adapted_height;
+  int crop_width;
+  int crop_height;
+  int crop_x;
+  int crop_y;
+  if (!AdaptFrame(frame.width(), frame.height(), frame.timestamp_us(),
+                  &adapted_width, &adapted_height, &crop_width, &crop_height,
+                  &crop_x, &crop_y)) {
+    return false;
+  }
+
+  if (adapted_width == frame.width() && adapted_height == frame.height()) {
+    OnFrame(frame);
+    return true;
+  }
+  OnFrame(webrtc::VideoFrame(
+      frame.video_frame_buffer()->CropAndScale(crop_x, crop_y, crop_width,
+                                               crop_height, adapted_width,
+                                               adapted_height),
+      frame.rotation(), frame.timestamp_us()));
+  return true;
+}
+
 }  // namespace rtc
@@ -49,6 +49,13 @@ class AdaptedVideoTrackSource
                   int* crop_x,
                   int* crop_y);
 
+  // Adapts |frame| with AdaptFrame() and delivers it with OnFrame(). The
+  // buffer is cropped and scaled with VideoFrameBuffer::CropAndScale(), so
+  // that sources producing native frames can pass the adaptation on to the
+  // sinks without a conversion to I420. Returns false if the frame was
+  // dropped.
+  bool AdaptAndDeliverFrame(const webrtc::VideoFrame& frame);
+
   // Returns the current value of the apply_rotation flag, derived
   // from the VideoSinkWants of registered sinks. The value is derived
   // from sinks' wants, in AddOrUpdateSink and RemoveSink. Beware that
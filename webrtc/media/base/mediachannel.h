@@ -831,6 +831,9 @@ struct VideoReceiverInfo : public MediaReceiverInfo {
   // Timing frame info: all important timestamps for a full lifetime of a
   // single 'timing frame'.
   rtc::Optional<webrtc::TimingFrameInfo> timing_frame_info;
+
+  // Average time spent by the timing frames in each stage of the pipeline.
+  rtc::Optional<webrtc::TimingFrameStageDelays> timing_frame_stage_delays;
 };
 
 struct DataSenderInfo : public MediaSenderInfo {
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/media/engine/decoderperformancemonitor.h"
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+const int kRtpTicksPerMs = 90;
+}  // namespace
+
+DecoderPerformanceMonitor::DecoderPerformanceMonitor(size_t window_size)
+    : window_size_(window_size),
+      decode_times_ms_(window_size),
+      frame_intervals_ms_(window_size) {
+  RTC_DCHECK_GT(window_size, 1);
+}
+
+DecoderPerformanceMonitor::~DecoderPerformanceMonitor() {}
+
+void DecoderPerformanceMonitor::OnDecodeStarted(uint32_t rtp_timestamp,
+                                                int64_t now_ms) {
+  rtc::CritScope lock(&crit_);
+  decode_start_ms_.push_back(std::make_pair(rtp_timestamp, now_ms));
+  // Frames which the decoder drops are never reported decoded.
+  while (decode_start_ms_.size() > 2 * window_size_)
+    decode_start_ms_.pop_front();
+}
+
+void DecoderPerformanceMonitor::OnFrameDecoded(
+    uint32_t rtp_timestamp,
+    int64_t now_ms,
+    rtc::Optional<int32_t> decode_time_ms) {
+  rtc::CritScope lock(&crit_);
+  rtc::Optional<int64_t> start_ms;
+  while (!decode_start_ms_.empty()) {
+    std::pair<uint32_t, int64_t> frame = decode_start_ms_.front();
+    decode_start_ms_.pop_front();
+    if (frame.first == rtp_timestamp) {
+      start_ms = rtc::Optional<int64_t>(frame.second);
+      break;
+    }
+  }
+  if (decode_time_ms) {
+    decode_times_ms_.AddSample(*decode_time_ms);
+  } else if (start_ms) {
+    decode_times_ms_.AddSample(static_cast<int>(now_ms - *start_ms));
+  } else {
+    return;
+  }
+
+  if (last_decoded_rtp_timestamp_) {
+    // Reordered frames don't tell anything about the frame rate.
+    int32_t interval_ticks =
+        static_cast<int32_t>(rtp_timestamp - *last_decoded_rtp_timestamp_);
+    if (interval_ticks > 0)
+      frame_intervals_ms_.AddSample(interval_ticks / kRtpTicksPerMs);
+  }
+  last_decoded_rtp_timestamp_ = rtc::Optional<uint32_t>(rtp_timestamp);
+}
+
+bool DecoderPerformanceMonitor::IsSlow() const {
+  rtc::CritScope lock(&crit_);
+  if (decode_times_ms_.count() < window_size_ ||
+      frame_intervals_ms_.count() < window_size_ - 1) {
+    return false;
+  }
+  return decode_times_ms_.ComputeMean() > frame_intervals_ms_.ComputeMean();
+}
+
+rtc::Optional<int> DecoderPerformanceMonitor::AverageDecodeTimeMs() const {
+  rtc::CritScope lock(&crit_);
+  if (decode_times_ms_.count() == 0)
+    return rtc::Optional<int>();
+  return rtc::Optional<int>(
+      static_cast<int>(decode_times_ms_.ComputeMean() + 0.5));
+}
+
+void DecoderPerformanceMonitor::Reset() {
+  rtc::CritScope lock(&crit_);
+  decode_start_ms_.clear();
+  decode_times_ms_.Reset();
+  frame_intervals_ms_.Reset();
+  last_decoded_rtp_timestamp_ = rtc::Optional<uint32_t>();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MEDIA_ENGINE_DECODERPERFORMANCEMONITOR_H_
+#define WEBRTC_MEDIA_ENGINE_DECODERPERFORMANCEMONITOR_H_
+
+#include <deque>
+#include <utility>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/optional.h"
+#include "webrtc/rtc_base/rollingaccumulator.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Measures how long a decoder takes per frame, to tell when it can't keep up
+// with the frame rate of the stream it decodes. Frames may be reported
+// decoded on another thread than the one they are decoded on.
+class DecoderPerformanceMonitor {
+ public:
+  // The decoder is slow when its decode time, averaged over the last
+  // |window_size| frames, exceeds the average interval between those frames.
+  explicit DecoderPerformanceMonitor(size_t window_size);
+  ~DecoderPerformanceMonitor();
+
+  // Called right before the frame with |rtp_timestamp| is decoded.
+  void OnDecodeStarted(uint32_t rtp_timestamp, int64_t now_ms);
+  // Called when the frame with |rtp_timestamp| has been decoded. The decode
+  // time is |decode_time_ms| if the decoder reports one, otherwise the time
+  // since the decode started.
+  void OnFrameDecoded(uint32_t rtp_timestamp,
+                      int64_t now_ms,
+                      rtc::Optional<int32_t> decode_time_ms);
+
+  bool IsSlow() const;
+  // Average decode time over the window, if any frame has been decoded.
+  rtc::Optional<int> AverageDecodeTimeMs() const;
+
+  // Forgets all frames, e.g. when another decoder is to be measured.
+  void Reset();
+
+ private:
+  const size_t window_size_;
+  rtc::CriticalSection crit_;
+  // RTP timestamp and start time of the frames being decoded, oldest first.
+  std::deque<std::pair<uint32_t, int64_t>> decode_start_ms_ GUARDED_BY(crit_);
+  rtc::RollingAccumulator<int> decode_times_ms_ GUARDED_BY(crit_);
+  rtc::RollingAccumulator<int> frame_intervals_ms_ GUARDED_BY(crit_);
+  rtc::Optional<uint32_t> last_decoded_rtp_timestamp_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DecoderPerformanceMonitor);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MEDIA_ENGINE_DECODERPERFORMANCEMONITOR_H_
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/media/engine/decoderperformancemonitor.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+const size_t kWindowSize = 10;
+const uint32_t kRtpTicksPer30FpsFrame = 3000;
+const int64_t kFrameIntervalMs = 33;
+}  // namespace
+
+class DecoderPerformanceMonitorTest : public ::testing::Test {
+ protected:
+  DecoderPerformanceMonitorTest() : monitor_(kWindowSize) {}
+
+  // Decodes |num_frames| at 30 fps, each taking |decode_time_ms|.
+  void DecodeFrames(size_t num_frames, int64_t decode_time_ms) {
+    for (size_t i = 0; i < num_frames; ++i) {
+      monitor_.OnDecodeStarted(rtp_timestamp_, now_ms_);
+      monitor_.OnFrameDecoded(rtp_timestamp_, now_ms_ + decode_time_ms,
+                              rtc::Optional<int32_t>());
+      rtp_timestamp_ += kRtpTicksPer30FpsFrame;
+      now_ms_ += kFrameIntervalMs;
+    }
+  }
+
+  DecoderPerformanceMonitor monitor_;
+  uint32_t rtp_timestamp_ = 0;
+  int64_t now_ms_ = 1000;
+};
+
+TEST_F(DecoderPerformanceMonitorTest, NotSlowUntilWindowIsFull) {
+  EXPECT_FALSE(monitor_.AverageDecodeTimeMs());
+  DecodeFrames(kWindowSize - 1, 50);
+  EXPECT_FALSE(monitor_.IsSlow());
+  EXPECT_EQ(rtc::Optional<int>(50), monitor_.AverageDecodeTimeMs());
+  DecodeFrames(1, 50);
+  EXPECT_TRUE(monitor_.IsSlow());
+}
+
+TEST_F(DecoderPerformanceMonitorTest, NotSlowWhenKeepingUp) {
+  DecodeFrames(2 * kWindowSize, 20);
+  EXPECT_FALSE(monitor_.IsSlow());
+  EXPECT_EQ(rtc::Optional<int>(20), monitor_.AverageDecodeTimeMs());
+}
+
+TEST_F(DecoderPerformanceMonitorTest, PrefersDecodeTimeReportedByDecoder) {
+  for (size_t i = 0; i < kWindowSize; ++i) {
+    monitor_.OnDecodeStarted(rtp_timestamp_, now_ms_);
+    // The frame is delivered late, but the decoder only spent 10 ms on it.
+    monitor_.OnFrameDecoded(rtp_timestamp_, now_ms_ + 100,
+                            rtc::Optional<int32_t>(10));
+    rtp_timestamp_ += kRtpTicksPer30FpsFrame;
+    now_ms_ += kFrameIntervalMs;
+  }
+  EXPECT_FALSE(monitor_.IsSlow());
+  EXPECT_EQ(rtc::Optional<int>(10), monitor_.AverageDecodeTimeMs());
+}
+
+TEST_F(DecoderPerformanceMonitorTest, MatchesPipelinedFramesByTimestamp) {
+  // Two frames in flight, each decoded 50 ms after its decode started.
+  monitor_.OnDecodeStarted(0, 0);
+  monitor_.OnDecodeStarted(kRtpTicksPer30FpsFrame, 10);
+  monitor_.OnFrameDecoded(0, 50, rtc::Optional<int32_t>());
+  monitor_.OnFrameDecoded(kRtpTicksPer30FpsFrame, 60,
+                          rtc::Optional<int32_t>());
+  EXPECT_EQ(rtc::Optional<int>(50), monitor_.AverageDecodeTimeMs());
+}
+
+TEST_F(DecoderPerformanceMonitorTest, ResetForgetsFrames) {
+  DecodeFrames(kWindowSize, 50);
+  EXPECT_TRUE(monitor_.IsSlow());
+  monitor_.Reset();
+  EXPECT_FALSE(monitor_.IsSlow());
+  EXPECT_FALSE(monitor_.AverageDecodeTimeMs());
+}
+
+}  // namespace webrtc
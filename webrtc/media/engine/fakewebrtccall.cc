@@ -535,6 +535,31 @@ void FakeCall::DestroyFlexfecReceiveStream(
   }
 }
 
+webrtc::RtpForwardingStream* FakeCall::CreateRtpForwardingStream(
+    const webrtc::RtpForwardingStream::Config& config) {
+  ADD_FAILURE() << "CreateRtpForwardingStream isn't supported by FakeCall.";
+  return nullptr;
+}
+
+void FakeCall::DestroyRtpForwardingStream(
+    webrtc::RtpForwardingStream* forwarding_stream) {
+  ADD_FAILURE() << "DestroyRtpForwardingStream isn't supported by FakeCall.";
+}
+
+webrtc::RtpForwardingDestination* FakeCall::CreateRtpForwardingDestination(
+    uint32_t ssrc,
+    webrtc::Transport* transport) {
+  ADD_FAILURE()
+      << "CreateRtpForwardingDestination isn't supported by FakeCall.";
+  return nullptr;
+}
+
+void FakeCall::DestroyRtpForwardingDestination(
+    webrtc::RtpForwardingDestination* destination) {
+  ADD_FAILURE()
+      << "DestroyRtpForwardingDestination isn't supported by FakeCall.";
+}
+
 webrtc::PacketReceiver* FakeCall::Receiver() {
   return this;
 }
@@ -283,6 +283,17 @@ class FakeCall final : public webrtc::Call, public webrtc::PacketReceiver {
   void DestroyFlexfecReceiveStream(
       webrtc::FlexfecReceiveStream* receive_stream) override;
 
+  // Forwarding isn't used by the media engine; these fail the test.
+  webrtc::RtpForwardingStream* CreateRtpForwardingStream(
+      const webrtc::RtpForwardingStream::Config& config) override;
+  void DestroyRtpForwardingStream(
+      webrtc::RtpForwardingStream* forwarding_stream) override;
+  webrtc::RtpForwardingDestination* CreateRtpForwardingDestination(
+      uint32_t ssrc,
+      webrtc::Transport* transport) override;
+  void DestroyRtpForwardingDestination(
+      webrtc::RtpForwardingDestination* destination) override;
+
   webrtc::PacketReceiver* Receiver() override;
 
   DeliveryStatus DeliverPacket(webrtc::MediaType media_type,
@@ -16,6 +16,7 @@
 #include "webrtc/api/video/i420_buffer.h"
 #include "webrtc/media/base/testutils.h"
 #include "webrtc/media/engine/webrtcvideocapturer.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 class FakeWebRtcVcmFactory;
 
@@ -25,6 +26,7 @@ class FakeWebRtcVideoCaptureModule : public webrtc::VideoCaptureModule {
   FakeWebRtcVideoCaptureModule(FakeWebRtcVcmFactory* factory)
       : factory_(factory),
         callback_(NULL),
+        adapter_(NULL),
         running_(false) {
   }
   ~FakeWebRtcVideoCaptureModule();
@@ -33,6 +35,7 @@ class FakeWebRtcVideoCaptureModule : public webrtc::VideoCaptureModule {
     callback_ = callback;
   }
   void DeRegisterCaptureDataCallback() override { callback_ = NULL; }
+  void SetFrameAdapter(FrameAdapter* adapter) override { adapter_ = adapter; }
   int32_t StartCapture(const webrtc::VideoCaptureCapability& cap) override {
     if (running_) return -1;
     cap_ = cap;
@@ -65,6 +68,14 @@ class FakeWebRtcVideoCaptureModule : public webrtc::VideoCaptureModule {
   void SendFrame(int w, int h) {
     if (!running_) return;
 
+    if (adapter_) {
+      int crop_width, crop_height, crop_x, crop_y;
+      if (!adapter_->AdaptCapturedFrame(w, h, rtc::TimeMicros(), &w, &h,
+                                        &crop_width, &crop_height, &crop_x,
+                                        &crop_y)) {
+        return;
+      }
+    }
     rtc::scoped_refptr<webrtc::I420Buffer> buffer =
         webrtc::I420Buffer::Create(w, h);
     // Initialize memory to satisfy DrMemory tests. See
@@ -83,6 +94,7 @@ class FakeWebRtcVideoCaptureModule : public webrtc::VideoCaptureModule {
  private:
   FakeWebRtcVcmFactory* factory_;
   rtc::VideoSinkInterface<webrtc::VideoFrame>* callback_;
+  FrameAdapter* adapter_;
   bool running_;
   webrtc::VideoCaptureCapability cap_;
 };
@@ -21,6 +21,7 @@
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_rate_allocator.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 namespace {
 
@@ -29,6 +30,9 @@ const unsigned int kDefaultMaxQp = 56;
 // Max qp for lowest spatial resolution when doing simulcast.
 const unsigned int kLowestResMaxQp = 45;
 
+const char kParallelEncodingFieldTrial[] =
+    "WebRTC-SimulcastEncoderAdapter-ParallelEncoding";
+
 uint32_t SumStreamMaxBitrate(int streams, const webrtc::VideoCodec& codec) {
   uint32_t bitrate_sum = 0;
   for (int i = 0; i < streams; ++i) {
@@ -159,6 +163,7 @@ int SimulcastEncoderAdapter::Release() {
     streaminfos_.pop_back();  // Deletes callback adapter.
     stored_encoders_.push(std::move(encoder));
   }
+  buffer_pool_.Release();
 
   // It's legal to move the encoder to another queue now.
   encoder_queue_.Detach();
@@ -205,6 +210,10 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     start_bitrates.push_back(stream_bitrate);
   }
 
+  const bool parallel_encoding =
+      doing_simulcast && number_of_cores > 1 &&
+      webrtc::field_trial::IsEnabled(kParallelEncodingFieldTrial);
+
   std::string implementation_name;
   // Create |number_of_streams| of encoder instances and init them.
   for (int i = 0; i < number_of_streams; ++i) {
@@ -256,6 +265,11 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     streaminfos_.emplace_back(std::move(encoder), std::move(callback),
                               stream_codec.width, stream_codec.height,
                               start_bitrate_kbps > 0);
+    if (parallel_encoding && i != number_of_streams - 1) {
+      streaminfos_[i].encoder_queue.reset(
+          new rtc::TaskQueue("SimulcastEncoderQueue"));
+      streaminfos_[i].encode_done.reset(new rtc::Event(false, false));
+    }
 
     if (i != 0) {
       implementation_name += ", ";
@@ -312,6 +326,14 @@ int SimulcastEncoderAdapter::Encode(
 
   int src_width = input_image.width();
   int src_height = input_image.height();
+  // Texture frames are passed on to the encoders unscaled, see below.
+  std::vector<rtc::scoped_refptr<I420Buffer>> scaled_buffers(
+      streaminfos_.size());
+  if (input_image.video_frame_buffer()->type() !=
+      VideoFrameBuffer::Type::kNative) {
+    ScaleInputForStreams(input_image, &scaled_buffers);
+  }
+  int result = WEBRTC_VIDEO_CODEC_OK;
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream) {
@@ -338,39 +360,120 @@ int SimulcastEncoderAdapter::Encode(
     // correctly sample/scale the source texture.
     // TODO(perkj): ensure that works going forward, and figure out how this
     // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
+    const bool pass_through =
+        (dst_width == src_width && dst_height == src_height) ||
         input_image.video_frame_buffer()->type() ==
-            VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
-    } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          VideoFrame(dst_buffer, input_image.timestamp(),
-                     input_image.render_time_ms(), webrtc::kVideoRotation_0),
-          codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
+            VideoFrameBuffer::Type::kNative;
+    RTC_DCHECK(pass_through || scaled_buffers[stream_idx]);
+    const VideoFrame stream_frame =
+        pass_through
+            ? input_image
+            : VideoFrame(scaled_buffers[stream_idx], input_image.timestamp(),
+                         input_image.render_time_ms(),
+                         webrtc::kVideoRotation_0);
+
+    StreamInfo& streaminfo = streaminfos_[stream_idx];
+    if (streaminfo.encoder_queue) {
+      VideoEncoder* encoder = streaminfo.encoder.get();
+      int* encode_result = &streaminfo.encode_result;
+      rtc::Event* encode_done = streaminfo.encode_done.get();
+      streaminfo.encoder_queue->PostTask([=]() {
+        *encode_result = encoder->Encode(stream_frame, codec_specific_info,
+                                         &stream_frame_types);
+        encode_done->Set();
+      });
+      continue;
+    }
+    // When encoding in parallel, only the last stream is encoded here, after
+    // the others have been posted.
+    int ret = streaminfo.encoder->Encode(stream_frame, codec_specific_info,
+                                         &stream_frame_types);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      result = ret;
+      break;
     }
   }
 
-  return WEBRTC_VIDEO_CODEC_OK;
+  // Wait for the streams encoded in parallel. A failure of a lower stream takes
+  // precedence, as it would have stopped a serial encode.
+  for (auto it = streaminfos_.rbegin(); it != streaminfos_.rend(); ++it) {
+    if (!it->encoder_queue || !it->send_stream)
+      continue;
+    it->encode_done->Wait(rtc::Event::kForever);
+    if (it->encode_result != WEBRTC_VIDEO_CODEC_OK)
+      result = it->encode_result;
+  }
+
+  return result;
+}
+
+void SimulcastEncoderAdapter::ScaleInputForStreams(
+    const VideoFrame& input_image,
+    std::vector<rtc::scoped_refptr<I420Buffer>>* scaled_buffers) {
+  const int src_width = input_image.width();
+  const int src_height = input_image.height();
+  // Visit the streams from the highest resolution down, so that every stream
+  // can be scaled from the one above it instead of from the input.
+  std::vector<size_t> order(streaminfos_.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return streaminfos_[a].width * streaminfos_[a].height >
+           streaminfos_[b].width * streaminfos_[b].height;
+  });
+
+  rtc::scoped_refptr<I420BufferInterface> input;
+  for (size_t stream_idx : order) {
+    const StreamInfo& streaminfo = streaminfos_[stream_idx];
+    const int dst_width = streaminfo.width;
+    const int dst_height = streaminfo.height;
+    if (!streaminfo.send_stream ||
+        (dst_width == src_width && dst_height == src_height)) {
+      continue;
+    }
+
+    // Smallest frame scaled so far that covers the destination resolution.
+    rtc::scoped_refptr<I420Buffer> src_buffer;
+    for (const auto& buffer : *scaled_buffers) {
+      if (buffer && buffer->width() >= dst_width &&
+          buffer->height() >= dst_height &&
+          (!src_buffer || buffer->width() * buffer->height() <
+                              src_buffer->width() * src_buffer->height())) {
+        src_buffer = buffer;
+      }
+    }
+    if (src_buffer && src_buffer->width() == dst_width &&
+        src_buffer->height() == dst_height) {
+      // Another stream has the same resolution; share its frame.
+      (*scaled_buffers)[stream_idx] = src_buffer;
+      continue;
+    }
+
+    rtc::scoped_refptr<I420Buffer> dst_buffer =
+        buffer_pool_.CreateBuffer(dst_width, dst_height);
+    const I420BufferInterface* src = src_buffer.get();
+    if (!src && input_image.video_frame_buffer()->type() ==
+                    VideoFrameBuffer::Type::kNV12) {
+      // Scale NV12 input directly, without converting the full frame first.
+      nv12_to_i420_scaler_.NV12ToI420Scale(
+          *input_image.video_frame_buffer()->GetNV12(), dst_buffer.get());
+      (*scaled_buffers)[stream_idx] = dst_buffer;
+      continue;
+    }
+    if (!src) {
+      if (!input)
+        input = input_image.video_frame_buffer()->ToI420();
+      src = input.get();
+    }
+    libyuv::I420Scale(src->DataY(), src->StrideY(), src->DataU(),
+                      src->StrideU(), src->DataV(), src->StrideV(),
+                      src->width(), src->height(), dst_buffer->MutableDataY(),
+                      dst_buffer->StrideY(), dst_buffer->MutableDataU(),
+                      dst_buffer->StrideU(), dst_buffer->MutableDataV(),
+                      dst_buffer->StrideV(), dst_width, dst_height,
+                      libyuv::kFilterBilinear);
+    (*scaled_buffers)[stream_idx] = dst_buffer;
+  }
 }
 
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
@@ -455,6 +558,7 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
   vp8Info->simulcastIdx = stream_idx;
 
+  rtc::CritScope lock(&callback_crit_);
   return encoded_complete_callback_->OnEncodedImage(
       encodedImage, &stream_codec_specific, fragmentation);
 }
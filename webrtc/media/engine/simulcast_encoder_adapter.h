@@ -18,10 +18,15 @@
 #include <utility>
 #include <vector>
 
+#include "webrtc/common_video/include/i420_buffer_pool.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/media/engine/webrtcvideoencoderfactory.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 #include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/sequenced_task_checker.h"
+#include "webrtc/rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -31,6 +36,11 @@ class SimulcastRateAllocator;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+//
+// With the "WebRTC-SimulcastEncoderAdapter-ParallelEncoding" field trial and
+// more than one core, every stream but the first is encoded on a task queue of
+// its own, and Encode() returns once all streams are done. Each stream always
+// runs on the same thread, so its encoded images are delivered in order.
 class SimulcastEncoderAdapter : public VP8Encoder {
  public:
   explicit SimulcastEncoderAdapter(cricket::WebRtcVideoEncoderFactory* factory);
@@ -82,6 +92,11 @@ class SimulcastEncoderAdapter : public VP8Encoder {
     uint16_t height;
     bool key_frame_request;
     bool send_stream;
+    // Set when encoding in parallel; Encode() then posts to |encoder_queue|
+    // and waits for |encode_done|.
+    std::unique_ptr<rtc::TaskQueue> encoder_queue;
+    std::unique_ptr<rtc::Event> encode_done;
+    int encode_result = WEBRTC_VIDEO_CODEC_OK;
   };
 
   // Populate the codec settings for each simulcast stream.
@@ -93,6 +108,14 @@ class SimulcastEncoderAdapter : public VP8Encoder {
 
   bool Initialized() const;
 
+  // Scales |input_image| for each sent stream that doesn't match its
+  // resolution, setting the corresponding entry of |scaled_buffers|. Each
+  // stream is scaled from the smallest already scaled frame that is at least
+  // as large, so the input is only converted and fully scaled once.
+  void ScaleInputForStreams(
+      const VideoFrame& input_image,
+      std::vector<rtc::scoped_refptr<I420Buffer>>* scaled_buffers);
+
   void DestroyStoredEncoders();
 
   volatile int inited_;  // Accessed atomically.
@@ -100,6 +123,11 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   VideoCodec codec_;
   std::vector<StreamInfo> streaminfos_;
   EncodedImageCallback* encoded_complete_callback_;
+  // Serializes the deliveries of encoded images when encoding in parallel.
+  rtc::CriticalSection callback_crit_;
+  // Buffers for the scaled input of all streams, reused across frames.
+  I420BufferPool buffer_pool_;
+  NV12ToI420Scaler nv12_to_i420_scaler_;
   std::string implementation_name_;
 
   // Used for checking the single-threaded access of the encoder interface.
@@ -16,6 +16,8 @@
 #include "webrtc/media/engine/simulcast_encoder_adapter.h"
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_test_utility.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/gmock.h"
 
 namespace webrtc {
@@ -786,6 +788,93 @@ TEST_F(TestSimulcastEncoderAdapterFake,
   EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, ScalesEachStreamOnceIntoPooledBuffers) {
+  TestVp8Simulcast::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
+  codec_.VP8()->tl_factory = &tl_factory_;
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 1, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  ASSERT_EQ(3u, helper_->factory()->encoders().size());
+
+  std::vector<const VideoFrameBuffer*> buffers(3, nullptr);
+  for (size_t i = 0; i < 3; ++i) {
+    MockVideoEncoder* encoder = helper_->factory()->encoders()[i];
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .Times(2)
+        .WillRepeatedly(::testing::Invoke(
+            [encoder, &buffers, i](const VideoFrame& frame,
+                                   const CodecSpecificInfo*,
+                                   const std::vector<FrameType>*) {
+              EXPECT_EQ(encoder->codec().width, frame.width());
+              EXPECT_EQ(encoder->codec().height, frame.height());
+              buffers[i] = frame.video_frame_buffer().get();
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> input_buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  input_buffer->InitializeData();
+  VideoFrame input_frame(input_buffer, 0, 0, webrtc::kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+  const std::vector<const VideoFrameBuffer*> first_buffers = buffers;
+  EXPECT_EQ(input_buffer.get(), first_buffers[2]);
+
+  // The scaled buffers of the first frame have been released by the encoders,
+  // so the second frame reuses them.
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+  EXPECT_EQ(first_buffers, buffers);
+}
+
+TEST_F(TestSimulcastEncoderAdapterFake, EncodesStreamsInParallel) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/");
+  TestVp8Simulcast::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
+  codec_.VP8()->tl_factory = &tl_factory_;
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 4, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  ASSERT_EQ(3u, helper_->factory()->encoders().size());
+
+  std::vector<rtc::PlatformThreadRef> threads(3);
+  for (size_t i = 0; i < 3; ++i) {
+    MockVideoEncoder* encoder = helper_->factory()->encoders()[i];
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .WillOnce(::testing::Invoke(
+            [encoder, &threads, i](const VideoFrame& frame,
+                                   const CodecSpecificInfo*,
+                                   const std::vector<FrameType>*) {
+              threads[i] = rtc::CurrentThreadRef();
+              encoder->SendEncodedImage(frame.width(), frame.height());
+              return i == 1 ? WEBRTC_VIDEO_CODEC_ERROR : WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> input_buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  input_buffer->InitializeData();
+  VideoFrame input_frame(input_buffer, 0, 0, webrtc::kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  // All streams are encoded before the failure is returned.
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_ERROR,
+            adapter_->Encode(input_frame, nullptr, &frame_types));
+
+  // The highest stream is encoded on the calling thread, the others on
+  // threads of their own.
+  const rtc::PlatformThreadRef current_thread = rtc::CurrentThreadRef();
+  EXPECT_TRUE(rtc::IsThreadRefEqual(current_thread, threads[2]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(current_thread, threads[0]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(current_thread, threads[1]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(threads[0], threads[1]));
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, TestFailureReturnCodesFromEncodeCalls) {
   TestVp8Simulcast::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
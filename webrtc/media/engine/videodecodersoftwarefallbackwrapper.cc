@@ -16,17 +16,36 @@
 #include "webrtc/modules/video_coding/include/video_error_codes.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
+namespace {
+const char kSlownessFallbackFieldTrial[] = "WebRTC-DecoderSlownessFallback";
+// About three seconds of video at 30 fps.
+const size_t kDecodeTimeWindowFrames = 90;
+
+std::unique_ptr<DecoderPerformanceMonitor> CreatePerformanceMonitor() {
+  if (!field_trial::IsEnabled(kSlownessFallbackFieldTrial))
+    return nullptr;
+  return rtc::MakeUnique<DecoderPerformanceMonitor>(kDecodeTimeWindowFrames);
+}
+}  // namespace
+
 VideoDecoderSoftwareFallbackWrapper::VideoDecoderSoftwareFallbackWrapper(
     VideoCodecType codec_type,
     VideoDecoder* decoder)
     : codec_type_(codec_type),
       decoder_(decoder),
       decoder_initialized_(false),
-      callback_(nullptr) {}
+      callback_(nullptr),
+      performance_monitor_(CreatePerformanceMonitor()),
+      fallback_on_slowness_(false),
+      slowness_switching_disabled_(false),
+      hardware_decode_time_ms_(0) {}
 
 int32_t VideoDecoderSoftwareFallbackWrapper::InitDecode(
     const VideoCodec* codec_settings,
@@ -44,12 +63,13 @@ int32_t VideoDecoderSoftwareFallbackWrapper::InitDecode(
   decoder_initialized_ = false;
 
   // Try to initialize fallback decoder.
-  if (InitFallbackDecoder())
+  if (InitFallbackDecoder(DecoderFallbackReason::kInitDecode))
     return WEBRTC_VIDEO_CODEC_OK;
   return ret;
 }
 
-bool VideoDecoderSoftwareFallbackWrapper::InitFallbackDecoder() {
+bool VideoDecoderSoftwareFallbackWrapper::InitFallbackDecoder(
+    DecoderFallbackReason reason) {
   RTC_CHECK(codec_type_ != kVideoCodecUnknown)
       << "Decoder requesting fallback to codec not supported in software.";
   LOG(LS_WARNING) << "Decoder falling back to software decoding.";
@@ -63,23 +83,81 @@ bool VideoDecoderSoftwareFallbackWrapper::InitFallbackDecoder() {
     return false;
   }
   if (callback_)
-    fallback_decoder_->RegisterDecodeCompleteCallback(callback_);
+    fallback_decoder_->RegisterDecodeCompleteCallback(DecoderCallback());
   fallback_implementation_name_ =
       std::string(fallback_decoder_->ImplementationName()) +
       " (fallback from: " + decoder_->ImplementationName() + ")";
+  if (performance_monitor_)
+    performance_monitor_->Reset();
+  ReportFallback(reason);
   return true;
 }
 
+void VideoDecoderSoftwareFallbackWrapper::ReleaseFallbackDecoder() {
+  fallback_decoder_->Release();
+  fallback_decoder_.reset();
+  fallback_on_slowness_ = false;
+  if (performance_monitor_)
+    performance_monitor_->Reset();
+}
+
+void VideoDecoderSoftwareFallbackWrapper::MaybeSwitchOnSlowness() {
+  if (slowness_switching_disabled_ || !performance_monitor_->IsSlow())
+    return;
+  int decode_time_ms = *performance_monitor_->AverageDecodeTimeMs();
+  if (!fallback_decoder_) {
+    LOG(LS_WARNING) << "Decoder too slow, " << decode_time_ms
+                    << " ms per frame.";
+    if (!InitFallbackDecoder(DecoderFallbackReason::kSlowDecoding)) {
+      slowness_switching_disabled_ = true;
+      return;
+    }
+    fallback_on_slowness_ = true;
+    hardware_decode_time_ms_ = decode_time_ms;
+  } else if (fallback_on_slowness_) {
+    if (decode_time_ms <= hardware_decode_time_ms_)
+      return;
+    LOG(LS_WARNING) << "Software fallback decoder slower than the original "
+                       "decoder, "
+                    << decode_time_ms << " ms vs " << hardware_decode_time_ms_
+                    << " ms per frame. Switching back.";
+    ReleaseFallbackDecoder();
+    slowness_switching_disabled_ = true;
+  }
+}
+
+void VideoDecoderSoftwareFallbackWrapper::ReportFallback(
+    DecoderFallbackReason reason) {
+  if (callback_) {
+    callback_->OnDecoderFallback(reason);
+  } else {
+    pending_fallback_reasons_.push_back(reason);
+  }
+}
+
+DecodedImageCallback* VideoDecoderSoftwareFallbackWrapper::DecoderCallback() {
+  if (performance_monitor_)
+    return this;
+  return callback_;
+}
+
 int32_t VideoDecoderSoftwareFallbackWrapper::Decode(
     const EncodedImage& input_image,
     bool missing_frames,
     const RTPFragmentationHeader* fragmentation,
     const CodecSpecificInfo* codec_specific_info,
     int64_t render_time_ms) {
-    TRACE_EVENT0("webrtc", "VideoDecoderSoftwareFallbackWrapper::Decode");
+  TRACE_EVENT0("webrtc", "VideoDecoderSoftwareFallbackWrapper::Decode");
+  if (performance_monitor_) {
+    if (input_image._frameType == kVideoFrameKey)
+      MaybeSwitchOnSlowness();
+    performance_monitor_->OnDecodeStarted(input_image._timeStamp,
+                                          rtc::TimeMillis());
+  }
   // Try initializing and decoding with the provided decoder on every keyframe
   // or when there's no fallback decoder. This is the normal case.
-  if (!fallback_decoder_ || input_image._frameType == kVideoFrameKey) {
+  if (!fallback_decoder_ ||
+      (input_image._frameType == kVideoFrameKey && !fallback_on_slowness_)) {
     int32_t ret = WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE;
     // Try reinitializing the decoder if it had failed before.
     if (!decoder_initialized_) {
@@ -96,8 +174,7 @@ int32_t VideoDecoderSoftwareFallbackWrapper::Decode(
         // Decode OK -> stop using fallback decoder.
         LOG(LS_WARNING)
             << "Decode OK, no longer using the software fallback decoder.";
-        fallback_decoder_->Release();
-        fallback_decoder_.reset();
+        ReleaseFallbackDecoder();
         return WEBRTC_VIDEO_CODEC_OK;
       }
     }
@@ -105,7 +182,7 @@ int32_t VideoDecoderSoftwareFallbackWrapper::Decode(
       return ret;
     if (!fallback_decoder_) {
       // Try to initialize fallback decoder.
-      if (!InitFallbackDecoder())
+      if (!InitFallbackDecoder(DecoderFallbackReason::kDecode))
         return ret;
     }
   }
@@ -116,17 +193,21 @@ int32_t VideoDecoderSoftwareFallbackWrapper::Decode(
 int32_t VideoDecoderSoftwareFallbackWrapper::RegisterDecodeCompleteCallback(
     DecodedImageCallback* callback) {
   callback_ = callback;
-  int32_t ret = decoder_->RegisterDecodeCompleteCallback(callback);
+  if (callback_) {
+    for (DecoderFallbackReason reason : pending_fallback_reasons_)
+      callback_->OnDecoderFallback(reason);
+    pending_fallback_reasons_.clear();
+  }
+  int32_t ret = decoder_->RegisterDecodeCompleteCallback(DecoderCallback());
   if (fallback_decoder_)
-    return fallback_decoder_->RegisterDecodeCompleteCallback(callback);
+    return fallback_decoder_->RegisterDecodeCompleteCallback(DecoderCallback());
   return ret;
 }
 
 int32_t VideoDecoderSoftwareFallbackWrapper::Release() {
   if (fallback_decoder_) {
     LOG(LS_INFO) << "Releasing software fallback decoder.";
-    fallback_decoder_->Release();
-    fallback_decoder_.reset();
+    ReleaseFallbackDecoder();
   }
   decoder_initialized_ = false;
   return decoder_->Release();
@@ -144,4 +225,42 @@ const char* VideoDecoderSoftwareFallbackWrapper::ImplementationName() const {
   return decoder_->ImplementationName();
 }
 
+int32_t VideoDecoderSoftwareFallbackWrapper::Decoded(
+    VideoFrame& decoded_image) {
+  performance_monitor_->OnFrameDecoded(decoded_image.timestamp(),
+                                       rtc::TimeMillis(),
+                                       rtc::Optional<int32_t>());
+  return callback_->Decoded(decoded_image);
+}
+
+int32_t VideoDecoderSoftwareFallbackWrapper::Decoded(
+    VideoFrame& decoded_image,
+    int64_t decode_time_ms) {
+  performance_monitor_->OnFrameDecoded(
+      decoded_image.timestamp(), rtc::TimeMillis(),
+      decode_time_ms >= 0
+          ? rtc::Optional<int32_t>(static_cast<int32_t>(decode_time_ms))
+          : rtc::Optional<int32_t>());
+  return callback_->Decoded(decoded_image, decode_time_ms);
+}
+
+void VideoDecoderSoftwareFallbackWrapper::Decoded(
+    VideoFrame& decoded_image,
+    rtc::Optional<int32_t> decode_time_ms,
+    rtc::Optional<uint8_t> qp) {
+  performance_monitor_->OnFrameDecoded(decoded_image.timestamp(),
+                                       rtc::TimeMillis(), decode_time_ms);
+  callback_->Decoded(decoded_image, decode_time_ms, qp);
+}
+
+int32_t VideoDecoderSoftwareFallbackWrapper::ReceivedDecodedReferenceFrame(
+    const uint64_t picture_id) {
+  return callback_->ReceivedDecodedReferenceFrame(picture_id);
+}
+
+int32_t VideoDecoderSoftwareFallbackWrapper::ReceivedDecodedFrame(
+    const uint64_t picture_id) {
+  return callback_->ReceivedDecodedFrame(picture_id);
+}
+
 }  // namespace webrtc
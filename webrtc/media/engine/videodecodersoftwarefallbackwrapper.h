@@ -13,15 +13,21 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "webrtc/api/video_codecs/video_decoder.h"
+#include "webrtc/media/engine/decoderperformancemonitor.h"
 
 namespace webrtc {
 
 // Class used to wrap external VideoDecoders to provide a fallback option on
 // software decoding when a hardware decoder fails to decode a stream due to
 // hardware restrictions, such as max resolution.
-class VideoDecoderSoftwareFallbackWrapper : public webrtc::VideoDecoder {
+// With the WebRTC-DecoderSlownessFallback field trial, it also falls back when
+// the hardware decoder can't keep up with the frame rate, and returns to it
+// should the software decoder turn out to be even slower.
+class VideoDecoderSoftwareFallbackWrapper : public webrtc::VideoDecoder,
+                                            public DecodedImageCallback {
  public:
   VideoDecoderSoftwareFallbackWrapper(VideoCodecType codec_type,
                                       VideoDecoder* decoder);
@@ -43,8 +49,24 @@ class VideoDecoderSoftwareFallbackWrapper : public webrtc::VideoDecoder {
 
   const char* ImplementationName() const override;
 
+  // Implements DecodedImageCallback, used while measuring decode times.
+  int32_t Decoded(VideoFrame& decoded_image) override;
+  int32_t Decoded(VideoFrame& decoded_image, int64_t decode_time_ms) override;
+  void Decoded(VideoFrame& decoded_image,
+               rtc::Optional<int32_t> decode_time_ms,
+               rtc::Optional<uint8_t> qp) override;
+  int32_t ReceivedDecodedReferenceFrame(const uint64_t picture_id) override;
+  int32_t ReceivedDecodedFrame(const uint64_t picture_id) override;
+
  private:
-  bool InitFallbackDecoder();
+  bool InitFallbackDecoder(DecoderFallbackReason reason);
+  void ReleaseFallbackDecoder();
+  // Switches decoder if the one in use has been too slow. Called on key
+  // frames, so that the new decoder starts from a decodable frame.
+  void MaybeSwitchOnSlowness();
+  void ReportFallback(DecoderFallbackReason reason);
+  // The callback to register with the wrapped decoders.
+  DecodedImageCallback* DecoderCallback();
 
   const VideoCodecType codec_type_;
   VideoDecoder* const decoder_;
@@ -55,6 +77,17 @@ class VideoDecoderSoftwareFallbackWrapper : public webrtc::VideoDecoder {
   std::string fallback_implementation_name_;
   std::unique_ptr<VideoDecoder> fallback_decoder_;
   DecodedImageCallback* callback_;
+  // Fallbacks which happened before |callback_| was registered.
+  std::vector<DecoderFallbackReason> pending_fallback_reasons_;
+
+  // Set if the WebRTC-DecoderSlownessFallback field trial is enabled.
+  const std::unique_ptr<DecoderPerformanceMonitor> performance_monitor_;
+  // True while |fallback_decoder_| is used because |decoder_| was too slow,
+  // in which case |decoder_| isn't retried on every key frame.
+  bool fallback_on_slowness_;
+  // Set once switching back and forth has been tried, so it isn't repeated.
+  bool slowness_switching_disabled_;
+  int hardware_decode_time_ms_;
 };
 
 }  // namespace webrtc
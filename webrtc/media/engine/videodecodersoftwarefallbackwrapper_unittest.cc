@@ -9,13 +9,29 @@
  */
 
 #include "webrtc/media/engine/videodecodersoftwarefallbackwrapper.h"
+#include "webrtc/api/video/i420_buffer.h"
 #include "webrtc/api/video_codecs/video_decoder.h"
 #include "webrtc/modules/video_coding/include/video_error_codes.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/gtest.h"
 
 namespace webrtc {
 
+namespace {
+const uint32_t kRtpTicksPer30FpsFrame = 3000;
+
+class FallbackCountingCallback : public DecodedImageCallback {
+ public:
+  int32_t Decoded(VideoFrame& decoded_image) override { return 0; }
+  void OnDecoderFallback(DecoderFallbackReason reason) override {
+    fallback_reasons_.push_back(reason);
+  }
+
+  std::vector<DecoderFallbackReason> fallback_reasons_;
+};
+}  // namespace
+
 class VideoDecoderSoftwareFallbackWrapperTest : public ::testing::Test {
  protected:
   VideoDecoderSoftwareFallbackWrapperTest()
@@ -35,6 +51,12 @@ class VideoDecoderSoftwareFallbackWrapperTest : public ::testing::Test {
                    const CodecSpecificInfo* codec_specific_info,
                    int64_t render_time_ms) override {
       ++decode_count_;
+      if (reported_decode_time_ms_ && decode_complete_callback_) {
+        VideoFrame frame(I420Buffer::Create(16, 16), input_image._timeStamp, 0,
+                         kVideoRotation_0);
+        decode_complete_callback_->Decoded(frame, reported_decode_time_ms_,
+                                           rtc::Optional<uint8_t>());
+      }
       return decode_return_code_;
     }
 
@@ -58,6 +80,8 @@ class VideoDecoderSoftwareFallbackWrapperTest : public ::testing::Test {
     int32_t init_decode_return_code_ = WEBRTC_VIDEO_CODEC_OK;
     int32_t decode_return_code_ = WEBRTC_VIDEO_CODEC_OK;
     DecodedImageCallback* decode_complete_callback_ = nullptr;
+    // If set, every Decode call delivers a frame which took this long.
+    rtc::Optional<int32_t> reported_decode_time_ms_;
     int release_count_ = 0;
     int reset_count_ = 0;
   };
@@ -201,4 +225,62 @@ TEST_F(VideoDecoderSoftwareFallbackWrapperTest,
   fallback_wrapper_.Release();
 }
 
+TEST_F(VideoDecoderSoftwareFallbackWrapperTest, ReportsFallbackReasons) {
+  VideoCodec codec = {};
+  fake_decoder_.init_decode_return_code_ = WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE;
+  fallback_wrapper_.InitDecode(&codec, 2);
+  FallbackCountingCallback callback;
+  // A fallback before the callback is registered is reported on registration.
+  fallback_wrapper_.RegisterDecodeCompleteCallback(&callback);
+  ASSERT_EQ(1u, callback.fallback_reasons_.size());
+  EXPECT_EQ(DecoderFallbackReason::kInitDecode, callback.fallback_reasons_[0]);
+  fallback_wrapper_.Release();
+
+  fake_decoder_.init_decode_return_code_ = WEBRTC_VIDEO_CODEC_OK;
+  fallback_wrapper_.InitDecode(&codec, 2);
+  fake_decoder_.decode_return_code_ = WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE;
+  EncodedImage encoded_image;
+  fallback_wrapper_.Decode(encoded_image, false, nullptr, nullptr, -1);
+  ASSERT_EQ(2u, callback.fallback_reasons_.size());
+  EXPECT_EQ(DecoderFallbackReason::kDecode, callback.fallback_reasons_[1]);
+  fallback_wrapper_.Release();
+}
+
+TEST_F(VideoDecoderSoftwareFallbackWrapperTest,
+       FallsBackOnSlowDecodingWithFieldTrial) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-DecoderSlownessFallback/Enabled/");
+  VideoDecoderSoftwareFallbackWrapper fallback_wrapper(kVideoCodecVP8,
+                                                       &fake_decoder_);
+  VideoCodec codec = {};
+  fallback_wrapper.InitDecode(&codec, 2);
+  FallbackCountingCallback callback;
+  fallback_wrapper.RegisterDecodeCompleteCallback(&callback);
+  // 50 ms per frame can't keep up with 30 fps.
+  fake_decoder_.reported_decode_time_ms_ = rtc::Optional<int32_t>(50);
+
+  EncodedImage encoded_image;
+  encoded_image._frameType = kVideoFrameKey;
+  const int kNumFrames = 100;
+  for (int i = 0; i < kNumFrames; ++i) {
+    encoded_image._timeStamp = i * kRtpTicksPer30FpsFrame;
+    fallback_wrapper.Decode(encoded_image, false, nullptr, nullptr, -1);
+    encoded_image._frameType = kVideoFrameDelta;
+  }
+  EXPECT_EQ(kNumFrames, fake_decoder_.decode_count_);
+  EXPECT_TRUE(callback.fallback_reasons_.empty());
+
+  // The switch happens on the next key frame.
+  encoded_image._frameType = kVideoFrameKey;
+  encoded_image._timeStamp += kRtpTicksPer30FpsFrame;
+  fallback_wrapper.Decode(encoded_image, false, nullptr, nullptr, -1);
+  EXPECT_EQ(kNumFrames, fake_decoder_.decode_count_);
+  ASSERT_EQ(1u, callback.fallback_reasons_.size());
+  EXPECT_EQ(DecoderFallbackReason::kSlowDecoding,
+            callback.fallback_reasons_[0]);
+  EXPECT_STREQ("libvpx (fallback from: fake-decoder)",
+               fallback_wrapper.ImplementationName());
+  fallback_wrapper.Release();
+}
+
 }  // namespace webrtc
@@ -110,12 +110,18 @@ WebRtcVideoCapturer::WebRtcVideoCapturer()
     : factory_(new WebRtcVcmFactory),
       module_(nullptr),
       captured_frames_(0),
+      dropped_frames_(0),
+      captured_width_(0),
+      captured_height_(0),
       start_thread_(nullptr) {}
 
 WebRtcVideoCapturer::WebRtcVideoCapturer(WebRtcVcmFactoryInterface* factory)
     : factory_(factory),
       module_(nullptr),
       captured_frames_(0),
+      dropped_frames_(0),
+      captured_width_(0),
+      captured_height_(0),
       start_thread_(nullptr) {}
 
 WebRtcVideoCapturer::~WebRtcVideoCapturer() {}
@@ -255,6 +261,9 @@ CaptureState WebRtcVideoCapturer::Start(const VideoFormat& capture_format) {
 
   start_thread_ = rtc::Thread::Current();
   captured_frames_ = 0;
+  dropped_frames_ = 0;
+  captured_width_ = 0;
+  captured_height_ = 0;
 
   SetCaptureFormat(&capture_format);
 
@@ -266,8 +275,10 @@ CaptureState WebRtcVideoCapturer::Start(const VideoFormat& capture_format) {
 
   int64_t start = rtc::TimeMillis();
   module_->RegisterCaptureDataCallback(this);
+  module_->SetFrameAdapter(this);
   if (module_->StartCapture(cap) != 0) {
     LOG(LS_ERROR) << "Camera '" << GetId() << "' failed to start";
+    module_->SetFrameAdapter(nullptr);
     module_->DeRegisterCaptureDataCallback();
     SetCaptureFormat(nullptr);
     start_thread_ = nullptr;
@@ -294,10 +305,12 @@ void WebRtcVideoCapturer::Stop() {
     // we stop it we will get no further callbacks.
     module_->StopCapture();
   }
+  module_->SetFrameAdapter(nullptr);
   module_->DeRegisterCaptureDataCallback();
 
-  // TODO(juberti): Determine if the VCM exposes any drop stats we can use.
-  double drop_ratio = 0.0;
+  int total_frames = captured_frames_ + dropped_frames_;
+  double drop_ratio =
+      total_frames > 0 ? 100.0 * dropped_frames_ / total_frames : 0.0;
   LOG(LS_INFO) << "Camera '" << GetId() << "' stopped after capturing "
                << captured_frames_ << " frames and dropping "
                << drop_ratio << "%";
@@ -336,7 +349,32 @@ void WebRtcVideoCapturer::OnFrame(
                  << ". Expected format " << GetCaptureFormat()->ToString();
   }
 
-  VideoCapturer::OnFrame(sample, sample.width(), sample.height());
+  // Modules which don't call AdaptCapturedFrame deliver frames unadapted.
+  if (captured_width_ > 0) {
+    VideoCapturer::OnFrame(sample, captured_width_, captured_height_);
+  } else {
+    VideoCapturer::OnFrame(sample, sample.width(), sample.height());
+  }
+}
+
+bool WebRtcVideoCapturer::AdaptCapturedFrame(int width,
+                                             int height,
+                                             int64_t capture_time_us,
+                                             int* out_width,
+                                             int* out_height,
+                                             int* crop_width,
+                                             int* crop_height,
+                                             int* crop_x,
+                                             int* crop_y) {
+  captured_width_ = width;
+  captured_height_ = height;
+  if (!AdaptFrame(width, height, capture_time_us, rtc::TimeMicros(),
+                  out_width, out_height, crop_width, crop_height, crop_x,
+                  crop_y, nullptr)) {
+    ++dropped_frames_;
+    return false;
+  }
+  return true;
 }
 
 }  // namespace cricket
@@ -38,8 +38,10 @@ class WebRtcVcmFactoryInterface {
 };
 
 // WebRTC-based implementation of VideoCapturer.
-class WebRtcVideoCapturer : public VideoCapturer,
-                            public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+class WebRtcVideoCapturer
+    : public VideoCapturer,
+      public rtc::VideoSinkInterface<webrtc::VideoFrame>,
+      public webrtc::VideoCaptureModule::FrameAdapter {
  public:
   WebRtcVideoCapturer();
   explicit WebRtcVideoCapturer(WebRtcVcmFactoryInterface* factory);
@@ -65,6 +67,18 @@ class WebRtcVideoCapturer : public VideoCapturer,
   // Callback when a frame is captured by camera.
   void OnFrame(const webrtc::VideoFrame& frame) override;
 
+  // Implements webrtc::VideoCaptureModule::FrameAdapter, called by the module
+  // before it converts a captured frame.
+  bool AdaptCapturedFrame(int width,
+                          int height,
+                          int64_t capture_time_us,
+                          int* out_width,
+                          int* out_height,
+                          int* crop_width,
+                          int* crop_height,
+                          int* crop_x,
+                          int* crop_y) override;
+
   // Used to signal captured frames on the same thread as invoked Start().
   // With WebRTC's current VideoCapturer implementations, this will mean a
   // thread hop, but in other implementations (e.g. Chrome) it will be called
@@ -76,6 +90,12 @@ class WebRtcVideoCapturer : public VideoCapturer,
   std::unique_ptr<WebRtcVcmFactoryInterface> factory_;
   rtc::scoped_refptr<webrtc::VideoCaptureModule> module_;
   int captured_frames_;
+  // Frames dropped by the video adapter before they were converted.
+  int dropped_frames_;
+  // Resolution of the last captured frame before adaptation, if the module
+  // asked for it to be adapted.
+  int captured_width_;
+  int captured_height_;
   std::vector<uint8_t> capture_buffer_;
   rtc::Thread* start_thread_;  // Set in Start(), unset in Stop();
 };
@@ -126,6 +126,23 @@ TEST_F(WebRtcVideoCapturerTest, TestCaptureVcm) {
   EXPECT_TRUE(capturer_->GetCaptureFormat() == NULL);
 }
 
+TEST_F(WebRtcVideoCapturerTest, TestCaptureAdaptsBeforeConversion) {
+  EXPECT_TRUE(capturer_->Init(cricket::Device(kTestDeviceName, kTestDeviceId)));
+  cricket::VideoCapturerListener listener(capturer_.get());
+  rtc::VideoSinkWants wants;
+  wants.max_pixel_count = 640 * 480 - 1;
+  capturer_->AddOrUpdateSink(&listener, wants);
+  cricket::VideoFormat format(capturer_->GetSupportedFormats()->at(0));
+  EXPECT_EQ(cricket::CS_STARTING, capturer_->Start(format));
+  EXPECT_EQ_WAIT(cricket::CS_RUNNING, listener.last_capture_state(), 1000);
+  // The module is asked for the adapted resolution before it converts.
+  factory_->modules[0]->SendFrame(640, 480);
+  EXPECT_TRUE_WAIT(listener.frame_count() > 0, 5000);
+  EXPECT_EQ(480, listener.frame_width());
+  EXPECT_EQ(360, listener.frame_height());
+  capturer_->Stop();
+}
+
 TEST_F(WebRtcVideoCapturerTest, TestCaptureWithoutInit) {
   cricket::VideoFormat format;
   EXPECT_EQ(cricket::CS_FAILED, capturer_->Start(format));
@@ -188,6 +188,27 @@ int GetDefaultVp9TemporalLayers() {
   }
   return 1;
 }
+
+// Maps the priority of an encoding to the relative bitrate priority used by
+// webrtc::VideoEncoderConfig, using the factors of the WebRTC spec. An unset
+// priority is the default "low".
+double GetBitratePriority(
+    const rtc::Optional<webrtc::PriorityType>& priority) {
+  if (!priority)
+    return 1.0;
+  switch (*priority) {
+    case webrtc::PriorityType::VERY_LOW:
+      return 0.5;
+    case webrtc::PriorityType::LOW:
+      return 1.0;
+    case webrtc::PriorityType::MEDIUM:
+      return 2.0;
+    case webrtc::PriorityType::HIGH:
+      return 4.0;
+  }
+  RTC_NOTREACHED();
+  return 1.0;
+}
 }  // namespace
 
 // Constants defined in webrtc/media/engine/constants.h
@@ -1270,10 +1291,8 @@ void WebRtcVideoChannel::OnPacketReceived(
   const webrtc::PacketTime webrtc_packet_time(packet_time.timestamp,
                                               packet_time.not_before);
   const webrtc::PacketReceiver::DeliveryStatus delivery_result =
-      call_->Receiver()->DeliverPacket(
-          webrtc::MediaType::VIDEO,
-          packet->cdata(), packet->size(),
-          webrtc_packet_time);
+      call_->Receiver()->DeliverPacketBuffer(webrtc::MediaType::VIDEO, *packet,
+                                             webrtc_packet_time);
   switch (delivery_result) {
     case webrtc::PacketReceiver::DELIVERY_OK:
       return;
@@ -1316,10 +1335,9 @@ void WebRtcVideoChannel::OnPacketReceived(
       break;
   }
 
-  if (call_->Receiver()->DeliverPacket(
-          webrtc::MediaType::VIDEO,
-          packet->cdata(), packet->size(),
-          webrtc_packet_time) != webrtc::PacketReceiver::DELIVERY_OK) {
+  if (call_->Receiver()->DeliverPacketBuffer(
+          webrtc::MediaType::VIDEO, *packet, webrtc_packet_time) !=
+      webrtc::PacketReceiver::DELIVERY_OK) {
     LOG(LS_WARNING) << "Failed to deliver RTP packet on re-delivery.";
     return;
   }
@@ -1733,8 +1751,11 @@ bool WebRtcVideoChannel::WebRtcVideoSendStream::SetRtpParameters(
     return false;
   }
 
-  bool reconfigure_encoder = new_parameters.encodings[0].max_bitrate_bps !=
-                             rtp_parameters_.encodings[0].max_bitrate_bps;
+  bool reconfigure_encoder =
+      new_parameters.encodings[0].max_bitrate_bps !=
+          rtp_parameters_.encodings[0].max_bitrate_bps ||
+      new_parameters.encodings[0].priority !=
+          rtp_parameters_.encodings[0].priority;
   rtp_parameters_ = new_parameters;
   // Codecs are currently handled at the WebRtcVideoChannel level.
   rtp_parameters_.codecs.clear();
@@ -1821,6 +1842,8 @@ WebRtcVideoChannel::WebRtcVideoSendStream::CreateVideoEncoderConfig(
     stream_max_bitrate = codec_max_bitrate_kbps * 1000;
   }
   encoder_config.max_bitrate_bps = stream_max_bitrate;
+  encoder_config.bitrate_priority =
+      GetBitratePriority(rtp_parameters_.encodings[0].priority);
 
   int max_qp = kDefaultQpMax;
   codec.GetParam(kCodecParamMaxQuantization, &max_qp);
@@ -2396,6 +2419,7 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::GetVideoReceiverInfo(
   info.nacks_sent = stats.rtcp_packet_type_counts.nack_packets;
 
   info.timing_frame_info = stats.timing_frame_info;
+  info.timing_frame_stage_delays = stats.timing_frame_stage_delays;
 
   if (log_stats)
     LOG(LS_INFO) << stats.ToString(rtc::TimeMillis());
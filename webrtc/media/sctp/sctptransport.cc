@@ -295,13 +295,7 @@ class SctpTransport::UsrSctpWrapper {
                     << "; set_df: " << std::hex << static_cast<int>(set_df);
 
     VerboseLogPacket(data, length, SCTP_DUMP_OUTBOUND);
-    // Note: We have to copy the data; the caller will delete it.
-    rtc::CopyOnWriteBuffer buf(reinterpret_cast<uint8_t*>(data), length);
-    // TODO(deadbeef): Why do we need an AsyncInvoke here? We're already on the
-    // right thread and don't need to unwind the stack.
-    transport->invoker_.AsyncInvoke<void>(
-        RTC_FROM_HERE, transport->network_thread_,
-        rtc::Bind(&SctpTransport::OnPacketFromSctpToNetwork, transport, buf));
+    transport->OnOutboundPacketFromSctp(data, length);
     return 0;
   }
 
@@ -519,8 +513,39 @@ bool SctpTransport::SendData(const SendDataParams& params,
     return false;
   }
 
-  // Send data using SCTP.
-  ssize_t send_res = 0;  // result from usrsctp_sendv.
+  if (partial_outgoing_message_) {
+    // The rest of the last message has to be accepted before this one.
+    if (result) {
+      *result = SDR_BLOCK;
+    }
+    ready_to_send_data_ = false;
+    return false;
+  }
+
+  OutgoingMessage message(params, payload);
+  SendDataResult send_result = SendMessageInternal(&message);
+  if (result) {
+    *result = send_result;
+  }
+  if (send_result != SDR_SUCCESS) {
+    return false;
+  }
+  if (message.size() > 0) {
+    // usrsctp only had room for part of the message. It's accepted anyway, so
+    // that the caller doesn't resend it, and the rest is sent when there's
+    // room, before anything else.
+    LOG(LS_VERBOSE) << debug_name_ << "->SendData(...): buffering "
+                    << message.size() << " of " << payload.size()
+                    << " bytes.";
+    partial_outgoing_message_.emplace(message);
+    ready_to_send_data_ = false;
+  }
+  return true;
+}
+
+SendDataResult SctpTransport::SendMessageInternal(OutgoingMessage* message) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  const SendDataParams& params = message->params();
   struct sctp_sendv_spa spa = {0};
   spa.sendv_flags |= SCTP_SEND_SNDINFO_VALID;
   spa.sendv_sndinfo.snd_sid = params.sid;
@@ -539,26 +564,37 @@ bool SctpTransport::SendData(const SendDataParams& params,
       spa.sendv_prinfo.pr_value = params.max_rtx_ms;
     }
   }
+  // With SCTP_EXPLICIT_EOR, this ends the message once all of it has been
+  // accepted; usrsctp fragments it into packets itself.
+  spa.sendv_sndinfo.snd_flags |= SCTP_EOR;
 
-  // We don't fragment.
-  send_res = usrsctp_sendv(
-      sock_, payload.data(), static_cast<size_t>(payload.size()), NULL, 0, &spa,
+  ssize_t send_res = usrsctp_sendv(
+      sock_, message->data(), message->size(), NULL, 0, &spa,
       rtc::checked_cast<socklen_t>(sizeof(spa)), SCTP_SENDV_SPA, 0);
   if (send_res < 0) {
     if (errno == SCTP_EWOULDBLOCK) {
-      *result = SDR_BLOCK;
       ready_to_send_data_ = false;
-      LOG(LS_INFO) << debug_name_ << "->SendData(...): EWOULDBLOCK returned";
-    } else {
-      LOG_ERRNO(LS_ERROR) << "ERROR:" << debug_name_ << "->SendData(...): "
-                          << " usrsctp_sendv: ";
+      LOG(LS_INFO) << debug_name_
+                   << "->SendMessageInternal(...): EWOULDBLOCK returned";
+      return SDR_BLOCK;
     }
-    return false;
+    LOG_ERRNO(LS_ERROR) << "ERROR:" << debug_name_
+                        << "->SendMessageInternal(...): "
+                        << " usrsctp_sendv: ";
+    return SDR_ERROR;
   }
-  if (result) {
-    // Only way out now is success.
-    *result = SDR_SUCCESS;
+  message->Advance(static_cast<size_t>(send_res));
+  return SDR_SUCCESS;
+}
+
+bool SctpTransport::SendBufferedMessage() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK(partial_outgoing_message_);
+  if (SendMessageInternal(&*partial_outgoing_message_) != SDR_SUCCESS ||
+      partial_outgoing_message_->size() > 0) {
+    return false;
   }
+  partial_outgoing_message_.reset();
   return true;
 }
 
@@ -653,10 +689,12 @@ bool SctpTransport::OpenSctpSocket() {
   // still have to do something reasonable here.  Look up what the buffer's
   // real size is and set our threshold to something reasonable.
   static const int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  const int send_threshold =
+      send_buffer_size_ ? *send_buffer_size_ / 2 : kSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, &UsrSctpWrapper::OnSctpInboundPacket,
-      &UsrSctpWrapper::SendThresholdCallback, kSendThreshold, this);
+      &UsrSctpWrapper::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     LOG_ERRNO(LS_ERROR) << debug_name_ << "->OpenSctpSocket(): "
                         << "Failed to create SCTP socket.";
@@ -721,6 +759,27 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
+  // Lets usrsctp accept part of a message that doesn't fit in the send
+  // buffer, so that messages larger than the buffer can be sent.
+  uint32_t eor = 1;
+  if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_EXPLICIT_EOR, &eor,
+                         sizeof(eor))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                        << "Failed to set SCTP_EXPLICIT_EOR.";
+    return false;
+  }
+
+  if (send_buffer_size_) {
+    int send_buffer_size = *send_buffer_size_;
+    if (usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size,
+                           sizeof(send_buffer_size))) {
+      LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                          << "Failed to set SO_SNDBUF to "
+                          << send_buffer_size;
+      return false;
+    }
+  }
+
   // Subscribe to SCTP event notifications.
   int event_types[] = {SCTP_ASSOC_CHANGE, SCTP_PEER_ADDR_CHANGE,
                        SCTP_SEND_FAILED_EVENT, SCTP_SENDER_DRY_EVENT,
@@ -752,6 +811,7 @@ void SctpTransport::CloseSctpSocket() {
     usrsctp_deregister_address(this);
     UsrSctpWrapper::DecrementUsrSctpUsageCount();
     ready_to_send_data_ = false;
+    partial_outgoing_message_.reset();
   }
 }
 
@@ -852,6 +912,9 @@ void SctpTransport::OnPacketRead(rtc::PacketTransportInternal* transport,
 
 void SctpTransport::OnSendThresholdCallback() {
   RTC_DCHECK_RUN_ON(network_thread_);
+  if (partial_outgoing_message_ && !SendBufferedMessage()) {
+    return;
+  }
   SetReadyToSendData();
 }
 
@@ -867,6 +930,35 @@ sockaddr_conn SctpTransport::GetSctpSockAddr(int port) {
   return sconn;
 }
 
+void SctpTransport::OnOutboundPacketFromSctp(const void* data, size_t length) {
+  // Note: We have to copy the data; the caller will delete it.
+  rtc::CopyOnWriteBuffer buffer(static_cast<const uint8_t*>(data), length);
+  bool first_of_batch;
+  {
+    rtc::CritScope cs(&outbound_packets_lock_);
+    first_of_batch = outbound_packets_.empty();
+    outbound_packets_.push_back(std::move(buffer));
+  }
+  // The packets queued before the invoke runs are sent along with this one.
+  if (first_of_batch) {
+    invoker_.AsyncInvoke<void>(
+        RTC_FROM_HERE, network_thread_,
+        rtc::Bind(&SctpTransport::OnPacketsFromSctpToNetwork, this));
+  }
+}
+
+void SctpTransport::OnPacketsFromSctpToNetwork() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  {
+    rtc::CritScope cs(&outbound_packets_lock_);
+    packets.swap(outbound_packets_);
+  }
+  for (const rtc::CopyOnWriteBuffer& packet : packets) {
+    OnPacketFromSctpToNetwork(packet);
+  }
+}
+
 void SctpTransport::OnPacketFromSctpToNetwork(
     const rtc::CopyOnWriteBuffer& buffer) {
   RTC_DCHECK_RUN_ON(network_thread_);
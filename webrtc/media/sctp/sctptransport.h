@@ -19,8 +19,11 @@
 #include <vector>
 
 #include "webrtc/rtc_base/asyncinvoker.h"
+#include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/copyonwritebuffer.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/sigslot.h"
 #include "webrtc/rtc_base/thread.h"
 // For SendDataParams/ReceiveDataParams.
@@ -44,8 +47,9 @@ struct SctpInboundPacket;
 //  2.  usrsctp_sendv(data)
 // [network thread returns; sctp thread then calls the following]
 //  3.  OnSctpOutboundPacket(wrapped_data)
-// [sctp thread returns having async invoked on the network thread]
-//  4.  SctpTransport::OnPacketFromSctpToNetwork(wrapped_data)
+// [sctp thread returns having queued the packet, and async invoked on the
+//  network thread if it's the first of a batch]
+//  4.  SctpTransport::OnPacketsFromSctpToNetwork()
 //  5.  TransportChannel::SendPacket(wrapped_data)
 //  6.  ... across network ... a packet is sent back ...
 //  7.  SctpTransport::OnPacketReceived(wrapped_data)
@@ -83,6 +87,15 @@ class SctpTransport : public SctpTransportInternal,
     debug_name_ = debug_name;
   }
 
+  // Sets the size of the SCTP association's send buffer, in bytes, instead of
+  // the usrsctp default of 256kB, which limits throughput on paths with a
+  // large bandwidth-delay product. Only takes effect when the SCTP socket is
+  // created, so must be called before Start().
+  void set_send_buffer_size(int size) {
+    RTC_DCHECK(!sock_);
+    send_buffer_size_ = rtc::Optional<int>(size);
+  }
+
   // Exposed to allow Post call from c-callbacks.
   // TODO(deadbeef): Remove this or at least make it return a const pointer.
   rtc::Thread* network_thread() const { return network_thread_; }
@@ -107,6 +120,36 @@ class SctpTransport : public SctpTransportInternal,
   // Sets the "ready to send" flag and fires signal if needed.
   void SetReadyToSendData();
 
+  // A message passed to SendData, of which usrsctp may only have accepted a
+  // part. Shares the payload's data, so no copy is made of the rest.
+  class OutgoingMessage {
+   public:
+    OutgoingMessage(const SendDataParams& params,
+                    const rtc::CopyOnWriteBuffer& payload)
+        : params_(params), payload_(payload) {}
+
+    const SendDataParams& params() const { return params_; }
+    // The part of the payload that hasn't been accepted yet.
+    const uint8_t* data() const { return payload_.data() + offset_; }
+    size_t size() const { return payload_.size() - offset_; }
+    void Advance(size_t amount) {
+      RTC_DCHECK_LE(amount, size());
+      offset_ += amount;
+    }
+
+   private:
+    SendDataParams params_;
+    rtc::CopyOnWriteBuffer payload_;
+    size_t offset_ = 0;
+  };
+
+  // Gives as much of |message| to usrsctp as it will accept, and advances it
+  // past that.
+  SendDataResult SendMessageInternal(OutgoingMessage* message);
+  // Continues sending |partial_outgoing_message_|. Returns true if all of it
+  // has now been accepted.
+  bool SendBufferedMessage();
+
   // Callbacks from DTLS channel.
   void OnWritableState(rtc::PacketTransportInternal* transport);
   virtual void OnPacketRead(rtc::PacketTransportInternal* transport,
@@ -119,7 +162,12 @@ class SctpTransport : public SctpTransportInternal,
   void OnSendThresholdCallback();
   sockaddr_conn GetSctpSockAddr(int port);
 
-  // Called using |invoker_| to send packet on the network.
+  // Called by usrsctp, on any thread, with a packet to send on the network.
+  // Queues a copy and, if it's the first of a batch, invokes
+  // OnPacketsFromSctpToNetwork.
+  void OnOutboundPacketFromSctp(const void* data, size_t length);
+  // Called using |invoker_| to send the queued packets on the network.
+  void OnPacketsFromSctpToNetwork();
   void OnPacketFromSctpToNetwork(const rtc::CopyOnWriteBuffer& buffer);
   // Called using |invoker_| to decide what to do with the packet.
   // The |flags| parameter is used by SCTP to distinguish notification packets
@@ -152,6 +200,18 @@ class SctpTransport : public SctpTransportInternal,
   // congestion control)? Different than |transport_channel_|'s "ready to
   // send".
   bool ready_to_send_data_ = false;
+  // See set_send_buffer_size(). Unset means the usrsctp default.
+  rtc::Optional<int> send_buffer_size_;
+  // The rest of a message that usrsctp only accepted part of. Sent before any
+  // other message, as usrsctp can only have one incomplete message at a time.
+  rtc::Optional<OutgoingMessage> partial_outgoing_message_;
+
+  // Packets made by usrsctp that are waiting to be sent on the network thread.
+  // A burst of them, such as the fragments of one large message, takes one
+  // thread hop instead of one each.
+  rtc::CriticalSection outbound_packets_lock_;
+  std::vector<rtc::CopyOnWriteBuffer> outbound_packets_
+      GUARDED_BY(outbound_packets_lock_);
 
   typedef std::set<uint32_t> StreamSet;
   // When a data channel opens a stream, it goes into open_streams_.  When we
@@ -180,12 +240,22 @@ class SctpTransportFactory : public SctpTransportInternalFactory {
 
   std::unique_ptr<SctpTransportInternal> CreateSctpTransport(
       rtc::PacketTransportInternal* channel) override {
-    return std::unique_ptr<SctpTransportInternal>(
-        new SctpTransport(network_thread_, channel));
+    SctpTransport* transport = new SctpTransport(network_thread_, channel);
+    if (send_buffer_size_) {
+      transport->set_send_buffer_size(*send_buffer_size_);
+    }
+    return std::unique_ptr<SctpTransportInternal>(transport);
+  }
+
+  // Sets the send buffer size of the transports created from now on. See
+  // SctpTransport::set_send_buffer_size.
+  void set_send_buffer_size(int size) {
+    send_buffer_size_ = rtc::Optional<int>(size);
   }
 
  private:
   rtc::Thread* network_thread_;
+  rtc::Optional<int> send_buffer_size_;
 };
 
 }  // namespace cricket
@@ -25,6 +25,8 @@
 #include "webrtc/rtc_base/helpers.h"
 #include "webrtc/rtc_base/ssladapter.h"
 #include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace {
 static const int kDefaultTimeout = 10000;  // 10 seconds.
@@ -447,6 +449,30 @@ TEST_F(SctpTransportTest, SendDataBlocked) {
   EXPECT_EQ(SDR_BLOCK, result);
 }
 
+// Sends a message larger than the send buffer, and verifies that it's accepted
+// and that the transport is ready to send again once the rest has gone out.
+TEST_F(SctpTransportTest, SendMessageLargerThanSendBuffer) {
+  SetupConnectedTransportsWithTwoStreams();
+  EXPECT_TRUE_WAIT(transport1()->ReadyToSendData(), kDefaultTimeout);
+  int ready_to_send_count = transport1_ready_to_send_count();
+
+  SendDataResult result;
+  std::string large_message(1024 * 1024, 'a');
+  ASSERT_TRUE(SendData(transport1(), 1, large_message, &result));
+  EXPECT_EQ(SDR_SUCCESS, result);
+  EXPECT_FALSE(transport1()->ReadyToSendData());
+  // Nothing else is accepted until all of the first message has been.
+  EXPECT_FALSE(SendData(transport1(), 1, "next", &result));
+  EXPECT_EQ(SDR_BLOCK, result);
+
+  EXPECT_TRUE_WAIT(transport1_ready_to_send_count() > ready_to_send_count,
+                   kDefaultTimeout);
+  EXPECT_TRUE(transport1()->ReadyToSendData());
+  ASSERT_TRUE(SendData(transport1(), 1, "next", &result));
+  EXPECT_EQ(SDR_SUCCESS, result);
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, "next"), kDefaultTimeout);
+}
+
 // Trying to send data for a nonexistent stream should fail.
 TEST_F(SctpTransportTest, SendDataWithNonexistentStreamFails) {
   SetupConnectedTransportsWithTwoStreams();
@@ -578,4 +604,98 @@ TEST_F(SctpTransportTest, DISABLED_ReusesAStream) {
                    kDefaultTimeout);
 }
 
+// Counts the bytes received, without keeping them.
+class SctpCountingDataReceiver : public sigslot::has_slots<> {
+ public:
+  void OnDataReceived(const ReceiveDataParams& params,
+                      const rtc::CopyOnWriteBuffer& data) {
+    bytes_received_ += data.size();
+  }
+
+  size_t bytes_received() const { return bytes_received_; }
+
+ private:
+  size_t bytes_received_ = 0;
+};
+
+// Dispatches messages on the current thread until |condition| holds. Unlike
+// the WAIT macros this doesn't sleep between messages, which would limit the
+// measured throughput.
+template <typename Condition>
+bool DispatchUntil(Condition condition) {
+  rtc::Thread* thread = rtc::Thread::Current();
+  const int64_t deadline = rtc::TimeMillis() + kDefaultTimeout;
+  while (!condition()) {
+    int wait_ms = static_cast<int>(deadline - rtc::TimeMillis());
+    rtc::Message msg;
+    if (wait_ms <= 0 || !thread->Get(&msg, wait_ms)) {
+      return false;
+    }
+    thread->Dispatch(&msg);
+  }
+  return true;
+}
+
+// Sends 16MB between two transports connected back to back, in messages of
+// |message_size| bytes, and prints the throughput.
+void MeasureSendThroughput(size_t message_size, bool ordered) {
+  const size_t kTotalBytes = 16 * 1024 * 1024;
+  const size_t num_messages = kTotalBytes / message_size;
+
+  FakeDtlsTransport fake_dtls1("fake dtls 1", 0);
+  FakeDtlsTransport fake_dtls2("fake dtls 2", 0);
+  fake_dtls1.SetDestination(&fake_dtls2, false);
+  SctpTransport transport1(rtc::Thread::Current(), &fake_dtls1);
+  SctpTransport transport2(rtc::Thread::Current(), &fake_dtls2);
+  SctpCountingDataReceiver receiver;
+  transport2.SignalDataReceived.connect(
+      &receiver, &SctpCountingDataReceiver::OnDataReceived);
+  ASSERT_TRUE(transport1.OpenStream(1));
+  ASSERT_TRUE(transport2.OpenStream(1));
+  ASSERT_TRUE(transport1.Start(kTransport1Port, kTransport2Port));
+  ASSERT_TRUE(transport2.Start(kTransport2Port, kTransport1Port));
+
+  SendDataParams params;
+  params.sid = 1;
+  params.ordered = ordered;
+  rtc::CopyOnWriteBuffer payload(message_size);
+  memset(payload.data(), 'a', message_size);
+
+  const int64_t start_us = rtc::TimeMicros();
+  size_t messages_sent = 0;
+  while (messages_sent < num_messages) {
+    SendDataResult result;
+    if (transport1.SendData(params, payload, &result)) {
+      ++messages_sent;
+      continue;
+    }
+    ASSERT_EQ(SDR_BLOCK, result);
+    ASSERT_TRUE(
+        DispatchUntil([&transport1] { return transport1.ReadyToSendData(); }));
+  }
+  const size_t bytes_sent = num_messages * message_size;
+  ASSERT_TRUE(DispatchUntil([&receiver, bytes_sent] {
+    return receiver.bytes_received() == bytes_sent;
+  }));
+  const int64_t elapsed_us = std::max<int64_t>(rtc::TimeMicros() - start_us, 1);
+
+  const std::string modifier = ordered ? "_ordered" : "_unordered";
+  const std::string trace = std::to_string(message_size) + "_bytes";
+  webrtc::test::PrintResult(
+      "sctp_messages", modifier, trace,
+      static_cast<size_t>(num_messages * rtc::kNumMicrosecsPerSec / elapsed_us),
+      "messages/s", false);
+  webrtc::test::PrintResult(
+      "sctp_throughput", modifier, trace,
+      static_cast<size_t>(bytes_sent / elapsed_us), "MB/s", false);
+}
+
+TEST_F(SctpTransportTest, DISABLED_SendThroughputPerf) {
+  for (size_t message_size : {1024, 16 * 1024, 64 * 1024, 256 * 1024}) {
+    for (bool ordered : {true, false}) {
+      MeasureSendThroughput(message_size, ordered);
+    }
+  }
+}
+
 }  // namespace cricket
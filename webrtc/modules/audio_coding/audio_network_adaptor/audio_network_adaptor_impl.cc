@@ -21,9 +21,44 @@ namespace {
 constexpr int kEventLogMinBitrateChangeBps = 5000;
 constexpr float kEventLogMinBitrateChangeFraction = 0.25;
 constexpr float kEventLogMinPacketLossChangeFraction = 0.5;
+
+bool IsEqual(const AudioEncoderRuntimeConfig& a,
+             const AudioEncoderRuntimeConfig& b) {
+  return a.bitrate_bps == b.bitrate_bps &&
+         a.frame_length_ms == b.frame_length_ms &&
+         a.uplink_packet_loss_fraction == b.uplink_packet_loss_fraction &&
+         a.enable_fec == b.enable_fec && a.enable_dtx == b.enable_dtx &&
+         a.num_channels == b.num_channels;
+}
+
+// Returns true if |value| is set and differs from |reference| by |threshold|
+// or more, or if only one of them is set.
+template <typename T>
+bool ExceedsThreshold(const rtc::Optional<T>& value,
+                      const rtc::Optional<T>& reference,
+                      T threshold) {
+  if (!value || !reference)
+    return static_cast<bool>(value) != static_cast<bool>(reference);
+  if (threshold == 0)
+    return *value != *reference;
+  return (*value > *reference ? *value - *reference : *reference - *value) >=
+         threshold;
+}
+
+bool BitrateChanged(const rtc::Optional<int>& value,
+                    const rtc::Optional<int>& reference,
+                    float min_change_fraction) {
+  return ExceedsThreshold(
+      value, reference,
+      reference ? static_cast<int>(min_change_fraction * *reference) : 0);
+}
 }  // namespace
 
-AudioNetworkAdaptorImpl::Config::Config() : event_log(nullptr){};
+AudioNetworkAdaptorImpl::Config::Config()
+    : event_log(nullptr),
+      reuse_stable_decisions(false),
+      min_bitrate_change_fraction(0.f),
+      min_rtt_change_ms(0) {}
 
 AudioNetworkAdaptorImpl::Config::~Config() = default;
 
@@ -33,6 +68,7 @@ AudioNetworkAdaptorImpl::AudioNetworkAdaptorImpl(
     std::unique_ptr<DebugDumpWriter> debug_dump_writer)
     : config_(config),
       controller_manager_(std::move(controller_manager)),
+      controllers_(controller_manager_->GetControllers()),
       debug_dump_writer_(std::move(debug_dump_writer)),
       event_log_writer_(
           config.event_log
@@ -60,6 +96,7 @@ void AudioNetworkAdaptorImpl::SetUplinkPacketLossFraction(
     float uplink_packet_loss_fraction) {
   last_metrics_.uplink_packet_loss_fraction =
       rtc::Optional<float>(uplink_packet_loss_fraction);
+  packet_loss_updated_ = true;
   DumpNetworkMetrics();
 
   Controller::NetworkMetrics network_metrics;
@@ -113,10 +150,27 @@ void AudioNetworkAdaptorImpl::SetOverhead(size_t overhead_bytes_per_packet) {
 }
 
 AudioEncoderRuntimeConfig AudioNetworkAdaptorImpl::GetEncoderRuntimeConfig() {
+  std::vector<Controller*> sorted_controllers =
+      controller_manager_->GetSortedControllers(last_metrics_);
+  const bool same_order =
+      last_decision_ && sorted_controllers == decision_controllers_;
+
   AudioEncoderRuntimeConfig config;
-  for (auto& controller :
-       controller_manager_->GetSortedControllers(last_metrics_))
-    controller->MakeDecision(&config);
+  if (config_.reuse_stable_decisions && decision_is_stable_ && same_order &&
+      !packet_loss_updated_ && !MetricsChangedSinceDecision()) {
+    config = *last_decision_;
+  } else {
+    for (auto& controller : sorted_controllers)
+      controller->MakeDecision(&config);
+    // The controllers decide from the network metrics and their previous
+    // decisions, so when they repeat a decision they will keep repeating it
+    // until the metrics change.
+    decision_is_stable_ = same_order && IsEqual(config, *last_decision_);
+    last_decision_ = rtc::Optional<AudioEncoderRuntimeConfig>(config);
+    decision_controllers_ = std::move(sorted_controllers);
+    decision_metrics_ = last_metrics_;
+    packet_loss_updated_ = false;
+  }
 
   if (debug_dump_writer_)
     debug_dump_writer_->DumpEncoderRuntimeConfig(config, rtc::TimeMillis());
@@ -140,9 +194,28 @@ void AudioNetworkAdaptorImpl::DumpNetworkMetrics() {
     debug_dump_writer_->DumpNetworkMetrics(last_metrics_, rtc::TimeMillis());
 }
 
+bool AudioNetworkAdaptorImpl::MetricsChangedSinceDecision() const {
+  const Controller::NetworkMetrics& last = last_metrics_;
+  const Controller::NetworkMetrics& decision = decision_metrics_;
+  return BitrateChanged(last.uplink_bandwidth_bps,
+                        decision.uplink_bandwidth_bps,
+                        config_.min_bitrate_change_fraction) ||
+         BitrateChanged(last.target_audio_bitrate_bps,
+                        decision.target_audio_bitrate_bps,
+                        config_.min_bitrate_change_fraction) ||
+         ExceedsThreshold(last.rtt_ms, decision.rtt_ms,
+                          config_.min_rtt_change_ms) ||
+         ExceedsThreshold(last.uplink_recoverable_packet_loss_fraction,
+                          decision.uplink_recoverable_packet_loss_fraction,
+                          0.f) ||
+         ExceedsThreshold(last.overhead_bytes_per_packet,
+                          decision.overhead_bytes_per_packet,
+                          static_cast<size_t>(0));
+}
+
 void AudioNetworkAdaptorImpl::UpdateNetworkMetrics(
     const Controller::NetworkMetrics& network_metrics) {
-  for (auto& controller : controller_manager_->GetControllers())
+  for (auto& controller : controllers_)
     controller->UpdateNetworkMetrics(network_metrics);
 }
 
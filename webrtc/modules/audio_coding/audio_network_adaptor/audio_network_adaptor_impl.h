@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_AUDIO_NETWORK_ADAPTOR_IMPL_H_
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/modules/audio_coding/audio_network_adaptor/controller.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/controller_manager.h"
@@ -30,6 +31,20 @@ class AudioNetworkAdaptorImpl final : public AudioNetworkAdaptor {
     Config();
     ~Config();
     RtcEventLog* event_log;
+    // If true, GetEncoderRuntimeConfig() returns its previous decision without
+    // asking the controllers while that decision is stable, i.e. the
+    // controllers made the same decision in the same order twice in a row,
+    // and the network metrics haven't changed by more than the thresholds
+    // below since. This requires that the controllers make their decisions
+    // from the network metrics and their own previous decisions only, as the
+    // controllers created by ControllerManagerImpl::Create() do. Any packet
+    // loss update invalidates the decision, since it may be smoothed.
+    bool reuse_stable_decisions;
+    // Changes of the uplink bandwidth and of the target audio bitrate by less
+    // than this fraction keep a stable decision.
+    float min_bitrate_change_fraction;
+    // RTT changes of less than this keep a stable decision.
+    int min_rtt_change_ms;
   };
 
   AudioNetworkAdaptorImpl(
@@ -63,16 +78,31 @@ class AudioNetworkAdaptorImpl final : public AudioNetworkAdaptor {
 
   void UpdateNetworkMetrics(const Controller::NetworkMetrics& network_metrics);
 
+  // Returns true if |last_metrics_| differ from the metrics of the last
+  // decision by more than the thresholds of |config_|.
+  bool MetricsChangedSinceDecision() const;
+
   const Config config_;
 
   std::unique_ptr<ControllerManager> controller_manager_;
 
+  // All controllers of |controller_manager_|.
+  const std::vector<Controller*> controllers_;
+
   std::unique_ptr<DebugDumpWriter> debug_dump_writer_;
 
   const std::unique_ptr<EventLogWriter> event_log_writer_;
 
   Controller::NetworkMetrics last_metrics_;
 
+  // The last decision, and the controller order and network metrics it was
+  // made with.
+  rtc::Optional<AudioEncoderRuntimeConfig> last_decision_;
+  std::vector<Controller*> decision_controllers_;
+  Controller::NetworkMetrics decision_metrics_;
+  bool decision_is_stable_ = false;
+  bool packet_loss_updated_ = false;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioNetworkAdaptorImpl);
 };
 
@@ -60,7 +60,8 @@ struct AudioNetworkAdaptorStates {
   MockDebugDumpWriter* mock_debug_dump_writer;
 };
 
-AudioNetworkAdaptorStates CreateAudioNetworkAdaptor() {
+AudioNetworkAdaptorStates CreateAudioNetworkAdaptor(
+    AudioNetworkAdaptorImpl::Config config) {
   AudioNetworkAdaptorStates states;
   std::vector<Controller*> controllers;
   for (size_t i = 0; i < kNumControllers; ++i) {
@@ -87,7 +88,6 @@ AudioNetworkAdaptorStates CreateAudioNetworkAdaptor() {
   EXPECT_CALL(*debug_dump_writer, Die());
   states.mock_debug_dump_writer = debug_dump_writer.get();
 
-  AudioNetworkAdaptorImpl::Config config;
   config.event_log = states.event_log.get();
   // AudioNetworkAdaptorImpl governs the lifetime of controller manager.
   states.audio_network_adaptor.reset(new AudioNetworkAdaptorImpl(
@@ -97,6 +97,18 @@ AudioNetworkAdaptorStates CreateAudioNetworkAdaptor() {
   return states;
 }
 
+AudioNetworkAdaptorStates CreateAudioNetworkAdaptor() {
+  return CreateAudioNetworkAdaptor(AudioNetworkAdaptorImpl::Config());
+}
+
+AudioNetworkAdaptorStates CreateReusingAudioNetworkAdaptor() {
+  AudioNetworkAdaptorImpl::Config config;
+  config.reuse_stable_decisions = true;
+  config.min_bitrate_change_fraction = 0.1f;
+  config.min_rtt_change_ms = 20;
+  return CreateAudioNetworkAdaptor(config);
+}
+
 void SetExpectCallToUpdateNetworkMetrics(
     const std::vector<std::unique_ptr<MockController>>& controllers,
     const Controller::NetworkMetrics& check) {
@@ -270,4 +282,74 @@ TEST(AudioNetworkAdaptorImplTest, LogRuntimeConfigOnGetEncoderRuntimeConfig) {
   states.audio_network_adaptor->GetEncoderRuntimeConfig();
 }
 
+TEST(AudioNetworkAdaptorImplTest, ReusesStableDecision) {
+  auto states = CreateReusingAudioNetworkAdaptor();
+  AudioEncoderRuntimeConfig config;
+  config.bitrate_bps = rtc::Optional<int>(32000);
+  config.enable_fec = rtc::Optional<bool>(true);
+
+  // The decision is stable once it has been made twice.
+  EXPECT_CALL(*states.mock_controllers[0], MakeDecision(_))
+      .Times(2)
+      .WillRepeatedly(SetArgPointee<0>(config));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_THAT(states.audio_network_adaptor->GetEncoderRuntimeConfig(),
+                EncoderRuntimeConfigIs(config));
+  }
+}
+
+TEST(AudioNetworkAdaptorImplTest, ReusesStableDecisionOnSmallChanges) {
+  auto states = CreateReusingAudioNetworkAdaptor();
+  states.audio_network_adaptor->SetUplinkBandwidth(20000);
+  states.audio_network_adaptor->SetRtt(100);
+  EXPECT_CALL(*states.mock_controllers[0], MakeDecision(_)).Times(2);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+
+  // Changes below the thresholds, with respect to the metrics of the decision.
+  states.audio_network_adaptor->SetUplinkBandwidth(21000);
+  states.audio_network_adaptor->SetRtt(110);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  states.audio_network_adaptor->SetUplinkBandwidth(21900);
+  states.audio_network_adaptor->SetRtt(119);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+}
+
+TEST(AudioNetworkAdaptorImplTest, MakesNewDecisionOnNetworkChanges) {
+  auto states = CreateReusingAudioNetworkAdaptor();
+  states.audio_network_adaptor->SetUplinkBandwidth(20000);
+  states.audio_network_adaptor->SetRtt(100);
+  EXPECT_CALL(*states.mock_controllers[0], MakeDecision(_)).Times(5);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+
+  states.audio_network_adaptor->SetUplinkBandwidth(22000);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  states.audio_network_adaptor->SetRtt(120);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  // Packet loss updates always need a new decision.
+  states.audio_network_adaptor->SetUplinkPacketLossFraction(0.1f);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+}
+
+TEST(AudioNetworkAdaptorImplTest, MakesNewDecisionUntilStable) {
+  auto states = CreateReusingAudioNetworkAdaptor();
+  AudioEncoderRuntimeConfig config;
+  config.frame_length_ms = rtc::Optional<int>(20);
+  AudioEncoderRuntimeConfig longer_config;
+  longer_config.frame_length_ms = rtc::Optional<int>(60);
+
+  // A controller that approaches its decision in steps isn't stable until it
+  // repeats the decision.
+  EXPECT_CALL(*states.mock_controllers[0], MakeDecision(_))
+      .WillOnce(SetArgPointee<0>(config))
+      .WillOnce(SetArgPointee<0>(longer_config))
+      .WillOnce(SetArgPointee<0>(longer_config));
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+  EXPECT_THAT(states.audio_network_adaptor->GetEncoderRuntimeConfig(),
+              EncoderRuntimeConfigIs(longer_config));
+}
+
 }  // namespace webrtc
@@ -328,11 +328,6 @@ std::vector<Controller*> ControllerManagerImpl::GetSortedControllers(
   if (!metrics.uplink_bandwidth_bps || !metrics.uplink_packet_loss_fraction)
     return sorted_controllers_;
 
-  const int64_t now_ms = rtc::TimeMillis();
-  if (last_reordering_time_ms_ &&
-      now_ms - *last_reordering_time_ms_ < config_.min_reordering_time_ms)
-    return sorted_controllers_;
-
   ScoringPoint scoring_point(*metrics.uplink_bandwidth_bps,
                              *metrics.uplink_packet_loss_fraction);
 
@@ -341,6 +336,20 @@ std::vector<Controller*> ControllerManagerImpl::GetSortedControllers(
           config_.min_reordering_squared_distance)
     return sorted_controllers_;
 
+  // Sorting again for the same scoring point gives the same order.
+  if (last_sorted_scoring_point_ &&
+      last_sorted_scoring_point_->uplink_bandwidth_bps ==
+          scoring_point.uplink_bandwidth_bps &&
+      last_sorted_scoring_point_->uplink_packet_loss_fraction ==
+          scoring_point.uplink_packet_loss_fraction)
+    return sorted_controllers_;
+
+  // The clock is read only when the cheaper checks above didn't suffice.
+  const int64_t now_ms = rtc::TimeMillis();
+  if (last_reordering_time_ms_ &&
+      now_ms - *last_reordering_time_ms_ < config_.min_reordering_time_ms)
+    return sorted_controllers_;
+
   // Sort controllers according to the distances of |scoring_point| to the
   // scoring points of controllers.
   //
@@ -366,6 +375,7 @@ std::vector<Controller*> ControllerManagerImpl::GetSortedControllers(
                rhs_scoring_point->second.SquaredDistanceTo(scoring_point);
       });
 
+  last_sorted_scoring_point_ = rtc::Optional<ScoringPoint>(scoring_point);
   if (sorted_controllers_ != sorted_controllers) {
     sorted_controllers_ = sorted_controllers;
     last_reordering_time_ms_ = rtc::Optional<int64_t>(now_ms);
@@ -31,6 +31,8 @@ class ControllerManager {
   virtual std::vector<Controller*> GetSortedControllers(
       const Controller::NetworkMetrics& metrics) = 0;
 
+  // Returns all controllers. They don't change over the lifetime of the
+  // manager.
   virtual std::vector<Controller*> GetControllers() const = 0;
 };
 
@@ -106,6 +108,9 @@ class ControllerManagerImpl final : public ControllerManager {
 
   rtc::Optional<int64_t> last_reordering_time_ms_;
   ScoringPoint last_scoring_point_;
+  // The scoring point of the last sorting, for which |sorted_controllers_| is
+  // the sorted order.
+  rtc::Optional<ScoringPoint> last_sorted_scoring_point_;
 
   std::vector<Controller*> default_sorted_controllers_;
 
@@ -8,14 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
 #include <utility>
 
+#include "webrtc/modules/audio_coding/audio_network_adaptor/audio_network_adaptor_impl.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/controller_manager.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/mock/mock_controller.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/mock/mock_debug_dump_writer.h"
 #include "webrtc/rtc_base/fakeclock.h"
 #include "webrtc/rtc_base/ignore_wundef.h"
 #include "webrtc/rtc_base/protobuf_utils.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gtest.h"
 
 #if WEBRTC_ENABLE_PROTOBUF
@@ -483,6 +486,57 @@ TEST(ControllerManagerTest, CreateFromConfigStringAndCheckReordering) {
                             ControllerType::CHANNEL, ControllerType::DTX,
                             ControllerType::BIT_RATE});
 }
+
+// Measures the cost of a network metrics update followed by
+// GetEncoderRuntimeConfig(), as done by the Opus encoder, with the controllers
+// of a typical config on a steady network.
+TEST(ControllerManagerTest, DISABLED_BenchmarkGetEncoderRuntimeConfig) {
+  audio_network_adaptor::config::ControllerManager config;
+  config.set_min_reordering_time_ms(kMinReorderingTimeMs);
+  config.set_min_reordering_squared_distance(kMinReorderingSquareDistance);
+  AddFecControllerConfig(&config);
+  AddChannelControllerConfig(&config);
+  AddDtxControllerConfig(&config);
+  AddFrameLengthControllerConfig(&config);
+  AddBitrateControllerConfig(&config);
+  ProtoString config_string;
+  config.SerializeToString(&config_string);
+
+  struct {
+    const char* name;
+    bool reuse_stable_decisions;
+    float min_bitrate_change_fraction;
+    int min_rtt_change_ms;
+  } const kSetups[] = {{"no reuse", false, 0.f, 0},
+                       {"reuse", true, 0.f, 0},
+                       {"reuse with thresholds", true, 0.05f, 10}};
+  constexpr int kIterations = 1000000;
+  for (const auto& setup : kSetups) {
+    AudioNetworkAdaptorImpl::Config adaptor_config;
+    adaptor_config.reuse_stable_decisions = setup.reuse_stable_decisions;
+    adaptor_config.min_bitrate_change_fraction =
+        setup.min_bitrate_change_fraction;
+    adaptor_config.min_rtt_change_ms = setup.min_rtt_change_ms;
+    AudioNetworkAdaptorImpl adaptor(
+        adaptor_config,
+        CreateControllerManager(config_string).controller_manager);
+    adaptor.SetUplinkPacketLossFraction(0.01f);
+    adaptor.SetOverhead(50);
+
+    const int64_t start = rtc::TimeNanos();
+    for (int i = 0; i < kIterations; ++i) {
+      // The bandwidth estimate and the RTT fluctuate a little.
+      if (i % 2 == 0) {
+        adaptor.SetUplinkBandwidth(32000 + (i % 8) * 100);
+      } else {
+        adaptor.SetRtt(100 + i % 4);
+      }
+      adaptor.GetEncoderRuntimeConfig();
+    }
+    printf("%s: %.1f ns per update\n", setup.name,
+           static_cast<double>(rtc::TimeNanos() - start) / kIterations);
+  }
+}
 #endif  // WEBRTC_ENABLE_PROTOBUF
 
 }  // namespace webrtc
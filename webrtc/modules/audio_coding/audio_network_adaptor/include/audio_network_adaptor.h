@@ -19,6 +19,7 @@ struct AudioEncoderRuntimeConfig {
   AudioEncoderRuntimeConfig();
   AudioEncoderRuntimeConfig(const AudioEncoderRuntimeConfig& other);
   ~AudioEncoderRuntimeConfig();
+  AudioEncoderRuntimeConfig& operator=(const AudioEncoderRuntimeConfig& other);
   rtc::Optional<int> bitrate_bps;
   rtc::Optional<int> frame_length_ms;
   // Note: This is what we tell the encoder. It doesn't have to reflect
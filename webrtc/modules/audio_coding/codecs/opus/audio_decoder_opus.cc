@@ -12,6 +12,7 @@
 
 #include <utility>
 
+#include "webrtc/modules/audio_coding/codecs/opus/opus_state_pool.h"
 #include "webrtc/rtc_base/checks.h"
 
 namespace webrtc {
@@ -65,14 +66,27 @@ class OpusFrame : public AudioDecoder::EncodedAudioFrame {
 }  // namespace
 
 AudioDecoderOpusImpl::AudioDecoderOpusImpl(size_t num_channels)
-    : channels_(num_channels) {
+    : AudioDecoderOpusImpl(num_channels, nullptr) {}
+
+AudioDecoderOpusImpl::AudioDecoderOpusImpl(size_t num_channels,
+                                           OpusStatePool* state_pool)
+    : state_pool_(state_pool), channels_(num_channels) {
   RTC_DCHECK(num_channels == 1 || num_channels == 2);
-  WebRtcOpus_DecoderCreate(&dec_state_, channels_);
+  if (state_pool_) {
+    dec_state_ = state_pool_->AcquireDecoder(channels_);
+    RTC_CHECK(dec_state_);
+  } else {
+    WebRtcOpus_DecoderCreate(&dec_state_, channels_);
+  }
   WebRtcOpus_DecoderInit(dec_state_);
 }
 
 AudioDecoderOpusImpl::~AudioDecoderOpusImpl() {
-  WebRtcOpus_DecoderFree(dec_state_);
+  if (state_pool_) {
+    state_pool_->ReleaseDecoder(dec_state_);
+  } else {
+    WebRtcOpus_DecoderFree(dec_state_);
+  }
 }
 
 std::vector<AudioDecoder::ParseResult> AudioDecoderOpusImpl::ParsePayload(
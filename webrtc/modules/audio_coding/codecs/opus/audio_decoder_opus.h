@@ -17,9 +17,14 @@
 
 namespace webrtc {
 
+class OpusStatePool;
+
 class AudioDecoderOpusImpl final : public AudioDecoder {
  public:
   explicit AudioDecoderOpusImpl(size_t num_channels);
+  // Takes the decoder state from |state_pool|, and gives it back on
+  // destruction. |state_pool| must outlive the decoder.
+  AudioDecoderOpusImpl(size_t num_channels, OpusStatePool* state_pool);
   ~AudioDecoderOpusImpl() override;
 
   std::vector<ParseResult> ParsePayload(rtc::Buffer&& payload,
@@ -45,6 +50,7 @@ class AudioDecoderOpusImpl final : public AudioDecoder {
                               SpeechType* speech_type) override;
 
  private:
+  OpusStatePool* const state_pool_;
   OpusDecInst* dec_state_;
   const size_t channels_;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioDecoderOpusImpl);
@@ -18,6 +18,7 @@
 #include "webrtc/modules/audio_coding/audio_network_adaptor/audio_network_adaptor_impl.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/controller_manager.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_state_pool.h"
 #include "webrtc/rtc_base/arraysize.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
@@ -238,7 +239,8 @@ std::unique_ptr<AudioEncoder> AudioEncoderOpus::MakeAudioEncoder(
     const AudioEncoderOpusConfig& config,
     int payload_type) {
   RTC_DCHECK(config.IsOk());
-  return rtc::MakeUnique<AudioEncoderOpus>(config, payload_type);
+  return rtc::MakeUnique<AudioEncoderOpus>(config, payload_type,
+                                           OpusStatePool::Default());
 }
 
 rtc::Optional<AudioCodecInfo> AudioEncoderOpus::QueryAudioEncoder(
@@ -370,6 +372,11 @@ AudioEncoderOpus::AudioEncoderOpus(const AudioEncoderOpusConfig& config)
 
 AudioEncoderOpus::AudioEncoderOpus(const AudioEncoderOpusConfig& config,
                                    int payload_type)
+    : AudioEncoderOpus(config, payload_type, nullptr) {}
+
+AudioEncoderOpus::AudioEncoderOpus(const AudioEncoderOpusConfig& config,
+                                   int payload_type,
+                                   OpusStatePool* state_pool)
     : AudioEncoderOpus(
           config,
           payload_type,
@@ -377,14 +384,28 @@ AudioEncoderOpus::AudioEncoderOpus(const AudioEncoderOpusConfig& config,
             return DefaultAudioNetworkAdaptorCreator(config_string, event_log);
           },
           // We choose 5sec as initial time constant due to empirical data.
-          rtc::MakeUnique<SmoothingFilterImpl>(5000)) {}
+          rtc::MakeUnique<SmoothingFilterImpl>(5000),
+          state_pool) {}
 
 AudioEncoderOpus::AudioEncoderOpus(
     const AudioEncoderOpusConfig& config,
     int payload_type,
     const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
     std::unique_ptr<SmoothingFilter> bitrate_smoother)
+    : AudioEncoderOpus(config,
+                       payload_type,
+                       audio_network_adaptor_creator,
+                       std::move(bitrate_smoother),
+                       nullptr) {}
+
+AudioEncoderOpus::AudioEncoderOpus(
+    const AudioEncoderOpusConfig& config,
+    int payload_type,
+    const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
+    std::unique_ptr<SmoothingFilter> bitrate_smoother,
+    OpusStatePool* state_pool)
     : payload_type_(payload_type),
+      state_pool_(state_pool),
       send_side_bwe_with_overhead_(
           webrtc::field_trial::IsEnabled("WebRTC-SendSideBwe-WithOverhead")),
       packet_loss_rate_(0.0),
@@ -409,7 +430,7 @@ AudioEncoderOpus::AudioEncoderOpus(int payload_type,
     : AudioEncoderOpus(*SdpToConfig(format), payload_type) {}
 
 AudioEncoderOpus::~AudioEncoderOpus() {
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
+  FreeEncoderInstance();
 }
 
 int AudioEncoderOpus::SampleRateHz() const {
@@ -651,15 +672,20 @@ bool AudioEncoderOpus::RecreateEncoderInstance(
     return false;
   config_ = config;
   if (inst_)
-    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
+    FreeEncoderInstance();
   input_buffer_.clear();
   input_buffer_.reserve(Num10msFramesPerPacket() * SamplesPer10msFrame());
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(
-                      &inst_, config.num_channels,
-                      config.application ==
-                              AudioEncoderOpusConfig::ApplicationMode::kVoip
-                          ? 0
-                          : 1));
+  const int32_t application =
+      config.application == AudioEncoderOpusConfig::ApplicationMode::kVoip
+          ? 0
+          : 1;
+  if (state_pool_) {
+    inst_ = state_pool_->AcquireEncoder(config.num_channels, application);
+    RTC_CHECK(inst_);
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
+                                             application));
+  }
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, GetBitrateBps(config)));
   if (config.fec_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -690,6 +716,15 @@ bool AudioEncoderOpus::RecreateEncoderInstance(
   return true;
 }
 
+void AudioEncoderOpus::FreeEncoderInstance() {
+  if (state_pool_) {
+    state_pool_->ReleaseEncoder(inst_);
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
+  }
+  inst_ = nullptr;
+}
+
 void AudioEncoderOpus::SetFrameLength(int frame_length_ms) {
   next_frame_length_ms_ = frame_length_ms;
 }
@@ -751,6 +786,7 @@ AudioEncoderOpus::DefaultAudioNetworkAdaptorCreator(
     RtcEventLog* event_log) const {
   AudioNetworkAdaptorImpl::Config config;
   config.event_log = event_log;
+  config.reuse_stable_decisions = true;
   return std::unique_ptr<AudioNetworkAdaptor>(new AudioNetworkAdaptorImpl(
       config, ControllerManagerImpl::Create(
                   config_string, NumChannels(), supported_frame_lengths_ms(),
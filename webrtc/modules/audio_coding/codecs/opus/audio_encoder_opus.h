@@ -28,6 +28,7 @@
 
 namespace webrtc {
 
+class OpusStatePool;
 class RtcEventLog;
 
 struct CodecInst;
@@ -69,12 +70,25 @@ class AudioEncoderOpus final : public AudioEncoder {
 
   AudioEncoderOpus(const AudioEncoderOpusConfig& config, int payload_type);
 
+  // Takes the encoder states from |state_pool|, and gives them back when
+  // they're recreated or on destruction. |state_pool| must outlive the
+  // encoder.
+  AudioEncoderOpus(const AudioEncoderOpusConfig& config,
+                   int payload_type,
+                   OpusStatePool* state_pool);
+
   // Dependency injection for testing.
   AudioEncoderOpus(
       const AudioEncoderOpusConfig& config,
       int payload_type,
       const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
       std::unique_ptr<SmoothingFilter> bitrate_smoother);
+  AudioEncoderOpus(
+      const AudioEncoderOpusConfig& config,
+      int payload_type,
+      const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
+      std::unique_ptr<SmoothingFilter> bitrate_smoother,
+      OpusStatePool* state_pool);
 
   explicit AudioEncoderOpus(const CodecInst& codec_inst);
   AudioEncoderOpus(int payload_type, const SdpAudioFormat& format);
@@ -141,6 +155,7 @@ class AudioEncoderOpus final : public AudioEncoder {
   size_t SamplesPer10msFrame() const;
   size_t SufficientOutputBufferSize() const;
   bool RecreateEncoderInstance(const AudioEncoderOpusConfig& config);
+  void FreeEncoderInstance();
   void SetFrameLength(int frame_length_ms);
   void SetNumChannelsToEncode(size_t num_channels_to_encode);
   void SetProjectedPacketLossRate(float fraction);
@@ -158,6 +173,7 @@ class AudioEncoderOpus final : public AudioEncoder {
 
   AudioEncoderOpusConfig config_;
   const int payload_type_;
+  OpusStatePool* const state_pool_;
   const bool send_side_bwe_with_overhead_;
   float packet_loss_rate_;
   std::vector<int16_t> input_buffer_;
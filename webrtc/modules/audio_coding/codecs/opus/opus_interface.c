@@ -38,6 +38,19 @@ enum {
   kWebRtcOpusDefaultFrameSize = 960,
 };
 
+/* Maps the |application| of WebRtcOpus_EncoderCreate() to the Opus value, or
+ * returns -1 if it is invalid. */
+static int OpusApplication(int32_t application) {
+  switch (application) {
+    case 0:
+      return OPUS_APPLICATION_VOIP;
+    case 1:
+      return OPUS_APPLICATION_AUDIO;
+    default:
+      return -1;
+  }
+}
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  size_t channels,
                                  int32_t application) {
@@ -45,16 +58,9 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   if (!inst)
     return -1;
 
-  switch (application) {
-    case 0:
-      opus_app = OPUS_APPLICATION_VOIP;
-      break;
-    case 1:
-      opus_app = OPUS_APPLICATION_AUDIO;
-      break;
-    default:
-      return -1;
-  }
+  opus_app = OpusApplication(application);
+  if (opus_app == -1)
+    return -1;
 
   OpusEncInst* state = calloc(1, sizeof(OpusEncInst));
   RTC_DCHECK(state);
@@ -84,6 +90,19 @@ int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   }
 }
 
+int16_t WebRtcOpus_EncoderReinit(OpusEncInst* inst, int32_t application) {
+  const int opus_app = OpusApplication(application);
+  if (!inst || opus_app == -1)
+    return -1;
+
+  if (opus_encoder_init(inst->encoder, 48000, (int)inst->channels,
+                        opus_app) != OPUS_OK) {
+    return -1;
+  }
+  inst->in_dtx_mode = 0;
+  return 0;
+}
+
 int WebRtcOpus_Encode(OpusEncInst* inst,
                       const int16_t* audio_in,
                       size_t samples,
@@ -284,6 +303,19 @@ int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   }
 }
 
+int16_t WebRtcOpus_DecoderReinit(OpusDecInst* inst) {
+  if (!inst)
+    return -1;
+
+  if (opus_decoder_init(inst->decoder, 48000, (int)inst->channels) !=
+      OPUS_OK) {
+    return -1;
+  }
+  inst->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+  inst->in_dtx_mode = 0;
+  return 0;
+}
+
 size_t WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
   return inst->channels;
 }
@@ -48,6 +48,24 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
 
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_EncoderReinit(...)
+ *
+ * This function brings an Opus encoder back to the state of a newly created
+ * one with the same number of channels, without reallocating it.
+ *
+ * Input:
+ *      - inst               : Encoder context
+ *      - application        : 0 - VOIP applications.
+ *                                 Favor speech intelligibility.
+ *                             1 - Audio applications.
+ *                                 Favor faithfulness to the original input.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_EncoderReinit(OpusEncInst* inst, int32_t application);
+
 /****************************************************************************
  * WebRtcOpus_Encode(...)
  *
@@ -246,6 +264,22 @@ int16_t WebRtcOpus_SetForceChannels(OpusEncInst* inst, size_t num_channels);
 int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, size_t channels);
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_DecoderReinit(...)
+ *
+ * This function brings an Opus decoder back to the state of a newly created
+ * one with the same number of channels, without reallocating it. Unlike
+ * WebRtcOpus_DecoderInit(), this also forgets the length of the last decoded
+ * packet.
+ *
+ * Input:
+ *      - inst               : Decoder context
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_DecoderReinit(OpusDecInst* inst);
+
 /****************************************************************************
  * WebRtcOpus_DecoderChannels(...)
  *
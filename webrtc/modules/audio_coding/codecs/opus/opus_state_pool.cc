@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/opus/opus_state_pool.h"
+
+#include "webrtc/modules/audio_coding/codecs/opus/opus_inst.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kDefaultMaxIdleInstances = 16;
+
+// Pops an instance off |idle|, or returns null if it's empty.
+template <typename T>
+T* Pop(std::vector<T*>* idle) {
+  if (idle->empty()) {
+    return nullptr;
+  }
+  T* inst = idle->back();
+  idle->pop_back();
+  return inst;
+}
+
+}  // namespace
+
+constexpr size_t OpusStatePool::kMaxChannels;
+
+// static
+OpusStatePool* OpusStatePool::Default() {
+  static OpusStatePool* const pool =
+      new OpusStatePool(kDefaultMaxIdleInstances);
+  return pool;
+}
+
+OpusStatePool::OpusStatePool(size_t max_idle_instances)
+    : max_idle_instances_(max_idle_instances) {}
+
+OpusStatePool::~OpusStatePool() {
+  for (size_t c = 0; c < kMaxChannels; ++c) {
+    for (OpusEncInst* inst : idle_encoders_[c]) {
+      WebRtcOpus_EncoderFree(inst);
+    }
+    for (OpusDecInst* inst : idle_decoders_[c]) {
+      WebRtcOpus_DecoderFree(inst);
+    }
+  }
+}
+
+OpusEncInst* OpusStatePool::AcquireEncoder(size_t channels,
+                                           int32_t application) {
+  RTC_DCHECK_GE(channels, 1);
+  RTC_DCHECK_LE(channels, kMaxChannels);
+  OpusEncInst* inst;
+  {
+    rtc::CritScope lock(&crit_);
+    inst = Pop(&idle_encoders_[channels - 1]);
+  }
+  if (inst) {
+    if (WebRtcOpus_EncoderReinit(inst, application) == 0) {
+      return inst;
+    }
+    WebRtcOpus_EncoderFree(inst);
+    return nullptr;
+  }
+  if (WebRtcOpus_EncoderCreate(&inst, channels, application) != 0) {
+    return nullptr;
+  }
+  return inst;
+}
+
+void OpusStatePool::ReleaseEncoder(OpusEncInst* inst) {
+  RTC_DCHECK(inst);
+  RTC_DCHECK_GE(inst->channels, 1);
+  RTC_DCHECK_LE(inst->channels, kMaxChannels);
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusEncInst*>& idle = idle_encoders_[inst->channels - 1];
+    if (idle.size() < max_idle_instances_) {
+      idle.push_back(inst);
+      return;
+    }
+  }
+  WebRtcOpus_EncoderFree(inst);
+}
+
+OpusDecInst* OpusStatePool::AcquireDecoder(size_t channels) {
+  RTC_DCHECK_GE(channels, 1);
+  RTC_DCHECK_LE(channels, kMaxChannels);
+  OpusDecInst* inst;
+  {
+    rtc::CritScope lock(&crit_);
+    inst = Pop(&idle_decoders_[channels - 1]);
+  }
+  if (inst) {
+    if (WebRtcOpus_DecoderReinit(inst) == 0) {
+      return inst;
+    }
+    WebRtcOpus_DecoderFree(inst);
+    return nullptr;
+  }
+  if (WebRtcOpus_DecoderCreate(&inst, channels) != 0) {
+    return nullptr;
+  }
+  return inst;
+}
+
+void OpusStatePool::ReleaseDecoder(OpusDecInst* inst) {
+  RTC_DCHECK(inst);
+  RTC_DCHECK_GE(inst->channels, 1);
+  RTC_DCHECK_LE(inst->channels, kMaxChannels);
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusDecInst*>& idle = idle_decoders_[inst->channels - 1];
+    if (idle.size() < max_idle_instances_) {
+      idle.push_back(inst);
+      return;
+    }
+  }
+  WebRtcOpus_DecoderFree(inst);
+}
+
+size_t OpusStatePool::NumIdleEncoders(size_t channels) const {
+  RTC_DCHECK_GE(channels, 1);
+  RTC_DCHECK_LE(channels, kMaxChannels);
+  rtc::CritScope lock(&crit_);
+  return idle_encoders_[channels - 1].size();
+}
+
+size_t OpusStatePool::NumIdleDecoders(size_t channels) const {
+  RTC_DCHECK_GE(channels, 1);
+  RTC_DCHECK_LE(channels, kMaxChannels);
+  rtc::CritScope lock(&crit_);
+  return idle_decoders_[channels - 1].size();
+}
+
+}  // namespace webrtc
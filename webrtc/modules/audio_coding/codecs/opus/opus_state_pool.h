@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_STATE_POOL_H_
+#define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_STATE_POOL_H_
+
+#include <vector>
+
+#include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Keeps the Opus encoder and decoder instances of destroyed codecs, to hand
+// them out to new codecs with the same number of channels instead of
+// allocating new ones. Reused instances are reinitialized to the state of
+// newly created ones, so a codec can't tell the difference. Thread-safe.
+class OpusStatePool {
+ public:
+  // Opus codecs in WebRTC are mono or stereo.
+  static constexpr size_t kMaxChannels = 2;
+
+  // The pool of the codecs made by AudioEncoderOpus::MakeAudioEncoder() and
+  // AudioDecoderOpus::MakeAudioDecoder(), which keeps up to 16 idle encoders
+  // and decoders for each number of channels. It is never destroyed.
+  static OpusStatePool* Default();
+
+  // Keeps up to |max_idle_instances| idle encoders, and as many decoders, for
+  // each number of channels. Instances released beyond that are freed.
+  explicit OpusStatePool(size_t max_idle_instances);
+  ~OpusStatePool();
+
+  // Returns an encoder as created by WebRtcOpus_EncoderCreate(), or null on
+  // failure. |application| is as for WebRtcOpus_EncoderCreate().
+  OpusEncInst* AcquireEncoder(size_t channels, int32_t application);
+  // Takes back an encoder of AcquireEncoder().
+  void ReleaseEncoder(OpusEncInst* inst);
+
+  // Returns a decoder as created by WebRtcOpus_DecoderCreate(), or null on
+  // failure.
+  OpusDecInst* AcquireDecoder(size_t channels);
+  // Takes back a decoder of AcquireDecoder().
+  void ReleaseDecoder(OpusDecInst* inst);
+
+  size_t NumIdleEncoders(size_t channels) const;
+  size_t NumIdleDecoders(size_t channels) const;
+
+ private:
+  const size_t max_idle_instances_;
+  rtc::CriticalSection crit_;
+  // Indexed by the number of channels minus one.
+  std::vector<OpusEncInst*> idle_encoders_[kMaxChannels] GUARDED_BY(crit_);
+  std::vector<OpusDecInst*> idle_decoders_[kMaxChannels] GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OpusStatePool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_STATE_POOL_H_
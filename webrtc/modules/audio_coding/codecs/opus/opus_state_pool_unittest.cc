@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/opus/opus_state_pool.h"
+
+#include <math.h>
+
+#include <vector>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kFrameSamples = 960;  // 20 ms at 48 kHz.
+const size_t kMaxBytes = 1000;
+const int kNumFrames = 10;
+
+// Returns |kNumFrames| frames of a tone on each channel.
+std::vector<int16_t> MakeInput(size_t channels) {
+  std::vector<int16_t> input(kNumFrames * kFrameSamples * channels);
+  for (size_t i = 0; i < input.size(); ++i) {
+    const size_t t = i / channels;
+    const size_t c = i % channels;
+    input[i] = static_cast<int16_t>(
+        8000 * sin(2 * 3.14159265 * (440 + 220 * c) * t / 48000));
+  }
+  return input;
+}
+
+// Encodes |input| with |inst| into one packet per frame.
+std::vector<std::vector<uint8_t>> Encode(OpusEncInst* inst,
+                                         const std::vector<int16_t>& input,
+                                         size_t channels) {
+  std::vector<std::vector<uint8_t>> packets;
+  for (int i = 0; i < kNumFrames; ++i) {
+    std::vector<uint8_t> packet(kMaxBytes);
+    const int bytes = WebRtcOpus_Encode(
+        inst, &input[i * kFrameSamples * channels], kFrameSamples, kMaxBytes,
+        packet.data());
+    EXPECT_GT(bytes, 0);
+    packet.resize(bytes > 0 ? bytes : 0);
+    packets.push_back(packet);
+  }
+  return packets;
+}
+
+// Decodes |packets| with |inst|.
+std::vector<int16_t> Decode(OpusDecInst* inst,
+                            const std::vector<std::vector<uint8_t>>& packets,
+                            size_t channels) {
+  std::vector<int16_t> output;
+  std::vector<int16_t> decoded(kFrameSamples * channels);
+  for (const auto& packet : packets) {
+    int16_t audio_type;
+    const int samples = WebRtcOpus_Decode(inst, packet.data(), packet.size(),
+                                          decoded.data(), &audio_type);
+    EXPECT_EQ(static_cast<int>(kFrameSamples), samples);
+    output.insert(output.end(), decoded.begin(), decoded.end());
+  }
+  return output;
+}
+
+}  // namespace
+
+TEST(OpusStatePoolTest, ReusesReleasedInstances) {
+  OpusStatePool pool(4);
+  OpusDecInst* decoder = pool.AcquireDecoder(1);
+  ASSERT_TRUE(decoder);
+  pool.ReleaseDecoder(decoder);
+  EXPECT_EQ(1u, pool.NumIdleDecoders(1));
+  EXPECT_EQ(0u, pool.NumIdleDecoders(2));
+  EXPECT_EQ(decoder, pool.AcquireDecoder(1));
+  EXPECT_EQ(0u, pool.NumIdleDecoders(1));
+
+  OpusEncInst* encoder = pool.AcquireEncoder(2, 0);
+  ASSERT_TRUE(encoder);
+  pool.ReleaseEncoder(encoder);
+  EXPECT_EQ(1u, pool.NumIdleEncoders(2));
+  // Instances with another number of channels are not reused.
+  OpusEncInst* mono_encoder = pool.AcquireEncoder(1, 1);
+  EXPECT_NE(encoder, mono_encoder);
+  EXPECT_EQ(1u, pool.NumIdleEncoders(2));
+  // The application can differ.
+  EXPECT_EQ(encoder, pool.AcquireEncoder(2, 1));
+
+  pool.ReleaseDecoder(decoder);
+  pool.ReleaseEncoder(encoder);
+  pool.ReleaseEncoder(mono_encoder);
+}
+
+TEST(OpusStatePoolTest, KeepsAtMostMaxIdleInstances) {
+  OpusStatePool pool(2);
+  std::vector<OpusDecInst*> decoders;
+  for (int i = 0; i < 3; ++i) {
+    decoders.push_back(pool.AcquireDecoder(2));
+  }
+  for (OpusDecInst* decoder : decoders) {
+    pool.ReleaseDecoder(decoder);
+  }
+  EXPECT_EQ(2u, pool.NumIdleDecoders(2));
+}
+
+TEST(OpusStatePoolTest, ReusedInstancesMatchNewInstances) {
+  for (size_t channels = 1; channels <= 2; ++channels) {
+    SCOPED_TRACE(channels);
+    const std::vector<int16_t> input = MakeInput(channels);
+    OpusStatePool pool(1);
+
+    // Use an encoder and a decoder, and return them to the pool.
+    OpusEncInst* encoder = pool.AcquireEncoder(channels, 1);
+    ASSERT_EQ(0, WebRtcOpus_SetBitRate(encoder, 20000));
+    ASSERT_EQ(0, WebRtcOpus_EnableFec(encoder));
+    ASSERT_EQ(0, WebRtcOpus_EnableDtx(encoder));
+    const auto used_packets = Encode(encoder, input, channels);
+    OpusDecInst* decoder = pool.AcquireDecoder(channels);
+    Decode(decoder, used_packets, channels);
+    pool.ReleaseEncoder(encoder);
+    pool.ReleaseDecoder(decoder);
+
+    OpusEncInst* new_encoder;
+    ASSERT_EQ(0, WebRtcOpus_EncoderCreate(&new_encoder, channels, 0));
+    OpusDecInst* new_decoder;
+    ASSERT_EQ(0, WebRtcOpus_DecoderCreate(&new_decoder, channels));
+    const auto expected_packets = Encode(new_encoder, input, channels);
+    const auto expected_output =
+        Decode(new_decoder, expected_packets, channels);
+
+    OpusEncInst* reused_encoder = pool.AcquireEncoder(channels, 0);
+    EXPECT_EQ(encoder, reused_encoder);
+    OpusDecInst* reused_decoder = pool.AcquireDecoder(channels);
+    EXPECT_EQ(decoder, reused_decoder);
+    EXPECT_EQ(expected_packets, Encode(reused_encoder, input, channels));
+    EXPECT_EQ(expected_output,
+              Decode(reused_decoder, expected_packets, channels));
+
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(new_encoder));
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(new_decoder));
+    pool.ReleaseEncoder(reused_encoder);
+    pool.ReleaseDecoder(reused_decoder);
+  }
+}
+
+}  // namespace webrtc
@@ -107,6 +107,9 @@ class NetEq {
     NetEqPlayoutMode playout_mode;
     bool enable_fast_accelerate;
     bool enable_muted_state = false;
+    // Decodes the next packet on a helper thread after each GetAudio() call,
+    // so that the decoding cost is taken off the thread pulling the audio.
+    bool enable_decode_ahead = false;
   };
 
   enum ReturnCodes {
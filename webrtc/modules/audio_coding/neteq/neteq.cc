@@ -27,7 +27,8 @@ std::string NetEq::Config::ToString() const {
      << ", playout_mode=" << playout_mode
      << ", enable_fast_accelerate="
      << (enable_fast_accelerate ? " true": "false")
-     << ", enable_muted_state=" << (enable_muted_state ? " true": "false");
+     << ", enable_muted_state=" << (enable_muted_state ? " true": "false")
+     << ", enable_decode_ahead=" << (enable_decode_ahead ? "true" : "false");
   return ss.str();
 }
 
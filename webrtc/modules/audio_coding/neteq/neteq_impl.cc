@@ -102,7 +102,12 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       playout_mode_(config.playout_mode),
       enable_fast_accelerate_(config.enable_fast_accelerate),
       nack_enabled_(false),
-      enable_muted_state_(config.enable_muted_state) {
+      enable_muted_state_(config.enable_muted_state),
+      decode_ahead_queue_(
+          config.enable_decode_ahead
+              ? new rtc::TaskQueue("NetEqDecodeAhead",
+                                   rtc::TaskQueue::Priority::HIGH)
+              : nullptr) {
   LOG(LS_INFO) << "NetEq config: " << config.ToString();
   int fs = config.sample_rate_hz;
   if (fs != 8000 && fs != 16000 && fs != 32000 && fs != 48000) {
@@ -194,9 +199,13 @@ void SetAudioFrameActivityAndType(bool vad_enabled,
 int NetEqImpl::GetAudio(AudioFrame* audio_frame, bool* muted) {
   TRACE_EVENT0("webrtc", "NetEqImpl::GetAudio");
   rtc::CritScope lock(&crit_sect_);
+  // A decode-ahead that has not started yet is obsolete; the packet is
+  // decoded below instead if needed.
+  decode_ahead_pending_ = false;
   if (GetAudioInternal(audio_frame, muted) != 0) {
     return kFail;
   }
+  MaybeStartDecodeAhead();
   RTC_DCHECK_EQ(
       audio_frame->sample_rate_hz_,
       rtc::dchecked_cast<int>(audio_frame->samples_per_channel_ * 100));
@@ -219,6 +228,8 @@ void NetEqImpl::SetCodecs(const std::map<int, SdpAudioFormat>& codecs) {
       decoder_database_->SetCodecs(codecs);
   for (const int pt : changed_payload_types) {
     packet_buffer_->DiscardPacketsWithPayloadType(pt, &stats_);
+    if (decoded_ahead_ && decoded_ahead_->payload_type == pt)
+      decoded_ahead_ = rtc::Optional<DecodedAheadPacket>();
   }
 }
 
@@ -270,6 +281,8 @@ int NetEqImpl::RemovePayloadType(uint8_t rtp_payload_type) {
   int ret = decoder_database_->Remove(rtp_payload_type);
   if (ret == DecoderDatabase::kOK || ret == DecoderDatabase::kDecoderNotFound) {
     packet_buffer_->DiscardPacketsWithPayloadType(rtp_payload_type, &stats_);
+    if (decoded_ahead_ && decoded_ahead_->payload_type == rtp_payload_type)
+      decoded_ahead_ = rtc::Optional<DecodedAheadPacket>();
     return kOK;
   }
   return kFail;
@@ -278,6 +291,7 @@ int NetEqImpl::RemovePayloadType(uint8_t rtp_payload_type) {
 void NetEqImpl::RemoveAllPayloadTypes() {
   rtc::CritScope lock(&crit_sect_);
   decoder_database_->RemoveAll();
+  decoded_ahead_ = rtc::Optional<DecodedAheadPacket>();
 }
 
 bool NetEqImpl::SetMinimumDelay(int delay_ms) {
@@ -535,6 +549,12 @@ Operations NetEqImpl::last_operation_for_test() const {
   return last_operation_;
 }
 
+size_t NetEqImpl::FinishDecodeAheadForTest() {
+  DecodeAhead();
+  rtc::CritScope lock(&crit_sect_);
+  return decode_ahead_hits_;
+}
+
 // Methods below this line are private.
 
 int NetEqImpl::InsertPacketInternal(const RTPHeader& rtp_header,
@@ -1367,6 +1387,7 @@ int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
   }
 
   if (reset_decoder_) {
+    DiscardDecodedAhead(true);
     // TODO(hlundin): Write test for this.
     if (decoder)
       decoder->Reset();
@@ -1382,12 +1403,14 @@ int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
   *decoded_length = 0;
   // Update codec-internal PLC state.
   if ((*operation == kMerge) && decoder && decoder->HasDecodePlc()) {
+    DiscardDecodedAhead(false);
     decoder->DecodePlc(1, &decoded_buffer_[*decoded_length]);
   }
 
   int return_value;
   if (*operation == kCodecInternalCng) {
     RTC_DCHECK(packet_list->empty());
+    DiscardDecodedAhead(false);
     return_value = DecodeCng(decoder, decoded_length, speech_type);
   } else {
     return_value = DecodeLoop(packet_list, *operation, decoder,
@@ -1473,9 +1496,23 @@ int NetEqImpl::DecodeLoop(PacketList* packet_list, const Operations& operation,
            operation == kFastAccelerate || operation == kMerge ||
            operation == kPreemptiveExpand);
 
-    auto opt_result = packet_list->front().frame->Decode(
-        rtc::ArrayView<int16_t>(&decoded_buffer_[*decoded_length],
-                                decoded_buffer_length_ - *decoded_length));
+    const Packet& packet = packet_list->front();
+    rtc::Optional<AudioDecoder::EncodedAudioFrame::DecodeResult> opt_result;
+    if (decoded_ahead_ && *decoded_length == 0 &&
+        decoded_ahead_->timestamp == packet.timestamp &&
+        decoded_ahead_->payload_type == packet.payload_type &&
+        decoded_ahead_->buffer_length == decoded_buffer_length_) {
+      opt_result = decoded_ahead_->result;
+      std::copy(decoded_ahead_->samples.begin(),
+                decoded_ahead_->samples.end(), decoded_buffer_.get());
+      decoded_ahead_ = rtc::Optional<DecodedAheadPacket>();
+      ++decode_ahead_hits_;
+    } else {
+      DiscardDecodedAhead(false);
+      opt_result = packet.frame->Decode(
+          rtc::ArrayView<int16_t>(&decoded_buffer_[*decoded_length],
+                                  decoded_buffer_length_ - *decoded_length));
+    }
     last_decoded_timestamps_.push_back(packet_list->front().timestamp);
     packet_list->pop_front();
     if (opt_result) {
@@ -1872,6 +1909,7 @@ void NetEqImpl::DoAlternativePlc(bool increase_timestamp) {
   AudioDecoder* decoder = decoder_database_->GetActiveDecoder();
   size_t length;
   if (decoder && decoder->HasDecodePlc()) {
+    DiscardDecodedAhead(false);
     // Use the decoder's packet-loss concealment.
     // TODO(hlundin): Will probably need a longer buffer for multi-channel.
     int16_t decoded_buffer[kMaxFrameSize];
@@ -2121,4 +2159,70 @@ void NetEqImpl::CreateDecisionLogic() {
       *packet_buffer_.get(), delay_manager_.get(), buffer_level_filter_.get(),
       tick_timer_.get()));
 }
+const Packet* NetEqImpl::NextPacketToDecodeAhead() const {
+  // Only decode ahead while playing out decoded speech, when the next packet
+  // continues where the last one ended. The decision logic will then hand it
+  // to the decoder next, unless new packets cause a flush or a codec change.
+  if (decoded_ahead_ || reset_decoder_ || new_codec_ ||
+      !(last_mode_ == kModeNormal || last_mode_ == kModeMerge ||
+        last_mode_ == kModeAccelerateSuccess ||
+        last_mode_ == kModeAccelerateLowEnergy ||
+        last_mode_ == kModeAccelerateFail ||
+        last_mode_ == kModePreemptiveExpandSuccess ||
+        last_mode_ == kModePreemptiveExpandLowEnergy ||
+        last_mode_ == kModePreemptiveExpandFail)) {
+    return nullptr;
+  }
+  const Packet* packet = packet_buffer_->PeekNextPacket();
+  // A packet of lower priority, e.g. Opus FEC, may still be replaced by the
+  // primary packet of the same timestamp.
+  if (!packet || !packet->frame || !(packet->priority == Packet::Priority()) ||
+      packet->timestamp != sync_buffer_->end_timestamp()) {
+    return nullptr;
+  }
+  AudioDecoder* decoder = decoder_database_->GetActiveDecoder();
+  if (!decoder || decoder != decoder_database_->GetDecoder(packet->payload_type))
+    return nullptr;
+  return packet;
+}
+
+void NetEqImpl::MaybeStartDecodeAhead() {
+  if (!decode_ahead_queue_ || decode_ahead_pending_ ||
+      !NextPacketToDecodeAhead()) {
+    return;
+  }
+  decode_ahead_pending_ = true;
+  decode_ahead_queue_->PostTask([this] { DecodeAhead(); });
+}
+
+void NetEqImpl::DecodeAhead() {
+  rtc::CritScope lock(&crit_sect_);
+  if (!decode_ahead_pending_)
+    return;
+  decode_ahead_pending_ = false;
+  // Packets may have been inserted since the task was posted.
+  const Packet* packet = NextPacketToDecodeAhead();
+  if (!packet)
+    return;
+  DecodedAheadPacket decoded;
+  decoded.timestamp = packet->timestamp;
+  decoded.payload_type = packet->payload_type;
+  decoded.buffer_length = decoded_buffer_length_;
+  decoded.samples.resize(decoded_buffer_length_);
+  decoded.result = packet->frame->Decode(decoded.samples);
+  decoded.samples.resize(decoded.result ? decoded.result->num_decoded_samples
+                                        : 0);
+  decoded_ahead_ = rtc::Optional<DecodedAheadPacket>(std::move(decoded));
+}
+
+void NetEqImpl::DiscardDecodedAhead(bool decoder_reset) {
+  if (!decoded_ahead_)
+    return;
+  if (!decoder_reset) {
+    LOG(LS_WARNING) << "Discarding packet decoded ahead, timestamp "
+                    << decoded_ahead_->timestamp;
+  }
+  decoded_ahead_ = rtc::Optional<DecodedAheadPacket>();
+}
+
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "webrtc/modules/audio_coding/neteq/audio_multi_vector.h"
 #include "webrtc/modules/audio_coding/neteq/defines.h"
@@ -26,6 +27,7 @@
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/optional.h"
+#include "webrtc/rtc_base/task_queue.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/typedefs.h"
 
@@ -229,6 +231,9 @@ class NetEqImpl : public webrtc::NetEq {
   // This accessor method is only intended for testing purposes.
   const SyncBuffer* sync_buffer_for_test() const;
   Operations last_operation_for_test() const;
+  // Runs a pending decode-ahead on the calling thread, and returns the number
+  // of packets whose decoded-ahead output has been used so far.
+  size_t FinishDecodeAheadForTest();
 
  protected:
   static const int kOutputSizeMs = 10;
@@ -366,6 +371,23 @@ class NetEqImpl : public webrtc::NetEq {
   // Creates DecisionLogic object with the mode given by |playout_mode_|.
   virtual void CreateDecisionLogic() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
+  // Returns the packet to decode ahead of the next GetAudio() call, or null if
+  // it is not certain that it is the next one to be given to the decoder.
+  const Packet* NextPacketToDecodeAhead() const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Schedules decoding of the next packet on |decode_ahead_queue_|.
+  void MaybeStartDecodeAhead() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Decodes the next packet into |decoded_ahead_|, if still requested.
+  void DecodeAhead() LOCKS_EXCLUDED(crit_sect_);
+
+  // Discards |decoded_ahead_| before the active decoder is used for something
+  // other than decoding that packet. The decoder state then already includes
+  // the packet, so this is logged unless the decoder is about to be reset.
+  void DiscardDecodedAhead(bool decoder_reset)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
   rtc::CriticalSection crit_sect_;
   const std::unique_ptr<TickTimer> tick_timer_ GUARDED_BY(crit_sect_);
   const std::unique_ptr<BufferLevelFilter> buffer_level_filter_
@@ -433,6 +455,22 @@ class NetEqImpl : public webrtc::NetEq {
       GUARDED_BY(crit_sect_);
   std::vector<uint32_t> last_decoded_timestamps_ GUARDED_BY(crit_sect_);
 
+  // Output of a packet that was decoded on |decode_ahead_queue_| while still
+  // in |packet_buffer_|. Used instead of decoding the packet once extracted.
+  struct DecodedAheadPacket {
+    uint32_t timestamp;
+    uint8_t payload_type;
+    size_t buffer_length;
+    rtc::Optional<AudioDecoder::EncodedAudioFrame::DecodeResult> result;
+    std::vector<int16_t> samples;
+  };
+  rtc::Optional<DecodedAheadPacket> decoded_ahead_ GUARDED_BY(crit_sect_);
+  bool decode_ahead_pending_ GUARDED_BY(crit_sect_) = false;
+  size_t decode_ahead_hits_ GUARDED_BY(crit_sect_) = 0;
+  // Declared last, so that no decode-ahead task runs while the other members
+  // are destroyed.
+  const std::unique_ptr<rtc::TaskQueue> decode_ahead_queue_;
+
  private:
   RTC_DISALLOW_COPY_AND_ASSIGN(NetEqImpl);
 };
@@ -28,6 +28,7 @@
 #include "webrtc/modules/audio_coding/neteq/sync_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/timestamp_scaler.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/rtc_base/random.h"
 #include "webrtc/rtc_base/safe_conversions.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
@@ -1517,4 +1518,100 @@ TEST_F(NetEqImplTest120ms, Accelerate) {
   EXPECT_EQ(kAccelerate, neteq_->last_operation_for_test());
 }
 
+namespace {
+
+// Decodes 20 ms packets into a series that continues from one packet to the
+// next, so that the output depends on the order of the decode calls.
+class StatefulDecoder : public AudioDecoder {
+ public:
+  int DecodeInternal(const uint8_t* encoded,
+                     size_t encoded_len,
+                     int /* sample_rate_hz */,
+                     int16_t* decoded,
+                     SpeechType* speech_type) override {
+    for (size_t i = 0; i < kSamplesPerPacket; ++i) {
+      state_ = state_ * 31 + encoded[i % encoded_len];
+      decoded[i] = static_cast<int16_t>(state_ % 8000) - 4000;
+    }
+    *speech_type = kSpeech;
+    return kSamplesPerPacket;
+  }
+
+  void Reset() override { state_ = 0; }
+  int SampleRateHz() const override { return 8000; }
+  size_t Channels() const override { return 1; }
+
+  static const size_t kSamplesPerPacket = 160;
+
+ private:
+  uint32_t state_ = 0;
+};
+
+// Plays out a stream of packets with jitter and losses, and returns the
+// output. If |finish_decode_ahead| is set, the pending decode-ahead is run
+// right after each GetAudio() call, instead of whenever the task queue gets
+// to it.
+std::vector<int16_t> PlayOutJitteryStream(bool decode_ahead,
+                                          bool finish_decode_ahead,
+                                          size_t* decode_ahead_hits) {
+  const int kNumPackets = 500;
+  const uint8_t kPayloadType = 17;
+  NetEq::Config config;
+  config.sample_rate_hz = 8000;
+  config.enable_decode_ahead = decode_ahead;
+  NetEqImpl neteq(config,
+                  NetEqImpl::Dependencies(config,
+                                          CreateBuiltinAudioDecoderFactory()));
+  StatefulDecoder decoder;
+  EXPECT_EQ(NetEq::kOK,
+            neteq.RegisterExternalDecoder(&decoder, NetEqDecoder::kDecoderPCM16B,
+                                          "stateful", kPayloadType));
+
+  // Packet n is sent in output frame 2 * n, and received up to 80 ms later.
+  Random random(4711);
+  std::vector<std::vector<int>> packets_per_frame(2 * kNumPackets + 10);
+  for (int n = 0; n < kNumPackets; ++n) {
+    if (random.Rand(0, 19) == 0)
+      continue;  // Lost.
+    packets_per_frame[2 * n + random.Rand(0, 8)].push_back(n);
+  }
+
+  std::vector<int16_t> output;
+  for (size_t frame = 0; frame < packets_per_frame.size(); ++frame) {
+    for (int n : packets_per_frame[frame]) {
+      RTPHeader rtp_header;
+      rtp_header.payloadType = kPayloadType;
+      rtp_header.sequenceNumber = static_cast<uint16_t>(n);
+      rtp_header.timestamp =
+          static_cast<uint32_t>(n * StatefulDecoder::kSamplesPerPacket);
+      rtp_header.ssrc = 0x1234;
+      const uint8_t payload[] = {static_cast<uint8_t>(n),
+                                 static_cast<uint8_t>(n >> 8), 17};
+      EXPECT_EQ(NetEq::kOK, neteq.InsertPacket(rtp_header, payload, 0));
+    }
+    AudioFrame audio_frame;
+    bool muted;
+    EXPECT_EQ(NetEq::kOK, neteq.GetAudio(&audio_frame, &muted));
+    output.insert(output.end(), audio_frame.data(),
+                  audio_frame.data() + audio_frame.samples_per_channel_);
+    if (finish_decode_ahead)
+      *decode_ahead_hits = neteq.FinishDecodeAheadForTest();
+  }
+  return output;
+}
+
+}  // namespace
+
+TEST(NetEqImplDecodeAheadTest, SameOutputAsWithoutDecodeAhead) {
+  size_t hits = 0;
+  const std::vector<int16_t> reference =
+      PlayOutJitteryStream(false, false, &hits);
+  EXPECT_EQ(0u, hits);
+  EXPECT_EQ(reference, PlayOutJitteryStream(true, true, &hits));
+  // Most packets arrive in time to be decoded ahead.
+  EXPECT_GT(hits, 250u);
+  // The output doesn't depend on when the decode-ahead tasks run.
+  EXPECT_EQ(reference, PlayOutJitteryStream(true, false, &hits));
+}
+
 }// namespace webrtc
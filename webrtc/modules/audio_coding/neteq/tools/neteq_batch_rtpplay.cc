@@ -0,0 +1,258 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/audio_coding/neteq/include/neteq.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_packet_source_input.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_simulation_batch.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/format_macros.h"
+#include "webrtc/rtc_base/stringencode.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
+DEFINE_int32(threads, 0,
+             "Number of simulation threads; 0 uses one thread per core");
+DEFINE_string(input_list, "",
+              "File with one input file name per line, simulated in addition "
+              "to the input files on the command line");
+DEFINE_string(variants, "",
+              "Semicolon separated NetEq config variants to simulate in "
+              "addition to the default config. Each variant is a comma "
+              "separated list of key=value, with the keys "
+              "max_packets_in_buffer, max_delay_ms, enable_fast_accelerate, "
+              "enable_post_decode_vad and playout_mode. Example: "
+              "\"max_delay_ms=200;enable_fast_accelerate=1\"");
+DEFINE_string(csv_file, "",
+              "Writes the results of the individual simulations to this file, "
+              "as comma separated values");
+DEFINE_int32(audio_level, 1, "Extension ID for audio level (RFC 6464)");
+DEFINE_int32(abs_send_time, 3, "Extension ID for absolute sender time");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// The default payload types of neteq_rtpplay.
+NetEqTest::DecoderMap DefaultCodecs() {
+  return {{0, std::make_pair(NetEqDecoder::kDecoderPCMu, "pcmu")},
+          {8, std::make_pair(NetEqDecoder::kDecoderPCMa, "pcma")},
+          {102, std::make_pair(NetEqDecoder::kDecoderILBC, "ilbc")},
+          {103, std::make_pair(NetEqDecoder::kDecoderISAC, "isac")},
+          {104, std::make_pair(NetEqDecoder::kDecoderISACswb, "isac-swb")},
+          {111, std::make_pair(NetEqDecoder::kDecoderOpus, "opus")},
+          {93, std::make_pair(NetEqDecoder::kDecoderPCM16B, "pcm16-nb")},
+          {94, std::make_pair(NetEqDecoder::kDecoderPCM16Bwb, "pcm16-wb")},
+          {95,
+           std::make_pair(NetEqDecoder::kDecoderPCM16Bswb32kHz, "pcm16-swb32")},
+          {96,
+           std::make_pair(NetEqDecoder::kDecoderPCM16Bswb48kHz, "pcm16-swb48")},
+          {9, std::make_pair(NetEqDecoder::kDecoderG722, "g722")},
+          {106, std::make_pair(NetEqDecoder::kDecoderAVT, "avt")},
+          {114, std::make_pair(NetEqDecoder::kDecoderAVT16kHz, "avt-16")},
+          {115, std::make_pair(NetEqDecoder::kDecoderAVT32kHz, "avt-32")},
+          {116, std::make_pair(NetEqDecoder::kDecoderAVT48kHz, "avt-48")},
+          {117, std::make_pair(NetEqDecoder::kDecoderRED, "red")},
+          {13, std::make_pair(NetEqDecoder::kDecoderCNGnb, "cng-nb")},
+          {98, std::make_pair(NetEqDecoder::kDecoderCNGwb, "cng-wb")},
+          {99, std::make_pair(NetEqDecoder::kDecoderCNGswb32kHz, "cng-swb32")},
+          {100,
+           std::make_pair(NetEqDecoder::kDecoderCNGswb48kHz, "cng-swb48")}};
+}
+
+// Parses a variant in the format of --variants into |config|. Returns false
+// if the variant has an unknown key or an invalid value.
+bool ParseVariant(const std::string& variant, NetEq::Config* config) {
+  std::vector<std::string> settings;
+  rtc::split(variant, ',', &settings);
+  for (const std::string& setting : settings) {
+    std::vector<std::string> key_value;
+    if (rtc::split(setting, '=', &key_value) != 2)
+      return false;
+    const std::string& key = key_value[0];
+    const std::string& value = key_value[1];
+    int int_value;
+    if (!rtc::FromString(value, &int_value))
+      return false;
+    if (key == "max_packets_in_buffer" && int_value > 0) {
+      config->max_packets_in_buffer = static_cast<size_t>(int_value);
+    } else if (key == "max_delay_ms" && int_value >= 0) {
+      config->max_delay_ms = int_value;
+    } else if (key == "enable_fast_accelerate") {
+      config->enable_fast_accelerate = int_value != 0;
+    } else if (key == "enable_post_decode_vad") {
+      config->enable_post_decode_vad = int_value != 0;
+    } else if (key == "playout_mode" && int_value >= kPlayoutOn &&
+               int_value <= kPlayoutStreaming) {
+      config->playout_mode = static_cast<NetEqPlayoutMode>(int_value);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PrintSummary(const NetEqSimulationBatch::VariantSummary& summary) {
+  printf("Variant \"%s\":\n", summary.name.c_str());
+  printf("  simulations: %" PRIuS "\n", summary.num_simulations);
+  printf("  output duration: %" PRId64 " ms\n", summary.total_duration_ms);
+  printf("  errors: %d\n", summary.num_errors);
+  printf("  packet_loss_rate: %f %%\n", 100.0 * summary.packet_loss_rate);
+  printf("  expand_rate: %f %%\n", 100.0 * summary.expand_rate);
+  printf("  speech_expand_rate: %f %%\n", 100.0 * summary.speech_expand_rate);
+  printf("  preemptive_rate: %f %%\n", 100.0 * summary.preemptive_rate);
+  printf("  accelerate_rate: %f %%\n", 100.0 * summary.accelerate_rate);
+  printf("  secondary_decoded_rate: %f %%\n",
+         100.0 * summary.secondary_decoded_rate);
+  printf("  current_buffer_size_ms: %f ms\n", summary.current_buffer_size_ms);
+  printf("  preferred_buffer_size_ms: %f ms\n",
+         summary.preferred_buffer_size_ms);
+  printf("  mean_waiting_time_ms: %f ms\n", summary.mean_waiting_time_ms);
+  printf("  max_waiting_time_ms: %d ms\n", summary.max_waiting_time_ms);
+  printf("  mean_playout_delay_ms: %f ms\n", summary.mean_playout_delay_ms);
+  printf("  max_playout_delay_ms: %f ms\n", summary.max_playout_delay_ms);
+  printf("  mean_target_delay_ms: %f ms\n", summary.mean_target_delay_ms);
+}
+
+void WriteCsv(const std::string& file_name,
+              const std::vector<NetEqSimulationBatch::Input>& inputs,
+              const std::vector<NetEqSimulationBatch::ConfigVariant>& variants,
+              const std::vector<NetEqSimulationBatch::SimulationResult>&
+                  results) {
+  std::ofstream csv(file_name);
+  RTC_CHECK(csv.is_open()) << "Cannot open " << file_name;
+  csv << "input,variant,duration_ms,errors,packet_loss_rate,expand_rate,"
+         "speech_expand_rate,preemptive_rate,accelerate_rate,"
+         "current_buffer_size_ms,preferred_buffer_size_ms,"
+         "mean_waiting_time_ms,max_waiting_time_ms,mean_playout_delay_ms,"
+         "max_playout_delay_ms,mean_target_delay_ms\n";
+  for (const auto& result : results) {
+    const NetEqNetworkStatistics& stats = result.stats;
+    // The variant names contain commas, so the names are quoted.
+    csv << "\"" << inputs[result.input_index].name << "\",\""
+        << variants[result.variant_index].name << "\"," << result.duration_ms
+        << ","
+        << result.num_insert_packet_errors + result.num_get_audio_errors
+        << "," << stats.packet_loss_rate / 16384.0 << ","
+        << stats.expand_rate / 16384.0 << ","
+        << stats.speech_expand_rate / 16384.0 << ","
+        << stats.preemptive_rate / 16384.0 << ","
+        << stats.accelerate_rate / 16384.0 << ","
+        << stats.current_buffer_size_ms << ","
+        << stats.preferred_buffer_size_ms << ","
+        << stats.mean_waiting_time_ms << "," << stats.max_waiting_time_ms
+        << "," << result.mean_playout_delay_ms << ","
+        << result.max_playout_delay_ms << "," << result.mean_target_delay_ms
+        << "\n";
+  }
+}
+
+int RunBatch(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Tool for simulating many RTP dump or event log files with NetEq, "
+      "using several NetEq configs.\n"
+      "Run " + program_name + " --helpshort for usage.\n"
+      "Example usage:\n" + program_name +
+      " --variants=\"max_delay_ms=200\" input1.rtp input2.log\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::vector<std::string> file_names(argv + 1, argv + argc);
+  if (!FLAGS_input_list.empty()) {
+    std::ifstream input_list(FLAGS_input_list);
+    RTC_CHECK(input_list.is_open()) << "Cannot open " << FLAGS_input_list;
+    std::string line;
+    while (std::getline(input_list, line)) {
+      if (!line.empty())
+        file_names.push_back(line);
+    }
+  }
+  if (file_names.empty()) {
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+
+  const NetEqPacketSourceInput::RtpHeaderExtensionMap rtp_ext_map = {
+      {FLAGS_audio_level, kRtpExtensionAudioLevel},
+      {FLAGS_abs_send_time, kRtpExtensionAbsoluteSendTime}};
+  std::vector<NetEqSimulationBatch::Input> inputs;
+  for (const std::string& file_name : file_names) {
+    NetEqSimulationBatch::Input input;
+    input.name = file_name;
+    if (RtpFileSource::ValidRtpDump(file_name) ||
+        RtpFileSource::ValidPcap(file_name)) {
+      input.create = [file_name, rtp_ext_map] {
+        return std::unique_ptr<NetEqInput>(
+            new NetEqRtpDumpInput(file_name, rtp_ext_map));
+      };
+    } else {
+      input.create = [file_name, rtp_ext_map] {
+        return std::unique_ptr<NetEqInput>(
+            new NetEqEventLogInput(file_name, rtp_ext_map));
+      };
+    }
+    inputs.push_back(std::move(input));
+  }
+
+  std::vector<NetEqSimulationBatch::ConfigVariant> variants(1);
+  variants[0].name = "default";
+  std::vector<std::string> variant_strings;
+  rtc::split(FLAGS_variants, ';', &variant_strings);
+  for (const std::string& variant_string : variant_strings) {
+    if (variant_string.empty())
+      continue;
+    NetEqSimulationBatch::ConfigVariant variant;
+    variant.name = variant_string;
+    if (!ParseVariant(variant_string, &variant.config)) {
+      std::cout << "Invalid variant: " << variant_string << std::endl;
+      return 1;
+    }
+    variants.push_back(variant);
+  }
+
+  const size_t num_threads =
+      FLAGS_threads > 0 ? static_cast<size_t>(FLAGS_threads)
+                        : std::max<uint32_t>(CpuInfo::DetectNumberOfCores(), 1);
+  std::cout << "Simulating " << inputs.size() << " inputs with "
+            << variants.size() << " variants on " << num_threads
+            << " threads" << std::endl;
+
+  NetEqSimulationBatch batch(DefaultCodecs(), num_threads);
+  const std::vector<NetEqSimulationBatch::SimulationResult> results =
+      batch.Run(inputs, variants);
+
+  for (const auto& summary :
+       NetEqSimulationBatch::Summarize(variants, results)) {
+    PrintSummary(summary);
+  }
+  if (!FLAGS_csv_file.empty())
+    WriteCsv(FLAGS_csv_file, inputs, variants, results);
+
+  return 0;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  return webrtc::test::RunBatch(argc, argv);
+}
@@ -0,0 +1,208 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_simulation_batch.h"
+
+#include <algorithm>
+
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_delay_analyzer.h"
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/platform_thread.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// Counts the errors instead of crashing like DefaultNetEqTestErrorCallback,
+// since one broken input should not end the whole batch.
+class CountingErrorCallback : public NetEqTestErrorCallback {
+ public:
+  void OnInsertPacketError(const NetEqInput::PacketData& packet) override {
+    ++num_insert_packet_errors;
+  }
+  void OnGetAudioError() override { ++num_get_audio_errors; }
+
+  int num_insert_packet_errors = 0;
+  int num_get_audio_errors = 0;
+};
+
+double Q14ToFraction(uint16_t value) {
+  return value / 16384.0;
+}
+
+}  // namespace
+
+NetEqSimulationBatch::NetEqSimulationBatch(const NetEqTest::DecoderMap& codecs,
+                                           size_t num_threads)
+    : codecs_(codecs), num_threads_(num_threads) {
+  RTC_DCHECK_GE(num_threads, 1);
+}
+
+NetEqSimulationBatch::~NetEqSimulationBatch() = default;
+
+std::vector<NetEqSimulationBatch::SimulationResult> NetEqSimulationBatch::Run(
+    const std::vector<Input>& inputs,
+    const std::vector<ConfigVariant>& variants) {
+  inputs_ = &inputs;
+  variants_ = &variants;
+  results_.assign(inputs.size() * variants.size(), SimulationResult());
+  for (size_t i = 0; i < results_.size(); ++i) {
+    results_[i].input_index = i / variants.size();
+    results_[i].variant_index = i % variants.size();
+  }
+  next_simulation_ = 0;
+
+  // The calling thread runs simulations too.
+  const size_t num_started =
+      std::min(num_threads_ - 1, results_.empty() ? 0 : results_.size() - 1);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < num_started; ++i) {
+    threads.emplace_back(new rtc::PlatformThread(
+        &NetEqSimulationBatch::RunThread, this, "NetEqSimulation",
+        rtc::kNormalPriority));
+    threads.back()->Start();
+  }
+  RunPendingSimulations();
+  for (auto& thread : threads)
+    thread->Stop();
+
+  inputs_ = nullptr;
+  variants_ = nullptr;
+  return std::move(results_);
+}
+
+void NetEqSimulationBatch::RunThread(void* obj) {
+  static_cast<NetEqSimulationBatch*>(obj)->RunPendingSimulations();
+}
+
+void NetEqSimulationBatch::RunPendingSimulations() {
+  const int num_simulations = static_cast<int>(results_.size());
+  while (true) {
+    const int index = rtc::AtomicOps::Increment(&next_simulation_) - 1;
+    if (index >= num_simulations)
+      return;
+    RunSimulation(&results_[index]);
+  }
+}
+
+void NetEqSimulationBatch::RunSimulation(SimulationResult* result) {
+  std::unique_ptr<NetEqInput> input =
+      (*inputs_)[result->input_index].create();
+  if (!input || input->ended())
+    return;
+
+  CountingErrorCallback error_callback;
+  NetEqDelayAnalyzer delay_analyzer;
+  NetEqTest::Callbacks callbacks;
+  callbacks.error_callback = &error_callback;
+  callbacks.post_insert_packet = &delay_analyzer;
+  callbacks.get_audio_callback = &delay_analyzer;
+  NetEqTest test((*variants_)[result->variant_index].config, codecs_,
+                 NetEqTest::ExtDecoderMap(), std::move(input), nullptr,
+                 callbacks);
+  result->duration_ms = test.Run();
+  result->stats = test.SimulationStats();
+  result->num_insert_packet_errors = error_callback.num_insert_packet_errors;
+  result->num_get_audio_errors = error_callback.num_get_audio_errors;
+
+  std::vector<float> send_time_s;
+  std::vector<float> arrival_delay_ms;
+  std::vector<float> corrected_arrival_delay_ms;
+  std::vector<rtc::Optional<float>> playout_delay_ms;
+  std::vector<rtc::Optional<float>> target_delay_ms;
+  delay_analyzer.CreateGraphs(&send_time_s, &arrival_delay_ms,
+                              &corrected_arrival_delay_ms, &playout_delay_ms,
+                              &target_delay_ms);
+  RTC_DCHECK_EQ(playout_delay_ms.size(), target_delay_ms.size());
+  double playout_delay_sum_ms = 0.0;
+  double target_delay_sum_ms = 0.0;
+  for (size_t i = 0; i < playout_delay_ms.size(); ++i) {
+    if (!playout_delay_ms[i] || !target_delay_ms[i])
+      continue;
+    playout_delay_sum_ms += *playout_delay_ms[i];
+    target_delay_sum_ms += *target_delay_ms[i];
+    result->max_playout_delay_ms =
+        std::max(result->max_playout_delay_ms, *playout_delay_ms[i]);
+    ++result->num_played_packets;
+  }
+  if (result->num_played_packets > 0) {
+    result->mean_playout_delay_ms = static_cast<float>(
+        playout_delay_sum_ms / result->num_played_packets);
+    result->mean_target_delay_ms =
+        static_cast<float>(target_delay_sum_ms / result->num_played_packets);
+  }
+}
+
+std::vector<NetEqSimulationBatch::VariantSummary>
+NetEqSimulationBatch::Summarize(const std::vector<ConfigVariant>& variants,
+                                const std::vector<SimulationResult>& results) {
+  std::vector<VariantSummary> summaries(variants.size());
+  std::vector<size_t> num_played_packets(variants.size(), 0);
+  for (size_t k = 0; k < variants.size(); ++k)
+    summaries[k].name = variants[k].name;
+
+  for (const SimulationResult& result : results) {
+    RTC_DCHECK_LT(result.variant_index, variants.size());
+    VariantSummary& summary = summaries[result.variant_index];
+    const NetEqNetworkStatistics& stats = result.stats;
+    const double weight = static_cast<double>(result.duration_ms);
+    ++summary.num_simulations;
+    summary.total_duration_ms += result.duration_ms;
+    summary.packet_loss_rate += weight * Q14ToFraction(stats.packet_loss_rate);
+    summary.expand_rate += weight * Q14ToFraction(stats.expand_rate);
+    summary.speech_expand_rate +=
+        weight * Q14ToFraction(stats.speech_expand_rate);
+    summary.preemptive_rate += weight * Q14ToFraction(stats.preemptive_rate);
+    summary.accelerate_rate += weight * Q14ToFraction(stats.accelerate_rate);
+    summary.secondary_decoded_rate +=
+        weight * Q14ToFraction(stats.secondary_decoded_rate);
+    summary.current_buffer_size_ms += weight * stats.current_buffer_size_ms;
+    summary.preferred_buffer_size_ms +=
+        weight * stats.preferred_buffer_size_ms;
+    summary.mean_waiting_time_ms += weight * stats.mean_waiting_time_ms;
+    summary.max_waiting_time_ms =
+        std::max(summary.max_waiting_time_ms, stats.max_waiting_time_ms);
+
+    summary.mean_playout_delay_ms +=
+        result.num_played_packets * result.mean_playout_delay_ms;
+    summary.mean_target_delay_ms +=
+        result.num_played_packets * result.mean_target_delay_ms;
+    num_played_packets[result.variant_index] += result.num_played_packets;
+    summary.max_playout_delay_ms =
+        std::max(summary.max_playout_delay_ms, result.max_playout_delay_ms);
+    summary.num_errors +=
+        result.num_insert_packet_errors + result.num_get_audio_errors;
+  }
+
+  for (size_t k = 0; k < summaries.size(); ++k) {
+    VariantSummary& summary = summaries[k];
+    if (summary.total_duration_ms > 0) {
+      const double total = static_cast<double>(summary.total_duration_ms);
+      summary.packet_loss_rate /= total;
+      summary.expand_rate /= total;
+      summary.speech_expand_rate /= total;
+      summary.preemptive_rate /= total;
+      summary.accelerate_rate /= total;
+      summary.secondary_decoded_rate /= total;
+      summary.current_buffer_size_ms /= total;
+      summary.preferred_buffer_size_ms /= total;
+      summary.mean_waiting_time_ms /= total;
+    }
+    if (num_played_packets[k] > 0) {
+      summary.mean_playout_delay_ms /= num_played_packets[k];
+      summary.mean_target_delay_ms /= num_played_packets[k];
+    }
+  }
+  return summaries;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_SIMULATION_BATCH_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_SIMULATION_BATCH_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/modules/audio_coding/neteq/include/neteq.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_input.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_test.h"
+#include "webrtc/rtc_base/constructormagic.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs many NetEq simulations in parallel, to compare NetEq::Config variants
+// over a large set of recorded calls. Each input is simulated once with each
+// variant, and the simulations are spread over a fixed number of threads. The
+// results are reported per simulation, and can be aggregated per variant with
+// Summarize().
+class NetEqSimulationBatch {
+ public:
+  // Creates the input of one simulation. Called once per input and variant,
+  // on the simulation threads; must not share state between the inputs it
+  // returns.
+  using InputFactory = std::function<std::unique_ptr<NetEqInput>()>;
+
+  struct Input {
+    std::string name;
+    InputFactory create;
+  };
+
+  struct ConfigVariant {
+    std::string name;
+    NetEq::Config config;
+  };
+
+  struct SimulationResult {
+    size_t input_index = 0;
+    size_t variant_index = 0;
+    // Duration of the produced audio.
+    int64_t duration_ms = 0;
+    // Statistics from NetEq at the end of the simulation, i.e., covering the
+    // whole simulation.
+    NetEqNetworkStatistics stats = NetEqNetworkStatistics();
+    // From NetEqDelayAnalyzer, over the packets that were played out.
+    float mean_playout_delay_ms = 0.f;
+    float max_playout_delay_ms = 0.f;
+    float mean_target_delay_ms = 0.f;
+    size_t num_played_packets = 0;
+    int num_insert_packet_errors = 0;
+    int num_get_audio_errors = 0;
+  };
+
+  struct VariantSummary {
+    std::string name;
+    size_t num_simulations = 0;
+    int64_t total_duration_ms = 0;
+    // Averages over the simulations weighted with their duration. The rates
+    // are fractions, not Q14.
+    double packet_loss_rate = 0.0;
+    double expand_rate = 0.0;
+    double speech_expand_rate = 0.0;
+    double preemptive_rate = 0.0;
+    double accelerate_rate = 0.0;
+    double secondary_decoded_rate = 0.0;
+    double current_buffer_size_ms = 0.0;
+    double preferred_buffer_size_ms = 0.0;
+    double mean_waiting_time_ms = 0.0;
+    // Averages over the played packets of all simulations.
+    double mean_playout_delay_ms = 0.0;
+    double mean_target_delay_ms = 0.0;
+    // Maxima over all simulations.
+    int max_waiting_time_ms = 0;
+    float max_playout_delay_ms = 0.f;
+    int num_errors = 0;
+  };
+
+  // Uses |num_threads| threads for the simulations. All simulations register
+  // the decoders in |codecs|.
+  NetEqSimulationBatch(const NetEqTest::DecoderMap& codecs,
+                       size_t num_threads);
+  ~NetEqSimulationBatch();
+
+  // Simulates each of |inputs| with each of |variants|. Returns when all
+  // simulations are done, with the results ordered by input and then by
+  // variant.
+  std::vector<SimulationResult> Run(const std::vector<Input>& inputs,
+                                    const std::vector<ConfigVariant>& variants);
+
+  // Aggregates |results| per variant. The returned vector has the same order
+  // as |variants|.
+  static std::vector<VariantSummary> Summarize(
+      const std::vector<ConfigVariant>& variants,
+      const std::vector<SimulationResult>& results);
+
+ private:
+  // Runs simulations of the current batch until none are left. Called on each
+  // of the simulation threads.
+  static void RunThread(void* obj);
+  void RunPendingSimulations();
+  void RunSimulation(SimulationResult* result);
+
+  const NetEqTest::DecoderMap codecs_;
+  const size_t num_threads_;
+
+  // The current batch. Written before the threads are started and only read
+  // until they are stopped, except for the results, which each thread writes
+  // for the simulations it takes.
+  const std::vector<Input>* inputs_ = nullptr;
+  const std::vector<ConfigVariant>* variants_ = nullptr;
+  std::vector<SimulationResult> results_;
+  volatile int next_simulation_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetEqSimulationBatch);
+};
+
+}  // namespace test
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_SIMULATION_BATCH_H_
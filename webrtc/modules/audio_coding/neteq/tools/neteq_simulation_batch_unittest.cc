@@ -0,0 +1,254 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_simulation_batch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const int kPayloadType = 93;
+const int kSampleRateHz = 8000;
+const int kPacketMs = 20;
+const size_t kSamplesPerPacket = kSampleRateHz * kPacketMs / 1000;
+const int64_t kOutputPeriodMs = 10;
+
+// Produces a 20 ms PCM16b sine wave stream with random network jitter.
+class JitteryPcm16bInput : public NetEqInput {
+ public:
+  JitteryPcm16bInput(uint64_t seed, int max_jitter_ms, int64_t duration_ms)
+      : random_(seed), max_jitter_ms_(max_jitter_ms), duration_ms_(duration_ms) {
+    CreatePacket();
+  }
+
+  rtc::Optional<int64_t> NextPacketTime() const override {
+    if (!packet_)
+      return rtc::Optional<int64_t>();
+    return rtc::Optional<int64_t>(static_cast<int64_t>(packet_->time_ms));
+  }
+
+  rtc::Optional<int64_t> NextOutputEventTime() const override {
+    return rtc::Optional<int64_t>(next_output_event_ms_);
+  }
+
+  std::unique_ptr<PacketData> PopPacket() override {
+    std::unique_ptr<PacketData> packet = std::move(packet_);
+    CreatePacket();
+    return packet;
+  }
+
+  void AdvanceOutputEvent() override { next_output_event_ms_ += kOutputPeriodMs; }
+
+  bool ended() const override { return next_output_event_ms_ > duration_ms_; }
+
+  rtc::Optional<RTPHeader> NextHeader() const override {
+    if (!packet_)
+      return rtc::Optional<RTPHeader>();
+    return rtc::Optional<RTPHeader>(packet_->header);
+  }
+
+ private:
+  void CreatePacket() {
+    const int64_t send_time_ms = sequence_number_ * kPacketMs;
+    if (send_time_ms >= duration_ms_)
+      return;
+    packet_.reset(new PacketData);
+    packet_->header.payloadType = kPayloadType;
+    packet_->header.sequenceNumber = sequence_number_;
+    packet_->header.timestamp =
+        static_cast<uint32_t>(sequence_number_ * kSamplesPerPacket);
+    packet_->header.ssrc = 0x1234;
+    packet_->payload.SetSize(2 * kSamplesPerPacket);
+    for (size_t i = 0; i < kSamplesPerPacket; ++i) {
+      const int16_t sample = static_cast<int16_t>(
+          8000 * std::sin(0.1 * (packet_->header.timestamp + i)));
+      packet_->payload[2 * i] = static_cast<uint8_t>(sample >> 8);
+      packet_->payload[2 * i + 1] = static_cast<uint8_t>(sample);
+    }
+    // Keep the arrival times in order.
+    last_arrival_time_ms_ =
+        std::max(last_arrival_time_ms_,
+                 send_time_ms + random_.Rand(0, max_jitter_ms_));
+    packet_->time_ms = static_cast<double>(last_arrival_time_ms_);
+    ++sequence_number_;
+  }
+
+  Random random_;
+  const int max_jitter_ms_;
+  const int64_t duration_ms_;
+  std::unique_ptr<PacketData> packet_;
+  uint16_t sequence_number_ = 0;
+  int64_t last_arrival_time_ms_ = 0;
+  int64_t next_output_event_ms_ = 0;
+};
+
+NetEqTest::DecoderMap Codecs() {
+  return {{kPayloadType,
+           std::make_pair(NetEqDecoder::kDecoderPCM16B, "pcm16-nb")}};
+}
+
+std::vector<NetEqSimulationBatch::Input> CreateInputs() {
+  std::vector<NetEqSimulationBatch::Input> inputs;
+  for (int k = 0; k < 5; ++k) {
+    inputs.push_back({"input" + std::to_string(k), [k] {
+                        return std::unique_ptr<NetEqInput>(
+                            new JitteryPcm16bInput(k + 1, 20 + 40 * k, 3000));
+                      }});
+  }
+  return inputs;
+}
+
+std::vector<NetEqSimulationBatch::ConfigVariant> CreateVariants() {
+  std::vector<NetEqSimulationBatch::ConfigVariant> variants(2);
+  variants[0].name = "default";
+  variants[1].name = "fast_accelerate";
+  variants[1].config.enable_fast_accelerate = true;
+  variants[1].config.max_packets_in_buffer = 10;
+  return variants;
+}
+
+void ExpectSameResult(const NetEqSimulationBatch::SimulationResult& expected,
+                      const NetEqSimulationBatch::SimulationResult& actual) {
+  EXPECT_EQ(expected.input_index, actual.input_index);
+  EXPECT_EQ(expected.variant_index, actual.variant_index);
+  EXPECT_EQ(expected.duration_ms, actual.duration_ms);
+  EXPECT_EQ(expected.stats.current_buffer_size_ms,
+            actual.stats.current_buffer_size_ms);
+  EXPECT_EQ(expected.stats.preferred_buffer_size_ms,
+            actual.stats.preferred_buffer_size_ms);
+  EXPECT_EQ(expected.stats.expand_rate, actual.stats.expand_rate);
+  EXPECT_EQ(expected.stats.accelerate_rate, actual.stats.accelerate_rate);
+  EXPECT_EQ(expected.stats.preemptive_rate, actual.stats.preemptive_rate);
+  EXPECT_EQ(expected.stats.mean_waiting_time_ms,
+            actual.stats.mean_waiting_time_ms);
+  EXPECT_EQ(expected.mean_playout_delay_ms, actual.mean_playout_delay_ms);
+  EXPECT_EQ(expected.max_playout_delay_ms, actual.max_playout_delay_ms);
+  EXPECT_EQ(expected.mean_target_delay_ms, actual.mean_target_delay_ms);
+  EXPECT_EQ(expected.num_played_packets, actual.num_played_packets);
+}
+
+}  // namespace
+
+TEST(NetEqSimulationBatchTest, MultipleThreadsMatchSingleThread) {
+  const std::vector<NetEqSimulationBatch::Input> inputs = CreateInputs();
+  const std::vector<NetEqSimulationBatch::ConfigVariant> variants =
+      CreateVariants();
+
+  NetEqSimulationBatch single_thread(Codecs(), 1);
+  const std::vector<NetEqSimulationBatch::SimulationResult> expected =
+      single_thread.Run(inputs, variants);
+  NetEqSimulationBatch multiple_threads(Codecs(), 4);
+  const std::vector<NetEqSimulationBatch::SimulationResult> actual =
+      multiple_threads.Run(inputs, variants);
+
+  ASSERT_EQ(inputs.size() * variants.size(), expected.size());
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(i / variants.size(), actual[i].input_index);
+    EXPECT_EQ(i % variants.size(), actual[i].variant_index);
+    EXPECT_LT(2900, actual[i].duration_ms);
+    EXPECT_LT(0u, actual[i].num_played_packets);
+    EXPECT_EQ(0, actual[i].num_insert_packet_errors);
+    EXPECT_EQ(0, actual[i].num_get_audio_errors);
+    ExpectSameResult(expected[i], actual[i]);
+  }
+}
+
+TEST(NetEqSimulationBatchTest, ReusedForSeveralBatches) {
+  const std::vector<NetEqSimulationBatch::Input> inputs = CreateInputs();
+  const std::vector<NetEqSimulationBatch::ConfigVariant> variants =
+      CreateVariants();
+  NetEqSimulationBatch batch(Codecs(), 3);
+  const std::vector<NetEqSimulationBatch::SimulationResult> first =
+      batch.Run(inputs, variants);
+  const std::vector<NetEqSimulationBatch::SimulationResult> second =
+      batch.Run(inputs, variants);
+  ASSERT_EQ(first.size(), second.size());
+  for (size_t i = 0; i < first.size(); ++i)
+    ExpectSameResult(first[i], second[i]);
+}
+
+TEST(NetEqSimulationBatchTest, EmptyBatch) {
+  NetEqSimulationBatch batch(Codecs(), 3);
+  EXPECT_TRUE(batch.Run(std::vector<NetEqSimulationBatch::Input>(),
+                        CreateVariants())
+                  .empty());
+  EXPECT_TRUE(batch.Run(CreateInputs(),
+                        std::vector<NetEqSimulationBatch::ConfigVariant>())
+                  .empty());
+}
+
+TEST(NetEqSimulationBatchTest, SkipsEmptyInputs) {
+  std::vector<NetEqSimulationBatch::Input> inputs = {
+      {"null", [] { return std::unique_ptr<NetEqInput>(); }}};
+  NetEqSimulationBatch batch(Codecs(), 2);
+  const std::vector<NetEqSimulationBatch::SimulationResult> results =
+      batch.Run(inputs, CreateVariants());
+  ASSERT_EQ(2u, results.size());
+  for (const auto& result : results) {
+    EXPECT_EQ(0, result.duration_ms);
+    EXPECT_EQ(0u, result.num_played_packets);
+  }
+}
+
+TEST(NetEqSimulationBatchTest, SummaryWeightsWithDuration) {
+  const std::vector<NetEqSimulationBatch::ConfigVariant> variants =
+      CreateVariants();
+  std::vector<NetEqSimulationBatch::SimulationResult> results(3);
+  results[0].variant_index = 0;
+  results[0].duration_ms = 1000;
+  results[0].stats.expand_rate = 1 << 14;  // 100 %.
+  results[0].stats.current_buffer_size_ms = 40;
+  results[0].stats.max_waiting_time_ms = 100;
+  results[0].num_played_packets = 10;
+  results[0].mean_playout_delay_ms = 60.f;
+  results[0].max_playout_delay_ms = 80.f;
+  results[0].num_insert_packet_errors = 1;
+  results[1].variant_index = 0;
+  results[1].duration_ms = 3000;
+  results[1].stats.expand_rate = 0;
+  results[1].stats.current_buffer_size_ms = 80;
+  results[1].stats.max_waiting_time_ms = 50;
+  results[1].num_played_packets = 30;
+  results[1].mean_playout_delay_ms = 100.f;
+  results[1].max_playout_delay_ms = 120.f;
+  results[1].num_get_audio_errors = 2;
+  results[2].variant_index = 1;
+  results[2].duration_ms = 500;
+  results[2].stats.accelerate_rate = 1 << 13;  // 50 %.
+
+  const std::vector<NetEqSimulationBatch::VariantSummary> summaries =
+      NetEqSimulationBatch::Summarize(variants, results);
+  ASSERT_EQ(2u, summaries.size());
+  EXPECT_EQ("default", summaries[0].name);
+  EXPECT_EQ(2u, summaries[0].num_simulations);
+  EXPECT_EQ(4000, summaries[0].total_duration_ms);
+  EXPECT_DOUBLE_EQ(0.25, summaries[0].expand_rate);
+  EXPECT_DOUBLE_EQ(70.0, summaries[0].current_buffer_size_ms);
+  EXPECT_EQ(100, summaries[0].max_waiting_time_ms);
+  EXPECT_DOUBLE_EQ(90.0, summaries[0].mean_playout_delay_ms);
+  EXPECT_EQ(120.f, summaries[0].max_playout_delay_ms);
+  EXPECT_EQ(3, summaries[0].num_errors);
+
+  EXPECT_EQ("fast_accelerate", summaries[1].name);
+  EXPECT_EQ(1u, summaries[1].num_simulations);
+  EXPECT_DOUBLE_EQ(0.5, summaries[1].accelerate_rate);
+  EXPECT_DOUBLE_EQ(0.0, summaries[1].mean_playout_delay_ms);
+}
+
+}  // namespace test
+}  // namespace webrtc
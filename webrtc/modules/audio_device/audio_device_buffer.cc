@@ -37,6 +37,10 @@ static const size_t kTimerIntervalInMilliseconds =
 static const size_t kMinValidCallTimeTimeInSeconds = 10;
 static const size_t kMinValidCallTimeTimeInMilliseconds =
     kMinValidCallTimeTimeInSeconds * rtc::kNumMillisecsPerSec;
+// Number of samples allocated up front for each of the playout and recording
+// buffers. Corresponds to 10ms of stereo audio at 96kHz.
+static const size_t kPreallocatedBufferSizeInSamples =
+    kMaxBufferSizeBytes / sizeof(int16_t);
 #ifdef AUDIO_DEVICE_PLAYS_SINUS_TONE
 static const double k2Pi = 6.28318530717959;
 #endif
@@ -50,6 +54,8 @@ AudioDeviceBuffer::AudioDeviceBuffer()
       play_channels_(0),
       playing_(false),
       recording_(false),
+      play_buffer_(0, kPreallocatedBufferSizeInSamples),
+      rec_buffer_(0, kPreallocatedBufferSizeInSamples),
       current_mic_level_(0),
       new_mic_level_(0),
       typing_status_(false),
@@ -313,6 +319,9 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audio_buffer,
   // size changes, which is a rare event.
   if (old_size != rec_buffer_.size()) {
     LOG(LS_INFO) << "Size of recording buffer: " << rec_buffer_.size();
+    if (rec_buffer_.size() > kPreallocatedBufferSizeInSamples) {
+      LOG(LS_WARNING) << "Recording buffer was reallocated on the audio thread";
+    }
   }
 
   // Derive a new level value twice per second and check if it is non-zero.
@@ -366,6 +375,9 @@ int32_t AudioDeviceBuffer::RequestPlayoutData(size_t samples_per_channel) {
   if (play_buffer_.size() != total_samples) {
     play_buffer_.SetSize(total_samples);
     LOG(LS_INFO) << "Size of playout buffer: " << play_buffer_.size();
+    if (total_samples > kPreallocatedBufferSizeInSamples) {
+      LOG(LS_WARNING) << "Playout buffer was reallocated on the audio thread";
+    }
   }
 
   size_t num_samples_out(0);
@@ -457,13 +469,7 @@ void AudioDeviceBuffer::LogStats(LogState state) {
   int64_t time_since_last = rtc::TimeDiff(now_time, last_timer_task_time_);
   last_timer_task_time_ = now_time;
 
-  Stats stats;
-  {
-    rtc::CritScope cs(&lock_);
-    stats = stats_;
-    stats_.max_rec_level = 0;
-    stats_.max_play_level = 0;
-  }
+  const Stats stats = TakeStats();
 
   // Log the latest statistics but skip the first round just after state was
   // set to LOG_START. Hence, first printed log will be after ~10 seconds.
@@ -499,37 +505,70 @@ void AudioDeviceBuffer::LogStats(LogState state) {
 
 void AudioDeviceBuffer::ResetRecStats() {
   RTC_DCHECK_RUN_ON(&task_queue_);
-  last_stats_.ResetRecStats();
-  rtc::CritScope cs(&lock_);
-  stats_.ResetRecStats();
+  last_stats_.rec_callbacks =
+      live_stats_.rec_callbacks.load(std::memory_order_relaxed);
+  last_stats_.rec_samples =
+      live_stats_.rec_samples.load(std::memory_order_relaxed);
+  last_stats_.max_rec_level = 0;
+  live_stats_.max_rec_level.store(0, std::memory_order_relaxed);
 }
 
 void AudioDeviceBuffer::ResetPlayStats() {
   RTC_DCHECK_RUN_ON(&task_queue_);
-  last_stats_.ResetPlayStats();
-  rtc::CritScope cs(&lock_);
-  stats_.ResetPlayStats();
+  last_stats_.play_callbacks =
+      live_stats_.play_callbacks.load(std::memory_order_relaxed);
+  last_stats_.play_samples =
+      live_stats_.play_samples.load(std::memory_order_relaxed);
+  last_stats_.max_play_level = 0;
+  live_stats_.max_play_level.store(0, std::memory_order_relaxed);
 }
 
+AudioDeviceBuffer::Stats AudioDeviceBuffer::TakeStats() {
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  Stats stats;
+  stats.rec_callbacks =
+      live_stats_.rec_callbacks.load(std::memory_order_relaxed);
+  stats.play_callbacks =
+      live_stats_.play_callbacks.load(std::memory_order_relaxed);
+  stats.rec_samples = live_stats_.rec_samples.load(std::memory_order_relaxed);
+  stats.play_samples =
+      live_stats_.play_samples.load(std::memory_order_relaxed);
+  stats.max_rec_level =
+      live_stats_.max_rec_level.exchange(0, std::memory_order_relaxed);
+  stats.max_play_level =
+      live_stats_.max_play_level.exchange(0, std::memory_order_relaxed);
+  return stats;
+}
+
+// The counters below have a single writer each, hence plain loads and stores
+// suffice and the audio thread never has to retry or wait.
 void AudioDeviceBuffer::UpdateRecStats(int16_t max_abs,
                                        size_t samples_per_channel) {
   RTC_DCHECK_RUN_ON(&recording_thread_checker_);
-  rtc::CritScope cs(&lock_);
-  ++stats_.rec_callbacks;
-  stats_.rec_samples += samples_per_channel;
-  if (max_abs > stats_.max_rec_level) {
-    stats_.max_rec_level = max_abs;
+  LiveStats& stats = live_stats_;
+  stats.rec_callbacks.store(
+      stats.rec_callbacks.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  stats.rec_samples.store(
+      stats.rec_samples.load(std::memory_order_relaxed) + samples_per_channel,
+      std::memory_order_relaxed);
+  if (max_abs > stats.max_rec_level.load(std::memory_order_relaxed)) {
+    stats.max_rec_level.store(max_abs, std::memory_order_relaxed);
   }
 }
 
 void AudioDeviceBuffer::UpdatePlayStats(int16_t max_abs,
                                         size_t samples_per_channel) {
   RTC_DCHECK_RUN_ON(&playout_thread_checker_);
-  rtc::CritScope cs(&lock_);
-  ++stats_.play_callbacks;
-  stats_.play_samples += samples_per_channel;
-  if (max_abs > stats_.max_play_level) {
-    stats_.max_play_level = max_abs;
+  LiveStats& stats = live_stats_;
+  stats.play_callbacks.store(
+      stats.play_callbacks.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  stats.play_samples.store(
+      stats.play_samples.load(std::memory_order_relaxed) + samples_per_channel,
+      std::memory_order_relaxed);
+  if (max_abs > stats.max_play_level.load(std::memory_order_relaxed)) {
+    stats.max_play_level.store(max_abs, std::memory_order_relaxed);
   }
 }
 
@@ -11,9 +11,10 @@
 #ifndef WEBRTC_MODULES_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H_
 #define WEBRTC_MODULES_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H_
 
+#include <atomic>
+
 #include "webrtc/modules/audio_device/include/audio_device.h"
 #include "webrtc/rtc_base/buffer.h"
-#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/task_queue.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/rtc_base/thread_checker.h"
@@ -138,7 +139,7 @@ class AudioDeviceBuffer {
   void LogStats(LogState state);
 
   // Updates counters in each play/record callback. These counters are later
-  // (periodically) read by LogStats() using a lock.
+  // (periodically) read by LogStats() without any locking.
   void UpdateRecStats(int16_t max_abs, size_t samples_per_channel);
   void UpdatePlayStats(int16_t max_abs, size_t samples_per_channel);
 
@@ -147,6 +148,9 @@ class AudioDeviceBuffer {
   void ResetRecStats();
   void ResetPlayStats();
 
+  // Returns a snapshot of |live_stats_| and clears the max levels.
+  Stats TakeStats();
+
   // This object lives on the main (creating) thread and most methods are
   // called on that same thread. When audio has started some methods will be
   // called on either a native audio thread for playout or a native thread for
@@ -164,8 +168,6 @@ class AudioDeviceBuffer {
   // Native (platform specific) audio thread driving the recording side.
   rtc::ThreadChecker recording_thread_checker_;
 
-  rtc::CriticalSection lock_;
-
   // Task queue used to invoke LogStats() periodically. Tasks are executed on a
   // worker thread but it does not necessarily have to be the same thread for
   // each task.
@@ -201,11 +203,12 @@ class AudioDeviceBuffer {
 
   // Buffer used for audio samples to be played out. Size can be changed
   // dynamically. The 16-bit samples are interleaved, hence the size is
-  // proportional to the number of channels.
+  // proportional to the number of channels. Memory for 10ms of stereo audio at
+  // 96kHz is allocated at construction, which avoids allocations on the audio
+  // thread for all native audio layers in use today.
   rtc::BufferT<int16_t> play_buffer_ ACCESS_ON(playout_thread_checker_);
 
-  // Byte buffer used for recorded audio samples. Size can be changed
-  // dynamically.
+  // Buffer used for recorded audio samples. Preallocated like |play_buffer_|.
   rtc::BufferT<int16_t> rec_buffer_ ACCESS_ON(recording_thread_checker_);
 
   // AGC parameters.
@@ -242,8 +245,22 @@ class AudioDeviceBuffer {
   int64_t play_start_time_ ACCESS_ON(main_thread_checker_);
   int64_t rec_start_time_ ACCESS_ON(main_thread_checker_);
 
-  // Contains counters for playout and recording statistics.
-  Stats stats_ GUARDED_BY(lock_);
+  // Counters for playout and recording statistics. They are updated on the
+  // native audio threads and read on the task queue without locking, so that
+  // an audio callback never has to wait for the logging task. Each counter has
+  // a single writer (the recording or the playout thread) and is never reset;
+  // ResetRecStats() and ResetPlayStats() instead move |last_stats_| to the
+  // current totals. Only the max levels are cleared by the task queue, which
+  // at worst drops one level estimate.
+  struct LiveStats {
+    std::atomic<uint64_t> rec_callbacks{0};
+    std::atomic<uint64_t> play_callbacks{0};
+    std::atomic<uint64_t> rec_samples{0};
+    std::atomic<uint64_t> play_samples{0};
+    std::atomic<int16_t> max_rec_level{0};
+    std::atomic<int16_t> max_play_level{0};
+  };
+  LiveStats live_stats_;
 
   // Stores current stats at each timer task. Used to calculate differences
   // between two successive timer events.
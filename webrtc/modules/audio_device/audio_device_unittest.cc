@@ -27,6 +27,7 @@
 #include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/rtc_base/thread_checker.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 
@@ -538,6 +539,28 @@ class AudioDeviceTest : public ::testing::Test {
     EXPECT_FALSE(audio_device()->RecordingIsInitialized());
   }
 
+  void MeasureLoopbackLatency() {
+    NiceMock<MockAudioTransport> mock(TransportType::kPlayAndRecord);
+    LatencyAudioStream audio_stream;
+    mock.HandleCallbacks(event(), &audio_stream,
+                         kMeasureLatencyTimeInSec * kNumCallbacksPerSecond);
+    EXPECT_EQ(0, audio_device()->RegisterAudioCallback(&mock));
+    EXPECT_EQ(0, audio_device()->SetStereoPlayout(false));
+    EXPECT_EQ(0, audio_device()->SetStereoRecording(false));
+    StartPlayout();
+    StartRecording();
+    event()->Wait(static_cast<int>(std::max(
+        kTestTimeOutInMilliseconds, 1000 * kMeasureLatencyTimeInSec)));
+    StopRecording();
+    StopPlayout();
+    // Verify that the correct number of transmitted impulses are detected.
+    EXPECT_EQ(audio_stream.num_latency_values(),
+              static_cast<size_t>(
+                  kImpulseFrequencyInHz * kMeasureLatencyTimeInSec - 1));
+    // Print out min, max and average delay values for debugging purposes.
+    audio_stream.PrintResults();
+  }
+
  private:
   bool requirements_satisfied_ = true;
   rtc::Event event_;
@@ -545,6 +568,20 @@ class AudioDeviceTest : public ::testing::Test {
   bool stereo_playout_ = false;
 };
 
+// Enables the low-latency mode of the PulseAudio ADM. Used as the first base
+// class of a fixture, so that the field trial is set before the ADM is created.
+class PulseLowLatencyFieldTrial {
+ protected:
+  PulseLowLatencyFieldTrial()
+      : field_trials_("WebRTC-Audio-PulseLowLatency/Enabled/") {}
+
+ private:
+  test::ScopedFieldTrials field_trials_;
+};
+
+class AudioDeviceLowLatencyTest : public PulseLowLatencyFieldTrial,
+                                  public AudioDeviceTest {};
+
 // Uses the test fixture to create, initialize and destruct the ADM.
 TEST_F(AudioDeviceTest, ConstructDestruct) {}
 
@@ -675,25 +712,15 @@ TEST_F(AudioDeviceTest, RunPlayoutAndRecordingInFullDuplex) {
 // to run the test at highest possible output volume.
 TEST_F(AudioDeviceTest, DISABLED_MeasureLoopbackLatency) {
   SKIP_TEST_IF_NOT(requirements_satisfied());
-  NiceMock<MockAudioTransport> mock(TransportType::kPlayAndRecord);
-  LatencyAudioStream audio_stream;
-  mock.HandleCallbacks(event(), &audio_stream,
-                       kMeasureLatencyTimeInSec * kNumCallbacksPerSecond);
-  EXPECT_EQ(0, audio_device()->RegisterAudioCallback(&mock));
-  EXPECT_EQ(0, audio_device()->SetStereoPlayout(false));
-  EXPECT_EQ(0, audio_device()->SetStereoRecording(false));
-  StartPlayout();
-  StartRecording();
-  event()->Wait(static_cast<int>(
-      std::max(kTestTimeOutInMilliseconds, 1000 * kMeasureLatencyTimeInSec)));
-  StopRecording();
-  StopPlayout();
-  // Verify that the correct number of transmitted impulses are detected.
-  EXPECT_EQ(audio_stream.num_latency_values(),
-            static_cast<size_t>(
-                kImpulseFrequencyInHz * kMeasureLatencyTimeInSec - 1));
-  // Print out min, max and average delay values for debugging purposes.
-  audio_stream.PrintResults();
+  MeasureLoopbackLatency();
+}
+
+// Same as DISABLED_MeasureLoopbackLatency but with the low-latency mode of the
+// PulseAudio ADM enabled, to compare the two. Other ADMs ignore the field
+// trial.
+TEST_F(AudioDeviceLowLatencyTest, DISABLED_MeasureLoopbackLatency) {
+  SKIP_TEST_IF_NOT(requirements_satisfied());
+  MeasureLoopbackLatency();
 }
 
 }  // namespace webrtc
@@ -27,8 +27,9 @@ FineAudioBuffer::FineAudioBuffer(AudioDeviceBuffer* device_buffer,
       sample_rate_(sample_rate),
       samples_per_10_ms_(static_cast<size_t>(sample_rate_ * 10 / 1000)),
       bytes_per_10_ms_(samples_per_10_ms_ * sizeof(int16_t)),
-      playout_buffer_(0, capacity),
-      record_buffer_(0, capacity) {
+      capacity_(capacity),
+      playout_buffer_(0, capacity_ + bytes_per_10_ms_),
+      record_buffer_(0, capacity_ + bytes_per_10_ms_) {
   LOG(INFO) << "samples_per_10_ms_:" << samples_per_10_ms_;
 }
 
@@ -47,6 +48,8 @@ void FineAudioBuffer::GetPlayoutData(rtc::ArrayView<int8_t> audio_buffer) {
   // fulfill the request. It is possible that the buffer already contains
   // enough samples from the last round.
   const size_t num_bytes = audio_buffer.size();
+  RTC_DCHECK_LE(num_bytes, capacity_);
+  const int8_t* const data = playout_buffer_.data();
   while (playout_buffer_.size() < num_bytes) {
     // Get 10ms decoded audio from WebRTC.
     device_buffer_->RequestPlayoutData(samples_per_10_ms_);
@@ -61,6 +64,8 @@ void FineAudioBuffer::GetPlayoutData(rtc::ArrayView<int8_t> audio_buffer) {
         });
     RTC_DCHECK_EQ(bytes_per_10_ms_, bytes_written);
   }
+  // Verify that the buffer was not reallocated on the audio thread.
+  RTC_DCHECK_EQ(data, playout_buffer_.data());
   // Provide the requested number of bytes to the consumer.
   memcpy(audio_buffer.data(), playout_buffer_.data(), num_bytes);
   // Move remaining samples to start of buffer to prepare for next round.
@@ -73,8 +78,12 @@ void FineAudioBuffer::DeliverRecordedData(
     rtc::ArrayView<const int8_t> audio_buffer,
     int playout_delay_ms,
     int record_delay_ms) {
-  // Always append new data and grow the buffer if needed.
+  RTC_DCHECK_LE(audio_buffer.size(), capacity_);
+  const int8_t* const data = record_buffer_.data();
+  // Always append new data. The buffer has room for it since it holds less
+  // than 10ms of audio between calls.
   record_buffer_.AppendData(audio_buffer.data(), audio_buffer.size());
+  RTC_DCHECK_EQ(data, record_buffer_.data());
   // Consume samples from buffer in chunks of 10ms until there is not
   // enough data left. The number of remaining bytes in the cache is given by
   // the new size of the buffer.
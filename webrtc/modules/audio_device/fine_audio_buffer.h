@@ -29,14 +29,18 @@ class AudioDeviceBuffer;
 // in 10ms chunks when the size of the provided audio buffers differs from 10ms.
 // As an example: calling DeliverRecordedData() with 5ms buffers will deliver
 // accumulated 10ms worth of data to the ADB every second call.
+// All memory is allocated at construction, hence the methods can be called on
+// a real-time audio thread; they never allocate memory or take locks as long
+// as no audio buffer is larger than |capacity|. Debug builds verify this.
 // TODO(henrika): add support for stereo when mobile platforms need it.
 class FineAudioBuffer {
  public:
   // |device_buffer| is a buffer that provides 10ms of audio data.
   // |sample_rate| is the sample rate of the audio data. This is needed because
   // |device_buffer| delivers 10ms of data. Given the sample rate the number
-  // of samples can be calculated. The |capacity| ensures that the buffer size
-  // can be increased to at least capacity without further reallocation.
+  // of samples can be calculated. |capacity| is the largest size in bytes of
+  // the audio buffers given to GetPlayoutData() and DeliverRecordedData(), and
+  // it is used to allocate the internal buffers up front.
   FineAudioBuffer(AudioDeviceBuffer* device_buffer,
                   int sample_rate,
                   size_t capacity);
@@ -78,11 +82,15 @@ class FineAudioBuffer {
   const size_t samples_per_10_ms_;
   // Number of audio bytes per 10ms.
   const size_t bytes_per_10_ms_;
+  // Largest supported size of the audio buffers in bytes.
+  const size_t capacity_;
   // Storage for output samples from which a consumer can read audio buffers
-  // in any size using GetPlayoutData().
+  // in any size using GetPlayoutData(). Holds less than |capacity_| +
+  // |bytes_per_10_ms_| bytes.
   rtc::BufferT<int8_t> playout_buffer_;
   // Storage for input samples that are about to be delivered to the WebRTC
   // ADB or remains from the last successful delivery of a 10ms audio buffer.
+  // Holds less than |capacity_| + |bytes_per_10_ms_| bytes.
   rtc::BufferT<int8_t> record_buffer_;
 };
 
@@ -137,6 +137,11 @@ TEST(FineBufferTest, BufferLessThan10ms) {
   RunFineBufferTest(kFrameSizeSamples);
 }
 
+TEST(FineBufferTest, BufferMuchLessThan10ms) {
+  const int kFrameSizeSamples = kSamplesPer10Ms / 4 + 1;
+  RunFineBufferTest(kFrameSizeSamples);
+}
+
 TEST(FineBufferTest, GreaterThan10ms) {
   const int kFrameSizeSamples = kSamplesPer10Ms + 50;
   RunFineBufferTest(kFrameSizeSamples);
@@ -10,11 +10,14 @@
 
 #include <assert.h>
 
+#include <algorithm>
+
 #include "webrtc/modules/audio_device/audio_device_config.h"
 #include "webrtc/modules/audio_device/linux/audio_device_pulse_linux.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/system_wrappers/include/event_wrapper.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 webrtc::adm_linux_pulse::PulseAudioSymbolTable PaSymbolTable;
 
@@ -52,6 +55,8 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse()
       _stopPlay(false),
       _AGC(false),
       update_speaker_volume_at_startup_(false),
+      low_latency_(
+          webrtc::field_trial::IsEnabled("WebRTC-Audio-PulseLowLatency")),
       _playBufDelayFixed(20),
       _sndCardPlayDelay(0),
       _sndCardRecDelay(0),
@@ -988,6 +993,9 @@ int32_t AudioDeviceLinuxPulse::InitPlayout() {
 
   LOG(LS_VERBOSE) << "stream state " << LATE(pa_stream_get_state)(_playStream);
 
+  // num samples in bytes * num channels
+  _playbackBufferSize = sample_rate_hz_ / 100 * 2 * _playChannels;
+
   // Set stream flags
   _playStreamFlags = (pa_stream_flags_t)(PA_STREAM_AUTO_TIMING_UPDATE |
                                          PA_STREAM_INTERPOLATE_TIMING);
@@ -1013,19 +1021,11 @@ int32_t AudioDeviceLinuxPulse::InitPlayout() {
     uint32_t latency = bytesPerSec * WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS /
                        WEBRTC_PA_MSECS_PER_SEC;
 
-    // Set the play buffer attributes
-    _playBufferAttr.maxlength = latency;  // num bytes stored in the buffer
-    _playBufferAttr.tlength = latency;    // target fill level of play buffer
-    // minimum free num bytes before server request more data
-    _playBufferAttr.minreq = latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
-    // prebuffer tlength before starting playout
-    _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
+    SetPlayBufferAttr(latency);
 
     _configuredLatencyPlay = latency;
   }
 
-  // num samples in bytes * num channels
-  _playbackBufferSize = sample_rate_hz_ / 100 * 2 * _playChannels;
   _playbackBufferUnused = _playbackBufferSize;
   _playBuffer = new int8_t[_playbackBufferSize];
 
@@ -1111,6 +1111,10 @@ int32_t AudioDeviceLinuxPulse::InitRecording() {
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
     uint32_t latency = bytesPerSec * WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS /
                        WEBRTC_PA_MSECS_PER_SEC;
+    if (low_latency_) {
+      // Exactly one 10 ms block per fragment.
+      latency = sample_rate_hz_ / 100 * 2 * _recChannels;
+    }
 
     // Set the rec buffer attributes
     // Note: fragsize specifies a maximum transfer size, not a minimum, so
@@ -1889,6 +1893,20 @@ void AudioDeviceLinuxPulse::WaitForOperationCompletion(
 //                                  Thread Methods
 // ============================================================================
 
+void AudioDeviceLinuxPulse::SetPlayBufferAttr(uint32_t latency) {
+  _playBufferAttr.maxlength = latency;  // num bytes stored in the buffer
+  _playBufferAttr.tlength = latency;    // target fill level of play buffer
+  // minimum free num bytes before server request more data
+  if (low_latency_) {
+    // Request one 10 ms block at a time, whatever the target latency is.
+    _playBufferAttr.minreq = _playbackBufferSize;
+  } else {
+    _playBufferAttr.minreq = latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+  }
+  // prebuffer tlength before starting playout
+  _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
+}
+
 void AudioDeviceLinuxPulse::EnableWriteCallback() {
   if (LATE(pa_stream_get_state)(_playStream) == PA_STREAM_READY) {
     // May already have available space. Must check.
@@ -1950,16 +1968,25 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler() {
   }
 
   size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-  uint32_t newLatency =
-      _configuredLatencyPlay + bytesPerSec *
-                                   WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS /
-                                   WEBRTC_PA_MSECS_PER_SEC;
-
-  // Set the play buffer attributes
-  _playBufferAttr.maxlength = newLatency;
-  _playBufferAttr.tlength = newLatency;
-  _playBufferAttr.minreq = newLatency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
-  _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
+  uint32_t newLatency;
+  if (low_latency_) {
+    const uint32_t maxLatency = bytesPerSec *
+                                WEBRTC_PA_LOW_LATENCY_PLAYBACK_MAXIMUM_MSECS /
+                                WEBRTC_PA_MSECS_PER_SEC;
+    newLatency = std::min<uint32_t>(
+        _configuredLatencyPlay + _playbackBufferSize, maxLatency);
+    if (newLatency <= static_cast<uint32_t>(_configuredLatencyPlay)) {
+      // Already at the maximum latency.
+      return;
+    }
+  } else {
+    newLatency =
+        _configuredLatencyPlay + bytesPerSec *
+                                     WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS /
+                                     WEBRTC_PA_MSECS_PER_SEC;
+  }
+
+  SetPlayBufferAttr(newLatency);
 
   pa_operation* op = LATE(pa_stream_set_buffer_attr)(
       _playStream, &_playBufferAttr, NULL, NULL);
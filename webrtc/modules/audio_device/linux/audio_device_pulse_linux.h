@@ -80,6 +80,14 @@ const uint32_t WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS = 10;
 // kNoLatencyRequirements case.)
 const uint32_t WEBRTC_PA_CAPTURE_BUFFER_EXTRA_MSECS = 750;
 
+// Low-latency mode, enabled with the "WebRTC-Audio-PulseLowLatency" field
+// trial. The buffer attributes are then derived from the 10 ms cadence of the
+// audio callbacks: the server requests playout data one 10 ms block at a time
+// and delivers capture data in 10 ms fragments, so neither side gets larger
+// fragments that have to be split up. An underflow only adds one block to the
+// playout latency, which is capped at this value.
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_MAXIMUM_MSECS = 100;
+
 const uint32_t WEBRTC_PA_MSECS_PER_SEC = 1000;
 
 // Init _configuredLatencyRec/Play to this value to disable latency requirements
@@ -238,6 +246,8 @@ private:
     void PaServerInfoCallbackHandler(const pa_server_info *i);
     void PaStreamStateCallbackHandler(pa_stream *p);
 
+    // Sets |_playBufferAttr| for a target playout latency of |latency| bytes.
+    void SetPlayBufferAttr(uint32_t latency);
     void EnableWriteCallback();
     void DisableWriteCallback();
     static void PaStreamWriteCallback(pa_stream *unused, size_t buffer_space,
@@ -314,6 +324,7 @@ private:
     bool _stopPlay;
     bool _AGC;
     bool update_speaker_volume_at_startup_;
+    const bool low_latency_;
 
     uint16_t _playBufDelayFixed; // fixed playback delay
 
@@ -104,11 +104,27 @@ AudioMixerImpl::SourceStatusList::iterator FindSourceInList(
 AudioMixerImpl::AudioMixerImpl(
     std::unique_ptr<OutputRateCalculator> output_rate_calculator,
     bool use_limiter)
+    : AudioMixerImpl(std::move(output_rate_calculator),
+                     use_limiter ? FrameCombiner::LimiterType::kApm
+                                 : FrameCombiner::LimiterType::kNone) {}
+
+AudioMixerImpl::AudioMixerImpl(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    FrameCombiner::LimiterType limiter_type)
+    : AudioMixerImpl(std::move(output_rate_calculator), limiter_type, 1) {}
+
+AudioMixerImpl::AudioMixerImpl(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    FrameCombiner::LimiterType limiter_type,
+    int num_pull_threads)
     : output_rate_calculator_(std::move(output_rate_calculator)),
       output_frequency_(0),
       sample_size_(0),
       audio_source_list_(),
-      frame_combiner_(use_limiter) {}
+      frame_combiner_(limiter_type),
+      pull_runner_(num_pull_threads > 1
+                       ? new ParallelTaskRunner(num_pull_threads)
+                       : nullptr) {}
 
 AudioMixerImpl::~AudioMixerImpl() {}
 
@@ -126,6 +142,23 @@ rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
           std::move(output_rate_calculator), use_limiter));
 }
 
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    FrameCombiner::LimiterType limiter_type) {
+  return rtc::scoped_refptr<AudioMixerImpl>(
+      new rtc::RefCountedObject<AudioMixerImpl>(
+          std::move(output_rate_calculator), limiter_type));
+}
+
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    FrameCombiner::LimiterType limiter_type,
+    int num_pull_threads) {
+  return rtc::scoped_refptr<AudioMixerImpl>(
+      new rtc::RefCountedObject<AudioMixerImpl>(
+          std::move(output_rate_calculator), limiter_type, num_pull_threads));
+}
+
 void AudioMixerImpl::Mix(size_t number_of_channels,
                          AudioFrame* audio_frame_for_mixing) {
   RTC_DCHECK(number_of_channels == 1 || number_of_channels == 2);
@@ -190,17 +223,32 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   std::vector<SourceFrame> ramp_list;
 
   // Get audio from the audio sources and put it in the SourceFrame vector.
-  for (auto& source_and_status : audio_source_list_) {
-    const auto audio_frame_info =
-        source_and_status->audio_source->GetAudioFrameWithInfo(
-            OutputFrequency(), &source_and_status->audio_frame);
+  // The sources are pulled before any of the frames are looked at, so that
+  // they can be pulled in parallel; the frames are then handled in the same
+  // order either way.
+  const std::vector<SourceStatus*> sources = SourcesToPull();
+  const int output_frequency = OutputFrequency();
+  pulled_frame_infos_.resize(sources.size());
+  auto pull_source = [&](size_t i) {
+    pulled_frame_infos_[i] = sources[i]->audio_source->GetAudioFrameWithInfo(
+        output_frequency, &sources[i]->audio_frame);
+  };
+  if (pull_runner_ && sources.size() > 1) {
+    pull_runner_->Run(sources.size(), pull_source);
+  } else {
+    for (size_t i = 0; i < sources.size(); ++i)
+      pull_source(i);
+  }
+  for (size_t i = 0; i < sources.size(); ++i) {
+    SourceStatus* const source_status = sources[i];
+    const auto audio_frame_info = pulled_frame_infos_[i];
 
     if (audio_frame_info == Source::AudioFrameInfo::kError) {
       LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
       continue;
     }
     audio_source_mixing_data_list.emplace_back(
-        source_and_status.get(), &source_and_status->audio_frame,
+        source_status, &source_status->audio_frame,
         audio_frame_info == Source::AudioFrameInfo::kMuted);
   }
 
@@ -232,6 +280,39 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   return result;
 }
 
+std::vector<AudioMixerImpl::SourceStatus*> AudioMixerImpl::SourcesToPull() {
+  std::vector<SourceStatus*> sources;
+  // Level and source of the sources that have to compete for the mix.
+  std::vector<std::pair<int, SourceStatus*>> contenders;
+  for (auto& source_and_status : audio_source_list_) {
+    const rtc::Optional<int> level =
+        source_and_status->audio_source->LatestReceivedAudioLevel();
+    // Mixed sources are always asked for audio, so that they are ramped out
+    // when they stop being mixed.
+    if (!level || source_and_status->is_mixed) {
+      sources.push_back(source_and_status.get());
+    } else {
+      contenders.emplace_back(*level, source_and_status.get());
+    }
+  }
+
+  // A lower level means louder audio. A partial selection is enough to find
+  // the loudest contenders; their order doesn't matter.
+  if (contenders.size() > kMaximumAmountOfMixedAudioSources) {
+    std::nth_element(contenders.begin(),
+                     contenders.begin() + kMaximumAmountOfMixedAudioSources,
+                     contenders.end(),
+                     [](const std::pair<int, SourceStatus*>& a,
+                        const std::pair<int, SourceStatus*>& b) {
+                       return a.first < b.first;
+                     });
+    contenders.resize(kMaximumAmountOfMixedAudioSources);
+  }
+  for (const auto& contender : contenders)
+    sources.push_back(contender.second);
+  return sources;
+}
+
 bool AudioMixerImpl::GetAudioSourceMixabilityStatusForTest(
     AudioMixerImpl::Source* audio_source) const {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
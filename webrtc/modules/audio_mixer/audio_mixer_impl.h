@@ -17,6 +17,7 @@
 #include "webrtc/api/audio/audio_mixer.h"
 #include "webrtc/modules/audio_mixer/frame_combiner.h"
 #include "webrtc/modules/audio_mixer/output_rate_calculator.h"
+#include "webrtc/modules/audio_mixer/parallel_task_runner.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/rtc_base/race_checker.h"
@@ -53,6 +54,18 @@ class AudioMixerImpl : public AudioMixer {
       std::unique_ptr<OutputRateCalculator> output_rate_calculator,
       bool use_limiter);
 
+  static rtc::scoped_refptr<AudioMixerImpl> Create(
+      std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+      FrameCombiner::LimiterType limiter_type);
+
+  // Pulls the sources on |num_pull_threads| threads, the mixing thread
+  // included, for servers mixing many streams which each decode their audio
+  // when pulled. The sources must then allow to be pulled from any thread.
+  static rtc::scoped_refptr<AudioMixerImpl> Create(
+      std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+      FrameCombiner::LimiterType limiter_type,
+      int num_pull_threads);
+
   ~AudioMixerImpl() override;
 
   // AudioMixer functions
@@ -70,6 +83,11 @@ class AudioMixerImpl : public AudioMixer {
  protected:
   AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
                  bool use_limiter);
+  AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+                 FrameCombiner::LimiterType limiter_type);
+  AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+                 FrameCombiner::LimiterType limiter_type,
+                 int num_pull_threads);
 
  private:
   // Set mixing frequency through OutputFrequencyCalculator.
@@ -82,6 +100,11 @@ class AudioMixerImpl : public AudioMixer {
   // kMaximumAmountOfMixedAudioSources audio sources.
   AudioFrameList GetAudioFromSources() EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Returns the sources to ask for audio this round. Sources that report an
+  // audio level are left out unless they were mixed last round, or are among
+  // the kMaximumAmountOfMixedAudioSources loudest of the remaining ones.
+  std::vector<SourceStatus*> SourcesToPull() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Add/remove the MixerAudioSource to the specified
   // MixerAudioSource list.
   bool AddAudioSourceToList(Source* audio_source,
@@ -106,6 +129,12 @@ class AudioMixerImpl : public AudioMixer {
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_ GUARDED_BY(race_checker_);
 
+  // Pulls the sources in parallel, if more than one pull thread is used.
+  std::unique_ptr<ParallelTaskRunner> pull_runner_;
+  // What the sources returned when pulled, reused from round to round.
+  std::vector<Source::AudioFrameInfo> pulled_frame_infos_
+      GUARDED_BY(race_checker_);
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
 }  // namespace webrtc
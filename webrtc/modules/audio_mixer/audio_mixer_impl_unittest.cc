@@ -23,7 +23,9 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/task_queue.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gmock.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 using testing::_;
 using testing::Exactly;
@@ -73,6 +75,8 @@ class MockMixerAudioSource : public AudioMixer::Source {
             Invoke(this, &MockMixerAudioSource::FakeAudioFrameWithInfo));
     ON_CALL(*this, PreferredSampleRate())
         .WillByDefault(Return(kDefaultSampleRateHz));
+    ON_CALL(*this, LatestReceivedAudioLevel())
+        .WillByDefault(Return(rtc::Optional<int>()));
   }
 
   MOCK_METHOD2(GetAudioFrameWithInfo,
@@ -80,6 +84,7 @@ class MockMixerAudioSource : public AudioMixer::Source {
 
   MOCK_CONST_METHOD0(PreferredSampleRate, int());
   MOCK_CONST_METHOD0(Ssrc, int());
+  MOCK_CONST_METHOD0(LatestReceivedAudioLevel, rtc::Optional<int>());
 
   AudioFrame* fake_frame() { return &fake_frame_; }
   AudioFrameInfo fake_info() { return fake_audio_frame_info_; }
@@ -542,4 +547,220 @@ TEST(AudioMixer, AnyRateIsPossibleWithNoLimiter) {
     }
   }
 }
+
+TEST(AudioMixer, AnyRateIsPossibleWithLookaheadLimiter) {
+  for (const auto rate : {8000, 20000, 24000, 32000, 44100, 48000}) {
+    for (const size_t number_of_channels : {1, 2}) {
+      for (const auto number_of_sources : {0, 1, 2, 3, 4}) {
+        SCOPED_TRACE(
+            ProduceDebugText(rate, number_of_sources, number_of_sources));
+        const auto mixer = AudioMixerImpl::Create(
+            std::unique_ptr<OutputRateCalculator>(
+                new CustomRateCalculator(rate)),
+            FrameCombiner::LimiterType::kLookahead);
+
+        std::vector<MockMixerAudioSource> sources(number_of_sources);
+        for (auto& source : sources) {
+          mixer->AddSource(&source);
+        }
+
+        mixer->Mix(number_of_channels, &frame_for_mixing);
+        EXPECT_EQ(rate, frame_for_mixing.sample_rate_hz_);
+        EXPECT_EQ(number_of_channels, frame_for_mixing.num_channels_);
+      }
+    }
+  }
+}
+
+TEST(AudioMixer, QuietSourcesWithAudioLevelAreNotPulled) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 5;
+
+  const auto mixer = AudioMixerImpl::Create();
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->mutable_data()[80] = 100;
+    // The level increases, i.e. the audio gets quieter, with the index.
+    ON_CALL(participants[i], LatestReceivedAudioLevel())
+        .WillByDefault(Return(rtc::Optional<int>(10 + i)));
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(
+            i < AudioMixerImpl::kMaximumAmountOfMixedAudioSources ? 1 : 0));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    EXPECT_EQ(i < AudioMixerImpl::kMaximumAmountOfMixedAudioSources,
+              mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]))
+        << "Mixed status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, MixedSourcesArePulledWhileLoudSourcesTakeOver) {
+  constexpr int kMixed = AudioMixerImpl::kMaximumAmountOfMixedAudioSources;
+  constexpr int kAudioSources = 3 * kMixed;
+
+  const auto mixer = AudioMixerImpl::Create();
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->mutable_data()[80] = 100;
+    ON_CALL(participants[i], LatestReceivedAudioLevel())
+        .WillByDefault(Return(rtc::Optional<int>(10 + i)));
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+  mixer->Mix(1, &frame_for_mixing);
+
+  // The second group of sources becomes the loudest, with more energy than
+  // the first group. The first group is still mixed, so it's asked for audio
+  // once more to be ramped out.
+  for (int i = kMixed; i < 2 * kMixed; ++i) {
+    ON_CALL(participants[i], LatestReceivedAudioLevel())
+        .WillByDefault(Return(rtc::Optional<int>(0)));
+    participants[i].fake_frame()->mutable_data()[80] = 1000;
+  }
+  for (int i = 0; i < kAudioSources; ++i) {
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(i < 2 * kMixed ? 1 : 0));
+  }
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    EXPECT_EQ(i >= kMixed && i < 2 * kMixed,
+              mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]))
+        << "Mixed status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, SourcesWithoutAudioLevelAreAlwaysPulled) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 4;
+
+  const auto mixer = AudioMixerImpl::Create();
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    // Every other source reports a level.
+    if (i % 2 == 0) {
+      ON_CALL(participants[i], LatestReceivedAudioLevel())
+          .WillByDefault(Return(rtc::Optional<int>(127 - i)));
+    }
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+  for (int i = 0; i < kAudioSources; ++i) {
+    // Only the quietest of the sources with a level is out of contention.
+    const bool pulled = i != 0;
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(pulled ? 1 : 0));
+  }
+  mixer->Mix(1, &frame_for_mixing);
+}
+
+namespace {
+
+// A source with a fixed frame and a fixed audio level, without the overhead
+// of the mock, for measuring the time spent in the mixer.
+class FakeLevelSource : public AudioMixer::Source {
+ public:
+  FakeLevelSource(int16_t amplitude, rtc::Optional<int> level)
+      : level_(level) {
+    ResetFrame(&frame_);
+    int16_t* data = frame_.mutable_data();
+    for (size_t i = 0; i < frame_.samples_per_channel_; ++i)
+      data[i] = (i % 2 == 0) ? amplitude : -amplitude;
+  }
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    audio_frame->CopyFrom(frame_);
+    return AudioFrameInfo::kNormal;
+  }
+  int Ssrc() const override { return 0; }
+  int PreferredSampleRate() const override { return kDefaultSampleRateHz; }
+  rtc::Optional<int> LatestReceivedAudioLevel() const override {
+    return level_;
+  }
+
+ private:
+  AudioFrame frame_;
+  const rtc::Optional<int> level_;
+};
+
+void MeasureMixTime(int num_sources, bool with_audio_level) {
+  const int kNumMixes = 1000;
+  const auto mixer = AudioMixerImpl::Create();
+  std::vector<std::unique_ptr<FakeLevelSource>> sources;
+  for (int i = 0; i < num_sources; ++i) {
+    const rtc::Optional<int> level =
+        with_audio_level ? rtc::Optional<int>(i % 128) : rtc::Optional<int>();
+    sources.emplace_back(new FakeLevelSource(
+        static_cast<int16_t>(1000 + i % 1000), level));
+    mixer->AddSource(sources.back().get());
+  }
+
+  AudioFrame mixed_frame;
+  const int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumMixes; ++i)
+    mixer->Mix(1, &mixed_frame);
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+  webrtc::test::PrintResult(
+      "audio_mixer",
+      with_audio_level ? "_with_audio_level" : "_without_audio_level",
+      "sources_" + std::to_string(num_sources),
+      static_cast<size_t>(elapsed_us * 1000 / kNumMixes), "ns/mix", false);
+}
+
+}  // namespace
+
+TEST(AudioMixer, DISABLED_MixPerf) {
+  for (int num_sources : {10, 100, 1000}) {
+    MeasureMixTime(num_sources, false);
+    MeasureMixTime(num_sources, true);
+  }
+}
+
+TEST(AudioMixer, ParallelPullsMixLikeSequentialPulls) {
+  constexpr int kAudioSources = 8;
+  const auto sequential_mixer = AudioMixerImpl::Create(
+      std::unique_ptr<OutputRateCalculator>(new DefaultOutputRateCalculator()),
+      FrameCombiner::LimiterType::kNone);
+  const auto parallel_mixer = AudioMixerImpl::Create(
+      std::unique_ptr<OutputRateCalculator>(new DefaultOutputRateCalculator()),
+      FrameCombiner::LimiterType::kNone, 4);
+
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    // Different amplitudes, so that only the loudest ones are mixed.
+    participants[i].fake_frame()->mutable_data()[0] = 100 * (i + 1);
+    // Muted every other one.
+    if (i % 2 == 1)
+      participants[i].set_fake_info(AudioMixer::Source::AudioFrameInfo::kMuted);
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(4));
+    EXPECT_TRUE(sequential_mixer->AddSource(&participants[i]));
+    EXPECT_TRUE(parallel_mixer->AddSource(&participants[i]));
+  }
+
+  for (int round = 0; round < 2; ++round) {
+    AudioFrame sequential_frame;
+    AudioFrame parallel_frame;
+    sequential_mixer->Mix(1, &sequential_frame);
+    parallel_mixer->Mix(1, &parallel_frame);
+    EXPECT_EQ(0, memcmp(sequential_frame.data(), parallel_frame.data(),
+                        sizeof(int16_t) * sequential_frame.samples_per_channel_));
+    for (int i = 0; i < kAudioSources; ++i) {
+      EXPECT_EQ(
+          sequential_mixer->GetAudioSourceMixabilityStatusForTest(
+              &participants[i]),
+          parallel_mixer->GetAudioSourceMixabilityStatusForTest(
+              &participants[i]));
+    }
+  }
+}
+
 }  // namespace webrtc
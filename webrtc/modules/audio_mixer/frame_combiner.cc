@@ -12,7 +12,6 @@
 
 #include <algorithm>
 #include <array>
-#include <functional>
 #include <memory>
 
 #include "webrtc/audio/utility/audio_frame_operations.h"
@@ -74,6 +73,7 @@ void CombineOneFrame(const AudioFrame* input_frame,
 // limiter.
 void CombineMultipleFrames(
     const std::vector<rtc::ArrayView<const int16_t>>& input_frames,
+    const MixingKernels& kernels,
     bool use_limiter,
     AudioProcessing* limiter,
     AudioFrame* audio_frame_for_mixing) {
@@ -95,10 +95,10 @@ void CombineMultipleFrames(
 
   add_buffer.fill(0);
 
+  const rtc::ArrayView<int32_t> sum(add_buffer.data(), frame_length);
   for (const auto& frame : input_frames) {
     // TODO(yujo): skip this for muted frames.
-    std::transform(frame.begin(), frame.end(), add_buffer.begin(),
-                   add_buffer.begin(), std::plus<int32_t>());
+    kernels.Accumulate(frame, sum);
   }
 
   if (use_limiter) {
@@ -128,9 +128,9 @@ void CombineMultipleFrames(
     // negative value is undefined).
     AudioFrameOperations::Add(*audio_frame_for_mixing, audio_frame_for_mixing);
   } else {
-    std::transform(add_buffer.begin(), add_buffer.begin() + frame_length,
-                   audio_frame_for_mixing->mutable_data(),
-                   [](int32_t a) { return rtc::saturated_cast<int16_t>(a); });
+    kernels.Saturate(sum, rtc::ArrayView<int16_t>(
+                              audio_frame_for_mixing->mutable_data(),
+                              frame_length));
   }
 }
 
@@ -163,9 +163,17 @@ std::unique_ptr<AudioProcessing> CreateLimiter() {
 }
 }  // namespace
 
+FrameCombiner::FrameCombiner(LimiterType limiter_type)
+    : limiter_type_(limiter_type),
+      kernels_(DetectMixingOptimization()),
+      limiter_(limiter_type == LimiterType::kApm ? CreateLimiter() : nullptr),
+      lookahead_limiter_(limiter_type == LimiterType::kLookahead
+                             ? new LookaheadLimiter(DetectMixingOptimization())
+                             : nullptr) {}
+
 FrameCombiner::FrameCombiner(bool use_apm_limiter)
-    : use_apm_limiter_(use_apm_limiter),
-      limiter_(use_apm_limiter ? CreateLimiter() : nullptr) {}
+    : FrameCombiner(use_apm_limiter ? LimiterType::kApm : LimiterType::kNone) {
+}
 
 FrameCombiner::~FrameCombiner() = default;
 
@@ -196,7 +204,13 @@ void FrameCombiner::Combine(const std::vector<AudioFrame*>& mix_list,
       -1, 0, nullptr, samples_per_channel, sample_rate, AudioFrame::kUndefined,
       AudioFrame::kVadUnknown, number_of_channels);
 
-  const bool use_limiter_this_round = use_apm_limiter_ && number_of_streams > 1;
+  if (limiter_type_ == LimiterType::kLookahead) {
+    CombineWithLookaheadLimiter(mix_list, audio_frame_for_mixing);
+    return;
+  }
+
+  const bool use_limiter_this_round =
+      limiter_type_ == LimiterType::kApm && number_of_streams > 1;
 
   if (mix_list.empty()) {
     CombineZeroFrames(use_limiter_this_round, limiter_.get(),
@@ -210,9 +224,40 @@ void FrameCombiner::Combine(const std::vector<AudioFrame*>& mix_list,
       input_frames.push_back(rtc::ArrayView<const int16_t>(
           mix_list[i]->data(), samples_per_channel * number_of_channels));
     }
-    CombineMultipleFrames(input_frames, use_limiter_this_round, limiter_.get(),
-                          audio_frame_for_mixing);
+    CombineMultipleFrames(input_frames, kernels_, use_limiter_this_round,
+                          limiter_.get(), audio_frame_for_mixing);
+  }
+}
+
+void FrameCombiner::CombineWithLookaheadLimiter(
+    const std::vector<AudioFrame*>& mix_list,
+    AudioFrame* audio_frame_for_mixing) const {
+  RTC_DCHECK(lookahead_limiter_);
+  const size_t frame_length = audio_frame_for_mixing->samples_per_channel_ *
+                              audio_frame_for_mixing->num_channels_;
+  RTC_DCHECK_GE(kMaximalFrameSize, frame_length);
+  if (mix_list.empty()) {
+    audio_frame_for_mixing->elapsed_time_ms_ = -1;
+  } else if (mix_list.size() == 1) {
+    audio_frame_for_mixing->timestamp_ = mix_list.front()->timestamp_;
+    audio_frame_for_mixing->elapsed_time_ms_ =
+        mix_list.front()->elapsed_time_ms_;
+  }
+
+  // The frames are summed and limited in one pass each, straight into the
+  // output frame. The limiter also processes silence, so that its gain keeps
+  // being released.
+  std::array<int32_t, kMaximalFrameSize> add_buffer;
+  const rtc::ArrayView<int32_t> sum(add_buffer.data(), frame_length);
+  std::fill(sum.begin(), sum.end(), 0);
+  for (const AudioFrame* frame : mix_list) {
+    kernels_.Accumulate(
+        rtc::ArrayView<const int16_t>(frame->data(), frame_length), sum);
   }
+  lookahead_limiter_->Process(
+      sum, audio_frame_for_mixing->num_channels_,
+      rtc::ArrayView<int16_t>(audio_frame_for_mixing->mutable_data(),
+                              frame_length));
 }
 
 }  // namespace webrtc
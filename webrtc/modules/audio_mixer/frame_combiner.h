@@ -14,6 +14,8 @@
 #include <memory>
 #include <vector>
 
+#include "webrtc/modules/audio_mixer/lookahead_limiter.h"
+#include "webrtc/modules/audio_mixer/mixing_kernels.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/include/module_common_types.h"
 
@@ -21,6 +23,17 @@ namespace webrtc {
 
 class FrameCombiner {
  public:
+  enum class LimiterType {
+    kNone,
+    // The AGC limiter of AudioProcessing, applied to the halved sum.
+    kApm,
+    // A LookaheadLimiter, applied directly to the sum. It doesn't restrict
+    // the sample rate, and avoids the AudioFrame copies of the APM limiter.
+    kLookahead,
+  };
+
+  explicit FrameCombiner(LimiterType limiter_type);
+  // Uses the APM limiter if |use_apm_limiter|, and no limiter otherwise.
   explicit FrameCombiner(bool use_apm_limiter);
   ~FrameCombiner();
 
@@ -37,8 +50,13 @@ class FrameCombiner {
                AudioFrame* audio_frame_for_mixing) const;
 
  private:
-  const bool use_apm_limiter_;
+  void CombineWithLookaheadLimiter(const std::vector<AudioFrame*>& mix_list,
+                                   AudioFrame* audio_frame_for_mixing) const;
+
+  const LimiterType limiter_type_;
+  const MixingKernels kernels_;
   std::unique_ptr<AudioProcessing> limiter_;
+  std::unique_ptr<LookaheadLimiter> lookahead_limiter_;
 };
 }  // namespace webrtc
 
@@ -18,7 +18,9 @@
 #include "webrtc/modules/audio_mixer/gain_change_calculator.h"
 #include "webrtc/modules/audio_mixer/sine_wave_generator.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 
@@ -102,6 +104,51 @@ TEST(FrameCombiner, BasicApiCallsNoLimiter) {
   }
 }
 
+// The lookahead limiter has no rate restriction either.
+TEST(FrameCombiner, BasicApiCallsLookaheadLimiter) {
+  FrameCombiner combiner(FrameCombiner::LimiterType::kLookahead);
+  for (const int rate : {8000, 10000, 11000, 32000, 44100, 48000}) {
+    for (const int number_of_channels : {1, 2}) {
+      const std::vector<AudioFrame*> all_frames = {&frame1, &frame2};
+      SetUpFrames(rate, number_of_channels);
+
+      for (const int number_of_frames : {0, 1, 2}) {
+        SCOPED_TRACE(
+            ProduceDebugText(rate, number_of_channels, number_of_frames));
+        const std::vector<AudioFrame*> frames_to_combine(
+            all_frames.begin(), all_frames.begin() + number_of_frames);
+        combiner.Combine(frames_to_combine, number_of_channels, rate,
+                         frames_to_combine.size(), &audio_frame_for_mixing);
+      }
+    }
+  }
+}
+
+// Quiet mixes pass through the lookahead limiter unchanged.
+TEST(FrameCombiner, LookaheadLimiterDoesNotChangeQuietMix) {
+  FrameCombiner combiner(FrameCombiner::LimiterType::kLookahead);
+  for (const int rate : {8000, 32000, 48000}) {
+    for (const int number_of_channels : {1, 2}) {
+      SCOPED_TRACE(ProduceDebugText(rate, number_of_channels, 2));
+
+      SetUpFrames(rate, number_of_channels);
+      const size_t number_of_samples = number_of_channels * rate / 100;
+      int16_t* frame1_data = frame1.mutable_data();
+      int16_t* frame2_data = frame2.mutable_data();
+      std::iota(frame1_data, frame1_data + number_of_samples, -100);
+      std::iota(frame2_data, frame2_data + number_of_samples, 0);
+      const std::vector<AudioFrame*> frames_to_combine = {&frame1, &frame2};
+      combiner.Combine(frames_to_combine, number_of_channels, rate,
+                       frames_to_combine.size(), &audio_frame_for_mixing);
+
+      for (size_t i = 0; i < number_of_samples; ++i) {
+        ASSERT_EQ(frame1_data[i] + frame2_data[i],
+                  audio_frame_for_mixing.data()[i]);
+      }
+    }
+  }
+}
+
 TEST(FrameCombiner, CombiningZeroFramesShouldProduceSilence) {
   FrameCombiner combiner(false);
   for (const int rate : {8000, 10000, 11000, 32000, 44100}) {
@@ -203,4 +250,83 @@ TEST(FrameCombiner, GainCurveIsSmoothForAlternatingNumberOfStreams) {
     }
   }
 }
+
+// Like above, but with loud waves that have to be limited.
+TEST(FrameCombiner, LookaheadLimiterGainCurveIsSmoothForLoudMix) {
+  for (const int rate : {8000, 16000, 48000}) {
+    constexpr int number_of_channels = 2;
+    for (const float wave_frequency : {50, 400, 3200}) {
+      SCOPED_TRACE(ProduceDebugText(rate, number_of_channels, 2, true,
+                                    wave_frequency));
+
+      FrameCombiner combiner(FrameCombiner::LimiterType::kLookahead);
+
+      constexpr int16_t wave_amplitude = 30000;
+      SineWaveGenerator wave_generator(wave_frequency, wave_amplitude);
+
+      GainChangeCalculator change_calculator;
+      float cumulative_change = 0.f;
+
+      constexpr size_t iterations = 100;
+
+      for (size_t i = 0; i < iterations; ++i) {
+        SetUpFrames(rate, number_of_channels);
+        wave_generator.GenerateNextFrame(&frame1);
+        frame2.CopyFrom(frame1);
+        const size_t number_of_samples =
+            frame1.samples_per_channel_ * number_of_channels;
+
+        const std::vector<AudioFrame*> frames_to_combine = {&frame1, &frame2};
+        combiner.Combine(frames_to_combine, number_of_channels, rate,
+                         frames_to_combine.size(), &audio_frame_for_mixing);
+        cumulative_change += change_calculator.CalculateGainChange(
+            rtc::ArrayView<const int16_t>(frame1.data(), number_of_samples),
+            rtc::ArrayView<const int16_t>(audio_frame_for_mixing.data(),
+                                          number_of_samples));
+      }
+      EXPECT_LT(cumulative_change, 10);
+    }
+  }
+}
+
+// Measures the time to combine 48 kHz stereo frames with each limiter.
+TEST(FrameCombiner, DISABLED_CombinePerf) {
+  constexpr int kRate = 48000;
+  constexpr int kNumberOfChannels = 2;
+  constexpr int kIterations = 10000;
+  const struct {
+    FrameCombiner::LimiterType type;
+    const char* name;
+  } kLimiters[] = {{FrameCombiner::LimiterType::kNone, "none"},
+                   {FrameCombiner::LimiterType::kApm, "apm"},
+                   {FrameCombiner::LimiterType::kLookahead, "lookahead"}};
+  for (const auto& limiter : kLimiters) {
+    for (const size_t number_of_frames : {2, 3, 10}) {
+      std::vector<AudioFrame> frames(number_of_frames);
+      std::vector<AudioFrame*> frames_to_combine;
+      for (size_t i = 0; i < number_of_frames; ++i) {
+        frames[i].UpdateFrame(-1, 0, nullptr, kRate / 100, kRate,
+                              AudioFrame::kNormalSpeech,
+                              AudioFrame::kVadActive, kNumberOfChannels);
+        SineWaveGenerator wave_generator(100.f * (i + 1), 15000);
+        wave_generator.GenerateNextFrame(&frames[i]);
+        frames_to_combine.push_back(&frames[i]);
+      }
+
+      FrameCombiner combiner(limiter.type);
+      const int64_t start_ns = rtc::TimeNanos();
+      for (int i = 0; i < kIterations; ++i) {
+        combiner.Combine(frames_to_combine, kNumberOfChannels, kRate,
+                         frames_to_combine.size(), &audio_frame_for_mixing);
+      }
+      const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+      std::ostringstream trace;
+      trace << limiter.name << "_" << number_of_frames << "_streams";
+      webrtc::test::PrintResult("frame_combiner_time", "", trace.str(),
+                                static_cast<size_t>(elapsed_ns / kIterations),
+                                "ns/frame", false);
+    }
+  }
+}
 }  // namespace webrtc
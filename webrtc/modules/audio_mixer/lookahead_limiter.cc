@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/lookahead_limiter.h"
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr float kMaxOutput = 32767.f;
+
+// The share of the remaining distance to unity gain that is recovered per
+// subframe. With 0.5 ms subframes, this gives a release time of about 250 ms,
+// which is slow enough to not follow the waveform of low frequencies.
+constexpr float kReleaseRate = 0.002f;
+
+// Gains above this are rounded to unity, to end the release.
+constexpr float kUnityGainThreshold = 0.999f;
+
+}  // namespace
+
+constexpr size_t LookaheadLimiter::kMaxFrameSize;
+constexpr size_t LookaheadLimiter::kNumSubframes;
+
+LookaheadLimiter::LookaheadLimiter(MixingOptimization optimization)
+    : kernels_(optimization) {}
+
+LookaheadLimiter::~LookaheadLimiter() = default;
+
+void LookaheadLimiter::Process(rtc::ArrayView<const int32_t> sums,
+                               size_t num_channels,
+                               rtc::ArrayView<int16_t> output) {
+  RTC_DCHECK_EQ(sums.size(), output.size());
+  RTC_DCHECK_GE(kMaxFrameSize, sums.size());
+  RTC_DCHECK_LT(0u, num_channels);
+  RTC_DCHECK_EQ(0u, sums.size() % num_channels);
+  const size_t samples_per_channel = sums.size() / num_channels;
+
+  // The subframe k covers the samples per channel in
+  // [boundaries[k], boundaries[k + 1]).
+  std::array<size_t, kNumSubframes + 1> boundaries;
+  for (size_t k = 0; k <= kNumSubframes; ++k) {
+    boundaries[k] = k * samples_per_channel / kNumSubframes;
+  }
+
+  // The highest gain that keeps each subframe within the int16 range.
+  std::array<float, kNumSubframes> max_gains;
+  bool limiting = last_gain_ < 1.f;
+  for (size_t k = 0; k < kNumSubframes; ++k) {
+    const float peak = kernels_.MaxAbs(sums.subview(
+        boundaries[k] * num_channels,
+        (boundaries[k + 1] - boundaries[k]) * num_channels));
+    max_gains[k] = peak > kMaxOutput ? kMaxOutput / peak : 1.f;
+    limiting = limiting || max_gains[k] < 1.f;
+  }
+
+  if (!limiting) {
+    kernels_.Saturate(sums, output);
+    return;
+  }
+
+  // The gain at the start of subframe k is limited by the peaks of both
+  // subframe k - 1 and subframe k, so the gain stays below the limit of each
+  // subframe while it's interpolated over it.
+  std::array<float, kNumSubframes + 1> gains_at_boundaries;
+  gains_at_boundaries[0] = last_gain_;
+  for (size_t k = 1; k <= kNumSubframes; ++k) {
+    const float limit =
+        k < kNumSubframes ? std::min(max_gains[k - 1], max_gains[k])
+                          : max_gains[k - 1];
+    const float previous = gains_at_boundaries[k - 1];
+    float released = previous + (1.f - previous) * kReleaseRate;
+    if (released > kUnityGainThreshold) {
+      released = 1.f;
+    }
+    gains_at_boundaries[k] = std::min(limit, released);
+  }
+
+  for (size_t k = 0; k < kNumSubframes; ++k) {
+    const size_t length = boundaries[k + 1] - boundaries[k];
+    if (length == 0) {
+      continue;
+    }
+    const float start_gain = gains_at_boundaries[k];
+    const float step = (gains_at_boundaries[k + 1] - start_gain) / length;
+    float* gains = &gains_[boundaries[k] * num_channels];
+    for (size_t i = 0; i < length; ++i) {
+      std::fill(gains + i * num_channels, gains + (i + 1) * num_channels,
+                start_gain + i * step);
+    }
+  }
+  last_gain_ = gains_at_boundaries[kNumSubframes];
+
+  kernels_.ApplyGainAndSaturate(
+      sums, rtc::ArrayView<const float>(gains_.data(), sums.size()), output);
+}
+
+}  // namespace webrtc
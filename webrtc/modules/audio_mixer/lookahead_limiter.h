@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_MIXER_LOOKAHEAD_LIMITER_H_
+#define WEBRTC_MODULES_AUDIO_MIXER_LOOKAHEAD_LIMITER_H_
+
+#include <array>
+
+#include "webrtc/modules/audio_mixer/mixing_kernels.h"
+#include "webrtc/rtc_base/array_view.h"
+#include "webrtc/rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Brings the int32 sums of mixed audio into the int16 range with a smoothly
+// varying gain, instead of clipping them. Each 10 ms frame is split into
+// subframes, and the gain needed for the peak of each subframe is reached by
+// the start of that subframe, i.e. the limiter looks ahead one subframe. In
+// between, the gain is interpolated linearly, and it returns to unity with a
+// release time of about 250 ms. Since the look-ahead doesn't reach into the
+// next frame, a peak at the very start of a frame may still be clipped.
+class LookaheadLimiter {
+ public:
+  // Stereo, 48 kHz, 10 ms.
+  static constexpr size_t kMaxFrameSize = 2 * 48 * 10;
+  static constexpr size_t kNumSubframes = 20;
+
+  explicit LookaheadLimiter(MixingOptimization optimization);
+  ~LookaheadLimiter();
+
+  // Limits the interleaved |sums| of a 10 ms frame with |num_channels|
+  // channels into |output|.
+  void Process(rtc::ArrayView<const int32_t> sums,
+               size_t num_channels,
+               rtc::ArrayView<int16_t> output);
+
+  // The gain at the end of the last processed frame.
+  float last_gain() const { return last_gain_; }
+
+ private:
+  const MixingKernels kernels_;
+  float last_gain_ = 1.f;
+  std::array<float, kMaxFrameSize> gains_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LookaheadLimiter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_MIXER_LOOKAHEAD_LIMITER_H_
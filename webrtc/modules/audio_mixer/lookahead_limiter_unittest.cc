@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/lookahead_limiter.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumChannels = 2;
+constexpr size_t kSamplesPerChannel = 480;
+
+// Interleaved stereo sums of three full scale sines, starting with a zero
+// crossing so that the frame doesn't start with a peak.
+std::vector<int32_t> LoudSums(size_t frame_index) {
+  std::vector<int32_t> sums(kSamplesPerChannel * kNumChannels);
+  for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+    const float t = (frame_index * kSamplesPerChannel + i) / 48000.f;
+    const float value = 32767.f * (sinf(2 * M_PI * 300 * t) +
+                                   sinf(2 * M_PI * 500 * t) +
+                                   sinf(2 * M_PI * 700 * t));
+    for (size_t ch = 0; ch < kNumChannels; ++ch) {
+      sums[i * kNumChannels + ch] = static_cast<int32_t>(value);
+    }
+  }
+  return sums;
+}
+
+}  // namespace
+
+TEST(LookaheadLimiter, QuietSumsPassUnchanged) {
+  LookaheadLimiter limiter(DetectMixingOptimization());
+  std::vector<int32_t> sums(kSamplesPerChannel * kNumChannels);
+  for (size_t i = 0; i < sums.size(); ++i) {
+    sums[i] = static_cast<int32_t>(i * 64) - 32767;
+  }
+  std::vector<int16_t> output(sums.size());
+  limiter.Process(sums, kNumChannels, output);
+  for (size_t i = 0; i < sums.size(); ++i) {
+    ASSERT_EQ(sums[i], output[i]);
+  }
+  EXPECT_EQ(1.f, limiter.last_gain());
+}
+
+TEST(LookaheadLimiter, LimitsLoudSumsWithoutClipping) {
+  LookaheadLimiter limiter(DetectMixingOptimization());
+  std::vector<int16_t> output(kSamplesPerChannel * kNumChannels);
+  float previous_gain = limiter.last_gain();
+  for (size_t frame = 0; frame < 10; ++frame) {
+    const std::vector<int32_t> sums = LoudSums(frame);
+    limiter.Process(sums, kNumChannels, output);
+    for (size_t i = 0; i < sums.size(); ++i) {
+      ASSERT_LE(-32767, output[i]);
+      // Away from the zero crossings, where rounding dominates, the applied
+      // gain is at most unity and changes smoothly. Clipping would make it
+      // jump at the peaks.
+      if (abs(sums[i]) > 10000) {
+        const float gain = static_cast<float>(output[i]) / sums[i];
+        ASSERT_LT(0.f, gain);
+        ASSERT_GE(1.f, gain);
+        // The onset at the very start can't be seen ahead of time.
+        if (frame > 0) {
+          ASSERT_NEAR(previous_gain, gain, 0.01f);
+        }
+        previous_gain = gain;
+      }
+    }
+    EXPECT_GT(1.f, limiter.last_gain());
+  }
+}
+
+TEST(LookaheadLimiter, GainIsReleasedAfterLoudSums) {
+  LookaheadLimiter limiter(DetectMixingOptimization());
+  std::vector<int16_t> output(kSamplesPerChannel * kNumChannels);
+  const std::vector<int32_t> sums = LoudSums(0);
+  limiter.Process(sums, kNumChannels, output);
+  float gain = limiter.last_gain();
+  ASSERT_GT(1.f, gain);
+
+  // The gain rises monotonically, and reaches unity within two seconds.
+  const std::vector<int32_t> silence(output.size(), 0);
+  for (size_t frame = 0; frame < 200; ++frame) {
+    limiter.Process(silence, kNumChannels, output);
+    EXPECT_LE(gain, limiter.last_gain());
+    gain = limiter.last_gain();
+  }
+  EXPECT_EQ(1.f, gain);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/mixing_kernels.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/safe_conversions.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+constexpr float kMinInt16 = -32768.f;
+constexpr float kMaxInt16 = 32767.f;
+
+// Rounds half away from zero, which all the optimizations can do alike.
+int16_t ScaleAndRound(int32_t x, float gain) {
+  const float y =
+      std::min(std::max(static_cast<float>(x) * gain, kMinInt16), kMaxInt16);
+  return static_cast<int16_t>(y + (y < 0.f ? -0.5f : 0.5f));
+}
+
+}  // namespace
+
+MixingOptimization DetectMixingOptimization() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    return MixingOptimization::kSse2;
+  }
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+  return MixingOptimization::kNeon;
+#endif
+
+  return MixingOptimization::kNone;
+}
+
+void MixingKernels::Accumulate(rtc::ArrayView<const int16_t> x,
+                               rtc::ArrayView<int32_t> sum) const {
+  RTC_DCHECK_EQ(x.size(), sum.size());
+  const size_t size = x.size();
+  size_t j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case MixingOptimization::kSse2:
+      for (; j + 8 <= size; j += 8) {
+        const __m128i x_j =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&x[j]));
+        // Sign extend by unpacking into the upper halves and shifting down.
+        const __m128i x_low = _mm_srai_epi32(_mm_unpacklo_epi16(x_j, x_j), 16);
+        const __m128i x_high =
+            _mm_srai_epi32(_mm_unpackhi_epi16(x_j, x_j), 16);
+        __m128i* sum_j = reinterpret_cast<__m128i*>(&sum[j]);
+        _mm_storeu_si128(sum_j, _mm_add_epi32(_mm_loadu_si128(sum_j), x_low));
+        _mm_storeu_si128(sum_j + 1,
+                         _mm_add_epi32(_mm_loadu_si128(sum_j + 1), x_high));
+      }
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case MixingOptimization::kNeon:
+      for (; j + 8 <= size; j += 8) {
+        const int16x8_t x_j = vld1q_s16(&x[j]);
+        vst1q_s32(&sum[j], vaddw_s16(vld1q_s32(&sum[j]), vget_low_s16(x_j)));
+        vst1q_s32(&sum[j + 4],
+                  vaddw_s16(vld1q_s32(&sum[j + 4]), vget_high_s16(x_j)));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+  for (; j < size; ++j) {
+    sum[j] += x[j];
+  }
+}
+
+float MixingKernels::MaxAbs(rtc::ArrayView<const int32_t> x) const {
+  const size_t size = x.size();
+  size_t j = 0;
+  float max_abs = 0.f;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case MixingOptimization::kSse2: {
+      const __m128 sign_mask = _mm_set1_ps(-0.f);
+      __m128 max_abs_4 = _mm_setzero_ps();
+      for (; j + 4 <= size; j += 4) {
+        const __m128 x_j = _mm_cvtepi32_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&x[j])));
+        max_abs_4 = _mm_max_ps(max_abs_4, _mm_andnot_ps(sign_mask, x_j));
+      }
+      float max_abs_values[4];
+      _mm_storeu_ps(max_abs_values, max_abs_4);
+      max_abs = *std::max_element(max_abs_values, max_abs_values + 4);
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case MixingOptimization::kNeon: {
+      float32x4_t max_abs_4 = vdupq_n_f32(0.f);
+      for (; j + 4 <= size; j += 4) {
+        max_abs_4 =
+            vmaxq_f32(max_abs_4, vabsq_f32(vcvtq_f32_s32(vld1q_s32(&x[j]))));
+      }
+      float max_abs_values[4];
+      vst1q_f32(max_abs_values, max_abs_4);
+      max_abs = *std::max_element(max_abs_values, max_abs_values + 4);
+    } break;
+#endif
+    default:
+      break;
+  }
+  for (; j < size; ++j) {
+    max_abs = std::max(max_abs, fabsf(static_cast<float>(x[j])));
+  }
+  return max_abs;
+}
+
+void MixingKernels::Saturate(rtc::ArrayView<const int32_t> x,
+                             rtc::ArrayView<int16_t> y) const {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  const size_t size = x.size();
+  size_t j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case MixingOptimization::kSse2:
+      for (; j + 8 <= size; j += 8) {
+        const __m128i* x_j = reinterpret_cast<const __m128i*>(&x[j]);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(&y[j]),
+            _mm_packs_epi32(_mm_loadu_si128(x_j), _mm_loadu_si128(x_j + 1)));
+      }
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case MixingOptimization::kNeon:
+      for (; j + 8 <= size; j += 8) {
+        vst1q_s16(&y[j], vcombine_s16(vqmovn_s32(vld1q_s32(&x[j])),
+                                      vqmovn_s32(vld1q_s32(&x[j + 4]))));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+  for (; j < size; ++j) {
+    y[j] = rtc::saturated_cast<int16_t>(x[j]);
+  }
+}
+
+void MixingKernels::ApplyGainAndSaturate(rtc::ArrayView<const int32_t> x,
+                                         rtc::ArrayView<const float> gain,
+                                         rtc::ArrayView<int16_t> y) const {
+  RTC_DCHECK_EQ(x.size(), gain.size());
+  RTC_DCHECK_EQ(x.size(), y.size());
+  const size_t size = x.size();
+  size_t j = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case MixingOptimization::kSse2: {
+      const __m128 min_value = _mm_set1_ps(kMinInt16);
+      const __m128 max_value = _mm_set1_ps(kMaxInt16);
+      const __m128 sign_mask = _mm_set1_ps(-0.f);
+      const __m128 half = _mm_set1_ps(0.5f);
+      __m128i y_4[2];
+      for (; j + 8 <= size; j += 8) {
+        for (int k = 0; k < 2; ++k) {
+          __m128 y_k = _mm_mul_ps(
+              _mm_cvtepi32_ps(_mm_loadu_si128(
+                  reinterpret_cast<const __m128i*>(&x[j + 4 * k]))),
+              _mm_loadu_ps(&gain[j + 4 * k]));
+          y_k = _mm_min_ps(_mm_max_ps(y_k, min_value), max_value);
+          // Add 0.5 with the sign of the value, and truncate.
+          y_k = _mm_add_ps(y_k, _mm_or_ps(_mm_and_ps(y_k, sign_mask), half));
+          y_4[k] = _mm_cvttps_epi32(y_k);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&y[j]),
+                         _mm_packs_epi32(y_4[0], y_4[1]));
+      }
+    } break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case MixingOptimization::kNeon: {
+      const float32x4_t min_value = vdupq_n_f32(kMinInt16);
+      const float32x4_t max_value = vdupq_n_f32(kMaxInt16);
+      const uint32x4_t sign_mask = vdupq_n_u32(0x80000000);
+      const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+      int16x4_t y_4[2];
+      for (; j + 8 <= size; j += 8) {
+        for (int k = 0; k < 2; ++k) {
+          float32x4_t y_k = vmulq_f32(vcvtq_f32_s32(vld1q_s32(&x[j + 4 * k])),
+                                      vld1q_f32(&gain[j + 4 * k]));
+          y_k = vminq_f32(vmaxq_f32(y_k, min_value), max_value);
+          // Add 0.5 with the sign of the value, and truncate.
+          const uint32x4_t signed_half =
+              vorrq_u32(vandq_u32(vreinterpretq_u32_f32(y_k), sign_mask), half);
+          y_k = vaddq_f32(y_k, vreinterpretq_f32_u32(signed_half));
+          y_4[k] = vmovn_s32(vcvtq_s32_f32(y_k));
+        }
+        vst1q_s16(&y[j], vcombine_s16(y_4[0], y_4[1]));
+      }
+    } break;
+#endif
+    default:
+      break;
+  }
+  for (; j < size; ++j) {
+    y[j] = ScaleAndRound(x[j], gain[j]);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_MIXER_MIXING_KERNELS_H_
+#define WEBRTC_MODULES_AUDIO_MIXER_MIXING_KERNELS_H_
+
+#include "webrtc/rtc_base/array_view.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+enum class MixingOptimization { kNone, kSse2, kNeon };
+
+// Returns the best optimization supported by the current CPU.
+MixingOptimization DetectMixingOptimization();
+
+// The vector operations of the FrameCombiner. All optimizations give the same
+// results.
+class MixingKernels {
+ public:
+  explicit MixingKernels(MixingOptimization optimization)
+      : optimization_(optimization) {}
+
+  // sum[i] += x[i].
+  void Accumulate(rtc::ArrayView<const int16_t> x,
+                  rtc::ArrayView<int32_t> sum) const;
+
+  // Returns the largest magnitude of the elements of |x|.
+  float MaxAbs(rtc::ArrayView<const int32_t> x) const;
+
+  // y[i] = x[i], saturated to the int16 range.
+  void Saturate(rtc::ArrayView<const int32_t> x,
+                rtc::ArrayView<int16_t> y) const;
+
+  // y[i] = x[i] * gain[i], rounded to the nearest integer and saturated to
+  // the int16 range.
+  void ApplyGainAndSaturate(rtc::ArrayView<const int32_t> x,
+                            rtc::ArrayView<const float> gain,
+                            rtc::ArrayView<int16_t> y) const;
+
+ private:
+  const MixingOptimization optimization_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_MIXER_MIXING_KERNELS_H_
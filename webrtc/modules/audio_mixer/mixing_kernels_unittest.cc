@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/mixing_kernels.h"
+
+#include <vector>
+
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Odd, so that the scalar tails of the optimizations are tested too.
+constexpr size_t kSize = 963;
+
+std::vector<int32_t> RandomSums(Random* random) {
+  std::vector<int32_t> x(kSize);
+  for (auto& x_k : x) {
+    x_k = random->Rand(-4 * 32768, 4 * 32767);
+  }
+  return x;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY) || defined(WEBRTC_HAS_NEON)
+void VerifyOptimization(MixingOptimization optimization) {
+  const MixingKernels reference(MixingOptimization::kNone);
+  const MixingKernels optimized(optimization);
+  Random random(42);
+
+  for (int iteration = 0; iteration < 10; ++iteration) {
+    std::vector<int16_t> x(kSize);
+    for (auto& x_k : x) {
+      x_k = random.Rand(-32768, 32767);
+    }
+    std::vector<int32_t> sum_reference = RandomSums(&random);
+    std::vector<int32_t> sum_optimized = sum_reference;
+    reference.Accumulate(x, sum_reference);
+    optimized.Accumulate(x, sum_optimized);
+    EXPECT_EQ(sum_reference, sum_optimized);
+
+    EXPECT_EQ(reference.MaxAbs(sum_reference),
+              optimized.MaxAbs(sum_reference));
+
+    std::vector<int16_t> y_reference(kSize);
+    std::vector<int16_t> y_optimized(kSize);
+    reference.Saturate(sum_reference, y_reference);
+    optimized.Saturate(sum_reference, y_optimized);
+    EXPECT_EQ(y_reference, y_optimized);
+
+    std::vector<float> gain(kSize);
+    for (auto& gain_k : gain) {
+      gain_k = random.Rand<float>() * 1.5f;
+    }
+    reference.ApplyGainAndSaturate(sum_reference, gain, y_reference);
+    optimized.ApplyGainAndSaturate(sum_reference, gain, y_optimized);
+    EXPECT_EQ(y_reference, y_optimized);
+  }
+}
+#endif
+
+}  // namespace
+
+TEST(MixingKernels, Accumulate) {
+  const MixingKernels kernels(MixingOptimization::kNone);
+  const std::vector<int16_t> x = {-32768, -1, 0, 1, 32767};
+  std::vector<int32_t> sum = {-32768, 1, 2, -1, 32767};
+  kernels.Accumulate(x, sum);
+  EXPECT_EQ(std::vector<int32_t>({-65536, 0, 2, 0, 65534}), sum);
+}
+
+TEST(MixingKernels, MaxAbs) {
+  const MixingKernels kernels(MixingOptimization::kNone);
+  const std::vector<int32_t> empty;
+  EXPECT_EQ(0.f, kernels.MaxAbs(empty));
+  const std::vector<int32_t> x = {1, -70000, 5};
+  EXPECT_EQ(70000.f, kernels.MaxAbs(x));
+}
+
+TEST(MixingKernels, Saturate) {
+  const MixingKernels kernels(MixingOptimization::kNone);
+  const std::vector<int32_t> x = {-70000, -32769, -1, 32767, 32768};
+  std::vector<int16_t> y(x.size());
+  kernels.Saturate(x, y);
+  EXPECT_EQ(std::vector<int16_t>({-32768, -32768, -1, 32767, 32767}), y);
+}
+
+TEST(MixingKernels, ApplyGainAndSaturateRoundsHalfAwayFromZero) {
+  const MixingKernels kernels(MixingOptimization::kNone);
+  const std::vector<int32_t> x = {-3, -1, 1, 3, 70000, -70000};
+  const std::vector<float> gain = {0.5f, 0.5f, 0.5f, 0.5f, 1.f, 1.f};
+  std::vector<int16_t> y(x.size());
+  kernels.ApplyGainAndSaturate(x, gain, y);
+  EXPECT_EQ(std::vector<int16_t>({-2, -1, 1, 2, 32767, -32768}), y);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Verifies that the SSE2 kernels give the same results as the reference.
+TEST(MixingKernels, Sse2MatchesReference) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    VerifyOptimization(MixingOptimization::kSse2);
+  }
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// Verifies that the NEON kernels give the same results as the reference.
+TEST(MixingKernels, NeonMatchesReference) {
+  VerifyOptimization(MixingOptimization::kNeon);
+}
+#endif
+
+}  // namespace webrtc
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/parallel_task_runner.h"
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/ptr_util.h"
+
+namespace webrtc {
+namespace {
+const char kThreadName[] = "AudioMixerWorker";
+}  // namespace
+
+ParallelTaskRunner::Worker::Worker(ParallelTaskRunner* runner)
+    : runner(runner), wake_up_event(false, false) {}
+
+ParallelTaskRunner::ParallelTaskRunner(int num_threads)
+    : task_(nullptr),
+      num_tasks_(0),
+      next_task_(0),
+      tasks_pending_(0),
+      stopping_(false),
+      tasks_done_event_(false, false) {
+  RTC_DCHECK_GT(num_threads, 0);
+  // The calling thread is one of the |num_threads|.
+  for (int i = 1; i < num_threads; ++i) {
+    workers_.push_back(rtc::MakeUnique<Worker>(this));
+    Worker* const worker = workers_.back().get();
+    worker->thread = rtc::MakeUnique<rtc::PlatformThread>(
+        &WorkerThreadFunction, worker, kThreadName, rtc::kRealtimePriority);
+    worker->thread->Start();
+  }
+}
+
+ParallelTaskRunner::~ParallelTaskRunner() {
+  {
+    rtc::CritScope lock(&crit_);
+    stopping_ = true;
+  }
+  for (auto& worker : workers_)
+    worker->wake_up_event.Set();
+  for (auto& worker : workers_)
+    worker->thread->Stop();
+}
+
+void ParallelTaskRunner::Run(size_t num_tasks,
+                             rtc::FunctionView<void(size_t)> task) {
+  if (num_tasks == 0)
+    return;
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK_EQ(tasks_pending_, 0);
+    task_ = &task;
+    num_tasks_ = num_tasks;
+    next_task_ = 0;
+    tasks_pending_ = num_tasks;
+  }
+  // No more workers are woken up than there are tasks for.
+  for (size_t i = 0; i < workers_.size() && i + 1 < num_tasks; ++i)
+    workers_[i]->wake_up_event.Set();
+  RunTasks();
+  tasks_done_event_.Wait(rtc::Event::kForever);
+  rtc::CritScope lock(&crit_);
+  task_ = nullptr;
+}
+
+void ParallelTaskRunner::WorkerThreadFunction(void* ptr) {
+  Worker* const worker = static_cast<Worker*>(ptr);
+  worker->runner->RunWorker(worker);
+}
+
+void ParallelTaskRunner::RunWorker(Worker* worker) {
+  while (true) {
+    worker->wake_up_event.Wait(rtc::Event::kForever);
+    {
+      rtc::CritScope lock(&crit_);
+      if (stopping_)
+        return;
+    }
+    RunTasks();
+  }
+}
+
+void ParallelTaskRunner::RunTasks() {
+  while (true) {
+    rtc::FunctionView<void(size_t)>* task;
+    size_t index;
+    {
+      rtc::CritScope lock(&crit_);
+      // Also the case for workers woken up after the tasks are all done.
+      if (!task_ || next_task_ == num_tasks_)
+        return;
+      task = task_;
+      index = next_task_++;
+    }
+    (*task)(index);
+    rtc::CritScope lock(&crit_);
+    if (--tasks_pending_ == 0)
+      tasks_done_event_.Set();
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_MIXER_PARALLEL_TASK_RUNNER_H_
+#define WEBRTC_MODULES_AUDIO_MIXER_PARALLEL_TASK_RUNNER_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/function_view.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Runs a number of tasks on a fixed set of worker threads together with the
+// calling thread, and returns once all of them have run. Used by the mixer to
+// pull many sources, each of which decodes its own audio, in parallel.
+class ParallelTaskRunner {
+ public:
+  // Runs the tasks on |num_threads| threads, the calling thread included.
+  explicit ParallelTaskRunner(int num_threads);
+  ~ParallelTaskRunner();
+
+  // Runs |task| with every index from 0 to |num_tasks| - 1, in no particular
+  // order. Must not be called by more than one thread at a time.
+  void Run(size_t num_tasks, rtc::FunctionView<void(size_t)> task);
+
+ private:
+  struct Worker {
+    explicit Worker(ParallelTaskRunner* runner);
+
+    ParallelTaskRunner* const runner;
+    // Signaled when there are tasks to run, or when stopping.
+    rtc::Event wake_up_event;
+    std::unique_ptr<rtc::PlatformThread> thread;
+  };
+
+  static void WorkerThreadFunction(void* ptr);
+  void RunWorker(Worker* worker);
+  // Runs tasks until none are left to start.
+  void RunTasks();
+
+  rtc::CriticalSection crit_;
+  rtc::FunctionView<void(size_t)>* task_ GUARDED_BY(crit_);
+  size_t num_tasks_ GUARDED_BY(crit_);
+  size_t next_task_ GUARDED_BY(crit_);
+  size_t tasks_pending_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+  // Signaled when the last task of a Run() call is done.
+  rtc::Event tasks_done_event_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ParallelTaskRunner);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_MIXER_PARALLEL_TASK_RUNNER_H_
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+#include <vector>
+
+#include "webrtc/modules/audio_mixer/parallel_task_runner.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+constexpr int kTimeoutMs = 5000;
+}  // namespace
+
+TEST(ParallelTaskRunnerTest, RunsEveryTaskOnce) {
+  ParallelTaskRunner runner(4);
+  for (size_t num_tasks : {0, 1, 3, 4, 100}) {
+    std::vector<int> runs(num_tasks, 0);
+    runner.Run(num_tasks, [&runs](size_t i) { ++runs[i]; });
+    EXPECT_EQ(std::vector<int>(num_tasks, 1), runs);
+  }
+}
+
+TEST(ParallelTaskRunnerTest, RunsTasksOnSeveralThreads) {
+  const size_t kNumTasks = 4;
+  ParallelTaskRunner runner(kNumTasks);
+  rtc::CriticalSection crit;
+  std::set<rtc::PlatformThreadId> threads;
+  size_t num_started = 0;
+  rtc::Event all_started(true, false);
+  runner.Run(kNumTasks, [&](size_t i) {
+    {
+      rtc::CritScope lock(&crit);
+      threads.insert(rtc::CurrentThreadId());
+      if (++num_started == kNumTasks)
+        all_started.Set();
+    }
+    // Each thread takes one task only, as the tasks wait for each other.
+    EXPECT_TRUE(all_started.Wait(kTimeoutMs));
+  });
+  EXPECT_EQ(kNumTasks, threads.size());
+}
+
+TEST(ParallelTaskRunnerTest, RunsOnCallingThreadAlone) {
+  ParallelTaskRunner runner(1);
+  const rtc::PlatformThreadRef thread = rtc::CurrentThreadRef();
+  bool on_calling_thread = true;
+  runner.Run(10, [&](size_t i) {
+    on_calling_thread &= rtc::IsThreadRefEqual(thread, rtc::CurrentThreadRef());
+  });
+  EXPECT_TRUE(on_calling_thread);
+}
+
+}  // namespace webrtc
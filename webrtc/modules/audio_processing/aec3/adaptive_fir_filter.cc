@@ -449,6 +449,9 @@ void AdaptiveFirFilter::Filter(const RenderBuffer& render_buffer,
     case Aec3Optimization::kSse2:
       aec3::ApplyFilter_SSE2(render_buffer, H_, S);
       break;
+    case Aec3Optimization::kAvx2:
+      aec3::ApplyFilter_AVX2(render_buffer, H_, S);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
@@ -468,6 +471,9 @@ void AdaptiveFirFilter::Adapt(const RenderBuffer& render_buffer,
     case Aec3Optimization::kSse2:
       aec3::AdaptPartitions_SSE2(render_buffer, G, H_);
       break;
+    case Aec3Optimization::kAvx2:
+      aec3::AdaptPartitions_AVX2(render_buffer, G, H_);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
@@ -488,6 +494,10 @@ void AdaptiveFirFilter::Adapt(const RenderBuffer& render_buffer,
       aec3::UpdateFrequencyResponse_SSE2(H_, &H2_);
       aec3::UpdateErlEstimator_SSE2(H2_, &erl_);
       break;
+    case Aec3Optimization::kAvx2:
+      aec3::UpdateFrequencyResponse_AVX2(H_, &H2_);
+      aec3::UpdateErlEstimator_AVX2(H2_, &erl_);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
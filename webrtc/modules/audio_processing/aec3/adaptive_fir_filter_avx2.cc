@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/aec3/adaptive_fir_filter.h"
+
+#include <immintrin.h>
+#include <algorithm>
+
+#include "webrtc/modules/audio_processing/aec3/fft_data.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace aec3 {
+
+// The AVX2 variants follow the operation order of the reference code, without
+// fused multiply-adds, so the filter stays bitexact to it; the adaptation
+// would otherwise amplify the rounding differences.
+
+// Computes and stores the frequency response of the filter.
+void UpdateFrequencyResponse_AVX2(
+    rtc::ArrayView<const FftData> H,
+    std::vector<std::array<float, kFftLengthBy2Plus1>>* H2) {
+  RTC_DCHECK_EQ(H.size(), H2->size());
+  for (size_t k = 0; k < H.size(); ++k) {
+    for (size_t j = 0; j < kFftLengthBy2; j += 8) {
+      const __m256 re = _mm256_loadu_ps(&H[k].re[j]);
+      const __m256 im = _mm256_loadu_ps(&H[k].im[j]);
+      const __m256 re2 = _mm256_mul_ps(re, re);
+      const __m256 im2 = _mm256_mul_ps(im, im);
+      const __m256 H2_k_j = _mm256_add_ps(re2, im2);
+      _mm256_storeu_ps(&(*H2)[k][j], H2_k_j);
+    }
+    (*H2)[k][kFftLengthBy2] = H[k].re[kFftLengthBy2] * H[k].re[kFftLengthBy2] +
+                              H[k].im[kFftLengthBy2] * H[k].im[kFftLengthBy2];
+  }
+}
+
+// Computes and stores the echo return loss estimate of the filter, which is the
+// sum of the partition frequency responses.
+void UpdateErlEstimator_AVX2(
+    const std::vector<std::array<float, kFftLengthBy2Plus1>>& H2,
+    std::array<float, kFftLengthBy2Plus1>* erl) {
+  erl->fill(0.f);
+  for (auto& H2_j : H2) {
+    for (size_t k = 0; k < kFftLengthBy2; k += 8) {
+      const __m256 H2_j_k = _mm256_loadu_ps(&H2_j[k]);
+      __m256 erl_k = _mm256_loadu_ps(&(*erl)[k]);
+      erl_k = _mm256_add_ps(erl_k, H2_j_k);
+      _mm256_storeu_ps(&(*erl)[k], erl_k);
+    }
+    (*erl)[kFftLengthBy2] += H2_j[kFftLengthBy2];
+  }
+}
+
+// Adapts the filter partitions. (AVX2 variant)
+void AdaptPartitions_AVX2(const RenderBuffer& render_buffer,
+                          const FftData& G,
+                          rtc::ArrayView<FftData> H) {
+  rtc::ArrayView<const FftData> render_buffer_data = render_buffer.Buffer();
+  const int lim1 =
+      std::min(render_buffer_data.size() - render_buffer.Position(), H.size());
+  const int lim2 = H.size();
+  constexpr int kNumEightBinBands = kFftLengthBy2 / 8;
+  FftData* H_j;
+  const FftData* X;
+  int limit;
+  int j;
+  for (int k = 0, n = 0; n < kNumEightBinBands; ++n, k += 8) {
+    const __m256 G_re = _mm256_loadu_ps(&G.re[k]);
+    const __m256 G_im = _mm256_loadu_ps(&G.im[k]);
+
+    H_j = &H[0];
+    X = &render_buffer_data[render_buffer.Position()];
+    limit = lim1;
+    j = 0;
+    do {
+      for (; j < limit; ++j, ++H_j, ++X) {
+        const __m256 X_re = _mm256_loadu_ps(&X->re[k]);
+        const __m256 X_im = _mm256_loadu_ps(&X->im[k]);
+        const __m256 H_re = _mm256_loadu_ps(&H_j->re[k]);
+        const __m256 H_im = _mm256_loadu_ps(&H_j->im[k]);
+        const __m256 a = _mm256_mul_ps(X_re, G_re);
+        const __m256 b = _mm256_mul_ps(X_im, G_im);
+        const __m256 c = _mm256_mul_ps(X_re, G_im);
+        const __m256 d = _mm256_mul_ps(X_im, G_re);
+        const __m256 e = _mm256_add_ps(a, b);
+        const __m256 f = _mm256_sub_ps(c, d);
+        const __m256 g = _mm256_add_ps(H_re, e);
+        const __m256 h = _mm256_add_ps(H_im, f);
+        _mm256_storeu_ps(&H_j->re[k], g);
+        _mm256_storeu_ps(&H_j->im[k], h);
+      }
+
+      X = &render_buffer_data[0];
+      limit = lim2;
+    } while (j < lim2);
+  }
+
+  H_j = &H[0];
+  X = &render_buffer_data[render_buffer.Position()];
+  limit = lim1;
+  j = 0;
+  do {
+    for (; j < limit; ++j, ++H_j, ++X) {
+      H_j->re[kFftLengthBy2] += X->re[kFftLengthBy2] * G.re[kFftLengthBy2] +
+                                X->im[kFftLengthBy2] * G.im[kFftLengthBy2];
+      H_j->im[kFftLengthBy2] += X->re[kFftLengthBy2] * G.im[kFftLengthBy2] -
+                                X->im[kFftLengthBy2] * G.re[kFftLengthBy2];
+    }
+
+    X = &render_buffer_data[0];
+    limit = lim2;
+  } while (j < lim2);
+}
+
+// Produces the filter output (AVX2 variant).
+void ApplyFilter_AVX2(const RenderBuffer& render_buffer,
+                      rtc::ArrayView<const FftData> H,
+                      FftData* S) {
+  S->re.fill(0.f);
+  S->im.fill(0.f);
+
+  rtc::ArrayView<const FftData> render_buffer_data = render_buffer.Buffer();
+  const int lim1 =
+      std::min(render_buffer_data.size() - render_buffer.Position(), H.size());
+  const int lim2 = H.size();
+  constexpr int kNumEightBinBands = kFftLengthBy2 / 8;
+  const FftData* H_j = &H[0];
+  const FftData* X = &render_buffer_data[render_buffer.Position()];
+
+  int j = 0;
+  int limit = lim1;
+  do {
+    for (; j < limit; ++j, ++H_j, ++X) {
+      for (int k = 0, n = 0; n < kNumEightBinBands; ++n, k += 8) {
+        const __m256 X_re = _mm256_loadu_ps(&X->re[k]);
+        const __m256 X_im = _mm256_loadu_ps(&X->im[k]);
+        const __m256 H_re = _mm256_loadu_ps(&H_j->re[k]);
+        const __m256 H_im = _mm256_loadu_ps(&H_j->im[k]);
+        const __m256 S_re = _mm256_loadu_ps(&S->re[k]);
+        const __m256 S_im = _mm256_loadu_ps(&S->im[k]);
+        const __m256 a = _mm256_mul_ps(X_re, H_re);
+        const __m256 b = _mm256_mul_ps(X_im, H_im);
+        const __m256 c = _mm256_mul_ps(X_re, H_im);
+        const __m256 d = _mm256_mul_ps(X_im, H_re);
+        const __m256 e = _mm256_sub_ps(a, b);
+        const __m256 f = _mm256_add_ps(c, d);
+        const __m256 g = _mm256_add_ps(S_re, e);
+        const __m256 h = _mm256_add_ps(S_im, f);
+        _mm256_storeu_ps(&S->re[k], g);
+        _mm256_storeu_ps(&S->im[k], h);
+      }
+    }
+    limit = lim2;
+    X = &render_buffer_data[0];
+  } while (j < lim2);
+
+  H_j = &H[0];
+  X = &render_buffer_data[render_buffer.Position()];
+  j = 0;
+  limit = lim1;
+  do {
+    for (; j < limit; ++j, ++H_j, ++X) {
+      S->re[kFftLengthBy2] += X->re[kFftLengthBy2] * H_j->re[kFftLengthBy2] -
+                              X->im[kFftLengthBy2] * H_j->im[kFftLengthBy2];
+      S->im[kFftLengthBy2] += X->re[kFftLengthBy2] * H_j->im[kFftLengthBy2] +
+                              X->im[kFftLengthBy2] * H_j->re[kFftLengthBy2];
+    }
+    limit = lim2;
+    X = &render_buffer_data[0];
+  } while (j < lim2);
+}
+
+}  // namespace aec3
+}  // namespace webrtc
@@ -252,6 +252,113 @@ TEST(AdaptiveFirFilter, UpdateErlSse2Optimization) {
   }
 }
 
+// Verifies that the AVX2 methods for filter adaptation are bitexact to their
+// reference counterparts.
+TEST(AdaptiveFirFilter, FilterAdaptationAvx2Optimizations) {
+  bool use_avx2 =
+      WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0;
+  if (use_avx2) {
+    RenderBuffer render_buffer(Aec3Optimization::kNone, 3, 12,
+                               std::vector<size_t>(1, 12));
+    Random random_generator(42U);
+    std::vector<std::vector<float>> x(3, std::vector<float>(kBlockSize, 0.f));
+    FftData S_C;
+    FftData S_AVX2;
+    FftData G;
+    Aec3Fft fft;
+    std::vector<FftData> H_C(10);
+    std::vector<FftData> H_AVX2(10);
+    for (auto& H_j : H_C) {
+      H_j.Clear();
+    }
+    for (auto& H_j : H_AVX2) {
+      H_j.Clear();
+    }
+
+    for (size_t k = 0; k < 500; ++k) {
+      RandomizeSampleVector(&random_generator, x[0]);
+      render_buffer.Insert(x);
+
+      ApplyFilter_AVX2(render_buffer, H_AVX2, &S_AVX2);
+      ApplyFilter(render_buffer, H_C, &S_C);
+      for (size_t j = 0; j < S_C.re.size(); ++j) {
+        EXPECT_FLOAT_EQ(S_C.re[j], S_AVX2.re[j]);
+        EXPECT_FLOAT_EQ(S_C.im[j], S_AVX2.im[j]);
+      }
+
+      std::for_each(G.re.begin(), G.re.end(),
+                    [&](float& a) { a = random_generator.Rand<float>(); });
+      std::for_each(G.im.begin(), G.im.end(),
+                    [&](float& a) { a = random_generator.Rand<float>(); });
+
+      AdaptPartitions_AVX2(render_buffer, G, H_AVX2);
+      AdaptPartitions(render_buffer, G, H_C);
+
+      for (size_t k = 0; k < H_C.size(); ++k) {
+        for (size_t j = 0; j < H_C[k].re.size(); ++j) {
+          EXPECT_FLOAT_EQ(H_C[k].re[j], H_AVX2[k].re[j]);
+          EXPECT_FLOAT_EQ(H_C[k].im[j], H_AVX2[k].im[j]);
+        }
+      }
+    }
+  }
+}
+
+// Verifies that the AVX2 method for frequency response computation is
+// bitexact to the reference counterpart.
+TEST(AdaptiveFirFilter, UpdateFrequencyResponseAvx2Optimization) {
+  bool use_avx2 =
+      WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0;
+  if (use_avx2) {
+    const size_t kNumPartitions = 12;
+    std::vector<FftData> H(kNumPartitions);
+    std::vector<std::array<float, kFftLengthBy2Plus1>> H2(kNumPartitions);
+    std::vector<std::array<float, kFftLengthBy2Plus1>> H2_AVX2(kNumPartitions);
+
+    for (size_t j = 0; j < H.size(); ++j) {
+      for (size_t k = 0; k < H[j].re.size(); ++k) {
+        H[j].re[k] = k + j / 3.f;
+        H[j].im[k] = j + k / 7.f;
+      }
+    }
+
+    UpdateFrequencyResponse(H, &H2);
+    UpdateFrequencyResponse_AVX2(H, &H2_AVX2);
+
+    for (size_t j = 0; j < H2.size(); ++j) {
+      for (size_t k = 0; k < H[j].re.size(); ++k) {
+        EXPECT_FLOAT_EQ(H2[j][k], H2_AVX2[j][k]);
+      }
+    }
+  }
+}
+
+// Verifies that the AVX2 method for echo return loss computation is bitexact
+// to the reference counterpart.
+TEST(AdaptiveFirFilter, UpdateErlAvx2Optimization) {
+  bool use_avx2 =
+      WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0;
+  if (use_avx2) {
+    const size_t kNumPartitions = 12;
+    std::vector<std::array<float, kFftLengthBy2Plus1>> H2(kNumPartitions);
+    std::array<float, kFftLengthBy2Plus1> erl;
+    std::array<float, kFftLengthBy2Plus1> erl_AVX2;
+
+    for (size_t j = 0; j < H2.size(); ++j) {
+      for (size_t k = 0; k < H2[j].size(); ++k) {
+        H2[j][k] = k + j / 3.f;
+      }
+    }
+
+    UpdateErlEstimator(H2, &erl);
+    UpdateErlEstimator_AVX2(H2, &erl_AVX2);
+
+    for (size_t j = 0; j < erl.size(); ++j) {
+      EXPECT_FLOAT_EQ(erl[j], erl_AVX2[j]);
+    }
+  }
+}
+
 #endif
 
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
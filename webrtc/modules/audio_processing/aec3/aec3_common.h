@@ -24,7 +24,9 @@ namespace webrtc {
 #define ALIGN16_END __attribute__((aligned(16)))
 #endif
 
-enum class Aec3Optimization { kNone, kSse2, kNeon };
+// kAvx2 implies AVX2 and FMA3 support, on top of SSE2; code without an AVX2
+// variant uses its SSE2 one.
+enum class Aec3Optimization { kNone, kSse2, kAvx2, kNeon };
 
 constexpr int kNumBlocksPerSecond = 250;
 
@@ -54,6 +56,9 @@ constexpr size_t kNumMatchedFilters = 4;
 constexpr size_t kMatchedFilterWindowSizeSubBlocks = 32;
 constexpr size_t kMatchedFilterAlignmentShiftSizeSubBlocks =
     kMatchedFilterWindowSizeSubBlocks * 3 / 4;
+// The margin, in downsampled samples, around a tracked lag within which the
+// matched filters are kept updated.
+constexpr size_t kMatchedFilterLagTrackingMargin = 2 * kSubBlockSize;
 constexpr size_t kDownsampledRenderBufferSize =
     kSubBlockSize *
     (kMatchedFilterAlignmentShiftSizeSubBlocks * kNumMatchedFilters +
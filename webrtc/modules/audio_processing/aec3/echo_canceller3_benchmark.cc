@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/aec3/echo_canceller3.h"
+
+#include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace webrtc {
+namespace {
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kFrameLength = kSampleRateHz / 100;
+
+void FillWithNoise(Random* random_generator, AudioBuffer* buffer) {
+  float* samples = buffer->channels_f()[0];
+  for (size_t i = 0; i < kFrameLength; ++i)
+    samples[i] = random_generator->Rand(-3000, 3000);
+}
+}  // namespace
+
+// Runs a 10 ms frame of render and capture audio through the echo canceller,
+// with the band splitting that AudioProcessing does around it.
+TEST(EchoCanceller3Benchmark, ProcessCapture) {
+  EchoCanceller3 aec3(AudioProcessing::Config::EchoCanceller3(), kSampleRateHz,
+                      true);
+  AudioBuffer render(kFrameLength, 1, kFrameLength, 1, kFrameLength);
+  AudioBuffer capture(kFrameLength, 1, kFrameLength, 1, kFrameLength);
+  Random random_generator(42U);
+  test::RunBenchmark("EchoCanceller3_ProcessCapture",
+                     kFrameLength * sizeof(float), [&] {
+                       FillWithNoise(&random_generator, &render);
+                       render.SplitIntoFrequencyBands();
+                       aec3.AnalyzeRender(&render);
+
+                       FillWithNoise(&random_generator, &capture);
+                       aec3.AnalyzeCapture(&capture);
+                       capture.SplitIntoFrequencyBands();
+                       aec3.ProcessCapture(&capture, false);
+                       capture.MergeFrequencyBands();
+                     });
+  EXPECT_EQ(3u, capture.num_bands());
+}
+
+}  // namespace webrtc
@@ -22,6 +22,9 @@ namespace webrtc {
 namespace {
 
 constexpr int kDownSamplingFactor = 4;
+// The number of blocks the matched filters around a tracked delay may go
+// without a reliable lag estimate before the full search is resumed.
+constexpr size_t kMaxBlocksWithoutReliableLag = 100;
 }  // namespace
 
 EchoPathDelayEstimator::EchoPathDelayEstimator(
@@ -35,7 +38,8 @@ EchoPathDelayEstimator::EchoPathDelayEstimator(
                       kMatchedFilterAlignmentShiftSizeSubBlocks,
                       config.param.render_levels.poor_excitation_render_limit),
       matched_filter_lag_aggregator_(data_dumper_,
-                                     matched_filter_.NumLagEstimates()) {
+                                     matched_filter_.NumLagEstimates()),
+      track_converged_delay_(config.param.delay.track_converged_delay) {
   RTC_DCHECK(data_dumper);
 }
 
@@ -44,6 +48,7 @@ EchoPathDelayEstimator::~EchoPathDelayEstimator() = default;
 void EchoPathDelayEstimator::Reset() {
   matched_filter_lag_aggregator_.Reset();
   matched_filter_.Reset();
+  blocks_without_reliable_lag_ = 0;
 }
 
 rtc::Optional<size_t> EchoPathDelayEstimator::EstimateDelay(
@@ -59,6 +64,27 @@ rtc::Optional<size_t> EchoPathDelayEstimator::EstimateDelay(
       matched_filter_lag_aggregator_.Aggregate(
           matched_filter_.GetLagEstimates());
 
+  if (track_converged_delay_) {
+    rtc::ArrayView<const MatchedFilter::LagEstimate> lag_estimates =
+        matched_filter_.GetLagEstimates();
+    const bool reliable_lag = std::any_of(
+        lag_estimates.begin(), lag_estimates.end(),
+        [](const MatchedFilter::LagEstimate& lag_estimate) {
+          return lag_estimate.updated && lag_estimate.reliable;
+        });
+    blocks_without_reliable_lag_ =
+        reliable_lag ? 0 : blocks_without_reliable_lag_ + 1;
+
+    if (blocks_without_reliable_lag_ > kMaxBlocksWithoutReliableLag) {
+      // The echo path may have moved away from the tracked delay, so search
+      // all the lags again until the aggregator has settled on a new one.
+      matched_filter_lag_aggregator_.Reset();
+      aggregated_matched_filter_lag = rtc::Optional<size_t>();
+      blocks_without_reliable_lag_ = 0;
+    }
+    matched_filter_.TrackLag(aggregated_matched_filter_lag);
+  }
+
   // TODO(peah): Move this logging outside of this class once EchoCanceller3
   // development is done.
   data_dumper_->DumpRaw("aec3_echo_path_delay_estimator_delay",
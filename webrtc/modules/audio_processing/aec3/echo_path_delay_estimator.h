@@ -45,6 +45,8 @@ class EchoPathDelayEstimator {
   DecimatorBy4 capture_decimator_;
   MatchedFilter matched_filter_;
   MatchedFilterLagAggregator matched_filter_lag_aggregator_;
+  const bool track_converged_delay_;
+  size_t blocks_without_reliable_lag_ = 0;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(EchoPathDelayEstimator);
 };
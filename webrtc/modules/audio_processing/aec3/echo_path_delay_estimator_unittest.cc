@@ -83,6 +83,45 @@ TEST(EchoPathDelayEstimator, DelayEstimation) {
   }
 }
 
+// Verifies that the delay estimator that tracks the converged delay follows a
+// change of the delay.
+TEST(EchoPathDelayEstimator, DelayChangeWhileTrackingConvergedDelay) {
+  Random random_generator(42U);
+  std::vector<std::vector<float>> render(3, std::vector<float>(kBlockSize));
+  std::vector<float> capture(kBlockSize);
+  ApmDataDumper data_dumper(0);
+  AudioProcessing::Config::EchoCanceller3 config;
+  config.param.delay.track_converged_delay = true;
+  for (size_t delay_samples : {200, 800}) {
+    SCOPED_TRACE(ProduceDebugText(delay_samples));
+    std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+        RenderDelayBuffer::Create(3));
+    DelayBuffer<float> signal_delay_buffer(delay_samples);
+    DelayBuffer<float> changed_signal_delay_buffer(3000);
+    EchoPathDelayEstimator estimator(&data_dumper, config);
+
+    rtc::Optional<size_t> estimated_delay_samples;
+    for (size_t k = 0; k < 1000; ++k) {
+      RandomizeSampleVector(&random_generator, render[0]);
+      if (k < 500) {
+        signal_delay_buffer.Delay(render[0], capture);
+      } else {
+        changed_signal_delay_buffer.Delay(render[0], capture);
+      }
+      render_delay_buffer->Insert(render);
+      render_delay_buffer->UpdateBuffers();
+      estimated_delay_samples = estimator.EstimateDelay(
+          render_delay_buffer->GetDownsampledRenderBuffer(), capture);
+      if (k == 499) {
+        ASSERT_TRUE(estimated_delay_samples);
+        EXPECT_NEAR(delay_samples, *estimated_delay_samples, 4);
+      }
+    }
+    ASSERT_TRUE(estimated_delay_samples);
+    EXPECT_NEAR(3000, *estimated_delay_samples, 4);
+  }
+}
+
 // Verifies that the delay estimator does not produce delay estimates too
 // quickly.
 TEST(EchoPathDelayEstimator, NoInitialDelayestimates) {
@@ -44,6 +44,7 @@ struct FftData {
     RTC_DCHECK(power_spectrum);
     switch (optimization) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kAvx2:
       case Aec3Optimization::kSse2: {
         constexpr int kNumFourBinBands = kFftLengthBy2 / 4;
         constexpr int kLimit = kNumFourBinBands * 4;
@@ -314,6 +314,12 @@ void MatchedFilter::Reset() {
   for (auto& l : lag_estimates_) {
     l = MatchedFilter::LagEstimate();
   }
+
+  tracked_lag_ = rtc::Optional<size_t>();
+}
+
+void MatchedFilter::TrackLag(rtc::Optional<size_t> lag) {
+  tracked_lag_ = lag;
 }
 
 void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
@@ -323,9 +329,18 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
   const float x2_sum_threshold =
       filters_[0].size() * excitation_limit_ * excitation_limit_;
 
-  // Apply all matched filters.
+  // Apply all matched filters, or only those covering the tracked lag.
   size_t alignment_shift = 0;
   for (size_t n = 0; n < filters_.size(); ++n) {
+    const size_t margin = kMatchedFilterLagTrackingMargin;
+    if (tracked_lag_ &&
+        (alignment_shift > *tracked_lag_ + margin ||
+         alignment_shift + filters_[n].size() + margin <= *tracked_lag_)) {
+      lag_estimates_[n].updated = false;
+      alignment_shift += filter_intra_lag_shift_;
+      continue;
+    }
+
     float error_sum = 0.f;
     bool filters_updated = false;
 
@@ -340,6 +355,11 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
                                      render_buffer.buffer, y, filters_[n],
                                      &filters_updated, &error_sum);
         break;
+      case Aec3Optimization::kAvx2:
+        aec3::MatchedFilterCore_AVX2(x_start_index, x2_sum_threshold,
+                                     render_buffer.buffer, y, filters_[n],
+                                     &filters_updated, &error_sum);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon:
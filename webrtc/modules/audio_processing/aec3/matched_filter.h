@@ -47,6 +47,15 @@ void MatchedFilterCore_SSE2(size_t x_start_index,
                             bool* filters_updated,
                             float* error_sum);
 
+// Filter core for the matched filter that is optimized for AVX2 and FMA3.
+void MatchedFilterCore_AVX2(size_t x_start_index,
+                            float x2_sum_threshold,
+                            rtc::ArrayView<const float> x,
+                            rtc::ArrayView<const float> y,
+                            rtc::ArrayView<float> h,
+                            bool* filters_updated,
+                            float* error_sum);
+
 #endif
 
 // Filter core for the matched filter.
@@ -95,6 +104,13 @@ class MatchedFilter {
   // Resets the matched filter.
   void Reset();
 
+  // Restricts the updates to the filters covering lags within
+  // kMatchedFilterLagTrackingMargin of |lag|, to track a known lag at a
+  // fraction of the cost of a full search. The other filters are left as they
+  // are, and their lag estimates are flagged as not updated. If |lag| is not
+  // set, all the filters are updated.
+  void TrackLag(rtc::Optional<size_t> lag);
+
   // Returns the current lag estimates.
   rtc::ArrayView<const MatchedFilter::LagEstimate> GetLagEstimates() const {
     return lag_estimates_;
@@ -110,6 +126,7 @@ class MatchedFilter {
   std::vector<std::vector<float>> filters_;
   std::vector<LagEstimate> lag_estimates_;
   const float excitation_limit_;
+  rtc::Optional<size_t> tracked_lag_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(MatchedFilter);
 };
@@ -119,6 +119,45 @@ TEST(MatchedFilter, TestSse2Optimizations) {
   }
 }
 
+// Verifies that the optimized methods for AVX2 are similar to their reference
+// counterparts.
+TEST(MatchedFilter, TestAvx2Optimizations) {
+  bool use_avx2 =
+      WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0;
+  if (use_avx2) {
+    Random random_generator(42U);
+    std::vector<float> x(2000);
+    RandomizeSampleVector(&random_generator, x);
+    std::vector<float> y(kSubBlockSize);
+    std::vector<float> h_AVX2(512);
+    std::vector<float> h(512);
+    int x_index = 0;
+    for (int k = 0; k < 1000; ++k) {
+      RandomizeSampleVector(&random_generator, y);
+
+      bool filters_updated = false;
+      float error_sum = 0.f;
+      bool filters_updated_AVX2 = false;
+      float error_sum_AVX2 = 0.f;
+
+      MatchedFilterCore_AVX2(x_index, h.size() * 150.f * 150.f, x, y, h_AVX2,
+                             &filters_updated_AVX2, &error_sum_AVX2);
+
+      MatchedFilterCore(x_index, h.size() * 150.f * 150.f, x, y, h,
+                        &filters_updated, &error_sum);
+
+      EXPECT_EQ(filters_updated, filters_updated_AVX2);
+      EXPECT_NEAR(error_sum, error_sum_AVX2, error_sum / 100000.f);
+
+      for (size_t j = 0; j < h.size(); ++j) {
+        EXPECT_NEAR(h[j], h_AVX2[j], 0.00001f);
+      }
+
+      x_index = (x_index + kSubBlockSize) % x.size();
+    }
+  }
+}
+
 #endif
 
 // Verifies that the matched filter produces proper lag estimates for
@@ -15,11 +15,17 @@
 #include "webrtc/modules/audio_processing/aec_dump/aec_dump_factory.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/ptr_util.h"
 
 namespace webrtc {
 
 namespace {
+
+// The most bytes of events that may be waiting to be written before stream
+// events are dropped.
+constexpr int64_t kMaxPendingBytes = 16 * 1024 * 1024;
+
 void CopyFromConfigToEvent(const webrtc::InternalAPMConfig& config,
                            webrtc::audioproc::Config* pb_cfg) {
   pb_cfg->set_aec_enabled(config.aec_enabled);
@@ -56,18 +62,29 @@ void CopyFromConfigToEvent(const webrtc::InternalAPMConfig& config,
 AecDumpImpl::AecDumpImpl(std::unique_ptr<FileWrapper> debug_file,
                          int64_t max_log_size_bytes,
                          rtc::TaskQueue* worker_queue)
-    : debug_file_(std::move(debug_file)),
-      num_bytes_left_for_log_(max_log_size_bytes),
+    : debug_file_writer_(std::move(debug_file), max_log_size_bytes),
+      pending_bytes_(0),
+      num_dropped_events_(0),
       worker_queue_(worker_queue),
       capture_stream_info_(CreateWriteToFileTask()) {}
 
 AecDumpImpl::~AecDumpImpl() {
-  // Block until all tasks have finished running.
+  // Block until all tasks have finished running, and the events they wrote
+  // have been flushed to the file.
   rtc::Event thread_sync_event(false /* manual_reset */, false);
-  worker_queue_->PostTask([&thread_sync_event] { thread_sync_event.Set(); });
+  worker_queue_->PostTask([this, &thread_sync_event] {
+    debug_file_writer_.Flush();
+    thread_sync_event.Set();
+  });
   // Wait until the event has been signaled with .Set(). By then all
   // pending tasks will have finished.
   thread_sync_event.Wait(rtc::Event::kForever);
+
+  const int num_dropped_events = num_dropped_events_.load();
+  if (num_dropped_events > 0) {
+    LOG(LS_WARNING) << "AecDump dropped " << num_dropped_events
+                    << " events that the file writer fell behind on.";
+  }
 }
 
 void AecDumpImpl::WriteInitMessage(
@@ -91,7 +108,7 @@ void AecDumpImpl::WriteInitMessage(
   msg->set_num_reverse_output_channels(
       streams_config.render_output_num_channels);
 
-  worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(std::move(task)));
+  PostWriteToFileTask(std::move(task));
 }
 
 void AecDumpImpl::AddCaptureStreamInput(const FloatAudioFrame& src) {
@@ -117,8 +134,7 @@ void AecDumpImpl::AddAudioProcessingState(const AudioProcessingState& state) {
 void AecDumpImpl::WriteCaptureStreamMessage() {
   auto task = capture_stream_info_.GetTask();
   RTC_DCHECK(task);
-  std::move(task);
-  worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(std::move(task)));
+  PostWriteToFileTask(std::move(task));
   capture_stream_info_.SetTask(CreateWriteToFileTask());
 }
 
@@ -132,7 +148,7 @@ void AecDumpImpl::WriteRenderStreamMessage(const AudioFrame& frame) {
       sizeof(int16_t) * frame.samples_per_channel_ * frame.num_channels_;
   msg->set_data(frame.data(), data_size);
 
-  worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(std::move(task)));
+  PostWriteToFileTask(std::move(task));
 }
 
 void AecDumpImpl::WriteRenderStreamMessage(const FloatAudioFrame& src) {
@@ -148,7 +164,7 @@ void AecDumpImpl::WriteRenderStreamMessage(const FloatAudioFrame& src) {
     msg->add_channel(channel_view.begin(), sizeof(float) * channel_view.size());
   }
 
-  worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(std::move(task)));
+  PostWriteToFileTask(std::move(task));
 }
 
 void AecDumpImpl::WriteConfig(const InternalAPMConfig& config) {
@@ -157,12 +173,31 @@ void AecDumpImpl::WriteConfig(const InternalAPMConfig& config) {
   auto* event = task->GetEvent();
   event->set_type(audioproc::Event::CONFIG);
   CopyFromConfigToEvent(config, event->mutable_config());
-  worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(std::move(task)));
+  PostWriteToFileTask(std::move(task));
 }
 
 std::unique_ptr<WriteToFileTask> AecDumpImpl::CreateWriteToFileTask() {
-  return rtc::MakeUnique<WriteToFileTask>(debug_file_.get(),
-                                          &num_bytes_left_for_log_);
+  return rtc::MakeUnique<WriteToFileTask>(&debug_file_writer_,
+                                          &pending_bytes_);
+}
+
+void AecDumpImpl::PostWriteToFileTask(std::unique_ptr<WriteToFileTask> task) {
+  const audioproc::Event* event = task->GetEvent();
+  // Also caches the size for the task to account for when it runs.
+  const int64_t event_byte_size = event->ByteSize();
+  const bool is_stream_event =
+      event->type() == audioproc::Event::STREAM ||
+      event->type() == audioproc::Event::REVERSE_STREAM;
+  if (pending_bytes_.fetch_add(event_byte_size) + event_byte_size >
+          kMaxPendingBytes &&
+      is_stream_event) {
+    // The worker queue has fallen too far behind. Drop the event rather than
+    // let it grow any further.
+    pending_bytes_ -= event_byte_size;
+    ++num_dropped_events_;
+    return;
+  }
+  worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(std::move(task)));
 }
 
 std::unique_ptr<AecDump> AecDumpFactory::Create(rtc::PlatformFile file,
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_AUDIO_PROCESSING_AEC_DUMP_AEC_DUMP_IMPL_H_
 #define WEBRTC_MODULES_AUDIO_PROCESSING_AEC_DUMP_AEC_DUMP_IMPL_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,7 +43,10 @@ class TaskQueue;
 namespace webrtc {
 
 // Task-queue based implementation of AecDump. It is thread safe by
-// relying on locks in TaskQueue.
+// relying on locks in TaskQueue. The events are written to the file in large
+// batches, and when the worker queue falls behind by more than
+// |kMaxPendingBytes| of events, further stream events are dropped until it
+// catches up.
 class AecDumpImpl : public AecDump {
  public:
   // Does member variables initialization shared across all c-tors.
@@ -68,9 +72,12 @@ class AecDumpImpl : public AecDump {
 
  private:
   std::unique_ptr<WriteToFileTask> CreateWriteToFileTask();
+  void PostWriteToFileTask(std::unique_ptr<WriteToFileTask> task);
 
-  std::unique_ptr<FileWrapper> debug_file_;
-  int64_t num_bytes_left_for_log_ = 0;
+  // Only used on the worker queue.
+  DebugFileWriter debug_file_writer_;
+  std::atomic<int64_t> pending_bytes_;
+  std::atomic<int> num_dropped_events_;
   rtc::RaceChecker race_checker_;
   rtc::TaskQueue* worker_queue_;
   CaptureStreamInfo capture_stream_info_;
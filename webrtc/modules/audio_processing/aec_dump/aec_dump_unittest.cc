@@ -69,3 +69,32 @@ TEST(AecDumper, WriteToFile) {
   ASSERT_EQ(0, fclose(fid));
   ASSERT_EQ(0, remove(filename.c_str()));
 }
+
+TEST(AecDumper, RespectsMaxLogSize) {
+  rtc::TaskQueue file_writer_queue("file_writer_queue");
+
+  const std::string filename =
+      webrtc::test::TempFilename(webrtc::test::OutputPath(), "aec_dump");
+  constexpr int64_t kMaxLogSizeBytes = 10000;
+
+  {
+    std::unique_ptr<webrtc::AecDump> aec_dump = webrtc::AecDumpFactory::Create(
+        filename, kMaxLogSizeBytes, &file_writer_queue);
+    const webrtc::AudioFrame frame;
+    for (int i = 0; i < 1000; ++i) {
+      aec_dump->WriteRenderStreamMessage(frame);
+    }
+  }
+
+  // The buffered writes are flushed by the AecDump d-tor, but never past the
+  // log size limit.
+  FILE* fid = fopen(filename.c_str(), "r");
+  ASSERT_TRUE(fid != NULL);
+  ASSERT_EQ(0, fseek(fid, 0, SEEK_END));
+  const long file_size = ftell(fid);
+  EXPECT_GT(file_size, 0);
+  EXPECT_LE(file_size, kMaxLogSizeBytes);
+
+  ASSERT_EQ(0, fclose(fid));
+  ASSERT_EQ(0, remove(filename.c_str()));
+}
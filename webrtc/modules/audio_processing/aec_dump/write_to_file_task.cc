@@ -10,58 +10,93 @@
 
 #include "webrtc/modules/audio_processing/aec_dump/write_to_file_task.h"
 
-#include "webrtc/rtc_base/protobuf_utils.h"
-
 namespace webrtc {
 
-WriteToFileTask::WriteToFileTask(webrtc::FileWrapper* debug_file,
-                                 int64_t* num_bytes_left_for_log)
-    : debug_file_(debug_file),
-      num_bytes_left_for_log_(num_bytes_left_for_log) {}
+namespace {
 
-WriteToFileTask::~WriteToFileTask() = default;
+// The size the write buffer grows to before it is written to the file.
+constexpr size_t kWriteBufferSize = 256 * 1024;
 
-audioproc::Event* WriteToFileTask::GetEvent() {
-  return &event_;
-}
+}  // namespace
 
-bool WriteToFileTask::IsRoomForNextEvent(size_t event_byte_size) const {
-  int64_t next_message_size = event_byte_size + sizeof(int32_t);
-  return (*num_bytes_left_for_log_ < 0) ||
-         (*num_bytes_left_for_log_ >= next_message_size);
+DebugFileWriter::DebugFileWriter(std::unique_ptr<FileWrapper> debug_file,
+                                 int64_t max_log_size_bytes)
+    : debug_file_(std::move(debug_file)),
+      num_bytes_left_for_log_(max_log_size_bytes) {
+  write_buffer_.EnsureCapacity(kWriteBufferSize);
 }
 
-void WriteToFileTask::UpdateBytesLeft(size_t event_byte_size) {
-  RTC_DCHECK(IsRoomForNextEvent(event_byte_size));
-  if (*num_bytes_left_for_log_ >= 0) {
-    *num_bytes_left_for_log_ -= (sizeof(int32_t) + event_byte_size);
-  }
+DebugFileWriter::~DebugFileWriter() {
+  Flush();
 }
 
-bool WriteToFileTask::Run() {
+void DebugFileWriter::WriteEvent(const audioproc::Event& event) {
   if (!debug_file_->is_open()) {
-    return true;
+    return;
   }
 
-  ProtoString event_string;
-  event_.SerializeToString(&event_string);
-
-  const size_t event_byte_size = event_.ByteSize();
+  const size_t event_byte_size = event.ByteSize();
 
   if (!IsRoomForNextEvent(event_byte_size)) {
+    Flush();
     debug_file_->CloseFile();
-    return true;
+    return;
   }
 
   UpdateBytesLeft(event_byte_size);
 
   // Write message preceded by its size.
-  if (!debug_file_->Write(&event_byte_size, sizeof(int32_t))) {
-    RTC_NOTREACHED();
+  const int32_t size_prefix = static_cast<int32_t>(event_byte_size);
+  write_buffer_.AppendData(reinterpret_cast<const uint8_t*>(&size_prefix),
+                           sizeof(int32_t));
+  write_buffer_.AppendData(event_byte_size,
+                           [&event, event_byte_size](rtc::ArrayView<uint8_t> v) {
+                             event.SerializeWithCachedSizesToArray(v.data());
+                             return event_byte_size;
+                           });
+
+  if (write_buffer_.size() >= kWriteBufferSize) {
+    Flush();
   }
-  if (!debug_file_->Write(event_string.data(), event_string.length())) {
+}
+
+void DebugFileWriter::Flush() {
+  if (write_buffer_.empty() || !debug_file_->is_open()) {
+    return;
+  }
+  if (!debug_file_->Write(write_buffer_.data(), write_buffer_.size())) {
     RTC_NOTREACHED();
   }
+  write_buffer_.Clear();
+}
+
+bool DebugFileWriter::IsRoomForNextEvent(size_t event_byte_size) const {
+  int64_t next_message_size = event_byte_size + sizeof(int32_t);
+  return (num_bytes_left_for_log_ < 0) ||
+         (num_bytes_left_for_log_ >= next_message_size);
+}
+
+void DebugFileWriter::UpdateBytesLeft(size_t event_byte_size) {
+  RTC_DCHECK(IsRoomForNextEvent(event_byte_size));
+  if (num_bytes_left_for_log_ >= 0) {
+    num_bytes_left_for_log_ -= (sizeof(int32_t) + event_byte_size);
+  }
+}
+
+WriteToFileTask::WriteToFileTask(DebugFileWriter* debug_file_writer,
+                                 std::atomic<int64_t>* pending_bytes)
+    : debug_file_writer_(debug_file_writer), pending_bytes_(pending_bytes) {}
+
+WriteToFileTask::~WriteToFileTask() = default;
+
+audioproc::Event* WriteToFileTask::GetEvent() {
+  return &event_;
+}
+
+bool WriteToFileTask::Run() {
+  // The size was computed and cached when the task was posted.
+  *pending_bytes_ -= event_.GetCachedSize();
+  debug_file_writer_->WriteEvent(event_);
   return true;  // Delete task from queue at once.
 }
 
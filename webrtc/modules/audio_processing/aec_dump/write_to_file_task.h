@@ -11,10 +11,12 @@
 #ifndef WEBRTC_MODULES_AUDIO_PROCESSING_AEC_DUMP_WRITE_TO_FILE_TASK_H_
 #define WEBRTC_MODULES_AUDIO_PROCESSING_AEC_DUMP_WRITE_TO_FILE_TASK_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "webrtc/rtc_base/buffer.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/ignore_wundef.h"
@@ -33,24 +35,46 @@ RTC_POP_IGNORING_WUNDEF()
 
 namespace webrtc {
 
-class WriteToFileTask : public rtc::QueuedTask {
+// Writes events to the debug file, each preceded by its size. The events are
+// serialized into a buffer, which is only written to the file once it has
+// grown large, or on Flush(). Only to be used on the worker queue.
+class DebugFileWriter {
  public:
-  WriteToFileTask(webrtc::FileWrapper* debug_file,
-                  int64_t* num_bytes_left_for_log);
-  ~WriteToFileTask() override;
+  // |max_log_size_bytes == -1| means the log size will be unlimited.
+  DebugFileWriter(std::unique_ptr<FileWrapper> debug_file,
+                  int64_t max_log_size_bytes);
+  ~DebugFileWriter();
 
-  audioproc::Event* GetEvent();
+  void WriteEvent(const audioproc::Event& event);
+  void Flush();
 
  private:
   bool IsRoomForNextEvent(size_t event_byte_size) const;
 
   void UpdateBytesLeft(size_t event_byte_size);
 
+  const std::unique_ptr<FileWrapper> debug_file_;
+  int64_t num_bytes_left_for_log_;
+  rtc::Buffer write_buffer_;
+};
+
+class WriteToFileTask : public rtc::QueuedTask {
+ public:
+  // |pending_bytes| is the number of bytes of events posted to the worker
+  // queue that have yet to be written, which is decreased by the size of the
+  // event of this task when it runs.
+  WriteToFileTask(DebugFileWriter* debug_file_writer,
+                  std::atomic<int64_t>* pending_bytes);
+  ~WriteToFileTask() override;
+
+  audioproc::Event* GetEvent();
+
+ private:
   bool Run() override;
 
-  webrtc::FileWrapper* debug_file_;
+  DebugFileWriter* const debug_file_writer_;
+  std::atomic<int64_t>* const pending_bytes_;
   audioproc::Event event_;
-  int64_t* num_bytes_left_for_log_;
 };
 
 }  // namespace webrtc
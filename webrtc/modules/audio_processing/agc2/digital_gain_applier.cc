@@ -12,26 +12,78 @@
 
 #include <algorithm>
 
+#include "webrtc/typedefs.h"
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
 namespace webrtc {
 namespace {
 
 constexpr float kMaxSampleValue = 32767.0f;
 constexpr float kMinSampleValue = -32767.0f;
 
+// Applies the gain and limits the result to the allowed range for the first
+// multiple of four samples. Returns the number of samples processed.
+#if defined(WEBRTC_HAS_NEON)
+size_t ApplyGainAndLimit_NEON(float gain, rtc::ArrayView<float> x) {
+  const size_t vector_limit = x.size() & ~static_cast<size_t>(3);
+  const float32x4_t gain_4 = vdupq_n_f32(gain);
+  const float32x4_t min_4 = vdupq_n_f32(kMinSampleValue);
+  const float32x4_t max_4 = vdupq_n_f32(kMaxSampleValue);
+  for (size_t k = 0; k < vector_limit; k += 4) {
+    float32x4_t v = vmulq_f32(vld1q_f32(x.data() + k), gain_4);
+    v = vminq_f32(vmaxq_f32(v, min_4), max_4);
+    vst1q_f32(x.data() + k, v);
+  }
+  return vector_limit;
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+size_t ApplyGainAndLimit_SSE2(float gain, rtc::ArrayView<float> x) {
+  const size_t vector_limit = x.size() & ~static_cast<size_t>(3);
+  const __m128 gain_4 = _mm_set1_ps(gain);
+  const __m128 min_4 = _mm_set1_ps(kMinSampleValue);
+  const __m128 max_4 = _mm_set1_ps(kMaxSampleValue);
+  for (size_t k = 0; k < vector_limit; k += 4) {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(x.data() + k), gain_4);
+    v = _mm_min_ps(_mm_max_ps(v, min_4), max_4);
+    _mm_storeu_ps(x.data() + k, v);
+  }
+  return vector_limit;
+}
+#endif
+
 }  // namespace
 
-DigitalGainApplier::DigitalGainApplier() = default;
+DigitalGainApplier::DigitalGainApplier() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  use_sse2_ = WebRtc_GetCPUInfo(kSSE2) != 0;
+#endif
+}
 
 void DigitalGainApplier::Process(float gain, rtc::ArrayView<float> samples) {
   if (gain == 1.f) { return; }
-  for (auto& v : samples) { v *= gain; }
-  LimitToAllowedRange(samples);
-}
 
-void DigitalGainApplier::LimitToAllowedRange(rtc::ArrayView<float> x) {
-  for (auto& v : x) {
+  // The gain and the limiting are applied in a single pass over the samples.
+  size_t processed = 0;
+#if defined(WEBRTC_HAS_NEON)
+  processed = ApplyGainAndLimit_NEON(gain, samples);
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    processed = ApplyGainAndLimit_SSE2(gain, samples);
+  }
+#endif
+  for (size_t k = processed; k < samples.size(); ++k) {
+    float v = samples[k] * gain;
     v = std::max(kMinSampleValue, v);
-    v = std::min(kMaxSampleValue, v);
+    samples[k] = std::min(kMaxSampleValue, v);
   }
 }
 
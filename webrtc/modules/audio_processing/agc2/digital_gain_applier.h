@@ -20,11 +20,12 @@ class DigitalGainApplier {
  public:
   DigitalGainApplier();
 
-  // Applies the specified gain to an array of samples.
+  // Applies the specified gain to an array of samples and limits the result
+  // to the allowed sample range.
   void Process(float gain, rtc::ArrayView<float> samples);
 
  private:
-  void LimitToAllowedRange(rtc::ArrayView<float> x);
+  bool use_sse2_ = false;
 };
 
 }  // namespace webrtc
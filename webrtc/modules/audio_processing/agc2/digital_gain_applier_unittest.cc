@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/agc2/digital_gain_applier.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+// Verifies that the gain is applied to all samples, including the ones that do
+// not fill a full SIMD vector, and that the result is limited.
+TEST(DigitalGainApplier, AppliesGainAndLimits) {
+  Random random_generator(42U);
+  DigitalGainApplier applier;
+  for (size_t num_samples : {1, 3, 4, 5, 160, 481}) {
+    for (float gain : {0.5f, 3.f}) {
+      std::vector<float> samples(num_samples);
+      for (auto& v : samples) {
+        v = random_generator.Rand(-32767, 32767);
+      }
+      std::vector<float> expected = samples;
+      for (auto& v : expected) {
+        v = std::min(32767.f, std::max(-32767.f, v * gain));
+      }
+
+      applier.Process(gain, samples);
+      EXPECT_EQ(expected, samples);
+    }
+  }
+}
+
+TEST(DigitalGainApplier, UnityGainLeavesSamplesUntouched) {
+  DigitalGainApplier applier;
+  std::vector<float> samples = {-40000.f, 0.f, 40000.f};
+  applier.Process(1.f, samples);
+  EXPECT_EQ(-40000.f, samples[0]);
+  EXPECT_EQ(40000.f, samples[2]);
+}
+
+}  // namespace webrtc
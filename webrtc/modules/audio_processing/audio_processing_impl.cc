@@ -365,12 +365,6 @@ AudioProcessingImpl::AudioProcessingImpl(const webrtc::Config& config,
     public_submodules_->gain_control_for_experimental_agc.reset(
         new GainControlForExperimentalAgc(
             public_submodules_->gain_control.get(), &crit_capture_));
-    private_submodules_->residual_echo_detector.reset(
-        new ResidualEchoDetector());
-
-    // TODO(peah): Move this creation to happen only when the level controller
-    // is enabled.
-    private_submodules_->level_controller.reset(new LevelController());
   }
 
   SetExtraOptions(config);
@@ -650,7 +644,18 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
   LOG(LS_INFO) << "Level controller activated: "
                << capture_nonlocked_.level_controller_enabled;
 
-  private_submodules_->level_controller->ApplyConfig(config_.level_controller);
+  if (private_submodules_->level_controller) {
+    private_submodules_->level_controller->ApplyConfig(
+        config_.level_controller);
+  }
+
+  // The residual echo detector is only allocated while it is enabled.
+  const bool residual_echo_detector_allocated =
+      private_submodules_->residual_echo_detector != nullptr;
+  if (config_.residual_echo_detector.enabled !=
+      residual_echo_detector_allocated) {
+    InitializeResidualEchoDetector();
+  }
 
   InitializeLowCutFilter();
 
@@ -694,6 +699,16 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
     LOG(LS_INFO) << "Gain controller 2 activated: "
                  << capture_nonlocked_.gain_controller2_enabled;
   }
+
+  if (config_.submodule_timing.enabled != !!capture_.submodule_timing) {
+    capture_.submodule_timing.reset(
+        config_.submodule_timing.enabled
+            ? new SubmoduleTimingStats(
+                  SubmoduleTimingStats::kDefaultFramesPerWindow)
+            : nullptr);
+    LOG(LS_INFO) << "Submodule timing activated: "
+                 << config_.submodule_timing.enabled;
+  }
 }
 
 void AudioProcessingImpl::SetExtraOptions(const webrtc::Config& config) {
@@ -865,12 +880,7 @@ void AudioProcessingImpl::QueueBandedRenderAudio(AudioBuffer* audio) {
 
   // Insert the samples into the queue.
   if (!aec_render_signal_queue_->Insert(&aec_render_queue_buffer_)) {
-    // The data queue is full and needs to be emptied.
-    EmptyQueuedRenderAudio();
-
-    // Retry the insert (should always work).
-    bool result = aec_render_signal_queue_->Insert(&aec_render_queue_buffer_);
-    RTC_DCHECK(result);
+    OnRenderQueueOverflow();
   }
 
   EchoControlMobileImpl::PackRenderAudioBuffer(audio, num_output_channels(),
@@ -879,39 +889,39 @@ void AudioProcessingImpl::QueueBandedRenderAudio(AudioBuffer* audio) {
 
   // Insert the samples into the queue.
   if (!aecm_render_signal_queue_->Insert(&aecm_render_queue_buffer_)) {
-    // The data queue is full and needs to be emptied.
-    EmptyQueuedRenderAudio();
-
-    // Retry the insert (should always work).
-    bool result = aecm_render_signal_queue_->Insert(&aecm_render_queue_buffer_);
-    RTC_DCHECK(result);
+    OnRenderQueueOverflow();
   }
 
   if (!constants_.use_experimental_agc) {
     GainControlImpl::PackRenderAudioBuffer(audio, &agc_render_queue_buffer_);
     // Insert the samples into the queue.
     if (!agc_render_signal_queue_->Insert(&agc_render_queue_buffer_)) {
-      // The data queue is full and needs to be emptied.
-      EmptyQueuedRenderAudio();
-
-      // Retry the insert (should always work).
-      bool result = agc_render_signal_queue_->Insert(&agc_render_queue_buffer_);
-      RTC_DCHECK(result);
+      OnRenderQueueOverflow();
     }
   }
 }
 
 void AudioProcessingImpl::QueueNonbandedRenderAudio(AudioBuffer* audio) {
+  if (!config_.residual_echo_detector.enabled) {
+    return;
+  }
+
   ResidualEchoDetector::PackRenderAudioBuffer(audio, &red_render_queue_buffer_);
 
   // Insert the samples into the queue.
   if (!red_render_signal_queue_->Insert(&red_render_queue_buffer_)) {
-    // The data queue is full and needs to be emptied.
-    EmptyQueuedRenderAudio();
+    OnRenderQueueOverflow();
+  }
+}
 
-    // Retry the insert (should always work).
-    bool result = red_render_signal_queue_->Insert(&red_render_queue_buffer_);
-    RTC_DCHECK(result);
+void AudioProcessingImpl::OnRenderQueueOverflow() {
+  // The capture side has not consumed the queued render audio in time. The
+  // audio is dropped rather than emptying the queue here, as that would
+  // require the capture lock and thereby block the render thread on capture
+  // processing.
+  if (render_.num_queue_overflows++ == 0) {
+    LOG(LS_WARNING) << "Render queue full; dropping render audio until the "
+                    << "capture side catches up.";
   }
 }
 
@@ -1015,7 +1025,6 @@ void AudioProcessingImpl::AllocateRenderQueue() {
 }
 
 void AudioProcessingImpl::EmptyQueuedRenderAudio() {
-  rtc::CritScope cs_capture(&crit_capture_);
   while (aec_render_signal_queue_->Remove(&aec_capture_queue_buffer_)) {
     public_submodules_->echo_cancellation->ProcessRenderAudio(
         aec_capture_queue_buffer_);
@@ -1032,8 +1041,10 @@ void AudioProcessingImpl::EmptyQueuedRenderAudio() {
   }
 
   while (red_render_signal_queue_->Remove(&red_capture_queue_buffer_)) {
-    private_submodules_->residual_echo_detector->AnalyzeRenderAudio(
-        red_capture_queue_buffer_);
+    if (private_submodules_->residual_echo_detector) {
+      private_submodules_->residual_echo_detector->AnalyzeRenderAudio(
+          red_capture_queue_buffer_);
+    }
   }
 }
 
@@ -1118,6 +1129,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   MaybeUpdateHistograms();
 
   AudioBuffer* capture_buffer = capture_.capture_audio.get();  // For brevity.
+  // Null unless submodule timing is enabled.
+  SubmoduleTimingStats* const timing = capture_.submodule_timing.get();
 
   capture_input_rms_.Analyze(rtc::ArrayView<const int16_t>(
       capture_buffer->channels_const()[0],
@@ -1133,6 +1146,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (private_submodules_->echo_canceller3) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kEchoCanceller3);
     // TODO(peah): Reactivate analogue AGC gain detection once the analogue AGC
     // issues have been addressed.
     capture_.echo_path_gain_change = false;
@@ -1141,6 +1156,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
 
   if (constants_.use_experimental_agc &&
       public_submodules_->gain_control->is_enabled()) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kExperimentalAgc);
     private_submodules_->agc_manager->AnalyzePreProcess(
         capture_buffer->channels()[0], capture_buffer->num_channels(),
         capture_nonlocked_.capture_processing_format.num_frames());
@@ -1161,6 +1178,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (capture_nonlocked_.beamformer_enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(timing,
+                                            SubmoduleTimingStats::kBeamformer);
     private_submodules_->beamformer->AnalyzeChunk(
         *capture_buffer->split_data_f());
     // Discards all channels by the leftmost one.
@@ -1170,11 +1189,26 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   // TODO(peah): Move the AEC3 low-cut filter to this place.
   if (private_submodules_->low_cut_filter &&
       !private_submodules_->echo_canceller3) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kLowCutFilter);
     private_submodules_->low_cut_filter->Process(capture_buffer);
   }
-  RETURN_ON_ERR(
-      public_submodules_->gain_control->AnalyzeCaptureAudio(capture_buffer));
-  public_submodules_->noise_suppression->AnalyzeCaptureAudio(capture_buffer);
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->gain_control->is_enabled() ? timing
+                                                                  : nullptr,
+        SubmoduleTimingStats::kGainControl);
+    RETURN_ON_ERR(
+        public_submodules_->gain_control->AnalyzeCaptureAudio(capture_buffer));
+  }
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->noise_suppression->is_enabled()
+            ? timing
+            : nullptr,
+        SubmoduleTimingStats::kNoiseSuppression);
+    public_submodules_->noise_suppression->AnalyzeCaptureAudio(capture_buffer);
+  }
 
   // Ensure that the stream delay was set before the call to the
   // AEC ProcessCaptureAudio function.
@@ -1184,9 +1218,16 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (private_submodules_->echo_canceller3) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kEchoCanceller3);
     private_submodules_->echo_canceller3->ProcessCapture(
         capture_buffer, capture_.echo_path_gain_change);
   } else {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->echo_cancellation->is_enabled()
+            ? timing
+            : nullptr,
+        SubmoduleTimingStats::kEchoCanceller);
     RETURN_ON_ERR(public_submodules_->echo_cancellation->ProcessCaptureAudio(
         capture_buffer, stream_delay_ms()));
   }
@@ -1195,9 +1236,18 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
       public_submodules_->noise_suppression->is_enabled()) {
     capture_buffer->CopyLowPassToReference();
   }
-  public_submodules_->noise_suppression->ProcessCaptureAudio(capture_buffer);
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->noise_suppression->is_enabled()
+            ? timing
+            : nullptr,
+        SubmoduleTimingStats::kNoiseSuppression);
+    public_submodules_->noise_suppression->ProcessCaptureAudio(capture_buffer);
+  }
 #if WEBRTC_INTELLIGIBILITY_ENHANCER
   if (capture_nonlocked_.intelligibility_enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kIntelligibilityEnhancer);
     RTC_DCHECK(public_submodules_->noise_suppression->is_enabled());
     int gain_db = public_submodules_->gain_control->is_enabled() ?
                   public_submodules_->gain_control->compression_gain_db() :
@@ -1220,26 +1270,47 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
 
   if (!(private_submodules_->echo_canceller3 ||
         public_submodules_->echo_cancellation->is_enabled())) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->echo_control_mobile->is_enabled()
+            ? timing
+            : nullptr,
+        SubmoduleTimingStats::kEchoControlMobile);
     RETURN_ON_ERR(public_submodules_->echo_control_mobile->ProcessCaptureAudio(
         capture_buffer, stream_delay_ms()));
   }
 
   if (capture_nonlocked_.beamformer_enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(timing,
+                                            SubmoduleTimingStats::kBeamformer);
     private_submodules_->beamformer->PostFilter(capture_buffer->split_data_f());
   }
 
-  public_submodules_->voice_detection->ProcessCaptureAudio(capture_buffer);
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->voice_detection->is_enabled() ? timing
+                                                                     : nullptr,
+        SubmoduleTimingStats::kVoiceDetection);
+    public_submodules_->voice_detection->ProcessCaptureAudio(capture_buffer);
+  }
 
   if (constants_.use_experimental_agc &&
       public_submodules_->gain_control->is_enabled() &&
       (!capture_nonlocked_.beamformer_enabled ||
        private_submodules_->beamformer->is_target_present())) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kExperimentalAgc);
     private_submodules_->agc_manager->Process(
         capture_buffer->split_bands_const(0)[kBand0To8kHz],
         capture_buffer->num_frames_per_band(), capture_nonlocked_.split_rate);
   }
-  RETURN_ON_ERR(public_submodules_->gain_control->ProcessCaptureAudio(
-      capture_buffer, echo_cancellation()->stream_has_echo()));
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->gain_control->is_enabled() ? timing
+                                                                  : nullptr,
+        SubmoduleTimingStats::kGainControl);
+    RETURN_ON_ERR(public_submodules_->gain_control->ProcessCaptureAudio(
+        capture_buffer, echo_cancellation()->stream_has_echo()));
+  }
 
   if (submodule_states_.CaptureMultiBandProcessingActive() &&
       SampleRateSupportsMultiBand(
@@ -1248,6 +1319,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (config_.residual_echo_detector.enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kResidualEchoDetector);
     private_submodules_->residual_echo_detector->AnalyzeCaptureAudio(
         rtc::ArrayView<const float>(capture_buffer->channels_f()[0],
                                     capture_buffer->num_frames()));
@@ -1256,6 +1329,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   // TODO(aluebs): Investigate if the transient suppression placement should be
   // before or after the AGC.
   if (capture_.transient_suppressor_enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kTransientSuppressor);
     float voice_probability =
         private_submodules_->agc_manager.get()
             ? private_submodules_->agc_manager->voice_probability()
@@ -1271,15 +1346,25 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (capture_nonlocked_.gain_controller2_enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kGainController2);
     private_submodules_->gain_controller2->Process(capture_buffer);
   }
 
   if (capture_nonlocked_.level_controller_enabled) {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing, SubmoduleTimingStats::kLevelController);
     private_submodules_->level_controller->Process(capture_buffer);
   }
 
-  // The level estimator operates on the recombined data.
-  public_submodules_->level_estimator->ProcessStream(capture_buffer);
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        timing && public_submodules_->level_estimator->is_enabled() ? timing
+                                                                     : nullptr,
+        SubmoduleTimingStats::kLevelEstimator);
+    // The level estimator operates on the recombined data.
+    public_submodules_->level_estimator->ProcessStream(capture_buffer);
+  }
 
   capture_output_rms_.Analyze(rtc::ArrayView<const int16_t>(
       capture_buffer->channels_const()[0],
@@ -1292,6 +1377,10 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
                                 levels.peak, 1, RmsLevel::kMinLevelDb, 64);
   }
 
+  if (timing) {
+    timing->OnFrameProcessed();
+  }
+
   capture_.was_stream_delay_set = false;
   return kNoError;
 }
@@ -1551,11 +1640,17 @@ AudioProcessing::AudioProcessingStatistics AudioProcessingImpl::GetStatistics()
   }
   {
     rtc::CritScope cs_capture(&crit_capture_);
-    stats.residual_echo_likelihood =
-        private_submodules_->residual_echo_detector->echo_likelihood();
-    stats.residual_echo_likelihood_recent_max =
-        private_submodules_->residual_echo_detector
-            ->echo_likelihood_recent_max();
+    if (private_submodules_->residual_echo_detector) {
+      stats.residual_echo_likelihood =
+          private_submodules_->residual_echo_detector->echo_likelihood();
+      stats.residual_echo_likelihood_recent_max =
+          private_submodules_->residual_echo_detector
+              ->echo_likelihood_recent_max();
+    }
+    if (capture_.submodule_timing) {
+      stats.submodule_timings =
+          capture_.submodule_timing->last_window_timings();
+    }
   }
   public_submodules_->echo_cancellation->GetDelayMetrics(
       &stats.delay_median, &stats.delay_standard_deviation,
@@ -1689,10 +1784,27 @@ void AudioProcessingImpl::InitializeGainController2() {
 }
 
 void AudioProcessingImpl::InitializeLevelController() {
+  if (!capture_nonlocked_.level_controller_enabled) {
+    private_submodules_->level_controller.reset();
+    return;
+  }
+  if (!private_submodules_->level_controller) {
+    private_submodules_->level_controller.reset(new LevelController());
+    private_submodules_->level_controller->ApplyConfig(
+        config_.level_controller);
+  }
   private_submodules_->level_controller->Initialize(proc_sample_rate_hz());
 }
 
 void AudioProcessingImpl::InitializeResidualEchoDetector() {
+  if (!config_.residual_echo_detector.enabled) {
+    private_submodules_->residual_echo_detector.reset();
+    return;
+  }
+  if (!private_submodules_->residual_echo_detector) {
+    private_submodules_->residual_echo_detector.reset(
+        new ResidualEchoDetector());
+  }
   private_submodules_->residual_echo_detector->Initialize();
 }
 
@@ -20,6 +20,7 @@
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/audio_processing/render_queue_item_verifier.h"
 #include "webrtc/modules/audio_processing/rms_level.h"
+#include "webrtc/modules/audio_processing/submodule_timing_stats.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/function_view.h"
 #include "webrtc/rtc_base/gtest_prod_util.h"
@@ -219,13 +220,15 @@ class AudioProcessingImpl : public AudioProcessing {
   void InitializeEchoCanceller3() EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
   void InitializeGainController2();
 
-  void EmptyQueuedRenderAudio();
+  void EmptyQueuedRenderAudio() EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
   void AllocateRenderQueue()
       EXCLUSIVE_LOCKS_REQUIRED(crit_render_, crit_capture_);
   void QueueBandedRenderAudio(AudioBuffer* audio)
       EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
   void QueueNonbandedRenderAudio(AudioBuffer* audio)
       EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
+  // Called when a render queue is full. Never acquires the capture lock.
+  void OnRenderQueueOverflow() EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
 
   // Capture-side exclusive methods possibly running APM in a multi-threaded
   // manner that are called with the render lock already acquired.
@@ -345,6 +348,8 @@ class AudioProcessingImpl : public AudioProcessing {
     StreamConfig capture_processing_format;
     int split_rate;
     bool echo_path_gain_change;
+    // Only set while Config::submodule_timing is enabled.
+    std::unique_ptr<SubmoduleTimingStats> submodule_timing;
   } capture_ GUARDED_BY(crit_capture_);
 
   struct ApmCaptureNonLockedState {
@@ -373,6 +378,9 @@ class AudioProcessingImpl : public AudioProcessing {
     ~ApmRenderState();
     std::unique_ptr<AudioConverter> render_converter;
     std::unique_ptr<AudioBuffer> render_audio;
+    // Number of times render audio was dropped because a render queue was
+    // full.
+    size_t num_queue_overflows = 0;
   } render_ GUARDED_BY(crit_render_);
 
   size_t aec_render_queue_element_max_size_ GUARDED_BY(crit_render_)
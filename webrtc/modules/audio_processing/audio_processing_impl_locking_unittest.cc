@@ -15,15 +15,19 @@
 #include <vector>
 
 #include "webrtc/config.h"
+#include "webrtc/modules/audio_processing/include/aec_dump.h"
 #include "webrtc/modules/audio_processing/test/test_utils.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/rtc_base/array_view.h"
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 
@@ -1115,6 +1119,90 @@ void RenderProcessor::ApplyRuntimeSettingScheme() {
                frame_data_.input_number_of_channels);
 }
 
+// Upper bound on how long the capture side is stalled in the render queue test.
+const int kMaxCaptureStallMs = 10000;
+
+// AecDump that lets a test stall the capture side of APM while it holds the
+// capture lock: AddCaptureStreamInput() blocks until |release| is set.
+class CaptureStallingAecDump : public AecDump {
+ public:
+  CaptureStallingAecDump(rtc::Event* capture_stalled, rtc::Event* release)
+      : capture_stalled_(capture_stalled), release_(release) {}
+
+  void WriteInitMessage(
+      const InternalAPMStreamsConfig& streams_config) override {}
+  void AddCaptureStreamInput(const FloatAudioFrame& src) override {}
+  void AddCaptureStreamOutput(const FloatAudioFrame& src) override {}
+  void AddCaptureStreamInput(const AudioFrame& frame) override {
+    capture_stalled_->Set();
+    // Bounded, so that a render side that does wait for the capture lock
+    // fails the test instead of hanging it.
+    release_->Wait(kMaxCaptureStallMs);
+  }
+  void AddCaptureStreamOutput(const AudioFrame& frame) override {}
+  void AddAudioProcessingState(const AudioProcessingState& state) override {}
+  void WriteCaptureStreamMessage() override {}
+  void WriteRenderStreamMessage(const AudioFrame& frame) override {}
+  void WriteRenderStreamMessage(const FloatAudioFrame& src) override {}
+  void WriteConfig(const InternalAPMConfig& config) override {}
+
+ private:
+  rtc::Event* const capture_stalled_;
+  rtc::Event* const release_;
+};
+
+std::unique_ptr<AudioProcessing> CreateApmWithRenderQueues() {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessing::Create());
+  EXPECT_EQ(AudioProcessing::kNoError, apm->echo_cancellation()->Enable(true));
+  EXPECT_EQ(AudioProcessing::kNoError, apm->gain_control()->Enable(true));
+  AudioProcessing::Config config;
+  config.residual_echo_detector.enabled = true;
+  apm->ApplyConfig(config);
+  return apm;
+}
+
+void PopulateFrame(int sample_rate_hz,
+                   RandomGenerator* rand_gen,
+                   AudioFrame* frame) {
+  frame->sample_rate_hz_ = sample_rate_hz;
+  frame->samples_per_channel_ =
+      AudioProcessing::kChunkSizeMs * sample_rate_hz / 1000;
+  frame->num_channels_ = 1;
+  PopulateAudioFrame(frame, 3000, rand_gen);
+}
+
+void SingleCaptureThreadFunc(void* context) {
+  AudioProcessing* apm = static_cast<AudioProcessing*>(context);
+  RandomGenerator rand_gen;
+  AudioFrame frame;
+  PopulateFrame(AudioProcessing::kSampleRate16kHz, &rand_gen, &frame);
+  apm->set_stream_delay_ms(30);
+  EXPECT_EQ(AudioProcessing::kNoError, apm->ProcessStream(&frame));
+}
+
+struct CaptureThreadContext {
+  AudioProcessing* apm;
+  RandomGenerator* rand_gen;
+  volatile int stop;
+};
+
+void ProcessCaptureFrame(CaptureThreadContext* capture) {
+  AudioFrame frame;
+  PopulateFrame(AudioProcessing::kSampleRate16kHz, capture->rand_gen, &frame);
+  capture->apm->set_stream_delay_ms(30);
+  capture->apm->gain_control()->set_stream_analog_level(100);
+  EXPECT_EQ(AudioProcessing::kNoError, capture->apm->ProcessStream(&frame));
+}
+
+void CaptureLoopThreadFunc(void* context) {
+  CaptureThreadContext* capture = static_cast<CaptureThreadContext*>(context);
+  while (!rtc::AtomicOps::AcquireLoad(&capture->stop)) {
+    ProcessCaptureFrame(capture);
+    // Leaves room for the render thread on machines with a single core.
+    SleepMs(1);
+  }
+}
+
 }  // anonymous namespace
 
 TEST_P(AudioProcessingImplLockTest, LockTest) {
@@ -1133,4 +1221,81 @@ INSTANTIATE_TEST_CASE_P(
     AudioProcessingImplLockTest,
     ::testing::ValuesIn(TestConfig::GenerateBriefTestConfigs()));
 
+// Verifies that the render side neither waits for the capture side nor fails
+// when the render queues overflow while capture processing is stalled.
+TEST(AudioProcessingImplRenderQueueTest, RenderDoesNotWaitForStalledCapture) {
+  std::unique_ptr<AudioProcessing> apm = CreateApmWithRenderQueues();
+  rtc::Event capture_stalled(false, false);
+  rtc::Event release(false, false);
+  apm->AttachAecDump(std::unique_ptr<AecDump>(
+      new CaptureStallingAecDump(&capture_stalled, &release)));
+
+  RandomGenerator rand_gen;
+  AudioFrame capture_frame;
+  PopulateFrame(AudioProcessing::kSampleRate16kHz, &rand_gen, &capture_frame);
+  rtc::PlatformThread capture_thread(&SingleCaptureThreadFunc, apm.get(),
+                                     "capture");
+  capture_thread.Start();
+  ASSERT_TRUE(capture_stalled.Wait(kMaxCaptureStallMs));
+
+  // Enough render calls to overflow the render queues several times over.
+  const int64_t start_ms = rtc::TimeMillis();
+  for (int i = 0; i < 1000; ++i) {
+    AudioFrame render_frame;
+    PopulateFrame(AudioProcessing::kSampleRate16kHz, &rand_gen, &render_frame);
+    EXPECT_EQ(AudioProcessing::kNoError,
+              apm->ProcessReverseStream(&render_frame));
+  }
+  EXPECT_LT(rtc::TimeMillis() - start_ms, kMaxCaptureStallMs);
+
+  release.Set();
+  capture_thread.Stop();
+  apm->DetachAecDump();
+
+  // The capture side keeps working after the overflow.
+  apm->set_stream_delay_ms(30);
+  EXPECT_EQ(AudioProcessing::kNoError, apm->ProcessStream(&capture_frame));
+}
+
+// Measures the duration of render calls while another thread continuously
+// runs capture processing.
+TEST(AudioProcessingImplRenderQueueTest,
+     DISABLED_RenderCallDurationUnderCaptureContentionPerf) {
+  const int kNumRenderCalls = 5000;
+  std::unique_ptr<AudioProcessing> apm = CreateApmWithRenderQueues();
+  RandomGenerator rand_gen;
+  CaptureThreadContext capture = {apm.get(), &rand_gen, 0};
+  AudioFrame render_frame;
+  // Process one frame on each side first, so that the initialization of APM
+  // is not part of the measurement.
+  PopulateFrame(AudioProcessing::kSampleRate16kHz, &rand_gen, &render_frame);
+  ASSERT_EQ(AudioProcessing::kNoError,
+            apm->ProcessReverseStream(&render_frame));
+  ProcessCaptureFrame(&capture);
+  rtc::PlatformThread capture_thread(&CaptureLoopThreadFunc, &capture,
+                                     "capture");
+  capture_thread.Start();
+
+  int64_t total_us = 0;
+  int64_t max_us = 0;
+  for (int i = 0; i < kNumRenderCalls; ++i) {
+    PopulateFrame(AudioProcessing::kSampleRate16kHz, &rand_gen, &render_frame);
+    const int64_t start_us = rtc::TimeMicros();
+    ASSERT_EQ(AudioProcessing::kNoError,
+              apm->ProcessReverseStream(&render_frame));
+    const int64_t duration_us = rtc::TimeMicros() - start_us;
+    total_us += duration_us;
+    max_us = std::max(max_us, duration_us);
+  }
+
+  rtc::AtomicOps::ReleaseStore(&capture.stop, 1);
+  capture_thread.Stop();
+
+  webrtc::test::PrintResult("apm_render_call_duration", "", "mean",
+                            static_cast<size_t>(total_us / kNumRenderCalls),
+                            "us", false);
+  webrtc::test::PrintResult("apm_render_call_duration", "", "max",
+                            static_cast<size_t>(max_us), "us", true);
+}
+
 }  // namespace webrtc
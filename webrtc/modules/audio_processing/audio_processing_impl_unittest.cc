@@ -10,6 +10,10 @@
 
 #include "webrtc/modules/audio_processing/audio_processing_impl.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+
 #include "webrtc/config.h"
 #include "webrtc/modules/audio_processing/test/test_utils.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -77,4 +81,68 @@ TEST(AudioProcessingImplTest, AudioParameterChangeTriggersInit) {
   EXPECT_NOERR(mock.ProcessReverseStream(&frame));
 }
 
+TEST(AudioProcessingImplTest, ReportsSubmoduleTimingsWhenEnabled) {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessing::Create());
+  EXPECT_NOERR(apm->noise_suppression()->Enable(true));
+  AudioFrame frame;
+  frame.num_channels_ = 1;
+  SetFrameSampleRate(&frame, 16000);
+
+  const size_t kNumFrames = SubmoduleTimingStats::kDefaultFramesPerWindow;
+  for (size_t k = 0; k < kNumFrames; ++k) {
+    EXPECT_NOERR(apm->ProcessStream(&frame));
+  }
+  EXPECT_TRUE(apm->GetStatistics().submodule_timings.empty());
+
+  AudioProcessing::Config config;
+  config.submodule_timing.enabled = true;
+  apm->ApplyConfig(config);
+  for (size_t k = 0; k < kNumFrames; ++k) {
+    EXPECT_NOERR(apm->ProcessStream(&frame));
+  }
+  const auto timings = apm->GetStatistics().submodule_timings;
+  auto noise_suppression = std::find_if(
+      timings.begin(), timings.end(),
+      [](const AudioProcessing::AudioProcessingStatistics::SubmoduleTiming&
+             timing) { return std::string(timing.name) == "NoiseSuppression"; });
+  ASSERT_NE(timings.end(), noise_suppression);
+  EXPECT_LE(0, noise_suppression->average_us);
+  EXPECT_LE(noise_suppression->average_us, noise_suppression->max_us);
+
+  config.submodule_timing.enabled = false;
+  apm->ApplyConfig(config);
+  EXPECT_TRUE(apm->GetStatistics().submodule_timings.empty());
+}
+
+TEST(AudioProcessingImplTest, TogglesLazilyCreatedSubmodulesWhileProcessing) {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessing::Create());
+  AudioProcessing::Config config;
+  config.residual_echo_detector.enabled = false;
+  apm->ApplyConfig(config);
+
+  AudioFrame frame;
+  frame.num_channels_ = 1;
+  SetFrameSampleRate(&frame, 16000);
+  EXPECT_NOERR(apm->ProcessReverseStream(&frame));
+  EXPECT_NOERR(apm->ProcessStream(&frame));
+  // A disabled residual echo detector reports no likelihood.
+  EXPECT_EQ(-1.0f, apm->GetStatistics().residual_echo_likelihood);
+
+  config.residual_echo_detector.enabled = true;
+  config.level_controller.enabled = true;
+  apm->ApplyConfig(config);
+  for (int k = 0; k < 10; ++k) {
+    EXPECT_NOERR(apm->ProcessReverseStream(&frame));
+    EXPECT_NOERR(apm->ProcessStream(&frame));
+  }
+  EXPECT_LE(0.0f, apm->GetStatistics().residual_echo_likelihood);
+
+  config.residual_echo_detector.enabled = false;
+  config.level_controller.enabled = false;
+  apm->ApplyConfig(config);
+  EXPECT_NOERR(apm->ProcessReverseStream(&frame));
+  EXPECT_NOERR(apm->ProcessStream(&frame));
+  EXPECT_EQ(-1.0f, apm->GetStatistics().residual_echo_likelihood);
+}
+
 }  // namespace webrtc
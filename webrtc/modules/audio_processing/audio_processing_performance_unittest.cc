@@ -55,7 +55,8 @@ enum class SettingsType {
   kDefaultApmDesktopAndIntelligibilityEnhancer,
   kAllSubmodulesTurnedOff,
   kDefaultApmDesktopWithoutDelayAgnostic,
-  kDefaultApmDesktopWithoutExtendedFilter
+  kDefaultApmDesktopWithoutExtendedFilter,
+  kGainController2Only
 };
 
 // Variables related to the audio data and formats.
@@ -93,7 +94,8 @@ struct SimulationConfig {
     const SettingsType desktop_settings[] = {
         SettingsType::kDefaultApmDesktop, SettingsType::kAllSubmodulesTurnedOff,
         SettingsType::kDefaultApmDesktopWithoutDelayAgnostic,
-        SettingsType::kDefaultApmDesktopWithoutExtendedFilter};
+        SettingsType::kDefaultApmDesktopWithoutExtendedFilter,
+        SettingsType::kGainController2Only};
 
     const int desktop_sample_rates[] = {8000, 16000, 32000, 48000};
 
@@ -166,6 +168,9 @@ struct SimulationConfig {
       case SettingsType::kDefaultApmDesktopWithoutExtendedFilter:
         description = "DefaultApmDesktopWithoutExtendedFilter";
         break;
+      case SettingsType::kGainController2Only:
+        description = "GainController2Only";
+        break;
     }
     return description;
   }
@@ -634,6 +639,15 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
         apm_->SetExtraOptions(config);
         break;
       }
+      case SettingsType::kGainController2Only: {
+        apm_.reset(AudioProcessingImpl::Create());
+        ASSERT_TRUE(!!apm_);
+        turn_off_default_apm_runtime_settings(apm_.get());
+        AudioProcessing::Config apm_config;
+        apm_config.gain_controller2.enabled = true;
+        apm_->ApplyConfig(apm_config);
+        break;
+      }
     }
 
     render_thread_state_.reset(new TimedThreadApiProcessor(
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/batched_audio_processing.h"
+
+#include <algorithm>
+
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/platform_thread.h"
+
+namespace webrtc {
+
+class BatchedAudioProcessing::Worker {
+ public:
+  explicit Worker(BatchedAudioProcessing* owner)
+      : owner_(owner),
+        wake_(false, false),
+        thread_(&Worker::Run, this, "BatchedApmWorker", rtc::kHighPriority) {
+    thread_.Start();
+  }
+
+  ~Worker() {
+    stop_ = true;
+    wake_.Set();
+    thread_.Stop();
+  }
+
+  void Wake() { wake_.Set(); }
+
+ private:
+  static void Run(void* obj) {
+    Worker* worker = static_cast<Worker*>(obj);
+    while (true) {
+      worker->wake_.Wait(rtc::Event::kForever);
+      if (worker->stop_)
+        return;
+      worker->owner_->ProcessPendingStreams();
+      worker->owner_->OnWorkerDone();
+    }
+  }
+
+  BatchedAudioProcessing* const owner_;
+  rtc::Event wake_;
+  // Written before |wake_| is set.
+  bool stop_ = false;
+  rtc::PlatformThread thread_;
+};
+
+BatchedAudioProcessing::BatchedAudioProcessing(size_t num_threads)
+    : batch_done_(false, false) {
+  RTC_DCHECK_GE(num_threads, 1);
+  for (size_t i = 1; i < num_threads; ++i)
+    workers_.emplace_back(new Worker(this));
+}
+
+BatchedAudioProcessing::~BatchedAudioProcessing() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  workers_.clear();
+}
+
+void BatchedAudioProcessing::ProcessCaptureStreams(
+    rtc::ArrayView<Stream> streams) {
+  ProcessStreams(streams, false);
+}
+
+void BatchedAudioProcessing::ProcessRenderStreams(
+    rtc::ArrayView<Stream> streams) {
+  ProcessStreams(streams, true);
+}
+
+void BatchedAudioProcessing::ProcessStreams(rtc::ArrayView<Stream> streams,
+                                            bool render) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  streams_ = streams;
+  render_ = render;
+  next_stream_ = 0;
+
+  // The calling thread takes a stream too, so there's no point in waking
+  // more workers than there are remaining streams.
+  const size_t num_woken =
+      std::min(workers_.size(), streams.empty() ? 0 : streams.size() - 1);
+  num_active_workers_ = static_cast<int>(num_woken);
+  for (size_t i = 0; i < num_woken; ++i)
+    workers_[i]->Wake();
+
+  ProcessPendingStreams();
+  if (num_woken > 0)
+    batch_done_.Wait(rtc::Event::kForever);
+  streams_ = rtc::ArrayView<Stream>();
+}
+
+void BatchedAudioProcessing::ProcessPendingStreams() {
+  const int num_streams = static_cast<int>(streams_.size());
+  while (true) {
+    const int index = rtc::AtomicOps::Increment(&next_stream_) - 1;
+    if (index >= num_streams)
+      return;
+    Stream& stream = streams_[index];
+    stream.error = render_ ? stream.apm->ProcessReverseStream(stream.frame)
+                           : stream.apm->ProcessStream(stream.frame);
+  }
+}
+
+void BatchedAudioProcessing::OnWorkerDone() {
+  if (rtc::AtomicOps::Decrement(&num_active_workers_) == 0)
+    batch_done_.Set();
+}
+
+}  // namespace webrtc
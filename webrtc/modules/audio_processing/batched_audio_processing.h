@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/rtc_base/array_view.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/thread_checker.h"
+
+namespace webrtc {
+
+class AudioFrame;
+class AudioProcessing;
+
+// Processes the 10 ms frames of many independent AudioProcessing instances in
+// one call, as done on media servers with one instance per participant. The
+// frames of a batch are spread over a fixed set of worker threads, which are
+// woken once per batch instead of once per frame.
+//
+// All methods must be called on the same thread. The AudioProcessing instances
+// in a batch must be distinct, and not used elsewhere during the call.
+class BatchedAudioProcessing {
+ public:
+  struct Stream {
+    AudioProcessing* apm;
+    AudioFrame* frame;
+    // Result of processing |frame|; set by the Process*Streams() methods.
+    int error;
+  };
+
+  // Uses |num_threads| threads for processing, counting the calling thread.
+  explicit BatchedAudioProcessing(size_t num_threads);
+  ~BatchedAudioProcessing();
+
+  // Runs AudioProcessing::ProcessStream() on each of |streams|. Returns when
+  // all of them are done.
+  void ProcessCaptureStreams(rtc::ArrayView<Stream> streams);
+
+  // Runs AudioProcessing::ProcessReverseStream() on each of |streams|.
+  void ProcessRenderStreams(rtc::ArrayView<Stream> streams);
+
+ private:
+  class Worker;
+
+  void ProcessStreams(rtc::ArrayView<Stream> streams, bool render);
+  // Processes streams of the current batch until none are left. Called on
+  // the calling thread and on the woken workers.
+  void ProcessPendingStreams();
+  void OnWorkerDone();
+
+  rtc::ThreadChecker thread_checker_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  rtc::Event batch_done_;
+
+  // The current batch. Written before the workers are woken and only read
+  // until they are done.
+  rtc::ArrayView<Stream> streams_;
+  bool render_ = false;
+  volatile int next_stream_ = 0;
+  volatile int num_active_workers_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BatchedAudioProcessing);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/batched_audio_processing.h"
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/modules/audio_processing/test/test_utils.h"
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const size_t kNumStreams = 7;
+const int kNumFrames = 100;
+
+std::unique_ptr<AudioProcessing> CreateApm() {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessing::Create());
+  EXPECT_EQ(AudioProcessing::kNoError,
+            apm->noise_suppression()->Enable(true));
+  EXPECT_EQ(AudioProcessing::kNoError, apm->gain_control()->set_mode(
+                                           GainControl::kAdaptiveDigital));
+  EXPECT_EQ(AudioProcessing::kNoError, apm->gain_control()->Enable(true));
+  return apm;
+}
+
+void RandomizeFrame(Random* random, AudioFrame* frame) {
+  frame->num_channels_ = 1;
+  SetFrameSampleRate(frame, kSampleRateHz);
+  int16_t* data = frame->mutable_data();
+  for (size_t i = 0; i < frame->samples_per_channel_; ++i)
+    data[i] = random->Rand(-2000, 2000);
+}
+
+void ExpectFramesEqual(const AudioFrame& expected, const AudioFrame& actual) {
+  ASSERT_EQ(expected.samples_per_channel_, actual.samples_per_channel_);
+  for (size_t i = 0; i < expected.samples_per_channel_; ++i)
+    ASSERT_EQ(expected.data()[i], actual.data()[i]) << "sample " << i;
+}
+
+// Processes the same input through one set of instances with |batched| and
+// through another set one frame at a time, and expects identical output.
+void ExpectSameOutputAsUnbatched(BatchedAudioProcessing* batched) {
+  std::vector<std::unique_ptr<AudioProcessing>> batched_apms;
+  std::vector<std::unique_ptr<AudioProcessing>> reference_apms;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    batched_apms.push_back(CreateApm());
+    reference_apms.push_back(CreateApm());
+  }
+
+  Random random(42);
+  std::vector<AudioFrame> render_frames(kNumStreams);
+  std::vector<AudioFrame> capture_frames(kNumStreams);
+  std::vector<AudioFrame> reference_render_frames(kNumStreams);
+  std::vector<AudioFrame> reference_capture_frames(kNumStreams);
+  std::vector<BatchedAudioProcessing::Stream> render_streams(kNumStreams);
+  std::vector<BatchedAudioProcessing::Stream> capture_streams(kNumStreams);
+  for (int n = 0; n < kNumFrames; ++n) {
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      RandomizeFrame(&random, &render_frames[i]);
+      RandomizeFrame(&random, &capture_frames[i]);
+      reference_render_frames[i].CopyFrom(render_frames[i]);
+      reference_capture_frames[i].CopyFrom(capture_frames[i]);
+      render_streams[i] = {batched_apms[i].get(), &render_frames[i], -1};
+      capture_streams[i] = {batched_apms[i].get(), &capture_frames[i], -1};
+    }
+
+    batched->ProcessRenderStreams(render_streams);
+    batched->ProcessCaptureStreams(capture_streams);
+
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      EXPECT_EQ(AudioProcessing::kNoError,
+                reference_apms[i]->ProcessReverseStream(
+                    &reference_render_frames[i]));
+      EXPECT_EQ(AudioProcessing::kNoError,
+                reference_apms[i]->ProcessStream(&reference_capture_frames[i]));
+      EXPECT_EQ(AudioProcessing::kNoError, render_streams[i].error);
+      EXPECT_EQ(AudioProcessing::kNoError, capture_streams[i].error);
+      ExpectFramesEqual(reference_render_frames[i], render_frames[i]);
+      ExpectFramesEqual(reference_capture_frames[i], capture_frames[i]);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(BatchedAudioProcessingTest, SingleThreadMatchesUnbatched) {
+  BatchedAudioProcessing batched(1);
+  ExpectSameOutputAsUnbatched(&batched);
+}
+
+TEST(BatchedAudioProcessingTest, MultipleThreadsMatchUnbatched) {
+  BatchedAudioProcessing batched(3);
+  ExpectSameOutputAsUnbatched(&batched);
+}
+
+TEST(BatchedAudioProcessingTest, MoreThreadsThanStreams) {
+  BatchedAudioProcessing batched(kNumStreams + 4);
+  ExpectSameOutputAsUnbatched(&batched);
+}
+
+TEST(BatchedAudioProcessingTest, EmptyBatch) {
+  BatchedAudioProcessing batched(2);
+  std::vector<BatchedAudioProcessing::Stream> streams;
+  batched.ProcessCaptureStreams(streams);
+}
+
+TEST(BatchedAudioProcessingTest, ReportsErrorsPerStream) {
+  BatchedAudioProcessing batched(2);
+  std::unique_ptr<AudioProcessing> apm = CreateApm();
+  std::unique_ptr<AudioProcessing> other_apm = CreateApm();
+  AudioFrame valid_frame;
+  Random random(17);
+  RandomizeFrame(&random, &valid_frame);
+  AudioFrame invalid_frame;
+  invalid_frame.CopyFrom(valid_frame);
+  invalid_frame.sample_rate_hz_ = 12345;
+
+  std::vector<BatchedAudioProcessing::Stream> streams = {
+      {apm.get(), &valid_frame, -1}, {other_apm.get(), &invalid_frame, -1}};
+  batched.ProcessCaptureStreams(streams);
+  EXPECT_EQ(AudioProcessing::kNoError, streams[0].error);
+  EXPECT_EQ(AudioProcessing::kBadSampleRateError, streams[1].error);
+}
+
+}  // namespace webrtc
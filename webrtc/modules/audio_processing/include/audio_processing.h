@@ -316,6 +316,12 @@ class AudioProcessing : public rtc::RefCountInterface {
 
           float floor_first_increase = 0.001f;
         } gain_updates;
+
+        struct Delay {
+          // Whether to only update the matched filters around the echo path
+          // delay once it has been found, rather than searching all the lags.
+          bool track_converged_delay = false;
+        } delay;
       } param;
       bool enabled = false;
     } echo_canceller3;
@@ -328,6 +334,13 @@ class AudioProcessing : public rtc::RefCountInterface {
       bool enabled = false;
     } gain_controller2;
 
+    // Enables measuring the time spent in the individual capture-side
+    // submodules. The results are logged to UMA histograms and reported in
+    // AudioProcessingStatistics::submodule_timings.
+    struct SubmoduleTiming {
+      bool enabled = false;
+    } submodule_timing;
+
     // Explicit copy assignment implementation to avoid issues with memory
     // sanitizer complaints in case of self-assignment.
     // TODO(peah): Add buildflag to ensure that this is only included for memory
@@ -600,6 +613,18 @@ class AudioProcessing : public rtc::RefCountInterface {
     float residual_echo_likelihood = -1.0f;
     // Maximum residual echo likelihood from the last time period.
     float residual_echo_likelihood_recent_max = -1.0f;
+
+    // Time spent per 10 ms frame in a capture-side submodule, in
+    // microseconds, over the frames of a ten second window in which it ran.
+    struct SubmoduleTiming {
+      // Static string, e.g. "NoiseSuppression".
+      const char* name = "";
+      int average_us = -1;
+      int max_us = -1;
+    };
+    // Timings of the last completed window, if Config::submodule_timing is
+    // enabled. Only submodules that ran during the window are included.
+    std::vector<SubmoduleTiming> submodule_timings;
   };
 
   // TODO(ivoc): Make this pure virtual when all subclasses have been updated.
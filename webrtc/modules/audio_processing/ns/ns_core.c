@@ -18,6 +18,36 @@
 #include "webrtc/modules/audio_processing/ns/noise_suppression.h"
 #include "webrtc/modules/audio_processing/ns/ns_core.h"
 #include "webrtc/modules/audio_processing/ns/windows_private.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+NsMagnitudeSpectrum WebRtcNs_MagnitudeSpectrum;
+NsComputeSnr WebRtcNs_ComputeSnr;
+NsUpdateNoiseEstimate WebRtcNs_UpdateNoiseEstimate;
+NsComputeDdBasedWienerFilter WebRtcNs_ComputeDdBasedWienerFilter;
+NsFloorFilter WebRtcNs_FloorFilter;
+NsApplyFilter WebRtcNs_ApplyFilter;
+
+static void MagnitudeSpectrumC(const float* time_data,
+                               size_t magnitude_length,
+                               float* real,
+                               float* imag,
+                               float* magn);
+static void ComputeSnrC(const NoiseSuppressionC* self,
+                        const float* magn,
+                        const float* noise,
+                        float* snrLocPrior,
+                        float* snrLocPost);
+static void UpdateNoiseEstimateC(NoiseSuppressionC* self,
+                                 const float* magn,
+                                 float* noise);
+static void ComputeDdBasedWienerFilterC(const NoiseSuppressionC* self,
+                                        const float* magn,
+                                        float* theFilter);
+static void FloorFilterC(const NoiseSuppressionC* self, float* theFilter);
+static void ApplyFilterC(NoiseSuppressionC* self,
+                         const float* theFilter,
+                         float* real,
+                         float* imag);
 
 // Set Feature Extraction Parameters.
 static void set_feature_extraction_parameters(NoiseSuppressionC* self) {
@@ -206,6 +236,19 @@ int WebRtcNs_InitCore(NoiseSuppressionC* self, uint32_t fs) {
 
   set_feature_extraction_parameters(self);
 
+  WebRtcNs_MagnitudeSpectrum = MagnitudeSpectrumC;
+  WebRtcNs_ComputeSnr = ComputeSnrC;
+  WebRtcNs_UpdateNoiseEstimate = UpdateNoiseEstimateC;
+  WebRtcNs_ComputeDdBasedWienerFilter = ComputeDdBasedWienerFilterC;
+  WebRtcNs_FloorFilter = FloorFilterC;
+  WebRtcNs_ApplyFilter = ApplyFilterC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcNs_InitSSE2();
+  }
+#endif
+
   // Default mode.
   WebRtcNs_set_policy_core(self, 0);
 
@@ -563,11 +606,11 @@ static void ComputeSpectralFlatness(NoiseSuppressionC* self,
 // Outputs:
 //   * |snrLocPrior| is the computed prior SNR.
 //   * |snrLocPost| is the computed post SNR.
-static void ComputeSnr(const NoiseSuppressionC* self,
-                       const float* magn,
-                       const float* noise,
-                       float* snrLocPrior,
-                       float* snrLocPost) {
+static void ComputeSnrC(const NoiseSuppressionC* self,
+                        const float* magn,
+                        const float* noise,
+                        float* snrLocPrior,
+                        float* snrLocPost) {
   size_t i;
 
   for (i = 0; i < self->magnLen; i++) {
@@ -794,15 +837,11 @@ static void FeatureUpdate(NoiseSuppressionC* self,
 // Update the noise estimate.
 // Inputs:
 //   * |magn| is the signal magnitude spectrum estimate.
-//   * |snrLocPrior| is the prior SNR.
-//   * |snrLocPost| is the post SNR.
 // Output:
 //   * |noise| is the updated noise magnitude spectrum estimate.
-static void UpdateNoiseEstimate(NoiseSuppressionC* self,
-                                const float* magn,
-                                const float* snrLocPrior,
-                                const float* snrLocPost,
-                                float* noise) {
+static void UpdateNoiseEstimateC(NoiseSuppressionC* self,
+                                 const float* magn,
+                                 float* noise) {
   size_t i;
   float probSpeech, probNonSpeech;
   // Time-avg parameter for noise update.
@@ -891,8 +930,6 @@ static void FFT(NoiseSuppressionC* self,
                 float* real,
                 float* imag,
                 float* magn) {
-  size_t i;
-
   RTC_DCHECK_EQ(magnitude_length, time_data_length / 2 + 1);
 
   WebRtc_rdft(time_data_length, 1, time_data, self->ip, self->wfft);
@@ -903,6 +940,15 @@ static void FFT(NoiseSuppressionC* self,
   imag[magnitude_length - 1] = 0;
   real[magnitude_length - 1] = time_data[1];
   magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
+  WebRtcNs_MagnitudeSpectrum(time_data, magnitude_length, real, imag, magn);
+}
+
+static void MagnitudeSpectrumC(const float* time_data,
+                               size_t magnitude_length,
+                               float* real,
+                               float* imag,
+                               float* magn) {
+  size_t i;
   for (i = 1; i < magnitude_length - 1; ++i) {
     real[i] = time_data[2 * i];
     imag[i] = time_data[2 * i + 1];
@@ -983,9 +1029,9 @@ static void Windowing(const float* window,
 //   * |magn| is the signal magnitude spectrum estimate.
 // Output:
 //   * |theFilter| is the frequency response of the computed Wiener filter.
-static void ComputeDdBasedWienerFilter(const NoiseSuppressionC* self,
-                                       const float* magn,
-                                       float* theFilter) {
+static void ComputeDdBasedWienerFilterC(const NoiseSuppressionC* self,
+                                        const float* magn,
+                                        float* theFilter) {
   size_t i;
   float snrPrior, previousEstimateStsa, currentEstimateStsa;
 
@@ -1007,6 +1053,32 @@ static void ComputeDdBasedWienerFilter(const NoiseSuppressionC* self,
   }  // End of loop over frequencies.
 }
 
+static void FloorFilterC(const NoiseSuppressionC* self, float* theFilter) {
+  size_t i;
+  for (i = 0; i < self->magnLen; i++) {
+    // Flooring bottom.
+    if (theFilter[i] < self->denoiseBound) {
+      theFilter[i] = self->denoiseBound;
+    }
+    // Flooring top.
+    if (theFilter[i] > 1.f) {
+      theFilter[i] = 1.f;
+    }
+  }
+}
+
+static void ApplyFilterC(NoiseSuppressionC* self,
+                         const float* theFilter,
+                         float* real,
+                         float* imag) {
+  size_t i;
+  for (i = 0; i < self->magnLen; i++) {
+    self->smooth[i] = theFilter[i];
+    real[i] *= self->smooth[i];
+    imag[i] *= self->smooth[i];
+  }
+}
+
 // Changes the aggressiveness of the noise suppression method.
 // |mode| = 0 is mild (6dB), |mode| = 1 is medium (10dB) and |mode| = 2 is
 // aggressive (15dB).
@@ -1170,11 +1242,11 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC* self, const float* speechFrame) {
   }
 
   // Post and prior SNR needed for SpeechNoiseProb.
-  ComputeSnr(self, magn, noise, snrLocPrior, snrLocPost);
+  WebRtcNs_ComputeSnr(self, magn, noise, snrLocPrior, snrLocPost);
 
   FeatureUpdate(self, magn, updateParsFlag);
   SpeechNoiseProb(self, self->speechProb, snrLocPrior, snrLocPost);
-  UpdateNoiseEstimate(self, magn, snrLocPrior, snrLocPost, noise);
+  WebRtcNs_UpdateNoiseEstimate(self, magn, noise);
 
   // Keep track of noise spectrum for next frame.
   memcpy(self->noise, noise, sizeof(*noise) * self->magnLen);
@@ -1272,18 +1344,11 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
     }
   }
 
-  ComputeDdBasedWienerFilter(self, magn, theFilter);
+  WebRtcNs_ComputeDdBasedWienerFilter(self, magn, theFilter);
+  WebRtcNs_FloorFilter(self, theFilter);
 
-  for (i = 0; i < self->magnLen; i++) {
-    // Flooring bottom.
-    if (theFilter[i] < self->denoiseBound) {
-      theFilter[i] = self->denoiseBound;
-    }
-    // Flooring top.
-    if (theFilter[i] > 1.f) {
-      theFilter[i] = 1.f;
-    }
-    if (self->blockInd < END_STARTUP_SHORT) {
+  if (self->blockInd < END_STARTUP_SHORT) {
+    for (i = 0; i < self->magnLen; i++) {
       theFilterTmp[i] =
           (self->initMagnEst[i] - self->overdrive * self->parametricNoise[i]);
       theFilterTmp[i] /= (self->initMagnEst[i] + 0.0001f);
@@ -1301,11 +1366,9 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
       theFilter[i] += theFilterTmp[i];
       theFilter[i] /= (END_STARTUP_SHORT);
     }
-
-    self->smooth[i] = theFilter[i];
-    real[i] *= self->smooth[i];
-    imag[i] *= self->smooth[i];
   }
+
+  WebRtcNs_ApplyFilter(self, theFilter, real, imag);
   // Keep track of |magn| spectrum for next frame.
   memcpy(self->magnPrevProcess, magn, sizeof(*magn) * self->magnLen);
   memcpy(self->noisePrev, self->noise, sizeof(self->noise[0]) * self->magnLen);
@@ -11,7 +11,10 @@
 #ifndef WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 #define WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 
+#include <stddef.h>
+
 #include "webrtc/modules/audio_processing/ns/defines.h"
+#include "webrtc/typedefs.h"
 
 typedef struct NSParaExtract_ {
   // Bin size of histogram.
@@ -184,6 +187,57 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
                           size_t num_bands,
                           float* const* outFrame);
 
+/****************************************************************************
+ * Function pointers for the per-frequency loops of the core, shared by the
+ * generic C and the SSE2 implementations. They are set by
+ * WebRtcNs_InitCore(). The SSE2 versions produce the same output as the C
+ * versions.
+ */
+
+// Splits the packed output of WebRtc_rdft() into |real| and |imag|, and
+// computes |magn|, for the bins 1 to |magnitude_length| - 2.
+typedef void (*NsMagnitudeSpectrum)(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn);
+extern NsMagnitudeSpectrum WebRtcNs_MagnitudeSpectrum;
+
+// Computes the prior and post SNR from the quantile noise estimate.
+typedef void (*NsComputeSnr)(const NoiseSuppressionC* self,
+                             const float* magn,
+                             const float* noise,
+                             float* snrLocPrior,
+                             float* snrLocPost);
+extern NsComputeSnr WebRtcNs_ComputeSnr;
+
+// Updates |noise| from the previous noise estimate and the speech probability.
+typedef void (*NsUpdateNoiseEstimate)(NoiseSuppressionC* self,
+                                      const float* magn,
+                                      float* noise);
+extern NsUpdateNoiseEstimate WebRtcNs_UpdateNoiseEstimate;
+
+// Computes the decision-directed Wiener filter.
+typedef void (*NsComputeDdBasedWienerFilter)(const NoiseSuppressionC* self,
+                                             const float* magn,
+                                             float* theFilter);
+extern NsComputeDdBasedWienerFilter WebRtcNs_ComputeDdBasedWienerFilter;
+
+// Limits |theFilter| to the range [self->denoiseBound, 1].
+typedef void (*NsFloorFilter)(const NoiseSuppressionC* self, float* theFilter);
+extern NsFloorFilter WebRtcNs_FloorFilter;
+
+// Stores |theFilter| as the smoothed filter and applies it to the spectrum.
+typedef void (*NsApplyFilter)(NoiseSuppressionC* self,
+                              const float* theFilter,
+                              float* real,
+                              float* imag);
+extern NsApplyFilter WebRtcNs_ApplyFilter;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcNs_InitSSE2(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,257 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core noise suppression algorithm, SSE2 version of the per-frequency
+ * loops. The operations are done in the same order as in the C versions, so
+ * the output is bit-exact.
+ */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_processing/ns/defines.h"
+#include "webrtc/modules/audio_processing/ns/ns_core.h"
+
+static void MagnitudeSpectrumSSE2(const float* time_data,
+                                  size_t magnitude_length,
+                                  float* real,
+                                  float* imag,
+                                  float* magn) {
+  const __m128 one = _mm_set1_ps(1.f);
+  size_t i = 1;
+  for (; i + 4 <= magnitude_length - 1; i += 4) {
+    const __m128 a = _mm_loadu_ps(&time_data[2 * i]);
+    const __m128 b = _mm_loadu_ps(&time_data[2 * i + 4]);
+    const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 energy = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+    _mm_storeu_ps(&real[i], re);
+    _mm_storeu_ps(&imag[i], im);
+    _mm_storeu_ps(&magn[i], _mm_add_ps(_mm_sqrt_ps(energy), one));
+  }
+  for (; i < magnitude_length - 1; ++i) {
+    real[i] = time_data[2 * i];
+    imag[i] = time_data[2 * i + 1];
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+static void ComputeSnrSSE2(const NoiseSuppressionC* self,
+                           const float* magn,
+                           const float* noise,
+                           float* snrLocPrior,
+                           float* snrLocPost) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 epsilon = _mm_set1_ps(0.0001f);
+  const __m128 dd_pr_snr = _mm_set1_ps(DD_PR_SNR);
+  const __m128 one_minus_dd_pr_snr = _mm_set1_ps(1.f - DD_PR_SNR);
+  size_t i = 0;
+  for (; i + 4 <= self->magnLen; i += 4) {
+    const __m128 magn_v = _mm_loadu_ps(&magn[i]);
+    const __m128 noise_v = _mm_loadu_ps(&noise[i]);
+    const __m128 previous_estimate_stsa = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&self->magnPrevAnalyze[i]),
+                   _mm_add_ps(_mm_loadu_ps(&self->noisePrev[i]), epsilon)),
+        _mm_loadu_ps(&self->smooth[i]));
+    const __m128 post = _mm_sub_ps(
+        _mm_div_ps(magn_v, _mm_add_ps(noise_v, epsilon)), one);
+    const __m128 snr_post = _mm_and_ps(_mm_cmpgt_ps(magn_v, noise_v), post);
+    _mm_storeu_ps(&snrLocPost[i], snr_post);
+    _mm_storeu_ps(&snrLocPrior[i],
+                  _mm_add_ps(_mm_mul_ps(dd_pr_snr, previous_estimate_stsa),
+                             _mm_mul_ps(one_minus_dd_pr_snr, snr_post)));
+  }
+  for (; i < self->magnLen; i++) {
+    float previousEstimateStsa = self->magnPrevAnalyze[i] /
+        (self->noisePrev[i] + 0.0001f) * self->smooth[i];
+    snrLocPost[i] = 0.f;
+    if (magn[i] > noise[i]) {
+      snrLocPost[i] = magn[i] / (noise[i] + 0.0001f) - 1.f;
+    }
+    snrLocPrior[i] =
+        DD_PR_SNR * previousEstimateStsa + (1.f - DD_PR_SNR) * snrLocPost[i];
+  }
+}
+
+static void UpdateNoiseEstimateSSE2(NoiseSuppressionC* self,
+                                    const float* magn,
+                                    float* noise) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 noise_update = _mm_set1_ps(NOISE_UPDATE);
+  const __m128 speech_update = _mm_set1_ps(SPEECH_UPDATE);
+  const __m128 prob_range = _mm_set1_ps(PROB_RANGE);
+  const __m128 gamma_pause = _mm_set1_ps(GAMMA_PAUSE);
+  // The time constant used for a frequency bin depends on the speech
+  // probability of the bin below it, see the C version.
+  float gammaNoiseTmp = NOISE_UPDATE;
+  size_t i = 0;
+  for (; i + 4 <= self->magnLen; i += 4) {
+    const __m128 prob_speech = _mm_loadu_ps(&self->speechProb[i]);
+    const __m128 prob_non_speech = _mm_sub_ps(one, prob_speech);
+    const __m128 magn_v = _mm_loadu_ps(&magn[i]);
+    const __m128 noise_prev = _mm_loadu_ps(&self->noisePrev[i]);
+    const __m128 target = _mm_add_ps(_mm_mul_ps(prob_non_speech, magn_v),
+                                     _mm_mul_ps(prob_speech, noise_prev));
+
+    // Previous bin's time-constant in each lane.
+    __m128 prob_speech_below;
+    if (i == 0) {
+      prob_speech_below = _mm_shuffle_ps(prob_speech, prob_speech,
+                                         _MM_SHUFFLE(2, 1, 0, 0));
+      prob_speech_below = _mm_move_ss(prob_speech_below, _mm_setzero_ps());
+    } else {
+      prob_speech_below = _mm_loadu_ps(&self->speechProb[i - 1]);
+    }
+    const __m128 speech_below = _mm_cmpgt_ps(prob_speech_below, prob_range);
+    const __m128 gamma_old =
+        _mm_or_ps(_mm_and_ps(speech_below, speech_update),
+                  _mm_andnot_ps(speech_below, noise_update));
+    const __m128 speech = _mm_cmpgt_ps(prob_speech, prob_range);
+    const __m128 gamma_new = _mm_or_ps(_mm_and_ps(speech, speech_update),
+                                       _mm_andnot_ps(speech, noise_update));
+
+    const __m128 noise_update_tmp =
+        _mm_add_ps(_mm_mul_ps(gamma_old, noise_prev),
+                   _mm_mul_ps(_mm_sub_ps(one, gamma_old), target));
+    const __m128 noise_new =
+        _mm_add_ps(_mm_mul_ps(gamma_new, noise_prev),
+                   _mm_mul_ps(_mm_sub_ps(one, gamma_new), target));
+    const __m128 same_gamma = _mm_cmpeq_ps(gamma_new, gamma_old);
+    _mm_storeu_ps(
+        &noise[i],
+        _mm_or_ps(_mm_and_ps(same_gamma, noise_update_tmp),
+                  _mm_andnot_ps(same_gamma,
+                                _mm_min_ps(noise_update_tmp, noise_new))));
+
+    // Conservative noise update.
+    const __m128 pause = _mm_cmplt_ps(prob_speech, prob_range);
+    const __m128 magn_avg_pause = _mm_loadu_ps(&self->magnAvgPause[i]);
+    const __m128 updated_pause = _mm_add_ps(
+        magn_avg_pause,
+        _mm_mul_ps(gamma_pause, _mm_sub_ps(magn_v, magn_avg_pause)));
+    _mm_storeu_ps(&self->magnAvgPause[i],
+                  _mm_or_ps(_mm_and_ps(pause, updated_pause),
+                            _mm_andnot_ps(pause, magn_avg_pause)));
+  }
+  if (i > 0 && self->speechProb[i - 1] > PROB_RANGE) {
+    gammaNoiseTmp = SPEECH_UPDATE;
+  }
+  for (; i < self->magnLen; i++) {
+    const float probSpeech = self->speechProb[i];
+    const float probNonSpeech = 1.f - probSpeech;
+    const float noiseUpdateTmp =
+        gammaNoiseTmp * self->noisePrev[i] +
+        (1.f - gammaNoiseTmp) *
+            (probNonSpeech * magn[i] + probSpeech * self->noisePrev[i]);
+    const float gammaNoiseOld = gammaNoiseTmp;
+    gammaNoiseTmp = NOISE_UPDATE;
+    if (probSpeech > PROB_RANGE) {
+      gammaNoiseTmp = SPEECH_UPDATE;
+    }
+    if (probSpeech < PROB_RANGE) {
+      self->magnAvgPause[i] += GAMMA_PAUSE * (magn[i] - self->magnAvgPause[i]);
+    }
+    if (gammaNoiseTmp == gammaNoiseOld) {
+      noise[i] = noiseUpdateTmp;
+    } else {
+      noise[i] = gammaNoiseTmp * self->noisePrev[i] +
+                 (1.f - gammaNoiseTmp) * (probNonSpeech * magn[i] +
+                                          probSpeech * self->noisePrev[i]);
+      if (noiseUpdateTmp < noise[i]) {
+        noise[i] = noiseUpdateTmp;
+      }
+    }
+  }
+}
+
+static void ComputeDdBasedWienerFilterSSE2(const NoiseSuppressionC* self,
+                                           const float* magn,
+                                           float* theFilter) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 epsilon = _mm_set1_ps(0.0001f);
+  const __m128 dd_pr_snr = _mm_set1_ps(DD_PR_SNR);
+  const __m128 one_minus_dd_pr_snr = _mm_set1_ps(1.f - DD_PR_SNR);
+  const __m128 overdrive = _mm_set1_ps(self->overdrive);
+  size_t i = 0;
+  for (; i + 4 <= self->magnLen; i += 4) {
+    const __m128 magn_v = _mm_loadu_ps(&magn[i]);
+    const __m128 noise_v = _mm_loadu_ps(&self->noise[i]);
+    const __m128 previous_estimate_stsa = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&self->magnPrevProcess[i]),
+                   _mm_add_ps(_mm_loadu_ps(&self->noisePrev[i]), epsilon)),
+        _mm_loadu_ps(&self->smooth[i]));
+    const __m128 current = _mm_sub_ps(
+        _mm_div_ps(magn_v, _mm_add_ps(noise_v, epsilon)), one);
+    const __m128 current_estimate_stsa =
+        _mm_and_ps(_mm_cmpgt_ps(magn_v, noise_v), current);
+    const __m128 snr_prior =
+        _mm_add_ps(_mm_mul_ps(dd_pr_snr, previous_estimate_stsa),
+                   _mm_mul_ps(one_minus_dd_pr_snr, current_estimate_stsa));
+    _mm_storeu_ps(&theFilter[i],
+                  _mm_div_ps(snr_prior, _mm_add_ps(overdrive, snr_prior)));
+  }
+  for (; i < self->magnLen; i++) {
+    const float previousEstimateStsa = self->magnPrevProcess[i] /
+        (self->noisePrev[i] + 0.0001f) * self->smooth[i];
+    float currentEstimateStsa = 0.f;
+    if (magn[i] > self->noise[i]) {
+      currentEstimateStsa = magn[i] / (self->noise[i] + 0.0001f) - 1.f;
+    }
+    const float snrPrior = DD_PR_SNR * previousEstimateStsa +
+                           (1.f - DD_PR_SNR) * currentEstimateStsa;
+    theFilter[i] = snrPrior / (self->overdrive + snrPrior);
+  }
+}
+
+static void FloorFilterSSE2(const NoiseSuppressionC* self, float* theFilter) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 bound = _mm_set1_ps(self->denoiseBound);
+  size_t i = 0;
+  for (; i + 4 <= self->magnLen; i += 4) {
+    const __m128 filter = _mm_loadu_ps(&theFilter[i]);
+    _mm_storeu_ps(&theFilter[i], _mm_min_ps(_mm_max_ps(filter, bound), one));
+  }
+  for (; i < self->magnLen; i++) {
+    if (theFilter[i] < self->denoiseBound) {
+      theFilter[i] = self->denoiseBound;
+    }
+    if (theFilter[i] > 1.f) {
+      theFilter[i] = 1.f;
+    }
+  }
+}
+
+static void ApplyFilterSSE2(NoiseSuppressionC* self,
+                            const float* theFilter,
+                            float* real,
+                            float* imag) {
+  size_t i = 0;
+  for (; i + 4 <= self->magnLen; i += 4) {
+    const __m128 filter = _mm_loadu_ps(&theFilter[i]);
+    _mm_storeu_ps(&self->smooth[i], filter);
+    _mm_storeu_ps(&real[i], _mm_mul_ps(_mm_loadu_ps(&real[i]), filter));
+    _mm_storeu_ps(&imag[i], _mm_mul_ps(_mm_loadu_ps(&imag[i]), filter));
+  }
+  for (; i < self->magnLen; i++) {
+    self->smooth[i] = theFilter[i];
+    real[i] *= self->smooth[i];
+    imag[i] *= self->smooth[i];
+  }
+}
+
+void WebRtcNs_InitSSE2(void) {
+  WebRtcNs_MagnitudeSpectrum = MagnitudeSpectrumSSE2;
+  WebRtcNs_ComputeSnr = ComputeSnrSSE2;
+  WebRtcNs_UpdateNoiseEstimate = UpdateNoiseEstimateSSE2;
+  WebRtcNs_ComputeDdBasedWienerFilter = ComputeDdBasedWienerFilterSSE2;
+  WebRtcNs_FloorFilter = FloorFilterSSE2;
+  WebRtcNs_ApplyFilter = ApplyFilterSSE2;
+}
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/submodule_timing_stats.h"
+
+#include <algorithm>
+#include <string>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/metrics.h"
+
+namespace webrtc {
+
+constexpr size_t SubmoduleTimingStats::kDefaultFramesPerWindow;
+
+SubmoduleTimingStats::ScopedTimer::ScopedTimer(SubmoduleTimingStats* stats,
+                                               Submodule submodule)
+    : stats_(stats),
+      submodule_(submodule),
+      start_ns_(stats ? rtc::TimeNanos() : 0) {}
+
+SubmoduleTimingStats::ScopedTimer::~ScopedTimer() {
+  if (stats_) {
+    stats_->AddDuration(submodule_, rtc::TimeNanos() - start_ns_);
+  }
+}
+
+SubmoduleTimingStats::SubmoduleTimingStats(size_t frames_per_window)
+    : frames_per_window_(frames_per_window) {
+  RTC_DCHECK_LT(0, frames_per_window);
+}
+
+SubmoduleTimingStats::~SubmoduleTimingStats() = default;
+
+void SubmoduleTimingStats::AddDuration(Submodule submodule,
+                                       int64_t duration_ns) {
+  RTC_DCHECK_LT(submodule, kNumSubmodules);
+  Accumulator& accumulator = accumulators_[submodule];
+  accumulator.frame_ns += duration_ns;
+  accumulator.ran_this_frame = true;
+}
+
+void SubmoduleTimingStats::OnFrameProcessed() {
+  for (Accumulator& accumulator : accumulators_) {
+    if (!accumulator.ran_this_frame) {
+      continue;
+    }
+    accumulator.sum_ns += accumulator.frame_ns;
+    accumulator.max_ns = std::max(accumulator.max_ns, accumulator.frame_ns);
+    ++accumulator.num_frames;
+    accumulator.frame_ns = 0;
+    accumulator.ran_this_frame = false;
+  }
+
+  if (++frame_counter_ >= frames_per_window_) {
+    CompleteWindow();
+    frame_counter_ = 0;
+  }
+}
+
+void SubmoduleTimingStats::CompleteWindow() {
+  last_window_timings_.clear();
+  for (size_t k = 0; k < accumulators_.size(); ++k) {
+    Accumulator& accumulator = accumulators_[k];
+    if (accumulator.num_frames == 0) {
+      continue;
+    }
+
+    AudioProcessing::AudioProcessingStatistics::SubmoduleTiming timing;
+    timing.name = SubmoduleName(static_cast<Submodule>(k));
+    timing.average_us = static_cast<int>(
+        accumulator.sum_ns / accumulator.num_frames /
+        rtc::kNumNanosecsPerMicrosec);
+    timing.max_us =
+        static_cast<int>(accumulator.max_ns / rtc::kNumNanosecsPerMicrosec);
+    last_window_timings_.push_back(timing);
+
+    const std::string histogram_prefix =
+        std::string("WebRTC.Audio.Apm.") + timing.name;
+    RTC_HISTOGRAM_COUNTS_SPARSE_10000(
+        histogram_prefix + ".AverageProcessingTimeUs", timing.average_us);
+    RTC_HISTOGRAM_COUNTS_SPARSE_10000(
+        histogram_prefix + ".MaxProcessingTimeUs", timing.max_us);
+
+    accumulator = Accumulator();
+  }
+}
+
+const char* SubmoduleTimingStats::SubmoduleName(Submodule submodule) {
+  switch (submodule) {
+    case kEchoCanceller3:
+      return "EchoCanceller3";
+    case kEchoCanceller:
+      return "EchoCanceller";
+    case kEchoControlMobile:
+      return "EchoControlMobile";
+    case kNoiseSuppression:
+      return "NoiseSuppression";
+    case kGainControl:
+      return "GainControl";
+    case kExperimentalAgc:
+      return "ExperimentalAgc";
+    case kBeamformer:
+      return "Beamformer";
+    case kIntelligibilityEnhancer:
+      return "IntelligibilityEnhancer";
+    case kLowCutFilter:
+      return "LowCutFilter";
+    case kVoiceDetection:
+      return "VoiceDetection";
+    case kResidualEchoDetector:
+      return "ResidualEchoDetector";
+    case kTransientSuppressor:
+      return "TransientSuppressor";
+    case kGainController2:
+      return "GainController2";
+    case kLevelController:
+      return "LevelController";
+    case kLevelEstimator:
+      return "LevelEstimator";
+    case kNumSubmodules:
+      break;
+  }
+  RTC_NOTREACHED();
+  return "";
+}
+
+}  // namespace webrtc
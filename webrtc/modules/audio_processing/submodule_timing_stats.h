@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_SUBMODULE_TIMING_STATS_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_SUBMODULE_TIMING_STATS_H_
+
+#include <array>
+#include <vector>
+
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Measures the time spent in the individual capture-side submodules of APM.
+// The time of each submodule is summed per frame, and aggregated over windows
+// of frames. At the end of each window, the per-frame average and maximum of
+// every submodule that ran are logged to UMA histograms and kept until the end
+// of the next window.
+class SubmoduleTimingStats {
+ public:
+  enum Submodule {
+    kEchoCanceller3,
+    kEchoCanceller,
+    kEchoControlMobile,
+    kNoiseSuppression,
+    kGainControl,
+    kExperimentalAgc,
+    kBeamformer,
+    kIntelligibilityEnhancer,
+    kLowCutFilter,
+    kVoiceDetection,
+    kResidualEchoDetector,
+    kTransientSuppressor,
+    kGainController2,
+    kLevelController,
+    kLevelEstimator,
+    kNumSubmodules
+  };
+
+  // Measures the time from construction to destruction and adds it to the
+  // stats of |submodule|. Does nothing if |stats| is null, which is how
+  // callers skip the measurement when timing is disabled.
+  class ScopedTimer {
+   public:
+    ScopedTimer(SubmoduleTimingStats* stats, Submodule submodule);
+    ~ScopedTimer();
+
+   private:
+    SubmoduleTimingStats* const stats_;
+    const Submodule submodule_;
+    const int64_t start_ns_;
+    RTC_DISALLOW_COPY_AND_ASSIGN(ScopedTimer);
+  };
+
+  // Ten seconds of 10 ms frames; the interval of the other APM histograms.
+  static constexpr size_t kDefaultFramesPerWindow = 1000;
+
+  explicit SubmoduleTimingStats(size_t frames_per_window);
+  ~SubmoduleTimingStats();
+
+  void AddDuration(Submodule submodule, int64_t duration_ns);
+
+  // Ends the current frame. Completes the window after every
+  // |frames_per_window| frames.
+  void OnFrameProcessed();
+
+  // Returns the timings of the last completed window, ordered as Submodule.
+  // Empty before the first window has completed.
+  const std::vector<AudioProcessing::AudioProcessingStatistics::SubmoduleTiming>&
+  last_window_timings() const {
+    return last_window_timings_;
+  }
+
+  static const char* SubmoduleName(Submodule submodule);
+
+ private:
+  struct Accumulator {
+    int64_t frame_ns = 0;
+    bool ran_this_frame = false;
+    int64_t sum_ns = 0;
+    int64_t max_ns = 0;
+    size_t num_frames = 0;
+  };
+
+  void CompleteWindow();
+
+  const size_t frames_per_window_;
+  size_t frame_counter_ = 0;
+  std::array<Accumulator, kNumSubmodules> accumulators_;
+  std::vector<AudioProcessing::AudioProcessingStatistics::SubmoduleTiming>
+      last_window_timings_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SubmoduleTimingStats);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_SUBMODULE_TIMING_STATS_H_
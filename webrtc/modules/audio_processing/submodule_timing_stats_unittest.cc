@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/submodule_timing_stats.h"
+
+#include <string>
+
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kNsPerUs = rtc::kNumNanosecsPerMicrosec;
+
+}  // namespace
+
+// Verifies that the durations of a submodule are summed per frame, and that
+// the average only counts the frames in which the submodule ran.
+TEST(SubmoduleTimingStats, AggregatesOverFramesWithActivity) {
+  SubmoduleTimingStats stats(3);
+
+  stats.AddDuration(SubmoduleTimingStats::kNoiseSuppression, 1000 * kNsPerUs);
+  stats.AddDuration(SubmoduleTimingStats::kNoiseSuppression, 500 * kNsPerUs);
+  stats.OnFrameProcessed();
+  stats.AddDuration(SubmoduleTimingStats::kNoiseSuppression, 3000 * kNsPerUs);
+  stats.OnFrameProcessed();
+  EXPECT_TRUE(stats.last_window_timings().empty());
+  stats.AddDuration(SubmoduleTimingStats::kLevelController, 40 * kNsPerUs);
+  stats.OnFrameProcessed();
+
+  const auto& timings = stats.last_window_timings();
+  ASSERT_EQ(2u, timings.size());
+  EXPECT_EQ(std::string("NoiseSuppression"), timings[0].name);
+  EXPECT_EQ(2250, timings[0].average_us);
+  EXPECT_EQ(3000, timings[0].max_us);
+  EXPECT_EQ(std::string("LevelController"), timings[1].name);
+  EXPECT_EQ(40, timings[1].average_us);
+  EXPECT_EQ(40, timings[1].max_us);
+}
+
+// Verifies that each window starts from scratch.
+TEST(SubmoduleTimingStats, WindowsAreIndependent) {
+  SubmoduleTimingStats stats(2);
+  for (int k = 0; k < 2; ++k) {
+    stats.AddDuration(SubmoduleTimingStats::kEchoCanceller3, 700 * kNsPerUs);
+    stats.OnFrameProcessed();
+  }
+  ASSERT_EQ(1u, stats.last_window_timings().size());
+
+  stats.AddDuration(SubmoduleTimingStats::kGainControl, 20 * kNsPerUs);
+  stats.OnFrameProcessed();
+  // The last completed window is kept until the next one completes.
+  ASSERT_EQ(1u, stats.last_window_timings().size());
+  stats.OnFrameProcessed();
+
+  const auto& timings = stats.last_window_timings();
+  ASSERT_EQ(1u, timings.size());
+  EXPECT_EQ(std::string("GainControl"), timings[0].name);
+  EXPECT_EQ(20, timings[0].average_us);
+}
+
+TEST(SubmoduleTimingStats, ScopedTimerAddsDuration) {
+  SubmoduleTimingStats stats(1);
+  {
+    SubmoduleTimingStats::ScopedTimer timer(
+        &stats, SubmoduleTimingStats::kVoiceDetection);
+  }
+  stats.OnFrameProcessed();
+  const auto& timings = stats.last_window_timings();
+  ASSERT_EQ(1u, timings.size());
+  EXPECT_EQ(std::string("VoiceDetection"), timings[0].name);
+  EXPECT_LE(0, timings[0].average_us);
+}
+
+TEST(SubmoduleTimingStats, ScopedTimerWithoutStatsDoesNothing) {
+  SubmoduleTimingStats::ScopedTimer timer(
+      nullptr, SubmoduleTimingStats::kVoiceDetection);
+}
+
+TEST(SubmoduleTimingStats, AllSubmodulesHaveNames) {
+  for (int k = 0; k < SubmoduleTimingStats::kNumSubmodules; ++k) {
+    EXPECT_STRNE("", SubmoduleTimingStats::SubmoduleName(
+                         static_cast<SubmoduleTimingStats::Submodule>(k)));
+  }
+}
+
+}  // namespace webrtc
@@ -13,26 +13,145 @@
 #include <math.h>
 #include <string.h>
 
-#include "webrtc/common_audio/fir_filter.h"
-#include "webrtc/modules/audio_processing/transient/dyadic_decimator.h"
+#include "webrtc/typedefs.h"
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
+namespace {
+
+// Computes |out[i]| = |sum_k coefficients[k] * in_k[i]|, where the even taps
+// read |odd_data| and the odd taps |even_data|, each delayed by k / 2 samples.
+// Returns the number of outputs computed, which is |length| rounded down to a
+// multiple of the vector width. The remaining outputs are left to
+// FilterPhases(). Even and odd taps go to separate accumulators, and two tap
+// pairs are handled per iteration, so that the additions do not all wait on
+// each other.
+#if defined(WEBRTC_HAS_NEON)
+size_t FilterPhases_NEON(const float* coefficients,
+                         size_t coefficients_length,
+                         const float* even_data,
+                         const float* odd_data,
+                         size_t length,
+                         float* out) {
+  const size_t vector_length = length & ~static_cast<size_t>(3);
+  for (size_t i = 0; i < vector_length; i += 4) {
+    float32x4_t acc0 = vdupq_n_f32(0.f);
+    float32x4_t acc1 = vdupq_n_f32(0.f);
+    float32x4_t acc2 = vdupq_n_f32(0.f);
+    float32x4_t acc3 = vdupq_n_f32(0.f);
+    size_t k = 0;
+    for (; k + 4 <= coefficients_length; k += 4) {
+      const float* odd_in = &odd_data[i] - k / 2;
+      const float* even_in = &even_data[i] - k / 2;
+      acc0 = vmlaq_n_f32(acc0, vld1q_f32(odd_in), coefficients[k]);
+      acc1 = vmlaq_n_f32(acc1, vld1q_f32(even_in), coefficients[k + 1]);
+      acc2 = vmlaq_n_f32(acc2, vld1q_f32(odd_in - 1),
+                         coefficients[k + 2]);
+      acc3 = vmlaq_n_f32(acc3, vld1q_f32(even_in - 1),
+                         coefficients[k + 3]);
+    }
+    for (; k < coefficients_length; ++k) {
+      const float* in = (k % 2 == 0 ? odd_data : even_data) - k / 2;
+      acc0 = vmlaq_n_f32(acc0, vld1q_f32(&in[i]), coefficients[k]);
+    }
+    const float32x4_t sum =
+        vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3));
+    vst1q_f32(&out[i], vabsq_f32(sum));
+  }
+  return vector_length;
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+size_t FilterPhases_SSE2(const float* coefficients,
+                         size_t coefficients_length,
+                         const float* even_data,
+                         const float* odd_data,
+                         size_t length,
+                         float* out) {
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const size_t vector_length = length & ~static_cast<size_t>(3);
+  for (size_t i = 0; i < vector_length; i += 4) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    __m128 acc3 = _mm_setzero_ps();
+    size_t k = 0;
+    for (; k + 4 <= coefficients_length; k += 4) {
+      const float* odd_in = &odd_data[i] - k / 2;
+      const float* even_in = &even_data[i] - k / 2;
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(odd_in),
+                                         _mm_set1_ps(coefficients[k])));
+      acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(even_in),
+                                         _mm_set1_ps(coefficients[k + 1])));
+      acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(odd_in - 1),
+                                         _mm_set1_ps(coefficients[k + 2])));
+      acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(even_in - 1),
+                                         _mm_set1_ps(coefficients[k + 3])));
+    }
+    for (; k < coefficients_length; ++k) {
+      const float* in = (k % 2 == 0 ? odd_data : even_data) - k / 2;
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(&in[i]),
+                                         _mm_set1_ps(coefficients[k])));
+    }
+    const __m128 sum =
+        _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+    _mm_storeu_ps(&out[i], _mm_and_ps(sum, abs_mask));
+  }
+  return vector_length;
+}
+#endif
+
+void FilterPhases(const float* coefficients,
+                  size_t coefficients_length,
+                  const float* even_data,
+                  const float* odd_data,
+                  size_t start,
+                  size_t length,
+                  float* out) {
+  for (size_t i = start; i < length; ++i) {
+    float acc = 0.f;
+    for (size_t k = 0; k < coefficients_length; ++k) {
+      const float* in = (k % 2 == 0 ? odd_data : even_data) - k / 2;
+      acc += coefficients[k] * in[i];
+    }
+    out[i] = fabs(acc);
+  }
+}
+
+}  // namespace
 
 WPDNode::WPDNode(size_t length,
                  const float* coefficients,
                  size_t coefficients_length)
-    : // The data buffer has parent data length to be able to contain and filter
-      // it.
-      data_(new float[2 * length + 1]),
+    : data_(new float[length]),
       length_(length),
-      filter_(FIRFilter::Create(coefficients,
-                                coefficients_length,
-                                2 * length + 1)) {
+      coefficients_length_(coefficients_length),
+      coefficients_(new float[coefficients_length]),
+      history_length_((coefficients_length - 1) / 2),
+      even_data_(new float[history_length_ + length]),
+      odd_data_(new float[history_length_ + length]) {
   RTC_DCHECK_GT(length, 0);
   RTC_DCHECK(coefficients);
   RTC_DCHECK_GT(coefficients_length, 0);
-  memset(data_.get(), 0.f, (2 * length + 1) * sizeof(data_[0]));
+  memcpy(coefficients_.get(), coefficients,
+         coefficients_length * sizeof(coefficients_[0]));
+  memset(data_.get(), 0, length * sizeof(data_[0]));
+  memset(even_data_.get(), 0,
+         (history_length_ + length) * sizeof(even_data_[0]));
+  memset(odd_data_.get(), 0,
+         (history_length_ + length) * sizeof(odd_data_[0]));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  use_sse2_ = WebRtc_GetCPUInfo(kSSE2) != 0;
+#endif
 }
 
 WPDNode::~WPDNode() {}
@@ -42,21 +161,37 @@ int WPDNode::Update(const float* parent_data, size_t parent_data_length) {
     return -1;
   }
 
-  // Filter data.
-  filter_->Filter(parent_data, parent_data_length, data_.get());
-
-  // Decimate data.
-  const bool kOddSequence = true;
-  size_t output_samples = DyadicDecimate(
-      data_.get(), parent_data_length, kOddSequence, data_.get(), length_);
-  if (output_samples != length_) {
-    return -1;
+  // Split the parent data by parity, after the history of the previous update.
+  float* even_data = &even_data_[history_length_];
+  float* odd_data = &odd_data_[history_length_];
+  for (size_t i = 0; i < length_; ++i) {
+    even_data[i] = parent_data[2 * i];
+    odd_data[i] = parent_data[2 * i + 1];
   }
 
-  // Get abs to all values.
-  for (size_t i = 0; i < length_; ++i) {
-    data_[i] = fabs(data_[i]);
+  // Filter and decimate. Odd output sample 2 * i + 1 is
+  //   sum_k coefficients_[k] * parent_data[2 * i + 1 - k],
+  // where the even taps pick odd samples and the odd taps even samples. The
+  // even output samples, which the decimation would drop, are not computed.
+  // The absolute values of the outputs are stored.
+  size_t filtered = 0;
+#if defined(WEBRTC_HAS_NEON)
+  filtered = FilterPhases_NEON(coefficients_.get(), coefficients_length_,
+                               even_data, odd_data, length_, data_.get());
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_sse2_) {
+    filtered = FilterPhases_SSE2(coefficients_.get(), coefficients_length_,
+                                 even_data, odd_data, length_, data_.get());
   }
+#endif
+  FilterPhases(coefficients_.get(), coefficients_length_, even_data, odd_data,
+               filtered, length_, data_.get());
+
+  // Keep the last samples of each parity for the next update.
+  memmove(even_data_.get(), &even_data_[length_],
+          history_length_ * sizeof(even_data_[0]));
+  memmove(odd_data_.get(), &odd_data_[length_],
+          history_length_ * sizeof(odd_data_[0]));
 
   return 0;
 }
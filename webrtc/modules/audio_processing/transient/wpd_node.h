@@ -17,9 +17,10 @@
 
 namespace webrtc {
 
-class FIRFilter;
-
 // A single node of a Wavelet Packet Decomposition (WPD) tree.
+// The node filters its parent data and keeps the odd samples of the result.
+// Only those samples are computed: the filter is split in two polyphase
+// components, applied to the odd and even parent samples respectively.
 class WPDNode {
  public:
   // Creates a WPDNode. The data vector will contain zeros. The filter will have
@@ -39,7 +40,17 @@ class WPDNode {
  private:
   std::unique_ptr<float[]> data_;
   size_t length_;
-  std::unique_ptr<FIRFilter> filter_;
+  size_t coefficients_length_;
+  std::unique_ptr<float[]> coefficients_;
+  // Number of previous parent samples of each parity the filter needs.
+  size_t history_length_;
+  // The even and odd parent samples, each preceded by |history_length_|
+  // samples from the previous update.
+  std::unique_ptr<float[]> even_data_;
+  std::unique_ptr<float[]> odd_data_;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  bool use_sse2_;
+#endif
 };
 
 }  // namespace webrtc
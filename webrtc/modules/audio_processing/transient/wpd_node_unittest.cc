@@ -10,8 +10,11 @@
 
 #include "webrtc/modules/audio_processing/transient/wpd_node.h"
 
+#include <math.h>
 #include <string.h>
 
+#include <vector>
+
 #include "webrtc/test/gtest.h"
 
 namespace webrtc {
@@ -54,6 +57,39 @@ TEST(WPDNodeTest, UpdateWithArbitraryDataAndArbitraryFilter) {
   EXPECT_NEAR(0.94f, node.data()[4], kTolerance);
 }
 
+// Verifies that the filter state is kept across updates, for a filter longer
+// than the data and for data lengths with and without a vectorized part.
+TEST(WPDNodeTest, UpdatesAreContinuous) {
+  const size_t kNumUpdates = 4;
+  for (size_t data_length : {5, 16, 23}) {
+    const size_t parent_length = 2 * data_length;
+    std::vector<float> parent(kNumUpdates * parent_length);
+    for (size_t i = 0; i < parent.size(); ++i) {
+      parent[i] = static_cast<float>((i * 7) % 11) - 5.f;
+    }
+    std::vector<float> coefficients(2 * data_length + 3);
+    for (size_t k = 0; k < coefficients.size(); ++k) {
+      coefficients[k] = 0.1f * static_cast<float>((k * 5) % 7) - 0.3f;
+    }
+
+    WPDNode node(data_length, coefficients.data(), coefficients.size());
+    for (size_t n = 0; n < kNumUpdates; ++n) {
+      ASSERT_EQ(0, node.Update(&parent[n * parent_length], parent_length));
+      for (size_t i = 0; i < data_length; ++i) {
+        // Filter the whole signal so far and keep the odd samples.
+        const size_t sample = n * parent_length + 2 * i + 1;
+        float expected = 0.f;
+        for (size_t k = 0; k < coefficients.size() && k <= sample; ++k) {
+          expected += coefficients[k] * parent[sample - k];
+        }
+        EXPECT_NEAR(fabs(expected), node.data()[i], kTolerance)
+            << "Data length " << data_length << ", update " << n
+            << ", sample " << i;
+      }
+    }
+  }
+}
+
 TEST(WPDNodeTest, ExpectedErrorReturnValue) {
   WPDNode node(kDataLength, kCoefficients, kCoefficientsLength);
   EXPECT_EQ(-1, node.Update(kParentData, kParentDataLength - 1));
@@ -117,11 +117,13 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketFeedbackVector(
   bool delayed_feedback = true;
   bool recovered_from_overuse = false;
   BandwidthUsage prev_detector_state = detector_.State();
+  // The whole vector is handled at once, so the clock is read only once.
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   for (const auto& packet_feedback : packet_feedback_vector) {
     if (packet_feedback.send_time_ms < 0)
       continue;
     delayed_feedback = false;
-    IncomingPacketFeedback(packet_feedback);
+    IncomingPacketFeedback(packet_feedback, now_ms);
     if (!in_sparse_update_experiment_)
       overusing |= (detector_.State() == BandwidthUsage::kBwOverusing);
     if (prev_detector_state == BandwidthUsage::kBwUnderusing &&
@@ -165,8 +167,8 @@ DelayBasedBwe::Result DelayBasedBwe::OnLongFeedbackDelay(
 }
 
 void DelayBasedBwe::IncomingPacketFeedback(
-    const PacketFeedback& packet_feedback) {
-  int64_t now_ms = clock_->TimeInMilliseconds();
+    const PacketFeedback& packet_feedback,
+    int64_t now_ms) {
   // Reset if the stream has timed out.
   if (last_seen_packet_ms_ == -1 ||
       now_ms - last_seen_packet_ms_ > kStreamTimeOutMs) {
@@ -59,7 +59,9 @@ class DelayBasedBwe {
   int64_t GetExpectedBwePeriodMs() const;
 
  private:
-  void IncomingPacketFeedback(const PacketFeedback& packet_feedback);
+  // Handles one packet of a feedback vector received at |now_ms|.
+  void IncomingPacketFeedback(const PacketFeedback& packet_feedback,
+                              int64_t now_ms);
   Result OnLongFeedbackDelay(int64_t arrival_time_ms);
   Result MaybeUpdateEstimate(bool overusing,
                              rtc::Optional<uint32_t> acked_bitrate_bps,
@@ -91,6 +91,7 @@ class SendSideCongestionController : public CallStatsObserver,
 
   virtual BitrateController* GetBitrateController() const;
   virtual int64_t GetPacerQueuingDelayMs() const;
+  virtual PacedSender::Stats GetPacerStats() const;
   virtual int64_t GetFirstPacketTimeMs() const;
 
   virtual TransportFeedbackObserver* GetTransportFeedbackObserver();
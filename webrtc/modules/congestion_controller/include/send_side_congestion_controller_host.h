@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_CONGESTION_CONTROLLER_INCLUDE_SEND_SIDE_CONGESTION_CONTROLLER_HOST_H_
+#define WEBRTC_MODULES_CONGESTION_CONTROLLER_INCLUDE_SEND_SIDE_CONGESTION_CONTROLLER_HOST_H_
+
+#include <vector>
+
+#include "webrtc/modules/include/module.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+
+namespace webrtc {
+
+class Clock;
+class ProcessThread;
+class SendSideCongestionController;
+
+// Drives many SendSideCongestionControllers as a single Module, so that a
+// ProcessThread serving thousands of transports wakes up once per tick and
+// polls one module instead of each controller separately. The deadlines of
+// the controllers are kept in one contiguous array, which is all that is
+// touched to find the controllers that are due.
+class SendSideCongestionControllerHost : public Module {
+ public:
+  explicit SendSideCongestionControllerHost(const Clock* clock);
+  ~SendSideCongestionControllerHost() override;
+
+  // Adds |controller|, which will be processed on the next tick. The
+  // controller must not be registered with a ProcessThread itself, and must
+  // outlive its membership in the host.
+  void AddController(SendSideCongestionController* controller);
+  // Must not be called from within a controller's Process().
+  void RemoveController(SendSideCongestionController* controller);
+  size_t num_controllers() const;
+
+  // Implements Module.
+  int64_t TimeUntilNextProcess() override;
+  void Process() override;
+  void ProcessThreadAttached(ProcessThread* process_thread) override;
+
+ private:
+  const Clock* const clock_;
+  rtc::CriticalSection lock_;
+  ProcessThread* process_thread_ GUARDED_BY(lock_);
+  // Parallel arrays, indexed alike. Removal swaps in the last element so
+  // that both stay dense.
+  std::vector<int64_t> next_process_time_ms_ GUARDED_BY(lock_);
+  std::vector<SendSideCongestionController*> controllers_ GUARDED_BY(lock_);
+  // The earliest of |next_process_time_ms_|, or -1 if a controller was added
+  // since the last Process().
+  int64_t earliest_process_time_ms_ GUARDED_BY(lock_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SendSideCongestionControllerHost);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_CONGESTION_CONTROLLER_INCLUDE_SEND_SIDE_CONGESTION_CONTROLLER_HOST_H_
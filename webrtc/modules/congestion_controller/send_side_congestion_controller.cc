@@ -260,6 +260,10 @@ int64_t SendSideCongestionController::GetPacerQueuingDelayMs() const {
   return IsNetworkDown() ? 0 : pacer_->QueueInMs();
 }
 
+PacedSender::Stats SendSideCongestionController::GetPacerStats() const {
+  return pacer_->GetStats();
+}
+
 int64_t SendSideCongestionController::GetFirstPacketTimeMs() const {
   return pacer_->FirstSentPacketTimeMs();
 }
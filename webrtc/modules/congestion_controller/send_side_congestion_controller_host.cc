@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/congestion_controller/include/send_side_congestion_controller_host.h"
+
+#include <algorithm>
+
+#include "webrtc/modules/congestion_controller/include/send_side_congestion_controller.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+// How often to poll while there are no controllers. Adding one wakes up the
+// process thread anyway.
+constexpr int64_t kIdleProcessIntervalMs = 1000;
+}  // namespace
+
+SendSideCongestionControllerHost::SendSideCongestionControllerHost(
+    const Clock* clock)
+    : clock_(clock), process_thread_(nullptr), earliest_process_time_ms_(-1) {}
+
+SendSideCongestionControllerHost::~SendSideCongestionControllerHost() {
+  RTC_DCHECK(controllers_.empty());
+}
+
+void SendSideCongestionControllerHost::AddController(
+    SendSideCongestionController* controller) {
+  RTC_DCHECK(controller);
+  ProcessThread* process_thread;
+  {
+    rtc::CritScope cs(&lock_);
+    RTC_DCHECK(std::find(controllers_.begin(), controllers_.end(),
+                         controller) == controllers_.end());
+    controllers_.push_back(controller);
+    next_process_time_ms_.push_back(-1);
+    earliest_process_time_ms_ = -1;
+    process_thread = process_thread_;
+  }
+  // Woken up without holding |lock_|, since the process thread may be
+  // calling TimeUntilNextProcess() with its own lock held.
+  if (process_thread)
+    process_thread->WakeUp(this);
+}
+
+void SendSideCongestionControllerHost::RemoveController(
+    SendSideCongestionController* controller) {
+  rtc::CritScope cs(&lock_);
+  auto it = std::find(controllers_.begin(), controllers_.end(), controller);
+  RTC_DCHECK(it != controllers_.end());
+  if (it == controllers_.end())
+    return;
+  const size_t index = it - controllers_.begin();
+  controllers_[index] = controllers_.back();
+  controllers_.pop_back();
+  next_process_time_ms_[index] = next_process_time_ms_.back();
+  next_process_time_ms_.pop_back();
+}
+
+size_t SendSideCongestionControllerHost::num_controllers() const {
+  rtc::CritScope cs(&lock_);
+  return controllers_.size();
+}
+
+int64_t SendSideCongestionControllerHost::TimeUntilNextProcess() {
+  rtc::CritScope cs(&lock_);
+  if (earliest_process_time_ms_ == -1)
+    return 0;
+  return std::max<int64_t>(
+      earliest_process_time_ms_ - clock_->TimeInMilliseconds(), 0);
+}
+
+void SendSideCongestionControllerHost::ProcessThreadAttached(
+    ProcessThread* process_thread) {
+  rtc::CritScope cs(&lock_);
+  process_thread_ = process_thread;
+}
+
+void SendSideCongestionControllerHost::Process() {
+  rtc::CritScope cs(&lock_);
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  int64_t earliest_process_time_ms = now_ms + kIdleProcessIntervalMs;
+  for (size_t i = 0; i < controllers_.size(); ++i) {
+    if (next_process_time_ms_[i] <= now_ms) {
+      controllers_[i]->Process();
+      next_process_time_ms_[i] =
+          now_ms + std::max<int64_t>(controllers_[i]->TimeUntilNextProcess(), 0);
+    }
+    earliest_process_time_ms =
+        std::min(earliest_process_time_ms, next_process_time_ms_[i]);
+  }
+  earliest_process_time_ms_ = earliest_process_time_ms;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/congestion_controller/include/send_side_congestion_controller_host.h"
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/logging/rtc_event_log/mock/mock_rtc_event_log.h"
+#include "webrtc/modules/congestion_controller/include/send_side_congestion_controller.h"
+#include "webrtc/modules/pacing/mock/mock_paced_sender.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gmock.h"
+#include "webrtc/test/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace webrtc {
+namespace test {
+namespace {
+
+class MockProcessedController : public SendSideCongestionController {
+ public:
+  MockProcessedController(const Clock* clock,
+                          RtcEventLog* event_log,
+                          PacedSender* pacer)
+      : SendSideCongestionController(clock, nullptr, event_log, pacer) {}
+
+  MOCK_METHOD0(TimeUntilNextProcess, int64_t());
+  MOCK_METHOD0(Process, void());
+};
+
+class SendSideCongestionControllerHostTest : public ::testing::Test {
+ protected:
+  SendSideCongestionControllerHostTest() : clock_(123456), host_(&clock_) {}
+
+  ~SendSideCongestionControllerHostTest() override {
+    for (const auto& controller : controllers_)
+      host_.RemoveController(controller.get());
+  }
+
+  MockProcessedController* AddController() {
+    controllers_.emplace_back(
+        new NiceMock<MockProcessedController>(&clock_, &event_log_, &pacer_));
+    host_.AddController(controllers_.back().get());
+    return controllers_.back().get();
+  }
+
+  SimulatedClock clock_;
+  NiceMock<MockRtcEventLog> event_log_;
+  NiceMock<MockPacedSender> pacer_;
+  SendSideCongestionControllerHost host_;
+  std::vector<std::unique_ptr<MockProcessedController>> controllers_;
+};
+
+}  // namespace
+
+TEST_F(SendSideCongestionControllerHostTest, ProcessesNewControllersAtOnce) {
+  MockProcessedController* first = AddController();
+  MockProcessedController* second = AddController();
+  EXPECT_EQ(2u, host_.num_controllers());
+  EXPECT_EQ(0, host_.TimeUntilNextProcess());
+
+  EXPECT_CALL(*first, Process());
+  EXPECT_CALL(*first, TimeUntilNextProcess()).WillOnce(Return(25));
+  EXPECT_CALL(*second, Process());
+  EXPECT_CALL(*second, TimeUntilNextProcess()).WillOnce(Return(10));
+  host_.Process();
+  EXPECT_EQ(10, host_.TimeUntilNextProcess());
+}
+
+TEST_F(SendSideCongestionControllerHostTest, ProcessesOnlyDueControllers) {
+  MockProcessedController* first = AddController();
+  MockProcessedController* second = AddController();
+  EXPECT_CALL(*first, TimeUntilNextProcess()).WillRepeatedly(Return(25));
+  EXPECT_CALL(*second, TimeUntilNextProcess()).WillRepeatedly(Return(10));
+  EXPECT_CALL(*first, Process()).Times(1);
+  EXPECT_CALL(*second, Process()).Times(1);
+  host_.Process();
+
+  clock_.AdvanceTimeMilliseconds(10);
+  EXPECT_EQ(0, host_.TimeUntilNextProcess());
+  EXPECT_CALL(*first, Process()).Times(0);
+  EXPECT_CALL(*second, Process()).Times(1);
+  host_.Process();
+  EXPECT_EQ(10, host_.TimeUntilNextProcess());
+
+  clock_.AdvanceTimeMilliseconds(5);
+  EXPECT_EQ(5, host_.TimeUntilNextProcess());
+  clock_.AdvanceTimeMilliseconds(10);
+  EXPECT_CALL(*first, Process()).Times(1);
+  EXPECT_CALL(*second, Process()).Times(1);
+  host_.Process();
+}
+
+TEST_F(SendSideCongestionControllerHostTest, RemovedControllerIsNotProcessed) {
+  MockProcessedController* first = AddController();
+  MockProcessedController* second = AddController();
+  MockProcessedController* third = AddController();
+  host_.RemoveController(first);
+  controllers_.erase(controllers_.begin());
+  EXPECT_EQ(2u, host_.num_controllers());
+
+  EXPECT_CALL(*second, Process());
+  EXPECT_CALL(*third, Process());
+  host_.Process();
+}
+
+TEST_F(SendSideCongestionControllerHostTest, IdlesWithoutControllers) {
+  host_.Process();
+  EXPECT_GT(host_.TimeUntilNextProcess(), 0);
+
+  MockProcessedController* controller = AddController();
+  EXPECT_EQ(0, host_.TimeUntilNextProcess());
+  EXPECT_CALL(*controller, Process());
+  host_.Process();
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include <limits>
 #include <memory>
 #include <vector>
@@ -19,6 +21,7 @@
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/safe_conversions.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
@@ -387,5 +390,51 @@ TEST_F(TransportFeedbackAdapterTest, TimestampDeltas) {
                                  adapter_->GetTransportFeedbackVector());
   }
 }
+
+// Feeds one minute of packets at 5000 packets per second through the adapter,
+// with transport feedback every 50 ms reporting 1% of the packets as lost, and
+// prints the time spent per packet.
+TEST_F(TransportFeedbackAdapterTest, DISABLED_Benchmark) {
+  const int kPacketsPerSecond = 5000;
+  const int kFeedbackIntervalMs = 50;
+  const int kPacketsPerFeedback =
+      kPacketsPerSecond * kFeedbackIntervalMs / 1000;
+  const int kNumFeedbacks = 60 * 1000 / kFeedbackIntervalMs;
+  const int kLossInterval = 100;
+  const int64_t kPacketIntervalUs = 1000000 / kPacketsPerSecond;
+  const int64_t kOneWayDelayUs = 50000;
+
+  uint16_t seq_num = 0;
+  int64_t elapsed_ns = 0;
+  for (int i = 0; i < kNumFeedbacks; ++i) {
+    int64_t start_ns = rtc::TimeNanos();
+    const uint16_t base_seq_num = seq_num;
+    const int64_t base_time_us = clock_.TimeInMicroseconds();
+    for (int j = 0; j < kPacketsPerFeedback; ++j) {
+      adapter_->AddPacket(kSsrc, seq_num++, 1200, kPacingInfo0);
+      adapter_->OnSentPacket(seq_num - 1, clock_.TimeInMilliseconds());
+      clock_.AdvanceTimeMicroseconds(kPacketIntervalUs);
+    }
+    elapsed_ns += rtc::TimeNanos() - start_ns;
+
+    rtcp::TransportFeedback feedback;
+    feedback.SetBase(base_seq_num, base_time_us + kOneWayDelayUs);
+    for (int j = 0; j < kPacketsPerFeedback; ++j) {
+      if ((base_seq_num + j) % kLossInterval != kLossInterval - 1) {
+        EXPECT_TRUE(feedback.AddReceivedPacket(
+            static_cast<uint16_t>(base_seq_num + j),
+            base_time_us + kOneWayDelayUs + j * kPacketIntervalUs));
+      }
+    }
+
+    start_ns = rtc::TimeNanos();
+    adapter_->OnTransportFeedback(feedback);
+    adapter_->GetOutstandingBytes();
+    elapsed_ns += rtc::TimeNanos() - start_ns;
+  }
+  printf("%.1f ns per packet.\n",
+         static_cast<double>(elapsed_ns) / (kNumFeedbacks * kPacketsPerFeedback));
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -14,34 +14,16 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "webrtc/rtc_base/checks.h"
-#include "webrtc/rtc_base/optional.h"
 
 namespace webrtc {
 
 namespace {
-rtc::Optional<double> LinearFitSlope(
-    const std::deque<std::pair<double, double>>& points) {
-  RTC_DCHECK(points.size() >= 2);
-  // Compute the "center of mass".
-  double sum_x = 0;
-  double sum_y = 0;
-  for (const auto& point : points) {
-    sum_x += point.first;
-    sum_y += point.second;
-  }
-  double x_avg = sum_x / points.size();
-  double y_avg = sum_y / points.size();
-  // Compute the slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2
-  double numerator = 0;
-  double denominator = 0;
-  for (const auto& point : points) {
-    numerator += (point.first - x_avg) * (point.second - y_avg);
-    denominator += (point.first - x_avg) * (point.first - x_avg);
-  }
-  if (denominator == 0)
-    return rtc::Optional<double>();
-  return rtc::Optional<double>(numerator / denominator);
-}
+// The incrementally updated regression sums are recomputed from scratch this
+// often, to keep rounding errors from accumulating.
+constexpr size_t kMaxUpdatesBetweenRecompute = 1000;
+// The arrival times are whole milliseconds, so the sum of the squared
+// deviations of the arrival times is at least 0.5 unless they are all equal.
+constexpr double kMinSumXx = 0.25;
 }  // namespace
 
 enum { kDeltaCounterMax = 1000 };
@@ -57,6 +39,11 @@ TrendlineEstimator::TrendlineEstimator(size_t window_size,
       accumulated_delay_(0),
       smoothed_delay_(0),
       delay_hist_(),
+      mean_x_(0),
+      mean_y_(0),
+      sum_xx_(0),
+      sum_xy_(0),
+      num_updates_since_recompute_(0),
       trendline_(0) {}
 
 TrendlineEstimator::~TrendlineEstimator() {}
@@ -81,17 +68,64 @@ void TrendlineEstimator::Update(double recv_delta_ms,
                         smoothed_delay_);
 
   // Simple linear regression.
-  delay_hist_.push_back(std::make_pair(
-      static_cast<double>(arrival_time_ms - first_arrival_time_ms),
-      smoothed_delay_));
+  AddPoint(static_cast<double>(arrival_time_ms - first_arrival_time_ms),
+           smoothed_delay_);
   if (delay_hist_.size() > window_size_)
-    delay_hist_.pop_front();
+    RemoveOldestPoint();
+  if (++num_updates_since_recompute_ >= kMaxUpdatesBetweenRecompute)
+    RecomputeSums();
   if (delay_hist_.size() == window_size_) {
     // Only update trendline_ if it is possible to fit a line to the data.
-    trendline_ = LinearFitSlope(delay_hist_).value_or(trendline_);
+    if (sum_xx_ >= kMinSumXx)
+      trendline_ = sum_xy_ / sum_xx_;
   }
 
   BWE_TEST_LOGGING_PLOT(1, "trendline_slope", arrival_time_ms, trendline_);
 }
 
+void TrendlineEstimator::AddPoint(double x, double y) {
+  delay_hist_.emplace_back(x, y);
+  const double dx = x - mean_x_;
+  mean_x_ += dx / delay_hist_.size();
+  mean_y_ += (y - mean_y_) / delay_hist_.size();
+  sum_xx_ += dx * (x - mean_x_);
+  sum_xy_ += dx * (y - mean_y_);
+}
+
+void TrendlineEstimator::RemoveOldestPoint() {
+  RTC_DCHECK(!delay_hist_.empty());
+  const double x = delay_hist_.front().first;
+  const double y = delay_hist_.front().second;
+  delay_hist_.pop_front();
+  if (delay_hist_.empty()) {
+    RecomputeSums();
+    return;
+  }
+  const double dx = x - mean_x_;
+  mean_x_ -= dx / delay_hist_.size();
+  mean_y_ -= (y - mean_y_) / delay_hist_.size();
+  sum_xx_ -= dx * (x - mean_x_);
+  sum_xy_ -= dx * (y - mean_y_);
+}
+
+void TrendlineEstimator::RecomputeSums() {
+  num_updates_since_recompute_ = 0;
+  mean_x_ = 0;
+  mean_y_ = 0;
+  sum_xx_ = 0;
+  sum_xy_ = 0;
+  if (delay_hist_.empty())
+    return;
+  for (const auto& point : delay_hist_) {
+    mean_x_ += point.first;
+    mean_y_ += point.second;
+  }
+  mean_x_ /= delay_hist_.size();
+  mean_y_ /= delay_hist_.size();
+  for (const auto& point : delay_hist_) {
+    sum_xx_ += (point.first - mean_x_) * (point.first - mean_x_);
+    sum_xy_ += (point.first - mean_x_) * (point.second - mean_y_);
+  }
+}
+
 }  // namespace webrtc
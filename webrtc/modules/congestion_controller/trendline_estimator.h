@@ -49,6 +49,13 @@ class TrendlineEstimator {
   unsigned int num_of_deltas() const { return num_of_deltas_; }
 
  private:
+  // Add a point to, or remove the oldest point from, |delay_hist_| and update
+  // the regression sums in constant time.
+  void AddPoint(double x, double y);
+  void RemoveOldestPoint();
+  // Recomputes the regression sums from |delay_hist_|.
+  void RecomputeSums();
+
   // Parameters.
   const size_t window_size_;
   const double smoothing_coef_;
@@ -62,6 +69,15 @@ class TrendlineEstimator {
   double smoothed_delay_;
   // Linear least squares regression.
   std::deque<std::pair<double, double>> delay_hist_;
+  // Means of the points in |delay_hist_|, and the sums of the squared x and
+  // the crossed deviations from them. The slope of the fitted line is
+  // |sum_xy_| / |sum_xx_|.
+  double mean_x_;
+  double mean_y_;
+  double sum_xx_;
+  double sum_xy_;
+  // Number of points added since the sums were last recomputed.
+  size_t num_updates_since_recompute_;
   double trendline_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(TrendlineEstimator);
@@ -9,6 +9,10 @@
  */
 
 #include "webrtc/modules/congestion_controller/trendline_estimator.h"
+
+#include <deque>
+#include <utility>
+
 #include "webrtc/rtc_base/random.h"
 #include "webrtc/test/gtest.h"
 
@@ -70,4 +74,47 @@ TEST(TrendlineEstimator, JitteryLineSlopeZero) {
   TestEstimator(0, kAvgTimeBetweenPackets / 3.0, 0.02);
 }
 
+// The regression is updated incrementally, so check that it still matches a
+// least squares fit of the window after many updates.
+TEST(TrendlineEstimator, MatchesExactFitOverLongStream) {
+  TrendlineEstimator estimator(kWindowSize, kSmoothing, kGain);
+  Random random(0x1234567);
+  const size_t kNumPackets = 10000;
+  const int64_t kStartTime = 1000000000;
+  std::deque<std::pair<double, double>> points;
+  int64_t recv_time = kStartTime;
+  double accumulated_delay = 0;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    // Alternate between an increasing and a decreasing delay.
+    const double send_delta = kAvgTimeBetweenPackets;
+    const double recv_delta = static_cast<double>(
+        (i / 100) % 2 ? random.Rand(10, 20) : random.Rand(5, 15));
+    recv_time += static_cast<int64_t>(recv_delta);
+    accumulated_delay += recv_delta - send_delta;
+    estimator.Update(recv_delta, send_delta, recv_time);
+
+    points.emplace_back(static_cast<double>(recv_time - kStartTime),
+                        accumulated_delay);
+    if (points.size() > kWindowSize)
+      points.pop_front();
+    if (points.size() < kWindowSize)
+      continue;
+    double sum_x = 0;
+    double sum_y = 0;
+    for (const auto& point : points) {
+      sum_x += point.first;
+      sum_y += point.second;
+    }
+    const double mean_x = sum_x / points.size();
+    const double mean_y = sum_y / points.size();
+    double numerator = 0;
+    double denominator = 0;
+    for (const auto& point : points) {
+      numerator += (point.first - mean_x) * (point.second - mean_y);
+      denominator += (point.first - mean_x) * (point.first - mean_x);
+    }
+    EXPECT_NEAR(numerator / denominator, estimator.trendline_slope(), 1e-9);
+  }
+}
+
 }  // namespace webrtc
@@ -14,6 +14,11 @@
 
 #include <utility>
 
+#include "webrtc/typedefs.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 #include "webrtc/modules/desktop_capture/desktop_capturer.h"
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
 #include "webrtc/modules/desktop_capture/mouse_cursor.h"
@@ -21,37 +26,114 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 
 namespace {
 
+// Blends |width| pixels of a pre-multiplied source row into an opaque
+// destination row.
+void AlphaBlendRow_C(uint8_t* dest, const uint8_t* src, int width) {
+  for (int x = 0; x < width; ++x) {
+    uint32_t base_alpha = 255 - src[x * DesktopFrame::kBytesPerPixel + 3];
+    if (base_alpha == 255) {
+      continue;
+    } else if (base_alpha == 0) {
+      memcpy(dest + x * DesktopFrame::kBytesPerPixel,
+             src + x * DesktopFrame::kBytesPerPixel,
+             DesktopFrame::kBytesPerPixel);
+    } else {
+      dest[x * DesktopFrame::kBytesPerPixel] =
+          dest[x * DesktopFrame::kBytesPerPixel] * base_alpha / 255 +
+          src[x * DesktopFrame::kBytesPerPixel];
+      dest[x * DesktopFrame::kBytesPerPixel + 1] =
+          dest[x * DesktopFrame::kBytesPerPixel + 1] * base_alpha / 255 +
+          src[x * DesktopFrame::kBytesPerPixel + 1];
+      dest[x * DesktopFrame::kBytesPerPixel + 2] =
+          dest[x * DesktopFrame::kBytesPerPixel + 2] * base_alpha / 255 +
+          src[x * DesktopFrame::kBytesPerPixel + 2];
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Divides each 16-bit lane, which must not exceed 255 * 255, by 255 rounding
+// down, i.e. exactly as the integer division in AlphaBlendRow_C.
+__m128i DivideBy255(__m128i v) {
+  const __m128i one = _mm_set1_epi16(1);
+  return _mm_srli_epi16(
+      _mm_add_epi16(_mm_add_epi16(v, one), _mm_srli_epi16(v, 8)), 8);
+}
+
+// SSE2 version of AlphaBlendRow_C, producing identical output. Four pixels are
+// blended at a time and the remaining ones by AlphaBlendRow_C.
+void AlphaBlendRow_SSE2(uint8_t* dest, const uint8_t* src, int width) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i opaque = _mm_set1_epi32(255);
+  const __m128i alpha_mask = _mm_slli_epi32(opaque, 24);
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    const int offset = x * DesktopFrame::kBytesPerPixel;
+    const __m128i d =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + offset));
+    const __m128i s =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+
+    // Spread 255 - alpha of each source pixel over the 16-bit lanes of its
+    // four channels.
+    const __m128i alpha = _mm_srli_epi32(s, 24);
+    __m128i base_alpha = _mm_sub_epi32(opaque, alpha);
+    base_alpha = _mm_or_si128(base_alpha, _mm_slli_epi32(base_alpha, 16));
+    const __m128i base_alpha_lo = _mm_unpacklo_epi32(base_alpha, base_alpha);
+    const __m128i base_alpha_hi = _mm_unpackhi_epi32(base_alpha, base_alpha);
+
+    const __m128i scaled_lo = DivideBy255(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), base_alpha_lo));
+    const __m128i scaled_hi = DivideBy255(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), base_alpha_hi));
+    __m128i blended = _mm_add_epi8(_mm_packus_epi16(scaled_lo, scaled_hi), s);
+
+    // The destination alpha is kept, unless the source pixel is opaque and
+    // copied as a whole.
+    const __m128i source_opaque = _mm_cmpeq_epi32(alpha, opaque);
+    const __m128i dest_alpha =
+        _mm_or_si128(_mm_and_si128(d, alpha_mask),
+                     _mm_and_si128(source_opaque, alpha_mask));
+    blended = _mm_or_si128(_mm_andnot_si128(alpha_mask, blended), dest_alpha);
+
+    // Fully transparent source pixels leave the destination untouched.
+    const __m128i source_transparent = _mm_cmpeq_epi32(alpha, zero);
+    blended = _mm_or_si128(_mm_and_si128(source_transparent, d),
+                           _mm_andnot_si128(source_transparent, blended));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset), blended);
+  }
+  AlphaBlendRow_C(dest + x * DesktopFrame::kBytesPerPixel,
+                  src + x * DesktopFrame::kBytesPerPixel, width - x);
+}
+#endif
+
+typedef void (*AlphaBlendRowProc)(uint8_t*, const uint8_t*, int);
+
+AlphaBlendRowProc GetAlphaBlendRowProc() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static const AlphaBlendRowProc blend_proc = WebRtc_GetCPUInfo(kSSE2) != 0
+                                                  ? &AlphaBlendRow_SSE2
+                                                  : &AlphaBlendRow_C;
+  return blend_proc;
+#else
+  return &AlphaBlendRow_C;
+#endif
+}
+
 // Helper function that blends one image into another. Source image must be
 // pre-multiplied with the alpha channel. Destination is assumed to be opaque.
 void AlphaBlend(uint8_t* dest, int dest_stride,
                 const uint8_t* src, int src_stride,
                 const DesktopSize& size) {
+  const AlphaBlendRowProc blend_proc = GetAlphaBlendRowProc();
   for (int y = 0; y < size.height(); ++y) {
-    for (int x = 0; x < size.width(); ++x) {
-      uint32_t base_alpha = 255 - src[x * DesktopFrame::kBytesPerPixel + 3];
-      if (base_alpha == 255) {
-        continue;
-      } else if (base_alpha == 0) {
-        memcpy(dest + x * DesktopFrame::kBytesPerPixel,
-               src + x * DesktopFrame::kBytesPerPixel,
-               DesktopFrame::kBytesPerPixel);
-      } else {
-        dest[x * DesktopFrame::kBytesPerPixel] =
-            dest[x * DesktopFrame::kBytesPerPixel] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel];
-        dest[x * DesktopFrame::kBytesPerPixel + 1] =
-            dest[x * DesktopFrame::kBytesPerPixel + 1] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 1];
-        dest[x * DesktopFrame::kBytesPerPixel + 2] =
-            dest[x * DesktopFrame::kBytesPerPixel + 2] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 2];
-      }
-    }
+    blend_proc(dest, src, size.width());
     src += src_stride;
     dest += dest_stride;
   }
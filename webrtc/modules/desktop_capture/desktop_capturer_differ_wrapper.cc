@@ -14,16 +14,35 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "webrtc/modules/desktop_capture/desktop_geometry.h"
 #include "webrtc/modules/desktop_capture/differ_block.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 
 namespace webrtc {
 
 namespace {
 
+// Updated areas of at least this many pixels are compared in bands on several
+// threads. Below it, starting the threads costs more than they save.
+const int kMinBandComparePixels = 1920 * 1080;
+
+// The largest number of threads, including the capture thread, used to compare
+// one area. Comparing is mostly bound by memory bandwidth, so more threads than
+// this don't help.
+const int kMaxCompareThreads = 4;
+
+int NumCompareThreads() {
+  return std::min(kMaxCompareThreads,
+                  static_cast<int>(CpuInfo::DetectNumberOfCores()));
+}
+
 // Returns true if (0, 0) - (|width|, |height|) vector in |old_buffer| and
 // |new_buffer| are equal. |width| should be less than 32
 // (defined by kBlockSize), otherwise BlockDifference() should be used.
@@ -143,6 +162,132 @@ void CompareFrames(const DesktopFrame& old_frame,
 
 }  // namespace
 
+// Compares an area in horizontal bands of whole block-rows, the first one on
+// the calling thread and each of the others on a worker thread. Since bands
+// start at block-row boundaries, the blocks compared, and so the resulting
+// region, are the same as those of a single CompareFrames() call.
+class DesktopCapturerDifferWrapper::BandComparer {
+ public:
+  // Creates |num_threads| - 1 worker threads.
+  explicit BandComparer(int num_threads);
+  ~BandComparer();
+
+  // Same as CompareFrames().
+  void Compare(const DesktopFrame& old_frame,
+               const DesktopFrame& new_frame,
+               DesktopRect rect,
+               DesktopRegion* const output);
+
+ private:
+  struct Worker {
+    explicit Worker(BandComparer* comparer);
+
+    BandComparer* const comparer;
+    rtc::PlatformThread thread;
+    // Signaled when |rect| is ready to be compared, or when stopping.
+    rtc::Event start;
+    // Signaled when |region| holds the result of comparing |rect|.
+    rtc::Event done;
+    DesktopRect rect;
+    DesktopRegion region;
+  };
+
+  static void Run(void* obj);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // The frames being compared. Only accessed by the workers between their
+  // |start| and |done| events.
+  const DesktopFrame* old_frame_ = nullptr;
+  const DesktopFrame* new_frame_ = nullptr;
+  bool stopping_ = false;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BandComparer);
+};
+
+DesktopCapturerDifferWrapper::BandComparer::Worker::Worker(
+    BandComparer* comparer)
+    : comparer(comparer),
+      thread(&BandComparer::Run, this, "DifferBandThread"),
+      start(false, false),
+      done(false, false) {}
+
+DesktopCapturerDifferWrapper::BandComparer::BandComparer(int num_threads) {
+  RTC_DCHECK_GT(num_threads, 1);
+  for (int i = 1; i < num_threads; i++) {
+    workers_.emplace_back(new Worker(this));
+    workers_.back()->thread.Start();
+  }
+}
+
+DesktopCapturerDifferWrapper::BandComparer::~BandComparer() {
+  stopping_ = true;
+  for (const auto& worker : workers_) {
+    worker->start.Set();
+    worker->thread.Stop();
+  }
+}
+
+void DesktopCapturerDifferWrapper::BandComparer::Compare(
+    const DesktopFrame& old_frame,
+    const DesktopFrame& new_frame,
+    DesktopRect rect,
+    DesktopRegion* const output) {
+  rect.IntersectWith(DesktopRect::MakeSize(old_frame.size()));
+  if (rect.is_empty()) {
+    return;
+  }
+
+  const int y_block_count = (rect.height() + kBlockSize - 1) / kBlockSize;
+  const int band_count =
+      std::min(static_cast<int>(workers_.size()) + 1, y_block_count);
+  old_frame_ = &old_frame;
+  new_frame_ = &new_frame;
+
+  DesktopRect first_band;
+  int top = rect.top();
+  for (int i = 0; i < band_count; i++) {
+    // Spreads the block-rows which don't divide evenly over the first bands.
+    const int band_y_blocks =
+        y_block_count / band_count + (i < y_block_count % band_count ? 1 : 0);
+    const int bottom = std::min(top + band_y_blocks * kBlockSize, rect.bottom());
+    const DesktopRect band =
+        DesktopRect::MakeLTRB(rect.left(), top, rect.right(), bottom);
+    if (i == 0) {
+      first_band = band;
+    } else {
+      Worker* worker = workers_[i - 1].get();
+      worker->rect = band;
+      worker->start.Set();
+    }
+    top = bottom;
+  }
+  RTC_DCHECK_EQ(top, rect.bottom());
+
+  CompareFrames(old_frame, new_frame, first_band, output);
+  for (int i = 1; i < band_count; i++) {
+    Worker* worker = workers_[i - 1].get();
+    worker->done.Wait(rtc::Event::kForever);
+    output->AddRegion(worker->region);
+  }
+  old_frame_ = nullptr;
+  new_frame_ = nullptr;
+}
+
+// static
+void DesktopCapturerDifferWrapper::BandComparer::Run(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  while (true) {
+    worker->start.Wait(rtc::Event::kForever);
+    if (worker->comparer->stopping_) {
+      return;
+    }
+    worker->region.Clear();
+    CompareFrames(*worker->comparer->old_frame_, *worker->comparer->new_frame_,
+                  worker->rect, &worker->region);
+    worker->done.Set();
+  }
+}
+
 DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
     std::unique_ptr<DesktopCapturer> base_capturer)
     : base_capturer_(std::move(base_capturer)) {
@@ -203,8 +348,18 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
     DesktopRegion hints;
     hints.Swap(frame->mutable_updated_region());
     for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
-      CompareFrames(*last_frame_, *frame, it.rect(),
-                    frame->mutable_updated_region());
+      const DesktopRect& rect = it.rect();
+      if (rect.width() * rect.height() >= kMinBandComparePixels &&
+          NumCompareThreads() > 1) {
+        if (!band_comparer_) {
+          band_comparer_.reset(new BandComparer(NumCompareThreads()));
+        }
+        band_comparer_->Compare(*last_frame_, *frame, rect,
+                                frame->mutable_updated_region());
+      } else {
+        CompareFrames(*last_frame_, *frame, rect,
+                      frame->mutable_updated_region());
+      }
     }
   } else {
     frame->mutable_updated_region()->SetRect(
@@ -26,6 +26,9 @@ namespace webrtc {
 //
 // This class marks entire frame as updated if the frame size or frame stride
 // has been changed.
+//
+// Large updated areas are compared in horizontal bands on a few worker
+// threads, which are created the first time such an area is compared.
 class DesktopCapturerDifferWrapper : public DesktopCapturer,
                                      public DesktopCapturer::Callback {
  public:
@@ -47,6 +50,8 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   bool FocusOnSelectedSource() override;
 
  private:
+  class BandComparer;
+
   // DesktopCapturer::Callback interface.
   void OnCaptureResult(Result result,
                        std::unique_ptr<DesktopFrame> frame) override;
@@ -54,6 +59,7 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   const std::unique_ptr<DesktopCapturer> base_capturer_;
   DesktopCapturer::Callback* callback_;
   std::unique_ptr<SharedDesktopFrame> last_frame_;
+  std::unique_ptr<BandComparer> band_comparer_;
 };
 
 }  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/desktop_capture/desktop_capturer_differ_wrapper.h"
 
+#include <string.h>
+
 #include <initializer_list>
 #include <memory>
 #include <utility>
@@ -20,10 +22,12 @@
 #include "webrtc/modules/desktop_capture/differ_block.h"
 #include "webrtc/modules/desktop_capture/fake_desktop_capturer.h"
 #include "webrtc/modules/desktop_capture/mock_desktop_capturer_callback.h"
+#include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
 #include "webrtc/rtc_base/random.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -222,6 +226,95 @@ void ExecuteDifferWrapperTest(bool with_hints,
   }
 }
 
+// Captures frames of sizes large enough to be compared in bands, with updated
+// areas of whole blocks, so the updated_region() is known exactly.
+void ExecuteLargeFramesTest() {
+  BlackWhiteDesktopFramePainter frame_painter;
+  PainterDesktopFrameGenerator frame_generator;
+  frame_generator.set_desktop_frame_painter(&frame_painter);
+  std::unique_ptr<FakeDesktopCapturer> fake(new FakeDesktopCapturer());
+  fake->set_frame_generator(&frame_generator);
+  DesktopCapturerDifferWrapper capturer(std::move(fake));
+  MockDesktopCapturerCallback callback;
+  capturer.Start(&callback);
+
+  Random random(rtc::TimeMillis());
+  for (const DesktopSize& size : {DesktopSize(1920, 1080),
+                                  DesktopSize(3840, 2160),
+                                  DesktopSize(5120, 2880)}) {
+    frame_generator.size()->set(size.width(), size.height());
+    const int x_block_count = (size.width() + kBlockSize - 1) / kBlockSize;
+    const int y_block_count = (size.height() + kBlockSize - 1) / kBlockSize;
+    for (int i = 0; i < 20; i++) {
+      ExecuteCapturer(&capturer, &callback);
+      std::vector<DesktopRect> updated_region;
+      for (int j = random.Rand(10); j >= 0; j--) {
+        const int left = random.Rand(0, x_block_count - 1);
+        const int top = random.Rand(0, y_block_count - 1);
+        const int right = random.Rand(left + 1, x_block_count);
+        const int bottom = random.Rand(top + 1, y_block_count);
+        updated_region.push_back(DesktopRect::MakeLTRB(
+            left * kBlockSize, top * kBlockSize,
+            std::min(right * kBlockSize, size.width()),
+            std::min(bottom * kBlockSize, size.height())));
+      }
+      ExecuteDifferWrapperCase(&frame_painter, &capturer, &callback,
+                               updated_region, true, true);
+    }
+  }
+}
+
+// Alternately returns one of two frames with the same content, both marked as
+// entirely updated, so that capturing only costs the comparison.
+class SameContentFrameGenerator : public DesktopFrameGenerator {
+ public:
+  explicit SameContentFrameGenerator(const DesktopSize& size) {
+    for (std::unique_ptr<SharedDesktopFrame>& frame : frames_) {
+      frame = SharedDesktopFrame::Wrap(
+          std::unique_ptr<DesktopFrame>(new BasicDesktopFrame(size)));
+      memset(frame->data(), 0, frame->stride() * size.height());
+    }
+  }
+
+  std::unique_ptr<DesktopFrame> GetNextFrame(
+      SharedMemoryFactory* factory) override {
+    next_frame_ = 1 - next_frame_;
+    std::unique_ptr<DesktopFrame> frame = frames_[next_frame_]->Share();
+    frame->mutable_updated_region()->SetRect(
+        DesktopRect::MakeSize(frame->size()));
+    return frame;
+  }
+
+ private:
+  std::unique_ptr<SharedDesktopFrame> frames_[2];
+  int next_frame_ = 0;
+};
+
+void MeasureCompareTime(const DesktopSize& size, const std::string& trace) {
+  const int kFrames = 100;
+  SameContentFrameGenerator frame_generator(size);
+  std::unique_ptr<FakeDesktopCapturer> fake(new FakeDesktopCapturer());
+  fake->set_frame_generator(&frame_generator);
+  DesktopCapturerDifferWrapper capturer(std::move(fake));
+  MockDesktopCapturerCallback callback;
+  capturer.Start(&callback);
+  EXPECT_CALL(callback,
+              OnCaptureResultPtr(DesktopCapturer::Result::SUCCESS, testing::_))
+      .Times(kFrames + 1);
+
+  // The first frame is not compared.
+  capturer.CaptureFrame();
+  int64_t started = rtc::TimeNanos();
+  for (int i = 0; i < kFrames; i++) {
+    capturer.CaptureFrame();
+  }
+  int64_t elapsed = rtc::TimeNanos() - started;
+  test::PrintResult("desktop_capturer_differ_wrapper_compare", "", trace,
+                    static_cast<size_t>(elapsed / kFrames /
+                                        rtc::kNumNanosecsPerMicrosec),
+                    "us", false);
+}
+
 }  // namespace
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithoutHints) {
@@ -244,6 +337,10 @@ TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedAndRandomHints) {
   ExecuteDifferWrapperTest(true, true, true, true);
 }
 
+TEST(DesktopCapturerDifferWrapperTest, CaptureLargeFrames) {
+  ExecuteLargeFramesTest();
+}
+
 // When hints are provided, DesktopCapturerDifferWrapper has a slightly better
 // performance in current configuration, but not so significant. Following is
 // one run result.
@@ -288,4 +385,12 @@ TEST(DesktopCapturerDifferWrapperTest,
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
+// Measures the time to compare two entirely updated frames with the same
+// content, which is the worst case since no block can be skipped early.
+TEST(DesktopCapturerDifferWrapperTest, DISABLED_CompareLargeFramesPerf) {
+  MeasureCompareTime(DesktopSize(1920, 1080), "1920x1080");
+  MeasureCompareTime(DesktopSize(3840, 2160), "3840x2160");
+  MeasureCompareTime(DesktopSize(5120, 2880), "5120x2880");
+}
+
 }  // namespace webrtc
@@ -13,6 +13,8 @@
 #include <string.h>
 
 #include "webrtc/typedefs.h"
+#include "webrtc/modules/desktop_capture/differ_vector_avx2.h"
+#include "webrtc/modules/desktop_capture/differ_vector_neon.h"
 #include "webrtc/modules/desktop_capture/differ_vector_sse2.h"
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
@@ -24,38 +26,57 @@ bool VectorDifference_C(const uint8_t* image1, const uint8_t* image2) {
   return memcmp(image1, image2, kBlockSize * kBytesPerPixel) != 0;
 }
 
-}  // namespace
-
-bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
-  static bool (*diff_proc)(const uint8_t*, const uint8_t*) = nullptr;
+typedef bool (*VectorDifferenceProc)(const uint8_t*, const uint8_t*);
 
-  if (!diff_proc) {
-#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
-    // For ARM and MIPS processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
-    diff_proc = &VectorDifference_C;
+VectorDifferenceProc SelectVectorDifferenceProc() {
+#if defined(WEBRTC_HAS_NEON)
+  if (kBlockSize == 32) {
+    return &VectorDifference_NEON_W32;
+  } else if (kBlockSize == 16) {
+    return &VectorDifference_NEON_W16;
+  }
+  return &VectorDifference_C;
+#elif defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
+  // For ARM processors without NEON, and MIPS processors, always use C
+  // version.
+  return &VectorDifference_C;
 #else
-    bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
-      diff_proc = &VectorDifference_SSE2_W32;
-    } else if (have_sse2 && kBlockSize == 16) {
-      diff_proc = &VectorDifference_SSE2_W16;
-    } else {
-      diff_proc = &VectorDifference_C;
-    }
-#endif
+  // For x86 processors, prefer AVX2 and then SSE2 if they are supported.
+  bool have_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+  bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  if (have_avx2 && kBlockSize == 32) {
+    return &VectorDifference_AVX2_W32;
+  } else if (have_avx2 && kBlockSize == 16) {
+    return &VectorDifference_AVX2_W16;
+  } else if (have_sse2 && kBlockSize == 32) {
+    return &VectorDifference_SSE2_W32;
+  } else if (have_sse2 && kBlockSize == 16) {
+    return &VectorDifference_SSE2_W16;
   }
+  return &VectorDifference_C;
+#endif
+}
+
+// Frames may be compared on several threads at once, so the proc is selected
+// once in a thread-safe static initializer.
+VectorDifferenceProc GetVectorDifferenceProc() {
+  static const VectorDifferenceProc diff_proc = SelectVectorDifferenceProc();
+  return diff_proc;
+}
 
-  return diff_proc(image1, image2);
+}  // namespace
+
+bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
+  return GetVectorDifferenceProc()(image1, image2);
 }
 
 bool BlockDifference(const uint8_t* image1,
                      const uint8_t* image2,
                      int height,
                      int stride) {
+  const VectorDifferenceProc diff_proc = GetVectorDifferenceProc();
   for (int i = 0; i < height; i++) {
-    if (VectorDifference(image1, image2)) {
+    if (diff_proc(image1, image2)) {
       return true;
     }
     image1 += stride;
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/differ_vector_avx2.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+// Unlike the SSE2 versions, these only need to know whether any byte differs,
+// so they OR together the XOR of the inputs instead of summing differences.
+extern bool VectorDifference_AVX2_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+  const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+  __m256i acc =
+      _mm256_xor_si256(_mm256_loadu_si256(i1), _mm256_loadu_si256(i2));
+  acc = _mm256_or_si256(acc, _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                              _mm256_loadu_si256(i2 + 1)));
+  return _mm256_testz_si256(acc, acc) == 0;
+}
+
+extern bool VectorDifference_AVX2_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+  const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+  __m256i acc =
+      _mm256_xor_si256(_mm256_loadu_si256(i1), _mm256_loadu_si256(i2));
+  acc = _mm256_or_si256(acc, _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                              _mm256_loadu_si256(i2 + 1)));
+  acc = _mm256_or_si256(acc, _mm256_xor_si256(_mm256_loadu_si256(i1 + 2),
+                                              _mm256_loadu_si256(i2 + 2)));
+  acc = _mm256_or_si256(acc, _mm256_xor_si256(_mm256_loadu_si256(i1 + 3),
+                                              _mm256_loadu_si256(i2 + 3)));
+  return _mm256_testz_si256(acc, acc) == 0;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/differ_vector_neon.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns whether any of the |length| bytes, a multiple of 16, differ.
+inline bool VectorDifference_NEON(const uint8_t* image1,
+                                  const uint8_t* image2,
+                                  int length) {
+  uint8x16_t acc = veorq_u8(vld1q_u8(image1), vld1q_u8(image2));
+  for (int i = 16; i < length; i += 16) {
+    acc = vorrq_u8(acc, veorq_u8(vld1q_u8(image1 + i), vld1q_u8(image2 + i)));
+  }
+  uint64x2_t acc64 = vreinterpretq_u64_u8(acc);
+  return (vgetq_lane_u64(acc64, 0) | vgetq_lane_u64(acc64, 1)) != 0;
+}
+
+}  // namespace
+
+extern bool VectorDifference_NEON_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  return VectorDifference_NEON(image1, image2, 16 * 4);
+}
+
+extern bool VectorDifference_NEON_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  return VectorDifference_NEON(image1, image2, 32 * 4);
+}
+
+}  // namespace webrtc
@@ -37,7 +37,8 @@ namespace {
 // A class to perform video frame capturing for Linux.
 //
 // If XDamage is used, this class sets DesktopFrame::updated_region() according
-// to the areas reported by XDamage. Otherwise this class does not detect
+// to the areas reported by XDamage, widened to whole rows if the frames wrap
+// X shared memory segments. Otherwise this class does not detect
 // DesktopFrame::updated_region(), the field is always set to the entire frame
 // rectangle. ScreenCapturerDifferWrapper should be used if that functionality
 // is necessary.
@@ -245,10 +246,14 @@ void ScreenCapturerLinux::CaptureFrame() {
   // If the current frame is from an older generation then allocate a new one.
   // Note that we can't reallocate other buffers at this point, since the caller
   // may still be reading from them.
+  // Frames wrap X shared memory segments when possible, so the X server writes
+  // the pixels right into them.
   if (!queue_.current_frame()) {
-    queue_.ReplaceCurrentFrame(
-        SharedDesktopFrame::Wrap(std::unique_ptr<DesktopFrame>(
-            new BasicDesktopFrame(x_server_pixel_buffer_.window_size()))));
+    std::unique_ptr<DesktopFrame> frame =
+        x_server_pixel_buffer_.CreateSharedMemoryFrame();
+    if (!frame)
+      frame.reset(new BasicDesktopFrame(x_server_pixel_buffer_.window_size()));
+    queue_.ReplaceCurrentFrame(SharedDesktopFrame::Wrap(std::move(frame)));
   }
 
   std::unique_ptr<DesktopFrame> result = CaptureScreen();
@@ -307,7 +312,12 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
 
   DesktopRegion* updated_region = frame->mutable_updated_region();
 
-  x_server_pixel_buffer_.Synchronize();
+  // A shared memory frame is captured to directly, so there's no need to
+  // fetch the whole screen first.
+  bool is_shared_memory_frame =
+      x_server_pixel_buffer_.IsSharedMemoryFrame(*frame);
+  if (!is_shared_memory_frame)
+    x_server_pixel_buffer_.Synchronize();
   if (use_damage_ && queue_.previous_frame()) {
     // Atomically fetch and clear the damage region.
     XDamageSubtract(display(), damage_handle_, None, damage_region_);
@@ -331,6 +341,18 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
     updated_region->IntersectWith(
         DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
 
+    // Whole rows of a shared memory frame are captured, so report them as
+    // updated, which also makes SynchronizeFrame() copy them to the next frame.
+    if (is_shared_memory_frame) {
+      DesktopRegion updated_rows;
+      for (DesktopRegion::Iterator it(*updated_region);
+           !it.IsAtEnd(); it.Advance()) {
+        updated_rows.AddRect(DesktopRect::MakeLTRB(
+            0, it.rect().top(), frame->size().width(), it.rect().bottom()));
+      }
+      updated_region->Swap(&updated_rows);
+    }
+
     for (DesktopRegion::Iterator it(*updated_region);
          !it.IsAtEnd(); it.Advance()) {
       if (!x_server_pixel_buffer_.CaptureRect(it.rect(), frame.get()))
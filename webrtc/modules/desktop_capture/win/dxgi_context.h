@@ -22,6 +22,9 @@ struct DxgiOutputContext final {
   // The updated region DxgiOutputDuplicator::DetectUpdatedRegion() output
   // during last Duplicate() function call. It's always relative to the (0, 0).
   DesktopRegion updated_region;
+
+  // Copied from DxgiFrameContext::pipelined.
+  bool pipelined = false;
 };
 
 // A DxgiAdapterContext stores the status of a single DxgiFrame of
@@ -52,6 +55,11 @@ struct DxgiFrameContext final {
   // each DxgiDuplicatorController::Initialize().
   int controller_id = 0;
 
+  // Whether DxgiOutputDuplicator may export the frame staged during the last
+  // Duplicate() function call instead of waiting for the GPU to copy the new
+  // one, i.e. trade one capture of latency for less time spent blocked.
+  bool pipelined = false;
+
   // Child DxgiAdapterContext belongs to this DxgiFrameContext.
   std::vector<DxgiAdapterContext> contexts;
 };
@@ -282,6 +282,9 @@ void DxgiDuplicatorController::Setup(Context* context) {
     context->contexts.resize(duplicators_.size());
     for (size_t i = 0; i < duplicators_.size(); i++) {
       duplicators_[i].Setup(&context->contexts[i]);
+      for (DxgiOutputContext& output_context : context->contexts[i].contexts) {
+        output_context.pipelined = context->pipelined;
+      }
     }
     context->controller_id = identity_;
   }
@@ -21,8 +21,10 @@
 
 namespace webrtc {
 
-DxgiFrame::DxgiFrame(SharedMemoryFactory* factory)
-    : factory_(factory) {}
+DxgiFrame::DxgiFrame(SharedMemoryFactory* factory, bool pipelined)
+    : factory_(factory) {
+  context_.pipelined = pipelined;
+}
 
 DxgiFrame::~DxgiFrame() = default;
 
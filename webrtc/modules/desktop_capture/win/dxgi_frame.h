@@ -33,8 +33,9 @@ class DxgiFrame final {
   using Context = DxgiFrameContext;
 
   // DxgiFrame does not take ownership of |factory|, consumers should ensure it
-  // outlives this instance. nullptr is acceptable.
-  explicit DxgiFrame(SharedMemoryFactory* factory);
+  // outlives this instance. nullptr is acceptable. See
+  // DxgiFrameContext::pipelined for |pipelined|.
+  DxgiFrame(SharedMemoryFactory* factory, bool pipelined);
   ~DxgiFrame();
 
   // Should not be called if Prepare() is not executed or returns false.
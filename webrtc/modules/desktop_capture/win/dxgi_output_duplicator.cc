@@ -20,7 +20,6 @@
 #include <algorithm>
 
 #include "webrtc/modules/desktop_capture/win/dxgi_texture_mapping.h"
-#include "webrtc/modules/desktop_capture/win/dxgi_texture_staging.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/win32.h"
@@ -87,8 +86,10 @@ bool DxgiOutputDuplicator::Initialize() {
   if (DuplicateOutput()) {
     if (desc_.DesktopImageInSystemMemory) {
       texture_.reset(new DxgiTextureMapping(duplication_.Get()));
+      staging_texture_ = nullptr;
     } else {
-      texture_.reset(new DxgiTextureStaging(device_));
+      staging_texture_ = new DxgiTextureStaging(device_);
+      texture_.reset(staging_texture_);
     }
     return true;
   } else {
@@ -158,6 +159,16 @@ bool DxgiOutputDuplicator::Duplicate(Context* context,
     return false;
   }
 
+  // A pipelined Duplicate() call keeps its frame until now: Windows suggests
+  // to release a frame right before acquiring the next one, and the desktop
+  // image stays unchanged while the GPU copies it.
+  if (frame_held_) {
+    frame_held_ = false;
+    if (!ReleaseFrame()) {
+      return false;
+    }
+  }
+
   DXGI_OUTDUPL_FRAME_INFO frame_info;
   memset(&frame_info, 0, sizeof(frame_info));
   ComPtr<IDXGIResource> resource;
@@ -177,7 +188,29 @@ bool DxgiOutputDuplicator::Duplicate(Context* context,
   if (error.Error() == S_OK &&
       frame_info.AccumulatedFrames > 0 &&
       resource) {
+    if (context->pipelined && staging_texture_) {
+      DesktopRegion frame_region;
+      DetectUpdatedRegion(frame_info, &frame_region);
+      if (!staging_texture_->Stage(frame_info, resource.Get())) {
+        return false;
+      }
+      staged_regions_.push_back(frame_region);
+      frame_held_ = true;
+      // The GPU copies the new frame while the previous one is exported. Only
+      // the very first frame has to be waited for.
+      if (staged_regions_.size() > 1 || !last_frame_) {
+        return ExportStagedFrame(context, &updated_region, offset, target);
+      }
+      ExportLastFrame(&updated_region, offset, target);
+      return true;
+    }
+
     DetectUpdatedRegion(frame_info, &context->updated_region);
+    // The frames staged by pipelined contexts are superseded by this one.
+    for (const DesktopRegion& staged_region : staged_regions_) {
+      context->updated_region.AddRegion(staged_region);
+    }
+    staged_regions_.clear();
     SpreadContextChange(context);
     if (!texture_->CopyFrom(frame_info, resource.Get())) {
       return false;
@@ -186,48 +219,19 @@ bool DxgiOutputDuplicator::Duplicate(Context* context,
     // TODO(zijiehe): Figure out why clearing context->updated_region() here
     // triggers screen flickering?
 
-    const DesktopFrame& source = texture_->AsDesktopFrame();
-    if (rotation_ != Rotation::CLOCK_WISE_0) {
-      for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
-           it.Advance()) {
-        // The |updated_region| returned by Windows is rotated, but the |source|
-        // frame is not. So we need to rotate it reversely.
-        const DesktopRect source_rect = RotateRect(
-            it.rect(), desktop_size(), ReverseRotation(rotation_));
-        RotateDesktopFrame(source, source_rect, rotation_, offset, target);
-      }
-    } else {
-      for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
-           it.Advance()) {
-        // The DesktopRect in |target|, starts from offset.
-        DesktopRect dest_rect = it.rect();
-        dest_rect.Translate(offset);
-        target->CopyPixelsFrom(source, it.rect().top_left(), dest_rect);
-      }
-    }
-    last_frame_ = target->Share();
-    last_frame_offset_ = offset;
-    updated_region.Translate(offset.x(), offset.y());
-    target->mutable_updated_region()->AddRegion(updated_region);
-    num_frames_captured_++;
+    ExportTexture(&updated_region, offset, target);
     return texture_->Release() && ReleaseFrame();
   }
 
-  if (last_frame_) {
+  if (!staged_regions_.empty()) {
+    // There is no new frame to overlap with, so exports the staged one.
+    if (!ExportStagedFrame(context, &updated_region, offset, target)) {
+      return false;
+    }
+  } else if (last_frame_) {
     // No change since last frame or AcquireNextFrame() timed out, we will
     // export last frame to the target.
-    for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
-         it.Advance()) {
-      // The DesktopRect in |source|, starts from last_frame_offset_.
-      DesktopRect source_rect = it.rect();
-      // The DesktopRect in |target|, starts from offset.
-      DesktopRect target_rect = source_rect;
-      source_rect.Translate(last_frame_offset_);
-      target_rect.Translate(offset);
-      target->CopyPixelsFrom(*last_frame_, source_rect.top_left(), target_rect);
-    }
-    updated_region.Translate(offset.x(), offset.y());
-    target->mutable_updated_region()->AddRegion(updated_region);
+    ExportLastFrame(&updated_region, offset, target);
   } else {
     // If we were at the very first frame, and capturing failed, the
     // context->updated_region should be kept unchanged for next attempt.
@@ -238,6 +242,77 @@ bool DxgiOutputDuplicator::Duplicate(Context* context,
   return error.Error() == DXGI_ERROR_WAIT_TIMEOUT || ReleaseFrame();
 }
 
+bool DxgiOutputDuplicator::ExportStagedFrame(Context* context,
+                                             DesktopRegion* updated_region,
+                                             DesktopVector offset,
+                                             SharedDesktopFrame* target) {
+  RTC_DCHECK(staging_texture_);
+  RTC_DCHECK(!staged_regions_.empty());
+  RTC_DCHECK_EQ(staging_texture_->staged_count(),
+                static_cast<int>(staged_regions_.size()));
+  if (!staging_texture_->MapStaged()) {
+    return false;
+  }
+
+  // Same as a non-pipelined Duplicate() call, but with the updated region of
+  // the staged frame.
+  RTC_DCHECK(context->updated_region.is_empty());
+  context->updated_region.Swap(&staged_regions_.front());
+  staged_regions_.pop_front();
+  SpreadContextChange(context);
+  updated_region->AddRegion(context->updated_region);
+
+  ExportTexture(updated_region, offset, target);
+  return texture_->Release();
+}
+
+void DxgiOutputDuplicator::ExportTexture(DesktopRegion* updated_region,
+                                         DesktopVector offset,
+                                         SharedDesktopFrame* target) {
+  const DesktopFrame& source = texture_->AsDesktopFrame();
+  if (rotation_ != Rotation::CLOCK_WISE_0) {
+    for (DesktopRegion::Iterator it(*updated_region); !it.IsAtEnd();
+         it.Advance()) {
+      // The |updated_region| returned by Windows is rotated, but the |source|
+      // frame is not. So we need to rotate it reversely.
+      const DesktopRect source_rect = RotateRect(
+          it.rect(), desktop_size(), ReverseRotation(rotation_));
+      RotateDesktopFrame(source, source_rect, rotation_, offset, target);
+    }
+  } else {
+    for (DesktopRegion::Iterator it(*updated_region); !it.IsAtEnd();
+         it.Advance()) {
+      // The DesktopRect in |target|, starts from offset.
+      DesktopRect dest_rect = it.rect();
+      dest_rect.Translate(offset);
+      target->CopyPixelsFrom(source, it.rect().top_left(), dest_rect);
+    }
+  }
+  last_frame_ = target->Share();
+  last_frame_offset_ = offset;
+  updated_region->Translate(offset.x(), offset.y());
+  target->mutable_updated_region()->AddRegion(*updated_region);
+  num_frames_captured_++;
+}
+
+void DxgiOutputDuplicator::ExportLastFrame(DesktopRegion* updated_region,
+                                           DesktopVector offset,
+                                           SharedDesktopFrame* target) {
+  RTC_DCHECK(last_frame_);
+  for (DesktopRegion::Iterator it(*updated_region); !it.IsAtEnd();
+       it.Advance()) {
+    // The DesktopRect in |source|, starts from last_frame_offset_.
+    DesktopRect source_rect = it.rect();
+    // The DesktopRect in |target|, starts from offset.
+    DesktopRect target_rect = source_rect;
+    source_rect.Translate(last_frame_offset_);
+    target_rect.Translate(offset);
+    target->CopyPixelsFrom(*last_frame_, source_rect.top_left(), target_rect);
+  }
+  updated_region->Translate(offset.x(), offset.y());
+  target->mutable_updated_region()->AddRegion(*updated_region);
+}
+
 DesktopRect DxgiOutputDuplicator::GetTranslatedDesktopRect(
     DesktopVector offset) const {
   DesktopRect result(DesktopRect::MakeSize(desktop_size()));
@@ -16,6 +16,7 @@
 #include <DXGI.h>
 #include <DXGI1_2.h>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "webrtc/modules/desktop_capture/win/d3d_device.h"
 #include "webrtc/modules/desktop_capture/win/dxgi_context.h"
 #include "webrtc/modules/desktop_capture/win/dxgi_texture.h"
+#include "webrtc/modules/desktop_capture/win/dxgi_texture_staging.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 
@@ -61,6 +63,9 @@ class DxgiOutputDuplicator {
   // the offset in the |target| where the content should be copied to. i.e. this
   // function copies the content to the rectangle of (offset.x(), offset.y()) to
   // (offset.x() + desktop_rect_.width(), offset.y() + desktop_rect_.height()).
+  // If |context| is pipelined and the desktop image is not in system memory,
+  // the new frame is staged on the GPU and the one staged during the last call
+  // is exported instead, so the GPU to CPU copy does not block this function.
   // Returns false in case of a failure.
   bool Duplicate(Context* context,
                  DesktopVector offset,
@@ -95,6 +100,25 @@ class DxgiOutputDuplicator {
 
   bool ReleaseFrame();
 
+  // Maps the oldest frame staged in |staging_texture_| and exports it to
+  // |target| together with |updated_region|. Returns false in case of a
+  // failure.
+  bool ExportStagedFrame(Context* context,
+                         DesktopRegion* updated_region,
+                         DesktopVector offset,
+                         SharedDesktopFrame* target);
+
+  // Copies |updated_region| of the mapped |texture_| to |target|, and makes
+  // |target| the |last_frame_|.
+  void ExportTexture(DesktopRegion* updated_region,
+                     DesktopVector offset,
+                     SharedDesktopFrame* target);
+
+  // Copies |updated_region| of |last_frame_| to |target|.
+  void ExportLastFrame(DesktopRegion* updated_region,
+                       DesktopVector offset,
+                       SharedDesktopFrame* target);
+
   // Initializes duplication_ instance. Expects duplication_ is in empty status.
   // Returns false if system does not support IDXGIOutputDuplication.
   bool DuplicateOutput();
@@ -122,6 +146,15 @@ class DxgiOutputDuplicator {
   DXGI_OUTDUPL_DESC desc_;
   std::vector<uint8_t> metadata_;
   std::unique_ptr<DxgiTexture> texture_;
+  // |texture_| if the desktop image is not in system memory, which allows
+  // Duplicate() to be pipelined.
+  DxgiTextureStaging* staging_texture_ = nullptr;
+  // The updated regions of the frames staged in |staging_texture_|, oldest
+  // first. They are spread to |contexts_| once the frame is exported.
+  std::deque<DesktopRegion> staged_regions_;
+  // Whether the frame acquired by the last pipelined Duplicate() call has not
+  // been released yet.
+  bool frame_held_ = false;
   Rotation rotation_;
   DesktopSize unrotated_size_;
 
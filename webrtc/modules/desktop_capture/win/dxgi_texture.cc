@@ -43,6 +43,15 @@ DxgiTexture::~DxgiTexture() = default;
 bool DxgiTexture::CopyFrom(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
                            IDXGIResource* resource) {
   RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
+  ComPtr<ID3D11Texture2D> texture = ToTexture(resource);
+  if (!texture) {
+    return false;
+  }
+
+  return CopyFromTexture(frame_info, texture.Get());
+}
+
+ComPtr<ID3D11Texture2D> DxgiTexture::ToTexture(IDXGIResource* resource) {
   RTC_DCHECK(resource);
   ComPtr<ID3D11Texture2D> texture;
   _com_error error = resource->QueryInterface(
@@ -52,14 +61,13 @@ bool DxgiTexture::CopyFrom(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
     LOG(LS_ERROR) << "Failed to convert IDXGIResource to ID3D11Texture2D, "
                      "error "
                   << error.ErrorMessage() << ", code " << error.Error();
-    return false;
+    return nullptr;
   }
 
   D3D11_TEXTURE2D_DESC desc = {0};
   texture->GetDesc(&desc);
   desktop_size_.set(desc.Width, desc.Height);
-
-  return CopyFromTexture(frame_info, texture.Get());
+  return texture;
 }
 
 const DesktopFrame& DxgiTexture::AsDesktopFrame() {
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_WIN_DXGI_TEXTURE_H_
 #define WEBRTC_MODULES_DESKTOP_CAPTURE_WIN_DXGI_TEXTURE_H_
 
+#include <wrl/client.h>
 #include <D3D11.h>
 #include <DXGI1_2.h>
 
@@ -57,6 +58,10 @@ class DxgiTexture {
  protected:
   DXGI_MAPPED_RECT* rect();
 
+  // Returns the ID3D11Texture2D behind |resource| and sets desktop_size() to
+  // its size. Returns nullptr if anything wrong.
+  Microsoft::WRL::ComPtr<ID3D11Texture2D> ToTexture(IDXGIResource* resource);
+
   virtual bool CopyFromTexture(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
                                ID3D11Texture2D* texture) = 0;
 
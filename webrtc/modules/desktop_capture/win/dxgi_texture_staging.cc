@@ -28,7 +28,8 @@ DxgiTextureStaging::DxgiTextureStaging(const D3dDevice& device)
 
 DxgiTextureStaging::~DxgiTextureStaging() = default;
 
-bool DxgiTextureStaging::InitializeStage(ID3D11Texture2D* texture) {
+bool DxgiTextureStaging::InitializeStage(Slot* slot,
+                                         ID3D11Texture2D* texture) {
   RTC_DCHECK(texture);
   D3D11_TEXTURE2D_DESC desc = {0};
   texture->GetDesc(&desc);
@@ -41,10 +42,10 @@ bool DxgiTextureStaging::InitializeStage(ID3D11Texture2D* texture) {
   desc.SampleDesc.Count = 1;
   desc.SampleDesc.Quality = 0;
   desc.Usage = D3D11_USAGE_STAGING;
-  if (stage_) {
-    AssertStageAndSurfaceAreSameObject();
+  if (slot->texture) {
+    AssertStageAndSurfaceAreSameObject(*slot);
     D3D11_TEXTURE2D_DESC current_desc;
-    stage_->GetDesc(&current_desc);
+    slot->texture->GetDesc(&current_desc);
     const bool recreate_needed = (
         memcmp(&desc, &current_desc, sizeof(D3D11_TEXTURE2D_DESC)) != 0);
     RTC_HISTOGRAM_BOOLEAN("WebRTC.DesktopCapture.StagingTextureRecreate",
@@ -55,22 +56,22 @@ bool DxgiTextureStaging::InitializeStage(ID3D11Texture2D* texture) {
 
     // The descriptions are not consistent, we need to create a new
     // ID3D11Texture2D instance.
-    stage_.Reset();
-    surface_.Reset();
+    slot->texture.Reset();
+    slot->surface.Reset();
   } else {
-    RTC_DCHECK(!surface_);
+    RTC_DCHECK(!slot->surface);
   }
 
   _com_error error = device_.d3d_device()->CreateTexture2D(
-      &desc, nullptr, stage_.GetAddressOf());
-  if (error.Error() != S_OK || !stage_) {
+      &desc, nullptr, slot->texture.GetAddressOf());
+  if (error.Error() != S_OK || !slot->texture) {
     LOG(LS_ERROR) << "Failed to create a new ID3D11Texture2D as stage, error "
                   << error.ErrorMessage() << ", code " << error.Error();
     return false;
   }
 
-  error = stage_.As(&surface_);
-  if (error.Error() != S_OK || !surface_) {
+  error = slot->texture.As(&slot->surface);
+  if (error.Error() != S_OK || !slot->surface) {
     LOG(LS_ERROR) << "Failed to convert ID3D11Texture2D to IDXGISurface, error "
                   << error.ErrorMessage() << ", code " << error.Error();
     return false;
@@ -79,33 +80,33 @@ bool DxgiTextureStaging::InitializeStage(ID3D11Texture2D* texture) {
   return true;
 }
 
-void DxgiTextureStaging::AssertStageAndSurfaceAreSameObject() {
+void DxgiTextureStaging::AssertStageAndSurfaceAreSameObject(const Slot& slot) {
   ComPtr<IUnknown> left;
   ComPtr<IUnknown> right;
-  bool left_result = SUCCEEDED(stage_.As(&left));
-  bool right_result = SUCCEEDED(surface_.As(&right));
+  bool left_result = SUCCEEDED(slot.texture.As(&left));
+  bool right_result = SUCCEEDED(slot.surface.As(&right));
   RTC_DCHECK(left_result);
   RTC_DCHECK(right_result);
   RTC_DCHECK(left.Get() == right.Get());
 }
 
-bool DxgiTextureStaging::CopyFromTexture(
-    const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-    ID3D11Texture2D* texture) {
-  RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
-  RTC_DCHECK(texture);
-
+bool DxgiTextureStaging::CopyToSlot(Slot* slot, ID3D11Texture2D* texture) {
   // AcquireNextFrame returns a CPU inaccessible IDXGIResource, so we need to
   // copy it to a CPU accessible staging ID3D11Texture2D.
-  if (!InitializeStage(texture)) {
+  if (!InitializeStage(slot, texture)) {
     return false;
   }
 
-  device_.context()->CopyResource(static_cast<ID3D11Resource*>(stage_.Get()),
-                                  static_cast<ID3D11Resource*>(texture));
+  device_.context()->CopyResource(
+      static_cast<ID3D11Resource*>(slot->texture.Get()),
+      static_cast<ID3D11Resource*>(texture));
+  return true;
+}
 
+bool DxgiTextureStaging::MapSlot(Slot* slot) {
+  RTC_DCHECK(!mapped_slot_);
   *rect() = {0};
-  _com_error error = surface_->Map(rect(), DXGI_MAP_READ);
+  _com_error error = slot->surface->Map(rect(), DXGI_MAP_READ);
   if (error.Error() != S_OK) {
     *rect() = {0};
     LOG(LS_ERROR) << "Failed to map the IDXGISurface to a bitmap, error "
@@ -113,15 +114,62 @@ bool DxgiTextureStaging::CopyFromTexture(
     return false;
   }
 
+  mapped_slot_ = slot;
+  return true;
+}
+
+bool DxgiTextureStaging::CopyFromTexture(
+    const DXGI_OUTDUPL_FRAME_INFO& frame_info,
+    ID3D11Texture2D* texture) {
+  RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
+  RTC_DCHECK(texture);
+
+  // The staged copies are older than |texture|.
+  first_staged_ = 0;
+  staged_count_ = 0;
+  return CopyToSlot(&slots_[0], texture) && MapSlot(&slots_[0]);
+}
+
+bool DxgiTextureStaging::Stage(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
+                               IDXGIResource* resource) {
+  RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
+  RTC_DCHECK_LT(staged_count_, kSlotCount);
+  ComPtr<ID3D11Texture2D> texture = ToTexture(resource);
+  if (!texture) {
+    return false;
+  }
+
+  Slot* slot = &slots_[(first_staged_ + staged_count_) % kSlotCount];
+  RTC_DCHECK(slot != mapped_slot_);
+  if (!CopyToSlot(slot, texture.Get())) {
+    return false;
+  }
+
+  // Submits the copy to the GPU now instead of when the slot is mapped.
+  device_.context()->Flush();
+  staged_count_++;
   return true;
 }
 
+bool DxgiTextureStaging::MapStaged() {
+  RTC_DCHECK_GT(staged_count_, 0);
+  Slot* slot = &slots_[first_staged_];
+  first_staged_ = (first_staged_ + 1) % kSlotCount;
+  staged_count_--;
+  return MapSlot(slot);
+}
+
 bool DxgiTextureStaging::DoRelease() {
-  _com_error error = surface_->Unmap();
+  if (!mapped_slot_) {
+    return true;
+  }
+
+  _com_error error = mapped_slot_->surface->Unmap();
   if (error.Error() != S_OK) {
-    stage_.Reset();
-    surface_.Reset();
+    mapped_slot_->texture.Reset();
+    mapped_slot_->surface.Reset();
   }
+  mapped_slot_ = nullptr;
   // If using staging mode, we only need to recreate ID3D11Texture2D instance.
   // This will happen during next CopyFrom call. So this function always returns
   // true.
@@ -22,10 +22,11 @@
 
 namespace webrtc {
 
-// A pair of an ID3D11Texture2D and an IDXGISurface. We need an ID3D11Texture2D
+// Pairs of an ID3D11Texture2D and an IDXGISurface. We need an ID3D11Texture2D
 // instance to copy GPU texture to RAM, but an IDXGISurface instance to map the
 // texture into a bitmap buffer. These two instances are pointing to a same
-// object.
+// object. Having more than one pair allows the copy of a frame to be staged
+// while the previous one is being read.
 //
 // An ID3D11Texture2D is created by an ID3D11Device, so a DxgiTexture cannot be
 // shared between two DxgiAdapterDuplicators.
@@ -37,6 +38,23 @@ class DxgiTextureStaging : public DxgiTexture {
 
   ~DxgiTextureStaging() override;
 
+  // Starts copying a frame represented by frame_info and resource to a staging
+  // texture, but doesn't wait for the GPU to finish, so the copy overlaps with
+  // whatever the caller does before MapStaged(). Up to kSlotCount copies can
+  // be staged at a time. Returns false if anything wrong.
+  bool Stage(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
+             IDXGIResource* resource);
+
+  // Maps the oldest staged copy, waiting for the GPU if it has not finished
+  // yet. The same rules as after CopyFrom() apply until Release() is called.
+  // Returns false if anything wrong.
+  bool MapStaged();
+
+  // The number of copies staged but not mapped yet. CopyFrom() discards them.
+  int staged_count() const { return staged_count_; }
+
+  static const int kSlotCount = 2;
+
  protected:
   // Copies selected regions of a frame represented by frame_info and texture.
   // Returns false if anything wrong.
@@ -46,21 +64,37 @@ class DxgiTextureStaging : public DxgiTexture {
   bool DoRelease() override;
 
  private:
-  // Initializes stage_ from a CPU inaccessible IDXGIResource. Returns false if
-  // it failed to execute Windows APIs, or the size of the texture is not
-  // consistent with desktop_rect.
-  bool InitializeStage(ID3D11Texture2D* texture);
-
-  // Makes sure stage_ and surface_ are always pointing to a same object.
   // We need an ID3D11Texture2D instance for
   // ID3D11DeviceContext::CopySubresourceRegion, but an IDXGISurface for
-  // IDXGISurface::Map.
-  void AssertStageAndSurfaceAreSameObject();
+  // IDXGISurface::Map. Both are pointing to a same object.
+  struct Slot {
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+    Microsoft::WRL::ComPtr<IDXGISurface> surface;
+  };
+
+  // Initializes |slot| from a CPU inaccessible IDXGIResource. Returns false
+  // if it failed to execute Windows APIs, or the size of the texture is not
+  // consistent with desktop_rect.
+  bool InitializeStage(Slot* slot, ID3D11Texture2D* texture);
+
+  // Copies |texture| to |slot|. Returns false if anything wrong.
+  bool CopyToSlot(Slot* slot, ID3D11Texture2D* texture);
+
+  // Maps |slot| into rect(). Returns false if anything wrong.
+  bool MapSlot(Slot* slot);
+
+  // Makes sure the texture and surface of |slot| are always pointing to a
+  // same object.
+  void AssertStageAndSurfaceAreSameObject(const Slot& slot);
 
   const DesktopRect desktop_rect_;
   const D3dDevice device_;
-  Microsoft::WRL::ComPtr<ID3D11Texture2D> stage_;
-  Microsoft::WRL::ComPtr<IDXGISurface> surface_;
+  Slot slots_[kSlotCount];
+  // The index of the oldest staged copy in |slots_|, and the count of them.
+  int first_staged_ = 0;
+  int staged_count_ = 0;
+  // The slot mapped by the last CopyFrom() or MapStaged() call, if any.
+  Slot* mapped_slot_ = nullptr;
 };
 
 }  // namespace webrtc
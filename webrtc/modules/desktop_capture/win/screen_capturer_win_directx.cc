@@ -98,8 +98,10 @@ int ScreenCapturerWinDirectx::GetIndexFromScreenId(
   return -1;
 }
 
-ScreenCapturerWinDirectx::ScreenCapturerWinDirectx()
-    : controller_(DxgiDuplicatorController::Instance()) {}
+ScreenCapturerWinDirectx::ScreenCapturerWinDirectx(
+    const DesktopCaptureOptions& options)
+    : controller_(DxgiDuplicatorController::Instance()),
+      pipelined_(options.allow_directx_pipelining()) {}
 
 ScreenCapturerWinDirectx::~ScreenCapturerWinDirectx() = default;
 
@@ -123,7 +125,7 @@ void ScreenCapturerWinDirectx::CaptureFrame() {
   frames_.MoveToNextFrame();
   if (!frames_.current_frame()) {
     frames_.ReplaceCurrentFrame(
-        rtc::MakeUnique<DxgiFrame>(shared_memory_factory_.get()));
+        rtc::MakeUnique<DxgiFrame>(shared_memory_factory_.get(), pipelined_));
   }
 
   DxgiDuplicatorController::Result result;
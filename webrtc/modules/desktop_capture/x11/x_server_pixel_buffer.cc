@@ -129,6 +129,19 @@ void SlowBlit(XImage* x_image,
   }
 }
 
+// A DesktopFrame whose pixels are in an X shared memory segment. The segment is
+// marked for removal once attached, so it's freed when both the frame and the X
+// server have detached from it.
+class SharedMemorySegmentFrame : public DesktopFrame {
+ public:
+  SharedMemorySegmentFrame(DesktopSize size, int stride, uint8_t* data)
+      : DesktopFrame(size, stride, data, nullptr) {}
+  ~SharedMemorySegmentFrame() override { shmdt(data_); }
+
+ private:
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedMemorySegmentFrame);
+};
+
 }  // namespace
 
 XServerPixelBuffer::XServerPixelBuffer() {}
@@ -156,6 +169,7 @@ void XServerPixelBuffer::Release() {
   }
 
   ReleaseSharedMemorySegment();
+  ReleaseFrameSegments();
 
   window_ = 0;
 }
@@ -171,6 +185,13 @@ void XServerPixelBuffer::ReleaseSharedMemorySegment() {
   shm_segment_info_ = nullptr;
 }
 
+void XServerPixelBuffer::ReleaseFrameSegments() {
+  // The frames may still be in use, so only the X server detaches here.
+  for (const std::unique_ptr<XShmSegmentInfo>& segment : frame_segments_)
+    XShmDetach(display_, segment.get());
+  frame_segments_.clear();
+}
+
 bool XServerPixelBuffer::Init(Display* display, Window window) {
   Release();
   display_ = display;
@@ -189,6 +210,8 @@ bool XServerPixelBuffer::Init(Display* display, Window window) {
 void XServerPixelBuffer::InitShm(const XWindowAttributes& attributes) {
   Visual* default_visual = attributes.visual;
   int default_depth = attributes.depth;
+  visual_ = default_visual;
+  depth_ = default_depth;
 
   int major, minor;
   Bool have_pixmaps;
@@ -310,15 +333,111 @@ void XServerPixelBuffer::Synchronize() {
   }
 }
 
+std::unique_ptr<DesktopFrame> XServerPixelBuffer::CreateSharedMemoryFrame() {
+  if (!shm_segment_info_ || !IsXImageRGBFormat(x_shm_image_))
+    return nullptr;
+
+  int stride = x_shm_image_->bytes_per_line;
+  std::unique_ptr<XShmSegmentInfo> segment(new XShmSegmentInfo);
+  segment->shmaddr = nullptr;
+  segment->readOnly = False;
+  segment->shmid =
+      shmget(IPC_PRIVATE, stride * window_rect_.height(), IPC_CREAT | 0600);
+  if (segment->shmid == -1) {
+    LOG(LS_WARNING) << "Failed to get shared memory segment for a frame.";
+    return nullptr;
+  }
+
+  bool attached = false;
+  void* shmat_result = shmat(segment->shmid, 0, 0);
+  if (shmat_result != reinterpret_cast<void*>(-1)) {
+    segment->shmaddr = reinterpret_cast<char*>(shmat_result);
+
+    XErrorTrap error_trap(display_);
+    attached = XShmAttach(display_, segment.get());
+    XSync(display_, False);
+    if (error_trap.GetLastErrorAndDisable() != 0)
+      attached = false;
+  }
+  shmctl(segment->shmid, IPC_RMID, 0);
+  if (!attached) {
+    if (segment->shmaddr)
+      shmdt(segment->shmaddr);
+    LOG(LS_WARNING) << "Failed to attach shared memory segment for a frame.";
+    return nullptr;
+  }
+
+  // A segment still attached at the same address belonged to a frame which has
+  // been destroyed since.
+  for (auto it = frame_segments_.begin(); it != frame_segments_.end();) {
+    if ((*it)->shmaddr == segment->shmaddr) {
+      XShmDetach(display_, it->get());
+      it = frame_segments_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  uint8_t* data = reinterpret_cast<uint8_t*>(segment->shmaddr);
+  frame_segments_.push_back(std::move(segment));
+  return std::unique_ptr<DesktopFrame>(
+      new SharedMemorySegmentFrame(window_rect_.size(), stride, data));
+}
+
+bool XServerPixelBuffer::IsSharedMemoryFrame(const DesktopFrame& frame) const {
+  return FindFrameSegment(frame) != nullptr;
+}
+
+XShmSegmentInfo* XServerPixelBuffer::FindFrameSegment(
+    const DesktopFrame& frame) const {
+  for (const std::unique_ptr<XShmSegmentInfo>& segment : frame_segments_) {
+    if (reinterpret_cast<uint8_t*>(segment->shmaddr) == frame.data())
+      return segment.get();
+  }
+  return nullptr;
+}
+
+bool XServerPixelBuffer::CaptureRowsToSegment(int top,
+                                              int bottom,
+                                              XShmSegmentInfo* segment) {
+  XImage* image =
+      XShmCreateImage(display_, visual_, depth_, ZPixmap, nullptr, segment,
+                      window_rect_.width(), bottom - top);
+  if (!image)
+    return false;
+  RTC_DCHECK_EQ(image->bytes_per_line, x_shm_image_->bytes_per_line);
+  image->data = segment->shmaddr + top * image->bytes_per_line;
+
+  bool result;
+  {
+    // XShmGetImage can fail if the display is being reconfigured.
+    XErrorTrap error_trap(display_);
+    result = XShmGetImage(display_, window_, image, 0, top, AllPlanes);
+  }
+  // The pixels belong to the frame.
+  image->data = nullptr;
+  XDestroyImage(image);
+  return result;
+}
+
 bool XServerPixelBuffer::CaptureRect(const DesktopRect& rect,
                                      DesktopFrame* frame) {
   RTC_DCHECK_LE(rect.right(), window_rect_.width());
   RTC_DCHECK_LE(rect.bottom(), window_rect_.height());
 
+  XShmSegmentInfo* frame_segment = FindFrameSegment(*frame);
+  if (frame_segment &&
+      CaptureRowsToSegment(rect.top(), rect.bottom(), frame_segment)) {
+    return true;
+  }
+
   XImage* image;
   uint8_t* data;
 
-  if (shm_segment_info_ && (shm_pixmap_ || xshm_get_image_succeeded_)) {
+  // Synchronize() isn't called for shared memory frames, so |x_shm_image_| is
+  // only up to date for them if it's backed by |shm_pixmap_|.
+  if (shm_segment_info_ &&
+      (shm_pixmap_ || (!frame_segment && xshm_get_image_succeeded_))) {
     if (shm_pixmap_) {
       XCopyArea(display_, window_, shm_pixmap_, shm_gc_,
                 rect.left(), rect.top(), rect.width(), rect.height(),
@@ -13,6 +13,9 @@
 #ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_X11_X_SERVER_PIXEL_BUFFER_H_
 #define WEBRTC_MODULES_DESKTOP_CAPTURE_X11_X_SERVER_PIXEL_BUFFER_H_
 
+#include <memory>
+#include <vector>
+
 #include "webrtc/modules/desktop_capture/desktop_geometry.h"
 #include "webrtc/rtc_base/constructormagic.h"
 
@@ -54,14 +57,36 @@ class XServerPixelBuffer {
   // beginning.
   void Synchronize();
 
+  // Creates a frame of window_size() whose pixels live in a new X shared
+  // memory segment, so that CaptureRect() has the X server write them in place
+  // instead of copying them out of another buffer. Returns nullptr if shared
+  // memory isn't available or the window's pixel format isn't the one of
+  // DesktopFrame, in which case the caller should allocate the frame itself.
+  // The frame stays valid after Release(), but isn't written in place anymore.
+  std::unique_ptr<DesktopFrame> CreateSharedMemoryFrame();
+
+  // Returns true if |frame| was created by CreateSharedMemoryFrame() since the
+  // last Init(). Synchronize() isn't needed before capturing to such a frame.
+  bool IsSharedMemoryFrame(const DesktopFrame& frame) const;
+
   // Capture the specified rectangle and stores it in the |frame|. In the case
   // where the full-screen data is captured by Synchronize(), this simply
-  // returns the pointer without doing any more work. The caller must ensure
-  // that |rect| is not larger than window_size().
+  // returns the pointer without doing any more work. For frames created by
+  // CreateSharedMemoryFrame() the whole rows covered by |rect| are captured.
+  // The caller must ensure that |rect| is not larger than window_size().
   bool CaptureRect(const DesktopRect& rect, DesktopFrame* frame);
 
  private:
   void ReleaseSharedMemorySegment();
+  void ReleaseFrameSegments();
+
+  // Returns the segment attached for |frame|, or nullptr if |frame| wasn't
+  // created by CreateSharedMemoryFrame().
+  XShmSegmentInfo* FindFrameSegment(const DesktopFrame& frame) const;
+
+  // Has the X server write the full width of the rows from |top| to |bottom|
+  // into |segment|.
+  bool CaptureRowsToSegment(int top, int bottom, XShmSegmentInfo* segment);
 
   void InitShm(const XWindowAttributes& attributes);
   bool InitPixmaps(int depth);
@@ -75,6 +100,13 @@ class XServerPixelBuffer {
   Pixmap shm_pixmap_ = 0;
   GC shm_gc_ = nullptr;
   bool xshm_get_image_succeeded_ = false;
+  Visual* visual_ = nullptr;
+  int depth_ = 0;
+
+  // Segments of the frames created by CreateSharedMemoryFrame(). The frames
+  // own the mappings, so the memory is freed once both the frame is destroyed
+  // and the segment is detached here.
+  std::vector<std::unique_ptr<XShmSegmentInfo>> frame_segments_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(XServerPixelBuffer);
 };
@@ -12,6 +12,7 @@
 
 #include <string>
 
+#include "webrtc/logging/rtc_event_log/rtc_event_log.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/format_macros.h"
 #include "webrtc/rtc_base/logging.h"
@@ -25,11 +26,14 @@ const char AlrDetector::kScreenshareProbingBweExperimentName[] =
 const char AlrDetector::kStrictPacingAndProbingExperimentName[] =
     "WebRTC-StrictPacingAndProbing";
 
-AlrDetector::AlrDetector()
+AlrDetector::AlrDetector() : AlrDetector(nullptr) {}
+
+AlrDetector::AlrDetector(RtcEventLog* event_log)
     : bandwidth_usage_percent_(kDefaultAlrBandwidthUsagePercent),
       alr_start_budget_level_percent_(kDefaultAlrStartBudgetLevelPercent),
       alr_stop_budget_level_percent_(kDefaultAlrStopBudgetLevelPercent),
-      alr_budget_(0, true) {
+      alr_budget_(0, true),
+      event_log_(event_log) {
   RTC_CHECK(
       field_trial::FindFullName(kStrictPacingAndProbingExperimentName)
           .empty() ||
@@ -55,13 +59,17 @@ void AlrDetector::OnBytesSent(size_t bytes_sent, int64_t delta_time_ms) {
   alr_budget_.UseBudget(bytes_sent);
   alr_budget_.IncreaseBudget(delta_time_ms);
 
-  if (alr_budget_.budget_level_percent() > alr_start_budget_level_percent_ &&
+  const int budget_level_percent = alr_budget_.budget_level_percent();
+  if (budget_level_percent > alr_start_budget_level_percent_ &&
       !alr_started_time_ms_) {
     alr_started_time_ms_.emplace(rtc::TimeMillis());
-  } else if (alr_budget_.budget_level_percent() <
-                 alr_stop_budget_level_percent_ &&
+    if (event_log_)
+      event_log_->LogAlrState(true);
+  } else if (budget_level_percent < alr_stop_budget_level_percent_ &&
              alr_started_time_ms_) {
     alr_started_time_ms_.reset();
+    if (event_log_)
+      event_log_->LogAlrState(false);
   }
 }
 
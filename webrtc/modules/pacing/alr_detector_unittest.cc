@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/pacing/alr_detector.h"
 
+#include "webrtc/logging/rtc_event_log/mock/mock_rtc_event_log.h"
+#include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 
 namespace {
@@ -142,4 +144,23 @@ TEST_F(AlrDetectorTest, BandwidthEstimateChanges) {
   EXPECT_FALSE(alr_detector_.GetApplicationLimitedRegionStartTime());
 }
 
+TEST(AlrDetectorEventLogTest, LogsAlrStartAndEnd) {
+  testing::StrictMock<MockRtcEventLog> event_log;
+  AlrDetector alr_detector(&event_log);
+  alr_detector.SetEstimatedBitrate(kEstimatedBitrateBps);
+
+  // Staying in the same state is not logged again.
+  EXPECT_CALL(event_log, LogAlrState(true)).Times(1);
+  SimulateOutgoingTrafficIn(&alr_detector)
+      .ForTimeMs(2000)
+      .AtPercentOfEstimatedBitrate(20);
+  EXPECT_TRUE(alr_detector.GetApplicationLimitedRegionStartTime());
+
+  EXPECT_CALL(event_log, LogAlrState(false)).Times(1);
+  SimulateOutgoingTrafficIn(&alr_detector)
+      .ForTimeMs(2000)
+      .AtPercentOfEstimatedBitrate(100);
+  EXPECT_FALSE(alr_detector.GetApplicationLimitedRegionStartTime());
+}
+
 }  // namespace webrtc
@@ -16,6 +16,7 @@ namespace webrtc {
 namespace {
 constexpr int kWindowMs = 500;
 constexpr int kDeltaTimeMs = 2000;
+constexpr int64_t kMillibitsPerByte = 8000;
 }
 
 IntervalBudget::IntervalBudget(int initial_target_rate_kbps)
@@ -23,7 +24,9 @@ IntervalBudget::IntervalBudget(int initial_target_rate_kbps)
 
 IntervalBudget::IntervalBudget(int initial_target_rate_kbps,
                                bool can_build_up_underuse)
-    : bytes_remaining_(0), can_build_up_underuse_(can_build_up_underuse) {
+    : bytes_remaining_(0),
+      unused_millibits_(0),
+      can_build_up_underuse_(can_build_up_underuse) {
   set_target_rate_kbps(initial_target_rate_kbps);
 }
 
@@ -36,7 +39,18 @@ void IntervalBudget::set_target_rate_kbps(int target_rate_kbps) {
 
 void IntervalBudget::IncreaseBudget(int64_t delta_time_ms) {
   RTC_DCHECK_LT(delta_time_ms, kDeltaTimeMs);
-  int bytes = target_rate_kbps_ * delta_time_ms / 8;
+  AddBytes(target_rate_kbps_ * delta_time_ms / 8);
+}
+
+void IntervalBudget::IncreaseBudgetUs(int64_t delta_time_us) {
+  RTC_DCHECK_LT(delta_time_us, kDeltaTimeMs * 1000);
+  const int64_t millibits = target_rate_kbps_ * delta_time_us +
+                            unused_millibits_;
+  unused_millibits_ = millibits % kMillibitsPerByte;
+  AddBytes(static_cast<int>(millibits / kMillibitsPerByte));
+}
+
+void IntervalBudget::AddBytes(int bytes) {
   if (bytes_remaining_ < 0 || can_build_up_underuse_) {
     // We overused last interval, compensate this interval.
     bytes_remaining_ = std::min(bytes_remaining_ + bytes, max_bytes_in_budget_);
@@ -51,6 +65,17 @@ void IntervalBudget::UseBudget(size_t bytes) {
                               -max_bytes_in_budget_);
 }
 
+int64_t IntervalBudget::TimeUntilBytesRemainingUs() const {
+  if (bytes_remaining_ > 0)
+    return 0;
+  if (target_rate_kbps_ <= 0)
+    return -1;
+  const int64_t millibits_needed =
+      (1 - bytes_remaining_) * kMillibitsPerByte - unused_millibits_;
+  // Round up, so that the budget is positive when the time has passed.
+  return (millibits_needed + target_rate_kbps_ - 1) / target_rate_kbps_;
+}
+
 size_t IntervalBudget::bytes_remaining() const {
   return static_cast<size_t>(std::max(0, bytes_remaining_));
 }
@@ -25,16 +25,28 @@ class IntervalBudget {
 
   // TODO(tschumim): Unify IncreaseBudget and UseBudget to one function.
   void IncreaseBudget(int64_t delta_time_ms);
+  // Same as IncreaseBudget(), for sub-millisecond intervals. The fractions of
+  // a byte are carried over to the next call.
+  void IncreaseBudgetUs(int64_t delta_time_us);
   void UseBudget(size_t bytes);
 
+  // Returns how long it takes at the target rate until bytes_remaining() is
+  // positive, or -1 if the target rate is zero.
+  int64_t TimeUntilBytesRemainingUs() const;
+
   size_t bytes_remaining() const;
   int budget_level_percent() const;
   int target_rate_kbps() const;
 
  private:
+  void AddBytes(int bytes);
+
   int target_rate_kbps_;
   int max_bytes_in_budget_;
   int bytes_remaining_;
+  // Fraction of a byte left over from IncreaseBudgetUs(), in millibits, the
+  // unit of kbps multiplied by microseconds.
+  int64_t unused_millibits_;
   bool can_build_up_underuse_;
 };
 
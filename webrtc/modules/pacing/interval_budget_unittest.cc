@@ -116,4 +116,37 @@ TEST(IntervalBudgetTest, CanNotBuildUpUnderuseWhenConfigured) {
             TimeToBytes(kBitrateKbps, delta_time_ms));
 }
 
+TEST(IntervalBudgetTest, CarriesOverFractionsOfBytes) {
+  IntervalBudget interval_budget(kBitrateKbps, kCanBuildUpUnderuse);
+  // Each increase is worth 1.25 bytes.
+  const int64_t kDeltaTimeUs = 100;
+  for (int i = 0; i < 10; ++i)
+    interval_budget.IncreaseBudgetUs(kDeltaTimeUs);
+  EXPECT_EQ(interval_budget.bytes_remaining(), 12u);
+  interval_budget.IncreaseBudgetUs(2 * kDeltaTimeUs);
+  EXPECT_EQ(interval_budget.bytes_remaining(), 15u);
+}
+
+TEST(IntervalBudgetTest, TimeUntilBytesRemaining) {
+  IntervalBudget interval_budget(kBitrateKbps);
+  // An empty budget is positive once a byte has been added.
+  EXPECT_EQ(interval_budget.TimeUntilBytesRemainingUs(), 80);
+  interval_budget.IncreaseBudgetUs(80);
+  EXPECT_EQ(interval_budget.TimeUntilBytesRemainingUs(), 0);
+
+  interval_budget.UseBudget(100);
+  EXPECT_EQ(interval_budget.bytes_remaining(), 0u);
+  const int64_t time_until_positive_us =
+      interval_budget.TimeUntilBytesRemainingUs();
+  EXPECT_EQ(time_until_positive_us, 100 * 80);
+  interval_budget.IncreaseBudgetUs(time_until_positive_us - 1);
+  EXPECT_EQ(interval_budget.bytes_remaining(), 0u);
+  interval_budget.IncreaseBudgetUs(1);
+  EXPECT_EQ(interval_budget.bytes_remaining(), 1u);
+
+  interval_budget.set_target_rate_kbps(0);
+  interval_budget.UseBudget(1);
+  EXPECT_EQ(interval_budget.TimeUntilBytesRemainingUs(), -1);
+}
+
 }  // namespace webrtc
@@ -11,20 +11,19 @@
 #include "webrtc/modules/pacing/paced_sender.h"
 
 #include <algorithm>
-#include <map>
-#include <queue>
-#include <set>
-#include <vector>
 
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/pacing/alr_detector.h"
 #include "webrtc/modules/pacing/bitrate_prober.h"
 #include "webrtc/modules/pacing/interval_budget.h"
+#include "webrtc/modules/pacing/packet_queue.h"
 #include "webrtc/modules/utility/include/process_thread.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/location.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/metrics.h"
 
 namespace {
 // Time limit in milliseconds between packet bursts.
@@ -35,203 +34,13 @@ const int64_t kPausedPacketIntervalMs = 500;
 // time.
 const int64_t kMaxIntervalTimeMs = 30;
 
-}  // namespace
+// Lower cap on the process interval in low-latency mode, so that a failing
+// send does not make the pacer spin.
+const int64_t kMinLowLatencyIntervalUs = 250;
 
-// TODO(sprang): Move at least PacketQueue out to separate files, so that we can
-// more easily test them.
+}  // namespace
 
 namespace webrtc {
-namespace paced_sender {
-struct Packet {
-  Packet(RtpPacketSender::Priority priority,
-         uint32_t ssrc,
-         uint16_t seq_number,
-         int64_t capture_time_ms,
-         int64_t enqueue_time_ms,
-         size_t length_in_bytes,
-         bool retransmission,
-         uint64_t enqueue_order)
-      : priority(priority),
-        ssrc(ssrc),
-        sequence_number(seq_number),
-        capture_time_ms(capture_time_ms),
-        enqueue_time_ms(enqueue_time_ms),
-        sum_paused_ms(0),
-        bytes(length_in_bytes),
-        retransmission(retransmission),
-        enqueue_order(enqueue_order) {}
-
-  RtpPacketSender::Priority priority;
-  uint32_t ssrc;
-  uint16_t sequence_number;
-  int64_t capture_time_ms;  // Absolute time of frame capture.
-  int64_t enqueue_time_ms;  // Absolute time of pacer queue entry.
-  int64_t sum_paused_ms;    // Sum of time spent in queue while pacer is paused.
-  size_t bytes;
-  bool retransmission;
-  uint64_t enqueue_order;
-  std::list<Packet>::iterator this_it;
-};
-
-// Used by priority queue to sort packets.
-struct Comparator {
-  bool operator()(const Packet* first, const Packet* second) {
-    // Highest prio = 0.
-    if (first->priority != second->priority)
-      return first->priority > second->priority;
-
-    // Retransmissions go first.
-    if (second->retransmission != first->retransmission)
-      return second->retransmission;
-
-    // Older frames have higher prio.
-    if (first->capture_time_ms != second->capture_time_ms)
-      return first->capture_time_ms > second->capture_time_ms;
-
-    return first->enqueue_order > second->enqueue_order;
-  }
-};
-
-// Class encapsulating a priority queue with some extensions.
-class PacketQueue {
- public:
-  explicit PacketQueue(const Clock* clock)
-      : bytes_(0),
-        clock_(clock),
-        queue_time_sum_(0),
-        time_last_updated_(clock_->TimeInMilliseconds()),
-        paused_(false) {}
-  virtual ~PacketQueue() {}
-
-  void Push(const Packet& packet) {
-    if (!AddToDupeSet(packet))
-      return;
-
-    UpdateQueueTime(packet.enqueue_time_ms);
-
-    // Store packet in list, use pointers in priority queue for cheaper moves.
-    // Packets have a handle to its own iterator in the list, for easy removal
-    // when popping from queue.
-    packet_list_.push_front(packet);
-    std::list<Packet>::iterator it = packet_list_.begin();
-    it->this_it = it;          // Handle for direct removal from list.
-    prio_queue_.push(&(*it));  // Pointer into list.
-    bytes_ += packet.bytes;
-  }
-
-  const Packet& BeginPop() {
-    const Packet& packet = *prio_queue_.top();
-    prio_queue_.pop();
-    return packet;
-  }
-
-  void CancelPop(const Packet& packet) { prio_queue_.push(&(*packet.this_it)); }
-
-  void FinalizePop(const Packet& packet) {
-    RemoveFromDupeSet(packet);
-    bytes_ -= packet.bytes;
-    int64_t packet_queue_time_ms = time_last_updated_ - packet.enqueue_time_ms;
-    RTC_DCHECK_LE(packet.sum_paused_ms, packet_queue_time_ms);
-    packet_queue_time_ms -= packet.sum_paused_ms;
-    RTC_DCHECK_LE(packet_queue_time_ms, queue_time_sum_);
-    queue_time_sum_ -= packet_queue_time_ms;
-    packet_list_.erase(packet.this_it);
-    RTC_DCHECK_EQ(packet_list_.size(), prio_queue_.size());
-    if (packet_list_.empty())
-      RTC_DCHECK_EQ(0, queue_time_sum_);
-  }
-
-  bool Empty() const { return prio_queue_.empty(); }
-
-  size_t SizeInPackets() const { return prio_queue_.size(); }
-
-  uint64_t SizeInBytes() const { return bytes_; }
-
-  int64_t OldestEnqueueTimeMs() const {
-    auto it = packet_list_.rbegin();
-    if (it == packet_list_.rend())
-      return 0;
-    return it->enqueue_time_ms;
-  }
-
-  void UpdateQueueTime(int64_t timestamp_ms) {
-    RTC_DCHECK_GE(timestamp_ms, time_last_updated_);
-    if (timestamp_ms == time_last_updated_)
-      return;
-
-    int64_t delta_ms = timestamp_ms - time_last_updated_;
-
-    if (paused_) {
-      // Increase per-packet accumulators of time spent in queue while paused,
-      // so that we can disregard that when subtracting main accumulator when
-      // popping packet from the queue.
-      for (auto& it : packet_list_) {
-        it.sum_paused_ms += delta_ms;
-      }
-    } else {
-      // Use packet packet_list_.size() not prio_queue_.size() here, as there
-      // might be an outstanding element popped from prio_queue_ currently in
-      // the SendPacket() call, while packet_list_ will always be correct.
-      queue_time_sum_ += delta_ms * packet_list_.size();
-    }
-    time_last_updated_ = timestamp_ms;
-  }
-
-  void SetPauseState(bool paused, int64_t timestamp_ms) {
-    if (paused_ == paused)
-      return;
-    UpdateQueueTime(timestamp_ms);
-    paused_ = paused;
-  }
-
-  int64_t AverageQueueTimeMs() const {
-    if (prio_queue_.empty())
-      return 0;
-    return queue_time_sum_ / packet_list_.size();
-  }
-
- private:
-  // Try to add a packet to the set of ssrc/seqno identifiers currently in the
-  // queue. Return true if inserted, false if this is a duplicate.
-  bool AddToDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    if (it == dupe_map_.end()) {
-      // First for this ssrc, just insert.
-      dupe_map_[packet.ssrc].insert(packet.sequence_number);
-      return true;
-    }
-
-    // Insert returns a pair, where second is a bool set to true if new element.
-    return it->second.insert(packet.sequence_number).second;
-  }
-
-  void RemoveFromDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    RTC_DCHECK(it != dupe_map_.end());
-    it->second.erase(packet.sequence_number);
-    if (it->second.empty()) {
-      dupe_map_.erase(it);
-    }
-  }
-
-  // List of packets, in the order the were enqueued. Since dequeueing may
-  // occur out of order, use list instead of vector.
-  std::list<Packet> packet_list_;
-  // Priority queue of the packets, sorted according to Comparator.
-  // Use pointers into list, to avoid moving whole struct within heap.
-  std::priority_queue<Packet*, std::vector<Packet*>, Comparator> prio_queue_;
-  // Total number of bytes in the queue.
-  uint64_t bytes_;
-  // Map<ssrc, std::set<seq_no> >, for checking duplicates.
-  typedef std::map<uint32_t, std::set<uint16_t> > SsrcSeqNoMap;
-  SsrcSeqNoMap dupe_map_;
-  const Clock* const clock_;
-  int64_t queue_time_sum_;
-  int64_t time_last_updated_;
-  bool paused_;
-};
-
-}  // namespace paced_sender
 
 const int64_t PacedSender::kMaxQueueLengthMs = 2000;
 const float PacedSender::kDefaultPaceMultiplier = 2.5f;
@@ -241,7 +50,7 @@ PacedSender::PacedSender(const Clock* clock,
                          RtcEventLog* event_log)
     : clock_(clock),
       packet_sender_(packet_sender),
-      alr_detector_(new AlrDetector()),
+      alr_detector_(new AlrDetector(event_log)),
       paused_(false),
       media_budget_(new IntervalBudget(0)),
       padding_budget_(new IntervalBudget(0)),
@@ -256,20 +65,41 @@ PacedSender::PacedSender(const Clock* clock,
       packets_(new paced_sender::PacketQueue(clock)),
       packet_counter_(0),
       pacing_factor_(kDefaultPaceMultiplier),
-      queue_time_limit(kMaxQueueLengthMs) {
+      queue_time_limit(kMaxQueueLengthMs),
+      low_latency_mode_(false),
+      alr_elapsed_time_us_(0),
+      creation_time_ms_(clock->TimeInMilliseconds()) {
   UpdateBudgetWithElapsedTime(kMinPacketLimitMs);
 }
 
-PacedSender::~PacedSender() {}
+PacedSender::~PacedSender() {
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
+  UpdateHistograms();
+}
+
+void PacedSender::UpdateHistograms() {
+  int64_t elapsed_minutes =
+      (clock_->TimeInMilliseconds() - creation_time_ms_) / 60000;
+  if (elapsed_minutes <= 0 || stats_.num_bursts == 0)
+    return;
+  RTC_HISTOGRAM_COUNTS_10000("WebRTC.Pacer.BudgetUnderrunsPerMinute",
+                             stats_.num_budget_underruns / elapsed_minutes);
+  RTC_HISTOGRAM_COUNTS_10000("WebRTC.Pacer.BudgetOverrunsPerMinute",
+                             stats_.num_budget_overruns / elapsed_minutes);
+  LOG(LS_INFO) << "WebRTC.Pacer.BudgetUnderrunsPerMinute "
+               << stats_.num_budget_underruns / elapsed_minutes
+               << ", WebRTC.Pacer.BudgetOverrunsPerMinute "
+               << stats_.num_budget_overruns / elapsed_minutes;
+}
 
 void PacedSender::CreateProbeCluster(int bitrate_bps) {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   prober_->CreateProbeCluster(bitrate_bps, clock_->TimeInMilliseconds());
 }
 
 void PacedSender::Pause() {
   {
-    rtc::CritScope cs(&critsect_);
+    rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
     if (!paused_)
       LOG(LS_INFO) << "PacedSender paused.";
     paused_ = true;
@@ -283,7 +113,7 @@ void PacedSender::Pause() {
 
 void PacedSender::Resume() {
   {
-    rtc::CritScope cs(&critsect_);
+    rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
     if (paused_)
       LOG(LS_INFO) << "PacedSender resumed.";
     paused_ = false;
@@ -297,14 +127,14 @@ void PacedSender::Resume() {
 
 void PacedSender::SetProbingEnabled(bool enabled) {
   RTC_CHECK_EQ(0, packet_counter_);
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   prober_->SetEnabled(enabled);
 }
 
 void PacedSender::SetEstimatedBitrate(uint32_t bitrate_bps) {
   if (bitrate_bps == 0)
     LOG(LS_ERROR) << "PacedSender is not designed to handle 0 bitrate.";
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   estimated_bitrate_bps_ = bitrate_bps;
   padding_budget_->set_target_rate_kbps(
       std::min(estimated_bitrate_bps_ / 1000, max_padding_bitrate_kbps_));
@@ -316,7 +146,7 @@ void PacedSender::SetEstimatedBitrate(uint32_t bitrate_bps) {
 
 void PacedSender::SetSendBitrateLimits(int min_send_bitrate_bps,
                                        int padding_bitrate) {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   min_send_bitrate_kbps_ = min_send_bitrate_bps / 1000;
   pacing_bitrate_kbps_ =
       std::max(min_send_bitrate_kbps_, estimated_bitrate_bps_ / 1000) *
@@ -332,23 +162,31 @@ void PacedSender::InsertPacket(RtpPacketSender::Priority priority,
                                int64_t capture_time_ms,
                                size_t bytes,
                                bool retransmission) {
-  rtc::CritScope cs(&critsect_);
-  RTC_DCHECK(estimated_bitrate_bps_ > 0)
-        << "SetEstimatedBitrate must be called before InsertPacket.";
-
-  int64_t now_ms = clock_->TimeInMilliseconds();
-  prober_->OnIncomingPacket(bytes);
-
-  if (capture_time_ms < 0)
-    capture_time_ms = now_ms;
-
-  packets_->Push(paced_sender::Packet(priority, ssrc, sequence_number,
-                                      capture_time_ms, now_ms, bytes,
-                                      retransmission, packet_counter_++));
+  bool wake_up;
+  {
+    rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
+    RTC_DCHECK(estimated_bitrate_bps_ > 0)
+          << "SetEstimatedBitrate must be called before InsertPacket.";
+
+    int64_t now_ms = clock_->TimeInMilliseconds();
+    prober_->OnIncomingPacket(bytes);
+
+    if (capture_time_ms < 0)
+      capture_time_ms = now_ms;
+
+    // In low-latency mode the process thread may be waiting for the padding
+    // interval, so have it send the first packet right away.
+    wake_up = low_latency_mode_ && packets_->Empty();
+    packets_->Push(paced_sender::Packet(priority, ssrc, sequence_number,
+                                        capture_time_ms, now_ms, bytes,
+                                        retransmission, packet_counter_++));
+  }
+  if (wake_up && process_thread_)
+    process_thread_->WakeUp(this);
 }
 
 int64_t PacedSender::ExpectedQueueTimeMs() const {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   RTC_DCHECK_GT(pacing_bitrate_kbps_, 0);
   return static_cast<int64_t>(packets_->SizeInBytes() * 8 /
                               pacing_bitrate_kbps_);
@@ -356,22 +194,22 @@ int64_t PacedSender::ExpectedQueueTimeMs() const {
 
 rtc::Optional<int64_t> PacedSender::GetApplicationLimitedRegionStartTime()
     const {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   return alr_detector_->GetApplicationLimitedRegionStartTime();
 }
 
 size_t PacedSender::QueueSizePackets() const {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   return packets_->SizeInPackets();
 }
 
 int64_t PacedSender::FirstSentPacketTimeMs() const {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   return first_sent_packet_ms_;
 }
 
 int64_t PacedSender::QueueInMs() const {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
 
   int64_t oldest_packet = packets_->OldestEnqueueTimeMs();
   if (oldest_packet == 0)
@@ -381,13 +219,20 @@ int64_t PacedSender::QueueInMs() const {
 }
 
 int64_t PacedSender::AverageQueueTimeMs() {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   packets_->UpdateQueueTime(clock_->TimeInMilliseconds());
   return packets_->AverageQueueTimeMs();
 }
 
+PacedSender::Stats PacedSender::GetStats() const {
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
+  return stats_;
+}
+
 int64_t PacedSender::TimeUntilNextProcess() {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
+  if (low_latency_mode_)
+    return (LowLatencyTimeUntilNextProcessUs() + 999) / 1000;
   int64_t elapsed_time_us = clock_->TimeInMicroseconds() - time_last_update_us_;
   int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
   // When paused we wake up every 500 ms to send a padding packet to ensure
@@ -403,11 +248,57 @@ int64_t PacedSender::TimeUntilNextProcess() {
   return std::max<int64_t>(kMinPacketLimitMs - elapsed_time_ms, 0);
 }
 
+int64_t PacedSender::TimeUntilNextProcessUs() {
+  {
+    rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
+    if (low_latency_mode_)
+      return LowLatencyTimeUntilNextProcessUs();
+  }
+  return TimeUntilNextProcess() * 1000;
+}
+
+int64_t PacedSender::LowLatencyTimeUntilNextProcessUs() {
+  const int64_t now_us = clock_->TimeInMicroseconds();
+  const int64_t elapsed_time_us = now_us - time_last_update_us_;
+  if (paused_) {
+    return std::max<int64_t>(kPausedPacketIntervalMs * 1000 - elapsed_time_us,
+                             0);
+  }
+
+  if (prober_->IsProbing()) {
+    int64_t ret = prober_->TimeUntilNextProbe(now_us / 1000);
+    if (ret > 0 || (ret == 0 && !probing_send_failure_))
+      return ret * 1000;
+  }
+  // Without anything queued, wake up for padding as often as in the normal
+  // mode.
+  int64_t time_until_process_us = kMinPacketLimitMs * 1000;
+  if (!packets_->Empty()) {
+    // The media budget is increased with the time elapsed since the last
+    // update, so the next packet can go when that time has passed.
+    const int64_t time_until_budget_us =
+        media_budget_->TimeUntilBytesRemainingUs();
+    if (time_until_budget_us >= 0) {
+      time_until_process_us = std::min(
+          time_until_process_us,
+          std::max(time_until_budget_us, kMinLowLatencyIntervalUs));
+    }
+  }
+  return std::max<int64_t>(time_until_process_us - elapsed_time_us, 0);
+}
+
 void PacedSender::Process() {
   int64_t now_us = clock_->TimeInMicroseconds();
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   int64_t elapsed_time_ms = std::min(
       kMaxIntervalTimeMs, (now_us - time_last_update_us_ + 500) / 1000);
+  const int64_t elapsed_time_us =
+      std::min(kMaxIntervalTimeMs * 1000, now_us - time_last_update_us_);
+  if (low_latency_mode_) {
+    alr_elapsed_time_us_ += elapsed_time_us;
+    elapsed_time_ms = alr_elapsed_time_us_ / 1000;
+    alr_elapsed_time_us_ %= 1000;
+  }
   int target_bitrate_kbps = pacing_bitrate_kbps_;
 
   if (paused_) {
@@ -422,7 +313,7 @@ void PacedSender::Process() {
     return;
   }
 
-  if (elapsed_time_ms > 0) {
+  if (low_latency_mode_ ? elapsed_time_us > 0 : elapsed_time_ms > 0) {
     size_t queue_size_bytes = packets_->SizeInBytes();
     if (queue_size_bytes > 0) {
       // Assuming equal size packets and input/output rate, the average packet
@@ -438,7 +329,10 @@ void PacedSender::Process() {
     }
 
     media_budget_->set_target_rate_kbps(target_bitrate_kbps);
-    UpdateBudgetWithElapsedTime(elapsed_time_ms);
+    if (low_latency_mode_)
+      UpdateBudgetWithElapsedTimeUs(elapsed_time_us);
+    else
+      UpdateBudgetWithElapsedTime(elapsed_time_ms);
   }
 
   time_last_update_us_ = now_us;
@@ -446,6 +340,7 @@ void PacedSender::Process() {
   bool is_probing = prober_->IsProbing();
   PacedPacketInfo pacing_info;
   size_t bytes_sent = 0;
+  int packets_sent = 0;
   size_t recommended_probe_size = 0;
   if (is_probing) {
     pacing_info = prober_->CurrentCluster();
@@ -459,9 +354,12 @@ void PacedSender::Process() {
 
     if (SendPacket(packet, pacing_info)) {
       // Send succeeded, remove it from the queue.
+      int64_t now_ms = clock_->TimeInMilliseconds();
       if (first_sent_packet_ms_ == -1)
-        first_sent_packet_ms_ = clock_->TimeInMilliseconds();
+        first_sent_packet_ms_ = now_ms;
       bytes_sent += packet.bytes;
+      ++packets_sent;
+      UpdateQueueDelayStats(packet, now_ms);
       packets_->FinalizePop(packet);
       if (is_probing && bytes_sent > recommended_probe_size)
         break;
@@ -472,6 +370,18 @@ void PacedSender::Process() {
     }
   }
 
+  if (packets_sent > 0) {
+    ++stats_.num_bursts;
+    stats_.num_burst_packets += packets_sent;
+    stats_.max_burst_packets =
+        std::max<int64_t>(stats_.max_burst_packets, packets_sent);
+    RTC_HISTOGRAM_COUNTS_1000("WebRTC.Pacer.PacketsPerProcess", packets_sent);
+  }
+  if (!packets_->Empty() && !is_probing &&
+      media_budget_->bytes_remaining() == 0) {
+    ++stats_.num_budget_underruns;
+  }
+
   if (packets_->Empty()) {
     // We can not send padding unless a normal packet has first been sent. If we
     // do, timestamps get messed up.
@@ -519,6 +429,10 @@ bool PacedSender::SendPacket(const paced_sender::Packet& packet,
       // situations where nothing actually ended up being sent to the network,
       // and we probably don't want to update the budget in such cases.
       // https://bugs.chromium.org/p/webrtc/issues/detail?id=8052
+      if (pacing_info.probe_cluster_id == PacedPacketInfo::kNotAProbe &&
+          packet.bytes > media_budget_->bytes_remaining()) {
+        ++stats_.num_budget_overruns;
+      }
       UpdateBudgetWithBytesSent(packet.bytes);
     }
   }
@@ -540,24 +454,68 @@ size_t PacedSender::SendPadding(size_t padding_needed,
   return bytes_sent;
 }
 
+void PacedSender::UpdateQueueDelayStats(const paced_sender::Packet& packet,
+                                        int64_t now_ms) {
+  const int64_t queue_delay_ms = now_ms - packet.enqueue_time_ms;
+  Stats::QueueDelay* queue_delay = nullptr;
+  switch (packet.priority) {
+    case kHighPriority:
+      queue_delay = &stats_.high_priority_queue_delay;
+      RTC_HISTOGRAM_COUNTS_10000("WebRTC.Pacer.QueueDelayInMs.HighPriority",
+                                 queue_delay_ms);
+      break;
+    case kNormalPriority:
+      queue_delay = &stats_.normal_priority_queue_delay;
+      RTC_HISTOGRAM_COUNTS_10000("WebRTC.Pacer.QueueDelayInMs.NormalPriority",
+                                 queue_delay_ms);
+      break;
+    case kLowPriority:
+      queue_delay = &stats_.low_priority_queue_delay;
+      RTC_HISTOGRAM_COUNTS_10000("WebRTC.Pacer.QueueDelayInMs.LowPriority",
+                                 queue_delay_ms);
+      break;
+  }
+  RTC_DCHECK(queue_delay);
+  ++queue_delay->num_packets;
+  queue_delay->total_ms += queue_delay_ms;
+  queue_delay->max_ms = std::max(queue_delay->max_ms, queue_delay_ms);
+}
+
 void PacedSender::UpdateBudgetWithElapsedTime(int64_t delta_time_ms) {
   media_budget_->IncreaseBudget(delta_time_ms);
   padding_budget_->IncreaseBudget(delta_time_ms);
 }
 
+void PacedSender::UpdateBudgetWithElapsedTimeUs(int64_t delta_time_us) {
+  media_budget_->IncreaseBudgetUs(delta_time_us);
+  padding_budget_->IncreaseBudgetUs(delta_time_us);
+}
+
 void PacedSender::UpdateBudgetWithBytesSent(size_t bytes_sent) {
   media_budget_->UseBudget(bytes_sent);
   padding_budget_->UseBudget(bytes_sent);
 }
 
 void PacedSender::SetPacingFactor(float pacing_factor) {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   pacing_factor_ = pacing_factor;
 }
 
 void PacedSender::SetQueueTimeLimit(int limit_ms) {
-  rtc::CritScope cs(&critsect_);
+  rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
   queue_time_limit = limit_ms;
 }
 
+void PacedSender::SetLowLatencyMode(bool enabled) {
+  {
+    rtc::CritScope cs(&critsect_, RTC_FROM_HERE);
+    low_latency_mode_ = enabled;
+    alr_elapsed_time_us_ = 0;
+  }
+  // Tell the process thread to call our TimeUntilNextProcess() method to
+  // refresh the estimate for when to call Process().
+  if (process_thread_)
+    process_thread_->WakeUp(this);
+}
+
 }  // namespace webrtc
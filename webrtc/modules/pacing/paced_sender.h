@@ -69,6 +69,29 @@ class PacedSender : public Pacer {
   // overshoots from the encoder.
   static const float kDefaultPaceMultiplier;
 
+  // Counters of how packets have been paced out since creation.
+  struct Stats {
+    struct QueueDelay {
+      int64_t num_packets = 0;
+      int64_t total_ms = 0;
+      int64_t max_ms = 0;
+    };
+    // Time from insertion to being sent of the sent packets.
+    QueueDelay high_priority_queue_delay;
+    QueueDelay normal_priority_queue_delay;
+    QueueDelay low_priority_queue_delay;
+    // Number of Process() calls which sent media packets, and the number of
+    // packets they sent.
+    int64_t num_bursts = 0;
+    int64_t num_burst_packets = 0;
+    int64_t max_burst_packets = 0;
+    // Process() calls which left packets queued because the media budget was
+    // used up.
+    int64_t num_budget_underruns = 0;
+    // Packets larger than what was left of the media budget.
+    int64_t num_budget_overruns = 0;
+  };
+
   PacedSender(const Clock* clock,
               PacketSender* packet_sender,
               RtcEventLog* event_log);
@@ -140,10 +163,16 @@ class PacedSender : public Pacer {
   // paused. Returns 0 if queue is empty.
   virtual int64_t AverageQueueTimeMs();
 
+  virtual Stats GetStats() const;
+
   // Returns the number of milliseconds until the module want a worker thread
   // to call Process.
   int64_t TimeUntilNextProcess() override;
 
+  // Returns the number of microseconds until the module wants Process to be
+  // called, for timers with a finer resolution than a ProcessThread.
+  int64_t TimeUntilNextProcessUs();
+
   // Process any pending packets in the queue(s).
   void Process() override;
 
@@ -152,10 +181,21 @@ class PacedSender : public Pacer {
   void SetPacingFactor(float pacing_factor);
   void SetQueueTimeLimit(int limit_ms);
 
+  // In low-latency mode the budgets are updated with microsecond precision
+  // and each packet is released as soon as the budget allows it, rather than
+  // in bursts every 5 ms. This is best driven by a high-resolution timer
+  // using TimeUntilNextProcessUs(); a ProcessThread rounds up to whole
+  // milliseconds.
+  void SetLowLatencyMode(bool enabled);
+
  private:
+  int64_t LowLatencyTimeUntilNextProcessUs()
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   // Updates the number of bytes that can be sent for the next time interval.
   void UpdateBudgetWithElapsedTime(int64_t delta_time_in_ms)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void UpdateBudgetWithElapsedTimeUs(int64_t delta_time_in_us)
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void UpdateBudgetWithBytesSent(size_t bytes)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
@@ -164,6 +204,9 @@ class PacedSender : public Pacer {
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   size_t SendPadding(size_t padding_needed, const PacedPacketInfo& cluster_info)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void UpdateQueueDelayStats(const paced_sender::Packet& packet, int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void UpdateHistograms() EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   const Clock* const clock_;
   PacketSender* const packet_sender_;
@@ -197,6 +240,14 @@ class PacedSender : public Pacer {
 
   float pacing_factor_ GUARDED_BY(critsect_);
   int64_t queue_time_limit GUARDED_BY(critsect_);
+
+  bool low_latency_mode_ GUARDED_BY(critsect_);
+  // Elapsed time not yet reported to |alr_detector_|, which counts whole
+  // milliseconds, in low-latency mode.
+  int64_t alr_elapsed_time_us_ GUARDED_BY(critsect_);
+
+  const int64_t creation_time_ms_;
+  Stats stats_ GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_PACING_PACED_SENDER_H_
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+
+#include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace webrtc {
+namespace {
+constexpr int kPacketsPerFrame = 50;
+constexpr size_t kPacketSize = 1200;
+
+class CountingPacketSender : public PacedSender::PacketSender {
+ public:
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission,
+                        const PacedPacketInfo& cluster_info) override {
+    ++packets_sent_;
+    return true;
+  }
+  size_t TimeToSendPadding(size_t bytes,
+                           const PacedPacketInfo& cluster_info) override {
+    return 0;
+  }
+
+  int packets_sent() const { return packets_sent_; }
+
+ private:
+  int packets_sent_ = 0;
+};
+}  // namespace
+
+// Enqueues the packets of a frame, and runs the pacer until all of them have
+// been sent.
+TEST(PacedSenderBenchmark, EnqueueAndSendFrame) {
+  SimulatedClock clock(123456);
+  CountingPacketSender packet_sender;
+  PacedSender pacer(&clock, &packet_sender, nullptr);
+  pacer.SetProbingEnabled(false);
+  pacer.SetEstimatedBitrate(100000000);
+
+  uint16_t sequence_number = 0;
+  int packets_inserted = 0;
+  test::RunBenchmark(
+      "PacedSender_EnqueueAndSendFrame", kPacketsPerFrame * kPacketSize, [&] {
+        for (int i = 0; i < kPacketsPerFrame; ++i) {
+          pacer.InsertPacket(PacedSender::kNormalPriority, 12345,
+                             sequence_number++, clock.TimeInMilliseconds(),
+                             kPacketSize, false);
+        }
+        packets_inserted += kPacketsPerFrame;
+        while (pacer.QueueSizePackets() > 0) {
+          clock.AdvanceTimeMilliseconds(
+              std::max<int64_t>(1, pacer.TimeUntilNextProcess()));
+          pacer.Process();
+        }
+      });
+  EXPECT_EQ(packets_inserted, packet_sender.packets_sent());
+}
+
+}  // namespace webrtc
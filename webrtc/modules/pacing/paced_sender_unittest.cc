@@ -10,11 +10,14 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 using testing::_;
 using testing::Field;
@@ -1102,6 +1105,99 @@ TEST_F(PacedSenderTest, AvoidBusyLoopOnSendFailure) {
   EXPECT_EQ(5, send_bucket_->TimeUntilNextProcess());
 }
 
+TEST_F(PacedSenderTest, LowLatencyModeReleasesPacketsOneByOne) {
+  uint32_t ssrc = 12346;
+  uint16_t sequence_number = 1234;
+  // At the pacing rate, a packet takes one millisecond to send.
+  const size_t kPacketSize = static_cast<size_t>(
+      kTargetBitrateBps * PacedSender::kDefaultPaceMultiplier / 8000);
+  const size_t kNumPackets = 20;
+
+  send_bucket_->SetLowLatencyMode(true);
+  send_bucket_->Process();
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                               sequence_number++, clock_.TimeInMilliseconds(),
+                               kPacketSize, false);
+  }
+
+  std::vector<int64_t> send_times_us;
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false, _))
+      .Times(kNumPackets)
+      .WillRepeatedly(testing::Invoke(
+          [this, &send_times_us](uint32_t, uint16_t, int64_t, bool,
+                                 const PacedPacketInfo&) {
+            send_times_us.push_back(clock_.TimeInMicroseconds());
+            return true;
+          }));
+  EXPECT_CALL(callback_, TimeToSendPadding(_, _)).WillRepeatedly(Return(0));
+  const int64_t start_time_us = clock_.TimeInMicroseconds();
+  while (send_times_us.size() < kNumPackets &&
+         clock_.TimeInMicroseconds() - start_time_us < 100000) {
+    const int64_t time_until_process_us =
+        send_bucket_->TimeUntilNextProcessUs();
+    EXPECT_LE(time_until_process_us, 5000);
+    clock_.AdvanceTimeMicroseconds(time_until_process_us);
+    send_bucket_->Process();
+  }
+
+  ASSERT_EQ(kNumPackets, send_times_us.size());
+  // Rather than bursts every 5 ms, the packets go out about a millisecond
+  // apart.
+  for (size_t i = 1; i < kNumPackets; ++i) {
+    EXPECT_GE(send_times_us[i] - send_times_us[i - 1], 750);
+    EXPECT_LE(send_times_us[i] - send_times_us[i - 1], 1250);
+  }
+}
+
+TEST_F(PacedSenderTest, ReportsQueueDelayAndBudgetStats) {
+  const uint32_t kSsrc = 12345;
+  uint16_t sequence_number = 1234;
+  // Due to the multiplicative factor we can send 5 packets of 250 bytes during
+  // a send interval.
+  const size_t kPacketsPerInterval =
+      kTargetBitrateBps * PacedSender::kDefaultPaceMultiplier / (8 * 250 * 200);
+  EXPECT_CALL(callback_, TimeToSendPacket(_, _, _, _, _))
+      .WillRepeatedly(Return(true));
+  send_bucket_->InsertPacket(PacedSender::kHighPriority, kSsrc,
+                             sequence_number++, clock_.TimeInMilliseconds(),
+                             250, false);
+  for (size_t i = 0; i < kPacketsPerInterval + 1; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, kSsrc,
+                               sequence_number++, clock_.TimeInMilliseconds(),
+                               250, false);
+  }
+  // The last normal priority packet doesn't fit in the media budget.
+  send_bucket_->Process();
+  EXPECT_EQ(1u, send_bucket_->QueueSizePackets());
+  clock_.AdvanceTimeMilliseconds(5);
+  send_bucket_->Process();
+  EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
+
+  // A packet larger than the media budget of an interval overruns it.
+  clock_.AdvanceTimeMilliseconds(5);
+  send_bucket_->InsertPacket(PacedSender::kLowPriority, kSsrc,
+                             sequence_number++, clock_.TimeInMilliseconds(),
+                             250 * kPacketsPerInterval + 1, false);
+  send_bucket_->Process();
+
+  PacedSender::Stats stats = send_bucket_->GetStats();
+  EXPECT_EQ(1, stats.high_priority_queue_delay.num_packets);
+  EXPECT_EQ(0, stats.high_priority_queue_delay.max_ms);
+  EXPECT_EQ(static_cast<int64_t>(kPacketsPerInterval + 1),
+            stats.normal_priority_queue_delay.num_packets);
+  EXPECT_EQ(5, stats.normal_priority_queue_delay.total_ms);
+  EXPECT_EQ(5, stats.normal_priority_queue_delay.max_ms);
+  EXPECT_EQ(1, stats.low_priority_queue_delay.num_packets);
+  EXPECT_EQ(3, stats.num_bursts);
+  EXPECT_EQ(static_cast<int64_t>(kPacketsPerInterval + 3),
+            stats.num_burst_packets);
+  EXPECT_EQ(static_cast<int64_t>(kPacketsPerInterval + 1),
+            stats.max_burst_packets);
+  EXPECT_EQ(1, stats.num_budget_underruns);
+  EXPECT_EQ(1, stats.num_budget_overruns);
+}
+
 TEST_F(PacedSenderTest, QueueTimeWithPause) {
   const size_t kPacketSize = 1200;
   const uint32_t kSsrc = 12346;
@@ -1162,6 +1258,43 @@ TEST_F(PacedSenderTest, QueueTimePausedDuringPush) {
   EXPECT_EQ(150, send_bucket_->AverageQueueTimeMs());
 }
 
+// Paces out 50 Mbps of video over three streams, with some retransmissions,
+// and measures the CPU time spent per packet.
+TEST(PacedSenderPerfTest, DISABLED_PacingThroughputPerf) {
+  const int kBitrateBps = 50000000;
+  const size_t kPacketSize = 1200;
+  const int kSimulatedSeconds = 60;
+  const int kPacketsPerProcess =
+      static_cast<int>(kBitrateBps / 8 / kPacketSize / 200);
+  SimulatedClock clock(123456);
+  PacedSenderPadding callback;
+  PacedSender pacer(&clock, &callback, nullptr);
+  pacer.SetProbingEnabled(false);
+  pacer.SetEstimatedBitrate(kBitrateBps);
+
+  uint16_t sequence_numbers[3] = {0, 0, 0};
+  int num_packets = 0;
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kSimulatedSeconds * 200; ++i) {
+    for (int j = 0; j < kPacketsPerProcess; ++j) {
+      const int stream = j % 3;
+      pacer.InsertPacket(PacedSender::kNormalPriority, 1000 + stream,
+                         sequence_numbers[stream]++,
+                         clock.TimeInMilliseconds(), kPacketSize, j % 20 == 0);
+      ++num_packets;
+    }
+    clock.AdvanceTimeMilliseconds(5);
+    pacer.Process();
+  }
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  EXPECT_LT(pacer.QueueSizePackets(), static_cast<size_t>(kPacketsPerProcess));
+
+  webrtc::test::PrintResult(
+      "paced_sender", "", "50mbps",
+      static_cast<size_t>(elapsed_us * 1000 / num_packets), "ns/packet",
+      false);
+}
+
 // TODO(sprang): Extract PacketQueue from PacedSender so that we can test
 // removing elements while paused. (This is possible, but only because of semi-
 // racy condition so can't easily be tested).
@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/pacing/packet_queue.h"
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace paced_sender {
+
+PacketQueue::Stream::Stream(uint32_t ssrc)
+    : ssrc(ssrc), queued_sequence_numbers((1 << 16) / 64) {}
+
+PacketQueue::PacketQueue(const Clock* clock)
+    : num_stored_(0),
+      num_queued_(0),
+      class_size_(),
+      bytes_(0),
+      clock_(clock),
+      queue_time_sum_(0),
+      time_last_updated_(clock_->TimeInMilliseconds()),
+      paused_(false),
+      paused_ms_(0) {}
+
+PacketQueue::~PacketQueue() {}
+
+void PacketQueue::Push(const Packet& packet) {
+  Stream* stream = GetStream(packet.ssrc);
+  uint64_t& word = stream->queued_sequence_numbers[packet.sequence_number / 64];
+  const uint64_t bit = uint64_t{1} << (packet.sequence_number % 64);
+  if (word & bit)
+    return;  // Duplicate.
+  word |= bit;
+
+  UpdateQueueTime(packet.enqueue_time_ms);
+
+  uint32_t slot;
+  if (free_slots_.empty()) {
+    slot = static_cast<uint32_t>(storage_.size());
+    storage_.push_back(packet);
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    storage_[slot] = packet;
+  }
+  Packet& stored = storage_[slot];
+  stored.slot = slot;
+  stored.stored = true;
+  stored.paused_ms_at_enqueue = paused_ms_;
+  ++num_stored_;
+  bytes_ += packet.bytes;
+  enqueue_fifo_.push_back(std::make_pair(slot, packet.enqueue_order));
+
+  // Almost always appends, since capture times of a stream's packets grow.
+  Ring<uint32_t>& queue = stream->queues[ClassOf(stored)];
+  size_t pos = queue.size();
+  while (pos > 0 && SendsBefore(slot, queue[pos - 1]))
+    --pos;
+  queue.insert(pos, slot);
+  ++class_size_[ClassOf(stored)];
+  ++num_queued_;
+}
+
+const Packet& PacketQueue::BeginPop() {
+  RTC_DCHECK(!Empty());
+  int packet_class = 0;
+  while (class_size_[packet_class] == 0)
+    ++packet_class;
+
+  Ring<uint32_t>* best = nullptr;
+  for (const auto& stream : streams_) {
+    Ring<uint32_t>* queue = &stream->queues[packet_class];
+    if (!queue->empty() &&
+        (!best || SendsBefore(queue->front(), best->front()))) {
+      best = queue;
+    }
+  }
+  RTC_DCHECK(best);
+  const uint32_t slot = best->front();
+  best->pop_front();
+  --class_size_[packet_class];
+  --num_queued_;
+  return storage_[slot];
+}
+
+void PacketQueue::CancelPop(const Packet& packet) {
+  RTC_DCHECK(packet.stored);
+  const int packet_class = ClassOf(packet);
+  Ring<uint32_t>& queue = GetStream(packet.ssrc)->queues[packet_class];
+  // The packet was the head of its queue, and normally still sorts first.
+  if (queue.empty() || SendsBefore(packet.slot, queue.front())) {
+    queue.push_front(packet.slot);
+  } else {
+    size_t pos = queue.size();
+    while (pos > 0 && SendsBefore(packet.slot, queue[pos - 1]))
+      --pos;
+    queue.insert(pos, packet.slot);
+  }
+  ++class_size_[packet_class];
+  ++num_queued_;
+}
+
+void PacketQueue::FinalizePop(const Packet& packet) {
+  RTC_DCHECK(packet.stored);
+  Stream* stream = GetStream(packet.ssrc);
+  stream->queued_sequence_numbers[packet.sequence_number / 64] &=
+      ~(uint64_t{1} << (packet.sequence_number % 64));
+
+  bytes_ -= packet.bytes;
+  int64_t packet_queue_time_ms = time_last_updated_ - packet.enqueue_time_ms;
+  const int64_t packet_paused_ms = paused_ms_ - packet.paused_ms_at_enqueue;
+  RTC_DCHECK_LE(packet_paused_ms, packet_queue_time_ms);
+  packet_queue_time_ms -= packet_paused_ms;
+  RTC_DCHECK_LE(packet_queue_time_ms, queue_time_sum_);
+  queue_time_sum_ -= packet_queue_time_ms;
+
+  storage_[packet.slot].stored = false;
+  free_slots_.push_back(packet.slot);
+  --num_stored_;
+  while (!enqueue_fifo_.empty()) {
+    const Packet& oldest = storage_[enqueue_fifo_.front().first];
+    if (oldest.stored && oldest.enqueue_order == enqueue_fifo_.front().second)
+      break;
+    enqueue_fifo_.pop_front();
+  }
+  if (num_stored_ == 0)
+    RTC_DCHECK_EQ(0, queue_time_sum_);
+}
+
+int64_t PacketQueue::OldestEnqueueTimeMs() const {
+  if (enqueue_fifo_.empty())
+    return 0;
+  return storage_[enqueue_fifo_.front().first].enqueue_time_ms;
+}
+
+void PacketQueue::UpdateQueueTime(int64_t timestamp_ms) {
+  RTC_DCHECK_GE(timestamp_ms, time_last_updated_);
+  if (timestamp_ms == time_last_updated_)
+    return;
+
+  int64_t delta_ms = timestamp_ms - time_last_updated_;
+
+  if (paused_) {
+    // Accumulate the time spent paused, so that popped packets can disregard
+    // it when subtracting from the main accumulator.
+    paused_ms_ += delta_ms;
+  } else {
+    // Use the number of stored packets, not just queued ones, as there might
+    // be an outstanding packet popped currently in the SendPacket() call.
+    queue_time_sum_ += delta_ms * num_stored_;
+  }
+  time_last_updated_ = timestamp_ms;
+}
+
+void PacketQueue::SetPauseState(bool paused, int64_t timestamp_ms) {
+  if (paused_ == paused)
+    return;
+  UpdateQueueTime(timestamp_ms);
+  paused_ = paused;
+}
+
+int64_t PacketQueue::AverageQueueTimeMs() const {
+  if (Empty())
+    return 0;
+  return queue_time_sum_ / num_stored_;
+}
+
+// static
+int PacketQueue::ClassOf(const Packet& packet) {
+  int priority_index;
+  switch (packet.priority) {
+    case RtpPacketSender::kHighPriority:
+      priority_index = 0;
+      break;
+    case RtpPacketSender::kNormalPriority:
+      priority_index = 1;
+      break;
+    default:
+      RTC_DCHECK_EQ(RtpPacketSender::kLowPriority, packet.priority);
+      priority_index = 2;
+      break;
+  }
+  return 2 * priority_index + (packet.retransmission ? 0 : 1);
+}
+
+bool PacketQueue::SendsBefore(uint32_t slot, uint32_t other_slot) const {
+  const Packet& packet = storage_[slot];
+  const Packet& other = storage_[other_slot];
+  // Older frames have higher prio.
+  if (packet.capture_time_ms != other.capture_time_ms)
+    return packet.capture_time_ms < other.capture_time_ms;
+  return packet.enqueue_order < other.enqueue_order;
+}
+
+PacketQueue::Stream* PacketQueue::GetStream(uint32_t ssrc) {
+  auto it = stream_by_ssrc_.find(ssrc);
+  if (it != stream_by_ssrc_.end())
+    return it->second;
+  streams_.emplace_back(new Stream(ssrc));
+  stream_by_ssrc_[ssrc] = streams_.back().get();
+  return streams_.back().get();
+}
+
+}  // namespace paced_sender
+}  // namespace webrtc
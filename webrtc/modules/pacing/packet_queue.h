@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_PACING_PACKET_QUEUE_H_
+#define WEBRTC_MODULES_PACING_PACKET_QUEUE_H_
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/rtc_base/constructormagic.h"
+
+namespace webrtc {
+class Clock;
+
+namespace paced_sender {
+
+struct Packet {
+  Packet(RtpPacketSender::Priority priority,
+         uint32_t ssrc,
+         uint16_t seq_number,
+         int64_t capture_time_ms,
+         int64_t enqueue_time_ms,
+         size_t length_in_bytes,
+         bool retransmission,
+         uint64_t enqueue_order)
+      : priority(priority),
+        ssrc(ssrc),
+        sequence_number(seq_number),
+        capture_time_ms(capture_time_ms),
+        enqueue_time_ms(enqueue_time_ms),
+        bytes(length_in_bytes),
+        retransmission(retransmission),
+        enqueue_order(enqueue_order) {}
+
+  RtpPacketSender::Priority priority;
+  uint32_t ssrc;
+  uint16_t sequence_number;
+  int64_t capture_time_ms;  // Absolute time of frame capture.
+  int64_t enqueue_time_ms;  // Absolute time of pacer queue entry.
+  size_t bytes;
+  bool retransmission;
+  uint64_t enqueue_order;
+  // Total paused time of the queue when the packet was enqueued.
+  int64_t paused_ms_at_enqueue = 0;
+  // Handle for direct access to the packet's storage slot.
+  uint32_t slot = 0;
+  bool stored = false;
+};
+
+// Queue of the packets waiting in the pacer. Packets are sent in order of
+// priority, with retransmissions before new packets of the same priority,
+// then oldest capture time first and finally in insertion order.
+//
+// Each SSRC has one ring buffer per (priority, retransmission) class, sorted
+// by capture time. Packets of a stream almost always arrive in capture order,
+// so pushing is O(1); popping picks the best head among the streams of the
+// highest non-empty class. Packets are stored in recycled slots and duplicates
+// are detected with one bit per sequence number, so nothing is allocated per
+// packet once the queue has reached its working size.
+class PacketQueue {
+ public:
+  explicit PacketQueue(const Clock* clock);
+  virtual ~PacketQueue();
+
+  // Adds |packet| unless a packet with the same SSRC and sequence number is
+  // already queued.
+  void Push(const Packet& packet);
+
+  // Removes the next packet to send from the send order. It stays in the queue
+  // (and the returned reference stays valid, even across Push() calls) until
+  // FinalizePop(), or is put back by CancelPop().
+  const Packet& BeginPop();
+  void CancelPop(const Packet& packet);
+  void FinalizePop(const Packet& packet);
+
+  bool Empty() const { return num_queued_ == 0; }
+  size_t SizeInPackets() const { return num_queued_; }
+  uint64_t SizeInBytes() const { return bytes_; }
+
+  int64_t OldestEnqueueTimeMs() const;
+
+  void UpdateQueueTime(int64_t timestamp_ms);
+  void SetPauseState(bool paused, int64_t timestamp_ms);
+  int64_t AverageQueueTimeMs() const;
+
+ private:
+  // Growable ring buffer; storage is only reallocated when it is full.
+  template <typename T>
+  class Ring {
+   public:
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) {
+      return buffer_[(head_ + i) & (buffer_.size() - 1)];
+    }
+    const T& operator[](size_t i) const {
+      return buffer_[(head_ + i) & (buffer_.size() - 1)];
+    }
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+
+    void push_back(const T& value) {
+      if (size_ == buffer_.size())
+        Grow();
+      ++size_;
+      (*this)[size_ - 1] = value;
+    }
+    void push_front(const T& value) {
+      if (size_ == buffer_.size())
+        Grow();
+      head_ = (head_ - 1) & (buffer_.size() - 1);
+      ++size_;
+      (*this)[0] = value;
+    }
+    void pop_front() {
+      head_ = (head_ + 1) & (buffer_.size() - 1);
+      --size_;
+    }
+    void insert(size_t pos, const T& value) {
+      push_back(value);
+      for (size_t i = size_ - 1; i > pos; --i)
+        (*this)[i] = (*this)[i - 1];
+      (*this)[pos] = value;
+    }
+
+   private:
+    void Grow() {
+      std::vector<T> buffer(std::max<size_t>(8, 2 * buffer_.size()));
+      for (size_t i = 0; i < size_; ++i)
+        buffer[i] = (*this)[i];
+      buffer_.swap(buffer);
+      head_ = 0;
+    }
+
+    // Size is always a power of two.
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+  };
+
+  // Priorities high, normal and low, each with retransmissions first.
+  static const int kNumClasses = 6;
+
+  struct Stream {
+    explicit Stream(uint32_t ssrc);
+
+    const uint32_t ssrc;
+    // One bit per sequence number currently in the queue.
+    std::vector<uint64_t> queued_sequence_numbers;
+    // Storage slots of the queued packets, sorted by send order.
+    Ring<uint32_t> queues[kNumClasses];
+  };
+
+  static int ClassOf(const Packet& packet);
+  // Send order of two packets with the same class.
+  bool SendsBefore(uint32_t slot, uint32_t other_slot) const;
+  Stream* GetStream(uint32_t ssrc);
+
+  // Packets are never moved once stored, so that references returned by
+  // BeginPop() stay valid. Free slots are reused.
+  std::deque<Packet> storage_;
+  std::vector<uint32_t> free_slots_;
+  // Number of stored packets, including popped ones not yet finalized.
+  size_t num_stored_;
+  // Number of packets in the send order.
+  size_t num_queued_;
+  size_t class_size_[kNumClasses];
+
+  std::vector<std::unique_ptr<Stream>> streams_;
+  std::unordered_map<uint32_t, Stream*> stream_by_ssrc_;
+  // (slot, enqueue order) of stored packets, oldest first, for
+  // OldestEnqueueTimeMs(). Entries of removed packets are dropped lazily.
+  Ring<std::pair<uint32_t, uint64_t>> enqueue_fifo_;
+
+  // Total number of bytes in the queue.
+  uint64_t bytes_;
+  const Clock* const clock_;
+  int64_t queue_time_sum_;
+  int64_t time_last_updated_;
+  bool paused_;
+  // Total time spent paused, for excluding it from the packets' queue time.
+  int64_t paused_ms_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PacketQueue);
+};
+
+}  // namespace paced_sender
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_PACING_PACKET_QUEUE_H_
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/pacing/packet_queue.h"
+
+#include <vector>
+
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace paced_sender {
+namespace {
+
+constexpr size_t kPacketSize = 1200;
+
+class PacketQueueTest : public ::testing::Test {
+ protected:
+  PacketQueueTest() : clock_(123456), queue_(&clock_) {}
+
+  void Push(RtpPacketSender::Priority priority,
+            uint32_t ssrc,
+            uint16_t sequence_number,
+            int64_t capture_time_ms,
+            bool retransmission) {
+    queue_.Push(Packet(priority, ssrc, sequence_number, capture_time_ms,
+                       clock_.TimeInMilliseconds(), kPacketSize,
+                       retransmission, enqueue_order_++));
+  }
+
+  // Pops all packets, returning their sequence numbers in send order.
+  std::vector<uint16_t> PopAll() {
+    std::vector<uint16_t> sequence_numbers;
+    while (!queue_.Empty()) {
+      const Packet& packet = queue_.BeginPop();
+      sequence_numbers.push_back(packet.sequence_number);
+      queue_.FinalizePop(packet);
+    }
+    return sequence_numbers;
+  }
+
+  SimulatedClock clock_;
+  PacketQueue queue_;
+  uint64_t enqueue_order_ = 0;
+};
+
+}  // namespace
+
+TEST_F(PacketQueueTest, EmptyQueue) {
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(0u, queue_.SizeInPackets());
+  EXPECT_EQ(0u, queue_.SizeInBytes());
+  EXPECT_EQ(0, queue_.OldestEnqueueTimeMs());
+  EXPECT_EQ(0, queue_.AverageQueueTimeMs());
+}
+
+TEST_F(PacketQueueTest, SendOrder) {
+  const int64_t now = clock_.TimeInMilliseconds();
+  Push(RtpPacketSender::kLowPriority, 1, 1, now, false);
+  Push(RtpPacketSender::kNormalPriority, 2, 2, now, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 3, now - 10, false);
+  Push(RtpPacketSender::kNormalPriority, 2, 4, now, true);
+  Push(RtpPacketSender::kHighPriority, 3, 5, now, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 6, now, false);
+  EXPECT_EQ(6u, queue_.SizeInPackets());
+  EXPECT_EQ(6 * kPacketSize, queue_.SizeInBytes());
+
+  // Priority first, then retransmissions, capture time and insertion order.
+  EXPECT_EQ(std::vector<uint16_t>({5, 4, 3, 2, 6, 1}), PopAll());
+  EXPECT_EQ(0u, queue_.SizeInBytes());
+}
+
+TEST_F(PacketQueueTest, OutOfOrderCaptureTimesWithinStream) {
+  const int64_t now = clock_.TimeInMilliseconds();
+  Push(RtpPacketSender::kNormalPriority, 1, 1, now - 10, true);
+  Push(RtpPacketSender::kNormalPriority, 1, 2, now - 30, true);
+  Push(RtpPacketSender::kNormalPriority, 1, 3, now - 20, true);
+  Push(RtpPacketSender::kNormalPriority, 1, 4, now - 30, true);
+  EXPECT_EQ(std::vector<uint16_t>({2, 4, 3, 1}), PopAll());
+}
+
+TEST_F(PacketQueueTest, DropsDuplicatesPerSsrc) {
+  const int64_t now = clock_.TimeInMilliseconds();
+  Push(RtpPacketSender::kNormalPriority, 1, 100, now, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 100, now, true);
+  Push(RtpPacketSender::kNormalPriority, 2, 100, now, false);
+  EXPECT_EQ(2u, queue_.SizeInPackets());
+  PopAll();
+
+  // Once sent, the same sequence number can be queued again.
+  Push(RtpPacketSender::kNormalPriority, 1, 100, now, true);
+  EXPECT_EQ(1u, queue_.SizeInPackets());
+}
+
+TEST_F(PacketQueueTest, CancelPopRestoresOrder) {
+  const int64_t now = clock_.TimeInMilliseconds();
+  Push(RtpPacketSender::kNormalPriority, 1, 1, now, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 2, now, false);
+
+  const Packet& packet = queue_.BeginPop();
+  EXPECT_EQ(1, packet.sequence_number);
+  EXPECT_EQ(1u, queue_.SizeInPackets());
+  // Packets pushed while one is being sent must not invalidate it.
+  for (uint16_t i = 0; i < 1000; ++i)
+    Push(RtpPacketSender::kNormalPriority, 2, i, now + 1, false);
+  EXPECT_EQ(1, packet.sequence_number);
+  queue_.CancelPop(packet);
+  EXPECT_EQ(1002u, queue_.SizeInPackets());
+
+  std::vector<uint16_t> order = PopAll();
+  ASSERT_EQ(1002u, order.size());
+  EXPECT_EQ(1, order[0]);
+  EXPECT_EQ(2, order[1]);
+}
+
+TEST_F(PacketQueueTest, OldestEnqueueTime) {
+  const int64_t start = clock_.TimeInMilliseconds();
+  Push(RtpPacketSender::kLowPriority, 1, 1, start, false);
+  clock_.AdvanceTimeMilliseconds(10);
+  Push(RtpPacketSender::kHighPriority, 1, 2, start, false);
+  EXPECT_EQ(start, queue_.OldestEnqueueTimeMs());
+
+  // The high priority packet goes first; the oldest is still queued.
+  const Packet& packet = queue_.BeginPop();
+  EXPECT_EQ(2, packet.sequence_number);
+  queue_.FinalizePop(packet);
+  EXPECT_EQ(start, queue_.OldestEnqueueTimeMs());
+  PopAll();
+  EXPECT_EQ(0, queue_.OldestEnqueueTimeMs());
+}
+
+TEST_F(PacketQueueTest, QueueTimeExcludesPausedTime) {
+  const int64_t now = clock_.TimeInMilliseconds();
+  Push(RtpPacketSender::kNormalPriority, 1, 1, now, false);
+  clock_.AdvanceTimeMilliseconds(100);
+  queue_.SetPauseState(true, clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(100);
+  Push(RtpPacketSender::kNormalPriority, 1, 2, now, false);
+  clock_.AdvanceTimeMilliseconds(100);
+  queue_.SetPauseState(false, clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(50);
+  queue_.UpdateQueueTime(clock_.TimeInMilliseconds());
+  // (150 + 50) / 2.
+  EXPECT_EQ(100, queue_.AverageQueueTimeMs());
+
+  PopAll();
+  EXPECT_EQ(0, queue_.AverageQueueTimeMs());
+}
+
+// Keeps about one frame of packets for each of three simulcast streams and
+// their retransmissions in the queue while pushing and popping.
+TEST_F(PacketQueueTest, DISABLED_PushPopPerf) {
+  const int kNumPackets = 2000000;
+  const int kPacketsInQueue = 300;
+  const uint32_t kSsrcs[] = {1111, 2222, 3333};
+  uint16_t sequence_numbers[3] = {0, 0, 0};
+
+  int64_t start_us = rtc::TimeMicros();
+  int64_t capture_time_ms = clock_.TimeInMilliseconds();
+  for (int i = 0; i < kNumPackets; ++i) {
+    if (i % 100 == 0)
+      clock_.AdvanceTimeMilliseconds(1);
+    if (i % 30 == 0)
+      ++capture_time_ms;
+    const int stream = i % 3;
+    const bool retransmission = i % 20 == 0;
+    Push(RtpPacketSender::kNormalPriority, kSsrcs[stream],
+         sequence_numbers[stream]++, capture_time_ms, retransmission);
+    if (queue_.SizeInPackets() > kPacketsInQueue) {
+      const Packet& packet = queue_.BeginPop();
+      queue_.FinalizePop(packet);
+    }
+  }
+  PopAll();
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+  webrtc::test::PrintResult(
+      "packet_queue", "", "push_pop",
+      static_cast<size_t>(int64_t{kNumPackets} * 1000 / elapsed_us),
+      "packets/ms", false);
+}
+
+}  // namespace paced_sender
+}  // namespace webrtc
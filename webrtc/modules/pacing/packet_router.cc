@@ -38,6 +38,7 @@ PacketRouter::PacketRouter()
 PacketRouter::~PacketRouter() {
   RTC_DCHECK(rtp_send_modules_.empty());
   RTC_DCHECK(rtp_receive_modules_.empty());
+  RTC_DCHECK(forwarded_streams_.empty());
   RTC_DCHECK(sender_remb_candidates_.empty());
   RTC_DCHECK(receiver_remb_candidates_.empty());
   RTC_DCHECK(active_remb_module_ == nullptr);
@@ -91,6 +92,20 @@ void PacketRouter::RemoveReceiveRtpModule(RtpRtcp* rtp_module) {
   rtp_receive_modules_.erase(it);
 }
 
+void PacketRouter::AddForwardedStream(
+    uint32_t ssrc,
+    PacedSender::PacketSender* packet_sender) {
+  rtc::CritScope cs(&modules_crit_);
+  RTC_DCHECK(forwarded_streams_.find(ssrc) == forwarded_streams_.end());
+  forwarded_streams_[ssrc] = packet_sender;
+}
+
+void PacketRouter::RemoveForwardedStream(uint32_t ssrc) {
+  rtc::CritScope cs(&modules_crit_);
+  size_t removed = forwarded_streams_.erase(ssrc);
+  RTC_DCHECK_EQ(removed, 1);
+}
+
 bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
                                     uint16_t sequence_number,
                                     int64_t capture_timestamp,
@@ -98,6 +113,12 @@ bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
                                     const PacedPacketInfo& pacing_info) {
   RTC_DCHECK_RUNS_SERIALIZED(&pacer_race_);
   rtc::CritScope cs(&modules_crit_);
+  auto forwarded_it = forwarded_streams_.find(ssrc);
+  if (forwarded_it != forwarded_streams_.end()) {
+    return forwarded_it->second->TimeToSendPacket(ssrc, sequence_number,
+                                                  capture_timestamp,
+                                                  retransmission, pacing_info);
+  }
   for (auto* rtp_module : rtp_send_modules_) {
     if (!rtp_module->SendingMedia())
       continue;
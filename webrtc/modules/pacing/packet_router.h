@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_PACING_PACKET_ROUTER_H_
 
 #include <list>
+#include <map>
 #include <vector>
 
 #include "webrtc/common_types.h"
@@ -62,6 +63,12 @@ class PacketRouter : public PacedSender::PacketSender,
     AddReceiveRtpModule(rtp_module, true);
   }
 
+  // Lets the pacer send the packets of |ssrc| through |packet_sender|, for
+  // streams which are forwarded rather than sent by an RTP module.
+  void AddForwardedStream(uint32_t ssrc,
+                          PacedSender::PacketSender* packet_sender);
+  void RemoveForwardedStream(uint32_t ssrc);
+
   // Implements PacedSender::Callback.
   bool TimeToSendPacket(uint32_t ssrc,
                         uint16_t sequence_number,
@@ -106,6 +113,8 @@ class PacketRouter : public PacedSender::PacketSender,
   rtc::CriticalSection modules_crit_;
   std::list<RtpRtcp*> rtp_send_modules_ GUARDED_BY(modules_crit_);
   std::vector<RtpRtcp*> rtp_receive_modules_ GUARDED_BY(modules_crit_);
+  std::map<uint32_t, PacedSender::PacketSender*> forwarded_streams_
+      GUARDED_BY(modules_crit_);
 
   // TODO(eladalon): remb_crit_ only ever held from one function, and it's not
   // clear if that function can actually be called from more than one thread.
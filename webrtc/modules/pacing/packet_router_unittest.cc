@@ -43,6 +43,18 @@ using ::testing::SaveArg;
 constexpr int kProbeMinProbes = 5;
 constexpr int kProbeMinBytes = 1000;
 
+class MockPacketSender : public PacedSender::PacketSender {
+ public:
+  MOCK_METHOD5(TimeToSendPacket,
+               bool(uint32_t ssrc,
+                    uint16_t sequence_number,
+                    int64_t capture_time_ms,
+                    bool retransmission,
+                    const PacedPacketInfo& pacing_info));
+  MOCK_METHOD2(TimeToSendPadding,
+               size_t(size_t bytes, const PacedPacketInfo& pacing_info));
+};
+
 class MockRtpRtcpWithRembTracking : public MockRtpRtcp {
  public:
   MockRtpRtcpWithRembTracking() {
@@ -304,6 +316,34 @@ TEST(PacketRouterTest, SenderOnlyFunctionsRespectSendingMedia) {
   packet_router.RemoveSendRtpModule(&rtp);
 }
 
+TEST(PacketRouterTest, TimeToSendPacketOfForwardedStream) {
+  PacketRouter packet_router;
+  NiceMock<MockRtpRtcp> rtp;
+  MockPacketSender forwarded_sender;
+  const uint32_t kSsrc = 1234;
+  const uint32_t kForwardedSsrc = 4567;
+  const uint16_t kSequenceNumber = 17;
+  const PacedPacketInfo paced_info(1, kProbeMinProbes, kProbeMinBytes);
+  ON_CALL(rtp, SSRC()).WillByDefault(Return(kSsrc));
+  ON_CALL(rtp, SendingMedia()).WillByDefault(Return(true));
+  packet_router.AddSendRtpModule(&rtp, false);
+  packet_router.AddForwardedStream(kForwardedSsrc, &forwarded_sender);
+
+  EXPECT_CALL(rtp, TimeToSendPacket(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(forwarded_sender,
+              TimeToSendPacket(kForwardedSsrc, kSequenceNumber, 1, true,
+                               Field(&PacedPacketInfo::probe_cluster_id, 1)))
+      .WillOnce(Return(false));
+  EXPECT_FALSE(packet_router.TimeToSendPacket(kForwardedSsrc, kSequenceNumber,
+                                              1, true, paced_info));
+
+  packet_router.RemoveForwardedStream(kForwardedSsrc);
+  EXPECT_CALL(forwarded_sender, TimeToSendPacket(_, _, _, _, _)).Times(0);
+  EXPECT_TRUE(packet_router.TimeToSendPacket(kForwardedSsrc, kSequenceNumber,
+                                             1, true, paced_info));
+  packet_router.RemoveSendRtpModule(&rtp);
+}
+
 TEST(PacketRouterTest, AllocateSequenceNumbers) {
   PacketRouter packet_router;
 
@@ -11,16 +11,21 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 
-#include <map>
+#include <vector>
 
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/rtc_base/basictypes.h"
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/optional.h"
 
 namespace webrtc {
 class Clock;
 struct PacketFeedback;
 
+// Keeps the sent packets awaiting transport feedback in a circular array
+// indexed by unwrapped transport sequence number. Since the sequence numbers
+// are dense, inserting and looking up a packet takes constant time and does
+// not allocate memory once the array has grown to fit the packets in flight.
 class SendTimeHistory {
  public:
   SendTimeHistory(const Clock* clock, int64_t packet_age_limit_ms);
@@ -42,10 +47,35 @@ class SendTimeHistory {
                              uint16_t remote_net_id) const;
 
  private:
+  using Slot = rtc::Optional<PacketFeedback>;
+
+  // Returns the slot for |unwrapped_seq_num|, which must be within
+  // [|first_seq_num_|, |end_seq_num_|).
+  Slot& SlotAt(int64_t unwrapped_seq_num);
+  const Slot& SlotAt(int64_t unwrapped_seq_num) const;
+
+  // Returns the packet with |unwrapped_seq_num|, or null if it is not in the
+  // history.
+  PacketFeedback* Find(int64_t unwrapped_seq_num);
+
+  // Removes all packets with sequence numbers before |unwrapped_seq_num|, as
+  // well as any empty slots at the front.
+  void RemoveBefore(int64_t unwrapped_seq_num);
+
+  // Makes room for |unwrapped_seq_num| and returns false if it can't be added.
+  bool MakeRoom(int64_t unwrapped_seq_num);
+
   const Clock* const clock_;
   const int64_t packet_age_limit_ms_;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+  // Circular array of packets with the sequence numbers in
+  // [|first_seq_num_|, |end_seq_num_|), at the index given by the sequence
+  // number modulo the size of the array, which is zero or a power of two.
+  // Slots of packets that were removed or never added are empty, and so are
+  // all slots outside of the range.
+  std::vector<Slot> history_;
+  int64_t first_seq_num_;
+  int64_t end_seq_num_;
   rtc::Optional<int64_t> latest_acked_seq_num_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendTimeHistory);
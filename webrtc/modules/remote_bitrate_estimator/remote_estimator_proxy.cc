@@ -29,6 +29,11 @@ const int RemoteEstimatorProxy::kMinSendIntervalMs = 50;
 const int RemoteEstimatorProxy::kMaxSendIntervalMs = 250;
 const int RemoteEstimatorProxy::kDefaultSendIntervalMs = 100;
 
+// The most packets kept for feedback. Older ones are dropped to make room.
+static constexpr size_t kMaxNumberOfPackets = 1 << 15;
+static constexpr size_t kMinCapacity = 128;
+static constexpr int64_t kNotReceived = -1;
+
 // The maximum allowed value for a timestamp in milliseconds. This is lower
 // than the numerical limit since we often convert to microseconds.
 static constexpr int64_t kMaxTimeMs =
@@ -42,6 +47,8 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(const Clock* clock,
       media_ssrc_(0),
       feedback_sequence_(0),
       window_start_seq_(-1),
+      first_seq_(0),
+      end_seq_(0),
       send_interval_ms_(kDefaultSendIntervalMs) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
@@ -130,16 +137,9 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     return;
   }
 
-  if (packet_arrival_times_.lower_bound(window_start_seq_) ==
-      packet_arrival_times_.end()) {
+  if (window_start_seq_ >= end_seq_) {
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
-    }
+    RemoveOldPackets(seq, arrival_time - kBackWindowMs);
   }
 
   if (window_start_seq_ == -1) {
@@ -148,11 +148,12 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     window_start_seq_ = seq;
   }
 
-  // We are only interested in the first time a packet is received.
-  if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
+  if (!MakeRoom(seq))
     return;
-
-  packet_arrival_times_[seq] = arrival_time;
+  // We are only interested in the first time a packet is received.
+  int64_t& packet_arrival_time = ArrivalTimeAt(seq);
+  if (packet_arrival_time == kNotReceived)
+    packet_arrival_time = arrival_time;
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
@@ -161,28 +162,33 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
   // feedback packet. Some older may still be in the map, in case a reordering
   // happens and we need to retransmit them.
   rtc::CritScope cs(&lock_);
-  auto it = packet_arrival_times_.lower_bound(window_start_seq_);
-  if (it == packet_arrival_times_.end()) {
+  int64_t seq = std::max(window_start_seq_, first_seq_);
+  while (seq < end_seq_ && ArrivalTimeAt(seq) == kNotReceived)
+    ++seq;
+  if (seq >= end_seq_) {
     // Feedback for all packets already sent.
     return false;
   }
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
-  const int64_t first_sequence = it->first;
+  const int64_t first_sequence = seq;
   feedback_packet->SetMediaSsrc(media_ssrc_);
   // Base sequence is the expected next (window_start_seq_). This is known, but
   // we might not have actually received it, so the base time shall be the time
   // of the first received packet in the feedback.
   feedback_packet->SetBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
-                           it->second * 1000);
+                           ArrivalTimeAt(seq) * 1000);
   feedback_packet->SetFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
-    if (!feedback_packet->AddReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+  for (; seq < end_seq_; ++seq) {
+    const int64_t arrival_time = ArrivalTimeAt(seq);
+    if (arrival_time == kNotReceived)
+      continue;
+    if (!feedback_packet->AddReceivedPacket(static_cast<uint16_t>(seq & 0xFFFF),
+                                            arrival_time * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK_NE(first_sequence, it->first);
+      RTC_CHECK_NE(first_sequence, seq);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
@@ -192,10 +198,64 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
     // Note: Don't erase items from packet_arrival_times_ after sending, in case
     // they need to be re-sent after a reordering. Removal will be handled
     // by OnPacketArrival once packets are too old.
-    window_start_seq_ = it->first + 1;
+    window_start_seq_ = seq + 1;
   }
 
   return true;
 }
 
+int64_t& RemoteEstimatorProxy::ArrivalTimeAt(int64_t seq) {
+  RTC_DCHECK_GE(seq, first_seq_);
+  RTC_DCHECK_LT(seq, end_seq_);
+  // The size is a power of two, so this is the index modulo the size also for
+  // negative sequence numbers.
+  return packet_arrival_times_[static_cast<uint64_t>(seq) &
+                               (packet_arrival_times_.size() - 1)];
+}
+
+void RemoteEstimatorProxy::RemoveOldPackets(int64_t seq,
+                                            int64_t arrival_time_limit) {
+  for (; first_seq_ < end_seq_; ++first_seq_) {
+    int64_t& arrival_time = ArrivalTimeAt(first_seq_);
+    if (arrival_time != kNotReceived &&
+        (first_seq_ >= seq || arrival_time > arrival_time_limit)) {
+      break;
+    }
+    arrival_time = kNotReceived;
+  }
+}
+
+bool RemoteEstimatorProxy::MakeRoom(int64_t seq) {
+  if (seq >= end_seq_) {
+    RemoveOldPackets(seq + 1 - static_cast<int64_t>(kMaxNumberOfPackets),
+                     std::numeric_limits<int64_t>::max());
+  }
+  if (first_seq_ == end_seq_) {
+    first_seq_ = end_seq_ = seq;
+  } else if (seq < first_seq_ &&
+             end_seq_ - seq > static_cast<int64_t>(kMaxNumberOfPackets)) {
+    LOG(LS_WARNING) << "Skipping sequence number " << seq
+                    << " since it is too old.";
+    return false;
+  }
+
+  const int64_t first_seq = std::min(first_seq_, seq);
+  const int64_t end_seq = std::max(end_seq_, seq + 1);
+  const size_t size = static_cast<size_t>(end_seq - first_seq);
+  if (size > packet_arrival_times_.size()) {
+    size_t capacity = std::max(kMinCapacity, packet_arrival_times_.size());
+    while (capacity < size)
+      capacity *= 2;
+    std::vector<int64_t> arrival_times(capacity, kNotReceived);
+    for (int64_t i = first_seq_; i < end_seq_; ++i) {
+      arrival_times[static_cast<uint64_t>(i) & (capacity - 1)] =
+          ArrivalTimeAt(i);
+    }
+    packet_arrival_times_.swap(arrival_times);
+  }
+  first_seq_ = first_seq;
+  end_seq_ = end_seq;
+  return true;
+}
+
 }  // namespace webrtc
@@ -11,7 +11,6 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
 #include "webrtc/modules/include/module_common_types.h"
@@ -57,6 +56,18 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
       EXCLUSIVE_LOCKS_REQUIRED(&lock_);
   bool BuildFeedbackPacket(rtcp::TransportFeedback* feedback_packet);
 
+  // Returns the arrival time slot for |seq|, which must be within
+  // [|first_seq_|, |end_seq_|).
+  int64_t& ArrivalTimeAt(int64_t seq) EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+
+  // Removes the packets from the front that are before |seq| and arrived at
+  // or before |arrival_time_limit|, stopping at the first one that is not.
+  void RemoveOldPackets(int64_t seq, int64_t arrival_time_limit)
+      EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+
+  // Makes room for |seq| and returns false if it can't be added.
+  bool MakeRoom(int64_t seq) EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+
   const Clock* const clock_;
   PacketRouter* const packet_router_;
   int64_t last_process_time_ms_;
@@ -67,8 +78,14 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ GUARDED_BY(&lock_);
   int64_t window_start_seq_ GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+  // Circular array of the arrival times of the packets with the unwrapped
+  // sequence numbers in [|first_seq_|, |end_seq_|), at the index given by the
+  // sequence number modulo the size of the array, which is zero or a power of
+  // two. Packets that have not been received have a negative arrival time.
+  // The first and the last packet in the range have always been received.
+  std::vector<int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+  int64_t first_seq_ GUARDED_BY(&lock_);
+  int64_t end_seq_ GUARDED_BY(&lock_);
   int64_t send_interval_ms_ GUARDED_BY(&lock_);
 };
 
@@ -293,6 +293,31 @@ TEST_F(RemoteEstimatorProxyTest, RemovesTimestampsOutOfScope) {
   Process();
 }
 
+TEST_F(RemoteEstimatorProxyTest, SendsFeedbackForManyPacketsWithLoss) {
+  // Enough packets to grow the arrival time record a few times.
+  const int kNumPackets = 3000;
+  const uint16_t kFirstSeq = 1000;
+  std::vector<uint16_t> expected_sequence_numbers;
+  for (int i = 0; i < kNumPackets; ++i) {
+    if (i % 3 == 1)
+      continue;
+    const uint16_t seq = static_cast<uint16_t>(kFirstSeq + i);
+    IncomingPacket(seq, kBaseTimeMs + i / 10);
+    expected_sequence_numbers.push_back(seq);
+  }
+
+  std::vector<uint16_t> sequence_numbers;
+  EXPECT_CALL(router_, SendTransportFeedback(_))
+      .WillRepeatedly(
+          Invoke([&sequence_numbers](rtcp::TransportFeedback* feedback_packet) {
+            for (uint16_t seq : SequenceNumbers(*feedback_packet))
+              sequence_numbers.push_back(seq);
+            return true;
+          }));
+  Process();
+  EXPECT_EQ(expected_sequence_numbers, sequence_numbers);
+}
+
 TEST_F(RemoteEstimatorProxyTest, TimeUntilNextProcessIsZeroBeforeFirstProcess) {
   EXPECT_EQ(0, proxy_.TimeUntilNextProcess());
 }
@@ -10,40 +10,59 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/system_wrappers/include/clock.h"
 
 namespace webrtc {
 
+namespace {
+// The unwrapper can't tell sequence numbers more than half of the 16-bit range
+// behind the latest one from newer ones, so such packets can never be looked
+// up again.
+constexpr size_t kMaxHistorySize = 1 << 15;
+constexpr size_t kMinHistoryCapacity = 64;
+}  // namespace
+
 SendTimeHistory::SendTimeHistory(const Clock* clock,
                                  int64_t packet_age_limit_ms)
-    : clock_(clock), packet_age_limit_ms_(packet_age_limit_ms) {}
+    : clock_(clock),
+      packet_age_limit_ms_(packet_age_limit_ms),
+      first_seq_num_(0),
+      end_seq_num_(0) {}
 
 SendTimeHistory::~SendTimeHistory() {}
 
 void SendTimeHistory::AddAndRemoveOld(const PacketFeedback& packet) {
   int64_t now_ms = clock_->TimeInMilliseconds();
   // Remove old.
-  while (!history_.empty() &&
-         now_ms - history_.begin()->second.creation_time_ms >
-             packet_age_limit_ms_) {
+  for (; first_seq_num_ < end_seq_num_; ++first_seq_num_) {
+    Slot& slot = SlotAt(first_seq_num_);
+    if (slot && now_ms - slot->creation_time_ms <= packet_age_limit_ms_)
+      break;
     // TODO(sprang): Warn if erasing (too many) old items?
-    history_.erase(history_.begin());
+    slot.reset();
   }
 
   // Add new.
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(packet.sequence_number);
-  history_.insert(std::make_pair(unwrapped_seq_num, packet));
+  if (!MakeRoom(unwrapped_seq_num))
+    return;
+  Slot& slot = SlotAt(unwrapped_seq_num);
+  if (!slot)
+    slot.emplace(packet);
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = Find(unwrapped_seq_num);
+  if (!packet)
     return false;
-  it->second.send_time_ms = send_time_ms;
+  packet->send_time_ms = send_time_ms;
   return true;
 }
 
@@ -55,35 +74,100 @@ bool SendTimeHistory::GetFeedback(PacketFeedback* packet_feedback,
   latest_acked_seq_num_.emplace(
       std::max(unwrapped_seq_num, latest_acked_seq_num_.value_or(0)));
   RTC_DCHECK_GE(*latest_acked_seq_num_, 0);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = Find(unwrapped_seq_num);
+  if (!packet)
     return false;
 
   // Save arrival_time not to overwrite it.
   int64_t arrival_time_ms = packet_feedback->arrival_time_ms;
-  *packet_feedback = it->second;
+  *packet_feedback = *packet;
   packet_feedback->arrival_time_ms = arrival_time_ms;
 
-  if (remove)
-    history_.erase(it);
+  if (remove) {
+    SlotAt(unwrapped_seq_num).reset();
+    RemoveBefore(first_seq_num_);
+  }
   return true;
 }
 
 size_t SendTimeHistory::GetOutstandingBytes(uint16_t local_net_id,
                                             uint16_t remote_net_id) const {
   size_t outstanding_bytes = 0;
-  auto unacked_it = history_.begin();
+  int64_t unacked_seq_num = first_seq_num_;
   if (latest_acked_seq_num_) {
-    unacked_it = history_.lower_bound(*latest_acked_seq_num_);
+    unacked_seq_num = std::max(unacked_seq_num, *latest_acked_seq_num_);
   }
-  for (; unacked_it != history_.end(); ++unacked_it) {
-    if (unacked_it->second.local_net_id == local_net_id &&
-        unacked_it->second.remote_net_id == remote_net_id &&
-        unacked_it->second.send_time_ms >= 0) {
-      outstanding_bytes += unacked_it->second.payload_size;
+  for (; unacked_seq_num < end_seq_num_; ++unacked_seq_num) {
+    const Slot& slot = SlotAt(unacked_seq_num);
+    if (slot && slot->local_net_id == local_net_id &&
+        slot->remote_net_id == remote_net_id && slot->send_time_ms >= 0) {
+      outstanding_bytes += slot->payload_size;
     }
   }
   return outstanding_bytes;
 }
 
+SendTimeHistory::Slot& SendTimeHistory::SlotAt(int64_t unwrapped_seq_num) {
+  RTC_DCHECK_GE(unwrapped_seq_num, first_seq_num_);
+  RTC_DCHECK_LT(unwrapped_seq_num, end_seq_num_);
+  // The size is a power of two, so this is the index modulo the size also for
+  // negative sequence numbers.
+  return history_[static_cast<uint64_t>(unwrapped_seq_num) &
+                  (history_.size() - 1)];
+}
+
+const SendTimeHistory::Slot& SendTimeHistory::SlotAt(
+    int64_t unwrapped_seq_num) const {
+  return const_cast<SendTimeHistory*>(this)->SlotAt(unwrapped_seq_num);
+}
+
+PacketFeedback* SendTimeHistory::Find(int64_t unwrapped_seq_num) {
+  if (unwrapped_seq_num < first_seq_num_ || unwrapped_seq_num >= end_seq_num_)
+    return nullptr;
+  Slot& slot = SlotAt(unwrapped_seq_num);
+  return slot ? &*slot : nullptr;
+}
+
+void SendTimeHistory::RemoveBefore(int64_t unwrapped_seq_num) {
+  for (; first_seq_num_ < end_seq_num_; ++first_seq_num_) {
+    Slot& slot = SlotAt(first_seq_num_);
+    if (slot && first_seq_num_ >= unwrapped_seq_num)
+      break;
+    slot.reset();
+  }
+}
+
+bool SendTimeHistory::MakeRoom(int64_t unwrapped_seq_num) {
+  if (unwrapped_seq_num >= end_seq_num_) {
+    RemoveBefore(unwrapped_seq_num + 1 -
+                 static_cast<int64_t>(kMaxHistorySize));
+  }
+  if (first_seq_num_ == end_seq_num_) {
+    first_seq_num_ = end_seq_num_ = unwrapped_seq_num;
+  } else if (unwrapped_seq_num < first_seq_num_ &&
+             end_seq_num_ - unwrapped_seq_num >
+                 static_cast<int64_t>(kMaxHistorySize)) {
+    // Packets are added in order, so a packet this far behind is stale.
+    return false;
+  }
+
+  const int64_t first_seq_num = std::min(first_seq_num_, unwrapped_seq_num);
+  const int64_t end_seq_num = std::max(end_seq_num_, unwrapped_seq_num + 1);
+  const size_t size = static_cast<size_t>(end_seq_num - first_seq_num);
+  if (size > history_.size()) {
+    size_t capacity = std::max(kMinHistoryCapacity, history_.size());
+    while (capacity < size)
+      capacity *= 2;
+    std::vector<Slot> history(capacity);
+    for (int64_t seq_num = first_seq_num_; seq_num < end_seq_num_; ++seq_num) {
+      history[static_cast<uint64_t>(seq_num) & (capacity - 1)] =
+          std::move(SlotAt(seq_num));
+    }
+    history_.swap(history);
+  }
+  first_seq_num_ = first_seq_num;
+  end_seq_num_ = end_seq_num;
+  return true;
+}
+
 }  // namespace webrtc
@@ -231,5 +231,37 @@ TEST_F(SendTimeHistoryTest, InterlievedGetAndRemove) {
   EXPECT_TRUE(history_.GetFeedback(&packet3, true));
   EXPECT_EQ(packets[2], packet3);
 }
+
+TEST_F(SendTimeHistoryTest, ManyPacketsWithGaps) {
+  const int kNumPackets = 5000;
+  const size_t kPacketSize = 100;
+  for (int i = 0; i < kNumPackets; ++i) {
+    AddPacketWithSendTime(static_cast<uint16_t>(i), kPacketSize, i,
+                          PacedPacketInfo());
+  }
+  EXPECT_EQ(kNumPackets * kPacketSize, history_.GetOutstandingBytes(0, 0));
+
+  // Remove every other packet, and only look at the others.
+  for (int i = 0; i < kNumPackets; ++i) {
+    PacketFeedback packet(0, static_cast<uint16_t>(i));
+    EXPECT_TRUE(history_.GetFeedback(&packet, i % 2 == 0));
+    EXPECT_EQ(i, packet.send_time_ms);
+  }
+  for (int i = 0; i < kNumPackets; ++i) {
+    PacketFeedback packet(0, static_cast<uint16_t>(i));
+    EXPECT_EQ(i % 2 == 1, history_.GetFeedback(&packet, false));
+  }
+  // Only the latest acked packet remains outstanding.
+  EXPECT_EQ(kPacketSize, history_.GetOutstandingBytes(0, 0));
+
+  // New packets are still added after the gaps.
+  AddPacketWithSendTime(kNumPackets, kPacketSize, kNumPackets,
+                        PacedPacketInfo());
+  EXPECT_EQ(2 * kPacketSize, history_.GetOutstandingBytes(0, 0));
+  PacketFeedback packet(0, kNumPackets);
+  EXPECT_TRUE(history_.GetFeedback(&packet, true));
+  EXPECT_EQ(kNumPackets, packet.send_time_ms);
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -94,6 +94,10 @@ class RtpRtcp : public Module {
     RateLimiter* retransmission_rate_limiter = nullptr;
     OverheadObserver* overhead_observer = nullptr;
     RtpKeepAliveConfig keepalive_config;
+    // Minimum time between retransmissions of a packet, regardless of RTT.
+    // Useful when NACKs from several receivers arrive on the same module, so
+    // that one retransmission answers all of them. Zero disables it.
+    int64_t nack_coalescing_window_ms = 0;
 
    private:
     RTC_DISALLOW_COPY_AND_ASSIGN(Configuration);
@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_RTP_RTCP_INCLUDE_ULPFEC_RECEIVER_H_
 
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/rtc_base/array_view.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -46,6 +47,20 @@ class UlpfecReceiver {
                                        size_t packet_length,
                                        uint8_t ulpfec_payload_type) = 0;
 
+  // Like AddReceivedRedPacket(), for callers that pass on the media of RED
+  // packets themselves. The media block of |incoming_rtp_packet| is returned
+  // in place in |media_payload|, empty if there is none, and |media_header| is
+  // set to |rtp_header| with the payload type of the media. It is then not
+  // returned by ProcessReceivedFec(), and it is only copied, for decoding, for
+  // as long as ULPFEC packets are being received.
+  virtual int32_t AddReceivedRedPacketInPlace(
+      const RTPHeader& rtp_header,
+      const uint8_t* incoming_rtp_packet,
+      size_t packet_length,
+      uint8_t ulpfec_payload_type,
+      RTPHeader* media_header,
+      rtc::ArrayView<const uint8_t>* media_payload) = 0;
+
   // Sends the received packets to the FEC and returns all packets
   // (both original media and recovered) through the callback.
   virtual int32_t ProcessReceivedFec() = 0;
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <string.h>
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace internal {
+
+void XorBytes_C(const uint8_t* src, size_t length, uint8_t* dst) {
+  // One machine word at a time; memcpy() compiles to unaligned loads/stores.
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t s;
+    uint64_t d;
+    memcpy(&s, src + i, sizeof(s));
+    memcpy(&d, dst + i, sizeof(d));
+    d ^= s;
+    memcpy(dst + i, &d, sizeof(d));
+  }
+  for (; i < length; ++i)
+    dst[i] ^= src[i];
+}
+
+void XorBytes(const uint8_t* src, size_t length, uint8_t* dst) {
+  static void (*xor_proc)(const uint8_t*, size_t, uint8_t*) = nullptr;
+
+  if (!xor_proc) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    xor_proc = WebRtc_GetCPUInfo(kSSE2) ? &XorBytes_SSE2 : &XorBytes_C;
+#elif defined(WEBRTC_HAS_NEON)
+    xor_proc = &XorBytes_NEON;
+#else
+    xor_proc = &XorBytes_C;
+#endif
+  }
+
+  xor_proc(src, length, dst);
+}
+
+}  // namespace internal
+}  // namespace webrtc
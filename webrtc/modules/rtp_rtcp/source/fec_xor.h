@@ -0,0 +1,33 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+namespace internal {
+
+// XORs |length| bytes of |src| into |dst|. The buffers must not overlap and
+// need not be aligned. Uses the fastest kernel supported by the CPU.
+void XorBytes(const uint8_t* src, size_t length, uint8_t* dst);
+
+// The kernels XorBytes() dispatches to, exposed for testing. Only the ones
+// built for the target architecture are defined.
+void XorBytes_C(const uint8_t* src, size_t length, uint8_t* dst);
+void XorBytes_SSE2(const uint8_t* src, size_t length, uint8_t* dst);
+void XorBytes_NEON(const uint8_t* src, size_t length, uint8_t* dst);
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
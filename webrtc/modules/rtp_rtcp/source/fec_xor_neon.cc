@@ -0,0 +1,32 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+namespace internal {
+
+void XorBytes_NEON(const uint8_t* src, size_t length, uint8_t* dst) {
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    uint8x16_t x0 = veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i));
+    uint8x16_t x1 = veorq_u8(vld1q_u8(dst + i + 16), vld1q_u8(src + i + 16));
+    vst1q_u8(dst + i, x0);
+    vst1q_u8(dst + i + 16, x1);
+  }
+  for (; i + 16 <= length; i += 16)
+    vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+  XorBytes_C(src + i, length - i, dst + i);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <vector>
+
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+using XorBytesFunction = void (*)(const uint8_t*, size_t, uint8_t*);
+
+// Checks |xor_bytes| against a byte loop for all lengths up to a few vectors
+// and all alignments of the source and destination within a vector.
+void VerifyXorBytes(XorBytesFunction xor_bytes) {
+  constexpr size_t kMaxLength = 200;
+  constexpr size_t kMaxOffset = 16;
+  Random random(0x12345678);
+  std::vector<uint8_t> src(kMaxLength + kMaxOffset);
+  std::vector<uint8_t> dst(kMaxLength + kMaxOffset);
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+      for (auto& byte : src)
+        byte = random.Rand<uint8_t>();
+      for (auto& byte : dst)
+        byte = random.Rand<uint8_t>();
+      std::vector<uint8_t> expected = dst;
+      for (size_t i = 0; i < length; ++i)
+        expected[offset + i] ^= src[kMaxOffset - offset + i];
+
+      xor_bytes(&src[kMaxOffset - offset], length, &dst[offset]);
+      ASSERT_EQ(expected, dst) << "length " << length << ", offset " << offset;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FecXorTest, XorBytes) {
+  VerifyXorBytes(&XorBytes);
+}
+
+TEST(FecXorTest, XorBytesC) {
+  VerifyXorBytes(&XorBytes_C);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(FecXorTest, XorBytesSSE2) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  VerifyXorBytes(&XorBytes_SSE2);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+TEST(FecXorTest, XorBytesNEON) {
+  VerifyXorBytes(&XorBytes_NEON);
+}
+#endif
+
+}  // namespace internal
+}  // namespace webrtc
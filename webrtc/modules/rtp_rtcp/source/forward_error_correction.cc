@@ -18,17 +18,30 @@
 
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
 #include "webrtc/modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "webrtc/modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/refcountedobject.h"
 
 namespace webrtc {
 
 namespace {
 // Transport header size in bytes. Assume UDP/IPv4 as a reasonable minimum.
 constexpr size_t kTransportOverhead = 28;
+
+// Released packets kept for reuse beyond the ones the decoder holds on to,
+// for the packets that are on their way to DecodeFec().
+constexpr size_t kExtraFreePackets = 16;
+
+int NumSetBits(uint8_t byte) {
+  int num_bits = 0;
+  for (; byte != 0; byte &= byte - 1)
+    ++num_bits;
+  return num_bits;
+}
 }  // namespace
 
 ForwardErrorCorrection::Packet::Packet() : length(0), data(), ref_count_(0) {}
@@ -41,11 +54,54 @@ int32_t ForwardErrorCorrection::Packet::AddRef() {
 int32_t ForwardErrorCorrection::Packet::Release() {
   int32_t ref_count;
   ref_count = --ref_count_;
-  if (ref_count == 0)
-    delete this;
+  if (ref_count == 0) {
+    if (pool_) {
+      // The pool may go away along with this packet, once the reference to
+      // it is released.
+      rtc::scoped_refptr<PacketPool> pool = std::move(pool_);
+      pool->ReturnPacket(this);
+    } else {
+      delete this;
+    }
+  }
   return ref_count;
 }
 
+rtc::scoped_refptr<ForwardErrorCorrection::PacketPool>
+ForwardErrorCorrection::PacketPool::Create(size_t max_free_packets) {
+  return new rtc::RefCountedObject<PacketPool>(max_free_packets);
+}
+
+ForwardErrorCorrection::PacketPool::PacketPool(size_t max_free_packets)
+    : max_free_packets_(max_free_packets) {}
+
+ForwardErrorCorrection::PacketPool::~PacketPool() = default;
+
+rtc::scoped_refptr<ForwardErrorCorrection::Packet>
+ForwardErrorCorrection::PacketPool::GetPacket() {
+  std::unique_ptr<Packet> packet;
+  {
+    rtc::CritScope lock(&crit_);
+    if (!free_packets_.empty()) {
+      packet = std::move(free_packets_.back());
+      free_packets_.pop_back();
+    }
+  }
+  if (!packet)
+    packet.reset(new Packet());
+  packet->length = 0;
+  packet->pool_ = this;
+  return rtc::scoped_refptr<Packet>(packet.release());
+}
+
+void ForwardErrorCorrection::PacketPool::ReturnPacket(Packet* packet) {
+  RTC_DCHECK(!packet->pool_);
+  std::unique_ptr<Packet> returned_packet(packet);
+  rtc::CritScope lock(&crit_);
+  if (free_packets_.size() < max_free_packets_)
+    free_packets_.push_back(std::move(returned_packet));
+}
+
 // This comparator is used to compare std::unique_ptr's pointing to
 // subclasses of SortablePackets. It needs to be parametric since
 // the std::unique_ptr's are not covariant w.r.t. the types that
@@ -80,7 +136,14 @@ ForwardErrorCorrection::ForwardErrorCorrection(
       fec_header_reader_(std::move(fec_header_reader)),
       fec_header_writer_(std::move(fec_header_writer)),
       generated_fec_packets_(fec_header_writer_->MaxFecPackets()),
-      packet_mask_size_(0) {}
+      packet_pool_(PacketPool::Create(fec_header_reader_->MaxMediaPackets() +
+                                      fec_header_reader_->MaxFecPackets() +
+                                      kExtraFreePackets)),
+      packet_mask_size_(0) {
+  // One more than the max, for the FEC packet inserted before the oldest one
+  // is discarded.
+  received_fec_packets_.reserve(fec_header_reader_->MaxFecPackets() + 1);
+}
 
 ForwardErrorCorrection::~ForwardErrorCorrection() = default;
 
@@ -337,7 +400,8 @@ void ForwardErrorCorrection::ResetState(
     RecoveredPacketList* recovered_packets) {
   // Free the memory for any existing recovered packets, if the caller hasn't.
   recovered_packets->clear();
-  received_fec_packets_.clear();
+  while (!received_fec_packets_.empty())
+    DiscardFecPacket(received_fec_packets_.begin());
 }
 
 void ForwardErrorCorrection::InsertMediaPacket(
@@ -365,29 +429,71 @@ void ForwardErrorCorrection::InsertMediaPacket(
   recovered_packet->seq_num = received_packet->seq_num;
   recovered_packet->pkt = received_packet->pkt;
   recovered_packet->pkt->length = received_packet->pkt->length;
-  // TODO(holmer): Consider replacing this with a binary search for the right
-  // position, and then just insert the new packet. Would get rid of the sort.
   RecoveredPacket* recovered_packet_ptr = recovered_packet.get();
-  recovered_packets->push_back(std::move(recovered_packet));
-  recovered_packets->sort(SortablePacket::LessThan());
+  InsertRecoveredPacket(recovered_packets, std::move(recovered_packet));
   UpdateCoveringFecPackets(*recovered_packet_ptr);
 }
 
+void ForwardErrorCorrection::InsertRecoveredPacket(
+    RecoveredPacketList* recovered_packets,
+    std::unique_ptr<RecoveredPacket> recovered_packet) {
+  // Packets mostly arrive in order, so the position is searched for from the
+  // newest packet.
+  auto it = recovered_packets->end();
+  while (it != recovered_packets->begin() &&
+         SortablePacket::LessThan()(recovered_packet, *std::prev(it))) {
+    --it;
+  }
+  recovered_packets->insert(it, std::move(recovered_packet));
+}
+
 void ForwardErrorCorrection::UpdateCoveringFecPackets(
     const RecoveredPacket& packet) {
   for (auto& fec_packet : received_fec_packets_) {
     // Is this FEC packet protecting the media packet |packet|?
-    auto protected_it = std::lower_bound(fec_packet->protected_packets.begin(),
-                                         fec_packet->protected_packets.end(),
-                                         &packet, SortablePacket::LessThan());
-    if (protected_it != fec_packet->protected_packets.end() &&
-        (*protected_it)->seq_num == packet.seq_num) {
+    ProtectedPacket* protected_packet =
+        FindProtectedPacket(fec_packet.get(), packet.seq_num);
+    if (protected_packet) {
       // Found an FEC packet which is protecting |packet|.
-      (*protected_it)->pkt = packet.pkt;
+      protected_packet->pkt = packet.pkt;
     }
   }
 }
 
+ForwardErrorCorrection::ProtectedPacket*
+ForwardErrorCorrection::FindProtectedPacket(ReceivedFecPacket* fec_packet,
+                                            uint16_t seq_num) {
+  // This wraps naturally with the sequence number.
+  const uint16_t bit = static_cast<uint16_t>(seq_num - fec_packet->seq_num_base);
+  if (bit >= fec_packet->packet_mask_size * 8)
+    return nullptr;
+  const uint8_t* packet_mask =
+      &fec_packet->pkt->data[fec_packet->packet_mask_offset];
+  const size_t byte_idx = bit >> 3;
+  const int bit_idx = bit & 7;
+  if (!(packet_mask[byte_idx] & (1 << (7 - bit_idx))))
+    return nullptr;
+  // The index of the protected packet is the number of bits set before |bit|.
+  size_t index = 0;
+  for (size_t i = 0; i < byte_idx; ++i)
+    index += NumSetBits(packet_mask[i]);
+  index += NumSetBits(packet_mask[byte_idx] >> (8 - bit_idx));
+  RTC_DCHECK_LT(index, fec_packet->protected_packets.size());
+  ProtectedPacket* protected_packet = &fec_packet->protected_packets[index];
+  RTC_DCHECK_EQ(protected_packet->seq_num, seq_num);
+  return protected_packet;
+}
+
+ForwardErrorCorrection::ReceivedFecPacketList::iterator
+ForwardErrorCorrection::DiscardFecPacket(ReceivedFecPacketList::iterator it) {
+  std::unique_ptr<ReceivedFecPacket> fec_packet = std::move(*it);
+  fec_packet->protected_packets.clear();
+  fec_packet->pkt = nullptr;
+  if (free_fec_packets_.size() < fec_header_reader_->MaxFecPackets())
+    free_fec_packets_.push_back(std::move(fec_packet));
+  return received_fec_packets_.erase(it);
+}
+
 void ForwardErrorCorrection::InsertFecPacket(
     const RecoveredPacketList& recovered_packets,
     ReceivedPacket* received_packet) {
@@ -403,13 +509,21 @@ void ForwardErrorCorrection::InsertFecPacket(
     }
   }
 
-  std::unique_ptr<ReceivedFecPacket> fec_packet(new ReceivedFecPacket());
+  std::unique_ptr<ReceivedFecPacket> fec_packet;
+  if (free_fec_packets_.empty()) {
+    fec_packet.reset(new ReceivedFecPacket());
+  } else {
+    fec_packet = std::move(free_fec_packets_.back());
+    free_fec_packets_.pop_back();
+  }
   fec_packet->pkt = received_packet->pkt;
   fec_packet->ssrc = received_packet->ssrc;
   fec_packet->seq_num = received_packet->seq_num;
   // Parse ULPFEC/FlexFEC header specific info.
   bool ret = fec_header_reader_->ReadFecHeader(fec_packet.get());
   if (!ret) {
+    fec_packet->pkt = nullptr;
+    free_fec_packets_.push_back(std::move(fec_packet));
     return;
   }
 
@@ -417,6 +531,8 @@ void ForwardErrorCorrection::InsertFecPacket(
   if (fec_packet->protected_ssrc != protected_media_ssrc_) {
     LOG(LS_INFO)
         << "Received FEC packet is protecting an unknown media SSRC; dropping.";
+    fec_packet->pkt = nullptr;
+    free_fec_packets_.push_back(std::move(fec_packet));
     return;
   }
 
@@ -427,14 +543,14 @@ void ForwardErrorCorrection::InsertFecPacket(
         fec_packet->pkt->data[fec_packet->packet_mask_offset + byte_idx];
     for (uint16_t bit_idx = 0; bit_idx < 8; ++bit_idx) {
       if (packet_mask & (1 << (7 - bit_idx))) {
-        std::unique_ptr<ProtectedPacket> protected_packet(
-            new ProtectedPacket());
+        fec_packet->protected_packets.emplace_back();
+        ProtectedPacket* protected_packet =
+            &fec_packet->protected_packets.back();
         // This wraps naturally with the sequence number.
         protected_packet->ssrc = protected_media_ssrc_;
         protected_packet->seq_num = static_cast<uint16_t>(
             fec_packet->seq_num_base + (byte_idx << 3) + bit_idx);
         protected_packet->pkt = nullptr;
-        fec_packet->protected_packets.push_back(std::move(protected_packet));
       }
     }
   }
@@ -442,15 +558,18 @@ void ForwardErrorCorrection::InsertFecPacket(
   if (fec_packet->protected_packets.empty()) {
     // All-zero packet mask; we can discard this FEC packet.
     LOG(LS_WARNING) << "Received FEC packet has an all-zero packet mask.";
+    fec_packet->pkt = nullptr;
+    free_fec_packets_.push_back(std::move(fec_packet));
   } else {
     AssignRecoveredPackets(recovered_packets, fec_packet.get());
-    // TODO(holmer): Consider replacing this with a binary search for the right
-    // position, and then just insert the new packet. Would get rid of the sort.
-    received_fec_packets_.push_back(std::move(fec_packet));
-    received_fec_packets_.sort(SortablePacket::LessThan());
+    auto it =
+        std::upper_bound(received_fec_packets_.begin(),
+                         received_fec_packets_.end(), fec_packet,
+                         SortablePacket::LessThan());
+    received_fec_packets_.insert(it, std::move(fec_packet));
     const size_t max_fec_packets = fec_header_reader_->MaxFecPackets();
     if (received_fec_packets_.size() > max_fec_packets) {
-      received_fec_packets_.pop_front();
+      DiscardFecPacket(received_fec_packets_.begin());
     }
     RTC_DCHECK_LE(received_fec_packets_.size(), max_fec_packets);
   }
@@ -466,17 +585,17 @@ void ForwardErrorCorrection::AssignRecoveredPackets(
   // and |recovered_packets|, i.e. all protected packets that have already
   // been recovered. Update the corresponding protected packets to point to
   // the recovered packets.
-  auto it_p = protected_packets->cbegin();
+  auto it_p = protected_packets->begin();
   auto it_r = recovered_packets.cbegin();
   SortablePacket::LessThan less_than;
   while (it_p != protected_packets->end() && it_r != recovered_packets.end()) {
-    if (less_than(*it_p, *it_r)) {
+    if (less_than(it_p, *it_r)) {
       ++it_p;
-    } else if (less_than(*it_r, *it_p)) {
+    } else if (less_than(*it_r, it_p)) {
       ++it_r;
     } else {  // *it_p == *it_r.
       // This protected packet has already been recovered.
-      (*it_p)->pkt = (*it_r)->pkt;
+      it_p->pkt = (*it_r)->pkt;
       ++it_p;
       ++it_r;
     }
@@ -509,7 +628,7 @@ void ForwardErrorCorrection::InsertPackets(
         uint16_t seq_num_diff = abs(static_cast<int>(received_packet->seq_num) -
                                     static_cast<int>((*it)->seq_num));
         if (seq_num_diff > 0x3fff) {
-          it = received_fec_packets_.erase(it);
+          it = DiscardFecPacket(it);
         } else {
           // No need to keep iterating, since |received_fec_packets_| is sorted.
           break;
@@ -540,7 +659,7 @@ bool ForwardErrorCorrection::StartPacketRecovery(
     return false;
   }
   // Initialize recovered packet data.
-  recovered_packet->pkt = new Packet();
+  recovered_packet->pkt = packet_pool_->GetPacket();
   memset(recovered_packet->pkt->data, 0, IP_PACKET_SIZE);
   recovered_packet->returned = false;
   recovered_packet->was_recovered = true;
@@ -615,9 +734,8 @@ void ForwardErrorCorrection::XorPayloads(const Packet& src,
   // XOR the payload.
   RTC_DCHECK_LE(kRtpHeaderSize + payload_length, sizeof(src.data));
   RTC_DCHECK_LE(dst_offset + payload_length, sizeof(dst->data));
-  for (size_t i = 0; i < payload_length; ++i) {
-    dst->data[dst_offset + i] ^= src.data[kRtpHeaderSize + i];
-  }
+  internal::XorBytes(&src.data[kRtpHeaderSize], payload_length,
+                     &dst->data[dst_offset]);
 }
 
 bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
@@ -626,12 +744,12 @@ bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
     return false;
   }
   for (const auto& protected_packet : fec_packet.protected_packets) {
-    if (protected_packet->pkt == nullptr) {
+    if (protected_packet.pkt == nullptr) {
       // This is the packet we're recovering.
-      recovered_packet->seq_num = protected_packet->seq_num;
+      recovered_packet->seq_num = protected_packet.seq_num;
     } else {
-      XorHeaders(*protected_packet->pkt, recovered_packet->pkt);
-      XorPayloads(*protected_packet->pkt, protected_packet->pkt->length,
+      XorHeaders(*protected_packet.pkt, recovered_packet->pkt);
+      XorPayloads(*protected_packet.pkt, protected_packet.pkt->length,
                   kRtpHeaderSize, recovered_packet->pkt);
     }
   }
@@ -655,21 +773,17 @@ void ForwardErrorCorrection::AttemptRecovery(
       recovered_packet->pkt = nullptr;
       if (!RecoverPacket(**fec_packet_it, recovered_packet.get())) {
         // Can't recover using this packet, drop it.
-        fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+        fec_packet_it = DiscardFecPacket(fec_packet_it);
         continue;
       }
 
       auto recovered_packet_ptr = recovered_packet.get();
       // Add recovered packet to the list of recovered packets and update any
       // FEC packets covering this packet with a pointer to the data.
-      // TODO(holmer): Consider replacing this with a binary search for the
-      // right position, and then just insert the new packet. Would get rid of
-      // the sort.
-      recovered_packets->push_back(std::move(recovered_packet));
-      recovered_packets->sort(SortablePacket::LessThan());
+      InsertRecoveredPacket(recovered_packets, std::move(recovered_packet));
       UpdateCoveringFecPackets(*recovered_packet_ptr);
       DiscardOldRecoveredPackets(recovered_packets);
-      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+      DiscardFecPacket(fec_packet_it);
 
       // A packet has been recovered. We need to check the FEC list again, as
       // this may allow additional packets to be recovered.
@@ -678,7 +792,7 @@ void ForwardErrorCorrection::AttemptRecovery(
     } else if (packets_missing == 0) {
       // Either all protected packets arrived or have been recovered. We can
       // discard this FEC packet.
-      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+      fec_packet_it = DiscardFecPacket(fec_packet_it);
     } else {
       fec_packet_it++;
     }
@@ -689,7 +803,7 @@ int ForwardErrorCorrection::NumCoveredPacketsMissing(
     const ReceivedFecPacket& fec_packet) {
   int packets_missing = 0;
   for (const auto& protected_packet : fec_packet.protected_packets) {
-    if (protected_packet->pkt == nullptr) {
+    if (protected_packet.pkt == nullptr) {
       ++packets_missing;
       if (packets_missing > 1) {
         break;  // We can't recover more than one packet.
@@ -754,6 +868,11 @@ size_t ForwardErrorCorrection::MaxPacketOverhead() const {
   return fec_header_writer_->MaxPacketOverhead();
 }
 
+rtc::scoped_refptr<ForwardErrorCorrection::Packet>
+ForwardErrorCorrection::AllocatePacket() {
+  return packet_pool_->GetPacket();
+}
+
 FecHeaderReader::FecHeaderReader(size_t max_media_packets,
                                  size_t max_fec_packets)
     : max_media_packets_(max_media_packets),
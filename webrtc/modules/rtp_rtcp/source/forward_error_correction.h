@@ -21,8 +21,10 @@
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "webrtc/rtc_base/basictypes.h"
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/refcount.h"
 #include "webrtc/rtc_base/scoped_ref_ptr.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
@@ -41,6 +43,8 @@ class ForwardErrorCorrection {
   // refactored into proper classes, and their members should be made private.
   // This will require parts of the functionality in forward_error_correction.cc
   // and receiver_fec.cc to be refactored into the packet classes.
+  class PacketPool;
+
   class Packet {
    public:
     Packet();
@@ -57,7 +61,36 @@ class ForwardErrorCorrection {
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
    private:
+    friend class PacketPool;
+
     int32_t ref_count_;  // Counts the number of references to a packet.
+    // Set for packets from a PacketPool, which they are returned to instead
+    // of being deleted.
+    rtc::scoped_refptr<PacketPool> pool_;
+  };
+
+  // Recycles released packets, so that the decoder doesn't allocate and clear
+  // a packet for every packet received or recovered once the pool holds as
+  // many packets as are in use. Recycled packets are not cleared.
+  class PacketPool : public rtc::RefCountInterface {
+   public:
+    // Keeps at most |max_free_packets| released packets for reuse.
+    static rtc::scoped_refptr<PacketPool> Create(size_t max_free_packets);
+
+    rtc::scoped_refptr<Packet> GetPacket();
+
+   protected:
+    explicit PacketPool(size_t max_free_packets);
+    ~PacketPool() override;
+
+   private:
+    friend class Packet;
+
+    void ReturnPacket(Packet* packet);
+
+    const size_t max_free_packets_;
+    rtc::CriticalSection crit_;
+    std::vector<std::unique_ptr<Packet>> free_packets_ GUARDED_BY(crit_);
   };
 
   // TODO(holmer): Refactor into a proper class.
@@ -115,7 +148,8 @@ class ForwardErrorCorrection {
     rtc::scoped_refptr<ForwardErrorCorrection::Packet> pkt;
   };
 
-  using ProtectedPacketList = std::list<std::unique_ptr<ProtectedPacket>>;
+  // Sorted by sequence number, as are the bits of the packet mask.
+  using ProtectedPacketList = std::vector<ProtectedPacket>;
 
   // Used for internal storage of received FEC packets in a list.
   //
@@ -143,7 +177,8 @@ class ForwardErrorCorrection {
   using PacketList = std::list<std::unique_ptr<Packet>>;
   using ReceivedPacketList = std::list<std::unique_ptr<ReceivedPacket>>;
   using RecoveredPacketList = std::list<std::unique_ptr<RecoveredPacket>>;
-  using ReceivedFecPacketList = std::list<std::unique_ptr<ReceivedFecPacket>>;
+  using ReceivedFecPacketList =
+      std::vector<std::unique_ptr<ReceivedFecPacket>>;
 
   ~ForwardErrorCorrection();
 
@@ -231,6 +266,10 @@ class ForwardErrorCorrection {
   // accounted for as packet overhead.
   size_t MaxPacketOverhead() const;
 
+  // Returns a packet to be passed to DecodeFec(), reused from the packets
+  // of earlier calls if possible.
+  rtc::scoped_refptr<Packet> AllocatePacket();
+
   // Reset internal states from last frame and clear |recovered_packets|.
   // Frees all memory allocated by this class.
   void ResetState(RecoveredPacketList* recovered_packets);
@@ -275,6 +314,12 @@ class ForwardErrorCorrection {
   void InsertMediaPacket(RecoveredPacketList* recovered_packets,
                          ReceivedPacket* received_packet);
 
+  // Inserts |recovered_packet| into |recovered_packets| in sequence number
+  // order.
+  static void InsertRecoveredPacket(
+      RecoveredPacketList* recovered_packets,
+      std::unique_ptr<RecoveredPacket> recovered_packet);
+
   // Assigns pointers to the recovered packet from all FEC packets which cover
   // it.
   // Note: This reduces the complexity when we want to try to recover a packet
@@ -286,6 +331,17 @@ class ForwardErrorCorrection {
   void InsertFecPacket(const RecoveredPacketList& recovered_packets,
                        ReceivedPacket* received_packet);
 
+  // Returns the protected packet of |fec_packet| for |seq_num|, or null if
+  // |fec_packet| doesn't protect it. Takes constant time, as it is found from
+  // the packet mask.
+  static ProtectedPacket* FindProtectedPacket(ReceivedFecPacket* fec_packet,
+                                              uint16_t seq_num);
+
+  // Removes the FEC packet at |it| from |received_fec_packets_|, keeping it
+  // for reuse. Returns the iterator to the next FEC packet.
+  ReceivedFecPacketList::iterator DiscardFecPacket(
+      ReceivedFecPacketList::iterator it);
+
   // Assigns pointers to already recovered packets covered by |fec_packet|.
   static void AssignRecoveredPackets(
       const RecoveredPacketList& recovered_packets,
@@ -297,8 +353,8 @@ class ForwardErrorCorrection {
 
   // Initializes headers and payload before the XOR operation
   // that recovers a packet.
-  static bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
-                                  RecoveredPacket* recovered_packet);
+  bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
+                           RecoveredPacket* recovered_packet);
 
   // Performs XOR between the first 8 bytes of |src| and |dst| and stores
   // the result in |dst|. The 3rd and 4th bytes are used for storing
@@ -319,8 +375,8 @@ class ForwardErrorCorrection {
                                    RecoveredPacket* recovered_packet);
 
   // Recover a missing packet.
-  static bool RecoverPacket(const ReceivedFecPacket& fec_packet,
-                            RecoveredPacket* recovered_packet);
+  bool RecoverPacket(const ReceivedFecPacket& fec_packet,
+                     RecoveredPacket* recovered_packet);
 
   // Get the number of missing media packets which are covered by |fec_packet|.
   // An FEC packet can recover at most one packet, and if zero packets are
@@ -340,7 +396,12 @@ class ForwardErrorCorrection {
   std::unique_ptr<FecHeaderWriter> fec_header_writer_;
 
   std::vector<Packet> generated_fec_packets_;
+  // Sorted by sequence number, and never more than MaxFecPackets().
   ReceivedFecPacketList received_fec_packets_;
+  // FEC packets removed from |received_fec_packets_|, kept for reuse along
+  // with the capacity of their protected packets.
+  std::vector<std::unique_ptr<ReceivedFecPacket>> free_fec_packets_;
+  const rtc::scoped_refptr<PacketPool> packet_pool_;
 
   // Arrays used to avoid dynamically allocating memory when generating
   // the packet masks.
@@ -18,6 +18,7 @@
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "webrtc/modules/rtp_rtcp/source/time_util.h"
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/system_wrappers/include/clock.h"
 
@@ -26,6 +27,14 @@ namespace webrtc {
 const int64_t kStatisticsTimeoutMs = 8000;
 const int64_t kStatisticsProcessIntervalMs = 1000;
 
+namespace {
+// Start slot of |ssrc| in an index with 2^|size_log2| slots. Uses the top bits
+// of a multiplicative hash, so that both sequential and random SSRCs spread.
+size_t StatisticianIndexSlot(uint32_t ssrc, int size_log2) {
+  return static_cast<uint32_t>(ssrc * 2654435769u) >> (32 - size_log2);
+}
+}  // namespace
+
 StreamStatistician::~StreamStatistician() {}
 
 StreamStatisticianImpl::StreamStatisticianImpl(
@@ -362,10 +371,16 @@ ReceiveStatistics* ReceiveStatistics::Create(Clock* clock) {
   return new ReceiveStatisticsImpl(clock);
 }
 
+constexpr int ReceiveStatisticsImpl::kStatisticianIndexSizeLog2;
+constexpr size_t ReceiveStatisticsImpl::kStatisticianIndexSize;
+
 ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
       rtcp_stats_callback_(NULL),
-      rtp_stats_callback_(NULL) {}
+      rtp_stats_callback_(NULL) {
+  for (size_t i = 0; i < kStatisticianIndexSize; ++i)
+    statistician_index_[i] = nullptr;
+}
 
 ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
   while (!statisticians_.empty()) {
@@ -374,20 +389,60 @@ ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
   }
 }
 
+StreamStatisticianImpl* ReceiveStatisticsImpl::FindStatistician(
+    uint32_t ssrc) const {
+  size_t slot = StatisticianIndexSlot(ssrc, kStatisticianIndexSizeLog2);
+  for (size_t i = 0; i < kStatisticianIndexSize; ++i) {
+    StreamStatisticianImpl* statistician =
+        rtc::AtomicOps::AcquireLoadPtr(&statistician_index_[slot]);
+    if (!statistician)
+      return nullptr;
+    if (statistician->ssrc() == ssrc)
+      return statistician;
+    slot = (slot + 1) & (kStatisticianIndexSize - 1);
+  }
+  return nullptr;
+}
+
+StreamStatisticianImpl* ReceiveStatisticsImpl::GetOrCreateStatistician(
+    uint32_t ssrc,
+    bool create) {
+  rtc::CritScope cs(&receive_statistics_lock_);
+  StatisticianImplMap::iterator it = statisticians_.find(ssrc);
+  if (it != statisticians_.end())
+    return it->second;
+  if (!create)
+    return nullptr;
+  StreamStatisticianImpl* impl =
+      new StreamStatisticianImpl(ssrc, clock_, this, this);
+  statisticians_[ssrc] = impl;
+  AddToIndex(impl);
+  return impl;
+}
+
+void ReceiveStatisticsImpl::AddToIndex(StreamStatisticianImpl* statistician) {
+  size_t slot = StatisticianIndexSlot(statistician->ssrc(),
+                                      kStatisticianIndexSizeLog2);
+  for (size_t i = 0; i < kStatisticianIndexSize; ++i) {
+    // Only written with |receive_statistics_lock_| held, so an empty slot
+    // stays empty until this call fills it.
+    if (rtc::AtomicOps::CompareAndSwapPtr(
+            &statistician_index_[slot],
+            static_cast<StreamStatisticianImpl*>(nullptr),
+            statistician) == nullptr) {
+      return;
+    }
+    slot = (slot + 1) & (kStatisticianIndexSize - 1);
+  }
+  // The index is full, this SSRC is only found through |statisticians_|.
+}
+
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t packet_length,
                                            bool retransmitted) {
-  StreamStatisticianImpl* impl;
-  {
-    rtc::CritScope cs(&receive_statistics_lock_);
-    StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
-    if (it != statisticians_.end()) {
-      impl = it->second;
-    } else {
-      impl = new StreamStatisticianImpl(header.ssrc, clock_, this, this);
-      statisticians_[header.ssrc] = impl;
-    }
-  }
+  StreamStatisticianImpl* impl = FindStatistician(header.ssrc);
+  if (!impl)
+    impl = GetOrCreateStatistician(header.ssrc, true);
   // StreamStatisticianImpl instance is created once and only destroyed when
   // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
   // it's own locking so don't hold receive_statistics_lock_ (potential
@@ -397,15 +452,12 @@ void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  StreamStatisticianImpl* impl;
-  {
-    rtc::CritScope cs(&receive_statistics_lock_);
-    StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
-    // Ignore FEC if it is the first packet.
-    if (it == statisticians_.end())
-      return;
-    impl = it->second;
-  }
+  StreamStatisticianImpl* impl = FindStatistician(header.ssrc);
+  if (!impl)
+    impl = GetOrCreateStatistician(header.ssrc, false);
+  // Ignore FEC if it is the first packet.
+  if (!impl)
+    return;
   impl->FecPacketReceived(header, packet_length);
 }
 
@@ -427,6 +479,9 @@ StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
 
 StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
     uint32_t ssrc) const {
+  StreamStatisticianImpl* impl = FindStatistician(ssrc);
+  if (impl)
+    return impl;
   rtc::CritScope cs(&receive_statistics_lock_);
   StatisticianImplMap::const_iterator it = statisticians_.find(ssrc);
   if (it == statisticians_.end())
@@ -445,7 +500,7 @@ void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
 
 void ReceiveStatisticsImpl::RegisterRtcpStatisticsCallback(
     RtcpStatisticsCallback* callback) {
-  rtc::CritScope cs(&receive_statistics_lock_);
+  rtc::CritScope cs(&callback_lock_);
   if (callback != NULL)
     assert(rtcp_stats_callback_ == NULL);
   rtcp_stats_callback_ = callback;
@@ -453,20 +508,20 @@ void ReceiveStatisticsImpl::RegisterRtcpStatisticsCallback(
 
 void ReceiveStatisticsImpl::StatisticsUpdated(const RtcpStatistics& statistics,
                                               uint32_t ssrc) {
-  rtc::CritScope cs(&receive_statistics_lock_);
+  rtc::CritScope cs(&callback_lock_);
   if (rtcp_stats_callback_)
     rtcp_stats_callback_->StatisticsUpdated(statistics, ssrc);
 }
 
 void ReceiveStatisticsImpl::CNameChanged(const char* cname, uint32_t ssrc) {
-  rtc::CritScope cs(&receive_statistics_lock_);
+  rtc::CritScope cs(&callback_lock_);
   if (rtcp_stats_callback_)
     rtcp_stats_callback_->CNameChanged(cname, ssrc);
 }
 
 void ReceiveStatisticsImpl::RegisterRtpStatisticsCallback(
     StreamDataCountersCallback* callback) {
-  rtc::CritScope cs(&receive_statistics_lock_);
+  rtc::CritScope cs(&callback_lock_);
   if (callback != NULL)
     assert(rtp_stats_callback_ == NULL);
   rtp_stats_callback_ = callback;
@@ -474,7 +529,7 @@ void ReceiveStatisticsImpl::RegisterRtpStatisticsCallback(
 
 void ReceiveStatisticsImpl::DataCountersUpdated(const StreamDataCounters& stats,
                                                 uint32_t ssrc) {
-  rtc::CritScope cs(&receive_statistics_lock_);
+  rtc::CritScope cs(&callback_lock_);
   if (rtp_stats_callback_) {
     rtp_stats_callback_->DataCountersUpdated(stats, ssrc);
   }
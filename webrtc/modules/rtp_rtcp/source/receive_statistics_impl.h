@@ -48,6 +48,8 @@ class StreamStatisticianImpl : public StreamStatistician {
   void SetMaxReorderingThreshold(int max_reordering_threshold);
   virtual void LastReceiveTimeNtp(uint32_t* secs, uint32_t* frac) const;
 
+  uint32_t ssrc() const { return ssrc_; }
+
  private:
   bool InOrderPacketInternal(uint16_t sequence_number) const;
   RtcpStatistics CalculateRtcpStatistics()
@@ -127,12 +129,37 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
 
   typedef std::map<uint32_t, StreamStatisticianImpl*> StatisticianImplMap;
 
+  static constexpr int kStatisticianIndexSizeLog2 = 6;
+  static constexpr size_t kStatisticianIndexSize =
+      1 << kStatisticianIndexSizeLog2;
+
+  // Returns the statistician for |ssrc| without taking any lock, or nullptr
+  // if it isn't in |statistician_index_|.
+  StreamStatisticianImpl* FindStatistician(uint32_t ssrc) const;
+  // Looks up the statistician for |ssrc| in |statisticians_|, and creates it
+  // if |create| is true.
+  StreamStatisticianImpl* GetOrCreateStatistician(uint32_t ssrc, bool create);
+  void AddToIndex(StreamStatisticianImpl* statistician)
+      EXCLUSIVE_LOCKS_REQUIRED(receive_statistics_lock_);
+
   Clock* const clock_;
   rtc::CriticalSection receive_statistics_lock_;
-  StatisticianImplMap statisticians_;
-
-  RtcpStatisticsCallback* rtcp_stats_callback_;
-  StreamDataCountersCallback* rtp_stats_callback_;
+  StatisticianImplMap statisticians_ GUARDED_BY(receive_statistics_lock_);
+
+  // Open addressed hash table of the first |kStatisticianIndexSize|
+  // statisticians, so that packets of different SSRCs can be counted from
+  // several threads without sharing a lock. Slots are only ever filled, with
+  // |receive_statistics_lock_| held, and statisticians live as long as this
+  // object, so readers only need acquire loads. Mutable since the atomic
+  // loads take non-const pointers.
+  mutable StreamStatisticianImpl* volatile
+      statistician_index_[kStatisticianIndexSize];
+
+  // Separate from |receive_statistics_lock_|, since the per-packet
+  // DataCountersUpdated() callback takes it.
+  rtc::CriticalSection callback_lock_;
+  RtcpStatisticsCallback* rtcp_stats_callback_ GUARDED_BY(callback_lock_);
+  StreamDataCountersCallback* rtp_stats_callback_ GUARDED_BY(callback_lock_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_IMPL_H_
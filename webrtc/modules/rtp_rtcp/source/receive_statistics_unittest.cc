@@ -9,8 +9,10 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
@@ -133,6 +135,74 @@ TEST_F(ReceiveStatisticsTest, ActiveStatisticians) {
   EXPECT_EQ(2u, packets_received);
 }
 
+TEST_F(ReceiveStatisticsTest, ManySsrcs) {
+  // More streams than fit in the lock-free index.
+  const uint32_t kNumSsrcs = 200;
+  RTPHeader header = header1_;
+  for (int i = 0; i < 2; ++i) {
+    for (uint32_t ssrc = 0; ssrc < kNumSsrcs; ++ssrc) {
+      header.ssrc = 0x1000 + ssrc * 0x10001;
+      receive_statistics_->IncomingPacket(header, kPacketSize1, false);
+    }
+    ++header.sequenceNumber;
+  }
+
+  for (uint32_t ssrc = 0; ssrc < kNumSsrcs; ++ssrc) {
+    StreamStatistician* statistician =
+        receive_statistics_->GetStatistician(0x1000 + ssrc * 0x10001);
+    ASSERT_TRUE(statistician != NULL);
+    uint32_t packets_received = 0;
+    statistician->GetDataCounters(nullptr, &packets_received);
+    EXPECT_EQ(2u, packets_received);
+  }
+  EXPECT_EQ(NULL, receive_statistics_->GetStatistician(kSsrc2));
+  EXPECT_EQ(kNumSsrcs, receive_statistics_->GetActiveStatisticians().size());
+}
+
+namespace {
+struct StreamFeeder {
+  ReceiveStatistics* receive_statistics;
+  uint32_t ssrc;
+  int num_packets;
+};
+
+void FeedStream(void* obj) {
+  StreamFeeder* feeder = static_cast<StreamFeeder*>(obj);
+  RTPHeader header;
+  memset(&header, 0, sizeof(header));
+  header.ssrc = feeder->ssrc;
+  for (int i = 0; i < feeder->num_packets; ++i) {
+    header.sequenceNumber = i;
+    feeder->receive_statistics->IncomingPacket(header, kPacketSize1, false);
+  }
+}
+}  // namespace
+
+TEST_F(ReceiveStatisticsTest, IncomingPacketsFromSeveralThreads) {
+  const int kNumThreads = 4;
+  const int kNumPackets = 10000;
+  std::vector<StreamFeeder> feeders;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i)
+    feeders.push_back({receive_statistics_.get(), 1000u + i, kNumPackets});
+  for (StreamFeeder& feeder : feeders) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&FeedStream, &feeder, "StreamFeeder"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  for (const StreamFeeder& feeder : feeders) {
+    StreamStatistician* statistician =
+        receive_statistics_->GetStatistician(feeder.ssrc);
+    ASSERT_TRUE(statistician != NULL);
+    uint32_t packets_received = 0;
+    statistician->GetDataCounters(nullptr, &packets_received);
+    EXPECT_EQ(static_cast<uint32_t>(kNumPackets), packets_received);
+  }
+}
+
 TEST_F(ReceiveStatisticsTest, GetReceiveStreamDataCounters) {
   receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
   StreamStatistician* statistician =
@@ -63,6 +63,32 @@ bool ReceiverReport::Parse(const CommonHeader& packet) {
   return true;
 }
 
+bool ReceiverReport::ParseReportBlocks(
+    const CommonHeader& packet,
+    uint32_t* sender_ssrc,
+    rtc::FunctionView<void(const ReportBlock&)> on_report_block) {
+  RTC_DCHECK_EQ(packet.type(), kPacketType);
+
+  const uint8_t report_blocks_count = packet.count();
+
+  if (packet.payload_size_bytes() <
+      kRrBaseLength + report_blocks_count * ReportBlock::kLength) {
+    LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+
+  *sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(packet.payload());
+
+  const uint8_t* next_report_block = packet.payload() + kRrBaseLength;
+  ReportBlock block;
+  for (uint8_t i = 0; i < report_blocks_count; ++i) {
+    block.Parse(next_report_block, ReportBlock::kLength);
+    on_report_block(block);
+    next_report_block += ReportBlock::kLength;
+  }
+  return true;
+}
+
 size_t ReceiverReport::BlockLength() const {
   return kHeaderLength + kRrBaseLength +
          report_blocks_.size() * ReportBlock::kLength;
@@ -16,6 +16,7 @@
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "webrtc/rtc_base/basictypes.h"
+#include "webrtc/rtc_base/function_view.h"
 
 namespace webrtc {
 namespace rtcp {
@@ -31,6 +32,13 @@ class ReceiverReport : public RtcpPacket {
 
   // Parse assumes header is already parsed and validated.
   bool Parse(const CommonHeader& packet);
+  // Like Parse(), but calls |on_report_block| for each report block instead of
+  // storing them, so that no memory is allocated. |sender_ssrc| is set before
+  // any block is visited, and nothing is visited if |packet| is malformed.
+  static bool ParseReportBlocks(
+      const CommonHeader& packet,
+      uint32_t* sender_ssrc,
+      rtc::FunctionView<void(const ReportBlock&)> on_report_block);
 
   void SetSenderSsrc(uint32_t ssrc) { sender_ssrc_ = ssrc; }
   bool AddReportBlock(const ReportBlock& block);
@@ -11,7 +11,9 @@
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 
 #include <utility>
+#include <vector>
 
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/rtcp_packet_parser.h"
@@ -65,6 +67,34 @@ TEST(RtcpPacketReceiverReportTest, ParseFailsOnIncorrectSize) {
   EXPECT_FALSE(test::ParseSinglePacket(damaged_packet, &rr));
 }
 
+TEST(RtcpPacketReceiverReportTest, ParseReportBlocks) {
+  rtcp::CommonHeader header;
+  ASSERT_TRUE(header.Parse(kPacket, sizeof(kPacket)));
+  uint32_t sender_ssrc = 0;
+  std::vector<ReportBlock> blocks;
+  EXPECT_TRUE(ReceiverReport::ParseReportBlocks(
+      header, &sender_ssrc,
+      [&](const ReportBlock& block) { blocks.push_back(block); }));
+
+  EXPECT_EQ(kSenderSsrc, sender_ssrc);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ(kRemoteSsrc, blocks[0].source_ssrc());
+  EXPECT_EQ(kCumulativeLost, blocks[0].cumulative_lost());
+  EXPECT_EQ(kDelayLastSr, blocks[0].delay_since_last_sr());
+}
+
+TEST(RtcpPacketReceiverReportTest, ParseReportBlocksFailsOnIncorrectSize) {
+  rtc::Buffer damaged_packet(kPacket);
+  damaged_packet[0]++;  // Damage the packet: increase count field.
+  rtcp::CommonHeader header;
+  ASSERT_TRUE(header.Parse(damaged_packet.data(), damaged_packet.size()));
+  uint32_t sender_ssrc = 0;
+  int num_blocks = 0;
+  EXPECT_FALSE(ReceiverReport::ParseReportBlocks(
+      header, &sender_ssrc, [&](const ReportBlock&) { ++num_blocks; }));
+  EXPECT_EQ(0, num_blocks);
+}
+
 TEST(RtcpPacketReceiverReportTest, CreateWithOneReportBlock) {
   ReceiverReport rr;
   rr.SetSenderSsrc(kSenderSsrc);
@@ -69,6 +69,24 @@ constexpr int64_t kTimeWrapPeriodUs = (1ll << 24) * kBaseScaleFactor;
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 //    |           recv delta          |  recv delta   | zero padding  |
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+// Number of packet statuses in |chunk|, see LastChunk::Decode().
+size_t ChunkCapacity(uint16_t chunk) {
+  if ((chunk & 0x8000) == 0)
+    return chunk & 0x1fff;
+  if ((chunk & 0x4000) == 0)
+    return 14;
+  return 7;
+}
+
+// Delta size of the |i|:th packet status in |chunk|.
+uint8_t ChunkDeltaSize(uint16_t chunk, size_t i) {
+  if ((chunk & 0x8000) == 0)
+    return (chunk >> 13) & 0x03;
+  if ((chunk & 0x4000) == 0)
+    return (chunk >> (13 - i)) & 0x01;
+  return (chunk >> 2 * (6 - i)) & 0x03;
+}
 }  // namespace
 constexpr uint8_t TransportFeedback::kFeedbackMessageType;
 constexpr size_t TransportFeedback::kMaxReportedPackets;
@@ -483,6 +501,81 @@ std::unique_ptr<TransportFeedback> TransportFeedback::ParseFrom(
   return parsed;
 }
 
+bool TransportFeedback::ParseReceivedPackets(
+    const CommonHeader& packet,
+    Header* header,
+    rtc::FunctionView<void(uint16_t sequence_number, int16_t delta_ticks)>
+        on_received_packet) {
+  RTC_DCHECK_EQ(packet.type(), kPacketType);
+  RTC_DCHECK_EQ(packet.fmt(), kFeedbackMessageType);
+
+  if (packet.payload_size_bytes() < kMinPayloadSizeBytes)
+    return false;
+
+  const uint8_t* const payload = packet.payload();
+  const uint16_t base_seq_no = ByteReader<uint16_t>::ReadBigEndian(&payload[8]);
+  const size_t status_count = ByteReader<uint16_t>::ReadBigEndian(&payload[10]);
+  if (header) {
+    header->sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+    header->media_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[4]);
+    header->base_sequence = base_seq_no;
+    header->packet_status_count = status_count;
+    header->base_time_us =
+        static_cast<int64_t>(
+            ByteReader<int32_t, 3>::ReadBigEndian(&payload[12])) *
+        kBaseScaleFactor;
+    header->feedback_sequence = payload[15];
+  }
+  if (status_count == 0)
+    return false;
+
+  // The deltas follow the last chunk, so find it before visiting anything.
+  const size_t end_index = packet.payload_size_bytes();
+  size_t delta_index = 16;
+  for (size_t statuses = 0; statuses < status_count;) {
+    if (delta_index + kChunkSizeBytes > end_index)
+      return false;
+    statuses += ChunkCapacity(
+        ByteReader<uint16_t>::ReadBigEndian(&payload[delta_index]));
+    delta_index += kChunkSizeBytes;
+  }
+
+  uint16_t seq_no = base_seq_no;
+  size_t remaining = status_count;
+  for (size_t chunk_index = 16; remaining > 0; chunk_index += kChunkSizeBytes) {
+    uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[chunk_index]);
+    size_t count = std::min(ChunkCapacity(chunk), remaining);
+    remaining -= count;
+    if ((chunk & 0x8000) == 0 && ChunkDeltaSize(chunk, 0) == 0) {
+      // Run of lost packets.
+      seq_no += count;
+      continue;
+    }
+    for (size_t i = 0; i < count; ++i, ++seq_no) {
+      switch (ChunkDeltaSize(chunk, i)) {
+        case 0:
+          break;
+        case 1:
+          if (delta_index + 1 > end_index)
+            return false;
+          on_received_packet(seq_no, payload[delta_index]);
+          delta_index += 1;
+          break;
+        case 2:
+          if (delta_index + 2 > end_index)
+            return false;
+          on_received_packet(
+              seq_no, ByteReader<int16_t>::ReadBigEndian(&payload[delta_index]));
+          delta_index += 2;
+          break;
+        default:
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool TransportFeedback::IsConsistent() const {
   size_t packet_size = kTransportFeedbackHeaderSizeBytes;
   std::vector<DeltaSize> delta_sizes;
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "webrtc/rtc_base/function_view.h"
 
 namespace webrtc {
 namespace rtcp {
@@ -65,6 +66,26 @@ class TransportFeedback : public Rtpfb {
   bool Parse(const CommonHeader& packet);
   static std::unique_ptr<TransportFeedback> ParseFrom(const uint8_t* buffer,
                                                       size_t length);
+
+  // Fixed fields of a feedback packet, as read by ParseReceivedPackets().
+  struct Header {
+    uint32_t sender_ssrc;
+    uint32_t media_ssrc;
+    uint16_t base_sequence;
+    uint16_t packet_status_count;
+    int64_t base_time_us;
+    uint8_t feedback_sequence;
+  };
+  // Streaming alternative to Parse() for receivers that only need to look at
+  // the received packets once. Fills |header| (unless null) and calls
+  // |on_received_packet| with the sequence number and delta ticks of each
+  // received packet, in order, without allocating anything. Returns false if
+  // |packet| is malformed, in which case some packets may have been visited.
+  static bool ParseReceivedPackets(
+      const CommonHeader& packet,
+      Header* header,
+      rtc::FunctionView<void(uint16_t sequence_number, int16_t delta_ticks)>
+          on_received_packet);
   // Pre and postcondition for all public methods. Should always return true.
   // This function is for tests.
   bool IsConsistent() const;
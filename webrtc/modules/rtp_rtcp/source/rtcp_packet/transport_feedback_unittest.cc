@@ -12,10 +12,15 @@
 
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 namespace {
@@ -78,6 +83,7 @@ class FeedbackTester {
     ASSERT_TRUE(feedback_->IsConsistent());
     serialized_ = feedback_->Build();
     VerifyInternal();
+    VerifyStreamingParse();
     feedback_ = TransportFeedback::ParseFrom(serialized_.data(),
                                              serialized_.size());
     ASSERT_TRUE(feedback_->IsConsistent());
@@ -106,6 +112,25 @@ class FeedbackTester {
     EXPECT_THAT(actual_deltas_us, ElementsAreArray(expected_deltas_));
   }
 
+  void VerifyStreamingParse() {
+    rtcp::CommonHeader header;
+    ASSERT_TRUE(header.Parse(serialized_.data(), serialized_.size()));
+    TransportFeedback::Header fields;
+    std::vector<uint16_t> actual_seq_nos;
+    std::vector<int64_t> actual_deltas_us;
+    ASSERT_TRUE(TransportFeedback::ParseReceivedPackets(
+        header, &fields, [&](uint16_t sequence_number, int16_t delta_ticks) {
+          actual_seq_nos.push_back(sequence_number);
+          actual_deltas_us.push_back(delta_ticks *
+                                     TransportFeedback::kDeltaScaleFactor);
+        }));
+    EXPECT_EQ(feedback_->GetBaseSequence(), fields.base_sequence);
+    EXPECT_EQ(feedback_->GetPacketStatusCount(), fields.packet_status_count);
+    EXPECT_EQ(feedback_->GetBaseTimeUs(), fields.base_time_us);
+    EXPECT_THAT(actual_seq_nos, ElementsAreArray(expected_seq_));
+    EXPECT_THAT(actual_deltas_us, ElementsAreArray(expected_deltas_));
+  }
+
   void GenerateDeltas(const uint16_t seq[],
                       const size_t length,
                       int64_t* deltas) {
@@ -466,5 +491,81 @@ TEST(RtcpPacketTest, TransportFeedback_CorrectlySplitsVectorChunks) {
   }
 }
 
+TEST(RtcpPacketTest, TransportFeedback_StreamingParseRejectsTruncatedPacket) {
+  TransportFeedback feedback;
+  feedback.SetBase(0, 0);
+  for (uint16_t i = 0; i < 20; ++i)
+    EXPECT_TRUE(feedback.AddReceivedPacket(i, i * 1000));
+  rtc::Buffer packet = feedback.Build();
+  // Claim more packet statuses than the chunks and deltas describe.
+  ByteWriter<uint16_t>::WriteBigEndian(&packet[14], 200);
+
+  rtcp::CommonHeader header;
+  ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+  EXPECT_FALSE(TransportFeedback().Parse(header));
+  EXPECT_FALSE(TransportFeedback::ParseReceivedPackets(
+      header, nullptr, [](uint16_t, int16_t) {}));
+}
+
+// Parses a corpus of random feedback packets, with losses and large deltas,
+// with both Parse() and ParseReceivedPackets().
+TEST(RtcpPacketTest, DISABLED_TransportFeedback_ParsePerf) {
+  const int kNumPackets = 1000;
+  const int kIterations = 100;
+  Random random(0x5b2f1a);
+  std::vector<rtc::Buffer> corpus;
+  uint16_t seq_no = 0;
+  int64_t time_us = 0;
+  for (int i = 0; i < kNumPackets; ++i) {
+    TransportFeedback feedback;
+    feedback.SetBase(seq_no, time_us);
+    const int num_sequence_numbers = random.Rand(10, 200);
+    for (int j = 0; j < num_sequence_numbers; ++j, ++seq_no) {
+      time_us += random.Rand(0, 10) == 0 ? random.Rand(0, 100000)
+                                         : random.Rand(0, 5000);
+      if (random.Rand(0, 20) != 0)
+        feedback.AddReceivedPacket(seq_no, time_us);
+    }
+    if (!feedback.GetReceivedPackets().empty())
+      corpus.push_back(feedback.Build());
+  }
+
+  int64_t parsed_sum = 0;
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const rtc::Buffer& packet : corpus) {
+      std::unique_ptr<TransportFeedback> feedback =
+          TransportFeedback::ParseFrom(packet.data(), packet.size());
+      ASSERT_TRUE(feedback);
+      for (const auto& received : feedback->GetReceivedPackets())
+        parsed_sum += received.sequence_number() + received.delta_ticks();
+    }
+  }
+  int64_t parse_us = rtc::TimeMicros() - start_us;
+
+  int64_t streamed_sum = 0;
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const rtc::Buffer& packet : corpus) {
+      rtcp::CommonHeader header;
+      ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+      ASSERT_TRUE(TransportFeedback::ParseReceivedPackets(
+          header, nullptr, [&](uint16_t sequence_number, int16_t delta_ticks) {
+            streamed_sum += sequence_number + delta_ticks;
+          }));
+    }
+  }
+  int64_t stream_us = rtc::TimeMicros() - start_us;
+  EXPECT_EQ(parsed_sum, streamed_sum);
+
+  const size_t num_parsed = corpus.size() * kIterations;
+  webrtc::test::PrintResult("transport_feedback", "", "parse",
+                            static_cast<size_t>(parse_us * 1000 / num_parsed),
+                            "ns/packet", false);
+  webrtc::test::PrintResult("transport_feedback", "", "streaming_parse",
+                            static_cast<size_t>(stream_us * 1000 / num_parsed),
+                            "ns/packet", false);
+}
+
 }  // namespace
 }  // namespace webrtc
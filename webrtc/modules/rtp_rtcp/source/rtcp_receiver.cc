@@ -12,6 +12,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <memory>
@@ -67,6 +68,7 @@ struct RTCPReceiver::PacketInformation {
   uint32_t receiver_estimated_max_bitrate_bps = 0;
   std::unique_ptr<rtcp::TransportFeedback> transport_feedback;
   rtc::Optional<BitrateAllocation> target_bitrate_allocation;
+  std::vector<rtcp::Sdes::Chunk> sdes_chunks;
 };
 
 // Structure for handing TMMBR and TMMBN rtcp messages (RFC5104, section 3.5.4).
@@ -85,6 +87,14 @@ struct RTCPReceiver::TmmbrInformation {
 };
 
 struct RTCPReceiver::ReportBlockWithRtt {
+  // Sort key of |received_report_blocks_|.
+  static uint64_t Key(uint32_t source_ssrc, uint32_t remote_ssrc) {
+    return (static_cast<uint64_t>(source_ssrc) << 32) | remote_ssrc;
+  }
+  uint64_t key() const {
+    return Key(report_block.source_ssrc, report_block.sender_ssrc);
+  }
+
   RTCPReportBlock report_block;
 
   int64_t last_rtt_ms = 0;
@@ -178,17 +188,9 @@ int32_t RTCPReceiver::RTT(uint32_t remote_ssrc,
                           int64_t* max_rtt_ms) const {
   rtc::CritScope lock(&rtcp_receiver_lock_);
 
-  auto it = received_report_blocks_.find(main_ssrc_);
-  if (it == received_report_blocks_.end())
-    return -1;
-
-  auto it_info = it->second.find(remote_ssrc);
-  if (it_info == it->second.end())
-    return -1;
-
-  const ReportBlockWithRtt* report_block = &it_info->second;
-
-  if (report_block->num_rtts == 0)
+  const ReportBlockWithRtt* report_block =
+      FindReportBlock(main_ssrc_, remote_ssrc);
+  if (!report_block || report_block->num_rtts == 0)
     return -1;
 
   if (last_rtt_ms)
@@ -273,12 +275,42 @@ int32_t RTCPReceiver::StatisticsReceived(
     std::vector<RTCPReportBlock>* receive_blocks) const {
   RTC_DCHECK(receive_blocks);
   rtc::CritScope lock(&rtcp_receiver_lock_);
-  for (const auto& reports_per_receiver : received_report_blocks_)
-    for (const auto& report : reports_per_receiver.second)
-      receive_blocks->push_back(report.second.report_block);
+  for (const ReportBlockWithRtt& report : received_report_blocks_)
+    receive_blocks->push_back(report.report_block);
   return 0;
 }
 
+const RTCPReceiver::ReportBlockWithRtt* RTCPReceiver::FindReportBlock(
+    uint32_t source_ssrc,
+    uint32_t remote_ssrc) const {
+  const uint64_t key = ReportBlockWithRtt::Key(source_ssrc, remote_ssrc);
+  auto it = std::lower_bound(
+      received_report_blocks_.begin(), received_report_blocks_.end(), key,
+      [](const ReportBlockWithRtt& block, uint64_t key) {
+        return block.key() < key;
+      });
+  if (it == received_report_blocks_.end() || it->key() != key)
+    return nullptr;
+  return &*it;
+}
+
+RTCPReceiver::ReportBlockWithRtt* RTCPReceiver::FindOrCreateReportBlock(
+    uint32_t source_ssrc,
+    uint32_t remote_ssrc) {
+  const uint64_t key = ReportBlockWithRtt::Key(source_ssrc, remote_ssrc);
+  auto it = std::lower_bound(
+      received_report_blocks_.begin(), received_report_blocks_.end(), key,
+      [](const ReportBlockWithRtt& block, uint64_t key) {
+        return block.key() < key;
+      });
+  if (it == received_report_blocks_.end() || it->key() != key) {
+    it = received_report_blocks_.insert(it, ReportBlockWithRtt());
+    it->report_block.source_ssrc = source_ssrc;
+    it->report_block.sender_ssrc = remote_ssrc;
+  }
+  return &*it;
+}
+
 bool RTCPReceiver::ParseCompoundPacket(const uint8_t* packet_begin,
                                        const uint8_t* packet_end,
                                        PacketInformation* packet_information) {
@@ -417,16 +449,19 @@ void RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
 
 void RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
                                         PacketInformation* packet_information) {
-  rtcp::ReceiverReport receiver_report;
-  if (!receiver_report.Parse(rtcp_block)) {
+  // Report blocks are handled as they are parsed, since they don't depend on
+  // the state updated below.
+  uint32_t remote_ssrc = 0;
+  if (!rtcp::ReceiverReport::ParseReportBlocks(
+          rtcp_block, &remote_ssrc, [&](const ReportBlock& report_block) {
+            HandleReportBlock(report_block, packet_information, remote_ssrc);
+          })) {
     ++num_skipped_packets_;
     return;
   }
 
   last_received_rr_ms_ = clock_->TimeInMilliseconds();
 
-  const uint32_t remote_ssrc = receiver_report.sender_ssrc();
-
   packet_information->remote_ssrc = remote_ssrc;
 
   UpdateTmmbrRemoteIsAlive(remote_ssrc);
@@ -435,9 +470,6 @@ void RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
                        "remote_ssrc", remote_ssrc, "ssrc", main_ssrc_);
 
   packet_information->packet_type_flags |= kRtcpRr;
-
-  for (const ReportBlock& report_block : receiver_report.report_blocks())
-    HandleReportBlock(report_block, packet_information, remote_ssrc);
 }
 
 void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
@@ -457,9 +489,7 @@ void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
     return;
 
   ReportBlockWithRtt* report_block_info =
-      &received_report_blocks_[report_block.source_ssrc()][remote_ssrc];
-  report_block_info->report_block.sender_ssrc = remote_ssrc;
-  report_block_info->report_block.source_ssrc = report_block.source_ssrc();
+      FindOrCreateReportBlock(report_block.source_ssrc(), remote_ssrc);
   report_block_info->report_block.fraction_lost = report_block.fraction_lost();
   report_block_info->report_block.packets_lost = report_block.cumulative_lost();
   if (report_block.extended_high_seq_num() >
@@ -618,14 +648,11 @@ void RTCPReceiver::HandleSdes(const CommonHeader& rtcp_block,
     return;
   }
 
-  for (const rtcp::Sdes::Chunk& chunk : sdes.chunks()) {
+  for (const rtcp::Sdes::Chunk& chunk : sdes.chunks())
     received_cnames_[chunk.ssrc] = chunk.cname;
-    {
-      rtc::CritScope lock(&feedbacks_lock_);
-      if (stats_callback_)
-        stats_callback_->CNameChanged(chunk.cname.c_str(), chunk.ssrc);
-    }
-  }
+  // The CNAME callbacks are made from TriggerCallbacksFromRtcpPacket(), outside
+  // |rtcp_receiver_lock_|.
+  packet_information->sdes_chunks = sdes.chunks();
   packet_information->packet_type_flags |= kRtcpSdes;
 }
 
@@ -662,8 +689,14 @@ void RTCPReceiver::HandleBye(const CommonHeader& rtcp_block) {
   }
 
   // Clear our lists.
-  for (auto& reports_per_receiver : received_report_blocks_)
-    reports_per_receiver.second.erase(bye.sender_ssrc());
+  const uint32_t sender_ssrc = bye.sender_ssrc();
+  received_report_blocks_.erase(
+      std::remove_if(received_report_blocks_.begin(),
+                     received_report_blocks_.end(),
+                     [sender_ssrc](const ReportBlockWithRtt& block) {
+                       return block.report_block.sender_ssrc == sender_ssrc;
+                     }),
+      received_report_blocks_.end());
 
   TmmbrInformation* tmmbr_info = GetTmmbrInformation(bye.sender_ssrc());
   if (tmmbr_info)
@@ -994,6 +1027,14 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
         *packet_information.target_bitrate_allocation);
   }
 
+  if (!packet_information.sdes_chunks.empty()) {
+    rtc::CritScope cs(&feedbacks_lock_);
+    if (stats_callback_) {
+      for (const rtcp::Sdes::Chunk& chunk : packet_information.sdes_chunks)
+        stats_callback_->CNameChanged(chunk.cname.c_str(), chunk.ssrc);
+    }
+  }
+
   if (!receiver_only_) {
     rtc::CritScope cs(&feedbacks_lock_);
     if (stats_callback_) {
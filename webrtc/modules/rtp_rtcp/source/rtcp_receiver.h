@@ -117,10 +117,15 @@ class RTCPReceiver {
   struct TmmbrInformation;
   struct ReportBlockWithRtt;
   struct LastFirStatus;
-  // RTCP report blocks mapped by remote SSRC.
-  using ReportBlockInfoMap = std::map<uint32_t, ReportBlockWithRtt>;
-  // RTCP report blocks map mapped by source SSRC.
-  using ReportBlockMap = std::map<uint32_t, ReportBlockInfoMap>;
+
+  // Returns the report block from |remote_ssrc| about |source_ssrc|, or
+  // nullptr if there is none.
+  const ReportBlockWithRtt* FindReportBlock(uint32_t source_ssrc,
+                                            uint32_t remote_ssrc) const
+      EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
+  ReportBlockWithRtt* FindOrCreateReportBlock(uint32_t source_ssrc,
+                                              uint32_t remote_ssrc)
+      EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
   bool ParseCompoundPacket(const uint8_t* packet_begin,
                            const uint8_t* packet_end,
@@ -239,7 +244,11 @@ class RTCPReceiver {
   std::map<uint32_t, TmmbrInformation> tmmbr_infos_
       GUARDED_BY(rtcp_receiver_lock_);
 
-  ReportBlockMap received_report_blocks_ GUARDED_BY(rtcp_receiver_lock_);
+  // Received report blocks, sorted by source SSRC and then remote SSRC. There
+  // is one per (registered SSRC, remote SSRC) pair, so a sorted vector is both
+  // smaller and faster to search than nested maps.
+  std::vector<ReportBlockWithRtt> received_report_blocks_
+      GUARDED_BY(rtcp_receiver_lock_);
   std::map<uint32_t, LastFirStatus> last_fir_ GUARDED_BY(rtcp_receiver_lock_);
   std::map<uint32_t, std::string> received_cnames_
       GUARDED_BY(rtcp_receiver_lock_);
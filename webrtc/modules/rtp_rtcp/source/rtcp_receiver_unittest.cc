@@ -43,6 +43,7 @@ namespace {
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::Field;
 using ::testing::IsEmpty;
@@ -580,6 +581,45 @@ TEST_F(RtcpReceiverTest, InjectByePacket_RemovesReportBlocks) {
   EXPECT_EQ(2u, received_blocks.size());
 }
 
+TEST_F(RtcpReceiverTest, InjectByePacket_KeepsReportBlocksFromOtherSenders) {
+  const uint32_t kOtherSenderSsrc = kSenderSsrc + 1;
+  rtcp::ReportBlock rb1;
+  rb1.SetMediaSsrc(kReceiverMainSsrc);
+  rb1.SetFractionLost(10);
+  rtcp::ReportBlock rb2;
+  rb2.SetMediaSsrc(kReceiverExtraSsrc);
+  rb2.SetFractionLost(20);
+  rtcp::ReceiverReport rr1;
+  rr1.SetSenderSsrc(kSenderSsrc);
+  rr1.AddReportBlock(rb1);
+  rr1.AddReportBlock(rb2);
+  rb1.SetFractionLost(30);
+  rtcp::ReceiverReport rr2;
+  rr2.SetSenderSsrc(kOtherSenderSsrc);
+  rr2.AddReportBlock(rb1);
+
+  EXPECT_CALL(rtp_rtcp_impl_, OnReceivedRtcpReportBlocks(_)).Times(2);
+  EXPECT_CALL(bandwidth_observer_, OnReceivedRtcpReceiverReport(_, _, _))
+      .Times(2);
+  InjectRtcpPacket(rr1);
+  InjectRtcpPacket(rr2);
+
+  std::vector<RTCPReportBlock> received_blocks;
+  rtcp_receiver_.StatisticsReceived(&received_blocks);
+  EXPECT_EQ(3u, received_blocks.size());
+
+  rtcp::Bye bye;
+  bye.SetSenderSsrc(kSenderSsrc);
+  InjectRtcpPacket(bye);
+
+  received_blocks.clear();
+  rtcp_receiver_.StatisticsReceived(&received_blocks);
+  EXPECT_THAT(received_blocks,
+              ElementsAre(AllOf(
+                  Field(&RTCPReportBlock::sender_ssrc, kOtherSenderSsrc),
+                  Field(&RTCPReportBlock::fraction_lost, 30))));
+}
+
 TEST_F(RtcpReceiverTest, InjectPliPacket) {
   rtcp::Pli pli;
   pli.SetMediaSsrc(kReceiverMainSsrc);
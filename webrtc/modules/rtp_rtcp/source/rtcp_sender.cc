@@ -119,6 +119,35 @@ class PacketContainer : public rtcp::CompoundPacket,
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(PacketContainer);
 };
 
+namespace {
+// An RTCP packet that is already serialized, such as a cached SDES.
+class PrebuiltPacket : public rtcp::RtcpPacket {
+ public:
+  explicit PrebuiltPacket(const rtc::Buffer& data)
+      : data_(data.data(), data.size()) {}
+
+  size_t BlockLength() const override { return data_.size(); }
+
+  bool Create(uint8_t* packet,
+              size_t* index,
+              size_t max_length,
+              PacketReadyCallback* callback) const override {
+    while (*index + BlockLength() > max_length) {
+      if (!OnBufferFull(packet, index, callback))
+        return false;
+    }
+    memcpy(&packet[*index], data_.data(), data_.size());
+    *index += data_.size();
+    return true;
+  }
+
+ private:
+  const rtc::Buffer data_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PrebuiltPacket);
+};
+}  // namespace
+
 class RTCPSender::RtcpContext {
  public:
   RtcpContext(const FeedbackState& feedback_state,
@@ -251,6 +280,8 @@ void RTCPSender::SetREMBStatus(bool enable) {
 void RTCPSender::SetREMBData(uint32_t bitrate,
                              const std::vector<uint32_t>& ssrcs) {
   rtc::CritScope lock(&critical_section_rtcp_sender_);
+  if (bitrate != remb_bitrate_ || ssrcs != remb_ssrcs_)
+    remb_cache_.Clear();
   remb_bitrate_ = bitrate;
   remb_ssrcs_ = ssrcs;
 
@@ -312,6 +343,8 @@ void RTCPSender::SetSSRC(uint32_t ssrc) {
     next_time_to_send_rtcp_ = clock_->TimeInMilliseconds() + 100;
   }
   ssrc_ = ssrc;
+  sdes_cache_.Clear();
+  remb_cache_.Clear();
 }
 
 void RTCPSender::SetRemoteSSRC(uint32_t ssrc) {
@@ -326,6 +359,7 @@ int32_t RTCPSender::SetCNAME(const char* c_name) {
   RTC_DCHECK_LT(strlen(c_name), RTCP_CNAME_SIZE);
   rtc::CritScope lock(&critical_section_rtcp_sender_);
   cname_ = c_name;
+  sdes_cache_.Clear();
   return 0;
 }
 
@@ -340,6 +374,7 @@ int32_t RTCPSender::AddMixedCNAME(uint32_t SSRC, const char* c_name) {
     return -1;
 
   csrc_cnames_[SSRC] = c_name;
+  sdes_cache_.Clear();
   return 0;
 }
 
@@ -351,6 +386,7 @@ int32_t RTCPSender::RemoveMixedCNAME(uint32_t SSRC) {
     return -1;
 
   csrc_cnames_.erase(it);
+  sdes_cache_.Clear();
   return 0;
 }
 
@@ -462,16 +498,22 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSR(const RtcpContext& ctx) {
 
 std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSDES(
     const RtcpContext& ctx) {
-  size_t length_cname = cname_.length();
-  RTC_CHECK_LT(length_cname, RTCP_CNAME_SIZE);
+  // The SDES only changes with the CNAMEs, so it is serialized once and
+  // copied into each report.
+  if (sdes_cache_.empty()) {
+    size_t length_cname = cname_.length();
+    RTC_CHECK_LT(length_cname, RTCP_CNAME_SIZE);
 
-  rtcp::Sdes* sdes = new rtcp::Sdes();
-  sdes->AddCName(ssrc_, cname_);
+    rtcp::Sdes sdes;
+    sdes.AddCName(ssrc_, cname_);
 
-  for (const auto& it : csrc_cnames_)
-    RTC_CHECK(sdes->AddCName(it.first, it.second));
+    for (const auto& it : csrc_cnames_)
+      RTC_CHECK(sdes.AddCName(it.first, it.second));
 
-  return std::unique_ptr<rtcp::RtcpPacket>(sdes);
+    sdes_cache_ = sdes.Build();
+  }
+
+  return std::unique_ptr<rtcp::RtcpPacket>(new PrebuiltPacket(sdes_cache_));
 }
 
 std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildRR(const RtcpContext& ctx) {
@@ -514,15 +556,18 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildFIR(const RtcpContext& ctx) {
 
 std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildREMB(
     const RtcpContext& ctx) {
-  rtcp::Remb* remb = new rtcp::Remb();
-  remb->SetSenderSsrc(ssrc_);
-  remb->SetBitrateBps(remb_bitrate_);
-  remb->SetSsrcs(remb_ssrcs_);
+  if (remb_cache_.empty()) {
+    rtcp::Remb remb;
+    remb.SetSenderSsrc(ssrc_);
+    remb.SetBitrateBps(remb_bitrate_);
+    remb.SetSsrcs(remb_ssrcs_);
+    remb_cache_ = remb.Build();
+  }
 
   TRACE_EVENT_INSTANT0(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
                        "RTCPSender::REMB");
 
-  return std::unique_ptr<rtcp::RtcpPacket>(remb);
+  return std::unique_ptr<rtcp::RtcpPacket>(new PrebuiltPacket(remb_cache_));
 }
 
 void RTCPSender::SetTargetBitrate(unsigned int target_bitrate) {
@@ -28,6 +28,7 @@
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/tmmb_item.h"
+#include "webrtc/rtc_base/buffer.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/optional.h"
@@ -215,6 +216,9 @@ class RTCPSender {
       GUARDED_BY(critical_section_rtcp_sender_);
   std::map<uint32_t, std::string> csrc_cnames_
       GUARDED_BY(critical_section_rtcp_sender_);
+  // Serialized SDES built from |ssrc_|, |cname_| and |csrc_cnames_|, reused
+  // until one of them changes. Empty if not built yet.
+  rtc::Buffer sdes_cache_ GUARDED_BY(critical_section_rtcp_sender_);
 
   // send CSRCs
   std::vector<uint32_t> csrcs_ GUARDED_BY(critical_section_rtcp_sender_);
@@ -225,6 +229,9 @@ class RTCPSender {
   // REMB
   uint32_t remb_bitrate_ GUARDED_BY(critical_section_rtcp_sender_);
   std::vector<uint32_t> remb_ssrcs_ GUARDED_BY(critical_section_rtcp_sender_);
+  // Serialized REMB, reused until the REMB data or |ssrc_| changes. Empty if
+  // not built yet.
+  rtc::Buffer remb_cache_ GUARDED_BY(critical_section_rtcp_sender_);
 
   std::vector<rtcp::TmmbItem> tmmbn_to_send_
       GUARDED_BY(critical_section_rtcp_sender_);
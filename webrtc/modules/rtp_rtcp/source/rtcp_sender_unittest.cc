@@ -400,6 +400,22 @@ TEST_F(RtcpSenderTest, SendSdesWithMaxChunks) {
   EXPECT_EQ(31U, parser()->sdes()->chunks().size());
 }
 
+TEST_F(RtcpSenderTest, SendSdesAfterCnameChange) {
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ("alice@host", parser()->sdes()->chunks()[0].cname);
+  // The SDES is cached between reports, but not across CNAME changes.
+  EXPECT_EQ(0, rtcp_sender_->SetCNAME("bob@host"));
+  EXPECT_EQ(0, rtcp_sender_->AddMixedCNAME(0x1234, "smith@host"));
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpSdes));
+  EXPECT_EQ(2, parser()->sdes()->num_packets());
+  ASSERT_EQ(2U, parser()->sdes()->chunks().size());
+  EXPECT_EQ("bob@host", parser()->sdes()->chunks()[0].cname);
+  EXPECT_EQ(0x1234U, parser()->sdes()->chunks()[1].ssrc);
+  EXPECT_EQ("smith@host", parser()->sdes()->chunks()[1].cname);
+}
+
 TEST_F(RtcpSenderTest, SdesIncludedInCompoundPacket) {
   rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
   EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
@@ -542,6 +558,23 @@ TEST_F(RtcpSenderTest, SendRemb) {
               ElementsAre(kRemoteSsrc, kRemoteSsrc + 1));
 }
 
+TEST_F(RtcpSenderTest, SendRembAfterDataChange) {
+  std::vector<uint32_t> ssrcs;
+  ssrcs.push_back(kRemoteSsrc);
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
+  rtcp_sender_->SetREMBData(261011, ssrcs);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRemb));
+  EXPECT_EQ(261011U, parser()->remb()->bitrate_bps());
+  // The REMB is cached between reports, but not across data changes.
+  ssrcs.push_back(kRemoteSsrc + 1);
+  rtcp_sender_->SetREMBData(522022, ssrcs);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRemb));
+  EXPECT_EQ(2, parser()->remb()->num_packets());
+  EXPECT_EQ(522022U, parser()->remb()->bitrate_bps());
+  EXPECT_THAT(parser()->remb()->ssrcs(),
+              ElementsAre(kRemoteSsrc, kRemoteSsrc + 1));
+}
+
 TEST_F(RtcpSenderTest, RembIncludedInCompoundPacketIfEnabled) {
   const int kBitrate = 261011;
   std::vector<uint32_t> ssrcs;
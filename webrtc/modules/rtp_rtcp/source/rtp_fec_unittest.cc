@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <list>
 #include <memory>
+#include <string>
 
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/fec_test_helper.h"
@@ -19,7 +20,9 @@
 #include "webrtc/modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 #include "webrtc/rtc_base/basictypes.h"
 #include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 
@@ -1032,4 +1035,78 @@ TYPED_TEST(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(this->IsRecoveryComplete());
 }
 
+TYPED_TEST(RtpFecTest, ReusesReleasedPackets) {
+  rtc::scoped_refptr<ForwardErrorCorrection::Packet> packet =
+      this->fec_.AllocatePacket();
+  packet->length = 100;
+  ForwardErrorCorrection::Packet* packet_ptr = packet.get();
+  packet = nullptr;
+
+  packet = this->fec_.AllocatePacket();
+  EXPECT_EQ(packet_ptr, packet.get());
+  EXPECT_EQ(0u, packet->length);
+
+  // Packets held on to may outlive the decoder.
+  std::unique_ptr<ForwardErrorCorrection> fec =
+      ForwardErrorCorrection::CreateFlexfec(kFlexfecSsrc, kMediaSsrc);
+  rtc::scoped_refptr<ForwardErrorCorrection::Packet> held_packet =
+      fec->AllocatePacket();
+  fec.reset();
+  held_packet = nullptr;
+}
+
+// Measures the encoding and decoding throughput, in media bytes, for a few
+// frame sizes with one media packet lost per frame.
+TYPED_TEST(RtpFecTest, DISABLED_EncodeDecodePerf) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr uint8_t kProtectionFactor = 127;
+  constexpr int kNumFrames = 2000;
+  const std::string trace =
+      TypeParam::kFecSsrc == kFlexfecSsrc ? "flexfec" : "ulpfec";
+
+  for (int num_media_packets : {4, 12, 24, 48}) {
+    int64_t encode_ns = 0;
+    int64_t decode_ns = 0;
+    int64_t media_bytes = 0;
+    for (int i = 0; i < kNumFrames; ++i) {
+      this->media_packets_ =
+          this->media_packet_generator_.ConstructMediaPackets(
+              num_media_packets);
+      for (const auto& packet : this->media_packets_)
+        media_bytes += packet->length;
+
+      this->generated_fec_packets_.clear();
+      int64_t start_ns = rtc::TimeNanos();
+      ASSERT_EQ(0, this->fec_.EncodeFec(
+                       this->media_packets_, kProtectionFactor,
+                       kNumImportantPackets, kUseUnequalProtection,
+                       kFecMaskBursty, &this->generated_fec_packets_));
+      encode_ns += rtc::TimeNanos() - start_ns;
+
+      memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+      memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+      this->media_loss_mask_[i % num_media_packets] = 1;
+      this->NetworkReceivedPackets(this->media_loss_mask_,
+                                   this->fec_loss_mask_);
+      start_ns = rtc::TimeNanos();
+      ASSERT_EQ(0, this->fec_.DecodeFec(&this->received_packets_,
+                                        &this->recovered_packets_));
+      decode_ns += rtc::TimeNanos() - start_ns;
+      ASSERT_TRUE(this->IsRecoveryComplete());
+      this->fec_.ResetState(&this->recovered_packets_);
+    }
+
+    // Bytes per nanosecond times 1000 is MB/s.
+    const std::string modifier =
+        "_" + std::to_string(num_media_packets) + "_packets";
+    webrtc::test::PrintResult(
+        "fec_encode", modifier, trace,
+        static_cast<size_t>(media_bytes * 1000 / encode_ns), "MB/s", false);
+    webrtc::test::PrintResult(
+        "fec_decode", modifier, trace,
+        static_cast<size_t>(media_bytes * 1000 / decode_ns), "MB/s", false);
+  }
+}
+
 }  // namespace webrtc
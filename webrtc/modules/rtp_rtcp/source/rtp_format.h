@@ -31,13 +31,16 @@ class RtpPacketizer {
   virtual ~RtpPacketizer() {}
 
   // Returns total number of packets which would be produced by the packetizer.
+  // Packetizers reference, rather than copy, |payload_data|, so it must stay
+  // valid until the last packet has been produced.
   virtual size_t SetPayloadData(
       const uint8_t* payload_data,
       size_t payload_size,
       const RTPFragmentationHeader* fragmentation) = 0;
 
   // Get the next payload with payload header.
-  // Write payload and set marker bit of the |packet|.
+  // Write payload and set marker bit of the |packet|. This is where the payload
+  // is copied, straight into the buffer that is eventually sent.
   // Returns true on success, false otherwise.
   virtual bool NextPacket(RtpPacketToSend* packet) = 0;
 
@@ -308,7 +308,7 @@ bool RtpPacketizerH264::NextPacket(RtpPacketToSend* rtp_packet) {
     return false;
   }
 
-  PacketUnit packet = packets_.front();
+  const PacketUnit& packet = packets_.front();
   if (packet.first_fragment && packet.last_fragment) {
     // Single NAL unit packet.
     size_t bytes_to_send = packet.source_fragment.length;
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/modules/rtp_rtcp/source/rtp_format_vp8.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace webrtc {
+namespace {
+constexpr size_t kFrameSize = 30000;
+constexpr size_t kMaxPayloadSize = 1200;
+}  // namespace
+
+// Packetizes a large key frame into packets of equal size, as done for each
+// sent VP8 frame.
+TEST(RtpPacketizerVp8Benchmark, PacketizeFrame) {
+  RTPVideoHeaderVP8 hdr_info;
+  hdr_info.InitRTPVideoHeaderVP8();
+  hdr_info.pictureId = 1234;
+  hdr_info.tl0PicIdx = 12;
+  hdr_info.temporalIdx = 0;
+  std::vector<uint8_t> frame(kFrameSize, 0x5a);
+  RtpPacketToSend packet(nullptr);
+
+  size_t num_packets = 0;
+  test::RunBenchmark("RtpPacketizerVp8_PacketizeFrame", kFrameSize, [&] {
+    RtpPacketizerVp8 packetizer(hdr_info, kMaxPayloadSize, 0);
+    packetizer.SetPayloadData(frame.data(), frame.size(), nullptr);
+    num_packets = 0;
+    while (packetizer.NextPacket(&packet))
+      ++num_packets;
+  });
+  EXPECT_GT(num_packets, kFrameSize / kMaxPayloadSize);
+}
+
+}  // namespace webrtc
@@ -65,8 +65,13 @@ Packet::Packet(const ExtensionManager* extensions)
 Packet::Packet(const Packet&) = default;
 
 Packet::Packet(const ExtensionManager* extensions, size_t capacity)
-    : buffer_(capacity) {
-  RTC_DCHECK_GE(capacity, kFixedHeaderSize);
+    : Packet(extensions, rtc::CopyOnWriteBuffer(capacity)) {}
+
+Packet::Packet(const ExtensionManager* extensions,
+               rtc::CopyOnWriteBuffer buffer)
+    : buffer_(std::move(buffer)) {
+  RTC_DCHECK_GE(buffer_.capacity(), kFixedHeaderSize);
+  buffer_.SetSize(kFixedHeaderSize);
   Clear();
   if (extensions) {
     IdentifyExtensions(*extensions);
@@ -151,35 +156,77 @@ void Packet::GetHeader(RTPHeader* header) const {
   header->sequenceNumber = SequenceNumber();
   header->timestamp = Timestamp();
   header->ssrc = Ssrc();
-  std::vector<uint32_t> csrcs = Csrcs();
-  header->numCSRCs = csrcs.size();
-  for (size_t i = 0; i < csrcs.size(); ++i) {
-    header->arrOfCSRCs[i] = csrcs[i];
+  // Read the csrcs directly rather than through Csrcs(), which allocates.
+  header->numCSRCs = data()[0] & 0x0F;
+  for (size_t i = 0; i < header->numCSRCs; ++i) {
+    header->arrOfCSRCs[i] =
+        ByteReader<uint32_t>::ReadBigEndian(&data()[kFixedHeaderSize + i * 4]);
   }
   header->paddingLength = padding_size();
   header->headerLength = headers_size();
   header->payload_type_frequency = 0;
-  header->extension.hasTransmissionTimeOffset =
-      GetExtension<TransmissionOffset>(
-          &header->extension.transmissionTimeOffset);
-  header->extension.hasAbsoluteSendTime =
-      GetExtension<AbsoluteSendTime>(&header->extension.absoluteSendTime);
-  header->extension.hasTransportSequenceNumber =
-      GetExtension<TransportSequenceNumber>(
-          &header->extension.transportSequenceNumber);
-  header->extension.hasAudioLevel = GetExtension<AudioLevel>(
-      &header->extension.voiceActivity, &header->extension.audioLevel);
-  header->extension.hasVideoRotation =
-      GetExtension<VideoOrientation>(&header->extension.videoRotation);
-  header->extension.hasVideoContentType =
-      GetExtension<VideoContentTypeExtension>(
-          &header->extension.videoContentType);
-  header->extension.has_video_timing =
-      GetExtension<VideoTimingExtension>(&header->extension.video_timing);
-  GetExtension<RtpStreamId>(&header->extension.stream_id);
-  GetExtension<RepairedRtpStreamId>(&header->extension.repaired_stream_id);
-  GetExtension<RtpMid>(&header->extension.mid);
-  GetExtension<PlayoutDelayLimits>(&header->extension.playout_delay);
+
+  // Decode all extensions in one pass over the id indexed entries, instead of
+  // looking up each extension type in turn.
+  RTPHeaderExtension* extension = &header->extension;
+  extension->hasTransmissionTimeOffset = false;
+  extension->hasAbsoluteSendTime = false;
+  extension->hasTransportSequenceNumber = false;
+  extension->hasAudioLevel = false;
+  extension->hasVideoRotation = false;
+  extension->hasVideoContentType = false;
+  extension->has_video_timing = false;
+  for (const ExtensionInfo& entry : extension_entries_) {
+    if (entry.length == 0)
+      continue;
+    rtc::ArrayView<const uint8_t> raw =
+        rtc::MakeArrayView(data() + entry.offset, entry.length);
+    switch (entry.type) {
+      case kRtpExtensionTransmissionTimeOffset:
+        extension->hasTransmissionTimeOffset =
+            TransmissionOffset::Parse(raw, &extension->transmissionTimeOffset);
+        break;
+      case kRtpExtensionAudioLevel:
+        extension->hasAudioLevel = AudioLevel::Parse(
+            raw, &extension->voiceActivity, &extension->audioLevel);
+        break;
+      case kRtpExtensionAbsoluteSendTime:
+        extension->hasAbsoluteSendTime =
+            AbsoluteSendTime::Parse(raw, &extension->absoluteSendTime);
+        break;
+      case kRtpExtensionVideoRotation:
+        extension->hasVideoRotation =
+            VideoOrientation::Parse(raw, &extension->videoRotation);
+        break;
+      case kRtpExtensionTransportSequenceNumber:
+        extension->hasTransportSequenceNumber = TransportSequenceNumber::Parse(
+            raw, &extension->transportSequenceNumber);
+        break;
+      case kRtpExtensionPlayoutDelay:
+        PlayoutDelayLimits::Parse(raw, &extension->playout_delay);
+        break;
+      case kRtpExtensionVideoContentType:
+        extension->hasVideoContentType =
+            VideoContentTypeExtension::Parse(raw, &extension->videoContentType);
+        break;
+      case kRtpExtensionVideoTiming:
+        extension->has_video_timing =
+            VideoTimingExtension::Parse(raw, &extension->video_timing);
+        break;
+      case kRtpExtensionRtpStreamId:
+        RtpStreamId::Parse(raw, &extension->stream_id);
+        break;
+      case kRtpExtensionRepairedRtpStreamId:
+        RepairedRtpStreamId::Parse(raw, &extension->repaired_stream_id);
+        break;
+      case kRtpExtensionMid:
+        RtpMid::Parse(raw, &extension->mid);
+        break;
+      case kRtpExtensionNone:
+      case kRtpExtensionNumberOfExtensions:
+        break;
+    }
+  }
 }
 
 size_t Packet::headers_size() const {
@@ -416,11 +463,18 @@ bool Packet::SetPadding(uint8_t size_bytes, Random* random) {
   buffer_.SetSize(payload_offset_ + payload_size_ + padding_size_);
   if (padding_size_ > 0) {
     size_t padding_offset = payload_offset_ + payload_size_;
-    size_t padding_end = padding_offset + padding_size_;
-    for (size_t offset = padding_offset; offset < padding_end - 1; ++offset) {
-      WriteAt(offset, random->Rand<uint8_t>());
+    uint8_t* padding = WriteAt(padding_offset);
+    // Fills four random bytes at a time, since this is done for every padding
+    // packet.
+    const size_t random_size = padding_size_ - 1;
+    size_t i = 0;
+    for (; i + sizeof(uint32_t) <= random_size; i += sizeof(uint32_t)) {
+      const uint32_t word = random->Rand<uint32_t>();
+      memcpy(padding + i, &word, sizeof(word));
     }
-    WriteAt(padding_end - 1, padding_size_);
+    for (; i < random_size; ++i)
+      padding[i] = random->Rand<uint8_t>();
+    padding[random_size] = padding_size_;
     WriteAt(0, data()[0] | 0x20);  // Set padding bit.
   } else {
     WriteAt(0, data()[0] & ~0x20);  // Clear padding bit.
@@ -127,6 +127,9 @@ class Packet {
   explicit Packet(const ExtensionManager* extensions);
   Packet(const Packet&);
   Packet(const ExtensionManager* extensions, size_t capacity);
+  // Writes the packet into |buffer|, whose capacity bounds the packet size.
+  // Lets the storage come from e.g. a CopyOnWriteBufferPool.
+  Packet(const ExtensionManager* extensions, rtc::CopyOnWriteBuffer buffer);
   virtual ~Packet();
 
   Packet& operator=(const Packet&) = default;
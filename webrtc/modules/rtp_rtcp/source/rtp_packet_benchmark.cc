@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace webrtc {
+namespace {
+constexpr size_t kPayloadSize = 1100;
+}  // namespace
+
+TEST(RtpPacketBenchmark, ParseWithExtensions) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register<TransmissionOffset>(1);
+  extensions.Register<AbsoluteSendTime>(2);
+  extensions.Register<TransportSequenceNumber>(3);
+  extensions.Register<VideoOrientation>(4);
+  RtpPacketToSend packet(&extensions);
+  packet.SetPayloadType(100);
+  packet.SetSequenceNumber(1234);
+  packet.SetTimestamp(90000);
+  packet.SetSsrc(0x12345678);
+  packet.SetExtension<TransmissionOffset>(100);
+  packet.SetExtension<AbsoluteSendTime>(0x123456);
+  packet.SetExtension<TransportSequenceNumber>(4321);
+  packet.SetExtension<VideoOrientation>(kVideoRotation_90);
+  memset(packet.AllocatePayload(kPayloadSize), 0x5a, kPayloadSize);
+
+  RtpPacketReceived received(&extensions);
+  uint16_t transport_sequence_number = 0;
+  test::RunBenchmark("RtpPacket_ParseWithExtensions", packet.size(), [&] {
+    RTC_CHECK(received.Parse(packet.data(), packet.size()));
+    received.GetExtension<TransportSequenceNumber>(&transport_sequence_number);
+  });
+  EXPECT_EQ(4321, transport_sequence_number);
+}
+
+}  // namespace webrtc
@@ -22,11 +22,18 @@
 namespace webrtc {
 namespace {
 constexpr size_t kMinPacketRequestBytes = 50;
+// The number of most recently stored packets that are searched for the best
+// fitting packet. The history can hold thousands of packets, and this is done
+// for every redundant payload sent while probing.
+constexpr size_t kMaxBestFittingCandidates = 64;
 }  // namespace
 constexpr size_t RtpPacketHistory::kMaxCapacity;
 
 RtpPacketHistory::RtpPacketHistory(Clock* clock)
-    : clock_(clock), store_(false), prev_index_(0) {}
+    : clock_(clock),
+      store_(false),
+      prev_index_(0),
+      num_coalesced_retransmissions_(0) {}
 
 RtpPacketHistory::~RtpPacketHistory() {}
 
@@ -119,19 +126,53 @@ bool RtpPacketHistory::HasRtpPacket(uint16_t sequence_number) const {
   return FindSeqNum(sequence_number, &unused_index);
 }
 
+size_t RtpPacketHistory::NumCoalescedRetransmissions() const {
+  rtc::CritScope cs(&critsect_);
+  return num_coalesced_retransmissions_;
+}
+
 std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
     uint16_t sequence_number,
     int64_t min_elapsed_time_ms,
     bool retransmit) {
   rtc::CritScope cs(&critsect_);
-  if (!store_) {
+  int index =
+      FindPacketAndSetSendTime(sequence_number, min_elapsed_time_ms, retransmit);
+  if (index < 0)
     return nullptr;
+  return GetPacket(index);
+}
+
+rtc::Optional<RtpPacketHistory::PacketState>
+RtpPacketHistory::GetPacketStateAndSetSendTime(uint16_t sequence_number,
+                                               int64_t min_elapsed_time_ms,
+                                               bool retransmit) {
+  rtc::CritScope cs(&critsect_);
+  int index =
+      FindPacketAndSetSendTime(sequence_number, min_elapsed_time_ms, retransmit);
+  if (index < 0)
+    return rtc::Optional<PacketState>();
+  const RtpPacketToSend& stored = *stored_packets_[index].packet;
+  PacketState state;
+  state.ssrc = stored.Ssrc();
+  state.sequence_number = stored.SequenceNumber();
+  state.capture_time_ms = stored.capture_time_ms();
+  state.packet_size = stored.size();
+  state.payload_size = stored.payload_size();
+  return rtc::Optional<PacketState>(state);
+}
+
+int RtpPacketHistory::FindPacketAndSetSendTime(uint16_t sequence_number,
+                                               int64_t min_elapsed_time_ms,
+                                               bool retransmit) {
+  if (!store_) {
+    return -1;
   }
 
   int index = 0;
   if (!FindSeqNum(sequence_number, &index)) {
     LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
-    return nullptr;
+    return -1;
   }
   RTC_DCHECK_EQ(sequence_number,
                 stored_packets_[index].packet->SequenceNumber());
@@ -142,21 +183,23 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
   if (min_elapsed_time_ms > 0 && retransmit &&
       stored_packets_[index].has_been_retransmitted &&
       ((now - stored_packets_[index].send_time) < min_elapsed_time_ms)) {
-    return nullptr;
+    ++num_coalesced_retransmissions_;
+    return -1;
   }
 
   if (retransmit) {
     if (stored_packets_[index].storage_type == kDontRetransmit) {
       // No bytes copied since this packet shouldn't be retransmitted.
-      return nullptr;
+      return -1;
     }
     stored_packets_[index].has_been_retransmitted = true;
   }
   stored_packets_[index].send_time = clock_->TimeInMilliseconds();
-  return GetPacket(index);
+  return index;
 }
 
 std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacket(int index) const {
+  // Shallow copy, the packet buffer is reference counted.
   const RtpPacketToSend& stored = *stored_packets_[index].packet;
   return std::unique_ptr<RtpPacketToSend>(new RtpPacketToSend(stored));
 }
@@ -205,15 +248,22 @@ int RtpPacketHistory::FindBestFittingPacket(size_t size) const {
     return -1;
   size_t min_diff = std::numeric_limits<size_t>::max();
   int best_index = -1;  // Returned unchanged if we don't find anything.
-  for (size_t i = 0; i < stored_packets_.size(); ++i) {
-    if (!stored_packets_[i].packet)
+  const size_t num_candidates =
+      std::min(stored_packets_.size(), kMaxBestFittingCandidates);
+  // Search backwards from the most recently stored packet.
+  size_t index = prev_index_;
+  for (size_t i = 0; i < num_candidates; ++i) {
+    index = (index == 0 ? stored_packets_.size() : index) - 1;
+    if (!stored_packets_[index].packet)
       continue;
-    size_t stored_size = stored_packets_[i].packet->size();
+    size_t stored_size = stored_packets_[index].packet->size();
     size_t diff =
         (stored_size > size) ? (stored_size - size) : (size - stored_size);
     if (diff < min_diff) {
       min_diff = diff;
-      best_index = static_cast<int>(i);
+      best_index = static_cast<int>(index);
+      if (diff == 0)
+        break;
     }
   }
   return best_index;
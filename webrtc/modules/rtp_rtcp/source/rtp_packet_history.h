@@ -17,6 +17,7 @@
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/typedefs.h"
 
@@ -27,6 +28,15 @@ class RtpPacketToSend;
 
 class RtpPacketHistory {
  public:
+  // Snapshot of a stored packet, for callers that only need to know about it.
+  struct PacketState {
+    uint32_t ssrc = 0;
+    uint16_t sequence_number = 0;
+    int64_t capture_time_ms = 0;
+    size_t packet_size = 0;
+    size_t payload_size = 0;
+  };
+
   static constexpr size_t kMaxCapacity = 9600;
   explicit RtpPacketHistory(Clock* clock);
   ~RtpPacketHistory();
@@ -44,16 +54,29 @@ class RtpPacketHistory {
   // the last time the packet was resent (parameter is ignored if set to zero).
   // If the packet is found but the minimum time has not elapsed, returns
   // nullptr.
+  // The returned packet shares its storage with the stored one; the bytes are
+  // only copied if the returned packet is modified.
   std::unique_ptr<RtpPacketToSend> GetPacketAndSetSendTime(
       uint16_t sequence_number,
       int64_t min_elapsed_time_ms,
       bool retransmit);
 
+  // Same as GetPacketAndSetSendTime(), but only returns the state of the
+  // packet instead of a copy of it.
+  rtc::Optional<PacketState> GetPacketStateAndSetSendTime(
+      uint16_t sequence_number,
+      int64_t min_elapsed_time_ms,
+      bool retransmit);
+
   std::unique_ptr<RtpPacketToSend> GetBestFittingPacket(
       size_t packet_size) const;
 
   bool HasRtpPacket(uint16_t sequence_number) const;
 
+  // Number of retransmission requests ignored because the packet had been
+  // retransmitted less than |min_elapsed_time_ms| before.
+  size_t NumCoalescedRetransmissions() const;
+
  private:
   struct StoredPacket {
     uint16_t sequence_number = 0;
@@ -66,6 +89,11 @@ class RtpPacketHistory {
 
   std::unique_ptr<RtpPacketToSend> GetPacket(int index) const
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  // Returns the index of the packet, or -1 if there is none that may be sent.
+  int FindPacketAndSetSendTime(uint16_t sequence_number,
+                               int64_t min_elapsed_time_ms,
+                               bool retransmit)
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void Allocate(size_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void Free() EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   bool FindSeqNum(uint16_t sequence_number, int* index) const
@@ -78,6 +106,7 @@ class RtpPacketHistory {
   bool store_ GUARDED_BY(critsect_);
   uint32_t prev_index_ GUARDED_BY(critsect_);
   std::vector<StoredPacket> stored_packets_ GUARDED_BY(critsect_);
+  size_t num_coalesced_retransmissions_ GUARDED_BY(critsect_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtpPacketHistory);
 };
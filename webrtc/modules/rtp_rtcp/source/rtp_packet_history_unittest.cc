@@ -39,6 +39,8 @@ class RtpPacketHistoryTest : public ::testing::Test {
   }
 };
 
+constexpr uint16_t RtpPacketHistoryTest::kSeqNum;
+
 TEST_F(RtpPacketHistoryTest, SetStoreStatus) {
   EXPECT_FALSE(hist_.StorePackets());
   hist_.SetStorePacketsStatus(true, 10);
@@ -141,8 +143,10 @@ TEST_F(RtpPacketHistoryTest, MinResendTime) {
   fake_clock_.AdvanceTimeMilliseconds(kMinRetransmitIntervalMs - 1);
   // Time has not elapsed. Packet should be found, but no bytes copied.
   EXPECT_TRUE(hist_.HasRtpPacket(kSeqNum));
+  EXPECT_EQ(0u, hist_.NumCoalescedRetransmissions());
   EXPECT_FALSE(
       hist_.GetPacketAndSetSendTime(kSeqNum, kMinRetransmitIntervalMs, true));
+  EXPECT_EQ(1u, hist_.NumCoalescedRetransmissions());
 }
 
 TEST_F(RtpPacketHistoryTest, EarlyFirstResend) {
@@ -173,6 +177,86 @@ TEST_F(RtpPacketHistoryTest, EarlyFirstResend) {
       hist_.GetPacketAndSetSendTime(kSeqNum, kMinRetransmitIntervalMs, true));
 }
 
+TEST_F(RtpPacketHistoryTest, ReturnedPacketSharesStoredBuffer) {
+  hist_.SetStorePacketsStatus(true, 10);
+  std::unique_ptr<RtpPacketToSend> packet = CreateRtpPacket(kSeqNum);
+  packet->AllocatePayload(1000);
+  const uint8_t* stored_data = packet->data();
+  hist_.PutRtpPacket(std::move(packet), kAllowRetransmission, false);
+
+  std::unique_ptr<RtpPacketToSend> packet_out =
+      hist_.GetPacketAndSetSendTime(kSeqNum, 0, true);
+  ASSERT_TRUE(packet_out);
+  EXPECT_EQ(stored_data, packet_out->data());
+
+  // Modifying the returned packet must not affect the stored one.
+  packet_out->SetSequenceNumber(kSeqNum + 1);
+  EXPECT_NE(stored_data, packet_out->data());
+  packet_out = hist_.GetPacketAndSetSendTime(kSeqNum, 0, true);
+  ASSERT_TRUE(packet_out);
+  EXPECT_EQ(stored_data, packet_out->data());
+  EXPECT_EQ(kSeqNum, packet_out->SequenceNumber());
+}
+
+TEST_F(RtpPacketHistoryTest, GetPacketState) {
+  static const int64_t kMinRetransmitIntervalMs = 100;
+
+  hist_.SetStorePacketsStatus(true, 10);
+  std::unique_ptr<RtpPacketToSend> packet = CreateRtpPacket(kSeqNum);
+  packet->SetSsrc(1234);
+  packet->AllocatePayload(100);
+  const size_t packet_size = packet->size();
+  const int64_t capture_time_ms = packet->capture_time_ms();
+  hist_.PutRtpPacket(std::move(packet), kAllowRetransmission, true);
+
+  rtc::Optional<RtpPacketHistory::PacketState> state =
+      hist_.GetPacketStateAndSetSendTime(kSeqNum, kMinRetransmitIntervalMs,
+                                         true);
+  ASSERT_TRUE(state);
+  EXPECT_EQ(1234u, state->ssrc);
+  EXPECT_EQ(kSeqNum, state->sequence_number);
+  EXPECT_EQ(capture_time_ms, state->capture_time_ms);
+  EXPECT_EQ(packet_size, state->packet_size);
+  EXPECT_EQ(100u, state->payload_size);
+
+  // The retransmission counts as a send, same as when getting the packet.
+  fake_clock_.AdvanceTimeMilliseconds(kMinRetransmitIntervalMs - 1);
+  EXPECT_FALSE(hist_.GetPacketStateAndSetSendTime(
+      kSeqNum, kMinRetransmitIntervalMs, true));
+  EXPECT_FALSE(
+      hist_.GetPacketAndSetSendTime(kSeqNum, kMinRetransmitIntervalMs, true));
+  EXPECT_FALSE(hist_.GetPacketStateAndSetSendTime(kSeqNum + 1, 0, false));
+}
+
+TEST_F(RtpPacketHistoryTest, GetBestFittingPacket) {
+  const size_t kNumPackets = 1000;
+  hist_.SetStorePacketsStatus(true, kNumPackets);
+  EXPECT_FALSE(hist_.GetBestFittingPacket(500));
+
+  // Payload sizes cycle from 0 to 990 bytes.
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        CreateRtpPacket(static_cast<uint16_t>(kSeqNum + i));
+    packet->SetPayloadSize((i % 100) * 10);
+    hist_.PutRtpPacket(std::move(packet), kAllowRetransmission, true);
+  }
+
+  // Requests smaller than the minimum get nothing.
+  EXPECT_FALSE(hist_.GetBestFittingPacket(10));
+  // Among equally good fits, the most recent packet is used.
+  std::unique_ptr<RtpPacketToSend> packet = hist_.GetBestFittingPacket(
+      RtpPacketToSend(nullptr).headers_size() + 990);
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(990u, packet->payload_size());
+  EXPECT_EQ(static_cast<uint16_t>(kSeqNum + kNumPackets - 1),
+            packet->SequenceNumber());
+
+  packet = hist_.GetBestFittingPacket(
+      RtpPacketToSend(nullptr).headers_size() + 502);
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(500u, packet->payload_size());
+}
+
 TEST_F(RtpPacketHistoryTest, DynamicExpansion) {
   hist_.SetStorePacketsStatus(true, 10);
 
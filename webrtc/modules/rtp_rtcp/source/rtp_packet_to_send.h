@@ -10,6 +10,8 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_H_
 
+#include <utility>
+
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_packet.h"
 
@@ -22,6 +24,9 @@ class RtpPacketToSend : public rtp::Packet {
   RtpPacketToSend(const RtpPacketToSend& packet) = default;
   RtpPacketToSend(const ExtensionManager* extensions, size_t capacity)
       : Packet(extensions, capacity) {}
+  RtpPacketToSend(const ExtensionManager* extensions,
+                  rtc::CopyOnWriteBuffer buffer)
+      : Packet(extensions, std::move(buffer)) {}
 
   RtpPacketToSend& operator=(const RtpPacketToSend& packet) = default;
 
@@ -563,4 +563,54 @@ TEST(RtpPacketTest, ParseLegacyTimingFrameExtension) {
   EXPECT_EQ(receivied_timing.flags, 0);
 }
 
+TEST(RtpPacketTest, GetHeaderDecodesAllExtensions) {
+  const uint8_t kTransportSequenceNumberExtensionId = 2;
+  const uint8_t kUnregisteredExtensionId = 3;
+  const uint16_t kTransportSequenceNumber = 0x1357;
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
+  extensions.Register<AudioLevel>(kAudioLevelExtensionId);
+  extensions.Register<TransportSequenceNumber>(
+      kTransportSequenceNumberExtensionId);
+  extensions.Register<RtpMid>(kRtpMidExtensionId);
+  RtpPacketToSend send_packet(&extensions);
+  send_packet.SetPayloadType(kPayloadType);
+  send_packet.SetSequenceNumber(kSeqNum);
+  send_packet.SetTimestamp(kTimestamp);
+  send_packet.SetSsrc(kSsrc);
+  send_packet.SetCsrcs(std::vector<uint32_t>(std::begin(kCsrcs),
+                                             std::end(kCsrcs)));
+  send_packet.SetExtension<TransmissionOffset>(kTimeOffset);
+  send_packet.SetExtension<AudioLevel>(kVoiceActive, kAudioLevel);
+  send_packet.SetExtension<RtpMid>(kMid);
+  const uint8_t kUnregisteredData[] = {0x42};
+  send_packet.SetRawExtension(kUnregisteredExtensionId, kUnregisteredData);
+
+  RtpPacketReceived packet(&extensions);
+  EXPECT_TRUE(packet.Parse(send_packet.Buffer()));
+  RTPHeader header;
+  // Stale values from a previous packet must not leak through.
+  header.extension.hasTransportSequenceNumber = true;
+  header.extension.transportSequenceNumber = kTransportSequenceNumber;
+  packet.GetHeader(&header);
+
+  EXPECT_EQ(kPayloadType, header.payloadType);
+  EXPECT_EQ(kSeqNum, header.sequenceNumber);
+  EXPECT_EQ(kTimestamp, header.timestamp);
+  EXPECT_EQ(kSsrc, header.ssrc);
+  ASSERT_EQ(2, header.numCSRCs);
+  EXPECT_EQ(kCsrcs[0], header.arrOfCSRCs[0]);
+  EXPECT_EQ(kCsrcs[1], header.arrOfCSRCs[1]);
+  EXPECT_EQ(packet.headers_size(), header.headerLength);
+  EXPECT_TRUE(header.extension.hasTransmissionTimeOffset);
+  EXPECT_EQ(kTimeOffset, header.extension.transmissionTimeOffset);
+  EXPECT_TRUE(header.extension.hasAudioLevel);
+  EXPECT_EQ(kVoiceActive, header.extension.voiceActivity);
+  EXPECT_EQ(kAudioLevel, header.extension.audioLevel);
+  EXPECT_STREQ(kMid, header.extension.mid.data());
+  EXPECT_FALSE(header.extension.hasTransportSequenceNumber);
+  EXPECT_FALSE(header.extension.hasAbsoluteSendTime);
+  EXPECT_FALSE(header.extension.hasVideoRotation);
+}
+
 }  // namespace webrtc
@@ -19,6 +19,7 @@
 #include "webrtc/common_types.h"
 #include "webrtc/config.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/location.h"
 #include "webrtc/rtc_base/logging.h"
 
 #ifdef _WIN32
@@ -124,6 +125,8 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
         configuration.send_packet_observer,
         configuration.retransmission_rate_limiter,
         configuration.overhead_observer));
+    rtp_sender_->SetNackCoalescingWindow(
+        configuration.nack_coalescing_window_ms);
     // Make sure rtcp sender use same timestamp offset as rtp sender.
     rtcp_sender_.SetTimestampOffset(rtp_sender_->TimestampOffset());
 
@@ -894,12 +897,12 @@ void ModuleRtpRtcpImpl::SetRtcpReceiverSsrcs(uint32_t main_ssrc) {
 }
 
 void ModuleRtpRtcpImpl::set_rtt_ms(int64_t rtt_ms) {
-  rtc::CritScope cs(&critical_section_rtt_);
+  rtc::CritScope cs(&critical_section_rtt_, RTC_FROM_HERE);
   rtt_ms_ = rtt_ms;
 }
 
 int64_t ModuleRtpRtcpImpl::rtt_ms() const {
-  rtc::CritScope cs(&critical_section_rtt_);
+  rtc::CritScope cs(&critical_section_rtt_, RTC_FROM_HERE);
   return rtt_ms_;
 }
 
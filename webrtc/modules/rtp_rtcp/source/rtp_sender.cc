@@ -45,6 +45,8 @@ constexpr uint32_t kTimestampTicksPerMs = 90;
 constexpr int kBitrateStatisticsWindowMs = 1000;
 
 constexpr size_t kMinFlexfecPacketsToStoreForPacing = 50;
+// Enough for the packets of a large key frame to be recycled.
+constexpr size_t kMaxFreePacketBuffers = 128;
 
 template <typename Extension>
 constexpr RtpExtensionSize CreateExtensionSize() {
@@ -109,6 +111,8 @@ RTPSender::RTPSender(
       transport_(transport),
       sending_media_(true),                   // Default to sending media.
       max_packet_size_(IP_PACKET_SIZE - 28),  // Default is IP-v4/UDP.
+      packet_pool_(new rtc::CopyOnWriteBufferPool(max_packet_size_,
+                                                  kMaxFreePacketBuffers)),
       payload_type_(-1),
       payload_type_map_(),
       rtp_header_extension_map_(),
@@ -135,6 +139,7 @@ RTPSender::RTPSender(
       csrcs_(),
       rtx_(kRtxOff),
       rtp_overhead_bytes_per_packet_(0),
+      nack_coalescing_window_ms_(0),
       retransmission_rate_limiter_(retransmission_rate_limiter),
       overhead_observer_(overhead_observer),
       send_side_bwe_with_overhead_(
@@ -291,6 +296,10 @@ void RTPSender::SetMaxRtpPacketSize(size_t max_packet_size) {
   RTC_DCHECK_GE(max_packet_size, 100);
   RTC_DCHECK_LE(max_packet_size, IP_PACKET_SIZE);
   rtc::CritScope lock(&send_critsect_);
+  if (max_packet_size != max_packet_size_) {
+    packet_pool_.reset(
+        new rtc::CopyOnWriteBufferPool(max_packet_size, kMaxFreePacketBuffers));
+  }
   max_packet_size_ = max_packet_size;
 }
 
@@ -547,7 +556,16 @@ size_t RTPSender::SendPadData(size_t bytes,
       }
     }
 
-    RtpPacketToSend padding_packet(&rtp_header_extension_map_);
+    RTC_DCHECK_RUNS_SERIALIZED(&padding_race_);
+    // The packet is sent before the next one is built, so reuse its buffer
+    // instead of allocating one per padding packet.
+    if (!padding_packet_) {
+      padding_packet_.reset(new RtpPacketToSend(&rtp_header_extension_map_));
+    } else {
+      padding_packet_->Clear();
+      padding_packet_->IdentifyExtensions(rtp_header_extension_map_);
+    }
+    RtpPacketToSend& padding_packet = *padding_packet_;
     padding_packet.SetPayloadType(payload_type);
     padding_packet.SetMarker(false);
     padding_packet.SetSequenceNumber(sequence_number);
@@ -588,7 +606,46 @@ bool RTPSender::StorePackets() const {
   return packet_history_.StorePackets();
 }
 
+void RTPSender::SetNackCoalescingWindow(int64_t window_ms) {
+  RTC_DCHECK_GE(window_ms, 0);
+  rtc::CritScope lock(&send_critsect_);
+  nack_coalescing_window_ms_ = window_ms;
+}
+
+size_t RTPSender::NumCoalescedNacks() const {
+  return packet_history_.NumCoalescedRetransmissions();
+}
+
 int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
+  RTC_DCHECK(retransmission_rate_limiter_);
+  if (paced_sender_) {
+    // The packet itself is fetched from the history again when the pacer
+    // sends it, only its state is needed here.
+    rtc::Optional<RtpPacketHistory::PacketState> state =
+        packet_history_.GetPacketStateAndSetSendTime(packet_id,
+                                                     min_resend_time, true);
+    if (!state) {
+      // Packet not found.
+      return 0;
+    }
+
+    // Check if we're overusing retransmission bitrate.
+    // TODO(sprang): Add histograms for nack success or failure reasons.
+    if (!retransmission_rate_limiter_->TryUseRate(state->packet_size))
+      return -1;
+
+    // Convert from TickTime to Clock since capture_time_ms is based on
+    // TickTime.
+    int64_t corrected_capture_tims_ms =
+        state->capture_time_ms + clock_delta_ms_;
+    paced_sender_->InsertPacket(RtpPacketSender::kNormalPriority, state->ssrc,
+                                state->sequence_number,
+                                corrected_capture_tims_ms, state->payload_size,
+                                true);
+
+    return state->packet_size;
+  }
+
   std::unique_ptr<RtpPacketToSend> packet =
       packet_history_.GetPacketAndSetSendTime(packet_id, min_resend_time, true);
   if (!packet) {
@@ -597,23 +654,9 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
   }
 
   // Check if we're overusing retransmission bitrate.
-  // TODO(sprang): Add histograms for nack success or failure reasons.
-  RTC_DCHECK(retransmission_rate_limiter_);
   if (!retransmission_rate_limiter_->TryUseRate(packet->size()))
     return -1;
 
-  if (paced_sender_) {
-    // Convert from TickTime to Clock since capture_time_ms is based on
-    // TickTime.
-    int64_t corrected_capture_tims_ms =
-        packet->capture_time_ms() + clock_delta_ms_;
-    paced_sender_->InsertPacket(RtpPacketSender::kNormalPriority,
-                                packet->Ssrc(), packet->SequenceNumber(),
-                                corrected_capture_tims_ms,
-                                packet->payload_size(), true);
-
-    return packet->size();
-  }
   bool rtx = (RtxStatus() & kRtxRetransmitted) > 0;
   int32_t packet_size = static_cast<int32_t>(packet->size());
   if (!PrepareAndSendPacket(std::move(packet), rtx, true, PacedPacketInfo()))
@@ -665,8 +708,13 @@ void RTPSender::OnReceivedNack(
   TRACE_EVENT2(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
                "RTPSender::OnReceivedNACK", "num_seqnum",
                nack_sequence_numbers.size(), "avg_rtt", avg_rtt);
+  int64_t min_resend_time = 5 + avg_rtt;
+  {
+    rtc::CritScope lock(&send_critsect_);
+    min_resend_time = std::max(min_resend_time, nack_coalescing_window_ms_);
+  }
   for (uint16_t seq_no : nack_sequence_numbers) {
-    const int32_t bytes_sent = ReSendPacket(seq_no, 5 + avg_rtt);
+    const int32_t bytes_sent = ReSendPacket(seq_no, min_resend_time);
     if (bytes_sent < 0) {
       // Failed to send one Sequence number. Give up the rest in this nack.
       LOG(LS_WARNING) << "Failed resending RTP packet " << seq_no
@@ -1006,8 +1054,8 @@ void RTPSender::GetDataCounters(StreamDataCounters* rtp_stats,
 
 std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   rtc::CritScope lock(&send_critsect_);
-  std::unique_ptr<RtpPacketToSend> packet(
-      new RtpPacketToSend(&rtp_header_extension_map_, max_packet_size_));
+  std::unique_ptr<RtpPacketToSend> packet(new RtpPacketToSend(
+      &rtp_header_extension_map_, packet_pool_->CreateBuffer(0)));
   RTC_DCHECK(ssrc_);
   packet->SetSsrc(*ssrc_);
   packet->SetCsrcs(csrcs_);
@@ -1022,6 +1070,25 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   return packet;
 }
 
+std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacketWithHeader(
+    const RtpPacketToSend& packet) const {
+  std::unique_ptr<RtpPacketToSend> new_packet;
+  {
+    rtc::CritScope lock(&send_critsect_);
+    if (packet.capacity() != packet_pool_->buffer_capacity()) {
+      // |packet| was made before the max packet size changed.
+      new_packet.reset(new RtpPacketToSend(packet));
+      new_packet->SetPayloadSize(0);
+      return new_packet;
+    }
+    new_packet.reset(new RtpPacketToSend(&rtp_header_extension_map_,
+                                         packet_pool_->CreateBuffer(0)));
+  }
+  new_packet->CopyHeaderFrom(packet);
+  new_packet->set_capture_time_ms(packet.capture_time_ms());
+  return new_packet;
+}
+
 bool RTPSender::AssignSequenceNumber(RtpPacketToSend* packet) {
   rtc::CritScope lock(&send_critsect_);
   if (!sending_media_)
@@ -1154,6 +1221,9 @@ bool RTPSender::SetFecParameters(const FecProtectionParams& delta_params,
   return true;
 }
 
+// |packet| normally shares its buffer with the packet history. It is only read
+// here, so that buffer is never copied; the payload is copied exactly once,
+// into the RTX packet.
 std::unique_ptr<RtpPacketToSend> RTPSender::BuildRtxPacket(
     const RtpPacketToSend& packet) {
   // TODO(danilchap): Create rtx packet with extra capacity for SRTP
@@ -27,9 +27,11 @@
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/rtc_base/array_view.h"
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/copyonwritebufferpool.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/deprecation.h"
 #include "webrtc/rtc_base/optional.h"
+#include "webrtc/rtc_base/race_checker.h"
 #include "webrtc/rtc_base/random.h"
 #include "webrtc/rtc_base/rate_statistics.h"
 #include "webrtc/rtc_base/thread_annotations.h"
@@ -134,6 +136,14 @@ class RTPSender {
 
   int32_t ReSendPacket(uint16_t packet_id, int64_t min_resend_time = 0);
 
+  // NACKs for a packet retransmitted less than |window_ms| ago are ignored,
+  // in addition to the usual RTT based limit. Lets a sender receiving the
+  // NACKs of several receivers on one RTCP session answer them with a single
+  // retransmission. Zero, the default, disables the window.
+  void SetNackCoalescingWindow(int64_t window_ms);
+  // Number of retransmission requests ignored because of the limits above.
+  size_t NumCoalescedNacks() const;
+
   // Feedback to decide when to stop sending playout delay.
   void OnReceivedRtcpReportBlocks(const ReportBlockList& report_blocks);
 
@@ -152,6 +162,12 @@ class RTPSender {
   // Create empty packet, fills ssrc, csrcs and reserve place for header
   // extensions RtpSender updates before sending.
   std::unique_ptr<RtpPacketToSend> AllocatePacket() const;
+  // Create packet with the header (and capture time) of |packet|, but without
+  // its payload, e.g. to packetize a frame after a header made by
+  // AllocatePacket(). Unlike copying |packet|, this doesn't allocate new
+  // storage once the payload is written.
+  std::unique_ptr<RtpPacketToSend> AllocatePacketWithHeader(
+      const RtpPacketToSend& packet) const;
   // Allocate sequence number for provided packet.
   // Save packet's fields to generate padding that doesn't break media stream.
   // Return false if sending was turned off.
@@ -254,6 +270,8 @@ class RTPSender {
   Clock* const clock_;
   const int64_t clock_delta_ms_;
   Random random_ GUARDED_BY(send_critsect_);
+  rtc::RaceChecker padding_race_;
+  std::unique_ptr<RtpPacketToSend> padding_packet_ GUARDED_BY(padding_race_);
 
   const bool audio_configured_;
   const std::unique_ptr<RTPSenderAudio> audio_;
@@ -269,6 +287,11 @@ class RTPSender {
   bool sending_media_ GUARDED_BY(send_critsect_);
 
   size_t max_packet_size_;
+  // Storage for the packets made by AllocatePacket(), recycled once they have
+  // been sent and dropped from the packet history. Buffers have a capacity of
+  // |max_packet_size_|, so the pool is replaced when that changes.
+  std::unique_ptr<rtc::CopyOnWriteBufferPool> packet_pool_
+      GUARDED_BY(send_critsect_);
 
   int8_t payload_type_ GUARDED_BY(send_critsect_);
   std::map<int8_t, RtpUtility::Payload*> payload_type_map_;
@@ -320,6 +343,7 @@ class RTPSender {
   // Mapping rtx_payload_type_map_[associated] = rtx.
   std::map<int8_t, int8_t> rtx_payload_type_map_ GUARDED_BY(send_critsect_);
   size_t rtp_overhead_bytes_per_packet_ GUARDED_BY(send_critsect_);
+  int64_t nack_coalescing_window_ms_ GUARDED_BY(send_critsect_);
 
   RateLimiter* const retransmission_rate_limiter_;
   OverheadObserver* overhead_observer_;
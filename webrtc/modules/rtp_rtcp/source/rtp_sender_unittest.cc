@@ -301,6 +301,44 @@ TEST_P(RtpSenderTestWithoutPacer, AllocatePacketReserveExtensions) {
   EXPECT_FALSE(packet->HasExtension<VideoOrientation>());
 }
 
+TEST_P(RtpSenderTestWithoutPacer, AllocatePacketWithHeaderCopiesHeader) {
+  ASSERT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(
+                   kRtpExtensionTransmissionTimeOffset,
+                   kTransmissionTimeOffsetExtensionId));
+  auto header = rtp_sender_->AllocatePacket();
+  header->SetPayloadType(kPayload);
+  header->SetTimestamp(kTimestamp);
+  header->set_capture_time_ms(fake_clock_.TimeInMilliseconds());
+  header->SetPayloadSize(100);
+
+  auto packet = rtp_sender_->AllocatePacketWithHeader(*header);
+
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(kPayload, packet->PayloadType());
+  EXPECT_EQ(kTimestamp, packet->Timestamp());
+  EXPECT_EQ(rtp_sender_->SSRC(), packet->Ssrc());
+  EXPECT_EQ(header->capture_time_ms(), packet->capture_time_ms());
+  EXPECT_TRUE(packet->HasExtension<TransmissionOffset>());
+  EXPECT_EQ(header->headers_size(), packet->headers_size());
+  EXPECT_EQ(0u, packet->payload_size());
+  EXPECT_EQ(header->capacity(), packet->capacity());
+  // Writing the payload leaves the header alone.
+  EXPECT_TRUE(packet->SetPayloadSize(200));
+  EXPECT_EQ(100u, header->payload_size());
+}
+
+TEST_P(RtpSenderTestWithoutPacer, AllocatePacketFollowsMaxPacketSize) {
+  auto header = rtp_sender_->AllocatePacket();
+  const size_t kMaxPacketSize = 1000;
+  rtp_sender_->SetMaxRtpPacketSize(kMaxPacketSize);
+
+  EXPECT_EQ(kMaxPacketSize, rtp_sender_->AllocatePacket()->capacity());
+  // Packets made after a header from before the change keep its capacity.
+  auto packet = rtp_sender_->AllocatePacketWithHeader(*header);
+  EXPECT_EQ(header->capacity(), packet->capacity());
+  EXPECT_EQ(0u, packet->payload_size());
+}
+
 TEST_P(RtpSenderTestWithoutPacer, AssignSequenceNumberAdvanceSequenceNumber) {
   auto packet = rtp_sender_->AllocatePacket();
   ASSERT_TRUE(packet);
@@ -1544,6 +1582,32 @@ TEST_P(RtpSenderTestWithoutPacer, RespectsNackBitrateLimit) {
   EXPECT_EQ(kNumPackets * 2, transport_.packets_sent());
 }
 
+TEST_P(RtpSenderTestWithoutPacer, CoalescesNacksWithinWindow) {
+  const int64_t kWindowMs = 100;
+  const size_t kPacketSize = 500;
+  rtp_sender_->SetStorePacketsStatus(true, 10);
+  rtp_sender_->SetNackCoalescingWindow(kWindowMs);
+  const uint16_t kSequenceNumber = rtp_sender_->SequenceNumber();
+  SendPacket(fake_clock_.TimeInMilliseconds(), kPacketSize);
+  EXPECT_EQ(1, transport_.packets_sent());
+
+  // The first request is always answered.
+  fake_clock_.AdvanceTimeMilliseconds(10);
+  rtp_sender_->OnReceivedNack({kSequenceNumber}, 0);
+  EXPECT_EQ(2, transport_.packets_sent());
+
+  // Another receiver asks for the same packet; the RTT alone would allow a
+  // new retransmission, but it is within the window.
+  fake_clock_.AdvanceTimeMilliseconds(kWindowMs / 2);
+  rtp_sender_->OnReceivedNack({kSequenceNumber}, 0);
+  EXPECT_EQ(2, transport_.packets_sent());
+  EXPECT_EQ(1u, rtp_sender_->NumCoalescedNacks());
+
+  fake_clock_.AdvanceTimeMilliseconds(kWindowMs / 2);
+  rtp_sender_->OnReceivedNack({kSequenceNumber}, 0);
+  EXPECT_EQ(3, transport_.packets_sent());
+}
+
 TEST_P(RtpSenderVideoTest, KeyFrameHasCVO) {
   uint8_t kFrame[kMaxPacketLength];
   EXPECT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(
@@ -26,7 +26,6 @@
 #include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
-#include "webrtc/rtc_base/ptr_util.h"
 #include "webrtc/rtc_base/trace_event.h"
 
 namespace webrtc {
@@ -122,8 +121,8 @@ void RTPSenderVideo::SendVideoPacketAsRedMaybeWithUlpfec(
   uint32_t rtp_timestamp = media_packet->Timestamp();
   uint16_t media_seq_num = media_packet->SequenceNumber();
 
-  std::unique_ptr<RtpPacketToSend> red_packet(
-      new RtpPacketToSend(*media_packet));
+  std::unique_ptr<RtpPacketToSend> red_packet =
+      rtp_sender_->AllocatePacketWithHeader(*media_packet);
   BuildRedPayload(*media_packet, red_packet.get());
 
   std::vector<std::unique_ptr<RedPacket>> fec_packets;
@@ -301,7 +300,7 @@ bool RTPSenderVideo::SendVideo(RtpVideoCodecTypes video_type,
   rtp_header->SetPayloadType(payload_type);
   rtp_header->SetTimestamp(rtp_timestamp);
   rtp_header->set_capture_time_ms(capture_time_ms);
-  auto last_packet = rtc::MakeUnique<RtpPacketToSend>(*rtp_header);
+  auto last_packet = rtp_sender_->AllocatePacketWithHeader(*rtp_header);
 
   size_t fec_packet_overhead;
   bool red_enabled;
@@ -383,7 +382,7 @@ bool RTPSenderVideo::SendVideo(RtpVideoCodecTypes video_type,
   for (size_t i = 0; i < num_packets; ++i) {
     bool last = (i + 1) == num_packets;
     auto packet = last ? std::move(last_packet)
-                       : rtc::MakeUnique<RtpPacketToSend>(*rtp_header);
+                       : rtp_sender_->AllocatePacketWithHeader(*rtp_header);
     if (!packetizer->NextPacket(packet.get()))
       return false;
     RTC_DCHECK_LE(packet->payload_size(),
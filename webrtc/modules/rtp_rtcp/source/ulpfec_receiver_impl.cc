@@ -20,6 +20,12 @@
 #include "webrtc/system_wrappers/include/clock.h"
 
 namespace webrtc {
+namespace {
+// How long media returned in place is still copied for FEC decoding after
+// the last ULPFEC packet. Media received before ULPFEC resumes can't be used
+// for recovery.
+constexpr int64_t kKeepMediaForFecTimeoutMs = 5000;
+}  // namespace
 
 UlpfecReceiver* UlpfecReceiver::Create(uint32_t ssrc,
                                        RecoveredPacketReceiver* callback) {
@@ -30,7 +36,9 @@ UlpfecReceiverImpl::UlpfecReceiverImpl(uint32_t ssrc,
                                        RecoveredPacketReceiver* callback)
     : ssrc_(ssrc),
       recovered_packet_callback_(callback),
-      fec_(ForwardErrorCorrection::CreateUlpfec(ssrc_)) {}
+      fec_(ForwardErrorCorrection::CreateUlpfec(ssrc_)),
+      return_media_(true),
+      last_fec_packet_time_ms_(-1) {}
 
 UlpfecReceiverImpl::~UlpfecReceiverImpl() {
   received_packets_.clear();
@@ -80,9 +88,38 @@ int32_t UlpfecReceiverImpl::AddReceivedRedPacket(
         << "Received RED packet with different SSRC than expected; dropping.";
     return -1;
   }
+  rtc::CritScope cs(&crit_sect_);
+  return AddRedPacket(header, incoming_rtp_packet, packet_length,
+                      ulpfec_payload_type, nullptr, nullptr);
+}
 
+int32_t UlpfecReceiverImpl::AddReceivedRedPacketInPlace(
+    const RTPHeader& header,
+    const uint8_t* incoming_rtp_packet,
+    size_t packet_length,
+    uint8_t ulpfec_payload_type,
+    RTPHeader* media_header,
+    rtc::ArrayView<const uint8_t>* media_payload) {
+  RTC_DCHECK(media_header);
+  RTC_DCHECK(media_payload);
+  *media_payload = rtc::ArrayView<const uint8_t>();
+  if (header.ssrc != ssrc_) {
+    LOG(LS_WARNING)
+        << "Received RED packet with different SSRC than expected; dropping.";
+    return -1;
+  }
   rtc::CritScope cs(&crit_sect_);
+  return AddRedPacket(header, incoming_rtp_packet, packet_length,
+                      ulpfec_payload_type, media_header, media_payload);
+}
 
+int32_t UlpfecReceiverImpl::AddRedPacket(
+    const RTPHeader& header,
+    const uint8_t* incoming_rtp_packet,
+    size_t packet_length,
+    uint8_t ulpfec_payload_type,
+    RTPHeader* media_header,
+    rtc::ArrayView<const uint8_t>* media_payload) {
   uint8_t red_header_length = 1;
   size_t payload_data_length = packet_length - header.headerLength;
 
@@ -91,16 +128,9 @@ int32_t UlpfecReceiverImpl::AddReceivedRedPacket(
     return -1;
   }
 
-  // Remove RED header of incoming packet and store as a virtual RTP packet.
-  std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet(
-      new ForwardErrorCorrection::ReceivedPacket());
-  received_packet->pkt = new ForwardErrorCorrection::Packet();
-
   // Get payload type from RED header and sequence number from RTP header.
   uint8_t payload_type = incoming_rtp_packet[header.headerLength] & 0x7f;
-  received_packet->is_fec = payload_type == ulpfec_payload_type;
-  received_packet->ssrc = header.ssrc;
-  received_packet->seq_num = header.sequenceNumber;
+  const bool is_fec = payload_type == ulpfec_payload_type;
 
   uint16_t block_length = 0;
   if (incoming_rtp_packet[header.headerLength] & 0x80) {
@@ -135,60 +165,45 @@ int32_t UlpfecReceiverImpl::AddReceivedRedPacket(
       return -1;
     }
   }
+  const int64_t now_ms = Clock::GetRealTimeClock()->TimeInMilliseconds();
   ++packet_counter_.num_packets;
   if (packet_counter_.first_packet_time_ms == -1) {
-    packet_counter_.first_packet_time_ms =
-        Clock::GetRealTimeClock()->TimeInMilliseconds();
+    packet_counter_.first_packet_time_ms = now_ms;
   }
+  return_media_ = media_payload == nullptr;
 
-  std::unique_ptr<ForwardErrorCorrection::ReceivedPacket>
-      second_received_packet;
+  // Locates the media and the FEC blocks of the packet, after the RED header.
+  size_t media_block_length = 0;
+  size_t fec_block_length = 0;
   if (block_length > 0) {
     // Handle block length, split into two packets.
     red_header_length = 5;
+    media_block_length = block_length;
+    fec_block_length = payload_data_length - red_header_length - block_length;
+  } else if (is_fec) {
+    fec_block_length = payload_data_length - red_header_length;
+  } else {
+    media_block_length = payload_data_length - red_header_length;
+  }
+  const uint8_t* media_block =
+      incoming_rtp_packet + header.headerLength + red_header_length;
+  const uint8_t* fec_block = media_block + media_block_length;
 
-    // Copy RTP header.
-    memcpy(received_packet->pkt->data, incoming_rtp_packet,
-           header.headerLength);
-
-    // Set payload type.
-    received_packet->pkt->data[1] &= 0x80;          // Reset RED payload type.
-    received_packet->pkt->data[1] += payload_type;  // Set media payload type.
-
-    // Copy payload data.
-    memcpy(received_packet->pkt->data + header.headerLength,
-           incoming_rtp_packet + header.headerLength + red_header_length,
-           block_length);
-    received_packet->pkt->length = block_length;
-
-    second_received_packet.reset(new ForwardErrorCorrection::ReceivedPacket);
-    second_received_packet->pkt = new ForwardErrorCorrection::Packet;
-
-    second_received_packet->is_fec = true;
-    second_received_packet->ssrc = header.ssrc;
-    second_received_packet->seq_num = header.sequenceNumber;
+  if (block_length > 0 || is_fec) {
     ++packet_counter_.num_fec_packets;
+    last_fec_packet_time_ms_ = now_ms;
+  }
 
-    // Copy FEC payload data.
-    memcpy(second_received_packet->pkt->data,
-           incoming_rtp_packet + header.headerLength + red_header_length +
-               block_length,
-           payload_data_length - red_header_length - block_length);
-
-    second_received_packet->pkt->length =
-        payload_data_length - red_header_length - block_length;
-
-  } else if (received_packet->is_fec) {
-    ++packet_counter_.num_fec_packets;
-    // everything behind the RED header
-    memcpy(received_packet->pkt->data,
-           incoming_rtp_packet + header.headerLength + red_header_length,
-           payload_data_length - red_header_length);
-    received_packet->pkt->length = payload_data_length - red_header_length;
-    received_packet->ssrc =
-        ByteReader<uint32_t>::ReadBigEndian(&incoming_rtp_packet[8]);
+  std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet;
+  const bool has_media = block_length > 0 || !is_fec;
+  if (has_media && (!media_payload || KeepMediaForFec(now_ms))) {
+    // Store as a virtual RTP packet, without the RED header.
+    received_packet.reset(new ForwardErrorCorrection::ReceivedPacket());
+    received_packet->pkt = fec_->AllocatePacket();
+    received_packet->is_fec = false;
+    received_packet->ssrc = header.ssrc;
+    received_packet->seq_num = header.sequenceNumber;
 
-  } else {
     // Copy RTP header.
     memcpy(received_packet->pkt->data, incoming_rtp_packet,
            header.headerLength);
@@ -198,29 +213,54 @@ int32_t UlpfecReceiverImpl::AddReceivedRedPacket(
     received_packet->pkt->data[1] += payload_type;  // Set media payload type.
 
     // Copy payload data.
-    memcpy(received_packet->pkt->data + header.headerLength,
-           incoming_rtp_packet + header.headerLength + red_header_length,
-           payload_data_length - red_header_length);
+    memcpy(received_packet->pkt->data + header.headerLength, media_block,
+           media_block_length);
     received_packet->pkt->length =
-        header.headerLength + payload_data_length - red_header_length;
+        block_length > 0 ? media_block_length
+                         : header.headerLength + media_block_length;
+  }
+  if (media_payload && has_media) {
+    *media_header = header;
+    media_header->payloadType = payload_type;
+    *media_payload =
+        rtc::ArrayView<const uint8_t>(media_block, media_block_length);
   }
 
-  if (received_packet->pkt->length == 0) {
-    return 0;
+  std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> fec_received_packet;
+  if (fec_block_length > 0) {
+    fec_received_packet.reset(new ForwardErrorCorrection::ReceivedPacket());
+    fec_received_packet->pkt = fec_->AllocatePacket();
+    fec_received_packet->is_fec = true;
+    fec_received_packet->ssrc =
+        block_length > 0
+            ? header.ssrc
+            : ByteReader<uint32_t>::ReadBigEndian(&incoming_rtp_packet[8]);
+    fec_received_packet->seq_num = header.sequenceNumber;
+
+    // Copy FEC payload data.
+    memcpy(fec_received_packet->pkt->data, fec_block, fec_block_length);
+    fec_received_packet->pkt->length = fec_block_length;
   }
 
-  received_packets_.push_back(std::move(received_packet));
-  if (second_received_packet) {
-    received_packets_.push_back(std::move(second_received_packet));
+  if (received_packet) {
+    received_packets_.push_back(std::move(received_packet));
+  }
+  if (fec_received_packet) {
+    received_packets_.push_back(std::move(fec_received_packet));
   }
   return 0;
 }
 
+bool UlpfecReceiverImpl::KeepMediaForFec(int64_t now_ms) const {
+  return last_fec_packet_time_ms_ >= 0 &&
+         now_ms - last_fec_packet_time_ms_ <= kKeepMediaForFecTimeoutMs;
+}
+
 int32_t UlpfecReceiverImpl::ProcessReceivedFec() {
   crit_sect_.Enter();
   if (!received_packets_.empty()) {
     // Send received media packet to VCM.
-    if (!received_packets_.front()->is_fec) {
+    if (return_media_ && !received_packets_.front()->is_fec) {
       ForwardErrorCorrection::Packet* packet = received_packets_.front()->pkt;
       crit_sect_.Leave();
       recovered_packet_callback_->OnRecoveredPacket(packet->data,
@@ -30,12 +30,30 @@ class UlpfecReceiverImpl : public UlpfecReceiver {
                                const uint8_t* incoming_rtp_packet,
                                size_t packet_length,
                                uint8_t ulpfec_payload_type) override;
+  int32_t AddReceivedRedPacketInPlace(
+      const RTPHeader& rtp_header,
+      const uint8_t* incoming_rtp_packet,
+      size_t packet_length,
+      uint8_t ulpfec_payload_type,
+      RTPHeader* media_header,
+      rtc::ArrayView<const uint8_t>* media_payload) override;
 
   int32_t ProcessReceivedFec() override;
 
   FecPacketCounter GetPacketCounter() const override;
 
  private:
+  // Implements both AddReceivedRedPacket() and AddReceivedRedPacketInPlace(),
+  // the latter if |media_payload| is set.
+  int32_t AddRedPacket(const RTPHeader& rtp_header,
+                       const uint8_t* incoming_rtp_packet,
+                       size_t packet_length,
+                       uint8_t ulpfec_payload_type,
+                       RTPHeader* media_header,
+                       rtc::ArrayView<const uint8_t>* media_payload);
+  // Whether media returned in place is to be copied for FEC decoding.
+  bool KeepMediaForFec(int64_t now_ms) const;
+
   const uint32_t ssrc_;
 
   rtc::CriticalSection crit_sect_;
@@ -46,6 +64,10 @@ class UlpfecReceiverImpl : public UlpfecReceiver {
   // arrives. We should remove the list.
   ForwardErrorCorrection::ReceivedPacketList received_packets_;
   ForwardErrorCorrection::RecoveredPacketList recovered_packets_;
+  // Whether the media of |received_packets_| is returned by
+  // ProcessReceivedFec(), i.e. was not returned in place.
+  bool return_media_;
+  int64_t last_fec_packet_time_ms_;
   FecPacketCounter packet_counter_;
 };
 
@@ -456,6 +456,65 @@ TEST_F(UlpfecReceiverTest, OldFecPacketDropped) {
   EXPECT_EQ(0, receiver_fec_->ProcessReceivedFec());
 }
 
+TEST_F(UlpfecReceiverTest, ReturnsMediaInPlaceAndKeepsItOnlyWithFec) {
+  constexpr size_t kNumFecPackets = 1u;
+  std::list<AugmentedPacket*> augmented_media_packets;
+  ForwardErrorCorrection::PacketList media_packets;
+  PacketizeFrame(2, 0, &augmented_media_packets, &media_packets);
+  PacketizeFrame(2, 2, &augmented_media_packets, &media_packets);
+  auto it = augmented_media_packets.begin();
+  RTPHeader media_header;
+  rtc::ArrayView<const uint8_t> media_payload;
+
+  // Before any FEC packet, the media is returned in place only.
+  std::unique_ptr<AugmentedPacket> red_packet =
+      packet_generator_.BuildMediaRedPacket(**it);
+  EXPECT_EQ(0, receiver_fec_->AddReceivedRedPacketInPlace(
+                   red_packet->header.header, red_packet->data,
+                   red_packet->length, kFecPayloadType, &media_header,
+                   &media_payload));
+  EXPECT_EQ((*it)->data[1] & 0x7f, media_header.payloadType);
+  EXPECT_EQ((*it)->header.header.sequenceNumber, media_header.sequenceNumber);
+  EXPECT_EQ(red_packet->data + kRtpHeaderSize + 1, media_payload.data());
+  EXPECT_EQ((*it)->length - kRtpHeaderSize, media_payload.size());
+  EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_, _)).Times(0);
+  EXPECT_EQ(0, receiver_fec_->ProcessReceivedFec());
+
+  // The second media packet can't be recovered without the first one.
+  ForwardErrorCorrection::PacketList first_frame;
+  first_frame.push_back(std::move(media_packets.front()));
+  media_packets.pop_front();
+  first_frame.push_back(std::move(media_packets.front()));
+  media_packets.pop_front();
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+  EncodeFec(first_frame, kNumFecPackets, &fec_packets);
+  red_packet = packet_generator_.BuildUlpfecRedPacket(*fec_packets.front());
+  EXPECT_EQ(0, receiver_fec_->AddReceivedRedPacketInPlace(
+                   red_packet->header.header, red_packet->data,
+                   red_packet->length, kFecPayloadType, &media_header,
+                   &media_payload));
+  EXPECT_TRUE(media_payload.empty());
+  EXPECT_EQ(0, receiver_fec_->ProcessReceivedFec());
+
+  // With FEC being received, the media is kept for recovery as well.
+  std::advance(it, 2);
+  red_packet = packet_generator_.BuildMediaRedPacket(**it);
+  EXPECT_EQ(0, receiver_fec_->AddReceivedRedPacketInPlace(
+                   red_packet->header.header, red_packet->data,
+                   red_packet->length, kFecPayloadType, &media_header,
+                   &media_payload));
+  EXPECT_FALSE(media_payload.empty());
+  EXPECT_EQ(0, receiver_fec_->ProcessReceivedFec());
+
+  fec_packets.clear();
+  EncodeFec(media_packets, kNumFecPackets, &fec_packets);
+  ++it;
+  VerifyReconstructedMediaPacket(**it, 1);
+  BuildAndAddRedFecPacket(fec_packets.front());
+  EXPECT_EQ(0, receiver_fec_->ProcessReceivedFec());
+  EXPECT_EQ(1u, receiver_fec_->GetPacketCounter().num_recovered_packets);
+}
+
 TEST_F(UlpfecReceiverTest, TruncatedPacketWithFBitSet) {
   const uint8_t kTruncatedPacket[] = {0x80, 0x2a, 0x68, 0x71, 0x29, 0xa1, 0x27,
                                       0x3a, 0x29, 0x12, 0x2a, 0x98, 0xe0, 0x29};
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_MODULES_UTILITY_INCLUDE_PROCESS_THREAD_H_
 #define WEBRTC_MODULES_UTILITY_INCLUDE_PROCESS_THREAD_H_
 
+#include <stddef.h>
+
 #include <memory>
 
 #include "webrtc/typedefs.h"
@@ -41,6 +43,10 @@ class ProcessThread {
   virtual ~ProcessThread();
 
   static std::unique_ptr<ProcessThread> Create(const char* thread_name);
+  // Creates a ProcessThread that runs modules on |num_threads| threads. See
+  // ProcessThreadImpl for the restrictions this places on modules.
+  static std::unique_ptr<ProcessThread> Create(const char* thread_name,
+                                               size_t num_threads);
 
   // Starts the worker thread.  Must be called from the construction thread.
   virtual void Start() = 0;
@@ -10,9 +10,12 @@
 
 #include "webrtc/modules/utility/source/process_thread_impl.h"
 
+#include <algorithm>
+
 #include "webrtc/modules/include/module.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/task_queue.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
 
@@ -42,14 +45,34 @@ std::unique_ptr<ProcessThread> ProcessThread::Create(
   return std::unique_ptr<ProcessThread>(new ProcessThreadImpl(thread_name));
 }
 
+// static
+std::unique_ptr<ProcessThread> ProcessThread::Create(const char* thread_name,
+                                                     size_t num_threads) {
+  return std::unique_ptr<ProcessThread>(
+      new ProcessThreadImpl(thread_name, num_threads));
+}
+
 ProcessThreadImpl::ProcessThreadImpl(const char* thread_name)
+    : ProcessThreadImpl(thread_name, 1) {}
+
+ProcessThreadImpl::ProcessThreadImpl(const char* thread_name,
+                                     size_t num_threads)
     : wake_up_(EventWrapper::Create()),
+      module_processed_(EventWrapper::Create()),
+      workers_(num_threads),
+      ready_(num_threads),
       stop_(false),
-      thread_name_(thread_name) {}
+      thread_name_(thread_name) {
+  RTC_DCHECK_GT(num_threads, 0);
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].owner = this;
+    workers_[i].index = i;
+  }
+}
 
 ProcessThreadImpl::~ProcessThreadImpl() {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
-  RTC_DCHECK(!thread_.get());
+  RTC_DCHECK(!started_);
   RTC_DCHECK(!stop_);
 
   while (!queue_.empty()) {
@@ -60,8 +83,8 @@ ProcessThreadImpl::~ProcessThreadImpl() {
 
 void ProcessThreadImpl::Start() {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
-  RTC_DCHECK(!thread_.get());
-  if (thread_.get())
+  RTC_DCHECK(!started_);
+  if (started_)
     return;
 
   RTC_DCHECK(!stop_);
@@ -69,14 +92,17 @@ void ProcessThreadImpl::Start() {
   for (ModuleCallback& m : modules_)
     m.module->ProcessThreadAttached(this);
 
-  thread_.reset(
-      new rtc::PlatformThread(&ProcessThreadImpl::Run, this, thread_name_));
-  thread_->Start();
+  for (Worker& worker : workers_) {
+    worker.thread.reset(
+        new rtc::PlatformThread(&ProcessThreadImpl::Run, &worker, thread_name_));
+    worker.thread->Start();
+  }
+  started_ = true;
 }
 
 void ProcessThreadImpl::Stop() {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
-  if(!thread_.get())
+  if (!started_)
     return;
 
   {
@@ -84,12 +110,28 @@ void ProcessThreadImpl::Stop() {
     stop_ = true;
   }
 
+  // Each worker passes the wakeup on as it exits.
   wake_up_->Set();
 
-  thread_->Stop();
+  for (Worker& worker : workers_) {
+    worker.thread->Stop();
+    worker.thread.reset();
+  }
   stop_ = false;
+  started_ = false;
+
+  {
+    // Put modules that were due but didn't get to run back on the schedule.
+    rtc::CritScope lock(&lock_);
+    for (std::deque<ModuleCallback*>& ready : ready_) {
+      for (ModuleCallback* callback : ready) {
+        callback->in_flight = false;
+        Schedule(callback);
+      }
+      ready.clear();
+    }
+  }
 
-  thread_.reset();
   for (ModuleCallback& m : modules_)
     m.module->ProcessThreadAttached(nullptr);
 }
@@ -99,8 +141,14 @@ void ProcessThreadImpl::WakeUp(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     for (ModuleCallback& m : modules_) {
-      if (m.module == module)
+      if (m.module != module)
+        continue;
+      if (m.in_flight) {
+        m.wake_up_pending = true;
+      } else {
         m.next_callback = kCallProcessImmediately;
+        Schedule(&m);
+      }
     }
   }
   wake_up_->Set();
@@ -135,12 +183,13 @@ void ProcessThreadImpl::RegisterModule(Module* module,
   // Now that we know the module isn't in the list, we'll call out to notify
   // the module that it's attached to the worker thread.  We don't hold
   // the lock while we make this call.
-  if (thread_.get())
+  if (started_)
     module->ProcessThreadAttached(this);
 
   {
     rtc::CritScope lock(&lock_);
     modules_.push_back(ModuleCallback(module, from));
+    Schedule(&modules_.back());
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -155,9 +204,38 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
-    modules_.remove_if([&module](const ModuleCallback& m) {
-        return m.module == module;
-      });
+    auto it = std::find_if(
+        modules_.begin(), modules_.end(),
+        [module](const ModuleCallback& m) { return m.module == module; });
+    if (it != modules_.end()) {
+      ModuleCallback* callback = &*it;
+      while (callback->in_flight) {
+        // Due but not yet picked up by a worker: just drop it.
+        bool was_queued = false;
+        for (std::deque<ModuleCallback*>& ready : ready_) {
+          auto ready_it = std::find(ready.begin(), ready.end(), callback);
+          if (ready_it != ready.end()) {
+            ready.erase(ready_it);
+            was_queued = true;
+            break;
+          }
+        }
+        if (was_queued)
+          break;
+        // In Process() on a worker; wait for it to return.
+        lock_.Leave();
+        module_processed_->Wait(WEBRTC_EVENT_INFINITE);
+        lock_.Enter();
+      }
+      schedule_.erase(
+          std::remove_if(schedule_.begin(), schedule_.end(),
+                         [callback](const ScheduledModule& scheduled) {
+                           return scheduled.callback == callback;
+                         }),
+          schedule_.end());
+      std::make_heap(schedule_.begin(), schedule_.end(), &ScheduledLater);
+      modules_.erase(it);
+    }
   }
 
   // Notify the module that it's been detached.
@@ -166,59 +244,156 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
 // static
 bool ProcessThreadImpl::Run(void* obj) {
-  return static_cast<ProcessThreadImpl*>(obj)->Process();
+  Worker* worker = static_cast<Worker*>(obj);
+  return worker->owner->Process(worker->index);
 }
 
-bool ProcessThreadImpl::Process() {
+bool ProcessThreadImpl::Process(size_t worker) {
   TRACE_EVENT1("webrtc", "ProcessThreadImpl", "name", thread_name_);
   int64_t now = rtc::TimeMillis();
-  int64_t next_checkpoint = now + (1000 * 60);
+  ModuleCallback* callback = nullptr;
+  bool more_ready = false;
 
   {
     rtc::CritScope lock(&lock_);
-    if (stop_)
+    if (stop_) {
+      wake_up_->Set();
       return false;
-    for (ModuleCallback& m : modules_) {
-      // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
-      // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
-      // operation should not require taking a lock, so querying all modules
-      // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
-        m.next_callback = GetNextCallbackTime(m.module, now);
-
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
-        {
-          TRACE_EVENT2("webrtc", "ModuleProcess", "function",
-                       m.location.function_name(), "file",
-                       m.location.file_and_line());
-          m.module->Process();
-        }
-        // Use a new 'now' reference to calculate when the next callback
-        // should occur.  We'll continue to use 'now' above for the baseline
-        // of calculating how long we should wait, to reduce variance.
-        int64_t new_now = rtc::TimeMillis();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
-      }
-
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
     }
+    DispatchDueModules(now);
+    callback = TakeReadyModule(worker);
+    for (const std::deque<ModuleCallback*>& ready : ready_)
+      more_ready |= !ready.empty();
+  }
 
+  if (callback) {
+    // Let another worker pick up the rest while this one is busy.
+    if (more_ready)
+      wake_up_->Set();
+    ProcessModule(callback);
+  }
+
+  if (worker == 0) {
+    rtc::CritScope lock(&lock_);
     while (!queue_.empty()) {
       rtc::QueuedTask* task = queue_.front();
       queue_.pop();
       lock_.Leave();
-      task->Run();
+      {
+        rtc::ThreadCpuAccounting::ScopedTask cpu_task(thread_name_,
+                                                      rtc::Location());
+        task->Run();
+      }
       delete task;
       lock_.Enter();
     }
   }
 
+  // Go around again right away after processing a module, since more may
+  // have become due meanwhile.
+  if (callback)
+    return true;
+
+  int64_t next_checkpoint = now + (1000 * 60);
+  {
+    rtc::CritScope lock(&lock_);
+    if (!schedule_.empty() && schedule_.front().next_callback < next_checkpoint)
+      next_checkpoint = schedule_.front().next_callback;
+  }
+
   int64_t time_to_wait = next_checkpoint - rtc::TimeMillis();
   if (time_to_wait > 0)
     wake_up_->Wait(static_cast<unsigned long>(time_to_wait));
 
   return true;
 }
+
+// static
+bool ProcessThreadImpl::ScheduledLater(const ScheduledModule& a,
+                                       const ScheduledModule& b) {
+  return a.next_callback > b.next_callback;
+}
+
+void ProcessThreadImpl::Schedule(ModuleCallback* callback) {
+  RTC_DCHECK(!callback->in_flight);
+  ++callback->generation;
+  schedule_.push_back(
+      ScheduledModule{callback->next_callback, callback, callback->generation});
+  std::push_heap(schedule_.begin(), schedule_.end(), &ScheduledLater);
+}
+
+void ProcessThreadImpl::DispatchDueModules(int64_t now) {
+  while (!schedule_.empty()) {
+    const ScheduledModule& next = schedule_.front();
+    ModuleCallback* callback = next.callback;
+    bool stale = next.generation != callback->generation;
+    if (!stale && next.next_callback > now)
+      break;
+    std::pop_heap(schedule_.begin(), schedule_.end(), &ScheduledLater);
+    schedule_.pop_back();
+    if (stale)
+      continue;
+
+    // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
+    // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
+    // operation should not require taking a lock, so querying all modules
+    // should run in a matter of nanoseconds.
+    if (callback->next_callback == 0) {
+      callback->next_callback = GetNextCallbackTime(callback->module, now);
+      if (callback->next_callback > now) {
+        Schedule(callback);
+        continue;
+      }
+    }
+
+    callback->in_flight = true;
+    ready_[next_worker_].push_back(callback);
+    next_worker_ = (next_worker_ + 1) % ready_.size();
+  }
+}
+
+ProcessThreadImpl::ModuleCallback* ProcessThreadImpl::TakeReadyModule(
+    size_t worker) {
+  ModuleCallback* callback = nullptr;
+  if (!ready_[worker].empty()) {
+    callback = ready_[worker].front();
+    ready_[worker].pop_front();
+    return callback;
+  }
+  for (size_t i = 1; i < ready_.size(); ++i) {
+    std::deque<ModuleCallback*>& victim = ready_[(worker + i) % ready_.size()];
+    if (!victim.empty()) {
+      callback = victim.back();
+      victim.pop_back();
+      return callback;
+    }
+  }
+  return nullptr;
+}
+
+void ProcessThreadImpl::ProcessModule(ModuleCallback* callback) {
+  // |callback| is in flight, so DeRegisterModule() waits for this to finish
+  // before removing it.
+  {
+    TRACE_EVENT2("webrtc", "ModuleProcess", "function",
+                 callback->location.function_name(), "file",
+                 callback->location.file_and_line());
+    rtc::ThreadCpuAccounting::ScopedTask cpu_task(thread_name_,
+                                                  callback->location);
+    callback->module->Process();
+  }
+  int64_t next_callback =
+      GetNextCallbackTime(callback->module, rtc::TimeMillis());
+
+  rtc::CritScope lock(&lock_);
+  callback->in_flight = false;
+  callback->next_callback = next_callback;
+  if (callback->wake_up_pending) {
+    callback->wake_up_pending = false;
+    callback->next_callback = kCallProcessImmediately;
+  }
+  Schedule(callback);
+  module_processed_->Set();
+}
+
 }  // namespace webrtc
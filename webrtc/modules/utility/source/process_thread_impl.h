@@ -11,9 +11,11 @@
 #ifndef WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 #define WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 
+#include <deque>
 #include <list>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "webrtc/modules/utility/include/process_thread.h"
 #include "webrtc/rtc_base/criticalsection.h"
@@ -28,6 +30,12 @@ namespace webrtc {
 class ProcessThreadImpl : public ProcessThread {
  public:
   explicit ProcessThreadImpl(const char* thread_name);
+  // Runs modules on |num_threads| worker threads. Each module is processed by
+  // one worker at a time, but not necessarily always the same one: a worker
+  // that has nothing due takes modules queued for busy workers. Posted tasks
+  // always run on the first worker. Only use this with modules that don't
+  // check which thread Process() is called on.
+  ProcessThreadImpl(const char* thread_name, size_t num_threads);
   ~ProcessThreadImpl() override;
 
   void Start() override;
@@ -40,8 +48,14 @@ class ProcessThreadImpl : public ProcessThread {
   void DeRegisterModule(Module* module) override;
 
  protected:
+  struct Worker {
+    ProcessThreadImpl* owner;
+    size_t index;
+    std::unique_ptr<rtc::PlatformThread> thread;
+  };
+
   static bool Run(void* obj);
-  bool Process();
+  bool Process(size_t worker);
 
  private:
   struct ModuleCallback {
@@ -57,6 +71,13 @@ class ProcessThreadImpl : public ProcessThread {
     Module* const module;
     int64_t next_callback = 0;  // Absolute timestamp.
     const rtc::Location location;
+    // Incremented whenever the module is rescheduled, which invalidates the
+    // heap entry made for the previous |next_callback|.
+    uint32_t generation = 0;
+    // Set while the module is queued on a worker or in Process().
+    bool in_flight = false;
+    // WakeUp() was called while in flight.
+    bool wake_up_pending = false;
 
    private:
     ModuleCallback& operator=(ModuleCallback&);
@@ -64,6 +85,21 @@ class ProcessThreadImpl : public ProcessThread {
 
   typedef std::list<ModuleCallback> ModuleList;
 
+  struct ScheduledModule {
+    int64_t next_callback;
+    ModuleCallback* callback;
+    uint32_t generation;
+  };
+
+  static bool ScheduledLater(const ScheduledModule& a,
+                             const ScheduledModule& b);
+
+  void Schedule(ModuleCallback* callback) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void DispatchDueModules(int64_t now) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  ModuleCallback* TakeReadyModule(size_t worker)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void ProcessModule(ModuleCallback* callback);
+
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
   // on Mac 10.9 debug.  I (Tommi) suspect we're hitting some obscure alignemnt
@@ -74,10 +110,20 @@ class ProcessThreadImpl : public ProcessThread {
 
   rtc::ThreadChecker thread_checker_;
   const std::unique_ptr<EventWrapper> wake_up_;
-  // TODO(pbos): Remove unique_ptr and stop recreating the thread.
-  std::unique_ptr<rtc::PlatformThread> thread_;
+  // Signaled when a module leaves Process(), for DeRegisterModule().
+  const std::unique_ptr<EventWrapper> module_processed_;
+  // TODO(pbos): Stop recreating the threads.
+  std::vector<Worker> workers_;
+  bool started_ = false;
 
   ModuleList modules_;
+  // Min-heap on |next_callback| of registered modules that are not in flight.
+  // Entries whose generation doesn't match their module are stale and skipped.
+  std::vector<ScheduledModule> schedule_;
+  // Due modules, per worker. Owners take from the front, others steal from the
+  // back.
+  std::vector<std::deque<ModuleCallback*>> ready_;
+  size_t next_worker_ = 0;
   std::queue<rtc::QueuedTask*> queue_;
   bool stop_;
   const char* thread_name_;
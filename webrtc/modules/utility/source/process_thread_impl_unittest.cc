@@ -318,4 +318,108 @@ TEST(ProcessThreadImpl, PostTask) {
   thread.Stop();
 }
 
+// Modules that are not due must not be queried or processed just because
+// another module was.
+TEST(ProcessThreadImpl, OnlyDueModulesAreProcessed) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::unique_ptr<EventWrapper> event(EventWrapper::Create());
+
+  MockModule busy_module;
+  MockModule idle_module;
+  int busy_count = 0;
+  EXPECT_CALL(busy_module, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(busy_module, Process())
+      .WillRepeatedly(DoAll(Increment(&busy_count), Return()));
+  // Queried once on registration and never again within the test.
+  EXPECT_CALL(idle_module, TimeUntilNextProcess())
+      .WillOnce(DoAll(SetEvent(event.get()), Return(60000)));
+  EXPECT_CALL(idle_module, Process()).Times(0);
+  EXPECT_CALL(busy_module, ProcessThreadAttached(&thread)).Times(1);
+  EXPECT_CALL(idle_module, ProcessThreadAttached(&thread)).Times(1);
+
+  thread.RegisterModule(&idle_module, RTC_FROM_HERE);
+  thread.RegisterModule(&busy_module, RTC_FROM_HERE);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, event->Wait(kEventWaitTimeout));
+  EXPECT_EQ(kEventTimeout, event->Wait(50));
+
+  EXPECT_CALL(busy_module, ProcessThreadAttached(nullptr)).Times(1);
+  EXPECT_CALL(idle_module, ProcessThreadAttached(nullptr)).Times(1);
+  thread.Stop();
+  EXPECT_GT(busy_count, 1);
+}
+
+// With several worker threads, a module that blocks in Process() doesn't hold
+// up other modules.
+TEST(ProcessThreadImpl, WorkersProcessModulesInParallel) {
+  ProcessThreadImpl thread("ProcessThread", 2);
+  std::unique_ptr<EventWrapper> blocked(EventWrapper::Create());
+  std::unique_ptr<EventWrapper> unblock(EventWrapper::Create());
+  std::unique_ptr<EventWrapper> other_called(EventWrapper::Create());
+
+  MockModule blocking_module;
+  MockModule other_module;
+  EXPECT_CALL(blocking_module, TimeUntilNextProcess())
+      .WillOnce(Return(0))
+      .WillRepeatedly(Return(60000));
+  EXPECT_CALL(blocking_module, Process()).WillOnce(Invoke([&]() {
+    blocked->Set();
+    unblock->Wait(kEventWaitTimeout);
+  }));
+  EXPECT_CALL(other_module, TimeUntilNextProcess())
+      .WillOnce(Return(10))
+      .WillRepeatedly(Return(60000));
+  EXPECT_CALL(other_module, Process())
+      .WillOnce(DoAll(SetEvent(other_called.get()), Return()));
+  EXPECT_CALL(blocking_module, ProcessThreadAttached(&thread)).Times(1);
+  EXPECT_CALL(other_module, ProcessThreadAttached(&thread)).Times(1);
+
+  thread.RegisterModule(&blocking_module, RTC_FROM_HERE);
+  thread.RegisterModule(&other_module, RTC_FROM_HERE);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, blocked->Wait(kEventWaitTimeout));
+  EXPECT_EQ(kEventSignaled, other_called->Wait(kEventWaitTimeout));
+  unblock->Set();
+
+  EXPECT_CALL(blocking_module, ProcessThreadAttached(nullptr)).Times(1);
+  EXPECT_CALL(other_module, ProcessThreadAttached(nullptr)).Times(1);
+  thread.Stop();
+}
+
+// Deregistering waits for a module that is in Process() on another worker.
+TEST(ProcessThreadImpl, DeregisterWaitsForProcess) {
+  ProcessThreadImpl thread("ProcessThread", 2);
+  std::unique_ptr<EventWrapper> entered(EventWrapper::Create());
+  std::unique_ptr<EventWrapper> unblock(EventWrapper::Create());
+  bool process_returned = false;
+
+  MockModule module;
+  EXPECT_CALL(module, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(module, Process()).WillOnce(Invoke([&]() {
+    entered->Set();
+    unblock->Wait(50);
+    process_returned = true;
+  })).WillRepeatedly(Return());
+  EXPECT_CALL(module, ProcessThreadAttached(&thread)).Times(1);
+
+  thread.RegisterModule(&module, RTC_FROM_HERE);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, entered->Wait(kEventWaitTimeout));
+
+  EXPECT_CALL(module, ProcessThreadAttached(nullptr)).Times(1);
+  thread.DeRegisterModule(&module);
+  EXPECT_TRUE(process_returned);
+  thread.Stop();
+}
+
+TEST(ProcessThreadImpl, PostTaskWithWorkers) {
+  ProcessThreadImpl thread("ProcessThread", 3);
+  std::unique_ptr<EventWrapper> task_ran(EventWrapper::Create());
+  std::unique_ptr<RaiseEventTask> task(new RaiseEventTask(task_ran.get()));
+  thread.Start();
+  thread.PostTask(std::move(task));
+  EXPECT_EQ(kEventSignaled, task_ran->Wait(kEventWaitTimeout));
+  thread.Stop();
+}
+
 }  // namespace webrtc
@@ -144,6 +144,35 @@ class TestVideoCaptureCallback
   webrtc::VideoRotation rotate_frame_;
 };
 
+// Crops the center of the frames and scales it to half its size, or drops
+// them.
+class TestFrameAdapter : public VideoCaptureModule::FrameAdapter {
+ public:
+  bool AdaptCapturedFrame(int width,
+                          int height,
+                          int64_t capture_time_us,
+                          int* out_width,
+                          int* out_height,
+                          int* crop_width,
+                          int* crop_height,
+                          int* crop_x,
+                          int* crop_y) override {
+    ++num_frames_;
+    if (drop_frames_)
+      return false;
+    *crop_width = width / 2;
+    *crop_height = height / 2;
+    *crop_x = width / 4;
+    *crop_y = height / 4;
+    *out_width = width / 4;
+    *out_height = height / 4;
+    return true;
+  }
+
+  int num_frames_ = 0;
+  bool drop_frames_ = false;
+};
+
 class VideoCaptureTest : public testing::Test {
  public:
   VideoCaptureTest() : number_of_devices_(0) {}
@@ -398,6 +427,32 @@ TEST_F(VideoCaptureExternalTest, TestExternalCapture) {
   EXPECT_TRUE(capture_callback_.CompareLastFrame(*test_frame_));
 }
 
+TEST_F(VideoCaptureExternalTest, AdaptsBeforeConversion) {
+  size_t length = webrtc::CalcBufferSize(
+      webrtc::VideoType::kI420, test_frame_->width(), test_frame_->height());
+  std::unique_ptr<uint8_t[]> test_buffer(new uint8_t[length]);
+  webrtc::ExtractBuffer(*test_frame_, length, test_buffer.get());
+  VideoCaptureCapability capability = capture_callback_.capability();
+  VideoCaptureCapability adapted_capability = capability;
+  adapted_capability.width = kTestWidth / 4;
+  adapted_capability.height = kTestHeight / 4;
+  capture_callback_.SetExpectedCapability(adapted_capability);
+
+  TestFrameAdapter adapter;
+  capture_module_->SetFrameAdapter(&adapter);
+  EXPECT_EQ(0, capture_input_interface_->IncomingFrame(test_buffer.get(),
+      length, capability, 0));
+  EXPECT_EQ(1, adapter.num_frames_);
+  EXPECT_EQ(1, capture_callback_.incoming_frames());
+
+  adapter.drop_frames_ = true;
+  EXPECT_EQ(0, capture_input_interface_->IncomingFrame(test_buffer.get(),
+      length, capability, 0));
+  EXPECT_EQ(2, adapter.num_frames_);
+  EXPECT_EQ(1, capture_callback_.incoming_frames());
+  capture_module_->SetFrameAdapter(nullptr);
+}
+
 TEST_F(VideoCaptureExternalTest, Rotation) {
   EXPECT_EQ(0, capture_module_->SetCaptureRotation(webrtc::kVideoRotation_0));
   size_t length = webrtc::CalcBufferSize(
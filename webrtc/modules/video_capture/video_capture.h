@@ -20,6 +20,29 @@ namespace webrtc {
 
 class VideoCaptureModule: public rtc::RefCountInterface {
  public:
+  // Decides, before a captured frame is converted to I420, whether it is
+  // wanted and at which resolution, so that dropped frames cost nothing.
+  class FrameAdapter {
+   public:
+    // |width| and |height| are the dimensions of the frame as it would be
+    // delivered, i.e. after any rotation applied by the module. Returns false
+    // if the frame should be dropped. Otherwise the frame is cropped to the
+    // |crop_width| x |crop_height| region at (|crop_x|, |crop_y|) and scaled
+    // to |out_width| x |out_height|.
+    virtual bool AdaptCapturedFrame(int width,
+                                    int height,
+                                    int64_t capture_time_us,
+                                    int* out_width,
+                                    int* out_height,
+                                    int* crop_width,
+                                    int* crop_height,
+                                    int* crop_x,
+                                    int* crop_y) = 0;
+
+   protected:
+    virtual ~FrameAdapter() {}
+  };
+
   // Interface for receiving information about available camera devices.
   class DeviceInfo {
    public:
@@ -83,6 +106,10 @@ class VideoCaptureModule: public rtc::RefCountInterface {
   //  Remove capture data callback
   virtual void DeRegisterCaptureDataCallback() = 0;
 
+  // Sets the adapter consulted for each captured frame, or removes it if
+  // |adapter| is null.
+  virtual void SetFrameAdapter(FrameAdapter* adapter) = 0;
+
   // Start capture device
   virtual int32_t StartCapture(
       const VideoCaptureCapability& capability) = 0;
@@ -83,6 +83,7 @@ VideoCaptureImpl::VideoCaptureImpl()
       _lastProcessTimeNanos(rtc::TimeNanos()),
       _lastFrameRateCallbackTimeNanos(rtc::TimeNanos()),
       _dataCallBack(NULL),
+      _frameAdapter(NULL),
       _lastProcessFrameTimeNanos(rtc::TimeNanos()),
       _rotateFrame(kVideoRotation_0),
       apply_rotation_(false) {
@@ -110,6 +111,11 @@ void VideoCaptureImpl::DeRegisterCaptureDataCallback() {
     rtc::CritScope cs(&_apiCs);
     _dataCallBack = NULL;
 }
+
+void VideoCaptureImpl::SetFrameAdapter(FrameAdapter* adapter) {
+    rtc::CritScope cs(&_apiCs);
+    _frameAdapter = adapter;
+}
 int32_t VideoCaptureImpl::DeliverCapturedFrame(VideoFrame& captureFrame) {
   UpdateFrameCount();  // frame count used for local frame rate callback.
 
@@ -141,8 +147,6 @@ int32_t VideoCaptureImpl::IncomingFrame(
       return -1;
     }
 
-    int stride_y = width;
-    int stride_uv = (width + 1) / 2;
     int target_width = width;
     int target_height = height;
 
@@ -161,19 +165,55 @@ int32_t VideoCaptureImpl::IncomingFrame(
     // Setting absolute height (in case it was negative).
     // In Windows, the image starts bottom left, instead of top left.
     // Setting a negative source height, inverts the image (within LibYuv).
+    target_height = abs(target_height);
+
+    int out_width = target_width;
+    int out_height = target_height;
+    int crop_width = target_width;
+    int crop_height = target_height;
+    int crop_x = 0;
+    int crop_y = 0;
+    if (_frameAdapter &&
+        !_frameAdapter->AdaptCapturedFrame(
+            target_width, target_height, rtc::TimeMicros(), &out_width,
+            &out_height, &crop_width, &crop_height, &crop_x, &crop_y)) {
+      // Dropped before conversion.
+      return 0;
+    }
+
+    const VideoRotation rotation =
+        apply_rotation ? _rotateFrame : kVideoRotation_0;
+    // libyuv can crop, but not scale, while converting. The crop region is
+    // in the coordinates of the rotated frame though, so rotated frames, like
+    // MJPEG frames, are converted whole and cropped afterwards.
+    const bool crop_when_converting =
+        rotation == kVideoRotation_0 &&
+        frameInfo.videoType != VideoType::kMJPEG;
 
     // TODO(nisse): Use a pool?
-    rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(
-        target_width, abs(target_height), stride_y, stride_uv, stride_uv);
+    rtc::scoped_refptr<I420Buffer> buffer =
+        crop_when_converting ? I420Buffer::Create(crop_width, crop_height)
+                             : I420Buffer::Create(target_width, target_height);
     const int conversionResult = ConvertToI420(
-        frameInfo.videoType, videoFrame, 0, 0,  // No cropping
-        width, height, videoFrameLength,
-        apply_rotation ? _rotateFrame : kVideoRotation_0, buffer.get());
+        frameInfo.videoType, videoFrame, crop_when_converting ? crop_x : 0,
+        crop_when_converting ? crop_y : 0, width, height, videoFrameLength,
+        rotation, buffer.get());
     if (conversionResult < 0) {
       LOG(LS_ERROR) << "Failed to convert capture frame from type "
                     << static_cast<int>(frameInfo.videoType) << "to I420.";
       return -1;
     }
+    if (out_width != buffer->width() || out_height != buffer->height()) {
+      rtc::scoped_refptr<I420Buffer> scaled_buffer =
+          I420Buffer::Create(out_width, out_height);
+      if (crop_when_converting) {
+        scaled_buffer->ScaleFrom(*buffer);
+      } else {
+        scaled_buffer->CropAndScaleFrom(*buffer, crop_x, crop_y, crop_width,
+                                        crop_height);
+      }
+      buffer = scaled_buffer;
+    }
 
     VideoFrame captureFrame(buffer, 0, rtc::TimeMillis(),
                             !apply_rotation ? _rotateFrame : kVideoRotation_0);
@@ -60,6 +60,7 @@ public:
     void RegisterCaptureDataCallback(
         rtc::VideoSinkInterface<VideoFrame>* dataCallback) override;
     void DeRegisterCaptureDataCallback() override;
+    void SetFrameAdapter(FrameAdapter* adapter) override;
 
     int32_t SetCaptureRotation(VideoRotation rotation) override;
     bool SetApplyRotation(bool enable) override;
@@ -105,6 +106,7 @@ private:
     int64_t _lastFrameRateCallbackTimeNanos;
 
     rtc::VideoSinkInterface<VideoFrame>* _dataCallBack;
+    FrameAdapter* _frameAdapter;
 
     int64_t _lastProcessFrameTimeNanos;
     // timestamp for local captured frames
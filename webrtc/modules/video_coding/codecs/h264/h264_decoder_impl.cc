@@ -22,6 +22,7 @@ extern "C" {
 
 #include "webrtc/api/video/i420_buffer.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
+#include "webrtc/modules/video_coding/utility/shared_decoder_buffer_pool.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/keep_ref_until_done.h"
@@ -87,6 +88,20 @@ void InitializeFFmpeg() {
 
 #endif  // defined(WEBRTC_INITIALIZE_FFMPEG)
 
+// Returns the pool shared by all decoders of the process, or null if each
+// decoder should have a pool of its own.
+I420BufferPool* GetSharedPool() {
+  static I420BufferPool* const shared_pool = []() -> I420BufferPool* {
+    rtc::Optional<size_t> max_pooled_bytes =
+        GetSharedDecoderBufferPoolMaxPooledBytes();
+    if (!max_pooled_bytes)
+      return nullptr;
+    return new I420BufferPool(true, std::numeric_limits<size_t>::max(),
+                              *max_pooled_bytes);
+  }();
+  return shared_pool;
+}
+
 }  // namespace
 
 int H264DecoderImpl::AVGetBuffer2(
@@ -132,7 +147,7 @@ int H264DecoderImpl::AVGetBuffer2(
   // TODO(nisse): Delete that feature from the video pool, instead add
   // an explicit call to InitializeData here.
   rtc::scoped_refptr<I420Buffer> frame_buffer =
-      decoder->pool_.CreateBuffer(width, height);
+      decoder->pool_->CreateBuffer(width, height);
 
   int y_size = width * height;
   int uv_size = frame_buffer->ChromaWidth() * frame_buffer->ChromaHeight();
@@ -177,11 +192,12 @@ void H264DecoderImpl::AVFreeBuffer2(void* opaque, uint8_t* data) {
   delete video_frame;
 }
 
-H264DecoderImpl::H264DecoderImpl() : pool_(true),
-                                     decoded_image_callback_(nullptr),
-                                     has_reported_init_(false),
-                                     has_reported_error_(false) {
-}
+H264DecoderImpl::H264DecoderImpl()
+    : own_pool_(true),
+      pool_(GetSharedPool() ? GetSharedPool() : &own_pool_),
+      decoded_image_callback_(nullptr),
+      has_reported_init_(false),
+      has_reported_error_(false) {}
 
 H264DecoderImpl::~H264DecoderImpl() {
   Release();
@@ -70,7 +70,11 @@ class H264DecoderImpl : public H264Decoder {
   void ReportInit();
   void ReportError();
 
-  I420BufferPool pool_;
+  // Decoded frames are stored in buffers from |pool_|, which either is
+  // |own_pool_| or the pool shared by all decoders, see
+  // GetSharedDecoderBufferPoolMaxPooledBytes().
+  I420BufferPool own_pool_;
+  I420BufferPool* const pool_;
   std::unique_ptr<AVCodecContext, AVCodecContextDeleter> av_context_;
   std::unique_ptr<AVFrame, AVFrameDeleter> av_frame_;
 
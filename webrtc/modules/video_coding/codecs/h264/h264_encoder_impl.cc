@@ -11,6 +11,9 @@
 
 #include "webrtc/modules/video_coding/codecs/h264/h264_encoder_impl.h"
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -23,6 +26,7 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/system_wrappers/include/metrics.h"
 
 namespace webrtc {
@@ -38,21 +42,22 @@ enum H264EncoderImplEvent {
   kH264EncoderEventMax = 16,
 };
 
-int NumberOfThreads(int width, int height, int number_of_cores) {
-  // TODO(hbos): In Chromium, multiple threads do not work with sandbox on Mac,
-  // see crbug.com/583348. Until further investigated, only use one thread.
-//  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
-//    return 8;  // 8 threads for 1080p on high perf machines.
-//  } else if (width * height > 1280 * 960 && number_of_cores >= 6) {
-//    return 3;  // 3 threads for 1080p.
-//  } else if (width * height > 640 * 480 && number_of_cores >= 3) {
-//    return 2;  // 2 threads for qHD/HD.
-//  } else {
-//    return 1;  // 1 thread for VGA or less.
-//  }
-// TODO(sprang): Also check sSliceArgument.uiSliceNum om GetEncoderPrams(),
-//               before enabling multithreading here.
-  return 1;
+// Enables multi-threaded encoding, e.g. for server-side transcoding. The group
+// may cap the number of threads, "Enabled-<max threads>".
+const char kH264MultiThreadingFieldTrial[] = "WebRTC-H264MultiThreading";
+
+// Returns the maximum number of encoder threads allowed by the field trial,
+// or 1 if it's disabled.
+int MaxNumberOfThreadsFromFieldTrial() {
+  if (!field_trial::IsEnabled(kH264MultiThreadingFieldTrial))
+    return 1;
+  std::string group = field_trial::FindFullName(kH264MultiThreadingFieldTrial);
+  int max_threads;
+  if (sscanf(group.c_str(), "Enabled-%d", &max_threads) != 1 ||
+      max_threads < 1) {
+    return std::numeric_limits<int>::max();
+  }
+  return max_threads;
 }
 
 FrameType ConvertToVideoFrameType(EVideoFrameType type) {
@@ -73,6 +78,26 @@ FrameType ConvertToVideoFrameType(EVideoFrameType type) {
 
 }  // namespace
 
+int H264EncoderImpl::NumberOfThreads(int width,
+                                     int height,
+                                     int number_of_cores,
+                                     int max_threads) {
+  // In Chromium, multiple threads do not work with sandbox on Mac, see
+  // crbug.com/583348. Until further investigated, only use more than one
+  // thread when enabled, i.e. by |max_threads|.
+  int threads;
+  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
+    threads = 8;  // 8 threads for 1080p on high perf machines.
+  } else if (width * height > 1280 * 960 && number_of_cores >= 6) {
+    threads = 3;  // 3 threads for 1080p.
+  } else if (width * height > 640 * 480 && number_of_cores >= 3) {
+    threads = 2;  // 2 threads for qHD/HD.
+  } else {
+    threads = 1;  // 1 thread for VGA or less.
+  }
+  return std::max(1, std::min(threads, max_threads));
+}
+
 // Helper method used by H264EncoderImpl::Encode.
 // Copies the encoded bytes from |info| to |encoded_image| and updates the
 // fragmentation information of |frag_header|. The |encoded_image->_buffer| may
@@ -165,6 +190,8 @@ H264EncoderImpl::H264EncoderImpl(const cricket::VideoCodec& codec)
       packetization_mode_(H264PacketizationMode::SingleNalUnit),
       max_payload_size_(0),
       number_of_cores_(0),
+      number_of_threads_(1),
+      number_of_slices_(1),
       encoded_image_callback_(nullptr),
       has_reported_init_(false),
       has_reported_error_(false) {
@@ -239,6 +266,16 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* codec_settings,
   else
     target_bps_ = codec_settings->targetBitrate * 1000;
 
+  number_of_threads_ = NumberOfThreads(width_, height_, number_of_cores_,
+                                       MaxNumberOfThreadsFromFieldTrial());
+  // OpenH264 encodes the slices of a frame in parallel, so the threads are only
+  // used with a slice per thread. Size limited slices are split by the encoder.
+  number_of_slices_ =
+      packetization_mode_ == H264PacketizationMode::NonInterleaved
+          ? number_of_threads_
+          : 1;
+  encode_time_stats_ = EncodeTimeStats();
+
   SEncParamExt encoder_params = CreateEncoderParams();
 
   // Initialize.
@@ -262,17 +299,22 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* codec_settings,
   encoded_image_._encodedWidth = 0;
   encoded_image_._encodedHeight = 0;
   encoded_image_._length = 0;
+  LOG(LS_INFO) << "OpenH264 encoder initialized for " << width_ << "x"
+               << height_ << " with " << number_of_threads_ << " threads and "
+               << number_of_slices_ << " slices.";
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
 int32_t H264EncoderImpl::Release() {
   if (openh264_encoder_) {
+    ReportEncodeTime();
     RTC_CHECK_EQ(0, openh264_encoder_->Uninitialize());
     WelsDestroySVCEncoder(openh264_encoder_);
     openh264_encoder_ = nullptr;
   }
   encoded_image_._buffer = nullptr;
   encoded_image_buffer_.reset();
+  input_buffer_pool_.Release();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -332,8 +374,18 @@ int32_t H264EncoderImpl::Encode(const VideoFrame& input_frame,
     // (If every frame is a key frame we get lag/delays.)
     openh264_encoder_->ForceIntraFrame(true);
   }
-  rtc::scoped_refptr<const I420BufferInterface> frame_buffer =
-      input_frame.video_frame_buffer()->ToI420();
+  rtc::scoped_refptr<const I420BufferInterface> frame_buffer;
+  if (input_frame.video_frame_buffer()->type() ==
+      VideoFrameBuffer::Type::kNV12) {
+    rtc::scoped_refptr<I420Buffer> i420_buffer =
+        input_buffer_pool_.CreateBuffer(input_frame.width(),
+                                        input_frame.height());
+    nv12_to_i420_scaler_.NV12ToI420Scale(
+        *input_frame.video_frame_buffer()->GetNV12(), i420_buffer.get());
+    frame_buffer = i420_buffer;
+  } else {
+    frame_buffer = input_frame.video_frame_buffer()->ToI420();
+  }
   // EncodeFrame input.
   SSourcePicture picture;
   memset(&picture, 0, sizeof(SSourcePicture));
@@ -353,7 +405,9 @@ int32_t H264EncoderImpl::Encode(const VideoFrame& input_frame,
   memset(&info, 0, sizeof(SFrameBSInfo));
 
   // Encode!
+  const int64_t encode_start_us = rtc::TimeMicros();
   int enc_ret = openh264_encoder_->EncodeFrame(&picture, &info);
+  encode_time_stats_.AddSample(rtc::TimeMicros() - encode_start_us);
   if (enc_ret != 0) {
     LOG(LS_ERROR) << "OpenH264 frame encoding failed, EncodeFrame returned "
                   << enc_ret << ".";
@@ -439,8 +493,7 @@ SEncParamExt H264EncoderImpl::CreateEncoderParams() const {
   //  0: auto (dynamic imp. internal encoder)
   //  1: single thread (default value)
   // >1: number of threads
-  encoder_params.iMultipleThreadIdc = NumberOfThreads(
-      encoder_params.iPicWidth, encoder_params.iPicHeight, number_of_cores_);
+  encoder_params.iMultipleThreadIdc = number_of_threads_;
   // The base spatial layer 0 is the only one we use.
   encoder_params.sSpatialLayers[0].iVideoWidth = encoder_params.iPicWidth;
   encoder_params.sSpatialLayers[0].iVideoHeight = encoder_params.iPicHeight;
@@ -464,8 +517,10 @@ SEncParamExt H264EncoderImpl::CreateEncoderParams() const {
       // When uiSliceMode = SM_FIXEDSLCNUM_SLICE, uiSliceNum = 0 means auto
       // design it with cpu core number.
       // TODO(sprang): Set to 0 when we understand why the rate controller borks
-      //               when uiSliceNum > 1.
-      encoder_params.sSpatialLayers[0].sSliceArgument.uiSliceNum = 1;
+      //               when uiSliceNum > 1. Until then, more than one slice is
+      //               only used for multi-threaded encoding.
+      encoder_params.sSpatialLayers[0].sSliceArgument.uiSliceNum =
+          number_of_slices_;
       encoder_params.sSpatialLayers[0].sSliceArgument.uiSliceMode =
           SM_FIXEDSLCNUM_SLICE;
       break;
@@ -491,6 +546,26 @@ void H264EncoderImpl::ReportError() {
   has_reported_error_ = true;
 }
 
+void H264EncoderImpl::ReportEncodeTime() {
+  if (encode_time_stats_.num_frames == 0)
+    return;
+  const int average_us = static_cast<int>(encode_time_stats_.total_us /
+                                          encode_time_stats_.num_frames);
+  RTC_HISTOGRAM_COUNTS_100000("WebRTC.Video.H264EncoderImpl.EncodeTimeUs",
+                              average_us);
+  LOG(LS_INFO) << "OpenH264 encoded " << encode_time_stats_.num_frames
+               << " frames with " << number_of_threads_ << " threads and "
+               << number_of_slices_ << " slices, average encode time "
+               << average_us << " us, max " << encode_time_stats_.max_us
+               << " us.";
+}
+
+void H264EncoderImpl::EncodeTimeStats::AddSample(int64_t encode_time_us) {
+  ++num_frames;
+  total_us += encode_time_us;
+  max_us = std::max(max_us, encode_time_us);
+}
+
 int32_t H264EncoderImpl::SetChannelParameters(
     uint32_t packet_loss, int64_t rtt) {
   return WEBRTC_VIDEO_CODEC_OK;
@@ -16,6 +16,8 @@
 #include <vector>
 
 #include "webrtc/common_video/h264/h264_bitstream_parser.h"
+#include "webrtc/common_video/include/i420_buffer_pool.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_coding/codecs/h264/include/h264.h"
 #include "webrtc/modules/video_coding/utility/quality_scaler.h"
 
@@ -61,19 +63,45 @@ class H264EncoderImpl : public H264Encoder {
   int32_t SetChannelParameters(uint32_t packet_loss, int64_t rtt) override;
   int32_t SetPeriodicKeyFrames(bool enable) override;
 
+  // Time spent in OpenH264 encoding frames since the last InitEncode(), to
+  // compare threading and slice configurations.
+  struct EncodeTimeStats {
+    void AddSample(int64_t encode_time_us);
+
+    int num_frames = 0;
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+  };
+  const EncodeTimeStats& encode_time_stats() const {
+    return encode_time_stats_;
+  }
+
+  // Returns the number of encoder threads to use for a |width| x |height|
+  // stream on |number_of_cores| cores, at most |max_threads|.
+  static int NumberOfThreads(int width,
+                             int height,
+                             int number_of_cores,
+                             int max_threads);
+
   // Exposed for testing.
   H264PacketizationMode PacketizationModeForTesting() const {
     return packetization_mode_;
   }
+  int NumberOfThreadsForTesting() const { return number_of_threads_; }
+  int NumberOfSlicesForTesting() const { return number_of_slices_; }
 
  private:
   bool IsInitialized() const;
   SEncParamExt CreateEncoderParams() const;
 
   webrtc::H264BitstreamParser h264_bitstream_parser_;
+  // OpenH264 takes I420 only; NV12 input is converted into these buffers.
+  I420BufferPool input_buffer_pool_;
+  NV12ToI420Scaler nv12_to_i420_scaler_;
   // Reports statistics with histograms.
   void ReportInit();
   void ReportError();
+  void ReportEncodeTime();
 
   ISVCEncoder* openh264_encoder_;
   // Settings that are used by this encoder.
@@ -90,6 +118,10 @@ class H264EncoderImpl : public H264Encoder {
 
   size_t max_payload_size_;
   int32_t number_of_cores_;
+  // Derived from the cores and resolution in InitEncode().
+  int number_of_threads_;
+  int number_of_slices_;
+  EncodeTimeStats encode_time_stats_;
 
   EncodedImage encoded_image_;
   std::unique_ptr<uint8_t[]> encoded_image_buffer_;
@@ -11,6 +11,7 @@
 
 #include "webrtc/modules/video_coding/codecs/h264/h264_encoder_impl.h"
 
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/gtest.h"
 
 namespace webrtc {
@@ -78,6 +79,61 @@ TEST(H264EncoderImplTest, CanInitializeWithRemovedParameter) {
             encoder.PacketizationModeForTesting());
 }
 
+TEST(H264EncoderImplTest, NumberOfThreadsDependsOnCoresAndResolution) {
+  const int kNoLimit = 16;
+  EXPECT_EQ(1, H264EncoderImpl::NumberOfThreads(640, 480, 16, kNoLimit));
+  EXPECT_EQ(1, H264EncoderImpl::NumberOfThreads(1280, 720, 2, kNoLimit));
+  EXPECT_EQ(2, H264EncoderImpl::NumberOfThreads(1280, 720, 4, kNoLimit));
+  EXPECT_EQ(3, H264EncoderImpl::NumberOfThreads(1920, 1080, 6, kNoLimit));
+  EXPECT_EQ(8, H264EncoderImpl::NumberOfThreads(1920, 1080, 16, kNoLimit));
+  EXPECT_EQ(4, H264EncoderImpl::NumberOfThreads(1920, 1080, 16, 4));
+}
+
+TEST(H264EncoderImplTest, UsesOneThreadByDefault) {
+  cricket::VideoCodec codec("H264");
+  codec.SetParam(cricket::kH264FmtpPacketizationMode, "1");
+  H264EncoderImpl encoder(codec);
+  VideoCodec codec_settings;
+  SetDefaultSettings(&codec_settings);
+  codec_settings.width = 1920;
+  codec_settings.height = 1080;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, 16, kMaxPayloadSize));
+  EXPECT_EQ(1, encoder.NumberOfThreadsForTesting());
+  EXPECT_EQ(1, encoder.NumberOfSlicesForTesting());
+  EXPECT_EQ(0, encoder.encode_time_stats().num_frames);
+}
+
+TEST(H264EncoderImplTest, UsesSlicePerThreadWhenMultiThreadingEnabled) {
+  test::ScopedFieldTrials field_trials("WebRTC-H264MultiThreading/Enabled-4/");
+  cricket::VideoCodec codec("H264");
+  codec.SetParam(cricket::kH264FmtpPacketizationMode, "1");
+  H264EncoderImpl encoder(codec);
+  VideoCodec codec_settings;
+  SetDefaultSettings(&codec_settings);
+  codec_settings.width = 1920;
+  codec_settings.height = 1080;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, 16, kMaxPayloadSize));
+  EXPECT_EQ(4, encoder.NumberOfThreadsForTesting());
+  EXPECT_EQ(4, encoder.NumberOfSlicesForTesting());
+}
+
+TEST(H264EncoderImplTest, KeepsSizeLimitedSlicesWhenMultiThreadingEnabled) {
+  test::ScopedFieldTrials field_trials("WebRTC-H264MultiThreading/Enabled/");
+  cricket::VideoCodec codec("H264");
+  codec.SetParam(cricket::kH264FmtpPacketizationMode, "0");
+  H264EncoderImpl encoder(codec);
+  VideoCodec codec_settings;
+  SetDefaultSettings(&codec_settings);
+  codec_settings.width = 1280;
+  codec_settings.height = 720;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings, 4, kMaxPayloadSize));
+  EXPECT_EQ(2, encoder.NumberOfThreadsForTesting());
+  EXPECT_EQ(1, encoder.NumberOfSlicesForTesting());
+}
+
 }  // anonymous namespace
 
 }  // namespace webrtc
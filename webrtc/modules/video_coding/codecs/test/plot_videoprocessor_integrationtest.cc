@@ -35,13 +35,16 @@ const float kPacketLoss = 0.0f;
 const VisualizationParams kVisualizationParams = {
     false,  // save_encoded_ivf
     false,  // save_decoded_y4m
+    false,  // save_frame_stats_csv
 };
 
 const int kNumFrames = 300;
 
 }  // namespace
 
-// Tests for plotting statistics from logs.
+// Tests for plotting statistics from logs. Every configuration writes to files
+// of its own, so a sweep can be run on all cores with
+// tools_webrtc/gtest-parallel-wrapper.py.
 class PlotVideoProcessorIntegrationTest
     : public VideoProcessorIntegrationTest,
       public ::testing::WithParamInterface<
@@ -20,6 +20,17 @@
 namespace webrtc {
 namespace test {
 namespace {
+// Writes the value of the metric for |frame_number| followed by |separator|,
+// or only the separator if the metric wasn't computed for the frame.
+void PrintQualityValue(FILE* file,
+                       const QualityMetricsResult& result,
+                       int frame_number,
+                       char separator) {
+  if (static_cast<size_t>(frame_number) < result.frames.size())
+    fprintf(file, "%f", result.frames[frame_number].value);
+  fputc(separator, file);
+}
+
 bool LessForEncodeTime(const FrameStatistic& s1, const FrameStatistic& s2) {
   return s1.encode_time_in_us < s2.encode_time_in_us;
 }
@@ -58,6 +69,7 @@ void Stats::PrintSummary() {
   // Calculate min, max, average and total encoding time.
   int total_encoding_time_in_us = 0;
   int total_decoding_time_in_us = 0;
+  int64_t total_decode_call_time_in_us = 0;
   int total_qp = 0;
   int total_qp_count = 0;
   size_t total_encoded_frames_lengths = 0;
@@ -69,6 +81,7 @@ void Stats::PrintSummary() {
   for (const FrameStatistic& stat : stats_) {
     total_encoding_time_in_us += stat.encode_time_in_us;
     total_decoding_time_in_us += stat.decode_time_in_us;
+    total_decode_call_time_in_us += stat.decode_call_time_in_us;
     total_encoded_frames_lengths += stat.encoded_frame_length_in_bytes;
     if (stat.frame_type == webrtc::kVideoFrameKey) {
       total_encoded_key_frames_lengths += stat.encoded_frame_length_in_bytes;
@@ -119,6 +132,10 @@ void Stats::PrintSummary() {
            static_cast<int>(total_decoding_time_in_us / decoded_frames.size()));
     printf("  Failures: %d frames failed to decode.\n",
            static_cast<int>(stats_.size() - decoded_frames.size()));
+    if (total_decode_call_time_in_us > 0) {
+      printf("  Throughput: %7.1f fps\n",
+             decoded_frames.size() * 1e6 / total_decode_call_time_in_us);
+    }
   }
 
   // Frame size stats.
@@ -162,5 +179,26 @@ void Stats::PrintSummary() {
   printf("Average QP: %d\n", avg_qp);
 }
 
+bool Stats::WriteCsv(const std::string& filename,
+                     const QualityMetricsResult& psnr_result,
+                     const QualityMetricsResult& ssim_result) const {
+  FILE* file = fopen(filename.c_str(), "w");
+  if (!file)
+    return false;
+  fprintf(file,
+          "frame_number,frame_type,encode_time_us,decode_time_us,"
+          "encoded_size_bytes,bit_rate_kbps,qp,packets_dropped,psnr,ssim\n");
+  for (const FrameStatistic& stat : stats_) {
+    fprintf(file, "%d,%s,%d,%d,%" PRIuS ",%d,%d,%d,", stat.frame_number,
+            stat.frame_type == kVideoFrameKey ? "key" : "delta",
+            stat.encode_time_in_us, stat.decode_time_in_us,
+            stat.encoded_frame_length_in_bytes, stat.bit_rate_in_kbps, stat.qp,
+            stat.packets_dropped);
+    PrintQualityValue(file, psnr_result, stat.frame_number, ',');
+    PrintQualityValue(file, ssim_result, stat.frame_number, '\n');
+  }
+  return fclose(file) == 0;
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -11,9 +11,11 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_STATS_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_STATS_H_
 
+#include <string>
 #include <vector>
 
 #include "webrtc/common_types.h"
+#include "webrtc/test/testsupport/metrics/video_metrics.h"
 
 namespace webrtc {
 namespace test {
@@ -25,7 +27,11 @@ struct FrameStatistic {
   int encode_return_code = 0;
   int decode_return_code = 0;
   int encode_time_in_us = 0;
+  // From the start of the Decode() call to the frame being decoded, which may
+  // be several calls later with frame parallel decoders.
   int decode_time_in_us = 0;
+  // Time spent in the Decode() call, for the decoder's throughput.
+  int decode_call_time_in_us = 0;
   int qp = -1;
   int frame_number = 0;
   // How many packets were discarded of the encoded frame data (if any).
@@ -60,6 +66,14 @@ class Stats {
   // processing.
   void PrintSummary();
 
+  // Writes one line per frame, with its encode and decode times, encoded size
+  // and type, and its PSNR and SSIM when |psnr_result| and |ssim_result| have
+  // them, to |filename| as comma-separated values. Returns false if the file
+  // can't be written.
+  bool WriteCsv(const std::string& filename,
+                const QualityMetricsResult& psnr_result,
+                const QualityMetricsResult& ssim_result) const;
+
   std::vector<FrameStatistic> stats_;
 };
 
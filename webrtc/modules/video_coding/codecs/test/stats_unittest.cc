@@ -10,7 +10,12 @@
 
 #include "webrtc/modules/video_coding/codecs/test/stats.h"
 
+#include <stdio.h>
+
+#include <string>
+
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -43,5 +48,43 @@ TEST(StatsTest, AddMultipleFrames) {
   stats.PrintSummary();  // should not crash
 }
 
+TEST(StatsTest, WriteCsv) {
+  Stats stats;
+  FrameStatistic& key_frame = stats.NewFrame(0);
+  key_frame.frame_type = kVideoFrameKey;
+  key_frame.encode_time_in_us = 1000;
+  key_frame.decode_time_in_us = 500;
+  key_frame.encoded_frame_length_in_bytes = 3000;
+  FrameStatistic& delta_frame = stats.NewFrame(1);
+  delta_frame.encode_time_in_us = 800;
+  delta_frame.decode_time_in_us = 400;
+  delta_frame.encoded_frame_length_in_bytes = 700;
+  QualityMetricsResult psnr_result;
+  psnr_result.frames.push_back({0, 40.5});
+  psnr_result.frames.push_back({1, 38.25});
+  // No SSIM for the second frame.
+  QualityMetricsResult ssim_result;
+  ssim_result.frames.push_back({0, 0.5});
+
+  const std::string filename = TempFilename(OutputPath(), "stats_unittest");
+  ASSERT_TRUE(stats.WriteCsv(filename, psnr_result, ssim_result));
+
+  FILE* file = fopen(filename.c_str(), "r");
+  ASSERT_TRUE(file != nullptr);
+  char line[256];
+  ASSERT_TRUE(fgets(line, sizeof(line), file));
+  EXPECT_STREQ(
+      "frame_number,frame_type,encode_time_us,decode_time_us,"
+      "encoded_size_bytes,bit_rate_kbps,qp,packets_dropped,psnr,ssim\n",
+      line);
+  ASSERT_TRUE(fgets(line, sizeof(line), file));
+  EXPECT_STREQ("0,key,1000,500,3000,0,-1,0,40.500000,0.500000\n", line);
+  ASSERT_TRUE(fgets(line, sizeof(line), file));
+  EXPECT_STREQ("1,delta,800,400,700,0,-1,0,38.250000,\n", line);
+  EXPECT_FALSE(fgets(line, sizeof(line), file));
+  fclose(file);
+  remove(filename.c_str());
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -395,6 +395,8 @@ void VideoProcessor::FrameEncoded(webrtc::VideoCodecType codec,
   frame_info->decode_start_ns = rtc::TimeNanos();
   frame_stat->decode_return_code =
       decoder_->Decode(copied_image, last_frame_missing, nullptr);
+  frame_stat->decode_call_time_in_us = GetElapsedTimeMicroseconds(
+      frame_info->decode_start_ns, rtc::TimeNanos());
 
   if (frame_stat->decode_return_code != WEBRTC_VIDEO_CODEC_OK) {
     // Write the last successful frame the output file to avoid getting it out
@@ -12,6 +12,8 @@
 
 #include <vector>
 
+#include "webrtc/test/field_trial.h"
+
 namespace webrtc {
 namespace test {
 
@@ -94,6 +96,30 @@ TEST_F(VideoProcessorIntegrationTest, Process0PercentPacketLossVP9) {
                               kNoVisualizationParams);
 }
 
+// VP9: Same as Process0PercentPacketLossVP9, but decoding on all cores in
+// frame parallel mode. The decode time and throughput are in the summary.
+TEST_F(VideoProcessorIntegrationTest,
+       Process0PercentPacketLossFrameParallelDecodingVP9) {
+  ScopedFieldTrials field_trials("WebRTC-VP9FrameParallelDecoding/Enabled/");
+  SetTestConfig(&config_, kHwCodec, false /* use_single_core */, 0.0f,
+                kForemanCif, kVerboseLogging);
+  SetCodecSettings(&config_, kVideoCodecVP9, 1, false, false, true, false,
+                   kResilienceOn, kCifWidth, kCifHeight);
+
+  RateProfile rate_profile;
+  SetRateProfile(&rate_profile, 0, 500, 30, 0);
+  rate_profile.frame_index_rate_update[1] = kNumFramesShort + 1;
+  rate_profile.num_frames = kNumFramesShort;
+
+  std::vector<RateControlThresholds> rc_thresholds;
+  AddRateControlThresholds(0, 40, 20, 10, 20, 0, 1, &rc_thresholds);
+
+  QualityThresholds quality_thresholds(37.0, 36.0, 0.93, 0.92);
+
+  ProcessFramesAndMaybeVerify(rate_profile, &rc_thresholds, &quality_thresholds,
+                              kNoVisualizationParams);
+}
+
 // VP9: Run with 5% packet loss and fixed bitrate. Quality should be a bit
 // lower. One key frame (first frame only) in sequence.
 TEST_F(VideoProcessorIntegrationTest, Process5PercentPacketLossVP9) {
@@ -41,6 +41,7 @@
 #include "webrtc/rtc_base/file.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/frame_reader.h"
@@ -109,6 +110,9 @@ struct RateControlThresholds {
 struct VisualizationParams {
   bool save_encoded_ivf;
   bool save_decoded_y4m;
+  // Per-frame encode/decode times, sizes and quality, as comma-separated
+  // values.
+  bool save_frame_stats_csv;
 };
 
 // Integration test for video processor. Encodes+decodes a clip and
@@ -219,6 +223,9 @@ class VideoProcessorIntegrationTest : public testing::Test {
             config_.codec_settings.height, initial_framerate_fps));
         EXPECT_TRUE(decoded_frame_writer_->Init());
       }
+      if (visualization_params->save_frame_stats_csv) {
+        frame_stats_csv_filename_ = output_filename_base + ".csv";
+      }
     }
 
     packet_manipulator_.reset(new PacketManipulatorImpl(
@@ -531,15 +538,23 @@ class VideoProcessorIntegrationTest : public testing::Test {
     }
 
     // TODO(marpan): Should compute these quality metrics per SetRates update.
+    // The frames are compared on all cores, since the comparison takes about
+    // as long as the encoding and decoding of a clip.
     QualityMetricsResult psnr_result, ssim_result;
-    EXPECT_EQ(0, I420MetricsFromFiles(config_.input_filename.c_str(),
-                                      config_.output_filename.c_str(),
-                                      config_.codec_settings.width,
-                                      config_.codec_settings.height,
-                                      &psnr_result, &ssim_result));
+    EXPECT_EQ(0, I420MetricsFromFilesMultiThreaded(
+                     config_.input_filename.c_str(),
+                     config_.output_filename.c_str(),
+                     config_.codec_settings.width,
+                     config_.codec_settings.height,
+                     CpuInfo::DetectNumberOfCores(), &psnr_result,
+                     &ssim_result));
     if (quality_thresholds) {
       VerifyQuality(psnr_result, ssim_result, *quality_thresholds);
     }
+    if (!frame_stats_csv_filename_.empty()) {
+      EXPECT_TRUE(stats_.WriteCsv(frame_stats_csv_filename_, psnr_result,
+                                  ssim_result));
+    }
     stats_.PrintSummary();
     printf("PSNR avg: %f, min: %f\nSSIM avg: %f, min: %f\n",
            psnr_result.average, psnr_result.min, ssim_result.average,
@@ -663,6 +678,8 @@ class VideoProcessorIntegrationTest : public testing::Test {
   std::unique_ptr<FrameWriter> analysis_frame_writer_;
   std::unique_ptr<IvfFileWriter> encoded_frame_writer_;
   std::unique_ptr<FrameWriter> decoded_frame_writer_;
+  // Empty unless the per-frame statistics are to be saved.
+  std::string frame_stats_csv_filename_;
   PacketReader packet_reader_;
   std::unique_ptr<PacketManipulator> packet_manipulator_;
   Stats stats_;
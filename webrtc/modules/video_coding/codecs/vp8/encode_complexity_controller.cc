@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/codecs/vp8/encode_complexity_controller.h"
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace {
+// Encode times are averaged over this many frames, about a second of video,
+// before the settings are reconsidered.
+const int kFramesPerUpdate = 30;
+// Fastest speed setting libvpx supports for VP8.
+const int kMinCpuSpeed = -16;
+const int kCpuSpeedStep = 2;
+// The settings are only relaxed when the average encode time is below this
+// share of the budget, which leaves room for the slower settings to fit.
+const int kUnderusePercent = 50;
+}  // namespace
+
+EncodeComplexityController::EncodeComplexityController(int budget_percent)
+    : budget_percent_(budget_percent),
+      initial_({1, 0}),
+      settings_(initial_),
+      max_threads_(1),
+      sum_encode_time_us_(0),
+      num_frames_(0) {
+  RTC_DCHECK_GT(budget_percent, 0);
+}
+
+void EncodeComplexityController::Reset(const Settings& initial,
+                                       int max_threads) {
+  RTC_DCHECK_GE(initial.threads, 1);
+  initial_ = initial;
+  settings_ = initial;
+  max_threads_ = std::max(max_threads, initial.threads);
+  sum_encode_time_us_ = 0;
+  num_frames_ = 0;
+}
+
+bool EncodeComplexityController::OnFrameEncoded(int64_t encode_time_us,
+                                                uint32_t framerate) {
+  RTC_DCHECK_GT(framerate, 0);
+  sum_encode_time_us_ += encode_time_us;
+  if (++num_frames_ < kFramesPerUpdate)
+    return false;
+
+  const int64_t avg_encode_time_us = sum_encode_time_us_ / num_frames_;
+  const int64_t budget_us =
+      budget_percent_ * rtc::kNumMicrosecsPerSec / (100 * framerate);
+  sum_encode_time_us_ = 0;
+  num_frames_ = 0;
+
+  bool changed = false;
+  if (avg_encode_time_us > budget_us) {
+    changed = IncreaseSpeed();
+  } else if (avg_encode_time_us * 100 < budget_us * kUnderusePercent) {
+    changed = DecreaseSpeed();
+  }
+  if (changed) {
+    LOG(LS_INFO) << "Encode time " << avg_encode_time_us << " us, budget "
+                 << budget_us << " us; now using " << settings_.threads
+                 << " threads, cpu speed " << settings_.cpu_speed;
+  }
+  return changed;
+}
+
+bool EncodeComplexityController::IncreaseSpeed() {
+  if (settings_.threads < max_threads_) {
+    ++settings_.threads;
+    return true;
+  }
+  if (settings_.cpu_speed > kMinCpuSpeed) {
+    settings_.cpu_speed =
+        std::max(settings_.cpu_speed - kCpuSpeedStep, kMinCpuSpeed);
+    return true;
+  }
+  return false;
+}
+
+bool EncodeComplexityController::DecreaseSpeed() {
+  if (settings_.cpu_speed < initial_.cpu_speed) {
+    settings_.cpu_speed =
+        std::min(settings_.cpu_speed + kCpuSpeedStep, initial_.cpu_speed);
+    return true;
+  }
+  if (settings_.threads > initial_.threads) {
+    --settings_.threads;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_ENCODE_COMPLEXITY_CONTROLLER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_ENCODE_COMPLEXITY_CONTROLLER_H_
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// Adapts the number of encoder threads and the libvpx speed setting
+// (cpu_used) to keep the average encode time within a share of the frame
+// interval. Threads are added first, as they cost no compression efficiency;
+// the speed setting is raised once all allowed threads are in use. When the
+// encode time drops well below the budget the steps are undone in reverse
+// order, never going below the settings the encoder was initialized with.
+class EncodeComplexityController {
+ public:
+  struct Settings {
+    int threads;
+    // Negative libvpx cpu_used value; lower is faster.
+    int cpu_speed;
+  };
+
+  // |budget_percent| is the share of the frame interval encoding may use.
+  explicit EncodeComplexityController(int budget_percent);
+
+  // Starts over from |initial|, allowing up to |max_threads| threads.
+  void Reset(const Settings& initial, int max_threads);
+
+  // Reports the time it took to encode a frame, with the input at |framerate|
+  // fps. Returns true if settings() changed.
+  bool OnFrameEncoded(int64_t encode_time_us, uint32_t framerate);
+
+  const Settings& settings() const { return settings_; }
+
+ private:
+  bool IncreaseSpeed();
+  bool DecreaseSpeed();
+
+  const int budget_percent_;
+  Settings initial_;
+  Settings settings_;
+  int max_threads_;
+  int64_t sum_encode_time_us_;
+  int num_frames_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_ENCODE_COMPLEXITY_CONTROLLER_H_
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/codecs/vp8/encode_complexity_controller.h"
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+const int kBudgetPercent = 50;
+const uint32_t kFramerate = 30;
+// Budget at |kBudgetPercent| of a 30 fps frame interval.
+const int64_t kBudgetUs = 16666;
+const int kFramesPerUpdate = 30;
+}  // namespace
+
+class EncodeComplexityControllerTest : public ::testing::Test {
+ protected:
+  EncodeComplexityControllerTest() : controller_(kBudgetPercent) {
+    controller_.Reset({2, -6}, 4);
+  }
+
+  // Returns true if the settings changed during the update period.
+  bool EncodeFrames(int64_t encode_time_us) {
+    bool changed = false;
+    for (int i = 0; i < kFramesPerUpdate; ++i)
+      changed |= controller_.OnFrameEncoded(encode_time_us, kFramerate);
+    return changed;
+  }
+
+  EncodeComplexityController controller_;
+};
+
+TEST_F(EncodeComplexityControllerTest, KeepsSettingsWithinBudget) {
+  EXPECT_FALSE(EncodeFrames(kBudgetUs * 3 / 4));
+  EXPECT_EQ(2, controller_.settings().threads);
+  EXPECT_EQ(-6, controller_.settings().cpu_speed);
+}
+
+TEST_F(EncodeComplexityControllerTest, WaitsForFullUpdatePeriod) {
+  for (int i = 0; i < kFramesPerUpdate - 1; ++i)
+    EXPECT_FALSE(controller_.OnFrameEncoded(kBudgetUs * 2, kFramerate));
+  EXPECT_TRUE(controller_.OnFrameEncoded(kBudgetUs * 2, kFramerate));
+}
+
+TEST_F(EncodeComplexityControllerTest, AddsThreadsBeforeRaisingSpeed) {
+  EXPECT_TRUE(EncodeFrames(kBudgetUs * 2));
+  EXPECT_EQ(3, controller_.settings().threads);
+  EXPECT_EQ(-6, controller_.settings().cpu_speed);
+  EXPECT_TRUE(EncodeFrames(kBudgetUs * 2));
+  EXPECT_EQ(4, controller_.settings().threads);
+  EXPECT_EQ(-6, controller_.settings().cpu_speed);
+  EXPECT_TRUE(EncodeFrames(kBudgetUs * 2));
+  EXPECT_EQ(4, controller_.settings().threads);
+  EXPECT_EQ(-8, controller_.settings().cpu_speed);
+}
+
+TEST_F(EncodeComplexityControllerTest, StopsAtFastestSpeed) {
+  while (EncodeFrames(kBudgetUs * 2)) {
+  }
+  EXPECT_EQ(4, controller_.settings().threads);
+  EXPECT_EQ(-16, controller_.settings().cpu_speed);
+}
+
+TEST_F(EncodeComplexityControllerTest, RelaxesInReverseOrderWhenUnderused) {
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(EncodeFrames(kBudgetUs * 2));
+  // Below the budget, but not enough to relax the settings.
+  EXPECT_FALSE(EncodeFrames(kBudgetUs * 3 / 4));
+
+  EXPECT_TRUE(EncodeFrames(kBudgetUs / 4));
+  EXPECT_EQ(4, controller_.settings().threads);
+  EXPECT_EQ(-6, controller_.settings().cpu_speed);
+  EXPECT_TRUE(EncodeFrames(kBudgetUs / 4));
+  EXPECT_EQ(3, controller_.settings().threads);
+  EXPECT_TRUE(EncodeFrames(kBudgetUs / 4));
+  EXPECT_EQ(2, controller_.settings().threads);
+  // Never below the initial settings.
+  EXPECT_FALSE(EncodeFrames(kBudgetUs / 4));
+  EXPECT_EQ(2, controller_.settings().threads);
+  EXPECT_EQ(-6, controller_.settings().cpu_speed);
+}
+
+TEST_F(EncodeComplexityControllerTest, BudgetFollowsFramerate) {
+  // Within budget at 30 fps, but not at 60 fps.
+  for (int i = 0; i < kFramesPerUpdate - 1; ++i)
+    controller_.OnFrameEncoded(kBudgetUs * 3 / 4, kFramerate * 2);
+  EXPECT_TRUE(controller_.OnFrameEncoded(kBudgetUs * 3 / 4, kFramerate * 2));
+  EXPECT_EQ(3, controller_.settings().threads);
+}
+
+TEST_F(EncodeComplexityControllerTest, ResetRestoresInitialSettings) {
+  EXPECT_TRUE(EncodeFrames(kBudgetUs * 2));
+  controller_.Reset({1, -12}, 1);
+  EXPECT_EQ(1, controller_.settings().threads);
+  EXPECT_EQ(-12, controller_.settings().cpu_speed);
+  EXPECT_TRUE(EncodeFrames(kBudgetUs * 2));
+  EXPECT_EQ(1, controller_.settings().threads);
+  EXPECT_EQ(-14, controller_.settings().cpu_speed);
+}
+
+}  // namespace webrtc
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <cmath>
 
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
@@ -27,6 +28,16 @@ static const int kMinTimeBetweenSyncs = kOneSecond90Khz * 5;
 static const int kMaxTimeBetweenSyncs = kOneSecond90Khz * 10;
 static const int kQpDeltaThresholdForSync = 8;
 static const int kMinBitrateKbpsForQpBoost = 500;
+// The encoder drops frames of more than this many average frame sizes, unless
+// already at max qp, and encodes them again at max qp.
+static const double kOvershootDropFactor = 2.0;
+// Roughly how many qp steps halve the size of a frame.
+static const double kQpStepsPerSizeHalving = 6.0;
+// Smallest changed area a frame size is scaled by, as also unchanged frames
+// cost some bytes.
+static const float kMinChangedArea = 0.05f;
+// Weight of the latest frame in the frame size estimate.
+static const double kFrameSizeSmoothingFactor = 0.25;
 
 const double ScreenshareLayers::kMaxTL0FpsReduction = 2.5;
 const double ScreenshareLayers::kAcceptableTargetOvershoot = 2.0;
@@ -69,6 +80,8 @@ ScreenshareLayers::ScreenshareLayers(int num_temporal_layers,
       min_qp_(-1),
       max_qp_(-1),
       max_debt_bytes_(0),
+      changed_area_reported_(false),
+      max_qp_forced_(false),
       encode_framerate_(1000.0f, 1000.0f),  // 1 second window, second scale.
       bitrate_updated_(false) {
   RTC_CHECK_GT(number_of_temporal_layers_, 0);
@@ -194,10 +207,46 @@ TemporalLayers::FrameConfig ScreenshareLayers::UpdateLayerConfig(
       break;
   }
 
+  // Frames which the encoder would drop, and then encode again at max qp, are
+  // encoded at max qp in the first place.
+  if (active_layer_ != -1 &&
+      layers_[active_layer_].state == TemporalLayer::State::kNormal &&
+      PredictOvershoot(active_layer_)) {
+    layers_[active_layer_].state = TemporalLayer::State::kOvershootPredicted;
+  }
+
   tl_config.layer_sync = layer_state == TemporalLayerState::kTl1Sync;
   return tl_config;
 }
 
+void ScreenshareLayers::OnFrameChangedArea(float changed_area) {
+  RTC_DCHECK_GE(changed_area, 0.0f);
+  RTC_DCHECK_LE(changed_area, 1.0f);
+  if (!changed_area_reported_) {
+    changed_area_reported_ = true;
+    for (TemporalLayer& layer : layers_)
+      layer.changed_area = 0.0f;
+  }
+  // The changes of dropped frames add up, as they still need to be coded.
+  for (TemporalLayer& layer : layers_)
+    layer.changed_area = std::min(1.0f, layer.changed_area + changed_area);
+}
+
+bool ScreenshareLayers::PredictOvershoot(int layer) const {
+  const TemporalLayer& temporal_layer = layers_[layer];
+  if (temporal_layer.bytes_per_changed_area < 0 || max_qp_ == -1 ||
+      temporal_layer.last_qp == -1 || temporal_layer.last_qp >= max_qp_ ||
+      max_debt_bytes_ == 0) {
+    return false;
+  }
+  // Assumes the encoder starts out from the qp of the last frame.
+  const double predicted_size_bytes =
+      temporal_layer.bytes_per_changed_area *
+      std::max(kMinChangedArea, temporal_layer.changed_area) *
+      std::pow(2.0, -temporal_layer.last_qp / kQpStepsPerSizeHalving);
+  return predicted_size_bytes > kOvershootDropFactor * max_debt_bytes_;
+}
+
 std::vector<uint32_t> ScreenshareLayers::OnRatesUpdated(int bitrate_kbps,
                                                         int max_bitrate_kbps,
                                                         int framerate) {
@@ -245,12 +294,30 @@ void ScreenshareLayers::FrameEncoded(unsigned int size, int qp) {
     return;
   }
 
-  if (layers_[active_layer_].state == TemporalLayer::State::kDropped) {
+  if (layers_[active_layer_].state == TemporalLayer::State::kDropped ||
+      layers_[active_layer_].state ==
+          TemporalLayer::State::kOvershootPredicted) {
     layers_[active_layer_].state = TemporalLayer::State::kQualityBoost;
   }
 
-  if (qp != -1)
+  if (qp != -1) {
     layers_[active_layer_].last_qp = qp;
+    TemporalLayer& layer = layers_[active_layer_];
+    const double bytes_per_changed_area =
+        size / std::max(kMinChangedArea, layer.changed_area) *
+        std::pow(2.0, qp / kQpStepsPerSizeHalving);
+    layer.bytes_per_changed_area =
+        layer.bytes_per_changed_area < 0
+            ? bytes_per_changed_area
+            : (1 - kFrameSizeSmoothingFactor) * layer.bytes_per_changed_area +
+                  kFrameSizeSmoothingFactor * bytes_per_changed_area;
+  }
+  if (changed_area_reported_) {
+    // TL1 frames predict from TL0 as well.
+    layers_[1].changed_area = 0.0f;
+    if (active_layer_ == 0)
+      layers_[0].changed_area = 0.0f;
+  }
 
   if (active_layer_ == 0) {
     layers_[0].debt_bytes_ += size;
@@ -346,7 +413,9 @@ bool ScreenshareLayers::UpdateConfiguration(vpx_codec_enc_cfg_t* cfg) {
 
     // Don't reconfigure qp limits during quality boost frames.
     if (active_layer_ == -1 ||
-        layers_[active_layer_].state != TemporalLayer::State::kQualityBoost) {
+        (layers_[active_layer_].state !=
+             TemporalLayer::State::kQualityBoost &&
+         !max_qp_forced_)) {
       min_qp_ = cfg->rc_min_quantizer;
       max_qp_ = cfg->rc_max_quantizer;
       // After a dropped frame, a frame with max qp will be encoded and the
@@ -388,6 +457,14 @@ bool ScreenshareLayers::UpdateConfiguration(vpx_codec_enc_cfg_t* cfg) {
   if (max_qp_ == -1 || number_of_temporal_layers_ <= 1)
     return cfg_updated;
 
+  const bool force_max_qp = layers_[active_layer_].state ==
+                            TemporalLayer::State::kOvershootPredicted;
+  if (force_max_qp != max_qp_forced_) {
+    cfg->rc_min_quantizer = force_max_qp ? max_qp_ : min_qp_;
+    max_qp_forced_ = force_max_qp;
+    cfg_updated = true;
+  }
+
   // If layer is in the quality boost state (following a dropped frame), update
   // the configuration with the adjusted (lower) qp and set the state back to
   // normal.
@@ -54,6 +54,8 @@ class ScreenshareLayers : public TemporalLayers {
 
   void FrameEncoded(unsigned int size, int qp) override;
 
+  void OnFrameChangedArea(float changed_area) override;
+
   uint8_t Tl0PicIdx() const override;
 
  private:
@@ -61,6 +63,9 @@ class ScreenshareLayers : public TemporalLayers {
 
   bool TimeToSync(int64_t timestamp) const;
   uint32_t GetCodecTargetBitrateKbps() const;
+  // Whether the next frame of |layer| is predicted to overshoot enough for
+  // the encoder to drop it and have it encoded again at max qp.
+  bool PredictOvershoot(int layer) const;
 
   Clock* const clock_;
 
@@ -75,6 +80,11 @@ class ScreenshareLayers : public TemporalLayers {
   int min_qp_;
   int max_qp_;
   uint32_t max_debt_bytes_;
+  // Set once OnFrameChangedArea() is called; otherwise every frame is assumed
+  // to change all of it.
+  bool changed_area_reported_;
+  // Set while the encoder is configured with the min qp raised to max qp.
+  bool max_qp_forced_;
 
   // Configured max framerate.
   rtc::Optional<uint32_t> target_framerate_;
@@ -91,19 +101,28 @@ class ScreenshareLayers : public TemporalLayers {
           enhanced_max_qp(-1),
           last_qp(-1),
           debt_bytes_(0),
-          target_rate_kbps_(0) {}
+          target_rate_kbps_(0),
+          changed_area(1.0f),
+          bytes_per_changed_area(-1.0) {}
 
     enum class State {
       kNormal,
       kDropped,
       kReencoded,
       kQualityBoost,
+      // The next frame is encoded at max qp, as it is predicted to overshoot.
+      kOvershootPredicted,
     } state;
 
     int enhanced_max_qp;
     int last_qp;
     uint32_t debt_bytes_;
     uint32_t target_rate_kbps_;
+    // Fraction of the frame which changed since the last frame of the layer.
+    float changed_area;
+    // Estimated size of frames of the layer with all of the frame changed,
+    // scaled to qp 0, or -1 until a frame has been encoded.
+    double bytes_per_changed_area;
 
     void UpdateDebt(int64_t delta_ms);
   } layers_[kMaxNumTemporalLayers];
@@ -604,4 +604,31 @@ TEST_F(ScreenshareLayerTest, 2LayersSyncAtOvershootDrop) {
   EXPECT_TRUE(new_vp8_info.layerSync);
 }
 
+TEST_F(ScreenshareLayerTest, EncodesPredictedOvershootAtMaxQp) {
+  const int kLowQp = kDefaultQp - 24;
+  const float kSmallChangedArea = 0.05f;
+  // Frames of the average size, with only a small part of the screen changed.
+  for (int i = 0; i < 4; ++i) {
+    layers_->OnFrameChangedArea(kSmallChangedArea);
+    ASSERT_NE(-1, ConfigureFrame(false));
+    EXPECT_EQ(static_cast<unsigned int>(min_qp_), cfg_.rc_min_quantizer);
+    layers_->FrameEncoded(frame_size_ / 2, kLowQp);
+    timestamp_ += kTimestampDelta5Fps;
+  }
+
+  // The whole screen changing makes for a frame the encoder would drop, so it
+  // is encoded at max qp right away.
+  layers_->OnFrameChangedArea(1.0f);
+  ASSERT_NE(-1, ConfigureFrame(false));
+  EXPECT_TRUE(config_updated_);
+  EXPECT_EQ(static_cast<unsigned int>(max_qp_), cfg_.rc_min_quantizer);
+  layers_->FrameEncoded(frame_size_ / 2, max_qp_);
+  timestamp_ += kTimestampDelta5Fps;
+
+  layers_->OnFrameChangedArea(kSmallChangedArea);
+  ASSERT_NE(-1, ConfigureFrame(false));
+  EXPECT_TRUE(config_updated_);
+  EXPECT_EQ(static_cast<unsigned int>(min_qp_), cfg_.rc_min_quantizer);
+}
+
 }  // namespace webrtc
@@ -109,6 +109,10 @@ class TemporalLayers {
 
   virtual void FrameEncoded(unsigned int size, int qp) = 0;
 
+  // Called before UpdateLayerConfig() with the fraction of the frame, from 0
+  // to 1, which changed since the previous frame given to the encoder.
+  virtual void OnFrameChangedArea(float changed_area) {}
+
   // Returns the current tl0_pic_idx, so it can be reused in future
   // instantiations.
   virtual uint8_t Tl0PicIdx() const = 0;
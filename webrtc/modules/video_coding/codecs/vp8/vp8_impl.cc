@@ -44,6 +44,13 @@ const char kVp8PostProcArmFieldTrial[] = "WebRTC-VP8-Postproc-Arm";
 const char kVp8GfBoostFieldTrial[] = "WebRTC-VP8-GfBoost";
 const char kVp8ForceFallbackEncoderFieldTrial[] =
     "WebRTC-VP8-Forced-Fallback-Encoder";
+const char kVp8AdaptiveComplexityFieldTrial[] = "WebRTC-VP8-AdaptiveComplexity";
+
+// Share of the frame interval encoding may use with adaptive complexity,
+// unless the field trial group sets it.
+const int kDefaultEncodeTimeBudgetPercent = 50;
+// Upper bound on the threads added by adaptive complexity.
+const int kMaxAdaptiveThreads = 8;
 
 const int kTokenPartitions = VP8_ONE_TOKENPARTITION;
 enum { kVp8ErrorPropagationTh = 30 };
@@ -151,6 +158,36 @@ bool GetGfBoostPercentageFromFieldTrialGroup(int* boost_percentage) {
   return true;
 }
 
+std::unique_ptr<EncodeComplexityController>
+CreateComplexityControllerFromFieldTrial() {
+  if (!webrtc::field_trial::IsEnabled(kVp8AdaptiveComplexityFieldTrial))
+    return nullptr;
+
+  std::string group =
+      webrtc::field_trial::FindFullName(kVp8AdaptiveComplexityFieldTrial);
+  int budget_percent;
+  if (sscanf(group.c_str(), "Enabled-%d", &budget_percent) != 1)
+    budget_percent = kDefaultEncodeTimeBudgetPercent;
+
+  if (budget_percent <= 0 || budget_percent > 100)
+    return nullptr;
+
+  return std::unique_ptr<EncodeComplexityController>(
+      new EncodeComplexityController(budget_percent));
+}
+
+// Uses one token partition per thread, up to the eight VP8 allows, so that
+// decoders can parse the partitions in parallel too.
+vp8e_token_partitions TokenPartitionsForThreads(int threads) {
+  if (threads >= 8)
+    return VP8_EIGHT_TOKENPARTITION;
+  if (threads >= 4)
+    return VP8_FOUR_TOKENPARTITION;
+  if (threads >= 2)
+    return VP8_TWO_TOKENPARTITION;
+  return VP8_ONE_TOKENPARTITION;
+}
+
 void GetPostProcParamsFromFieldTrialGroup(
     VP8DecoderImpl::DeblockParams* deblock_params) {
   std::string group =
@@ -209,6 +246,7 @@ vpx_enc_frame_flags_t VP8EncoderImpl::EncodeFlags(
 VP8EncoderImpl::VP8EncoderImpl()
     : use_gf_boost_(webrtc::field_trial::IsEnabled(kVp8GfBoostFieldTrial)),
       min_pixels_per_frame_(GetForcedFallbackMinPixelsFromFieldTrialGroup()),
+      complexity_controller_(CreateComplexityControllerFromFieldTrial()),
       encoded_complete_callback_(nullptr),
       inited_(false),
       timestamp_(0),
@@ -263,6 +301,8 @@ int VP8EncoderImpl::Release() {
     tl0_pic_idx_[i] = temporal_layers_[i]->Tl0PicIdx();
   }
   temporal_layers_.clear();
+  active_maps_.clear();
+  input_buffer_pool_.Release();
   inited_ = false;
   return ret_val;
 }
@@ -524,6 +564,11 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
   // TODO(fbarchard): Consider number of Simulcast layers.
   configurations_[0].g_threads = NumberOfThreads(
       configurations_[0].g_w, configurations_[0].g_h, number_of_cores);
+  if (complexity_controller_) {
+    complexity_controller_->Reset(
+        {static_cast<int>(configurations_[0].g_threads), cpu_speed_[0]},
+        std::min(number_of_cores, kMaxAdaptiveThreads));
+  }
 
   // Creating a wrapper to the image - setting image data to NULL.
   // Actual pointer will be set in encode. Setting align to 1, as it
@@ -571,6 +616,11 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
     temporal_layers_[stream_idx]->UpdateConfiguration(&configurations_[i]);
   }
 
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    active_maps_.emplace_back(new ActiveMap(
+        inst->width, inst->height, raw_images_[i].d_w, raw_images_[i].d_h));
+  }
+
   return InitAndSetControlSettings();
 }
 
@@ -671,8 +721,11 @@ int VP8EncoderImpl::InitAndSetControlSettings() {
     vpx_codec_control(&(encoders_[i]), VP8E_SET_STATIC_THRESHOLD,
                       codec_.mode == kScreensharing ? 300 : 1);
     vpx_codec_control(&(encoders_[i]), VP8E_SET_CPUUSED, cpu_speed_[i]);
-    vpx_codec_control(&(encoders_[i]), VP8E_SET_TOKEN_PARTITIONS,
-                      static_cast<vp8e_token_partitions>(kTokenPartitions));
+    vpx_codec_control(
+        &(encoders_[i]), VP8E_SET_TOKEN_PARTITIONS,
+        complexity_controller_
+            ? TokenPartitionsForThreads(configurations_[i].g_threads)
+            : static_cast<vp8e_token_partitions>(kTokenPartitions));
     vpx_codec_control(&(encoders_[i]), VP8E_SET_MAX_INTRA_BITRATE_PCT,
                       rc_max_intra_target_);
     // VP8E_SET_SCREEN_CONTENT_MODE 2 = screen content with more aggressive
@@ -692,6 +745,28 @@ int VP8EncoderImpl::InitAndSetControlSettings() {
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int VP8EncoderImpl::ApplyComplexitySettings() {
+  const EncodeComplexityController::Settings& settings =
+      complexity_controller_->settings();
+  // Only the highest resolution stream is multi-threaded; the lower ones
+  // follow its speed setting relative to where they started.
+  if (configurations_[0].g_threads !=
+      static_cast<unsigned int>(settings.threads)) {
+    configurations_[0].g_threads = settings.threads;
+    if (vpx_codec_enc_config_set(&encoders_[0], &configurations_[0]))
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    vpx_codec_control(&encoders_[0], VP8E_SET_TOKEN_PARTITIONS,
+                      TokenPartitionsForThreads(settings.threads));
+  }
+  const int speed_offset = settings.cpu_speed - cpu_speed_[0];
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    vpx_codec_control(&encoders_[i], VP8E_SET_CPUUSED,
+                      std::max(cpu_speed_[i] + speed_offset,
+                               settings.cpu_speed));
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
 uint32_t VP8EncoderImpl::MaxIntraTarget(uint32_t optimalBuffersize) {
   // Set max to the optimal buffer level (normalized by target BR),
   // and scaled by a scalePar.
@@ -719,8 +794,16 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
   if (encoded_complete_callback_ == NULL)
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
 
-  rtc::scoped_refptr<I420BufferInterface> input_image =
-      frame.video_frame_buffer()->ToI420();
+  rtc::scoped_refptr<I420BufferInterface> input_image;
+  if (frame.video_frame_buffer()->type() == VideoFrameBuffer::Type::kNV12) {
+    rtc::scoped_refptr<I420Buffer> i420_buffer =
+        input_buffer_pool_.CreateBuffer(frame.width(), frame.height());
+    nv12_to_i420_scaler_.NV12ToI420Scale(*frame.video_frame_buffer()->GetNV12(),
+                                         i420_buffer.get());
+    input_image = i420_buffer;
+  } else {
+    input_image = frame.video_frame_buffer()->ToI420();
+  }
   // Since we are extracting raw pointers from |input_image| to
   // |raw_images_[0]|, the resolution of these frames must match.
   RTC_DCHECK_EQ(input_image->width(), raw_images_[0].d_w);
@@ -754,9 +837,18 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
         raw_images_[i].stride[VPX_PLANE_V], raw_images_[i].d_w,
         raw_images_[i].d_h, libyuv::kFilterBilinear);
   }
+  // Added before the frame may be dropped, since the changes of a dropped
+  // frame still need to be coded in the next one.
+  for (const std::unique_ptr<ActiveMap>& active_map : active_maps_)
+    active_map->AddFrame(frame);
+  const VideoFrame::UpdateRect update_rect = frame.update_rect();
+  const float changed_area = std::min(
+      1.0f, static_cast<float>(update_rect.width * update_rect.height) /
+                (frame.width() * frame.height()));
   vpx_enc_frame_flags_t flags[kMaxSimulcastStreams];
   TemporalLayers::FrameConfig tl_configs[kMaxSimulcastStreams];
   for (size_t i = 0; i < encoders_.size(); ++i) {
+    temporal_layers_[i]->OnFrameChangedArea(changed_area);
     tl_configs[i] = temporal_layers_[i]->UpdateLayerConfig(frame.timestamp());
 
     if (tl_configs[i].drop_frame) {
@@ -818,6 +910,19 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
     vpx_codec_control(&encoders_[i], VP8E_SET_FRAME_FLAGS, flags[stream_idx]);
     vpx_codec_control(&encoders_[i], VP8E_SET_TEMPORAL_LAYER_ID,
                       tl_configs[i].encoder_layer_id);
+
+    // Macroblocks which are unchanged since the last reference frame can be
+    // skipped, unless the frame doesn't predict from it.
+    vpx_active_map_t active_map;
+    active_map.active_map = nullptr;
+    active_map.rows = active_maps_[i]->mb_rows();
+    active_map.cols = active_maps_[i]->mb_cols();
+    if ((flags[stream_idx] & (VPX_EFLAG_FORCE_KF | VP8_EFLAG_NO_REF_LAST)) ==
+        0) {
+      active_map.active_map =
+          const_cast<unsigned char*>(active_maps_[i]->GetMap());
+    }
+    vpx_codec_control(&encoders_[i], VP8E_SET_ACTIVEMAP, &active_map);
   }
   // TODO(holmer): Ideally the duration should be the timestamp diff of this
   // frame and the next frame to be encoded, which we don't have. Instead we
@@ -829,8 +934,14 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
 
   // Note we must pass 0 for |flags| field in encode call below since they are
   // set above in |vpx_codec_control| function for each encoder/spatial layer.
+  const int64_t encode_start_us = rtc::TimeMicros();
   int error = vpx_codec_encode(&encoders_[0], &raw_images_[0], timestamp_,
                                duration, 0, VPX_DL_REALTIME);
+  if (!error && complexity_controller_ &&
+      complexity_controller_->OnFrameEncoded(
+          rtc::TimeMicros() - encode_start_us, codec_.maxFramerate)) {
+    error = ApplyComplexitySettings();
+  }
   // Reset specific intra frame thresholds, following the key frame.
   if (send_key_frame) {
     vpx_codec_control(&(encoders_[0]), VP8E_SET_MAX_INTRA_BITRATE_PCT,
@@ -840,7 +951,17 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
     return WEBRTC_VIDEO_CODEC_ERROR;
   timestamp_ += duration;
   // Examines frame timestamps only.
-  return GetEncodedPartitions(tl_configs, frame);
+  int result = GetEncodedPartitions(tl_configs, frame);
+
+  stream_idx = encoders_.size() - 1;
+  for (size_t i = 0; i < encoders_.size(); ++i, --stream_idx) {
+    // Frames dropped by libvpx are empty.
+    if (encoded_images_[i]._length > 0 &&
+        (flags[stream_idx] & VP8_EFLAG_NO_UPD_LAST) == 0) {
+      active_maps_[i]->OnReferenceUpdated();
+    }
+  }
+  return result;
 }
 
 void VP8EncoderImpl::PopulateCodecSpecific(
@@ -879,8 +1000,11 @@ int VP8EncoderImpl::GetEncodedPartitions(
     encoded_images_[encoder_idx]._length = 0;
     encoded_images_[encoder_idx]._frameType = kVideoFrameDelta;
     RTPFragmentationHeader frag_info;
-    // kTokenPartitions is number of bits used.
-    frag_info.VerifyAndAllocateFragmentationHeader((1 << kTokenPartitions) + 1);
+    // The token partitions setting is the number of bits used.
+    frag_info.VerifyAndAllocateFragmentationHeader(
+        (1 << (complexity_controller_ ? VP8_EIGHT_TOKENPARTITION
+                                      : kTokenPartitions)) +
+        1);
     CodecSpecificInfo codec_specific;
     const vpx_codec_cx_pkt_t* pkt = NULL;
     while ((pkt = vpx_codec_get_cx_data(&encoders_[encoder_idx], &iter)) !=
@@ -26,9 +26,12 @@
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/common_video/include/video_frame.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/codecs/vp8/encode_complexity_controller.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 #include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/modules/video_coding/utility/active_map.h"
 #include "webrtc/modules/video_coding/utility/quality_scaler.h"
 
 namespace webrtc {
@@ -79,6 +82,9 @@ class VP8EncoderImpl : public VP8Encoder {
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings();
 
+  // Applies the thread count and speed chosen by |complexity_controller_|.
+  int ApplyComplexitySettings();
+
   void PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                              const TemporalLayers::FrameConfig& tl_config,
                              const vpx_codec_cx_pkt& pkt,
@@ -95,6 +101,8 @@ class VP8EncoderImpl : public VP8Encoder {
 
   const bool use_gf_boost_;
   const rtc::Optional<int> min_pixels_per_frame_;
+  // Set when adaptive complexity is enabled by field trial.
+  const std::unique_ptr<EncodeComplexityController> complexity_controller_;
 
   EncodedImageCallback* encoded_complete_callback_;
   VideoCodec codec_;
@@ -115,6 +123,11 @@ class VP8EncoderImpl : public VP8Encoder {
   std::vector<vpx_codec_ctx_t> encoders_;
   std::vector<vpx_codec_enc_cfg_t> configurations_;
   std::vector<vpx_rational_t> downsampling_factors_;
+  // Per encoder, the macroblocks which changed since its last reference frame.
+  std::vector<std::unique_ptr<ActiveMap>> active_maps_;
+  // libvpx takes I420 only; NV12 input is converted into these buffers.
+  I420BufferPool input_buffer_pool_;
+  NV12ToI420Scaler nv12_to_i420_scaler_;
 };
 
 class VP8DecoderImpl : public VP8Decoder {
@@ -9,8 +9,9 @@
  */
 
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
-#include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
 #include "webrtc/modules/video_coding/codecs/test/video_codec_test.h"
+#include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
+#include "webrtc/modules/video_coding/codecs/vp9/vp9_impl.h"
 
 namespace webrtc {
 
@@ -198,4 +199,25 @@ TEST_F(TestVp9Impl, EncoderRetainsRtpStateAfterRelease) {
                   1);
 }
 
+TEST(VP9EncoderImplTest, NumberOfThreadsDependsOnCoresAndResolution) {
+  EXPECT_EQ(1, VP9EncoderImpl::NumberOfThreads(320, 180, 16));
+  EXPECT_EQ(1, VP9EncoderImpl::NumberOfThreads(640, 360, 2));
+  EXPECT_EQ(2, VP9EncoderImpl::NumberOfThreads(640, 360, 4));
+  EXPECT_EQ(2, VP9EncoderImpl::NumberOfThreads(1280, 720, 4));
+  EXPECT_EQ(4, VP9EncoderImpl::NumberOfThreads(1280, 720, 16));
+  EXPECT_EQ(4, VP9EncoderImpl::NumberOfThreads(1920, 1080, 8));
+  EXPECT_EQ(8, VP9EncoderImpl::NumberOfThreads(1920, 1080, 16));
+}
+
+TEST(VP9EncoderImplTest, TileColumnsDependOnThreadsAndWidth) {
+  EXPECT_EQ(0, VP9EncoderImpl::TileColumnsLog2(1920, 1));
+  EXPECT_EQ(0, VP9EncoderImpl::TileColumnsLog2(320, 2));
+  EXPECT_EQ(1, VP9EncoderImpl::TileColumnsLog2(640, 2));
+  EXPECT_EQ(1, VP9EncoderImpl::TileColumnsLog2(640, 4));
+  EXPECT_EQ(2, VP9EncoderImpl::TileColumnsLog2(1280, 4));
+  // At most 4 tile columns fit in 1080p, whereas 8 threads would take 8.
+  EXPECT_EQ(2, VP9EncoderImpl::TileColumnsLog2(1920, 8));
+  EXPECT_EQ(3, VP9EncoderImpl::TileColumnsLog2(3840, 8));
+}
+
 }  // namespace webrtc
@@ -11,10 +11,13 @@
 
 #include "webrtc/modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
 
+#include <limits>
+
 #include "vpx/vpx_codec.h"
 #include "vpx/vpx_decoder.h"
 #include "vpx/vpx_frame_buffer.h"
 
+#include "webrtc/modules/video_coding/utility/shared_decoder_buffer_pool.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 
@@ -28,10 +31,36 @@ size_t Vp9FrameBufferPool::Vp9FrameBuffer::GetDataSize() const {
   return data_.size();
 }
 
+size_t Vp9FrameBufferPool::Vp9FrameBuffer::GetCapacity() const {
+  return data_.capacity();
+}
+
 void Vp9FrameBufferPool::Vp9FrameBuffer::SetSize(size_t size) {
   data_.SetSize(size);
 }
 
+Vp9FrameBufferPool::Vp9FrameBufferPool()
+    : Vp9FrameBufferPool(kDefaultMaxNumBuffers,
+                         std::numeric_limits<size_t>::max()) {}
+
+Vp9FrameBufferPool::Vp9FrameBufferPool(size_t max_num_buffers,
+                                       size_t max_pooled_bytes)
+    : max_num_buffers_(max_num_buffers), max_pooled_bytes_(max_pooled_bytes) {}
+
+// static
+Vp9FrameBufferPool* Vp9FrameBufferPool::GetSharedPool() {
+  static Vp9FrameBufferPool* const shared_pool = []() -> Vp9FrameBufferPool* {
+    rtc::Optional<size_t> max_pooled_bytes =
+        GetSharedDecoderBufferPoolMaxPooledBytes();
+    if (!max_pooled_bytes)
+      return nullptr;
+    // Every decoder can hold on to as many buffers as with a pool of its own.
+    return new Vp9FrameBufferPool(std::numeric_limits<size_t>::max(),
+                                  *max_pooled_bytes);
+  }();
+  return shared_pool;
+}
+
 bool Vp9FrameBufferPool::InitializeVpxUsePool(
     vpx_codec_ctx* vpx_codec_context) {
   RTC_DCHECK(vpx_codec_context);
@@ -55,13 +84,20 @@ rtc::scoped_refptr<Vp9FrameBufferPool::Vp9FrameBuffer>
 Vp9FrameBufferPool::GetFrameBuffer(size_t min_size) {
   RTC_DCHECK_GT(min_size, 0);
   rtc::scoped_refptr<Vp9FrameBuffer> available_buffer = nullptr;
+  std::vector<rtc::scoped_refptr<Vp9FrameBuffer>> freed_buffers;
   {
     rtc::CritScope cs(&buffers_lock_);
-    // Do we have a buffer we can recycle?
+    // Do we have a buffer we can recycle? Prefer one which doesn't have to
+    // grow.
+    size_t pooled_bytes = 0;
     for (const auto& buffer : allocated_buffers_) {
-      if (buffer->HasOneRef()) {
+      if (!buffer->HasOneRef())
+        continue;
+      pooled_bytes += buffer->GetCapacity();
+      if (!available_buffer ||
+          (available_buffer->GetCapacity() < min_size &&
+           buffer->GetCapacity() >= min_size)) {
         available_buffer = buffer;
-        break;
       }
     }
     // Otherwise create one.
@@ -78,6 +114,20 @@ Vp9FrameBufferPool::GetFrameBuffer(size_t min_size) {
         // See https://bugs.chromium.org/p/webrtc/issues/detail?id=6484.
         // RTC_NOTREACHED();
       }
+    } else {
+      pooled_bytes -= available_buffer->GetCapacity();
+    }
+    // Free the other available buffers until they fit in |max_pooled_bytes_|.
+    // They are deleted outside of the lock.
+    for (auto it = allocated_buffers_.begin();
+         it != allocated_buffers_.end() && pooled_bytes > max_pooled_bytes_;) {
+      if ((*it)->HasOneRef() && *it != available_buffer) {
+        pooled_bytes -= (*it)->GetCapacity();
+        freed_buffers.push_back(std::move(*it));
+        it = allocated_buffers_.erase(it);
+      } else {
+        ++it;
+      }
     }
   }
 
@@ -95,6 +145,16 @@ int Vp9FrameBufferPool::GetNumBuffersInUse() const {
   return num_buffers_in_use;
 }
 
+size_t Vp9FrameBufferPool::GetPooledBytes() const {
+  size_t pooled_bytes = 0;
+  rtc::CritScope cs(&buffers_lock_);
+  for (const auto& buffer : allocated_buffers_) {
+    if (buffer->HasOneRef())
+      pooled_bytes += buffer->GetCapacity();
+  }
+  return pooled_bytes;
+}
+
 void Vp9FrameBufferPool::ClearPool() {
   rtc::CritScope cs(&buffers_lock_);
   allocated_buffers_.clear();
@@ -57,6 +57,7 @@ class Vp9FrameBufferPool {
    public:
     uint8_t* GetData();
     size_t GetDataSize() const;
+    size_t GetCapacity() const;
     void SetSize(size_t size);
 
     virtual bool HasOneRef() const = 0;
@@ -66,16 +67,30 @@ class Vp9FrameBufferPool {
     rtc::Buffer data_;
   };
 
+  Vp9FrameBufferPool();
+  // A pool for many decoders, e.g. the one returned by GetSharedPool(), which
+  // warns when more than |max_num_buffers| are allocated and frees available
+  // buffers beyond |max_pooled_bytes|.
+  Vp9FrameBufferPool(size_t max_num_buffers, size_t max_pooled_bytes);
+
+  // Returns the pool shared by all decoders of the process, or null if the
+  // WebRTC-SharedDecoderBufferPool field trial is disabled.
+  static Vp9FrameBufferPool* GetSharedPool();
+
   // Configures libvpx to, in the specified context, use this memory pool for
   // buffers used to decompress frames. This is only supported for VP9.
   bool InitializeVpxUsePool(vpx_codec_ctx* vpx_codec_context);
 
   // Gets a frame buffer of at least |min_size|, recycling an available one or
-  // creating a new one. When no longer referenced from the outside the buffer
+  // creating a new one. Available buffers which are large enough are preferred,
+  // so that decoders of different resolutions can share the pool without
+  // reallocating. When no longer referenced from the outside the buffer
   // becomes recyclable.
   rtc::scoped_refptr<Vp9FrameBuffer> GetFrameBuffer(size_t min_size);
   // Gets the number of buffers currently in use (not ready to be recycled).
   int GetNumBuffersInUse() const;
+  // Gets the memory held by the buffers ready to be recycled.
+  size_t GetPooledBytes() const;
   // Releases allocated buffers, deleting available buffers. Buffers in use are
   // not deleted until they are no longer referenced.
   void ClearPool();
@@ -107,16 +122,19 @@ class Vp9FrameBufferPool {
   // All buffers, in use or ready to be recycled.
   std::vector<rtc::scoped_refptr<Vp9FrameBuffer>> allocated_buffers_
       GUARDED_BY(buffers_lock_);
-  // If more buffers than this are allocated we print warnings and crash if in
-  // debug mode. VP9 is defined to have 8 reference buffers, of which 3 can be
-  // referenced by any frame, see
+  // If more buffers than this are allocated we print warnings. VP9 is defined
+  // to have 8 reference buffers, of which 3 can be referenced by any frame, see
   // https://tools.ietf.org/html/draft-grange-vp9-bitstream-00#section-2.2.2.
   // Assuming VP9 holds on to at most 8 buffers, any more buffers than that
   // would have to be by application code. Decoded frames should not be
   // referenced for longer than necessary. If we allow ~60 additional buffers
   // then the application has ~1 second to e.g. render each frame of a 60 fps
   // video.
-  static const size_t max_num_buffers_ = 68;
+  static const size_t kDefaultMaxNumBuffers = 68;
+
+  const size_t max_num_buffers_;
+  // Buffers ready to be recycled are freed when they take more than this.
+  const size_t max_pooled_bytes_;
 };
 
 }  // namespace webrtc
@@ -11,9 +11,12 @@
 
 #include "webrtc/modules/video_coding/codecs/vp9/vp9_impl.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "vpx/vpx_encoder.h"
@@ -30,9 +33,31 @@
 #include "webrtc/rtc_base/random.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/metrics.h"
 
 namespace webrtc {
 
+namespace {
+
+// Enables frame parallel decoding, which decodes more frames per second on
+// many cores, at the cost of delaying each frame by up to one frame per
+// decoder thread.
+const char kVp9FrameParallelDecodingFieldTrial[] =
+    "WebRTC-VP9FrameParallelDecoding";
+
+// Encodes HD streams in frame parallel decoding mode, so that receivers can
+// decode their frames in parallel, at the cost of some compression as the
+// probabilities of the entropy coder no longer adapt from frame to frame.
+const char kVp9FrameParallelEncodingFieldTrial[] =
+    "WebRTC-VP9FrameParallelEncoding";
+
+// libvpx caps the number of tile columns so that they are at least this wide.
+const int kMinTileColumnWidth = 256;
+const int kMaxTileColumnsLog2 = 6;
+
+}  // namespace
+
 // Only positive speeds, range for real-time coding currently is: 5 - 8.
 // Lower means slower/better quality, higher means fastest/lower quality.
 int GetCpuSpeed(int width, int height) {
@@ -68,6 +93,7 @@ VP9EncoderImpl::VP9EncoderImpl()
       inited_(false),
       timestamp_(0),
       cpu_speed_(3),
+      frame_parallel_(false),
       rc_max_intra_target_(0),
       encoder_(nullptr),
       config_(nullptr),
@@ -98,6 +124,8 @@ int VP9EncoderImpl::Release() {
     encoded_image_._buffer = nullptr;
   }
   if (encoder_ != nullptr) {
+    if (inited_)
+      ReportEncodeTime();
     if (vpx_codec_destroy(encoder_)) {
       return WEBRTC_VIDEO_CODEC_MEMORY;
     }
@@ -112,6 +140,7 @@ int VP9EncoderImpl::Release() {
     vpx_img_free(raw_);
     raw_ = nullptr;
   }
+  active_map_.reset();
   inited_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -330,10 +359,21 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
       NumberOfThreads(config_->g_w, config_->g_h, number_of_cores);
 
   cpu_speed_ = GetCpuSpeed(config_->g_w, config_->g_h);
+  frame_parallel_ =
+      config_->g_w * config_->g_h >= 1280 * 720 &&
+      field_trial::IsEnabled(kVp9FrameParallelEncodingFieldTrial);
+  encode_time_stats_ = EncodeTimeStats();
 
   // TODO(asapersson): Check configuration of temporal switch up and increase
   // pattern length.
   is_flexible_mode_ = inst->VP9().flexibleMode;
+  if (num_spatial_layers_ == 1 && num_temporal_layers_ == 1 &&
+      !is_flexible_mode_) {
+    active_map_.reset(new ActiveMap(codec_.width, codec_.height, codec_.width,
+                                    codec_.height));
+  } else {
+    active_map_.reset();
+  }
   if (is_flexible_mode_) {
     config_->temporal_layering_mode = VP9E_TEMPORAL_LAYERING_MODE_BYPASS;
     config_->ts_number_layers = num_temporal_layers_;
@@ -374,12 +414,17 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   return InitAndSetControlSettings(inst);
 }
 
+// static
 int VP9EncoderImpl::NumberOfThreads(int width,
                                     int height,
                                     int number_of_cores) {
   // Keep the number of encoder threads equal to the possible number of column
-  // tiles, which is (1, 2, 4, 8). See comments below for VP9E_SET_TILE_COLUMNS.
-  if (width * height >= 1280 * 720 && number_of_cores > 4) {
+  // tiles, which is (1, 2, 4, 8). With row based multithreading, the threads
+  // also share the rows of a tile, so 1080p, which has at most 4 tile
+  // columns, still gains from 8 threads.
+  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
+    return 8;
+  } else if (width * height >= 1280 * 720 && number_of_cores > 4) {
     return 4;
   } else if (width * height >= 640 * 360 && number_of_cores > 2) {
     return 2;
@@ -389,6 +434,17 @@ int VP9EncoderImpl::NumberOfThreads(int width,
   }
 }
 
+// static
+int VP9EncoderImpl::TileColumnsLog2(int width, int number_of_threads) {
+  // One tile column per thread, as far as the width allows.
+  int log2 = 0;
+  while (log2 < kMaxTileColumnsLog2 && (2 << log2) <= number_of_threads &&
+         (kMinTileColumnWidth << (log2 + 1)) <= width) {
+    ++log2;
+  }
+  return log2;
+}
+
 int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // Set QP-min/max per spatial and temporal layer.
   int tot_num_layers = num_spatial_layers_ * num_temporal_layers_;
@@ -427,7 +483,8 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   vpx_codec_control(encoder_, VP9E_SET_AQ_MODE,
                     inst->VP9().adaptiveQpMode ? 3 : 0);
 
-  vpx_codec_control(encoder_, VP9E_SET_FRAME_PARALLEL_DECODING, 0);
+  vpx_codec_control(encoder_, VP9E_SET_FRAME_PARALLEL_DECODING,
+                    frame_parallel_ ? 1 : 0);
   vpx_codec_control(
       encoder_, VP9E_SET_SVC,
       (num_temporal_layers_ > 1 || num_spatial_layers_ > 1) ? 1 : 0);
@@ -446,10 +503,13 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // log2 unit: e.g., 0 = 1 tile column, 1 = 2 tile columns, 2 = 4 tile columns.
   // The number tile columns will be capped by the encoder based on image size
   // (minimum width of tile column is 256 pixels, maximum is 4096).
-  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, (config_->g_threads >> 1));
+  const int tile_columns_log2 =
+      TileColumnsLog2(config_->g_w, config_->g_threads);
+  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, tile_columns_log2);
 
-  // Turn on row-based multithreading.
-  vpx_codec_control(encoder_, VP9E_SET_ROW_MT, 1);
+  // Turn on row-based multithreading, which only pays off with more than one
+  // thread.
+  vpx_codec_control(encoder_, VP9E_SET_ROW_MT, config_->g_threads > 1 ? 1 : 0);
 
 #if !defined(WEBRTC_ARCH_ARM) && !defined(WEBRTC_ARCH_ARM64) && \
   !defined(ANDROID)
@@ -466,9 +526,34 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // Enable encoder skip of static/low content blocks.
   vpx_codec_control(encoder_, VP8E_SET_STATIC_THRESHOLD, 1);
   inited_ = true;
+  LOG(LS_INFO) << "libvpx VP9 encoder initialized for " << config_->g_w << "x"
+               << config_->g_h << " with " << config_->g_threads
+               << " threads, " << (1 << tile_columns_log2)
+               << " tile columns and frame parallel mode "
+               << (frame_parallel_ ? "on." : "off.");
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void VP9EncoderImpl::ReportEncodeTime() {
+  if (encode_time_stats_.num_frames == 0)
+    return;
+  const int average_us = static_cast<int>(encode_time_stats_.total_us /
+                                          encode_time_stats_.num_frames);
+  RTC_HISTOGRAM_COUNTS_100000("WebRTC.Video.VP9EncoderImpl.EncodeTimeUs",
+                              average_us);
+  LOG(LS_INFO) << "libvpx VP9 encoded " << encode_time_stats_.num_frames
+               << " frames of " << static_cast<int>(num_spatial_layers_)
+               << " spatial layers with " << config_->g_threads
+               << " threads, average encode time " << average_us
+               << " us, max " << encode_time_stats_.max_us << " us.";
+}
+
+void VP9EncoderImpl::EncodeTimeStats::AddSample(int64_t encode_time_us) {
+  ++num_frames;
+  total_us += encode_time_us;
+  max_us = std::max(max_us, encode_time_us);
+}
+
 uint32_t VP9EncoderImpl::MaxIntraTarget(uint32_t optimal_buffer_size) {
   // Set max to the optimal buffer level (normalized by target BR),
   // and scaled by a scale_par.
@@ -547,13 +632,36 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
     vpx_codec_control(encoder_, VP9E_SET_SVC_REF_FRAME_CONFIG, &enc_layer_conf);
   }
 
+  if (active_map_) {
+    // Macroblocks which are unchanged since the last encoded frame can be
+    // skipped.
+    active_map_->AddFrame(input_image);
+    vpx_active_map_t active_map;
+    active_map.active_map = nullptr;
+    active_map.rows = active_map_->mb_rows();
+    active_map.cols = active_map_->mb_cols();
+    if (!send_keyframe) {
+      active_map.active_map =
+          const_cast<unsigned char*>(active_map_->GetMap());
+    }
+    vpx_codec_control(encoder_, VP9E_SET_ACTIVEMAP, &active_map);
+  }
+
   RTC_CHECK_GT(codec_.maxFramerate, 0);
   uint32_t duration = 90000 / codec_.maxFramerate;
-  if (vpx_codec_encode(encoder_, raw_, timestamp_, duration, flags,
-                       VPX_DL_REALTIME)) {
+  // Stays empty if libvpx drops the frame.
+  encoded_image_._length = 0;
+  const int64_t encode_start_us = rtc::TimeMicros();
+  const vpx_codec_err_t err = vpx_codec_encode(encoder_, raw_, timestamp_,
+                                               duration, flags,
+                                               VPX_DL_REALTIME);
+  encode_time_stats_.AddSample(rtc::TimeMicros() - encode_start_us);
+  if (err) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   timestamp_ += duration;
+  if (active_map_ && encoded_image_._length > 0)
+    active_map_->OnReferenceUpdated();
 
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -846,17 +954,24 @@ VP9Decoder* VP9Decoder::Create() {
 }
 
 VP9DecoderImpl::VP9DecoderImpl()
-    : decode_complete_callback_(nullptr),
+    : frame_buffer_pool_(Vp9FrameBufferPool::GetSharedPool()
+                             ? Vp9FrameBufferPool::GetSharedPool()
+                             : &own_frame_buffer_pool_),
+      decode_complete_callback_(nullptr),
       inited_(false),
       decoder_(nullptr),
-      key_frame_required_(true) {
+      key_frame_required_(true),
+      number_of_threads_(1),
+      frame_parallel_(false) {
   memset(&codec_, 0, sizeof(codec_));
 }
 
 VP9DecoderImpl::~VP9DecoderImpl() {
   inited_ = true;  // in order to do the actual release
+  // Frames still being decoded are dropped rather than delivered.
+  decode_complete_callback_ = nullptr;
   Release();
-  int num_buffers_in_use = frame_buffer_pool_.GetNumBuffersInUse();
+  int num_buffers_in_use = own_frame_buffer_pool_.GetNumBuffersInUse();
   if (num_buffers_in_use > 0) {
     // The frame buffers are reference counted and frames are exposed after
     // decoding. There may be valid usage cases where previous frames are still
@@ -877,11 +992,21 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (decoder_ == nullptr) {
     decoder_ = new vpx_codec_ctx_t;
   }
+  number_of_threads_ = NumberOfThreads(number_of_cores);
+  frame_parallel_ = false;
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  cfg.threads = number_of_threads_;
   cfg.h = cfg.w = 0;  // set after decode
   vpx_codec_flags_t flags = 0;
+#if defined(VPX_CODEC_USE_FRAME_THREADING)
+  if (number_of_threads_ > 1 &&
+      field_trial::IsEnabled(kVp9FrameParallelDecodingFieldTrial) &&
+      (vpx_codec_get_caps(vpx_codec_vp9_dx()) &
+       VPX_CODEC_CAP_FRAME_THREADING)) {
+    flags |= VPX_CODEC_USE_FRAME_THREADING;
+    frame_parallel_ = true;
+  }
+#endif
   if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
   }
@@ -890,7 +1015,7 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
     codec_ = *inst;
   }
 
-  if (!frame_buffer_pool_.InitializeVpxUsePool(decoder_)) {
+  if (!frame_buffer_pool_->InitializeVpxUsePool(decoder_)) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
   }
 
@@ -929,12 +1054,22 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
     buffer = nullptr;  // Triggers full frame concealment.
   }
   // During decode libvpx may get and release buffers from |frame_buffer_pool_|.
-  // In practice libvpx keeps a few (~3-4) buffers alive at a time.
-  if (vpx_codec_decode(decoder_, buffer,
-                       static_cast<unsigned int>(input_image._length), 0,
-                       VPX_DL_REALTIME)) {
+  // In practice libvpx keeps a few (~3-4) buffers alive at a time, and a few
+  // more per thread in frame parallel mode. The RTP timestamp is passed along
+  // to identify the frames returned later in frame parallel mode.
+  if (vpx_codec_decode(
+          decoder_, buffer, static_cast<unsigned int>(input_image._length),
+          reinterpret_cast<void*>(
+              static_cast<uintptr_t>(input_image._timeStamp)),
+          VPX_DL_REALTIME)) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
+  if (frame_parallel_) {
+    pending_frames_.push_back(
+        std::make_pair(input_image._timeStamp, input_image.ntp_time_ms_));
+    ReturnFrameParallelFrames();
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
   // |img->fb_priv| contains the image data, a reference counted Vp9FrameBuffer.
   // It may be released by libvpx during future vpx_codec_decode or
   // vpx_codec_destroy calls.
@@ -943,18 +1078,39 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
   vpx_codec_err_t vpx_ret =
       vpx_codec_control(decoder_, VPXD_GET_LAST_QUANTIZER, &qp);
   RTC_DCHECK_EQ(vpx_ret, VPX_CODEC_OK);
-  int ret =
-      ReturnFrame(img, input_image._timeStamp, input_image.ntp_time_ms_, qp);
+  int ret = ReturnFrame(img, input_image._timeStamp, input_image.ntp_time_ms_,
+                        rtc::Optional<uint8_t>(qp));
   if (ret != 0) {
     return ret;
   }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void VP9DecoderImpl::ReturnFrameParallelFrames() {
+  vpx_codec_iter_t iter = nullptr;
+  while (vpx_image_t* img = vpx_codec_get_frame(decoder_, &iter)) {
+    const uint32_t timestamp =
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(img->user_priv));
+    // Frames which are not shown have no output, and are skipped.
+    while (!pending_frames_.empty() &&
+           pending_frames_.front().first != timestamp) {
+      pending_frames_.pop_front();
+    }
+    int64_t ntp_time_ms = 0;
+    if (!pending_frames_.empty()) {
+      ntp_time_ms = pending_frames_.front().second;
+      pending_frames_.pop_front();
+    }
+    // The last quantizer is that of the latest frame to start decoding, which
+    // need not be this one.
+    ReturnFrame(img, timestamp, ntp_time_ms, rtc::Optional<uint8_t>());
+  }
+}
+
 int VP9DecoderImpl::ReturnFrame(const vpx_image_t* img,
                                 uint32_t timestamp,
                                 int64_t ntp_time_ms,
-                                int qp) {
+                                rtc::Optional<uint8_t> qp) {
   if (img == nullptr) {
     // Decoder OK and nullptr image => No show frame.
     return WEBRTC_VIDEO_CODEC_NO_OUTPUT;
@@ -983,7 +1139,7 @@ int VP9DecoderImpl::ReturnFrame(const vpx_image_t* img,
   decoded_image.set_ntp_time_ms(ntp_time_ms);
 
   decode_complete_callback_->Decoded(decoded_image, rtc::Optional<int32_t>(),
-                                     rtc::Optional<uint8_t>(qp));
+                                     qp);
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -995,6 +1151,14 @@ int VP9DecoderImpl::RegisterDecodeCompleteCallback(
 
 int VP9DecoderImpl::Release() {
   if (decoder_ != nullptr) {
+    if (frame_parallel_ && inited_ && decode_complete_callback_) {
+      // Flush the frames still being decoded.
+      if (vpx_codec_decode(decoder_, nullptr, 0, nullptr, VPX_DL_REALTIME) ==
+          VPX_CODEC_OK) {
+        ReturnFrameParallelFrames();
+      }
+    }
+    pending_frames_.clear();
     // When a codec is destroyed libvpx will release any buffers of
     // |frame_buffer_pool_| it is currently using.
     if (vpx_codec_destroy(decoder_)) {
@@ -1005,8 +1169,8 @@ int VP9DecoderImpl::Release() {
   }
   // Releases buffers from the pool. Any buffers not in use are deleted. Buffers
   // still referenced externally are deleted once fully released, not returning
-  // to the pool.
-  frame_buffer_pool_.ClearPool();
+  // to the pool. A shared pool keeps its buffers for the other decoders.
+  own_frame_buffer_pool_.ClearPool();
   inited_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -1015,4 +1179,22 @@ const char* VP9DecoderImpl::ImplementationName() const {
   return "libvpx";
 }
 
+// static
+int VP9DecoderImpl::NumberOfThreads(int number_of_cores) {
+  // The resolution isn't known until the first frame is decoded; the receive
+  // side VideoCodec only has a default size. libvpx decodes the tile columns
+  // of a frame in parallel, and starts no more threads than a stream has
+  // tile columns, so small streams stay on one thread regardless. In frame
+  // parallel mode, every thread decodes a frame of its own.
+  if (number_of_cores > 8) {
+    return 8;
+  } else if (number_of_cores > 4) {
+    return 4;
+  } else if (number_of_cores > 2) {
+    return 2;
+  } else {
+    return 1;
+  }
+}
+
 }  // namespace webrtc
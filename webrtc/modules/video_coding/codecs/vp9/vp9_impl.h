@@ -12,11 +12,15 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP9_VP9_IMPL_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP9_VP9_IMPL_H_
 
+#include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
 #include "webrtc/modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
+#include "webrtc/modules/video_coding/utility/active_map.h"
+#include "webrtc/rtc_base/optional.h"
 
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_decoder.h"
@@ -65,9 +69,28 @@ class VP9EncoderImpl : public VP9Encoder {
     bool is_keyframe = false;
   };
 
+  // Time spent in libvpx encoding frames since the last InitEncode(), to
+  // compare threading and tile configurations.
+  struct EncodeTimeStats {
+    void AddSample(int64_t encode_time_us);
+
+    int num_frames = 0;
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+  };
+  const EncodeTimeStats& encode_time_stats() const {
+    return encode_time_stats_;
+  }
+
+  // Returns the number of encoder threads to use for a |width| x |height|
+  // stream on |number_of_cores| cores.
+  static int NumberOfThreads(int width, int height, int number_of_cores);
+  // Returns the number of tile columns, in log2 units, to encode a |width|
+  // pixels wide stream with on |number_of_threads| threads.
+  static int TileColumnsLog2(int width, int number_of_threads);
+
  private:
-  // Determine number of encoder threads to use.
-  int NumberOfThreads(int width, int height, int number_of_cores);
+  void ReportEncodeTime();
 
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings(const VideoCodec* inst);
@@ -108,6 +131,7 @@ class VP9EncoderImpl : public VP9Encoder {
   bool inited_;
   int64_t timestamp_;
   int cpu_speed_;
+  bool frame_parallel_;
   uint32_t rc_max_intra_target_;
   vpx_codec_ctx_t* encoder_;
   vpx_codec_enc_cfg_t* config_;
@@ -128,6 +152,12 @@ class VP9EncoderImpl : public VP9Encoder {
   uint8_t p_diff_[kMaxVp9NumberOfSpatialLayers][kMaxVp9RefPics];
   std::unique_ptr<ScreenshareLayersVP9> spatial_layer_;
 
+  // The macroblocks which changed since the last encoded frame. Only set when
+  // every frame predicts from the previous one, i.e. without layers.
+  std::unique_ptr<ActiveMap> active_map_;
+
+  EncodeTimeStats encode_time_stats_;
+
   // RTP state.
   uint16_t picture_id_;
   uint8_t tl0_pic_idx_;  // Only used in non-flexible mode.
@@ -153,19 +183,37 @@ class VP9DecoderImpl : public VP9Decoder {
 
   const char* ImplementationName() const override;
 
+  // Returns the number of decoder threads to use on |number_of_cores| cores.
+  static int NumberOfThreads(int number_of_cores);
+
+  // Exposed for testing.
+  int NumberOfThreadsForTesting() const { return number_of_threads_; }
+  bool FrameParallelForTesting() const { return frame_parallel_; }
+
  private:
   int ReturnFrame(const vpx_image_t* img,
                   uint32_t timestamp,
                   int64_t ntp_time_ms,
-                  int qp);
-
-  // Memory pool used to share buffers between libvpx and webrtc.
-  Vp9FrameBufferPool frame_buffer_pool_;
+                  rtc::Optional<uint8_t> qp);
+  // Delivers the frames libvpx has finished decoding in frame parallel mode.
+  void ReturnFrameParallelFrames();
+
+  // Memory pool used to share buffers between libvpx and webrtc. Points to
+  // |own_frame_buffer_pool_| unless the decoders share a pool.
+  Vp9FrameBufferPool own_frame_buffer_pool_;
+  Vp9FrameBufferPool* const frame_buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
   bool inited_;
   vpx_codec_ctx_t* decoder_;
   VideoCodec codec_;
   bool key_frame_required_;
+  int number_of_threads_;
+  // If true, libvpx decodes several frames at a time, one per thread, and
+  // returns them a few Decode() calls later.
+  bool frame_parallel_;
+  // RTP and NTP timestamps of the frames being decoded in frame parallel mode,
+  // oldest first.
+  std::deque<std::pair<uint32_t, int64_t>> pending_frames_;
 };
 }  // namespace webrtc
 
@@ -34,8 +34,17 @@ constexpr int kMaxFramesBuffered = 600;
 constexpr int kMaxFramesHistory = 50;
 
 constexpr int64_t kLogNonDecodedIntervalMs = 5000;
+
+constexpr int kRtpTicksPerSecond = 90000;
+
+// Lets frames come this much sooner than the max decode framerate allows, for
+// capture time jitter.
+constexpr float kDecodeIntervalTolerance = 0.9f;
 }  // namespace
 
+constexpr int FrameBuffer::kNoFrame;
+constexpr int FrameBuffer::kFrameIndexSize;
+
 FrameBuffer::FrameBuffer(Clock* clock,
                          VCMJitterEstimator* jitter_estimator,
                          VCMTiming* timing,
@@ -46,14 +55,22 @@ FrameBuffer::FrameBuffer(Clock* clock,
       timing_(timing),
       inter_frame_delay_(clock_->TimeInMilliseconds()),
       last_decoded_frame_timestamp_(0),
-      last_decoded_frame_it_(frames_.end()),
-      last_continuous_frame_it_(frames_.end()),
+      last_decoded_frame_(kNoFrame),
+      last_continuous_frame_(kNoFrame),
+      next_frame_(kNoFrame),
       num_frames_history_(0),
       num_frames_buffered_(0),
       stopped_(false),
       protection_mode_(kProtectionNack),
+      max_decode_framerate_(0),
+      max_decode_pixels_(0),
       stats_callback_(stats_callback),
-      last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs) {}
+      last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs) {
+  rtc::CritScope lock(&crit_);
+  frame_index_.resize(kFrameIndexSize, kNoFrame);
+  std::fill(spatial_layer_pixels_,
+            spatial_layer_pixels_ + kMaxVp9NumberOfSpatialLayers, 0);
+}
 
 FrameBuffer::~FrameBuffer() {}
 
@@ -75,127 +92,36 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
       if (stopped_)
         return kStopped;
 
-      wait_ms = max_wait_time_ms;
-
-      // Need to hold |crit_| in order to use |frames_|, therefore we
-      // set it here in the loop instead of outside the loop in order to not
-      // acquire the lock unnecesserily.
-      next_frame_it_ = frames_.end();
-
-      // |frame_it| points to the first frame after the
-      // |last_decoded_frame_it_|.
-      auto frame_it = frames_.end();
-      if (last_decoded_frame_it_ == frames_.end()) {
-        frame_it = frames_.begin();
-      } else {
-        frame_it = last_decoded_frame_it_;
-        ++frame_it;
-      }
-
-      // |continuous_end_it| points to the first frame after the
-      // |last_continuous_frame_it_|.
-      auto continuous_end_it = last_continuous_frame_it_;
-      if (continuous_end_it != frames_.end())
-        ++continuous_end_it;
-
-      for (; frame_it != continuous_end_it && frame_it != frames_.end();
-           ++frame_it) {
-        if (!frame_it->second.continuous ||
-            frame_it->second.num_missing_decodable > 0) {
-          continue;
-        }
-
-        FrameObject* frame = frame_it->second.frame.get();
-
-        if (keyframe_required && !frame->is_keyframe())
-          continue;
-
-        next_frame_it_ = frame_it;
-        if (frame->RenderTime() == -1)
-          frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-        wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
-
-        // This will cause the frame buffer to prefer high framerate rather
-        // than high resolution in the case of the decoder not decoding fast
-        // enough and the stream has multiple spatial and temporal layers.
-        if (wait_ms == 0)
-          continue;
-
-        break;
-      }
+      // Need to hold |crit_| in order to use the frame infos, therefore we
+      // find the next frame here in the loop instead of outside the loop in
+      // order to not acquire the lock unnecesserily.
+      wait_ms = FindNextFrame(now_ms, keyframe_required);
+      if (wait_ms < 0)
+        wait_ms = max_wait_time_ms;
     }  // rtc::Critscope lock(&crit_);
 
     wait_ms = std::min<int64_t>(wait_ms, latest_return_time_ms - now_ms);
     wait_ms = std::max<int64_t>(wait_ms, 0);
   } while (new_continuous_frame_event_.Wait(wait_ms));
 
+  bool frame_found = false;
+  VCMVideoProtection protection_mode = kProtectionNack;
   {
     rtc::CritScope lock(&crit_);
     now_ms = clock_->TimeInMilliseconds();
-    if (next_frame_it_ != frames_.end()) {
-      std::unique_ptr<FrameObject> frame =
-          std::move(next_frame_it_->second.frame);
-
-      if (!frame->delayed_by_retransmission()) {
-        int64_t frame_delay;
-
-        if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
-                                              frame->ReceivedTime())) {
-          jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
-        }
-
-        float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
-        timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
-        timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
-      }
-
-      // Gracefully handle bad RTP timestamps and render time issues.
-      if (HasBadRenderTiming(*frame, now_ms)) {
-        jitter_estimator_->Reset();
-        timing_->Reset();
-        frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-      }
-
-      UpdateJitterDelay();
-      UpdateTimingFrameInfo();
-      PropagateDecodability(next_frame_it_->second);
-
-      // Sanity check for RTP timestamp monotonicity.
-      if (last_decoded_frame_it_ != frames_.end()) {
-        const FrameKey& last_decoded_frame_key = last_decoded_frame_it_->first;
-        const FrameKey& frame_key = next_frame_it_->first;
-
-        const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
-            last_decoded_frame_timestamp_ == frame->timestamp &&
-            last_decoded_frame_key.picture_id == frame_key.picture_id &&
-            last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
-
-        if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
-            !frame_is_higher_spatial_layer_of_last_decoded_frame) {
-          // TODO(brandtr): Consider clearing the entire buffer when we hit
-          // these conditions.
-          LOG(LS_WARNING) << "Frame with (timestamp:picture_id:spatial_id) ("
-                          << frame->timestamp << ":" << frame->picture_id << ":"
-                          << static_cast<int>(frame->spatial_layer) << ")"
-                          << " sent to decoder after frame with"
-                          << " (timestamp:picture_id:spatial_id) ("
-                          << last_decoded_frame_timestamp_ << ":"
-                          << last_decoded_frame_key.picture_id << ":"
-                          << static_cast<int>(
-                                 last_decoded_frame_key.spatial_layer)
-                          << ").";
-        }
-      }
-
-      AdvanceLastDecodedFrame(next_frame_it_);
-      last_decoded_frame_timestamp_ = frame->timestamp;
-      *frame_out = std::move(frame);
-      return kFrameFound;
+    if (next_frame_ != kNoFrame) {
+      *frame_out = TakeNextFrame(now_ms);
+      protection_mode = protection_mode_;
+      frame_found = true;
     }
   }
+  if (frame_found) {
+    UpdateTimingForNextFrame(frame_out->get(), now_ms, protection_mode);
+    return kFrameFound;
+  }
 
   if (latest_return_time_ms - now_ms > 0) {
-    // If |next_frame_it_ == frames_.end()| and there is still time left, it
+    // If |next_frame_ == kNoFrame| and there is still time left, it
     // means that the frame buffer was cleared as the thread in this function
     // was waiting to acquire |crit_| in order to return. Wait for the
     // remaining time and then return.
@@ -205,6 +131,179 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
   return kTimeout;
 }
 
+FrameBuffer::ReturnReason FrameBuffer::NextFrameIfDue(
+    std::unique_ptr<FrameObject>* frame_out,
+    int64_t* wait_ms) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::NextFrameIfDue");
+  int64_t now_ms;
+  VCMVideoProtection protection_mode = kProtectionNack;
+  {
+    rtc::CritScope lock(&crit_);
+    if (stopped_)
+      return kStopped;
+    now_ms = clock_->TimeInMilliseconds();
+    *wait_ms = FindNextFrame(now_ms, false);
+    if (*wait_ms != 0)
+      return kTimeout;
+    *frame_out = TakeNextFrame(now_ms);
+    protection_mode = protection_mode_;
+  }
+  UpdateTimingForNextFrame(frame_out->get(), now_ms, protection_mode);
+  return kFrameFound;
+}
+
+int64_t FrameBuffer::FindNextFrame(int64_t now_ms, bool keyframe_required) {
+  next_frame_ = kNoFrame;
+  int64_t wait_ms = -1;
+
+  // Look at the frames after |last_decoded_frame_|, which follow the
+  // history in |frame_order_|, up to |last_continuous_frame_|.
+  for (size_t i = num_frames_history_;
+       last_continuous_frame_ != kNoFrame && i < frame_order_.size(); ++i) {
+    const int slot = frame_order_[i];
+    const FrameInfo& info = frame_infos_[slot];
+    if (frame_infos_[last_continuous_frame_].key < info.key)
+      break;
+
+    if (!info.continuous || info.num_missing_decodable > 0)
+      continue;
+
+    FrameObject* frame = info.frame.get();
+
+    if (keyframe_required && !frame->is_keyframe())
+      continue;
+
+    // A skipped frame is left undecoded, and so are the frames depending on
+    // it.
+    if (SkipFrame(*frame))
+      continue;
+
+    next_frame_ = slot;
+    if (frame->RenderTime() == -1)
+      frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+
+    wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
+
+    // This will cause the frame buffer to prefer high framerate rather
+    // than high resolution in the case of the decoder not decoding fast
+    // enough and the stream has multiple spatial and temporal layers.
+    if (wait_ms == 0)
+      continue;
+
+    break;
+  }
+  return wait_ms;
+}
+
+std::unique_ptr<FrameObject> FrameBuffer::TakeNextFrame(int64_t now_ms) {
+  RTC_DCHECK_NE(next_frame_, kNoFrame);
+  std::unique_ptr<FrameObject> frame =
+      std::move(frame_infos_[next_frame_].frame);
+
+  PropagateDecodability(frame_infos_[next_frame_]);
+
+  // Sanity check for RTP timestamp monotonicity.
+  if (last_decoded_frame_ != kNoFrame) {
+    const FrameKey& last_decoded_frame_key =
+        frame_infos_[last_decoded_frame_].key;
+    const FrameKey& frame_key = frame_infos_[next_frame_].key;
+
+    const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
+        last_decoded_frame_timestamp_ == frame->timestamp &&
+        last_decoded_frame_key.picture_id == frame_key.picture_id &&
+        last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
+
+    if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
+        !frame_is_higher_spatial_layer_of_last_decoded_frame) {
+      // TODO(brandtr): Consider clearing the entire buffer when we hit
+      // these conditions.
+      LOG(LS_WARNING) << "Frame with (timestamp:picture_id:spatial_id) ("
+                      << frame->timestamp << ":" << frame->picture_id << ":"
+                      << static_cast<int>(frame->spatial_layer) << ")"
+                      << " sent to decoder after frame with"
+                      << " (timestamp:picture_id:spatial_id) ("
+                      << last_decoded_frame_timestamp_ << ":"
+                      << last_decoded_frame_key.picture_id << ":"
+                      << static_cast<int>(last_decoded_frame_key.spatial_layer)
+                      << ").";
+    }
+  }
+
+  AdvanceLastDecodedFrame(next_frame_);
+  last_decoded_frame_timestamp_ = frame->timestamp;
+  return frame;
+}
+
+void FrameBuffer::UpdateTimingForNextFrame(FrameObject* frame,
+                                           int64_t now_ms,
+                                           VCMVideoProtection protection_mode) {
+  RTC_DCHECK_RUNS_SERIALIZED(&decode_race_);
+  if (!frame->delayed_by_retransmission()) {
+    int64_t frame_delay;
+
+    if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
+                                          frame->ReceivedTime())) {
+      jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
+    }
+
+    float rtt_mult = protection_mode == kProtectionNackFEC ? 0.0 : 1.0;
+    timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
+    timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
+  }
+
+  // Gracefully handle bad RTP timestamps and render time issues.
+  if (HasBadRenderTiming(*frame, now_ms)) {
+    jitter_estimator_->Reset();
+    timing_->Reset();
+    frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+  }
+
+  UpdateJitterDelay();
+  UpdateTimingFrameInfo();
+}
+
+void FrameBuffer::UpdateSpatialLayerResolutions(const FrameObject& frame) {
+  const CodecSpecificInfo* codec_info = frame.CodecSpecific();
+  if (codec_info->codecType != kVideoCodecVP9)
+    return;
+  const CodecSpecificInfoVP9& vp9 = codec_info->codecSpecific.VP9;
+  if (!vp9.ss_data_available || !vp9.spatial_layer_resolution_present)
+    return;
+  for (size_t i = 0; i < kMaxVp9NumberOfSpatialLayers; ++i) {
+    spatial_layer_pixels_[i] =
+        i < vp9.num_spatial_layers ? vp9.width[i] * vp9.height[i] : 0;
+  }
+}
+
+bool FrameBuffer::SkipFrame(const FrameObject& frame) const {
+  const CodecSpecificInfo* codec_info = frame.CodecSpecific();
+  if (max_decode_pixels_ > 0 && frame.spatial_layer > 0 &&
+      frame.spatial_layer < kMaxVp9NumberOfSpatialLayers &&
+      spatial_layer_pixels_[frame.spatial_layer] > max_decode_pixels_) {
+    return true;
+  }
+
+  // Higher spatial layers of the last decoded picture are never skipped by
+  // the framerate limit, and neither is the first frame.
+  if (max_decode_framerate_ == 0 || last_decoded_frame_ == kNoFrame ||
+      frame.timestamp == last_decoded_frame_timestamp_) {
+    return false;
+  }
+  bool droppable = false;
+  if (codec_info->codecType == kVideoCodecVP8) {
+    droppable = codec_info->codecSpecific.VP8.nonReference ||
+                codec_info->codecSpecific.VP8.temporalIdx > 0;
+  } else if (codec_info->codecType == kVideoCodecVP9) {
+    droppable = codec_info->codecSpecific.VP9.temporal_idx > 0;
+  }
+  if (!droppable)
+    return false;
+  const uint32_t min_interval =
+      kDecodeIntervalTolerance * kRtpTicksPerSecond / max_decode_framerate_;
+  return static_cast<uint32_t>(frame.timestamp -
+                               last_decoded_frame_timestamp_) < min_interval;
+}
+
 bool FrameBuffer::HasBadRenderTiming(const FrameObject& frame, int64_t now_ms) {
   // Assume that render timing errors are due to changes in the video stream.
   int64_t render_time_ms = frame.RenderTimeMs();
@@ -234,6 +333,20 @@ void FrameBuffer::SetProtectionMode(VCMVideoProtection mode) {
   protection_mode_ = mode;
 }
 
+void FrameBuffer::SetMaxDecodeFramerate(int max_framerate) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::SetMaxDecodeFramerate");
+  RTC_DCHECK_GE(max_framerate, 0);
+  rtc::CritScope lock(&crit_);
+  max_decode_framerate_ = max_framerate;
+}
+
+void FrameBuffer::SetMaxDecodePixels(int max_pixels) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::SetMaxDecodePixels");
+  RTC_DCHECK_GE(max_pixels, 0);
+  rtc::CritScope lock(&crit_);
+  max_decode_pixels_ = max_pixels;
+}
+
 void FrameBuffer::Start() {
   TRACE_EVENT0("webrtc", "FrameBuffer::Start");
   rtc::CritScope lock(&crit_);
@@ -284,9 +397,9 @@ int FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
   rtc::CritScope lock(&crit_);
 
   int last_continuous_picture_id =
-      last_continuous_frame_it_ == frames_.end()
+      last_continuous_frame_ == kNoFrame
           ? -1
-          : last_continuous_frame_it_->first.picture_id;
+          : frame_infos_[last_continuous_frame_].key.picture_id;
 
   if (!ValidReferences(*frame)) {
     LOG(LS_WARNING) << "Frame with (picture_id:spatial_id) (" << key.picture_id
@@ -303,8 +416,8 @@ int FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
     return last_continuous_picture_id;
   }
 
-  if (last_decoded_frame_it_ != frames_.end() &&
-      key <= last_decoded_frame_it_->first) {
+  if (last_decoded_frame_ != kNoFrame &&
+      key <= frame_infos_[last_decoded_frame_].key) {
     if (AheadOf(frame->timestamp, last_decoded_frame_timestamp_) &&
         frame->is_keyframe()) {
       // If this frame has a newer timestamp but an earlier picture id then we
@@ -316,13 +429,13 @@ int FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
       ClearFramesAndHistory();
       last_continuous_picture_id = -1;
     } else {
+      const FrameKey& last_decoded_key = frame_infos_[last_decoded_frame_].key;
       LOG(LS_WARNING) << "Frame with (picture_id:spatial_id) ("
                       << key.picture_id << ":"
                       << static_cast<int>(key.spatial_layer)
                       << ") inserted after frame ("
-                      << last_decoded_frame_it_->first.picture_id << ":"
-                      << static_cast<int>(
-                             last_decoded_frame_it_->first.spatial_layer)
+                      << last_decoded_key.picture_id << ":"
+                      << static_cast<int>(last_decoded_key.spatial_layer)
                       << ") was handed off for decoding, dropping frame.";
       return last_continuous_picture_id;
     }
@@ -331,33 +444,36 @@ int FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
   // Test if inserting this frame would cause the order of the frames to become
   // ambiguous (covering more than half the interval of 2^16). This can happen
   // when the picture id make large jumps mid stream.
-  if (!frames_.empty() &&
-      key < frames_.begin()->first &&
-      frames_.rbegin()->first < key) {
+  if (!frame_order_.empty() &&
+      key < frame_infos_[frame_order_.front()].key &&
+      frame_infos_[frame_order_.back()].key < key) {
     LOG(LS_WARNING) << "A jump in picture id was detected, clearing buffer.";
     ClearFramesAndHistory();
     last_continuous_picture_id = -1;
   }
 
-  auto info = frames_.insert(std::make_pair(key, FrameInfo())).first;
+  const int slot = GetOrCreateFrameInfo(key);
+  FrameInfo& info = frame_infos_[slot];
 
-  if (info->second.frame) {
+  if (info.frame) {
     LOG(LS_WARNING) << "Frame with (picture_id:spatial_id) (" << key.picture_id
                     << ":" << static_cast<int>(key.spatial_layer)
                     << ") already inserted, dropping frame.";
     return last_continuous_picture_id;
   }
 
-  if (!UpdateFrameInfoWithIncomingFrame(*frame, info))
+  if (!UpdateFrameInfoWithIncomingFrame(*frame, slot))
     return last_continuous_picture_id;
   UpdatePlayoutDelays(*frame);
-  info->second.frame = std::move(frame);
+  UpdateSpatialLayerResolutions(*frame);
+  info.frame = std::move(frame);
   ++num_frames_buffered_;
 
-  if (info->second.num_missing_continuous == 0) {
-    info->second.continuous = true;
-    PropagateContinuity(info);
-    last_continuous_picture_id = last_continuous_frame_it_->first.picture_id;
+  if (info.num_missing_continuous == 0) {
+    info.continuous = true;
+    PropagateContinuity(slot);
+    last_continuous_picture_id =
+        frame_infos_[last_continuous_frame_].key.picture_id;
 
     // Since we now have new continuous frames there might be a better frame
     // to return from NextFrame. Signal that thread so that it again can choose
@@ -368,35 +484,37 @@ int FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
   return last_continuous_picture_id;
 }
 
-void FrameBuffer::PropagateContinuity(FrameMap::iterator start) {
+void FrameBuffer::PropagateContinuity(int start) {
   TRACE_EVENT0("webrtc", "FrameBuffer::PropagateContinuity");
-  RTC_DCHECK(start->second.continuous);
-  if (last_continuous_frame_it_ == frames_.end())
-    last_continuous_frame_it_ = start;
+  RTC_DCHECK(frame_infos_[start].continuous);
+  if (last_continuous_frame_ == kNoFrame)
+    last_continuous_frame_ = start;
 
-  std::queue<FrameMap::iterator> continuous_frames;
+  std::queue<int> continuous_frames;
   continuous_frames.push(start);
 
   // A simple BFS to traverse continuous frames.
   while (!continuous_frames.empty()) {
-    auto frame = continuous_frames.front();
+    const int slot = continuous_frames.front();
     continuous_frames.pop();
+    const FrameInfo& info = frame_infos_[slot];
 
-    if (last_continuous_frame_it_->first < frame->first)
-      last_continuous_frame_it_ = frame;
+    if (frame_infos_[last_continuous_frame_].key < info.key)
+      last_continuous_frame_ = slot;
 
     // Loop through all dependent frames, and if that frame no longer has
     // any unfulfilled dependencies then that frame is continuous as well.
-    for (size_t d = 0; d < frame->second.num_dependent_frames; ++d) {
-      auto frame_ref = frames_.find(frame->second.dependent_frames[d]);
-      RTC_DCHECK(frame_ref != frames_.end());
+    for (size_t d = 0; d < info.num_dependent_frames; ++d) {
+      const int ref_slot = FindFrameInfo(info.dependent_frames[d]);
+      RTC_DCHECK_NE(ref_slot, kNoFrame);
 
       // TODO(philipel): Look into why we've seen this happen.
-      if (frame_ref != frames_.end()) {
-        --frame_ref->second.num_missing_continuous;
-        if (frame_ref->second.num_missing_continuous == 0) {
-          frame_ref->second.continuous = true;
-          continuous_frames.push(frame_ref);
+      if (ref_slot != kNoFrame) {
+        FrameInfo& ref_info = frame_infos_[ref_slot];
+        --ref_info.num_missing_continuous;
+        if (ref_info.num_missing_continuous == 0) {
+          ref_info.continuous = true;
+          continuous_frames.push(ref_slot);
         }
       }
     }
@@ -407,60 +525,69 @@ void FrameBuffer::PropagateDecodability(const FrameInfo& info) {
   TRACE_EVENT0("webrtc", "FrameBuffer::PropagateDecodability");
   RTC_CHECK(info.num_dependent_frames < FrameInfo::kMaxNumDependentFrames);
   for (size_t d = 0; d < info.num_dependent_frames; ++d) {
-    auto ref_info = frames_.find(info.dependent_frames[d]);
-    RTC_DCHECK(ref_info != frames_.end());
+    const int ref_slot = FindFrameInfo(info.dependent_frames[d]);
+    RTC_DCHECK_NE(ref_slot, kNoFrame);
     // TODO(philipel): Look into why we've seen this happen.
-    if (ref_info != frames_.end()) {
-      RTC_DCHECK_GT(ref_info->second.num_missing_decodable, 0U);
-      --ref_info->second.num_missing_decodable;
+    if (ref_slot != kNoFrame) {
+      FrameInfo& ref_info = frame_infos_[ref_slot];
+      RTC_DCHECK_GT(ref_info.num_missing_decodable, 0U);
+      --ref_info.num_missing_decodable;
     }
   }
 }
 
-void FrameBuffer::AdvanceLastDecodedFrame(FrameMap::iterator decoded) {
+void FrameBuffer::AdvanceLastDecodedFrame(int decoded) {
   TRACE_EVENT0("webrtc", "FrameBuffer::AdvanceLastDecodedFrame");
-  if (last_decoded_frame_it_ == frames_.end()) {
-    last_decoded_frame_it_ = frames_.begin();
-  } else {
-    RTC_DCHECK(last_decoded_frame_it_->first < decoded->first);
-    ++last_decoded_frame_it_;
-  }
+  RTC_DCHECK(last_decoded_frame_ == kNoFrame ||
+             frame_infos_[last_decoded_frame_].key <
+                 frame_infos_[decoded].key);
   --num_frames_buffered_;
-  ++num_frames_history_;
 
-  // First, delete non-decoded frames from the history.
-  while (last_decoded_frame_it_ != decoded) {
-    if (last_decoded_frame_it_->second.frame)
+  // First, delete non-decoded frames from the history. They are the ones
+  // between the history and |decoded|.
+  auto first = frame_order_.begin() + num_frames_history_;
+  auto it = first;
+  while (*it != decoded) {
+    if (frame_infos_[*it].frame)
       --num_frames_buffered_;
-    last_decoded_frame_it_ = frames_.erase(last_decoded_frame_it_);
+    FreeFrameInfo(*it);
+    ++it;
+    RTC_DCHECK(it != frame_order_.end());
   }
+  frame_order_.erase(first, it);
+  last_decoded_frame_ = decoded;
+  ++num_frames_history_;
 
   // Then remove old history if we have too much history saved.
   if (num_frames_history_ > kMaxFramesHistory) {
-    frames_.erase(frames_.begin());
+    FreeFrameInfo(frame_order_.front());
+    frame_order_.pop_front();
     --num_frames_history_;
   }
 }
 
 bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const FrameObject& frame,
-                                                   FrameMap::iterator info) {
+                                                   int slot) {
   TRACE_EVENT0("webrtc", "FrameBuffer::UpdateFrameInfoWithIncomingFrame");
   FrameKey key(frame.picture_id, frame.spatial_layer);
-  info->second.num_missing_continuous = frame.num_references;
-  info->second.num_missing_decodable = frame.num_references;
+  // Frame infos are stored in a deque, so |info| stays valid while frame
+  // infos for the references are created.
+  FrameInfo& info = frame_infos_[slot];
+  info.num_missing_continuous = frame.num_references;
+  info.num_missing_decodable = frame.num_references;
 
-  RTC_DCHECK(last_decoded_frame_it_ == frames_.end() ||
-             last_decoded_frame_it_->first < info->first);
+  RTC_DCHECK(last_decoded_frame_ == kNoFrame ||
+             frame_infos_[last_decoded_frame_].key < info.key);
 
   // Check how many dependencies that have already been fulfilled.
   for (size_t i = 0; i < frame.num_references; ++i) {
     FrameKey ref_key(frame.references[i], frame.spatial_layer);
-    auto ref_info = frames_.find(ref_key);
+    int ref_slot = FindFrameInfo(ref_key);
 
     // Does |frame| depend on a frame earlier than the last decoded frame?
-    if (last_decoded_frame_it_ != frames_.end() &&
-        ref_key <= last_decoded_frame_it_->first) {
-      if (ref_info == frames_.end()) {
+    if (last_decoded_frame_ != kNoFrame &&
+        ref_key <= frame_infos_[last_decoded_frame_].key) {
+      if (ref_slot == kNoFrame) {
         int64_t now_ms = clock_->TimeInMilliseconds();
         if (last_log_non_decoded_ms_ + kLogNonDecodedIntervalMs < now_ms) {
           LOG(LS_WARNING)
@@ -473,56 +600,55 @@ bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const FrameObject& frame,
         return false;
       }
 
-      --info->second.num_missing_continuous;
-      --info->second.num_missing_decodable;
+      --info.num_missing_continuous;
+      --info.num_missing_decodable;
     } else {
-      if (ref_info == frames_.end())
-        ref_info = frames_.insert(std::make_pair(ref_key, FrameInfo())).first;
+      if (ref_slot == kNoFrame)
+        ref_slot = GetOrCreateFrameInfo(ref_key);
+      FrameInfo& ref_info = frame_infos_[ref_slot];
 
-      if (ref_info->second.continuous)
-        --info->second.num_missing_continuous;
+      if (ref_info.continuous)
+        --info.num_missing_continuous;
 
       // Add backwards reference so |frame| can be updated when new
       // frames are inserted or decoded.
-      ref_info->second.dependent_frames[ref_info->second.num_dependent_frames] =
-          key;
-      RTC_DCHECK_LT(ref_info->second.num_dependent_frames,
+      ref_info.dependent_frames[ref_info.num_dependent_frames] = key;
+      RTC_DCHECK_LT(ref_info.num_dependent_frames,
                     (FrameInfo::kMaxNumDependentFrames - 1));
       // TODO(philipel): Look into why this could happen and handle
       // appropriately.
-      if (ref_info->second.num_dependent_frames <
+      if (ref_info.num_dependent_frames <
           (FrameInfo::kMaxNumDependentFrames - 1)) {
-        ++ref_info->second.num_dependent_frames;
+        ++ref_info.num_dependent_frames;
       }
     }
-    RTC_DCHECK_LE(ref_info->second.num_missing_continuous,
-                  ref_info->second.num_missing_decodable);
+    RTC_DCHECK_LE(frame_infos_[ref_slot].num_missing_continuous,
+                  frame_infos_[ref_slot].num_missing_decodable);
   }
 
   // Check if we have the lower spatial layer frame.
   if (frame.inter_layer_predicted) {
-    ++info->second.num_missing_continuous;
-    ++info->second.num_missing_decodable;
+    ++info.num_missing_continuous;
+    ++info.num_missing_decodable;
 
     FrameKey ref_key(frame.picture_id, frame.spatial_layer - 1);
     // Gets or create the FrameInfo for the referenced frame.
-    auto ref_info = frames_.insert(std::make_pair(ref_key, FrameInfo())).first;
-    if (ref_info->second.continuous)
-      --info->second.num_missing_continuous;
+    const int ref_slot = GetOrCreateFrameInfo(ref_key);
+    FrameInfo& ref_info = frame_infos_[ref_slot];
+    if (ref_info.continuous)
+      --info.num_missing_continuous;
 
-    if (ref_info == last_decoded_frame_it_) {
-      --info->second.num_missing_decodable;
+    if (ref_slot == last_decoded_frame_) {
+      --info.num_missing_decodable;
     } else {
-      ref_info->second.dependent_frames[ref_info->second.num_dependent_frames] =
-          key;
-      ++ref_info->second.num_dependent_frames;
+      ref_info.dependent_frames[ref_info.num_dependent_frames] = key;
+      ++ref_info.num_dependent_frames;
     }
-    RTC_DCHECK_LE(ref_info->second.num_missing_continuous,
-                  ref_info->second.num_missing_decodable);
+    RTC_DCHECK_LE(ref_info.num_missing_continuous,
+                  ref_info.num_missing_decodable);
   }
 
-  RTC_DCHECK_LE(info->second.num_missing_continuous,
-                info->second.num_missing_decodable);
+  RTC_DCHECK_LE(info.num_missing_continuous, info.num_missing_decodable);
 
   return true;
 }
@@ -557,13 +683,62 @@ void FrameBuffer::UpdateTimingFrameInfo() {
 
 void FrameBuffer::ClearFramesAndHistory() {
   TRACE_EVENT0("webrtc", "FrameBuffer::ClearFramesAndHistory");
-  frames_.clear();
-  last_decoded_frame_it_ = frames_.end();
-  last_continuous_frame_it_ = frames_.end();
-  next_frame_it_ = frames_.end();
+  frame_infos_.clear();
+  free_slots_.clear();
+  std::fill(frame_index_.begin(), frame_index_.end(), kNoFrame);
+  frame_order_.clear();
+  last_decoded_frame_ = kNoFrame;
+  last_continuous_frame_ = kNoFrame;
+  next_frame_ = kNoFrame;
   num_frames_history_ = 0;
   num_frames_buffered_ = 0;
 }
 
+int FrameBuffer::FindFrameInfo(const FrameKey& key) const {
+  int slot = frame_index_[key.picture_id % kFrameIndexSize];
+  while (slot != kNoFrame && !(frame_infos_[slot].key == key))
+    slot = frame_infos_[slot].next_in_bucket;
+  return slot;
+}
+
+int FrameBuffer::GetOrCreateFrameInfo(const FrameKey& key) {
+  int slot = FindFrameInfo(key);
+  if (slot != kNoFrame)
+    return slot;
+
+  if (free_slots_.empty()) {
+    slot = static_cast<int>(frame_infos_.size());
+    frame_infos_.emplace_back();
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  FrameInfo& info = frame_infos_[slot];
+  info.key = key;
+  int& bucket = frame_index_[key.picture_id % kFrameIndexSize];
+  info.next_in_bucket = bucket;
+  bucket = slot;
+
+  // Frames mostly arrive in order, so the new frame info almost always goes
+  // at or near the end.
+  auto it = frame_order_.end();
+  while (it != frame_order_.begin() && key < frame_infos_[*(it - 1)].key)
+    --it;
+  frame_order_.insert(it, slot);
+  return slot;
+}
+
+void FrameBuffer::FreeFrameInfo(int slot) {
+  int* link = &frame_index_[frame_infos_[slot].key.picture_id %
+                            kFrameIndexSize];
+  while (*link != slot) {
+    RTC_DCHECK_NE(*link, kNoFrame);
+    link = &frame_infos_[*link].next_in_bucket;
+  }
+  *link = frame_infos_[slot].next_in_bucket;
+  frame_infos_[slot] = FrameInfo();
+  free_slots_.push_back(slot);
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
@@ -12,9 +12,10 @@
 #define WEBRTC_MODULES_VIDEO_CODING_FRAME_BUFFER2_H_
 
 #include <array>
-#include <map>
+#include <deque>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "webrtc/modules/video_coding/frame_object.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
@@ -23,6 +24,7 @@
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/race_checker.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -60,12 +62,29 @@ class FrameBuffer {
                          std::unique_ptr<FrameObject>* frame_out,
                          bool keyframe_required = false);
 
+  // Same as NextFrame(), but doesn't wait. Returns kTimeout if no frame is
+  // due for decoding yet, and sets |wait_ms| to the time until the next
+  // frame is, or to -1 if there is no decodable frame.
+  ReturnReason NextFrameIfDue(std::unique_ptr<FrameObject>* frame_out,
+                              int64_t* wait_ms);
+
   // Tells the FrameBuffer which protection mode that is in use. Affects
   // the frame timing.
   // TODO(philipel): Remove this when new timing calculations has been
   //                 implemented.
   void SetProtectionMode(VCMVideoProtection mode);
 
+  // Skips frames that no other frame depends on, i.e. frames of the upper
+  // temporal layers and VP8 non-reference frames, when they come less than
+  // 1/|max_framerate| s after the last decoded picture. The base temporal
+  // layer is always decoded. 0 means no limit.
+  void SetMaxDecodeFramerate(int max_framerate);
+
+  // Skips the VP9 spatial layers whose resolution, as given by the
+  // scalability structure in the stream, is above |max_pixels|. The base
+  // spatial layer is always decoded. 0 means no limit.
+  void SetMaxDecodePixels(int max_pixels);
+
   // Start the frame buffer, has no effect if the frame buffer is started.
   // The frame buffer is started upon construction.
   void Start();
@@ -88,10 +107,20 @@ class FrameBuffer {
 
     bool operator<=(const FrameKey& rhs) const { return !(rhs < *this); }
 
+    bool operator==(const FrameKey& rhs) const {
+      return picture_id == rhs.picture_id &&
+             spatial_layer == rhs.spatial_layer;
+    }
+
     uint16_t picture_id;
     uint8_t spatial_layer;
   };
 
+  // Frame infos are referred to by their slot in |frame_infos_|.
+  static constexpr int kNoFrame = -1;
+  // Number of buckets of |frame_index_|, a power of two.
+  static constexpr int kFrameIndexSize = 1024;
+
   struct FrameInfo {
     // The maximum number of frames that can depend on this frame.
     static constexpr size_t kMaxNumDependentFrames = 8;
@@ -119,9 +148,46 @@ class FrameBuffer {
 
     // The actual FrameObject.
     std::unique_ptr<FrameObject> frame;
+
+    FrameKey key;
+    // Next FrameInfo in the same |frame_index_| bucket, or kNoFrame.
+    int next_in_bucket = kNoFrame;
   };
 
-  using FrameMap = std::map<FrameKey, FrameInfo>;
+  // Sets |next_frame_| to the frame to decode next, and returns the time until
+  // it is due, or -1 if there is no decodable frame.
+  int64_t FindNextFrame(int64_t now_ms, bool keyframe_required)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Hands out |next_frame_| for decoding.
+  std::unique_ptr<FrameObject> TakeNextFrame(int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Feeds the frame handed out by TakeNextFrame() to the jitter estimator and
+  // updates the timing. Called without holding |crit_|, so that frames can be
+  // inserted meanwhile.
+  void UpdateTimingForNextFrame(FrameObject* frame,
+                                int64_t now_ms,
+                                VCMVideoProtection protection_mode);
+
+  // Keeps the spatial layer resolutions of the scalability structure of
+  // |frame|, if it has one.
+  void UpdateSpatialLayerResolutions(const FrameObject& frame)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Whether |frame| is to be skipped by the decode framerate and resolution
+  // limits.
+  bool SkipFrame(const FrameObject& frame) const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Returns the slot of the frame info for |key|, or kNoFrame.
+  int FindFrameInfo(const FrameKey& key) const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Returns the slot of the frame info for |key|, creating it if needed.
+  int GetOrCreateFrameInfo(const FrameKey& key) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Releases the slot of a frame info. Does not remove it from
+  // |frame_order_|.
+  void FreeFrameInfo(int slot) EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Check that the references of |frame| are valid.
   bool ValidReferences(const FrameObject& frame) const;
@@ -133,50 +199,68 @@ class FrameBuffer {
 
   // Update all directly dependent and indirectly dependent frames and mark
   // them as continuous if all their references has been fulfilled.
-  void PropagateContinuity(FrameMap::iterator start)
+  void PropagateContinuity(int start)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Marks the frame as decoded and updates all directly dependent frames.
   void PropagateDecodability(const FrameInfo& info)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  // Advances |last_decoded_frame_it_| to |decoded| and removes old
+  // Advances |last_decoded_frame_| to |decoded| and removes old
   // frame info.
-  void AdvanceLastDecodedFrame(FrameMap::iterator decoded)
+  void AdvanceLastDecodedFrame(int decoded)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Update the corresponding FrameInfo of |frame| and all FrameInfos that
   // |frame| references.
   // Return false if |frame| will never be decodable, true otherwise.
-  bool UpdateFrameInfoWithIncomingFrame(const FrameObject& frame,
-                                        FrameMap::iterator info)
+  bool UpdateFrameInfoWithIncomingFrame(const FrameObject& frame, int slot)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  void UpdateJitterDelay() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateJitterDelay();
 
-  void UpdateTimingFrameInfo() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateTimingFrameInfo();
 
   void ClearFramesAndHistory() EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  bool HasBadRenderTiming(const FrameObject& frame, int64_t now_ms)
-      EXCLUSIVE_LOCKS_REQUIRED(crit_);
-
-  FrameMap frames_ GUARDED_BY(crit_);
+  bool HasBadRenderTiming(const FrameObject& frame, int64_t now_ms);
+
+  // Frame infos are stored in slots that are reused once freed, so that no
+  // allocation is needed per frame. A deque keeps references to them valid
+  // while new ones are added.
+  std::deque<FrameInfo> frame_infos_ GUARDED_BY(crit_);
+  std::vector<int> free_slots_ GUARDED_BY(crit_);
+  // Heads of the lists of frame infos with the same picture id modulo
+  // kFrameIndexSize, for finding frames without a search.
+  std::vector<int> frame_index_ GUARDED_BY(crit_);
+  // Slots of all frame infos in FrameKey order. The first
+  // |num_frames_history_| ones are the decoded frames kept as history, the
+  // last of which is |last_decoded_frame_|.
+  std::deque<int> frame_order_ GUARDED_BY(crit_);
 
   rtc::CriticalSection crit_;
   Clock* const clock_;
   rtc::Event new_continuous_frame_event_;
-  VCMJitterEstimator* const jitter_estimator_ GUARDED_BY(crit_);
-  VCMTiming* const timing_ GUARDED_BY(crit_);
-  VCMInterFrameDelay inter_frame_delay_ GUARDED_BY(crit_);
+  // Frames are taken out of the buffer serially, and the estimation state is
+  // only used for the frame taken out last.
+  rtc::RaceChecker decode_race_;
+  VCMJitterEstimator* const jitter_estimator_ GUARDED_BY(decode_race_);
+  // VCMTiming is thread safe.
+  VCMTiming* const timing_;
+  VCMInterFrameDelay inter_frame_delay_ GUARDED_BY(decode_race_);
   uint32_t last_decoded_frame_timestamp_ GUARDED_BY(crit_);
-  FrameMap::iterator last_decoded_frame_it_ GUARDED_BY(crit_);
-  FrameMap::iterator last_continuous_frame_it_ GUARDED_BY(crit_);
-  FrameMap::iterator next_frame_it_ GUARDED_BY(crit_);
+  int last_decoded_frame_ GUARDED_BY(crit_);
+  int last_continuous_frame_ GUARDED_BY(crit_);
+  int next_frame_ GUARDED_BY(crit_);
   int num_frames_history_ GUARDED_BY(crit_);
   int num_frames_buffered_ GUARDED_BY(crit_);
   bool stopped_ GUARDED_BY(crit_);
   VCMVideoProtection protection_mode_ GUARDED_BY(crit_);
+  int max_decode_framerate_ GUARDED_BY(crit_);
+  int max_decode_pixels_ GUARDED_BY(crit_);
+  // The resolution of each VP9 spatial layer, from the last scalability
+  // structure received. 0 if not known.
+  int spatial_layer_pixels_[kMaxVp9NumberOfSpatialLayers] GUARDED_BY(crit_);
   VCMReceiveStatisticsCallback* const stats_callback_;
   int64_t last_log_non_decoded_ms_ GUARDED_BY(crit_);
 
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <limits>
 #include <vector>
 
@@ -21,9 +22,11 @@
 #include "webrtc/modules/video_coding/timing.h"
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 using testing::_;
 using testing::Return;
@@ -99,6 +102,8 @@ class FrameObjectFake : public FrameObject {
   // In EncodedImage |_length| is used to descibe its size and |_size| to
   // describe its capacity.
   void SetSize(int size) { _length = size; }
+
+  CodecSpecificInfo* codec_specific_info() { return &_codecSpecificInfo; }
 };
 
 class VCMReceiveStatisticsCallbackMock : public VCMReceiveStatisticsCallback {
@@ -314,6 +319,34 @@ TEST_F(TestFrameBuffer2, ExtractFromEmptyBuffer) {
   CheckNoFrame(0);
 }
 
+TEST_F(TestFrameBuffer2, NextFrameIfDue) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  std::unique_ptr<FrameObject> frame;
+  int64_t wait_ms = 0;
+
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_.NextFrameIfDue(&frame, &wait_ms));
+  EXPECT_EQ(-1, wait_ms);
+
+  // The fake timing makes the first frame due 25 ms after it is inserted.
+  InsertFrame(pid, 0, ts, false);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_.NextFrameIfDue(&frame, &wait_ms));
+  EXPECT_EQ(25, wait_ms);
+  EXPECT_FALSE(frame);
+
+  clock_.AdvanceTimeMilliseconds(wait_ms);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kFrameFound,
+            buffer_.NextFrameIfDue(&frame, &wait_ms));
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(pid, frame->picture_id);
+
+  buffer_.Stop();
+  EXPECT_EQ(FrameBuffer::ReturnReason::kStopped,
+            buffer_.NextFrameIfDue(&frame, &wait_ms));
+}
+
 TEST_F(TestFrameBuffer2, MissingFrame) {
   uint16_t pid = Rand();
   uint32_t ts = Rand();
@@ -438,6 +471,34 @@ TEST_F(TestFrameBuffer2, ProtectionMode) {
   ExtractFrame();
 }
 
+// The jitter estimate is updated without holding the frame buffer lock, so
+// frames can be inserted by another thread meanwhile.
+TEST_F(TestFrameBuffer2, InsertFrameWhileUpdatingJitterEstimate) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  const int64_t kWaitMs = 1000;
+
+  rtc::Event inserted(false, false);
+  std::function<void()> insert = [&]() {
+    InsertFrame(pid + 1, 0, ts + kFps10, false, pid);
+    inserted.Set();
+  };
+  rtc::PlatformThread insert_thread(
+      +[](void* obj) { (*static_cast<std::function<void()>*>(obj))(); },
+      &insert, "InsertThread");
+
+  EXPECT_CALL(jitter_estimator_, GetJitterEstimate(1.0))
+      .WillOnce(::testing::Invoke([&](double) {
+        insert_thread.Start();
+        EXPECT_TRUE(inserted.Wait(kWaitMs));
+        return 0;
+      }));
+  InsertFrame(pid, 0, ts, false);
+  ExtractFrame();
+  insert_thread.Stop();
+  CheckFrame(0, pid, 0);
+}
+
 TEST_F(TestFrameBuffer2, NoContinuousFrame) {
   uint16_t pid = Rand();
   uint32_t ts = Rand();
@@ -559,5 +620,129 @@ TEST_F(TestFrameBuffer2, KeyframeRequired) {
   CheckNoFrame(2);
 }
 
+TEST_F(TestFrameBuffer2, MaxDecodeFramerateSkipsUpperTemporalLayer) {
+  buffer_.SetMaxDecodeFramerate(15);
+  // A 30 fps VP8 stream with two temporal layers, where each frame of the
+  // upper layer references the base layer frame before it.
+  for (uint16_t pid = 0; pid < 6; ++pid) {
+    std::unique_ptr<FrameObjectFake> frame(new FrameObjectFake());
+    frame->picture_id = pid;
+    frame->timestamp = pid * 3000;
+    frame->num_references = pid == 0 ? 0 : 1;
+    frame->references[0] = pid % 2 == 0 ? pid - 2 : pid - 1;
+    CodecSpecificInfo* codec_info = frame->codec_specific_info();
+    codec_info->codecType = kVideoCodecVP8;
+    codec_info->codecSpecific.VP8.temporalIdx = pid % 2;
+    buffer_.InsertFrame(std::move(frame));
+  }
+  for (int i = 0; i < 4; ++i)
+    ExtractFrame();
+
+  CheckFrame(0, 0, 0);
+  CheckFrame(1, 2, 0);
+  CheckFrame(2, 4, 0);
+  CheckNoFrame(3);
+}
+
+TEST_F(TestFrameBuffer2, MaxDecodePixelsSkipsUpperSpatialLayers) {
+  buffer_.SetMaxDecodePixels(640 * 360);
+  // A VP9 stream of two pictures with three spatial layers, where each layer
+  // is predicted from the layer below and the same layer of the picture
+  // before.
+  const uint16_t kWidths[] = {320, 640, 1280};
+  const uint16_t kHeights[] = {180, 360, 720};
+  for (uint16_t pid = 0; pid < 2; ++pid) {
+    for (uint8_t sid = 0; sid < 3; ++sid) {
+      std::unique_ptr<FrameObjectFake> frame(new FrameObjectFake());
+      frame->picture_id = pid;
+      frame->spatial_layer = sid;
+      frame->timestamp = pid * 3000;
+      frame->inter_layer_predicted = sid > 0;
+      frame->num_references = pid;
+      frame->references[0] = pid - 1;
+      CodecSpecificInfo* codec_info = frame->codec_specific_info();
+      codec_info->codecType = kVideoCodecVP9;
+      CodecSpecificInfoVP9& vp9 = codec_info->codecSpecific.VP9;
+      vp9.temporal_idx = 0;
+      vp9.ss_data_available = pid == 0 && sid == 0;
+      if (vp9.ss_data_available) {
+        vp9.spatial_layer_resolution_present = true;
+        vp9.num_spatial_layers = 3;
+        for (size_t i = 0; i < 3; ++i) {
+          vp9.width[i] = kWidths[i];
+          vp9.height[i] = kHeights[i];
+        }
+      }
+      buffer_.InsertFrame(std::move(frame));
+    }
+  }
+  for (int i = 0; i < 5; ++i)
+    ExtractFrame();
+
+  CheckFrame(0, 0, 0);
+  CheckFrame(1, 0, 1);
+  CheckFrame(2, 1, 0);
+  CheckFrame(3, 1, 1);
+  CheckNoFrame(4);
+}
+
+// A high framerate stream with three spatial layers, each predicted from the
+// lower layer and the previous picture, decoded a few pictures behind the
+// newest one. Frames are created up front, so that only the frame buffer
+// itself is measured.
+TEST_F(TestFrameBuffer2, DISABLED_InsertAndExtractSvcPerf) {
+  const int kNumPictures = 20000;
+  const int kNumSpatialLayers = 3;
+  const int kKeyFrameInterval = 300;
+  const int kPicturesBuffered = 10;
+
+  std::vector<std::unique_ptr<FrameObjectFake>> frames;
+  for (int i = 0; i < kNumPictures; ++i) {
+    for (int sl = 0; sl < kNumSpatialLayers; ++sl) {
+      std::unique_ptr<FrameObjectFake> frame(new FrameObjectFake());
+      frame->picture_id = static_cast<uint16_t>(i);
+      frame->spatial_layer = sl;
+      frame->timestamp = i * 90;
+      frame->inter_layer_predicted = sl > 0;
+      if (i % kKeyFrameInterval != 0) {
+        frame->num_references = 1;
+        frame->references[0] = static_cast<uint16_t>(i - 1);
+      }
+      frames.push_back(std::move(frame));
+    }
+  }
+
+  FrameBuffer buffer(&clock_, &jitter_estimator_, &timing_, nullptr);
+  int num_frames = 0;
+  int64_t insert_us = 0;
+  int64_t extract_us = 0;
+  for (int i = 0; i < kNumPictures; ++i) {
+    int64_t start_us = rtc::TimeMicros();
+    for (int sl = 0; sl < kNumSpatialLayers; ++sl)
+      buffer.InsertFrame(std::move(frames[i * kNumSpatialLayers + sl]));
+    insert_us += rtc::TimeMicros() - start_us;
+    clock_.AdvanceTimeMilliseconds(1);
+
+    if (i >= kPicturesBuffered) {
+      start_us = rtc::TimeMicros();
+      for (int sl = 0; sl < kNumSpatialLayers; ++sl) {
+        std::unique_ptr<FrameObject> frame;
+        if (buffer.NextFrame(0, &frame) == FrameBuffer::kFrameFound)
+          ++num_frames;
+      }
+      extract_us += rtc::TimeMicros() - start_us;
+    }
+  }
+  ASSERT_GT(num_frames, 0);
+
+  const int64_t kNumFrames = kNumPictures * kNumSpatialLayers;
+  webrtc::test::PrintResult("frame_buffer2", "", "insert_svc",
+                            static_cast<size_t>(insert_us * 1000 / kNumFrames),
+                            "ns/frame", false);
+  webrtc::test::PrintResult("frame_buffer2", "", "extract_svc",
+                            static_cast<size_t>(extract_us * 1000 / num_frames),
+                            "ns/frame", false);
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
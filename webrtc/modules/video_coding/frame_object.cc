@@ -65,7 +65,6 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
   else
     _size = frame_size;
 
-  _buffer = new uint8_t[_size];
   _length = frame_size;
 
   // For H264 frames we can't determine the frame type by just looking at the
@@ -94,8 +93,13 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
     frame_type_ = first_packet->frameType;
   }
 
-  bool bitstream_copied = GetBitstream(_buffer);
-  RTC_DCHECK(bitstream_copied);
+  // With a deferred copy the bitstream is left in |packet_buffer_| until
+  // AssembleBitstream() is called, usually right before decoding, so frames
+  // that are dropped before that are never copied.
+  if (!packet_buffer_->defer_bitstream_copy_) {
+    bool bitstream_copied = AssembleBitstream();
+    RTC_DCHECK(bitstream_copied);
+  }
   _encodedWidth = first_packet->width;
   _encodedHeight = first_packet->height;
 
@@ -147,6 +151,19 @@ RtpFrameObject::~RtpFrameObject() {
   packet_buffer_->ReturnFrame(this);
 }
 
+bool RtpFrameObject::AssembleBitstream() {
+  if (_buffer)
+    return true;
+
+  _buffer = new uint8_t[_size];
+  if (!GetBitstream(_buffer)) {
+    delete[] _buffer;
+    _buffer = nullptr;
+    return false;
+  }
+  return true;
+}
+
 uint16_t RtpFrameObject::first_seq_num() const {
   return first_seq_num_;
 }
@@ -28,6 +28,11 @@ class FrameObject : public webrtc::VCMEncodedFrame {
 
   virtual bool GetBitstream(uint8_t* destination) const = 0;
 
+  // Makes sure the bitstream is available in the frame's own buffer, which is
+  // what decoders read. Frames that fill their buffer when created have
+  // nothing to do. Returns false if the bitstream is no longer available.
+  virtual bool AssembleBitstream() { return true; }
+
   // The capture timestamp of this frame.
   virtual uint32_t Timestamp() const = 0;
 
@@ -78,6 +83,7 @@ class RtpFrameObject : public FrameObject {
   enum FrameType frame_type() const;
   VideoCodecType codec_type() const;
   bool GetBitstream(uint8_t* destination) const override;
+  bool AssembleBitstream() override;
   uint32_t Timestamp() const override;
   int64_t ReceivedTime() const override;
   int64_t RenderTime() const override;
@@ -159,6 +159,10 @@ int32_t VCMDecodedFrameCallback::ReceivedDecodedFrame(
   return 0;
 }
 
+void VCMDecodedFrameCallback::OnDecoderFallback(DecoderFallbackReason reason) {
+  _receiveCallback->OnDecoderFallback(reason);
+}
+
 uint64_t VCMDecodedFrameCallback::LastReceivedPictureID() const {
   return _lastReceivedPictureID;
 }
@@ -50,6 +50,7 @@ class VCMDecodedFrameCallback : public DecodedImageCallback {
                rtc::Optional<uint8_t> qp) override;
   int32_t ReceivedDecodedReferenceFrame(const uint64_t pictureId) override;
   int32_t ReceivedDecodedFrame(const uint64_t pictureId) override;
+  void OnDecoderFallback(DecoderFallbackReason reason) override;
 
   uint64_t LastReceivedPictureID() const;
   void OnDecoderImplementationName(const char* implementation_name);
@@ -74,6 +74,15 @@ class VideoCodingModule : public Module {
   // DEPRECATED.
   static VideoCodingModule* Create(Clock* clock, EventFactory* event_factory);
 
+  // Same as Create(), but received packets are assembled into frames by a
+  // PacketBuffer and scheduled for decoding by a FrameBuffer, like in
+  // VideoReceiveStream, instead of by VCMJitterBuffer. Lost packets are
+  // NACKed through the registered VCMPacketRequestCallback. The receiver
+  // robustness, decode error mode and NACK settings have no effect in this
+  // mode.
+  static VideoCodingModule* CreateWithFrameBuffer(Clock* clock,
+                                                  EventFactory* event_factory);
+
   /*
   *   Sender
   */
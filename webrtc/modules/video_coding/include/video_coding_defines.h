@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "webrtc/api/video/video_frame.h"
+#include "webrtc/api/video_codecs/video_decoder.h"
 // For EncodedImage
 #include "webrtc/common_video/include/video_frame.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -77,6 +78,7 @@ class VCMReceiveCallback {
   // Called when the current receive codec changes.
   virtual void OnIncomingPayloadType(int payload_type) {}
   virtual void OnDecoderImplementationName(const char* implementation_name) {}
+  virtual void OnDecoderFallback(DecoderFallbackReason reason) {}
 
  protected:
   virtual ~VCMReceiveCallback() {}
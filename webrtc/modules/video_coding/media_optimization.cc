@@ -170,6 +170,11 @@ void MediaOptimization::EnableFrameDropper(bool enable) {
   frame_dropper_->Enable(enable);
 }
 
+void MediaOptimization::EnableFrameDropperLookahead(bool enable) {
+  rtc::CritScope lock(&crit_sect_);
+  frame_dropper_->EnableLookahead(enable);
+}
+
 bool MediaOptimization::DropFrame() {
   rtc::CritScope lock(&crit_sect_);
   UpdateIncomingFrameRate();
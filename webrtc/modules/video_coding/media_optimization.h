@@ -48,6 +48,9 @@ class MediaOptimization {
   uint32_t SetTargetRates(uint32_t target_bitrate);
 
   void EnableFrameDropper(bool enable);
+  // Lets the frame dropper drop frames that are predicted to overshoot, before
+  // they are encoded. See FrameDropper::EnableLookahead.
+  void EnableFrameDropperLookahead(bool enable);
   bool DropFrame();
 
   // Informs Media Optimization of encoded output.
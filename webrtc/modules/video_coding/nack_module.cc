@@ -16,6 +16,7 @@
 #include "webrtc/modules/utility/include/process_thread.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/optional.h"
 
 namespace webrtc {
 
@@ -28,16 +29,43 @@ const int kProcessFrequency = 50;
 const int kProcessIntervalMs = 1000 / kProcessFrequency;
 const int kMaxReorderedPackets = 128;
 const int kNumReorderingBuckets = 10;
+
+// Mask with the |count| lowest bits set, 0 < |count| <= 64.
+uint64_t LowBits(int count) {
+  return count == 64 ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+}
+
+int CountBits(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(bits);
+#else
+  int count = 0;
+  for (; bits; bits &= bits - 1)
+    ++count;
+  return count;
+#endif
+}
+
+// Index of the lowest set bit, |bits| must not be zero.
+int LowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(bits);
+#else
+  int index = 0;
+  for (; !(bits & 1); bits >>= 1)
+    ++index;
+  return index;
+#endif
+}
 }  // namespace
 
+constexpr int NackModule::kNackWindowSize;
+
 NackModule::NackInfo::NackInfo()
-    : seq_num(0), send_at_seq_num(0), sent_at_time(-1), retries(0) {}
+    : send_at_seq_num(0), sent_at_time(-1), retries(0) {}
 
-NackModule::NackInfo::NackInfo(uint16_t seq_num, uint16_t send_at_seq_num)
-    : seq_num(seq_num),
-      send_at_seq_num(send_at_seq_num),
-      sent_at_time(-1),
-      retries(0) {}
+NackModule::NackInfo::NackInfo(uint16_t send_at_seq_num)
+    : send_at_seq_num(send_at_seq_num), sent_at_time(-1), retries(0) {}
 
 NackModule::NackModule(Clock* clock,
                        NackSender* nack_sender,
@@ -45,6 +73,12 @@ NackModule::NackModule(Clock* clock,
     : clock_(clock),
       nack_sender_(nack_sender),
       keyframe_request_sender_(keyframe_request_sender),
+      nack_bits_(kNackWindowSize / 64),
+      unsent_bits_(kNackWindowSize / 64),
+      nack_infos_(kNackWindowSize),
+      nack_list_size_(0),
+      num_unsent_(0),
+      oldest_nack_hint_(0),
       reordering_histogram_(kNumReorderingBuckets, kMaxReorderedPackets),
       initialized_(false),
       rtt_ms_(kDefaultRttMs),
@@ -53,6 +87,10 @@ NackModule::NackModule(Clock* clock,
   RTC_DCHECK(clock_);
   RTC_DCHECK(nack_sender_);
   RTC_DCHECK(keyframe_request_sender_);
+  static_assert(kMaxPacketAge < kNackWindowSize,
+                "The nack window must cover kMaxPacketAge packets.");
+  static_assert((1 << 16) % kNackWindowSize == 0,
+                "The nack window must divide the sequence number space.");
 }
 
 int NackModule::OnReceivedPacket(const VCMPacket& packet) {
@@ -81,12 +119,7 @@ int NackModule::OnReceivedPacket(const VCMPacket& packet) {
 
   if (AheadOf(newest_seq_num_, seq_num)) {
     // An out of order packet has been received.
-    auto nack_list_it = nack_list_.find(seq_num);
-    int nacks_sent_for_packet = 0;
-    if (nack_list_it != nack_list_.end()) {
-      nacks_sent_for_packet = nack_list_it->second.retries;
-      nack_list_.erase(nack_list_it);
-    }
+    int nacks_sent_for_packet = std::max(RemoveNack(seq_num), 0);
     if (!is_retransmitted)
       UpdateReorderingStatistics(seq_num);
     return nacks_sent_for_packet;
@@ -113,7 +146,13 @@ int NackModule::OnReceivedPacket(const VCMPacket& packet) {
 
 void NackModule::ClearUpTo(uint16_t seq_num) {
   rtc::CritScope lock(&crit_);
-  nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
+  const int num_older =
+      ForwardDiff<uint16_t>(newest_seq_num_ - kMaxPacketAge, seq_num);
+  if (num_older <= kMaxPacketAge) {
+    RemoveOldestNacks(num_older);
+  } else if (AheadOf(seq_num, newest_seq_num_)) {
+    RemoveAllNacks();
+  }
   keyframe_list_.erase(keyframe_list_.begin(),
                        keyframe_list_.lower_bound(seq_num));
 }
@@ -125,7 +164,7 @@ void NackModule::UpdateRtt(int64_t rtt_ms) {
 
 void NackModule::Clear() {
   rtc::CritScope lock(&crit_);
-  nack_list_.clear();
+  RemoveAllNacks();
   keyframe_list_.clear();
 }
 
@@ -161,16 +200,13 @@ void NackModule::Process() {
 }
 
 bool NackModule::RemovePacketsUntilKeyFrame() {
+  const uint16_t window_start = newest_seq_num_ - kMaxPacketAge;
   while (!keyframe_list_.empty()) {
-    auto it = nack_list_.lower_bound(*keyframe_list_.begin());
-
-    if (it != nack_list_.begin()) {
-      // We have found a keyframe that actually is newer than at least one
-      // packet in the nack list.
-      RTC_DCHECK(it != nack_list_.end());
-      nack_list_.erase(nack_list_.begin(), it);
+    // Check if the keyframe actually is newer than at least one packet in
+    // the nack list.
+    const int num_older = ForwardDiff(window_start, *keyframe_list_.begin());
+    if (num_older <= kMaxPacketAge && RemoveOldestNacks(num_older) > 0)
       return true;
-    }
 
     // If this keyframe is so old it does not remove any packets from the list,
     // remove it from the list of keyframes and try the next keyframe.
@@ -181,21 +217,22 @@ bool NackModule::RemovePacketsUntilKeyFrame() {
 
 void NackModule::AddPacketsToNack(uint16_t seq_num_start,
                                   uint16_t seq_num_end) {
-  // Remove old packets.
-  auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-  nack_list_.erase(nack_list_.begin(), it);
+  // Remove old packets, i.e. the ones that leave the window when
+  // |newest_seq_num_| advances to |seq_num_end|.
+  RemoveOldestNacks(std::min<int>(ForwardDiff(newest_seq_num_, seq_num_end),
+                                  kMaxPacketAge));
 
   // If the nack list is too large, remove packets from the nack list until
   // the latest first packet of a keyframe. If the list is still too large,
   // clear it and request a keyframe.
   uint16_t num_new_nacks = ForwardDiff(seq_num_start, seq_num_end);
-  if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+  if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     while (RemovePacketsUntilKeyFrame() &&
-           nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+           nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     }
 
-    if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
-      nack_list_.clear();
+    if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
+      RemoveAllNacks();
       LOG(LS_WARNING) << "NACK list full, clearing NACK"
                          " list and requesting keyframe.";
       keyframe_request_sender_->RequestKeyFrame();
@@ -203,11 +240,73 @@ void NackModule::AddPacketsToNack(uint16_t seq_num_start,
     }
   }
 
+  const int wait_number_of_packets = WaitNumberOfPackets(0.5);
   for (uint16_t seq_num = seq_num_start; seq_num != seq_num_end; ++seq_num) {
-    NackInfo nack_info(seq_num, seq_num + WaitNumberOfPackets(0.5));
-    RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
-    nack_list_[seq_num] = nack_info;
+    const int index = seq_num % kNackWindowSize;
+    const uint64_t bit = uint64_t{1} << (index % 64);
+    RTC_DCHECK(!(nack_bits_[index / 64] & bit));
+    nack_bits_[index / 64] |= bit;
+    unsent_bits_[index / 64] |= bit;
+    nack_infos_[index] = NackInfo(seq_num + wait_number_of_packets);
+  }
+  nack_list_size_ += num_new_nacks;
+  num_unsent_ += num_new_nacks;
+}
+
+int NackModule::RemoveNack(uint16_t seq_num) {
+  if (ForwardDiff(seq_num, newest_seq_num_) > kMaxPacketAge)
+    return -1;
+  const int index = seq_num % kNackWindowSize;
+  const uint64_t bit = uint64_t{1} << (index % 64);
+  if (!(nack_bits_[index / 64] & bit))
+    return -1;
+  nack_bits_[index / 64] &= ~bit;
+  --nack_list_size_;
+  if (unsent_bits_[index / 64] & bit) {
+    unsent_bits_[index / 64] &= ~bit;
+    --num_unsent_;
+  }
+  return nack_infos_[index].retries;
+}
+
+int NackModule::RemoveOldestNacks(int count) {
+  RTC_DCHECK_LE(count, kMaxPacketAge);
+  const uint16_t window_start = newest_seq_num_ - kMaxPacketAge;
+  int offset = OldestNackOffset();
+  if (offset >= count)
+    return 0;
+  oldest_nack_hint_ = window_start + count;
+
+  int removed = 0;
+  int unsent_removed = 0;
+  while (offset < count && nack_list_size_ > removed) {
+    const int index = static_cast<uint16_t>(window_start + offset) %
+                      kNackWindowSize;
+    const int num_bits = std::min(count - offset, 64 - index % 64);
+    const uint64_t mask = LowBits(num_bits) << (index % 64);
+    removed += CountBits(nack_bits_[index / 64] & mask);
+    unsent_removed += CountBits(unsent_bits_[index / 64] & mask);
+    nack_bits_[index / 64] &= ~mask;
+    unsent_bits_[index / 64] &= ~mask;
+    offset += num_bits;
   }
+  nack_list_size_ -= removed;
+  num_unsent_ -= unsent_removed;
+  return removed;
+}
+
+void NackModule::RemoveAllNacks() {
+  std::fill(nack_bits_.begin(), nack_bits_.end(), 0);
+  std::fill(unsent_bits_.begin(), unsent_bits_.end(), 0);
+  nack_list_size_ = 0;
+  num_unsent_ = 0;
+  oldest_nack_hint_ = newest_seq_num_;
+}
+
+int NackModule::OldestNackOffset() const {
+  const int offset =
+      ForwardDiff<uint16_t>(newest_seq_num_ - kMaxPacketAge, oldest_nack_hint_);
+  return offset <= kMaxPacketAge ? offset : 0;
 }
 
 std::vector<uint16_t> NackModule::GetNackBatch(NackFilterOptions options) {
@@ -215,38 +314,51 @@ std::vector<uint16_t> NackModule::GetNackBatch(NackFilterOptions options) {
   bool consider_timestamp = options != kSeqNumOnly;
   int64_t now_ms = clock_->TimeInMilliseconds();
   std::vector<uint16_t> nack_batch;
-  auto it = nack_list_.begin();
-  while (it != nack_list_.end()) {
-    if (consider_seq_num && it->second.sent_at_time == -1 &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num)) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                        << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
-      }
-      continue;
-    }
 
-    if (consider_timestamp && it->second.sent_at_time + rtt_ms_ <= now_ms) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                        << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
+  // Only packets that have not been nacked yet can be due by sequence number.
+  const std::vector<uint64_t>& bitmap =
+      consider_timestamp ? nack_bits_ : unsent_bits_;
+  int num_left = consider_timestamp ? nack_list_size_ : num_unsent_;
+  const uint16_t window_start = newest_seq_num_ - kMaxPacketAge;
+  rtc::Optional<uint16_t> oldest_nack;
+  // Walk the window oldest first, one bitmap word at a time, only looking at
+  // the packets that are in the nack list.
+  int offset = OldestNackOffset();
+  while (offset < kMaxPacketAge && num_left > 0) {
+    const uint16_t chunk_start = window_start + offset;
+    const int index = chunk_start % kNackWindowSize;
+    const int num_bits = std::min(kMaxPacketAge - offset, 64 - index % 64);
+    uint64_t bits = (bitmap[index / 64] >> (index % 64)) & LowBits(num_bits);
+    while (bits) {
+      const int bit = LowestBit(bits);
+      bits &= bits - 1;
+      --num_left;
+      const uint16_t seq_num = chunk_start + bit;
+      if (!oldest_nack)
+        oldest_nack = rtc::Optional<uint16_t>(seq_num);
+      const int slot = index + bit;
+      NackInfo& info = nack_infos_[slot];
+      if ((consider_seq_num && info.sent_at_time == -1 &&
+           AheadOrAt(newest_seq_num_, info.send_at_seq_num)) ||
+          (consider_timestamp && info.sent_at_time + rtt_ms_ <= now_ms)) {
+        nack_batch.emplace_back(seq_num);
+        ++info.retries;
+        if (info.sent_at_time == -1) {
+          unsent_bits_[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+          --num_unsent_;
+        }
+        info.sent_at_time = now_ms;
+        if (info.retries >= kMaxNackRetries) {
+          LOG(LS_WARNING) << "Sequence number " << seq_num
+                          << " removed from NACK list due to max retries.";
+          RemoveNack(seq_num);
+        }
       }
-      continue;
     }
-    ++it;
+    offset += num_bits;
   }
+  if (consider_timestamp)
+    oldest_nack_hint_ = oldest_nack ? *oldest_nack : newest_seq_num_;
   return nack_batch;
 }
 
@@ -11,9 +11,8 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_NACK_MODULE_H_
 #define WEBRTC_MODULES_VIDEO_CODING_NACK_MODULE_H_
 
-#include <map>
-#include <vector>
 #include <set>
+#include <vector>
 
 #include "webrtc/modules/include/module.h"
 #include "webrtc/modules/video_coding/histogram.h"
@@ -46,21 +45,36 @@ class NackModule : public Module {
   // GetNackBatch.
   enum NackFilterOptions { kSeqNumOnly, kTimeOnly, kSeqNumAndTime };
 
-  // This class holds the sequence number of the packet that is in the nack list
-  // as well as the meta data about when it should be nacked and how many times
-  // we have tried to nack this packet.
+  // This class holds the meta data about when a packet in the nack list should
+  // be nacked and how many times we have tried to nack it.
   struct NackInfo {
     NackInfo();
-    NackInfo(uint16_t seq_num, uint16_t send_at_seq_num);
+    explicit NackInfo(uint16_t send_at_seq_num);
 
-    uint16_t seq_num;
     uint16_t send_at_seq_num;
     int64_t sent_at_time;
     int retries;
   };
+
+  // The nack list covers the |kMaxPacketAge| sequence numbers before
+  // |newest_seq_num_|, stored in a ring indexed by sequence number. Must be a
+  // power of two that divides 2^16 and is larger than |kMaxPacketAge|.
+  static constexpr int kNackWindowSize = 1 << 14;
+
   void AddPacketsToNack(uint16_t seq_num_start, uint16_t seq_num_end)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Returns the number of nacks sent for |seq_num|, or -1 if it is not in the
+  // nack list.
+  int RemoveNack(uint16_t seq_num) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Removes the packets among the |count| oldest sequence numbers of the
+  // window from the nack list. Returns the number of packets removed.
+  int RemoveOldestNacks(int count) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void RemoveAllNacks() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Returns the offset of |oldest_nack_hint_| in the window, or 0 if it has
+  // left the window.
+  int OldestNackOffset() const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Removes packets from the nack list until the next keyframe. Returns true
   // if packets were removed.
   bool RemovePacketsUntilKeyFrame() EXCLUSIVE_LOCKS_REQUIRED(crit_);
@@ -84,8 +98,17 @@ class NackModule : public Module {
   // TODO(philipel): Some of the variables below are consistently used on a
   // known thread (e.g. see |initialized_|). Those probably do not need
   // synchronized access.
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
-      GUARDED_BY(crit_);
+  // One bit per sequence number in the nack list, one per packet in it that
+  // has not been nacked yet and the corresponding NackInfo, all indexed by
+  // |seq_num % kNackWindowSize|.
+  std::vector<uint64_t> nack_bits_ GUARDED_BY(crit_);
+  std::vector<uint64_t> unsent_bits_ GUARDED_BY(crit_);
+  std::vector<NackInfo> nack_infos_ GUARDED_BY(crit_);
+  int nack_list_size_ GUARDED_BY(crit_);
+  int num_unsent_ GUARDED_BY(crit_);
+  // No packet older than this is in the nack list, as long as it is within
+  // the window. Saves scanning the empty start of the window.
+  uint16_t oldest_nack_hint_ GUARDED_BY(crit_);
   std::set<uint16_t, DescendingSeqNumComp<uint16_t>> keyframe_list_
       GUARDED_BY(crit_);
   video_coding::Histogram reordering_histogram_ GUARDED_BY(crit_);
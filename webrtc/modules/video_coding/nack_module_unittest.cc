@@ -9,12 +9,17 @@
  */
 
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <utility>
 
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/modules/video_coding/nack_module.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 class TestNackModule : public ::testing::Test,
@@ -314,4 +319,103 @@ TEST_F(TestNackModule, PacketNackCount) {
   EXPECT_EQ(0, nack_module_.OnReceivedPacket(packet));
 }
 
+TEST_F(TestNackModule, OldPacketDoesNotClearNewerNack) {
+  VCMPacket packet;
+  packet.seqNum = 20000;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 20002;
+  nack_module_.OnReceivedPacket(packet);
+  EXPECT_EQ(1u, sent_nacks_.size());
+
+  // Far older than anything in the nack list, but maps to the same slot of
+  // the nack window as 20001.
+  packet.seqNum = 20001 - (1 << 14);
+  EXPECT_EQ(0, nack_module_.OnReceivedPacket(packet));
+  packet.seqNum = 20001;
+  EXPECT_EQ(1, nack_module_.OnReceivedPacket(packet));
+}
+
+TEST_F(TestNackModule, RemovesPacketsOlderThanMaxPacketAge) {
+  VCMPacket packet;
+  packet.seqNum = 0;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 2;
+  nack_module_.OnReceivedPacket(packet);
+  for (packet.seqNum = 3; packet.seqNum <= 10001; ++packet.seqNum)
+    nack_module_.OnReceivedPacket(packet);
+  EXPECT_EQ(1u, sent_nacks_.size());
+
+  // Packet 1 is still within the last 10000 packets.
+  sent_nacks_.clear();
+  clock_->AdvanceTimeMilliseconds(100);
+  nack_module_.Process();
+  EXPECT_EQ(1u, sent_nacks_.size());
+
+  packet.seqNum = 10002;
+  nack_module_.OnReceivedPacket(packet);
+  sent_nacks_.clear();
+  clock_->AdvanceTimeMilliseconds(100);
+  nack_module_.Process();
+  EXPECT_EQ(0u, sent_nacks_.size());
+}
+
+// Receives a high rate stream with random losses. Lost packets are mostly
+// recovered after a while, and the frame buffer regularly clears old
+// packets, as it would when frames are decoded or dropped.
+TEST_F(TestNackModule, DISABLED_ReceiveWithLossPerf) {
+  const int kNumPackets = 500000;
+  const int kPacketsPerMs = 5;
+  const int64_t kRecoveryDelayMs = 500;
+  const struct {
+    int loss_percent;
+    const char* trace;
+  } kConfigs[] = {{10, "receive_10_percent_loss"},
+                  {20, "receive_20_percent_loss"},
+                  {30, "receive_30_percent_loss"}};
+
+  for (const auto& config : kConfigs) {
+    const int loss_percent = config.loss_percent;
+    Random random(4711);
+    std::deque<std::pair<int64_t, uint16_t>> retransmissions;
+    VCMPacket packet;
+    int64_t elapsed_us = 0;
+    for (int i = 0; i < kNumPackets; ++i) {
+      const uint16_t seq_num = static_cast<uint16_t>(i);
+      const int64_t now_ms = clock_->TimeInMilliseconds();
+      const bool lost = i > 0 && random.Rand(0, 99) < loss_percent;
+      if (lost && random.Rand(0, 99) >= loss_percent)
+        retransmissions.push_back(
+            std::make_pair(now_ms + kRecoveryDelayMs, seq_num));
+
+      int64_t start_us = rtc::TimeMicros();
+      if (!lost) {
+        packet.seqNum = seq_num;
+        nack_module_.OnReceivedPacket(packet);
+      }
+      while (!retransmissions.empty() &&
+             retransmissions.front().first <= now_ms) {
+        packet.seqNum = retransmissions.front().second;
+        nack_module_.OnReceivedPacket(packet);
+        retransmissions.pop_front();
+      }
+      if (i % kPacketsPerMs == 0) {
+        if (nack_module_.TimeUntilNextProcess() == 0)
+          nack_module_.Process();
+        if (now_ms % 100 == 0)
+          nack_module_.ClearUpTo(seq_num - 2000);
+      }
+      elapsed_us += rtc::TimeMicros() - start_us;
+
+      if (i % kPacketsPerMs == kPacketsPerMs - 1)
+        clock_->AdvanceTimeMilliseconds(1);
+      sent_nacks_.clear();
+    }
+
+    webrtc::test::PrintResult(
+        "nack_module", "", config.trace,
+        static_cast<size_t>(elapsed_us * 1000 / kNumPackets), "ns/packet",
+        false);
+  }
+}
+
 }  // namespace webrtc
@@ -45,7 +45,8 @@ PacketBuffer::PacketBuffer(Clock* clock,
       is_cleared_to_first_seq_num_(false),
       data_buffer_(start_buffer_size),
       sequence_buffer_(start_buffer_size),
-      received_frame_callback_(received_frame_callback) {
+      received_frame_callback_(received_frame_callback),
+      defer_bitstream_copy_(false) {
   RTC_DCHECK_LE(start_buffer_size, max_buffer_size);
   // Buffer size must always be a power of 2.
   RTC_DCHECK((start_buffer_size & (start_buffer_size - 1)) == 0);
@@ -145,7 +146,13 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
   for (size_t i = 0; i < iterations; ++i) {
     size_t index = first_seq_num_ % size_;
     RTC_DCHECK_EQ(data_buffer_[index].seqNum, sequence_buffer_[index].seq_num);
-    if (AheadOf<uint16_t>(seq_num, sequence_buffer_[index].seq_num)) {
+    // Packets of frames that have been handed out are released by
+    // ReturnFrame() if the frame still needs its bitstream.
+    bool keep_for_frame = defer_bitstream_copy_ &&
+                          sequence_buffer_[index].used &&
+                          sequence_buffer_[index].frame_created;
+    if (AheadOf<uint16_t>(seq_num, sequence_buffer_[index].seq_num) &&
+        !keep_for_frame) {
       delete[] data_buffer_[index].dataPtr;
       data_buffer_[index].dataPtr = nullptr;
       sequence_buffer_[index].used = false;
@@ -190,6 +197,11 @@ void PacketBuffer::PaddingReceived(uint16_t seq_num) {
     received_frame_callback_->OnReceivedFrame(std::move(frame));
 }
 
+void PacketBuffer::SetDeferBitstreamCopy(bool defer) {
+  rtc::CritScope lock(&crit_);
+  defer_bitstream_copy_ = defer;
+}
+
 rtc::Optional<int64_t> PacketBuffer::LastReceivedPacketMs() const {
   rtc::CritScope lock(&crit_);
   return last_received_packet_ms_;
@@ -200,6 +212,16 @@ rtc::Optional<int64_t> PacketBuffer::LastReceivedKeyframePacketMs() const {
   return last_received_keyframe_packet_ms_;
 }
 
+size_t PacketBuffer::MemoryUsageBytes() const {
+  rtc::CritScope lock(&crit_);
+  size_t bytes = size_ * (sizeof(VCMPacket) + sizeof(ContinuityInfo));
+  for (size_t i = 0; i < size_; ++i) {
+    if (data_buffer_[i].dataPtr)
+      bytes += data_buffer_[i].sizeBytes;
+  }
+  return bytes;
+}
+
 bool PacketBuffer::ExpandBufferSize() {
   if (size_ == max_size_) {
     LOG(LS_WARNING) << "PacketBuffer is already at max size (" << max_size_
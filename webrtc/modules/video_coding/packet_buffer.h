@@ -57,10 +57,22 @@ class PacketBuffer {
   void Clear();
   void PaddingReceived(uint16_t seq_num);
 
+  // If enabled, frames handed out by the packet buffer don't copy their
+  // bitstream when created. The payloads stay in the packet buffer, which
+  // keeps the packets of a frame until it is destroyed even if ClearTo() has
+  // passed them, and are only made contiguous by
+  // RtpFrameObject::AssembleBitstream(). Clear() still releases all packets,
+  // after which assembling the frames already handed out fails.
+  void SetDeferBitstreamCopy(bool defer);
+
   // Timestamp (not RTP timestamp) of the last received packet/keyframe packet.
   rtc::Optional<int64_t> LastReceivedPacketMs() const;
   rtc::Optional<int64_t> LastReceivedKeyframePacketMs() const;
 
+  // Returns the number of bytes currently held by the buffer, i.e. the packet
+  // slots allocated so far plus the payloads of the stored packets.
+  size_t MemoryUsageBytes() const;
+
   int AddRef() const;
   int Release() const;
 
@@ -154,6 +166,9 @@ class PacketBuffer {
   rtc::Optional<int64_t> last_received_packet_ms_ GUARDED_BY(crit_);
   rtc::Optional<int64_t> last_received_keyframe_packet_ms_ GUARDED_BY(crit_);
 
+  // See SetDeferBitstreamCopy().
+  bool defer_bitstream_copy_ GUARDED_BY(crit_);
+
   rtc::Optional<uint16_t> newest_inserted_seq_num_ GUARDED_BY(crit_);
   std::set<uint16_t, DescendingSeqNumComp<uint16_t>> missing_packets_
       GUARDED_BY(crit_);
@@ -27,11 +27,16 @@ RtpFrameReferenceFinder::RtpFrameReferenceFinder(
       last_unwrap_(-1),
       current_ss_idx_(0),
       cleared_to_seq_num_(-1),
-      frame_callback_(frame_callback) {}
+      num_managed_frames_(0),
+      num_frame_attempts_(0),
+      frame_callback_(frame_callback) {
+  stashed_frames_.reserve(kMaxStashedFrames + 1);
+}
 
 void RtpFrameReferenceFinder::ManageFrame(
     std::unique_ptr<RtpFrameObject> frame) {
   rtc::CritScope lock(&crit_);
+  ++num_managed_frames_;
 
   // If we have cleared past this frame, drop it.
   if (cleared_to_seq_num_ != -1 &&
@@ -45,7 +50,7 @@ void RtpFrameReferenceFinder::ManageFrame(
     case kStash:
       if (stashed_frames_.size() > kMaxStashedFrames)
         stashed_frames_.pop_back();
-      stashed_frames_.push_front(std::move(frame));
+      stashed_frames_.insert(stashed_frames_.begin(), std::move(frame));
       break;
     case kHandOff:
       frame_callback_->OnCompleteFrame(std::move(frame));
@@ -81,6 +86,7 @@ void RtpFrameReferenceFinder::RetryStashedFrames() {
 
 RtpFrameReferenceFinder::FrameDecision
 RtpFrameReferenceFinder::ManageFrameInternal(RtpFrameObject* frame) {
+  ++num_frame_attempts_;
   switch (frame->codec_type()) {
     case kVideoCodecFlexfec:
     case kVideoCodecULPFEC:
@@ -131,6 +137,16 @@ void RtpFrameReferenceFinder::ClearTo(uint16_t seq_num) {
   }
 }
 
+size_t RtpFrameReferenceFinder::NumManagedFrames() const {
+  rtc::CritScope lock(&crit_);
+  return num_managed_frames_;
+}
+
+size_t RtpFrameReferenceFinder::NumFrameAttempts() const {
+  rtc::CritScope lock(&crit_);
+  return num_frame_attempts_;
+}
+
 void RtpFrameReferenceFinder::UpdateLastPictureIdWithPadding(uint16_t seq_num) {
   auto gop_seq_num_it = last_seq_num_gop_.upper_bound(seq_num);
 
@@ -264,6 +280,14 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   // Find if there has been a gap in fully received frames and save the picture
   // id of those frames in |not_yet_received_frames_|.
   if (AheadOf<uint16_t, kPicIdLength>(frame->picture_id, last_picture_id_)) {
+    // Frames older than |kMaxNotYetReceivedFrames| are cleaned up below, so
+    // there is no need to insert them.
+    if (ForwardDiff<uint16_t, kPicIdLength>(last_picture_id_,
+                                            frame->picture_id) >
+        kMaxNotYetReceivedFrames) {
+      last_picture_id_ = Subtract<kPicIdLength>(frame->picture_id,
+                                                kMaxNotYetReceivedFrames + 1);
+    }
     do {
       last_picture_id_ = Add<kPicIdLength>(last_picture_id_, 1);
       not_yet_received_frames_.insert(last_picture_id_);
@@ -272,41 +296,41 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
 
   // Clean up info for base layers that are too old.
   uint8_t old_tl0_pic_idx = codec_header.tl0PicIdx - kMaxLayerInfo;
-  auto clean_layer_info_to = layer_info_.lower_bound(old_tl0_pic_idx);
-  layer_info_.erase(layer_info_.begin(), clean_layer_info_to);
+  layer_info_tl0_.EraseOlderThan(old_tl0_pic_idx);
 
   // Clean up info about not yet received frames that are too old.
   uint16_t old_picture_id =
       Subtract<kPicIdLength>(frame->picture_id, kMaxNotYetReceivedFrames);
-  auto clean_frames_to = not_yet_received_frames_.lower_bound(old_picture_id);
-  not_yet_received_frames_.erase(not_yet_received_frames_.begin(),
-                                 clean_frames_to);
+  not_yet_received_frames_.EraseOlderThan(old_picture_id);
 
   if (frame->frame_type() == kVideoFrameKey) {
     frame->num_references = 0;
     layer_info_[codec_header.tl0PicIdx].fill(-1);
+    layer_info_tl0_.insert(codec_header.tl0PicIdx);
     UpdateLayerInfoVp8(frame);
     return kHandOff;
   }
 
-  auto layer_info_it = layer_info_.find(codec_header.temporalIdx == 0
-                                            ? codec_header.tl0PicIdx - 1
-                                            : codec_header.tl0PicIdx);
+  uint8_t layer_info_tl0_pic_idx = codec_header.temporalIdx == 0
+                                       ? codec_header.tl0PicIdx - 1
+                                       : codec_header.tl0PicIdx;
 
   // If we don't have the base layer frame yet, stash this frame.
-  if (layer_info_it == layer_info_.end())
+  if (!layer_info_tl0_.contains(layer_info_tl0_pic_idx))
     return kStash;
+  const std::array<int16_t, kMaxTemporalLayers>* layer_info =
+      &layer_info_[layer_info_tl0_pic_idx];
 
   // A non keyframe base layer frame has been received, copy the layer info
   // from the previous base layer frame and set a reference to the previous
   // base layer frame.
   if (codec_header.temporalIdx == 0) {
-    layer_info_it =
-        layer_info_
-            .insert(make_pair(codec_header.tl0PicIdx, layer_info_it->second))
-            .first;
+    if (!layer_info_tl0_.contains(codec_header.tl0PicIdx)) {
+      layer_info_[codec_header.tl0PicIdx] = *layer_info;
+      layer_info_tl0_.insert(codec_header.tl0PicIdx);
+    }
     frame->num_references = 1;
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = layer_info_[codec_header.tl0PicIdx][0];
     UpdateLayerInfoVp8(frame);
     return kHandOff;
   }
@@ -314,7 +338,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   // Layer sync frame, this frame only references its base layer frame.
   if (codec_header.layerSync) {
     frame->num_references = 1;
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = (*layer_info)[0];
 
     UpdateLayerInfoVp8(frame);
     return kHandOff;
@@ -325,29 +349,26 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   for (uint8_t layer = 0; layer <= codec_header.temporalIdx; ++layer) {
     // If we have not yet received a previous frame on this temporal layer,
     // stash this frame.
-    if (layer_info_it->second[layer] == -1)
+    if ((*layer_info)[layer] == -1)
       return kStash;
+    const uint16_t last_pid_on_layer = (*layer_info)[layer];
 
     // If the last frame on this layer is ahead of this frame it means that
     // a layer sync frame has been received after this frame for the same
     // base layer frame, drop this frame.
-    if (AheadOf<uint16_t, kPicIdLength>(layer_info_it->second[layer],
-                                        frame->picture_id)) {
+    if (AheadOf<uint16_t, kPicIdLength>(last_pid_on_layer, frame->picture_id))
       return kDrop;
-    }
 
     // If we have not yet received a frame between this frame and the referenced
     // frame then we have to wait for that frame to be completed first.
-    auto not_received_frame_it =
-        not_yet_received_frames_.upper_bound(layer_info_it->second[layer]);
-    if (not_received_frame_it != not_yet_received_frames_.end() &&
-        AheadOf<uint16_t, kPicIdLength>(frame->picture_id,
-                                        *not_received_frame_it)) {
+    if (AheadOf<uint16_t, kPicIdLength>(frame->picture_id, last_pid_on_layer) &&
+        not_yet_received_frames_.ContainsAnyInInterval(
+            Add<kPicIdLength>(last_pid_on_layer, 1), frame->picture_id)) {
       return kStash;
     }
 
     if (!(AheadOf<uint16_t, kPicIdLength>(frame->picture_id,
-                                          layer_info_it->second[layer]))) {
+                                          last_pid_on_layer))) {
       LOG(LS_WARNING) << "Frame with picture id " << frame->picture_id
                       << " and packet range [" << frame->first_seq_num() << ", "
                       << frame->last_seq_num() << "] already received, "
@@ -356,7 +377,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
     }
 
     ++frame->num_references;
-    frame->references[layer] = layer_info_it->second[layer];
+    frame->references[layer] = last_pid_on_layer;
   }
 
   UpdateLayerInfoVp8(frame);
@@ -370,21 +391,19 @@ void RtpFrameReferenceFinder::UpdateLayerInfoVp8(RtpFrameObject* frame) {
 
   uint8_t tl0_pic_idx = codec_header.tl0PicIdx;
   uint8_t temporal_index = codec_header.temporalIdx;
-  auto layer_info_it = layer_info_.find(tl0_pic_idx);
 
   // Update this layer info and newer.
-  while (layer_info_it != layer_info_.end()) {
-    if (layer_info_it->second[temporal_index] != -1 &&
-        AheadOf<uint16_t, kPicIdLength>(layer_info_it->second[temporal_index],
-                                        frame->picture_id)) {
+  while (layer_info_tl0_.contains(tl0_pic_idx)) {
+    int16_t& last_pid_on_layer = layer_info_[tl0_pic_idx][temporal_index];
+    if (last_pid_on_layer != -1 &&
+        AheadOf<uint16_t, kPicIdLength>(last_pid_on_layer, frame->picture_id)) {
       // The frame was not newer, then no subsequent layer info have to be
       // update.
       break;
     }
 
-    layer_info_it->second[codec_header.temporalIdx] = frame->picture_id;
+    last_pid_on_layer = frame->picture_id;
     ++tl0_pic_idx;
-    layer_info_it = layer_info_.find(tl0_pic_idx);
   }
   not_yet_received_frames_.erase(frame->picture_id);
 
@@ -433,39 +452,46 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
       scalability_structures_[current_ss_idx_] = codec_header.gof;
       scalability_structures_[current_ss_idx_].pid_start = frame->picture_id;
 
-      GofInfo info(&scalability_structures_[current_ss_idx_],
-                   frame->picture_id);
-      gof_info_.insert(std::make_pair(codec_header.tl0_pic_idx, info));
+      if (!gof_info_tl0_.contains(codec_header.tl0_pic_idx)) {
+        gof_info_[codec_header.tl0_pic_idx] =
+            GofInfo(&scalability_structures_[current_ss_idx_],
+                    frame->picture_id);
+        gof_info_tl0_.insert(codec_header.tl0_pic_idx);
+      }
     }
   }
 
   // Clean up info for base layers that are too old.
   uint8_t old_tl0_pic_idx = codec_header.tl0_pic_idx - kMaxGofSaved;
-  auto clean_gof_info_to = gof_info_.lower_bound(old_tl0_pic_idx);
-  gof_info_.erase(gof_info_.begin(), clean_gof_info_to);
+  gof_info_tl0_.EraseOlderThan(old_tl0_pic_idx);
 
   if (frame->frame_type() == kVideoFrameKey) {
     // When using GOF all keyframes must include the scalability structure.
     if (!codec_header.ss_data_available)
       LOG(LS_WARNING) << "Received keyframe without scalability structure";
 
+    // Without any scalability structure for this keyframe, wait until one
+    // arrives with another frame.
+    if (!gof_info_tl0_.contains(codec_header.tl0_pic_idx))
+      return kStash;
+
     frame->num_references = 0;
-    GofInfo info = gof_info_.find(codec_header.tl0_pic_idx)->second;
+    GofInfo info = gof_info_[codec_header.tl0_pic_idx];
     FrameReceivedVp9(frame->picture_id, &info);
     UnwrapPictureIds(frame);
     return kHandOff;
   }
 
-  auto gof_info_it = gof_info_.find(
+  uint8_t gof_info_tl0_pic_idx =
       (codec_header.temporal_idx == 0 && !codec_header.ss_data_available)
           ? codec_header.tl0_pic_idx - 1
-          : codec_header.tl0_pic_idx);
+          : codec_header.tl0_pic_idx;
 
   // Gof info for this frame is not available yet, stash this frame.
-  if (gof_info_it == gof_info_.end())
+  if (!gof_info_tl0_.contains(gof_info_tl0_pic_idx))
     return kStash;
 
-  GofInfo* info = &gof_info_it->second;
+  GofInfo* info = &gof_info_[gof_info_tl0_pic_idx];
   FrameReceivedVp9(frame->picture_id, info);
 
   // Make sure we don't miss any frame that could potentially have the
@@ -473,24 +499,29 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
   if (MissingRequiredFrameVp9(frame->picture_id, *info))
     return kStash;
 
-  if (codec_header.temporal_up_switch) {
-    auto pid_tidx =
-        std::make_pair(frame->picture_id, codec_header.temporal_idx);
-    up_switch_.insert(pid_tidx);
+  if (codec_header.temporal_up_switch &&
+      codec_header.temporal_idx < kMaxTemporalLayers) {
+    // Only the first frame with a given picture id sets its temporal layer.
+    bool up_switch_known = false;
+    for (const auto& up_switch : up_switch_)
+      up_switch_known |= up_switch.contains(frame->picture_id);
+    if (!up_switch_known)
+      up_switch_[codec_header.temporal_idx].insert(frame->picture_id);
   }
 
   // If this is a base layer frame that contains a scalability structure
   // then gof info has already been inserted earlier, so we only want to
   // insert if we haven't done so already.
-  if (codec_header.temporal_idx == 0 && !codec_header.ss_data_available) {
-    GofInfo new_info(info->gof, frame->picture_id);
-    gof_info_.insert(std::make_pair(codec_header.tl0_pic_idx, new_info));
+  if (codec_header.temporal_idx == 0 && !codec_header.ss_data_available &&
+      !gof_info_tl0_.contains(codec_header.tl0_pic_idx)) {
+    gof_info_[codec_header.tl0_pic_idx] = GofInfo(info->gof, frame->picture_id);
+    gof_info_tl0_.insert(codec_header.tl0_pic_idx);
   }
 
   // Clean out old info about up switch frames.
   uint16_t old_picture_id = Subtract<kPicIdLength>(frame->picture_id, 50);
-  auto up_switch_erase_to = up_switch_.lower_bound(old_picture_id);
-  up_switch_.erase(up_switch_.begin(), up_switch_erase_to);
+  for (auto& up_switch : up_switch_)
+    up_switch.EraseOlderThan(old_picture_id);
 
   size_t diff = ForwardDiff<uint16_t, kPicIdLength>(info->gof->pid_start,
                                                     frame->picture_id);
@@ -528,10 +559,11 @@ bool RtpFrameReferenceFinder::MissingRequiredFrameVp9(uint16_t picture_id,
   for (size_t i = 0; i < num_references; ++i) {
     uint16_t ref_pid =
         Subtract<kPicIdLength>(picture_id, info.gof->pid_diff[gof_idx][i]);
+    if (!AheadOf<uint16_t, kPicIdLength>(picture_id, ref_pid))
+      continue;
     for (size_t l = 0; l < temporal_idx; ++l) {
-      auto missing_frame_it = missing_frames_for_layer_[l].lower_bound(ref_pid);
-      if (missing_frame_it != missing_frames_for_layer_[l].end() &&
-          AheadOf<uint16_t, kPicIdLength>(picture_id, *missing_frame_it)) {
+      if (missing_frames_for_layer_[l].ContainsAnyInInterval(ref_pid,
+                                                             picture_id)) {
         return true;
       }
     }
@@ -572,11 +604,12 @@ void RtpFrameReferenceFinder::FrameReceivedVp9(uint16_t picture_id,
 bool RtpFrameReferenceFinder::UpSwitchInIntervalVp9(uint16_t picture_id,
                                                     uint8_t temporal_idx,
                                                     uint16_t pid_ref) {
-  for (auto up_switch_it = up_switch_.upper_bound(pid_ref);
-       up_switch_it != up_switch_.end() &&
-       AheadOf<uint16_t, kPicIdLength>(picture_id, up_switch_it->first);
-       ++up_switch_it) {
-    if (up_switch_it->second < temporal_idx)
+  if (!AheadOf<uint16_t, kPicIdLength>(picture_id, pid_ref))
+    return false;
+
+  const uint16_t begin = Add<kPicIdLength>(pid_ref, 1);
+  for (uint8_t l = 0; l < temporal_idx && l < kMaxTemporalLayers; ++l) {
+    if (up_switch_[l].ContainsAnyInInterval(begin, picture_id))
       return true;
   }
 
@@ -14,11 +14,12 @@
 #include <array>
 #include <map>
 #include <memory>
-#include <deque>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/video_coding/seq_num_set.h"
 #include "webrtc/modules/video_coding/sequence_number_util.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/thread_annotations.h"
@@ -56,6 +57,12 @@ class RtpFrameReferenceFinder {
   // Clear all stashed frames that include packets older than |seq_num|.
   void ClearTo(uint16_t seq_num);
 
+  // The number of frames passed to ManageFrame(), and the number of times a
+  // frame has been run through the reference finding logic, which includes
+  // every retry of a stashed frame. Their ratio is the average cost per frame.
+  size_t NumManagedFrames() const;
+  size_t NumFrameAttempts() const;
+
  private:
   static const uint16_t kPicIdLength = 1 << 15;
   static const uint8_t kMaxTemporalLayers = 5;
@@ -68,6 +75,7 @@ class RtpFrameReferenceFinder {
   enum FrameDecision { kStash, kHandOff, kDrop };
 
   struct GofInfo {
+    GofInfo() : gof(nullptr), last_picture_id(0) {}
     GofInfo(GofInfoVP9* gof, uint16_t last_picture_id)
         : gof(gof), last_picture_id(last_picture_id) {}
     GofInfoVP9* gof;
@@ -171,19 +179,19 @@ class RtpFrameReferenceFinder {
 
   // Frames earlier than the last received frame that have not yet been
   // fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
-      not_yet_received_frames_ GUARDED_BY(crit_);
+  SeqNumSet<uint16_t, kPicIdLength> not_yet_received_frames_ GUARDED_BY(crit_);
 
   // Frames that have been fully received but didn't have all the information
-  // needed to determine their references.
-  std::deque<std::unique_ptr<RtpFrameObject>> stashed_frames_ GUARDED_BY(crit_);
+  // needed to determine their references, newest first. The capacity is
+  // reserved up front, so stashing never allocates.
+  std::vector<std::unique_ptr<RtpFrameObject>> stashed_frames_
+      GUARDED_BY(crit_);
 
   // Holds the information about the last completed frame for a given temporal
-  // layer given a Tl0 picture index.
-  std::map<uint8_t,
-           std::array<int16_t, kMaxTemporalLayers>,
-           DescendingSeqNumComp<uint8_t>>
-      layer_info_ GUARDED_BY(crit_);
+  // layer given a Tl0 picture index, for the indices in |layer_info_tl0_|.
+  std::array<std::array<int16_t, kMaxTemporalLayers>, 256> layer_info_
+      GUARDED_BY(crit_);
+  SeqNumSet<uint8_t> layer_info_tl0_ GUARDED_BY(crit_);
 
   // Where the current scalability structure is in the
   // |scalability_structures_| array.
@@ -193,18 +201,18 @@ class RtpFrameReferenceFinder {
   std::array<GofInfoVP9, kMaxGofSaved> scalability_structures_
       GUARDED_BY(crit_);
 
-  // Holds the the Gof information for a given TL0 picture index.
-  std::map<uint8_t, GofInfo, DescendingSeqNumComp<uint8_t>> gof_info_
-      GUARDED_BY(crit_);
+  // Holds the the Gof information for a given TL0 picture index, for the
+  // indices in |gof_info_tl0_|.
+  std::array<GofInfo, 256> gof_info_ GUARDED_BY(crit_);
+  SeqNumSet<uint8_t> gof_info_tl0_ GUARDED_BY(crit_);
 
-  // Keep track of which picture id and which temporal layer that had the
-  // up switch flag set.
-  std::map<uint16_t, uint8_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
-      up_switch_ GUARDED_BY(crit_);
+  // For every temporal layer, keep track of which picture ids had the up
+  // switch flag set.
+  std::array<SeqNumSet<uint16_t, kPicIdLength>, kMaxTemporalLayers> up_switch_
+      GUARDED_BY(crit_);
 
   // For every temporal layer, keep a set of which frames that are missing.
-  std::array<std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>,
-             kMaxTemporalLayers>
+  std::array<SeqNumSet<uint16_t, kPicIdLength>, kMaxTemporalLayers>
       missing_frames_for_layer_ GUARDED_BY(crit_);
 
   // How far frames have been cleared by sequence number. A frame will be
@@ -212,6 +220,9 @@ class RtpFrameReferenceFinder {
   // |cleared_to_seq_num_|.
   int cleared_to_seq_num_ GUARDED_BY(crit_);
 
+  size_t num_managed_frames_ GUARDED_BY(crit_);
+  size_t num_frame_attempts_ GUARDED_BY(crit_);
+
   OnCompleteFrameCallback* frame_callback_;
 };
 
@@ -8,18 +8,22 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "webrtc/modules/video_coding/frame_object.h"
 #include "webrtc/modules/video_coding/packet_buffer.h"
 #include "webrtc/rtc_base/random.h"
 #include "webrtc/rtc_base/refcount.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace webrtc {
 namespace video_coding {
@@ -132,6 +136,20 @@ class TestRtpFrameReferenceFinder : public ::testing::Test,
                     int32_t tl0 = kNoTl0PicIdx,
                     bool up_switch = false,
                     GofInfoVP9* ss = nullptr) {
+    reference_finder_->ManageFrame(CreateVp9Gof(seq_num_start, seq_num_end,
+                                                keyframe, pid, sid, tid, tl0,
+                                                up_switch, ss));
+  }
+
+  std::unique_ptr<RtpFrameObject> CreateVp9Gof(uint16_t seq_num_start,
+                                               uint16_t seq_num_end,
+                                               bool keyframe,
+                                               int32_t pid,
+                                               uint8_t sid,
+                                               uint8_t tid,
+                                               int32_t tl0,
+                                               bool up_switch,
+                                               GofInfoVP9* ss) {
     VCMPacket packet;
     packet.timestamp = pid;
     packet.codec = kVideoCodecVP9;
@@ -157,9 +175,8 @@ class TestRtpFrameReferenceFinder : public ::testing::Test,
       ref_packet_buffer_->InsertPacket(&packet);
     }
 
-    std::unique_ptr<RtpFrameObject> frame(new RtpFrameObject(
+    return std::unique_ptr<RtpFrameObject>(new RtpFrameObject(
         ref_packet_buffer_, seq_num_start, seq_num_end, 0, 0, 0));
-    reference_finder_->ManageFrame(std::move(frame));
   }
 
   void InsertVp9Flex(uint16_t seq_num_start,
@@ -1308,5 +1325,80 @@ TEST_F(TestRtpFrameReferenceFinder, Vp9FlexibleModeTwoSpatialLayersReordered) {
   CheckReferencesVp9(pid + 8, 1, pid + 7);
 }
 
+TEST_F(TestRtpFrameReferenceFinder, CountsStashedFrameRetries) {
+  uint16_t pid = Rand();
+  uint16_t sn = Rand();
+
+  InsertVp8(sn + 1, sn + 1, false, pid + 1, 0, 1);
+  EXPECT_EQ(1u, reference_finder_->NumFrameAttempts());
+  InsertVp8(sn, sn, true, pid, 0, 0);
+
+  ASSERT_EQ(2UL, frames_from_callback_.size());
+  EXPECT_EQ(2u, reference_finder_->NumManagedFrames());
+  EXPECT_EQ(3u, reference_finder_->NumFrameAttempts());
+}
+
+// Three spatial layers with the 0212 temporal structure, received in order
+// and with every other pair of upper layer pictures swapped. Frames are created
+// in batches ahead of time, so that only the reference finder is measured.
+TEST_F(TestRtpFrameReferenceFinder, DISABLED_Vp9GofSpatialLayersPerf) {
+  const int kNumPictures = 100000;
+  const int kBatchSize = 1000;
+  const uint8_t kNumSpatialLayers = 3;
+  const uint8_t kTemporalIdx[] = {0, 2, 1, 2};
+  GofInfoVP9 ss;
+  ss.SetGofInfoVP9(kTemporalStructureMode3);
+
+  for (bool reordered : {false, true}) {
+    reference_finder_.reset(new RtpFrameReferenceFinder(this));
+    uint16_t pid = Rand();
+    uint16_t sn = Rand();
+    uint8_t tl0 = 0;
+    int64_t elapsed_us = 0;
+    std::vector<std::unique_ptr<RtpFrameObject>> frames;
+    for (int i = 0; i < kNumPictures; i += kBatchSize) {
+      for (int j = i; j < i + kBatchSize; ++j) {
+        const uint8_t tid = kTemporalIdx[j % 4];
+        if (j > 0 && tid == 0)
+          ++tl0;
+        for (uint8_t sid = 0; sid < kNumSpatialLayers; ++sid) {
+          frames.push_back(CreateVp9Gof(sn, sn, j == 0, pid + j, sid, tid, tl0,
+                                        false, j == 0 ? &ss : nullptr));
+          ++sn;
+        }
+      }
+      if (reordered) {
+        for (size_t j = kNumSpatialLayers; j < frames.size();
+             j += 4 * kNumSpatialLayers) {
+          std::swap_ranges(frames.begin() + j,
+                           frames.begin() + j + kNumSpatialLayers,
+                           frames.begin() + j + kNumSpatialLayers);
+        }
+      }
+
+      int64_t start_us = rtc::TimeMicros();
+      for (auto& frame : frames)
+        reference_finder_->ManageFrame(std::move(frame));
+      elapsed_us += rtc::TimeMicros() - start_us;
+      frames.clear();
+      ASSERT_EQ(kBatchSize * kNumSpatialLayers, frames_from_callback_.size());
+      frames_from_callback_.clear();
+    }
+
+    webrtc::test::PrintResult(
+        "rtp_frame_reference_finder", reordered ? "_reordered" : "",
+        "vp9_gof_3sl",
+        static_cast<size_t>(elapsed_us * 1000 /
+                            (kNumPictures * kNumSpatialLayers)),
+        "ns/frame", false);
+    webrtc::test::PrintResult(
+        "rtp_frame_reference_finder", reordered ? "_reordered" : "",
+        "attempts_per_100_frames",
+        reference_finder_->NumFrameAttempts() * 100 /
+            reference_finder_->NumManagedFrames(),
+        "attempts", false);
+  }
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_SEQ_NUM_SET_H_
+#define WEBRTC_MODULES_VIDEO_CODING_SEQ_NUM_SET_H_
+
+#include <array>
+#include <limits>
+
+#include "webrtc/modules/video_coding/sequence_number_util.h"
+#include "webrtc/rtc_base/optional.h"
+
+namespace webrtc {
+namespace video_coding {
+
+// A set of sequence numbers in the range [0, |M|), or the whole range of |T|
+// if |M| is zero, stored as one bit per possible value. Nothing is allocated,
+// and insert, erase and lookup are O(1).
+//
+// The values are ordered as sequence numbers, which requires all values in
+// the set to be within half the range of each other at any time.
+template <typename T, T M = 0>
+class SeqNumSet {
+ public:
+  static constexpr size_t kRange =
+      M == 0 ? size_t{std::numeric_limits<T>::max()} + 1 : M;
+
+  SeqNumSet() { clear(); }
+
+  void insert(T value) {
+    bits_[value / 64] |= uint64_t{1} << (value % 64);
+    if (!oldest_ || AheadOf<T, M>(*oldest_, value))
+      oldest_ = rtc::Optional<T>(value);
+  }
+
+  void erase(T value) { bits_[value / 64] &= ~(uint64_t{1} << (value % 64)); }
+
+  bool contains(T value) const {
+    return (bits_[value / 64] >> (value % 64)) & 1;
+  }
+
+  void clear() {
+    bits_.fill(0);
+    oldest_ = rtc::Optional<T>();
+  }
+
+  // Erases all values older than |value|. Only the values between the oldest
+  // inserted value and |value| are visited, so the total cost over a stream
+  // is proportional to how far the set has advanced.
+  void EraseOlderThan(T value) {
+    if (!oldest_ || !AheadOf<T, M>(value, *oldest_))
+      return;
+    for (T v = *oldest_; v != value; v = Add<kRange>(v, 1)) {
+      if (v % 64 == 0 && ForwardDiff<T, M>(v, value) >= 64) {
+        bits_[v / 64] = 0;
+        v = Add<kRange>(v, 63);
+      } else {
+        erase(v);
+      }
+    }
+    oldest_ = rtc::Optional<T>(value);
+  }
+
+  // Returns true if any value in the interval [|begin|, |end|) is in the set.
+  bool ContainsAnyInInterval(T begin, T end) const {
+    for (T v = begin; v != end; v = Add<kRange>(v, 1)) {
+      if (v % 64 == 0 && ForwardDiff<T, M>(v, end) >= 64) {
+        if (bits_[v / 64])
+          return true;
+        v = Add<kRange>(v, 63);
+      } else if (contains(v)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static_assert(kRange % 64 == 0, "Range must be a multiple of 64.");
+
+  std::array<uint64_t, kRange / 64> bits_;
+  // Lower bound of the values in the set, for EraseOlderThan().
+  rtc::Optional<T> oldest_;
+};
+
+template <typename T, T M>
+constexpr size_t SeqNumSet<T, M>::kRange;
+
+}  // namespace video_coding
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_SEQ_NUM_SET_H_
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/seq_num_set.h"
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace video_coding {
+
+TEST(SeqNumSetTest, InsertAndErase) {
+  SeqNumSet<uint16_t> set;
+  EXPECT_FALSE(set.contains(0));
+  set.insert(0);
+  set.insert(65535);
+  EXPECT_TRUE(set.contains(0));
+  EXPECT_TRUE(set.contains(65535));
+  EXPECT_FALSE(set.contains(1));
+  set.erase(0);
+  EXPECT_FALSE(set.contains(0));
+  set.clear();
+  EXPECT_FALSE(set.contains(65535));
+}
+
+TEST(SeqNumSetTest, EraseOlderThanWraps) {
+  SeqNumSet<uint16_t, 1 << 15> set;
+  for (uint16_t v = 32700; v < 32768; ++v)
+    set.insert(v);
+  for (uint16_t v = 0; v < 100; ++v)
+    set.insert(v);
+
+  set.EraseOlderThan(20);
+  EXPECT_FALSE(set.contains(32700));
+  EXPECT_FALSE(set.contains(32767));
+  EXPECT_FALSE(set.contains(19));
+  EXPECT_TRUE(set.contains(20));
+  EXPECT_TRUE(set.contains(99));
+
+  // Older than what has already been erased; nothing happens.
+  set.EraseOlderThan(10);
+  EXPECT_TRUE(set.contains(20));
+}
+
+TEST(SeqNumSetTest, ContainsAnyInInterval) {
+  SeqNumSet<uint8_t> set;
+  set.insert(250);
+  EXPECT_TRUE(set.ContainsAnyInInterval(200, 10));
+  EXPECT_TRUE(set.ContainsAnyInInterval(250, 251));
+  EXPECT_FALSE(set.ContainsAnyInInterval(251, 10));
+  EXPECT_FALSE(set.ContainsAnyInInterval(0, 250));
+  EXPECT_FALSE(set.ContainsAnyInInterval(250, 250));
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
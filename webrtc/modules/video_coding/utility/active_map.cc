@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/utility/active_map.h"
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kMacroblockSize = 16;
+
+// Scaling filters spread a change up to about a pixel around it, so scaled
+// areas are grown by this much.
+const int kScaledMargin = 1;
+
+}  // namespace
+
+ActiveMap::ActiveMap(int width, int height, int scaled_width, int scaled_height)
+    : width_(width),
+      height_(height),
+      scaled_width_(scaled_width),
+      scaled_height_(scaled_height),
+      mb_rows_((scaled_height + kMacroblockSize - 1) / kMacroblockSize),
+      mb_cols_((scaled_width + kMacroblockSize - 1) / kMacroblockSize),
+      updated_area_{0, 0, width, height},
+      map_(mb_rows_ * mb_cols_) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+}
+
+void ActiveMap::AddFrame(const VideoFrame& frame) {
+  if (frame.width() != width_ || frame.height() != height_) {
+    updated_area_ = VideoFrame::UpdateRect{0, 0, width_, height_};
+    return;
+  }
+  updated_area_.Union(frame.update_rect());
+}
+
+void ActiveMap::OnReferenceUpdated() {
+  updated_area_ = VideoFrame::UpdateRect{0, 0, 0, 0};
+}
+
+const uint8_t* ActiveMap::GetMap() {
+  const int left = std::max(updated_area_.offset_x, 0);
+  const int top = std::max(updated_area_.offset_y, 0);
+  const int right =
+      std::min(updated_area_.offset_x + updated_area_.width, width_);
+  const int bottom =
+      std::min(updated_area_.offset_y + updated_area_.height, height_);
+  if (left == 0 && top == 0 && right == width_ && bottom == height_)
+    return nullptr;
+
+  std::fill(map_.begin(), map_.end(), 0);
+  if (left >= right || top >= bottom)
+    return map_.data();
+
+  // Rounds outwards to the scaled pixels which the area touches.
+  int scaled_left = left * scaled_width_ / width_;
+  int scaled_top = top * scaled_height_ / height_;
+  int scaled_right = (right * scaled_width_ + width_ - 1) / width_;
+  int scaled_bottom = (bottom * scaled_height_ + height_ - 1) / height_;
+  if (scaled_width_ != width_ || scaled_height_ != height_) {
+    scaled_left = std::max(scaled_left - kScaledMargin, 0);
+    scaled_top = std::max(scaled_top - kScaledMargin, 0);
+    scaled_right = std::min(scaled_right + kScaledMargin, scaled_width_);
+    scaled_bottom = std::min(scaled_bottom + kScaledMargin, scaled_height_);
+  }
+
+  const int first_col = scaled_left / kMacroblockSize;
+  const int first_row = scaled_top / kMacroblockSize;
+  const int end_col = (scaled_right + kMacroblockSize - 1) / kMacroblockSize;
+  const int end_row = (scaled_bottom + kMacroblockSize - 1) / kMacroblockSize;
+  for (int row = first_row; row < end_row; ++row) {
+    std::fill(map_.begin() + row * mb_cols_ + first_col,
+              map_.begin() + row * mb_cols_ + end_col, 1);
+  }
+  return map_.data();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_UTILITY_ACTIVE_MAP_H_
+#define WEBRTC_MODULES_VIDEO_CODING_UTILITY_ACTIVE_MAP_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "webrtc/api/video/video_frame.h"
+
+namespace webrtc {
+
+// Tracks the area of the input which changed since an encoder last updated the
+// reference frame it predicts from, and makes a map of the 16x16 macroblocks
+// which overlap that area. Other macroblocks can be coded as skipped, e.g. by
+// passing the map to libvpx as an active map. Frames which the encoder drops
+// must still be added, since their changes aren't in the reference either.
+class ActiveMap {
+ public:
+  // |width| x |height| is the size of the input frames, and |scaled_width| x
+  // |scaled_height| the size at which they are encoded.
+  ActiveMap(int width, int height, int scaled_width, int scaled_height);
+
+  // Adds the update_rect() of a frame given to the encoder.
+  void AddFrame(const VideoFrame& frame);
+  // To be called when a frame was encoded into the reference, after which only
+  // later changes need to be coded.
+  void OnReferenceUpdated();
+
+  // Returns the map, row by row, with 1 for the macroblocks which need to be
+  // coded and 0 for the others, or nullptr if all need to be coded.
+  const uint8_t* GetMap();
+  int mb_rows() const { return mb_rows_; }
+  int mb_cols() const { return mb_cols_; }
+
+ private:
+  const int width_;
+  const int height_;
+  const int scaled_width_;
+  const int scaled_height_;
+  const int mb_rows_;
+  const int mb_cols_;
+  // In input coordinates.
+  VideoFrame::UpdateRect updated_area_;
+  std::vector<uint8_t> map_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_UTILITY_ACTIVE_MAP_H_
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/utility/active_map.h"
+
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+VideoFrame CreateFrame(int width, int height) {
+  return VideoFrame(I420Buffer::Create(width, height), kVideoRotation_0, 0);
+}
+
+VideoFrame CreateFrame(int width,
+                       int height,
+                       const VideoFrame::UpdateRect& update_rect) {
+  VideoFrame frame = CreateFrame(width, height);
+  frame.set_update_rect(update_rect);
+  return frame;
+}
+
+// Returns the number of macroblocks marked active in |map|.
+int CountActive(const ActiveMap& map, const uint8_t* data) {
+  int count = 0;
+  for (int i = 0; i < map.mb_rows() * map.mb_cols(); ++i)
+    count += data[i];
+  return count;
+}
+
+}  // namespace
+
+TEST(ActiveMapTest, AllActiveUntilReferenceUpdated) {
+  ActiveMap map(64, 48, 64, 48);
+  EXPECT_EQ(3, map.mb_rows());
+  EXPECT_EQ(4, map.mb_cols());
+  EXPECT_EQ(nullptr, map.GetMap());
+  map.AddFrame(CreateFrame(64, 48, VideoFrame::UpdateRect{0, 0, 1, 1}));
+  EXPECT_EQ(nullptr, map.GetMap());
+}
+
+TEST(ActiveMapTest, FrameWithoutUpdateRectIsAllActive) {
+  ActiveMap map(64, 48, 64, 48);
+  map.OnReferenceUpdated();
+  map.AddFrame(CreateFrame(64, 48));
+  EXPECT_EQ(nullptr, map.GetMap());
+}
+
+TEST(ActiveMapTest, UnchangedFrameIsAllInactive) {
+  ActiveMap map(64, 48, 64, 48);
+  map.OnReferenceUpdated();
+  map.AddFrame(CreateFrame(64, 48, VideoFrame::UpdateRect{0, 0, 0, 0}));
+  const uint8_t* data = map.GetMap();
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(0, CountActive(map, data));
+}
+
+TEST(ActiveMapTest, MarksOverlappedMacroblocks) {
+  ActiveMap map(64, 48, 64, 48);
+  map.OnReferenceUpdated();
+  // Overlaps the macroblocks in columns 1 and 2 of row 1.
+  map.AddFrame(CreateFrame(64, 48, VideoFrame::UpdateRect{20, 16, 20, 16}));
+  const uint8_t* data = map.GetMap();
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(2, CountActive(map, data));
+  EXPECT_EQ(1, data[1 * 4 + 1]);
+  EXPECT_EQ(1, data[1 * 4 + 2]);
+}
+
+TEST(ActiveMapTest, AccumulatesUntilReferenceUpdated) {
+  ActiveMap map(64, 48, 64, 48);
+  map.OnReferenceUpdated();
+  map.AddFrame(CreateFrame(64, 48, VideoFrame::UpdateRect{0, 0, 16, 16}));
+  // E.g. the frame above was dropped by the encoder.
+  map.AddFrame(CreateFrame(64, 48, VideoFrame::UpdateRect{16, 0, 16, 16}));
+  const uint8_t* data = map.GetMap();
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(2, CountActive(map, data));
+  EXPECT_EQ(1, data[0]);
+  EXPECT_EQ(1, data[1]);
+
+  map.OnReferenceUpdated();
+  map.AddFrame(CreateFrame(64, 48, VideoFrame::UpdateRect{48, 32, 16, 16}));
+  data = map.GetMap();
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(1, CountActive(map, data));
+  EXPECT_EQ(1, data[2 * 4 + 3]);
+}
+
+TEST(ActiveMapTest, ScaledAreaIsGrown) {
+  // Half the input size, so an area of 32x32 input pixels starting at (64, 64)
+  // scales to exactly one macroblock, which grows into its neighbours.
+  ActiveMap map(128, 128, 64, 64);
+  map.OnReferenceUpdated();
+  map.AddFrame(CreateFrame(128, 128, VideoFrame::UpdateRect{64, 64, 32, 32}));
+  const uint8_t* data = map.GetMap();
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(9, CountActive(map, data));
+  for (int row = 1; row <= 3; ++row) {
+    for (int col = 1; col <= 3; ++col)
+      EXPECT_EQ(1, data[row * 4 + col]);
+  }
+}
+
+}  // namespace webrtc
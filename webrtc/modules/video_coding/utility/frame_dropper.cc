@@ -48,6 +48,7 @@ FrameDropper::FrameDropper()
       delta_frame_size_avg_kbits_(kDefaultFrameSizeAlpha),
       drop_ratio_(kDefaultDropRatioAlpha, kDefaultDropRatioValue),
       enabled_(true),
+      lookahead_enabled_(false),
       max_drop_duration_secs_(kDefaultMaxDropDurationSecs) {
   Reset();
 }
@@ -57,6 +58,7 @@ FrameDropper::FrameDropper(float max_drop_duration_secs)
       delta_frame_size_avg_kbits_(kDefaultFrameSizeAlpha),
       drop_ratio_(kDefaultDropRatioAlpha, kDefaultDropRatioValue),
       enabled_(true),
+      lookahead_enabled_(false),
       max_drop_duration_secs_(max_drop_duration_secs) {
   Reset();
 }
@@ -79,6 +81,7 @@ void FrameDropper::Reset() {
   drop_ratio_.Reset(0.9f);
   drop_ratio_.Apply(0.0f, 0.0f);
   drop_count_ = 0;
+  lookahead_drop_count_ = 0;
   was_below_max_ = true;
 }
 
@@ -86,6 +89,11 @@ void FrameDropper::Enable(bool enable) {
   enabled_ = enable;
 }
 
+void FrameDropper::EnableLookahead(bool enable) {
+  lookahead_enabled_ = enable;
+  lookahead_drop_count_ = 0;
+}
+
 void FrameDropper::Fill(size_t framesize_bytes, bool delta_frame) {
   if (!enabled_) {
     return;
@@ -186,6 +194,9 @@ bool FrameDropper::DropFrame() {
   if (!enabled_) {
     return false;
   }
+  if (LookaheadDropFrame()) {
+    return true;
+  }
   if (drop_next_) {
     drop_next_ = false;
     drop_count_ = 0;
@@ -253,6 +264,30 @@ bool FrameDropper::DropFrame() {
   return false;
 }
 
+bool FrameDropper::LookaheadDropFrame() {
+  if (!lookahead_enabled_) {
+    return false;
+  }
+  float predicted_frame_kbits = delta_frame_size_avg_kbits_.filtered();
+  if (predicted_frame_kbits < 0.0f) {
+    // No delta frame seen yet.
+    return false;
+  }
+  if (large_frame_accumulation_count_ > 0) {
+    predicted_frame_kbits += large_frame_accumulation_chunk_size_;
+  }
+  // Same bound on the number of frames dropped in a row as for the drop ratio.
+  int max_drops =
+      static_cast<int>(incoming_frame_rate_ * max_drop_duration_secs_);
+  if (accumulator_ + predicted_frame_kbits > accumulator_max_ &&
+      lookahead_drop_count_ < max_drops) {
+    ++lookahead_drop_count_;
+    return true;
+  }
+  lookahead_drop_count_ = 0;
+  return false;
+}
+
 void FrameDropper::SetRates(float bitrate, float incoming_frame_rate) {
   // Bit rate of -1 means infinite bandwidth.
   accumulator_max_ = bitrate * kLeakyBucketSizeSeconds;
@@ -33,6 +33,12 @@ class FrameDropper {
   virtual void Reset();
 
   virtual void Enable(bool enable);
+  // In lookahead mode, DropFrame() also drops the frame when the bucket can't
+  // take a frame of the predicted size, the average delta frame size plus any
+  // pending large frame chunk, without going above its max. This drops before
+  // the encoder overshoots instead of after, which saves encoding frames that
+  // would be dropped later anyway, e.g. after a scene cut in screenshare.
+  virtual void EnableLookahead(bool enable);
   // Answers the question if it's time to drop a frame
   // if we want to reach a given frame rate. Must be
   // called for every frame.
@@ -63,6 +69,7 @@ class FrameDropper {
  private:
   void UpdateRatio();
   void CapAccumulator();
+  bool LookaheadDropFrame();
 
   rtc::ExpFilter key_frame_ratio_;
   rtc::ExpFilter delta_frame_size_avg_kbits_;
@@ -91,6 +98,9 @@ class FrameDropper {
   float incoming_frame_rate_;
   bool was_below_max_;
   bool enabled_;
+  bool lookahead_enabled_;
+  // Number of frames dropped in a row by lookahead.
+  int lookahead_drop_count_;
   const float max_drop_duration_secs_;
 };
 
@@ -129,6 +129,27 @@ TEST_F(FrameDropperTest, NoDropsWhenFillRateMatchesLeakRate) {
   }
 }
 
+TEST_F(FrameDropperTest, LookaheadDropsBeforeBucketOverflows) {
+  FrameDropper lookahead_frame_dropper;
+  lookahead_frame_dropper.SetRates(kTargetBitRateKbps, kIncomingFrameRate);
+  lookahead_frame_dropper.EnableLookahead(true);
+  // Fill the bucket up to its max, which doesn't yet cause a drop.
+  const int kFramesToFillBucket =
+      kTargetBitRateKbps / 2 / (kFrameSizeBytes * 8 / 1000) + 1;
+  for (int i = 0; i < kFramesToFillBucket; ++i) {
+    frame_dropper_.Fill(kFrameSizeBytes, true);
+    lookahead_frame_dropper.Fill(kFrameSizeBytes, true);
+  }
+  frame_dropper_.Leak(kIncomingFrameRate);
+  lookahead_frame_dropper.Leak(kIncomingFrameRate);
+  EXPECT_FALSE(frame_dropper_.DropFrame());
+  // Another frame of the same size would overflow the bucket.
+  EXPECT_TRUE(lookahead_frame_dropper.DropFrame());
+  // Once the bucket has leaked enough for one more frame, it's kept.
+  lookahead_frame_dropper.Leak(kIncomingFrameRate);
+  EXPECT_FALSE(lookahead_frame_dropper.DropFrame());
+}
+
 TEST_F(FrameDropperTest, LargeKeyFrames) {
   ValidateNoDropsAtTargetBitrate(kLargeFrameSizeBytes, 1, false);
   frame_dropper_.Reset();
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/utility/shared_decoder_buffer_pool.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "webrtc/system_wrappers/include/field_trial.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kSharedDecoderBufferPoolFieldTrial[] =
+    "WebRTC-SharedDecoderBufferPool";
+// Used if the group doesn't set a cap, enough for about 80 free 1080p frames.
+const size_t kDefaultMaxPooledBytes = 256 * 1024 * 1024;
+
+}  // namespace
+
+rtc::Optional<size_t> GetSharedDecoderBufferPoolMaxPooledBytes() {
+  if (!field_trial::IsEnabled(kSharedDecoderBufferPoolFieldTrial))
+    return rtc::Optional<size_t>();
+
+  std::string group =
+      field_trial::FindFullName(kSharedDecoderBufferPoolFieldTrial);
+  int max_pooled_mb;
+  if (sscanf(group.c_str(), "Enabled-%d", &max_pooled_mb) != 1 ||
+      max_pooled_mb < 0) {
+    return rtc::Optional<size_t>(kDefaultMaxPooledBytes);
+  }
+  return rtc::Optional<size_t>(static_cast<size_t>(max_pooled_mb) * 1024 *
+                               1024);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,31 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_UTILITY_SHARED_DECODER_BUFFER_POOL_H_
+#define WEBRTC_MODULES_VIDEO_CODING_UTILITY_SHARED_DECODER_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#include "webrtc/rtc_base/optional.h"
+
+namespace webrtc {
+
+// With the WebRTC-SharedDecoderBufferPool field trial, all decoders of a codec
+// in the process decode into one buffer pool instead of one pool each, so that
+// a process running many decoders keeps less memory in free buffers. The group
+// "Enabled-<megabytes>" caps the memory held by the free buffers of each
+// codec's pool.
+// Returns the cap in bytes if the field trial is enabled, or nothing if each
+// decoder should use its own pool.
+rtc::Optional<size_t> GetSharedDecoderBufferPoolMaxPooledBytes();
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_UTILITY_SHARED_DECODER_BUFFER_POOL_H_
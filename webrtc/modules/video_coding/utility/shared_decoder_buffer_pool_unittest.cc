@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/utility/shared_decoder_buffer_pool.h"
+
+#include "webrtc/test/field_trial.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+TEST(SharedDecoderBufferPoolTest, DisabledByDefault) {
+  EXPECT_FALSE(GetSharedDecoderBufferPoolMaxPooledBytes());
+}
+
+TEST(SharedDecoderBufferPoolTest, ParsesMaxPooledBytes) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SharedDecoderBufferPool/Enabled-64/");
+  EXPECT_EQ(rtc::Optional<size_t>(64 * 1024 * 1024),
+            GetSharedDecoderBufferPoolMaxPooledBytes());
+}
+
+TEST(SharedDecoderBufferPoolTest, UsesDefaultCapWithoutValue) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SharedDecoderBufferPool/Enabled/");
+  rtc::Optional<size_t> max_pooled_bytes =
+      GetSharedDecoderBufferPoolMaxPooledBytes();
+  ASSERT_TRUE(max_pooled_bytes);
+  EXPECT_GT(*max_pooled_bytes, 0u);
+}
+
+}  // namespace webrtc
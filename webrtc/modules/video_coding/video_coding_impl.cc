@@ -11,21 +11,31 @@
 #include "webrtc/modules/video_coding/video_coding_impl.h"
 
 #include <algorithm>
+#include <cstring>
 #include <utility>
+#include <vector>
 
 #include "webrtc/common_types.h"
 #include "webrtc/common_video/include/video_bitrate_allocator.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
 #include "webrtc/modules/video_coding/encoded_frame.h"
+#include "webrtc/modules/video_coding/frame_buffer2.h"
+#include "webrtc/modules/video_coding/frame_object.h"
+#include "webrtc/modules/video_coding/h264_sps_pps_tracker.h"
 #include "webrtc/modules/video_coding/include/video_codec_initializer.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
 #include "webrtc/modules/video_coding/jitter_buffer.h"
+#include "webrtc/modules/video_coding/jitter_estimator.h"
+#include "webrtc/modules/video_coding/nack_module.h"
 #include "webrtc/modules/video_coding/packet.h"
+#include "webrtc/modules/video_coding/packet_buffer.h"
+#include "webrtc/modules/video_coding/rtp_frame_reference_finder.h"
 #include "webrtc/modules/video_coding/timing.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/thread_checker.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/typedefs.h"
 
 namespace webrtc {
 namespace vcm {
@@ -75,13 +85,175 @@ class EncodedImageCallbackWrapper : public EncodedImageCallback {
   EncodedImageCallback* callback_ GUARDED_BY(cs_);
 };
 
+// Receive path of VideoCodingModule::CreateWithFrameBuffer(). Packets are
+// assembled into frames by a PacketBuffer and RtpFrameReferenceFinder and
+// scheduled for decoding by a FrameBuffer, the same way as in
+// VideoReceiveStream. Payloads are copied once into the packet buffer, and a
+// frame's bitstream is only assembled right before it is decoded.
+class FrameBufferReceiver : public video_coding::OnReceivedFrameCallback,
+                            public video_coding::OnCompleteFrameCallback,
+                            public NackSender,
+                            public KeyFrameRequestSender {
+ public:
+  FrameBufferReceiver(Clock* clock,
+                      VCMTiming* timing,
+                      vcm::VideoReceiver* receiver)
+      : clock_(clock),
+        timing_(timing),
+        receiver_(receiver),
+        jitter_estimator_(clock),
+        frame_buffer_(clock, &jitter_estimator_, timing, nullptr),
+        nack_module_(clock, this, this),
+        packet_request_callback_(nullptr),
+        has_received_frame_(false) {
+    packet_buffer_ = video_coding::PacketBuffer::Create(
+        clock, kPacketBufferStartSize, kPacketBufferMaxSize, this);
+    packet_buffer_->SetDeferBitstreamCopy(true);
+    reference_finder_.reset(new video_coding::RtpFrameReferenceFinder(this));
+  }
+
+  ~FrameBufferReceiver() override { frame_buffer_.Stop(); }
+
+  int32_t IncomingPacket(const uint8_t* incoming_payload,
+                         size_t payload_length,
+                         const WebRtcRTPHeader& rtp_info) {
+    if (incoming_payload == nullptr)
+      payload_length = 0;
+    VCMPacket packet(incoming_payload, payload_length, rtp_info);
+    packet.timesNacked = nack_module_.OnReceivedPacket(packet);
+    packet.receive_time_ms = clock_->TimeInMilliseconds();
+
+    // Padding is needed to calculate the references of frames without
+    // picture ids.
+    if (packet.sizeBytes == 0) {
+      reference_finder_->PaddingReceived(packet.seqNum);
+      packet_buffer_->PaddingReceived(packet.seqNum);
+      return VCM_OK;
+    }
+
+    if (packet.codec == kVideoCodecH264) {
+      switch (tracker_.CopyAndFixBitstream(&packet)) {
+        case video_coding::H264SpsPpsTracker::kRequestKeyframe:
+          RequestKeyFrame();
+          FALLTHROUGH();
+        case video_coding::H264SpsPpsTracker::kDrop:
+          return VCM_OK;
+        case video_coding::H264SpsPpsTracker::kInsert:
+          break;
+      }
+    } else {
+      uint8_t* data = new uint8_t[packet.sizeBytes];
+      memcpy(data, packet.dataPtr, packet.sizeBytes);
+      packet.dataPtr = data;
+    }
+
+    packet_buffer_->InsertPacket(&packet);
+    return VCM_OK;
+  }
+
+  int32_t Decode(uint16_t max_wait_time_ms) {
+    std::unique_ptr<video_coding::FrameObject> frame;
+    if (frame_buffer_.NextFrame(max_wait_time_ms, &frame) !=
+        video_coding::FrameBuffer::ReturnReason::kFrameFound) {
+      return VCM_FRAME_NOT_READY;
+    }
+    if (!frame->AssembleBitstream()) {
+      RequestKeyFrame();
+      return VCM_FRAME_NOT_READY;
+    }
+    const int32_t ret = receiver_->Decode(frame.get());
+    if (ret != VCM_OK) {
+      RequestKeyFrame();
+      return ret;
+    }
+    // Packets up to the decoded frame will not be needed anymore.
+    const uint16_t last_seq_num =
+        static_cast<video_coding::RtpFrameObject*>(frame.get())
+            ->last_seq_num();
+    nack_module_.ClearUpTo(last_seq_num);
+    packet_buffer_->ClearTo(last_seq_num);
+    reference_finder_->ClearTo(last_seq_num);
+    return VCM_OK;
+  }
+
+  void SetProtectionMode(VCMVideoProtection mode) {
+    frame_buffer_.SetProtectionMode(mode);
+  }
+
+  void UpdateRtt(int64_t rtt_ms) { nack_module_.UpdateRtt(rtt_ms); }
+
+  void RegisterPacketRequestCallback(VCMPacketRequestCallback* callback) {
+    rtc::CritScope lock(&crit_);
+    packet_request_callback_ = callback;
+  }
+
+  void Stop() { frame_buffer_.Stop(); }
+
+  NackModule* nack_module() { return &nack_module_; }
+
+  // Implements OnReceivedFrameCallback.
+  void OnReceivedFrame(
+      std::unique_ptr<video_coding::RtpFrameObject> frame) override {
+    if (!has_received_frame_) {
+      has_received_frame_ = true;
+      if (frame->FrameType() != kVideoFrameKey)
+        RequestKeyFrame();
+    }
+    if (!frame->delayed_by_retransmission())
+      timing_->IncomingTimestamp(frame->timestamp, clock_->TimeInMilliseconds());
+    reference_finder_->ManageFrame(std::move(frame));
+  }
+
+  // Implements OnCompleteFrameCallback.
+  void OnCompleteFrame(
+      std::unique_ptr<video_coding::FrameObject> frame) override {
+    frame_buffer_.InsertFrame(std::move(frame));
+  }
+
+  // Implements NackSender.
+  void SendNack(const std::vector<uint16_t>& sequence_numbers) override {
+    rtc::CritScope lock(&crit_);
+    if (packet_request_callback_ && !sequence_numbers.empty()) {
+      packet_request_callback_->ResendPackets(&sequence_numbers[0],
+                                              sequence_numbers.size());
+    }
+  }
+
+  // Implements KeyFrameRequestSender.
+  void RequestKeyFrame() override { receiver_->RequestKeyFrame(); }
+
+ private:
+  static constexpr size_t kPacketBufferStartSize = 32;
+  static constexpr size_t kPacketBufferMaxSize = 2048;
+
+  Clock* const clock_;
+  VCMTiming* const timing_;
+  vcm::VideoReceiver* const receiver_;
+  VCMJitterEstimator jitter_estimator_;
+  video_coding::FrameBuffer frame_buffer_;
+  NackModule nack_module_;
+  rtc::scoped_refptr<video_coding::PacketBuffer> packet_buffer_;
+  std::unique_ptr<video_coding::RtpFrameReferenceFinder> reference_finder_;
+
+  rtc::CriticalSection crit_;
+  VCMPacketRequestCallback* packet_request_callback_ GUARDED_BY(crit_);
+
+  // Only accessed on the thread calling IncomingPacket().
+  video_coding::H264SpsPpsTracker tracker_;
+  bool has_received_frame_;
+};
+
+constexpr size_t FrameBufferReceiver::kPacketBufferStartSize;
+constexpr size_t FrameBufferReceiver::kPacketBufferMaxSize;
+
 class VideoCodingModuleImpl : public VideoCodingModule {
  public:
   VideoCodingModuleImpl(Clock* clock,
                         EventFactory* event_factory,
                         NackSender* nack_sender,
                         KeyFrameRequestSender* keyframe_request_sender,
-                        EncodedImageCallback* pre_decode_image_callback)
+                        EncodedImageCallback* pre_decode_image_callback,
+                        bool use_frame_buffer)
       : VideoCodingModule(),
         sender_(clock, &post_encode_callback_, nullptr),
         timing_(new VCMTiming(clock)),
@@ -90,7 +262,12 @@ class VideoCodingModuleImpl : public VideoCodingModule {
                   pre_decode_image_callback,
                   timing_.get(),
                   nack_sender,
-                  keyframe_request_sender) {}
+                  keyframe_request_sender) {
+    if (use_frame_buffer) {
+      frame_buffer_receiver_.reset(
+          new FrameBufferReceiver(clock, timing_.get(), &receiver_));
+    }
+  }
 
   virtual ~VideoCodingModuleImpl() {}
 
@@ -99,12 +276,19 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     int64_t receiver_time = receiver_.TimeUntilNextProcess();
     RTC_DCHECK_GE(sender_time, 0);
     RTC_DCHECK_GE(receiver_time, 0);
+    if (frame_buffer_receiver_) {
+      receiver_time = VCM_MIN(
+          receiver_time,
+          frame_buffer_receiver_->nack_module()->TimeUntilNextProcess());
+    }
     return VCM_MIN(sender_time, receiver_time);
   }
 
   void Process() override {
     sender_.Process();
     receiver_.Process();
+    if (frame_buffer_receiver_)
+      frame_buffer_receiver_->nack_module()->Process();
   }
 
   int32_t RegisterSendCodec(const VideoCodec* sendCodec,
@@ -159,6 +343,10 @@ class VideoCodingModuleImpl : public VideoCodingModule {
   int32_t SetVideoProtection(VCMVideoProtection videoProtection,
                              bool enable) override {
     // TODO(pbos): Remove enable from receive-side protection modes as well.
+    if (frame_buffer_receiver_) {
+      frame_buffer_receiver_->SetProtectionMode(videoProtection);
+      return VCM_OK;
+    }
     return receiver_.SetVideoProtection(videoProtection, enable);
   }
 
@@ -206,16 +394,24 @@ class VideoCodingModuleImpl : public VideoCodingModule {
   int32_t RegisterPacketRequestCallback(
       VCMPacketRequestCallback* callback) override {
     RTC_DCHECK(construction_thread_.CalledOnValidThread());
+    if (frame_buffer_receiver_)
+      frame_buffer_receiver_->RegisterPacketRequestCallback(callback);
     return receiver_.RegisterPacketRequestCallback(callback);
   }
 
   int32_t Decode(uint16_t maxWaitTimeMs) override {
+    if (frame_buffer_receiver_)
+      return frame_buffer_receiver_->Decode(maxWaitTimeMs);
     return receiver_.Decode(maxWaitTimeMs);
   }
 
   int32_t IncomingPacket(const uint8_t* incomingPayload,
                          size_t payloadLength,
                          const WebRtcRTPHeader& rtpInfo) override {
+    if (frame_buffer_receiver_) {
+      return frame_buffer_receiver_->IncomingPacket(incomingPayload,
+                                                    payloadLength, rtpInfo);
+    }
     return receiver_.IncomingPacket(incomingPayload, payloadLength, rtpInfo);
   }
 
@@ -250,6 +446,8 @@ class VideoCodingModuleImpl : public VideoCodingModule {
   }
 
   int32_t SetReceiveChannelParameters(int64_t rtt) override {
+    if (frame_buffer_receiver_)
+      frame_buffer_receiver_->UpdateRtt(rtt);
     return receiver_.SetReceiveChannelParameters(rtt);
   }
 
@@ -258,7 +456,11 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     post_encode_callback_.Register(observer);
   }
 
-  void TriggerDecoderShutdown() override { receiver_.TriggerDecoderShutdown(); }
+  void TriggerDecoderShutdown() override {
+    if (frame_buffer_receiver_)
+      frame_buffer_receiver_->Stop();
+    receiver_.TriggerDecoderShutdown();
+  }
 
  private:
   rtc::ThreadChecker construction_thread_;
@@ -267,6 +469,10 @@ class VideoCodingModuleImpl : public VideoCodingModule {
   std::unique_ptr<VideoBitrateAllocator> rate_allocator_;
   std::unique_ptr<VCMTiming> timing_;
   vcm::VideoReceiver receiver_;
+  // Set when created with CreateWithFrameBuffer(), in which case it replaces
+  // the VCMJitterBuffer inside |receiver_| for receiving and scheduling
+  // frames.
+  std::unique_ptr<FrameBufferReceiver> frame_buffer_receiver_;
 };
 }  // namespace
 
@@ -277,7 +483,16 @@ VideoCodingModule* VideoCodingModule::Create(Clock* clock,
   RTC_DCHECK(clock);
   RTC_DCHECK(event_factory);
   return new VideoCodingModuleImpl(clock, event_factory, nullptr, nullptr,
-                                   nullptr);
+                                   nullptr, false);
+}
+
+VideoCodingModule* VideoCodingModule::CreateWithFrameBuffer(
+    Clock* clock,
+    EventFactory* event_factory) {
+  RTC_DCHECK(clock);
+  RTC_DCHECK(event_factory);
+  return new VideoCodingModuleImpl(clock, event_factory, nullptr, nullptr,
+                                   nullptr, true);
 }
 
 }  // namespace webrtc
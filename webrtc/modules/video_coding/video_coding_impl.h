@@ -130,6 +130,9 @@ class VideoSender : public Module {
   VCMSendStatisticsCallback* const send_stats_callback_;
   VCMCodecDataBase _codecDataBase GUARDED_BY(encoder_crit_);
   bool frame_dropper_enabled_ GUARDED_BY(encoder_crit_);
+  // The union of the update rects of the frames dropped since the last one
+  // was given to the encoder.
+  VideoFrame::UpdateRect dropped_update_rect_ GUARDED_BY(encoder_crit_);
   VCMProcessTimer _sendStatsTimer;
 
   // Must be accessed on the construction thread of VideoSender.
@@ -198,10 +201,11 @@ class VideoReceiver : public Module {
 
   void TriggerDecoderShutdown();
 
+  int32_t RequestKeyFrame();
+
  protected:
   int32_t Decode(const webrtc::VCMEncodedFrame& frame)
       EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
-  int32_t RequestKeyFrame();
 
  private:
   rtc::ThreadChecker construction_thread_;
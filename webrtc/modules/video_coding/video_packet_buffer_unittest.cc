@@ -239,6 +239,25 @@ TEST_F(TestPacketBuffer, ExpandBufferOverflow) {
   EXPECT_TRUE(Insert(seq_num + kMaxSize + 1, kKeyFrame, kFirst, kLast));
 }
 
+TEST_F(TestPacketBuffer, MemoryUsageFollowsCapacityAndPayloads) {
+  const uint16_t seq_num = Rand();
+  const size_t empty_bytes = packet_buffer_->MemoryUsageBytes();
+  EXPECT_LT(0u, empty_bytes);
+
+  // Payloads of incomplete frames are accounted for until they are released.
+  uint8_t* data = new uint8_t[100];
+  EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kNotLast, 100, data));
+  EXPECT_EQ(empty_bytes + 100, packet_buffer_->MemoryUsageBytes());
+
+  // Growing the buffer doubles the slot capacity.
+  for (int i = 1; i <= kStartSize; ++i)
+    EXPECT_TRUE(Insert(seq_num + i, kKeyFrame, kNotFirst, kNotLast));
+  EXPECT_EQ(2 * empty_bytes + 100, packet_buffer_->MemoryUsageBytes());
+
+  packet_buffer_->Clear();
+  EXPECT_EQ(2 * empty_bytes, packet_buffer_->MemoryUsageBytes());
+}
+
 TEST_F(TestPacketBuffer, OnePacketOneFrame) {
   const uint16_t seq_num = Rand();
   EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kLast));
@@ -550,6 +569,50 @@ TEST_F(TestPacketBuffer, InvalidateFrameByClearing) {
   EXPECT_FALSE(frames_from_callback_.begin()->second->GetBitstream(nullptr));
 }
 
+TEST_F(TestPacketBuffer, DeferredBitstreamCopy) {
+  packet_buffer_->SetDeferBitstreamCopy(true);
+  uint8_t first_data[] = {0x01, 0x02, 0x03};
+  uint8_t last_data[] = {0x04, 0x05};
+  uint8_t* first = new uint8_t[sizeof(first_data)];
+  uint8_t* last = new uint8_t[sizeof(last_data)];
+  memcpy(first, first_data, sizeof(first_data));
+  memcpy(last, last_data, sizeof(last_data));
+
+  const uint16_t seq_num = Rand();
+  EXPECT_TRUE(
+      Insert(seq_num, kKeyFrame, kFirst, kNotLast, sizeof(first_data), first));
+  EXPECT_TRUE(Insert(seq_num + 1, kKeyFrame, kNotFirst, kLast,
+                     sizeof(last_data), last));
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  RtpFrameObject* frame = frames_from_callback_[seq_num].get();
+  EXPECT_EQ(sizeof(first_data) + sizeof(last_data), frame->size());
+  EXPECT_EQ(nullptr, frame->Buffer());
+
+  // The packets of the frame are kept until the frame is destroyed.
+  packet_buffer_->ClearTo(seq_num + 1);
+  ASSERT_TRUE(frame->AssembleBitstream());
+  uint8_t expected[] = {0x01, 0x02, 0x03, 0x04, 0x05};
+  EXPECT_EQ(memcmp(frame->Buffer(), expected, sizeof(expected)), 0);
+
+  // The slots are free again once the frame is gone.
+  frames_from_callback_.clear();
+  EXPECT_FALSE(Insert(seq_num + 1, kKeyFrame, kFirst, kLast));
+  EXPECT_TRUE(Insert(seq_num + 2, kKeyFrame, kFirst, kLast));
+  CheckFrame(seq_num + 2);
+}
+
+TEST_F(TestPacketBuffer, DeferredBitstreamCopyInvalidatedByClearing) {
+  packet_buffer_->SetDeferBitstreamCopy(true);
+  const uint16_t seq_num = Rand();
+
+  EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kLast, 1, new uint8_t[1]));
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+
+  packet_buffer_->Clear();
+  EXPECT_FALSE(frames_from_callback_.begin()->second->AssembleBitstream());
+  EXPECT_EQ(nullptr, frames_from_callback_.begin()->second->Buffer());
+}
+
 TEST_F(TestPacketBuffer, FramesAfterClear) {
   Insert(9025, kDeltaFrame, kFirst, kLast);
   Insert(9024, kKeyFrame, kFirst, kLast);
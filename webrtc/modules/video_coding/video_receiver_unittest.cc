@@ -218,6 +218,61 @@ TEST_F(TestVideoReceiver, ReceiverDelay) {
   EXPECT_EQ(-1, receiver_->SetMinReceiverDelay(10010));
 }
 
+TEST(VideoCodingModuleWithFrameBufferTest, DecodesFramesAndNacksLosses) {
+  static const int kPayloadType = 10;
+  SimulatedClock clock(0);
+  NullEventFactory event_factory;
+  std::unique_ptr<VideoCodingModule> vcm(
+      VideoCodingModule::CreateWithFrameBuffer(&clock, &event_factory));
+  NiceMock<MockVideoDecoder> decoder;
+  NiceMock<MockPacketRequestCallback> packet_request_callback;
+  NiceMock<MockVCMReceiveCallback> receive_callback;
+  vcm->RegisterExternalDecoder(&decoder, kPayloadType);
+  VideoCodec settings;
+  webrtc::test::CodecSettings(kVideoCodecVP8, &settings);
+  settings.plType = kPayloadType;
+  EXPECT_EQ(0, vcm->RegisterReceiveCodec(&settings, 1, true));
+  vcm->RegisterReceiveCallback(&receive_callback);
+  EXPECT_EQ(0, vcm->SetVideoProtection(kProtectionNack, true));
+  EXPECT_EQ(0, vcm->RegisterPacketRequestCallback(&packet_request_callback));
+
+  const size_t kFrameSize = 1200;
+  const uint8_t payload[kFrameSize] = {0};
+  WebRtcRTPHeader header;
+  memset(&header, 0, sizeof(header));
+  header.header.payloadType = kPayloadType;
+  header.header.ssrc = 1;
+  header.header.headerLength = 12;
+  header.header.markerBit = true;
+  header.type.Video.codec = kRtpVideoVp8;
+  header.type.Video.is_first_packet_in_frame = true;
+  header.type.Video.codecHeader.VP8.pictureId = -1;
+  header.type.Video.codecHeader.VP8.tl0PicIdx = -1;
+
+  // One single packet key frame followed by a delta frame.
+  header.frameType = kVideoFrameKey;
+  EXPECT_EQ(0, vcm->IncomingPacket(payload, kFrameSize, header));
+  EXPECT_CALL(decoder, Decode(_, _, _, _, _)).Times(1);
+  EXPECT_EQ(0, vcm->Decode(100));
+  clock.AdvanceTimeMilliseconds(33);
+
+  header.frameType = kVideoFrameDelta;
+  ++header.header.sequenceNumber;
+  header.header.timestamp += 3000;
+  EXPECT_EQ(0, vcm->IncomingPacket(payload, kFrameSize, header));
+  EXPECT_CALL(decoder, Decode(_, _, _, _, _)).Times(1);
+  EXPECT_EQ(0, vcm->Decode(100));
+  clock.AdvanceTimeMilliseconds(33);
+
+  // Losing a packet is NACKed, and the next frame is not decodable.
+  header.header.sequenceNumber += 2;
+  header.header.timestamp += 3000;
+  EXPECT_CALL(packet_request_callback, ResendPackets(_, 1)).Times(1);
+  EXPECT_EQ(0, vcm->IncomingPacket(payload, kFrameSize, header));
+  EXPECT_CALL(decoder, Decode(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(VCM_FRAME_NOT_READY, vcm->Decode(0));
+}
+
 }  // namespace
 }  // namespace vcm
 }  // namespace webrtc
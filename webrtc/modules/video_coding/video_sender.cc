@@ -23,10 +23,16 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 namespace vcm {
 
+namespace {
+// Drops screenshare frames predicted to overshoot before encoding them.
+const char kFrameDropperLookaheadFieldTrial[] = "WebRTC-FrameDropperLookahead";
+}  // namespace
+
 VideoSender::VideoSender(Clock* clock,
                          EncodedImageCallback* post_encode_callback,
                          VCMSendStatisticsCallback* send_stats_callback)
@@ -38,6 +44,7 @@ VideoSender::VideoSender(Clock* clock,
       send_stats_callback_(send_stats_callback),
       _codecDataBase(&_encodedFrameCallback),
       frame_dropper_enabled_(true),
+      dropped_update_rect_{0, 0, 0, 0},
       _sendStatsTimer(VCMProcessTimer::kDefaultProcessIntervalMs, clock_),
       current_codec_(),
       encoder_params_({BitrateAllocation(), 0, 0, 0}),
@@ -120,6 +127,9 @@ int32_t VideoSender::RegisterSendCodec(const VideoCodec* sendCodec,
   } else if (frame_dropper_enabled_) {
     _mediaOpt.EnableFrameDropper(true);
   }
+  _mediaOpt.EnableFrameDropperLookahead(
+      sendCodec->mode == kScreensharing &&
+      field_trial::IsEnabled(kFrameDropperLookaheadFieldTrial));
 
   {
     rtc::CritScope cs(&params_crit_);
@@ -324,6 +334,7 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
                     << encoder_params.rtt << " input frame rate "
                     << encoder_params.input_frame_rate;
     post_encode_callback_->OnDroppedFrame();
+    dropped_update_rect_.Union(videoFrame.update_rect());
     return VCM_OK;
   }
   // TODO(pbos): Make sure setting send codec is synchronized with video
@@ -331,9 +342,16 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
   if (!_codecDataBase.MatchesCurrentResolution(videoFrame.width(),
                                                videoFrame.height())) {
     LOG(LS_ERROR) << "Incoming frame doesn't match set resolution. Dropping.";
+    dropped_update_rect_.Union(videoFrame.update_rect());
     return VCM_PARAMETER_ERROR;
   }
   VideoFrame converted_frame = videoFrame;
+  if (!dropped_update_rect_.IsEmpty()) {
+    // The encoder hasn't seen the changes of the dropped frames either.
+    VideoFrame::UpdateRect update_rect = dropped_update_rect_;
+    update_rect.Union(videoFrame.update_rect());
+    converted_frame.set_update_rect(update_rect);
+  }
   const VideoFrameBuffer::Type buffer_type =
       converted_frame.video_frame_buffer()->type();
   const bool is_buffer_type_supported =
@@ -348,13 +366,17 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
 
     if (!converted_buffer) {
       LOG(LS_ERROR) << "Frame conversion failed, dropping frame.";
+      dropped_update_rect_.Union(converted_frame.update_rect());
       return VCM_PARAMETER_ERROR;
     }
+    VideoFrame::UpdateRect update_rect = converted_frame.update_rect();
     converted_frame = VideoFrame(converted_buffer,
                                  converted_frame.timestamp(),
                                  converted_frame.render_time_ms(),
                                  converted_frame.rotation());
+    converted_frame.set_update_rect(update_rect);
   }
+  dropped_update_rect_ = VideoFrame::UpdateRect{0, 0, 0, 0};
   int32_t ret =
       _encoder->Encode(converted_frame, codecSpecificInfo, next_frame_types);
   if (ret < 0) {
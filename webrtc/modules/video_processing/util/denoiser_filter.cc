@@ -9,6 +9,7 @@
  */
 
 #include "webrtc/modules/video_processing/util/denoiser_filter.h"
+#include "webrtc/modules/video_processing/util/denoiser_filter_avx2.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter_c.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter_neon.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter_sse2.h"
@@ -32,15 +33,20 @@ std::unique_ptr<DenoiserFilter> DenoiserFilter::Create(
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 #if defined(__SSE2__)
-    filter.reset(new DenoiserFilterSSE2());
+    const bool has_sse2 = true;
 #else
     // x86 CPU detection required.
-    if (WebRtc_GetCPUInfo(kSSE2)) {
+    const bool has_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+#endif
+    // AVX2 isn't assumed at compile time, so that one binary runs on all x86
+    // CPUs.
+    if (WebRtc_GetCPUInfo(kAVX2)) {
+      filter.reset(new DenoiserFilterAVX2());
+    } else if (has_sse2) {
       filter.reset(new DenoiserFilterSSE2());
     } else {
       filter.reset(new DenoiserFilterC());
     }
-#endif
 #elif defined(WEBRTC_HAS_NEON)
     filter.reset(new DenoiserFilterNEON());
     if (cpu_type != nullptr)
@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+#include "webrtc/modules/video_processing/util/denoiser_filter_avx2.h"
+
+namespace webrtc {
+
+// Loads two rows of 16 pixels into the low and high lane of a register.
+static __m256i LoadTwoRows(const uint8_t* src, int src_stride) {
+  const __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i row1 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_stride));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(row0), row1, 1);
+}
+
+static void StoreTwoRows(__m256i rows, uint8_t* dst, int dst_stride) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   _mm256_castsi256_si128(rows));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_stride),
+                   _mm256_extracti128_si256(rows, 1));
+}
+
+static int32_t HorizontalAddS32x8(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// Compute the sum of all pixel differences of this MB.
+static uint32_t AbsSumDiff16x1(__m128i acc_diff) {
+  const __m128i k_1 = _mm_set1_epi16(1);
+  const __m128i acc_diff_lo =
+      _mm_srai_epi16(_mm_unpacklo_epi8(acc_diff, acc_diff), 8);
+  const __m128i acc_diff_hi =
+      _mm_srai_epi16(_mm_unpackhi_epi8(acc_diff, acc_diff), 8);
+  const __m128i acc_diff_16 = _mm_add_epi16(acc_diff_lo, acc_diff_hi);
+  const __m128i hg_fe_dc_ba = _mm_madd_epi16(acc_diff_16, k_1);
+  const __m128i hgfe_dcba =
+      _mm_add_epi32(hg_fe_dc_ba, _mm_srli_si128(hg_fe_dc_ba, 8));
+  const __m128i hgfedcba =
+      _mm_add_epi32(hgfe_dcba, _mm_srli_si128(hgfe_dcba, 4));
+  unsigned int sum_diff = abs(_mm_cvtsi128_si32(hgfedcba));
+
+  return sum_diff;
+}
+
+void DenoiserFilterAVX2::CopyMem16x16(const uint8_t* src,
+                                      int src_stride,
+                                      uint8_t* dst,
+                                      int dst_stride) {
+  for (int i = 0; i < 16; i += 2) {
+    StoreTwoRows(LoadTwoRows(src, src_stride), dst, dst_stride);
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+uint32_t DenoiserFilterAVX2::Variance16x8(const uint8_t* src,
+                                          int src_stride,
+                                          const uint8_t* ref,
+                                          int ref_stride,
+                                          uint32_t* sse) {
+  const __m256i k_1 = _mm256_set1_epi16(1);
+  __m256i vsum = _mm256_setzero_si256();
+  __m256i vsse = _mm256_setzero_si256();
+
+  // Every other row of the 16x16 block, like the C version.
+  for (int i = 0; i < 8; ++i) {
+    const __m256i src16 = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    const __m256i ref16 = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(ref)));
+    const __m256i diff = _mm256_sub_epi16(src16, ref16);
+    // At most 8 * 255 per lane, so the sum fits in 16 bits.
+    vsum = _mm256_add_epi16(vsum, diff);
+    vsse = _mm256_add_epi32(vsse, _mm256_madd_epi16(diff, diff));
+    src += 2 * src_stride;
+    ref += 2 * ref_stride;
+  }
+
+  const int64_t sum = HorizontalAddS32x8(_mm256_madd_epi16(vsum, k_1));
+  *sse = static_cast<uint32_t>(HorizontalAddS32x8(vsse));
+  return *sse - ((sum * sum) >> 7);
+}
+
+DenoiserDecision DenoiserFilterAVX2::MbDenoise(const uint8_t* mc_running_avg_y,
+                                               int mc_avg_y_stride,
+                                               uint8_t* running_avg_y,
+                                               int avg_y_stride,
+                                               const uint8_t* sig,
+                                               int sig_stride,
+                                               uint8_t motion_magnitude,
+                                               int increase_denoising) {
+  DenoiserDecision decision = FILTER_BLOCK;
+  unsigned int sum_diff_thresh = 0;
+  int shift_inc =
+      (increase_denoising && motion_magnitude <= kMotionMagnitudeThreshold) ? 1
+                                                                            : 0;
+  // Same filter as the SSE2 version, on two rows at a time.
+  __m256i acc_diff = _mm256_setzero_si256();
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= kMotionMagnitudeThreshold) ? 7 + shift_inc : 6);
+  // Difference between level 3 and level 2 is 2.
+  const __m256i l32 = _mm256_set1_epi8(2);
+  // Difference between level 2 and level 1 is 1.
+  const __m256i l21 = _mm256_set1_epi8(1);
+
+  for (int r = 0; r < 16; r += 2) {
+    // Calculate differences.
+    const __m256i v_sig = LoadTwoRows(sig, sig_stride);
+    const __m256i v_mc_running_avg_y =
+        LoadTwoRows(mc_running_avg_y, mc_avg_y_stride);
+    const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+    const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+    // Obtain the sign. FF if diff is negative.
+    const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+    // Clamp absolute difference to 16 to be used to get mask. Doing this
+    // allows us to use _mm256_cmpgt_epi8, which operates on signed byte.
+    const __m256i clamped_absdiff =
+        _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+    // Get masks for l2 l1 and l0 adjustments.
+    const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+    const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+    const __m256i mask0 = _mm256_cmpgt_epi8(k_4, clamped_absdiff);
+    // Get adjustments for l2, l1, and l0.
+    __m256i adj2 = _mm256_and_si256(mask2, l32);
+    const __m256i adj1 = _mm256_and_si256(mask1, l21);
+    const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+    __m256i adj, padj, nadj;
+
+    // Combine the adjustments and get absolute adjustments.
+    adj2 = _mm256_add_epi8(adj2, adj1);
+    adj = _mm256_sub_epi8(l3, adj2);
+    adj = _mm256_andnot_si256(mask0, adj);
+    adj = _mm256_or_si256(adj, adj0);
+
+    // Restore the sign and get positive and negative adjustments.
+    padj = _mm256_andnot_si256(diff_sign, adj);
+    nadj = _mm256_and_si256(diff_sign, adj);
+
+    // Calculate filtered value.
+    __m256i v_running_avg_y = _mm256_adds_epu8(v_sig, padj);
+    v_running_avg_y = _mm256_subs_epu8(v_running_avg_y, nadj);
+    StoreTwoRows(v_running_avg_y, running_avg_y, avg_y_stride);
+
+    // Adjustments <=8, and each element in acc_diff, which holds the sum of
+    // either the even or the odd rows of a column, can fit in signed char.
+    acc_diff = _mm256_adds_epi8(acc_diff, padj);
+    acc_diff = _mm256_subs_epi8(acc_diff, nadj);
+
+    // Update pointers for next iteration.
+    sig += 2 * sig_stride;
+    mc_running_avg_y += 2 * mc_avg_y_stride;
+    running_avg_y += 2 * avg_y_stride;
+  }
+
+  // Sum the even and odd rows per column, saturating like the SSE2 version.
+  unsigned int abs_sum_diff = AbsSumDiff16x1(_mm_adds_epi8(
+      _mm256_castsi256_si128(acc_diff), _mm256_extracti128_si256(acc_diff, 1)));
+  sum_diff_thresh =
+      increase_denoising ? kSumDiffThresholdHigh : kSumDiffThreshold;
+  if (abs_sum_diff > sum_diff_thresh)
+    decision = COPY_BLOCK;
+  return decision;
+}
+
+}  // namespace webrtc
@@ -97,13 +97,13 @@ static uint32_t AbsSumDiff16x1(__m128i acc_diff) {
   return sum_diff;
 }
 
-// TODO(jackychen): Optimize this function using SSE2.
 void DenoiserFilterSSE2::CopyMem16x16(const uint8_t* src,
                                       int src_stride,
                                       uint8_t* dst,
                                       int dst_stride) {
   for (int i = 0; i < 16; i++) {
-    memcpy(dst, src, 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
     src += src_stride;
     dst += dst_stride;
   }
@@ -99,6 +99,14 @@ PROXY_METHOD2(RTCErrorOr<std::unique_ptr<OrtcRtpSenderInterface>>,
               CreateRtpSender,
               cricket::MediaType,
               RtpTransportInterface*)
+PROXY_METHOD2(std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpSenderInterface>>>,
+              CreateRtpSenders,
+              cricket::MediaType,
+              const std::vector<RtpTransportInterface*>&)
+PROXY_METHOD2(std::vector<RTCError>,
+              SendBatch,
+              const std::vector<OrtcRtpSenderInterface*>&,
+              const std::vector<RtpParameters>&)
 PROXY_CONSTMETHOD1(RtpCapabilities,
                    GetRtpReceiverCapabilities,
                    cricket::MediaType)
@@ -106,6 +114,15 @@ PROXY_METHOD2(RTCErrorOr<std::unique_ptr<OrtcRtpReceiverInterface>>,
               CreateRtpReceiver,
               cricket::MediaType,
               RtpTransportInterface*)
+PROXY_METHOD2(
+    std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpReceiverInterface>>>,
+    CreateRtpReceivers,
+    cricket::MediaType,
+    const std::vector<RtpTransportInterface*>&)
+PROXY_METHOD2(std::vector<RTCError>,
+              ReceiveBatch,
+              const std::vector<OrtcRtpReceiverInterface*>&,
+              const std::vector<RtpParameters>&)
 PROXY_WORKER_METHOD3(RTCErrorOr<std::unique_ptr<UdpTransportInterface>>,
                      CreateUdpTransport,
                      int,
@@ -363,6 +380,33 @@ OrtcFactory::CreateRtpSender(cricket::MediaType kind,
       ->CreateProxiedRtpSender(kind, transport);
 }
 
+std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpSenderInterface>>>
+OrtcFactory::CreateRtpSenders(
+    cricket::MediaType kind,
+    const std::vector<RtpTransportInterface*>& transports) {
+  RTC_DCHECK_RUN_ON(signaling_thread_);
+  std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpSenderInterface>>> senders;
+  senders.reserve(transports.size());
+  for (RtpTransportInterface* transport : transports) {
+    senders.push_back(CreateRtpSender(kind, transport));
+  }
+  return senders;
+}
+
+std::vector<RTCError> OrtcFactory::SendBatch(
+    const std::vector<OrtcRtpSenderInterface*>& senders,
+    const std::vector<RtpParameters>& parameters) {
+  RTC_DCHECK_RUN_ON(signaling_thread_);
+  RTC_DCHECK_EQ(senders.size(), parameters.size());
+  std::vector<RTCError> errors;
+  errors.reserve(senders.size());
+  // The senders are proxies on the signaling thread, so these calls don't hop.
+  for (size_t i = 0; i < senders.size(); ++i) {
+    errors.push_back(senders[i]->Send(parameters[i]));
+  }
+  return errors;
+}
+
 RtpCapabilities OrtcFactory::GetRtpReceiverCapabilities(
     cricket::MediaType kind) const {
   RTC_DCHECK_RUN_ON(signaling_thread_);
@@ -407,6 +451,32 @@ OrtcFactory::CreateRtpReceiver(cricket::MediaType kind,
       ->CreateProxiedRtpReceiver(kind, transport);
 }
 
+std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpReceiverInterface>>>
+OrtcFactory::CreateRtpReceivers(
+    cricket::MediaType kind,
+    const std::vector<RtpTransportInterface*>& transports) {
+  RTC_DCHECK_RUN_ON(signaling_thread_);
+  std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpReceiverInterface>>> receivers;
+  receivers.reserve(transports.size());
+  for (RtpTransportInterface* transport : transports) {
+    receivers.push_back(CreateRtpReceiver(kind, transport));
+  }
+  return receivers;
+}
+
+std::vector<RTCError> OrtcFactory::ReceiveBatch(
+    const std::vector<OrtcRtpReceiverInterface*>& receivers,
+    const std::vector<RtpParameters>& parameters) {
+  RTC_DCHECK_RUN_ON(signaling_thread_);
+  RTC_DCHECK_EQ(receivers.size(), parameters.size());
+  std::vector<RTCError> errors;
+  errors.reserve(receivers.size());
+  for (size_t i = 0; i < receivers.size(); ++i) {
+    errors.push_back(receivers[i]->Receive(parameters[i]));
+  }
+  return errors;
+}
+
 // UdpTransport expects all methods to be called on one thread, which needs to
 // be the network thread, since that's where its socket can safely be used. So
 // return a proxy to the created UdpTransport.
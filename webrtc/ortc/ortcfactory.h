@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "webrtc/api/ortc/ortcfactoryinterface.h"
 #include "webrtc/media/base/mediaengine.h"
@@ -66,6 +67,15 @@ class OrtcFactory : public OrtcFactoryInterface {
       cricket::MediaType kind,
       RtpTransportInterface* transport) override;
 
+  std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpSenderInterface>>>
+  CreateRtpSenders(
+      cricket::MediaType kind,
+      const std::vector<RtpTransportInterface*>& transports) override;
+
+  std::vector<RTCError> SendBatch(
+      const std::vector<OrtcRtpSenderInterface*>& senders,
+      const std::vector<RtpParameters>& parameters) override;
+
   RtpCapabilities GetRtpReceiverCapabilities(
       cricket::MediaType kind) const override;
 
@@ -73,6 +83,15 @@ class OrtcFactory : public OrtcFactoryInterface {
       cricket::MediaType kind,
       RtpTransportInterface* transport) override;
 
+  std::vector<RTCErrorOr<std::unique_ptr<OrtcRtpReceiverInterface>>>
+  CreateRtpReceivers(
+      cricket::MediaType kind,
+      const std::vector<RtpTransportInterface*>& transports) override;
+
+  std::vector<RTCError> ReceiveBatch(
+      const std::vector<OrtcRtpReceiverInterface*>& receivers,
+      const std::vector<RtpParameters>& parameters) override;
+
   RTCErrorOr<std::unique_ptr<UdpTransportInterface>>
   CreateUdpTransport(int family, uint16_t min_port, uint16_t max_port) override;
 
@@ -9,6 +9,7 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/media/base/fakemediaengine.h"
 #include "webrtc/ortc/ortcfactory.h"
@@ -243,4 +244,61 @@ TEST_F(OrtcFactoryTest, CreateSendersOrReceieversWithNullTransport) {
   EXPECT_EQ(RTCErrorType::INVALID_PARAMETER, receiver_result.error().type());
 }
 
+// The batch methods should give the same result per transport as creating the
+// senders/receivers one by one, including for a failing entry.
+TEST_F(OrtcFactoryTest, CreateAndStartSendersAndReceiversInBatch) {
+  rtc::FakePacketTransport packet_transport1("transport1");
+  rtc::FakePacketTransport packet_transport2("transport2");
+  auto rtp_transport1 = ortc_factory_
+                            ->CreateRtpTransport(MakeRtcpMuxParameters(),
+                                                 &packet_transport1, nullptr,
+                                                 nullptr)
+                            .MoveValue();
+  auto rtp_transport2 = ortc_factory_
+                            ->CreateRtpTransport(MakeRtcpMuxParameters(),
+                                                 &packet_transport2, nullptr,
+                                                 nullptr)
+                            .MoveValue();
+  std::vector<RtpTransportInterface*> transports = {
+      rtp_transport1.get(), rtp_transport2.get(), nullptr};
+
+  auto sender_results =
+      ortc_factory_->CreateRtpSenders(cricket::MEDIA_TYPE_AUDIO, transports);
+  ASSERT_EQ(3u, sender_results.size());
+  ASSERT_TRUE(sender_results[0].ok());
+  ASSERT_TRUE(sender_results[1].ok());
+  EXPECT_EQ(RTCErrorType::INVALID_PARAMETER,
+            sender_results[2].error().type());
+  auto receiver_results =
+      ortc_factory_->CreateRtpReceivers(cricket::MEDIA_TYPE_AUDIO, transports);
+  ASSERT_EQ(3u, receiver_results.size());
+  ASSERT_TRUE(receiver_results[0].ok());
+  ASSERT_TRUE(receiver_results[1].ok());
+  EXPECT_EQ(RTCErrorType::INVALID_PARAMETER,
+            receiver_results[2].error().type());
+
+  std::vector<OrtcRtpSenderInterface*> senders = {
+      sender_results[0].value().get(), sender_results[1].value().get()};
+  std::vector<RtpParameters> send_parameters = {
+      MakeMinimalOpusParametersWithSsrc(0xdeadbeef),
+      MakeMinimalOpusParametersWithSsrc(0xbaadf00d)};
+  auto send_errors = ortc_factory_->SendBatch(senders, send_parameters);
+  ASSERT_EQ(2u, send_errors.size());
+  EXPECT_TRUE(send_errors[0].ok());
+  EXPECT_TRUE(send_errors[1].ok());
+  EXPECT_EQ(0xbaadf00du, *senders[1]->GetParameters().encodings[0].ssrc);
+
+  std::vector<OrtcRtpReceiverInterface*> receivers = {
+      receiver_results[0].value().get(), receiver_results[1].value().get()};
+  std::vector<RtpParameters> receive_parameters = {
+      MakeMinimalOpusParametersWithSsrc(0x12345678),
+      MakeMinimalOpusParametersWithSsrc(0x87654321)};
+  auto receive_errors =
+      ortc_factory_->ReceiveBatch(receivers, receive_parameters);
+  ASSERT_EQ(2u, receive_errors.size());
+  EXPECT_TRUE(receive_errors[0].ok());
+  EXPECT_TRUE(receive_errors[1].ok());
+  EXPECT_EQ(0x87654321u, *receivers[1]->GetParameters().encodings[0].ssrc);
+}
+
 }  // namespace webrtc
@@ -234,42 +234,37 @@ RTCError RtpTransportControllerAdapter::SetRtpTransportParameters(
                          "media streams or additional transports for the same "
                          "transport controller.");
   }
-  // Call must be configured on the worker thread.
-  worker_thread_->Invoke<void>(
-      RTC_FROM_HERE,
-      rtc::Bind(&RtpTransportControllerAdapter::SetRtpTransportParameters_w,
-                this, parameters));
-
-  do {
-    if (inner_transport == inner_audio_transport_) {
-      CopyRtcpParametersToDescriptions(parameters.rtcp,
-                                       &local_audio_description_,
-                                       &remote_audio_description_);
-      if (!voice_channel_->SetLocalContent(&local_audio_description_,
-                                           cricket::CA_OFFER, nullptr)) {
-        break;
-      }
-      if (!voice_channel_->SetRemoteContent(&remote_audio_description_,
-                                            cricket::CA_ANSWER, nullptr)) {
-        break;
-      }
-    } else if (inner_transport == inner_video_transport_) {
-      CopyRtcpParametersToDescriptions(parameters.rtcp,
-                                       &local_video_description_,
-                                       &remote_video_description_);
-      if (!video_channel_->SetLocalContent(&local_video_description_,
-                                           cricket::CA_OFFER, nullptr)) {
-        break;
-      }
-      if (!video_channel_->SetRemoteContent(&remote_video_description_,
-                                            cricket::CA_ANSWER, nullptr)) {
-        break;
-      }
-    }
-    return RTCError::OK();
-  } while (false);
-  LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                       "Failed to apply new RTCP parameters.");
+  cricket::BaseChannel* channel = nullptr;
+  const cricket::MediaContentDescription* local = nullptr;
+  const cricket::MediaContentDescription* remote = nullptr;
+  if (inner_transport == inner_audio_transport_) {
+    CopyRtcpParametersToDescriptions(parameters.rtcp,
+                                     &local_audio_description_,
+                                     &remote_audio_description_);
+    channel = voice_channel_;
+    local = &local_audio_description_;
+    remote = &remote_audio_description_;
+  } else if (inner_transport == inner_video_transport_) {
+    CopyRtcpParametersToDescriptions(parameters.rtcp,
+                                     &local_video_description_,
+                                     &remote_video_description_);
+    channel = video_channel_;
+    local = &local_video_description_;
+    remote = &remote_video_description_;
+  }
+  // Call must be configured on the worker thread. The new RTCP parameters are
+  // applied in the same hop.
+  bool applied = worker_thread_->Invoke<bool>(RTC_FROM_HERE, [&] {
+    SetRtpTransportParameters_w(parameters);
+    return !channel || ApplyChannelContents_w(channel, local, cricket::CA_OFFER,
+                                              remote, cricket::CA_ANSWER)
+                           .ok();
+  });
+  if (!applied) {
+    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
+                         "Failed to apply new RTCP parameters.");
+  }
+  return RTCError::OK();
 }
 
 void RtpTransportControllerAdapter::SetRtpTransportParameters_w(
@@ -353,17 +348,9 @@ RTCError RtpTransportControllerAdapter::ValidateAndApplyAudioSenderParameters(
 
   // Set remote content first, to ensure the stream is created with the correct
   // codec.
-  if (!voice_channel_->SetRemoteContent(&remote_audio_description_,
-                                        cricket::CA_OFFER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply remote parameters to media channel.");
-  }
-  if (!voice_channel_->SetLocalContent(&local_audio_description_,
-                                       cricket::CA_ANSWER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply local parameters to media channel.");
-  }
-  return RTCError::OK();
+  return ApplyChannelContents(voice_channel_, &local_audio_description_,
+                              cricket::CA_ANSWER, &remote_audio_description_,
+                              cricket::CA_OFFER);
 }
 
 RTCError RtpTransportControllerAdapter::ValidateAndApplyVideoSenderParameters(
@@ -442,17 +429,9 @@ RTCError RtpTransportControllerAdapter::ValidateAndApplyVideoSenderParameters(
 
   // Set remote content first, to ensure the stream is created with the correct
   // codec.
-  if (!video_channel_->SetRemoteContent(&remote_video_description_,
-                                        cricket::CA_OFFER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply remote parameters to media channel.");
-  }
-  if (!video_channel_->SetLocalContent(&local_video_description_,
-                                       cricket::CA_ANSWER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply local parameters to media channel.");
-  }
-  return RTCError::OK();
+  return ApplyChannelContents(video_channel_, &local_video_description_,
+                              cricket::CA_ANSWER, &remote_video_description_,
+                              cricket::CA_OFFER);
 }
 
 RTCError RtpTransportControllerAdapter::ValidateAndApplyAudioReceiverParameters(
@@ -516,17 +495,9 @@ RTCError RtpTransportControllerAdapter::ValidateAndApplyAudioReceiverParameters(
   remote_audio_description_.set_direction(
       local_direction.Reversed().ToMediaContentDirection());
 
-  if (!voice_channel_->SetLocalContent(&local_audio_description_,
-                                       cricket::CA_OFFER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply local parameters to media channel.");
-  }
-  if (!voice_channel_->SetRemoteContent(&remote_audio_description_,
-                                        cricket::CA_ANSWER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply remote parameters to media channel.");
-  }
-  return RTCError::OK();
+  return ApplyChannelContents(voice_channel_, &local_audio_description_,
+                              cricket::CA_OFFER, &remote_audio_description_,
+                              cricket::CA_ANSWER);
 }
 
 RTCError RtpTransportControllerAdapter::ValidateAndApplyVideoReceiverParameters(
@@ -592,17 +563,9 @@ RTCError RtpTransportControllerAdapter::ValidateAndApplyVideoReceiverParameters(
   remote_video_description_.set_direction(
       local_direction.Reversed().ToMediaContentDirection());
 
-  if (!video_channel_->SetLocalContent(&local_video_description_,
-                                       cricket::CA_OFFER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply local parameters to media channel.");
-  }
-  if (!video_channel_->SetRemoteContent(&remote_video_description_,
-                                        cricket::CA_ANSWER, nullptr)) {
-    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
-                         "Failed to apply remote parameters to media channel.");
-  }
-  return RTCError::OK();
+  return ApplyChannelContents(video_channel_, &local_video_description_,
+                              cricket::CA_OFFER, &remote_video_description_,
+                              cricket::CA_ANSWER);
 }
 
 RtpTransportControllerAdapter::RtpTransportControllerAdapter(
@@ -927,6 +890,44 @@ void RtpTransportControllerAdapter::CopyRtcpParametersToDescriptions(
   }
 }
 
+RTCError RtpTransportControllerAdapter::ApplyChannelContents(
+    cricket::BaseChannel* channel,
+    const cricket::MediaContentDescription* local,
+    cricket::ContentAction local_action,
+    const cricket::MediaContentDescription* remote,
+    cricket::ContentAction remote_action) {
+  return worker_thread_->Invoke<RTCError>(RTC_FROM_HERE, [&] {
+    return ApplyChannelContents_w(channel, local, local_action, remote,
+                                  remote_action);
+  });
+}
+
+RTCError RtpTransportControllerAdapter::ApplyChannelContents_w(
+    cricket::BaseChannel* channel,
+    const cricket::MediaContentDescription* local,
+    cricket::ContentAction local_action,
+    const cricket::MediaContentDescription* remote,
+    cricket::ContentAction remote_action) {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  // BaseChannel's setters don't hop when already on the worker thread.
+  bool local_first = local_action == cricket::CA_OFFER;
+  if (!local_first && !channel->SetRemoteContent(remote, remote_action,
+                                                 nullptr)) {
+    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
+                         "Failed to apply remote parameters to media channel.");
+  }
+  if (!channel->SetLocalContent(local, local_action, nullptr)) {
+    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
+                         "Failed to apply local parameters to media channel.");
+  }
+  if (local_first && !channel->SetRemoteContent(remote, remote_action,
+                                                nullptr)) {
+    LOG_AND_RETURN_ERROR(RTCErrorType::INTERNAL_ERROR,
+                         "Failed to apply remote parameters to media channel.");
+  }
+  return RTCError::OK();
+}
+
 uint32_t RtpTransportControllerAdapter::GenerateUnusedSsrc(
     std::set<uint32_t>* new_ssrcs) const {
   uint32_t ssrc;
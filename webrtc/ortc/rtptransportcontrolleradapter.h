@@ -165,6 +165,21 @@ class RtpTransportControllerAdapter : public RtpTransportControllerInterface,
       cricket::MediaContentDescription* local,
       cricket::MediaContentDescription* remote);
 
+  // Applies |local| and |remote| to |channel|, starting with the one whose
+  // action is CA_OFFER. Both are applied in a single hop to the worker thread;
+  // BaseChannel's own setters would make one hop each.
+  RTCError ApplyChannelContents(cricket::BaseChannel* channel,
+                                const cricket::MediaContentDescription* local,
+                                cricket::ContentAction local_action,
+                                const cricket::MediaContentDescription* remote,
+                                cricket::ContentAction remote_action);
+  RTCError ApplyChannelContents_w(
+      cricket::BaseChannel* channel,
+      const cricket::MediaContentDescription* local,
+      cricket::ContentAction local_action,
+      const cricket::MediaContentDescription* remote,
+      cricket::ContentAction remote_action);
+
   // Helper function to generate an SSRC that doesn't match one in any of the
   // "content description" structs, or in |new_ssrcs| (which is needed since
   // multiple SSRCs may be generated in one go).
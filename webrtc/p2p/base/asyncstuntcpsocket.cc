@@ -66,13 +66,19 @@ int AsyncStunTCPSocket::Send(const void *pv, size_t cb,
   if (cb != expected_pkt_len)
     return -1;
 
-  AppendToOutBuffer(pv, cb);
+  int res;
+  if (pad_bytes == 0) {
+    // The packet is framed already, so it's sent without copying it.
+    res = SendDirect(pv, cb);
+  } else {
+    AppendToOutBuffer(pv, cb);
 
-  RTC_DCHECK(pad_bytes < 4);
-  char padding[4] = {0};
-  AppendToOutBuffer(padding, pad_bytes);
+    RTC_DCHECK(pad_bytes < 4);
+    char padding[4] = {0};
+    AppendToOutBuffer(padding, pad_bytes);
 
-  int res = FlushOutBuffer();
+    res = FlushOutBuffer();
+  }
   if (res <= 0) {
     // drop packet if we made no progress
     ClearOutBuffer();
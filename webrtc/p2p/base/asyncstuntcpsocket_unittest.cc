@@ -186,6 +186,24 @@ TEST_F(AsyncStunTCPSocketTest, TestTurnChannelDataPadding) {
                         sizeof(kTurnChannelDataMessageWithOddLength)));
 }
 
+// Verifying packets that are sent as they are and packets that are padded
+// in the outgoing buffer can follow each other.
+TEST_F(AsyncStunTCPSocketTest, TestPaddedAndUnpaddedPackets) {
+  EXPECT_TRUE(Send(kTurnChannelDataMessageWithOddLength,
+                   sizeof(kTurnChannelDataMessageWithOddLength)));
+  EXPECT_TRUE(Send(kTurnChannelDataMessage,
+                   sizeof(kTurnChannelDataMessage)));
+  EXPECT_TRUE(Send(kTurnChannelDataMessageWithOddLength,
+                   sizeof(kTurnChannelDataMessageWithOddLength)));
+  EXPECT_EQ(3u, recv_packets_.size());
+  EXPECT_TRUE(CheckData(kTurnChannelDataMessageWithOddLength,
+                        sizeof(kTurnChannelDataMessageWithOddLength)));
+  EXPECT_TRUE(CheckData(kTurnChannelDataMessage,
+                        sizeof(kTurnChannelDataMessage)));
+  EXPECT_TRUE(CheckData(kTurnChannelDataMessageWithOddLength,
+                        sizeof(kTurnChannelDataMessageWithOddLength)));
+}
+
 // Verifying stun message with invalid length.
 TEST_F(AsyncStunTCPSocketTest, TestStunInvalidLength) {
   EXPECT_FALSE(Send(kStunMessageWithInvalidLength,
@@ -23,6 +23,7 @@
 #include "webrtc/rtc_base/sslstreamadapter.h"
 #include "webrtc/rtc_base/stream.h"
 #include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace cricket {
 
@@ -525,7 +526,11 @@ void DtlsTransport::OnDtlsEvent(rtc::StreamInterface* dtls, int sig, int err) {
   RTC_DCHECK(dtls == dtls_.get());
   if (sig & rtc::SE_OPEN) {
     // This is the first time.
-    LOG_J(LS_INFO, this) << "DTLS handshake complete.";
+    dtls_handshake_time_ms_ = rtc::Optional<int>(
+        static_cast<int>(rtc::TimeMillis() - dtls_handshake_start_ms_));
+    LOG_J(LS_INFO, this) << "DTLS handshake complete in "
+                         << *dtls_handshake_time_ms_ << " ms.";
+    SignalDtlsHandshakeTime(*dtls_handshake_time_ms_);
     if (dtls_->GetState() == rtc::SS_OPEN) {
       // The check for OPEN shouldn't be necessary but let's make
       // sure we don't accidentally frob the state if it's closed.
@@ -574,6 +579,7 @@ void DtlsTransport::MaybeStartDtls() {
   if (dtls_ && ice_transport_->writable()) {
     ConfigureHandshakeTimeout();
 
+    dtls_handshake_start_ms_ = rtc::TimeMillis();
     if (dtls_->StartSSL()) {
       // This should never fail:
       // Because we are operating in a nonblocking mode and all
@@ -20,6 +20,7 @@
 #include "webrtc/rtc_base/buffer.h"
 #include "webrtc/rtc_base/bufferqueue.h"
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/sslstreamadapter.h"
 #include "webrtc/rtc_base/stream.h"
 
@@ -163,6 +164,12 @@ class DtlsTransport : public DtlsTransportInternal {
   // has not yet been verified.
   bool IsDtlsConnected();
 
+  // The time from starting the last DTLS handshake to its completion, unset
+  // until one has completed.
+  rtc::Optional<int> dtls_handshake_time_ms() const {
+    return dtls_handshake_time_ms_;
+  }
+
   bool receiving() const override { return receiving_; }
 
   bool writable() const override { return writable_; }
@@ -231,6 +238,10 @@ class DtlsTransport : public DtlsTransportInternal {
   bool receiving_ = false;
   bool writable_ = false;
 
+  // When the last DTLS handshake was started, in rtc::TimeMillis.
+  int64_t dtls_handshake_start_ms_ = 0;
+  rtc::Optional<int> dtls_handshake_time_ms_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(DtlsTransport);
 };
 
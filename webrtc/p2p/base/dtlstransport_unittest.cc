@@ -665,6 +665,23 @@ TEST_F(DtlsTransportChannelTest, TestTransferDtls) {
   TestTransfer(0, 1000, 100, false);
 }
 
+// Test that the handshake time is recorded once DTLS is connected, and not
+// without DTLS.
+TEST_F(DtlsTransportChannelTest, TestDtlsHandshakeTime) {
+  PrepareDtls(true, true, rtc::KT_DEFAULT);
+  EXPECT_FALSE(client1_.GetDtlsTransport(0)->dtls_handshake_time_ms());
+  ASSERT_TRUE(Connect());
+  ASSERT_TRUE(client1_.GetDtlsTransport(0)->dtls_handshake_time_ms());
+  EXPECT_LE(0, *client1_.GetDtlsTransport(0)->dtls_handshake_time_ms());
+  ASSERT_TRUE(client2_.GetDtlsTransport(0)->dtls_handshake_time_ms());
+  EXPECT_LE(0, *client2_.GetDtlsTransport(0)->dtls_handshake_time_ms());
+}
+
+TEST_F(DtlsTransportChannelTest, TestNoDtlsHandshakeTimeWithoutDtls) {
+  ASSERT_TRUE(Connect());
+  EXPECT_FALSE(client1_.GetDtlsTransport(0)->dtls_handshake_time_ms());
+}
+
 // Create two channels with DTLS, and transfer some data.
 TEST_F(DtlsTransportChannelTest, TestTransferDtlsTwoChannels) {
   SetChannelCount(2);
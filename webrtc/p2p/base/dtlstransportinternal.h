@@ -93,6 +93,10 @@ class DtlsTransportInternal : public rtc::PacketTransportInternal {
   // Emitted whenever the Dtls handshake failed on some transport channel.
   sigslot::signal1<rtc::SSLHandshakeError> SignalDtlsHandshakeError;
 
+  // Emitted whenever the Dtls handshake completed on some transport channel,
+  // with the time it took in milliseconds.
+  sigslot::signal1<int> SignalDtlsHandshakeTime;
+
   // Debugging description of this transport.
   std::string debug_name() const override {
     return transport_name() + " " + rtc::ToString(component());
@@ -12,7 +12,10 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <set>
+#include <tuple>
+#include <utility>
 
 #include "webrtc/api/umametrics.h"
 #include "webrtc/p2p/base/candidate.h"
@@ -59,6 +62,39 @@ cricket::PortInterface::CandidateOrigin GetOrigin(cricket::PortInterface* port,
     return cricket::PortInterface::ORIGIN_OTHER_PORT;
 }
 
+// Everything P2PTransportChannel::CompareConnections() looks at when sorting
+// the connections, followed by the latency estimate as a tie-breaker.
+// Computing it once per connection and sort keeps each comparison cheap when
+// there are many candidates.
+struct ConnectionSortKey {
+  bool writable;
+  int write_state;
+  bool receiving;
+  // Only set if the connection is in STATE_WRITABLE.
+  bool writable_and_connected;
+  // Only set on the controlled side.
+  uint32_t remote_nomination;
+  int64_t last_data_received;
+  uint32_t network_cost;
+  uint64_t priority;
+  uint32_t generation;
+  bool pruned;
+  int rtt;
+};
+
+// Returns true if |a| should be sorted before |b|. The members for which
+// lower values are better are swapped between the two sides.
+bool IsBetterSortKey(const ConnectionSortKey& a, const ConnectionSortKey& b) {
+  return std::tie(a.writable, b.write_state, a.receiving,
+                  a.writable_and_connected, a.remote_nomination,
+                  a.last_data_received, b.network_cost, a.priority,
+                  a.generation, b.pruned, b.rtt) >
+         std::tie(b.writable, a.write_state, b.receiving,
+                  b.writable_and_connected, b.remote_nomination,
+                  b.last_data_received, a.network_cost, b.priority,
+                  b.generation, a.pruned, a.rtt);
+}
+
 }  // unnamed namespace
 
 namespace cricket {
@@ -1299,16 +1335,58 @@ void P2PTransportChannel::SortConnectionsAndUpdateState() {
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
   // TODO(honghaiz): Don't sort;  Just use std::max_element in the right places.
-  std::stable_sort(connections_.begin(), connections_.end(),
-                   [this](const Connection* a, const Connection* b) {
-                     int cmp = CompareConnections(
-                         a, b, rtc::Optional<int64_t>(), nullptr);
-                     if (cmp != 0) {
-                       return cmp > 0;
-                     }
-                     // Otherwise, sort based on latency estimate.
-                     return a->rtt() < b->rtt();
+  // Sorting by CompareConnections() directly would look for the port and the
+  // remote candidate of both connections among the unpruned ones on every
+  // comparison, which dominates with large candidate sets, so sort keys are
+  // computed once per connection instead.
+  std::multimap<std::string, const Candidate*> remote_candidates_by_id;
+  for (const Candidate& candidate : remote_candidates_) {
+    remote_candidates_by_id.insert(std::make_pair(candidate.id(), &candidate));
+  }
+  std::vector<std::pair<ConnectionSortKey, Connection*>> keyed_connections;
+  keyed_connections.reserve(connections_.size());
+  for (Connection* conn : connections_) {
+    const Candidate& remote = conn->remote_candidate();
+    auto remote_range = remote_candidates_by_id.equal_range(remote.id());
+    bool remote_pruned = std::none_of(
+        remote_range.first, remote_range.second,
+        [&remote](const std::pair<const std::string, const Candidate*>& entry) {
+          return *entry.second == remote;
+        });
+    bool controlled = ice_role_ == ICEROLE_CONTROLLED;
+    ConnectionSortKey key;
+    key.writable = conn->writable() || PresumedWritable(conn);
+    key.write_state = conn->write_state();
+    key.receiving = conn->receiving();
+    key.writable_and_connected =
+        conn->write_state() == Connection::STATE_WRITABLE && conn->connected();
+    key.remote_nomination = controlled ? conn->remote_nomination() : 0;
+    key.last_data_received = controlled ? conn->last_data_received() : 0;
+    key.network_cost = conn->ComputeNetworkCost();
+    key.priority = conn->priority();
+    key.generation = remote.generation() + conn->port()->generation();
+    key.pruned = IsPortPruned(conn->port()) || remote_pruned;
+    key.rtt = conn->rtt();
+    keyed_connections.push_back(std::make_pair(key, conn));
+  }
+  std::stable_sort(keyed_connections.begin(), keyed_connections.end(),
+                   [](const std::pair<ConnectionSortKey, Connection*>& a,
+                      const std::pair<ConnectionSortKey, Connection*>& b) {
+                     return IsBetterSortKey(a.first, b.first);
                    });
+  for (size_t i = 0; i < keyed_connections.size(); ++i) {
+    connections_[i] = keyed_connections[i].second;
+  }
+  RTC_DCHECK(std::is_sorted(connections_.begin(), connections_.end(),
+                            [this](const Connection* a, const Connection* b) {
+                              int cmp = CompareConnections(
+                                  a, b, rtc::Optional<int64_t>(), nullptr);
+                              if (cmp != 0) {
+                                return cmp > 0;
+                              }
+                              // Otherwise, sort based on latency estimate.
+                              return a->rtt() < b->rtt();
+                            }));
 
   LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                   << " available connections:";
@@ -1752,20 +1830,27 @@ Connection* P2PTransportChannel::FindNextPingableConnection() {
   // Otherwise, treat everything as unpinged.
   // TODO(honghaiz): Instead of adding two separate vectors, we can add a state
   // "pinged" to filter out unpinged connections.
-  if (std::find_if(unpinged_connections_.begin(), unpinged_connections_.end(),
-                   [this, now](Connection* conn) {
-                     return this->IsPingable(conn, now);
-                   }) == unpinged_connections_.end()) {
+  // The pingable connections are collected in the order of |connections_|,
+  // so that MorePingable() doesn't need to look them up to break ties.
+  std::vector<Connection*> pingable_connections;
+  for (Connection* conn : connections_) {
+    if (unpinged_connections_.count(conn) && IsPingable(conn, now)) {
+      pingable_connections.push_back(conn);
+    }
+  }
+  if (pingable_connections.empty()) {
     unpinged_connections_.insert(pinged_connections_.begin(),
                                  pinged_connections_.end());
     pinged_connections_.clear();
+    std::copy_if(connections_.begin(), connections_.end(),
+                 std::back_inserter(pingable_connections),
+                 [this, now](Connection* conn) {
+                   return IsPingable(conn, now);
+                 });
   }
 
   // Among un-pinged pingable connections, "more pingable" takes precedence.
-  std::vector<Connection*> pingable_connections;
-  std::copy_if(unpinged_connections_.begin(), unpinged_connections_.end(),
-               std::back_inserter(pingable_connections),
-               [this, now](Connection* conn) { return IsPingable(conn, now); });
+  // std::max_element() always passes the earlier connection first.
   auto iter =
       std::max_element(pingable_connections.begin(), pingable_connections.end(),
                        [this](Connection* conn1, Connection* conn2) {
@@ -2101,10 +2186,7 @@ Connection* P2PTransportChannel::MorePingable(Connection* conn1,
 
   // During the initial state when nothing has been pinged yet, return the first
   // one in the ordered |connections_|.
-  return *(std::find_if(connections_.begin(), connections_.end(),
-                        [conn1, conn2](Connection* conn) {
-                          return conn == conn1 || conn == conn2;
-                        }));
+  return conn1;
 }
 
 void P2PTransportChannel::set_writable(bool writable) {
@@ -304,7 +304,7 @@ class P2PTransportChannel : public IceTransportInternal,
 
   Connection* FindOldestConnectionNeedingTriggeredCheck(int64_t now);
   // Between |conn1| and |conn2|, this function returns the one which should
-  // be pinged first.
+  // be pinged first. |conn1| must come before |conn2| in |connections_|.
   Connection* MorePingable(Connection* conn1, Connection* conn2);
   // Select the connection which is Relay/Relay. If both of them are,
   // UDP relay protocol takes precedence.
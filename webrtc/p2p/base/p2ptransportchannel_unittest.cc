@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include <algorithm>
 #include <memory>
 
@@ -35,6 +37,7 @@
 #include "webrtc/rtc_base/socketaddress.h"
 #include "webrtc/rtc_base/ssladapter.h"
 #include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/virtualsocketserver.h"
 
 namespace {
@@ -4307,6 +4310,80 @@ TEST_F(P2PTransportChannelPingTest, TestPortDestroyedAfterTimeoutAndPruned) {
   EXPECT_EQ_SIMULATED_WAIT(nullptr, GetPrunedPort(&ch), 1, fake_clock);
 }
 
+// Test that with many connections that haven't been pinged yet, they are
+// all pinged once, in the order of their priority.
+TEST_F(P2PTransportChannelPingTest, TestManyConnectionsPingedInSortedOrder) {
+  rtc::ScopedFakeClock clock;
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch("many connections", 1, &pa);
+  PrepareChannel(&ch);
+  ch.MaybeStartGathering();
+  const int kNumConnections = 100;
+  std::vector<Connection*> connections;
+  for (int i = 0; i < kNumConnections; ++i) {
+    // Add them in an order which doesn't match their priority.
+    int priority = (i * 37) % kNumConnections + 1;
+    Connection* conn = CreateConnectionWithCandidate(
+        ch, clock, "1.1." + std::to_string(i / 250) + "." +
+                       std::to_string(i % 250 + 1),
+        1, priority, false);
+    ASSERT_TRUE(conn != nullptr);
+    connections.push_back(conn);
+  }
+  std::sort(connections.begin(), connections.end(),
+            [](const Connection* a, const Connection* b) {
+              return a->remote_candidate().priority() >
+                     b->remote_candidate().priority();
+            });
+  for (Connection* conn : connections) {
+    EXPECT_EQ(conn, FindNextPingableConnectionAndPingIt(&ch));
+  }
+}
+
+// Measures how long re-sorting the connections and finding the next one to
+// ping take, as the number of connections grows.
+TEST_F(P2PTransportChannelPingTest, DISABLED_BenchmarkManyConnections) {
+  rtc::ScopedFakeClock clock;
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch("benchmark", 1, &pa);
+  PrepareChannel(&ch);
+  ch.MaybeStartGathering();
+  const int kIterations = 200;
+  std::vector<Connection*> connections;
+  for (size_t num_connections : {16, 64, 256, 1024}) {
+    while (connections.size() < num_connections) {
+      int i = static_cast<int>(connections.size());
+      Connection* conn = CreateConnectionWithCandidate(
+          ch, clock, "1.1." + std::to_string(i / 250) + "." +
+                         std::to_string(i % 250 + 1),
+          1, i % 64 + 1, i % 2 == 0);
+      ASSERT_TRUE(conn != nullptr);
+      connections.push_back(conn);
+    }
+
+    int64_t start = rtc::SystemTimeNanos();
+    for (int i = 0; i < kIterations; ++i) {
+      Connection* conn = connections[(i * 7919) % num_connections];
+      if (conn->writable()) {
+        conn->ReceivedPingResponse(LOW_RTT + i % 100, "id");
+      }
+      conn->SignalStateChange(conn);
+      rtc::Thread::Current()->ProcessMessages(0);
+    }
+    double sort_us = static_cast<double>(rtc::SystemTimeNanos() - start) /
+                     kIterations / 1000;
+
+    start = rtc::SystemTimeNanos();
+    for (int i = 0; i < kIterations; ++i) {
+      FindNextPingableConnectionAndPingIt(&ch);
+    }
+    double ping_us = static_cast<double>(rtc::SystemTimeNanos() - start) /
+                     kIterations / 1000;
+    printf("%4zu connections: sort and update %8.1f us, next ping %8.1f us\n",
+           num_connections, sort_us, ping_us);
+  }
+}
+
 class P2PTransportChannelMostLikelyToWorkFirstTest
     : public P2PTransportChannelPingTest {
  public:
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "webrtc/p2p/base/packetlossestimator.h"
@@ -23,20 +24,37 @@ PacketLossEstimator::PacketLossEstimator(int64_t consider_lost_after_ms,
   RTC_DCHECK_LT(consider_lost_after_ms, forget_after_ms);
 }
 
-void PacketLossEstimator::ExpectResponse(std::string id, int64_t sent_time) {
-  tracked_packets_[id] = PacketInfo{sent_time, false};
+void PacketLossEstimator::ExpectResponse(const std::string& id,
+                                         int64_t sent_time) {
+  if (tracked_packet_count_ == tracked_packets_.size()) {
+    // Full, so unroll the packets into a buffer twice the size.
+    std::vector<PacketInfo> tracked_packets(
+        std::max<size_t>(2 * tracked_packets_.size(), 8));
+    for (size_t i = 0; i < tracked_packet_count_; ++i)
+      tracked_packets[i] = TrackedPacket(i);
+    tracked_packets_.swap(tracked_packets);
+    first_tracked_packet_ = 0;
+  }
+  PacketInfo& packet_info = TrackedPacket(tracked_packet_count_++);
+  packet_info.id = StunTransactionId(id);
+  packet_info.sent_time = sent_time;
+  packet_info.response_received = false;
 
   // Called to free memory in case the client hasn't called UpdateResponseRate
   // in a while.
   MaybeForgetOldRequests(sent_time);
 }
 
-void PacketLossEstimator::ReceivedResponse(std::string id,
+void PacketLossEstimator::ReceivedResponse(const std::string& id,
                                            int64_t received_time) {
-  auto iter = tracked_packets_.find(id);
-  if (iter != tracked_packets_.end()) {
-    auto& packet_info = iter->second;
-    packet_info.response_received = true;
+  // Responses mostly come for the latest requests, so search from the back.
+  const StunTransactionId transaction_id(id);
+  for (size_t i = tracked_packet_count_; i > 0; --i) {
+    PacketInfo& packet_info = TrackedPacket(i - 1);
+    if (packet_info.id == transaction_id) {
+      packet_info.response_received = true;
+      break;
+    }
   }
 
   // Called to free memory in case the client hasn't called UpdateResponseRate
@@ -45,22 +63,22 @@ void PacketLossEstimator::ReceivedResponse(std::string id,
 }
 
 void PacketLossEstimator::UpdateResponseRate(int64_t now) {
+  ForgetOldRequests(now);
+
   int responses_expected = 0;
   int responses_received = 0;
 
-  for (auto iter = tracked_packets_.begin(); iter != tracked_packets_.end();) {
-    const auto& packet_info = iter->second;
-    if (Forget(packet_info, now)) {
-      iter = tracked_packets_.erase(iter);
+  for (size_t i = 0; i < tracked_packet_count_; ++i) {
+    const PacketInfo& packet_info = TrackedPacket(i);
+    // Packets sent out of order may be left behind a newer one.
+    if (Forget(packet_info, now))
       continue;
-    }
     if (packet_info.response_received) {
       responses_expected += 1;
       responses_received += 1;
     } else if (ConsiderLost(packet_info, now)) {
       responses_expected += 1;
     }
-    ++iter;
   }
 
   if (responses_expected > 0) {
@@ -69,27 +87,38 @@ void PacketLossEstimator::UpdateResponseRate(int64_t now) {
   } else {
     response_rate_ = 1.0;
   }
-
-  last_forgot_at_ = now;
 }
 
 void PacketLossEstimator::MaybeForgetOldRequests(int64_t now) {
   if (now - last_forgot_at_ <= forget_after_ms_) {
     return;
   }
+  ForgetOldRequests(now);
+}
 
-  for (auto iter = tracked_packets_.begin(); iter != tracked_packets_.end();) {
-    const auto& packet_info = iter->second;
-    if (Forget(packet_info, now)) {
-      iter = tracked_packets_.erase(iter);
-    } else {
-      ++iter;
-    }
+void PacketLossEstimator::ForgetOldRequests(int64_t now) {
+  // The oldest packets are at the front.
+  while (tracked_packet_count_ > 0 && Forget(TrackedPacket(0), now)) {
+    first_tracked_packet_ =
+        (first_tracked_packet_ + 1) % tracked_packets_.size();
+    --tracked_packet_count_;
   }
 
   last_forgot_at_ = now;
 }
 
+PacketLossEstimator::PacketInfo& PacketLossEstimator::TrackedPacket(
+    size_t index) {
+  return tracked_packets_[(first_tracked_packet_ + index) %
+                          tracked_packets_.size()];
+}
+
+const PacketLossEstimator::PacketInfo& PacketLossEstimator::TrackedPacket(
+    size_t index) const {
+  return tracked_packets_[(first_tracked_packet_ + index) %
+                          tracked_packets_.size()];
+}
+
 bool PacketLossEstimator::ConsiderLost(const PacketInfo& packet_info,
                                        int64_t now) const {
   return packet_info.sent_time < now - consider_lost_after_ms_;
@@ -101,7 +130,7 @@ bool PacketLossEstimator::Forget(const PacketInfo& packet_info,
 }
 
 std::size_t PacketLossEstimator::tracked_packet_count_for_testing() const {
-  return tracked_packets_.size();
+  return tracked_packet_count_;
 }
 
 std::string PacketLossEstimator::TrackedPacketsStringForTesting(
@@ -109,10 +138,11 @@ std::string PacketLossEstimator::TrackedPacketsStringForTesting(
   std::ostringstream oss;
 
   size_t count = 0;
-  for (const auto& p : tracked_packets_) {
-    const auto& id = p.first;
-    const auto& packet_info = p.second;
-    oss << "{ " << id << ", " << packet_info.sent_time << "}, ";
+  for (size_t i = 0; i < tracked_packet_count_; ++i) {
+    const PacketInfo& packet_info = TrackedPacket(i);
+    oss << "{ "
+        << std::string(packet_info.id.data().data(), packet_info.id.size())
+        << ", " << packet_info.sent_time << "}, ";
     count += 1;
     if (count == max) {
       oss << "...";
@@ -13,12 +13,18 @@
 
 #include <stdint.h>
 #include <string>
-#include <unordered_map>
+#include <vector>
+
+#include "webrtc/p2p/base/stun.h"
 
 namespace cricket {
 
 // Estimates the response rate for a series of messages expecting responses.
-// Messages and their corresponding responses are identified by a string id.
+// Messages and their corresponding responses are identified by a string id of
+// at most 16 bytes, such as a STUN transaction ID. The ids are copied into a
+// ring buffer of the messages in the order they were sent, so tracking a
+// message allocates nothing once the buffer has grown to the number of
+// messages in flight.
 //
 // Responses are considered lost if they are not received within
 // |consider_lost_after_ms|. If a response is received after
@@ -41,10 +47,11 @@ class PacketLossEstimator {
                                int64_t forget_after_ms);
 
   // Registers that a message with the given |id| was sent at |sent_time|.
-  void ExpectResponse(std::string id, int64_t sent_time);
+  // Messages are expected to be registered in the order they are sent.
+  void ExpectResponse(const std::string& id, int64_t sent_time);
 
   // Registers a response with the given |id| was received at |received_time|.
-  void ReceivedResponse(std::string id, int64_t received_time);
+  void ReceivedResponse(const std::string& id, int64_t received_time);
 
   // Calculates the current response rate based on the expected and received
   // messages. Messages sent more than |forget_after| ms ago will be forgotten.
@@ -60,13 +67,19 @@ class PacketLossEstimator {
 
  private:
   struct PacketInfo {
+    StunTransactionId id;
     int64_t sent_time;
     bool response_received;
   };
 
+  // Returns the |index|th oldest tracked packet.
+  PacketInfo& TrackedPacket(size_t index);
+  const PacketInfo& TrackedPacket(size_t index) const;
+
   // Called periodically by ExpectResponse and ReceivedResponse to manage memory
   // usage.
   void MaybeForgetOldRequests(int64_t now);
+  void ForgetOldRequests(int64_t now);
 
   bool ConsiderLost(const PacketInfo&, int64_t now) const;
   bool Forget(const PacketInfo&, int64_t now) const;
@@ -76,7 +89,11 @@ class PacketLossEstimator {
 
   int64_t last_forgot_at_ = 0;
 
-  std::unordered_map<std::string, PacketInfo> tracked_packets_;
+  // A ring buffer of |tracked_packet_count_| packets starting at
+  // |first_tracked_packet_|, which is doubled in size when full.
+  std::vector<PacketInfo> tracked_packets_;
+  size_t first_tracked_packet_ = 0;
+  size_t tracked_packet_count_ = 0;
 
   double response_rate_ = 1.0;
 };
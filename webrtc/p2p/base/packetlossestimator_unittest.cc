@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string>
 #include <utility>
 
 #include "webrtc/p2p/base/packetlossestimator.h"
@@ -170,3 +171,21 @@ TEST_F(PacketLossEstimatorTest, ReceivedResponseForgetsOldPackets) {
   // a should be forgoten, b should not be tracked (received but not sent).
   EXPECT_EQ(0u, ple.tracked_packet_count_for_testing());
 }
+
+// Tests that the tracked messages are kept in order, and forgotten oldest
+// first, as they wrap around the ring buffer they are kept in.
+TEST_F(PacketLossEstimatorTest, TracksMessagesAcrossWrapAround) {
+  PacketLossEstimator ple(10, 50);
+  for (int i = 0; i < 1000; ++i) {
+    std::string id = std::to_string(i);
+    ple.ExpectResponse(id, i);
+    if (i % 2 == 1) {
+      ple.ReceivedResponse(id, i);
+    }
+  }
+  ple.UpdateResponseRate(1000);
+  // Messages 950 to 999 are tracked, of which 25 were responded to and the
+  // 20 even ones sent before 990 are lost.
+  EXPECT_EQ(50u, ple.tracked_packet_count_for_testing());
+  EXPECT_DOUBLE_EQ(25.0 / 45, ple.get_response_rate());
+}
@@ -241,11 +241,14 @@ void Port::SetIceParameters(int component,
 }
 
 Connection* Port::GetConnection(const rtc::SocketAddress& remote_addr) {
+  if (last_found_connection_ && remote_addr == last_found_address_)
+    return last_found_connection_;
   AddressMap::const_iterator iter = connections_.find(remote_addr);
-  if (iter != connections_.end())
-    return iter->second;
-  else
+  if (iter == connections_.end())
     return NULL;
+  last_found_address_ = remote_addr;
+  last_found_connection_ = iter->second;
+  return iter->second;
 }
 
 void Port::AddAddress(const rtc::SocketAddress& address,
@@ -306,6 +309,8 @@ void Port::AddOrReplaceConnection(Connection* conn) {
     LOG_J(LS_WARNING, this)
         << "A new connection was created on an existing remote address. "
         << "New remote candidate: " << conn->remote_candidate().ToString();
+    if (last_found_connection_ == ret.first->second)
+      last_found_connection_ = nullptr;
     ret.first->second->SignalDestroyed.disconnect(this);
     ret.first->second->Destroy();
     ret.first->second = conn;
@@ -740,6 +745,8 @@ void Port::OnConnectionDestroyed(Connection* conn) {
       connections_.find(conn->remote_candidate().address());
   RTC_DCHECK(iter != connections_.end());
   connections_.erase(iter);
+  if (last_found_connection_ == conn)
+    last_found_connection_ = nullptr;
   HandleConnectionDestroyed(conn);
 
   // Ports time out after all connections fail if it is not marked as
@@ -1171,12 +1178,12 @@ void Connection::PrintPingsSinceLastResponse(std::string* s, size_t max) {
   if (pings_since_last_response_.size() > max) {
     for (size_t i = 0; i < max; i++) {
       const SentPing& ping = pings_since_last_response_[i];
-      oss << rtc::hex_encode(ping.id) << " ";
+      oss << rtc::hex_encode(ping.id.data().data(), ping.id.size()) << " ";
     }
     oss << "... " << (pings_since_last_response_.size() - max) << " more";
   } else {
     for (const SentPing& ping : pings_since_last_response_) {
-      oss << rtc::hex_encode(ping.id) << " ";
+      oss << rtc::hex_encode(ping.id.data().data(), ping.id.size()) << " ";
     }
   }
   *s = oss.str();
@@ -1277,9 +1284,12 @@ void Connection::ReceivedPingResponse(int rtt, const std::string& request_id) {
   // So if we're not already, become writable. We may be bringing a pruned
   // connection back to life, but if we don't really want it, we can always
   // prune it again.
+  const StunTransactionId transaction_id(request_id);
   auto iter = std::find_if(
       pings_since_last_response_.begin(), pings_since_last_response_.end(),
-      [request_id](const SentPing& ping) { return ping.id == request_id; });
+      [&transaction_id](const SentPing& ping) {
+        return ping.id == transaction_id;
+      });
   if (iter != pings_since_last_response_.end() &&
       iter->nomination > acked_nomination_) {
     acked_nomination_ = iter->nomination;
@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/p2p/base/candidate.h"
@@ -241,8 +242,11 @@ class Port : public PortInterface, public rtc::MessageHandler,
   sigslot::signal1<Port*> SignalPortError;
 
   // Returns a map containing all of the connections of this port, keyed by the
-  // remote address.
-  typedef std::map<rtc::SocketAddress, Connection*> AddressMap;
+  // remote address. It's hashed since it's searched for every packet received.
+  typedef std::unordered_map<rtc::SocketAddress,
+                             Connection*,
+                             rtc::SocketAddressHasher>
+      AddressMap;
   const AddressMap& connections() { return connections_; }
 
   // Returns the connection to the given address or NULL if none exists.
@@ -420,6 +424,10 @@ class Port : public PortInterface, public rtc::MessageHandler,
   std::string password_;
   std::vector<Candidate> candidates_;
   AddressMap connections_;
+  // The result of the last GetConnection() that found one. Media mostly
+  // comes from one address, which this then finds without hashing it.
+  rtc::SocketAddress last_found_address_;
+  Connection* last_found_connection_ = nullptr;
   int timeout_delay_;
   bool enable_port_packets_;
   IceRole ice_role_;
@@ -446,10 +454,10 @@ class Connection : public CandidatePairInterface,
                    public sigslot::has_slots<> {
  public:
   struct SentPing {
-    SentPing(const std::string id, int64_t sent_time, uint32_t nomination)
+    SentPing(const std::string& id, int64_t sent_time, uint32_t nomination)
         : id(id), sent_time(sent_time), nomination(nomination) {}
 
-    std::string id;
+    StunTransactionId id;
     int64_t sent_time;
     uint32_t nomination;
   };
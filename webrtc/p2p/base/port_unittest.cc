@@ -2896,3 +2896,27 @@ TEST_F(PortTest, TestAddConnectionWithSameAddress) {
   rtc::Thread::Current()->ProcessMessages(300);
   EXPECT_TRUE(port->GetConnection(address) != nullptr);
 }
+
+TEST_F(PortTest, TestGetConnectionAfterConnectionDestroyed) {
+  std::unique_ptr<TestPort> port(
+      CreateTestPort(kLocalAddr1, "ufrag1", "password1"));
+  port->PrepareAddress();
+  rtc::SocketAddress address1("1.1.1.1", 5000);
+  rtc::SocketAddress address2("1.1.1.1", 5001);
+  cricket::Connection* conn1 = port->CreateConnection(
+      cricket::Candidate(1, "udp", address1, 0, "", "", "relay", 0, ""),
+      Port::ORIGIN_MESSAGE);
+  cricket::Connection* conn2 = port->CreateConnection(
+      cricket::Candidate(1, "udp", address2, 0, "", "", "relay", 0, ""),
+      Port::ORIGIN_MESSAGE);
+  // Look each up twice, the second time from the last one found.
+  EXPECT_EQ(conn1, port->GetConnection(address1));
+  EXPECT_EQ(conn1, port->GetConnection(address1));
+  EXPECT_EQ(conn2, port->GetConnection(address2));
+  EXPECT_EQ(conn2, port->GetConnection(address2));
+
+  conn2->Destroy();
+  rtc::Thread::Current()->ProcessMessages(0);
+  EXPECT_EQ(nullptr, port->GetConnection(address2));
+  EXPECT_EQ(conn1, port->GetConnection(address1));
+}
@@ -86,6 +86,21 @@ enum {
   // the application to work in a wider variety of environments, at the expense
   // of having to allocate additional candidates.
   PORTALLOCATOR_ENABLE_ANY_ADDRESS_PORTS = 0x8000,
+
+  // When specified along with PORTALLOCATOR_ENABLE_SHARED_SOCKET, the UDP
+  // ports of all the sessions of an allocator share one socket per local IP,
+  // instead of one per session, and the incoming packets are demultiplexed by
+  // ICE ufrag and remote address. TURN ports then use sockets of their own,
+  // since a TURN server tells allocations apart by the client address. Only
+  // supported by BasicPortAllocator with a socket factory.
+  PORTALLOCATOR_ENABLE_SHARED_SOCKET_ACROSS_SESSIONS = 0x10000,
+
+  // When specified, all the allocation phases of a network, STUN and TURN
+  // included, start at once instead of one step delay apart, which gets the
+  // relay candidates of clients behind restrictive NATs as early as the
+  // others. The candidates are still signaled as soon as each is ready, and
+  // the ports are created in the order of their candidates' priority.
+  PORTALLOCATOR_ENABLE_CONCURRENT_PHASES = 0x20000,
 };
 
 // Defines various reasons that have caused ICE regathering.
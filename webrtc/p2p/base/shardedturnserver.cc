@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/shardedturnserver.h"
+
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/p2p/base/port.h"
+#include "webrtc/rtc_base/asyncudpsocket.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+
+namespace cricket {
+
+namespace {
+
+const int kListenBacklog = 128;
+
+}  // namespace
+
+ShardedTurnServer::ShardedTurnServer(int num_shards) {
+  RTC_DCHECK_GT(num_shards, 0);
+  for (int i = 0; i < num_shards; ++i) {
+    std::unique_ptr<Shard> shard(new Shard());
+    shard->thread = rtc::Thread::CreateWithSocketServer();
+    shard->thread->SetName("TurnServerShard", shard.get());
+    shard->thread->Start();
+    // The server, and the sockets it owns, live on the shard's thread.
+    Shard* shard_ptr = shard.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE, [shard_ptr] {
+      shard_ptr->server.reset(new TurnServer(shard_ptr->thread.get()));
+    });
+    shards_.push_back(std::move(shard));
+  }
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    Shard* shard_ptr = shard.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE,
+                                [shard_ptr] { shard_ptr->server.reset(); });
+    shard->thread->Stop();
+  }
+}
+
+void ShardedTurnServer::set_realm(const std::string& realm) {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    TurnServer* server = shard->server.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE,
+                                [server, &realm] { server->set_realm(realm); });
+  }
+}
+
+void ShardedTurnServer::set_software(const std::string& software) {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    TurnServer* server = shard->server.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE, [server, &software] {
+      server->set_software(software);
+    });
+  }
+}
+
+void ShardedTurnServer::set_auth_hook(TurnAuthInterface* auth_hook) {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    TurnServer* server = shard->server.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE, [server, auth_hook] {
+      server->set_auth_hook(auth_hook);
+    });
+  }
+}
+
+void ShardedTurnServer::set_reject_private_addresses(bool filter) {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    TurnServer* server = shard->server.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE, [server, filter] {
+      server->set_reject_private_addresses(filter);
+    });
+  }
+}
+
+void ShardedTurnServer::set_enable_permission_checks(bool enable) {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    TurnServer* server = shard->server.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE, [server, enable] {
+      server->set_enable_permission_checks(enable);
+    });
+  }
+}
+
+bool ShardedTurnServer::AddInternalSocket(const rtc::SocketAddress& address,
+                                          ProtocolType proto) {
+  if (proto != PROTO_UDP && proto != PROTO_TCP) {
+    LOG(LS_ERROR) << "Unsupported internal protocol: " << ProtoToString(proto);
+    return false;
+  }
+  // A single shard doesn't share its port, and so works without
+  // SO_REUSEPORT too.
+  bool reuse_port = shards_.size() > 1;
+  rtc::SocketAddress bind_address = address;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    Shard* shard_ptr = shard.get();
+    rtc::SocketAddress bound_address;
+    bool result = shard->thread->Invoke<bool>(RTC_FROM_HERE, [&] {
+      return AddInternalSocketOnShard(shard_ptr, bind_address, proto,
+                                      reuse_port, &bound_address);
+    });
+    if (!result) {
+      return false;
+    }
+    // The other shards use the port the first one got.
+    bind_address = bound_address;
+  }
+  internal_addresses_.push_back(bind_address);
+  return true;
+}
+
+void ShardedTurnServer::SetExternalAddress(
+    const rtc::SocketAddress& address) {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    Shard* shard_ptr = shard.get();
+    shard->thread->Invoke<void>(RTC_FROM_HERE, [shard_ptr, &address] {
+      shard_ptr->server->SetExternalSocketFactory(
+          new rtc::BasicPacketSocketFactory(shard_ptr->thread.get()),
+          address);
+    });
+  }
+}
+
+size_t ShardedTurnServer::num_allocations() const {
+  size_t num_allocations = 0;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    TurnServer* server = shard->server.get();
+    num_allocations += shard->thread->Invoke<size_t>(
+        RTC_FROM_HERE, [server] { return server->allocations().size(); });
+  }
+  return num_allocations;
+}
+
+bool ShardedTurnServer::AddInternalSocketOnShard(
+    Shard* shard,
+    const rtc::SocketAddress& address,
+    ProtocolType proto,
+    bool reuse_port,
+    rtc::SocketAddress* bound_address) {
+  RTC_DCHECK(shard->thread->IsCurrent());
+  std::unique_ptr<rtc::AsyncSocket> socket(
+      shard->thread->socketserver()->CreateAsyncSocket(
+          address.family(), proto == PROTO_UDP ? SOCK_DGRAM : SOCK_STREAM));
+  if (!socket) {
+    LOG(LS_ERROR) << "Failed to create a socket for "
+                  << address.ToSensitiveString();
+    return false;
+  }
+  if (reuse_port && socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) < 0) {
+    LOG(LS_ERROR) << "Failed to share the port of "
+                  << address.ToSensitiveString()
+                  << " among the shards, err=" << socket->GetError();
+    return false;
+  }
+  if (socket->Bind(address) < 0) {
+    LOG(LS_ERROR) << "Failed to bind a socket to "
+                  << address.ToSensitiveString()
+                  << ", err=" << socket->GetError();
+    return false;
+  }
+  *bound_address = socket->GetLocalAddress();
+  if (proto == PROTO_UDP) {
+    shard->server->AddInternalSocket(new rtc::AsyncUDPSocket(socket.release()),
+                                     proto);
+    return true;
+  }
+  if (socket->Listen(kListenBacklog) < 0) {
+    LOG(LS_ERROR) << "Failed to listen on " << address.ToSensitiveString()
+                  << ", err=" << socket->GetError();
+    return false;
+  }
+  shard->server->AddInternalServerSocket(socket.release(), proto);
+  return true;
+}
+
+}  // namespace cricket
@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
+#define WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/turnserver.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/socketaddress.h"
+#include "webrtc/rtc_base/thread.h"
+
+namespace cricket {
+
+// Runs a TurnServer on each of several threads, so that relaying isn't
+// limited to what one thread can do. Every shard binds its own sockets to the
+// same internal addresses with Socket::OPT_REUSEPORT, and the kernel spreads
+// the clients among them by the hash of their 5-tuple; so all the packets of
+// a client, and its allocation, stay on one shard and the shards share no
+// state. This needs SO_REUSEPORT, so on platforms without it only one shard
+// can be used.
+// The auth hook is called on all the shard threads, so it must be
+// thread-safe. All methods must be called on the same thread.
+class ShardedTurnServer {
+ public:
+  explicit ShardedTurnServer(int num_shards);
+  ~ShardedTurnServer();
+
+  int num_shards() const { return static_cast<int>(shards_.size()); }
+
+  // These set up every shard, as the TurnServer methods of the same names.
+  void set_realm(const std::string& realm);
+  void set_software(const std::string& software);
+  // Does not take ownership.
+  void set_auth_hook(TurnAuthInterface* auth_hook);
+  void set_reject_private_addresses(bool filter);
+  void set_enable_permission_checks(bool enable);
+
+  // Binds a UDP socket, or a listening TCP socket, to |address| on every
+  // shard. If the port of |address| is 0, the first shard picks one and the
+  // others use it. Returns false if any shard fails to bind.
+  bool AddInternalSocket(const rtc::SocketAddress& address,
+                         ProtocolType proto);
+  // Relays from |address| on every shard.
+  void SetExternalAddress(const rtc::SocketAddress& address);
+
+  // The addresses bound by AddInternalSocket(), in order.
+  const std::vector<rtc::SocketAddress>& internal_addresses() const {
+    return internal_addresses_;
+  }
+  // The total number of allocations on all the shards.
+  size_t num_allocations() const;
+
+ private:
+  struct Shard {
+    std::unique_ptr<rtc::Thread> thread;
+    std::unique_ptr<TurnServer> server;
+  };
+
+  // Runs on the thread of |shard|.
+  static bool AddInternalSocketOnShard(Shard* shard,
+                                       const rtc::SocketAddress& address,
+                                       ProtocolType proto,
+                                       bool reuse_port,
+                                       rtc::SocketAddress* bound_address);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<rtc::SocketAddress> internal_addresses_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ShardedTurnServer);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
@@ -0,0 +1,177 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/shardedturnserver.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/rtc_base/asyncudpsocket.h"
+#include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/helpers.h"
+#include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/physicalsocketserver.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/rtc_base/thread.h"
+
+namespace cricket {
+
+namespace {
+
+const rtc::SocketAddress kLocalAddr("127.0.0.1", 0);
+const char kRealm[] = "example.org";
+const char kUsername[] = "user";
+const int kTimeoutMs = 5000;
+
+// Succeeds if the password is the same as the username.
+class TestAuth : public TurnAuthInterface {
+ public:
+  bool GetKey(const std::string& username,
+              const std::string& realm,
+              std::string* key) override {
+    return ComputeStunCredentialHash(username, realm, username, key);
+  }
+};
+
+// Allocates from a server with raw TURN messages.
+class TestTurnClient : public sigslot::has_slots<> {
+ public:
+  TestTurnClient(rtc::SocketServer* ss, const rtc::SocketAddress& server_addr)
+      : socket_(rtc::AsyncUDPSocket::Create(ss, kLocalAddr)),
+        server_addr_(server_addr) {
+    socket_->SignalReadPacket.connect(this, &TestTurnClient::OnReadPacket);
+  }
+
+  bool allocated() const { return allocated_; }
+
+  void SendAllocateRequest() {
+    TurnMessage request;
+    request.SetType(STUN_ALLOCATE_REQUEST);
+    request.SetTransactionID(
+        rtc::CreateRandomString(kStunTransactionIdLength));
+    auto transport_attr =
+        StunAttribute::CreateUInt32(STUN_ATTR_REQUESTED_TRANSPORT);
+    transport_attr->SetValue(IPPROTO_UDP << 24);
+    request.AddAttribute(std::move(transport_attr));
+    if (!nonce_.empty()) {
+      request.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+          STUN_ATTR_USERNAME, kUsername));
+      request.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+          STUN_ATTR_REALM, kRealm));
+      request.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+          STUN_ATTR_NONCE, nonce_));
+      std::string key;
+      ComputeStunCredentialHash(kUsername, kRealm, kUsername, &key);
+      request.AddMessageIntegrity(key);
+    }
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    socket_->SendTo(buf.Data(), buf.Length(), server_addr_,
+                    rtc::PacketOptions());
+  }
+
+ private:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    TurnMessage response;
+    rtc::ByteBufferReader buf(data, size);
+    if (!response.Read(&buf)) {
+      return;
+    }
+    if (response.type() == STUN_ALLOCATE_RESPONSE) {
+      allocated_ = true;
+      return;
+    }
+    const StunByteStringAttribute* nonce_attr =
+        response.GetByteString(STUN_ATTR_NONCE);
+    if (response.type() == STUN_ALLOCATE_ERROR_RESPONSE && nonce_attr &&
+        nonce_.empty()) {
+      // Retry with the credentials.
+      nonce_ = nonce_attr->GetString();
+      SendAllocateRequest();
+    }
+  }
+
+  std::unique_ptr<rtc::AsyncPacketSocket> socket_;
+  const rtc::SocketAddress server_addr_;
+  std::string nonce_;
+  bool allocated_ = false;
+};
+
+}  // namespace
+
+class ShardedTurnServerTest : public testing::Test {
+ public:
+  ShardedTurnServerTest() : thread_(&ss_) {}
+
+ protected:
+  void CreateServer(int num_shards) {
+    server_.reset(new ShardedTurnServer(num_shards));
+    server_->set_realm(kRealm);
+    server_->set_auth_hook(&auth_);
+    server_->SetExternalAddress(kLocalAddr);
+  }
+
+  // Allocates from |num_clients| clients, and returns how many succeeded.
+  int Allocate(int num_clients) {
+    std::vector<std::unique_ptr<TestTurnClient>> clients;
+    for (int i = 0; i < num_clients; ++i) {
+      clients.push_back(rtc::MakeUnique<TestTurnClient>(
+          &ss_, server_->internal_addresses()[0]));
+      clients.back()->SendAllocateRequest();
+    }
+    int num_allocated = 0;
+    for (const std::unique_ptr<TestTurnClient>& client : clients) {
+      EXPECT_TRUE_WAIT(client->allocated(), kTimeoutMs);
+      num_allocated += client->allocated() ? 1 : 0;
+    }
+    return num_allocated;
+  }
+
+  rtc::PhysicalSocketServer ss_;
+  rtc::AutoSocketServerThread thread_;
+  TestAuth auth_;
+  std::unique_ptr<ShardedTurnServer> server_;
+};
+
+TEST_F(ShardedTurnServerTest, AllocatesOnOneShard) {
+  CreateServer(1);
+  ASSERT_TRUE(server_->AddInternalSocket(kLocalAddr, PROTO_UDP));
+  EXPECT_EQ(4, Allocate(4));
+  EXPECT_EQ(4U, server_->num_allocations());
+}
+
+TEST_F(ShardedTurnServerTest, ShardsShareInternalPort) {
+  CreateServer(4);
+  EXPECT_EQ(4, server_->num_shards());
+  if (!server_->AddInternalSocket(kLocalAddr, PROTO_UDP)) {
+    LOG(LS_INFO) << "No SO_REUSEPORT... skipping";
+    return;
+  }
+  ASSERT_EQ(1U, server_->internal_addresses().size());
+  EXPECT_NE(0, server_->internal_addresses()[0].port());
+  // Each client's allocation is kept by whichever shard the kernel gives its
+  // packets to, so they all succeed.
+  EXPECT_EQ(32, Allocate(32));
+  EXPECT_EQ(32U, server_->num_allocations());
+}
+
+TEST_F(ShardedTurnServerTest, RejectsUnsupportedProtocol) {
+  CreateServer(2);
+  EXPECT_FALSE(server_->AddInternalSocket(kLocalAddr, PROTO_TLS));
+  EXPECT_TRUE(server_->internal_addresses().empty());
+}
+
+}  // namespace cricket
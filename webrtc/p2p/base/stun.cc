@@ -12,6 +12,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "webrtc/rtc_base/byteorder.h"
@@ -43,6 +44,43 @@ const char TURN_MAGIC_COOKIE_VALUE[] = { '\x72', '\xC6', '\x4B', '\xC6' };
 const char EMPTY_TRANSACTION_ID[] = "0000000000000000";
 const uint32_t STUN_FINGERPRINT_XOR_VALUE = 0x5354554E;
 
+namespace {
+
+// Computes the HMAC of the STUN message in |data| whose MESSAGE-INTEGRITY
+// attribute starts at |mi_pos|. As RFC 5389, section 15.4, requires, the
+// length in the header counts the message up to the end of that attribute;
+// only the header is copied to change it.
+bool ComputeMessageIntegrity(const char* data,
+                             size_t mi_pos,
+                             const std::string& password,
+                             char* hmac) {
+  std::unique_ptr<rtc::MessageDigest> digest(
+      rtc::MessageDigestFactory::Create(rtc::DIGEST_SHA_1));
+  if (!digest) {
+    return false;
+  }
+  // Writing new length of the STUN message @ Message Length in the header.
+  //      0                   1                   2                   3
+  //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //     |0 0|     STUN Message Type     |         Message Length        |
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  char header[kStunHeaderSize];
+  memcpy(header, data, kStunHeaderSize);
+  rtc::SetBE16(header + 2,
+               static_cast<uint16_t>(mi_pos + kStunAttributeHeaderSize +
+                                     kStunMessageIntegritySize -
+                                     kStunHeaderSize));
+  rtc::Hmac hmac_digest(digest.get(), password.c_str(), password.size());
+  hmac_digest.Update(header, sizeof(header));
+  hmac_digest.Update(data + kStunHeaderSize, mi_pos - kStunHeaderSize);
+  size_t ret = hmac_digest.Finish(hmac, kStunMessageIntegritySize);
+  RTC_DCHECK(ret == kStunMessageIntegritySize);
+  return ret == kStunMessageIntegritySize;
+}
+
+}  // namespace
+
 // StunMessage
 
 StunMessage::StunMessage()
@@ -171,33 +209,8 @@ bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
     return false;
   }
 
-  // Getting length of the message to calculate Message Integrity.
-  size_t mi_pos = current_pos;
-  std::unique_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
-  if (size > mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize) {
-    // Stun message has other attributes after message integrity.
-    // Adjust the length parameter in stun message to calculate HMAC.
-    size_t extra_offset = size -
-        (mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize);
-    size_t new_adjusted_len = size - extra_offset - kStunHeaderSize;
-
-    // Writing new length of the STUN message @ Message Length in temp buffer.
-    //      0                   1                   2                   3
-    //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    //     |0 0|     STUN Message Type     |         Message Length        |
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2, static_cast<uint16_t>(new_adjusted_len));
-  }
-
   char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      password.c_str(), password.size(),
-                                      temp_data.get(), mi_pos,
-                                      hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac))
+  if (!ComputeMessageIntegrity(data, current_pos, password, hmac))
     return false;
 
   // Comparing the calculated HMAC with the one present in the message.
@@ -929,4 +942,211 @@ bool ComputeStunCredentialHash(const std::string& username,
   return true;
 }
 
+// StunMessageView
+
+StunMessageView::StunMessageView()
+    : data_(nullptr),
+      size_(0),
+      type_(0),
+      username_(nullptr),
+      username_length_(0),
+      priority_(nullptr),
+      ice_controlling_(nullptr),
+      ice_controlled_(nullptr),
+      use_candidate_(nullptr),
+      xor_mapped_address_(nullptr),
+      xor_mapped_address_length_(0),
+      message_integrity_(nullptr) {}
+
+bool StunMessageView::Parse(const char* data, size_t size) {
+  *this = StunMessageView();
+  if (size < kStunHeaderSize)
+    return false;
+  uint16_t type = rtc::GetBE16(data);
+  if (type & 0x8000) {
+    // Not STUN; see StunMessage::Read().
+    return false;
+  }
+  if (rtc::GetBE16(data + 2) != size - kStunHeaderSize)
+    return false;
+
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    if (pos + kStunAttributeHeaderSize > size)
+      return false;
+    uint16_t attr_type = rtc::GetBE16(data + pos);
+    uint16_t attr_length = rtc::GetBE16(data + pos + 2);
+    const char* value = data + pos + kStunAttributeHeaderSize;
+    pos += kStunAttributeHeaderSize + attr_length;
+    if (pos > size)
+      return false;
+    // As in StunMessage::Read(), a known attribute of the wrong size makes
+    // the whole message malformed.
+    switch (attr_type) {
+      case STUN_ATTR_USERNAME:
+        if (!username_) {
+          username_ = value;
+          username_length_ = attr_length;
+        }
+        break;
+      case STUN_ATTR_PRIORITY:
+        if (attr_length != StunUInt32Attribute::SIZE)
+          return false;
+        if (!priority_)
+          priority_ = value;
+        break;
+      case STUN_ATTR_ICE_CONTROLLING:
+        if (attr_length != StunUInt64Attribute::SIZE)
+          return false;
+        if (!ice_controlling_)
+          ice_controlling_ = value;
+        break;
+      case STUN_ATTR_ICE_CONTROLLED:
+        if (attr_length != StunUInt64Attribute::SIZE)
+          return false;
+        if (!ice_controlled_)
+          ice_controlled_ = value;
+        break;
+      case STUN_ATTR_USE_CANDIDATE:
+        if (!use_candidate_)
+          use_candidate_ = value;
+        break;
+      case STUN_ATTR_XOR_MAPPED_ADDRESS:
+        if (attr_length != StunAddressAttribute::SIZE_IP4 &&
+            attr_length != StunAddressAttribute::SIZE_IP6)
+          return false;
+        if (!xor_mapped_address_) {
+          xor_mapped_address_ = value;
+          xor_mapped_address_length_ = attr_length;
+        }
+        break;
+      case STUN_ATTR_MESSAGE_INTEGRITY:
+        if (attr_length != kStunMessageIntegritySize)
+          return false;
+        if (!message_integrity_)
+          message_integrity_ = value;
+        break;
+      case STUN_ATTR_FINGERPRINT:
+        if (attr_length != StunUInt32Attribute::SIZE)
+          return false;
+        break;
+    }
+    // The padding of the last attribute may be missing.
+    if ((attr_length % 4) != 0)
+      pos = std::min(size, pos + 4 - (attr_length % 4));
+  }
+
+  data_ = data;
+  size_ = size;
+  type_ = type;
+  return true;
+}
+
+bool StunMessageView::IsLegacy() const {
+  RTC_DCHECK(data_);
+  return rtc::GetBE32(data_ + kStunTransactionIdOffset -
+                      kStunMagicCookieLength) != kStunMagicCookie;
+}
+
+rtc::ArrayView<const char> StunMessageView::transaction_id() const {
+  RTC_DCHECK(data_);
+  if (IsLegacy()) {
+    return rtc::ArrayView<const char>(
+        data_ + kStunTransactionIdOffset - kStunMagicCookieLength,
+        kStunLegacyTransactionIdLength);
+  }
+  return rtc::ArrayView<const char>(data_ + kStunTransactionIdOffset,
+                                    kStunTransactionIdLength);
+}
+
+rtc::ArrayView<const char> StunMessageView::username() const {
+  return rtc::ArrayView<const char>(username_, username_length_);
+}
+
+rtc::Optional<uint32_t> StunMessageView::priority() const {
+  return priority_ ? rtc::Optional<uint32_t>(rtc::GetBE32(priority_))
+                   : rtc::Optional<uint32_t>();
+}
+
+rtc::Optional<uint64_t> StunMessageView::ice_controlling() const {
+  return ice_controlling_
+             ? rtc::Optional<uint64_t>(rtc::GetBE64(ice_controlling_))
+             : rtc::Optional<uint64_t>();
+}
+
+rtc::Optional<uint64_t> StunMessageView::ice_controlled() const {
+  return ice_controlled_
+             ? rtc::Optional<uint64_t>(rtc::GetBE64(ice_controlled_))
+             : rtc::Optional<uint64_t>();
+}
+
+bool StunMessageView::GetXorMappedAddress(rtc::SocketAddress* address) const {
+  if (!xor_mapped_address_)
+    return false;
+  //      0                   1                   2                   3
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //     |x x x x x x x x|    Family     |         X-Port                |
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //     |                X-Address (Variable)
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  uint8_t family = static_cast<uint8_t>(xor_mapped_address_[1]);
+  uint16_t port = rtc::GetBE16(xor_mapped_address_ + 2) ^
+                  static_cast<uint16_t>(kStunMagicCookie >> 16);
+  const char* xored_ip = xor_mapped_address_ + 4;
+  if (family == STUN_ADDRESS_IPV4 &&
+      xor_mapped_address_length_ == StunAddressAttribute::SIZE_IP4) {
+    in_addr v4addr;
+    v4addr.s_addr =
+        rtc::HostToNetwork32(rtc::GetBE32(xored_ip) ^ kStunMagicCookie);
+    address->SetIP(rtc::IPAddress(v4addr));
+  } else if (family == STUN_ADDRESS_IPV6 &&
+             xor_mapped_address_length_ == StunAddressAttribute::SIZE_IP6 &&
+             !IsLegacy()) {
+    // The address is XORed with the magic cookie and the transaction id,
+    // which follow each other in the header.
+    const char* mask =
+        data_ + kStunTransactionIdOffset - kStunMagicCookieLength;
+    in6_addr v6addr;
+    for (size_t i = 0; i < sizeof(v6addr.s6_addr); ++i) {
+      v6addr.s6_addr[i] = static_cast<uint8_t>(xored_ip[i] ^ mask[i]);
+    }
+    address->SetIP(rtc::IPAddress(v6addr));
+  } else {
+    return false;
+  }
+  address->SetPort(port);
+  return true;
+}
+
+bool StunMessageView::ValidateMessageIntegrity(
+    const std::string& password) const {
+  if (!message_integrity_ || (size_ % 4) != 0)
+    return false;
+  size_t mi_pos = message_integrity_ - kStunAttributeHeaderSize - data_;
+  char hmac[kStunMessageIntegritySize];
+  if (!ComputeMessageIntegrity(data_, mi_pos, password, hmac))
+    return false;
+  return memcmp(message_integrity_, hmac, sizeof(hmac)) == 0;
+}
+
+bool StunMessageView::ValidateFingerprint() const {
+  return data_ && StunMessage::ValidateFingerprint(data_, size_);
+}
+
+StunTransactionId::StunTransactionId() : size_(0) {}
+
+StunTransactionId::StunTransactionId(rtc::ArrayView<const char> id)
+    : size_(static_cast<uint8_t>(
+          std::min(id.size(), kStunLegacyTransactionIdLength))) {
+  RTC_DCHECK_LE(id.size(), kStunLegacyTransactionIdLength);
+  memcpy(data_, id.data(), size_);
+}
+
+StunTransactionId::StunTransactionId(const std::string& id)
+    : StunTransactionId(rtc::ArrayView<const char>(id.data(), id.size())) {}
+
+bool StunTransactionId::operator==(const StunTransactionId& other) const {
+  return size_ == other.size_ && memcmp(data_, other.data_, size_) == 0;
+}
+
 }  // namespace cricket
@@ -17,8 +17,10 @@
 #include <string>
 #include <vector>
 
+#include "webrtc/rtc_base/array_view.h"
 #include "webrtc/rtc_base/basictypes.h"
 #include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/socketaddress.h"
 
 namespace cricket {
@@ -639,6 +641,83 @@ class IceMessage : public StunMessage {
   virtual StunMessage* CreateNew() const { return new IceMessage(); }
 };
 
+// A read-only view of a raw STUN message, for the packet paths that only need
+// a few attributes. Unlike StunMessage::Read(), Parse() allocates nothing and
+// doesn't copy the attributes; it just records where each of the ones below
+// is in |data|, which must outlive the view. The other attributes are only
+// skipped over, so best to use a StunMessage if more than these are needed.
+class StunMessageView {
+ public:
+  StunMessageView();
+
+  // Checks that |data| is a well-formed STUN message and finds its
+  // attributes. The return value indicates whether this was successful.
+  bool Parse(const char* data, size_t size);
+
+  int type() const { return type_; }
+  // See StunMessage::IsLegacy().
+  bool IsLegacy() const;
+  // 12 bytes, or 16 for a legacy message.
+  rtc::ArrayView<const char> transaction_id() const;
+
+  bool has_username() const { return username_ != nullptr; }
+  rtc::ArrayView<const char> username() const;
+  rtc::Optional<uint32_t> priority() const;
+  rtc::Optional<uint64_t> ice_controlling() const;
+  rtc::Optional<uint64_t> ice_controlled() const;
+  bool use_candidate() const { return use_candidate_ != nullptr; }
+  // Gets the unXORed address of the XOR-MAPPED-ADDRESS attribute. Returns
+  // false if there isn't one.
+  bool GetXorMappedAddress(rtc::SocketAddress* address) const;
+
+  bool has_message_integrity() const { return message_integrity_ != nullptr; }
+  // Like StunMessage::ValidateMessageIntegrity(), but without copying the
+  // message.
+  bool ValidateMessageIntegrity(const std::string& password) const;
+  // Like StunMessage::ValidateFingerprint().
+  bool ValidateFingerprint() const;
+
+ private:
+  const char* data_;
+  size_t size_;
+  uint16_t type_;
+  // Each of these points to the value of the first attribute of its type, or
+  // is null if there is none.
+  const char* username_;
+  uint16_t username_length_;
+  const char* priority_;
+  const char* ice_controlling_;
+  const char* ice_controlled_;
+  const char* use_candidate_;
+  const char* xor_mapped_address_;
+  uint16_t xor_mapped_address_length_;
+  const char* message_integrity_;
+};
+
+// A transaction ID held by value, for tracking many outstanding requests
+// without allocating a string for each of them.
+class StunTransactionId {
+ public:
+  StunTransactionId();
+  // |id| is at most 16 bytes, the length of a legacy transaction ID.
+  explicit StunTransactionId(rtc::ArrayView<const char> id);
+  explicit StunTransactionId(const std::string& id);
+
+  size_t size() const { return size_; }
+  rtc::ArrayView<const char> data() const {
+    return rtc::ArrayView<const char>(data_, size_);
+  }
+
+  bool operator==(const StunTransactionId& other) const;
+  bool operator!=(const StunTransactionId& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  char data_[kStunLegacyTransactionIdLength];
+  uint8_t size_;
+};
+
 }  // namespace cricket
 
 #endif  // WEBRTC_P2P_BASE_STUN_H_
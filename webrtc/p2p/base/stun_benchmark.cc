@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace cricket {
+
+// Reads an ICE connectivity check, as received many times per second on
+// every candidate pair.
+TEST(StunMessageBenchmark, ReadBindingRequest) {
+  IceMessage request;
+  request.SetType(STUN_BINDING_REQUEST);
+  ASSERT_TRUE(request.SetTransactionID("0123456789ab"));
+  request.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+      STUN_ATTR_USERNAME, "remoteufrag:localufrag"));
+  request.AddAttribute(
+      rtc::MakeUnique<StunUInt32Attribute>(STUN_ATTR_PRIORITY, 0x6e7f1eff));
+  request.AddAttribute(rtc::MakeUnique<StunUInt64Attribute>(
+      STUN_ATTR_ICE_CONTROLLING, 0x0123456789abcdefULL));
+  request.AddAttribute(
+      rtc::MakeUnique<StunByteStringAttribute>(STUN_ATTR_USE_CANDIDATE));
+  ASSERT_TRUE(request.AddMessageIntegrity("0123456789abcdefghijklmn"));
+  ASSERT_TRUE(request.AddFingerprint());
+  rtc::ByteBufferWriter writer;
+  ASSERT_TRUE(request.Write(&writer));
+
+  std::string username;
+  webrtc::test::RunBenchmark(
+      "StunMessage_ReadBindingRequest", writer.Length(), [&] {
+        IceMessage message;
+        rtc::ByteBufferReader reader(writer.Data(), writer.Length());
+        RTC_CHECK(message.Read(&reader));
+        username = message.GetByteString(STUN_ATTR_USERNAME)->GetString();
+      });
+  EXPECT_EQ("remoteufrag:localufrag", username);
+}
+
+}  // namespace cricket
@@ -1329,6 +1329,153 @@ TEST_F(StunTest, AddFingerprint) {
       reinterpret_cast<const char*>(buf1.Data()), buf1.Length()));
 }
 
+// Test that a StunMessageView finds the ICE attributes of the RFC5769 sample
+// request, and validates it like StunMessage does.
+TEST_F(StunTest, ParseRfc5769RequestMessageView) {
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                         sizeof(kRfc5769SampleRequest)));
+  EXPECT_EQ(STUN_BINDING_REQUEST, view.type());
+  EXPECT_FALSE(view.IsLegacy());
+  ASSERT_EQ(kStunTransactionIdLength, view.transaction_id().size());
+  EXPECT_EQ(0, memcmp(view.transaction_id().data(),
+                      kRfc5769SampleMsgTransactionId,
+                      kStunTransactionIdLength));
+
+  ASSERT_TRUE(view.has_username());
+  EXPECT_EQ(kRfc5769SampleMsgUsername,
+            std::string(view.username().data(), view.username().size()));
+  EXPECT_EQ(rtc::Optional<uint32_t>(0x6e0001ff), view.priority());
+  EXPECT_EQ(rtc::Optional<uint64_t>(0x932ff9b151263b36ULL),
+            view.ice_controlled());
+  EXPECT_FALSE(view.ice_controlling());
+  EXPECT_FALSE(view.use_candidate());
+  rtc::SocketAddress addr;
+  EXPECT_FALSE(view.GetXorMappedAddress(&addr));
+
+  EXPECT_TRUE(view.has_message_integrity());
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_FALSE(view.ValidateMessageIntegrity("InvalidPassword"));
+  EXPECT_TRUE(view.ValidateFingerprint());
+
+  // Munging a bit of the HMAC is caught, but munging the fingerprint isn't.
+  char buf[sizeof(kRfc5769SampleRequest)];
+  memcpy(buf, kRfc5769SampleRequest, sizeof(kRfc5769SampleRequest));
+  buf[sizeof(buf) - 12] ^= 0x01;
+  ASSERT_TRUE(view.Parse(buf, sizeof(buf)));
+  EXPECT_FALSE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+  buf[sizeof(buf) - 12] ^= 0x01;
+  buf[sizeof(buf) - 1] ^= 0x01;
+  ASSERT_TRUE(view.Parse(buf, sizeof(buf)));
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_FALSE(view.ValidateFingerprint());
+}
+
+TEST_F(StunTest, ParseRfc5769ResponseMessageViews) {
+  StunMessageView view;
+  rtc::SocketAddress addr;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleResponse),
+                         sizeof(kRfc5769SampleResponse)));
+  EXPECT_EQ(STUN_BINDING_RESPONSE, view.type());
+  EXPECT_FALSE(view.has_username());
+  EXPECT_FALSE(view.priority());
+  ASSERT_TRUE(view.GetXorMappedAddress(&addr));
+  EXPECT_EQ(kRfc5769SampleMsgMappedAddress, addr);
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+
+  ASSERT_TRUE(
+      view.Parse(reinterpret_cast<const char*>(kRfc5769SampleResponseIPv6),
+                 sizeof(kRfc5769SampleResponseIPv6)));
+  ASSERT_TRUE(view.GetXorMappedAddress(&addr));
+  EXPECT_EQ(kRfc5769SampleMsgIPv6MappedAddress, addr);
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+
+  // Without the FINGERPRINT, the M-I is the last attribute.
+  ASSERT_TRUE(view.Parse(
+      reinterpret_cast<const char*>(kRfc5769SampleRequestLongTermAuth),
+      sizeof(kRfc5769SampleRequestLongTermAuth)));
+  EXPECT_EQ(kRfc5769SampleMsgWithAuthUsername,
+            std::string(view.username().data(), view.username().size()));
+  std::string key;
+  ComputeStunCredentialHash(kRfc5769SampleMsgWithAuthUsername,
+      kRfc5769SampleMsgWithAuthRealm, kRfc5769SampleMsgWithAuthPassword, &key);
+  EXPECT_TRUE(view.ValidateMessageIntegrity(key));
+  EXPECT_FALSE(view.ValidateFingerprint());
+}
+
+// Test that a StunMessageView reads what an IceMessage writes.
+TEST_F(StunTest, ParseWrittenIceMessageView) {
+  IceMessage msg;
+  msg.SetType(STUN_BINDING_REQUEST);
+  msg.SetTransactionID(std::string(
+      reinterpret_cast<const char*>(kTestTransactionId1),
+      kStunTransactionIdLength));
+  msg.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+      STUN_ATTR_USERNAME, kTestUserName2));
+  msg.AddAttribute(
+      rtc::MakeUnique<StunUInt64Attribute>(STUN_ATTR_ICE_CONTROLLING, 1234));
+  msg.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+      STUN_ATTR_USE_CANDIDATE));
+  EXPECT_TRUE(msg.AddMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_TRUE(msg.AddFingerprint());
+  rtc::ByteBufferWriter buf;
+  EXPECT_TRUE(msg.Write(&buf));
+
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(buf.Data(), buf.Length()));
+  EXPECT_EQ(kTestUserName2,
+            std::string(view.username().data(), view.username().size()));
+  EXPECT_EQ(rtc::Optional<uint64_t>(1234), view.ice_controlling());
+  EXPECT_FALSE(view.ice_controlled());
+  EXPECT_TRUE(view.use_candidate());
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_TRUE(view.ValidateFingerprint());
+}
+
+TEST_F(StunTest, ParseLegacyMessageView) {
+  unsigned char rfc3489_packet[sizeof(kStunMessageWithIPv4MappedAddress)];
+  memcpy(rfc3489_packet, kStunMessageWithIPv4MappedAddress,
+      sizeof(kStunMessageWithIPv4MappedAddress));
+  memcpy(&rfc3489_packet[4], "ABCD", 4);
+
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(rfc3489_packet),
+                         sizeof(rfc3489_packet)));
+  EXPECT_TRUE(view.IsLegacy());
+  ASSERT_EQ(kStunLegacyTransactionIdLength, view.transaction_id().size());
+  EXPECT_EQ(0, memcmp(view.transaction_id().data(), &rfc3489_packet[4],
+                      kStunLegacyTransactionIdLength));
+}
+
+TEST_F(StunTest, FailToParseInvalidMessageViews) {
+  StunMessageView view;
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kStunMessageWithZeroLength),
+      kRealLengthOfInvalidLengthTestCases));
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kStunMessageWithSmallLength),
+      kRealLengthOfInvalidLengthTestCases));
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kStunMessageWithExcessLength),
+      kRealLengthOfInvalidLengthTestCases));
+  EXPECT_FALSE(view.Parse(reinterpret_cast<const char*>(kRtcpPacket),
+                          sizeof(kRtcpPacket)));
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kRfc5769SampleRequest), kStunHeaderSize));
+  // A truncated M-I doesn't cause a buffer overflow.
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kStunMessageWithBadHmacAtEnd),
+      sizeof(kStunMessageWithBadHmacAtEnd)));
+  EXPECT_FALSE(view.has_message_integrity());
+  EXPECT_FALSE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+
+  // An attribute running past the end of the message.
+  char buf[sizeof(kRfc5769SampleRequest)];
+  memcpy(buf, kRfc5769SampleRequest, sizeof(kRfc5769SampleRequest));
+  rtc::SetBE16(&buf[sizeof(buf) - 6], 8);
+  EXPECT_FALSE(view.Parse(buf, sizeof(buf)));
+}
+
 // Sample "GTURN" relay message.
 static const unsigned char kRelayMessage[] = {
   0x00, 0x01, 0x00, 88,    // message header
@@ -267,6 +267,8 @@ DtlsTransportInternal* TransportController::CreateDtlsTransport_n(
       this, &TransportController::OnChannelReceivingState_n);
   dtls->SignalDtlsHandshakeError.connect(
       this, &TransportController::OnDtlsHandshakeError);
+  dtls->SignalDtlsHandshakeTime.connect(
+      this, &TransportController::OnDtlsHandshakeTime);
   dtls->ice_transport()->SignalGatheringState.connect(
       this, &TransportController::OnChannelGatheringState_n);
   dtls->ice_transport()->SignalCandidateGathered.connect(
@@ -888,4 +890,8 @@ void TransportController::OnDtlsHandshakeError(rtc::SSLHandshakeError error) {
   SignalDtlsHandshakeError(error);
 }
 
+void TransportController::OnDtlsHandshakeTime(int time_ms) {
+  SignalDtlsHandshakeTime(time_ms);
+}
+
 }  // namespace cricket
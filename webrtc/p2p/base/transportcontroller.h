@@ -164,6 +164,10 @@ class TransportController : public sigslot::has_slots<>,
 
   sigslot::signal1<rtc::SSLHandshakeError> SignalDtlsHandshakeError;
 
+  // Emitted whenever the DTLS handshake of a transport channel completes, with
+  // the time it took in milliseconds.
+  sigslot::signal1<int> SignalDtlsHandshakeTime;
+
  protected:
   // TODO(deadbeef): Get rid of these virtual methods. Used by
   // FakeTransportController currently, but FakeTransportController shouldn't
@@ -245,6 +249,7 @@ class TransportController : public sigslot::has_slots<>,
   void UpdateAggregateStates_n();
 
   void OnDtlsHandshakeError(rtc::SSLHandshakeError error);
+  void OnDtlsHandshakeTime(int time_ms);
 
   rtc::Thread* const signaling_thread_ = nullptr;
   rtc::Thread* const network_thread_ = nullptr;
@@ -18,11 +18,13 @@
 #include "webrtc/rtc_base/asyncpacketsocket.h"
 #include "webrtc/rtc_base/byteorder.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/helpers.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/nethelpers.h"
 #include "webrtc/rtc_base/ptr_util.h"
 #include "webrtc/rtc_base/socketaddress.h"
 #include "webrtc/rtc_base/stringencode.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace cricket {
 
@@ -42,6 +44,28 @@ static const size_t MAX_ALLOCATE_MISMATCH_RETRIES = 2;
 
 static const int TURN_SUCCESS_RESULT_CODE = 0;
 
+// Renewals of allocations, permissions and channel bindings are sent in slots
+// of this size on the clock, so that the renewals of all the TURN ports of the
+// process that fall in a slot are sent on a single wakeup of the thread.
+static const int TURN_RENEWAL_SLOT_MS = 5 * 1000;
+// Renewals are moved ahead by up to this much at random, so that those of
+// ports created together are spread over several slots rather than all
+// reaching the server at once.
+static const int TURN_RENEWAL_JITTER_MS = 30 * 1000;
+
+// Returns the delay to send a renewal due in |delay| ms with, which is at the
+// start of a renewal slot no more than TURN_RENEWAL_JITTER_MS ahead of it.
+static int GetRenewalDelay(int delay) {
+  if (delay <= TURN_RENEWAL_JITTER_MS + TURN_RENEWAL_SLOT_MS) {
+    return delay;
+  }
+  int64_t now = rtc::TimeMillis();
+  int64_t send_time =
+      now + delay - rtc::CreateRandomId() % TURN_RENEWAL_JITTER_MS;
+  send_time -= send_time % TURN_RENEWAL_SLOT_MS;
+  return static_cast<int>(send_time - now);
+}
+
 inline bool IsTurnChannelData(uint16_t msg_type) {
   return ((msg_type & 0xC000) == 0x4000);  // MSB are 0b01
 }
@@ -943,6 +967,10 @@ bool TurnPort::ScheduleRefresh(int lifetime) {
 }
 
 void TurnPort::SendRequest(StunRequest* req, int delay) {
+  // Only renewals are delayed.
+  if (delay > 0) {
+    delay = GetRenewalDelay(delay);
+  }
   request_manager_.SendDelayed(req, delay);
 }
 
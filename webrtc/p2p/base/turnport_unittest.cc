@@ -1037,6 +1037,23 @@ TEST_F(TurnPortTest, TestRefreshRequestGetsErrorResponse) {
   EXPECT_FALSE(turn_port_->HasRequests());
 }
 
+// Test that the refresh of an allocation is sent in the renewal window ahead
+// of the time it is due, one minute before the allocation expires.
+TEST_F(TurnPortTest, TestRefreshRequestSentInRenewalWindow) {
+  CreateTurnPort(kTurnUsername, kTurnPassword, kTurnUdpProtoAddr);
+  turn_port_->KeepAliveUntilPruned();
+  turn_port_->PrepareAddress();
+  EXPECT_TRUE_SIMULATED_WAIT(turn_ready_, kSimulatedRtt * 2, fake_clock_);
+
+  // The server grants allocations a lifetime of 10 minutes, and the renewal
+  // may be moved up to 30 seconds ahead, to the start of a 5 second slot.
+  fake_clock_.AdvanceTime(rtc::TimeDelta::FromSeconds(9 * 60 - 36));
+  EXPECT_FALSE(turn_refresh_success_);
+  fake_clock_.AdvanceTime(rtc::TimeDelta::FromSeconds(36));
+  EXPECT_TRUE_SIMULATED_WAIT(turn_refresh_success_, kSimulatedRtt * 2,
+                             fake_clock_);
+}
+
 // Test that TurnPort will not handle any incoming packets once it has been
 // closed.
 TEST_F(TurnPortTest, TestStopProcessingPacketsAfterClosed) {
@@ -18,6 +18,7 @@
 #include "webrtc/p2p/base/stun.h"
 #include "webrtc/rtc_base/bind.h"
 #include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/byteorder.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/helpers.h"
 #include "webrtc/rtc_base/logging.h"
@@ -501,8 +502,14 @@ void TurnServer::SendStun(TurnServerConnection* conn, StunMessage* msg) {
 
 void TurnServer::Send(TurnServerConnection* conn,
                       const rtc::ByteBufferWriter& buf) {
+  Send(conn, buf.Data(), buf.Length());
+}
+
+void TurnServer::Send(TurnServerConnection* conn,
+                      const char* data,
+                      size_t size) {
   rtc::PacketOptions options;
-  conn->socket()->SendTo(buf.Data(), buf.Length(), conn->src(), options);
+  conn->socket()->SendTo(data, size, conn->src(), options);
 }
 
 void TurnServer::OnAllocationDestroyed(TurnServerAllocation* allocation) {
@@ -581,16 +588,16 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
       key_(key) {
   external_socket_->SignalReadPacket.connect(
       this, &TurnServerAllocation::OnExternalPacket);
+  channel_data_in_place_ =
+      external_socket_->SetReceiveHeadroom(TURN_CHANNEL_HEADER_SIZE);
 }
 
 TurnServerAllocation::~TurnServerAllocation() {
-  for (ChannelList::iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    delete *it;
+  for (const auto& kv : channels_) {
+    delete kv.second;
   }
-  for (PermissionList::iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    delete *it;
+  for (const auto& kv : perms_) {
+    delete kv.second;
   }
   thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
   LOG_J(LS_INFO, this) << "Allocation destroyed";
@@ -766,7 +773,8 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
     channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
     channel1->SignalDestroyed.connect(this,
         &TurnServerAllocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    channels_[channel_id] = channel1;
+    channels_by_peer_[channel1->peer()] = channel1;
   } else {
     channel1->Refresh();
   }
@@ -804,8 +812,15 @@ void TurnServerAllocation::OnExternalPacket(
     const rtc::PacketTime& packet_time) {
   RTC_DCHECK(external_socket_.get() == socket);
   Channel* channel = FindChannel(addr);
-  if (channel) {
-    // There is a channel bound to this address. Send as a channel message.
+  if (channel && channel_data_in_place_) {
+    // There is a channel bound to this address. Send as a channel message,
+    // writing its header into the headroom that the socket left in front of
+    // the data, so that the data isn't copied.
+    char* message = const_cast<char*>(data) - TURN_CHANNEL_HEADER_SIZE;
+    rtc::SetBE16(message, static_cast<uint16_t>(channel->id()));
+    rtc::SetBE16(message + 2, static_cast<uint16_t>(size));
+    server_->Send(&conn_, message, TURN_CHANNEL_HEADER_SIZE + size);
+  } else if (channel) {
     rtc::ByteBufferWriter buf;
     buf.WriteUInt16(channel->id());
     buf.WriteUInt16(static_cast<uint16_t>(size));
@@ -849,7 +864,7 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
     perm = new Permission(thread_, addr);
     perm->SignalDestroyed.connect(
         this, &TurnServerAllocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
+    perms_[addr] = perm;
   } else {
     perm->Refresh();
   }
@@ -857,32 +872,20 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
 
 TurnServerAllocation::Permission* TurnServerAllocation::FindPermission(
     const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  PermissionMap::const_iterator it = perms_.find(addr);
+  return (it != perms_.end()) ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
-  }
-  return NULL;
+  ChannelMap::const_iterator it = channels_.find(channel_id);
+  return (it != channels_.end()) ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  ChannelAddressMap::const_iterator it = channels_by_peer_.find(addr);
+  return (it != channels_by_peer_.end()) ? it->second : NULL;
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -913,16 +916,14 @@ void TurnServerAllocation::OnMessage(rtc::Message* msg) {
 }
 
 void TurnServerAllocation::OnPermissionDestroyed(Permission* perm) {
-  PermissionList::iterator it = std::find(perms_.begin(), perms_.end(), perm);
-  RTC_DCHECK(it != perms_.end());
-  perms_.erase(it);
+  size_t erased = perms_.erase(perm->peer());
+  RTC_DCHECK_EQ(1U, erased);
 }
 
 void TurnServerAllocation::OnChannelDestroyed(Channel* channel) {
-  ChannelList::iterator it =
-      std::find(channels_.begin(), channels_.end(), channel);
-  RTC_DCHECK(it != channels_.end());
-  channels_.erase(it);
+  size_t erased = channels_.erase(channel->id());
+  erased += channels_by_peer_.erase(channel->peer());
+  RTC_DCHECK_EQ(2U, erased);
 }
 
 TurnServerAllocation::Permission::Permission(rtc::Thread* thread,
@@ -11,11 +11,11 @@
 #ifndef WEBRTC_P2P_BASE_TURNSERVER_H_
 #define WEBRTC_P2P_BASE_TURNSERVER_H_
 
-#include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/p2p/base/portinterface.h"
@@ -93,8 +93,20 @@ class TurnServerAllocation : public rtc::MessageHandler,
  private:
   class Channel;
   class Permission;
-  typedef std::list<Permission*> PermissionList;
-  typedef std::list<Channel*> ChannelList;
+  struct IPAddressHash {
+    size_t operator()(const rtc::IPAddress& ip) const {
+      return rtc::HashIP(ip);
+    }
+  };
+  // These are looked up for every relayed packet, so they're hashed; the
+  // channels both by number and by peer address.
+  typedef std::unordered_map<rtc::IPAddress, Permission*, IPAddressHash>
+      PermissionMap;
+  typedef std::unordered_map<int, Channel*> ChannelMap;
+  typedef std::unordered_map<rtc::SocketAddress,
+                             Channel*,
+                             rtc::SocketAddressHasher>
+      ChannelAddressMap;
 
   void HandleAllocateRequest(const TurnMessage* msg);
   void HandleRefreshRequest(const TurnMessage* msg);
@@ -134,8 +146,12 @@ class TurnServerAllocation : public rtc::MessageHandler,
   std::string username_;
   std::string origin_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  // Whether |external_socket_| leaves room for the ChannelData header in
+  // front of the packets it receives.
+  bool channel_data_in_place_ = false;
+  PermissionMap perms_;
+  ChannelMap channels_;
+  ChannelAddressMap channels_by_peer_;
 };
 
 // An interface through which the MD5 credential hash can be retrieved.
@@ -256,6 +272,7 @@ class TurnServer : public sigslot::has_slots<> {
 
   void SendStun(TurnServerConnection* conn, StunMessage* msg);
   void Send(TurnServerConnection* conn, const rtc::ByteBufferWriter& buf);
+  void Send(TurnServerConnection* conn, const char* data, size_t size);
 
   void OnAllocationDestroyed(TurnServerAllocation* allocation);
   void DestroyInternalSocket(rtc::AsyncPacketSocket* socket);
@@ -0,0 +1,292 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/udpsocketmultiplexer.h"
+
+#include <errno.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/rtc_base/byteorder.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+
+namespace cricket {
+
+namespace {
+
+// Returns the type of |data| if it looks like a STUN message, and -1
+// otherwise. ICE only uses STUN messages with the magic cookie, which follows
+// the type and the length.
+int GetStunType(const char* data, size_t size) {
+  if (size < kStunHeaderSize || (data[0] & 0xC0) != 0 ||
+      rtc::GetBE32(data + 4) != kStunMagicCookie) {
+    return -1;
+  }
+  return rtc::GetBE16(data);
+}
+
+std::string GetStunTransactionId(const char* data) {
+  return std::string(data + kStunTransactionIdOffset,
+                     kStunTransactionIdLength);
+}
+
+}  // namespace
+
+class UdpSocketMultiplexer::MultiplexedSocket : public rtc::AsyncPacketSocket {
+ public:
+  MultiplexedSocket(UdpSocketMultiplexer* multiplexer,
+                    const std::string& ice_ufrag)
+      : multiplexer_(multiplexer), ice_ufrag_(ice_ufrag) {}
+  ~MultiplexedSocket() override { Close(); }
+
+  const std::string& ice_ufrag() const { return ice_ufrag_; }
+  std::set<rtc::SocketAddress>& addresses() { return addresses_; }
+  std::deque<std::string>& transaction_ids() { return transaction_ids_; }
+  // Called when the multiplexer is destroyed.
+  void Detach() { multiplexer_ = nullptr; }
+
+  rtc::SocketAddress GetLocalAddress() const override {
+    return multiplexer_ ? multiplexer_->socket_->GetLocalAddress()
+                        : rtc::SocketAddress();
+  }
+  rtc::SocketAddress GetRemoteAddress() const override {
+    return rtc::SocketAddress();
+  }
+  int Send(const void* pv,
+           size_t cb,
+           const rtc::PacketOptions& options) override {
+    // Like the shared socket, this is never connected.
+    error_ = ENOTCONN;
+    return -1;
+  }
+  int SendTo(const void* pv,
+             size_t cb,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options) override {
+    if (!multiplexer_) {
+      error_ = ENOTCONN;
+      return -1;
+    }
+    return multiplexer_->SendTo(this, pv, cb, addr, options);
+  }
+  int Close() override {
+    if (multiplexer_) {
+      multiplexer_->RemoveSocket(this);
+      multiplexer_ = nullptr;
+    }
+    return 0;
+  }
+  State GetState() const override {
+    return multiplexer_ ? multiplexer_->socket_->GetState() : STATE_CLOSED;
+  }
+  // Options apply to the shared socket, and so to all the sockets sharing it.
+  int GetOption(rtc::Socket::Option opt, int* value) override {
+    return multiplexer_ ? multiplexer_->socket_->GetOption(opt, value) : -1;
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override {
+    return multiplexer_ ? multiplexer_->socket_->SetOption(opt, value) : -1;
+  }
+  int GetError() const override {
+    return multiplexer_ && error_ == 0 ? multiplexer_->socket_->GetError()
+                                       : error_;
+  }
+  void SetError(int error) override { error_ = error; }
+
+ private:
+  UdpSocketMultiplexer* multiplexer_;
+  const std::string ice_ufrag_;
+  // The remote addresses associated with this socket.
+  std::set<rtc::SocketAddress> addresses_;
+  // The STUN requests this socket sent, oldest first.
+  std::deque<std::string> transaction_ids_;
+  int error_ = 0;
+};
+
+UdpSocketMultiplexer::UdpSocketMultiplexer(rtc::AsyncPacketSocket* socket)
+    : socket_(socket) {
+  RTC_DCHECK(socket_);
+  socket_->SignalReadPacket.connect(this, &UdpSocketMultiplexer::OnReadPacket);
+  socket_->SignalSentPacket.connect(this, &UdpSocketMultiplexer::OnSentPacket);
+  socket_->SignalReadyToSend.connect(this,
+                                     &UdpSocketMultiplexer::OnReadyToSend);
+  socket_->SignalAddressReady.connect(this,
+                                      &UdpSocketMultiplexer::OnAddressReady);
+}
+
+UdpSocketMultiplexer::~UdpSocketMultiplexer() {
+  for (MultiplexedSocket* socket : sockets_) {
+    socket->Detach();
+  }
+}
+
+rtc::AsyncPacketSocket* UdpSocketMultiplexer::CreateSocket(
+    const std::string& ice_ufrag) {
+  MultiplexedSocket* socket = new MultiplexedSocket(this, ice_ufrag);
+  sockets_.insert(socket);
+  MultiplexedSocket*& ufrag_socket = sockets_by_ufrag_[ice_ufrag];
+  if (ufrag_socket) {
+    LOG(LS_WARNING) << "ICE ufrag " << ice_ufrag
+                    << " is already used by another multiplexed socket. "
+                    << "Only the new one will get its binding requests.";
+  }
+  ufrag_socket = socket;
+  return socket;
+}
+
+void UdpSocketMultiplexer::AssociateAddress(const rtc::SocketAddress& addr,
+                                            MultiplexedSocket* socket) {
+  MultiplexedSocket*& address_socket = sockets_by_address_[addr];
+  if (address_socket == socket) {
+    return;
+  }
+  if (address_socket) {
+    address_socket->addresses().erase(addr);
+  }
+  address_socket = socket;
+  socket->addresses().insert(addr);
+}
+
+void UdpSocketMultiplexer::RemoveSocket(MultiplexedSocket* socket) {
+  sockets_.erase(socket);
+  auto ufrag_it = sockets_by_ufrag_.find(socket->ice_ufrag());
+  if (ufrag_it != sockets_by_ufrag_.end() && ufrag_it->second == socket) {
+    sockets_by_ufrag_.erase(ufrag_it);
+  }
+  for (const rtc::SocketAddress& addr : socket->addresses()) {
+    sockets_by_address_.erase(addr);
+  }
+  for (const std::string& transaction_id : socket->transaction_ids()) {
+    auto it = sockets_by_transaction_id_.find(transaction_id);
+    if (it != sockets_by_transaction_id_.end() && it->second == socket) {
+      sockets_by_transaction_id_.erase(it);
+    }
+  }
+  if (sending_socket_ == socket) {
+    sending_socket_ = nullptr;
+  }
+}
+
+int UdpSocketMultiplexer::SendTo(MultiplexedSocket* socket,
+                                 const void* data,
+                                 size_t size,
+                                 const rtc::SocketAddress& addr,
+                                 const rtc::PacketOptions& options) {
+  AssociateAddress(addr, socket);
+  const char* bytes = static_cast<const char*>(data);
+  int stun_type = GetStunType(bytes, size);
+  if (stun_type >= 0 && IsStunRequestType(stun_type)) {
+    std::string transaction_id = GetStunTransactionId(bytes);
+    MultiplexedSocket*& request_socket =
+        sockets_by_transaction_id_[transaction_id];
+    // Retransmissions reuse the transaction id.
+    if (request_socket != socket) {
+      request_socket = socket;
+      std::deque<std::string>& transaction_ids = socket->transaction_ids();
+      transaction_ids.push_back(transaction_id);
+      if (transaction_ids.size() > kMaxPendingTransactionsPerSocket) {
+        auto it = sockets_by_transaction_id_.find(transaction_ids.front());
+        if (it != sockets_by_transaction_id_.end() && it->second == socket) {
+          sockets_by_transaction_id_.erase(it);
+        }
+        transaction_ids.pop_front();
+      }
+    }
+  }
+
+  sending_socket_ = socket;
+  int result = socket_->SendTo(data, size, addr, options);
+  sending_socket_ = nullptr;
+  return result;
+}
+
+UdpSocketMultiplexer::MultiplexedSocket*
+UdpSocketMultiplexer::FindSocketForPacket(const char* data,
+                                          size_t size,
+                                          const rtc::SocketAddress& addr) {
+  int stun_type = GetStunType(data, size);
+  if (stun_type == STUN_BINDING_REQUEST) {
+    // Only the USERNAME is needed, so the request isn't fully parsed here;
+    // the port it's routed to does that.
+    StunMessageView message;
+    if (message.Parse(data, size) && message.has_username()) {
+      rtc::ArrayView<const char> username = message.username();
+      const char* colon = std::find(username.begin(), username.end(), ':');
+      auto it = sockets_by_ufrag_.find(std::string(username.begin(), colon));
+      if (it != sockets_by_ufrag_.end()) {
+        AssociateAddress(addr, it->second);
+        return it->second;
+      }
+    }
+  } else if (stun_type >= 0 && (IsStunSuccessResponseType(stun_type) ||
+                                IsStunErrorResponseType(stun_type))) {
+    auto it = sockets_by_transaction_id_.find(GetStunTransactionId(data));
+    if (it != sockets_by_transaction_id_.end()) {
+      // The pending transaction ids of the socket are left as they are, since
+      // they are only used to clean up.
+      MultiplexedSocket* socket = it->second;
+      sockets_by_transaction_id_.erase(it);
+      return socket;
+    }
+  }
+
+  auto it = sockets_by_address_.find(addr);
+  return it != sockets_by_address_.end() ? it->second : nullptr;
+}
+
+void UdpSocketMultiplexer::OnReadPacket(rtc::AsyncPacketSocket* socket,
+                                        const char* data,
+                                        size_t size,
+                                        const rtc::SocketAddress& remote_addr,
+                                        const rtc::PacketTime& packet_time) {
+  RTC_DCHECK(socket == socket_.get());
+  MultiplexedSocket* multiplexed_socket =
+      FindSocketForPacket(data, size, remote_addr);
+  if (!multiplexed_socket) {
+    LOG(LS_VERBOSE) << "Dropping a packet from "
+                    << remote_addr.ToSensitiveString()
+                    << ", which no multiplexed socket is talking to.";
+    return;
+  }
+  multiplexed_socket->SignalReadPacket(multiplexed_socket, data, size,
+                                       remote_addr, packet_time);
+}
+
+void UdpSocketMultiplexer::OnSentPacket(rtc::AsyncPacketSocket* socket,
+                                        const rtc::SentPacket& sent_packet) {
+  if (sending_socket_) {
+    sending_socket_->SignalSentPacket(sending_socket_, sent_packet);
+  }
+}
+
+void UdpSocketMultiplexer::OnReadyToSend(rtc::AsyncPacketSocket* socket) {
+  // The handlers may destroy sockets.
+  std::vector<MultiplexedSocket*> sockets(sockets_.begin(), sockets_.end());
+  for (MultiplexedSocket* multiplexed_socket : sockets) {
+    if (sockets_.count(multiplexed_socket)) {
+      multiplexed_socket->SignalReadyToSend(multiplexed_socket);
+    }
+  }
+}
+
+void UdpSocketMultiplexer::OnAddressReady(rtc::AsyncPacketSocket* socket,
+                                          const rtc::SocketAddress& address) {
+  std::vector<MultiplexedSocket*> sockets(sockets_.begin(), sockets_.end());
+  for (MultiplexedSocket* multiplexed_socket : sockets) {
+    if (sockets_.count(multiplexed_socket)) {
+      multiplexed_socket->SignalAddressReady(multiplexed_socket, address);
+    }
+  }
+}
+
+}  // namespace cricket
@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_UDPSOCKETMULTIPLEXER_H_
+#define WEBRTC_P2P_BASE_UDPSOCKETMULTIPLEXER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "webrtc/rtc_base/asyncpacketsocket.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/socketaddress.h"
+
+namespace cricket {
+
+// Lets the ports of many sessions share one bound UDP socket, so that a
+// server with many sessions doesn't need a socket per session and network.
+// Each user gets an AsyncPacketSocket of its own from CreateSocket(), which
+// sends through the shared socket and only signals the packets meant for it:
+//  - STUN binding requests go to the socket of the ICE ufrag in their
+//    USERNAME attribute, which also associates the sender's address with it.
+//  - STUN responses go to the socket that sent the request.
+//  - Anything else goes to the socket associated with the sender's address,
+//    which is the one that last sent to, or got a binding request from, it.
+// So the ufrags must be unique among the users, and if two of them talk to
+// the same remote address, only the last one gets its media. Everything runs
+// on the thread of the shared socket.
+class UdpSocketMultiplexer : public sigslot::has_slots<> {
+ public:
+  // Takes ownership of |socket|.
+  explicit UdpSocketMultiplexer(rtc::AsyncPacketSocket* socket);
+  ~UdpSocketMultiplexer() override;
+
+  // Creates a socket that receives the binding requests for |ice_ufrag|.
+  // The socket is closed if this object is destroyed first.
+  rtc::AsyncPacketSocket* CreateSocket(const std::string& ice_ufrag);
+
+  size_t num_sockets() const { return sockets_.size(); }
+  const rtc::AsyncPacketSocket* socket() const { return socket_.get(); }
+
+ private:
+  class MultiplexedSocket;
+
+  // Forgets the oldest transactions of a socket beyond this many, since
+  // requests that are never answered would otherwise be kept forever.
+  static const size_t kMaxPendingTransactionsPerSocket = 64;
+
+  void AssociateAddress(const rtc::SocketAddress& addr,
+                        MultiplexedSocket* socket);
+  void RemoveSocket(MultiplexedSocket* socket);
+  int SendTo(MultiplexedSocket* socket,
+             const void* data,
+             size_t size,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options);
+  MultiplexedSocket* FindSocketForPacket(const char* data,
+                                         size_t size,
+                                         const rtc::SocketAddress& addr);
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time);
+  void OnSentPacket(rtc::AsyncPacketSocket* socket,
+                    const rtc::SentPacket& sent_packet);
+  void OnReadyToSend(rtc::AsyncPacketSocket* socket);
+  void OnAddressReady(rtc::AsyncPacketSocket* socket,
+                      const rtc::SocketAddress& address);
+
+  std::unique_ptr<rtc::AsyncPacketSocket> socket_;
+  std::set<MultiplexedSocket*> sockets_;
+  std::map<std::string, MultiplexedSocket*> sockets_by_ufrag_;
+  std::map<rtc::SocketAddress, MultiplexedSocket*> sockets_by_address_;
+  // The transaction ids of the STUN requests sent that haven't been answered.
+  std::map<std::string, MultiplexedSocket*> sockets_by_transaction_id_;
+  // The socket whose packet |socket_| is sending, to which SignalSentPacket
+  // is forwarded.
+  MultiplexedSocket* sending_socket_ = nullptr;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(UdpSocketMultiplexer);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_UDPSOCKETMULTIPLEXER_H_
@@ -0,0 +1,239 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/p2p/base/udpsocketmultiplexer.h"
+#include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/virtualsocketserver.h"
+
+namespace cricket {
+
+namespace {
+
+const rtc::SocketAddress kLocalAddr("11.11.11.11", 0);
+const rtc::SocketAddress kRemoteAddr1("22.22.22.22", 0);
+const rtc::SocketAddress kRemoteAddr2("33.33.33.33", 0);
+const rtc::SocketAddress kRemoteAddr3("44.44.44.44", 0);
+const char kUfrag1[] = "ufrag1";
+const char kUfrag2[] = "ufrag2";
+const char kTransactionId1[] = "transaction1";
+const char kTransactionId2[] = "transaction2";
+const int kTimeoutMs = 1000;
+
+std::string WriteStunMessage(int type,
+                             const std::string& transaction_id,
+                             const std::string& username) {
+  IceMessage message;
+  message.SetType(type);
+  message.SetTransactionID(transaction_id);
+  if (!username.empty()) {
+    message.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, username));
+  }
+  rtc::ByteBufferWriter buf;
+  message.Write(&buf);
+  return std::string(buf.Data(), buf.Length());
+}
+
+}  // namespace
+
+class UdpSocketMultiplexerTest : public testing::Test,
+                                 public sigslot::has_slots<> {
+ public:
+  UdpSocketMultiplexerTest()
+      : vss_(new rtc::VirtualSocketServer()),
+        thread_(vss_.get()),
+        factory_(rtc::Thread::Current()),
+        multiplexer_(new UdpSocketMultiplexer(
+            factory_.CreateUdpSocket(kLocalAddr, 0, 0))),
+        remote1_(CreateReceivingSocket(kRemoteAddr1)),
+        remote2_(CreateReceivingSocket(kRemoteAddr2)),
+        remote3_(CreateReceivingSocket(kRemoteAddr3)) {}
+
+ protected:
+  std::unique_ptr<rtc::AsyncPacketSocket> CreateMultiplexedSocket(
+      const std::string& ufrag) {
+    std::unique_ptr<rtc::AsyncPacketSocket> socket(
+        multiplexer_->CreateSocket(ufrag));
+    socket->SignalReadPacket.connect(this,
+                                     &UdpSocketMultiplexerTest::OnReadPacket);
+    socket->SignalSentPacket.connect(this,
+                                     &UdpSocketMultiplexerTest::OnSentPacket);
+    return socket;
+  }
+
+  std::unique_ptr<rtc::AsyncPacketSocket> CreateReceivingSocket(
+      const rtc::SocketAddress& addr) {
+    std::unique_ptr<rtc::AsyncPacketSocket> socket(
+        factory_.CreateUdpSocket(addr, 0, 0));
+    socket->SignalReadPacket.connect(this,
+                                     &UdpSocketMultiplexerTest::OnReadPacket);
+    return socket;
+  }
+
+  void Send(rtc::AsyncPacketSocket* from,
+            const std::string& packet,
+            const rtc::SocketAddress& to) {
+    EXPECT_EQ(static_cast<int>(packet.size()),
+              from->SendTo(packet.data(), packet.size(), to,
+                           rtc::PacketOptions()));
+  }
+
+  // Sends |packet| from |from| to the shared socket.
+  void SendToMultiplexer(rtc::AsyncPacketSocket* from,
+                         const std::string& packet) {
+    Send(from, packet, multiplexer_->socket()->GetLocalAddress());
+  }
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    received_[socket].push_back(std::string(data, size));
+  }
+
+  void OnSentPacket(rtc::AsyncPacketSocket* socket,
+                    const rtc::SentPacket& sent_packet) {
+    ++sent_packets_[socket];
+  }
+
+  std::unique_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::AutoSocketServerThread thread_;
+  rtc::BasicPacketSocketFactory factory_;
+  std::unique_ptr<UdpSocketMultiplexer> multiplexer_;
+  std::unique_ptr<rtc::AsyncPacketSocket> remote1_;
+  std::unique_ptr<rtc::AsyncPacketSocket> remote2_;
+  std::unique_ptr<rtc::AsyncPacketSocket> remote3_;
+  std::map<rtc::AsyncPacketSocket*, std::vector<std::string>> received_;
+  std::map<rtc::AsyncPacketSocket*, int> sent_packets_;
+};
+
+TEST_F(UdpSocketMultiplexerTest, BindingRequestsAreRoutedByUfrag) {
+  std::unique_ptr<rtc::AsyncPacketSocket> socket1 =
+      CreateMultiplexedSocket(kUfrag1);
+  std::unique_ptr<rtc::AsyncPacketSocket> socket2 =
+      CreateMultiplexedSocket(kUfrag2);
+  EXPECT_EQ(2U, multiplexer_->num_sockets());
+
+  std::string request = WriteStunMessage(
+      STUN_BINDING_REQUEST, kTransactionId1, std::string(kUfrag2) + ":remote");
+  SendToMultiplexer(remote1_.get(), request);
+  ASSERT_EQ_WAIT(1U, received_[socket2.get()].size(), kTimeoutMs);
+  EXPECT_EQ(request, received_[socket2.get()][0]);
+
+  // The remote address is now associated with the second socket.
+  SendToMultiplexer(remote1_.get(), "media");
+  ASSERT_EQ_WAIT(2U, received_[socket2.get()].size(), kTimeoutMs);
+  EXPECT_EQ("media", received_[socket2.get()][1]);
+  EXPECT_TRUE(received_[socket1.get()].empty());
+}
+
+TEST_F(UdpSocketMultiplexerTest, PacketsAreRoutedByRemoteAddress) {
+  std::unique_ptr<rtc::AsyncPacketSocket> socket1 =
+      CreateMultiplexedSocket(kUfrag1);
+  std::unique_ptr<rtc::AsyncPacketSocket> socket2 =
+      CreateMultiplexedSocket(kUfrag2);
+  Send(socket1.get(), "to remote1", remote1_->GetLocalAddress());
+  Send(socket2.get(), "to remote2", remote2_->GetLocalAddress());
+  ASSERT_EQ_WAIT(1U, received_[remote1_.get()].size(), kTimeoutMs);
+  ASSERT_EQ_WAIT(1U, received_[remote2_.get()].size(), kTimeoutMs);
+  EXPECT_EQ(multiplexer_->socket()->GetLocalAddress(),
+            socket1->GetLocalAddress());
+  EXPECT_EQ(socket1->GetLocalAddress(), socket2->GetLocalAddress());
+
+  // Nobody talked to the third remote address, so its packet is dropped.
+  SendToMultiplexer(remote3_.get(), "from remote3");
+  SendToMultiplexer(remote2_.get(), "from remote2");
+  SendToMultiplexer(remote1_.get(), "from remote1");
+  ASSERT_EQ_WAIT(1U, received_[socket1.get()].size(), kTimeoutMs);
+  ASSERT_EQ_WAIT(1U, received_[socket2.get()].size(), kTimeoutMs);
+  EXPECT_EQ("from remote1", received_[socket1.get()][0]);
+  EXPECT_EQ("from remote2", received_[socket2.get()][0]);
+}
+
+TEST_F(UdpSocketMultiplexerTest, StunResponsesAreRoutedByTransactionId) {
+  std::unique_ptr<rtc::AsyncPacketSocket> socket1 =
+      CreateMultiplexedSocket(kUfrag1);
+  std::unique_ptr<rtc::AsyncPacketSocket> socket2 =
+      CreateMultiplexedSocket(kUfrag2);
+  // Both sockets use the same STUN server.
+  Send(socket1.get(),
+       WriteStunMessage(STUN_BINDING_REQUEST, kTransactionId1, ""),
+       remote1_->GetLocalAddress());
+  Send(socket2.get(),
+       WriteStunMessage(STUN_BINDING_REQUEST, kTransactionId2, ""),
+       remote1_->GetLocalAddress());
+  ASSERT_EQ_WAIT(2U, received_[remote1_.get()].size(), kTimeoutMs);
+
+  std::string response1 =
+      WriteStunMessage(STUN_BINDING_RESPONSE, kTransactionId1, "");
+  std::string response2 =
+      WriteStunMessage(STUN_BINDING_ERROR_RESPONSE, kTransactionId2, "");
+  SendToMultiplexer(remote1_.get(), response1);
+  SendToMultiplexer(remote1_.get(), response2);
+  ASSERT_EQ_WAIT(1U, received_[socket1.get()].size(), kTimeoutMs);
+  ASSERT_EQ_WAIT(1U, received_[socket2.get()].size(), kTimeoutMs);
+  EXPECT_EQ(response1, received_[socket1.get()][0]);
+  EXPECT_EQ(response2, received_[socket2.get()][0]);
+}
+
+TEST_F(UdpSocketMultiplexerTest, SentPacketIsSignaledOnSendingSocket) {
+  std::unique_ptr<rtc::AsyncPacketSocket> socket1 =
+      CreateMultiplexedSocket(kUfrag1);
+  std::unique_ptr<rtc::AsyncPacketSocket> socket2 =
+      CreateMultiplexedSocket(kUfrag2);
+  Send(socket1.get(), "packet", remote1_->GetLocalAddress());
+  EXPECT_EQ(1, sent_packets_[socket1.get()]);
+  EXPECT_EQ(0, sent_packets_[socket2.get()]);
+}
+
+TEST_F(UdpSocketMultiplexerTest, DestroyedSocketStopsReceiving) {
+  std::unique_ptr<rtc::AsyncPacketSocket> socket1 =
+      CreateMultiplexedSocket(kUfrag1);
+  std::unique_ptr<rtc::AsyncPacketSocket> socket2 =
+      CreateMultiplexedSocket(kUfrag2);
+  Send(socket1.get(), "packet", remote1_->GetLocalAddress());
+  socket1.reset();
+  EXPECT_EQ(1U, multiplexer_->num_sockets());
+
+  SendToMultiplexer(remote1_.get(),
+                    WriteStunMessage(STUN_BINDING_REQUEST, kTransactionId1,
+                                     std::string(kUfrag1) + ":remote"));
+  SendToMultiplexer(remote1_.get(), "media");
+  // The packets before this one have arrived once it has, and were dropped.
+  std::string request = WriteStunMessage(
+      STUN_BINDING_REQUEST, kTransactionId2, std::string(kUfrag2) + ":remote");
+  SendToMultiplexer(remote1_.get(), request);
+  ASSERT_EQ_WAIT(1U, received_[socket2.get()].size(), kTimeoutMs);
+  EXPECT_EQ(request, received_[socket2.get()][0]);
+}
+
+TEST_F(UdpSocketMultiplexerTest, SocketIsClosedWhenMultiplexerIsDestroyed) {
+  std::unique_ptr<rtc::AsyncPacketSocket> socket =
+      CreateMultiplexedSocket(kUfrag1);
+  EXPECT_EQ(rtc::AsyncPacketSocket::STATE_BOUND, socket->GetState());
+  multiplexer_.reset();
+  EXPECT_EQ(rtc::AsyncPacketSocket::STATE_CLOSED, socket->GetState());
+  EXPECT_LT(socket->SendTo("packet", 6, remote1_->GetLocalAddress(),
+                           rtc::PacketOptions()),
+            0);
+}
+
+}  // namespace cricket
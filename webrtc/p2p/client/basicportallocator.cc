@@ -175,6 +175,20 @@ BasicPortAllocator::~BasicPortAllocator() {
   DiscardCandidatePool();
 }
 
+UdpSocketMultiplexer* BasicPortAllocator::GetUdpSocketMultiplexer(
+    const rtc::IPAddress& ip) {
+  std::unique_ptr<UdpSocketMultiplexer>& multiplexer =
+      udp_socket_multiplexers_[ip];
+  if (!multiplexer && socket_factory_) {
+    rtc::AsyncPacketSocket* socket = socket_factory_->CreateUdpSocket(
+        rtc::SocketAddress(ip, 0), min_port(), max_port());
+    if (socket) {
+      multiplexer.reset(new UdpSocketMultiplexer(socket));
+    }
+  }
+  return multiplexer.get();
+}
+
 PortAllocatorSession* BasicPortAllocator::CreateSessionInternal(
     const std::string& content_name, int component,
     const std::string& ice_ufrag, const std::string& ice_pwd) {
@@ -1106,9 +1120,21 @@ AllocationSequence::AllocationSequence(BasicPortAllocatorSession* session,
 
 void AllocationSequence::Init() {
   if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET)) {
-    udp_socket_.reset(session_->socket_factory()->CreateUdpSocket(
-        rtc::SocketAddress(network_->GetBestIP(), 0),
-        session_->allocator()->min_port(), session_->allocator()->max_port()));
+    if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET_ACROSS_SESSIONS)) {
+      UdpSocketMultiplexer* multiplexer =
+          session_->allocator()->GetUdpSocketMultiplexer(
+              network_->GetBestIP());
+      if (multiplexer) {
+        udp_socket_.reset(multiplexer->CreateSocket(session_->username()));
+        udp_socket_multiplexed_ = true;
+      }
+    }
+    if (!udp_socket_) {
+      udp_socket_.reset(session_->socket_factory()->CreateUdpSocket(
+          rtc::SocketAddress(network_->GetBestIP(), 0),
+          session_->allocator()->min_port(),
+          session_->allocator()->max_port()));
+    }
     if (udp_socket_) {
       udp_socket_->SignalReadPacket.connect(
           this, &AllocationSequence::OnReadPacket);
@@ -1224,9 +1250,12 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
 
   if (state() == kRunning) {
     ++phase_;
-    session_->network_thread()->PostDelayed(RTC_FROM_HERE,
-                                            session_->allocator()->step_delay(),
-                                            this, MSG_ALLOCATION_PHASE);
+    // With concurrent phases, the next phase runs right after this one.
+    const int delay_ms = IsFlagSet(PORTALLOCATOR_ENABLE_CONCURRENT_PHASES)
+                             ? 0
+                             : session_->allocator()->step_delay();
+    session_->network_thread()->PostDelayed(RTC_FROM_HERE, delay_ms, this,
+                                            MSG_ALLOCATION_PHASE);
   } else {
     // If all phases in AllocationSequence are completed, no allocation
     // steps needed further. Canceling  pending signal.
@@ -1428,7 +1457,8 @@ void AllocationSequence::CreateTurnPort(const RelayServerConfig& config) {
     // TODO(mallinath) - Enable shared socket mode for TURN ports. Disabled
     // due to webrtc bug https://code.google.com/p/webrtc/issues/detail?id=3537
     if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) &&
-        relay_port->proto == PROTO_UDP && udp_socket_) {
+        relay_port->proto == PROTO_UDP && udp_socket_ &&
+        !udp_socket_multiplexed_) {
       port = TurnPort::Create(session_->network_thread(),
                               session_->socket_factory(),
                               network_, udp_socket_.get(),
@@ -11,11 +11,13 @@
 #ifndef WEBRTC_P2P_CLIENT_BASICPORTALLOCATOR_H_
 #define WEBRTC_P2P_CLIENT_BASICPORTALLOCATOR_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "webrtc/p2p/base/portallocator.h"
+#include "webrtc/p2p/base/udpsocketmultiplexer.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/messagequeue.h"
 #include "webrtc/rtc_base/network.h"
@@ -63,6 +65,12 @@ class BasicPortAllocator : public PortAllocator {
   // Convenience method that adds a TURN server to the configuration.
   void AddTurnServer(const RelayServerConfig& turn_server);
 
+  // Returns the multiplexer of the UDP socket that the sessions share on |ip|
+  // with PORTALLOCATOR_ENABLE_SHARED_SOCKET_ACROSS_SESSIONS, creating it if
+  // needed. Returns null if there is no socket factory or the socket can't be
+  // created.
+  UdpSocketMultiplexer* GetUdpSocketMultiplexer(const rtc::IPAddress& ip);
+
  private:
   void Construct();
 
@@ -73,6 +81,8 @@ class BasicPortAllocator : public PortAllocator {
   rtc::PacketSocketFactory* socket_factory_;
   bool allow_tcp_listen_;
   int network_ignore_mask_ = rtc::kDefaultNetworkIgnoreMask;
+  std::map<rtc::IPAddress, std::unique_ptr<UdpSocketMultiplexer>>
+      udp_socket_multiplexers_;
 };
 
 struct PortConfiguration;
@@ -372,6 +382,8 @@ class AllocationSequence : public rtc::MessageHandler,
   uint32_t flags_;
   ProtocolList protocols_;
   std::unique_ptr<rtc::AsyncPacketSocket> udp_socket_;
+  // Whether |udp_socket_| is shared with other sessions.
+  bool udp_socket_multiplexed_ = false;
   // There will be only one udp port per AllocationSequence.
   UDPPort* udp_port_;
   std::vector<TurnPort*> turn_ports_;
@@ -86,6 +86,8 @@ static const int kMaxPort = 10099;
 static const char kIceUfrag0[] = "UF00";
 // Based on ICE_PWD_LENGTH
 static const char kIcePwd0[] = "TESTICEPWD00000000000000";
+static const char kIceUfrag1[] = "UF01";
+static const char kIcePwd1[] = "TESTICEPWD00000000000001";
 
 static const char kContentName[] = "test content";
 
@@ -971,6 +973,29 @@ TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Verify that with concurrent phases, the relay and TCP candidates are
+// gathered right away instead of one step delay after another.
+TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithConcurrentPhases) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_CONCURRENT_PHASES);
+  EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  const int64_t start_ms = rtc::TimeMillis();
+  session_->StartGettingPorts();
+  ASSERT_EQ_SIMULATED_WAIT(7U, candidates_.size(), kDefaultStepDelay,
+                           fake_clock);
+  EXPECT_PRED4(HasCandidate, candidates_, "relay", "udp", kRelayUdpIntAddr);
+  EXPECT_PRED4(HasCandidate, candidates_, "relay", "tcp", kRelayTcpIntAddr);
+  EXPECT_PRED4(HasCandidate, candidates_, "relay", "ssltcp",
+               kRelaySslTcpIntAddr);
+  EXPECT_EQ(4U, ports_.size());
+  EXPECT_TRUE(candidate_allocation_done_);
+  // The default step delay would have taken three steps.
+  EXPECT_LT(rtc::TimeMillis() - start_ms, kDefaultStepDelay);
+  session_->StopGettingPorts();
+}
+
 TEST_F(BasicPortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP, CN_VIDEO));
@@ -1477,6 +1502,43 @@ TEST_F(BasicPortAllocatorTest, TestSharedSocketWithNat) {
   EXPECT_EQ(3U, candidates_.size());
 }
 
+// Test that when PORTALLOCATOR_ENABLE_SHARED_SOCKET_ACROSS_SESSIONS is enabled
+// the UDP ports of two sessions share one socket, and that both sessions still
+// get their STUN candidates.
+TEST_F(BasicPortAllocatorTest, TestSharedSocketAcrossSessionsWithNat) {
+  AddInterface(kClientAddr);
+  ResetWithStunServerAndNat(kStunAddr);
+
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_SHARED_SOCKET |
+                        PORTALLOCATOR_ENABLE_SHARED_SOCKET_ACROSS_SESSIONS |
+                        PORTALLOCATOR_DISABLE_TCP);
+  std::unique_ptr<PortAllocatorSession> session1 =
+      CreateSession("session1", kContentName, ICE_CANDIDATE_COMPONENT_RTP,
+                    kIceUfrag0, kIcePwd0);
+  std::unique_ptr<PortAllocatorSession> session2 =
+      CreateSession("session2", kContentName, ICE_CANDIDATE_COMPONENT_RTP,
+                    kIceUfrag1, kIcePwd1);
+  session1->StartGettingPorts();
+  session2->StartGettingPorts();
+  EXPECT_EQ_SIMULATED_WAIT(
+      2, CountCandidates(candidates_, "stun", "udp",
+                         rtc::SocketAddress(kNatUdpAddr.ipaddr(), 0)),
+      kDefaultAllocationTimeout, fake_clock);
+  ASSERT_EQ(2, CountCandidates(candidates_, "local", "udp", kClientAddr));
+  EXPECT_EQ(2U, ports_.size());
+
+  const UdpSocketMultiplexer* multiplexer =
+      allocator().GetUdpSocketMultiplexer(kClientAddr.ipaddr());
+  ASSERT_TRUE(multiplexer != nullptr);
+  EXPECT_EQ(2U, multiplexer->num_sockets());
+  for (const Candidate& candidate : candidates_) {
+    if (candidate.type() == "local") {
+      EXPECT_EQ(multiplexer->socket()->GetLocalAddress(), candidate.address());
+    }
+  }
+}
+
 // Test TURN port in shared socket mode with UDP and TCP TURN server addresses.
 TEST_F(BasicPortAllocatorTest, TestSharedSocketWithoutNatUsingTurn) {
   turn_server_.AddInternalSocket(kTurnTcpIntAddr, PROTO_TCP);
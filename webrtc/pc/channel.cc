@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <set>
 #include <utility>
 
 #include "webrtc/pc/channel.h"
@@ -74,6 +75,17 @@ static void SafeSetError(const std::string& message, std::string* error_desc) {
   }
 }
 
+// Returns the ssrcs of all of |streams|, so that the streams of two
+// descriptions can be diffed without the linear GetStreamBySsrc lookup per
+// stream, which is quadratic for descriptions with hundreds of tracks.
+static std::set<uint32_t> GetAllSsrcs(const StreamParamsVec& streams) {
+  std::set<uint32_t> ssrcs;
+  for (const StreamParams& stream : streams) {
+    ssrcs.insert(stream.ssrcs.begin(), stream.ssrcs.end());
+  }
+  return ssrcs;
+}
+
 struct VoiceChannelErrorMessageData : public rtc::MessageData {
   VoiceChannelErrorMessageData(uint32_t in_ssrc,
                                VoiceMediaChannel::Error in_error)
@@ -828,14 +840,20 @@ void BaseChannel::ProcessPacket(bool rtcp,
   }
 }
 
+const MediaContentDescription* BaseChannel::GetAcceptedContent(
+    const SessionDescription* sdesc) {
+  const ContentInfo* content_info = GetFirstContent(sdesc);
+  if (!content_info || content_info->rejected) {
+    return nullptr;
+  }
+  return GetContentDescription(content_info);
+}
+
 bool BaseChannel::PushdownLocalDescription(
     const SessionDescription* local_desc, ContentAction action,
     std::string* error_desc) {
-  const ContentInfo* content_info = GetFirstContent(local_desc);
-  const MediaContentDescription* content_desc =
-      GetContentDescription(content_info);
-  if (content_desc && content_info && !content_info->rejected &&
-      !SetLocalContent(content_desc, action, error_desc)) {
+  const MediaContentDescription* content_desc = GetAcceptedContent(local_desc);
+  if (content_desc && !SetLocalContent(content_desc, action, error_desc)) {
     LOG(LS_ERROR) << "Failure in SetLocalContent with action " << action;
     return false;
   }
@@ -845,11 +863,9 @@ bool BaseChannel::PushdownLocalDescription(
 bool BaseChannel::PushdownRemoteDescription(
     const SessionDescription* remote_desc, ContentAction action,
     std::string* error_desc) {
-  const ContentInfo* content_info = GetFirstContent(remote_desc);
   const MediaContentDescription* content_desc =
-      GetContentDescription(content_info);
-  if (content_desc && content_info && !content_info->rejected &&
-      !SetRemoteContent(content_desc, action, error_desc)) {
+      GetAcceptedContent(remote_desc);
+  if (content_desc && !SetRemoteContent(content_desc, action, error_desc)) {
     LOG(LS_ERROR) << "Failure in SetRemoteContent with action " << action;
     return false;
   }
@@ -1298,9 +1314,10 @@ bool BaseChannel::UpdateLocalStreams_w(const std::vector<StreamParams>& streams,
 
   // Check for streams that have been removed.
   bool ret = true;
+  const std::set<uint32_t> new_ssrcs = GetAllSsrcs(streams);
   for (StreamParamsVec::const_iterator it = local_streams_.begin();
        it != local_streams_.end(); ++it) {
-    if (!GetStreamBySsrc(streams, it->first_ssrc())) {
+    if (!new_ssrcs.count(it->first_ssrc())) {
       if (!media_channel()->RemoveSendStream(it->first_ssrc())) {
         std::ostringstream desc;
         desc << "Failed to remove send stream with ssrc "
@@ -1311,9 +1328,10 @@ bool BaseChannel::UpdateLocalStreams_w(const std::vector<StreamParams>& streams,
     }
   }
   // Check for new streams.
+  const std::set<uint32_t> old_ssrcs = GetAllSsrcs(local_streams_);
   for (StreamParamsVec::const_iterator it = streams.begin();
        it != streams.end(); ++it) {
-    if (!GetStreamBySsrc(local_streams_, it->first_ssrc())) {
+    if (!old_ssrcs.count(it->first_ssrc())) {
       if (media_channel()->AddSendStream(*it)) {
         LOG(LS_INFO) << "Add send stream ssrc: " << it->ssrcs[0];
       } else {
@@ -1373,9 +1391,10 @@ bool BaseChannel::UpdateRemoteStreams_w(
 
   // Check for streams that have been removed.
   bool ret = true;
+  const std::set<uint32_t> new_ssrcs = GetAllSsrcs(streams);
   for (StreamParamsVec::const_iterator it = remote_streams_.begin();
        it != remote_streams_.end(); ++it) {
-    if (!GetStreamBySsrc(streams, it->first_ssrc())) {
+    if (!new_ssrcs.count(it->first_ssrc())) {
       if (!RemoveRecvStream_w(it->first_ssrc())) {
         std::ostringstream desc;
         desc << "Failed to remove remote stream with ssrc "
@@ -1386,9 +1405,10 @@ bool BaseChannel::UpdateRemoteStreams_w(
     }
   }
   // Check for new streams.
+  const std::set<uint32_t> old_ssrcs = GetAllSsrcs(remote_streams_);
   for (StreamParamsVec::const_iterator it = streams.begin();
       it != streams.end(); ++it) {
-    if (!GetStreamBySsrc(remote_streams_, it->first_ssrc())) {
+    if (!old_ssrcs.count(it->first_ssrc())) {
       if (AddRecvStream_w(*it)) {
         LOG(LS_INFO) << "Add remote ssrc: " << it->ssrcs[0];
       } else {
@@ -2460,4 +2480,87 @@ void RtpDataChannel::OnDataChannelReadyToSend(bool writable) {
                            new DataChannelReadyToSendMessageData(writable));
 }
 
+ChannelUpdateBatch::ChannelUpdateBatch() = default;
+
+ChannelUpdateBatch::~ChannelUpdateBatch() = default;
+
+void ChannelUpdateBatch::Enable(BaseChannel* channel, bool enable) {
+  RTC_DCHECK(!worker_thread_ || worker_thread_ == channel->worker_thread());
+  worker_thread_ = channel->worker_thread();
+  updates_.push_back([channel, enable](std::string* error_desc) {
+    if (enable) {
+      channel->EnableMedia_w();
+    } else {
+      channel->DisableMedia_w();
+    }
+    return true;
+  });
+}
+
+void ChannelUpdateBatch::PushdownLocalDescription(
+    BaseChannel* channel,
+    const SessionDescription* local_desc,
+    ContentAction action) {
+  RTC_DCHECK(!worker_thread_ || worker_thread_ == channel->worker_thread());
+  // Look up the content now, so that channels without any don't cost a hop.
+  const MediaContentDescription* content_desc =
+      channel->GetAcceptedContent(local_desc);
+  if (!content_desc) {
+    return;
+  }
+  worker_thread_ = channel->worker_thread();
+  updates_.push_back(
+      [channel, content_desc, action](std::string* error_desc) {
+        TRACE_EVENT0("webrtc", "BaseChannel::SetLocalContent");
+        if (!channel->SetLocalContent_w(content_desc, action, error_desc)) {
+          LOG(LS_ERROR) << "Failure in SetLocalContent with action " << action;
+          return false;
+        }
+        return true;
+      });
+}
+
+void ChannelUpdateBatch::PushdownRemoteDescription(
+    BaseChannel* channel,
+    const SessionDescription* remote_desc,
+    ContentAction action) {
+  RTC_DCHECK(!worker_thread_ || worker_thread_ == channel->worker_thread());
+  const MediaContentDescription* content_desc =
+      channel->GetAcceptedContent(remote_desc);
+  if (!content_desc) {
+    return;
+  }
+  worker_thread_ = channel->worker_thread();
+  updates_.push_back(
+      [channel, content_desc, action](std::string* error_desc) {
+        TRACE_EVENT0("webrtc", "BaseChannel::SetRemoteContent");
+        if (!channel->SetRemoteContent_w(content_desc, action, error_desc)) {
+          LOG(LS_ERROR) << "Failure in SetRemoteContent with action "
+                        << action;
+          return false;
+        }
+        return true;
+      });
+}
+
+bool ChannelUpdateBatch::Apply(std::string* error_desc) {
+  if (updates_.empty()) {
+    return true;
+  }
+  bool ret = worker_thread_->Invoke<bool>(
+      RTC_FROM_HERE, Bind(&ChannelUpdateBatch::Apply_w, this, error_desc));
+  updates_.clear();
+  return ret;
+}
+
+bool ChannelUpdateBatch::Apply_w(std::string* error_desc) {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  for (const auto& update : updates_) {
+    if (!update(error_desc)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace cricket
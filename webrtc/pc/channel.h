@@ -11,6 +11,7 @@
 #ifndef WEBRTC_PC_CHANNEL_H_
 #define WEBRTC_PC_CHANNEL_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -37,6 +38,7 @@
 #include "webrtc/pc/srtpfilter.h"
 #include "webrtc/rtc_base/asyncinvoker.h"
 #include "webrtc/rtc_base/asyncudpsocket.h"
+#include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/network.h"
 #include "webrtc/rtc_base/sigslot.h"
@@ -48,6 +50,7 @@ class AudioSinkInterface;
 
 namespace cricket {
 
+class ChannelUpdateBatch;
 struct CryptoParams;
 class MediaContentDescription;
 
@@ -366,6 +369,13 @@ class BaseChannel
   void AddHandledPayloadType(int payload_type);
 
  private:
+  friend class ChannelUpdateBatch;
+
+  // Returns the content of |sdesc| for this channel, or null if there is none
+  // or it was rejected.
+  const MediaContentDescription* GetAcceptedContent(
+      const SessionDescription* sdesc);
+
   bool InitNetwork_n(DtlsTransportInternal* rtp_dtls_transport,
                      DtlsTransportInternal* rtcp_dtls_transport,
                      rtc::PacketTransportInternal* rtp_packet_transport,
@@ -732,6 +742,42 @@ class RtpDataChannel : public BaseChannel {
   DataRecvParameters last_recv_params_;
 };
 
+// Gathers the changes that one negotiation makes to channels sharing a worker
+// thread, and applies them with a single Invoke rather than one per channel and
+// change. The changes are applied in the order they were added, as the
+// corresponding BaseChannel methods would have.
+class ChannelUpdateBatch {
+ public:
+  ChannelUpdateBatch();
+  ~ChannelUpdateBatch();
+
+  // Like BaseChannel::Enable.
+  void Enable(BaseChannel* channel, bool enable);
+  // Like BaseChannel::PushdownLocalDescription and PushdownRemoteDescription.
+  // |desc| must stay valid until Apply returns.
+  void PushdownLocalDescription(BaseChannel* channel,
+                                const SessionDescription* local_desc,
+                                ContentAction action);
+  void PushdownRemoteDescription(BaseChannel* channel,
+                                 const SessionDescription* remote_desc,
+                                 ContentAction action);
+
+  // Applies the changes, stopping at the first one that fails, in which case
+  // false is returned and |error_desc| is set. Does not block when there is
+  // nothing to apply. The batch is empty afterwards.
+  bool Apply(std::string* error_desc);
+
+  bool empty() const { return updates_.empty(); }
+
+ private:
+  bool Apply_w(std::string* error_desc);
+
+  rtc::Thread* worker_thread_ = nullptr;
+  std::vector<std::function<bool(std::string*)>> updates_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ChannelUpdateBatch);
+};
+
 }  // namespace cricket
 
 #endif  // WEBRTC_PC_CHANNEL_H_
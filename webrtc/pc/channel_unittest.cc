@@ -606,6 +606,37 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
                              media_channel1_->codecs()[0]));
   }
 
+  // Test that updates gathered in a ChannelUpdateBatch are applied in order
+  // when the batch is applied, and that rejected contents are skipped.
+  void TestSetContentsInBatch() {
+    CreateChannels(0, 0);
+    typename T::Content content;
+    CreateContent(0, kPcmuCodec, kH264Codec, &content);
+    cricket::SessionDescription sdesc;
+    sdesc.AddContent("DUMMY_CONTENT_NAME", cricket::NS_JINGLE_RTP,
+                     content.Copy());
+    cricket::SessionDescription rejected_sdesc;
+    rejected_sdesc.AddContent("DUMMY_CONTENT_NAME", cricket::NS_JINGLE_RTP,
+                              true, content.Copy());
+
+    cricket::ChannelUpdateBatch batch;
+    batch.PushdownLocalDescription(channel1_.get(), &rejected_sdesc, CA_OFFER);
+    EXPECT_TRUE(batch.empty());
+    batch.PushdownLocalDescription(channel1_.get(), &sdesc, CA_OFFER);
+    batch.PushdownRemoteDescription(channel1_.get(), &sdesc, CA_ANSWER);
+    batch.Enable(channel1_.get(), true);
+    EXPECT_FALSE(batch.empty());
+    EXPECT_EQ(0U, media_channel1_->codecs().size());
+    EXPECT_FALSE(channel1_->enabled());
+
+    EXPECT_TRUE(batch.Apply(nullptr));
+    EXPECT_TRUE(batch.empty());
+    EXPECT_TRUE(channel1_->enabled());
+    ASSERT_EQ(1U, media_channel1_->codecs().size());
+    EXPECT_TRUE(CodecMatches(content.codecs()[0],
+                             media_channel1_->codecs()[0]));
+  }
+
   // Test that SetLocalContent and SetRemoteContent properly deals
   // with an empty offer.
   void TestSetContentsNullOffer() {
@@ -2286,6 +2317,10 @@ TEST_F(VoiceChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VoiceChannelSingleThreadTest, TestSetContentsInBatch) {
+  Base::TestSetContentsInBatch();
+}
+
 TEST_F(VoiceChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -2645,6 +2680,10 @@ TEST_F(VoiceChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VoiceChannelDoubleThreadTest, TestSetContentsInBatch) {
+  Base::TestSetContentsInBatch();
+}
+
 TEST_F(VoiceChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -3002,6 +3041,10 @@ TEST_F(VideoChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VideoChannelSingleThreadTest, TestSetContentsInBatch) {
+  Base::TestSetContentsInBatch();
+}
+
 TEST_F(VideoChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -3233,6 +3276,10 @@ TEST_F(VideoChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VideoChannelDoubleThreadTest, TestSetContentsInBatch) {
+  Base::TestSetContentsInBatch();
+}
+
 TEST_F(VideoChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -3543,6 +3590,10 @@ TEST_F(RtpDataChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(RtpDataChannelSingleThreadTest, TestSetContentsInBatch) {
+  Base::TestSetContentsInBatch();
+}
+
 TEST_F(RtpDataChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -3675,6 +3726,10 @@ TEST_F(RtpDataChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(RtpDataChannelDoubleThreadTest, TestSetContentsInBatch) {
+  Base::TestSetContentsInBatch();
+}
+
 TEST_F(RtpDataChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -141,7 +141,8 @@ DataChannel::DataChannel(
       receive_ssrc_set_(false),
       writable_(false),
       send_ssrc_(0),
-      receive_ssrc_(0) {
+      receive_ssrc_(0),
+      buffered_amount_low_threshold_(0) {
 }
 
 bool DataChannel::Init(const InternalDataChannelInit& config) {
@@ -535,6 +536,10 @@ void DataChannel::SendQueuedDataMessages() {
 
   if (observer_ && buffered_amount() < start_buffered_amount) {
     observer_->OnBufferedAmountChange(start_buffered_amount);
+    if (start_buffered_amount > buffered_amount_low_threshold_ &&
+        buffered_amount() <= buffered_amount_low_threshold_) {
+      observer_->OnBufferedAmountLow();
+    }
   }
 }
 
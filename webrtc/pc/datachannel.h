@@ -128,6 +128,12 @@ class DataChannel : public DataChannelInterface,
   virtual bool negotiated() const { return config_.negotiated; }
   virtual int id() const { return config_.id; }
   virtual uint64_t buffered_amount() const;
+  virtual uint64_t buffered_amount_low_threshold() const {
+    return buffered_amount_low_threshold_;
+  }
+  virtual void SetBufferedAmountLowThreshold(uint64_t threshold) {
+    buffered_amount_low_threshold_ = threshold;
+  }
   virtual void Close();
   virtual DataState state() const { return state_; }
   virtual uint32_t messages_sent() const { return messages_sent_; }
@@ -263,6 +269,7 @@ class DataChannel : public DataChannelInterface,
   bool writable_;
   uint32_t send_ssrc_;
   uint32_t receive_ssrc_;
+  uint64_t buffered_amount_low_threshold_;
   // Control messages that always have to get sent out before any queued
   // data.
   PacketQueue queued_control_data_;
@@ -289,6 +296,8 @@ BEGIN_SIGNALING_PROXY_MAP(DataChannel)
   PROXY_CONSTMETHOD0(uint32_t, messages_received)
   PROXY_CONSTMETHOD0(uint64_t, bytes_received)
   PROXY_CONSTMETHOD0(uint64_t, buffered_amount)
+  PROXY_CONSTMETHOD0(uint64_t, buffered_amount_low_threshold)
+  PROXY_METHOD1(void, SetBufferedAmountLowThreshold, uint64_t)
   PROXY_METHOD0(void, Close)
   PROXY_METHOD1(bool, Send, const DataBuffer&)
 END_PROXY_MAP()
@@ -25,7 +25,8 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
   FakeDataChannelObserver()
       : messages_received_(0),
         on_state_change_count_(0),
-        on_buffered_amount_change_count_(0) {}
+        on_buffered_amount_change_count_(0),
+        on_buffered_amount_low_count_(0) {}
 
   void OnStateChange() {
     ++on_state_change_count_;
@@ -35,6 +36,8 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     ++on_buffered_amount_change_count_;
   }
 
+  void OnBufferedAmountLow() { ++on_buffered_amount_low_count_; }
+
   void OnMessage(const webrtc::DataBuffer& buffer) {
     ++messages_received_;
   }
@@ -59,10 +62,15 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     return on_buffered_amount_change_count_;
   }
 
+  size_t on_buffered_amount_low_count() const {
+    return on_buffered_amount_low_count_;
+  }
+
  private:
   size_t messages_received_;
   size_t on_state_change_count_;
   size_t on_buffered_amount_change_count_;
+  size_t on_buffered_amount_low_count_;
 };
 
 class SctpDataChannelTest : public testing::Test {
@@ -185,6 +193,33 @@ TEST_F(SctpDataChannelTest, BufferedAmountWhenBlocked) {
   EXPECT_EQ(number_of_packets, observer_->on_buffered_amount_change_count());
 }
 
+// Tests that OnBufferedAmountLow is called only when the buffered amount drops
+// from above the threshold to at or below it.
+TEST_F(SctpDataChannelTest, OnBufferedAmountLowCalledAtThreshold) {
+  AddObserver();
+  SetChannelReady();
+  webrtc_data_channel_->SetBufferedAmountLowThreshold(4);
+  EXPECT_EQ(4U, webrtc_data_channel_->buffered_amount_low_threshold());
+  webrtc::DataBuffer buffer("abcd");
+
+  // Draining a queue that never went above the threshold doesn't call it.
+  provider_->set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  provider_->set_send_blocked(false);
+  SetChannelReady();
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(0U, observer_->on_buffered_amount_low_count());
+
+  provider_->set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  EXPECT_EQ(8U, webrtc_data_channel_->buffered_amount());
+  provider_->set_send_blocked(false);
+  SetChannelReady();
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+}
+
 // Tests that the queued data are sent when the channel transitions from blocked
 // to unblocked.
 TEST_F(SctpDataChannelTest, QueuedDataSentWhenUnblocked) {
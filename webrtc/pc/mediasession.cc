@@ -285,18 +285,17 @@ static bool SelectCrypto(const MediaContentDescription* offer,
   return false;
 }
 
-// Generate random SSRC values that are not already present in |params_vec|.
-// The generated values are added to |ssrcs|.
+// Generate random SSRC values that are not already present in |used_ssrcs|.
+// The generated values are added to |ssrcs| and to |used_ssrcs|.
 // |num_ssrcs| is the number of the SSRC will be generated.
-static void GenerateSsrcs(const StreamParamsVec& params_vec,
-                          int num_ssrcs,
+static void GenerateSsrcs(int num_ssrcs,
+                          std::set<uint32_t>* used_ssrcs,
                           std::vector<uint32_t>* ssrcs) {
   for (int i = 0; i < num_ssrcs; i++) {
     uint32_t candidate;
     do {
       candidate = rtc::CreateRandomNonZeroId();
-    } while (GetStreamBySsrc(params_vec, candidate) ||
-             std::count(ssrcs->begin(), ssrcs->end(), candidate) > 0);
+    } while (!used_ssrcs->insert(candidate).second);
     ssrcs->push_back(candidate);
   }
 }
@@ -452,15 +451,27 @@ static bool AddStreamParams(
   const bool include_flexfec_stream =
       ContainsFlexfecCodec(content_description->codecs());
 
+  // Index the current streams once rather than searching them for every
+  // sender, which made offers and answers quadratic in the number of tracks.
+  // groupid is empty for StreamParams generated using
+  // MediaSessionDescriptionFactory.
+  std::map<std::string, size_t> stream_index_by_track_id;
+  std::set<uint32_t> used_ssrcs;
+  for (size_t i = 0; i < current_streams->size(); ++i) {
+    const StreamParams& stream = (*current_streams)[i];
+    if (stream.groupid.empty()) {
+      // Like GetStreamByIds, use the first stream with the track id.
+      stream_index_by_track_id.insert(std::make_pair(stream.id, i));
+    }
+    used_ssrcs.insert(stream.ssrcs.begin(), stream.ssrcs.end());
+  }
+
   for (const SenderOptions& sender : sender_options) {
-    // groupid is empty for StreamParams generated using
-    // MediaSessionDescriptionFactory.
-    StreamParams* param =
-        GetStreamByIds(*current_streams, "" /*group_id*/, sender.track_id);
-    if (!param) {
+    auto index_it = stream_index_by_track_id.find(sender.track_id);
+    if (index_it == stream_index_by_track_id.end()) {
       // This is a new sender.
       std::vector<uint32_t> ssrcs;
-      GenerateSsrcs(*current_streams, sender.num_sim_layers, &ssrcs);
+      GenerateSsrcs(sender.num_sim_layers, &used_ssrcs, &ssrcs);
       StreamParams stream_param;
       stream_param.id = sender.track_id;
       // Add the generated ssrc.
@@ -475,8 +486,7 @@ static bool AddStreamParams(
       if (include_rtx_streams) {
         // Generate an RTX ssrc for every ssrc in the group.
         std::vector<uint32_t> rtx_ssrcs;
-        GenerateSsrcs(*current_streams, static_cast<int>(ssrcs.size()),
-                      &rtx_ssrcs);
+        GenerateSsrcs(static_cast<int>(ssrcs.size()), &used_ssrcs, &rtx_ssrcs);
         for (size_t i = 0; i < ssrcs.size(); ++i) {
           stream_param.AddFidSsrc(ssrcs[i], rtx_ssrcs[i]);
         }
@@ -487,7 +497,7 @@ static bool AddStreamParams(
         // TODO(brandtr): Update when we support multistream protection.
         if (ssrcs.size() == 1) {
           std::vector<uint32_t> flexfec_ssrcs;
-          GenerateSsrcs(*current_streams, 1, &flexfec_ssrcs);
+          GenerateSsrcs(1, &used_ssrcs, &flexfec_ssrcs);
           stream_param.AddFecFrSsrc(ssrcs[0], flexfec_ssrcs[0]);
           content_description->set_multistream(true);
         } else if (!ssrcs.empty()) {
@@ -503,11 +513,14 @@ static bool AddStreamParams(
 
       // Store the new StreamParams in current_streams.
       // This is necessary so that we can use the CNAME for other media types.
+      stream_index_by_track_id.insert(
+          std::make_pair(sender.track_id, current_streams->size()));
       current_streams->push_back(stream_param);
     } else {
       // Use existing generated SSRCs/groups, but update the sync_label if
       // necessary. This may be needed if a MediaStreamTrack was moved from one
       // MediaStream to another.
+      StreamParams* param = &(*current_streams)[index_it->second];
       param->sync_label = sender.stream_id;
       content_description->AddStream(*param);
     }
@@ -9,6 +9,7 @@
  */
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -1822,6 +1823,49 @@ TEST_F(MediaSessionDescriptionFactoryTest, TestCreateSimulcastVideoOffer) {
   EXPECT_EQ(static_cast<size_t>(num_sim_layers), sim_ssrc_group->ssrcs.size());
 }
 
+// Create an offer with many simulcast video tracks, then update it with one
+// more track, and ensure that all SSRCs are unique and that the existing
+// tracks keep theirs.
+TEST_F(MediaSessionDescriptionFactoryTest, TestCreateUpdatedOfferManyTracks) {
+  MediaSessionOptions opts;
+  AddMediaSection(MEDIA_TYPE_VIDEO, "video", cricket::MD_SENDRECV, kActive,
+                  &opts);
+  const int kNumTracks = 100;
+  const int num_sim_layers = 3;
+  for (int i = 0; i < kNumTracks; ++i) {
+    AttachSenderToMediaSection("video", MEDIA_TYPE_VIDEO,
+                               "video_track" + std::to_string(i),
+                               kMediaStream1, num_sim_layers, &opts);
+  }
+  std::unique_ptr<SessionDescription> offer(f1_.CreateOffer(opts, NULL));
+  ASSERT_TRUE(offer.get() != NULL);
+
+  AttachSenderToMediaSection("video", MEDIA_TYPE_VIDEO, kVideoTrack1,
+                             kMediaStream1, num_sim_layers, &opts);
+  std::unique_ptr<SessionDescription> updated_offer(
+      f1_.CreateOffer(opts, offer.get()));
+  ASSERT_TRUE(updated_offer.get() != NULL);
+
+  const StreamParamsVec& streams = GetFirstVideoContentDescription(
+      offer.get())->streams();
+  const StreamParamsVec& updated_streams = GetFirstVideoContentDescription(
+      updated_offer.get())->streams();
+  ASSERT_EQ(static_cast<size_t>(kNumTracks), streams.size());
+  ASSERT_EQ(static_cast<size_t>(kNumTracks + 1), updated_streams.size());
+  std::set<uint32_t> ssrcs;
+  for (size_t i = 0; i < updated_streams.size(); ++i) {
+    if (i < streams.size()) {
+      EXPECT_EQ(streams[i], updated_streams[i]);
+    }
+    ssrcs.insert(updated_streams[i].ssrcs.begin(),
+                 updated_streams[i].ssrcs.end());
+  }
+  EXPECT_EQ(kVideoTrack1, updated_streams.back().id);
+  EXPECT_EQ(updated_streams[0].cname, updated_streams.back().cname);
+  EXPECT_EQ(static_cast<size_t>((kNumTracks + 1) * num_sim_layers),
+            ssrcs.size());
+}
+
 // Create an audio and video answer to a standard video offer with:
 // - one video track
 // - two audio tracks
@@ -761,6 +761,21 @@ void PeerConnection::GetStats(RTCStatsCollectorCallback* callback) {
   stats_collector_->GetStatsReport(callback);
 }
 
+bool PeerConnection::SubscribeStats(RTCStatsCollectorCallback* callback,
+                                    const std::set<std::string>& stats_types,
+                                    const std::set<std::string>& stats_ids,
+                                    int interval_ms) {
+  TRACE_EVENT0("webrtc", "PeerConnection::SubscribeStats");
+  RTC_DCHECK(stats_collector_);
+  return stats_collector_->AddStatsSubscription(callback, stats_types,
+                                                stats_ids, interval_ms);
+}
+
+void PeerConnection::UnsubscribeStats(RTCStatsCollectorCallback* callback) {
+  RTC_DCHECK(stats_collector_);
+  stats_collector_->RemoveStatsSubscription(callback);
+}
+
 PeerConnectionInterface::SignalingState PeerConnection::signaling_state() {
   return signaling_state_;
 }
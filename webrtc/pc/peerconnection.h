@@ -86,6 +86,11 @@ class PeerConnection : public PeerConnectionInterface,
                 webrtc::MediaStreamTrackInterface* track,
                 StatsOutputLevel level) override;
   void GetStats(RTCStatsCollectorCallback* callback) override;
+  bool SubscribeStats(RTCStatsCollectorCallback* callback,
+                      const std::set<std::string>& stats_types,
+                      const std::set<std::string>& stats_ids,
+                      int interval_ms) override;
+  void UnsubscribeStats(RTCStatsCollectorCallback* callback) override;
 
   SignalingState signaling_state() override;
 
@@ -21,6 +21,7 @@
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
 #include "webrtc/rtc_base/bind.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
 // Adding 'nogncheck' to disable the gn include headers check to support modular
 // WebRTC build targets.
 // TODO(zhihuang): This wouldn't be necessary if the interface and
@@ -167,7 +168,24 @@ bool PeerConnectionFactory::Initialize() {
 }
 
 void PeerConnectionFactory::SetOptions(const Options& options) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
   options_ = options;
+  if (options.certificate_pool_size <= 0) {
+    certificate_pool_ = nullptr;
+    return;
+  }
+  // Keep the certificates generated so far unless the pool changes.
+  if (certificate_pool_ &&
+      certificate_pool_->size() ==
+          static_cast<size_t>(options.certificate_pool_size) &&
+      certificate_pool_->key_params().type() ==
+          options.certificate_pool_key_type) {
+    return;
+  }
+  certificate_pool_ = rtc::RTCCertificatePool::Create(
+      signaling_thread_, network_thread_,
+      rtc::KeyParams(options.certificate_pool_key_type),
+      options.certificate_pool_size);
 }
 
 rtc::scoped_refptr<AudioSourceInterface>
@@ -221,6 +239,21 @@ void PeerConnectionFactory::StopAecDump() {
   channel_manager_->StopAecDump();
 }
 
+void PeerConnectionFactory::StartThreadCpuAccounting() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  rtc::ThreadCpuAccounting::SetEnabled(true);
+}
+
+void PeerConnectionFactory::StopThreadCpuAccounting() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  rtc::ThreadCpuAccounting::SetEnabled(false);
+}
+
+std::vector<rtc::ThreadCpuStats> PeerConnectionFactory::GetThreadCpuStats() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  return rtc::ThreadCpuAccounting::GetStats();
+}
+
 rtc::scoped_refptr<PeerConnectionInterface>
 PeerConnectionFactory::CreatePeerConnection(
     const PeerConnectionInterface::RTCConfiguration& configuration_in,
@@ -248,8 +281,8 @@ PeerConnectionFactory::CreatePeerConnection(
 
   if (!cert_generator.get()) {
     // No certificate generator specified, use the default one.
-    cert_generator.reset(
-        new rtc::RTCCertificateGenerator(signaling_thread_, network_thread_));
+    cert_generator.reset(new rtc::RTCCertificateGenerator(
+        signaling_thread_, network_thread_, certificate_pool_));
   }
 
   if (!allocator) {
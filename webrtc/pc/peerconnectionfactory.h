@@ -85,6 +85,9 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
 
   bool StartAecDump(rtc::PlatformFile file, int64_t max_size_bytes) override;
   void StopAecDump() override;
+  void StartThreadCpuAccounting() override;
+  void StopThreadCpuAccounting() override;
+  std::vector<rtc::ThreadCpuStats> GetThreadCpuStats() override;
   // TODO(ivoc) Remove after Chrome is updated.
   bool StartRtcEventLog(rtc::PlatformFile file) override { return false; }
   // TODO(ivoc) Remove after Chrome is updated.
@@ -130,6 +133,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   std::unique_ptr<rtc::Thread> owned_network_thread_;
   std::unique_ptr<rtc::Thread> owned_worker_thread_;
   Options options_;
+  // Set when |options_| ask for a certificate pool.
+  rtc::scoped_refptr<rtc::RTCCertificatePool> certificate_pool_;
   // External Audio device used for audio playback.
   rtc::scoped_refptr<AudioDeviceModule> default_adm_;
   rtc::scoped_refptr<AudioEncoderFactory> audio_encoder_factory_;
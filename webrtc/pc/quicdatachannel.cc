@@ -10,12 +10,15 @@
 
 #include "webrtc/pc/quicdatachannel.h"
 
+#include <vector>
+
 #include "webrtc/p2p/quic/quictransportchannel.h"
 #include "webrtc/p2p/quic/reliablequicstream.h"
 #include "webrtc/rtc_base/bind.h"
 #include "webrtc/rtc_base/bytebuffer.h"
 #include "webrtc/rtc_base/copyonwritebuffer.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace webrtc {
 
@@ -71,6 +74,8 @@ QuicDataChannel::QuicDataChannel(rtc::Thread* signaling_thread,
       state_(kConnecting),
       buffered_amount_(0),
       next_message_id_(0),
+      max_retransmits_(config.maxRetransmits),
+      max_retransmit_time_(config.maxRetransmitTime),
       label_(label),
       protocol_(config.protocol) {}
 
@@ -99,6 +104,9 @@ bool QuicDataChannel::Send(const DataBuffer& buffer) {
 
 bool QuicDataChannel::Send_n(const DataBuffer& buffer) {
   RTC_DCHECK(network_thread_->IsCurrent());
+  if (!reliable()) {
+    AbandonWriteBlockedMessages_n();
+  }
 
   // Encode and send the header containing the data channel ID and message ID.
   rtc::CopyOnWriteBuffer header;
@@ -154,7 +162,7 @@ bool QuicDataChannel::Send_n(const DataBuffer& buffer) {
     SetBufferedAmount_w(buffered_amount_ + stream->queued_data_bytes());
     stream->SignalQueuedBytesWritten.connect(
         this, &QuicDataChannel::OnQueuedBytesWritten);
-    write_blocked_quic_streams_[stream->id()] = stream;
+    write_blocked_quic_streams_[stream->id()] = {stream, rtc::TimeMillis()};
     // The QUIC stream will be removed from |write_blocked_quic_streams_| once
     // it closes.
     stream->SignalClosed.connect(this,
@@ -167,6 +175,31 @@ bool QuicDataChannel::Send_n(const DataBuffer& buffer) {
   return false;
 }
 
+void QuicDataChannel::AbandonWriteBlockedMessages_n() {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  const int64_t now_ms = rtc::TimeMillis();
+  std::vector<cricket::ReliableQuicStream*> abandoned_streams;
+  uint64_t abandoned_bytes = 0;
+  for (const auto& kv : write_blocked_quic_streams_) {
+    const WriteBlockedMessage& message = kv.second;
+    if (max_retransmits_ >= 0 ||
+        now_ms - message.send_time_ms >= max_retransmit_time_) {
+      abandoned_streams.push_back(message.stream);
+      abandoned_bytes += message.stream->queued_data_bytes();
+    }
+  }
+  if (abandoned_streams.empty()) {
+    return;
+  }
+  LOG(LS_INFO) << "Abandoning " << abandoned_streams.size()
+               << " write blocked messages for QUIC data channel " << id_;
+  SetBufferedAmount_w(buffered_amount_ - abandoned_bytes);
+  // Closing a stream removes it from |write_blocked_quic_streams_|.
+  for (cricket::ReliableQuicStream* stream : abandoned_streams) {
+    stream->Close();
+  }
+}
+
 void QuicDataChannel::OnQueuedBytesWritten(net::QuicStreamId stream_id,
                                            uint64_t queued_bytes_written) {
   RTC_DCHECK(worker_thread_->IsCurrent());
@@ -176,7 +209,7 @@ void QuicDataChannel::OnQueuedBytesWritten(net::QuicStreamId stream_id,
     RTC_NOTREACHED();
     return;
   }
-  cricket::ReliableQuicStream* stream = kv->second;
+  cricket::ReliableQuicStream* stream = kv->second.stream;
   // True if the QUIC stream is done sending data.
   if (stream->fin_sent()) {
     LOG(LS_INFO) << "Stream " << stream->id()
@@ -215,7 +248,7 @@ void QuicDataChannel::Close_w() {
   }
 
   for (auto& kv : write_blocked_quic_streams_) {
-    cricket::ReliableQuicStream* stream = kv.second;
+    cricket::ReliableQuicStream* stream = kv.second.stream;
     stream->Close();
   }
 }
@@ -56,8 +56,8 @@ bool ParseQuicDataMessageHeader(const char* data,
 // QuicDataChannel is an implementation of DataChannelInterface based on the
 // QUIC protocol. It uses a QuicTransportChannel to establish encryption and
 // transfer data, and a QuicDataTransport to receive incoming messages at
-// the correct data channel. Currently this class implements unordered, reliable
-// delivery and does not send an "OPEN" message.
+// the correct data channel. Currently this class implements unordered delivery,
+// reliable or partially reliable, and does not send an "OPEN" message.
 //
 // Each time a message is sent:
 //
@@ -73,8 +73,17 @@ bool ParseQuicDataMessageHeader(const char* data,
 //   it receives a QUIC stream frame with a FIN, it provides the message to the
 //   DataChannelObserver.
 //
-// TODO(mikescarlett): Implement ordered delivery, unreliable delivery, and
-// an OPEN message similar to the one for SCTP.
+// Since each message has its own QUIC stream, a message that is lost or write
+// blocked doesn't hold up the others. If the DataChannelInit sets
+// maxRetransmits or maxRetransmitTime, messages that are still write blocked
+// are abandoned by closing their QUIC stream: with maxRetransmits, as soon as
+// a newer message is sent (QUIC doesn't expose retransmission counts), and
+// with maxRetransmitTime, once they have been blocked for that long. This
+// suits applications such as game state updates, where only the latest
+// message matters.
+//
+// TODO(mikescarlett): Implement ordered delivery and an OPEN message similar
+// to the one for SCTP.
 class QuicDataChannel : public rtc::RefCountedObject<DataChannelInterface>,
                         public sigslot::has_slots<> {
  public:
@@ -95,10 +104,12 @@ class QuicDataChannel : public rtc::RefCountedObject<DataChannelInterface>,
 
   // DataChannelInterface overrides.
   std::string label() const override { return label_; }
-  bool reliable() const override { return true; }
+  bool reliable() const override {
+    return max_retransmits_ < 0 && max_retransmit_time_ < 0;
+  }
   bool ordered() const override { return false; }
-  uint16_t maxRetransmitTime() const override { return -1; }
-  uint16_t maxRetransmits() const override { return -1; }
+  uint16_t maxRetransmitTime() const override { return max_retransmit_time_; }
+  uint16_t maxRetransmits() const override { return max_retransmits_; }
   bool negotiated() const override { return false; }
   int id() const override { return id_; }
   DataState state() const override { return state_; }
@@ -161,6 +172,9 @@ class QuicDataChannel : public rtc::RefCountedObject<DataChannelInterface>,
   // Returns true if the data buffer can be successfully sent, or if it is
   // queued to be sent later.
   bool Send_n(const DataBuffer& buffer);
+  // For partially reliable data channels, closes the QUIC streams of the write
+  // blocked messages that should no longer be delivered.
+  void AbandonWriteBlockedMessages_n();
 
   // Worker thread methods.
   // Connects the |quic_transport_channel_| signals to this QuicDataChannel,
@@ -193,9 +207,14 @@ class QuicDataChannel : public rtc::RefCountedObject<DataChannelInterface>,
   // Network thread for sending data and |quic_transport_channel_| callbacks.
   rtc::Thread* const network_thread_;
   rtc::AsyncInvoker invoker_;
-  // Map of QUIC stream ID => ReliableQuicStream* for write blocked QUIC
+  struct WriteBlockedMessage {
+    cricket::ReliableQuicStream* stream;
+    // When the message was sent, in rtc::TimeMillis.
+    int64_t send_time_ms;
+  };
+  // Map of QUIC stream ID => WriteBlockedMessage for write blocked QUIC
   // streams.
-  std::unordered_map<net::QuicStreamId, cricket::ReliableQuicStream*>
+  std::unordered_map<net::QuicStreamId, WriteBlockedMessage>
       write_blocked_quic_streams_;
   // Map of QUIC stream ID => Message for each incoming QUIC stream.
   std::unordered_map<net::QuicStreamId, Message> incoming_quic_messages_;
@@ -209,6 +228,9 @@ class QuicDataChannel : public rtc::RefCountedObject<DataChannelInterface>,
   uint64_t buffered_amount_;
   // Counter for number of sent messages that is used for message IDs.
   uint64_t next_message_id_;
+  // From the DataChannelInit; -1 if unset.
+  const int max_retransmits_;
+  const int max_retransmit_time_;
 
   // Variables for application use.
   const std::string& label_;
@@ -116,10 +116,12 @@ class FakeQuicDataTransport : public sigslot::has_slots<> {
   rtc::scoped_refptr<QuicDataChannel> CreateDataChannel(
       int id,
       const std::string& label,
-      const std::string& protocol) {
+      const std::string& protocol,
+      int max_retransmits = -1) {
     DataChannelInit config;
     config.id = id;
     config.protocol = protocol;
+    config.maxRetransmits = max_retransmits;
     rtc::scoped_refptr<QuicDataChannel> data_channel(
         new QuicDataChannel(rtc::Thread::Current(), rtc::Thread::Current(),
                             rtc::Thread::Current(), label, config));
@@ -186,9 +188,11 @@ class QuicDataChannelPeer {
   rtc::scoped_refptr<QuicDataChannel> CreateDataChannelWithTransportChannel(
       int id,
       const std::string& label,
-      const std::string& protocol) {
+      const std::string& protocol,
+      int max_retransmits = -1) {
     rtc::scoped_refptr<QuicDataChannel> data_channel =
-        fake_quic_data_transport_.CreateDataChannel(id, label, protocol);
+        fake_quic_data_transport_.CreateDataChannel(id, label, protocol,
+                                                    max_retransmits);
     data_channel->SetTransportChannel(&quic_transport_channel_);
     return data_channel;
   }
@@ -472,6 +476,45 @@ TEST_F(QuicDataChannelTest, MessagesReceivedWhenTransportChannelReconnects) {
   EXPECT_EQ(0, peer2_data_channel->GetNumIncomingStreams());
 }
 
+// Tests that when a partially reliable QuicDataChannel sends a message while
+// an earlier one is write blocked, the earlier one is abandoned and only the
+// latest is received once the QuicTransportChannel becomes writable again.
+TEST_F(QuicDataChannelTest, UnreliableMessagesAbandonedWhenSuperseded) {
+  ConnectTransportChannels();
+  int data_channel_id = 402;
+  std::string label = "label";
+  std::string protocol = "protocol";
+  rtc::scoped_refptr<QuicDataChannel> peer1_data_channel =
+      peer1_.CreateDataChannelWithTransportChannel(data_channel_id, label,
+                                                   protocol, 0);
+  EXPECT_FALSE(peer1_data_channel->reliable());
+  ASSERT_TRUE(peer1_data_channel->state() ==
+              webrtc::DataChannelInterface::kOpen);
+  rtc::scoped_refptr<QuicDataChannel> peer2_data_channel =
+      peer2_.CreateDataChannelWithTransportChannel(data_channel_id, label,
+                                                   protocol, 0);
+  ASSERT_TRUE(peer2_data_channel->state() ==
+              webrtc::DataChannelInterface::kOpen);
+
+  FakeObserver peer2_observer;
+  peer2_data_channel->RegisterObserver(&peer2_observer);
+  // writable => unwritable
+  peer1_.ice_transport_channel()->SetWritable(false);
+  ASSERT_FALSE(peer1_.quic_transport_channel()->writable());
+  EXPECT_TRUE(peer1_data_channel->Send(kSmallBuffer1));
+  EXPECT_EQ(1, peer1_data_channel->GetNumWriteBlockedStreams());
+  EXPECT_TRUE(peer1_data_channel->Send(kSmallBuffer2));
+  EXPECT_EQ(1, peer1_data_channel->GetNumWriteBlockedStreams());
+  EXPECT_TRUE(peer1_data_channel->Send(kSmallBuffer3));
+  EXPECT_EQ(1, peer1_data_channel->GetNumWriteBlockedStreams());
+  // unwritable => writable
+  peer1_.ice_transport_channel()->SetWritable(true);
+  ASSERT_TRUE(peer1_.quic_transport_channel()->writable());
+  ASSERT_EQ_WAIT(1, peer2_observer.messages_received(), kTimeoutMs);
+  EXPECT_EQ(kSmallMessage3, peer2_observer.messages().back());
+  EXPECT_EQ(0, peer1_data_channel->GetNumWriteBlockedStreams());
+}
+
 // Tests that the QuicDataChannel does not send before it is open.
 TEST_F(QuicDataChannelTest, TransferMessageBeforeChannelOpens) {
   rtc::scoped_refptr<QuicDataChannel> data_channel =
@@ -10,6 +10,7 @@
 
 #include "webrtc/pc/rtcstatscollector.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <utility>
@@ -24,6 +25,7 @@
 #include "webrtc/pc/peerconnection.h"
 #include "webrtc/pc/webrtcsession.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/stringutils.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
@@ -587,8 +589,51 @@ void ProduceMediaStreamAndTrackStats(
   }
 }
 
+// The stats types produced on the network thread.
+const char* const kNetworkThreadStatsTypes[] = {
+    RTCCertificateStats::kType,       RTCCodecStats::kType,
+    RTCIceCandidatePairStats::kType,  RTCLocalIceCandidateStats::kType,
+    RTCRemoteIceCandidateStats::kType, RTCInboundRTPStreamStats::kType,
+    RTCOutboundRTPStreamStats::kType, RTCTransportStats::kType};
+
+// Whether a report of |stats_types| includes stats of |type|. An empty set
+// means all types.
+bool IncludesStatsType(const std::set<std::string>& stats_types,
+                       const char* type) {
+  return stats_types.empty() || stats_types.count(type) > 0;
+}
+
+// Whether a report of |stats_types| includes all of |requested_stats_types|.
+bool IncludesStatsTypes(const std::set<std::string>& stats_types,
+                        const std::set<std::string>& requested_stats_types) {
+  if (stats_types.empty())
+    return true;
+  if (requested_stats_types.empty())
+    return false;
+  return std::includes(stats_types.begin(), stats_types.end(),
+                       requested_stats_types.begin(),
+                       requested_stats_types.end());
+}
+
 }  // namespace
 
+// Delivers the reports gathered for a stats subscription to the collector.
+class RTCStatsCollector::StatsSubscriptionCallback
+    : public RTCStatsCollectorCallback {
+ public:
+  StatsSubscriptionCallback(RTCStatsCollector* collector, int subscription_id)
+      : collector_(collector), subscription_id_(subscription_id) {}
+
+  void OnStatsDelivered(
+      const rtc::scoped_refptr<const RTCStatsReport>& report) override {
+    collector_->OnStatsSubscriptionSample(subscription_id_, report);
+  }
+
+ private:
+  const rtc::scoped_refptr<RTCStatsCollector> collector_;
+  const int subscription_id_;
+};
+
 rtc::scoped_refptr<RTCStatsCollector> RTCStatsCollector::Create(
     PeerConnection* pc, int64_t cache_lifetime_us) {
   return rtc::scoped_refptr<RTCStatsCollector>(
@@ -603,6 +648,7 @@ RTCStatsCollector::RTCStatsCollector(PeerConnection* pc,
       network_thread_(pc->session()->network_thread()),
       num_pending_partial_reports_(0),
       partial_report_timestamp_us_(0),
+      next_stats_subscription_id_(0),
       cache_timestamp_us_(0),
       cache_lifetime_us_(cache_lifetime_us) {
   RTC_DCHECK(pc_);
@@ -620,29 +666,76 @@ RTCStatsCollector::~RTCStatsCollector() {
 
 void RTCStatsCollector::GetStatsReport(
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {
+  GetStatsReport(callback, std::set<std::string>());
+}
+
+void RTCStatsCollector::GetStatsReport(
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback,
+    const std::set<std::string>& stats_types) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   RTC_DCHECK(callback);
-  callbacks_.push_back(callback);
+  StatsRequest request = {callback, stats_types};
 
   // "Now" using a monotonically increasing timer.
   int64_t cache_now_us = rtc::TimeMicros();
   if (cached_report_ &&
-      cache_now_us - cache_timestamp_us_ <= cache_lifetime_us_) {
+      cache_now_us - cache_timestamp_us_ <= cache_lifetime_us_ &&
+      IncludesStatsTypes(cached_stats_types_, stats_types)) {
     // We have a fresh cached report to deliver.
-    DeliverCachedReport();
+    DeliverReport(request, cached_report_, cached_stats_types_);
   } else if (!num_pending_partial_reports_) {
-    // Only start gathering stats if we're not already gathering stats. In the
-    // case of already gathering stats, |callback_| will be invoked when there
-    // are no more pending partial reports.
-
-    // "Now" using a system clock, relative to the UNIX epoch (Jan 1, 1970,
-    // UTC), in microseconds. The system clock could be modified and is not
-    // necessarily monotonically increasing.
-    int64_t timestamp_us = rtc::TimeUTCMicros();
+    requests_.push_back(request);
+    StartGatheringStats(stats_types);
+  } else if (IncludesStatsTypes(gathered_stats_types_, stats_types)) {
+    // The request is delivered when there are no more pending partial reports.
+    requests_.push_back(request);
+  } else {
+    // The stats being gathered don't include all the requested types, so they
+    // are gathered after this.
+    queued_requests_.push_back(request);
+  }
+}
 
-    num_pending_partial_reports_ = 2;
-    partial_report_timestamp_us_ = cache_now_us;
+void RTCStatsCollector::StartGatheringStats(
+    const std::set<std::string>& stats_types) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(!num_pending_partial_reports_);
+  // "Now" using a system clock, relative to the UNIX epoch (Jan 1, 1970, UTC),
+  // in microseconds. The system clock could be modified and is not
+  // necessarily monotonically increasing.
+  int64_t timestamp_us = rtc::TimeUTCMicros();
+
+  gathered_stats_types_ = stats_types;
+  bool gather_network_stats = false;
+  for (const char* type : kNetworkThreadStatsTypes)
+    gather_network_stats |= IncludesStatsType(stats_types, type);
+  // The media info is needed for the codec, RTP stream and track stats.
+  bool gather_media_info =
+      IncludesStatsType(stats_types, RTCCodecStats::kType) ||
+      IncludesStatsType(stats_types, RTCInboundRTPStreamStats::kType) ||
+      IncludesStatsType(stats_types, RTCOutboundRTPStreamStats::kType) ||
+      IncludesStatsType(stats_types, RTCMediaStreamStats::kType) ||
+      IncludesStatsType(stats_types, RTCMediaStreamTrackStats::kType);
+
+  num_pending_partial_reports_ = gather_network_stats ? 2 : 1;
+  partial_report_timestamp_us_ = rtc::TimeMicros();
+
+  if (gather_media_info) {
+    // Prepare |track_media_info_map_| for use in
+    // |ProducePartialResultsOnNetworkThread| and
+    // |ProducePartialResultsOnSignalingThread|, together with |call_stats_|
+    // since both come from the worker thread.
+    track_media_info_map_.reset(
+        PrepareTrackMediaInfoMap_s(gather_network_stats ? &call_stats_
+                                                        : nullptr)
+            .release());
+  } else if (gather_network_stats) {
+    // TODO(holmer): To avoid the hop we could move BWE and BWE stats to the
+    // network thread, where it more naturally belongs.
+    call_stats_ = pc_->session()->GetCallStats();
+  }
 
+  if (gather_network_stats) {
     // Prepare |channel_name_pairs_| for use in
     // |ProducePartialResultsOnNetworkThread|.
     channel_name_pairs_.reset(new ChannelNamePairs());
@@ -667,27 +760,17 @@ void RTCStatsCollector::GetStatsReport(
           ChannelNamePair(*pc_->session()->sctp_content_name(),
                           *pc_->session()->sctp_transport_name()));
     }
-    // Prepare |track_media_info_map_| for use in
-    // |ProducePartialResultsOnNetworkThread| and
-    // |ProducePartialResultsOnSignalingThread|.
-    track_media_info_map_.reset(PrepareTrackMediaInfoMap_s().release());
     // Prepare |track_to_id_| for use in |ProducePartialResultsOnNetworkThread|.
     // This avoids a possible deadlock if |MediaStreamTrackInterface::id| is
     // implemented to invoke on the signaling thread.
     track_to_id_ = PrepareTrackToID_s();
 
-    // Prepare |call_stats_| here since GetCallStats() will hop to the worker
-    // thread.
-    // TODO(holmer): To avoid the hop we could move BWE and BWE stats to the
-    // network thread, where it more naturally belongs.
-    call_stats_ = pc_->session()->GetCallStats();
-
     invoker_.AsyncInvoke<void>(
         RTC_FROM_HERE, network_thread_,
         rtc::Bind(&RTCStatsCollector::ProducePartialResultsOnNetworkThread,
                   rtc::scoped_refptr<RTCStatsCollector>(this), timestamp_us));
-    ProducePartialResultsOnSignalingThread(timestamp_us);
   }
+  ProducePartialResultsOnSignalingThread(timestamp_us);
 }
 
 void RTCStatsCollector::ClearCachedStatsReport() {
@@ -695,6 +778,88 @@ void RTCStatsCollector::ClearCachedStatsReport() {
   cached_report_ = nullptr;
 }
 
+bool RTCStatsCollector::AddStatsSubscription(
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback,
+    const std::set<std::string>& stats_types,
+    const std::set<std::string>& stats_ids,
+    int interval_ms) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(callback);
+  if (interval_ms <= 0) {
+    LOG(LS_ERROR) << "Invalid stats subscription interval: " << interval_ms;
+    return false;
+  }
+  RemoveStatsSubscription(callback);
+  int subscription_id = next_stats_subscription_id_++;
+  StatsSubscription& subscription = stats_subscriptions_[subscription_id];
+  subscription.callback = callback;
+  subscription.stats_types = stats_types;
+  subscription.stats_ids = stats_ids;
+  subscription.interval_ms = interval_ms;
+  SampleStatsSubscription(subscription_id);
+  return true;
+}
+
+void RTCStatsCollector::RemoveStatsSubscription(
+    RTCStatsCollectorCallback* callback) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  for (auto it = stats_subscriptions_.begin(); it != stats_subscriptions_.end();
+       ++it) {
+    if (it->second.callback.get() == callback) {
+      stats_subscriptions_.erase(it);
+      return;
+    }
+  }
+}
+
+void RTCStatsCollector::SampleStatsSubscription(int subscription_id) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  auto it = stats_subscriptions_.find(subscription_id);
+  if (it == stats_subscriptions_.end())
+    return;
+  // The next sample is scheduled before this one is gathered, so that the
+  // samples are |interval_ms| apart however long gathering takes. |invoker_|
+  // is destroyed with the collector, so it's safe to not hold a reference.
+  invoker_.AsyncInvokeDelayed<void>(
+      RTC_FROM_HERE, signaling_thread_,
+      rtc::Bind(&RTCStatsCollector::SampleStatsSubscription,
+                rtc::Unretained(this), subscription_id),
+      it->second.interval_ms);
+  GetStatsReport(
+      new rtc::RefCountedObject<StatsSubscriptionCallback>(this,
+                                                           subscription_id),
+      it->second.stats_types);
+}
+
+void RTCStatsCollector::OnStatsSubscriptionSample(
+    int subscription_id,
+    const rtc::scoped_refptr<const RTCStatsReport>& report) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  auto it = stats_subscriptions_.find(subscription_id);
+  if (it == stats_subscriptions_.end())
+    return;
+  StatsSubscription& subscription = it->second;
+  rtc::scoped_refptr<RTCStatsReport> sample =
+      RTCStatsReport::Create(report->timestamp_us());
+  rtc::scoped_refptr<RTCStatsReport> changes =
+      RTCStatsReport::Create(report->timestamp_us());
+  for (const RTCStats& stats : *report) {
+    if (!subscription.stats_ids.empty() &&
+        !subscription.stats_ids.count(stats.id())) {
+      continue;
+    }
+    const RTCStats* last_stats =
+        subscription.last_sample ? subscription.last_sample->Get(stats.id())
+                                 : nullptr;
+    if (!last_stats || *last_stats != stats)
+      changes->AddStats(stats.copy());
+    sample->AddStats(stats.copy());
+  }
+  subscription.last_sample = sample;
+  if (changes->size() > 0)
+    subscription.callback->OnStatsDelivered(changes);
+}
+
 void RTCStatsCollector::WaitForPendingRequest() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   if (num_pending_partial_reports_) {
@@ -712,9 +877,15 @@ void RTCStatsCollector::ProducePartialResultsOnSignalingThread(
   rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(
       timestamp_us);
 
-  ProduceDataChannelStats_s(timestamp_us, report.get());
-  ProduceMediaStreamAndTrackStats_s(timestamp_us, report.get());
-  ProducePeerConnectionStats_s(timestamp_us, report.get());
+  if (IncludesStatsType(gathered_stats_types_, RTCDataChannelStats::kType))
+    ProduceDataChannelStats_s(timestamp_us, report.get());
+  if (IncludesStatsType(gathered_stats_types_, RTCMediaStreamStats::kType) ||
+      IncludesStatsType(gathered_stats_types_,
+                        RTCMediaStreamTrackStats::kType)) {
+    ProduceMediaStreamAndTrackStats_s(timestamp_us, report.get());
+  }
+  if (IncludesStatsType(gathered_stats_types_, RTCPeerConnectionStats::kType))
+    ProducePeerConnectionStats_s(timestamp_us, report.get());
 
   AddPartialResults(report);
 }
@@ -728,20 +899,39 @@ void RTCStatsCollector::ProducePartialResultsOnNetworkThread(
   std::unique_ptr<SessionStats> session_stats =
       pc_->session()->GetStats(*channel_name_pairs_);
   if (session_stats) {
-    std::map<std::string, CertificateStatsPair> transport_cert_stats =
-        PrepareTransportCertificateStats_n(*session_stats);
-
-    ProduceCertificateStats_n(
-        timestamp_us, transport_cert_stats, report.get());
-    ProduceCodecStats_n(
-        timestamp_us, *track_media_info_map_, report.get());
-    ProduceIceCandidateAndPairStats_n(timestamp_us, *session_stats,
-                                      track_media_info_map_->video_media_info(),
-                                      call_stats_, report.get());
-    ProduceRTPStreamStats_n(
-        timestamp_us, *session_stats, *track_media_info_map_, report.get());
-    ProduceTransportStats_n(
-        timestamp_us, *session_stats, transport_cert_stats, report.get());
+    const std::set<std::string>& types = gathered_stats_types_;
+    std::map<std::string, CertificateStatsPair> transport_cert_stats;
+    if (IncludesStatsType(types, RTCCertificateStats::kType) ||
+        IncludesStatsType(types, RTCTransportStats::kType)) {
+      transport_cert_stats = PrepareTransportCertificateStats_n(*session_stats);
+    }
+
+    if (IncludesStatsType(types, RTCCertificateStats::kType)) {
+      ProduceCertificateStats_n(
+          timestamp_us, transport_cert_stats, report.get());
+    }
+    if (IncludesStatsType(types, RTCCodecStats::kType)) {
+      ProduceCodecStats_n(
+          timestamp_us, *track_media_info_map_, report.get());
+    }
+    if (IncludesStatsType(types, RTCIceCandidatePairStats::kType) ||
+        IncludesStatsType(types, RTCLocalIceCandidateStats::kType) ||
+        IncludesStatsType(types, RTCRemoteIceCandidateStats::kType)) {
+      ProduceIceCandidateAndPairStats_n(
+          timestamp_us, *session_stats,
+          track_media_info_map_ ? track_media_info_map_->video_media_info()
+                                : nullptr,
+          call_stats_, report.get());
+    }
+    if (IncludesStatsType(types, RTCInboundRTPStreamStats::kType) ||
+        IncludesStatsType(types, RTCOutboundRTPStreamStats::kType)) {
+      ProduceRTPStreamStats_n(
+          timestamp_us, *session_stats, *track_media_info_map_, report.get());
+    }
+    if (IncludesStatsType(types, RTCTransportStats::kType)) {
+      ProduceTransportStats_n(
+          timestamp_us, *session_stats, transport_cert_stats, report.get());
+    }
   }
 
   AddPartialResults(report);
@@ -771,6 +961,7 @@ void RTCStatsCollector::AddPartialResults_s(
   if (!num_pending_partial_reports_) {
     cache_timestamp_us_ = partial_report_timestamp_us_;
     cached_report_ = partial_report_;
+    cached_stats_types_ = gathered_stats_types_;
     partial_report_ = nullptr;
     channel_name_pairs_.reset();
     track_media_info_map_.reset();
@@ -788,19 +979,47 @@ void RTCStatsCollector::AddPartialResults_s(
         }
       }
     }
-    DeliverCachedReport();
+    std::vector<StatsRequest> requests;
+    requests.swap(requests_);
+    for (const StatsRequest& request : requests)
+      DeliverReport(request, cached_report_, cached_stats_types_);
+
+    if (!queued_requests_.empty()) {
+      // Gather all the types that the queued requests need at once.
+      std::set<std::string> stats_types;
+      bool all_stats_types = false;
+      for (const StatsRequest& request : queued_requests_) {
+        all_stats_types |= request.stats_types.empty();
+        stats_types.insert(request.stats_types.begin(),
+                           request.stats_types.end());
+      }
+      if (all_stats_types)
+        stats_types.clear();
+      requests_.swap(queued_requests_);
+      StartGatheringStats(stats_types);
+    }
   }
 }
 
-void RTCStatsCollector::DeliverCachedReport() {
+void RTCStatsCollector::DeliverReport(
+    const StatsRequest& request,
+    const rtc::scoped_refptr<const RTCStatsReport>& report,
+    const std::set<std::string>& report_stats_types) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  RTC_DCHECK(!callbacks_.empty());
-  RTC_DCHECK(cached_report_);
-  for (const rtc::scoped_refptr<RTCStatsCollectorCallback>& callback :
-       callbacks_) {
-    callback->OnStatsDelivered(cached_report_);
+  RTC_DCHECK(report);
+  if (request.stats_types == report_stats_types) {
+    request.callback->OnStatsDelivered(report);
+    return;
   }
-  callbacks_.clear();
+  // The report has stats that weren't requested, so a copy of the requested
+  // ones is delivered instead.
+  rtc::scoped_refptr<RTCStatsReport> filtered_report =
+      RTCStatsReport::Create(report->timestamp_us());
+  for (const RTCStats& stats : *report) {
+    if (IncludesStatsType(request.stats_types, stats.type()))
+      filtered_report->AddStats(stats.copy());
+  }
+  request.callback->OnStatsDelivered(filtered_report);
 }
 
 void RTCStatsCollector::ProduceCertificateStats_n(
@@ -811,11 +1030,11 @@ void RTCStatsCollector::ProduceCertificateStats_n(
   for (const auto& transport_cert_stats_pair : transport_cert_stats) {
     if (transport_cert_stats_pair.second.local) {
       ProduceCertificateStatsFromSSLCertificateStats(
-          timestamp_us, *transport_cert_stats_pair.second.local.get(), report);
+          timestamp_us, *transport_cert_stats_pair.second.local, report);
     }
     if (transport_cert_stats_pair.second.remote) {
       ProduceCertificateStatsFromSSLCertificateStats(
-          timestamp_us, *transport_cert_stats_pair.second.remote.get(), report);
+          timestamp_us, *transport_cert_stats_pair.second.remote, report);
     }
   }
 }
@@ -1185,47 +1404,79 @@ void RTCStatsCollector::ProduceTransportStats_n(
 
 std::map<std::string, RTCStatsCollector::CertificateStatsPair>
 RTCStatsCollector::PrepareTransportCertificateStats_n(
-    const SessionStats& session_stats) const {
+    const SessionStats& session_stats) {
   RTC_DCHECK(network_thread_->IsCurrent());
+  // Computing the fingerprints and base64 encoding of a certificate is
+  // expensive, so the stats of the certificates that haven't changed since
+  // the last report are reused. Transports that are gone are dropped.
+  std::map<std::string, CachedCertificateStats> certificate_stats_cache;
   std::map<std::string, CertificateStatsPair> transport_cert_stats;
   for (const auto& transport_stats : session_stats.transport_stats) {
-    CertificateStatsPair certificate_stats_pair;
+    const std::string& transport_name = transport_stats.second.transport_name;
+    CachedCertificateStats& cached =
+        certificate_stats_cache[transport_name];
+    auto it = certificate_stats_cache_.find(transport_name);
+    if (it != certificate_stats_cache_.end())
+      cached = std::move(it->second);
+
     rtc::scoped_refptr<rtc::RTCCertificate> local_certificate;
-    if (pc_->session()->GetLocalCertificate(
-        transport_stats.second.transport_name, &local_certificate)) {
-      certificate_stats_pair.local =
-          local_certificate->ssl_certificate().GetStats();
+    if (!pc_->session()->GetLocalCertificate(transport_name,
+                                             &local_certificate)) {
+      local_certificate = nullptr;
+    }
+    if (local_certificate != cached.local_certificate) {
+      cached.local_certificate = local_certificate;
+      cached.local_stats =
+          local_certificate ? local_certificate->ssl_certificate().GetStats()
+                            : nullptr;
     }
     std::unique_ptr<rtc::SSLCertificate> remote_certificate =
-        pc_->session()->GetRemoteSSLCertificate(
-            transport_stats.second.transport_name);
-    if (remote_certificate) {
-      certificate_stats_pair.remote = remote_certificate->GetStats();
+        pc_->session()->GetRemoteSSLCertificate(transport_name);
+    rtc::Buffer remote_der;
+    if (remote_certificate)
+      remote_certificate->ToDER(&remote_der);
+    if (!remote_certificate) {
+      cached.remote_der.Clear();
+      cached.remote_stats.reset();
+    } else if (!cached.remote_stats || remote_der != cached.remote_der) {
+      cached.remote_der = std::move(remote_der);
+      cached.remote_stats = remote_certificate->GetStats();
     }
+
+    CertificateStatsPair certificate_stats_pair;
+    certificate_stats_pair.local = cached.local_stats.get();
+    certificate_stats_pair.remote = cached.remote_stats.get();
     transport_cert_stats.insert(
-        std::make_pair(transport_stats.second.transport_name,
-                       std::move(certificate_stats_pair)));
+        std::make_pair(transport_name, certificate_stats_pair));
   }
+  certificate_stats_cache_.swap(certificate_stats_cache);
   return transport_cert_stats;
 }
 
 std::unique_ptr<TrackMediaInfoMap>
-RTCStatsCollector::PrepareTrackMediaInfoMap_s() const {
+RTCStatsCollector::PrepareTrackMediaInfoMap_s(Call::Stats* call_stats) const {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   std::unique_ptr<cricket::VoiceMediaInfo> voice_media_info;
-  if (pc_->session()->voice_channel()) {
-    voice_media_info.reset(new cricket::VoiceMediaInfo());
-    if (!pc_->session()->voice_channel()->GetStats(voice_media_info.get())) {
-      voice_media_info.reset();
-    }
-  }
   std::unique_ptr<cricket::VideoMediaInfo> video_media_info;
-  if (pc_->session()->video_channel()) {
-    video_media_info.reset(new cricket::VideoMediaInfo());
-    if (!pc_->session()->video_channel()->GetStats(video_media_info.get())) {
-      video_media_info.reset();
+  cricket::VoiceChannel* voice_channel = pc_->session()->voice_channel();
+  cricket::VideoChannel* video_channel = pc_->session()->video_channel();
+  // The channels and the call get their stats on the worker thread. Getting
+  // them all in one invoke blocks the signaling thread for a single hop
+  // instead of one per channel and one for the call.
+  worker_thread_->Invoke<void>(RTC_FROM_HERE, [&] {
+    if (voice_channel) {
+      voice_media_info.reset(new cricket::VoiceMediaInfo());
+      if (!voice_channel->GetStats(voice_media_info.get()))
+        voice_media_info.reset();
     }
-  }
+    if (video_channel) {
+      video_media_info.reset(new cricket::VideoMediaInfo());
+      if (!video_channel->GetStats(video_media_info.get()))
+        video_media_info.reset();
+    }
+    if (call_stats)
+      *call_stats = pc_->session()->GetCallStats();
+  });
   std::unique_ptr<TrackMediaInfoMap> track_media_info_map(
       new TrackMediaInfoMap(std::move(voice_media_info),
                             std::move(video_media_info),
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "webrtc/api/stats/rtcstats_objects.h"
@@ -24,8 +25,10 @@
 #include "webrtc/pc/datachannel.h"
 #include "webrtc/pc/trackmediainfomap.h"
 #include "webrtc/rtc_base/asyncinvoker.h"
+#include "webrtc/rtc_base/buffer.h"
 #include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/refcount.h"
+#include "webrtc/rtc_base/rtccertificate.h"
 #include "webrtc/rtc_base/scoped_ref_ptr.h"
 #include "webrtc/rtc_base/sigslot.h"
 #include "webrtc/rtc_base/sslidentity.h"
@@ -48,7 +51,8 @@ struct ChannelNamePairs;
 // All public methods of the collector are to be called on the signaling thread.
 // Stats are gathered on the signaling, worker and network threads
 // asynchronously. The callback is invoked on the signaling thread. Resulting
-// reports are cached for |cache_lifetime_| ms.
+// reports are cached for |cache_lifetime_| ms. The stats of certificates that
+// haven't changed are reused between reports.
 class RTCStatsCollector : public virtual rtc::RefCountInterface,
                           public sigslot::has_slots<> {
  public:
@@ -61,10 +65,27 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // considered fresh for |cache_lifetime_| ms. const RTCStatsReports are safe
   // to use across multiple threads and may be destructed on any thread.
   void GetStatsReport(rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
+  // Like the above, but the report only has the stats of |stats_types|, e.g.
+  // RTCPeerConnectionStats::kType, of which all are included if it's empty.
+  // Only the stats that are needed are gathered, e.g. the network thread isn't
+  // invoked if none of its stats are requested, unless a fresh or pending
+  // report that includes them can be used instead.
+  void GetStatsReport(rtc::scoped_refptr<RTCStatsCollectorCallback> callback,
+                      const std::set<std::string>& stats_types);
   // Clears the cache's reference to the most recent stats report. Subsequently
   // calling |GetStatsReport| guarantees fresh stats.
   void ClearCachedStatsReport();
 
+  // Samples the stats of |stats_types| every |interval_ms|, starting now, and
+  // delivers the ones that are new or have changed since the previous sample
+  // to |callback|. See PeerConnectionInterface::SubscribeStats().
+  bool AddStatsSubscription(
+      rtc::scoped_refptr<RTCStatsCollectorCallback> callback,
+      const std::set<std::string>& stats_types,
+      const std::set<std::string>& stats_ids,
+      int interval_ms);
+  void RemoveStatsSubscription(RTCStatsCollectorCallback* callback);
+
   // If there is a |GetStatsReport| requests in-flight, waits until it has been
   // completed. Must be called on the signaling thread.
   void WaitForPendingRequest();
@@ -83,13 +104,48 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
       const rtc::scoped_refptr<RTCStatsReport>& partial_report);
 
  private:
+  class StatsSubscriptionCallback;
+
+  // Points into |certificate_stats_cache_|.
   struct CertificateStatsPair {
-    std::unique_ptr<rtc::SSLCertificateStats> local;
-    std::unique_ptr<rtc::SSLCertificateStats> remote;
+    const rtc::SSLCertificateStats* local = nullptr;
+    const rtc::SSLCertificateStats* remote = nullptr;
+  };
+  struct CachedCertificateStats {
+    rtc::scoped_refptr<rtc::RTCCertificate> local_certificate;
+    std::unique_ptr<rtc::SSLCertificateStats> local_stats;
+    rtc::Buffer remote_der;
+    std::unique_ptr<rtc::SSLCertificateStats> remote_stats;
+  };
+  struct StatsRequest {
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback;
+    // All types if empty.
+    std::set<std::string> stats_types;
   };
 
+  struct StatsSubscription {
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback;
+    std::set<std::string> stats_types;
+    std::set<std::string> stats_ids;
+    int interval_ms;
+    // The subscribed stats of the previous sample.
+    rtc::scoped_refptr<const RTCStatsReport> last_sample;
+  };
+
+  // Gathers a sample of the subscription, and schedules the next one.
+  void SampleStatsSubscription(int subscription_id);
+  void OnStatsSubscriptionSample(
+      int subscription_id,
+      const rtc::scoped_refptr<const RTCStatsReport>& report);
+
+  // Starts gathering the stats of |stats_types|, all if it's empty.
+  void StartGatheringStats(const std::set<std::string>& stats_types);
   void AddPartialResults_s(rtc::scoped_refptr<RTCStatsReport> partial_report);
-  void DeliverCachedReport();
+  // Delivers |report|, which has the stats of |report_stats_types|, or the
+  // requested stats of it.
+  void DeliverReport(const StatsRequest& request,
+                     const rtc::scoped_refptr<const RTCStatsReport>& report,
+                     const std::set<std::string>& report_stats_types);
 
   // Produces |RTCCertificateStats|.
   void ProduceCertificateStats_n(
@@ -129,8 +185,10 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
 
   // Helper function to stats-producing functions.
   std::map<std::string, CertificateStatsPair>
-  PrepareTransportCertificateStats_n(const SessionStats& session_stats) const;
-  std::unique_ptr<TrackMediaInfoMap> PrepareTrackMediaInfoMap_s() const;
+  PrepareTransportCertificateStats_n(const SessionStats& session_stats);
+  // Also gets |call_stats| from the worker thread, unless it's null.
+  std::unique_ptr<TrackMediaInfoMap> PrepareTrackMediaInfoMap_s(
+      Call::Stats* call_stats) const;
   std::map<MediaStreamTrackInterface*, std::string> PrepareTrackToID_s() const;
 
   // Slots for signals (sigslot) that are wired up to |pc_|.
@@ -148,7 +206,10 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   int num_pending_partial_reports_;
   int64_t partial_report_timestamp_us_;
   rtc::scoped_refptr<RTCStatsReport> partial_report_;
-  std::vector<rtc::scoped_refptr<RTCStatsCollectorCallback>> callbacks_;
+  // Delivered when the stats being gathered are.
+  std::vector<StatsRequest> requests_;
+  // For stats that aren't being gathered, delivered after the next gathering.
+  std::vector<StatsRequest> queued_requests_;
 
   // Set in |GetStatsReport|, read in |ProducePartialResultsOnNetworkThread| and
   // |ProducePartialResultsOnSignalingThread|, reset after work is complete. Not
@@ -158,6 +219,16 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   std::unique_ptr<TrackMediaInfoMap> track_media_info_map_;
   std::map<MediaStreamTrackInterface*, std::string> track_to_id_;
   Call::Stats call_stats_;
+  // The types of the stats being gathered, all if empty.
+  std::set<std::string> gathered_stats_types_;
+
+  // Only used on the network thread.
+  std::map<std::string, CachedCertificateStats> certificate_stats_cache_;
+
+  // By subscription ID, which isn't reused so that the samples of a removed
+  // subscription are dropped.
+  std::map<int, StatsSubscription> stats_subscriptions_;
+  int next_stats_subscription_id_;
 
   // A timestamp, in microseconds, that is based on a timer that is
   // monotonically increasing. That is, even if the system clock is modified the
@@ -166,6 +237,8 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   int64_t cache_timestamp_us_;
   int64_t cache_lifetime_us_;
   rtc::scoped_refptr<const RTCStatsReport> cached_report_;
+  // The types of the stats of |cached_report_|, all if empty.
+  std::set<std::string> cached_stats_types_;
 
   // Data recorded and maintained by the stats collector during its lifetime.
   // Some stats are produced from this record instead of other components.
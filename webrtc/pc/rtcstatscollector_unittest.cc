@@ -711,6 +711,112 @@ TEST_F(RTCStatsCollectorTest, MultipleCallbacksWithInvalidatedCacheInBetween) {
   EXPECT_NE(c.get(), b.get());
 }
 
+TEST_F(RTCStatsCollectorTest, GetStatsReportOfTypes) {
+  // None of the requested stats are produced on the network thread, so it
+  // isn't invoked.
+  EXPECT_CALL(test_->session(), GetStats(_)).Times(0);
+  rtc::scoped_refptr<const RTCStatsReport> report;
+  collector_->GetStatsReport(RTCStatsObtainer::Create(&report),
+                             {RTCPeerConnectionStats::kType});
+  EXPECT_TRUE_WAIT(report, kGetStatsReportTimeoutMs);
+  EXPECT_EQ(1u, report->size());
+  EXPECT_TRUE(report->Get("RTCPeerConnection"));
+}
+
+TEST_F(RTCStatsCollectorTest, ReportOfTypesIsFilteredFromCachedReport) {
+  test_->data_channels().push_back(DataChannel::Create(
+      nullptr, cricket::DCT_NONE, "DummyChannel", InternalDataChannelInit()));
+  rtc::scoped_refptr<const RTCStatsReport> full_report = GetStatsReport();
+
+  // The cached report is fresh, so it's filtered right away.
+  rtc::scoped_refptr<const RTCStatsReport> report;
+  collector_->GetStatsReport(RTCStatsObtainer::Create(&report),
+                             {RTCDataChannelStats::kType});
+  ASSERT_TRUE(report);
+  EXPECT_NE(full_report.get(), report.get());
+  EXPECT_EQ(full_report->timestamp_us(), report->timestamp_us());
+  EXPECT_EQ(1u, report->size());
+  for (const RTCStats& stats : *report) {
+    EXPECT_STREQ(RTCDataChannelStats::kType, stats.type());
+    ASSERT_TRUE(full_report->Get(stats.id()));
+    EXPECT_EQ(*full_report->Get(stats.id()), stats);
+  }
+}
+
+TEST_F(RTCStatsCollectorTest, RequestOfOtherTypesIsGatheredAfterPending) {
+  rtc::scoped_refptr<const RTCStatsReport> transport_report;
+  rtc::scoped_refptr<const RTCStatsReport> full_report;
+  collector_->GetStatsReport(RTCStatsObtainer::Create(&transport_report),
+                             {RTCTransportStats::kType});
+  collector_->GetStatsReport(RTCStatsObtainer::Create(&full_report));
+  EXPECT_TRUE_WAIT(transport_report, kGetStatsReportTimeoutMs);
+  EXPECT_TRUE_WAIT(full_report, kGetStatsReportTimeoutMs);
+  EXPECT_FALSE(transport_report->Get("RTCPeerConnection"));
+  EXPECT_TRUE(full_report->Get("RTCPeerConnection"));
+}
+
+// Collects the reports delivered to a stats subscription.
+class RTCStatsReportsObtainer : public RTCStatsCollectorCallback {
+ public:
+  void OnStatsDelivered(
+      const rtc::scoped_refptr<const RTCStatsReport>& report) override {
+    reports_.push_back(report);
+  }
+
+  const std::vector<rtc::scoped_refptr<const RTCStatsReport>>& reports() {
+    return reports_;
+  }
+
+ private:
+  std::vector<rtc::scoped_refptr<const RTCStatsReport>> reports_;
+};
+
+TEST_F(RTCStatsCollectorTest, StatsSubscriptionDeliversChangedStats) {
+  rtc::scoped_refptr<RTCStatsReportsObtainer> obtainer(
+      new rtc::RefCountedObject<RTCStatsReportsObtainer>());
+  EXPECT_FALSE(collector_->AddStatsSubscription(
+      obtainer, {RTCPeerConnectionStats::kType}, {}, 0));
+  ASSERT_TRUE(collector_->AddStatsSubscription(
+      obtainer, {RTCPeerConnectionStats::kType}, {}, 1000));
+  // The first sample is taken right away.
+  EXPECT_EQ_WAIT(1u, obtainer->reports().size(), kGetStatsReportTimeoutMs);
+  EXPECT_EQ(1u, obtainer->reports()[0]->size());
+  ASSERT_TRUE(obtainer->reports()[0]->Get("RTCPeerConnection"));
+
+  // Nothing has changed, so nothing is delivered.
+  test_->fake_clock().AdvanceTime(rtc::TimeDelta::FromMilliseconds(1000));
+  EXPECT_EQ(1u, obtainer->reports().size());
+
+  rtc::scoped_refptr<DataChannel> dummy_channel = DataChannel::Create(
+      nullptr, cricket::DCT_NONE, "DummyChannel", InternalDataChannelInit());
+  test_->pc().SignalDataChannelCreated(dummy_channel.get());
+  dummy_channel->SignalOpened(dummy_channel.get());
+  test_->fake_clock().AdvanceTime(rtc::TimeDelta::FromMilliseconds(1000));
+  ASSERT_EQ_WAIT(2u, obtainer->reports().size(), kGetStatsReportTimeoutMs);
+  const RTCStats* stats = obtainer->reports()[1]->Get("RTCPeerConnection");
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(1u,
+            *stats->cast_to<RTCPeerConnectionStats>().data_channels_opened);
+
+  collector_->RemoveStatsSubscription(obtainer);
+  dummy_channel->SignalClosed(dummy_channel.get());
+  test_->fake_clock().AdvanceTime(rtc::TimeDelta::FromMilliseconds(1000));
+  EXPECT_EQ(2u, obtainer->reports().size());
+}
+
+TEST_F(RTCStatsCollectorTest, StatsSubscriptionOfIds) {
+  test_->data_channels().push_back(DataChannel::Create(
+      nullptr, cricket::DCT_NONE, "DummyChannel", InternalDataChannelInit()));
+  rtc::scoped_refptr<RTCStatsReportsObtainer> obtainer(
+      new rtc::RefCountedObject<RTCStatsReportsObtainer>());
+  ASSERT_TRUE(collector_->AddStatsSubscription(obtainer, {},
+                                               {"RTCPeerConnection"}, 1000));
+  EXPECT_EQ_WAIT(1u, obtainer->reports().size(), kGetStatsReportTimeoutMs);
+  EXPECT_EQ(1u, obtainer->reports()[0]->size());
+  EXPECT_TRUE(obtainer->reports()[0]->Get("RTCPeerConnection"));
+  collector_->RemoveStatsSubscription(obtainer);
+}
+
 TEST_F(RTCStatsCollectorTest, CollectRTCCertificateStatsSingle) {
   std::unique_ptr<CertificateInfo> local_certinfo =
       CreateFakeCertificateAndInfoFromDers(
@@ -748,6 +854,52 @@ TEST_F(RTCStatsCollectorTest, CollectRTCCertificateStatsSingle) {
   ExpectReportContainsCertificateInfo(report, *remote_certinfo);
 }
 
+TEST_F(RTCStatsCollectorTest, CollectRTCCertificateStatsOfChangedCertificate) {
+  std::unique_ptr<CertificateInfo> local_certinfo =
+      CreateFakeCertificateAndInfoFromDers(
+          std::vector<std::string>({ "(local) certificate" }));
+  std::unique_ptr<CertificateInfo> remote_certinfo =
+      CreateFakeCertificateAndInfoFromDers(
+          std::vector<std::string>({ "(remote) certificate" }));
+  CertificateInfo* current_remote_certinfo = remote_certinfo.get();
+
+  EXPECT_CALL(test_->session(), GetStats(_)).WillRepeatedly(Invoke(
+      [](const ChannelNamePairs&) {
+        std::unique_ptr<SessionStats> stats(new SessionStats());
+        stats->transport_stats["transport"].transport_name = "transport";
+        return stats;
+      }));
+  EXPECT_CALL(test_->session(), GetLocalCertificate(_, _)).WillRepeatedly(
+      Invoke([&local_certinfo](const std::string& transport_name,
+             rtc::scoped_refptr<rtc::RTCCertificate>* certificate) {
+        *certificate = local_certinfo->certificate;
+        return true;
+      }));
+  EXPECT_CALL(test_->session(),
+      GetRemoteSSLCertificate_ReturnsRawPointer(_)).WillRepeatedly(Invoke(
+      [&current_remote_certinfo](const std::string& transport_name) {
+        return current_remote_certinfo->certificate->ssl_certificate()
+            .GetReference();
+      }));
+
+  rtc::scoped_refptr<const RTCStatsReport> report = GetStatsReport();
+  ExpectReportContainsCertificateInfo(report, *local_certinfo);
+  ExpectReportContainsCertificateInfo(report, *remote_certinfo);
+
+  // The stats of the unchanged local certificate are reused, and those of the
+  // new remote certificate replace the old ones.
+  std::unique_ptr<CertificateInfo> new_remote_certinfo =
+      CreateFakeCertificateAndInfoFromDers(
+          std::vector<std::string>({ "(remote) new certificate" }));
+  current_remote_certinfo = new_remote_certinfo.get();
+  collector_->ClearCachedStatsReport();
+  report = GetStatsReport();
+  ExpectReportContainsCertificateInfo(report, *local_certinfo);
+  ExpectReportContainsCertificateInfo(report, *new_remote_certinfo);
+  EXPECT_FALSE(report->Get(
+      "RTCCertificate_" + remote_certinfo->fingerprints[0]));
+}
+
 TEST_F(RTCStatsCollectorTest, CollectRTCCodecStats) {
   MockVoiceMediaChannel* voice_media_channel = new MockVoiceMediaChannel();
   cricket::VoiceChannel voice_channel(
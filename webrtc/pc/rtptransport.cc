@@ -189,7 +189,8 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
   // transport. We check the RTP payload type to determine if it is RTCP.
   bool rtcp = transport == rtcp_packet_transport() ||
               IsRtcp(data, static_cast<int>(len));
-  rtc::CopyOnWriteBuffer packet(data, len);
+  rtc::CopyOnWriteBuffer packet =
+      packet_pool_.CreateBuffer(reinterpret_cast<const uint8_t*>(data), len);
 
   if (!WantsPacket(rtcp, &packet)) {
     return;
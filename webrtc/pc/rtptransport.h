@@ -13,6 +13,7 @@
 
 #include "webrtc/pc/bundlefilter.h"
 #include "webrtc/pc/rtptransportinternal.h"
+#include "webrtc/rtc_base/copyonwritebufferpool.h"
 #include "webrtc/rtc_base/sigslot.h"
 
 namespace rtc {
@@ -100,6 +101,15 @@ class RtpTransport : public RtpTransportInternal {
   RtpTransportParameters parameters_;
 
   cricket::BundleFilter bundle_filter_;
+
+  // Same as cricket::kMaxRtpPacketLen.
+  static const size_t kPacketPoolBufferCapacity = 2048;
+  static const size_t kPacketPoolMaxFreeBuffers = 256;
+  // Incoming packets are copied out of the socket buffer once, into recycled
+  // storage. SRTP decryption and the hop to the worker thread then operate on
+  // that same buffer.
+  rtc::CopyOnWriteBufferPool packet_pool_{kPacketPoolBufferCapacity,
+                                          kPacketPoolMaxFreeBuffers};
 };
 
 }  // namespace webrtc
@@ -55,7 +55,10 @@ bool SrtpSession::ProtectRtp(void* p, int in_len, int max_len, int* out_len) {
     LOG(LS_WARNING) << "Failed to protect SRTP packet: no SRTP Session";
     return false;
   }
+  return DoProtectRtp(p, in_len, max_len, out_len);
+}
 
+bool SrtpSession::DoProtectRtp(void* p, int in_len, int max_len, int* out_len) {
   int need_len = in_len + rtp_auth_tag_len_;  // NOLINT
   if (max_len < need_len) {
     LOG(LS_WARNING) << "Failed to protect SRTP packet: The buffer length "
@@ -117,7 +120,10 @@ bool SrtpSession::UnprotectRtp(void* p, int in_len, int* out_len) {
     LOG(LS_WARNING) << "Failed to unprotect SRTP packet: no SRTP Session";
     return false;
   }
+  return DoUnprotectRtp(p, in_len, out_len);
+}
 
+bool SrtpSession::DoUnprotectRtp(void* p, int in_len, int* out_len) {
   *out_len = in_len;
   int err = srtp_unprotect(session_, p, out_len);
   if (err != srtp_err_status_ok) {
@@ -127,6 +133,54 @@ bool SrtpSession::UnprotectRtp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+size_t SrtpSession::ProtectRtpPackets(Packet* packets, size_t num_packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to protect " << num_packets
+                    << " SRTP packets: no SRTP Session";
+    for (size_t i = 0; i < num_packets; ++i) {
+      packets[i].ok = false;
+    }
+    return 0;
+  }
+
+  size_t num_protected = 0;
+  for (size_t i = 0; i < num_packets; ++i) {
+    Packet& packet = packets[i];
+    int out_len = 0;
+    packet.ok = DoProtectRtp(packet.data, packet.len, packet.max_len, &out_len);
+    if (packet.ok) {
+      packet.len = out_len;
+      ++num_protected;
+    }
+  }
+  return num_protected;
+}
+
+size_t SrtpSession::UnprotectRtpPackets(Packet* packets, size_t num_packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to unprotect " << num_packets
+                    << " SRTP packets: no SRTP Session";
+    for (size_t i = 0; i < num_packets; ++i) {
+      packets[i].ok = false;
+    }
+    return 0;
+  }
+
+  size_t num_unprotected = 0;
+  for (size_t i = 0; i < num_packets; ++i) {
+    Packet& packet = packets[i];
+    int out_len = 0;
+    packet.ok = DoUnprotectRtp(packet.data, packet.len, &out_len);
+    if (packet.ok) {
+      packet.len = out_len;
+      ++num_unprotected;
+    }
+  }
+  return num_unprotected;
+}
+
 bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   if (!session_) {
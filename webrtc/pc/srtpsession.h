@@ -56,6 +56,24 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // An RTP packet for the batched methods below.
+  struct Packet {
+    void* data = nullptr;
+    // The length of the packet; updated when it is protected or unprotected.
+    int len = 0;
+    // The size of the buffer at |data|. Only used for protecting.
+    int max_len = 0;
+    // Set to whether the packet was protected or unprotected.
+    bool ok = false;
+  };
+  // Like calling ProtectRtp() or UnprotectRtp() for each of |num_packets|
+  // |packets| in turn, e.g. for a burst from the pacer, but with the session
+  // checked once per batch. A packet that fails keeps its |len|, and doesn't
+  // keep the others from being processed. Returns the number of packets that
+  // succeeded.
+  size_t ProtectRtpPackets(Packet* packets, size_t num_packets);
+  size_t UnprotectRtpPackets(Packet* packets, size_t num_packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -81,6 +99,9 @@ class SrtpSession {
   bool DoSetKey(int type, int cs, const uint8_t* key, size_t len);
   bool SetKey(int type, int cs, const uint8_t* key, size_t len);
   bool UpdateKey(int type, int cs, const uint8_t* key, size_t len);
+  // ProtectRtp() and UnprotectRtp() after checking the session.
+  bool DoProtectRtp(void* p, int in_len, int max_len, int* out_len);
+  bool DoUnprotectRtp(void* p, int in_len, int* out_len);
   bool SetEncryptedHeaderExtensionIds(
       int type,
       const std::vector<int>& encrypted_header_extension_ids);
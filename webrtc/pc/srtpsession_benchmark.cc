@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "webrtc/pc/srtpsession.h"
+#include "webrtc/rtc_base/byteorder.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/sslstreamadapter.h"  // For rtc::SRTP_*
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/benchmark.h"
+
+namespace cricket {
+namespace {
+constexpr uint8_t kTestKey[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
+constexpr int kTestKeyLen = 30;
+constexpr int kPacketSize = 1200;
+// Room for the authentication tag.
+constexpr int kMaxPacketSize = kPacketSize + 16;
+}  // namespace
+
+// Protects a video sized packet with the default crypto suite.
+TEST(SrtpSessionBenchmark, ProtectRtp) {
+  SrtpSession session;
+  ASSERT_TRUE(
+      session.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey, kTestKeyLen));
+  uint8_t packet[kMaxPacketSize];
+  memset(packet, 0x5a, sizeof(packet));
+  packet[0] = 0x80;
+  packet[1] = 100;
+  rtc::SetBE32(&packet[4], 90000);
+  rtc::SetBE32(&packet[8], 0x12345678);
+
+  uint8_t buffer[kMaxPacketSize];
+  uint16_t sequence_number = 0;
+  int out_len = 0;
+  webrtc::test::RunBenchmark("SrtpSession_ProtectRtp", kPacketSize, [&] {
+    // libsrtp refuses to protect the same sequence number twice.
+    rtc::SetBE16(&packet[2], sequence_number++);
+    memcpy(buffer, packet, kPacketSize);
+    RTC_CHECK(session.ProtectRtp(buffer, kPacketSize, sizeof(buffer),
+                                 &out_len));
+  });
+  EXPECT_EQ(kPacketSize + 10, out_len);
+}
+
+}  // namespace cricket
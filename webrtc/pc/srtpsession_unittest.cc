@@ -11,14 +11,57 @@
 #include "webrtc/pc/srtpsession.h"
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "webrtc/media/base/fakertp.h"
 #include "webrtc/pc/srtptestutil.h"
+#include "webrtc/rtc_base/byteorder.h"
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/sslstreamadapter.h"  // For rtc::SRTP_*
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace rtc {
 
+namespace {
+
+static const uint8_t kTestKeyGcm128[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ12";
+static const int kTestKeyGcm128Len = 28;  // 128 bits key + 96 bits salt.
+static const uint8_t kTestKeyGcm256[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ123456789ABCDEFGHI";
+static const int kTestKeyGcm256Len = 44;  // 256 bits key + 96 bits salt.
+// Room for the largest auth tag, of the GCM cipher suites.
+static const int kMaxAuthTagLen = 16;
+
+// Copies of kPcmuFrame with the sequence numbers of |num_packets| packets
+// from |first_seq_num| on, in buffers with room for the auth tag.
+std::vector<std::vector<char>> CreateRtpPackets(size_t num_packets,
+                                                uint16_t first_seq_num) {
+  std::vector<std::vector<char>> packets;
+  for (size_t i = 0; i < num_packets; ++i) {
+    std::vector<char> packet(sizeof(kPcmuFrame) + kMaxAuthTagLen);
+    memcpy(packet.data(), kPcmuFrame, sizeof(kPcmuFrame));
+    SetBE16(packet.data() + 2, static_cast<uint16_t>(first_seq_num + i));
+    packets.push_back(std::move(packet));
+  }
+  return packets;
+}
+
+std::vector<cricket::SrtpSession::Packet> CreateBatch(
+    std::vector<std::vector<char>>* buffers,
+    int len) {
+  std::vector<cricket::SrtpSession::Packet> batch(buffers->size());
+  for (size_t i = 0; i < buffers->size(); ++i) {
+    batch[i].data = (*buffers)[i].data();
+    batch[i].len = len;
+    batch[i].max_len = static_cast<int>((*buffers)[i].size());
+  }
+  return batch;
+}
+
+}  // namespace
+
 class SrtpSessionTest : public testing::Test {
  protected:
   virtual void SetUp() {
@@ -201,4 +244,145 @@ TEST_F(SrtpSessionTest, TestReplay) {
       s1_.ProtectRtp(rtp_packet_, rtp_len_, sizeof(rtp_packet_), &out_len));
 }
 
+// Test that a batch of RTP packets can be protected and unprotected.
+TEST_F(SrtpSessionTest, TestProtectUnprotectRtpPackets) {
+  EXPECT_TRUE(s1_.SetSend(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  std::vector<std::vector<char>> buffers = CreateRtpPackets(4, 1);
+  std::vector<std::vector<char>> expected = buffers;
+  std::vector<cricket::SrtpSession::Packet> batch =
+      CreateBatch(&buffers, sizeof(kPcmuFrame));
+
+  EXPECT_EQ(4U, s1_.ProtectRtpPackets(batch.data(), batch.size()));
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)) +
+                  rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80),
+              batch[i].len);
+    EXPECT_NE(0, memcmp(buffers[i].data(), expected[i].data(),
+                        sizeof(kPcmuFrame)));
+  }
+
+  EXPECT_EQ(4U, s2_.UnprotectRtpPackets(batch.data(), batch.size()));
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[i].len);
+    EXPECT_EQ(0, memcmp(buffers[i].data(), expected[i].data(),
+                        sizeof(kPcmuFrame)));
+  }
+}
+
+// Test that a packet that fails doesn't keep the rest of its batch from
+// being processed.
+TEST_F(SrtpSessionTest, TestRtpPacketsFailIndividually) {
+  EXPECT_TRUE(s1_.SetSend(SRTP_AEAD_AES_128_GCM, kTestKeyGcm128,
+                          kTestKeyGcm128Len));
+  EXPECT_TRUE(s2_.SetRecv(SRTP_AEAD_AES_128_GCM, kTestKeyGcm128,
+                          kTestKeyGcm128Len));
+  std::vector<std::vector<char>> buffers = CreateRtpPackets(3, 1);
+  std::vector<cricket::SrtpSession::Packet> batch =
+      CreateBatch(&buffers, sizeof(kPcmuFrame));
+  // No room for the auth tag.
+  batch[1].max_len = sizeof(kPcmuFrame);
+
+  EXPECT_EQ(2U, s1_.ProtectRtpPackets(batch.data(), batch.size()));
+  EXPECT_TRUE(batch[0].ok);
+  EXPECT_FALSE(batch[1].ok);
+  EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[1].len);
+  EXPECT_TRUE(batch[2].ok);
+
+  // The packet that wasn't protected can't be unprotected.
+  EXPECT_EQ(2U, s2_.UnprotectRtpPackets(batch.data(), batch.size()));
+  EXPECT_TRUE(batch[0].ok);
+  EXPECT_FALSE(batch[1].ok);
+  EXPECT_TRUE(batch[2].ok);
+}
+
+TEST_F(SrtpSessionTest, TestRtpPacketsWithoutSession) {
+  std::vector<std::vector<char>> buffers = CreateRtpPackets(2, 1);
+  std::vector<cricket::SrtpSession::Packet> batch =
+      CreateBatch(&buffers, sizeof(kPcmuFrame));
+  batch[0].ok = true;
+  EXPECT_EQ(0U, s1_.ProtectRtpPackets(batch.data(), batch.size()));
+  EXPECT_FALSE(batch[0].ok);
+  EXPECT_FALSE(batch[1].ok);
+  EXPECT_EQ(0U, s2_.UnprotectRtpPackets(batch.data(), batch.size()));
+}
+
+// Reports how many MB/s of RTP packets are protected and unprotected with
+// each cipher suite, one packet per call and in batches of 16, the size of a
+// burst from the pacer.
+TEST(SrtpSessionPerfTest, DISABLED_ProtectUnprotectRtpPerf) {
+  const size_t kNumPackets = 16000;
+  const size_t kBatchSize = 16;
+  struct CipherSuite {
+    const char* name;
+    int cs;
+    const uint8_t* key;
+    int key_len;
+  };
+  const CipherSuite kCipherSuites[] = {
+      {"aes_cm_128_hmac_sha1_80", SRTP_AES128_CM_SHA1_80, kTestKey1,
+       kTestKeyLen},
+      {"aead_aes_128_gcm", SRTP_AEAD_AES_128_GCM, kTestKeyGcm128,
+       kTestKeyGcm128Len},
+      {"aead_aes_256_gcm", SRTP_AEAD_AES_256_GCM, kTestKeyGcm256,
+       kTestKeyGcm256Len},
+  };
+  const int payload_bytes = static_cast<int>(kNumPackets * sizeof(kPcmuFrame));
+
+  for (const CipherSuite& suite : kCipherSuites) {
+    for (bool batched : {false, true}) {
+      const std::string trace =
+          std::string(suite.name) + (batched ? "_batched" : "_single");
+      cricket::SrtpSession sender;
+      cricket::SrtpSession receiver;
+      ASSERT_TRUE(sender.SetSend(suite.cs, suite.key, suite.key_len));
+      ASSERT_TRUE(receiver.SetRecv(suite.cs, suite.key, suite.key_len));
+      std::vector<std::vector<char>> buffers =
+          CreateRtpPackets(kNumPackets, 1);
+      std::vector<cricket::SrtpSession::Packet> packets =
+          CreateBatch(&buffers, sizeof(kPcmuFrame));
+
+      int64_t start_ns = TimeNanos();
+      if (batched) {
+        for (size_t i = 0; i < kNumPackets; i += kBatchSize) {
+          ASSERT_EQ(kBatchSize,
+                    sender.ProtectRtpPackets(&packets[i], kBatchSize));
+        }
+      } else {
+        for (cricket::SrtpSession::Packet& packet : packets) {
+          ASSERT_TRUE(sender.ProtectRtp(packet.data, packet.len,
+                                        packet.max_len, &packet.len));
+        }
+      }
+      int64_t protect_ns = TimeNanos() - start_ns;
+
+      start_ns = TimeNanos();
+      if (batched) {
+        for (size_t i = 0; i < kNumPackets; i += kBatchSize) {
+          ASSERT_EQ(kBatchSize,
+                    receiver.UnprotectRtpPackets(&packets[i], kBatchSize));
+        }
+      } else {
+        for (cricket::SrtpSession::Packet& packet : packets) {
+          ASSERT_TRUE(
+              receiver.UnprotectRtp(packet.data, packet.len, &packet.len));
+        }
+      }
+      int64_t unprotect_ns = TimeNanos() - start_ns;
+
+      // Bytes per nanosecond times 1000 is MB/s.
+      webrtc::test::PrintResult(
+          "srtp_protect", "", trace,
+          static_cast<size_t>(payload_bytes * 1000LL / protect_ns), "MB/s",
+          false);
+      webrtc::test::PrintResult(
+          "srtp_unprotect", "", trace,
+          static_cast<size_t>(payload_bytes * 1000LL / unprotect_ns), "MB/s",
+          false);
+    }
+  }
+}
+
 }  // namespace rtc
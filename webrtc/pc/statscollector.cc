@@ -269,6 +269,10 @@ void ExtractStats(const cricket::VideoReceiverInfo& info, StatsReport* report) {
     report->AddString(StatsReport::kStatsValueNameTimingFrameInfo,
                       info.timing_frame_info->ToString());
   }
+  if (info.timing_frame_stage_delays) {
+    report->AddString(StatsReport::kStatsValueNameTimingFrameStageDelays,
+                      info.timing_frame_stage_delays->ToString());
+  }
 
   report->AddInt64(StatsReport::kStatsValueNameInterframeDelayMaxMs,
                    info.interframe_delay_max_ms);
@@ -682,7 +686,6 @@ StatsReport* StatsCollector::AddCandidateReport(
   StatsReport* report = reports_.Find(id);
   if (!report) {
     report = reports_.InsertNew(id);
-    report->set_timestamp(stats_gathering_started_);
     if (local) {
       report->AddString(StatsReport::kStatsValueNameCandidateNetworkType,
                         AdapterTypeToStatsType(candidate.network_type()));
@@ -698,6 +701,8 @@ StatsReport* StatsCollector::AddCandidateReport(
     report->AddString(StatsReport::kStatsValueNameCandidateTransportType,
                       candidate.protocol());
   }
+  // Updated even if the report exists, to mark the candidate as still in use.
+  report->set_timestamp(stats_gathering_started_);
 
   return report;
 }
@@ -794,6 +799,19 @@ void StatsCollector::ExtractSessionInfo() {
       }
     }
   }
+
+  // The reports above are all refreshed on each update. Ones that weren't
+  // belong to connections, candidates or transports that are gone; removing
+  // them keeps the collection from growing over a long call.
+  const StatsReport::StatsType kSessionInfoTypes[] = {
+      StatsReport::kStatsReportTypeCertificate,
+      StatsReport::kStatsReportTypeComponent,
+      StatsReport::kStatsReportTypeCandidatePair,
+      StatsReport::kStatsReportTypeIceLocalCandidate,
+      StatsReport::kStatsReportTypeIceRemoteCandidate,
+  };
+  for (StatsReport::StatsType type : kSessionInfoTypes)
+    reports_.RemoveStale(type, stats_gathering_started_);
 }
 
 void StatsCollector::ExtractBweInfo() {
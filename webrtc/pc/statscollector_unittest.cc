@@ -500,6 +500,8 @@ class StatsCollectorForTest : public webrtc::StatsCollector {
     return time_now_;
   }
 
+  void set_time_now(double time_now) { time_now_ = time_now; }
+
  private:
   double time_now_;
 };
@@ -1469,6 +1471,78 @@ TEST_F(StatsCollectorTest, IceCandidateReport) {
                 StatsReport::kStatsValueNameCandidateNetworkType));
 }
 
+// Candidate and candidate pair reports of connections that are gone should be
+// removed on the next update rather than accumulate.
+TEST_F(StatsCollectorTest, ReportsOfGoneConnectionsAreRemoved) {
+  StatsCollectorForTest stats(&pc_);
+
+  EXPECT_CALL(session_, GetLocalCertificate(_, _))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(session_, GetRemoteSSLCertificate_ReturnsRawPointer(_))
+      .WillRepeatedly(Return(nullptr));
+
+  cricket::ConnectionInfo connection_info;
+  connection_info.local_candidate.set_address(
+      rtc::SocketAddress("192.168.0.1", 2000));
+  connection_info.remote_candidate.set_address(
+      rtc::SocketAddress("192.168.0.2", 2001));
+  cricket::ConnectionInfo other_connection_info;
+  other_connection_info.local_candidate.set_address(
+      rtc::SocketAddress("192.168.0.1", 3000));
+  other_connection_info.remote_candidate.set_address(
+      rtc::SocketAddress("192.168.0.2", 3001));
+
+  cricket::TransportChannelStats channel_stats;
+  channel_stats.component = 1;
+  channel_stats.connection_infos.push_back(connection_info);
+  channel_stats.connection_infos.push_back(other_connection_info);
+  cricket::TransportStats transport_stats;
+  transport_stats.transport_name = "audio";
+  transport_stats.channel_stats.push_back(channel_stats);
+  SessionStats session_stats;
+  session_stats.transport_stats[transport_stats.transport_name] =
+      transport_stats;
+  EXPECT_CALL(session_, GetStats(_)).WillRepeatedly(Invoke(
+      [&session_stats](const ChannelNamePairs&) {
+        return std::unique_ptr<SessionStats>(new SessionStats(session_stats));
+      }));
+
+  StatsReports reports;
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStats(NULL, &reports);
+  EXPECT_TRUE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeCandidatePair, 2));
+  EXPECT_TRUE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeIceLocalCandidate, 2));
+
+  // One connection goes away.
+  session_stats.transport_stats[transport_stats.transport_name]
+      .channel_stats[0]
+      .connection_infos.pop_back();
+  stats.set_time_now(stats.GetTimeNow() + 1000);
+  reports.clear();
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStats(NULL, &reports);
+  EXPECT_TRUE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeCandidatePair, 1));
+  EXPECT_FALSE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeCandidatePair, 2));
+  EXPECT_TRUE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeIceLocalCandidate, 1));
+  EXPECT_FALSE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeIceLocalCandidate, 2));
+  EXPECT_FALSE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeIceRemoteCandidate, 2));
+  EXPECT_EQ("192.168.0.1",
+            ExtractStatsValue(StatsReport::kStatsReportTypeIceLocalCandidate,
+                              reports,
+                              StatsReport::kStatsValueNameCandidateIPAddress));
+  EXPECT_EQ("2000",
+            ExtractStatsValue(StatsReport::kStatsReportTypeIceLocalCandidate,
+                              reports,
+                              StatsReport::kStatsValueNameCandidatePortNumber));
+}
+
 // This test verifies that all chained certificates are correctly
 // reported
 TEST_F(StatsCollectorTest, ChainedCertificateReportsCreated) {
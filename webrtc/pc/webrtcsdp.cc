@@ -13,6 +13,7 @@
 #include <ctype.h>
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <algorithm>
 #include <memory>
@@ -26,6 +27,7 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/messagedigest.h"
+#include "webrtc/rtc_base/string_to_number.h"
 #include "webrtc/rtc_base/stringutils.h"
 // for RtpExtension
 #include "webrtc/config.h"
@@ -442,7 +444,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuses the buffer of |line|, which callers keep across lines.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -474,6 +477,20 @@ static void InitAttrLine(const std::string& attribute, std::ostringstream* os) {
   InitLine(kLineTypeAttributes, attribute, os);
 }
 
+// Appends "a=|attribute|" to |message|, for the lines that are written once per
+// ssrc or feedback parameter: building those in place rather than in an
+// ostringstream each saves most of the serialization time of large
+// descriptions. The line has to be ended with AddLineBreak.
+static void InitAttrLine(const char* attribute, std::string* message) {
+  message->push_back(kLineTypeAttributes);
+  message->push_back(kSdpDelimiterEqual);
+  message->append(attribute);
+}
+
+static void AddLineBreak(std::string* message) {
+  message->append(kLineBreak);
+}
+
 // Writes a SDP attribute line based on |attribute| and |value| to |message|.
 static void AddAttributeLine(const std::string& attribute, int value,
                              std::string* message) {
@@ -511,9 +528,10 @@ static bool GetLineWithType(const std::string& message, size_t* pos,
   return true;
 }
 
-static bool HasAttribute(const std::string& line,
-                         const std::string& attribute) {
-  return (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0);
+// Takes a C string, as attribute lines are matched against dozens of names and
+// constructing a std::string for each of them would dominate the parsing.
+static bool HasAttribute(const std::string& line, const char* attribute) {
+  return (line.compare(kLinePrefixLength, strlen(attribute), attribute) == 0);
 }
 
 static bool AddSsrcLine(uint32_t ssrc_id,
@@ -522,11 +540,15 @@ static bool AddSsrcLine(uint32_t ssrc_id,
                         std::string* message) {
   // RFC 5576
   // a=ssrc:<ssrc-id> <attribute>:<value>
-  std::ostringstream os;
-  InitAttrLine(kAttributeSsrc, &os);
-  os << kSdpDelimiterColon << ssrc_id << kSdpDelimiterSpace
-     << attribute << kSdpDelimiterColon << value;
-  return AddLine(os.str(), message);
+  InitAttrLine(kAttributeSsrc, message);
+  message->push_back(kSdpDelimiterColon);
+  message->append(std::to_string(ssrc_id));
+  message->push_back(kSdpDelimiterSpace);
+  message->append(attribute);
+  message->push_back(kSdpDelimiterColon);
+  message->append(value);
+  AddLineBreak(message);
+  return true;
 }
 
 // Get value only from <attribute>:<value>.
@@ -553,12 +575,26 @@ static bool CaseInsensitiveFind(std::string str1, std::string str2) {
   return str1.find(str2) != std::string::npos;
 }
 
+// Like rtc::FromString, but parses the plain numbers found in practice with
+// rtc::StringToNumber, as the istringstream behind rtc::FromString is costly to
+// construct for every number of a large SDP. rtc::FromString still handles the
+// other inputs it accepts, such as ones with leading whitespace.
+template <class T>
+static bool NumberFromString(const std::string& s, T* t) {
+  rtc::Optional<T> value = rtc::StringToNumber<T>(s);
+  if (value) {
+    *t = *value;
+    return true;
+  }
+  return rtc::FromString(s, t);
+}
+
 template <class T>
 static bool GetValueFromString(const std::string& line,
                                const std::string& s,
                                T* t,
                                SdpParseError* error) {
-  if (!rtc::FromString(s, t)) {
+  if (!NumberFromString(s, t)) {
     std::ostringstream description;
     description << "Invalid value: " << s << ".";
     return ParseFailed(line, description.str(), error);
@@ -1137,10 +1173,10 @@ bool ParseSctpPort(const std::string& line,
   // a=sctp-port
   std::vector<std::string> fields;
   const size_t expected_min_fields = 2;
-  rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterColon, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterColon, &fields);
   if (fields.size() < expected_min_fields) {
     fields.resize(0);
-    rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterSpace, &fields);
+    rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   }
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -1157,8 +1193,7 @@ bool ParseExtmap(const std::string& line,
   // RFC 5285
   // a=extmap:<value>["/"<direction>] <URI> <extensionattributes>
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -1240,7 +1275,7 @@ void BuildMediaDescription(const ContentInfo* content_info,
              video_desc->codecs().begin();
          it != video_desc->codecs().end(); ++it) {
       fmt.append(" ");
-      fmt.append(rtc::ToString<int>(it->id));
+      fmt.append(std::to_string(it->id));
     }
   } else if (media_type == cricket::MEDIA_TYPE_AUDIO) {
     const AudioContentDescription* audio_desc =
@@ -1249,7 +1284,7 @@ void BuildMediaDescription(const ContentInfo* content_info,
              audio_desc->codecs().begin();
          it != audio_desc->codecs().end(); ++it) {
       fmt.append(" ");
-      fmt.append(rtc::ToString<int>(it->id));
+      fmt.append(std::to_string(it->id));
     }
   } else if (media_type == cricket::MEDIA_TYPE_DATA) {
     const DataContentDescription* data_desc =
@@ -1277,7 +1312,7 @@ void BuildMediaDescription(const ContentInfo* content_info,
            data_desc->codecs().begin();
            it != data_desc->codecs().end(); ++it) {
         fmt.append(" ");
-        fmt.append(rtc::ToString<int>(it->id));
+        fmt.append(std::to_string(it->id));
       }
     }
   }
@@ -1547,7 +1582,7 @@ void BuildRtpContentAttributes(const MediaContentDescription* media_desc,
       std::vector<uint32_t>::const_iterator ssrc =
           track->ssrc_groups[i].ssrcs.begin();
       for (; ssrc != track->ssrc_groups[i].ssrcs.end(); ++ssrc) {
-        os << kSdpDelimiterSpace << rtc::ToString<uint32_t>(*ssrc);
+        os << kSdpDelimiterSpace << *ssrc;
       }
       AddLine(os.str(), message);
     }
@@ -1564,11 +1599,8 @@ void BuildRtpContentAttributes(const MediaContentDescription* media_desc,
       // The appdata consists of the "id" attribute of a MediaStreamTrack,
       // which corresponds to the "id" attribute of StreamParams.
       const std::string& stream_id = track->sync_label;
-      InitAttrLine(kAttributeSsrc, &os);
-      os << kSdpDelimiterColon << ssrc << kSdpDelimiterSpace
-         << kSsrcAttributeMsid << kSdpDelimiterColon << stream_id
-         << kSdpDelimiterSpace << track->id;
-      AddLine(os.str(), message);
+      AddSsrcLine(ssrc, kSsrcAttributeMsid,
+                  stream_id + kSdpDelimiterSpace + track->id, message);
 
       // TODO(ronghuawu): Remove below code which is for backward
       // compatibility.
@@ -1666,13 +1698,21 @@ void AddRtcpFbLines(const T& codec, std::string* message) {
   for (std::vector<cricket::FeedbackParam>::const_iterator iter =
            codec.feedback_params.params().begin();
        iter != codec.feedback_params.params().end(); ++iter) {
-    std::ostringstream os;
-    WriteRtcpFbHeader(codec.id, &os);
-    os << " " << iter->id();
+    // a=rtcp-fb:<payload type> <id> [<param>]
+    InitAttrLine(kAttributeRtcpFb, message);
+    message->push_back(kSdpDelimiterColon);
+    if (codec.id == kWildcardPayloadType) {
+      message->push_back('*');
+    } else {
+      message->append(std::to_string(codec.id));
+    }
+    message->push_back(kSdpDelimiterSpace);
+    message->append(iter->id());
     if (!iter->param().empty()) {
-      os << " " << iter->param();
+      message->push_back(kSdpDelimiterSpace);
+      message->append(iter->param());
     }
-    AddLine(os.str(), message);
+    AddLineBreak(message);
   }
 }
 
@@ -1712,7 +1752,7 @@ bool GetParameter(const std::string& name,
   if (found == params.end()) {
     return false;
   }
-  if (!rtc::FromString(found->second, value)) {
+  if (!NumberFromString(found->second, value)) {
     return false;
   }
   return true;
@@ -1845,7 +1885,7 @@ void BuildCandidate(const std::vector<Candidate>& candidates,
        << it->protocol() << " "
        << it->priority() << " "
        << it->address().ipaddr().ToString() << " "
-       << it->address().PortAsString() << " "
+       << it->address().port() << " "
        << kAttributeCandidateTyp << " "
        << type << " ";
 
@@ -1854,7 +1894,7 @@ void BuildCandidate(const std::vector<Candidate>& candidates,
       os << kAttributeCandidateRaddr << " "
          << it->related_address().ipaddr().ToString() << " "
          << kAttributeCandidateRport << " "
-         << it->related_address().PortAsString() << " ";
+         << it->related_address().port() << " ";
     }
 
     if (it->protocol() == cricket::TCP_PROTOCOL_NAME) {
@@ -1976,8 +2016,7 @@ bool ParseSessionDescription(const std::string& message,
                                  std::string(), error);
   }
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_fields = 6;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2119,8 +2158,7 @@ bool ParseGroupAttribute(const std::string& line,
   // RFC 5888 and draft-holmberg-mmusic-sdp-bundle-negotiation-00
   // a=group:BUNDLE video voice
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   std::string semantics;
   if (!GetValue(fields[0], kAttributeGroup, &semantics, error)) {
     return false;
@@ -2143,8 +2181,7 @@ static bool ParseFingerprintAttribute(const std::string& line,
   }
 
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_fields = 2;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2179,7 +2216,7 @@ static bool ParseDtlsSetup(const std::string& line,
   // setup-attr           =  "a=setup:" role
   // role                 =  "active" / "passive" / "actpass" / "holdconn"
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterColon, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterColon, &fields);
   const size_t expected_fields = 2;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2361,8 +2398,7 @@ bool ParseMediaDescription(const std::string& message,
     ++mline_index;
 
     std::vector<std::string> fields;
-    rtc::split(line.substr(kLinePrefixLength),
-                     kSdpDelimiterSpace, &fields);
+    rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
 
     const size_t expected_min_fields = 4;
     if (fields.size() < expected_min_fields) {
@@ -2377,7 +2413,7 @@ bool ParseMediaDescription(const std::string& message,
     }
 
     int port = 0;
-    if (!rtc::FromString<int>(fields[1], &port) || !IsValidPort(port)) {
+    if (!NumberFromString(fields[1], &port) || !IsValidPort(port)) {
       return ParseFailed(line, "The port number is invalid", error);
     }
     std::string protocol = fields[2];
@@ -2581,23 +2617,9 @@ T GetCodecWithPayloadType(const std::vector<T>& codecs, int payload_type) {
 // Updates or creates a new codec entry in the audio description.
 template <class T, class U>
 void AddOrReplaceCodec(MediaContentDescription* content_desc, const U& codec) {
-  T* desc = static_cast<T*>(content_desc);
-  std::vector<U> codecs = desc->codecs();
-  bool found = false;
-
-  typename std::vector<U>::iterator iter;
-  for (iter = codecs.begin(); iter != codecs.end(); ++iter) {
-    if (iter->id == codec.id) {
-      *iter = codec;
-      found = true;
-      break;
-    }
-  }
-  if (!found) {
-    desc->AddCodec(codec);
-    return;
-  }
-  desc->set_codecs(codecs);
+  // Replaces the codec in place; copying the whole list for every rtpmap,
+  // fmtp and rtcp-fb line made parsing quadratic in the number of codecs.
+  static_cast<T*>(content_desc)->AddOrReplaceCodec(codec);
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -3056,8 +3078,7 @@ bool ParseSsrcGroupAttribute(const std::string& line,
   // RFC 5576
   // a=ssrc-group:<semantics> <ssrc-id> ...
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -3082,8 +3103,7 @@ bool ParseCryptoAttribute(const std::string& line,
                           MediaContentDescription* media_desc,
                           SdpParseError* error) {
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   // RFC 4568
   // a=crypto:<tag> <crypto-suite> <key-params> [<session-params>]
   const size_t expected_min_fields = 3;
@@ -3149,8 +3169,7 @@ bool ParseRtpmapAttribute(const std::string& line,
                           MediaContentDescription* media_desc,
                           SdpParseError* error) {
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  rtc::split(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   // RFC 4566
   // a=rtpmap:<payload type> <encoding name>/<clock rate>[/<encodingparameters>]
   const size_t expected_min_fields = 2;
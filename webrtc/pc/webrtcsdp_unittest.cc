@@ -26,6 +26,8 @@
 #include "webrtc/rtc_base/sslfingerprint.h"
 #include "webrtc/rtc_base/stringencode.h"
 #include "webrtc/rtc_base/stringutils.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 #ifdef WEBRTC_ANDROID
 #include "webrtc/pc/test/androidtestinitializer.h"
 #endif
@@ -3583,3 +3585,112 @@ TEST_F(WebRtcSdpTest, SerializeAndDeserializeWithConnectionAddress) {
   EXPECT_EQ(video_desc_->connection_address().ToString(),
             video_desc->connection_address().ToString());
 }
+
+// Builds an offer with |num_sections| audio and video sections of the size
+// browsers produce: a dozen codecs with their rtcp-fb and fmtp lines, header
+// extensions, a few candidates and simulcast ssrcs.
+static std::string MakeLargeSdp(int num_sections) {
+  std::string sdp =
+      "v=0\r\n"
+      "o=- 18446744069414584320 18446462598732840960 IN IP4 127.0.0.1\r\n"
+      "s=-\r\n"
+      "t=0 0\r\n"
+      "a=msid-semantic: WMS local_stream_1\r\n";
+  for (int i = 0; i < num_sections; ++i) {
+    const std::string index = rtc::ToString(i);
+    const bool audio = i % 2 == 0;
+    if (audio) {
+      sdp += "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 104 9 0 8 106 105 13 126\r\n";
+    } else {
+      sdp += "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 102\r\n";
+    }
+    sdp += "c=IN IP4 0.0.0.0\r\n"
+           "a=rtcp:9 IN IP4 0.0.0.0\r\n";
+    for (int j = 0; j < 4; ++j) {
+      const std::string port = rtc::ToString(10000 + i * 4 + j);
+      sdp += "a=candidate:a0+B/" + rtc::ToString(j) + " 1 udp 2130706432 " +
+             "192.168.1." + rtc::ToString(j) + " " + port +
+             " typ host generation 2\r\n";
+    }
+    sdp += "a=ice-ufrag:ufrag_" + index + "\r\n"
+           "a=ice-pwd:pwd_" + index + "\r\n" + kFingerprint +
+           "a=setup:actpass\r\n"
+           "a=mid:mid_" + index + "\r\n"
+           "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+           "a=extmap:2 urn:ietf:params:rtp-hdrext:toffset\r\n"
+           "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+           "abs-send-time\r\n"
+           "a=sendrecv\r\n"
+           "a=rtcp-mux\r\n";
+    if (audio) {
+      sdp += "a=rtpmap:111 opus/48000/2\r\n"
+             "a=rtcp-fb:111 transport-cc\r\n"
+             "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+             "a=rtpmap:103 ISAC/16000\r\n"
+             "a=rtpmap:104 ISAC/32000\r\n"
+             "a=rtpmap:9 G722/8000\r\n"
+             "a=rtpmap:0 PCMU/8000\r\n"
+             "a=rtpmap:8 PCMA/8000\r\n"
+             "a=rtpmap:106 CN/32000\r\n"
+             "a=rtpmap:105 CN/16000\r\n"
+             "a=rtpmap:13 CN/8000\r\n"
+             "a=rtpmap:126 telephone-event/8000\r\n";
+    } else {
+      sdp += "a=rtcp-rsize\r\n";
+      static const char* const kVideoCodecs[] = {"VP8", "VP9", "H264"};
+      for (int j = 0; j < 3; ++j) {
+        const std::string pt = rtc::ToString(96 + 2 * j);
+        const std::string rtx_pt = rtc::ToString(97 + 2 * j);
+        sdp += "a=rtpmap:" + pt + " " + kVideoCodecs[j] + "/90000\r\n"
+               "a=rtcp-fb:" + pt + " goog-remb\r\n"
+               "a=rtcp-fb:" + pt + " transport-cc\r\n"
+               "a=rtcp-fb:" + pt + " ccm fir\r\n"
+               "a=rtcp-fb:" + pt + " nack\r\n"
+               "a=rtcp-fb:" + pt + " nack pli\r\n"
+               "a=rtpmap:" + rtx_pt + " rtx/90000\r\n"
+               "a=fmtp:" + rtx_pt + " apt=" + pt + "\r\n";
+      }
+      sdp += "a=fmtp:100 level-asymmetry-allowed=1;packetization-mode=1;"
+             "profile-level-id=42e01f\r\n"
+             "a=rtpmap:102 red/90000\r\n";
+    }
+    const int num_ssrcs = audio ? 1 : 6;
+    for (int j = 0; j < num_ssrcs; ++j) {
+      const std::string ssrc = rtc::ToString(1000 + i * 10 + j);
+      sdp += "a=ssrc:" + ssrc + " cname:stream_1_cname\r\n"
+             "a=ssrc:" + ssrc + " msid:local_stream_1 track_" + index + "\r\n"
+             "a=ssrc:" + ssrc + " mslabel:local_stream_1\r\n"
+             "a=ssrc:" + ssrc + " label:track_" + index + "\r\n";
+    }
+  }
+  return sdp;
+}
+
+TEST_F(WebRtcSdpTest, DISABLED_SerializeDeserializeLargeSdpPerf) {
+  const int kNumSections = 200;
+  const int kNumIterations = 50;
+  const std::string sdp = MakeLargeSdp(kNumSections);
+
+  int64_t deserialize_us = 0;
+  int64_t serialize_us = 0;
+  size_t serialized_size = 0;
+  for (int i = 0; i < kNumIterations; ++i) {
+    JsepSessionDescription jdesc(kDummyString);
+    int64_t start_us = rtc::TimeMicros();
+    ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+    deserialize_us += rtc::TimeMicros() - start_us;
+
+    start_us = rtc::TimeMicros();
+    std::string message = webrtc::SdpSerialize(jdesc, false);
+    serialize_us += rtc::TimeMicros() - start_us;
+    serialized_size += message.size();
+  }
+
+  webrtc::test::PrintResult(
+      "webrtcsdp", "", "deserialize",
+      static_cast<size_t>(sdp.size() * kNumIterations / deserialize_us),
+      "bytes/us", false);
+  webrtc::test::PrintResult(
+      "webrtcsdp", "", "serialize",
+      static_cast<size_t>(serialized_size / serialize_us), "bytes/us", false);
+}
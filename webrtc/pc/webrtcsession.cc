@@ -515,6 +515,8 @@ WebRtcSession::WebRtcSession(
       this, &WebRtcSession::OnTransportControllerCandidatesRemoved);
   transport_controller_->SignalDtlsHandshakeError.connect(
       this, &WebRtcSession::OnTransportControllerDtlsHandshakeError);
+  transport_controller_->SignalDtlsHandshakeTime.connect(
+      this, &WebRtcSession::OnTransportControllerDtlsHandshakeTime);
 }
 
 WebRtcSession::~WebRtcSession() {
@@ -965,20 +967,24 @@ bool WebRtcSession::PushdownMediaDescription(
     cricket::ContentAction action,
     cricket::ContentSource source,
     std::string* err) {
-  auto set_content = [this, action, source, err](cricket::BaseChannel* ch) {
+  // Set the content of all channels with one hop to the worker thread.
+  cricket::ChannelUpdateBatch batch;
+  for (cricket::BaseChannel* ch :
+       {static_cast<cricket::BaseChannel*>(voice_channel()),
+        static_cast<cricket::BaseChannel*>(video_channel()),
+        static_cast<cricket::BaseChannel*>(rtp_data_channel())}) {
     if (!ch) {
-      return true;
+      continue;
     } else if (source == cricket::CS_LOCAL) {
-      return ch->PushdownLocalDescription(local_description()->description(),
-                                          action, err);
+      batch.PushdownLocalDescription(ch, local_description()->description(),
+                                     action);
     } else {
-      return ch->PushdownRemoteDescription(remote_description()->description(),
-                                           action, err);
+      batch.PushdownRemoteDescription(ch, remote_description()->description(),
+                                      action);
     }
-  };
+  }
 
-  bool ret = (set_content(voice_channel()) && set_content(video_channel()) &&
-              set_content(rtp_data_channel()));
+  bool ret = batch.Apply(err);
   // Need complete offer/answer with an SCTP m= section before starting SCTP,
   // according to https://tools.ietf.org/html/draft-ietf-mmusic-sctp-sdp-19
   if (sctp_transport_ && local_description() && remote_description() &&
@@ -1564,16 +1570,25 @@ void WebRtcSession::OnTransportControllerDtlsHandshakeError(
   }
 }
 
+void WebRtcSession::OnTransportControllerDtlsHandshakeTime(int time_ms) {
+  if (metrics_observer_) {
+    metrics_observer_->AddHistogramSample(webrtc::kDtlsHandshakeTime, time_ms);
+  }
+}
+
 // Enabling voice and video (and RTP data) channel.
 void WebRtcSession::EnableChannels() {
+  cricket::ChannelUpdateBatch batch;
   if (voice_channel_ && !voice_channel_->enabled())
-    voice_channel_->Enable(true);
+    batch.Enable(voice_channel_.get(), true);
 
   if (video_channel_ && !video_channel_->enabled())
-    video_channel_->Enable(true);
+    batch.Enable(video_channel_.get(), true);
 
   if (rtp_data_channel_ && !rtp_data_channel_->enabled())
-    rtp_data_channel_->Enable(true);
+    batch.Enable(rtp_data_channel_.get(), true);
+
+  batch.Apply(nullptr);
 }
 
 // Returns the media index for a local ice candidate given the content name.
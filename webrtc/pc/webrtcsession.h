@@ -531,6 +531,7 @@ class WebRtcSession :
   void OnTransportControllerCandidatesRemoved(
       const std::vector<cricket::Candidate>& candidates);
   void OnTransportControllerDtlsHandshakeError(rtc::SSLHandshakeError error);
+  void OnTransportControllerDtlsHandshakeTime(int time_ms);
 
   std::string GetSessionErrorMsg();
 
@@ -26,4 +26,20 @@ AsyncPacketSocket::AsyncPacketSocket() {
 AsyncPacketSocket::~AsyncPacketSocket() {
 }
 
+int AsyncPacketSocket::SendToBatch(ArrayView<const OutgoingPacket> packets) {
+  int sent = 0;
+  for (const OutgoingPacket& packet : packets) {
+    if (SendTo(packet.data, packet.size, packet.remote_address,
+               packet.options) < 0) {
+      break;
+    }
+    ++sent;
+  }
+  return (sent == 0 && !packets.empty()) ? -1 : sent;
+}
+
+bool AsyncPacketSocket::SetReceiveHeadroom(size_t headroom) {
+  return false;
+}
+
 };  // namespace rtc
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_RTC_BASE_ASYNCPACKETSOCKET_H_
 #define WEBRTC_RTC_BASE_ASYNCPACKETSOCKET_H_
 
+#include "webrtc/rtc_base/array_view.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/dscp.h"
 #include "webrtc/rtc_base/sigslot.h"
@@ -43,6 +44,15 @@ struct PacketOptions {
   PacketTimeUpdateParams packet_time_params;
 };
 
+// A packet to be sent with AsyncPacketSocket::SendToBatch. The payload must
+// stay valid until SendToBatch returns.
+struct OutgoingPacket {
+  const void* data;
+  size_t size;
+  SocketAddress remote_address;
+  PacketOptions options;
+};
+
 // This structure will have the information about when packet is actually
 // received by socket.
 struct PacketTime {
@@ -63,6 +73,15 @@ inline PacketTime CreatePacketTime(int64_t not_before) {
   return PacketTime(TimeMicros(), not_before);
 }
 
+// A single packet delivered through AsyncPacketSocket::SignalReadPacketBatch.
+// |data| is only valid for the duration of the signal.
+struct ReceivedPacket {
+  const char* data;
+  size_t size;
+  SocketAddress remote_address;
+  PacketTime packet_time;
+};
+
 // Provides the ability to receive packets asynchronously. Sends are not
 // buffered since it is acceptable to drop packets under high load.
 class AsyncPacketSocket : public sigslot::has_slots<> {
@@ -89,6 +108,17 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int Send(const void *pv, size_t cb, const PacketOptions& options) = 0;
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr,
                      const PacketOptions& options) = 0;
+  // Sends several packets, coalescing them into as few system calls as the
+  // socket allows. Returns the number of packets sent, or a negative value if
+  // the first packet could not be sent. The default implementation calls
+  // SendTo() for each packet.
+  virtual int SendToBatch(ArrayView<const OutgoingPacket> packets);
+
+  // Reserves |headroom| writable bytes in front of the data of every packet
+  // signaled after this, which the receivers may overwrite to prepend a
+  // header and forward the packet without copying it. Returns false if the
+  // socket can't, which is the default.
+  virtual bool SetReceiveHeadroom(size_t headroom);
 
   // Close the socket.
   virtual int Close() = 0;
@@ -111,6 +141,12 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
                    const SocketAddress&,
                    const PacketTime&> SignalReadPacket;
 
+  // Emitted with all packets read in one go by sockets that receive in
+  // batches (see AsyncUDPSocket::SetRecvBatchSize). When nothing is connected
+  // to this signal, SignalReadPacket is emitted for every packet instead.
+  sigslot::signal2<AsyncPacketSocket*, ArrayView<const ReceivedPacket>>
+      SignalReadPacketBatch;
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
@@ -65,6 +65,9 @@ AsyncTCPSocketBase::AsyncTCPSocketBase(AsyncSocket* socket, bool listen,
   if (!listen_) {
     // Listening sockets don't send/receive data, so they don't need buffers.
     inbuf_.EnsureCapacity(kMinimumRecvSize);
+    // The outgoing data never exceeds |max_outsize_|, so the buffer is never
+    // reallocated.
+    outbuf_.EnsureCapacity(max_outsize_);
   }
 
   RTC_DCHECK(socket_.get() != nullptr);
@@ -142,38 +145,63 @@ int AsyncTCPSocketBase::SendTo(const void *pv, size_t cb,
 }
 
 int AsyncTCPSocketBase::SendRaw(const void * pv, size_t cb) {
-  if (outbuf_.size() + cb > max_outsize_) {
+  if (outbuf_.size() - outpos_ + cb > max_outsize_) {
     socket_->SetError(EMSGSIZE);
     return -1;
   }
 
-  RTC_DCHECK(!listen_);
-  outbuf_.AppendData(static_cast<const uint8_t*>(pv), cb);
+  AppendToOutBuffer(pv, cb);
 
   return FlushOutBuffer();
 }
 
+int AsyncTCPSocketBase::SendDirect(const void* pv, size_t cb) {
+  RTC_DCHECK(IsOutBufferEmpty());
+  RTC_DCHECK(!listen_);
+  int res = socket_->Send(pv, cb);
+  if (res <= 0) {
+    return res;
+  }
+  if (static_cast<size_t>(res) > cb) {
+    RTC_NOTREACHED();
+    return -1;
+  }
+  if (static_cast<size_t>(res) < cb) {
+    AppendToOutBuffer(static_cast<const uint8_t*>(pv) + res, cb - res);
+  }
+  return res;
+}
+
 int AsyncTCPSocketBase::FlushOutBuffer() {
   RTC_DCHECK(!listen_);
-  int res = socket_->Send(outbuf_.data(), outbuf_.size());
+  size_t pending = outbuf_.size() - outpos_;
+  int res = socket_->Send(outbuf_.data() + outpos_, pending);
   if (res <= 0) {
     return res;
   }
-  if (static_cast<size_t>(res) > outbuf_.size()) {
+  if (static_cast<size_t>(res) > pending) {
     RTC_NOTREACHED();
     return -1;
   }
-  size_t new_size = outbuf_.size() - res;
-  if (new_size > 0) {
-    memmove(outbuf_.data(), outbuf_.data() + res, new_size);
+  // What was sent is skipped over rather than moved out, until all of it is.
+  outpos_ += res;
+  if (outpos_ == outbuf_.size()) {
+    ClearOutBuffer();
   }
-  outbuf_.SetSize(new_size);
   return res;
 }
 
 void AsyncTCPSocketBase::AppendToOutBuffer(const void* pv, size_t cb) {
-  RTC_DCHECK(outbuf_.size() + cb <= max_outsize_);
+  RTC_DCHECK(outbuf_.size() - outpos_ + cb <= max_outsize_);
   RTC_DCHECK(!listen_);
+  if (outpos_ > 0 && outbuf_.size() + cb > outbuf_.capacity()) {
+    // Move the data still to be sent to the front, rather than grow the
+    // buffer.
+    size_t pending = outbuf_.size() - outpos_;
+    memmove(outbuf_.data(), outbuf_.data() + outpos_, pending);
+    outbuf_.SetSize(pending);
+    outpos_ = 0;
+  }
   outbuf_.AppendData(static_cast<const uint8_t*>(pv), cb);
 }
 
@@ -245,11 +273,11 @@ void AsyncTCPSocketBase::OnReadEvent(AsyncSocket* socket) {
 void AsyncTCPSocketBase::OnWriteEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
-  if (outbuf_.size() > 0) {
+  if (!IsOutBufferEmpty()) {
     FlushOutBuffer();
   }
 
-  if (outbuf_.size() == 0) {
+  if (IsOutBufferEmpty()) {
     SignalReadyToSend(this);
   }
 }
@@ -57,13 +57,19 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
                                     const SocketAddress& bind_address,
                                     const SocketAddress& remote_address);
   virtual int SendRaw(const void* pv, size_t cb);
+  // Sends |pv| straight from the caller's memory, and adds what the socket
+  // doesn't take to |outbuf_|. Only for when |outbuf_| is empty.
+  int SendDirect(const void* pv, size_t cb);
   int FlushOutBuffer();
   // Add data to |outbuf_|.
   void AppendToOutBuffer(const void* pv, size_t cb);
 
   // Helper methods for |outpos_|.
-  bool IsOutBufferEmpty() const { return outbuf_.size() == 0; }
-  void ClearOutBuffer() { outbuf_.Clear(); }
+  bool IsOutBufferEmpty() const { return outpos_ == outbuf_.size(); }
+  void ClearOutBuffer() {
+    outbuf_.Clear();
+    outpos_ = 0;
+  }
 
  private:
   // Called by the underlying socket
@@ -76,6 +82,8 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   bool listen_;
   Buffer inbuf_;
   Buffer outbuf_;
+  // The data in |outbuf_| before |outpos_| has been sent.
+  size_t outpos_ = 0;
   size_t max_insize_;
   size_t max_outsize_;
 
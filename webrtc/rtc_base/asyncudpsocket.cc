@@ -9,6 +9,9 @@
  */
 
 #include "webrtc/rtc_base/asyncudpsocket.h"
+
+#include <algorithm>
+
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 
@@ -16,6 +19,8 @@ namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
 
+const size_t AsyncUDPSocket::kMaxBatchedPacketSize;
+
 AsyncUDPSocket* AsyncUDPSocket::Create(
     AsyncSocket* socket,
     const SocketAddress& bind_address) {
@@ -75,6 +80,37 @@ int AsyncUDPSocket::SendTo(const void *pv, size_t cb,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(ArrayView<const OutgoingPacket> packets) {
+  send_batch_.resize(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    send_batch_[i].data = static_cast<const char*>(packets[i].data);
+    send_batch_[i].length = packets[i].size;
+    send_batch_[i].address = packets[i].remote_address;
+  }
+  int64_t send_time_ms = rtc::TimeMillis();
+  int ret = socket_->SendToBatch(send_batch_.data(), send_batch_.size());
+  // Like SendTo(), report every packet that was handed to the socket, and the
+  // first one even if it failed.
+  size_t reported = ret > 0 ? static_cast<size_t>(ret)
+                            : std::min<size_t>(1, packets.size());
+  for (size_t i = 0; i < reported; ++i) {
+    SignalSentPacket(this, rtc::SentPacket(packets[i].options.packet_id,
+                                           send_time_ms));
+  }
+  return ret;
+}
+
+bool AsyncUDPSocket::SetReceiveHeadroom(size_t headroom) {
+  delete [] buf_;
+  buf_ = new char[headroom + size_];
+  headroom_ = headroom;
+  if (recv_batch_size_ > 1) {
+    // Lay the slots out again.
+    SetRecvBatchSize(recv_batch_size_);
+  }
+  return true;
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -99,12 +135,37 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+void AsyncUDPSocket::SetRecvBatchSize(size_t batch_size) {
+  RTC_DCHECK_GT(batch_size, 0);
+  recv_batch_size_ = batch_size;
+  if (recv_batch_size_ == 1) {
+    batch_buf_.clear();
+    batch_slots_.clear();
+    batch_packets_.clear();
+    return;
+  }
+  const size_t slot_size = headroom_ + kMaxBatchedPacketSize;
+  batch_buf_.resize(recv_batch_size_ * slot_size);
+  batch_slots_.resize(recv_batch_size_);
+  for (size_t i = 0; i < recv_batch_size_; ++i) {
+    batch_slots_[i].data = &batch_buf_[i * slot_size + headroom_];
+    batch_slots_[i].capacity = kMaxBatchedPacketSize;
+  }
+  batch_packets_.reserve(recv_batch_size_);
+}
+
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
+  if (recv_batch_size_ > 1) {
+    ReadBatch();
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
-  int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
+  char* data = buf_ + headroom_;
+  int len = socket_->RecvFrom(data, size_, &remote_addr, &timestamp);
   if (len < 0) {
     // An error here typically means we got an ICMP error in response to our
     // send datagram, indicating the remote address was unreachable.
@@ -119,10 +180,46 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   // TODO: Make sure that we got all of the packet.
   // If we did not, then we should resize our buffer to be large enough.
   SignalReadPacket(
-      this, buf_, static_cast<size_t>(len), remote_addr,
+      this, data, static_cast<size_t>(len), remote_addr,
       (timestamp > -1 ? PacketTime(timestamp, 0) : CreatePacketTime(0)));
 }
 
+void AsyncUDPSocket::ReadBatch() {
+  int count = socket_->RecvFromBatch(batch_slots_.data(), batch_slots_.size());
+  if (count < 0) {
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString() << "] "
+                 << "batched receive failed with error "
+                 << socket_->GetError();
+    return;
+  }
+
+  batch_packets_.clear();
+  for (int i = 0; i < count; ++i) {
+    const DatagramBuffer& slot = batch_slots_[i];
+    if (slot.length > slot.capacity) {
+      LOG(LS_WARNING) << "Dropping " << slot.length << " byte datagram from "
+                      << slot.address.ToSensitiveString()
+                      << ", larger than the batched receive slot.";
+      continue;
+    }
+    batch_packets_.push_back(
+        {slot.data, slot.length, slot.address,
+         slot.timestamp > -1 ? PacketTime(slot.timestamp, 0)
+                             : CreatePacketTime(0)});
+  }
+
+  if (!SignalReadPacketBatch.is_empty()) {
+    if (!batch_packets_.empty())
+      SignalReadPacketBatch(this, batch_packets_);
+    return;
+  }
+  for (const ReceivedPacket& packet : batch_packets_) {
+    SignalReadPacket(this, packet.data, packet.size, packet.remote_address,
+                     packet.packet_time);
+  }
+}
+
 void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
   SignalReadyToSend(this);
 }
@@ -12,6 +12,7 @@
 #define WEBRTC_RTC_BASE_ASYNCUDPSOCKET_H_
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/rtc_base/asyncpacketsocket.h"
 #include "webrtc/rtc_base/socketfactory.h"
@@ -43,6 +44,10 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  // Hands the whole batch to the underlying socket, so that it can be sent
+  // with sendmmsg() or UDP segmentation offload where available.
+  int SendToBatch(ArrayView<const OutgoingPacket> packets) override;
+  bool SetReceiveHeadroom(size_t headroom) override;
   int Close() override;
 
   State GetState() const override;
@@ -51,15 +56,33 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int GetError() const override;
   void SetError(int error) override;
 
+  // Drains up to |batch_size| datagrams for each read event, using a single
+  // system call where the underlying socket supports it. The default of 1
+  // reads one datagram per event. In batched mode each datagram is limited to
+  // kMaxBatchedPacketSize bytes; larger datagrams are dropped.
+  void SetRecvBatchSize(size_t batch_size);
+  size_t recv_batch_size() const { return recv_batch_size_; }
+
+  static const size_t kMaxBatchedPacketSize = 2048;
+
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
+  void ReadBatch();
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
 
   std::unique_ptr<AsyncSocket> socket_;
+  // |size_| bytes are received after the first |headroom_| of |buf_|.
   char* buf_;
   size_t size_;
+  size_t headroom_ = 0;
+
+  size_t recv_batch_size_ = 1;
+  std::vector<char> batch_buf_;
+  std::vector<DatagramBuffer> batch_slots_;
+  std::vector<ReceivedPacket> batch_packets_;
+  std::vector<OutgoingDatagram> send_batch_;
 };
 
 }  // namespace rtc
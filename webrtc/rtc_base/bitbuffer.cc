@@ -59,6 +59,21 @@ uint8_t WritePartialByte(uint8_t source,
   return (target & ~mask) | (source >> target_bit_offset);
 }
 
+// Returns the number of leading zero bits in |val|, which must be non-zero.
+size_t CountLeadingZeros32(uint32_t val) {
+  RTC_DCHECK_NE(val, 0);
+#if defined(__GNUC__)
+  return __builtin_clz(val);
+#else
+  size_t zero_bit_count = 0;
+  while ((val & 0x80000000u) == 0) {
+    zero_bit_count++;
+    val <<= 1;
+  }
+  return zero_bit_count;
+#endif
+}
+
 // Counts the number of bits used in the binary representation of val.
 size_t CountBits(uint64_t val) {
   size_t bit_count = 0;
@@ -164,22 +179,24 @@ bool BitBuffer::ReadExponentialGolomb(uint32_t* val) {
   size_t original_byte_offset = byte_offset_;
   size_t original_bit_offset = bit_offset_;
 
-  // Count the number of leading 0 bits by peeking/consuming them one at a time.
-  size_t zero_bit_count = 0;
-  uint32_t peeked_bit;
-  while (PeekBits(&peeked_bit, 1) && peeked_bit == 0) {
-    zero_bit_count++;
-    ConsumeBits(1);
+  // Count the number of leading 0 bits. A value that fits in a uint32_t has at
+  // most 31 of them, so a single peek of up to 32 bits either finds the first
+  // 1 bit or tells us the value is too large.
+  size_t peek_bit_count =
+      static_cast<size_t>(std::min<uint64_t>(32, RemainingBitCount()));
+  uint32_t peeked_bits;
+  if (peek_bit_count == 0 || !PeekBits(&peeked_bits, peek_bit_count) ||
+      peeked_bits == 0) {
+    return false;
   }
+  size_t zero_bit_count =
+      CountLeadingZeros32(peeked_bits) - (32 - peek_bit_count);
+  RTC_CHECK(ConsumeBits(zero_bit_count));
 
-  // We should either be at the end of the stream, or the next bit should be 1.
-  RTC_DCHECK(!PeekBits(&peeked_bit, 1) || peeked_bit == 1);
-
-  // The bit count of the value is the number of zeros + 1. Make sure that many
-  // bits fits in a uint32_t and that we have enough bits left for it, and then
-  // read the value.
+  // The bit count of the value is the number of zeros + 1. Make sure we have
+  // enough bits left for it, and then read the value.
   size_t value_bit_count = zero_bit_count + 1;
-  if (value_bit_count > 32 || !ReadBits(val, value_bit_count)) {
+  if (!ReadBits(val, value_bit_count)) {
     RTC_CHECK(Seek(original_byte_offset, original_bit_offset));
     return false;
   }
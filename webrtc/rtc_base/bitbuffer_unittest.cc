@@ -243,6 +243,27 @@ TEST(BitBufferTest, NoGolombOverread) {
   EXPECT_EQ(0x01FEu, decoded_val);
 }
 
+TEST(BitBufferTest, GolombValuesWithLeadingZerosAcrossWords) {
+  // 31 zero bits followed by 32 bits of value, at a 3 bit offset: the largest
+  // value that fits in a uint32_t.
+  const uint8_t bytes[] = {0xE0, 0x00, 0x00, 0x00, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF};
+  BitBuffer buffer(bytes, sizeof(bytes));
+  ASSERT_TRUE(buffer.ConsumeBits(3));
+  uint32_t decoded_val;
+  ASSERT_TRUE(buffer.ReadExponentialGolomb(&decoded_val));
+  EXPECT_EQ(0xFFFFFFFEu, decoded_val);
+  EXPECT_EQ(6u, buffer.RemainingBitCount());
+}
+
+TEST(BitBufferTest, GolombValueTooLargeIsNotConsumed) {
+  // 32 zero bits can only start a value that doesn't fit in a uint32_t.
+  const uint8_t bytes[] = {0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  BitBuffer buffer(bytes, sizeof(bytes));
+  uint32_t decoded_val;
+  EXPECT_FALSE(buffer.ReadExponentialGolomb(&decoded_val));
+  EXPECT_EQ(sizeof(bytes) * 8, buffer.RemainingBitCount());
+}
+
 TEST(BitBufferWriterTest, SymmetricReadWrite) {
   uint8_t bytes[16] = {0};
   BitBufferWriter buffer(bytes, 4);
@@ -36,6 +36,12 @@ CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size, size_t capacity)
   RTC_DCHECK(IsConsistent());
 }
 
+CopyOnWriteBuffer::CopyOnWriteBuffer(
+    scoped_refptr<RefCountedObject<Buffer>> buffer)
+    : buffer_(std::move(buffer)) {
+  RTC_DCHECK(IsConsistent());
+}
+
 CopyOnWriteBuffer::~CopyOnWriteBuffer() = default;
 
 bool CopyOnWriteBuffer::operator==(const CopyOnWriteBuffer& buf) const {
@@ -21,6 +21,8 @@
 
 namespace rtc {
 
+class CopyOnWriteBufferPool;
+
 class CopyOnWriteBuffer {
  public:
   // An empty buffer.
@@ -223,6 +225,11 @@ class CopyOnWriteBuffer {
   }
 
  private:
+  friend class CopyOnWriteBufferPool;
+
+  // Wraps storage handed out by CopyOnWriteBufferPool.
+  explicit CopyOnWriteBuffer(scoped_refptr<RefCountedObject<Buffer>> buffer);
+
   // Create a copy of the underlying data if it is referenced from other Buffer
   // objects.
   void CloneDataIfReferenced(size_t new_capacity);
@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/copyonwritebufferpool.h"
+
+#include <cstring>
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/refcount.h"
+
+namespace rtc {
+
+// Holds the unused storage. It is reference counted since storage that is in
+// use when the pool goes away still needs somewhere to return to.
+class CopyOnWriteBufferPool::FreeList {
+ public:
+  explicit FreeList(size_t max_free_buffers)
+      : max_free_buffers_(max_free_buffers) {}
+
+  virtual int AddRef() const = 0;
+  virtual int Release() const = 0;
+
+  // Returns unused storage, or null if there is none.
+  PooledStorage* Take();
+  // Takes ownership of |storage|, which has no references left.
+  void Recycle(PooledStorage* storage);
+  // Frees all unused storage; storage recycled after this is freed directly.
+  void Shutdown();
+
+  size_t size() const {
+    CritScope lock(&crit_);
+    return free_.size();
+  }
+
+ protected:
+  virtual ~FreeList() { RTC_DCHECK(free_.empty()); }
+
+ private:
+  const size_t max_free_buffers_;
+  CriticalSection crit_;
+  bool shut_down_ GUARDED_BY(crit_) = false;
+  std::vector<PooledStorage*> free_ GUARDED_BY(crit_);
+};
+
+// Buffer storage that goes back to its free list instead of being deleted
+// when the last reference is released.
+class CopyOnWriteBufferPool::PooledStorage : public RefCountedObject<Buffer> {
+ public:
+  PooledStorage(size_t capacity, const scoped_refptr<FreeList>& free_list)
+      : RefCountedObject<Buffer>(0, capacity), free_list_(free_list) {}
+
+  int Release() const override {
+    int count = AtomicOps::Decrement(&ref_count_);
+    if (!count) {
+      free_list_->Recycle(const_cast<PooledStorage*>(this));
+    }
+    return count;
+  }
+
+  void Destroy() { delete this; }
+
+ private:
+  ~PooledStorage() override {}
+
+  const scoped_refptr<FreeList> free_list_;
+};
+
+CopyOnWriteBufferPool::PooledStorage* CopyOnWriteBufferPool::FreeList::Take() {
+  CritScope lock(&crit_);
+  if (free_.empty())
+    return nullptr;
+  PooledStorage* storage = free_.back();
+  free_.pop_back();
+  return storage;
+}
+
+void CopyOnWriteBufferPool::FreeList::Recycle(PooledStorage* storage) {
+  {
+    CritScope lock(&crit_);
+    if (!shut_down_ && free_.size() < max_free_buffers_) {
+      storage->Clear();
+      free_.push_back(storage);
+      return;
+    }
+  }
+  // Destroying the storage may release the last reference to this list, so
+  // it must happen outside the lock.
+  storage->Destroy();
+}
+
+void CopyOnWriteBufferPool::FreeList::Shutdown() {
+  std::vector<PooledStorage*> to_destroy;
+  {
+    CritScope lock(&crit_);
+    shut_down_ = true;
+    to_destroy.swap(free_);
+  }
+  for (PooledStorage* storage : to_destroy)
+    storage->Destroy();
+}
+
+CopyOnWriteBufferPool::CopyOnWriteBufferPool(size_t buffer_capacity,
+                                             size_t max_free_buffers)
+    : buffer_capacity_(buffer_capacity),
+      free_list_(new RefCountedObject<FreeList>(max_free_buffers)) {
+  RTC_DCHECK_GT(buffer_capacity_, 0);
+}
+
+CopyOnWriteBufferPool::~CopyOnWriteBufferPool() {
+  free_list_->Shutdown();
+}
+
+CopyOnWriteBuffer CopyOnWriteBufferPool::CreateBuffer(size_t size) {
+  if (size > buffer_capacity_)
+    return CopyOnWriteBuffer(size);
+  PooledStorage* storage = free_list_->Take();
+  if (!storage)
+    storage = new PooledStorage(buffer_capacity_, free_list_);
+  storage->SetSize(size);
+  return CopyOnWriteBuffer(scoped_refptr<RefCountedObject<Buffer>>(storage));
+}
+
+CopyOnWriteBuffer CopyOnWriteBufferPool::CreateBuffer(const uint8_t* data,
+                                                      size_t size) {
+  CopyOnWriteBuffer buffer = CreateBuffer(size);
+  if (size > 0)
+    std::memcpy(buffer.data(), data, size);
+  return buffer;
+}
+
+size_t CopyOnWriteBufferPool::num_free_buffers() const {
+  return free_list_->size();
+}
+
+}  // namespace rtc
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_BASE_COPYONWRITEBUFFERPOOL_H_
+#define WEBRTC_RTC_BASE_COPYONWRITEBUFFERPOOL_H_
+
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/copyonwritebuffer.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/scoped_ref_ptr.h"
+
+namespace rtc {
+
+// Recycles the storage backing CopyOnWriteBuffers, so that a steady stream of
+// similarly sized packets doesn't hit the allocator for every packet. Buffers
+// returned by CreateBuffer behave like any other CopyOnWriteBuffer; when the
+// last reference to the storage goes away, on any thread, the storage goes
+// back to the pool instead of being freed. Storage cloned by copy-on-write is
+// not pooled.
+//
+// The pool may be destroyed while buffers are still in use; their storage is
+// then freed when released.
+class CopyOnWriteBufferPool {
+ public:
+  // Pooled storage has at least |buffer_capacity| bytes. At most
+  // |max_free_buffers| unused buffers are kept around.
+  CopyOnWriteBufferPool(size_t buffer_capacity, size_t max_free_buffers);
+  ~CopyOnWriteBufferPool();
+
+  // Returns a buffer with |size| uninitialized bytes. Requests larger than
+  // the pool's buffer capacity are served by a regular allocation.
+  CopyOnWriteBuffer CreateBuffer(size_t size);
+  // Returns a buffer holding a copy of |data|.
+  CopyOnWriteBuffer CreateBuffer(const uint8_t* data, size_t size);
+
+  size_t buffer_capacity() const { return buffer_capacity_; }
+  // Number of unused buffers currently held by the pool.
+  size_t num_free_buffers() const;
+
+ private:
+  class FreeList;
+  class PooledStorage;
+
+  const size_t buffer_capacity_;
+  const scoped_refptr<FreeList> free_list_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CopyOnWriteBufferPool);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_RTC_BASE_COPYONWRITEBUFFERPOOL_H_
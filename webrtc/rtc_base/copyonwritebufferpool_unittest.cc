@@ -0,0 +1,108 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "webrtc/rtc_base/copyonwritebufferpool.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/platform_thread.h"
+
+namespace rtc {
+
+namespace {
+
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7};
+
+}  // namespace
+
+TEST(CopyOnWriteBufferPoolTest, ReusesReleasedStorage) {
+  CopyOnWriteBufferPool pool(1500, 4);
+  const uint8_t* first_data;
+  {
+    CopyOnWriteBuffer buffer = pool.CreateBuffer(kTestData, sizeof(kTestData));
+    EXPECT_EQ(sizeof(kTestData), buffer.size());
+    EXPECT_EQ(1500u, buffer.capacity());
+    EXPECT_EQ(0, memcmp(kTestData, buffer.cdata(), sizeof(kTestData)));
+    first_data = buffer.cdata();
+    EXPECT_EQ(0u, pool.num_free_buffers());
+  }
+  EXPECT_EQ(1u, pool.num_free_buffers());
+
+  CopyOnWriteBuffer buffer = pool.CreateBuffer(100);
+  EXPECT_EQ(first_data, buffer.cdata());
+  EXPECT_EQ(100u, buffer.size());
+  EXPECT_EQ(0u, pool.num_free_buffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, SharedStorageReturnsOnLastRelease) {
+  CopyOnWriteBufferPool pool(1500, 4);
+  CopyOnWriteBuffer buffer = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  std::unique_ptr<CopyOnWriteBuffer> copy(new CopyOnWriteBuffer(buffer));
+  EXPECT_EQ(buffer.cdata(), copy->cdata());
+
+  buffer = CopyOnWriteBuffer();
+  EXPECT_EQ(0u, pool.num_free_buffers());
+  copy.reset();
+  EXPECT_EQ(1u, pool.num_free_buffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, WritingToUnsharedBufferDoesNotCopy) {
+  CopyOnWriteBufferPool pool(1500, 4);
+  CopyOnWriteBuffer buffer = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  const uint8_t* data = buffer.cdata();
+  buffer.data()[0] = 0xff;
+  EXPECT_EQ(data, buffer.cdata());
+}
+
+TEST(CopyOnWriteBufferPoolTest, LimitsNumberOfFreeBuffers) {
+  CopyOnWriteBufferPool pool(1500, 2);
+  {
+    CopyOnWriteBuffer buffer1 = pool.CreateBuffer(10);
+    CopyOnWriteBuffer buffer2 = pool.CreateBuffer(10);
+    CopyOnWriteBuffer buffer3 = pool.CreateBuffer(10);
+  }
+  EXPECT_EQ(2u, pool.num_free_buffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, LargeBuffersAreNotPooled) {
+  CopyOnWriteBufferPool pool(1500, 2);
+  {
+    CopyOnWriteBuffer buffer = pool.CreateBuffer(2000);
+    EXPECT_EQ(2000u, buffer.size());
+  }
+  EXPECT_EQ(0u, pool.num_free_buffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, BufferOutlivesPool) {
+  std::unique_ptr<CopyOnWriteBufferPool> pool(
+      new CopyOnWriteBufferPool(1500, 2));
+  CopyOnWriteBuffer buffer = pool->CreateBuffer(kTestData, sizeof(kTestData));
+  pool.reset();
+  EXPECT_EQ(0, memcmp(kTestData, buffer.cdata(), sizeof(kTestData)));
+  // Releasing the buffer after the pool is gone frees the storage.
+  buffer = CopyOnWriteBuffer();
+}
+
+TEST(CopyOnWriteBufferPoolTest, ReleaseOnOtherThread) {
+  CopyOnWriteBufferPool pool(1500, 4);
+  CopyOnWriteBuffer* buffer =
+      new CopyOnWriteBuffer(pool.CreateBuffer(kTestData, sizeof(kTestData)));
+  PlatformThread thread(
+      [](void* obj) {
+        delete static_cast<CopyOnWriteBuffer*>(obj);
+        return false;
+      },
+      buffer, "ReleaseThread");
+  thread.Start();
+  thread.Stop();
+  EXPECT_EQ(1u, pool.num_free_buffers());
+}
+
+}  // namespace rtc
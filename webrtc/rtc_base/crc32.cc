@@ -10,6 +10,21 @@
 
 #include "webrtc/rtc_base/crc32.h"
 
+#include <string.h>
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(RTC_CRC32_HAS_ARMV8_KERNEL)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 #include "webrtc/rtc_base/arraysize.h"
 
 namespace rtc {
@@ -19,12 +34,15 @@ namespace rtc {
 // CRC32 polynomial, in reversed form.
 // See RFC 1952, or http://en.wikipedia.org/wiki/Cyclic_redundancy_check
 static const uint32_t kCrc32Polynomial = 0xEDB88320;
-static uint32_t kCrc32Table[256] = {0};
+// kCrc32Table[0] is the table of RFC 1952. kCrc32Table[k][i] is the CRC
+// register after byte i is followed by k zero bytes, which updates the
+// register for eight bytes at once (the "slicing-by-8" method).
+static uint32_t kCrc32Table[8][256] = {{0}};
 
 static void EnsureCrc32TableInited() {
-  if (kCrc32Table[arraysize(kCrc32Table) - 1])
+  if (kCrc32Table[7][arraysize(kCrc32Table[7]) - 1])
     return;  // already inited
-  for (uint32_t i = 0; i < arraysize(kCrc32Table); ++i) {
+  for (uint32_t i = 0; i < arraysize(kCrc32Table[0]); ++i) {
     uint32_t c = i;
     for (size_t j = 0; j < 8; ++j) {
       if (c & 1) {
@@ -33,20 +51,104 @@ static void EnsureCrc32TableInited() {
         c >>= 1;
       }
     }
-    kCrc32Table[i] = c;
+    kCrc32Table[0][i] = c;
+  }
+  for (size_t k = 1; k < arraysize(kCrc32Table); ++k) {
+    for (uint32_t i = 0; i < arraysize(kCrc32Table[k]); ++i) {
+      uint32_t c = kCrc32Table[k - 1][i];
+      kCrc32Table[k][i] = kCrc32Table[0][c & 0xFF] ^ (c >> 8);
+    }
   }
 }
 
-uint32_t UpdateCrc32(uint32_t start, const void* buf, size_t len) {
+namespace internal {
+
+uint32_t UpdateCrc32_C(uint32_t crc, const uint8_t* buf, size_t len) {
   EnsureCrc32TableInited();
+#if defined(WEBRTC_ARCH_LITTLE_ENDIAN)
+  for (; len >= 8; buf += 8, len -= 8) {
+    uint32_t lo;
+    uint32_t hi;
+    memcpy(&lo, buf, sizeof(lo));
+    memcpy(&hi, buf + 4, sizeof(hi));
+    lo ^= crc;
+    crc = kCrc32Table[7][lo & 0xFF] ^ kCrc32Table[6][(lo >> 8) & 0xFF] ^
+          kCrc32Table[5][(lo >> 16) & 0xFF] ^ kCrc32Table[4][lo >> 24] ^
+          kCrc32Table[3][hi & 0xFF] ^ kCrc32Table[2][(hi >> 8) & 0xFF] ^
+          kCrc32Table[1][(hi >> 16) & 0xFF] ^ kCrc32Table[0][hi >> 24];
+  }
+#endif
+  for (; len > 0; ++buf, --len) {
+    crc = kCrc32Table[0][(crc ^ *buf) & 0xFF] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+bool CpuSupportsCrc32PCLMUL() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // CPUID leaf 1 reports PCLMULQDQ in bit 1 of ECX, and SSE4.1 in bit 19.
+  unsigned int ecx;
+#if defined(_MSC_VER)
+  int cpu_info[4];
+  __cpuid(cpu_info, 1);
+  ecx = static_cast<unsigned int>(cpu_info[2]);
+#else
+  unsigned int eax, ebx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+#endif
+  return (ecx & (1 << 1)) && (ecx & (1 << 19));
+#else
+  return false;
+#endif
+}
 
-  uint32_t c = start ^ 0xFFFFFFFF;
-  const uint8_t* u = static_cast<const uint8_t*>(buf);
-  for (size_t i = 0; i < len; ++i) {
-    c = kCrc32Table[(c ^ u[i]) & 0xFF] ^ (c >> 8);
+bool CpuSupportsCrc32ARMv8() {
+#if defined(RTC_CRC32_HAS_ARMV8_KERNEL)
+  return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace internal
+
+namespace {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The PCLMULQDQ kernel only folds whole 16-byte blocks, and isn't worth
+// setting up for less than 64 bytes; the C kernel does the rest.
+uint32_t UpdateCrc32_PCLMULAndC(uint32_t crc, const uint8_t* buf, size_t len) {
+  if (len >= 64) {
+    size_t folded_len = len & ~static_cast<size_t>(15);
+    crc = internal::UpdateCrc32_PCLMUL(crc, buf, folded_len);
+    buf += folded_len;
+    len -= folded_len;
+  }
+  return internal::UpdateCrc32_C(crc, buf, len);
+}
+#endif
+
+}  // namespace
+
+uint32_t UpdateCrc32(uint32_t start, const void* buf, size_t len) {
+  static uint32_t (*crc_proc)(uint32_t, const uint8_t*, size_t) = nullptr;
+
+  if (!crc_proc) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    crc_proc = internal::CpuSupportsCrc32PCLMUL() ? &UpdateCrc32_PCLMULAndC
+                                                  : &internal::UpdateCrc32_C;
+#elif defined(RTC_CRC32_HAS_ARMV8_KERNEL)
+    crc_proc = internal::CpuSupportsCrc32ARMv8() ? &internal::UpdateCrc32_ARMv8
+                                                 : &internal::UpdateCrc32_C;
+#else
+    crc_proc = &internal::UpdateCrc32_C;
+#endif
   }
+
+  uint32_t c = crc_proc(start ^ 0xFFFFFFFF, static_cast<const uint8_t*>(buf),
+                        len);
   return c ^ 0xFFFFFFFF;
 }
 
 }  // namespace rtc
-
@@ -14,6 +14,12 @@
 #include <string>
 
 #include "webrtc/rtc_base/basictypes.h"
+#include "webrtc/typedefs.h"
+
+// ARMv8 CPU features are only detected on Linux and Android.
+#if defined(__aarch64__) && defined(WEBRTC_LINUX)
+#define RTC_CRC32_HAS_ARMV8_KERNEL
+#endif
 
 namespace rtc {
 
@@ -29,6 +35,25 @@ inline uint32_t ComputeCrc32(const std::string& str) {
   return ComputeCrc32(str.c_str(), str.size());
 }
 
+namespace internal {
+
+// The kernels UpdateCrc32() dispatches to, exposed for testing. They update
+// the CRC register |crc|, which is the checksum XORed with 0xFFFFFFFF. Only
+// the ones built for the target architecture are defined.
+uint32_t UpdateCrc32_C(uint32_t crc, const uint8_t* buf, size_t len);
+// x86 with PCLMULQDQ and SSE4.1. |len| must be a multiple of 16, and at least
+// 64.
+uint32_t UpdateCrc32_PCLMUL(uint32_t crc, const uint8_t* buf, size_t len);
+// ARMv8 with the CRC32 extension.
+uint32_t UpdateCrc32_ARMv8(uint32_t crc, const uint8_t* buf, size_t len);
+
+// Whether the CPU supports the kernels above. Always false for the ones that
+// aren't built.
+bool CpuSupportsCrc32PCLMUL();
+bool CpuSupportsCrc32ARMv8();
+
+}  // namespace internal
+
 }  // namespace rtc
 
 #endif  // WEBRTC_RTC_BASE_CRC32_H_
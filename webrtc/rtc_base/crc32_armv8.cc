@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/crc32.h"
+
+#include <arm_acle.h>
+#include <string.h>
+
+namespace rtc {
+namespace internal {
+
+// The CRC32 (not CRC32C) instructions use the polynomial of RFC 1952 and
+// update the reflected register directly, so no table or folding is needed.
+uint32_t UpdateCrc32_ARMv8(uint32_t crc, const uint8_t* buf, size_t len) {
+  for (; len >= 8; buf += 8, len -= 8) {
+    uint64_t data;
+    memcpy(&data, buf, sizeof(data));
+    crc = __crc32d(crc, data);
+  }
+  if (len >= 4) {
+    uint32_t data;
+    memcpy(&data, buf, sizeof(data));
+    crc = __crc32w(crc, data);
+    buf += 4;
+    len -= 4;
+  }
+  for (; len > 0; ++buf, --len) {
+    crc = __crc32b(crc, *buf);
+  }
+  return crc;
+}
+
+}  // namespace internal
+}  // namespace rtc
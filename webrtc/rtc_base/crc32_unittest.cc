@@ -12,9 +12,37 @@
 #include "webrtc/rtc_base/gunit.h"
 
 #include <string>
+#include <vector>
+
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace rtc {
 
+namespace {
+
+// The checksum of |len| bytes of |buf|, one byte at a time as in RFC 1952.
+uint32_t ReferenceCrc32(const uint8_t* buf, size_t len) {
+  uint32_t c = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; ++i) {
+    c ^= buf[i];
+    for (int j = 0; j < 8; ++j)
+      c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+  }
+  return c ^ 0xFFFFFFFF;
+}
+
+std::vector<uint8_t> RandomBytes(size_t len) {
+  webrtc::Random random(0x1234);
+  std::vector<uint8_t> bytes(len);
+  for (uint8_t& byte : bytes)
+    byte = random.Rand<uint8_t>();
+  return bytes;
+}
+
+}  // namespace
+
 TEST(Crc32Test, TestBasic) {
   EXPECT_EQ(0U, ComputeCrc32(""));
   EXPECT_EQ(0x352441C2U, ComputeCrc32("abc"));
@@ -32,4 +60,84 @@ TEST(Crc32Test, TestMultipleUpdates) {
   EXPECT_EQ(0x171A3F5FU, c);
 }
 
+// Checks every length and alignment around the 8 byte steps of the C kernel
+// and the 16 and 64 byte blocks of the PCLMULQDQ one.
+TEST(Crc32Test, TestAllLengthsAndAlignments) {
+  std::vector<uint8_t> input = RandomBytes(300);
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t len = 0; offset + len <= input.size(); ++len) {
+      EXPECT_EQ(ReferenceCrc32(&input[offset], len),
+                ComputeCrc32(&input[offset], len))
+          << "offset " << offset << ", length " << len;
+    }
+  }
+}
+
+TEST(Crc32Test, TestKernels) {
+  std::vector<uint8_t> input = RandomBytes(1024);
+  for (size_t len = 0; len <= input.size(); ++len) {
+    uint32_t expected = ReferenceCrc32(input.data(), len) ^ 0xFFFFFFFF;
+    EXPECT_EQ(expected,
+              internal::UpdateCrc32_C(0xFFFFFFFF, input.data(), len));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (internal::CpuSupportsCrc32PCLMUL() && len >= 64 && len % 16 == 0) {
+      EXPECT_EQ(expected,
+                internal::UpdateCrc32_PCLMUL(0xFFFFFFFF, input.data(), len));
+    }
+#endif
+#if defined(RTC_CRC32_HAS_ARMV8_KERNEL)
+    if (internal::CpuSupportsCrc32ARMv8()) {
+      EXPECT_EQ(expected,
+                internal::UpdateCrc32_ARMv8(0xFFFFFFFF, input.data(), len));
+    }
+#endif
+  }
+}
+
+// Reports the throughput of each kernel for the sizes of common STUN
+// messages: a binding request, a request with MESSAGE-INTEGRITY and ICE
+// attributes, and TURN Send and Data indications of audio and video.
+TEST(Crc32Test, DISABLED_Crc32Perf) {
+  const int kNumIterations = 200000;
+  std::vector<uint8_t> input = RandomBytes(1200);
+  struct Kernel {
+    const char* name;
+    uint32_t (*update)(uint32_t, const uint8_t*, size_t);
+    size_t min_len;
+  };
+  // UpdateCrc32() itself, with whichever kernel it picked.
+  auto update_crc32 = [](uint32_t crc, const uint8_t* buf, size_t len) {
+    return UpdateCrc32(crc, buf, len);
+  };
+  std::vector<Kernel> kernels = {{"auto", update_crc32, 0},
+                                 {"c", &internal::UpdateCrc32_C, 0}};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (internal::CpuSupportsCrc32PCLMUL())
+    kernels.push_back({"pclmul", &internal::UpdateCrc32_PCLMUL, 64});
+#endif
+#if defined(RTC_CRC32_HAS_ARMV8_KERNEL)
+  if (internal::CpuSupportsCrc32ARMv8())
+    kernels.push_back({"armv8", &internal::UpdateCrc32_ARMv8, 0});
+#endif
+  for (size_t len : {28, 96, 160, 208, 1200}) {
+    for (const Kernel& kernel : kernels) {
+      if (len < kernel.min_len || (kernel.min_len > 0 && len % 16 != 0))
+        continue;
+      uint32_t crc = 0;
+      int64_t start_ns = TimeNanos();
+      for (int i = 0; i < kNumIterations; ++i)
+        crc = kernel.update(crc, input.data(), len);
+      int64_t elapsed_ns = TimeNanos() - start_ns;
+      // Keeps the loop from being optimized away.
+      EXPECT_NE(0xDEADBEEF, crc);
+      // Bytes per nanosecond times 1000 is MB/s.
+      webrtc::test::PrintResult(
+          "crc32", "_" + std::to_string(len) + "_bytes", kernel.name,
+          static_cast<size_t>(static_cast<int64_t>(len) * kNumIterations *
+                              1000 / elapsed_ns),
+          "MB/s", false);
+    }
+  }
+}
+
 }  // namespace rtc
@@ -10,12 +10,34 @@
 
 #include "webrtc/rtc_base/criticalsection.h"
 
+#include <algorithm>
+
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/criticalsectionprofiler.h"
 #include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 // TODO(tommi): Split this file up to per-platform implementation files.
 
 namespace rtc {
+namespace {
+
+#if defined(WEBRTC_POSIX) && !(defined(WEBRTC_MAC) && !USE_NATIVE_MUTEX_ON_MAC)
+// Upper bound of the attempts SpinToEnter() makes before blocking.
+const int kMaxSpinAttempts = 100;
+
+volatile int g_adaptive_spinning = 0;
+
+// Tells the CPU that we are spinning, so that it can save power and give the
+// core to a sibling hyperthread.
+void SpinPause() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  __asm__ __volatile__("pause");
+#endif
+}
+#endif
+
+}  // namespace
 
 CriticalSection::CriticalSection() {
 #if defined(WEBRTC_WIN)
@@ -32,6 +54,7 @@ CriticalSection::CriticalSection() {
   pthread_mutexattr_settype(&mutex_attribute, PTHREAD_MUTEX_RECURSIVE);
   pthread_mutex_init(&mutex_, &mutex_attribute);
   pthread_mutexattr_destroy(&mutex_attribute);
+  spin_estimate_ = 0;
 # endif
   CS_DEBUG_CODE(thread_ = 0);
   CS_DEBUG_CODE(recursion_count_ = 0);
@@ -98,7 +121,8 @@ void CriticalSection::Enter() const EXCLUSIVE_LOCK_FUNCTION() {
   ++recursion_;
 
 # else
-  pthread_mutex_lock(&mutex_);
+  if (!AtomicOps::AcquireLoad(&g_adaptive_spinning) || !SpinToEnter())
+    pthread_mutex_lock(&mutex_);
 # endif
 
 # if CS_DEBUG_CHECKS
@@ -115,6 +139,19 @@ void CriticalSection::Enter() const EXCLUSIVE_LOCK_FUNCTION() {
 #endif
 }
 
+void CriticalSection::Enter(const Location& location) const
+    EXCLUSIVE_LOCK_FUNCTION() {
+  if (!CriticalSectionProfiler::IsEnabled()) {
+    Enter();
+    return;
+  }
+  if (TryEnter())
+    return;
+  int64_t wait_start_us = TimeMicros();
+  Enter();
+  CriticalSectionProfiler::RecordWait(location, TimeMicros() - wait_start_us);
+}
+
 bool CriticalSection::TryEnter() const EXCLUSIVE_TRYLOCK_FUNCTION(true) {
 #if defined(WEBRTC_WIN)
   return TryEnterCriticalSection(&crit_) != FALSE;
@@ -176,6 +213,35 @@ void CriticalSection::Leave() const UNLOCK_FUNCTION() {
 #endif
 }
 
+void CriticalSection::EnableAdaptiveSpinning(bool enable) {
+#if defined(WEBRTC_POSIX) && !(defined(WEBRTC_MAC) && !USE_NATIVE_MUTEX_ON_MAC)
+  AtomicOps::ReleaseStore(&g_adaptive_spinning, enable ? 1 : 0);
+#endif
+}
+
+#if defined(WEBRTC_POSIX) && !(defined(WEBRTC_MAC) && !USE_NATIVE_MUTEX_ON_MAC)
+bool CriticalSection::SpinToEnter() const {
+  // This is the same heuristic as glibc's adaptive mutexes: the estimate is a
+  // running average of the attempts that were needed, and racy updates of it
+  // only make it a little less accurate.
+  int spin_estimate = AtomicOps::AcquireLoad(&spin_estimate_);
+  int max_attempts = std::min(kMaxSpinAttempts, spin_estimate * 2 + 10);
+  int attempts = 0;
+  bool have_lock = false;
+  while (attempts < max_attempts) {
+    ++attempts;
+    if (pthread_mutex_trylock(&mutex_) == 0) {
+      have_lock = true;
+      break;
+    }
+    SpinPause();
+  }
+  AtomicOps::ReleaseStore(&spin_estimate_,
+                          spin_estimate + (attempts - spin_estimate) / 8);
+  return have_lock;
+}
+#endif
+
 bool CriticalSection::CurrentThreadIsOwner() const {
 #if defined(WEBRTC_WIN)
   // OwningThread has type HANDLE but actually contains the Thread ID:
@@ -196,6 +262,10 @@ bool CriticalSection::CurrentThreadIsOwner() const {
 }
 
 CritScope::CritScope(const CriticalSection* cs) : cs_(cs) { cs_->Enter(); }
+CritScope::CritScope(const CriticalSection* cs, const Location& location)
+    : cs_(cs) {
+  cs_->Enter(location);
+}
 CritScope::~CritScope() { cs_->Leave(); }
 
 TryCritScope::TryCritScope(const CriticalSection* cs)
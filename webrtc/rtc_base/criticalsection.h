@@ -49,6 +49,8 @@
 
 namespace rtc {
 
+class Location;
+
 // Locking methods (Enter, TryEnter, Leave)are const to permit protecting
 // members inside a const context without requiring mutable CriticalSections
 // everywhere.
@@ -58,9 +60,20 @@ class LOCKABLE CriticalSection {
   ~CriticalSection();
 
   void Enter() const EXCLUSIVE_LOCK_FUNCTION();
+  // Same as Enter(), but while CriticalSectionProfiler is enabled, the time
+  // spent waiting for the lock is attributed to |location|.
+  void Enter(const Location& location) const EXCLUSIVE_LOCK_FUNCTION();
   bool TryEnter() const EXCLUSIVE_TRYLOCK_FUNCTION(true);
   void Leave() const UNLOCK_FUNCTION();
 
+  // When enabled, a thread that finds a CriticalSection taken retries for a
+  // while before it blocks. How long it retries adapts, per lock, to how many
+  // attempts recent waits needed, so briefly held locks are taken without
+  // sleeping while long held ones block almost right away. Disabled by
+  // default. Only affects the pthread based implementation; the Mac one
+  // always spins.
+  static void EnableAdaptiveSpinning(bool enable);
+
  private:
   // Use only for RTC_DCHECKing.
   bool CurrentThreadIsOwner() const;
@@ -81,7 +94,12 @@ class LOCKABLE CriticalSection {
   // The thread that currently holds the lock. Required to handle recursion.
   mutable PlatformThreadRef owning_thread_;
 # else
+  // Tries to take the lock for up to about twice |spin_estimate_| attempts.
+  bool SpinToEnter() const;
+
   mutable pthread_mutex_t mutex_;
+  // Running average of the attempts SpinToEnter() needed.
+  mutable volatile int spin_estimate_;
 # endif
   mutable PlatformThreadRef thread_;  // Only used by RTC_DCHECKs.
   mutable int recursion_count_;       // Only used by RTC_DCHECKs.
@@ -94,6 +112,9 @@ class LOCKABLE CriticalSection {
 class SCOPED_LOCKABLE CritScope {
  public:
   explicit CritScope(const CriticalSection* cs) EXCLUSIVE_LOCK_FUNCTION(cs);
+  // Attributes any wait for |cs| to |location|, see CriticalSectionProfiler.
+  CritScope(const CriticalSection* cs, const Location& location)
+      EXCLUSIVE_LOCK_FUNCTION(cs);
   ~CritScope() UNLOCK_FUNCTION();
  private:
   const CriticalSection* const cs_;
@@ -305,6 +305,18 @@ TEST(CriticalSectionTest, Basic) {
   EXPECT_EQ(0, runner.shared_value());
 }
 
+TEST(CriticalSectionTest, BasicWithAdaptiveSpinning) {
+  CriticalSection::EnableAdaptiveSpinning(true);
+  LockRunner<CriticalSectionLock> runner;
+  std::vector<std::unique_ptr<Thread>> threads;
+  StartThreads(&threads, &runner);
+  runner.SetExpectedThreadCount(kNumThreads);
+
+  EXPECT_TRUE(runner.Run());
+  EXPECT_EQ(0, runner.shared_value());
+  CriticalSection::EnableAdaptiveSpinning(false);
+}
+
 class PerfTestData {
  public:
   PerfTestData(int expected_count, Event* event)
@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/criticalsectionprofiler.h"
+
+#include <algorithm>
+#include <map>
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/logging.h"
+
+namespace rtc {
+namespace {
+
+volatile int g_enabled = 0;
+
+// A CriticalSection can't protect the sites, since recording happens from
+// within CriticalSection::Enter().
+GlobalLockPod g_sites_lock;
+// Keyed by Location::file_and_line(), which is a string literal per site.
+// Allocated on first use and never freed, to avoid a static destructor.
+std::map<const char*, CriticalSectionProfiler::SiteStats>* g_sites
+    GUARDED_BY(g_sites_lock) = nullptr;
+
+}  // namespace
+
+void CriticalSectionProfiler::Enable(bool enable) {
+  AtomicOps::ReleaseStore(&g_enabled, enable ? 1 : 0);
+}
+
+bool CriticalSectionProfiler::IsEnabled() {
+  return AtomicOps::AcquireLoad(&g_enabled) != 0;
+}
+
+void CriticalSectionProfiler::RecordWait(const Location& location,
+                                         int64_t wait_us) {
+  GlobalLockScope lock(&g_sites_lock);
+  if (!g_sites)
+    g_sites = new std::map<const char*, SiteStats>();
+  SiteStats& site = (*g_sites)[location.file_and_line()];
+  site.location = location;
+  ++site.contended_count;
+  site.total_wait_us += wait_us;
+  site.max_wait_us = std::max(site.max_wait_us, wait_us);
+}
+
+std::vector<CriticalSectionProfiler::SiteStats>
+CriticalSectionProfiler::GetTopContenders(size_t max_sites) {
+  std::vector<SiteStats> sites;
+  {
+    GlobalLockScope lock(&g_sites_lock);
+    if (g_sites) {
+      for (const auto& site : *g_sites)
+        sites.push_back(site.second);
+    }
+  }
+  std::sort(sites.begin(), sites.end(),
+            [](const SiteStats& a, const SiteStats& b) {
+              return a.total_wait_us > b.total_wait_us;
+            });
+  if (sites.size() > max_sites)
+    sites.resize(max_sites);
+  return sites;
+}
+
+void CriticalSectionProfiler::LogTopContenders(size_t max_sites) {
+  std::vector<SiteStats> sites = GetTopContenders(max_sites);
+  LOG(LS_INFO) << "Top " << sites.size() << " contended lock sites:";
+  for (const SiteStats& site : sites) {
+    LOG(LS_INFO) << "  " << site.location.ToString()
+                 << " waits: " << site.contended_count
+                 << ", total: " << site.total_wait_us
+                 << " us, max: " << site.max_wait_us << " us";
+  }
+}
+
+void CriticalSectionProfiler::Reset() {
+  GlobalLockScope lock(&g_sites_lock);
+  if (g_sites)
+    g_sites->clear();
+}
+
+}  // namespace rtc
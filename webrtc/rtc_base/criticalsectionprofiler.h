@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_BASE_CRITICALSECTIONPROFILER_H_
+#define WEBRTC_RTC_BASE_CRITICALSECTIONPROFILER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "webrtc/rtc_base/location.h"
+
+namespace rtc {
+
+// Opt-in profiler of lock contention. While it is enabled, each CritScope
+// that was given a Location and finds its CriticalSection taken records how
+// long it waited, so the locks that hurt the most can be found. CritScopes
+// without a Location, and uncontended ones, are not recorded.
+//
+// Usage:
+//   rtc::CritScope lock(&crit_, RTC_FROM_HERE);
+//   ...
+//   CriticalSectionProfiler::Enable(true);
+//   // Run the scenario.
+//   CriticalSectionProfiler::LogTopContenders(10);
+class CriticalSectionProfiler {
+ public:
+  struct SiteStats {
+    Location location;
+    // Number of times a thread had to wait for the lock at |location|.
+    int64_t contended_count = 0;
+    int64_t total_wait_us = 0;
+    int64_t max_wait_us = 0;
+  };
+
+  // Disabled by default. While disabled, a CritScope with a Location costs the
+  // same as one without.
+  static void Enable(bool enable);
+  static bool IsEnabled();
+
+  // Called by CriticalSection after a thread waited |wait_us| for the lock at
+  // |location|.
+  static void RecordWait(const Location& location, int64_t wait_us);
+
+  // Returns up to |max_sites| lock sites, the one with the most total wait
+  // time first.
+  static std::vector<SiteStats> GetTopContenders(size_t max_sites);
+  // Logs the result of GetTopContenders().
+  static void LogTopContenders(size_t max_sites);
+
+  // Forgets everything recorded so far.
+  static void Reset();
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_RTC_BASE_CRITICALSECTIONPROFILER_H_
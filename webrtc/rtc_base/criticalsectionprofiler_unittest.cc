@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/criticalsectionprofiler.h"
+
+#include <string>
+
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const int kHoldTimeMs = 20;
+const int kTimeoutMs = 10000;
+
+struct ContendingThreadData {
+  CriticalSection* crit;
+  Event* started;
+};
+
+void ContendingThread(void* obj) {
+  ContendingThreadData* data = static_cast<ContendingThreadData*>(obj);
+  data->started->Set();
+  CritScope lock(data->crit, RTC_FROM_HERE);
+}
+
+class CriticalSectionProfilerTest : public testing::Test {
+ protected:
+  CriticalSectionProfilerTest() {
+    CriticalSectionProfiler::Reset();
+    CriticalSectionProfiler::Enable(true);
+  }
+  ~CriticalSectionProfilerTest() override {
+    CriticalSectionProfiler::Enable(false);
+    CriticalSectionProfiler::Reset();
+  }
+};
+
+}  // namespace
+
+TEST_F(CriticalSectionProfilerTest, DoesNotRecordUncontendedLocks) {
+  CriticalSection crit;
+  {
+    CritScope lock(&crit, RTC_FROM_HERE);
+  }
+  EXPECT_TRUE(CriticalSectionProfiler::GetTopContenders(10).empty());
+}
+
+TEST_F(CriticalSectionProfilerTest, RecordsWaitAtContendedSite) {
+  CriticalSection crit;
+  Event started(false, false);
+  ContendingThreadData data = {&crit, &started};
+  PlatformThread thread(&ContendingThread, &data, "ContendingThread");
+  {
+    CritScope lock(&crit);
+    thread.Start();
+    ASSERT_TRUE(started.Wait(kTimeoutMs));
+    Thread::SleepMs(kHoldTimeMs);
+  }
+  thread.Stop();
+
+  std::vector<CriticalSectionProfiler::SiteStats> sites =
+      CriticalSectionProfiler::GetTopContenders(10);
+  ASSERT_EQ(1u, sites.size());
+  EXPECT_EQ(1, sites[0].contended_count);
+  EXPECT_GT(sites[0].total_wait_us, 0);
+  EXPECT_EQ(sites[0].total_wait_us, sites[0].max_wait_us);
+  EXPECT_NE(std::string::npos,
+            std::string(sites[0].location.file_and_line())
+                .find("criticalsectionprofiler_unittest.cc"));
+}
+
+TEST_F(CriticalSectionProfilerTest, DoesNotRecordWhileDisabled) {
+  CriticalSectionProfiler::Enable(false);
+  CriticalSection crit;
+  Event started(false, false);
+  ContendingThreadData data = {&crit, &started};
+  PlatformThread thread(&ContendingThread, &data, "ContendingThread");
+  {
+    CritScope lock(&crit);
+    thread.Start();
+    ASSERT_TRUE(started.Wait(kTimeoutMs));
+    Thread::SleepMs(kHoldTimeMs);
+  }
+  thread.Stop();
+  EXPECT_TRUE(CriticalSectionProfiler::GetTopContenders(10).empty());
+}
+
+}  // namespace rtc
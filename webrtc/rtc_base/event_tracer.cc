@@ -10,11 +10,20 @@
 #include "webrtc/rtc_base/event_tracer.h"
 
 #include <inttypes.h>
+#include <string.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/bytebuffer.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/logging.h"
@@ -85,6 +94,282 @@ static void EventTracingThreadFunc(void* params);
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
 
+// The number of events each thread can have waiting for the logging thread.
+// Events added to a full buffer are dropped.
+static const int kThreadEventBufferSize = 4096;
+
+// Identifies a binary capture, followed by the format version.
+static const char kBinaryCaptureMagic[] = "RTCTRACE";
+static const uint8_t kBinaryCaptureVersion = 1;
+
+// The trace event macros in trace_event.h take at most two arguments.
+static const int kMaxTraceArgs = 2;
+
+struct TraceArg {
+  const char* name;
+  unsigned char type;
+  // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
+  union TraceArgValue {
+    bool as_bool;
+    unsigned long long as_uint;
+    long long as_int;
+    double as_double;
+    const void* as_pointer;
+    const char* as_string;
+  } value;
+
+  // Assert that the size of the union is equal to the size of the as_uint
+  // field since we are assigning to arbitrary types using it.
+  static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
+                "Size of TraceArg value union is not equal to the size of "
+                "the uint field of that union.");
+};
+
+struct TraceEvent {
+  const char* name;
+  const unsigned char* category_enabled;
+  char phase;
+  int num_args;
+  TraceArg args[kMaxTraceArgs];
+  uint64_t timestamp;
+  int pid;
+  rtc::PlatformThreadId tid;
+};
+
+// Deletes the copies of the TRACE_VALUE_TYPE_COPY_STRING arguments of |e|.
+void DeleteCopiedStrings(TraceEvent* e) {
+  for (int i = 0; i < e->num_args; ++i) {
+    TraceArg& arg = e->args[i];
+    if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      delete[] arg.value.as_string;
+      arg.value.as_string = nullptr;
+    }
+  }
+}
+
+std::string TraceArgValueAsString(TraceArg arg) {
+  std::string output;
+
+  if (arg.type == TRACE_VALUE_TYPE_STRING ||
+      arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+    // Space for every character to be an espaced character + two for
+    // quatation marks.
+    output.reserve(strlen(arg.value.as_string) * 2 + 2);
+    output += '\"';
+    const char* c = arg.value.as_string;
+    do {
+      if (*c == '"' || *c == '\\') {
+        output += '\\';
+        output += *c;
+      } else {
+        output += *c;
+      }
+    } while (*++c);
+    output += '\"';
+  } else {
+    output.resize(kTraceArgBufferLength);
+    size_t print_length = 0;
+    switch (arg.type) {
+      case TRACE_VALUE_TYPE_BOOL:
+        if (arg.value.as_bool) {
+          strcpy(&output[0], "true");
+          print_length = 4;
+        } else {
+          strcpy(&output[0], "false");
+          print_length = 5;
+        }
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
+                                arg.value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
+                                arg.value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
+                                arg.value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
+                                arg.value.as_pointer);
+        break;
+    }
+    size_t output_length = print_length < kTraceArgBufferLength
+                               ? print_length
+                               : kTraceArgBufferLength - 1;
+    // This will hopefully be very close to nop. On most implementations, it
+    // just writes null byte and sets the length field of the string.
+    output.resize(output_length);
+  }
+
+  return output;
+}
+
+// The TraceEvent format is documented here:
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+void WriteJsonEvent(const TraceEvent& e,
+                    bool is_first_event,
+                    std::string* args_str,
+                    FILE* file) {
+  args_str->clear();
+  if (e.num_args > 0) {
+    *args_str += ", \"args\": {";
+    for (int i = 0; i < e.num_args; ++i) {
+      if (i > 0)
+        *args_str += ",";
+      *args_str += " \"";
+      *args_str += e.args[i].name;
+      *args_str += "\": ";
+      *args_str += TraceArgValueAsString(e.args[i]);
+    }
+    *args_str += " }";
+  }
+  fprintf(file,
+          "%s{ \"name\": \"%s\""
+          ", \"cat\": \"%s\""
+          ", \"ph\": \"%c\""
+          ", \"ts\": %" PRIu64
+          ", \"pid\": %d"
+#if defined(WEBRTC_WIN)
+          ", \"tid\": %lu"
+#else
+          ", \"tid\": %d"
+#endif  // defined(WEBRTC_WIN)
+          "%s"
+          "}\n",
+          is_first_event ? " " : ",", e.name, e.category_enabled, e.phase,
+          e.timestamp, e.pid, e.tid, args_str->c_str());
+}
+
+// A binary capture is kBinaryCaptureMagic and kBinaryCaptureVersion followed
+// by blocks of events, each a uint32 byte count and then the events. Strings
+// are a uint16 length (uint32 for argument values) and then the characters.
+void WriteBinaryString(const char* str, rtc::ByteBufferWriter* buffer) {
+  size_t length = std::min<size_t>(strlen(str), 0xffff);
+  buffer->WriteUInt16(static_cast<uint16_t>(length));
+  buffer->WriteBytes(str, length);
+}
+
+void WriteBinaryEvent(const TraceEvent& e, rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUInt8(static_cast<uint8_t>(e.phase));
+  buffer->WriteUInt64(e.timestamp);
+  buffer->WriteUInt32(static_cast<uint32_t>(e.pid));
+  buffer->WriteUInt32(static_cast<uint32_t>(e.tid));
+  WriteBinaryString(e.name, buffer);
+  WriteBinaryString(reinterpret_cast<const char*>(e.category_enabled),
+                    buffer);
+  buffer->WriteUInt8(static_cast<uint8_t>(e.num_args));
+  for (int i = 0; i < e.num_args; ++i) {
+    const TraceArg& arg = e.args[i];
+    WriteBinaryString(arg.name, buffer);
+    buffer->WriteUInt8(arg.type);
+    if (arg.type == TRACE_VALUE_TYPE_STRING ||
+        arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      size_t length = strlen(arg.value.as_string);
+      buffer->WriteUInt32(static_cast<uint32_t>(length));
+      buffer->WriteBytes(arg.value.as_string, length);
+    } else {
+      buffer->WriteUInt64(arg.value.as_uint);
+    }
+  }
+}
+
+bool ReadBinaryString(rtc::ByteBufferReader* buffer, std::string* str) {
+  uint16_t length;
+  return buffer->ReadUInt16(&length) && buffer->ReadString(str, length);
+}
+
+// Reads an event of a binary capture into |e|, of which the strings point into
+// |strings|.
+bool ReadBinaryEvent(rtc::ByteBufferReader* buffer,
+                     TraceEvent* e,
+                     std::string strings[2 + 2 * kMaxTraceArgs]) {
+  uint8_t phase;
+  uint32_t pid;
+  uint32_t tid;
+  uint8_t num_args;
+  if (!buffer->ReadUInt8(&phase) || !buffer->ReadUInt64(&e->timestamp) ||
+      !buffer->ReadUInt32(&pid) || !buffer->ReadUInt32(&tid) ||
+      !ReadBinaryString(buffer, &strings[0]) ||
+      !ReadBinaryString(buffer, &strings[1]) ||
+      !buffer->ReadUInt8(&num_args) || num_args > kMaxTraceArgs) {
+    return false;
+  }
+  e->phase = static_cast<char>(phase);
+  e->pid = static_cast<int>(pid);
+  e->tid = static_cast<rtc::PlatformThreadId>(tid);
+  e->name = strings[0].c_str();
+  e->category_enabled =
+      reinterpret_cast<const unsigned char*>(strings[1].c_str());
+  e->num_args = num_args;
+  for (int i = 0; i < e->num_args; ++i) {
+    TraceArg& arg = e->args[i];
+    std::string& arg_name = strings[2 + 2 * i];
+    std::string& arg_value = strings[3 + 2 * i];
+    if (!ReadBinaryString(buffer, &arg_name) || !buffer->ReadUInt8(&arg.type))
+      return false;
+    arg.name = arg_name.c_str();
+    if (arg.type == TRACE_VALUE_TYPE_STRING ||
+        arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      uint32_t length;
+      if (!buffer->ReadUInt32(&length) ||
+          !buffer->ReadString(&arg_value, length)) {
+        return false;
+      }
+      arg.type = TRACE_VALUE_TYPE_STRING;
+      arg.value.as_string = arg_value.c_str();
+    } else {
+      uint64_t value;
+      if (!buffer->ReadUInt64(&value))
+        return false;
+      arg.value.as_uint = value;
+    }
+  }
+  return true;
+}
+
+// The events of one thread. Only that thread adds events and only one
+// consumer at a time removes them, so no lock is needed.
+class ThreadEventBuffer {
+ public:
+  ThreadEventBuffer() : write_index_(0), read_index_(0) {}
+
+  // Called on the buffer's thread. Returns false if the buffer is full, in
+  // which case the event isn't added.
+  bool Push(const TraceEvent& event) {
+    int write_index = rtc::AtomicOps::AcquireLoad(&write_index_);
+    int next_index = (write_index + 1) % kThreadEventBufferSize;
+    if (next_index == rtc::AtomicOps::AcquireLoad(&read_index_))
+      return false;
+    events_[write_index] = event;
+    rtc::AtomicOps::ReleaseStore(&write_index_, next_index);
+    return true;
+  }
+
+  // Returns false if the buffer is empty.
+  bool Pop(TraceEvent* event) {
+    int read_index = rtc::AtomicOps::AcquireLoad(&read_index_);
+    if (read_index == rtc::AtomicOps::AcquireLoad(&write_index_))
+      return false;
+    *event = events_[read_index];
+    rtc::AtomicOps::ReleaseStore(&read_index_,
+                                 (read_index + 1) % kThreadEventBufferSize);
+    return true;
+  }
+
+ private:
+  TraceEvent events_[kThreadEventBufferSize];
+  // The next slot to add an event to is only written by the buffer's thread,
+  // and the next event to remove only by the consumer. The buffer is empty
+  // when they're equal, and one slot is left unused when it's full.
+  volatile int write_index_;
+  volatile int read_index_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ThreadEventBuffer);
+};
+
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
  public:
@@ -93,8 +378,27 @@ class EventLogger final {
                         this,
                         "EventTracingThread",
                         kLowPriority),
-        shutdown_event_(false, false) {}
-  ~EventLogger() { RTC_DCHECK(thread_checker_.CalledOnValidThread()); }
+        shutdown_event_(false, false) {
+#if defined(WEBRTC_WIN)
+    tls_index_ = TlsAlloc();
+#else
+    RTC_CHECK_EQ(0, pthread_key_create(&tls_key_, nullptr));
+#endif
+  }
+  ~EventLogger() {
+    RTC_DCHECK(thread_checker_.CalledOnValidThread());
+    for (ThreadEventBuffer* buffer : thread_buffers_) {
+      TraceEvent event;
+      while (buffer->Pop(&event))
+        DeleteCopiedStrings(&event);
+      delete buffer;
+    }
+#if defined(WEBRTC_WIN)
+    TlsFree(tls_index_);
+#else
+    pthread_key_delete(tls_key_);
+#endif
+  }
 
   void AddTraceEvent(const char* name,
                      const unsigned char* category_enabled,
@@ -106,9 +410,17 @@ class EventLogger final {
                      uint64_t timestamp,
                      int pid,
                      rtc::PlatformThreadId thread_id) {
-    std::vector<TraceArg> args(num_args);
+    RTC_DCHECK_LE(num_args, kMaxTraceArgs);
+    TraceEvent event;
+    event.name = name;
+    event.category_enabled = category_enabled;
+    event.phase = phase;
+    event.num_args = num_args;
+    event.timestamp = timestamp;
+    event.pid = pid;
+    event.tid = thread_id;
     for (int i = 0; i < num_args; ++i) {
-      TraceArg& arg = args[i];
+      TraceArg& arg = event.args[i];
       arg.name = arg_names[i];
       arg.type = arg_types[i];
       arg.value.as_uint = arg_values[i];
@@ -122,89 +434,82 @@ class EventLogger final {
         arg.value.as_string = str_copy;
       }
     }
-    rtc::CritScope lock(&crit_);
-    trace_events_.push_back(
-        {name, category_enabled, phase, args, timestamp, 1, thread_id});
+    if (!GetThreadBuffer()->Push(event)) {
+      DeleteCopiedStrings(&event);
+      rtc::AtomicOps::Increment(&num_dropped_events_);
+    }
   }
 
-// The TraceEvent format is documented here:
-// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
   void Log() {
     RTC_DCHECK(output_file_);
     static const int kLoggingIntervalMs = 100;
-    fprintf(output_file_, "{ \"traceEvents\": [\n");
+    if (binary_) {
+      fwrite(kBinaryCaptureMagic, 1, strlen(kBinaryCaptureMagic),
+             output_file_);
+      fwrite(&kBinaryCaptureVersion, 1, 1, output_file_);
+    } else {
+      fprintf(output_file_, "{ \"traceEvents\": [\n");
+    }
     bool has_logged_event = false;
+    std::string args_str;
+    args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
+    std::vector<ThreadEventBuffer*> thread_buffers;
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
       {
         rtc::CritScope lock(&crit_);
-        trace_events_.swap(events);
+        thread_buffers = thread_buffers_;
       }
-      std::string args_str;
-      args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
-      for (TraceEvent& e : events) {
-        args_str.clear();
-        if (!e.args.empty()) {
-          args_str += ", \"args\": {";
-          bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
-            if (!is_first_argument)
-              args_str += ",";
-            is_first_argument = false;
-            args_str += " \"";
-            args_str += arg.name;
-            args_str += "\": ";
-            args_str += TraceArgValueAsString(arg);
-
-            // Delete our copy of the string.
-            if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-              delete[] arg.value.as_string;
-              arg.value.as_string = nullptr;
-            }
+      rtc::ByteBufferWriter binary_events;
+      for (ThreadEventBuffer* buffer : thread_buffers) {
+        TraceEvent event;
+        while (buffer->Pop(&event)) {
+          if (binary_) {
+            WriteBinaryEvent(event, &binary_events);
+          } else {
+            WriteJsonEvent(event, !has_logged_event, &args_str, output_file_);
           }
-          args_str += " }";
+          has_logged_event = true;
+          DeleteCopiedStrings(&event);
         }
-        fprintf(output_file_,
-                "%s{ \"name\": \"%s\""
-                ", \"cat\": \"%s\""
-                ", \"ph\": \"%c\""
-                ", \"ts\": %" PRIu64
-                ", \"pid\": %d"
-#if defined(WEBRTC_WIN)
-                ", \"tid\": %lu"
-#else
-                ", \"tid\": %d"
-#endif  // defined(WEBRTC_WIN)
-                "%s"
-                "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
-        has_logged_event = true;
+      }
+      if (binary_events.Length() > 0) {
+        rtc::ByteBufferWriter block_length;
+        block_length.WriteUInt32(static_cast<uint32_t>(binary_events.Length()));
+        fwrite(block_length.Data(), 1, block_length.Length(), output_file_);
+        fwrite(binary_events.Data(), 1, binary_events.Length(), output_file_);
       }
       if (shutting_down)
         break;
     }
-    fprintf(output_file_, "]}\n");
+    if (!binary_)
+      fprintf(output_file_, "]}\n");
     if (output_file_owned_)
       fclose(output_file_);
     output_file_ = nullptr;
   }
 
-  void Start(FILE* file, bool owned) {
+  void Start(FILE* file, bool owned, bool binary) {
     RTC_DCHECK(thread_checker_.CalledOnValidThread());
     RTC_DCHECK(file);
     RTC_DCHECK(!output_file_);
     output_file_ = file;
     output_file_owned_ = owned;
+    binary_ = binary;
     {
       rtc::CritScope lock(&crit_);
       // Since the atomic fast-path for adding events to the queue can be
       // bypassed while the logging thread is shutting down there may be some
-      // stale events in the queue, hence the vector needs to be cleared to not
-      // log events from a previous logging session (which may be days old).
-      trace_events_.clear();
+      // stale events in the buffers, hence they need to be emptied to not log
+      // events from a previous logging session (which may be days old). The
+      // logging thread isn't running, so this is the only consumer.
+      for (ThreadEventBuffer* buffer : thread_buffers_) {
+        TraceEvent event;
+        while (buffer->Pop(&event))
+          DeleteCopiedStrings(&event);
+      }
     }
+    rtc::AtomicOps::ReleaseStore(&num_dropped_events_, 0);
     // Enable event logging (fast-path). This should be disabled since starting
     // shouldn't be done twice.
     RTC_CHECK_EQ(0,
@@ -226,106 +531,56 @@ class EventLogger final {
     shutdown_event_.Set();
     // Join the logging thread.
     logging_thread_.Stop();
+    int num_dropped_events = rtc::AtomicOps::AcquireLoad(&num_dropped_events_);
+    if (num_dropped_events > 0) {
+      LOG(LS_WARNING) << "Dropped " << num_dropped_events
+                      << " trace events because a thread's buffer was full.";
+    }
   }
 
  private:
-  struct TraceArg {
-    const char* name;
-    unsigned char type;
-    // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
-    union TraceArgValue {
-      bool as_bool;
-      unsigned long long as_uint;
-      long long as_int;
-      double as_double;
-      const void* as_pointer;
-      const char* as_string;
-    } value;
-
-    // Assert that the size of the union is equal to the size of the as_uint
-    // field since we are assigning to arbitrary types using it.
-    static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
-                  "Size of TraceArg value union is not equal to the size of "
-                  "the uint field of that union.");
-  };
-
-  struct TraceEvent {
-    const char* name;
-    const unsigned char* category_enabled;
-    char phase;
-    std::vector<TraceArg> args;
-    uint64_t timestamp;
-    int pid;
-    rtc::PlatformThreadId tid;
-  };
-
-  static std::string TraceArgValueAsString(TraceArg arg) {
-    std::string output;
-
-    if (arg.type == TRACE_VALUE_TYPE_STRING ||
-        arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-      // Space for every character to be an espaced character + two for
-      // quatation marks.
-      output.reserve(strlen(arg.value.as_string) * 2 + 2);
-      output += '\"';
-      const char* c = arg.value.as_string;
-      do {
-        if (*c == '"' || *c == '\\') {
-          output += '\\';
-          output += *c;
-        } else {
-          output += *c;
-        }
-      } while (*++c);
-      output += '\"';
-    } else {
-      output.resize(kTraceArgBufferLength);
-      size_t print_length = 0;
-      switch (arg.type) {
-        case TRACE_VALUE_TYPE_BOOL:
-          if (arg.value.as_bool) {
-            strcpy(&output[0], "true");
-            print_length = 4;
-          } else {
-            strcpy(&output[0], "false");
-            print_length = 5;
-          }
-          break;
-        case TRACE_VALUE_TYPE_UINT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
-                                  arg.value.as_uint);
-          break;
-        case TRACE_VALUE_TYPE_INT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
-                                  arg.value.as_int);
-          break;
-        case TRACE_VALUE_TYPE_DOUBLE:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
-                                  arg.value.as_double);
-          break;
-        case TRACE_VALUE_TYPE_POINTER:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
-                                  arg.value.as_pointer);
-          break;
-      }
-      size_t output_length = print_length < kTraceArgBufferLength
-                                 ? print_length
-                                 : kTraceArgBufferLength - 1;
-      // This will hopefully be very close to nop. On most implementations, it
-      // just writes null byte and sets the length field of the string.
-      output.resize(output_length);
+  // Returns the buffer of the current thread, which is created on its first
+  // event. The buffers are kept until the logger is destroyed, since their
+  // threads may add events at any time.
+  ThreadEventBuffer* GetThreadBuffer() {
+#if defined(WEBRTC_WIN)
+    ThreadEventBuffer* buffer =
+        static_cast<ThreadEventBuffer*>(TlsGetValue(tls_index_));
+#else
+    ThreadEventBuffer* buffer =
+        static_cast<ThreadEventBuffer*>(pthread_getspecific(tls_key_));
+#endif
+    if (buffer)
+      return buffer;
+    buffer = new ThreadEventBuffer();
+    {
+      rtc::CritScope lock(&crit_);
+      thread_buffers_.push_back(buffer);
     }
-
-    return output;
+#if defined(WEBRTC_WIN)
+    TlsSetValue(tls_index_, buffer);
+#else
+    pthread_setspecific(tls_key_, buffer);
+#endif
+    return buffer;
   }
 
+  // Only taken when a thread adds its first event, and by the logging thread
+  // to find the buffers.
   rtc::CriticalSection crit_;
-  std::vector<TraceEvent> trace_events_ GUARDED_BY(crit_);
+  std::vector<ThreadEventBuffer*> thread_buffers_ GUARDED_BY(crit_);
+#if defined(WEBRTC_WIN)
+  DWORD tls_index_;
+#else
+  pthread_key_t tls_key_;
+#endif
+  volatile int num_dropped_events_ = 0;
   rtc::PlatformThread logging_thread_;
   rtc::Event shutdown_event_;
   rtc::ThreadChecker thread_checker_;
   FILE* output_file_ = nullptr;
   bool output_file_owned_ = false;
+  bool binary_ = false;
 };
 
 static void EventTracingThreadFunc(void* params) {
@@ -364,6 +619,20 @@ void InternalAddTraceEvent(char phase,
                                 rtc::TimeMicros(), 1, rtc::CurrentThreadId());
 }
 
+bool StartCapture(const char* filename, bool binary) {
+  if (!g_event_logger)
+    return false;
+
+  FILE* file = fopen(filename, binary ? "wb" : "w");
+  if (!file) {
+    LOG(LS_ERROR) << "Failed to open trace file '" << filename
+                  << "' for writing.";
+    return false;
+  }
+  g_event_logger->Start(file, true, binary);
+  return true;
+}
+
 }  // namespace
 
 void SetupInternalTracer() {
@@ -375,22 +644,22 @@ void SetupInternalTracer() {
 
 void StartInternalCaptureToFile(FILE* file) {
   if (g_event_logger) {
-    g_event_logger->Start(file, false);
+    g_event_logger->Start(file, false, false);
   }
 }
 
 bool StartInternalCapture(const char* filename) {
-  if (!g_event_logger)
-    return false;
+  return StartCapture(filename, false);
+}
 
-  FILE* file = fopen(filename, "w");
-  if (!file) {
-    LOG(LS_ERROR) << "Failed to open trace file '" << filename
-                  << "' for writing.";
-    return false;
+void StartInternalBinaryCaptureToFile(FILE* file) {
+  if (g_event_logger) {
+    g_event_logger->Start(file, false, true);
   }
-  g_event_logger->Start(file, true);
-  return true;
+}
+
+bool StartInternalBinaryCapture(const char* filename) {
+  return StartCapture(filename, true);
 }
 
 void StopInternalCapture() {
@@ -410,5 +679,58 @@ void ShutdownInternalTracer() {
   webrtc::SetupEventTracer(nullptr, nullptr);
 }
 
+bool ConvertBinaryCaptureToJson(FILE* binary_file, FILE* json_file) {
+  const size_t magic_length = strlen(kBinaryCaptureMagic);
+  std::vector<char> header(magic_length + 1);
+  if (fread(header.data(), 1, header.size(), binary_file) != header.size() ||
+      memcmp(header.data(), kBinaryCaptureMagic, magic_length) != 0 ||
+      static_cast<uint8_t>(header[magic_length]) != kBinaryCaptureVersion) {
+    LOG(LS_ERROR) << "Not a binary trace capture.";
+    return false;
+  }
+  fprintf(json_file, "{ \"traceEvents\": [\n");
+  bool has_logged_event = false;
+  std::string args_str;
+  args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
+  std::vector<char> block;
+  bool success = true;
+  while (true) {
+    char block_length_bytes[4];
+    size_t read_length =
+        fread(block_length_bytes, 1, sizeof(block_length_bytes), binary_file);
+    if (read_length == 0)
+      break;
+    uint32_t block_length;
+    rtc::ByteBufferReader block_length_reader(block_length_bytes, read_length);
+    if (!block_length_reader.ReadUInt32(&block_length)) {
+      success = false;
+      break;
+    }
+    block.resize(block_length);
+    if (fread(block.data(), 1, block.size(), binary_file) != block.size()) {
+      success = false;
+      break;
+    }
+    rtc::ByteBufferReader events(block.data(), block.size());
+    while (events.Length() > 0) {
+      TraceEvent event;
+      std::string strings[2 + 2 * kMaxTraceArgs];
+      if (!ReadBinaryEvent(&events, &event, strings)) {
+        success = false;
+        break;
+      }
+      WriteJsonEvent(event, !has_logged_event, &args_str, json_file);
+      has_logged_event = true;
+    }
+    if (!success)
+      break;
+  }
+  // The events before an error are still converted to a valid trace.
+  fprintf(json_file, "]}\n");
+  if (!success)
+    LOG(LS_ERROR) << "Truncated or malformed binary trace capture.";
+  return success;
+}
+
 }  // namespace tracing
 }  // namespace rtc
@@ -72,13 +72,25 @@ class EventTracer {
 
 namespace rtc {
 namespace tracing {
-// Set up internal event tracer.
+// Set up internal event tracer. Each thread adds its events to a fixed-size
+// buffer of its own without taking a lock, and the events are written by a
+// separate thread. Events are dropped if a thread adds them faster than they
+// are written.
 void SetupInternalTracer();
+// Writes the events in the Chrome trace format.
 bool StartInternalCapture(const char* filename);
 void StartInternalCaptureToFile(FILE* file);
+// Writes the events in a binary format, which is cheaper than formatting them
+// while capturing. Use ConvertBinaryCaptureToJson() to view them.
+bool StartInternalBinaryCapture(const char* filename);
+void StartInternalBinaryCaptureToFile(FILE* file);
 void StopInternalCapture();
 // Make sure we run this, this will tear down the internal tracing.
 void ShutdownInternalTracer();
+// Converts a capture of StartInternalBinaryCapture() to the Chrome trace
+// format. Returns false if |binary_file| isn't a complete binary capture, in
+// which case the events before the error are still converted.
+bool ConvertBinaryCaptureToJson(FILE* binary_file, FILE* json_file);
 }  // namespace tracing
 }  // namespace rtc
 
@@ -10,6 +10,13 @@
 
 #include "webrtc/rtc_base/event_tracer.h"
 
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/trace_event.h"
 #include "webrtc/system_wrappers/include/static_instance.h"
 #include "webrtc/test/gtest.h"
@@ -58,6 +65,32 @@ static void AddTraceEventHandler(char phase,
   TestStatistics::Get()->Increment();
 }
 
+const int kEventsPerThread = 100;
+
+void AddTraceEvents(void* obj) {
+  for (int i = 0; i < kEventsPerThread; ++i)
+    TRACE_EVENT_INSTANT1("test", "ThreadEvent", "index", i);
+}
+
+std::string ReadFile(FILE* file) {
+  rewind(file);
+  std::string contents;
+  char buffer[1024];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, length);
+  return contents;
+}
+
+int CountOccurrences(const std::string& str, const std::string& substr) {
+  int count = 0;
+  for (size_t pos = str.find(substr); pos != std::string::npos;
+       pos = str.find(substr, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -79,4 +112,73 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   TestStatistics::Get()->Reset();
 }
 
+TEST(EventTracerTest, InternalCaptureHasEventsOfAllThreads) {
+  rtc::tracing::SetupInternalTracer();
+  FILE* json_file = tmpfile();
+  ASSERT_TRUE(json_file);
+  rtc::tracing::StartInternalCaptureToFile(json_file);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&AddTraceEvents, nullptr, "TraceThread"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  rtc::tracing::StopInternalCapture();
+  rtc::tracing::ShutdownInternalTracer();
+
+  std::string json = ReadFile(json_file);
+  fclose(json_file);
+  EXPECT_EQ(0u, json.find("{ \"traceEvents\": ["));
+  EXPECT_EQ(4 * kEventsPerThread,
+            CountOccurrences(json, "\"name\": \"ThreadEvent\""));
+  EXPECT_EQ(4, CountOccurrences(json, "\"index\": 99"));
+}
+
+TEST(EventTracerTest, BinaryCaptureConvertsToJson) {
+  rtc::tracing::SetupInternalTracer();
+  FILE* binary_file = tmpfile();
+  ASSERT_TRUE(binary_file);
+  rtc::tracing::StartInternalBinaryCaptureToFile(binary_file);
+  std::string copied = "copied \"string\"";
+  TRACE_EVENT_INSTANT2("test", "BinaryEvent", "number", -7, "string",
+                       TRACE_STR_COPY(copied.c_str()));
+  AddTraceEvents(nullptr);
+  rtc::tracing::StopInternalCapture();
+  rtc::tracing::ShutdownInternalTracer();
+
+  std::string binary = ReadFile(binary_file);
+  rewind(binary_file);
+  FILE* json_file = tmpfile();
+  ASSERT_TRUE(json_file);
+  EXPECT_TRUE(rtc::tracing::ConvertBinaryCaptureToJson(binary_file, json_file));
+  fclose(binary_file);
+  std::string json = ReadFile(json_file);
+  EXPECT_EQ(1, CountOccurrences(
+                   json, "\"name\": \"BinaryEvent\", \"cat\": \"test\", "
+                         "\"ph\": \"I\""));
+  EXPECT_EQ(1, CountOccurrences(
+                   json, "\"args\": { \"number\": -7, "
+                         "\"string\": \"copied \\\"string\\\"\" }"));
+  EXPECT_EQ(kEventsPerThread,
+            CountOccurrences(json, "\"name\": \"ThreadEvent\""));
+  EXPECT_EQ("]}\n", json.substr(json.size() - 3));
+
+  // A truncated capture converts to a valid trace of the events before the
+  // truncation.
+  FILE* truncated_file = tmpfile();
+  ASSERT_TRUE(truncated_file);
+  fwrite(binary.data(), 1, binary.size() - 1, truncated_file);
+  rewind(truncated_file);
+  FILE* truncated_json_file = tmpfile();
+  ASSERT_TRUE(truncated_json_file);
+  EXPECT_FALSE(rtc::tracing::ConvertBinaryCaptureToJson(truncated_file,
+                                                        truncated_json_file));
+  EXPECT_EQ("{ \"traceEvents\": [\n]}\n", ReadFile(truncated_json_file));
+  fclose(truncated_file);
+  fclose(truncated_json_file);
+  fclose(json_file);
+}
+
 }  // namespace webrtc
@@ -11,6 +11,7 @@
 #include "webrtc/rtc_base/logsinks.h"
 
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "webrtc/rtc_base/checks.h"
@@ -61,4 +62,113 @@ CallSessionFileRotatingLogSink::CallSessionFileRotatingLogSink(
 CallSessionFileRotatingLogSink::~CallSessionFileRotatingLogSink() {
 }
 
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogSink> sink,
+                           size_t max_queued_bytes)
+    : sink_(std::move(sink)),
+      max_queued_bytes_(max_queued_bytes),
+      queued_bytes_(0),
+      dropped_messages_(0),
+      unreported_drops_(0),
+      queued_count_(0),
+      written_count_(0),
+      stopping_(false),
+      wake_up_(false, false),
+      batch_written_(false, false),
+      thread_(&AsyncLogSink::WriterThread,
+              this,
+              "AsyncLogSink",
+              kLowPriority) {
+  RTC_DCHECK(sink_);
+  RTC_DCHECK_GT(max_queued_bytes_, 0);
+  thread_.Start();
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    CritScope cs(&crit_);
+    stopping_ = true;
+  }
+  wake_up_.Set();
+  thread_.Stop();
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message) {
+  bool was_empty;
+  {
+    CritScope cs(&crit_);
+    if (queued_bytes_ + message.size() > max_queued_bytes_) {
+      ++dropped_messages_;
+      ++unreported_drops_;
+      return;
+    }
+    was_empty = queue_.empty();
+    queue_.push_back(message);
+    queued_bytes_ += message.size();
+    ++queued_count_;
+  }
+  // The writer thread only needs waking up when it has emptied the queue, so
+  // most messages don't touch |wake_up_|.
+  if (was_empty)
+    wake_up_.Set();
+}
+
+void AsyncLogSink::Flush() {
+  uint64_t target_count;
+  {
+    CritScope cs(&crit_);
+    target_count = queued_count_;
+  }
+  while (true) {
+    {
+      CritScope cs(&crit_);
+      if (written_count_ >= target_count)
+        return;
+    }
+    batch_written_.Wait(Event::kForever);
+  }
+}
+
+size_t AsyncLogSink::dropped_messages() const {
+  CritScope cs(&crit_);
+  return dropped_messages_;
+}
+
+void AsyncLogSink::WriterThread(void* obj) {
+  static_cast<AsyncLogSink*>(obj)->WriteMessages();
+}
+
+void AsyncLogSink::WriteMessages() {
+  std::vector<std::string> messages;
+  while (true) {
+    wake_up_.Wait(Event::kForever);
+    size_t dropped;
+    bool stopping;
+    {
+      CritScope cs(&crit_);
+      // Swapping keeps the capacity of both vectors, so that a steady stream
+      // of messages doesn't allocate for the queue.
+      messages.swap(queue_);
+      queued_bytes_ = 0;
+      dropped = unreported_drops_;
+      unreported_drops_ = 0;
+      stopping = stopping_;
+    }
+    if (dropped > 0) {
+      std::ostringstream oss;
+      oss << "AsyncLogSink dropped " << dropped << " log messages" << std::endl;
+      sink_->OnLogMessage(oss.str());
+    }
+    for (const std::string& message : messages)
+      sink_->OnLogMessage(message);
+    {
+      CritScope cs(&crit_);
+      written_count_ += messages.size();
+    }
+    messages.clear();
+    batch_written_.Set();
+    if (stopping)
+      return;
+  }
+}
+
 }  // namespace rtc
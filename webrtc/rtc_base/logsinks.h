@@ -13,10 +13,15 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/filerotatingstream.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 
 namespace rtc {
 
@@ -63,6 +68,59 @@ class CallSessionFileRotatingLogSink : public FileRotatingLogSink {
   RTC_DISALLOW_COPY_AND_ASSIGN(CallSessionFileRotatingLogSink);
 };
 
+// Log sink that hands messages to another sink on a dedicated writer thread,
+// so that a thread that logs never waits for the other sink, e.g. for disk
+// I/O. Logging only queues the message. At most |max_queued_bytes| of messages
+// are queued: messages beyond that are dropped, and the writer thread writes a
+// line saying how many were dropped before it writes the next ones.
+// For example, to write to disk without blocking real-time threads:
+//   std::unique_ptr<FileRotatingLogSink> file_sink(
+//       new FileRotatingLogSink(dir, prefix, max_log_size, num_log_files));
+//   file_sink->Init();
+//   AsyncLogSink async_sink(std::move(file_sink), 1024 * 1024);
+//   LogMessage::AddLogToStream(&async_sink, LS_VERBOSE);
+class AsyncLogSink : public LogSink {
+ public:
+  AsyncLogSink(std::unique_ptr<LogSink> sink, size_t max_queued_bytes);
+  // Writes the messages that are still queued before returning. Remove the
+  // sink from LogMessage first.
+  ~AsyncLogSink() override;
+
+  void OnLogMessage(const std::string& message) override;
+
+  // Blocks until all messages that were queued before the call are written.
+  void Flush();
+
+  // Total number of messages dropped because the queue was full.
+  size_t dropped_messages() const;
+
+ private:
+  static void WriterThread(void* obj);
+  void WriteMessages();
+
+  const std::unique_ptr<LogSink> sink_;
+  const size_t max_queued_bytes_;
+
+  CriticalSection crit_;
+  std::vector<std::string> queue_ GUARDED_BY(crit_);
+  size_t queued_bytes_ GUARDED_BY(crit_);
+  size_t dropped_messages_ GUARDED_BY(crit_);
+  // Drops the writer thread hasn't reported yet.
+  size_t unreported_drops_ GUARDED_BY(crit_);
+  // Messages queued and written since construction, for Flush().
+  uint64_t queued_count_ GUARDED_BY(crit_);
+  uint64_t written_count_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+
+  // Set when |queue_| stops being empty, or when stopping.
+  Event wake_up_;
+  // Set whenever the writer thread has written a batch.
+  Event batch_written_;
+  PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AsyncLogSink);
+};
+
 }  // namespace rtc
 
 #endif  // WEBRTC_RTC_BASE_LOGSINKS_H_
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/logsinks.h"
+
+#include <string>
+#include <vector>
+
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/gunit.h"
+
+namespace rtc {
+
+namespace {
+
+const int kTimeoutMs = 10000;
+
+// Records messages. With a |release| event, the writer thread signals
+// |entered| and then blocks in each message until |release| is set.
+class RecordingLogSink : public LogSink {
+ public:
+  RecordingLogSink() : RecordingLogSink(nullptr, nullptr) {}
+  RecordingLogSink(Event* entered, Event* release)
+      : entered_(entered), release_(release) {}
+
+  void OnLogMessage(const std::string& message) override {
+    if (release_) {
+      entered_->Set();
+      release_->Wait(kTimeoutMs);
+    }
+    CritScope cs(&crit_);
+    messages_.push_back(message);
+  }
+
+  std::vector<std::string> messages() const {
+    CritScope cs(&crit_);
+    return messages_;
+  }
+
+ private:
+  Event* const entered_;
+  Event* const release_;
+  CriticalSection crit_;
+  std::vector<std::string> messages_ GUARDED_BY(crit_);
+};
+
+// Forwards to a sink that outlives the AsyncLogSink.
+class ForwardingLogSink : public LogSink {
+ public:
+  explicit ForwardingLogSink(LogSink* sink) : sink_(sink) {}
+  void OnLogMessage(const std::string& message) override {
+    sink_->OnLogMessage(message);
+  }
+
+ private:
+  LogSink* const sink_;
+};
+
+}  // namespace
+
+TEST(AsyncLogSinkTest, WritesMessagesInOrder) {
+  RecordingLogSink* recorder = new RecordingLogSink();
+  AsyncLogSink sink(std::unique_ptr<LogSink>(recorder), 1024);
+  sink.OnLogMessage("first\n");
+  sink.OnLogMessage("second\n");
+  sink.OnLogMessage("third\n");
+  sink.Flush();
+
+  std::vector<std::string> messages = recorder->messages();
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ("first\n", messages[0]);
+  EXPECT_EQ("second\n", messages[1]);
+  EXPECT_EQ("third\n", messages[2]);
+  EXPECT_EQ(0u, sink.dropped_messages());
+}
+
+TEST(AsyncLogSinkTest, DropsMessagesWhenQueueIsFullAndReportsIt) {
+  Event entered(false, false);
+  // Manual reset, so that the writer never blocks again once released.
+  Event release(true, false);
+  RecordingLogSink* recorder = new RecordingLogSink(&entered, &release);
+  AsyncLogSink sink(std::unique_ptr<LogSink>(recorder), 10);
+
+  // Keep the writer thread busy with the first message, so that the others
+  // pile up in the queue.
+  sink.OnLogMessage("blocked\n");
+  ASSERT_TRUE(entered.Wait(kTimeoutMs));
+  sink.OnLogMessage("12345");
+  sink.OnLogMessage("67890");
+  sink.OnLogMessage("dropped");
+  EXPECT_EQ(1u, sink.dropped_messages());
+
+  release.Set();
+  sink.Flush();
+  std::vector<std::string> messages = recorder->messages();
+  ASSERT_EQ(4u, messages.size());
+  EXPECT_EQ("blocked\n", messages[0]);
+  EXPECT_EQ("AsyncLogSink dropped 1 log messages\n", messages[1]);
+  EXPECT_EQ("12345", messages[2]);
+  EXPECT_EQ("67890", messages[3]);
+}
+
+TEST(AsyncLogSinkTest, WritesQueuedMessagesOnDestruction) {
+  RecordingLogSink recorder;
+  {
+    AsyncLogSink sink(
+        std::unique_ptr<LogSink>(new ForwardingLogSink(&recorder)), 1024);
+    for (int i = 0; i < 100; ++i)
+      sink.OnLogMessage("message\n");
+  }
+  EXPECT_EQ(100u, recorder.messages().size());
+}
+
+}  // namespace rtc
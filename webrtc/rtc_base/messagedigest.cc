@@ -28,8 +28,6 @@ const char DIGEST_SHA_256[] = "sha-256";
 const char DIGEST_SHA_384[] = "sha-384";
 const char DIGEST_SHA_512[] = "sha-512";
 
-static const size_t kBlockSize = 64;  // valid for SHA-256 and down
-
 MessageDigest* MessageDigestFactory::Create(const std::string& alg) {
   MessageDigest* digest = new OpenSSLDigest(alg);
   if (digest->Size() == 0) {  // invalid algorithm
@@ -90,42 +88,58 @@ std::string ComputeDigest(const std::string& alg, const std::string& input) {
 }
 
 // Compute a RFC 2104 HMAC: H(K XOR opad, H(K XOR ipad, text))
-size_t ComputeHmac(MessageDigest* digest,
-                   const void* key, size_t key_len,
-                   const void* input, size_t in_len,
-                   void* output, size_t out_len) {
+Hmac::Hmac(MessageDigest* digest, const void* key, size_t key_len)
+    : digest_(digest), valid_(digest->Size() <= 32) {
   // We only handle algorithms with a 64-byte blocksize.
   // TODO: Add BlockSize() method to MessageDigest.
-  size_t block_len = kBlockSize;
-  if (digest->Size() > 32) {
-    return 0;
+  if (!valid_) {
+    return;
   }
   // Copy the key to a block-sized buffer to simplify padding.
   // If the key is longer than a block, hash it and use the result instead.
-  std::unique_ptr<uint8_t[]> new_key(new uint8_t[block_len]);
-  if (key_len > block_len) {
-    ComputeDigest(digest, key, key_len, new_key.get(), block_len);
-    memset(new_key.get() + digest->Size(), 0, block_len - digest->Size());
+  uint8_t new_key[kBlockSize];
+  if (key_len > kBlockSize) {
+    ComputeDigest(digest_, key, key_len, new_key, kBlockSize);
+    memset(new_key + digest_->Size(), 0, kBlockSize - digest_->Size());
   } else {
-    memcpy(new_key.get(), key, key_len);
-    memset(new_key.get() + key_len, 0, block_len - key_len);
+    memcpy(new_key, key, key_len);
+    memset(new_key + key_len, 0, kBlockSize - key_len);
   }
   // Set up the padding from the key, salting appropriately for each padding.
-  std::unique_ptr<uint8_t[]> o_pad(new uint8_t[block_len]);
-  std::unique_ptr<uint8_t[]> i_pad(new uint8_t[block_len]);
-  for (size_t i = 0; i < block_len; ++i) {
-    o_pad[i] = 0x5c ^ new_key[i];
+  uint8_t i_pad[kBlockSize];
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    o_pad_[i] = 0x5c ^ new_key[i];
     i_pad[i] = 0x36 ^ new_key[i];
   }
-  // Inner hash; hash the inner padding, and then the input buffer.
-  std::unique_ptr<uint8_t[]> inner(new uint8_t[digest->Size()]);
-  digest->Update(i_pad.get(), block_len);
-  digest->Update(input, in_len);
-  digest->Finish(inner.get(), digest->Size());
+  // Inner hash; hash the inner padding, and then the input from Update().
+  digest_->Update(i_pad, kBlockSize);
+}
+
+void Hmac::Update(const void* buf, size_t len) {
+  if (valid_) {
+    digest_->Update(buf, len);
+  }
+}
+
+size_t Hmac::Finish(void* buf, size_t len) {
+  if (!valid_) {
+    return 0;
+  }
+  uint8_t inner[MessageDigest::kMaxSize];
+  digest_->Finish(inner, digest_->Size());
   // Outer hash; hash the outer padding, and then the result of the inner hash.
-  digest->Update(o_pad.get(), block_len);
-  digest->Update(inner.get(), digest->Size());
-  return digest->Finish(output, out_len);
+  digest_->Update(o_pad_, kBlockSize);
+  digest_->Update(inner, digest_->Size());
+  return digest_->Finish(buf, len);
+}
+
+size_t ComputeHmac(MessageDigest* digest,
+                   const void* key, size_t key_len,
+                   const void* input, size_t in_len,
+                   void* output, size_t out_len) {
+  Hmac hmac(digest, key, key_len);
+  hmac.Update(input, in_len);
+  return hmac.Finish(output, out_len);
 }
 
 size_t ComputeHmac(const std::string& alg, const void* key, size_t key_len,
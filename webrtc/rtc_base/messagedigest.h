@@ -11,6 +11,8 @@
 #ifndef WEBRTC_RTC_BASE_MESSAGEDIGEST_H_
 #define WEBRTC_RTC_BASE_MESSAGEDIGEST_H_
 
+#include <stdint.h>
+
 #include <string>
 
 namespace rtc {
@@ -75,6 +77,29 @@ inline std::string MD5(const std::string& input) {
   return ComputeDigest(DIGEST_MD5, input);
 }
 
+// Computes an RFC 2104 HMAC incrementally, so that its input needn't be in one
+// contiguous buffer. Only digests with a 64-byte block size (SHA-256 and
+// down) are supported; valid() is false for the others. Does not take
+// ownership of |digest|, which must outlive this object.
+class Hmac {
+ public:
+  Hmac(MessageDigest* digest, const void* key, size_t key_len);
+
+  bool valid() const { return valid_; }
+  // Updates the HMAC with |len| bytes from |buf|.
+  void Update(const void* buf, size_t len);
+  // Outputs the HMAC to |buf| with length |len|. Returns the number of bytes
+  // written, or 0 if |len| was too small or the digest is not supported.
+  size_t Finish(void* buf, size_t len);
+
+ private:
+  enum { kBlockSize = 64 };
+
+  MessageDigest* digest_;
+  bool valid_;
+  uint8_t o_pad_[kBlockSize];
+};
+
 // Functions to compute RFC 2104 HMACs.
 
 // Computes the HMAC of |in_len| bytes of |input|, using the |digest| hash
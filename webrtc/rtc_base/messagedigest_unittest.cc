@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <memory>
+
 #include "webrtc/rtc_base/messagedigest.h"
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/stringencode.h"
@@ -142,6 +144,42 @@ TEST(MessageDigestTest, TestSha1Hmac) {
           input.c_str(), input.size(), output, sizeof(output) - 1));
 }
 
+// Test that an HMAC computed from several pieces of the input matches the
+// one computed from the whole input.
+TEST(MessageDigestTest, TestIncrementalHmac) {
+  std::unique_ptr<MessageDigest> digest(
+      MessageDigestFactory::Create(DIGEST_SHA_1));
+  ASSERT_TRUE(digest);
+  std::string key(80, '\xaa');
+  Hmac hmac(digest.get(), key.data(), key.size());
+  ASSERT_TRUE(hmac.valid());
+  hmac.Update("Test Using Larger Than Block-Size Key and Larger ", 49);
+  hmac.Update("Than One Block-Size Data", 24);
+  char output[20];
+  EXPECT_EQ(sizeof(output), hmac.Finish(output, sizeof(output)));
+  EXPECT_EQ("e8e99d0f45237d786d6bbaa7965c7808bbff1a91",
+      hex_encode(output, sizeof(output)));
+
+  // The digest can be used again afterwards.
+  Hmac hmac2(digest.get(), "Jefe", 4);
+  hmac2.Update("what do ya want ", 16);
+  hmac2.Update("for nothing?", 12);
+  EXPECT_EQ(sizeof(output), hmac2.Finish(output, sizeof(output)));
+  EXPECT_EQ("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+      hex_encode(output, sizeof(output)));
+}
+
+TEST(MessageDigestTest, TestUnsupportedIncrementalHmac) {
+  std::unique_ptr<MessageDigest> digest(
+      MessageDigestFactory::Create(DIGEST_SHA_512));
+  ASSERT_TRUE(digest);
+  Hmac hmac(digest.get(), "key", 3);
+  EXPECT_FALSE(hmac.valid());
+  hmac.Update("abc", 3);
+  char output[MessageDigest::kMaxSize];
+  EXPECT_EQ(0U, hmac.Finish(output, sizeof(output)));
+}
+
 TEST(MessageDigestTest, TestBadHmac) {
   std::string output;
   EXPECT_FALSE(ComputeHmac("sha-9000", "key", "abc", &output));
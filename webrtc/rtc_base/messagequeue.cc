@@ -175,6 +175,7 @@ void MessageQueueManager::ProcessAllMessageQueuesInternal() {
 // MessageQueue
 MessageQueue::MessageQueue(SocketServer* ss, bool init_queue)
     : fPeekKeep_(false),
+      dmsgq_(TimeMillis()),
       dmsgq_next_num_(0),
       fInitialized_(false),
       fDestroyed_(false),
@@ -298,13 +299,22 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!dmsgq_.empty()) {
-            if (msCurrent < dmsgq_.top().msTrigger_) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
-              break;
-            }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
+          dmsgq_expired_.clear();
+          dmsgq_.Advance(msCurrent, &dmsgq_expired_);
+          // Messages sharing a wheel slot are not sorted by trigger time.
+          std::sort(dmsgq_expired_.begin(), dmsgq_expired_.end(),
+                    [](TimerWheel::Timer* a, TimerWheel::Timer* b) {
+                      return *static_cast<DelayedMessage*>(b) <
+                             *static_cast<DelayedMessage*>(a);
+                    });
+          for (TimerWheel::Timer* timer : dmsgq_expired_) {
+            DelayedMessage* dmsg = static_cast<DelayedMessage*>(timer);
+            msgq_.push_back(dmsg->msg_);
+            RemoveDelayedMessage(dmsg);
+          }
+          int64_t wakeup;
+          if (dmsgq_.NextWakeup(&wakeup)) {
+            cmsDelayNext = std::max<int64_t>(TimeDiff(wakeup, msCurrent), 0);
           }
         }
         // Pull a message off the message queue, if available.
@@ -435,7 +445,7 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
   }
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the timer wheel.
   // Signal for the multiplexer to return.
 
   {
@@ -445,8 +455,8 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
     msg.phandler = phandler;
     msg.message_id = id;
     msg.pdata = pdata;
-    DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-    dmsgq_.push(dmsg);
+    AddDelayedMessage(
+        new DelayedMessage(cmsDelay, tstamp, dmsgq_next_num_, msg));
     // If this message queue processes 1 message every millisecond for 50 days,
     // we will wrap this number.  Even then, only messages with identical times
     // will be misordered, and then only briefly.  This is probably ok.
@@ -462,8 +472,9 @@ int MessageQueue::GetDelay() {
   if (!msgq_.empty())
     return 0;
 
-  if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
+  int64_t wakeup;
+  if (dmsgq_.NextWakeup(&wakeup)) {
+    int delay = TimeUntil(wakeup);
     if (delay < 0)
       delay = 0;
     return delay;
@@ -503,23 +514,61 @@ void MessageQueue::Clear(MessageHandler* phandler,
     }
   }
 
-  // Remove from priority queue. Not directly iterable, so use this approach
-
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
+  // Remove delayed messages. With a handler given, only its own list needs
+  // to be walked. Unlink all matches before deleting any data, since that may
+  // re-enter Clear().
+
+  std::vector<Message> cleared;
+  if (phandler) {
+    auto it = dmsgs_by_handler_.find(phandler);
+    DelayedMessage* dmsg = it != dmsgs_by_handler_.end() ? it->second : nullptr;
+    while (dmsg) {
+      DelayedMessage* next = dmsg->handler_next_;
+      if (dmsg->msg_.Match(phandler, id)) {
+        cleared.push_back(dmsg->msg_);
+        RemoveDelayedMessage(dmsg);
       }
+      dmsg = next;
+    }
+  } else {
+    for (TimerWheel::Timer* timer : dmsgq_.Timers()) {
+      DelayedMessage* dmsg = static_cast<DelayedMessage*>(timer);
+      if (dmsg->msg_.Match(phandler, id)) {
+        cleared.push_back(dmsg->msg_);
+        RemoveDelayedMessage(dmsg);
+      }
+    }
+  }
+  for (const Message& msg : cleared) {
+    if (removed) {
+      removed->push_back(msg);
     } else {
-      *new_end++ = *it;
+      delete msg.pdata;
     }
   }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
+}
+
+void MessageQueue::AddDelayedMessage(DelayedMessage* dmsg) {
+  DelayedMessage*& head = dmsgs_by_handler_[dmsg->msg_.phandler];
+  dmsg->handler_next_ = head;
+  if (head)
+    head->handler_prev_ = dmsg;
+  head = dmsg;
+  dmsgq_.Schedule(dmsg, dmsg->msTrigger_, TimeMillis());
+}
+
+void MessageQueue::RemoveDelayedMessage(DelayedMessage* dmsg) {
+  dmsgq_.Cancel(dmsg);
+  if (dmsg->handler_prev_) {
+    dmsg->handler_prev_->handler_next_ = dmsg->handler_next_;
+  } else if (dmsg->handler_next_) {
+    dmsgs_by_handler_[dmsg->msg_.phandler] = dmsg->handler_next_;
+  } else {
+    dmsgs_by_handler_.erase(dmsg->msg_.phandler);
+  }
+  if (dmsg->handler_next_)
+    dmsg->handler_next_->handler_prev_ = dmsg->handler_prev_;
+  delete dmsg;
 }
 
 void MessageQueue::Dispatch(Message *pmsg) {
@@ -17,6 +17,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -29,6 +30,7 @@
 #include "webrtc/rtc_base/sigslot.h"
 #include "webrtc/rtc_base/socketserver.h"
 #include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/rtc_base/timerwheel.h"
 #include "webrtc/rtc_base/timeutils.h"
 
 namespace rtc {
@@ -170,10 +172,10 @@ struct Message {
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
+// DelayedMessage goes into a timer wheel, keyed by trigger time.  Messages
 // with the same trigger time are processed in num_ (FIFO) order.
 
-class DelayedMessage {
+class DelayedMessage : public TimerWheel::Timer {
  public:
   DelayedMessage(int64_t delay,
                  int64_t trigger,
@@ -190,6 +192,11 @@ class DelayedMessage {
   int64_t msTrigger_;
   uint32_t num_;
   Message msg_;
+
+  // Links of the list of delayed messages with the same handler, so that
+  // Clear() does not have to look at every pending message.
+  DelayedMessage* handler_prev_ = nullptr;
+  DelayedMessage* handler_next_ = nullptr;
 };
 
 class MessageQueue {
@@ -281,12 +288,6 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
-  };
-
   void DoDelayPost(const Location& posted_from,
                    int64_t cmsDelay,
                    int64_t tstamp,
@@ -304,10 +305,19 @@ class MessageQueue {
 
   void WakeUpSocketServer();
 
+  // Add a delayed message to the timer wheel and its handler's list, taking
+  // ownership, or remove and delete it.
+  void AddDelayedMessage(DelayedMessage* dmsg) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void RemoveDelayedMessage(DelayedMessage* dmsg)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   bool fPeekKeep_;
   Message msgPeek_;
   MessageList msgq_ GUARDED_BY(crit_);
-  PriorityQueue dmsgq_ GUARDED_BY(crit_);
+  TimerWheel dmsgq_ GUARDED_BY(crit_);
+  std::unordered_map<MessageHandler*, DelayedMessage*> dmsgs_by_handler_
+      GUARDED_BY(crit_);
+  std::vector<TimerWheel::Timer*> dmsgq_expired_ GUARDED_BY(crit_);
   uint32_t dmsgq_next_num_ GUARDED_BY(crit_);
   CriticalSection crit_;
   bool fInitialized_;
@@ -11,6 +11,7 @@
 #include "webrtc/rtc_base/messagequeue.h"
 
 #include <functional>
+#include <vector>
 
 #include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/bind.h"
@@ -18,10 +19,12 @@
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/nullsocketserver.h"
+#include "webrtc/rtc_base/random.h"
 #include "webrtc/rtc_base/refcount.h"
 #include "webrtc/rtc_base/refcountedobject.h"
 #include "webrtc/rtc_base/thread.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 using namespace rtc;
 
@@ -121,6 +124,39 @@ TEST_F(MessageQueueTest, DiposeHandlerWithPostedMessagePending) {
   EXPECT_TRUE(deleted);
 }
 
+class NullMessageHandler : public MessageHandler {
+ public:
+  void OnMessage(Message* msg) override {}
+};
+
+// Mimics the retransmission timers of many outstanding STUN requests: each
+// request has its own handler with one delayed message, which is cleared when
+// the response arrives.
+TEST_F(MessageQueueTest, DISABLED_DelayedPostAndClearPerf) {
+  const int kNumRequests = 50000;
+  webrtc::Random random(1234);
+  std::vector<NullMessageHandler> handlers(kNumRequests);
+
+  int64_t start_us = TimeMicros();
+  for (NullMessageHandler& handler : handlers)
+    PostDelayed(RTC_FROM_HERE, random.Rand(100, 1600), &handler);
+  int64_t posted_us = TimeMicros();
+  EXPECT_EQ(static_cast<size_t>(kNumRequests), size());
+  for (NullMessageHandler& handler : handlers)
+    Clear(&handler);
+  int64_t cleared_us = TimeMicros();
+  EXPECT_TRUE(empty());
+
+  webrtc::test::PrintResult(
+      "delayed_post", "", "50k_requests",
+      static_cast<size_t>((posted_us - start_us) * 1000 / kNumRequests),
+      "ns/message", false);
+  webrtc::test::PrintResult(
+      "clear", "", "50k_requests",
+      static_cast<size_t>((cleared_us - posted_us) * 1000 / kNumRequests),
+      "ns/message", false);
+}
+
 struct UnwrapMainThreadScope {
   UnwrapMainThreadScope() : rewrap_(Thread::Current() != nullptr) {
     if (rewrap_) ThreadManager::Instance()->UnwrapCurrentThread();
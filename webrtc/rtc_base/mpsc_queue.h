@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_BASE_MPSC_QUEUE_H_
+#define WEBRTC_RTC_BASE_MPSC_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include "webrtc/rtc_base/constructormagic.h"
+
+namespace rtc {
+
+// Unbounded lock-free multiple producer, single consumer FIFO queue. Push()
+// may be called from any thread, Pop() only from one thread at a time.
+//
+// Producers never block each other or the consumer: a push is one allocation
+// and one atomic exchange. Push() reports whether the queue was empty, so that
+// callers can wake up the consumer only on empty to non-empty transitions.
+//
+// T must be default constructible and movable.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_.load()) {}
+  ~MpscQueue() {
+    T value;
+    while (Pop(&value)) {
+    }
+    delete tail_;
+  }
+
+  // Appends |value| to the queue. Returns true if the queue was empty, i.e.
+  // all previously pushed values had already been popped.
+  bool Push(T value) {
+    Node* node = new Node(std::move(value));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+    return size_.fetch_add(1, std::memory_order_acq_rel) == 0;
+  }
+
+  // Moves the oldest value into |value|. Returns false if the queue is empty.
+  // Consumer thread only.
+  bool Pop(T* value) {
+    if (size_.load(std::memory_order_acquire) == 0)
+      return false;
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    while (!next) {
+      // Another producer has claimed the slot before ours but has not linked
+      // it yet. This window is a couple of instructions wide.
+      std::this_thread::yield();
+      next = tail_->next.load(std::memory_order_acquire);
+    }
+    *value = std::move(next->value);
+    delete tail_;
+    tail_ = next;
+    size_.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  }
+
+  bool empty() const { return size_.load(std::memory_order_acquire) == 0; }
+
+ private:
+  struct Node {
+    Node() : next(nullptr) {}
+    explicit Node(T value) : next(nullptr), value(std::move(value)) {}
+    std::atomic<Node*> next;
+    T value;
+  };
+
+  // Most recently pushed node. Written by producers.
+  std::atomic<Node*> head_;
+  // Node preceding the oldest value; its own value has been consumed.
+  // Only touched by the consumer.
+  Node* tail_;
+  std::atomic<size_t> size_{0};
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MpscQueue);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_RTC_BASE_MPSC_QUEUE_H_
@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/mpsc_queue.h"
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/platform_thread.h"
+
+namespace rtc {
+namespace {
+
+constexpr int kValuesPerProducer = 100000;
+
+struct ProducerContext {
+  MpscQueue<int>* queue;
+  int producer_id;
+};
+
+void ProduceValues(void* obj) {
+  ProducerContext* context = static_cast<ProducerContext*>(obj);
+  for (int i = 0; i < kValuesPerProducer; ++i)
+    context->queue->Push(context->producer_id * kValuesPerProducer + i);
+}
+
+}  // namespace
+
+TEST(MpscQueueTest, PopFromEmptyQueue) {
+  MpscQueue<int> queue;
+  int value = 0;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+TEST(MpscQueueTest, FifoOrder) {
+  MpscQueue<int> queue;
+  for (int i = 0; i < 10; ++i)
+    queue.Push(i);
+  EXPECT_FALSE(queue.empty());
+  for (int i = 0; i < 10; ++i) {
+    int value = -1;
+    ASSERT_TRUE(queue.Pop(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, PushReportsEmptyToNonEmptyTransitions) {
+  MpscQueue<int> queue;
+  int value;
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_FALSE(queue.Push(2));
+  ASSERT_TRUE(queue.Pop(&value));
+  EXPECT_FALSE(queue.Push(3));
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_TRUE(queue.Pop(&value));
+  EXPECT_TRUE(queue.Push(4));
+}
+
+TEST(MpscQueueTest, DeletesPendingValues) {
+  std::weak_ptr<int> pending;
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    std::shared_ptr<int> value = std::make_shared<int>(1);
+    pending = value;
+    queue.Push(std::move(value));
+  }
+  EXPECT_TRUE(pending.expired());
+}
+
+TEST(MpscQueueTest, MultipleProducers) {
+  const int kNumProducers = 4;
+  MpscQueue<int> queue;
+  std::vector<ProducerContext> contexts(kNumProducers);
+  std::vector<std::unique_ptr<PlatformThread>> producers;
+  for (int i = 0; i < kNumProducers; ++i) {
+    contexts[i].queue = &queue;
+    contexts[i].producer_id = i;
+    producers.emplace_back(
+        new PlatformThread(&ProduceValues, &contexts[i], "MpscProducer"));
+    producers.back()->Start();
+  }
+
+  // Values from each producer must come out in the order they were pushed.
+  std::vector<int> next_expected(kNumProducers, 0);
+  int received = 0;
+  while (received < kNumProducers * kValuesPerProducer) {
+    int value;
+    if (!queue.Pop(&value))
+      continue;
+    int producer = value / kValuesPerProducer;
+    if (producer >= kNumProducers) {
+      ADD_FAILURE() << "Unexpected value " << value;
+      break;
+    }
+    EXPECT_EQ(next_expected[producer], value % kValuesPerProducer);
+    next_expected[producer] = value % kValuesPerProducer + 1;
+    ++received;
+  }
+  for (auto& producer : producers)
+    producer->Stop();
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace rtc
@@ -35,12 +35,15 @@
 #include <memory>
 
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/networkmonitor.h"
 #include "webrtc/rtc_base/socket.h"  // includes something that makes windows happy
 #include "webrtc/rtc_base/stream.h"
 #include "webrtc/rtc_base/stringencode.h"
 #include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace rtc {
 namespace {
@@ -386,6 +389,7 @@ BasicNetworkManager::~BasicNetworkManager() {
 
 void BasicNetworkManager::OnNetworksChanged() {
   LOG(LS_INFO) << "Network change was observed";
+  InvalidateInterfaceSnapshot();
   UpdateNetworksOnce();
 }
 
@@ -398,69 +402,160 @@ bool BasicNetworkManager::CreateNetworks(bool include_ignored,
   return false;
 }
 
+// static
+void BasicNetworkManager::InvalidateInterfaceSnapshot() {}
+
 #elif defined(WEBRTC_POSIX)
+struct BasicNetworkManager::InterfaceEntry {
+  std::string name;
+  unsigned int flags = 0;
+  InterfaceAddress ip;
+  IPAddress mask;
+  int scope_id = 0;
+};
+
+namespace {
+// A snapshot is enumerated again once it's this old, for the periodic updates
+// to see the changes that no network monitor tells about. A single manager
+// still enumerates the interfaces for each of its updates.
+const int64_t kInterfaceSnapshotMaxAgeMs = kNetworksUpdateIntervalMs / 2;
+
+// The snapshot of the interfaces shared by all the BasicNetworkManagers, so
+// that a burst of them starting, e.g. as many PeerConnections are created,
+// enumerates the interfaces once.
+class InterfaceSnapshot {
+ public:
+  static InterfaceSnapshot* Get() {
+    static InterfaceSnapshot* const snapshot = new InterfaceSnapshot();
+    return snapshot;
+  }
+
+  // Gets the running interface addresses, enumerating them unless the
+  // snapshot is recent enough. Returns false if enumerating them fails.
+  bool GetInterfaces(
+      std::vector<BasicNetworkManager::InterfaceEntry>* entries) {
+    CritScope lock(&crit_);
+    const int64_t now_ms = TimeMillis();
+    if (snapshot_time_ms_ < 0 ||
+        now_ms - snapshot_time_ms_ >= kInterfaceSnapshotMaxAgeMs) {
+      struct ifaddrs* interfaces;
+      int error = getifaddrs(&interfaces);
+      if (error != 0) {
+        LOG_ERR(LERROR) << "getifaddrs failed to gather interface data: "
+                        << error;
+        return false;
+      }
+      std::unique_ptr<IfAddrsConverter> ifaddrs_converter(
+          CreateIfAddrsConverter());
+      entries_.clear();
+      AddInterfaceEntries(interfaces, ifaddrs_converter.get(), &entries_);
+      freeifaddrs(interfaces);
+      snapshot_time_ms_ = now_ms;
+    }
+    *entries = entries_;
+    return true;
+  }
+
+  void Invalidate() {
+    CritScope lock(&crit_);
+    snapshot_time_ms_ = -1;
+  }
+
+  static void AddInterfaceEntries(
+      struct ifaddrs* interfaces,
+      IfAddrsConverter* ifaddrs_converter,
+      std::vector<BasicNetworkManager::InterfaceEntry>* entries) {
+    for (struct ifaddrs* cursor = interfaces; cursor != nullptr;
+         cursor = cursor->ifa_next) {
+      // Some interfaces may not have address assigned.
+      if (!cursor->ifa_addr || !cursor->ifa_netmask) {
+        continue;
+      }
+      // Skip ones which are down.
+      if (!(cursor->ifa_flags & IFF_RUNNING)) {
+        continue;
+      }
+      // Skip unknown family.
+      if (cursor->ifa_addr->sa_family != AF_INET &&
+          cursor->ifa_addr->sa_family != AF_INET6) {
+        continue;
+      }
+      BasicNetworkManager::InterfaceEntry entry;
+      // Convert to InterfaceAddress.
+      if (!ifaddrs_converter->ConvertIfAddrsToIPAddress(cursor, &entry.ip,
+                                                        &entry.mask)) {
+        continue;
+      }
+      if (cursor->ifa_addr->sa_family == AF_INET6) {
+        entry.scope_id =
+            reinterpret_cast<sockaddr_in6*>(cursor->ifa_addr)->sin6_scope_id;
+      }
+      entry.name = cursor->ifa_name;
+      entry.flags = cursor->ifa_flags;
+      entries->push_back(entry);
+    }
+  }
+
+ private:
+  InterfaceSnapshot() : snapshot_time_ms_(-1) {}
+
+  CriticalSection crit_;
+  std::vector<BasicNetworkManager::InterfaceEntry> entries_ GUARDED_BY(crit_);
+  int64_t snapshot_time_ms_ GUARDED_BY(crit_);
+};
+}  // namespace
+
+// static
+void BasicNetworkManager::InvalidateInterfaceSnapshot() {
+  InterfaceSnapshot::Get()->Invalidate();
+}
+
 void BasicNetworkManager::ConvertIfAddrs(struct ifaddrs* interfaces,
                                          IfAddrsConverter* ifaddrs_converter,
                                          bool include_ignored,
                                          NetworkList* networks) const {
+  std::vector<InterfaceEntry> entries;
+  InterfaceSnapshot::AddInterfaceEntries(interfaces, ifaddrs_converter,
+                                         &entries);
+  ConvertInterfaces(entries, include_ignored, networks);
+}
+
+void BasicNetworkManager::ConvertInterfaces(
+    const std::vector<InterfaceEntry>& interfaces,
+    bool include_ignored,
+    NetworkList* networks) const {
   NetworkMap current_networks;
 
-  for (struct ifaddrs* cursor = interfaces; cursor != nullptr;
-       cursor = cursor->ifa_next) {
+  for (const InterfaceEntry& entry : interfaces) {
     IPAddress prefix;
-    IPAddress mask;
-    InterfaceAddress ip;
-    int scope_id = 0;
+    const InterfaceAddress& ip = entry.ip;
 
-    // Some interfaces may not have address assigned.
-    if (!cursor->ifa_addr || !cursor->ifa_netmask) {
-      continue;
-    }
-    // Skip ones which are down.
-    if (!(cursor->ifa_flags & IFF_RUNNING)) {
-      continue;
-    }
-    // Skip unknown family.
-    if (cursor->ifa_addr->sa_family != AF_INET &&
-        cursor->ifa_addr->sa_family != AF_INET6) {
-      continue;
-    }
     // Skip IPv6 if not enabled.
-    if (cursor->ifa_addr->sa_family == AF_INET6 && !ipv6_enabled()) {
-      continue;
-    }
-    // Convert to InterfaceAddress.
-    if (!ifaddrs_converter->ConvertIfAddrsToIPAddress(cursor, &ip, &mask)) {
+    if (ip.family() == AF_INET6 && !ipv6_enabled()) {
       continue;
     }
-
     // Special case for IPv6 address.
-    if (cursor->ifa_addr->sa_family == AF_INET6) {
-      if (IsIgnoredIPv6(ip)) {
-        continue;
-      }
-      scope_id =
-          reinterpret_cast<sockaddr_in6*>(cursor->ifa_addr)->sin6_scope_id;
+    if (IsIgnoredIPv6(ip)) {
+      continue;
     }
 
     AdapterType adapter_type = ADAPTER_TYPE_UNKNOWN;
-    if (cursor->ifa_flags & IFF_LOOPBACK) {
+    if (entry.flags & IFF_LOOPBACK) {
       adapter_type = ADAPTER_TYPE_LOOPBACK;
     } else {
-      adapter_type = GetAdapterTypeFromName(cursor->ifa_name);
+      adapter_type = GetAdapterTypeFromName(entry.name.c_str());
     }
-    int prefix_length = CountIPMaskBits(mask);
+    int prefix_length = CountIPMaskBits(entry.mask);
     prefix = TruncateIP(ip, prefix_length);
-    std::string key = MakeNetworkKey(std::string(cursor->ifa_name),
-                                     prefix, prefix_length);
+    std::string key = MakeNetworkKey(entry.name, prefix, prefix_length);
     auto iter = current_networks.find(key);
     if (iter == current_networks.end()) {
       // TODO(phoglund): Need to recognize other types as well.
       std::unique_ptr<Network> network(
-          new Network(cursor->ifa_name, cursor->ifa_name, prefix, prefix_length,
+          new Network(entry.name, entry.name, prefix, prefix_length,
                       adapter_type));
       network->set_default_local_address_provider(this);
-      network->set_scope_id(scope_id);
+      network->set_scope_id(entry.scope_id);
       network->AddIP(ip);
       network->set_ignored(IsIgnoredNetwork(*network));
       if (include_ignored || !network->ignored()) {
@@ -479,23 +574,18 @@ void BasicNetworkManager::ConvertIfAddrs(struct ifaddrs* interfaces,
 
 bool BasicNetworkManager::CreateNetworks(bool include_ignored,
                                          NetworkList* networks) const {
-  struct ifaddrs* interfaces;
-  int error = getifaddrs(&interfaces);
-  if (error != 0) {
-    LOG_ERR(LERROR) << "getifaddrs failed to gather interface data: " << error;
+  std::vector<InterfaceEntry> interfaces;
+  if (!InterfaceSnapshot::Get()->GetInterfaces(&interfaces))
     return false;
-  }
-
-  std::unique_ptr<IfAddrsConverter> ifaddrs_converter(CreateIfAddrsConverter());
-  ConvertIfAddrs(interfaces, ifaddrs_converter.get(), include_ignored,
-                 networks);
-
-  freeifaddrs(interfaces);
+  ConvertInterfaces(interfaces, include_ignored, networks);
   return true;
 }
 
 #elif defined(WEBRTC_WIN)
 
+// static
+void BasicNetworkManager::InvalidateInterfaceSnapshot() {}
+
 unsigned int GetPrefix(PIP_ADAPTER_PREFIX prefixlist,
               const IPAddress& ip, IPAddress* prefix) {
   IPAddress current_prefix;
@@ -209,9 +209,18 @@ class BasicNetworkManager : public NetworkManagerBase,
                             public MessageHandler,
                             public sigslot::has_slots<> {
  public:
+  // A running interface address, as enumerated from the system. Defined in
+  // network.cc.
+  struct InterfaceEntry;
+
   BasicNetworkManager();
   ~BasicNetworkManager() override;
 
+  // Makes the next network update of any BasicNetworkManager enumerate the
+  // interfaces again, instead of using the snapshot of the interfaces that
+  // all the managers share. Called on network change events.
+  static void InvalidateInterfaceSnapshot();
+
   void StartUpdating() override;
   void StopUpdating() override;
 
@@ -242,6 +251,10 @@ class BasicNetworkManager : public NetworkManagerBase,
                       IfAddrsConverter* converter,
                       bool include_ignored,
                       NetworkList* networks) const;
+  // Creates the networks of the enumerated |interfaces|.
+  void ConvertInterfaces(const std::vector<InterfaceEntry>& interfaces,
+                         bool include_ignored,
+                         NetworkList* networks) const;
 #endif  // defined(WEBRTC_POSIX)
 
   // Creates a network object for each network available on the machine.
@@ -668,6 +668,35 @@ TEST_F(NetworkTest, MAYBE_TestIPv6Toggle) {
   }
 }
 
+// Test that managers enumerating the interfaces from the snapshot they share
+// still apply their own settings to them.
+TEST_F(NetworkTest, TestInterfaceSnapshotKeepsSettingsPerManager) {
+  BasicNetworkManager manager;
+  NetworkManager::NetworkList list = GetNetworks(manager, true);
+  ASSERT_FALSE(list.empty());
+  const std::string name = list[0]->name();
+  const bool ignored = list[0]->ignored();
+  for (Network* network : list)
+    delete network;
+
+  BasicNetworkManager ignoring_manager;
+  ignoring_manager.set_network_ignore_list({name});
+  list = GetNetworks(ignoring_manager, true);
+  for (Network* network : list) {
+    if (network->name() == name)
+      EXPECT_TRUE(network->ignored());
+    delete network;
+  }
+
+  BasicNetworkManager::InvalidateInterfaceSnapshot();
+  list = GetNetworks(manager, true);
+  ASSERT_FALSE(list.empty());
+  EXPECT_EQ(name, list[0]->name());
+  EXPECT_EQ(ignored, list[0]->ignored());
+  for (Network* network : list)
+    delete network;
+}
+
 // Test that when network interfaces are sorted and given preference values,
 // IPv6 comes first.
 TEST_F(NetworkTest, IPv6NetworksPreferredOverIPv4) {
@@ -26,6 +26,7 @@
 #include <poll.h>
 #endif
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/select.h>
 #include <unistd.h>
@@ -53,6 +54,16 @@
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/win32socketinit.h"
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// recvmmsg()/sendmmsg() are available in glibc; Android's bionic only has them
+// on newer API levels, so it keeps the generic one-datagram-per-call path.
+#define WEBRTC_USE_MMSG 1
+#include <netinet/udp.h>
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103  // From linux/udp.h, for kernels >= 4.18.
+#endif
+#endif
+
 #if defined(WEBRTC_POSIX)
 #include <netinet/tcp.h>  // for TCP_NODELAY
 #define IP_MTU 14 // Until this is integrated from linux/in.h to netinet/in.h
@@ -387,6 +398,120 @@ int PhysicalSocket::SendTo(const void* buffer,
   return sent;
 }
 
+int PhysicalSocket::SendToBatch(const OutgoingDatagram* datagrams,
+                                size_t count) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_ || count <= 1)
+    return AsyncSocket::SendToBatch(datagrams, count);
+
+  size_t sent = 0;
+  while (sent < count) {
+    size_t chunk = std::min(count - sent, kMaxSendBatchSize);
+    int result = SendSegmented(datagrams + sent, chunk);
+    if (result == kSegmentationUnsupported)
+      result = SendMultiple(datagrams + sent, chunk);
+    if (result <= 0)
+      break;
+    sent += result;
+    if (static_cast<size_t>(result) < chunk)
+      break;
+  }
+  MaybeRemapSendError();
+  if (sent < count && IsBlockingError(GetError()))
+    EnableEvents(DE_WRITE);
+  return (sent == 0) ? SOCKET_ERROR : static_cast<int>(sent);
+#else
+  return AsyncSocket::SendToBatch(datagrams, count);
+#endif
+}
+
+#if defined(WEBRTC_USE_MMSG)
+int PhysicalSocket::SendMultiple(const OutgoingDatagram* datagrams,
+                                 size_t count) {
+  RTC_DCHECK_LE(count, kMaxSendBatchSize);
+  mmsghdr msgs[kMaxSendBatchSize];
+  iovec iovs[kMaxSendBatchSize];
+  sockaddr_storage addrs[kMaxSendBatchSize];
+  memset(msgs, 0, sizeof(msgs[0]) * count);
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = const_cast<char*>(datagrams[i].data);
+    iovs[i].iov_len = datagrams[i].length;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen =
+        static_cast<socklen_t>(datagrams[i].address.ToSockAddrStorage(&addrs[i]));
+  }
+  // Suppress SIGPIPE. See PhysicalSocket::Send for explanation.
+  int sent = ::sendmmsg(s_, msgs, static_cast<unsigned int>(count),
+                        MSG_NOSIGNAL);
+  UpdateLastError();
+  return sent;
+}
+
+int PhysicalSocket::SendSegmented(const OutgoingDatagram* datagrams,
+                                  size_t count) {
+  // UDP GSO needs a single destination and equally sized segments; only the
+  // last one may be shorter.
+  if (udp_segmentation_unsupported_)
+    return kSegmentationUnsupported;
+  const size_t segment_size = datagrams[0].length;
+  size_t total_size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const bool last = (i == count - 1);
+    if (datagrams[i].address != datagrams[0].address ||
+        (last ? datagrams[i].length > segment_size
+              : datagrams[i].length != segment_size)) {
+      return kSegmentationUnsupported;
+    }
+    total_size += datagrams[i].length;
+  }
+  if (segment_size == 0 || total_size > kMaxSegmentedPayloadSize)
+    return kSegmentationUnsupported;
+
+  segmentation_buffer_.resize(total_size);
+  size_t offset = 0;
+  for (size_t i = 0; i < count; ++i) {
+    memcpy(&segmentation_buffer_[offset], datagrams[i].data,
+           datagrams[i].length);
+    offset += datagrams[i].length;
+  }
+
+  sockaddr_storage addr;
+  iovec iov;
+  iov.iov_base = segmentation_buffer_.data();
+  iov.iov_len = total_size;
+  char control[CMSG_SPACE(sizeof(uint16_t))];
+  memset(control, 0, sizeof(control));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = &addr;
+  msg.msg_namelen =
+      static_cast<socklen_t>(datagrams[0].address.ToSockAddrStorage(&addr));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  uint16_t gso_size = static_cast<uint16_t>(segment_size);
+  memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+  ssize_t sent = ::sendmsg(s_, &msg, MSG_NOSIGNAL);
+  if (sent < 0 && (errno == EINVAL || errno == EIO || errno == ENOPROTOOPT ||
+                   errno == EOPNOTSUPP)) {
+    // The kernel or the outgoing device doesn't support UDP GSO.
+    LOG(LS_INFO) << "UDP segmentation offload not available, errno=" << errno;
+    udp_segmentation_unsupported_ = true;
+    return kSegmentationUnsupported;
+  }
+  UpdateLastError();
+  return sent < 0 ? SOCKET_ERROR : static_cast<int>(count);
+}
+#endif  // WEBRTC_USE_MMSG
+
 int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   int received = ::recv(s_, static_cast<char*>(buffer),
                         static_cast<int>(length), 0);
@@ -442,6 +567,50 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+const size_t PhysicalSocket::kMaxRecvBatchSize;
+const size_t PhysicalSocket::kMaxSendBatchSize;
+
+int PhysicalSocket::RecvFromBatch(DatagramBuffer* buffers, size_t count) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_ || count <= 1)
+    return AsyncSocket::RecvFromBatch(buffers, count);
+  count = std::min(count, kMaxRecvBatchSize);
+
+  mmsghdr msgs[kMaxRecvBatchSize];
+  iovec iovs[kMaxRecvBatchSize];
+  sockaddr_storage addrs[kMaxRecvBatchSize];
+  memset(msgs, 0, sizeof(msgs[0]) * count);
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = buffers[i].data;
+    iovs[i].iov_len = buffers[i].capacity;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+  }
+  // MSG_TRUNC makes msg_len report the real datagram size, so that callers
+  // can detect datagrams that did not fit in their slot.
+  int received = ::recvmmsg(s_, msgs, static_cast<unsigned int>(count),
+                            MSG_TRUNC, nullptr);
+  // The ioctl timestamp is only valid for the most recent datagram.
+  int64_t timestamp = received > 0 ? GetSocketRecvTimestamp(s_) : -1;
+  UpdateLastError();
+  for (int i = 0; i < received; ++i) {
+    buffers[i].length = msgs[i].msg_len;
+    SocketAddressFromSockAddrStorage(addrs[i], &buffers[i].address);
+    buffers[i].timestamp = (i == received - 1) ? timestamp : -1;
+  }
+  int error = GetError();
+  if (received < 0 && !IsBlockingError(error)) {
+    LOG_F(LS_VERBOSE) << "Error = " << error;
+  }
+  EnableEvents(DE_READ);
+  return received;
+#else
+  return AsyncSocket::RecvFromBatch(buffers, count);
+#endif
+}
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -583,6 +752,15 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
     case OPT_DSCP:
       LOG(LS_WARNING) << "Socket::OPT_DSCP not supported.";
       return -1;
+    case OPT_REUSEPORT:
+#if defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
+#endif
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
     default:
@@ -136,6 +136,9 @@ class PhysicalSocketServer : public SocketServer {
 
 class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
  public:
+  static const size_t kMaxRecvBatchSize = 64;
+  static const size_t kMaxSendBatchSize = 64;
+
   PhysicalSocket(PhysicalSocketServer* ss, SOCKET s = INVALID_SOCKET);
   ~PhysicalSocket() override;
 
@@ -160,12 +163,19 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   int SendTo(const void* buffer,
              size_t length,
              const SocketAddress& addr) override;
+  // Uses a single UDP GSO (UDP_SEGMENT) send when all datagrams go to the
+  // same destination with the same size, and sendmmsg() otherwise. Only
+  // available for UDP sockets on Linux.
+  int SendToBatch(const OutgoingDatagram* datagrams, size_t count) override;
 
   int Recv(void* buffer, size_t length, int64_t* timestamp) override;
   int RecvFrom(void* buffer,
                size_t length,
                SocketAddress* out_addr,
                int64_t* timestamp) override;
+  // Uses recvmmsg() for UDP sockets on Linux, reading at most
+  // |kMaxRecvBatchSize| datagrams per call.
+  int RecvFromBatch(DatagramBuffer* buffers, size_t count) override;
 
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
@@ -212,6 +222,19 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 #endif
 
  private:
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  static const int kSegmentationUnsupported = -2;
+  static const size_t kMaxSegmentedPayloadSize = 65000;
+
+  int SendMultiple(const OutgoingDatagram* datagrams, size_t count);
+  // Returns kSegmentationUnsupported if |datagrams| can't be sent as one
+  // segmented buffer.
+  int SendSegmented(const OutgoingDatagram* datagrams, size_t count);
+
+  bool udp_segmentation_unsupported_ = false;
+  std::vector<char> segmentation_buffer_;
+#endif
+
   uint8_t enabled_events_ = 0;
 };
 
@@ -12,6 +12,8 @@
 #include <signal.h>
 #include <stdarg.h>
 
+#include "webrtc/rtc_base/arraysize.h"
+#include "webrtc/rtc_base/asyncudpsocket.h"
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/networkmonitor.h"
@@ -498,6 +500,233 @@ TEST_F(PhysicalSocketTest,
   server_->set_network_binder(nullptr);
 }
 
+TEST_F(PhysicalSocketTest, RecvFromBatchReadsAllPendingDatagrams) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const int kNumPackets = 5;
+  for (int i = 0; i < kNumPackets; ++i) {
+    char payload[4] = {'a', 'b', 'c', static_cast<char>('0' + i)};
+    ASSERT_EQ(static_cast<int>(sizeof(payload)),
+              sender->SendTo(payload, sizeof(payload),
+                             receiver->GetLocalAddress()));
+  }
+
+  char storage[8][16];
+  DatagramBuffer buffers[8];
+  for (size_t i = 0; i < arraysize(buffers); ++i) {
+    buffers[i].data = storage[i];
+    buffers[i].capacity = sizeof(storage[i]);
+  }
+  int received = 0;
+  // Datagrams on the loopback interface may not all be queued at once.
+  for (int attempt = 0; attempt < 100 && received < kNumPackets; ++attempt) {
+    int count = receiver->RecvFromBatch(buffers + received,
+                                        arraysize(buffers) - received);
+    if (count < 0) {
+      EXPECT_TRUE(receiver->IsBlocking());
+      Thread::Current()->SleepMs(1);
+      continue;
+    }
+    received += count;
+  }
+  ASSERT_EQ(kNumPackets, received);
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(4u, buffers[i].length);
+    EXPECT_EQ('0' + i, buffers[i].data[3]);
+    EXPECT_EQ(sender->GetLocalAddress(), buffers[i].address);
+  }
+}
+
+class BatchedReadPacketSink : public sigslot::has_slots<> {
+ public:
+  void OnReadPacketBatch(AsyncPacketSocket* socket,
+                         ArrayView<const ReceivedPacket> packets) {
+    ++num_batches_;
+    for (const ReceivedPacket& packet : packets)
+      payloads_.push_back(std::string(packet.data, packet.size));
+  }
+
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_address,
+                    const PacketTime& packet_time) {
+    payloads_.push_back(std::string(data, size));
+  }
+
+  int num_batches_ = 0;
+  std::vector<std::string> payloads_;
+};
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketDeliversBatches) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  receiver->SetRecvBatchSize(16);
+  BatchedReadPacketSink sink;
+  receiver->SignalReadPacketBatch.connect(
+      &sink, &BatchedReadPacketSink::OnReadPacketBatch);
+
+  const std::string kPayloads[] = {"one", "two", "three"};
+  for (const std::string& payload : kPayloads) {
+    sender->SendTo(payload.data(), payload.size(),
+                   receiver->GetLocalAddress(), PacketOptions());
+  }
+  EXPECT_EQ_WAIT(arraysize(kPayloads), sink.payloads_.size(), 1000);
+  EXPECT_LE(sink.num_batches_, static_cast<int>(arraysize(kPayloads)));
+  for (size_t i = 0; i < sink.payloads_.size(); ++i)
+    EXPECT_EQ(kPayloads[i], sink.payloads_[i]);
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketBatchFallsBackToReadPacket) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  receiver->SetRecvBatchSize(16);
+  BatchedReadPacketSink sink;
+  receiver->SignalReadPacket.connect(&sink,
+                                     &BatchedReadPacketSink::OnReadPacket);
+
+  // A datagram larger than a batch slot is dropped.
+  std::string oversized(AsyncUDPSocket::kMaxBatchedPacketSize + 1, 'x');
+  sender->SendTo(oversized.data(), oversized.size(),
+                 receiver->GetLocalAddress(), PacketOptions());
+  sender->SendTo("hello", 5, receiver->GetLocalAddress(), PacketOptions());
+  EXPECT_EQ_WAIT(1u, sink.payloads_.size(), 1000);
+  EXPECT_EQ("hello", sink.payloads_[0]);
+  EXPECT_EQ(0, sink.num_batches_);
+}
+
+// Prepends a header to each packet in the headroom of the socket.
+class HeadroomWriter : public sigslot::has_slots<> {
+ public:
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_address,
+                    const PacketTime& packet_time) {
+    char* message = const_cast<char*>(data) - 2;
+    message[0] = '[';
+    message[1] = ':';
+    messages_.push_back(std::string(message, size + 2));
+  }
+
+  std::vector<std::string> messages_;
+};
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketReservesHeadroom) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  EXPECT_TRUE(receiver->SetReceiveHeadroom(2));
+  HeadroomWriter writer;
+  receiver->SignalReadPacket.connect(&writer, &HeadroomWriter::OnReadPacket);
+
+  sender->SendTo("one", 3, receiver->GetLocalAddress(), PacketOptions());
+  EXPECT_EQ_WAIT(1u, writer.messages_.size(), 1000);
+  // Every slot of a batch has its own headroom.
+  receiver->SetRecvBatchSize(16);
+  sender->SendTo("two", 3, receiver->GetLocalAddress(), PacketOptions());
+  sender->SendTo("three", 5, receiver->GetLocalAddress(), PacketOptions());
+  EXPECT_EQ_WAIT(3u, writer.messages_.size(), 1000);
+  EXPECT_EQ("[:one", writer.messages_[0]);
+  EXPECT_EQ("[:two", writer.messages_[1]);
+  EXPECT_EQ("[:three", writer.messages_[2]);
+}
+
+class SentPacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& packet) {
+    packet_ids_.push_back(packet.packet_id);
+  }
+
+  std::vector<int> packet_ids_;
+};
+
+// Sends |payloads| in one batch from a new socket and expects |receivers| to
+// get them, in order, with receiver |i % receivers.size()| getting packet |i|.
+static void SendBatchAndVerify(
+    SocketServer* ss,
+    const IPAddress& loopback,
+    const std::vector<std::string>& payloads,
+    const std::vector<BatchedReadPacketSink*>& sinks,
+    const std::vector<AsyncUDPSocket*>& receivers) {
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(ss, SocketAddress(loopback, 0)));
+  ASSERT_TRUE(sender);
+  SentPacketCounter counter;
+  sender->SignalSentPacket.connect(&counter, &SentPacketCounter::OnSentPacket);
+
+  std::vector<OutgoingPacket> packets;
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    PacketOptions options;
+    options.packet_id = static_cast<int>(i);
+    packets.push_back(
+        {payloads[i].data(), payloads[i].size(),
+         receivers[i % receivers.size()]->GetLocalAddress(), options});
+  }
+  EXPECT_EQ(static_cast<int>(payloads.size()), sender->SendToBatch(packets));
+  ASSERT_EQ(payloads.size(), counter.packet_ids_.size());
+  for (size_t i = 0; i < payloads.size(); ++i)
+    EXPECT_EQ(static_cast<int>(i), counter.packet_ids_[i]);
+
+  for (size_t r = 0; r < sinks.size(); ++r) {
+    size_t expected = (payloads.size() + sinks.size() - 1 - r) / sinks.size();
+    EXPECT_EQ_WAIT(expected, sinks[r]->payloads_.size(), 1000);
+    for (size_t i = 0; i < sinks[r]->payloads_.size(); ++i)
+      EXPECT_EQ(payloads[r + i * sinks.size()], sinks[r]->payloads_[i]);
+  }
+}
+
+TEST_F(PhysicalSocketTest, SendToBatchSameDestination) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver);
+  BatchedReadPacketSink sink;
+  receiver->SignalReadPacket.connect(&sink,
+                                     &BatchedReadPacketSink::OnReadPacket);
+  // Equally sized packets with a shorter tail qualify for UDP segmentation.
+  SendBatchAndVerify(server_.get(), kIPv4Loopback, {"aaaa", "bbbb", "cccc", "dd"}, {&sink},
+                     {receiver.get()});
+}
+
+TEST_F(PhysicalSocketTest, SendToBatchMultipleDestinations) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver1(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver2(
+      AsyncUDPSocket::Create(server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver1);
+  ASSERT_TRUE(receiver2);
+  BatchedReadPacketSink sink1;
+  BatchedReadPacketSink sink2;
+  receiver1->SignalReadPacket.connect(&sink1,
+                                      &BatchedReadPacketSink::OnReadPacket);
+  receiver2->SignalReadPacket.connect(&sink2,
+                                      &BatchedReadPacketSink::OnReadPacket);
+  SendBatchAndVerify(server_.get(), kIPv4Loopback, {"one", "two", "three", "four", "five"},
+                     {&sink1, &sink2}, {receiver1.get(), receiver2.get()});
+}
+
 class PosixSignalDeliveryTest : public testing::Test {
  public:
   static void RecordSignal(int signum) {
@@ -15,6 +15,9 @@
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
 
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+#include <sched.h>
+#endif
 #if defined(WEBRTC_LINUX)
 #include <sys/prctl.h>
 #include <sys/syscall.h>
@@ -79,6 +82,34 @@ void SetCurrentThreadName(const char* name) {
 #endif
 }
 
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+  if (cpus.empty())
+    return false;
+#if defined(WEBRTC_WIN)
+  DWORD_PTR mask = 0;
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= static_cast<int>(sizeof(mask) * 8))
+      return false;
+    mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+  return ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0;
+#elif defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+      return false;
+    CPU_SET(cpu, &cpu_set);
+  }
+  // A pid of 0 refers to the calling thread.
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  // Mac and iOS only support affinity hints between threads, not placement on
+  // specific CPUs.
+  return false;
+#endif
+}
+
 namespace {
 #if defined(WEBRTC_WIN)
 void CALLBACK RaiseFlag(ULONG_PTR param) {
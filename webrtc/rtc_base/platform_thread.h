@@ -12,6 +12,7 @@
 #define WEBRTC_RTC_BASE_PLATFORM_THREAD_H_
 
 #include <string>
+#include <vector>
 
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/event.h"
@@ -29,6 +30,13 @@ bool IsThreadRefEqual(const PlatformThreadRef& a, const PlatformThreadRef& b);
 // Sets the current thread name.
 void SetCurrentThreadName(const char* name);
 
+// Restricts the calling thread to the given logical CPUs, e.g. the CPUs of one
+// NUMA node as reported by webrtc::CpuInfo::DetectNumaNodeCpus(). Threads that
+// are not created by the caller, such as task queues, can apply this from a
+// task posted to them. Returns false if the set is empty or invalid, or if the
+// platform does not support thread affinity.
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
 // Callback function that the spawned thread will enter once spawned.
 // A return value of false is interpreted as that the function has no
 // more work to do and that the thread can be released.
@@ -10,6 +10,10 @@
 
 #include "webrtc/rtc_base/platform_thread.h"
 
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/gtest.h"
 
@@ -41,6 +45,21 @@ void SetFlagRunFunction(void* obj) {
   *obj_as_bool = true;
 }
 
+#if defined(WEBRTC_LINUX)
+// Pins the thread to the first CPU it is allowed to run on and reports whether
+// it ended up running there.
+void PinToFirstAllowedCpuRunFunction(void* obj) {
+  bool* obj_as_bool = static_cast<bool*>(obj);
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return;
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed))
+    ++cpu;
+  *obj_as_bool = SetCurrentThreadAffinity({cpu}) && sched_getcpu() == cpu;
+}
+#endif
+
 }  // namespace
 
 TEST(PlatformThreadTest, StartStopDeprecated) {
@@ -113,6 +132,22 @@ TEST(PlatformThreadTest, RunFunctionIsCalled) {
   EXPECT_TRUE(flag);
 }
 
+TEST(PlatformThreadTest, SetCurrentThreadAffinityRejectsEmptySet) {
+  EXPECT_FALSE(SetCurrentThreadAffinity({}));
+  EXPECT_FALSE(SetCurrentThreadAffinity({-1}));
+}
+
+#if defined(WEBRTC_LINUX)
+TEST(PlatformThreadTest, SetCurrentThreadAffinity) {
+  bool pinned = false;
+  PlatformThread thread(&PinToFirstAllowedCpuRunFunction, &pinned,
+                        "SetCurrentThreadAffinity");
+  thread.Start();
+  thread.Stop();
+  EXPECT_TRUE(pinned);
+}
+#endif
+
 // This test is disabled since it will cause a crash.
 // There might be a way to implement this as a death test, but it looks like
 // a death test requires an expression to be checked but does not allow a
@@ -28,6 +28,13 @@ class RateStatistics {
   // scale = coefficient to convert counts/ms to desired unit
   //         ex: kBpsScale (8000) for bits/s if count represents bytes.
   RateStatistics(int64_t max_window_size_ms, float scale);
+  // As above, but with samples counted in buckets of |bucket_size_ms|, so that
+  // long windows need fewer buckets to be kept and erased. A bucket is only
+  // erased once all of it has left the window, so the rate may include up to
+  // |bucket_size_ms| - 1 ms of older data.
+  RateStatistics(int64_t max_window_size_ms,
+                 float scale,
+                 int64_t bucket_size_ms);
   ~RateStatistics();
 
   // Reset instance to original state.
@@ -51,9 +58,11 @@ class RateStatistics {
  private:
   void EraseOld(int64_t now_ms);
   bool IsInitialized() const;
+  // Returns the number of the bucket that |time_ms| falls in.
+  int64_t BucketTime(int64_t time_ms) const;
 
   // Counters are kept in buckets (circular buffer), with one bucket
-  // per millisecond.
+  // per |bucket_size_ms_|.
   struct Bucket {
     size_t sum;      // Sum of all samples in this bucket.
     size_t samples;  // Number of samples in this bucket.
@@ -69,8 +78,10 @@ class RateStatistics {
   // Oldest time recorded in buckets.
   int64_t oldest_time_;
 
-  // Bucket index of oldest counter recorded in buckets.
+  // Bucket index of oldest counter recorded in buckets, and the number of the
+  // bucket that it holds.
   uint32_t oldest_index_;
+  int64_t oldest_bucket_time_;
 
   // To convert counts/ms to desired units
   const float scale_;
@@ -78,6 +89,9 @@ class RateStatistics {
   // The window sizes, in ms, over which the rate is calculated.
   const int64_t max_window_size_ms_;
   int64_t current_window_size_ms_;
+
+  const int64_t bucket_size_ms_;
+  const int64_t num_buckets_;
 };
 }  // namespace webrtc
 
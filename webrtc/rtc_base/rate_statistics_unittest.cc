@@ -9,9 +9,12 @@
  */
 
 #include <algorithm>
+#include <string>
 
 #include "webrtc/rtc_base/rate_statistics.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace {
 
@@ -277,4 +280,73 @@ TEST_F(RateStatisticsTest, HandlesQuietPeriods) {
   EXPECT_TRUE(static_cast<bool>(bitrate));
   EXPECT_EQ(0u, *bitrate);
 }
+
+TEST(RateStatisticsCoarseTest, EstimatesRateWithCoarseBuckets) {
+  const int64_t kBucketSizeMs = 10;
+  RateStatistics stats(kWindowMs, 8000, kBucketSizeMs);
+  const uint32_t kPacketSize = 1500u;
+  const uint32_t kExpectedRateBps = kPacketSize * 1000 * 8 / 5;
+  int64_t now_ms = 0;
+  for (; now_ms < 4 * kWindowMs; now_ms += 5)
+    stats.Update(kPacketSize, now_ms);
+  // A bucket is kept until all of it has left the window, so the rate may
+  // include up to one extra bucket of data.
+  rtc::Optional<uint32_t> rate = stats.Rate(now_ms);
+  ASSERT_TRUE(static_cast<bool>(rate));
+  EXPECT_GE(*rate, kExpectedRateBps);
+  EXPECT_LE(*rate, kExpectedRateBps * (kWindowMs + kBucketSizeMs) / kWindowMs);
+
+  // Once the window has passed, all of the data is gone.
+  now_ms += kWindowMs + kBucketSizeMs;
+  EXPECT_FALSE(static_cast<bool>(stats.Rate(now_ms)));
+
+  // Updates after the quiet period are averaged over the whole window.
+  stats.Update(kPacketSize, now_ms);
+  stats.Update(kPacketSize, now_ms + 1);
+  rate = stats.Rate(now_ms + 1);
+  ASSERT_TRUE(static_cast<bool>(rate));
+  EXPECT_EQ(2 * kPacketSize * 8000 / kWindowMs, *rate);
+}
+
+TEST(RateStatisticsCoarseTest, HandlesChangingWindowSize) {
+  RateStatistics stats(kWindowMs, 8000, 10);
+  int64_t now_ms = 0;
+  for (; now_ms < kWindowMs; now_ms += 10)
+    stats.Update(1000, now_ms);
+  EXPECT_TRUE(stats.SetWindowSize(kWindowMs / 5, now_ms));
+  rtc::Optional<uint32_t> rate = stats.Rate(now_ms);
+  ASSERT_TRUE(static_cast<bool>(rate));
+  EXPECT_NEAR(800000u, *rate, 800000u / 10);
+  EXPECT_FALSE(stats.SetWindowSize(kWindowMs + 1, now_ms));
+  EXPECT_TRUE(stats.SetWindowSize(kWindowMs, now_ms));
+  for (; now_ms < 3 * kWindowMs; now_ms += 10)
+    stats.Update(1000, now_ms);
+  rate = stats.Rate(now_ms);
+  ASSERT_TRUE(static_cast<bool>(rate));
+  EXPECT_NEAR(800000u, *rate, 800000u / 20);
+}
+
+TEST(RateStatisticsCoarseTest, DISABLED_UpdatePerf) {
+  const int64_t kPerfWindowMs = 1000;
+  const int kNumUpdates = 2000000;
+  for (int64_t bucket_size_ms : {1, 5, 10, 25}) {
+    RateStatistics stats(kPerfWindowMs, 8000, bucket_size_ms);
+    uint32_t rate_sum = 0;
+    int64_t now_ms = 0;
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumUpdates; ++i) {
+      // Bursts of packets, followed by a quiet period every second.
+      now_ms += (i % 100 == 99) ? 400 : 1 + i % 3;
+      stats.Update(1200, now_ms);
+      rate_sum += stats.Rate(now_ms).value_or(0);
+    }
+    int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    // Keeps the loop from being optimized away.
+    EXPECT_NE(0u, rate_sum);
+    webrtc::test::PrintResult(
+        "rate_statistics", "_update_and_rate",
+        "bucket_" + std::to_string(bucket_size_ms) + "_ms",
+        static_cast<size_t>(elapsed_ns / kNumUpdates), "ns", false);
+  }
+}
 }  // namespace
@@ -14,7 +14,9 @@
 #include <memory>
 
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/sslidentity.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace rtc {
 
@@ -54,6 +56,12 @@ class RTCCertificateGenerationTask : public RefCountInterface,
   }
   ~RTCCertificateGenerationTask() override {}
 
+  // Sets the result up front, for a task that is posted as
+  // |MSG_GENERATE_DONE| without generating a certificate.
+  void set_certificate(const scoped_refptr<RTCCertificate>& certificate) {
+    certificate_ = certificate;
+  }
+
   // Handles |MSG_GENERATE| and its follow-up |MSG_GENERATE_DONE|.
   void OnMessage(Message* msg) override {
     switch (msg->message_id) {
@@ -98,8 +106,134 @@ class RTCCertificateGenerationTask : public RefCountInterface,
   scoped_refptr<RTCCertificate> certificate_;
 };
 
+bool KeyParamsEqual(const KeyParams& a, const KeyParams& b) {
+  if (a.type() != b.type())
+    return false;
+  if (a.type() == KT_RSA) {
+    return a.rsa_params().mod_size == b.rsa_params().mod_size &&
+           a.rsa_params().pub_exp == b.rsa_params().pub_exp;
+  }
+  return a.ec_curve() == b.ec_curve();
+}
+
+// Posts a task for a generation request to the worker thread, or straight to
+// the signaling thread if |certificate| already is the result.
+void PostGenerationTask(
+    Thread* signaling_thread,
+    Thread* worker_thread,
+    const KeyParams& key_params,
+    const Optional<uint64_t>& expires_ms,
+    const scoped_refptr<RTCCertificate>& certificate,
+    const scoped_refptr<RTCCertificateGeneratorCallback>& callback) {
+  // The task is reference counted and referenced by the message data, ensuring
+  // it lives until it has completed (independent of whoever posted it).
+  ScopedRefMessageData<RTCCertificateGenerationTask>* msg_data =
+      new ScopedRefMessageData<RTCCertificateGenerationTask>(
+          new RefCountedObject<RTCCertificateGenerationTask>(
+              signaling_thread, worker_thread, key_params, expires_ms,
+              callback));
+  if (certificate) {
+    msg_data->data()->set_certificate(certificate);
+    signaling_thread->Post(RTC_FROM_HERE, msg_data->data().get(),
+                           MSG_GENERATE_DONE, msg_data);
+  } else {
+    worker_thread->Post(RTC_FROM_HERE, msg_data->data().get(), MSG_GENERATE,
+                        msg_data);
+  }
+}
+
 }  // namespace
 
+class RTCCertificatePool::RefillCallback
+    : public RTCCertificateGeneratorCallback {
+ public:
+  explicit RefillCallback(const scoped_refptr<RTCCertificatePool>& pool)
+      : pool_(pool) {}
+
+  void OnSuccess(const scoped_refptr<RTCCertificate>& certificate) override {
+    pool_->OnGenerated(certificate);
+  }
+  void OnFailure() override { pool_->OnGenerated(nullptr); }
+
+ private:
+  // Keeps the pool alive until the generation has completed.
+  const scoped_refptr<RTCCertificatePool> pool_;
+};
+
+// static
+scoped_refptr<RTCCertificatePool> RTCCertificatePool::Create(
+    Thread* signaling_thread,
+    Thread* worker_thread,
+    const KeyParams& key_params,
+    size_t size) {
+  scoped_refptr<RTCCertificatePool> pool(
+      new RefCountedObject<RTCCertificatePool>(signaling_thread, worker_thread,
+                                               key_params, size));
+  pool->Refill();
+  return pool;
+}
+
+RTCCertificatePool::RTCCertificatePool(Thread* signaling_thread,
+                                       Thread* worker_thread,
+                                       const KeyParams& key_params,
+                                       size_t size)
+    : signaling_thread_(signaling_thread),
+      worker_thread_(worker_thread),
+      key_params_(key_params),
+      size_(size) {
+  RTC_DCHECK(signaling_thread_);
+  RTC_DCHECK(worker_thread_);
+}
+
+RTCCertificatePool::~RTCCertificatePool() {}
+
+size_t RTCCertificatePool::available() const {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  return certificates_.size();
+}
+
+scoped_refptr<RTCCertificate> RTCCertificatePool::Take(
+    const KeyParams& key_params) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  if (!KeyParamsEqual(key_params, key_params_))
+    return nullptr;
+  const uint64_t now_ms = TimeUTCMicros() / kNumMicrosecsPerMillisec;
+  scoped_refptr<RTCCertificate> certificate;
+  while (!certificate && !certificates_.empty()) {
+    // The oldest certificate expires first.
+    if (!certificates_.front()->HasExpired(now_ms))
+      certificate = certificates_.front();
+    certificates_.pop_front();
+  }
+  Refill();
+  return certificate;
+}
+
+void RTCCertificatePool::Refill() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  scoped_refptr<RefillCallback> callback;
+  for (; certificates_.size() + pending_ < size_; ++pending_) {
+    if (!callback)
+      callback = new RefCountedObject<RefillCallback>(this);
+    PostGenerationTask(signaling_thread_, worker_thread_, key_params_,
+                       Optional<uint64_t>(), nullptr, callback);
+  }
+}
+
+void RTCCertificatePool::OnGenerated(
+    const scoped_refptr<RTCCertificate>& certificate) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK_GT(pending_, 0u);
+  --pending_;
+  // A failure isn't retried here, as it would most likely fail again; the next
+  // Take will.
+  if (!certificate) {
+    LOG(LS_WARNING) << "Failed to generate a pooled certificate.";
+    return;
+  }
+  certificates_.push_back(certificate);
+}
+
 // static
 scoped_refptr<RTCCertificate>
 RTCCertificateGenerator::GenerateCertificate(
@@ -132,8 +266,15 @@ RTCCertificateGenerator::GenerateCertificate(
 
 RTCCertificateGenerator::RTCCertificateGenerator(
     Thread* signaling_thread, Thread* worker_thread)
+    : RTCCertificateGenerator(signaling_thread, worker_thread, nullptr) {}
+
+RTCCertificateGenerator::RTCCertificateGenerator(
+    Thread* signaling_thread,
+    Thread* worker_thread,
+    const scoped_refptr<RTCCertificatePool>& pool)
     : signaling_thread_(signaling_thread),
-      worker_thread_(worker_thread) {
+      worker_thread_(worker_thread),
+      pool_(pool) {
   RTC_DCHECK(signaling_thread_);
   RTC_DCHECK(worker_thread_);
 }
@@ -145,16 +286,13 @@ void RTCCertificateGenerator::GenerateCertificateAsync(
   RTC_DCHECK(signaling_thread_->IsCurrent());
   RTC_DCHECK(callback);
 
-  // Create a new |RTCCertificateGenerationTask| for this generation request. It
-  // is reference counted and referenced by the message data, ensuring it lives
-  // until the task has completed (independent of |RTCCertificateGenerator|).
-  ScopedRefMessageData<RTCCertificateGenerationTask>* msg_data =
-      new ScopedRefMessageData<RTCCertificateGenerationTask>(
-          new RefCountedObject<RTCCertificateGenerationTask>(
-              signaling_thread_, worker_thread_, key_params, expires_ms,
-              callback));
-  worker_thread_->Post(RTC_FROM_HERE, msg_data->data().get(), MSG_GENERATE,
-                       msg_data);
+  // Pooled certificates have the default expiration time. The callback is
+  // still invoked asynchronously when one is used, as callers expect.
+  scoped_refptr<RTCCertificate> certificate;
+  if (pool_ && !expires_ms)
+    certificate = pool_->Take(key_params);
+  PostGenerationTask(signaling_thread_, worker_thread_, key_params, expires_ms,
+                     certificate, callback);
 }
 
 }  // namespace rtc
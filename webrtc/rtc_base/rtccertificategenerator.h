@@ -11,6 +11,8 @@
 #ifndef WEBRTC_RTC_BASE_RTCCERTIFICATEGENERATOR_H_
 #define WEBRTC_RTC_BASE_RTCCERTIFICATEGENERATOR_H_
 
+#include <deque>
+
 #include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/refcount.h"
 #include "webrtc/rtc_base/rtccertificate.h"
@@ -48,6 +50,54 @@ class RTCCertificateGeneratorInterface {
       const scoped_refptr<RTCCertificateGeneratorCallback>& callback) = 0;
 };
 
+// A pool of certificates that are generated ahead of time on the worker thread,
+// so that a burst of certificate requests doesn't wait for key generation. The
+// pool holds up to |size| certificates of one |KeyParams| with the default
+// expiration time, and starts generating a replacement for each one taken.
+// Must be used on the signaling thread. It is reference counted so that the
+// generators of several PeerConnections can share it.
+class RTCCertificatePool : public RefCountInterface {
+ public:
+  // Starts generating the certificates.
+  static scoped_refptr<RTCCertificatePool> Create(Thread* signaling_thread,
+                                                  Thread* worker_thread,
+                                                  const KeyParams& key_params,
+                                                  size_t size);
+
+  const KeyParams& key_params() const { return key_params_; }
+  size_t size() const { return size_; }
+  // The number of certificates ready to be taken.
+  size_t available() const;
+
+  // Returns a pooled certificate that hasn't expired, or null if there is none
+  // or |key_params| differs from the pool's.
+  scoped_refptr<RTCCertificate> Take(const KeyParams& key_params);
+
+ protected:
+  RTCCertificatePool(Thread* signaling_thread,
+                     Thread* worker_thread,
+                     const KeyParams& key_params,
+                     size_t size);
+  ~RTCCertificatePool() override;
+
+ private:
+  class RefillCallback;
+
+  // Starts generating certificates until the available and pending ones make up
+  // |size_|.
+  void Refill();
+  // Called with the result of a generation started by Refill, which is null if
+  // it failed.
+  void OnGenerated(const scoped_refptr<RTCCertificate>& certificate);
+
+  Thread* const signaling_thread_;
+  Thread* const worker_thread_;
+  const KeyParams key_params_;
+  const size_t size_;
+  std::deque<scoped_refptr<RTCCertificate>> certificates_;
+  size_t pending_ = 0;
+};
+
 // Standard implementation of |RTCCertificateGeneratorInterface|.
 // The static function |GenerateCertificate| generates a certificate on the
 // current thread. The |RTCCertificateGenerator| instance generates certificates
@@ -64,6 +114,11 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
       const Optional<uint64_t>& expires_ms);
 
   RTCCertificateGenerator(Thread* signaling_thread, Thread* worker_thread);
+  // Requests without |expires_ms| are served from |pool| when it has a
+  // certificate of the requested |KeyParams|.
+  RTCCertificateGenerator(Thread* signaling_thread,
+                          Thread* worker_thread,
+                          const scoped_refptr<RTCCertificatePool>& pool);
   ~RTCCertificateGenerator() override {}
 
   // |RTCCertificateGeneratorInterface| overrides.
@@ -79,6 +134,7 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
  private:
   Thread* const signaling_thread_;
   Thread* const worker_thread_;
+  const scoped_refptr<RTCCertificatePool> pool_;
 };
 
 }  // namespace rtc
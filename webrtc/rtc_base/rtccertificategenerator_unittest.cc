@@ -35,6 +35,15 @@ class RTCCertificateGeneratorFixture : public RTCCertificateGeneratorCallback {
 
   RTCCertificateGenerator* generator() const { return generator_.get(); }
   RTCCertificate* certificate() const { return certificate_.get(); }
+  RTCCertificatePool* pool() const { return pool_.get(); }
+
+  // Makes |generator()| use a new pool.
+  void CreatePool(const KeyParams& key_params, size_t size) {
+    pool_ = RTCCertificatePool::Create(signaling_thread_, worker_thread_.get(),
+                                       key_params, size);
+    generator_.reset(new RTCCertificateGenerator(
+        signaling_thread_, worker_thread_.get(), pool_));
+  }
 
   void OnSuccess(const scoped_refptr<RTCCertificate>& certificate) override {
     RTC_CHECK(signaling_thread_->IsCurrent());
@@ -62,6 +71,7 @@ class RTCCertificateGeneratorFixture : public RTCCertificateGeneratorCallback {
   Thread* const signaling_thread_;
   std::unique_ptr<Thread> worker_thread_;
   std::unique_ptr<RTCCertificateGenerator> generator_;
+  scoped_refptr<RTCCertificatePool> pool_;
   scoped_refptr<RTCCertificate> certificate_;
   bool generate_async_completed_;
 };
@@ -149,4 +159,36 @@ TEST_F(RTCCertificateGeneratorTest, GenerateWithInvalidParamsShouldFail) {
   EXPECT_FALSE(fixture_->certificate());
 }
 
+TEST_F(RTCCertificateGeneratorTest, GenerateAsyncFromPool) {
+  fixture_->CreatePool(KeyParams::ECDSA(), 2);
+  EXPECT_EQ_WAIT(2u, fixture_->pool()->available(), kGenerationTimeoutMs);
+
+  fixture_->generator()->GenerateCertificateAsync(
+      KeyParams::ECDSA(), Optional<uint64_t>(), fixture_);
+  // The pooled certificate is still delivered asynchronously, and is replaced.
+  EXPECT_FALSE(fixture_->GenerateAsyncCompleted());
+  EXPECT_EQ(1u, fixture_->pool()->available());
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+  EXPECT_EQ_WAIT(2u, fixture_->pool()->available(), kGenerationTimeoutMs);
+}
+
+TEST_F(RTCCertificateGeneratorTest, GenerateAsyncBypassesPool) {
+  fixture_->CreatePool(KeyParams::ECDSA(), 1);
+  EXPECT_EQ_WAIT(1u, fixture_->pool()->available(), kGenerationTimeoutMs);
+
+  // Neither another key type nor an explicit expiration is served by the pool.
+  fixture_->generator()->GenerateCertificateAsync(
+      KeyParams::RSA(), Optional<uint64_t>(), fixture_);
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+  EXPECT_EQ(1u, fixture_->pool()->available());
+
+  fixture_->generator()->GenerateCertificateAsync(
+      KeyParams::ECDSA(), Optional<uint64_t>(60000), fixture_);
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+  EXPECT_EQ(1u, fixture_->pool()->available());
+}
+
 }  // namespace rtc
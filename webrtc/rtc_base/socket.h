@@ -133,6 +133,25 @@ struct SentPacket {
   int64_t send_time_ms;
 };
 
+// One slot of a batched datagram read, see Socket::RecvFromBatch. |data| and
+// |capacity| describe a caller-owned buffer; |length|, |address| and
+// |timestamp| are filled in for every datagram that was read. A |length|
+// larger than |capacity| means the datagram was truncated.
+struct DatagramBuffer {
+  char* data = nullptr;
+  size_t capacity = 0;
+  size_t length = 0;
+  SocketAddress address;
+  int64_t timestamp = -1;
+};
+
+// One datagram of a batched send, see Socket::SendToBatch.
+struct OutgoingDatagram {
+  const char* data = nullptr;
+  size_t length = 0;
+  SocketAddress address;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -151,12 +170,37 @@ class Socket {
   virtual int Connect(const SocketAddress& addr) = 0;
   virtual int Send(const void *pv, size_t cb) = 0;
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr) = 0;
+  // Sends |count| datagrams, using as few system calls as the platform allows.
+  // Returns the number of datagrams sent, or SOCKET_ERROR if the first one
+  // could not be sent. The default implementation calls SendTo() for each.
+  virtual int SendToBatch(const OutgoingDatagram* datagrams, size_t count) {
+    size_t sent = 0;
+    for (; sent < count; ++sent) {
+      const OutgoingDatagram& datagram = datagrams[sent];
+      if (SendTo(datagram.data, datagram.length, datagram.address) < 0)
+        break;
+    }
+    return (sent == 0 && count > 0) ? SOCKET_ERROR : static_cast<int>(sent);
+  }
   // |timestamp| is in units of microseconds.
   virtual int Recv(void* pv, size_t cb, int64_t* timestamp) = 0;
   virtual int RecvFrom(void* pv,
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Reads up to |count| datagrams into |buffers|. Returns the number of
+  // datagrams read, or SOCKET_ERROR. Implementations that can't read more than
+  // one datagram per call fall back to a single RecvFrom().
+  virtual int RecvFromBatch(DatagramBuffer* buffers, size_t count) {
+    if (count == 0)
+      return 0;
+    int received = RecvFrom(buffers[0].data, buffers[0].capacity,
+                            &buffers[0].address, &buffers[0].timestamp);
+    if (received < 0)
+      return received;
+    buffers[0].length = static_cast<size_t>(received);
+    return 1;
+  }
   virtual int Listen(int backlog) = 0;
   virtual Socket *Accept(SocketAddress *paddr) = 0;
   virtual int Close() = 0;
@@ -178,6 +222,8 @@ class Socket {
     OPT_NODELAY,     // whether Nagle algorithm is enabled
     OPT_IPV6_V6ONLY, // Whether the socket is IPv6 only.
     OPT_DSCP,        // DSCP code
+    OPT_REUSEPORT,   // whether other sockets may bind the same address, with
+                     // the kernel spreading the packets among them
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
@@ -188,6 +188,12 @@ class SocketAddress {
   bool literal_;  // Indicates that 'hostname_' contains a literal IP string.
 };
 
+// Hashes SocketAddresses for unordered containers. Addresses that are equal
+// have the same hash, since it leaves out the hostname.
+struct SocketAddressHasher {
+  size_t operator()(const SocketAddress& addr) const { return addr.Hash(); }
+};
+
 bool SocketAddressFromSockAddrStorage(const sockaddr_storage& saddr,
                                       SocketAddress* out);
 SocketAddress EmptySocketAddressWithFamily(int family);
@@ -647,17 +647,29 @@ bool tokenize_first(const std::string& source,
 
 size_t split(const std::string& source, char delimiter,
              std::vector<std::string>* fields) {
+  return split(source, 0, delimiter, fields);
+}
+
+size_t split(const std::string& source, size_t pos, char delimiter,
+             std::vector<std::string>* fields) {
   RTC_DCHECK(fields);
-  fields->clear();
-  size_t last = 0;
-  for (size_t i = 0; i < source.length(); ++i) {
-    if (source[i] == delimiter) {
-      fields->push_back(source.substr(last, i - last));
+  RTC_DCHECK_LE(pos, source.length());
+  size_t num_fields = 0;
+  size_t last = pos;
+  for (size_t i = pos; i <= source.length(); ++i) {
+    if (i == source.length() || source[i] == delimiter) {
+      // Assign to the fields already there, so that their buffers are reused.
+      if (num_fields < fields->size()) {
+        (*fields)[num_fields].assign(source, last, i - last);
+      } else {
+        fields->push_back(source.substr(last, i - last));
+      }
+      ++num_fields;
       last = i + 1;
     }
   }
-  fields->push_back(source.substr(last, source.length() - last));
-  return fields->size();
+  fields->resize(num_fields);
+  return num_fields;
 }
 
 char make_char_safe_for_filename(char c) {
@@ -141,6 +141,12 @@ inline std::string s_url_decode(const std::string& source) {
 size_t split(const std::string& source, char delimiter,
              std::vector<std::string>* fields);
 
+// Like split(source.substr(pos), ...), without copying the substring. Strings
+// already in |fields| are overwritten rather than reallocated, so splitting
+// many lines into the same vector does little allocation.
+size_t split(const std::string& source, size_t pos, char delimiter,
+             std::vector<std::string>* fields);
+
 // Splits the source string into multiple fields separated by delimiter,
 // with duplicates of delimiter ignored.  Trailing delimiter ignored.
 size_t tokenize(const std::string& source, char delimiter,
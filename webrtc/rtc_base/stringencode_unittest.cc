@@ -396,6 +396,24 @@ TEST(SplitTest, CompareSubstrings) {
   ASSERT_STREQ("", fields.at(0).c_str());
 }
 
+// Tests splitting from an offset into a vector that already has fields.
+TEST(SplitTest, SplitFromPosition) {
+  std::vector<std::string> fields = {"old", "fields", "to", "overwrite"};
+
+  EXPECT_EQ(3ul, split("a=one,,three", 2, ',', &fields));
+  ASSERT_EQ(3ul, fields.size());
+  EXPECT_EQ("one", fields[0]);
+  EXPECT_EQ("", fields[1]);
+  EXPECT_EQ("three", fields[2]);
+
+  EXPECT_EQ(5ul, split("a=one,two,three,four,five", 2, ',', &fields));
+  EXPECT_EQ("five", fields[4]);
+
+  EXPECT_EQ(1ul, split("a=", 2, ',', &fields));
+  ASSERT_EQ(1ul, fields.size());
+  EXPECT_EQ("", fields[0]);
+}
+
 TEST(BoolTest, DecodeValid) {
   bool value;
   EXPECT_TRUE(FromString("true", &value));
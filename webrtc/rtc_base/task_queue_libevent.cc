@@ -15,15 +15,23 @@
 #include <string.h>
 #include <unistd.h>
 
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+#include <sys/eventfd.h>
+#endif
+
 #include "base/third_party/libevent/event.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+#include "webrtc/rtc_base/mpsc_queue.h"
+#endif
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/refcount.h"
 #include "webrtc/rtc_base/refcountedobject.h"
 #include "webrtc/rtc_base/safe_conversions.h"
 #include "webrtc/rtc_base/task_queue.h"
 #include "webrtc/rtc_base/task_queue_posix.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
 #include "webrtc/rtc_base/timeutils.h"
 
 namespace rtc {
@@ -35,6 +43,13 @@ static const char kQuit = 1;
 static const char kRunTask = 2;
 static const char kRunReplyTask = 3;
 
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+// Upper bound on tasks run per eventfd wakeup, so that a queue that is posted
+// to faster than it can run tasks still gets to its timers and control
+// messages.
+static const size_t kMaxTasksPerWakeup = 64;
+#endif
+
 using Priority = TaskQueue::Priority;
 
 // This ignores the SIGPIPE signal on the calling thread.
@@ -134,6 +149,10 @@ class TaskQueue::Impl : public RefCountInterface {
   static void OnWakeup(int socket, short flags, void* context);  // NOLINT
   static void RunTask(int fd, short flags, void* context);       // NOLINT
   static void RunTimer(int fd, short flags, void* context);      // NOLINT
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+  static void OnTasksPosted(int fd, short flags, void* context);  // NOLINT
+  void SignalTasksPosted();
+#endif
 
   class ReplyTaskOwner;
   class PostAndReplyTask;
@@ -151,7 +170,16 @@ class TaskQueue::Impl : public RefCountInterface {
   std::unique_ptr<event> wakeup_event_;
   PlatformThread thread_;
   rtc::CriticalSection pending_lock_;
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+  // Tasks posted from other threads. The eventfd is only written when the
+  // queue goes from empty to non-empty, so a burst of posts costs a single
+  // wakeup. The pipe is still used for quit and reply messages.
+  int task_event_fd_ = -1;
+  std::unique_ptr<event> task_event_;
+  MpscQueue<std::unique_ptr<QueuedTask>> pending_tasks_;
+#else
   std::list<std::unique_ptr<QueuedTask>> pending_ GUARDED_BY(pending_lock_);
+#endif
   std::list<scoped_refptr<ReplyTaskOwnerRef>> pending_replies_
       GUARDED_BY(pending_lock_);
 };
@@ -292,6 +320,14 @@ TaskQueue::Impl::Impl(const char* queue_name,
   EventAssign(wakeup_event_.get(), event_base_, wakeup_pipe_out_,
               EV_READ | EV_PERSIST, OnWakeup, this);
   event_add(wakeup_event_.get(), 0);
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+  task_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  RTC_CHECK(task_event_fd_ != -1);
+  task_event_.reset(new event());
+  EventAssign(task_event_.get(), event_base_, task_event_fd_,
+              EV_READ | EV_PERSIST, OnTasksPosted, this);
+  event_add(task_event_.get(), 0);
+#endif
   thread_.Start();
 }
 
@@ -310,6 +346,11 @@ TaskQueue::Impl::~Impl() {
   thread_.Stop();
 
   event_del(wakeup_event_.get());
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+  event_del(task_event_.get());
+  close(task_event_fd_);
+  task_event_fd_ = -1;
+#endif
 
   IgnoreSigPipeSignalOnCurrentThread();
 
@@ -358,6 +399,10 @@ void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
       task.release();
     }
   } else {
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+    if (pending_tasks_.Push(std::move(task)))
+      SignalTasksPosted();
+#else
     QueuedTask* task_id = task.get();  // Only used for comparison.
     {
       CritScope lock(&pending_lock_);
@@ -371,6 +416,7 @@ void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
         return t.get() == task_id;
       });
     }
+#endif
   }
 }
 
@@ -431,6 +477,7 @@ void TaskQueue::Impl::OnWakeup(int socket,
       ctx->is_active = false;
       event_base_loopbreak(ctx->queue->event_base_);
       break;
+#if !defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
     case kRunTask: {
       std::unique_ptr<QueuedTask> task;
       {
@@ -440,10 +487,13 @@ void TaskQueue::Impl::OnWakeup(int socket,
         ctx->queue->pending_.pop_front();
         RTC_DCHECK(task.get());
       }
+      ThreadCpuAccounting::ScopedTask cpu_task(
+          ctx->queue->thread_.name().c_str(), Location());
       if (!task->Run())
         task.release();
       break;
     }
+#endif
     case kRunReplyTask: {
       scoped_refptr<ReplyTaskOwnerRef> reply_task;
       {
@@ -469,6 +519,10 @@ void TaskQueue::Impl::OnWakeup(int socket,
 // static
 void TaskQueue::Impl::RunTask(int fd, short flags, void* context) {  // NOLINT
   auto* task = static_cast<QueuedTask*>(context);
+  QueueContext* ctx =
+      static_cast<QueueContext*>(pthread_getspecific(GetQueuePtrTls()));
+  ThreadCpuAccounting::ScopedTask cpu_task(ctx->queue->thread_.name().c_str(),
+                                           Location());
   if (task->Run())
     delete task;
 }
@@ -476,14 +530,56 @@ void TaskQueue::Impl::RunTask(int fd, short flags, void* context) {  // NOLINT
 // static
 void TaskQueue::Impl::RunTimer(int fd, short flags, void* context) {  // NOLINT
   TimerEvent* timer = static_cast<TimerEvent*>(context);
-  if (!timer->task->Run())
-    timer->task.release();
   QueueContext* ctx =
       static_cast<QueueContext*>(pthread_getspecific(GetQueuePtrTls()));
+  {
+    ThreadCpuAccounting::ScopedTask cpu_task(
+        ctx->queue->thread_.name().c_str(), Location());
+    if (!timer->task->Run())
+      timer->task.release();
+  }
   ctx->pending_timers_.remove(timer);
   delete timer;
 }
 
+#if defined(WEBRTC_TASK_QUEUE_USE_EVENTFD)
+// static
+void TaskQueue::Impl::OnTasksPosted(int fd,
+                                    short flags,
+                                    void* context) {  // NOLINT
+  TaskQueue::Impl* me = static_cast<TaskQueue::Impl*>(context);
+  RTC_DCHECK(me->task_event_fd_ == fd);
+  // Reset the counter before draining; a post that races with the drain
+  // either gets popped below or signals the eventfd again.
+  uint64_t count;
+  if (read(fd, &count, sizeof(count)) != sizeof(count))
+    RTC_CHECK_EQ(EAGAIN, errno);
+
+  std::unique_ptr<QueuedTask> task;
+  for (size_t i = 0; i < kMaxTasksPerWakeup && me->pending_tasks_.Pop(&task);
+       ++i) {
+    {
+      ThreadCpuAccounting::ScopedTask cpu_task(me->thread_.name().c_str(),
+                                               Location());
+      if (!task->Run())
+        task.release();
+    }
+    task.reset();
+  }
+  // Producers only signal on empty to non-empty transitions, so come back for
+  // whatever is left.
+  if (!me->pending_tasks_.empty())
+    me->SignalTasksPosted();
+}
+
+void TaskQueue::Impl::SignalTasksPosted() {
+  // Can only fail if the counter would overflow, which takes 2^64 - 1 posts.
+  uint64_t one = 1;
+  ssize_t written = write(task_event_fd_, &one, sizeof(one));
+  RTC_CHECK_EQ(static_cast<ssize_t>(sizeof(one)), written);
+}
+#endif
+
 void TaskQueue::Impl::PrepareReplyTask(
     scoped_refptr<ReplyTaskOwnerRef> reply_task) {
   RTC_DCHECK(reply_task);
@@ -0,0 +1,419 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// TaskQueue implementation that multiplexes all task queues in the process
+// onto one fixed size pool of worker threads, instead of giving each queue a
+// thread of its own.
+//
+// Each queue keeps its own FIFO of pending tasks. A queue with pending tasks is
+// put on the pool's ready list exactly once; a worker takes it from there, runs
+// a slice of its tasks and puts it back if more remain. Since a queue is never
+// on the ready list or running on more than one worker at a time, tasks posted
+// to one queue run one at a time and in order, and TaskQueue::Current() (and
+// so SequencedTaskChecker) behaves as with a dedicated thread. Consecutive
+// tasks of one queue may however run on different threads.
+//
+// Tasks should not block waiting for tasks on other queues, since with all
+// workers blocked nothing else can run.
+
+#include "webrtc/rtc_base/task_queue.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/refcount.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+#include "webrtc/rtc_base/task_queue_posix.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
+#include "webrtc/rtc_base/timeutils.h"
+
+namespace rtc {
+using internal::GetQueuePtrTls;
+using internal::AutoSetCurrentQueuePtr;
+
+namespace {
+using Priority = TaskQueue::Priority;
+
+// Number of tasks a worker runs from one queue before giving other ready
+// queues a turn.
+const int kMaxTasksPerSlice = 32;
+
+// Lower bound on the pool size, so that a few tasks blocking on events (which
+// some tests and shutdown paths do) can't stall every queue in the process.
+const long kMinWorkerThreads = 4;
+
+size_t NumWorkerThreads() {
+  return std::max(kMinWorkerThreads, sysconf(_SC_NPROCESSORS_ONLN));
+}
+}  // namespace
+
+class TaskQueue::Impl : public RefCountInterface {
+ public:
+  Impl(const char* queue_name, TaskQueue* queue, Priority priority);
+
+  static TaskQueue* CurrentQueue();
+  static bool IsCurrent(const char* queue_name);
+  bool IsCurrent() const;
+
+  // Called by ~TaskQueue. Waits for a running task to finish and deletes the
+  // pending ones. Tasks posted after this are deleted without running.
+  void Stop();
+
+  void PostTask(std::unique_ptr<QueuedTask> task);
+  void PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                        std::unique_ptr<QueuedTask> reply,
+                        TaskQueue::Impl* reply_queue);
+  void PostDelayedTask(std::unique_ptr<QueuedTask> task, uint32_t milliseconds);
+
+  // Runs up to kMaxTasksPerSlice pending tasks on the calling pool thread.
+  // Returns true if tasks remain, in which case the queue must be put back on
+  // the ready list.
+  bool RunSlice();
+
+  Priority priority() const { return priority_; }
+
+ private:
+  class ThreadPool;
+  class PostAndReplyTask;
+
+  static ThreadPool* GetThreadPool();
+
+  TaskQueue* const queue_;
+  const std::string name_;
+  const Priority priority_;
+  Event slice_done_;
+
+  CriticalSection lock_;
+  std::deque<std::unique_ptr<QueuedTask>> pending_ GUARDED_BY(lock_);
+  // True while the queue is on the ready list or running on a worker.
+  bool scheduled_ GUARDED_BY(lock_) = false;
+  bool running_ GUARDED_BY(lock_) = false;
+  bool stopped_ GUARDED_BY(lock_) = false;
+};
+
+class TaskQueue::Impl::ThreadPool {
+ public:
+  explicit ThreadPool(size_t num_threads) : wakeup_(false, false) {
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads_.emplace_back(
+          new PlatformThread(&ThreadPool::ThreadMain, this, "TaskQueuePool"));
+      threads_.back()->Start();
+    }
+  }
+
+  // Puts |queue| on the ready list. HIGH priority queues are served first.
+  void Schedule(scoped_refptr<TaskQueue::Impl> queue) {
+    {
+      CritScope lock(&lock_);
+      ready_[ReadyListIndex(queue->priority())].push_back(std::move(queue));
+    }
+    wakeup_.Set();
+  }
+
+  void ScheduleDelayed(int64_t run_at_ms,
+                       scoped_refptr<TaskQueue::Impl> queue,
+                       std::unique_ptr<QueuedTask> task) {
+    {
+      CritScope lock(&lock_);
+      delayed_.push_back(DelayedTask{run_at_ms, next_delayed_sequence_++,
+                                     std::move(queue), std::move(task)});
+      std::push_heap(delayed_.begin(), delayed_.end(), LaterFirst);
+    }
+    // Whichever worker wakes up recomputes its wait time.
+    wakeup_.Set();
+  }
+
+ private:
+  struct DelayedTask {
+    int64_t run_at_ms;
+    uint64_t sequence;
+    scoped_refptr<TaskQueue::Impl> queue;
+    std::unique_ptr<QueuedTask> task;
+  };
+
+  // Heap order for |delayed_|, earliest (and among those, first posted) on top.
+  static bool LaterFirst(const DelayedTask& a, const DelayedTask& b) {
+    if (a.run_at_ms != b.run_at_ms)
+      return a.run_at_ms > b.run_at_ms;
+    return a.sequence > b.sequence;
+  }
+
+  static size_t ReadyListIndex(Priority priority) {
+    switch (priority) {
+      case Priority::HIGH:
+        return 0;
+      case Priority::NORMAL:
+        return 1;
+      case Priority::LOW:
+        return 2;
+    }
+    RTC_NOTREACHED();
+    return 1;
+  }
+
+  static void ThreadMain(void* context) {
+    static_cast<ThreadPool*>(context)->Run();
+  }
+
+  void Run() {
+    while (true) {
+      std::vector<DelayedTask> due;
+      scoped_refptr<TaskQueue::Impl> queue;
+      int wait_ms = Event::kForever;
+      bool more_ready = false;
+      {
+        CritScope lock(&lock_);
+        int64_t now_ms = TimeMillis();
+        while (!delayed_.empty() && delayed_.front().run_at_ms <= now_ms) {
+          std::pop_heap(delayed_.begin(), delayed_.end(), LaterFirst);
+          due.push_back(std::move(delayed_.back()));
+          delayed_.pop_back();
+        }
+        if (!delayed_.empty()) {
+          wait_ms = static_cast<int>(
+              std::min<int64_t>(delayed_.front().run_at_ms - now_ms,
+                                std::numeric_limits<int>::max()));
+        }
+        for (auto& ready : ready_) {
+          if (!ready.empty()) {
+            queue = std::move(ready.front());
+            ready.pop_front();
+            break;
+          }
+        }
+        for (const auto& ready : ready_)
+          more_ready |= !ready.empty();
+      }
+
+      // Posted outside of |lock_|, since PostTask() may call Schedule().
+      for (DelayedTask& delayed : due)
+        delayed.queue->PostTask(std::move(delayed.task));
+
+      if (!queue) {
+        if (due.empty())
+          wakeup_.Wait(wait_ms);
+        continue;
+      }
+      // Pass the wakeup on, so that other ready queues run in parallel.
+      if (more_ready)
+        wakeup_.Set();
+      if (queue->RunSlice())
+        Schedule(std::move(queue));
+    }
+  }
+
+  std::vector<std::unique_ptr<PlatformThread>> threads_;
+  Event wakeup_;
+
+  CriticalSection lock_;
+  std::deque<scoped_refptr<TaskQueue::Impl>> ready_[3] GUARDED_BY(lock_);
+  std::vector<DelayedTask> delayed_ GUARDED_BY(lock_);
+  uint64_t next_delayed_sequence_ GUARDED_BY(lock_) = 0;
+};
+
+// static
+TaskQueue::Impl::ThreadPool* TaskQueue::Impl::GetThreadPool() {
+  // Intentionally leaked; worker threads live as long as the process.
+  static ThreadPool* const pool = new ThreadPool(NumWorkerThreads());
+  return pool;
+}
+
+// Runs the task and then posts the reply to |reply_queue_|. Holding a
+// reference keeps the reply queue's Impl alive; if the TaskQueue itself has
+// been deleted by then, the reply is deleted without running.
+class TaskQueue::Impl::PostAndReplyTask : public QueuedTask {
+ public:
+  PostAndReplyTask(std::unique_ptr<QueuedTask> task,
+                   std::unique_ptr<QueuedTask> reply,
+                   TaskQueue::Impl* reply_queue)
+      : task_(std::move(task)),
+        reply_(std::move(reply)),
+        reply_queue_(reply_queue) {}
+
+ private:
+  bool Run() override {
+    if (!task_->Run())
+      task_.release();
+    reply_queue_->PostTask(std::move(reply_));
+    return true;
+  }
+
+  std::unique_ptr<QueuedTask> task_;
+  std::unique_ptr<QueuedTask> reply_;
+  const scoped_refptr<TaskQueue::Impl> reply_queue_;
+};
+
+TaskQueue::Impl::Impl(const char* queue_name,
+                      TaskQueue* queue,
+                      Priority priority)
+    : queue_(queue),
+      name_(queue_name),
+      priority_(priority),
+      slice_done_(false, false) {
+  RTC_DCHECK(queue_name);
+}
+
+// static
+TaskQueue* TaskQueue::Impl::CurrentQueue() {
+  return static_cast<TaskQueue*>(pthread_getspecific(GetQueuePtrTls()));
+}
+
+// static
+bool TaskQueue::Impl::IsCurrent(const char* queue_name) {
+  TaskQueue* current = CurrentQueue();
+  return current && current->impl_->name_.compare(queue_name) == 0;
+}
+
+bool TaskQueue::Impl::IsCurrent() const {
+  return CurrentQueue() == queue_;
+}
+
+void TaskQueue::Impl::Stop() {
+  RTC_DCHECK(!IsCurrent());
+  std::deque<std::unique_ptr<QueuedTask>> pending;
+  bool wait_for_slice;
+  {
+    CritScope lock(&lock_);
+    stopped_ = true;
+    pending.swap(pending_);
+    wait_for_slice = running_;
+  }
+  if (wait_for_slice)
+    slice_done_.Wait(Event::kForever);
+  // |pending| is deleted here, outside of |lock_|, since task destructors may
+  // post to other queues.
+}
+
+void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
+  RTC_DCHECK(task.get());
+  {
+    CritScope lock(&lock_);
+    if (stopped_)
+      return;
+    pending_.push_back(std::move(task));
+    if (scheduled_)
+      return;
+    scheduled_ = true;
+  }
+  GetThreadPool()->Schedule(this);
+}
+
+void TaskQueue::Impl::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                      uint32_t milliseconds) {
+  GetThreadPool()->ScheduleDelayed(TimeMillis() + milliseconds, this,
+                                   std::move(task));
+}
+
+void TaskQueue::Impl::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                       std::unique_ptr<QueuedTask> reply,
+                                       TaskQueue::Impl* reply_queue) {
+  PostTask(std::unique_ptr<QueuedTask>(
+      new PostAndReplyTask(std::move(task), std::move(reply), reply_queue)));
+}
+
+bool TaskQueue::Impl::RunSlice() {
+  {
+    CritScope lock(&lock_);
+    if (stopped_) {
+      scheduled_ = false;
+      return false;
+    }
+    running_ = true;
+  }
+
+  {
+    AutoSetCurrentQueuePtr set_current(queue_);
+    for (int i = 0; i < kMaxTasksPerSlice; ++i) {
+      std::unique_ptr<QueuedTask> task;
+      {
+        CritScope lock(&lock_);
+        if (stopped_ || pending_.empty())
+          break;
+        task = std::move(pending_.front());
+        pending_.pop_front();
+      }
+      // Queued tasks don't record where they were posted from.
+      ThreadCpuAccounting::ScopedTask cpu_task(name_.c_str(), Location());
+      if (!task->Run())
+        task.release();
+    }
+  }
+
+  bool more;
+  bool stopped;
+  {
+    CritScope lock(&lock_);
+    running_ = false;
+    stopped = stopped_;
+    more = !stopped_ && !pending_.empty();
+    if (!more)
+      scheduled_ = false;
+  }
+  if (stopped)
+    slice_done_.Set();
+  return more;
+}
+
+TaskQueue::TaskQueue(const char* queue_name, Priority priority)
+    : impl_(new RefCountedObject<TaskQueue::Impl>(queue_name, this, priority)) {
+}
+
+TaskQueue::~TaskQueue() {
+  impl_->Stop();
+}
+
+// static
+TaskQueue* TaskQueue::Current() {
+  return TaskQueue::Impl::CurrentQueue();
+}
+
+// Used for DCHECKing the current queue.
+// static
+bool TaskQueue::IsCurrent(const char* queue_name) {
+  return TaskQueue::Impl::IsCurrent(queue_name);
+}
+
+bool TaskQueue::IsCurrent() const {
+  return impl_->IsCurrent();
+}
+
+void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+  return TaskQueue::impl_->PostTask(std::move(task));
+}
+
+void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                 std::unique_ptr<QueuedTask> reply,
+                                 TaskQueue* reply_queue) {
+  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
+                                            reply_queue->impl_.get());
+}
+
+void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                 std::unique_ptr<QueuedTask> reply) {
+  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
+                                            impl_.get());
+}
+
+void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                uint32_t milliseconds) {
+  return TaskQueue::impl_->PostDelayedTask(std::move(task), milliseconds);
+}
+
+}  // namespace rtc
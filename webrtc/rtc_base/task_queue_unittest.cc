@@ -18,11 +18,13 @@
 #include <memory>
 #include <vector>
 
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/bind.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/task_queue.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 namespace rtc {
 namespace {
@@ -328,4 +330,82 @@ TEST(TaskQueueTest, PostALot) {
   EXPECT_EQ(kTaskCount, tasks_cleaned_up);
 }
 
+// Tasks posted to each of many queues must run in order and with that queue
+// as the current one, regardless of how queues map onto threads.
+TEST(TaskQueueTest, PostToManyQueuesKeepsOrder) {
+  static const int kNumQueues = 100;
+  static const int kTasksPerQueue = 100;
+  Event done(false, false);
+  volatile int queues_done = 0;
+  std::vector<std::unique_ptr<TaskQueue>> queues;
+  std::vector<int> last_run(kNumQueues, -1);
+  std::vector<int> out_of_order(kNumQueues, 0);
+  for (int i = 0; i < kNumQueues; ++i)
+    queues.emplace_back(new TaskQueue("ManyQueues"));
+
+  for (int task = 0; task < kTasksPerQueue; ++task) {
+    for (int i = 0; i < kNumQueues; ++i) {
+      TaskQueue* queue = queues[i].get();
+      int* last = &last_run[i];
+      int* errors = &out_of_order[i];
+      queues[i]->PostTask([queue, last, errors, task, &queues_done, &done]() {
+        if (!queue->IsCurrent() || *last != task - 1)
+          ++*errors;
+        *last = task;
+        if (task == kTasksPerQueue - 1 &&
+            AtomicOps::Increment(&queues_done) == kNumQueues) {
+          done.Set();
+        }
+      });
+    }
+  }
+  EXPECT_TRUE(done.Wait(10000));
+  queues.clear();
+  for (int i = 0; i < kNumQueues; ++i) {
+    EXPECT_EQ(0, out_of_order[i]) << "queue " << i;
+    EXPECT_EQ(kTasksPerQueue - 1, last_run[i]);
+  }
+}
+
+// Measures PostTask() throughput with several threads posting small tasks to
+// one queue, which is how encoder and pacer queues are typically driven.
+// Tasks are posted in rounds small enough to never fill the pipe used by the
+// default libevent implementation (see PostALot).
+TEST(TaskQueueTest, DISABLED_PostTaskThroughputPerf) {
+  static const int kNumPosters = 4;
+  static const int kTasksPerPosterPerRound = 10000;
+  static const int kNumRounds = 25;
+  static const char kQueueName[] = "PostTaskThroughput";
+
+  TaskQueue queue(kQueueName);
+  std::vector<std::unique_ptr<TaskQueue>> posters;
+  for (int i = 0; i < kNumPosters; ++i)
+    posters.emplace_back(new TaskQueue("Poster"));
+
+  int64_t elapsed_us = 0;
+  for (int round = 0; round < kNumRounds; ++round) {
+    Event done(false, false);
+    int tasks_run = 0;
+    int64_t start_us = TimeMicros();
+    for (auto& poster : posters) {
+      poster->PostTask([&queue, &tasks_run, &done]() {
+        for (int i = 0; i < kTasksPerPosterPerRound; ++i) {
+          queue.PostTask([&tasks_run, &done]() {
+            if (++tasks_run == kNumPosters * kTasksPerPosterPerRound)
+              done.Set();
+          });
+        }
+      });
+    }
+    ASSERT_TRUE(done.Wait(30000));
+    elapsed_us += TimeMicros() - start_us;
+  }
+
+  webrtc::test::PrintResult(
+      "task_queue_post", "", "throughput",
+      static_cast<size_t>(int64_t{kNumPosters} * kTasksPerPosterPerRound *
+                          kNumRounds * kNumMicrosecsPerSec / elapsed_us),
+      "tasks/s", false);
+}
+
 }  // namespace rtc
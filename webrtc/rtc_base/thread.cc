@@ -21,6 +21,7 @@
 #include "webrtc/rtc_base/nullsocketserver.h"
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/stringutils.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
 
@@ -410,7 +411,11 @@ void Thread::ReceiveSendsFromThread(const Thread* source) {
   while (PopSendMessageFromThread(source, &smsg)) {
     crit_.Leave();
 
-    smsg.msg.phandler->OnMessage(&smsg.msg);
+    {
+      ThreadCpuAccounting::ScopedTask cpu_task(name_.c_str(),
+                                               smsg.msg.posted_from);
+      smsg.msg.phandler->OnMessage(&smsg.msg);
+    }
 
     crit_.Enter();
     *smsg.ready = true;
@@ -484,7 +489,11 @@ bool Thread::ProcessMessages(int cmsLoop) {
     Message msg;
     if (!Get(&msg, cmsNext))
       return !IsQuitting();
-    Dispatch(&msg);
+    {
+      ThreadCpuAccounting::ScopedTask cpu_task(name_.c_str(),
+                                               msg.posted_from);
+      Dispatch(&msg);
+    }
 
     if (cmsLoop != kForever) {
       cmsNext = static_cast<int>(TimeUntil(msEnd));
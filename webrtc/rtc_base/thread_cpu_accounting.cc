@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/cpu_time.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace rtc {
+namespace {
+
+// Number of locations reported in ThreadCpuStats::slowest_tasks.
+const size_t kMaxSlowestTasks = 5;
+
+volatile int g_enabled = 0;
+
+class Registry {
+ public:
+  void AddTask(const char* name, const Location& location, int64_t cpu_ns) {
+    CritScope lock(&crit_);
+    auto it = threads_.find(name);
+    if (it == threads_.end())
+      it = threads_.emplace(name, ThreadEntry()).first;
+    ThreadEntry& thread = it->second;
+    ++thread.num_tasks;
+    thread.cpu_time_ns += cpu_ns;
+    // Locations are constructed from string literals, so they can be told
+    // apart by address.
+    TaskCpuStats& task = thread.tasks[location.file_and_line()];
+    if (task.num_tasks == 0)
+      task.location = location.ToString();
+    ++task.num_tasks;
+    task.cpu_time_ns += cpu_ns;
+    task.max_cpu_time_ns = std::max(task.max_cpu_time_ns, cpu_ns);
+  }
+
+  std::vector<ThreadCpuStats> GetStats() {
+    std::vector<ThreadCpuStats> stats;
+    CritScope lock(&crit_);
+    for (const auto& it : threads_) {
+      ThreadCpuStats thread_stats;
+      thread_stats.name = it.first;
+      thread_stats.num_tasks = it.second.num_tasks;
+      thread_stats.cpu_time_ns = it.second.cpu_time_ns;
+      for (const auto& task : it.second.tasks)
+        thread_stats.slowest_tasks.push_back(task.second);
+      std::sort(thread_stats.slowest_tasks.begin(),
+                thread_stats.slowest_tasks.end(),
+                [](const TaskCpuStats& a, const TaskCpuStats& b) {
+                  return a.max_cpu_time_ns > b.max_cpu_time_ns;
+                });
+      if (thread_stats.slowest_tasks.size() > kMaxSlowestTasks)
+        thread_stats.slowest_tasks.resize(kMaxSlowestTasks);
+      stats.push_back(std::move(thread_stats));
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const ThreadCpuStats& a, const ThreadCpuStats& b) {
+                return a.cpu_time_ns > b.cpu_time_ns;
+              });
+    return stats;
+  }
+
+  void Reset() {
+    CritScope lock(&crit_);
+    threads_.clear();
+  }
+
+ private:
+  struct ThreadEntry {
+    int64_t num_tasks = 0;
+    int64_t cpu_time_ns = 0;
+    std::map<const char*, TaskCpuStats> tasks;
+  };
+
+  CriticalSection crit_;
+  // std::less<> allows looking up names without constructing a std::string.
+  std::map<std::string, ThreadEntry, std::less<>> threads_ GUARDED_BY(crit_);
+};
+
+Registry* GetRegistry() {
+  static Registry* const registry = new Registry();
+  return registry;
+}
+
+}  // namespace
+
+ThreadCpuStats::ThreadCpuStats() = default;
+ThreadCpuStats::ThreadCpuStats(const ThreadCpuStats&) = default;
+ThreadCpuStats::~ThreadCpuStats() = default;
+
+// static
+void ThreadCpuAccounting::SetEnabled(bool enabled) {
+  AtomicOps::ReleaseStore(&g_enabled, enabled ? 1 : 0);
+}
+
+// static
+bool ThreadCpuAccounting::IsEnabled() {
+  return AtomicOps::AcquireLoad(&g_enabled) != 0;
+}
+
+// static
+std::vector<ThreadCpuStats> ThreadCpuAccounting::GetStats() {
+  return GetRegistry()->GetStats();
+}
+
+// static
+void ThreadCpuAccounting::Reset() {
+  GetRegistry()->Reset();
+}
+
+ThreadCpuAccounting::ScopedTask::ScopedTask(const char* name,
+                                            const Location& location)
+    : name_(name),
+      location_(location),
+      start_cpu_time_ns_(IsEnabled() ? GetThreadCpuTimeNanos() : -1) {}
+
+ThreadCpuAccounting::ScopedTask::~ScopedTask() {
+  if (start_cpu_time_ns_ < 0)
+    return;
+  GetRegistry()->AddTask(name_, location_,
+                         GetThreadCpuTimeNanos() - start_cpu_time_ns_);
+}
+
+}  // namespace rtc
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_BASE_THREAD_CPU_ACCOUNTING_H_
+#define WEBRTC_RTC_BASE_THREAD_CPU_ACCOUNTING_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/location.h"
+
+namespace rtc {
+
+// CPU time spent running the tasks posted from one location.
+struct TaskCpuStats {
+  std::string location;
+  int64_t num_tasks = 0;
+  int64_t cpu_time_ns = 0;
+  int64_t max_cpu_time_ns = 0;
+};
+
+// CPU time spent running tasks on the threads, task queues or process threads
+// of one name.
+struct ThreadCpuStats {
+  ThreadCpuStats();
+  ThreadCpuStats(const ThreadCpuStats&);
+  ~ThreadCpuStats();
+
+  std::string name;
+  int64_t num_tasks = 0;
+  int64_t cpu_time_ns = 0;
+  // The locations whose tasks took the most CPU time in a single run, slowest
+  // first.
+  std::vector<TaskCpuStats> slowest_tasks;
+};
+
+// Process wide accounting of the CPU time spent by the rtc::Thread,
+// rtc::TaskQueue and ProcessThread instances running their tasks, so that it
+// can be seen which of the threads are saturated. Threads of the same name,
+// e.g. the encoder queues of several streams, are accounted together.
+//
+// Disabled by default; when disabled, accounting a task only costs reading an
+// atomic flag.
+class ThreadCpuAccounting {
+ public:
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+  // Returns the accounted CPU time per name, busiest first.
+  static std::vector<ThreadCpuStats> GetStats();
+  // Forgets everything accounted so far.
+  static void Reset();
+
+  // Accounts the CPU time of the current thread during its lifetime to the
+  // task posted from |location| on |name|. |name| must outlive the object.
+  class ScopedTask {
+   public:
+    ScopedTask(const char* name, const Location& location);
+    ~ScopedTask();
+
+   private:
+    const char* const name_;
+    const Location location_;
+    // -1 if accounting was disabled when the task started.
+    const int64_t start_cpu_time_ns_;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(ScopedTask);
+  };
+
+ private:
+  RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(ThreadCpuAccounting);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_RTC_BASE_THREAD_CPU_ACCOUNTING_H_
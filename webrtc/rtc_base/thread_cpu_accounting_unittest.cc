@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
+
+#include "webrtc/rtc_base/cpu_time.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/thread.h"
+
+namespace rtc {
+namespace {
+
+const int64_t kBusyCpuTimeNs = 20000000;
+
+void SpendCpuTime(int64_t cpu_time_ns) {
+  const int64_t start = GetThreadCpuTimeNanos();
+  while (GetThreadCpuTimeNanos() - start < cpu_time_ns) {
+  }
+}
+
+class ThreadCpuAccountingTest : public testing::Test {
+ protected:
+  ThreadCpuAccountingTest() {
+    ThreadCpuAccounting::Reset();
+    ThreadCpuAccounting::SetEnabled(true);
+  }
+  ~ThreadCpuAccountingTest() override {
+    ThreadCpuAccounting::SetEnabled(false);
+    ThreadCpuAccounting::Reset();
+  }
+
+  const ThreadCpuStats* FindStats(const std::vector<ThreadCpuStats>& stats,
+                                  const std::string& name) {
+    for (const ThreadCpuStats& thread_stats : stats) {
+      if (thread_stats.name == name)
+        return &thread_stats;
+    }
+    return nullptr;
+  }
+};
+
+}  // namespace
+
+TEST_F(ThreadCpuAccountingTest, AccountsTasksPerNameAndLocation) {
+  const Location kFastLocation = RTC_FROM_HERE;
+  const Location kSlowLocation = RTC_FROM_HERE;
+  for (int i = 0; i < 3; ++i) {
+    ThreadCpuAccounting::ScopedTask task("thread", kFastLocation);
+  }
+  {
+    ThreadCpuAccounting::ScopedTask task("thread", kSlowLocation);
+    SpendCpuTime(kBusyCpuTimeNs);
+  }
+
+  std::vector<ThreadCpuStats> stats = ThreadCpuAccounting::GetStats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ("thread", stats[0].name);
+  EXPECT_EQ(4, stats[0].num_tasks);
+  EXPECT_GE(stats[0].cpu_time_ns, kBusyCpuTimeNs);
+  ASSERT_EQ(2u, stats[0].slowest_tasks.size());
+  EXPECT_EQ(kSlowLocation.ToString(), stats[0].slowest_tasks[0].location);
+  EXPECT_EQ(1, stats[0].slowest_tasks[0].num_tasks);
+  EXPECT_GE(stats[0].slowest_tasks[0].max_cpu_time_ns, kBusyCpuTimeNs);
+  EXPECT_EQ(kFastLocation.ToString(), stats[0].slowest_tasks[1].location);
+  EXPECT_EQ(3, stats[0].slowest_tasks[1].num_tasks);
+}
+
+TEST_F(ThreadCpuAccountingTest, ReportsBusiestNameFirst) {
+  {
+    ThreadCpuAccounting::ScopedTask task("idle", RTC_FROM_HERE);
+  }
+  {
+    ThreadCpuAccounting::ScopedTask task("busy", RTC_FROM_HERE);
+    SpendCpuTime(kBusyCpuTimeNs);
+  }
+  std::vector<ThreadCpuStats> stats = ThreadCpuAccounting::GetStats();
+  ASSERT_EQ(2u, stats.size());
+  EXPECT_EQ("busy", stats[0].name);
+  EXPECT_EQ("idle", stats[1].name);
+}
+
+TEST_F(ThreadCpuAccountingTest, DoesNothingWhenDisabled) {
+  ThreadCpuAccounting::SetEnabled(false);
+  {
+    ThreadCpuAccounting::ScopedTask task("thread", RTC_FROM_HERE);
+  }
+  EXPECT_TRUE(ThreadCpuAccounting::GetStats().empty());
+}
+
+TEST_F(ThreadCpuAccountingTest, AccountsMessagesOfNamedThread) {
+  Thread thread;
+  thread.SetName("accounted_thread", nullptr);
+  thread.Start();
+  thread.Invoke<void>(RTC_FROM_HERE, [] { SpendCpuTime(kBusyCpuTimeNs); });
+  thread.Stop();
+
+  std::vector<ThreadCpuStats> stats = ThreadCpuAccounting::GetStats();
+  const ThreadCpuStats* thread_stats = FindStats(stats, "accounted_thread");
+  ASSERT_TRUE(thread_stats);
+  EXPECT_GE(thread_stats->num_tasks, 1);
+  EXPECT_GE(thread_stats->cpu_time_ns, kBusyCpuTimeNs);
+}
+
+}  // namespace rtc
@@ -13,6 +13,7 @@
 #import <Foundation/Foundation.h>
 
 #include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
 
 /*
  * This file contains platform-specific implementations for several
@@ -71,7 +72,11 @@ bool Thread::ProcessMessages(int cmsLoop) {
       Message msg;
       if (!Get(&msg, cmsNext))
         return !IsQuitting();
-      Dispatch(&msg);
+      {
+        ThreadCpuAccounting::ScopedTask cpu_task(name_.c_str(),
+                                                 msg.posted_from);
+        Dispatch(&msg);
+      }
 
       if (cmsLoop != kForever) {
         cmsNext = static_cast<int>(TimeUntil(msEnd));
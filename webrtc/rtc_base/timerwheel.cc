@@ -0,0 +1,253 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/timerwheel.h"
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace rtc {
+
+// The wheel follows the classic hierarchical design: level 0 has one slot per
+// millisecond for the next 256 ms, and each further level has 64 slots, each
+// covering a whole turn of the level below. A timer is put on the finest level
+// whose range covers its expiry, in the slot selected by the corresponding
+// bits of the absolute expiry time. Whenever level 0 completes a turn, the
+// level 1 slot for the next turn is emptied and its timers are re-inserted,
+// which brings them down to level 0; the same happens for the higher levels
+// when the level below wraps. Timers beyond the last level wait on an overflow
+// list that is re-inserted whenever the last level wraps.
+
+TimerWheel::Timer::Timer() {}
+
+TimerWheel::Timer::~Timer() {
+  RTC_DCHECK(!is_scheduled());
+}
+
+void TimerWheel::Timer::Unlink() {
+  prev_->next_ = next_;
+  next_->prev_ = prev_;
+  prev_ = nullptr;
+  next_ = nullptr;
+}
+
+TimerWheel::TimerWheel(int64_t now_ms)
+    : cursor_ms_(now_ms),
+      slots_(kFirstLevelSlots + (kLevels - 2) * kLevelSlots + 1) {
+  for (Timer& slot : slots_) {
+    slot.prev_ = &slot;
+    slot.next_ = &slot;
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  // Leave remaining timers in a state their destructors accept.
+  for (Timer* timer : Timers()) {
+    timer->prev_ = nullptr;
+    timer->next_ = nullptr;
+  }
+  for (Timer& slot : slots_) {
+    slot.prev_ = nullptr;
+    slot.next_ = nullptr;
+  }
+}
+
+void TimerWheel::Schedule(Timer* timer, int64_t expiry_ms, int64_t now_ms) {
+  RTC_DCHECK(timer);
+  RTC_DCHECK(!timer->is_scheduled());
+  if (now_ms + 1 < cursor_ms_) {
+    Rebase(now_ms);
+  } else if (size_ == 0) {
+    // Nothing to cascade, so skip the idle time.
+    cursor_ms_ = std::max(cursor_ms_, now_ms);
+  }
+  timer->expiry_ms_ = expiry_ms;
+  Insert(timer);
+}
+
+void TimerWheel::Cancel(Timer* timer) {
+  RTC_DCHECK(timer);
+  if (!timer->is_scheduled())
+    return;
+  RTC_DCHECK_GT(level_size_[timer->level_], 0);
+  --level_size_[timer->level_];
+  --size_;
+  timer->Unlink();
+}
+
+void TimerWheel::Advance(int64_t now_ms, std::vector<Timer*>* expired) {
+  RTC_DCHECK(expired);
+  if (now_ms + 1 < cursor_ms_)
+    Rebase(now_ms);
+
+  while (cursor_ms_ <= now_ms) {
+    if (size_ == 0) {
+      cursor_ms_ = now_ms + 1;
+      break;
+    }
+
+    // With the finer levels empty, jump straight to the next time a slot of
+    // the finest non-empty level is cascaded.
+    int lowest = 0;
+    while (level_size_[lowest] == 0)
+      ++lowest;
+    if (lowest > 0) {
+      const int64_t mask = (int64_t{1} << SlotShift(lowest)) - 1;
+      if (cursor_ms_ & mask) {
+        cursor_ms_ = std::min(now_ms + 1, (cursor_ms_ | mask) + 1);
+        continue;
+      }
+    }
+
+    const int index = static_cast<int>(cursor_ms_ & (kFirstLevelSlots - 1));
+    if (index == 0) {
+      for (int level = 1; level < kLevels; ++level) {
+        int level_index =
+            level == kLevels - 1
+                ? 0
+                : static_cast<int>((cursor_ms_ >> SlotShift(level)) &
+                                   (kLevelSlots - 1));
+        Cascade(level, level_index);
+        if (level_index != 0)
+          break;
+      }
+    }
+
+    Timer* head = Slot(0, index);
+    while (head->next_ != head) {
+      Timer* timer = head->next_;
+      timer->Unlink();
+      --level_size_[0];
+      --size_;
+      expired->push_back(timer);
+    }
+    ++cursor_ms_;
+  }
+}
+
+bool TimerWheel::NextWakeup(int64_t* wakeup_ms) const {
+  RTC_DCHECK(wakeup_ms);
+  if (size_ == 0)
+    return false;
+
+  if (level_size_[0] > 0) {
+    // Level 0 timers all expire within 256 ms of the cursor, one slot per
+    // millisecond, so the first non-empty slot is exact.
+    for (int64_t time = cursor_ms_;; ++time) {
+      const Timer* head =
+          Slot(0, static_cast<int>(time & (kFirstLevelSlots - 1)));
+      if (head->next_ != head) {
+        *wakeup_ms = time;
+        return true;
+      }
+    }
+  }
+
+  // Otherwise nothing can expire before the finest non-empty level gets
+  // cascaded next.
+  int lowest = 1;
+  while (level_size_[lowest] == 0)
+    ++lowest;
+  const int64_t mask = (int64_t{1} << SlotShift(lowest)) - 1;
+  *wakeup_ms = (cursor_ms_ & mask) ? (cursor_ms_ | mask) + 1 : cursor_ms_;
+  return true;
+}
+
+std::vector<TimerWheel::Timer*> TimerWheel::Timers() const {
+  std::vector<Timer*> timers;
+  timers.reserve(size_);
+  for (const Timer& slot : slots_) {
+    for (Timer* timer = slot.next_; timer != &slot; timer = timer->next_)
+      timers.push_back(timer);
+  }
+  return timers;
+}
+
+// static
+int TimerWheel::SlotShift(int level) {
+  return level == 0 ? 0 : kFirstLevelBits + (level - 1) * kLevelBits;
+}
+
+TimerWheel::Timer* TimerWheel::Slot(int level, int index) {
+  return const_cast<Timer*>(
+      static_cast<const TimerWheel*>(this)->Slot(level, index));
+}
+
+const TimerWheel::Timer* TimerWheel::Slot(int level, int index) const {
+  if (level == 0)
+    return &slots_[index];
+  return &slots_[kFirstLevelSlots + (level - 1) * kLevelSlots + index];
+}
+
+void TimerWheel::Insert(Timer* timer) {
+  // Timers that are already due go in the slot processed next.
+  const int64_t expiry_ms = std::max(timer->expiry_ms_, cursor_ms_);
+  const int64_t delta_ms = expiry_ms - cursor_ms_;
+
+  int level = 0;
+  int index;
+  if (delta_ms < kFirstLevelSlots) {
+    index = static_cast<int>(expiry_ms & (kFirstLevelSlots - 1));
+  } else {
+    level = 1;
+    while (level < kLevels - 1 &&
+           delta_ms >= (int64_t{1} << (SlotShift(level) + kLevelBits))) {
+      ++level;
+    }
+    index = level == kLevels - 1
+                ? 0
+                : static_cast<int>((expiry_ms >> SlotShift(level)) &
+                                   (kLevelSlots - 1));
+  }
+
+  Timer* head = Slot(level, index);
+  timer->level_ = level;
+  timer->prev_ = head->prev_;
+  timer->next_ = head;
+  head->prev_->next_ = timer;
+  head->prev_ = timer;
+  ++level_size_[level];
+  ++size_;
+}
+
+void TimerWheel::Cascade(int level, int index) {
+  Timer* head = Slot(level, index);
+  if (head->next_ == head)
+    return;
+  // Detach the whole list first; Insert() may put timers that are a full turn
+  // or more ahead back into this same slot.
+  Timer* timer = head->next_;
+  Timer* const last = head->prev_;
+  head->next_ = head;
+  head->prev_ = head;
+  while (true) {
+    Timer* const next = timer->next_;
+    const bool is_last = timer == last;
+    --level_size_[level];
+    --size_;
+    Insert(timer);
+    if (is_last)
+      break;
+    timer = next;
+  }
+}
+
+void TimerWheel::Rebase(int64_t now_ms) {
+  std::vector<Timer*> timers = Timers();
+  for (Timer* timer : timers)
+    Cancel(timer);
+  RTC_DCHECK_EQ(0, size_);
+  cursor_ms_ = now_ms;
+  for (Timer* timer : timers)
+    Insert(timer);
+}
+
+}  // namespace rtc
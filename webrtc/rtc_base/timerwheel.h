@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_BASE_TIMERWHEEL_H_
+#define WEBRTC_RTC_BASE_TIMERWHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+
+namespace rtc {
+
+// Hierarchical timer wheel with millisecond resolution. Scheduling and
+// cancelling a timer are O(1); advancing the time is O(1) per elapsed
+// millisecond while timers less than 256 ms away are pending, plus the cost of
+// occasionally moving farther timers to a finer level ("cascading").
+//
+// Timers are intrusive: users derive from TimerWheel::Timer and own the
+// objects. A timer must be cancelled or have expired before it is deleted.
+// Not thread safe.
+class TimerWheel {
+ public:
+  class Timer {
+   public:
+    Timer();
+    ~Timer();
+
+    int64_t expiry_ms() const { return expiry_ms_; }
+    bool is_scheduled() const { return next_ != nullptr; }
+
+   private:
+    friend class TimerWheel;
+
+    void Unlink();
+
+    int64_t expiry_ms_ = 0;
+    Timer* prev_ = nullptr;
+    Timer* next_ = nullptr;
+    int level_ = 0;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Timer);
+  };
+
+  // |now_ms| is the time from which delays are measured, normally
+  // rtc::TimeMillis().
+  explicit TimerWheel(int64_t now_ms);
+  ~TimerWheel();
+
+  // Schedules |timer| to expire at |expiry_ms|, which may be in the past.
+  // |now_ms| lets the wheel detect that the clock was reset backwards (fake
+  // clocks in tests do this), in which case pending timers are rebucketed.
+  void Schedule(Timer* timer, int64_t expiry_ms, int64_t now_ms);
+  void Cancel(Timer* timer);
+
+  // Appends every timer with expiry_ms() <= |now_ms| to |expired| and
+  // unschedules it. Timers are appended in order of expiry, except that timers
+  // that were already due when scheduled come first.
+  void Advance(int64_t now_ms, std::vector<Timer*>* expired);
+
+  // Returns a time no later than the earliest expiry at which Advance() will
+  // return at least one timer, or another call to this function returns a
+  // later time. Exact while a timer is due within 256 ms. Returns false if
+  // there are no timers.
+  bool NextWakeup(int64_t* wakeup_ms) const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Returns all scheduled timers in no particular order, without unscheduling
+  // them.
+  std::vector<Timer*> Timers() const;
+
+ private:
+  static const int kLevels = 5;  // Four wheels and an overflow list.
+  static const int kFirstLevelBits = 8;
+  static const int kLevelBits = 6;
+  static const int kFirstLevelSlots = 1 << kFirstLevelBits;
+  static const int kLevelSlots = 1 << kLevelBits;
+
+  // log2 of the time span covered by one slot of |level|.
+  static int SlotShift(int level);
+  Timer* Slot(int level, int index);
+  const Timer* Slot(int level, int index) const;
+
+  void Insert(Timer* timer);
+  void Cascade(int level, int index);
+  void Rebase(int64_t now_ms);
+
+  // First unprocessed millisecond.
+  int64_t cursor_ms_;
+  size_t size_ = 0;
+  size_t level_size_[kLevels] = {};
+  // Sentinels of the circular slot lists: kFirstLevelSlots for level 0,
+  // kLevelSlots for each further wheel, then one for the overflow list.
+  std::vector<Timer> slots_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_RTC_BASE_TIMERWHEEL_H_
@@ -0,0 +1,181 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/timerwheel.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/random.h"
+
+namespace rtc {
+namespace {
+
+class TestTimer : public TimerWheel::Timer {
+ public:
+  explicit TestTimer(int id) : id(id) {}
+  const int id;
+};
+
+std::vector<int> ExpiredIds(TimerWheel* wheel, int64_t now_ms) {
+  std::vector<TimerWheel::Timer*> expired;
+  wheel->Advance(now_ms, &expired);
+  std::vector<int> ids;
+  for (TimerWheel::Timer* timer : expired)
+    ids.push_back(static_cast<TestTimer*>(timer)->id);
+  return ids;
+}
+
+}  // namespace
+
+TEST(TimerWheelTest, EmptyWheel) {
+  TimerWheel wheel(1000);
+  int64_t wakeup_ms;
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.NextWakeup(&wakeup_ms));
+  EXPECT_TRUE(ExpiredIds(&wheel, 100000).empty());
+}
+
+TEST(TimerWheelTest, ExpiresInOrder) {
+  TimerWheel wheel(0);
+  TestTimer t1(1), t2(2), t3(3);
+  wheel.Schedule(&t3, 30, 0);
+  wheel.Schedule(&t1, 10, 0);
+  wheel.Schedule(&t2, 20, 0);
+  EXPECT_EQ(3u, wheel.size());
+
+  int64_t wakeup_ms;
+  ASSERT_TRUE(wheel.NextWakeup(&wakeup_ms));
+  EXPECT_EQ(10, wakeup_ms);
+  EXPECT_TRUE(ExpiredIds(&wheel, 9).empty());
+  EXPECT_EQ(std::vector<int>({1}), ExpiredIds(&wheel, 10));
+  EXPECT_EQ(std::vector<int>({2, 3}), ExpiredIds(&wheel, 35));
+  EXPECT_FALSE(t1.is_scheduled());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, PastExpiryIsDueImmediately) {
+  TimerWheel wheel(1000);
+  TestTimer t1(1);
+  wheel.Schedule(&t1, 500, 1000);
+  int64_t wakeup_ms;
+  ASSERT_TRUE(wheel.NextWakeup(&wakeup_ms));
+  EXPECT_EQ(1000, wakeup_ms);
+  EXPECT_EQ(std::vector<int>({1}), ExpiredIds(&wheel, 1000));
+}
+
+TEST(TimerWheelTest, Cancel) {
+  TimerWheel wheel(0);
+  TestTimer t1(1), t2(2);
+  wheel.Schedule(&t1, 10, 0);
+  wheel.Schedule(&t2, 100000, 0);
+  wheel.Cancel(&t1);
+  wheel.Cancel(&t2);
+  // Cancelling an unscheduled timer is a no-op.
+  wheel.Cancel(&t2);
+  EXPECT_FALSE(t1.is_scheduled());
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_TRUE(ExpiredIds(&wheel, 200000).empty());
+}
+
+TEST(TimerWheelTest, CascadesFarTimers) {
+  TimerWheel wheel(0);
+  // One timer per level, plus one on the overflow list.
+  const int64_t kExpiries[] = {100, 5000, 300000, 20000000, 100000000};
+  std::vector<std::unique_ptr<TestTimer>> timers;
+  for (int64_t expiry : kExpiries) {
+    timers.emplace_back(new TestTimer(static_cast<int>(timers.size())));
+    wheel.Schedule(timers.back().get(), expiry, 0);
+  }
+
+  int64_t now = 0;
+  for (size_t i = 0; i < timers.size(); ++i) {
+    int64_t wakeup_ms;
+    // Follow the wakeups, as a message loop would.
+    while (true) {
+      ASSERT_TRUE(wheel.NextWakeup(&wakeup_ms));
+      ASSERT_LE(wakeup_ms, kExpiries[i]);
+      ASSERT_GT(wakeup_ms, now);
+      now = wakeup_ms;
+      std::vector<int> ids = ExpiredIds(&wheel, now);
+      if (!ids.empty()) {
+        EXPECT_EQ(std::vector<int>({static_cast<int>(i)}), ids);
+        EXPECT_EQ(kExpiries[i], now);
+        break;
+      }
+    }
+  }
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, ClockGoingBackwards) {
+  TimerWheel wheel(100000);
+  TestTimer t1(1), t2(2);
+  wheel.Schedule(&t1, 100500, 100000);
+  // A fake clock is reset to an earlier time.
+  wheel.Schedule(&t2, 600, 100);
+  EXPECT_EQ(std::vector<int>({2}), ExpiredIds(&wheel, 600));
+  EXPECT_TRUE(ExpiredIds(&wheel, 100499).empty());
+  EXPECT_EQ(std::vector<int>({1}), ExpiredIds(&wheel, 100500));
+}
+
+TEST(TimerWheelTest, MatchesReferenceWithRandomTimers) {
+  webrtc::Random random(12345);
+  TimerWheel wheel(0);
+  std::vector<std::unique_ptr<TestTimer>> timers;
+  std::multimap<int64_t, int> reference;
+  for (int i = 0; i < 2000; ++i) {
+    timers.emplace_back(new TestTimer(i));
+    // Mostly short delays, some up to several hours.
+    int64_t expiry = i % 10 == 0 ? random.Rand(0, 20000000)
+                                 : random.Rand(0, 5000);
+    wheel.Schedule(timers.back().get(), expiry, 0);
+    reference.insert(std::make_pair(expiry, i));
+  }
+  for (int i = 0; i < 2000; i += 7) {
+    wheel.Cancel(timers[i].get());
+    for (auto it = reference.begin(); it != reference.end(); ++it) {
+      if (it->second == i) {
+        reference.erase(it);
+        break;
+      }
+    }
+  }
+  EXPECT_EQ(reference.size(), wheel.size());
+
+  int64_t now = 0;
+  while (!reference.empty()) {
+    int64_t wakeup_ms;
+    ASSERT_TRUE(wheel.NextWakeup(&wakeup_ms));
+    ASSERT_LE(wakeup_ms, reference.begin()->first);
+    now = std::max(now + random.Rand(0, 3), wakeup_ms);
+    std::vector<TimerWheel::Timer*> expired;
+    wheel.Advance(now, &expired);
+    std::vector<int> expected;
+    while (!reference.empty() && reference.begin()->first <= now) {
+      expected.push_back(reference.begin()->second);
+      reference.erase(reference.begin());
+    }
+    std::vector<int> ids;
+    for (TimerWheel::Timer* timer : expired) {
+      EXPECT_LE(timer->expiry_ms(), now);
+      ids.push_back(static_cast<TestTimer*>(timer)->id);
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(expected, ids) << "at " << now;
+  }
+  EXPECT_TRUE(wheel.empty());
+}
+
+}  // namespace rtc
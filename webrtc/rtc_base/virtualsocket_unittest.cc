@@ -1103,6 +1103,47 @@ TEST_F(VirtualSocketServerTest, SetSendingBlockedWithTcpSocket) {
   EXPECT_TRUE(sink.Check(socket2.get(), SSE_READ));
 }
 
+// Packets in flight to a socket that is closed are dropped, without holding up
+// the packets in flight to the other sockets.
+TEST_F(VirtualSocketServerTest, DeliversInOrderPastClosedRecipient) {
+  AsyncSocket* socket1 =
+      ss_.CreateAsyncSocket(kIPv4AnyAddress.family(), SOCK_DGRAM);
+  AsyncSocket* socket2 =
+      ss_.CreateAsyncSocket(kIPv4AnyAddress.family(), SOCK_DGRAM);
+  AsyncSocket* socket3 =
+      ss_.CreateAsyncSocket(kIPv4AnyAddress.family(), SOCK_DGRAM);
+  socket1->Bind(kIPv4AnyAddress);
+  socket2->Bind(kIPv4AnyAddress);
+  socket3->Bind(kIPv4AnyAddress);
+  SocketAddress client1_addr = socket1->GetLocalAddress();
+  SocketAddress client2_addr = socket2->GetLocalAddress();
+  SocketAddress client3_addr = socket3->GetLocalAddress();
+  auto client1 =
+      MakeUnique<TestClient>(MakeUnique<AsyncUDPSocket>(socket1), &fake_clock_);
+  auto client2 =
+      MakeUnique<TestClient>(MakeUnique<AsyncUDPSocket>(socket2), &fake_clock_);
+  auto client3 =
+      MakeUnique<TestClient>(MakeUnique<AsyncUDPSocket>(socket3), &fake_clock_);
+
+  EXPECT_EQ(3, client1->SendTo("foo", 3, client2_addr));
+  EXPECT_EQ(3, client1->SendTo("bar", 3, client3_addr));
+  EXPECT_EQ(3, client1->SendTo("foo", 3, client2_addr));
+  EXPECT_EQ(3, client1->SendTo("baz", 3, client3_addr));
+  client2.reset();
+
+  SocketAddress addr;
+  EXPECT_TRUE(client3->CheckNextPacket("bar", 3, &addr));
+  EXPECT_EQ(client1_addr, addr);
+  EXPECT_TRUE(client3->CheckNextPacket("baz", 3, &addr));
+  EXPECT_TRUE(client3->CheckNoPacket());
+
+  // The packets that have been read are reused for the next ones.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(6, client1->SendTo("bizbaz", 6, client3_addr));
+    EXPECT_TRUE(client3->CheckNextPacket("bizbaz", 6, &addr));
+  }
+}
+
 TEST_F(VirtualSocketServerTest, CreatesStandardDistribution) {
   const uint32_t kTestMean[] = {10, 100, 333, 1000};
   const double kTestDev[] = { 0.25, 0.1, 0.01 };
@@ -52,45 +52,213 @@ const uint32_t TCP_MSS = 1400;        // Maximum segment size
 // Note: The current algorithm doesn't work for sample sizes smaller than this.
 const int NUM_SAMPLES = 1000;
 
+// Number of one millisecond slots of the timer wheel of the delivery queue.
+const int64_t kDeliverySlots = 1024;
+// Number of released packets kept for reuse.
+const size_t kMaxPooledPackets = 256;
+
 enum {
-  MSG_ID_PACKET,
+  MSG_ID_DELIVER_PACKETS,
   MSG_ID_ADDRESS_BOUND,
   MSG_ID_CONNECT,
   MSG_ID_DISCONNECT,
   MSG_ID_SIGNALREADEVENT,
 };
 
-// Packets are passed between sockets as messages.  We copy the data just like
-// the kernel does.
-class Packet : public MessageData {
+// Packets are passed between sockets through the delivery queue of the server.
+// We copy the data just like the kernel does, into buffers that are reused once
+// the packets have been read.
+class Packet {
  public:
-  Packet(const char* data, size_t size, const SocketAddress& from)
-        : size_(size), consumed_(0), from_(from) {
-    RTC_DCHECK(nullptr != data);
-    data_ = new char[size_];
-    memcpy(data_, data, size_);
-  }
+  Packet() : consumed_(0) {}
 
-  ~Packet() override {
-    delete[] data_;
+  void Assign(const char* data, size_t size, const SocketAddress& from) {
+    RTC_DCHECK(nullptr != data);
+    data_.assign(data, data + size);
+    consumed_ = 0;
+    from_ = from;
   }
 
-  const char* data() const { return data_ + consumed_; }
-  size_t size() const { return size_ - consumed_; }
+  const char* data() const { return data_.data() + consumed_; }
+  size_t size() const { return data_.size() - consumed_; }
   const SocketAddress& from() const { return from_; }
 
   // Remove the first size bytes from the data.
   void Consume(size_t size) {
-    RTC_DCHECK(size + consumed_ < size_);
+    RTC_DCHECK(size + consumed_ < data_.size());
     consumed_ += size;
   }
 
  private:
-  char* data_;
-  size_t size_, consumed_;
+  std::vector<char> data_;
+  size_t consumed_;
   SocketAddress from_;
 };
 
+// The packets in flight, delivered in the order of their delivery times, and
+// in the order they were sent for equal times. They are kept in a timer wheel
+// of one millisecond slots, and a message is posted for the next delivery due
+// instead of one for each packet, which keeps the message queue short however
+// many packets are in flight.
+class VirtualSocketServer::DeliveryQueue : public MessageHandler {
+ public:
+  explicit DeliveryQueue(VirtualSocketServer* server)
+      : server_(server),
+        slots_(kDeliverySlots),
+        size_(0),
+        next_sequence_number_(0),
+        cursor_ms_(0),
+        posted_time_ms_(-1) {}
+
+  ~DeliveryQueue() override {
+    for (const auto& slot : slots_) {
+      for (const Entry& entry : slot)
+        delete entry.packet;
+    }
+  }
+
+  void Add(int64_t time_ms, VirtualSocket* recipient, Packet* packet) {
+    CritScope cs(&crit_);
+    if (size_ == 0)
+      cursor_ms_ = TimeMillis();
+    time_ms = std::max(time_ms, cursor_ms_);
+    Entry entry = {time_ms, next_sequence_number_++, recipient, packet};
+    slots_[time_ms % kDeliverySlots].push_back(entry);
+    ++size_;
+    ++recipient->packets_in_flight_;
+    if (posted_time_ms_ < 0 || time_ms < posted_time_ms_)
+      PostAt(time_ms);
+  }
+
+  // Removes the packets in flight to |recipient|, and returns them.
+  void Cancel(VirtualSocket* recipient, std::vector<Packet*>* packets) {
+    CritScope cs(&crit_);
+    if (recipient->packets_in_flight_ == 0)
+      return;
+    for (auto& slot : slots_) {
+      auto it = std::remove_if(
+          slot.begin(), slot.end(), [recipient, packets](const Entry& entry) {
+            if (entry.recipient != recipient)
+              return false;
+            packets->push_back(entry.packet);
+            return true;
+          });
+      slot.erase(it, slot.end());
+    }
+    size_ -= recipient->packets_in_flight_;
+    recipient->packets_in_flight_ = 0;
+    if (size_ == 0 && server_->msg_queue_) {
+      server_->msg_queue_->Clear(this, MSG_ID_DELIVER_PACKETS);
+      posted_time_ms_ = -1;
+    }
+  }
+
+  void OnMessage(Message* msg) override {
+    RTC_DCHECK(msg->message_id == MSG_ID_DELIVER_PACKETS);
+    const int64_t now_ms = TimeMillis();
+    uint64_t end_sequence_number;
+    {
+      CritScope cs(&crit_);
+      // The message posted for the next delivery is the one to be dispatched
+      // first.
+      if (posted_time_ms_ <= now_ms)
+        posted_time_ms_ = -1;
+      // Packets sent as these are delivered wait for the next message, as if
+      // each had a message of its own.
+      end_sequence_number = next_sequence_number_;
+    }
+    while (true) {
+      Entry entry;
+      {
+        CritScope cs(&crit_);
+        if (!PopDue(now_ms, end_sequence_number, &entry)) {
+          const int64_t next_time_ms = NextTime();
+          if (next_time_ms >= 0 &&
+              (posted_time_ms_ < 0 || next_time_ms < posted_time_ms_)) {
+            PostAt(next_time_ms);
+          }
+          return;
+        }
+      }
+      // Delivered without holding the lock, since the recipient may send.
+      server_->DeliverPacket(entry.recipient, entry.packet);
+    }
+  }
+
+ private:
+  struct Entry {
+    int64_t time_ms;
+    uint64_t sequence_number;
+    VirtualSocket* recipient;
+    Packet* packet;
+  };
+
+  void PostAt(int64_t time_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    server_->msg_queue_->PostAt(RTC_FROM_HERE, time_ms, this,
+                                MSG_ID_DELIVER_PACKETS);
+    posted_time_ms_ = time_ms;
+  }
+
+  // Takes the first packet due by |now_ms| that was sent before the packet of
+  // |end_sequence_number|. The slots before the one of the packet are done
+  // with, and aren't looked at again.
+  bool PopDue(int64_t now_ms, uint64_t end_sequence_number, Entry* entry)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    if (size_ == 0)
+      return false;
+    // Packets are never added before |cursor_ms_|, and new ones never before
+    // |now_ms| either, so that the cursor doesn't pass any.
+    while (true) {
+      std::vector<Entry>& slot = slots_[cursor_ms_ % kDeliverySlots];
+      for (auto it = slot.begin(); it != slot.end(); ++it) {
+        if (it->time_ms == cursor_ms_ &&
+            it->sequence_number < end_sequence_number) {
+          *entry = *it;
+          slot.erase(it);
+          --size_;
+          --entry->recipient->packets_in_flight_;
+          return true;
+        }
+      }
+      if (cursor_ms_ >= now_ms)
+        return false;
+      ++cursor_ms_;
+    }
+  }
+
+  // Returns the time of the next delivery, or -1 if there is none.
+  int64_t NextTime() const EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    if (size_ == 0)
+      return -1;
+    for (int64_t time_ms = cursor_ms_; time_ms < cursor_ms_ + kDeliverySlots;
+         ++time_ms) {
+      for (const Entry& entry : slots_[time_ms % kDeliverySlots]) {
+        if (entry.time_ms == time_ms)
+          return time_ms;
+      }
+    }
+    // All the packets are a turn of the wheel or more away.
+    int64_t next_time_ms = -1;
+    for (const auto& slot : slots_) {
+      for (const Entry& entry : slot) {
+        if (next_time_ms < 0 || entry.time_ms < next_time_ms)
+          next_time_ms = entry.time_ms;
+      }
+    }
+    return next_time_ms;
+  }
+
+  VirtualSocketServer* const server_;
+  CriticalSection crit_;
+  std::vector<std::vector<Entry>> slots_ GUARDED_BY(crit_);
+  size_t size_ GUARDED_BY(crit_);
+  uint64_t next_sequence_number_ GUARDED_BY(crit_);
+  // The time of the slot to deliver packets from next.
+  int64_t cursor_ms_ GUARDED_BY(crit_);
+  // The time of the earliest message posted, or -1 if there is none.
+  int64_t posted_time_ms_ GUARDED_BY(crit_);
+};
+
 struct MessageAddress : public MessageData {
   explicit MessageAddress(const SocketAddress& a) : addr(a) { }
   SocketAddress addr;
@@ -120,9 +288,10 @@ VirtualSocket::VirtualSocket(VirtualSocketServer* server,
 VirtualSocket::~VirtualSocket() {
   Close();
 
+  server_->CancelPackets(this);
   for (RecvBuffer::iterator it = recv_buffer_.begin(); it != recv_buffer_.end();
        ++it) {
-    delete *it;
+    server_->ReleasePacket(*it);
   }
 }
 
@@ -224,6 +393,7 @@ int VirtualSocket::Close() {
       delete data;
     }
     // Clear incoming packets and disconnect messages
+    server_->CancelPackets(this);
     if (server_->msg_queue_) {
       server_->msg_queue_->Clear(this);
     }
@@ -296,7 +466,7 @@ int VirtualSocket::RecvFrom(void* pv,
     packet->Consume(data_read);
   } else {
     recv_buffer_.pop_front();
-    delete packet;
+    server_->ReleasePacket(packet);
   }
 
   // To behave like a real socket, SignalReadEvent should fire in the next
@@ -389,16 +559,7 @@ int VirtualSocket::SetOption(Option opt, int value) {
 }
 
 void VirtualSocket::OnMessage(Message* pmsg) {
-  if (pmsg->message_id == MSG_ID_PACKET) {
-    RTC_DCHECK(nullptr != pmsg->pdata);
-    Packet* packet = static_cast<Packet*>(pmsg->pdata);
-
-    recv_buffer_.push_back(packet);
-
-    if (async_) {
-      SignalReadEvent(this);
-    }
-  } else if (pmsg->message_id == MSG_ID_CONNECT) {
+  if (pmsg->message_id == MSG_ID_CONNECT) {
     RTC_DCHECK(nullptr != pmsg->pdata);
     MessageAddress* data = static_cast<MessageAddress*>(pmsg->pdata);
     if (listen_queue_ != nullptr) {
@@ -542,11 +703,13 @@ VirtualSocketServer::VirtualSocketServer(FakeClock* fake_clock)
       delay_mean_(0),
       delay_stddev_(0),
       delay_samples_(NUM_SAMPLES),
-      drop_prob_(0.0) {
+      drop_prob_(0.0),
+      delivery_queue_(new DeliveryQueue(this)) {
   UpdateDelayDistribution();
 }
 
 VirtualSocketServer::~VirtualSocketServer() {
+  delivery_queue_.reset();
   delete bindings_;
   delete connections_;
 }
@@ -978,8 +1141,8 @@ void VirtualSocketServer::AddPacketToNetwork(VirtualSocket* sender,
     sender_addr.SetIP(default_ip);
   }
 
-  // Post the packet as a message to be delivered (on our own thread)
-  Packet* p = new Packet(data, data_size, sender_addr);
+  // Queue the packet to be delivered (on our own thread)
+  Packet* p = CreatePacket(data, data_size, sender_addr);
 
   int64_t ts = TimeAfter(send_delay + transit_delay);
   if (ordered) {
@@ -989,7 +1152,47 @@ void VirtualSocketServer::AddPacketToNetwork(VirtualSocket* sender,
     // delivery time only needs to be updated when it has ordered delivery.
     sender->last_delivery_time_ = ts;
   }
-  msg_queue_->PostAt(RTC_FROM_HERE, ts, recipient, MSG_ID_PACKET, p);
+  delivery_queue_->Add(ts, recipient, p);
+}
+
+Packet* VirtualSocketServer::CreatePacket(const char* data,
+                                          size_t size,
+                                          const SocketAddress& from) {
+  std::unique_ptr<Packet> packet;
+  {
+    CritScope cs(&packet_pool_crit_);
+    if (!packet_pool_.empty()) {
+      packet = std::move(packet_pool_.back());
+      packet_pool_.pop_back();
+    }
+  }
+  if (!packet)
+    packet.reset(new Packet());
+  packet->Assign(data, size, from);
+  return packet.release();
+}
+
+void VirtualSocketServer::ReleasePacket(Packet* packet) {
+  std::unique_ptr<Packet> released(packet);
+  CritScope cs(&packet_pool_crit_);
+  if (packet_pool_.size() < kMaxPooledPackets)
+    packet_pool_.push_back(std::move(released));
+}
+
+void VirtualSocketServer::CancelPackets(VirtualSocket* socket) {
+  std::vector<Packet*> packets;
+  delivery_queue_->Cancel(socket, &packets);
+  for (Packet* packet : packets)
+    ReleasePacket(packet);
+}
+
+void VirtualSocketServer::DeliverPacket(VirtualSocket* recipient,
+                                        Packet* packet) {
+  recipient->recv_buffer_.push_back(packet);
+
+  if (recipient->async_) {
+    recipient->SignalReadEvent(recipient);
+  }
 }
 
 void VirtualSocketServer::PurgeNetworkPackets(VirtualSocket* socket,
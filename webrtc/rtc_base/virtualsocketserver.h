@@ -13,19 +13,23 @@
 
 #include <deque>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/fakeclock.h"
 #include "webrtc/rtc_base/messagequeue.h"
+#include "webrtc/rtc_base/socketaddresspair.h"
 #include "webrtc/rtc_base/socketserver.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 
 namespace rtc {
 
 class Packet;
 class VirtualSocket;
-class SocketAddressPair;
 
 // Simulates a network in the same manner as a loopback interface.  The
 // interface can create as many addresses as you want.  All of the sockets
@@ -251,11 +255,34 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
  private:
   friend class VirtualSocket;
 
+  class DeliveryQueue;
+
+  struct SocketAddressPairHasher {
+    size_t operator()(const SocketAddressPair& pair) const {
+      return pair.Hash();
+    }
+  };
+
+  // Takes a packet from the pool of released packets, or creates one if there
+  // are none.
+  Packet* CreatePacket(const char* data,
+                       size_t size,
+                       const SocketAddress& from);
+  // Returns a packet that has been read, or dropped, to the pool.
+  void ReleasePacket(Packet* packet);
+  // Removes the packets in flight to |socket| from the network.
+  void CancelPackets(VirtualSocket* socket);
+  // Hands a packet that has crossed the network to |recipient|.
+  void DeliverPacket(VirtualSocket* recipient, Packet* packet);
+
   // Sending was previously blocked, but now isn't.
   sigslot::signal0<> SignalReadyToSend;
 
-  typedef std::map<SocketAddress, VirtualSocket*> AddressMap;
-  typedef std::map<SocketAddressPair, VirtualSocket*> ConnectionMap;
+  typedef std::unordered_map<SocketAddress, VirtualSocket*, SocketAddressHasher>
+      AddressMap;
+  typedef std::
+      unordered_map<SocketAddressPair, VirtualSocket*, SocketAddressPairHasher>
+          ConnectionMap;
 
   // May be null if the test doesn't use a fake clock, or it does but doesn't
   // use ProcessMessagesUntilIdle.
@@ -290,6 +317,13 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
 
   double drop_prob_;
   bool sending_blocked_ = false;
+
+  // The packets in flight, in the order they are to be delivered.
+  std::unique_ptr<DeliveryQueue> delivery_queue_;
+
+  CriticalSection packet_pool_crit_;
+  std::vector<std::unique_ptr<Packet>> packet_pool_
+      GUARDED_BY(packet_pool_crit_);
   RTC_DISALLOW_COPY_AND_ASSIGN(VirtualSocketServer);
 };
 
@@ -382,6 +416,9 @@ class VirtualSocket : public AsyncSocket,
 
   // Data which has been received from the network
   RecvBuffer recv_buffer_;
+  // The number of packets this socket is the recipient of that are in the
+  // delivery queue of the server. Guarded by the lock of the queue.
+  size_t packets_in_flight_ = 0;
   // The amount of data which is in flight or in recv_buffer_
   size_t recv_buffer_size_;
 
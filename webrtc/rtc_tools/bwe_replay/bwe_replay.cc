@@ -0,0 +1,335 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_tools/bwe_replay/bwe_replay.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "webrtc/config.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/modules/congestion_controller/include/send_side_congestion_controller.h"
+#include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/pacing/packet_router.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/rate_statistics.h"
+#include "webrtc/rtc_base/socket.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace bwe_replay {
+namespace {
+
+// The window of the acked bitrate that the target bitrate is compared to.
+constexpr int64_t kAckedBitrateWindowMs = 500;
+
+class TargetBitrateObserver : public SendSideCongestionController::Observer {
+ public:
+  TargetBitrateObserver() : bitrate_bps_(0) {}
+
+  void OnNetworkChanged(uint32_t bitrate_bps,
+                        uint8_t fraction_loss,
+                        int64_t rtt_ms,
+                        int64_t probing_interval_ms) override {
+    bitrate_bps_ = bitrate_bps;
+  }
+
+  uint32_t bitrate_bps() const { return bitrate_bps_; }
+
+ private:
+  uint32_t bitrate_bps_;
+};
+
+struct SweepState {
+  const std::vector<Trace>* traces;
+  const std::vector<Config>* configs;
+  std::vector<Result>* results;
+  volatile int next_job;
+};
+
+void RunSweepJobs(void* obj) {
+  SweepState* state = static_cast<SweepState*>(obj);
+  const size_t num_jobs = state->results->size();
+  while (true) {
+    const size_t job = rtc::AtomicOps::Increment(&state->next_job) - 1;
+    if (job >= num_jobs)
+      return;
+    const size_t num_configs = state->configs->size();
+    (*state->results)[job] = Replay((*state->traces)[job / num_configs],
+                                    (*state->configs)[job % num_configs]);
+  }
+}
+
+}  // namespace
+
+Trace::Trace() = default;
+Trace::Trace(Trace&&) = default;
+Trace::~Trace() = default;
+Trace& Trace::operator=(Trace&&) = default;
+
+Trace TraceFromEventLog(const ParsedRtcEventLog& parsed_log,
+                        const std::string& name) {
+  Trace trace;
+  trace.name = name;
+
+  // Used for streams whose configuration is not in the log.
+  RtpHeaderExtensionMap default_extension_map;
+  default_extension_map.Register<TransportSequenceNumber>(
+      RtpExtension::kTransportSequenceNumberDefaultId);
+
+  uint8_t last_incoming_rtcp_packet[IP_PACKET_SIZE];
+  size_t last_incoming_rtcp_packet_length = 0;
+  for (size_t i = 0; i < parsed_log.GetNumberOfEvents(); ++i) {
+    PacketDirection direction;
+    uint8_t packet[IP_PACKET_SIZE];
+    size_t header_length;
+    size_t total_length;
+    switch (parsed_log.GetEventType(i)) {
+      case ParsedRtcEventLog::RTP_EVENT: {
+        RtpHeaderExtensionMap* extension_map = parsed_log.GetRtpHeader(
+            i, &direction, packet, &header_length, &total_length);
+        if (direction != kOutgoingPacket)
+          break;
+        RtpUtility::RtpHeaderParser rtp_parser(packet, header_length);
+        RTPHeader header;
+        rtp_parser.Parse(&header, extension_map ? extension_map
+                                                : &default_extension_map);
+        if (!header.extension.hasTransportSequenceNumber)
+          break;
+        trace.sent_packets.push_back(
+            {parsed_log.GetTimestamp(i), header.ssrc,
+             header.extension.transportSequenceNumber, total_length});
+        break;
+      }
+      case ParsedRtcEventLog::RTCP_EVENT: {
+        parsed_log.GetRtcpPacket(i, &direction, packet, &total_length);
+        if (direction != kIncomingPacket)
+          break;
+        // Incoming RTCP packets are logged for both audio and video, so skip
+        // the second copy.
+        RTC_CHECK_LE(total_length, IP_PACKET_SIZE);
+        if (total_length == last_incoming_rtcp_packet_length &&
+            memcmp(last_incoming_rtcp_packet, packet, total_length) == 0) {
+          break;
+        }
+        memcpy(last_incoming_rtcp_packet, packet, total_length);
+        last_incoming_rtcp_packet_length = total_length;
+
+        rtcp::CommonHeader header;
+        const uint8_t* packet_end = packet + total_length;
+        for (const uint8_t* block = packet; block < packet_end;
+             block = header.NextPacket()) {
+          if (!header.Parse(block, packet_end - block))
+            break;
+          if (header.type() != rtcp::TransportFeedback::kPacketType ||
+              header.fmt() != rtcp::TransportFeedback::kFeedbackMessageType) {
+            continue;
+          }
+          std::unique_ptr<rtcp::TransportFeedback> feedback(
+              new rtcp::TransportFeedback());
+          if (feedback->Parse(header)) {
+            trace.feedback.push_back(
+                {parsed_log.GetTimestamp(i), std::move(feedback)});
+          }
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return trace;
+}
+
+Result Replay(const Trace& trace, const Config& config) {
+  Result result;
+  result.trace_name = trace.name;
+  result.config = config;
+  if (trace.sent_packets.empty())
+    return result;
+
+  int64_t start_time_us = trace.sent_packets.front().send_time_us;
+  if (!trace.feedback.empty())
+    start_time_us =
+        std::min(start_time_us, trace.feedback.front().receive_time_us);
+  SimulatedClock clock(start_time_us);
+  TargetBitrateObserver observer;
+  RtcEventLogNullImpl null_event_log;
+  PacketRouter packet_router;
+  PacedSender pacer(&clock, &packet_router, &null_event_log);
+  SendSideCongestionController cc(&clock, &observer, &null_event_log, &pacer);
+  cc.SetBweBitrates(config.min_bitrate_bps, config.start_bitrate_bps,
+                    config.max_bitrate_bps);
+
+  auto sent_packet = trace.sent_packets.begin();
+  auto feedback = trace.feedback.begin();
+  const int64_t kNever = std::numeric_limits<int64_t>::max();
+  auto NextSendTime = [&]() {
+    return sent_packet != trace.sent_packets.end() ? sent_packet->send_time_us
+                                                   : kNever;
+  };
+  auto NextFeedbackTime = [&]() {
+    return feedback != trace.feedback.end() ? feedback->receive_time_us
+                                            : kNever;
+  };
+  int64_t next_process_time_us = start_time_us;
+
+  RateStatistics acked_bitrate(kAckedBitrateWindowMs, 8000);
+  // Integral of the target bitrate over time, in bits per second times
+  // microseconds.
+  double target_bitrate_integral = 0;
+  size_t acked_bytes = 0;
+  size_t num_received = 0;
+  size_t num_lost = 0;
+  size_t num_rate_checks = 0;
+  size_t num_overshoots = 0;
+  std::vector<int64_t> one_way_delays_ms;
+
+  int64_t time_us = start_time_us;
+  while (true) {
+    const int64_t next_event_time_us = std::min(
+        {NextSendTime(), NextFeedbackTime(), next_process_time_us});
+    if (NextSendTime() == kNever && NextFeedbackTime() == kNever)
+      break;
+    target_bitrate_integral += static_cast<double>(observer.bitrate_bps()) *
+                               (next_event_time_us - time_us);
+    time_us = next_event_time_us;
+    clock.AdvanceTimeMicroseconds(time_us - clock.TimeInMicroseconds());
+
+    if (NextFeedbackTime() == time_us) {
+      cc.OnTransportFeedback(*feedback->packet);
+      std::vector<PacketFeedback> packets = cc.GetTransportFeedbackVector();
+      std::sort(packets.begin(), packets.end(),
+                [](const PacketFeedback& a, const PacketFeedback& b) {
+                  return a.arrival_time_ms < b.arrival_time_ms;
+                });
+      for (const PacketFeedback& packet : packets) {
+        if (packet.arrival_time_ms == PacketFeedback::kNotReceived) {
+          ++num_lost;
+          continue;
+        }
+        ++num_received;
+        acked_bytes += packet.payload_size;
+        acked_bitrate.Update(packet.payload_size, packet.arrival_time_ms);
+        if (packet.send_time_ms >= 0)
+          one_way_delays_ms.push_back(packet.arrival_time_ms -
+                                      packet.send_time_ms);
+      }
+      if (!packets.empty()) {
+        rtc::Optional<uint32_t> rate_bps =
+            acked_bitrate.Rate(packets.back().arrival_time_ms);
+        if (rate_bps) {
+          ++num_rate_checks;
+          if (observer.bitrate_bps() > *rate_bps)
+            ++num_overshoots;
+        }
+      }
+      ++feedback;
+    }
+    if (NextSendTime() == time_us) {
+      cc.AddPacket(sent_packet->ssrc, sent_packet->transport_sequence_number,
+                   sent_packet->size, PacedPacketInfo());
+      cc.OnSentPacket(rtc::SentPacket(sent_packet->transport_sequence_number,
+                                      sent_packet->send_time_us / 1000));
+      ++sent_packet;
+    }
+    if (next_process_time_us <= time_us) {
+      cc.Process();
+      next_process_time_us =
+          time_us + std::max<int64_t>(cc.TimeUntilNextProcess(), 0) * 1000;
+      // Always make progress, even if the controller wants to run at once.
+      if (next_process_time_us == time_us)
+        next_process_time_us += 1000;
+    }
+  }
+
+  const int64_t duration_us = time_us - start_time_us;
+  if (duration_us <= 0)
+    return result;
+  result.duration_s = duration_us / 1e6;
+  result.average_target_bitrate_bps = target_bitrate_integral / duration_us;
+  result.average_acked_bitrate_bps = 8 * acked_bytes / result.duration_s;
+  if (result.average_target_bitrate_bps > 0) {
+    result.utilization =
+        result.average_acked_bitrate_bps / result.average_target_bitrate_bps;
+  }
+  if (num_rate_checks > 0)
+    result.overshoot_fraction = static_cast<double>(num_overshoots) /
+                                num_rate_checks;
+  if (num_received + num_lost > 0)
+    result.loss_fraction = static_cast<double>(num_lost) /
+                           (num_received + num_lost);
+  if (!one_way_delays_ms.empty()) {
+    const int64_t min_delay_ms =
+        *std::min_element(one_way_delays_ms.begin(), one_way_delays_ms.end());
+    double sum_ms = 0;
+    for (int64_t& delay_ms : one_way_delays_ms) {
+      delay_ms -= min_delay_ms;
+      sum_ms += delay_ms;
+    }
+    result.average_queuing_delay_ms = sum_ms / one_way_delays_ms.size();
+    auto p95 = one_way_delays_ms.begin() + one_way_delays_ms.size() * 95 / 100;
+    std::nth_element(one_way_delays_ms.begin(), p95, one_way_delays_ms.end());
+    result.p95_queuing_delay_ms = *p95;
+  }
+  return result;
+}
+
+std::vector<Result> ReplaySweep(const std::vector<Trace>& traces,
+                                const std::vector<Config>& configs,
+                                int num_threads) {
+  std::vector<Result> results(traces.size() * configs.size());
+  SweepState state = {&traces, &configs, &results, 0};
+  num_threads = std::min(num_threads, static_cast<int>(results.size()));
+  if (num_threads <= 1) {
+    RunSweepJobs(&state);
+    return results;
+  }
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&RunSweepJobs, &state, "BweReplaySweep"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  return results;
+}
+
+void WriteCsvHeader(FILE* file) {
+  fprintf(file,
+          "trace,min_bitrate_bps,start_bitrate_bps,max_bitrate_bps,"
+          "duration_s,average_target_bitrate_bps,average_acked_bitrate_bps,"
+          "utilization,overshoot_fraction,average_queuing_delay_ms,"
+          "p95_queuing_delay_ms,loss_fraction\n");
+}
+
+void WriteCsvRow(const Result& result, FILE* file) {
+  fprintf(file, "%s,%d,%d,%d,%.3f,%.0f,%.0f,%.4f,%.4f,%.2f,%.2f,%.4f\n",
+          result.trace_name.c_str(), result.config.min_bitrate_bps,
+          result.config.start_bitrate_bps, result.config.max_bitrate_bps,
+          result.duration_s, result.average_target_bitrate_bps,
+          result.average_acked_bitrate_bps, result.utilization,
+          result.overshoot_fraction, result.average_queuing_delay_ms,
+          result.p95_queuing_delay_ms, result.loss_fraction);
+}
+
+}  // namespace bwe_replay
+}  // namespace webrtc
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_TOOLS_BWE_REPLAY_BWE_REPLAY_H_
+#define WEBRTC_RTC_TOOLS_BWE_REPLAY_BWE_REPLAY_H_
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+
+namespace webrtc {
+
+class ParsedRtcEventLog;
+
+namespace bwe_replay {
+
+// The outgoing packets and the incoming transport feedback of a call, which
+// is all the send-side congestion controller looks at.
+struct Trace {
+  struct SentPacket {
+    int64_t send_time_us;
+    uint32_t ssrc;
+    uint16_t transport_sequence_number;
+    size_t size;
+  };
+  struct Feedback {
+    int64_t receive_time_us;
+    std::unique_ptr<rtcp::TransportFeedback> packet;
+  };
+
+  Trace();
+  Trace(Trace&&);
+  ~Trace();
+  Trace& operator=(Trace&&);
+
+  std::string name;
+  // Both sorted by time.
+  std::vector<SentPacket> sent_packets;
+  std::vector<Feedback> feedback;
+};
+
+// Extracts the outgoing RTP packets with a transport sequence number and the
+// incoming transport feedback from |parsed_log|.
+Trace TraceFromEventLog(const ParsedRtcEventLog& parsed_log,
+                        const std::string& name);
+
+struct Config {
+  int min_bitrate_bps = 0;
+  int start_bitrate_bps = 300000;
+  // -1 means no limit.
+  int max_bitrate_bps = -1;
+};
+
+// Since the trace is replayed as it was recorded, the delay, loss and acked
+// bitrate are those of the recorded call. What the configuration changes is
+// the target bitrate, and so how closely it tracks the acked bitrate.
+struct Result {
+  std::string trace_name;
+  Config config;
+  double duration_s = 0;
+  // Averages over the duration of the trace.
+  double average_target_bitrate_bps = 0;
+  double average_acked_bitrate_bps = 0;
+  // The acked bitrate divided by the target bitrate.
+  double utilization = 0;
+  // The fraction of feedback reports at which the target bitrate was above
+  // the acked bitrate of the last 500 ms.
+  double overshoot_fraction = 0;
+  // Queuing delay, relative to the smallest one-way delay of the trace.
+  double average_queuing_delay_ms = 0;
+  double p95_queuing_delay_ms = 0;
+  double loss_fraction = 0;
+};
+
+// Runs a SendSideCongestionController over |trace| on a simulated clock, as
+// fast as possible.
+Result Replay(const Trace& trace, const Config& config);
+
+// Replays every trace with every configuration, spread over |num_threads|
+// threads. The results are in the order of the traces, and for each trace in
+// the order of the configurations.
+std::vector<Result> ReplaySweep(const std::vector<Trace>& traces,
+                                const std::vector<Config>& configs,
+                                int num_threads);
+
+void WriteCsvHeader(FILE* file);
+void WriteCsvRow(const Result& result, FILE* file);
+
+}  // namespace bwe_replay
+}  // namespace webrtc
+
+#endif  // WEBRTC_RTC_TOOLS_BWE_REPLAY_BWE_REPLAY_H_
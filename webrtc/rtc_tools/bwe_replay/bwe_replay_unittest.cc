@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_tools/bwe_replay/bwe_replay.h"
+
+#include <utility>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace bwe_replay {
+namespace {
+
+constexpr uint32_t kSsrc = 1234;
+constexpr size_t kPacketSize = 1200;
+constexpr int64_t kSendIntervalUs = 10000;
+constexpr int64_t kFeedbackIntervalUs = 100000;
+constexpr int64_t kOneWayDelayUs = 50000;
+
+// A call that sends a packet every 10 ms over a path with a constant delay,
+// and drops every |loss_interval|th packet if |loss_interval| is positive.
+Trace CreateTrace(const std::string& name,
+                  int64_t duration_us,
+                  int loss_interval) {
+  Trace trace;
+  trace.name = name;
+  const int64_t kStartTimeUs = 1000000;
+  uint16_t sequence_number = 0;
+  std::unique_ptr<rtcp::TransportFeedback> feedback;
+  for (int64_t time_us = kStartTimeUs; time_us < kStartTimeUs + duration_us;
+       time_us += kSendIntervalUs) {
+    trace.sent_packets.push_back(
+        {time_us, kSsrc, sequence_number, kPacketSize});
+    if (!feedback) {
+      feedback.reset(new rtcp::TransportFeedback());
+      feedback->SetBase(sequence_number, time_us + kOneWayDelayUs);
+    }
+    if (loss_interval <= 0 || sequence_number % loss_interval != 0)
+      feedback->AddReceivedPacket(sequence_number, time_us + kOneWayDelayUs);
+    ++sequence_number;
+    if (sequence_number * kSendIntervalUs % kFeedbackIntervalUs == 0) {
+      trace.feedback.push_back(
+          {time_us + kOneWayDelayUs + 1000, std::move(feedback)});
+    }
+  }
+  return trace;
+}
+
+}  // namespace
+
+TEST(BweReplayTest, ReplaysConstantDelayPath) {
+  Trace trace = CreateTrace("trace", 20000000, 0);
+  Config config;
+  Result result = Replay(trace, config);
+  EXPECT_EQ("trace", result.trace_name);
+  EXPECT_NEAR(20.0, result.duration_s, 0.1);
+  EXPECT_NEAR(8 * kPacketSize * 100, result.average_acked_bitrate_bps,
+              8 * kPacketSize * 2);
+  EXPECT_GT(result.average_target_bitrate_bps, 0);
+  EXPECT_EQ(0, result.average_queuing_delay_ms);
+  EXPECT_EQ(0, result.p95_queuing_delay_ms);
+  EXPECT_EQ(0, result.loss_fraction);
+}
+
+TEST(BweReplayTest, ReportsLoss) {
+  Trace trace = CreateTrace("trace", 20000000, 10);
+  Result result = Replay(trace, Config());
+  EXPECT_NEAR(0.1, result.loss_fraction, 0.01);
+}
+
+TEST(BweReplayTest, StartBitrateChangesTarget) {
+  Trace trace = CreateTrace("trace", 5000000, 0);
+  Config low;
+  low.start_bitrate_bps = 100000;
+  Config high;
+  high.start_bitrate_bps = 2000000;
+  EXPECT_LT(Replay(trace, low).average_target_bitrate_bps,
+            Replay(trace, high).average_target_bitrate_bps);
+}
+
+TEST(BweReplayTest, SweepMatchesSerialReplay) {
+  std::vector<Trace> traces;
+  traces.push_back(CreateTrace("first", 5000000, 0));
+  traces.push_back(CreateTrace("second", 5000000, 20));
+  std::vector<Config> configs(3);
+  configs[0].start_bitrate_bps = 100000;
+  configs[1].start_bitrate_bps = 500000;
+  configs[2].max_bitrate_bps = 800000;
+
+  std::vector<Result> results = ReplaySweep(traces, configs, 4);
+  ASSERT_EQ(traces.size() * configs.size(), results.size());
+  for (size_t i = 0; i < traces.size(); ++i) {
+    for (size_t j = 0; j < configs.size(); ++j) {
+      const Result& result = results[i * configs.size() + j];
+      const Result expected = Replay(traces[i], configs[j]);
+      EXPECT_EQ(traces[i].name, result.trace_name);
+      EXPECT_EQ(configs[j].start_bitrate_bps, result.config.start_bitrate_bps);
+      EXPECT_EQ(configs[j].max_bitrate_bps, result.config.max_bitrate_bps);
+      EXPECT_EQ(expected.average_target_bitrate_bps,
+                result.average_target_bitrate_bps);
+      EXPECT_EQ(expected.overshoot_fraction, result.overshoot_fraction);
+      EXPECT_EQ(expected.loss_fraction, result.loss_fraction);
+    }
+  }
+}
+
+}  // namespace bwe_replay
+}  // namespace webrtc
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/rtc_base/flags.h"
+#include "webrtc/rtc_tools/bwe_replay/bwe_replay.h"
+#include "webrtc/test/field_trial.h"
+
+DEFINE_string(min_bitrates,
+              "0",
+              "Comma separated list of minimum bitrates, in bps, to sweep.");
+DEFINE_string(start_bitrates,
+              "300000",
+              "Comma separated list of start bitrates, in bps, to sweep.");
+DEFINE_string(max_bitrates,
+              "-1",
+              "Comma separated list of maximum bitrates, in bps, to sweep. "
+              "-1 means no limit.");
+DEFINE_int(threads, 1, "The number of threads to replay the logs on.");
+DEFINE_string(output, "", "The CSV file to write. Defaults to stdout.");
+DEFINE_string(
+    force_fieldtrials,
+    "",
+    "Field trials control experimental feature code which can be forced. "
+    "E.g. running with --force_fieldtrials=WebRTC-FooFeature/Enabled/"
+    " will assign the group Enabled to field trial WebRTC-FooFeature. Multiple "
+    "trials are separated by \"/\"");
+DEFINE_bool(help, false, "prints this message");
+
+namespace {
+
+bool ParseBitrates(const std::string& list, std::vector<int>* bitrates) {
+  std::istringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    char* end;
+    const long bitrate = strtol(item.c_str(), &end, 10);  // NOLINT
+    if (item.empty() || *end != '\0')
+      return false;
+    bitrates->push_back(static_cast<int>(bitrate));
+  }
+  return !bitrates->empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Replays the outgoing packets and the transport feedback of WebRTC "
+      "event logs through the send-side bandwidth estimator, for every "
+      "combination of the given bitrates, and writes the results as CSV.\n"
+      "Example usage:\n" +
+      program_name +
+      " --start_bitrates=300000,1000000 --threads=8 <logfile>...\n" + "Run " +
+      program_name + " --help for a list of command line options\n";
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (argc < 2 || FLAG_help) {
+    std::cout << usage;
+    if (FLAG_help)
+      rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+
+  webrtc::test::InitFieldTrialsFromString(FLAG_force_fieldtrials);
+
+  std::vector<int> min_bitrates;
+  std::vector<int> start_bitrates;
+  std::vector<int> max_bitrates;
+  if (!ParseBitrates(FLAG_min_bitrates, &min_bitrates) ||
+      !ParseBitrates(FLAG_start_bitrates, &start_bitrates) ||
+      !ParseBitrates(FLAG_max_bitrates, &max_bitrates)) {
+    std::cerr << "Could not parse the bitrate lists." << std::endl;
+    return 1;
+  }
+  std::vector<webrtc::bwe_replay::Config> configs;
+  for (int min_bitrate_bps : min_bitrates) {
+    for (int start_bitrate_bps : start_bitrates) {
+      for (int max_bitrate_bps : max_bitrates) {
+        webrtc::bwe_replay::Config config;
+        config.min_bitrate_bps = min_bitrate_bps;
+        config.start_bitrate_bps = start_bitrate_bps;
+        config.max_bitrate_bps = max_bitrate_bps;
+        configs.push_back(config);
+      }
+    }
+  }
+
+  std::vector<webrtc::bwe_replay::Trace> traces;
+  for (int i = 1; i < argc; ++i) {
+    webrtc::ParsedRtcEventLog parsed_log;
+    if (!parsed_log.ParseFile(argv[i])) {
+      std::cerr << "Could not parse the entire log file " << argv[i]
+                << ". Proceeding with the first "
+                << parsed_log.GetNumberOfEvents() << " events." << std::endl;
+    }
+    traces.push_back(
+        webrtc::bwe_replay::TraceFromEventLog(parsed_log, argv[i]));
+  }
+
+  FILE* output = stdout;
+  if (*FLAG_output != '\0') {
+    output = fopen(FLAG_output, "w");
+    if (!output) {
+      std::cerr << "Could not open " << FLAG_output << std::endl;
+      return 1;
+    }
+  }
+  webrtc::bwe_replay::WriteCsvHeader(output);
+  for (const webrtc::bwe_replay::Result& result :
+       webrtc::bwe_replay::ReplaySweep(traces, configs, FLAG_threads)) {
+    webrtc::bwe_replay::WriteCsvRow(result, output);
+  }
+  if (output != stdout)
+    fclose(output);
+  return 0;
+}
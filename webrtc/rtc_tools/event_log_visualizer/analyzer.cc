@@ -51,6 +51,33 @@ namespace plotting {
 
 namespace {
 
+// The number of events that are parsed at a time when reading a log, which
+// bounds the memory used for the events themselves.
+const size_t kEventsPerChunk = 100000;
+
+// Returns the EventLogAnalyzer::EventKind of |event_type|, or 0 if events of
+// the type are always analyzed.
+uint32_t GetEventKind(ParsedRtcEventLog::EventType event_type) {
+  switch (event_type) {
+    case ParsedRtcEventLog::RTP_EVENT:
+      return EventLogAnalyzer::kRtpEvents;
+    case ParsedRtcEventLog::RTCP_EVENT:
+      return EventLogAnalyzer::kRtcpEvents;
+    case ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT:
+      return EventLogAnalyzer::kAudioPlayoutEvents;
+    case ParsedRtcEventLog::LOSS_BASED_BWE_UPDATE:
+    case ParsedRtcEventLog::DELAY_BASED_BWE_UPDATE:
+    case ParsedRtcEventLog::BWE_PROBE_CLUSTER_CREATED_EVENT:
+    case ParsedRtcEventLog::BWE_PROBE_RESULT_EVENT:
+    case ParsedRtcEventLog::ALR_STATE_EVENT:
+      return EventLogAnalyzer::kBweEvents;
+    case ParsedRtcEventLog::AUDIO_NETWORK_ADAPTATION_EVENT:
+      return EventLogAnalyzer::kAudioNetworkAdaptationEvents;
+    default:
+      return 0;
+  }
+}
+
 void SortPacketFeedbackVector(std::vector<PacketFeedback>* vec) {
   auto pred = [](const PacketFeedback& packet_feedback) {
     return packet_feedback.arrival_time_ms == PacketFeedback::kNotReceived;
@@ -303,42 +330,60 @@ void MovingAverage(
 
 }  // namespace
 
+EventLogAnalyzer::EventLogAnalyzer(uint32_t event_kinds)
+    : event_kinds_(event_kinds),
+      window_duration_(250000),
+      step_(10000),
+      begin_time_(0),
+      end_time_(0),
+      call_duration_s_(0),
+      first_timestamp_(std::numeric_limits<uint64_t>::max()),
+      last_timestamp_(std::numeric_limits<uint64_t>::min()),
+      last_incoming_rtcp_packet_length_(0),
+      default_extension_map_(GetDefaultHeaderExtensionMap()) {}
+
 EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
-    : parsed_log_(log), window_duration_(250000), step_(10000) {
-  uint64_t first_timestamp = std::numeric_limits<uint64_t>::max();
-  uint64_t last_timestamp = std::numeric_limits<uint64_t>::min();
+    : EventLogAnalyzer(kAllEvents) {
+  AddEvents(log);
+  FinishAddingEvents();
+}
+
+EventLogAnalyzer::EventLogAnalyzer(RtcEventLogReader* reader,
+                                   uint32_t event_kinds)
+    : EventLogAnalyzer(event_kinds) {
+  ParsedRtcEventLog chunk;
+  while (chunk.ParseEvents(reader, kEventsPerChunk) > 0) {
+    AddEvents(chunk);
+  }
+  FinishAddingEvents();
+}
 
+void EventLogAnalyzer::AddEvents(const ParsedRtcEventLog& log) {
   PacketDirection direction;
   uint8_t header[IP_PACKET_SIZE];
   size_t header_length;
   size_t total_length;
 
-  uint8_t last_incoming_rtcp_packet[IP_PACKET_SIZE];
-  uint8_t last_incoming_rtcp_packet_length = 0;
-
-  // Make a default extension map for streams without configuration information.
-  // TODO(ivoc): Once configuration of audio streams is stored in the event log,
-  //             this can be removed. Tracking bug: webrtc:6399
-  RtpHeaderExtensionMap default_extension_map = GetDefaultHeaderExtensionMap();
-
-  rtc::Optional<uint64_t> last_log_start;
-
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
+  for (size_t i = 0; i < log.GetNumberOfEvents(); i++) {
+    ParsedRtcEventLog::EventType event_type = log.GetEventType(i);
     if (event_type != ParsedRtcEventLog::VIDEO_RECEIVER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::VIDEO_SENDER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::AUDIO_RECEIVER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::AUDIO_SENDER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::LOG_START &&
         event_type != ParsedRtcEventLog::LOG_END) {
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      first_timestamp = std::min(first_timestamp, timestamp);
-      last_timestamp = std::max(last_timestamp, timestamp);
+      uint64_t timestamp = log.GetTimestamp(i);
+      first_timestamp_ = std::min(first_timestamp_, timestamp);
+      last_timestamp_ = std::max(last_timestamp_, timestamp);
     }
 
-    switch (parsed_log_.GetEventType(i)) {
+    const uint32_t event_kind = GetEventKind(event_type);
+    if (event_kind != 0 && (event_kinds_ & event_kind) == 0)
+      continue;
+
+    switch (event_type) {
       case ParsedRtcEventLog::VIDEO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = parsed_log_.GetVideoReceiveConfig(i);
+        rtclog::StreamConfig config = log.GetVideoReceiveConfig(i);
         StreamId stream(config.remote_ssrc, kIncomingPacket);
         video_ssrcs_.insert(stream);
         StreamId rtx_stream(config.rtx_ssrc, kIncomingPacket);
@@ -348,7 +393,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::VIDEO_SENDER_CONFIG_EVENT: {
         std::vector<rtclog::StreamConfig> configs =
-            parsed_log_.GetVideoSendConfig(i);
+            log.GetVideoSendConfig(i);
         for (const auto& config : configs) {
           StreamId stream(config.local_ssrc, kOutgoingPacket);
           video_ssrcs_.insert(stream);
@@ -359,19 +404,19 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
         break;
       }
       case ParsedRtcEventLog::AUDIO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = parsed_log_.GetAudioReceiveConfig(i);
+        rtclog::StreamConfig config = log.GetAudioReceiveConfig(i);
         StreamId stream(config.remote_ssrc, kIncomingPacket);
         audio_ssrcs_.insert(stream);
         break;
       }
       case ParsedRtcEventLog::AUDIO_SENDER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = parsed_log_.GetAudioSendConfig(i);
+        rtclog::StreamConfig config = log.GetAudioSendConfig(i);
         StreamId stream(config.local_ssrc, kOutgoingPacket);
         audio_ssrcs_.insert(stream);
         break;
       }
       case ParsedRtcEventLog::RTP_EVENT: {
-        RtpHeaderExtensionMap* extension_map = parsed_log_.GetRtpHeader(
+        RtpHeaderExtensionMap* extension_map = log.GetRtpHeader(
             i, &direction, header, &header_length, &total_length);
         RtpUtility::RtpHeaderParser rtp_parser(header, header_length);
         RTPHeader parsed_header;
@@ -382,9 +427,9 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
           // TODO(ivoc): Once configuration of audio streams is stored in the
           //             event log, this can be removed.
           //             Tracking bug: webrtc:6399
-          rtp_parser.Parse(&parsed_header, &default_extension_map);
+          rtp_parser.Parse(&parsed_header, &default_extension_map_);
         }
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
+        uint64_t timestamp = log.GetTimestamp(i);
         StreamId stream(parsed_header.ssrc, direction);
         rtp_packets_[stream].push_back(
             LoggedRtpPacket(timestamp, parsed_header, total_length));
@@ -392,18 +437,18 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::RTCP_EVENT: {
         uint8_t packet[IP_PACKET_SIZE];
-        parsed_log_.GetRtcpPacket(i, &direction, packet, &total_length);
+        log.GetRtcpPacket(i, &direction, packet, &total_length);
         // Currently incoming RTCP packets are logged twice, both for audio and
         // video. Only act on one of them. Compare against the previous parsed
         // incoming RTCP packet.
         if (direction == webrtc::kIncomingPacket) {
           RTC_CHECK_LE(total_length, IP_PACKET_SIZE);
-          if (total_length == last_incoming_rtcp_packet_length &&
-              memcmp(last_incoming_rtcp_packet, packet, total_length) == 0) {
+          if (total_length == last_incoming_rtcp_packet_length_ &&
+              memcmp(last_incoming_rtcp_packet_, packet, total_length) == 0) {
             continue;
           } else {
-            memcpy(last_incoming_rtcp_packet, packet, total_length);
-            last_incoming_rtcp_packet_length = total_length;
+            memcpy(last_incoming_rtcp_packet_, packet, total_length);
+            last_incoming_rtcp_packet_length_ = total_length;
           }
         }
         rtcp::CommonHeader header;
@@ -418,7 +463,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(LoggedRtcpPacket(
                   timestamp, kRtcpTransportFeedback, std::move(rtcp_packet)));
             }
@@ -428,7 +473,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(
                   LoggedRtcpPacket(timestamp, kRtcpSr, std::move(rtcp_packet)));
             }
@@ -438,7 +483,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(
                   LoggedRtcpPacket(timestamp, kRtcpRr, std::move(rtcp_packet)));
             }
@@ -449,7 +494,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(LoggedRtcpPacket(
                   timestamp, kRtcpRemb, std::move(rtcp_packet)));
             }
@@ -458,55 +503,59 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
         break;
       }
       case ParsedRtcEventLog::LOG_START: {
-        if (last_log_start) {
-          // A LOG_END event was missing. Use last_timestamp.
-          RTC_DCHECK_GE(last_timestamp, *last_log_start);
+        if (last_log_start_) {
+          // A LOG_END event was missing. Use last_timestamp_.
+          RTC_DCHECK_GE(last_timestamp_, *last_log_start_);
           log_segments_.push_back(
-            std::make_pair(*last_log_start, last_timestamp));
+            std::make_pair(*last_log_start_, last_timestamp_));
         }
-        last_log_start = rtc::Optional<uint64_t>(parsed_log_.GetTimestamp(i));
+        last_log_start_ = rtc::Optional<uint64_t>(log.GetTimestamp(i));
         break;
       }
       case ParsedRtcEventLog::LOG_END: {
-        RTC_DCHECK(last_log_start);
+        RTC_DCHECK(last_log_start_);
         log_segments_.push_back(
-            std::make_pair(*last_log_start, parsed_log_.GetTimestamp(i)));
-        last_log_start.reset();
+            std::make_pair(*last_log_start_, log.GetTimestamp(i)));
+        last_log_start_.reset();
         break;
       }
       case ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT: {
         uint32_t this_ssrc;
-        parsed_log_.GetAudioPlayout(i, &this_ssrc);
-        audio_playout_events_[this_ssrc].push_back(parsed_log_.GetTimestamp(i));
+        log.GetAudioPlayout(i, &this_ssrc);
+        audio_playout_events_[this_ssrc].push_back(log.GetTimestamp(i));
         break;
       }
       case ParsedRtcEventLog::LOSS_BASED_BWE_UPDATE: {
         LossBasedBweUpdate bwe_update;
-        bwe_update.timestamp = parsed_log_.GetTimestamp(i);
-        parsed_log_.GetLossBasedBweUpdate(i, &bwe_update.new_bitrate,
-                                          &bwe_update.fraction_loss,
-                                          &bwe_update.expected_packets);
+        bwe_update.timestamp = log.GetTimestamp(i);
+        log.GetLossBasedBweUpdate(i, &bwe_update.new_bitrate,
+                                  &bwe_update.fraction_loss,
+                                  &bwe_update.expected_packets);
         bwe_loss_updates_.push_back(bwe_update);
         break;
       }
       case ParsedRtcEventLog::DELAY_BASED_BWE_UPDATE: {
-        bwe_delay_updates_.push_back(parsed_log_.GetDelayBasedBweUpdate(i));
+        bwe_delay_updates_.push_back(log.GetDelayBasedBweUpdate(i));
         break;
       }
       case ParsedRtcEventLog::AUDIO_NETWORK_ADAPTATION_EVENT: {
         AudioNetworkAdaptationEvent ana_event;
-        ana_event.timestamp = parsed_log_.GetTimestamp(i);
-        parsed_log_.GetAudioNetworkAdaptation(i, &ana_event.config);
+        ana_event.timestamp = log.GetTimestamp(i);
+        log.GetAudioNetworkAdaptation(i, &ana_event.config);
         audio_network_adaptation_events_.push_back(ana_event);
         break;
       }
       case ParsedRtcEventLog::BWE_PROBE_CLUSTER_CREATED_EVENT: {
         bwe_probe_cluster_created_events_.push_back(
-            parsed_log_.GetBweProbeClusterCreated(i));
+            log.GetBweProbeClusterCreated(i));
         break;
       }
       case ParsedRtcEventLog::BWE_PROBE_RESULT_EVENT: {
-        bwe_probe_result_events_.push_back(parsed_log_.GetBweProbeResult(i));
+        bwe_probe_result_events_.push_back(log.GetBweProbeResult(i));
+        break;
+      }
+      case ParsedRtcEventLog::ALR_STATE_EVENT: {
+        alr_state_events_.push_back(log.GetAlrState(i));
         break;
       }
       case ParsedRtcEventLog::UNKNOWN_EVENT: {
@@ -514,17 +563,19 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
     }
   }
+}
 
-  if (last_timestamp < first_timestamp) {
+void EventLogAnalyzer::FinishAddingEvents() {
+  if (last_timestamp_ < first_timestamp_) {
     // No useful events in the log.
-    first_timestamp = last_timestamp = 0;
+    first_timestamp_ = last_timestamp_ = 0;
   }
-  begin_time_ = first_timestamp;
-  end_time_ = last_timestamp;
+  begin_time_ = first_timestamp_;
+  end_time_ = last_timestamp_;
   call_duration_s_ = static_cast<float>(end_time_ - begin_time_) / 1000000;
-  if (last_log_start) {
+  if (last_log_start_) {
     // The log was missing the last LOG_END event. Fake it.
-    log_segments_.push_back(std::make_pair(*last_log_start, end_time_));
+    log_segments_.push_back(std::make_pair(*last_log_start_, end_time_));
   }
 }
 
@@ -589,7 +640,7 @@ std::string EventLogAnalyzer::GetStreamName(StreamId stream_id) const {
 }
 
 void EventLogAnalyzer::CreatePacketGraph(PacketDirection desired_direction,
-                                         Plot* plot) {
+                                         Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -623,7 +674,7 @@ void EventLogAnalyzer::CreateAccumulatedPacketsTimeSeries(
     PacketDirection desired_direction,
     Plot* plot,
     const std::map<StreamId, std::vector<T>>& packets,
-    const std::string& label_prefix) {
+    const std::string& label_prefix) const {
   for (auto& kv : packets) {
     StreamId stream_id = kv.first;
     const std::vector<T>& packet_stream = kv.second;
@@ -647,7 +698,7 @@ void EventLogAnalyzer::CreateAccumulatedPacketsTimeSeries(
 
 void EventLogAnalyzer::CreateAccumulatedPacketsGraph(
     PacketDirection desired_direction,
-    Plot* plot) {
+    Plot* plot) const {
   CreateAccumulatedPacketsTimeSeries(desired_direction, plot, rtp_packets_,
                                      "RTP");
   CreateAccumulatedPacketsTimeSeries(desired_direction, plot, rtcp_packets_,
@@ -663,28 +714,24 @@ void EventLogAnalyzer::CreateAccumulatedPacketsGraph(
 }
 
 // For each SSRC, plot the time between the consecutive playouts.
-void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) {
+void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) const {
   std::map<uint32_t, TimeSeries> time_series;
-  std::map<uint32_t, uint64_t> last_playout;
-
-  uint32_t ssrc;
-
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT) {
-      parsed_log_.GetAudioPlayout(i, &ssrc);
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      if (MatchingSsrc(ssrc, desired_ssrc_)) {
-        float x = static_cast<float>(timestamp - begin_time_) / 1000000;
-        float y = static_cast<float>(timestamp - last_playout[ssrc]) / 1000;
-        if (time_series[ssrc].points.size() == 0) {
-          // There were no previusly logged playout for this SSRC.
-          // Generate a point, but place it on the x-axis.
-          y = 0;
-        }
-        time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
-        last_playout[ssrc] = timestamp;
+
+  for (const auto& kv : audio_playout_events_) {
+    const uint32_t ssrc = kv.first;
+    if (!MatchingSsrc(ssrc, desired_ssrc_))
+      continue;
+    uint64_t last_playout = 0;
+    for (uint64_t timestamp : kv.second) {
+      float x = static_cast<float>(timestamp - begin_time_) / 1000000;
+      float y = static_cast<float>(timestamp - last_playout) / 1000;
+      if (time_series[ssrc].points.size() == 0) {
+        // There were no previusly logged playout for this SSRC.
+        // Generate a point, but place it on the x-axis.
+        y = 0;
       }
+      time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
+      last_playout = timestamp;
     }
   }
 
@@ -702,7 +749,7 @@ void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) {
 }
 
 // For audio SSRCs, plot the audio level.
-void EventLogAnalyzer::CreateAudioLevelGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioLevelGraph(Plot* plot) const {
   std::map<StreamId, TimeSeries> time_series;
 
   for (auto& kv : rtp_packets_) {
@@ -735,7 +782,7 @@ void EventLogAnalyzer::CreateAudioLevelGraph(Plot* plot) {
 }
 
 // For each SSRC, plot the time between the consecutive playouts.
-void EventLogAnalyzer::CreateSequenceNumberGraph(Plot* plot) {
+void EventLogAnalyzer::CreateSequenceNumberGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -764,7 +811,7 @@ void EventLogAnalyzer::CreateSequenceNumberGraph(Plot* plot) {
   plot->SetTitle("Sequence number");
 }
 
-void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) {
+void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -821,7 +868,7 @@ void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) {
   plot->SetTitle("Estimated incoming loss rate");
 }
 
-void EventLogAnalyzer::CreateIncomingDelayDeltaGraph(Plot* plot) {
+void EventLogAnalyzer::CreateIncomingDelayDeltaGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -854,7 +901,7 @@ void EventLogAnalyzer::CreateIncomingDelayDeltaGraph(Plot* plot) {
   plot->SetTitle("Network latency difference between consecutive packets");
 }
 
-void EventLogAnalyzer::CreateIncomingDelayGraph(Plot* plot) {
+void EventLogAnalyzer::CreateIncomingDelayGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -888,7 +935,7 @@ void EventLogAnalyzer::CreateIncomingDelayGraph(Plot* plot) {
 }
 
 // Plot the fraction of packets lost (as perceived by the loss-based BWE).
-void EventLogAnalyzer::CreateFractionLossGraph(Plot* plot) {
+void EventLogAnalyzer::CreateFractionLossGraph(Plot* plot) const {
   TimeSeries time_series("Fraction lost", LINE_DOT_GRAPH);
   for (auto& bwe_update : bwe_loss_updates_) {
     float x = static_cast<float>(bwe_update.timestamp - begin_time_) / 1000000;
@@ -907,7 +954,7 @@ void EventLogAnalyzer::CreateFractionLossGraph(Plot* plot) {
 void EventLogAnalyzer::CreateTotalBitrateGraph(
     PacketDirection desired_direction,
     Plot* plot,
-    bool show_detector_state) {
+    bool show_detector_state) const {
   struct TimestampSize {
     TimestampSize(uint64_t t, size_t s) : timestamp(t), size(s) {}
     uint64_t timestamp;
@@ -915,20 +962,20 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
   };
   std::vector<TimestampSize> packets;
 
-  PacketDirection direction;
-  size_t total_length;
-
-  // Extract timestamps and sizes for the relevant packets.
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::RTP_EVENT) {
-      parsed_log_.GetRtpHeader(i, &direction, nullptr, nullptr, &total_length);
-      if (direction == desired_direction) {
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
-        packets.push_back(TimestampSize(timestamp, total_length));
-      }
+  // Extract timestamps and sizes for the relevant packets, in the order they
+  // were logged.
+  for (const auto& kv : rtp_packets_) {
+    if (kv.first.GetDirection() != desired_direction)
+      continue;
+    for (const LoggedRtpPacket& rtp_packet : kv.second) {
+      packets.push_back(
+          TimestampSize(rtp_packet.timestamp, rtp_packet.total_length));
     }
   }
+  std::stable_sort(packets.begin(), packets.end(),
+                   [](const TimestampSize& a, const TimestampSize& b) {
+                     return a.timestamp < b.timestamp;
+                   });
 
   size_t window_index_begin = 0;
   size_t window_index_end = 0;
@@ -1023,6 +1070,24 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
       }
     }
 
+    IntervalSeries alr_series("ALR", "#555555", IntervalSeries::kHorizontal);
+    rtc::Optional<float> alr_start;
+    for (auto& alr : alr_state_events_) {
+      float x = static_cast<float>(alr.timestamp - begin_time_) / 1000000;
+      if (alr.in_alr && !alr_start) {
+        alr_start.emplace(x);
+      } else if (!alr.in_alr && alr_start) {
+        alr_series.intervals.emplace_back(*alr_start, x);
+        alr_start.reset();
+      }
+    }
+    if (alr_start) {
+      alr_series.intervals.emplace_back(
+          *alr_start, static_cast<float>(end_time_ - begin_time_) / 1000000);
+    }
+    if (!alr_series.intervals.empty())
+      plot->AppendIntervalSeries(std::move(alr_series));
+
     if (show_detector_state) {
       plot->AppendIntervalSeries(std::move(overusing_series));
       plot->AppendIntervalSeries(std::move(underusing_series));
@@ -1074,7 +1139,7 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
 // For each SSRC, plot the bandwidth used by that stream.
 void EventLogAnalyzer::CreateStreamBitrateGraph(
     PacketDirection desired_direction,
-    Plot* plot) {
+    Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -1103,7 +1168,7 @@ void EventLogAnalyzer::CreateStreamBitrateGraph(
   }
 }
 
-void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
+void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) const {
   std::multimap<uint64_t, const LoggedRtpPacket*> outgoing_rtp;
   std::multimap<uint64_t, const LoggedRtcpPacket*> incoming_rtcp;
 
@@ -1225,7 +1290,7 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
   plot->SetTitle("Simulated BWE behavior");
 }
 
-void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
+void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) const {
   std::multimap<uint64_t, const LoggedRtpPacket*> outgoing_rtp;
   std::multimap<uint64_t, const LoggedRtcpPacket*> incoming_rtcp;
 
@@ -1343,7 +1408,7 @@ std::vector<std::pair<int64_t, int64_t>> EventLogAnalyzer::GetFrameTimestamps()
   return timestamps;
 }
 
-void EventLogAnalyzer::CreateTimestampGraph(Plot* plot) {
+void EventLogAnalyzer::CreateTimestampGraph(Plot* plot) const {
   for (const auto& kv : rtp_packets_) {
     const std::vector<LoggedRtpPacket>& rtp_packets = kv.second;
     StreamId stream_id = kv.first;
@@ -1384,7 +1449,7 @@ void EventLogAnalyzer::CreateTimestampGraph(Plot* plot) {
   plot->SetTitle("Timestamps");
 }
 
-void EventLogAnalyzer::CreateAudioEncoderTargetBitrateGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioEncoderTargetBitrateGraph(Plot* plot) const {
   TimeSeries time_series("Audio encoder target bitrate", LINE_DOT_GRAPH);
   ProcessPoints<AudioNetworkAdaptationEvent>(
       [](const AudioNetworkAdaptationEvent& ana_event) -> rtc::Optional<float> {
@@ -1400,7 +1465,7 @@ void EventLogAnalyzer::CreateAudioEncoderTargetBitrateGraph(Plot* plot) {
   plot->SetTitle("Reported audio encoder target bitrate");
 }
 
-void EventLogAnalyzer::CreateAudioEncoderFrameLengthGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioEncoderFrameLengthGraph(Plot* plot) const {
   TimeSeries time_series("Audio encoder frame length", LINE_DOT_GRAPH);
   ProcessPoints<AudioNetworkAdaptationEvent>(
       [](const AudioNetworkAdaptationEvent& ana_event) {
@@ -1416,7 +1481,7 @@ void EventLogAnalyzer::CreateAudioEncoderFrameLengthGraph(Plot* plot) {
   plot->SetTitle("Reported audio encoder frame length");
 }
 
-void EventLogAnalyzer::CreateAudioEncoderPacketLossGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioEncoderPacketLossGraph(Plot* plot) const {
   TimeSeries time_series("Audio encoder uplink packet loss fraction",
                          LINE_DOT_GRAPH);
   ProcessPoints<AudioNetworkAdaptationEvent>(
@@ -1434,7 +1499,7 @@ void EventLogAnalyzer::CreateAudioEncoderPacketLossGraph(Plot* plot) {
   plot->SetTitle("Reported audio encoder lost packets");
 }
 
-void EventLogAnalyzer::CreateAudioEncoderEnableFecGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioEncoderEnableFecGraph(Plot* plot) const {
   TimeSeries time_series("Audio encoder FEC", LINE_DOT_GRAPH);
   ProcessPoints<AudioNetworkAdaptationEvent>(
       [](const AudioNetworkAdaptationEvent& ana_event) {
@@ -1450,7 +1515,7 @@ void EventLogAnalyzer::CreateAudioEncoderEnableFecGraph(Plot* plot) {
   plot->SetTitle("Reported audio encoder FEC");
 }
 
-void EventLogAnalyzer::CreateAudioEncoderEnableDtxGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioEncoderEnableDtxGraph(Plot* plot) const {
   TimeSeries time_series("Audio encoder DTX", LINE_DOT_GRAPH);
   ProcessPoints<AudioNetworkAdaptationEvent>(
       [](const AudioNetworkAdaptationEvent& ana_event) {
@@ -1466,7 +1531,7 @@ void EventLogAnalyzer::CreateAudioEncoderEnableDtxGraph(Plot* plot) {
   plot->SetTitle("Reported audio encoder DTX");
 }
 
-void EventLogAnalyzer::CreateAudioEncoderNumChannelsGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAudioEncoderNumChannelsGraph(Plot* plot) const {
   TimeSeries time_series("Audio encoder number of channels", LINE_DOT_GRAPH);
   ProcessPoints<AudioNetworkAdaptationEvent>(
       [](const AudioNetworkAdaptationEvent& ana_event) {
@@ -1624,7 +1689,7 @@ std::unique_ptr<test::NetEqDelayAnalyzer> CreateNetEqTestAndRun(
 void EventLogAnalyzer::CreateAudioJitterBufferGraph(
     const std::string& replacement_file_name,
     int file_sample_rate_hz,
-    Plot* plot) {
+    Plot* plot) const {
   const auto& incoming_audio_kv = std::find_if(
       rtp_packets_.begin(), rtp_packets_.end(),
       [this](std::pair<StreamId, std::vector<LoggedRtpPacket>> kv) {
@@ -19,10 +19,13 @@
 #include <vector>
 
 #include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_reader.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
 #include "webrtc/rtc_base/function_view.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_tools/event_log_visualizer/plot_base.h"
 
 namespace webrtc {
@@ -59,51 +62,74 @@ struct AudioNetworkAdaptationEvent {
   AudioEncoderRuntimeConfig config;
 };
 
+// The graphs are drawn by const methods, which only read what was extracted
+// from the log, so they can be called concurrently.
 class EventLogAnalyzer {
  public:
-  // The EventLogAnalyzer keeps a reference to the ParsedRtcEventLog for the
-  // duration of its lifetime. The ParsedRtcEventLog must not be destroyed or
-  // modified while the EventLogAnalyzer is being used.
+  // The kinds of events that the graphs are drawn from, as bits of a mask.
+  // The stream configurations and log start and end events are always used.
+  enum EventKind : uint32_t {
+    kRtpEvents = 1 << 0,
+    kRtcpEvents = 1 << 1,
+    kAudioPlayoutEvents = 1 << 2,
+    // Loss- and delay-based BWE updates, and BWE probe clusters and results.
+    kBweEvents = 1 << 3,
+    kAudioNetworkAdaptationEvents = 1 << 4,
+    kAllEvents = (1 << 5) - 1
+  };
+
+  // Extracts what the graphs need from the events of |log|, which isn't used
+  // after the constructor returns.
   explicit EventLogAnalyzer(const ParsedRtcEventLog& log);
 
-  void CreatePacketGraph(PacketDirection desired_direction, Plot* plot);
+  // Reads the events from |reader| a chunk at a time, so that only what the
+  // graphs need is kept rather than every event of the log. Only the events of
+  // the kinds in |event_kinds| are parsed, which is faster when only the
+  // graphs that need them will be drawn; the others come out empty. If the
+  // log can't be parsed to the end, reader->failed() is true and the events
+  // before the error are analyzed.
+  explicit EventLogAnalyzer(RtcEventLogReader* reader,
+                            uint32_t event_kinds = kAllEvents);
+
+  void CreatePacketGraph(PacketDirection desired_direction, Plot* plot) const;
 
   void CreateAccumulatedPacketsGraph(PacketDirection desired_direction,
-                                     Plot* plot);
+                                     Plot* plot) const;
 
-  void CreatePlayoutGraph(Plot* plot);
+  void CreatePlayoutGraph(Plot* plot) const;
 
-  void CreateAudioLevelGraph(Plot* plot);
+  void CreateAudioLevelGraph(Plot* plot) const;
 
-  void CreateSequenceNumberGraph(Plot* plot);
+  void CreateSequenceNumberGraph(Plot* plot) const;
 
-  void CreateIncomingPacketLossGraph(Plot* plot);
+  void CreateIncomingPacketLossGraph(Plot* plot) const;
 
-  void CreateIncomingDelayDeltaGraph(Plot* plot);
-  void CreateIncomingDelayGraph(Plot* plot);
+  void CreateIncomingDelayDeltaGraph(Plot* plot) const;
+  void CreateIncomingDelayGraph(Plot* plot) const;
 
-  void CreateFractionLossGraph(Plot* plot);
+  void CreateFractionLossGraph(Plot* plot) const;
 
   void CreateTotalBitrateGraph(PacketDirection desired_direction,
                                Plot* plot,
-                               bool show_detector_state = false);
+                               bool show_detector_state = false) const;
 
-  void CreateStreamBitrateGraph(PacketDirection desired_direction, Plot* plot);
+  void CreateStreamBitrateGraph(PacketDirection desired_direction,
+                                Plot* plot) const;
 
-  void CreateBweSimulationGraph(Plot* plot);
+  void CreateBweSimulationGraph(Plot* plot) const;
 
-  void CreateNetworkDelayFeedbackGraph(Plot* plot);
-  void CreateTimestampGraph(Plot* plot);
+  void CreateNetworkDelayFeedbackGraph(Plot* plot) const;
+  void CreateTimestampGraph(Plot* plot) const;
 
-  void CreateAudioEncoderTargetBitrateGraph(Plot* plot);
-  void CreateAudioEncoderFrameLengthGraph(Plot* plot);
-  void CreateAudioEncoderPacketLossGraph(Plot* plot);
-  void CreateAudioEncoderEnableFecGraph(Plot* plot);
-  void CreateAudioEncoderEnableDtxGraph(Plot* plot);
-  void CreateAudioEncoderNumChannelsGraph(Plot* plot);
+  void CreateAudioEncoderTargetBitrateGraph(Plot* plot) const;
+  void CreateAudioEncoderFrameLengthGraph(Plot* plot) const;
+  void CreateAudioEncoderPacketLossGraph(Plot* plot) const;
+  void CreateAudioEncoderEnableFecGraph(Plot* plot) const;
+  void CreateAudioEncoderEnableDtxGraph(Plot* plot) const;
+  void CreateAudioEncoderNumChannelsGraph(Plot* plot) const;
   void CreateAudioJitterBufferGraph(const std::string& replacement_file_name,
                                     int file_sample_rate_hz,
-                                    Plot* plot);
+                                    Plot* plot) const;
 
   // Returns a vector of capture and arrival timestamps for the video frames
   // of the stream with the most number of frames.
@@ -130,12 +156,20 @@ class EventLogAnalyzer {
     webrtc::PacketDirection direction_;
   };
 
+  explicit EventLogAnalyzer(uint32_t event_kinds);
+
+  // Adds the events of |log| to those analyzed, as if they followed the
+  // events added before.
+  void AddEvents(const ParsedRtcEventLog& log);
+  // Sets the begin and end times once all the events have been added.
+  void FinishAddingEvents();
+
   template <typename T>
   void CreateAccumulatedPacketsTimeSeries(
       PacketDirection desired_direction,
       Plot* plot,
       const std::map<StreamId, std::vector<T>>& packets,
-      const std::string& label_prefix);
+      const std::string& label_prefix) const;
 
   bool IsRtxSsrc(StreamId stream_id) const;
 
@@ -145,7 +179,8 @@ class EventLogAnalyzer {
 
   std::string GetStreamName(StreamId) const;
 
-  const ParsedRtcEventLog& parsed_log_;
+  // The EventKinds that are extracted from the log.
+  const uint32_t event_kinds_;
 
   // A list of SSRCs we are interested in analysing.
   // If left empty, all SSRCs will be considered relevant.
@@ -186,6 +221,8 @@ class EventLogAnalyzer {
 
   std::vector<ParsedRtcEventLog::BweDelayBasedUpdate> bwe_delay_updates_;
 
+  std::vector<ParsedRtcEventLog::AlrStateEvent> alr_state_events_;
+
   // Window and step size used for calculating moving averages, e.g. bitrate.
   // The generated data points will be |step_| microseconds apart.
   // Only events occuring at most |window_duration_| microseconds before the
@@ -199,6 +236,17 @@ class EventLogAnalyzer {
 
   // Duration (in seconds) of log file.
   float call_duration_s_;
+
+  // The state of AddEvents() from one chunk of events to the next.
+  uint64_t first_timestamp_;
+  uint64_t last_timestamp_;
+  rtc::Optional<uint64_t> last_log_start_;
+  uint8_t last_incoming_rtcp_packet_[IP_PACKET_SIZE];
+  size_t last_incoming_rtcp_packet_length_;
+  // Used for streams without configuration information.
+  // TODO(ivoc): Once configuration of audio streams is stored in the event log,
+  //             this can be removed. Tracking bug: webrtc:6399
+  RtpHeaderExtensionMap default_extension_map_;
 };
 
 }  // namespace plotting
@@ -8,13 +8,21 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
 
-#include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_reader.h"
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/flags.h"
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_tools/event_log_visualizer/analyzer.h"
 #include "webrtc/rtc_tools/event_log_visualizer/plot_base.h"
 #include "webrtc/rtc_tools/event_log_visualizer/plot_python.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/test/field_trial.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -114,6 +122,10 @@ DEFINE_string(
 DEFINE_string(wav_filename,
               "",
               "Path to wav file used for simulation of jitter buffer");
+DEFINE_int(threads,
+           0,
+           "The number of threads to create the plots on. 0 means one per "
+           "core.");
 DEFINE_bool(help, false, "prints this message");
 
 DEFINE_bool(show_detector_state,
@@ -123,6 +135,58 @@ DEFINE_bool(show_detector_state,
 
 void SetAllPlotFlags(bool setting);
 
+namespace {
+
+using PlotFunction =
+    std::function<void(const webrtc::plotting::EventLogAnalyzer&,
+                       webrtc::plotting::Plot*)>;
+
+struct PlotJob {
+  // The EventLogAnalyzer::EventKinds the plot is created from.
+  uint32_t event_kinds;
+  PlotFunction create_plot;
+  webrtc::plotting::Plot* plot;
+};
+
+struct PlotState {
+  const webrtc::plotting::EventLogAnalyzer* analyzer;
+  const std::vector<PlotJob>* jobs;
+  volatile int next_job;
+};
+
+void RunPlotJobs(void* obj) {
+  PlotState* state = static_cast<PlotState*>(obj);
+  while (true) {
+    const size_t job = rtc::AtomicOps::Increment(&state->next_job) - 1;
+    if (job >= state->jobs->size())
+      return;
+    const PlotJob& plot_job = (*state->jobs)[job];
+    plot_job.create_plot(*state->analyzer, plot_job.plot);
+  }
+}
+
+// Creates the plots of |jobs| on |num_threads| threads. Each plot is only
+// written by one job, and the analyzer is only read.
+void CreatePlots(const webrtc::plotting::EventLogAnalyzer& analyzer,
+                 const std::vector<PlotJob>* jobs,
+                 int num_threads) {
+  PlotState state = {&analyzer, jobs, 0};
+  num_threads = std::min(num_threads, static_cast<int>(jobs->size()));
+  if (num_threads <= 1) {
+    RunPlotJobs(&state);
+    return;
+  }
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&RunPlotJobs, &state, "EventLogPlots"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+}
+
+}  // namespace
 
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -162,100 +226,149 @@ int main(int argc, char* argv[]) {
 
   std::string filename = argv[1];
 
-  webrtc::ParsedRtcEventLog parsed_log;
-
-  if (!parsed_log.ParseFile(filename)) {
-    std::cerr << "Could not parse the entire log file." << std::endl;
-    std::cerr << "Proceeding to analyze the first "
-              << parsed_log.GetNumberOfEvents() << " events in the file."
-              << std::endl;
+  std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
+  if (!file.good() || !file.is_open()) {
+    std::cerr << "Could not open the log file." << std::endl;
+    return 1;
   }
 
-  webrtc::plotting::EventLogAnalyzer analyzer(parsed_log);
+  // The log is analyzed while it is read, so that logs too large to keep in
+  // memory can be plotted.
   std::unique_ptr<webrtc::plotting::PlotCollection> collection(
       new webrtc::plotting::PythonPlotCollection());
 
+  // The plots are appended in flag order, but drawn into after the log has
+  // been read, from the events of the kinds they need.
+  std::vector<PlotJob> jobs;
+  auto add_plot = [&jobs, &collection](uint32_t event_kinds,
+                                       const PlotFunction& create_plot) {
+    jobs.push_back({event_kinds, create_plot, collection->AppendNewPlot()});
+  };
+  using webrtc::PacketDirection;
+  using webrtc::plotting::EventLogAnalyzer;
+  using webrtc::plotting::Plot;
+
   if (FLAG_plot_incoming_packet_sizes) {
-    analyzer.CreatePacketGraph(webrtc::PacketDirection::kIncomingPacket,
-                               collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreatePacketGraph(PacketDirection::kIncomingPacket,
+                                          plot);
+             });
   }
   if (FLAG_plot_outgoing_packet_sizes) {
-    analyzer.CreatePacketGraph(webrtc::PacketDirection::kOutgoingPacket,
-                               collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreatePacketGraph(PacketDirection::kOutgoingPacket,
+                                          plot);
+             });
   }
   if (FLAG_plot_incoming_packet_count) {
-    analyzer.CreateAccumulatedPacketsGraph(
-        webrtc::PacketDirection::kIncomingPacket, collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kRtcpEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreateAccumulatedPacketsGraph(
+                   PacketDirection::kIncomingPacket, plot);
+             });
   }
   if (FLAG_plot_outgoing_packet_count) {
-    analyzer.CreateAccumulatedPacketsGraph(
-        webrtc::PacketDirection::kOutgoingPacket, collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kRtcpEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreateAccumulatedPacketsGraph(
+                   PacketDirection::kOutgoingPacket, plot);
+             });
   }
   if (FLAG_plot_audio_playout) {
-    analyzer.CreatePlayoutGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioPlayoutEvents,
+             &EventLogAnalyzer::CreatePlayoutGraph);
   }
   if (FLAG_plot_audio_level) {
-    analyzer.CreateAudioLevelGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             &EventLogAnalyzer::CreateAudioLevelGraph);
   }
   if (FLAG_plot_incoming_sequence_number_delta) {
-    analyzer.CreateSequenceNumberGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             &EventLogAnalyzer::CreateSequenceNumberGraph);
   }
   if (FLAG_plot_incoming_delay_delta) {
-    analyzer.CreateIncomingDelayDeltaGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             &EventLogAnalyzer::CreateIncomingDelayDeltaGraph);
   }
   if (FLAG_plot_incoming_delay) {
-    analyzer.CreateIncomingDelayGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             &EventLogAnalyzer::CreateIncomingDelayGraph);
   }
   if (FLAG_plot_incoming_loss_rate) {
-    analyzer.CreateIncomingPacketLossGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             &EventLogAnalyzer::CreateIncomingPacketLossGraph);
   }
   if (FLAG_plot_incoming_bitrate) {
-    analyzer.CreateTotalBitrateGraph(webrtc::PacketDirection::kIncomingPacket,
-                                     collection->AppendNewPlot(),
-                                     FLAG_show_detector_state);
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kBweEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreateTotalBitrateGraph(
+                   PacketDirection::kIncomingPacket, plot,
+                   FLAG_show_detector_state);
+             });
   }
   if (FLAG_plot_outgoing_bitrate) {
-    analyzer.CreateTotalBitrateGraph(webrtc::PacketDirection::kOutgoingPacket,
-                                     collection->AppendNewPlot(),
-                                     FLAG_show_detector_state);
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kBweEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreateTotalBitrateGraph(
+                   PacketDirection::kOutgoingPacket, plot,
+                   FLAG_show_detector_state);
+             });
   }
   if (FLAG_plot_incoming_stream_bitrate) {
-    analyzer.CreateStreamBitrateGraph(webrtc::PacketDirection::kIncomingPacket,
-                                      collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreateStreamBitrateGraph(
+                   PacketDirection::kIncomingPacket, plot);
+             });
   }
   if (FLAG_plot_outgoing_stream_bitrate) {
-    analyzer.CreateStreamBitrateGraph(webrtc::PacketDirection::kOutgoingPacket,
-                                      collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents,
+             [](const EventLogAnalyzer& analyzer, Plot* plot) {
+               analyzer.CreateStreamBitrateGraph(
+                   PacketDirection::kOutgoingPacket, plot);
+             });
   }
   if (FLAG_plot_simulated_sendside_bwe) {
-    analyzer.CreateBweSimulationGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kRtcpEvents,
+             &EventLogAnalyzer::CreateBweSimulationGraph);
   }
   if (FLAG_plot_network_delay_feedback) {
-    analyzer.CreateNetworkDelayFeedbackGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kRtcpEvents,
+             &EventLogAnalyzer::CreateNetworkDelayFeedbackGraph);
   }
   if (FLAG_plot_fraction_loss_feedback) {
-    analyzer.CreateFractionLossGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kBweEvents,
+             &EventLogAnalyzer::CreateFractionLossGraph);
   }
   if (FLAG_plot_timestamps) {
-    analyzer.CreateTimestampGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kRtcpEvents,
+             &EventLogAnalyzer::CreateTimestampGraph);
   }
   if (FLAG_plot_audio_encoder_bitrate_bps) {
-    analyzer.CreateAudioEncoderTargetBitrateGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioNetworkAdaptationEvents,
+             &EventLogAnalyzer::CreateAudioEncoderTargetBitrateGraph);
   }
   if (FLAG_plot_audio_encoder_frame_length_ms) {
-    analyzer.CreateAudioEncoderFrameLengthGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioNetworkAdaptationEvents,
+             &EventLogAnalyzer::CreateAudioEncoderFrameLengthGraph);
   }
   if (FLAG_plot_audio_encoder_packet_loss) {
-    analyzer.CreateAudioEncoderPacketLossGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioNetworkAdaptationEvents,
+             &EventLogAnalyzer::CreateAudioEncoderPacketLossGraph);
   }
   if (FLAG_plot_audio_encoder_fec) {
-    analyzer.CreateAudioEncoderEnableFecGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioNetworkAdaptationEvents,
+             &EventLogAnalyzer::CreateAudioEncoderEnableFecGraph);
   }
   if (FLAG_plot_audio_encoder_dtx) {
-    analyzer.CreateAudioEncoderEnableDtxGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioNetworkAdaptationEvents,
+             &EventLogAnalyzer::CreateAudioEncoderEnableDtxGraph);
   }
   if (FLAG_plot_audio_encoder_num_channels) {
-    analyzer.CreateAudioEncoderNumChannelsGraph(collection->AppendNewPlot());
+    add_plot(EventLogAnalyzer::kAudioNetworkAdaptationEvents,
+             &EventLogAnalyzer::CreateAudioEncoderNumChannelsGraph);
   }
   if (FLAG_plot_audio_jitter_buffer) {
     std::string wav_path;
@@ -265,10 +378,31 @@ int main(int argc, char* argv[]) {
       wav_path = webrtc::test::ResourcePath(
           "audio_processing/conversational_speech/EN_script2_F_sp2_B1", "wav");
     }
-    analyzer.CreateAudioJitterBufferGraph(wav_path, 48000,
-                                          collection->AppendNewPlot());
+    add_plot(
+        EventLogAnalyzer::kRtpEvents | EventLogAnalyzer::kAudioPlayoutEvents,
+        [wav_path](const EventLogAnalyzer& analyzer, Plot* plot) {
+          analyzer.CreateAudioJitterBufferGraph(wav_path, 48000, plot);
+        });
   }
 
+  // The log is analyzed while it is read, so that logs too large to keep in
+  // memory can be plotted. Only the events that the plots need are kept.
+  uint32_t event_kinds = 0;
+  for (const PlotJob& job : jobs)
+    event_kinds |= job.event_kinds;
+  webrtc::RtcEventLogReader reader(&file);
+  EventLogAnalyzer analyzer(&reader, event_kinds);
+  if (reader.failed()) {
+    std::cerr << "Could not parse the entire log file." << std::endl;
+    std::cerr << "Proceeding to analyze the events before the error."
+              << std::endl;
+  }
+
+  int num_threads = FLAG_threads > 0
+                        ? FLAG_threads
+                        : webrtc::CpuInfo::DetectNumberOfCores();
+  CreatePlots(analyzer, &jobs, num_threads);
+
   collection->Draw();
 
   return 0;
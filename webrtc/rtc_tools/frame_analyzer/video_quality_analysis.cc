@@ -14,10 +14,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <map>
 #include <utility>
 
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
 #define STATS_LINE_LENGTH 32
 #define Y4M_FILE_HEADER_MAX_SIZE 200
 #define Y4M_FRAME_DELIMITER "FRAME"
@@ -26,9 +30,179 @@
 namespace webrtc {
 namespace test {
 
+namespace {
+
+// The pairs [begin, end) of the frames that one thread of CompareFrames()
+// compares. |read_frames[i]| is set if the frames of pair i could be read.
+struct FrameComparison {
+  const char* reference_file_name;
+  const char* test_file_name;
+  int width;
+  int height;
+  const FramePair* frame_pairs;
+  size_t begin;
+  size_t end;
+  AnalysisResult* results;
+  uint8_t* read_frames;
+};
+
+void CompareFrameRange(void* obj) {
+  FrameComparison* comparison = static_cast<FrameComparison*>(obj);
+  const bool y4m_mode =
+      std::string(comparison->reference_file_name).find("y4m") !=
+      std::string::npos;
+  I420FrameFileReader reference_reader(comparison->reference_file_name,
+                                       comparison->width, comparison->height,
+                                       y4m_mode);
+  I420FrameFileReader test_reader(comparison->test_file_name,
+                                  comparison->width, comparison->height,
+                                  false);
+  if (!reference_reader.Init() || !test_reader.Init())
+    return;
+
+  const int size = GetI420FrameSize(comparison->width, comparison->height);
+  std::unique_ptr<uint8_t[]> reference_frame(new uint8_t[size]);
+  std::unique_ptr<uint8_t[]> test_frame(new uint8_t[size]);
+  for (size_t i = comparison->begin; i < comparison->end; ++i) {
+    const FramePair& pair = comparison->frame_pairs[i];
+    if (!reference_reader.ReadFrame(pair.reference_frame,
+                                    reference_frame.get()) ||
+        !test_reader.ReadFrame(pair.test_frame, test_frame.get())) {
+      continue;
+    }
+    comparison->results[i] = AnalysisResult(
+        pair.frame_number,
+        CalculateMetrics(kPSNR, reference_frame.get(), test_frame.get(),
+                         comparison->width, comparison->height),
+        CalculateMetrics(kSSIM, reference_frame.get(), test_frame.get(),
+                         comparison->width, comparison->height));
+    comparison->read_frames[i] = 1;
+  }
+}
+
+}  // namespace
+
 ResultsContainer::ResultsContainer() {}
 ResultsContainer::~ResultsContainer() {}
 
+I420FrameFileReader::I420FrameFileReader(const std::string& file_name,
+                                         int width,
+                                         int height,
+                                         bool y4m)
+    : file_name_(file_name),
+      frame_size_(GetI420FrameSize(width, height)),
+      y4m_(y4m),
+      file_(NULL),
+      first_frame_offset_(0),
+      frame_stride_(static_cast<long>(frame_size_)),
+      num_frames_(0) {}
+
+I420FrameFileReader::~I420FrameFileReader() {
+  if (file_ != NULL)
+    fclose(file_);
+}
+
+bool I420FrameFileReader::Init() {
+  file_ = fopen(file_name_.c_str(), "rb");
+  if (file_ == NULL) {
+    fprintf(stderr, "Couldn't open input file for reading: %s\n",
+            file_name_.c_str());
+    return false;
+  }
+
+  if (y4m_) {
+    // YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header.
+    // The file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
+    char header[Y4M_FILE_HEADER_MAX_SIZE];
+    size_t bytes_read = fread(header, 1, Y4M_FILE_HEADER_MAX_SIZE - 1, file_);
+    header[bytes_read] = '\0';
+    std::string header_contents(header);
+    std::size_t found = header_contents.find(Y4M_FRAME_DELIMITER);
+    if (found == std::string::npos) {
+      fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
+              header_contents.c_str());
+      return false;
+    }
+    first_frame_offset_ = static_cast<long>(found) + Y4M_FRAME_HEADER_SIZE;
+    frame_stride_ += Y4M_FRAME_HEADER_SIZE;
+  }
+
+  if (fseek(file_, 0, SEEK_END) != 0)
+    return false;
+  const long file_size = ftell(file_);
+  const long frame_size = static_cast<long>(frame_size_);
+  if (file_size >= first_frame_offset_ + frame_size) {
+    num_frames_ = static_cast<int>(
+        (file_size - first_frame_offset_ - frame_size) / frame_stride_ + 1);
+  }
+  return true;
+}
+
+bool I420FrameFileReader::ReadFrame(int frame_number, uint8_t* result_frame) {
+  if (file_ == NULL || frame_number < 0 || frame_number >= num_frames_)
+    return false;
+  if (fseek(file_, first_frame_offset_ + frame_number * frame_stride_,
+            SEEK_SET) != 0) {
+    return false;
+  }
+  if (fread(result_frame, 1, frame_size_, file_) != frame_size_) {
+    fprintf(stdout, "Error while reading frame no %d from file %s\n",
+            frame_number, file_name_.c_str());
+    return false;
+  }
+  return true;
+}
+
+void CompareFrames(const char* reference_file_name,
+                   const char* test_file_name,
+                   int width,
+                   int height,
+                   const std::vector<FramePair>& frame_pairs,
+                   int num_threads,
+                   ResultsContainer* results) {
+  if (frame_pairs.empty())
+    return;
+  const size_t num_ranges = std::max<size_t>(
+      1, std::min<size_t>(num_threads, frame_pairs.size()));
+  std::vector<AnalysisResult> compared(frame_pairs.size());
+  std::vector<uint8_t> read_frames(frame_pairs.size(), 0);
+
+  // Consecutive pairs are compared on the same thread, which then mostly reads
+  // the files sequentially.
+  std::vector<FrameComparison> comparisons(num_ranges);
+  size_t begin = 0;
+  for (size_t i = 0; i < num_ranges; ++i) {
+    FrameComparison& comparison = comparisons[i];
+    comparison.reference_file_name = reference_file_name;
+    comparison.test_file_name = test_file_name;
+    comparison.width = width;
+    comparison.height = height;
+    comparison.frame_pairs = frame_pairs.data();
+    comparison.begin = begin;
+    begin += frame_pairs.size() / num_ranges +
+             (i < frame_pairs.size() % num_ranges ? 1 : 0);
+    comparison.end = begin;
+    comparison.results = compared.data();
+    comparison.read_frames = read_frames.data();
+  }
+
+  // The first range is compared on the calling thread.
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 1; i < num_ranges; ++i) {
+    threads.emplace_back(new rtc::PlatformThread(
+        &CompareFrameRange, &comparisons[i], "CompareFrames"));
+    threads.back()->Start();
+  }
+  CompareFrameRange(&comparisons[0]);
+  for (const auto& thread : threads)
+    thread->Stop();
+
+  for (size_t i = 0; i < compared.size(); ++i) {
+    if (read_frames[i])
+      results->frames.push_back(compared[i]);
+  }
+}
+
 int GetI420FrameSize(int width, int height) {
   int half_width = (width + 1) >> 1;
   int half_height = (height + 1) >> 1;
@@ -232,22 +406,12 @@ void RunAnalysis(const char* reference_file_name,
                  int width,
                  int height,
                  ResultsContainer* results) {
-  // Check if the reference_file_name ends with "y4m".
-  bool y4m_mode = false;
-  if (std::string(reference_file_name).find("y4m") != std::string::npos) {
-    y4m_mode = true;
-  }
-
-  int size = GetI420FrameSize(width, height);
   FILE* stats_file_ref = fopen(stats_file_reference_name, "r");
   FILE* stats_file_test = fopen(stats_file_test_name, "r");
 
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
 
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* reference_frame = new uint8_t[size];
   int previous_frame_number = -1;
 
   // Maps barcode id to the frame id for the reference video.
@@ -263,6 +427,8 @@ void RunAnalysis(const char* reference_file_name,
         std::make_pair(decoded_frame_number, extracted_ref_frame));
   }
 
+  // The frames to compare, which are then compared in parallel.
+  std::vector<FramePair> frame_pairs;
   while (GetNextStatsLine(stats_file_test, line)) {
     int extracted_test_frame = ExtractFrameSequenceNumber(line);
     int decoded_frame_number = ExtractDecodedFrameNumber(line);
@@ -284,38 +450,17 @@ void RunAnalysis(const char* reference_file_name,
     assert(extracted_test_frame != -1);
     assert(decoded_frame_number != -1);
 
-    ExtractFrameFromYuvFile(test_file_name, width, height, extracted_test_frame,
-                            test_frame);
-    if (y4m_mode) {
-      ExtractFrameFromY4mFile(reference_file_name, width, height,
-                              extracted_ref_frame, reference_frame);
-    } else {
-      ExtractFrameFromYuvFile(reference_file_name, width, height,
-                              extracted_ref_frame, reference_frame);
-    }
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr =
-        CalculateMetrics(kPSNR, reference_frame, test_frame, width, height);
-    double result_ssim =
-        CalculateMetrics(kSSIM, reference_frame, test_frame, width, height);
-
     previous_frame_number = decoded_frame_number;
-
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
-
-    results->frames.push_back(result);
+    frame_pairs.push_back(
+        {decoded_frame_number, extracted_ref_frame, extracted_test_frame});
   }
 
   // Cleanup.
   fclose(stats_file_ref);
   fclose(stats_file_test);
-  delete[] test_frame;
-  delete[] reference_frame;
+
+  CompareFrames(reference_file_name, test_file_name, width, height,
+                frame_pairs, CpuInfo::DetectNumberOfCores(), results);
 }
 
 void PrintMaxRepeatedAndSkippedFrames(const std::string& label,
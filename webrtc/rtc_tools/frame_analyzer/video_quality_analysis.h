@@ -11,12 +11,15 @@
 #ifndef WEBRTC_RTC_TOOLS_FRAME_ANALYZER_VIDEO_QUALITY_ANALYSIS_H_
 #define WEBRTC_RTC_TOOLS_FRAME_ANALYZER_VIDEO_QUALITY_ANALYSIS_H_
 
+#include <stdio.h>
+
 #include <string>
 #include <vector>
 #include <utility>
 
 #include "libyuv/compare.h"  // NOLINT
 #include "libyuv/convert.h"  // NOLINT
+#include "webrtc/rtc_base/constructormagic.h"
 
 namespace webrtc {
 namespace test {
@@ -41,6 +44,65 @@ struct ResultsContainer {
 
 enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 
+// Reads I420 frames from a raw YUV file, or from a Y4M file if |y4m| is set.
+// Unlike ExtractFrameFromYuvFile() and ExtractFrameFromY4mFile(), which open
+// the file, and parse the Y4M header, for every frame, the reader opens the
+// file once, in Init().
+class I420FrameFileReader {
+ public:
+  I420FrameFileReader(const std::string& file_name,
+                      int width,
+                      int height,
+                      bool y4m);
+  ~I420FrameFileReader();
+
+  // Returns false if the file can't be opened or its Y4M header is corrupted.
+  bool Init();
+
+  // The number of complete frames in the file.
+  int num_frames() const { return num_frames_; }
+
+  // Reads the frame at position |frame_number|, the first being 0, into
+  // |result_frame|, which must have room for GetI420FrameSize(width, height)
+  // bytes. Returns false if the file doesn't have the whole frame.
+  bool ReadFrame(int frame_number, uint8_t* result_frame);
+
+ private:
+  const std::string file_name_;
+  const size_t frame_size_;
+  const bool y4m_;
+  FILE* file_;
+  // Where the data of the first frame starts, and how far apart the frames
+  // are, which for Y4M includes the header of each frame.
+  long first_frame_offset_;
+  long frame_stride_;
+  int num_frames_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(I420FrameFileReader);
+};
+
+// A frame to compare: the frame at |reference_frame| in the reference file with
+// the one at |test_frame| in the test file, reported as |frame_number|.
+struct FramePair {
+  int frame_number;
+  int reference_frame;
+  int test_frame;
+};
+
+// Calculates the PSNR and SSIM of every pair in |frame_pairs|, spread over
+// |num_threads| threads that each read the frames they compare with their own
+// I420FrameFileReaders. Like RunAnalysis, the reference file is read as Y4M if
+// its name contains "y4m", and the test file is raw YUV. Adds the results to
+// |results| in the order of |frame_pairs|, leaving out the pairs of which a
+// frame can't be read.
+void CompareFrames(const char* reference_file_name,
+                   const char* test_file_name,
+                   int width,
+                   int height,
+                   const std::vector<FramePair>& frame_pairs,
+                   int num_threads,
+                   ResultsContainer* results);
+
 // A function to run the PSNR and SSIM analysis on the test file. The test file
 // comprises the frames that were captured during the quality measurement test.
 // There may be missing or duplicate frames. Also the frames start at a random
@@ -55,7 +117,7 @@ enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 // integrated in every video and generates the stats file. If three was some
 // problem with the decoding there would be 'Barcode error' instead of yyyy.
 // The stat files are used to compare the right frames with each other and
-// to calculate statistics.
+// to calculate statistics. The frames are compared on all cores.
 void RunAnalysis(const char* reference_file_name,
                  const char* test_file_name,
                  const char* stats_file_reference_name,
@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "webrtc/rtc_tools/frame_analyzer/video_quality_analysis.h"
 #include "webrtc/test/gtest.h"
@@ -67,6 +68,97 @@ TEST_F(VideoQualityAnalysisTest, MatchExtractedY4mFrame) {
   delete[] expected_frame;
 }
 
+TEST_F(VideoQualityAnalysisTest, ReadFramesFromY4mFile) {
+  const int kWidth = 4, kHeight = 2, kNumFrames = 3;
+  const int size = GetI420FrameSize(kWidth, kHeight);
+  std::string y4m_filename =
+      TempFilename(OutputPath(), "VideoQualityAnalysisTest.y4m");
+  FILE* y4m_file = fopen(y4m_filename.c_str(), "wb");
+  ASSERT_TRUE(y4m_file != NULL);
+  fprintf(y4m_file, "YUV4MPEG2 W%d H%d F30:1 C420\n", kWidth, kHeight);
+  for (int i = 0; i < kNumFrames; ++i) {
+    fprintf(y4m_file, "FRAME\n");
+    for (int j = 0; j < size; ++j)
+      fputc(i * size + j, y4m_file);
+  }
+  // Half a frame, which isn't read.
+  fprintf(y4m_file, "FRAME\n");
+  for (int j = 0; j < size / 2; ++j)
+    fputc(0, y4m_file);
+  fclose(y4m_file);
+
+  I420FrameFileReader reader(y4m_filename, kWidth, kHeight, true);
+  ASSERT_TRUE(reader.Init());
+  EXPECT_EQ(kNumFrames, reader.num_frames());
+  std::vector<uint8_t> frame(size);
+  std::vector<uint8_t> extracted_frame(size);
+  // Out of order, to check that the reader seeks to each frame.
+  for (int i : {2, 0, 1}) {
+    ASSERT_TRUE(reader.ReadFrame(i, frame.data()));
+    EXPECT_EQ(i * size, frame[0]);
+    EXPECT_EQ(i * size + size - 1, frame[size - 1]);
+    ASSERT_TRUE(ExtractFrameFromY4mFile(y4m_filename.c_str(), kWidth, kHeight,
+                                        i, extracted_frame.data()));
+    EXPECT_EQ(extracted_frame, frame);
+  }
+  EXPECT_FALSE(reader.ReadFrame(kNumFrames, frame.data()));
+  remove(y4m_filename.c_str());
+}
+
+TEST_F(VideoQualityAnalysisTest, CompareFramesOnSeveralThreads) {
+  const int kWidth = 64, kHeight = 48, kNumFrames = 10;
+  const int size = GetI420FrameSize(kWidth, kHeight);
+  std::string reference_filename =
+      TempFilename(OutputPath(), "VideoQualityAnalysisTest_reference.yuv");
+  std::string test_filename =
+      TempFilename(OutputPath(), "VideoQualityAnalysisTest_test.yuv");
+  std::vector<std::vector<uint8_t>> reference_frames;
+  std::vector<std::vector<uint8_t>> test_frames;
+  FILE* reference_file = fopen(reference_filename.c_str(), "wb");
+  FILE* test_file = fopen(test_filename.c_str(), "wb");
+  ASSERT_TRUE(reference_file != NULL);
+  ASSERT_TRUE(test_file != NULL);
+  for (int i = 0; i < kNumFrames; ++i) {
+    std::vector<uint8_t> reference_frame(size);
+    std::vector<uint8_t> test_frame(size);
+    for (int j = 0; j < size; ++j) {
+      reference_frame[j] = static_cast<uint8_t>(i * 7 + j * 3);
+      test_frame[j] = static_cast<uint8_t>(reference_frame[j] + (j % (i + 2)));
+    }
+    fwrite(reference_frame.data(), 1, size, reference_file);
+    fwrite(test_frame.data(), 1, size, test_file);
+    reference_frames.push_back(reference_frame);
+    test_frames.push_back(test_frame);
+  }
+  fclose(reference_file);
+  fclose(test_file);
+
+  // Compare each test frame with the reference frame before it, and one pair
+  // past the end of the files.
+  std::vector<FramePair> frame_pairs;
+  for (int i = 1; i < kNumFrames; ++i)
+    frame_pairs.push_back({100 + i, i - 1, i});
+  frame_pairs.push_back({200, kNumFrames, kNumFrames});
+
+  ResultsContainer results;
+  CompareFrames(reference_filename.c_str(), test_filename.c_str(), kWidth,
+                kHeight, frame_pairs, 4, &results);
+  remove(reference_filename.c_str());
+  remove(test_filename.c_str());
+
+  ASSERT_EQ(static_cast<size_t>(kNumFrames - 1), results.frames.size());
+  for (int i = 1; i < kNumFrames; ++i) {
+    const AnalysisResult& result = results.frames[i - 1];
+    EXPECT_EQ(100 + i, result.frame_number);
+    EXPECT_EQ(CalculateMetrics(kPSNR, reference_frames[i - 1].data(),
+                               test_frames[i].data(), kWidth, kHeight),
+              result.psnr_value);
+    EXPECT_EQ(CalculateMetrics(kSSIM, reference_frames[i - 1].data(),
+                               test_frames[i].data(), kWidth, kHeight),
+              result.ssim_value);
+  }
+}
+
 TEST_F(VideoQualityAnalysisTest, PrintAnalysisResultsEmpty) {
   ResultsContainer result;
   PrintAnalysisResults(logfile_, "Empty", &result);
@@ -8,18 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "webrtc/rtc_tools/frame_analyzer/video_quality_analysis.h"
 #include "webrtc/rtc_tools/simple_command_line_parser.h"
-
-#define MAX_NUM_FRAMES_PER_FILE INT_MAX
+#include "webrtc/system_wrappers/include/cpu_info.h"
 
 void CompareFiles(const char* reference_file_name, const char* test_file_name,
                   const char* results_file_name, int width, int height) {
@@ -29,38 +28,31 @@ void CompareFiles(const char* reference_file_name, const char* test_file_name,
     y4m_mode = true;
   }
 
-  FILE* results_file = fopen(results_file_name, "w");
+  webrtc::test::I420FrameFileReader reference_reader(reference_file_name,
+                                                    width, height, y4m_mode);
+  webrtc::test::I420FrameFileReader test_reader(test_file_name, width, height,
+                                               false);
+  if (!reference_reader.Init() || !test_reader.Init())
+    return;
+
+  // Compare the frames until either file runs out of them.
+  std::vector<webrtc::test::FramePair> frame_pairs;
+  const int num_frames =
+      std::min(reference_reader.num_frames(), test_reader.num_frames());
+  for (int frame_counter = 0; frame_counter < num_frames; ++frame_counter)
+    frame_pairs.push_back({frame_counter, frame_counter, frame_counter});
+
+  webrtc::test::ResultsContainer results;
+  webrtc::test::CompareFrames(reference_file_name, test_file_name, width,
+                              height, frame_pairs,
+                              webrtc::CpuInfo::DetectNumberOfCores(),
+                              &results);
 
-  int size = webrtc::test::GetI420FrameSize(width, height);
-
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* ref_frame = new uint8_t[size];
-
-  bool read_result = true;
-  for (int frame_counter = 0; frame_counter < MAX_NUM_FRAMES_PER_FILE;
-      ++frame_counter) {
-    read_result &= (y4m_mode) ? webrtc::test::ExtractFrameFromY4mFile(
-        reference_file_name, width, height, frame_counter, ref_frame):
-        webrtc::test::ExtractFrameFromYuvFile(reference_file_name, width,
-                                              height, frame_counter, ref_frame);
-    read_result &=  webrtc::test::ExtractFrameFromYuvFile(test_file_name, width,
-        height, frame_counter, test_frame);
-
-    if (!read_result)
-      break;
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::CalculateMetrics(
-        webrtc::test::kPSNR, ref_frame, test_frame, width, height);
-    double result_ssim = webrtc::test::CalculateMetrics(
-        webrtc::test::kSSIM, ref_frame, test_frame, width, height);
-    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
-            result_psnr, result_ssim);
+  FILE* results_file = fopen(results_file_name, "w");
+  for (const webrtc::test::AnalysisResult& result : results.frames) {
+    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n",
+            result.frame_number, result.psnr_value, result.ssim_value);
   }
-  delete[] test_frame;
-  delete[] ref_frame;
-
   fclose(results_file);
 }
 
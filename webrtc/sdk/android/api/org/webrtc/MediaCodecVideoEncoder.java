@@ -211,6 +211,9 @@ public class MediaCodecVideoEncoder {
 
   // SPS and PPS NALs (Config frame) for H.264.
   private ByteBuffer configData = null;
+  // Reused for H.264 key frames prefixed with the config frame. The native side consumes each
+  // output buffer before the next one is dequeued, so a single buffer is enough.
+  private ByteBuffer keyFrameBuffer = null;
 
   // MediaCodec error handler - invoked when critical error happens which may prevent
   // further use of media codec API. Now it means that one of media codec instances
@@ -832,12 +835,18 @@ public class MediaCodecVideoEncoder {
           Logging.d(TAG, "Appending config frame of size " + configData.capacity()
                   + " to output buffer with offset " + info.offset + ", size " + info.size);
           // For H.264 key frame append SPS and PPS NALs at the start
-          ByteBuffer keyFrameBuffer = ByteBuffer.allocateDirect(configData.capacity() + info.size);
+          final int keyFrameSize = configData.capacity() + info.size;
+          if (keyFrameBuffer == null || keyFrameBuffer.capacity() < keyFrameSize) {
+            keyFrameBuffer = ByteBuffer.allocateDirect(keyFrameSize);
+          }
+          keyFrameBuffer.clear();
           configData.rewind();
           keyFrameBuffer.put(configData);
           keyFrameBuffer.put(outputBuffer);
-          keyFrameBuffer.position(0);
-          return new OutputBufferInfo(result, keyFrameBuffer, isKeyFrame, info.presentationTimeUs);
+          keyFrameBuffer.flip();
+          // Slice so that the capacity seen from native code is the payload size.
+          return new OutputBufferInfo(
+              result, keyFrameBuffer.slice(), isKeyFrame, info.presentationTimeUs);
         } else {
           return new OutputBufferInfo(
               result, outputBuffer.slice(), isKeyFrame, info.presentationTimeUs);
@@ -47,7 +47,7 @@ public class NV12Buffer implements VideoFrame.Buffer {
 
   @Override
   public VideoFrame.I420Buffer toI420() {
-    return (VideoFrame.I420Buffer) cropAndScale(0, 0, width, height, width, height);
+    return cropAndScaleToI420(0, 0, width, height, width, height);
   }
 
   @Override
@@ -69,6 +69,31 @@ public class NV12Buffer implements VideoFrame.Buffer {
   @Override
   public VideoFrame.Buffer cropAndScale(
       int cropX, int cropY, int cropWidth, int cropHeight, int scaleWidth, int scaleHeight) {
+    // Native code wraps NV12 buffers without converting them, so don't convert a frame that is
+    // passed through as is.
+    if (cropX == 0 && cropY == 0 && cropWidth == width && cropHeight == height
+        && scaleWidth == width && scaleHeight == height) {
+      retain();
+      return this;
+    }
+    return cropAndScaleToI420(cropX, cropY, cropWidth, cropHeight, scaleWidth, scaleHeight);
+  }
+
+  // The getters below are used by native code to wrap the buffer without copying.
+  ByteBuffer getBuffer() {
+    return buffer;
+  }
+
+  int getStride() {
+    return stride;
+  }
+
+  int getSliceHeight() {
+    return sliceHeight;
+  }
+
+  private VideoFrame.I420Buffer cropAndScaleToI420(
+      int cropX, int cropY, int cropWidth, int cropHeight, int scaleWidth, int scaleHeight) {
     I420BufferImpl newBuffer = I420BufferImpl.allocate(scaleWidth, scaleHeight);
     nativeCropAndScale(cropX, cropY, cropWidth, cropHeight, scaleWidth, scaleHeight, buffer, width,
         height, stride, sliceHeight, newBuffer.getDataY(), newBuffer.getStrideY(),
@@ -20,6 +20,7 @@
 
 #include "third_party/libyuv/include/libyuv/convert.h"
 #include "third_party/libyuv/include/libyuv/convert_from.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
 #include "third_party/libyuv/include/libyuv/video_common.h"
 #include "webrtc/api/video_codecs/video_encoder.h"
 #include "webrtc/common_types.h"
@@ -170,6 +171,11 @@ class MediaCodecVideoEncoder : public VideoEncoder {
                         bool key_frame,
                         const VideoFrame& frame,
                         int input_buffer_index);
+  // Fills the input buffer from an NV12 frame, without an intermediate I420
+  // conversion.
+  bool FillInputBufferFromNV12(JNIEnv* jni,
+                               int input_buffer_index,
+                               const NV12BufferInterface& buffer);
   bool EncodeTexture(JNIEnv* jni, bool key_frame, const VideoFrame& frame);
   // Encodes a new style org.webrtc.VideoFrame. Might be a I420 or a texture
   // frame.
@@ -900,13 +906,18 @@ bool MediaCodecVideoEncoder::EncodeByteBuffer(JNIEnv* jni,
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_checker_);
   RTC_CHECK(!use_surface_);
 
-  rtc::scoped_refptr<I420BufferInterface> i420_buffer =
-      frame.video_frame_buffer()->ToI420();
-  if (!FillInputBuffer(jni, input_buffer_index, i420_buffer->DataY(),
-                       i420_buffer->StrideY(), i420_buffer->DataU(),
-                       i420_buffer->StrideU(), i420_buffer->DataV(),
-                       i420_buffer->StrideV())) {
-    return false;
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = frame.video_frame_buffer();
+  if (buffer->type() == VideoFrameBuffer::Type::kNV12) {
+    if (!FillInputBufferFromNV12(jni, input_buffer_index, *buffer->GetNV12()))
+      return false;
+  } else {
+    rtc::scoped_refptr<I420BufferInterface> i420_buffer = buffer->ToI420();
+    if (!FillInputBuffer(jni, input_buffer_index, i420_buffer->DataY(),
+                         i420_buffer->StrideY(), i420_buffer->DataU(),
+                         i420_buffer->StrideU(), i420_buffer->DataV(),
+                         i420_buffer->StrideV())) {
+      return false;
+    }
   }
   bool encode_status = jni->CallBooleanMethod(
       *j_media_codec_video_encoder_, j_encode_buffer_method_, key_frame,
@@ -944,6 +955,41 @@ bool MediaCodecVideoEncoder::FillInputBuffer(JNIEnv* jni,
   return true;
 }
 
+bool MediaCodecVideoEncoder::FillInputBufferFromNV12(
+    JNIEnv* jni,
+    int input_buffer_index,
+    const NV12BufferInterface& buffer) {
+  jobject j_input_buffer = input_buffers_[input_buffer_index];
+  uint8_t* yuv_buffer =
+      reinterpret_cast<uint8_t*>(jni->GetDirectBufferAddress(j_input_buffer));
+  if (CheckException(jni)) {
+    ALOGE << "Exception in get direct buffer address.";
+    ProcessHWError(true /* reset_if_fallback_unavailable */);
+    return false;
+  }
+  RTC_CHECK(yuv_buffer) << "Indirect buffer??";
+
+  // Same layout as libyuv::ConvertFromI420() produces in FillInputBuffer().
+  uint8_t* dst_y = yuv_buffer;
+  uint8_t* dst_uv = yuv_buffer + width_ * height_;
+  if (encoder_fourcc_ == libyuv::FOURCC_NV12) {
+    libyuv::CopyPlane(buffer.DataY(), buffer.StrideY(), dst_y, width_, width_,
+                      height_);
+    libyuv::CopyPlane(buffer.DataUV(), buffer.StrideUV(), dst_uv, width_,
+                      2 * buffer.ChromaWidth(), buffer.ChromaHeight());
+  } else {
+    RTC_DCHECK_EQ(libyuv::FOURCC_YU12, encoder_fourcc_);
+    const int stride_uv = (width_ + 1) / 2;
+    uint8_t* dst_v = dst_uv + stride_uv * ((height_ + 1) / 2);
+    RTC_CHECK(!libyuv::NV12ToI420(buffer.DataY(), buffer.StrideY(),
+                                  buffer.DataUV(), buffer.StrideUV(), dst_y,
+                                  width_, dst_uv, stride_uv, dst_v, stride_uv,
+                                  width_, height_))
+        << "NV12ToI420 failed";
+  }
+  return true;
+}
+
 bool MediaCodecVideoEncoder::EncodeTexture(JNIEnv* jni,
                                            bool key_frame,
                                            const VideoFrame& frame) {
@@ -12,7 +12,9 @@
 
 #include <memory>
 
+#include "webrtc/api/video/nv12_buffer.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/rtc_base/bind.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/keep_ref_until_done.h"
@@ -151,6 +153,198 @@ AndroidVideoI420Buffer::~AndroidVideoI420Buffer() {
   jni->CallVoidMethod(*j_video_frame_buffer_, j_release_id_);
 }
 
+rtc::scoped_refptr<VideoFrameBuffer> CropAndScaleNV12(
+    const rtc::scoped_refptr<NV12BufferInterface>& buffer,
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height);
+
+// A cropped view of the pixel data of another NV12 buffer, which it keeps
+// alive.
+class CroppedNV12Buffer : public NV12BufferInterface {
+ public:
+  // The offsets must be even so that the UV plane stays aligned.
+  CroppedNV12Buffer(const rtc::scoped_refptr<NV12BufferInterface>& buffer,
+                    int offset_x,
+                    int offset_y,
+                    int width,
+                    int height)
+      : buffer_(buffer),
+        width_(width),
+        height_(height),
+        data_y_(buffer->DataY() + offset_y * buffer->StrideY() + offset_x),
+        data_uv_(buffer->DataUV() + offset_y / 2 * buffer->StrideUV() +
+                 offset_x) {
+    RTC_DCHECK_EQ(0, offset_x % 2);
+    RTC_DCHECK_EQ(0, offset_y % 2);
+  }
+
+ private:
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+
+  const uint8_t* DataY() const override { return data_y_; }
+  const uint8_t* DataUV() const override { return data_uv_; }
+
+  int StrideY() const override { return buffer_->StrideY(); }
+  int StrideUV() const override { return buffer_->StrideUV(); }
+
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override {
+    return CropAndScaleNV12(this, offset_x, offset_y, crop_width, crop_height,
+                            scaled_width, scaled_height);
+  }
+
+  const rtc::scoped_refptr<NV12BufferInterface> buffer_;
+  const int width_;
+  const int height_;
+  const uint8_t* const data_y_;
+  const uint8_t* const data_uv_;
+};
+
+// Crops without copying when there is no scaling, and otherwise scales into a
+// new NV12 buffer, so that NV12 frames are never converted to I420 here.
+rtc::scoped_refptr<VideoFrameBuffer> CropAndScaleNV12(
+    const rtc::scoped_refptr<NV12BufferInterface>& buffer,
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  if (crop_width == scaled_width && crop_height == scaled_height) {
+    // Round the offsets down to even numbers, like NV12CropAndScale().
+    return new rtc::RefCountedObject<CroppedNV12Buffer>(
+        buffer, offset_x & ~1, offset_y & ~1, crop_width, crop_height);
+  }
+  rtc::scoped_refptr<NV12Buffer> scaled_buffer =
+      NV12Buffer::Create(scaled_width, scaled_height);
+  std::vector<uint8_t> tmp_buffer;
+  NV12CropAndScale(*buffer, offset_x, offset_y, crop_width, crop_height,
+                   scaled_buffer.get(), &tmp_buffer);
+  return scaled_buffer;
+}
+
+// Wraps an org.webrtc.NV12Buffer, so that its pixel data can be used directly
+// instead of being converted to I420 by VideoFrame.Buffer.toI420().
+class AndroidNV12Buffer : public NV12BufferInterface {
+ public:
+  // Wraps an existing reference to a Java NV12Buffer. Retain will not be
+  // called but release will be called when the C++ object is destroyed.
+  static rtc::scoped_refptr<AndroidNV12Buffer> WrapReference(
+      JNIEnv* jni,
+      jmethodID j_release_id,
+      int width,
+      int height,
+      jobject j_nv12_buffer);
+
+ protected:
+  AndroidNV12Buffer(JNIEnv* jni,
+                    jmethodID j_retain_id,
+                    jmethodID j_release_id,
+                    int width,
+                    int height,
+                    jobject j_nv12_buffer);
+  // Should not be called directly. Wraps a reference. Use
+  // AndroidNV12Buffer::WrapReference instead for clarity.
+  AndroidNV12Buffer(JNIEnv* jni,
+                    jmethodID j_release_id,
+                    int width,
+                    int height,
+                    jobject j_nv12_buffer);
+  ~AndroidNV12Buffer() override;
+
+ private:
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+
+  const uint8_t* DataY() const override { return data_y_; }
+  const uint8_t* DataUV() const override { return data_uv_; }
+
+  int StrideY() const override { return stride_; }
+  int StrideUV() const override { return stride_; }
+
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override {
+    return CropAndScaleNV12(this, offset_x, offset_y, crop_width, crop_height,
+                            scaled_width, scaled_height);
+  }
+
+  const jmethodID j_release_id_;
+  const int width_;
+  const int height_;
+  // Holds an org.webrtc.NV12Buffer.
+  const ScopedGlobalRef<jobject> j_nv12_buffer_;
+
+  const uint8_t* data_y_;
+  const uint8_t* data_uv_;
+  int stride_;
+};
+
+rtc::scoped_refptr<AndroidNV12Buffer> AndroidNV12Buffer::WrapReference(
+    JNIEnv* jni,
+    jmethodID j_release_id,
+    int width,
+    int height,
+    jobject j_nv12_buffer) {
+  return new rtc::RefCountedObject<AndroidNV12Buffer>(
+      jni, j_release_id, width, height, j_nv12_buffer);
+}
+
+AndroidNV12Buffer::AndroidNV12Buffer(JNIEnv* jni,
+                                     jmethodID j_retain_id,
+                                     jmethodID j_release_id,
+                                     int width,
+                                     int height,
+                                     jobject j_nv12_buffer)
+    : AndroidNV12Buffer(jni, j_release_id, width, height, j_nv12_buffer) {
+  jni->CallVoidMethod(j_nv12_buffer, j_retain_id);
+}
+
+AndroidNV12Buffer::AndroidNV12Buffer(JNIEnv* jni,
+                                     jmethodID j_release_id,
+                                     int width,
+                                     int height,
+                                     jobject j_nv12_buffer)
+    : j_release_id_(j_release_id),
+      width_(width),
+      height_(height),
+      j_nv12_buffer_(jni, j_nv12_buffer) {
+  jclass j_nv12_buffer_class = FindClass(jni, "org/webrtc/NV12Buffer");
+  jmethodID j_get_buffer_id = jni->GetMethodID(
+      j_nv12_buffer_class, "getBuffer", "()Ljava/nio/ByteBuffer;");
+  jmethodID j_get_stride_id =
+      jni->GetMethodID(j_nv12_buffer_class, "getStride", "()I");
+  jmethodID j_get_slice_height_id =
+      jni->GetMethodID(j_nv12_buffer_class, "getSliceHeight", "()I");
+
+  jobject j_data = jni->CallObjectMethod(j_nv12_buffer, j_get_buffer_id);
+  stride_ = jni->CallIntMethod(j_nv12_buffer, j_get_stride_id);
+  const int slice_height =
+      jni->CallIntMethod(j_nv12_buffer, j_get_slice_height_id);
+
+  data_y_ = static_cast<const uint8_t*>(jni->GetDirectBufferAddress(j_data));
+  data_uv_ = data_y_ + slice_height * stride_;
+}
+
+AndroidNV12Buffer::~AndroidNV12Buffer() {
+  JNIEnv* jni = AttachCurrentThreadIfNeeded();
+  jni->CallVoidMethod(*j_nv12_buffer_, j_release_id_);
+}
+
 }  // namespace
 
 Matrix::Matrix(JNIEnv* jni, jfloatArray a) {
@@ -324,6 +518,26 @@ rtc::scoped_refptr<I420BufferInterface> AndroidTextureBuffer::ToI420() {
   return copy;
 }
 
+rtc::scoped_refptr<VideoFrameBuffer> AndroidTextureBuffer::CropAndScale(
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  Matrix matrix = native_handle_.sampling_matrix;
+  matrix.Crop(crop_width / static_cast<float>(width_),
+              crop_height / static_cast<float>(height_),
+              offset_x / static_cast<float>(width_),
+              offset_y / static_cast<float>(height_));
+  // The new buffer shares the texture, so keep this buffer, and thereby the
+  // texture, alive until the new one is released.
+  return new rtc::RefCountedObject<AndroidTextureBuffer>(
+      scaled_width, scaled_height,
+      NativeHandleImpl(native_handle_.oes_texture_id, matrix),
+      surface_texture_helper_, rtc::KeepRefUntilDone(this));
+}
+
 rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::WrapReference(
     JNIEnv* jni,
     jmethodID j_release_id,
@@ -398,6 +612,31 @@ rtc::scoped_refptr<I420BufferInterface> AndroidVideoBuffer::ToI420() {
                                                height_, j_i420_buffer);
 }
 
+rtc::scoped_refptr<VideoFrameBuffer> AndroidVideoBuffer::CropAndScale(
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  JNIEnv* jni = AttachCurrentThreadIfNeeded();
+  ScopedLocalRefFrame local_ref_frame(jni);
+
+  jclass j_video_frame_buffer_class =
+      FindClass(jni, "org/webrtc/VideoFrame$Buffer");
+  jmethodID j_crop_and_scale_id =
+      jni->GetMethodID(j_video_frame_buffer_class, "cropAndScale",
+                       "(IIIIII)Lorg/webrtc/VideoFrame$Buffer;");
+
+  jobject j_cropped_buffer = jni->CallObjectMethod(
+      *j_video_frame_buffer_, j_crop_and_scale_id, offset_x, offset_y,
+      crop_width, crop_height, scaled_width, scaled_height);
+
+  // cropAndScale returns a new object that we take the ownership of.
+  return WrapReference(jni, j_release_id_, scaled_width, scaled_height,
+                       j_cropped_buffer);
+}
+
 jobject AndroidVideoBuffer::ToJavaI420Frame(JNIEnv* jni, int rotation) {
   jclass j_byte_buffer_class = jni->FindClass("java/nio/ByteBuffer");
   jclass j_i420_frame_class =
@@ -433,7 +672,8 @@ AndroidVideoBufferFactory::AndroidVideoBufferFactory(JNIEnv* jni)
       j_get_width_id_(
           GetMethodID(jni, *j_video_frame_buffer_class_, "getWidth", "()I")),
       j_get_height_id_(
-          GetMethodID(jni, *j_video_frame_buffer_class_, "getHeight", "()I")) {}
+          GetMethodID(jni, *j_video_frame_buffer_class_, "getHeight", "()I")),
+      j_nv12_buffer_class_(jni, FindClass(jni, "org/webrtc/NV12Buffer")) {}
 
 VideoFrame AndroidVideoBufferFactory::CreateFrame(
     JNIEnv* jni,
@@ -444,27 +684,35 @@ VideoFrame AndroidVideoBufferFactory::CreateFrame(
   int rotation = jni->CallIntMethod(j_video_frame, j_get_rotation_id_);
   uint32_t timestamp_ns =
       jni->CallLongMethod(j_video_frame, j_get_timestamp_ns_id_);
-  rtc::scoped_refptr<AndroidVideoBuffer> buffer =
+  rtc::scoped_refptr<VideoFrameBuffer> buffer =
       CreateBuffer(jni, j_video_frame_buffer);
   return VideoFrame(buffer, timestamp_rtp,
                     timestamp_ns / rtc::kNumNanosecsPerMillisec,
                     static_cast<VideoRotation>(rotation));
 }
 
-rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBufferFactory::WrapBuffer(
+rtc::scoped_refptr<VideoFrameBuffer> AndroidVideoBufferFactory::WrapBuffer(
     JNIEnv* jni,
     jobject j_video_frame_buffer) const {
   int width = jni->CallIntMethod(j_video_frame_buffer, j_get_width_id_);
   int height = jni->CallIntMethod(j_video_frame_buffer, j_get_height_id_);
+  if (jni->IsInstanceOf(j_video_frame_buffer, *j_nv12_buffer_class_)) {
+    return AndroidNV12Buffer::WrapReference(jni, j_release_id_, width, height,
+                                            j_video_frame_buffer);
+  }
   return AndroidVideoBuffer::WrapReference(jni, j_release_id_, width, height,
                                            j_video_frame_buffer);
 }
 
-rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBufferFactory::CreateBuffer(
+rtc::scoped_refptr<VideoFrameBuffer> AndroidVideoBufferFactory::CreateBuffer(
     JNIEnv* jni,
     jobject j_video_frame_buffer) const {
   int width = jni->CallIntMethod(j_video_frame_buffer, j_get_width_id_);
   int height = jni->CallIntMethod(j_video_frame_buffer, j_get_height_id_);
+  if (jni->IsInstanceOf(j_video_frame_buffer, *j_nv12_buffer_class_)) {
+    return new rtc::RefCountedObject<AndroidNV12Buffer>(
+        jni, j_retain_id_, j_release_id_, width, height, j_video_frame_buffer);
+  }
   return new rtc::RefCountedObject<AndroidVideoBuffer>(
       jni, j_retain_id_, j_release_id_, width, height, j_video_frame_buffer);
 }
@@ -88,6 +88,14 @@ class AndroidTextureBuffer : public AndroidVideoFrameBuffer {
 
   rtc::scoped_refptr<I420BufferInterface> ToI420() override;
 
+  // Crops by adjusting the sampling matrix, so the texture stays on the GPU.
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(int offset_x,
+                                                    int offset_y,
+                                                    int crop_width,
+                                                    int crop_height,
+                                                    int scaled_width,
+                                                    int scaled_height) override;
+
   AndroidType android_type() override { return AndroidType::kTextureBuffer; }
 
   const int width_;
@@ -140,6 +148,15 @@ class AndroidVideoBuffer : public AndroidVideoFrameBuffer {
 
   rtc::scoped_refptr<I420BufferInterface> ToI420() override;
 
+  // Delegates to VideoFrame.Buffer.cropAndScale(), which keeps texture buffers
+  // on the GPU.
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(int offset_x,
+                                                    int offset_y,
+                                                    int crop_width,
+                                                    int crop_height,
+                                                    int scaled_width,
+                                                    int scaled_height) override;
+
   AndroidType android_type() override { return AndroidType::kJavaBuffer; }
 
   const jmethodID j_release_id_;
@@ -158,12 +175,13 @@ class AndroidVideoBufferFactory {
                          uint32_t timestamp_rtp) const;
 
   // Wraps a buffer to AndroidVideoBuffer without incrementing the reference
-  // count.
-  rtc::scoped_refptr<AndroidVideoBuffer> WrapBuffer(
+  // count. An org.webrtc.NV12Buffer is instead wrapped as a Type::kNV12 buffer
+  // that refers to its pixel data directly.
+  rtc::scoped_refptr<VideoFrameBuffer> WrapBuffer(
       JNIEnv* jni,
       jobject j_video_frame_buffer) const;
 
-  rtc::scoped_refptr<AndroidVideoBuffer> CreateBuffer(
+  rtc::scoped_refptr<VideoFrameBuffer> CreateBuffer(
       JNIEnv* jni,
       jobject j_video_frame_buffer) const;
 
@@ -178,6 +196,8 @@ class AndroidVideoBufferFactory {
   jmethodID j_release_id_;
   jmethodID j_get_width_id_;
   jmethodID j_get_height_id_;
+
+  ScopedGlobalRef<jclass> j_nv12_buffer_class_;
 };
 
 class JavaVideoFrameFactory {
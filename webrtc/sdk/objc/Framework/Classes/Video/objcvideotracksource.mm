@@ -59,10 +59,9 @@ void ObjcVideoTrackSource::OnCapturedFrame(RTCVideoFrame* frame) {
   } else {
     // Adapted I420 frame.
     // TODO(magjed): Optimize this I420 path.
-    rtc::scoped_refptr<I420Buffer> i420_buffer = I420Buffer::Create(adapted_width, adapted_height);
     buffer = new rtc::RefCountedObject<ObjCFrameBuffer>(frame.buffer);
-    i420_buffer->CropAndScaleFrom(*buffer->ToI420(), crop_x, crop_y, crop_width, crop_height);
-    buffer = i420_buffer;
+    buffer = buffer->CropAndScale(
+        crop_x, crop_y, crop_width, crop_height, adapted_width, adapted_height);
   }
 
   // Applying rotation is only supported for legacy reasons and performance is
@@ -20,7 +20,9 @@ extern "C" {
 // List of features in x86.
 typedef enum {
   kSSE2,
-  kSSE3
+  kSSE3,
+  kAVX2,
+  kFMA3
 } CPUFeature;
 
 // List of features in ARM.
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INCLUDE_CPU_INFO_H_
 #define WEBRTC_SYSTEM_WRAPPERS_INCLUDE_CPU_INFO_H_
 
+#include <vector>
+
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -19,6 +21,10 @@ class CpuInfo {
  public:
   static uint32_t DetectNumberOfCores();
 
+  // Returns the logical CPUs of each NUMA node, indexed by node. Where the
+  // topology is not available all cores are reported as a single node.
+  static std::vector<std::vector<int>> DetectNumaNodeCpus();
+
  private:
   CpuInfo() {}
 };
@@ -17,6 +17,7 @@ namespace field_trial {
 // Optionally initialize field trial from a string.
 // This method can be called at most once before any other call into webrtc.
 // E.g. before the peer connection factory is constructed.
+// The trials are parsed here, so that looking them up later is cheap.
 // Note: trials_string must never be destroyed.
 void InitFieldTrialsFromString(const char* trials_string);
 
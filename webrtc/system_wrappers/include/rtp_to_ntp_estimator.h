@@ -11,6 +11,8 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INCLUDE_RTP_TO_NTP_ESTIMATOR_H_
 #define WEBRTC_SYSTEM_WRAPPERS_INCLUDE_RTP_TO_NTP_ESTIMATOR_H_
 
+#include <stddef.h>
+
 #include <list>
 
 #include "webrtc/system_wrappers/include/ntp_time.h"
@@ -19,7 +21,10 @@
 namespace webrtc {
 // Class for converting an RTP timestamp to the NTP domain in milliseconds.
 // The class needs to be trained with (at least 2) RTP/NTP timestamp pairs from
-// RTCP sender reports before the convertion can be done.
+// RTCP sender reports before the convertion can be done. The conversion is a
+// least squares fit over the latest reports, of which the sums are kept
+// updated as reports are added and removed, so that a new report costs the
+// same however many reports are used.
 class RtpToNtpEstimator {
  public:
   RtpToNtpEstimator();
@@ -32,6 +37,10 @@ class RtpToNtpEstimator {
 
     NtpTime ntp_time;
     uint32_t rtp_timestamp;
+    // The NTP time in ms and the unwrapped RTP timestamp, relative to those of
+    // the reference report of the sums.
+    int64_t ntp_ms_delta = 0;
+    int64_t rtp_timestamp_delta = 0;
   };
 
   // Estimated parameters from RTP and NTP timestamp pairs in |measurements_|.
@@ -57,10 +66,26 @@ class RtpToNtpEstimator {
   static const int kMaxInvalidSamples = 3;
 
  private:
+  // Sums of the fit over |measurements_|, of the deltas to the reference.
+  struct Sums {
+    double x = 0.0;
+    double y = 0.0;
+    double xx = 0.0;
+    double xy = 0.0;
+  };
+
+  void AddToSums(const RtcpMeasurement& measurement);
+  void RemoveFromSums(const RtcpMeasurement& measurement);
+  // Makes the oldest report the reference, and sums the deltas to it anew, so
+  // that the deltas stay small enough to be summed exactly.
+  void RebaseSums();
   void UpdateParameters();
 
   int consecutive_invalid_samples_;
   std::list<RtcpMeasurement> measurements_;
+  Sums sums_;
+  // Number of reports removed since the sums were last rebased.
+  size_t removed_since_rebase_;
   Parameters params_;
 };
 
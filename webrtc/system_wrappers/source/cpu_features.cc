@@ -28,22 +28,32 @@ int GetCPUInfoNoASM(CPUFeature feature) {
 #ifndef _MSC_VER
 // Intrinsic for "cpuid".
 #if defined(__pic__) && defined(__i386__)
-static inline void __cpuid(int cpu_info[4], int info_type) {
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
   __asm__ volatile(
     "mov %%ebx, %%edi\n"
     "cpuid\n"
     "xchg %%edi, %%ebx\n"
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(sub_leaf));
 }
 #else
-static inline void __cpuid(int cpu_info[4], int info_type) {
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
   __asm__ volatile(
     "cpuid\n"
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(sub_leaf));
 }
 #endif
+static inline void __cpuid(int cpu_info[4], int info_type) {
+  __cpuidex(cpu_info, info_type, 0);
+}
+
+// Intrinsic for "xgetbv", which older compilers don't know by name.
+static inline uint64_t _xgetbv(unsigned int xcr) {
+  uint32_t eax, edx;
+  __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
@@ -58,6 +68,23 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  // AVX2 and FMA3 also need the OS to save the YMM registers (OSXSAVE and AVX
+  // set, and XCR0 enabling the XMM and YMM state).
+  const int kOsxsaveAndAvx = 0x18000000;
+  const bool has_ymm_state = (cpu_info[2] & kOsxsaveAndAvx) == kOsxsaveAndAvx &&
+                             (_xgetbv(0) & 0x6) == 0x6;
+  if (feature == kFMA3) {
+    return has_ymm_state && 0 != (cpu_info[2] & 0x00001000);
+  }
+  if (feature == kAVX2) {
+    if (!has_ymm_state)
+      return 0;
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7)
+      return 0;
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
@@ -17,6 +17,8 @@
 #include <d3d9.h>
 #endif
 #elif defined(WEBRTC_LINUX)
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #endif
 #if defined(WEBRTC_MAC)
@@ -51,6 +53,52 @@ static int DetectNumberOfCores() {
 
   return number_of_cores;
 }
+
+#if defined(WEBRTC_LINUX)
+// Parses a sysfs CPU list such as "0-3,8-11". Returns false on malformed input.
+static bool ParseCpuList(const char* list, std::vector<int>* cpus) {
+  const char* p = list;
+  while (*p != '\0' && *p != '\n') {
+    char* end;
+    long first = strtol(p, &end, 10);
+    if (end == p || first < 0)
+      return false;
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      last = strtol(p, &end, 10);
+      if (end == p || last < first)
+        return false;
+      p = end;
+    }
+    for (long cpu = first; cpu <= last; ++cpu)
+      cpus->push_back(static_cast<int>(cpu));
+    if (*p == ',')
+      ++p;
+  }
+  return !cpus->empty();
+}
+
+static std::vector<std::vector<int>> DetectNumaNodeCpus() {
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0;; ++node) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+             node);
+    FILE* file = fopen(path, "r");
+    if (!file)
+      break;
+    char list[1024];
+    std::vector<int> cpus;
+    bool ok = fgets(list, sizeof(list), file) && ParseCpuList(list, &cpus);
+    fclose(file);
+    // Nodes without CPUs, e.g. memory-only nodes, are reported as empty.
+    nodes.push_back(ok ? cpus : std::vector<int>());
+  }
+  return nodes;
+}
+#endif
 }
 
 namespace webrtc {
@@ -66,4 +114,19 @@ uint32_t CpuInfo::DetectNumberOfCores() {
   return logical_cpus;
 }
 
+std::vector<std::vector<int>> CpuInfo::DetectNumaNodeCpus() {
+  std::vector<std::vector<int>> nodes;
+#if defined(WEBRTC_LINUX)
+  nodes = internal::DetectNumaNodeCpus();
+#endif
+  if (nodes.empty()) {
+    std::vector<int> cpus(DetectNumberOfCores());
+    for (size_t i = 0; i < cpus.size(); ++i)
+      cpus[i] = static_cast<int>(i);
+    nodes.push_back(cpus);
+  }
+  LOG(LS_INFO) << "Detected number of NUMA nodes: " << nodes.size();
+  return nodes;
+}
+
 }  // namespace webrtc
@@ -0,0 +1,33 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
+#include <set>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+TEST(CpuInfoTest, NumaNodesListEachCpuOnce) {
+  const std::vector<std::vector<int>> nodes = CpuInfo::DetectNumaNodeCpus();
+  ASSERT_FALSE(nodes.empty());
+
+  std::set<int> seen;
+  for (const auto& node : nodes) {
+    for (int cpu : node) {
+      EXPECT_LE(0, cpu);
+      EXPECT_TRUE(seen.insert(cpu).second) << "CPU " << cpu;
+    }
+  }
+  EXPECT_FALSE(seen.empty());
+}
+
+}  // namespace webrtc
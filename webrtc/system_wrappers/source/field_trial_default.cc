@@ -11,22 +11,26 @@
 #include "webrtc/system_wrappers/include/field_trial_default.h"
 
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 // Simple field trial implementation, which allows client to
 // specify desired flags in InitFieldTrialsFromString.
 namespace webrtc {
 namespace field_trial {
 
-static const char *trials_init_string = NULL;
+namespace {
 
-std::string FindFullName(const std::string& name) {
-  if (trials_init_string == NULL)
-    return std::string();
+typedef std::unordered_map<std::string, std::string> FieldTrialMap;
 
-  std::string trials_string(trials_init_string);
-  if (trials_string.empty())
-    return std::string();
+static const char *trials_init_string = NULL;
+// The trials of |trials_init_string|, parsed once so that lookups don't have
+// to. Only replaced by InitFieldTrialsFromString(), which must not race with
+// lookups.
+static const FieldTrialMap* trials = NULL;
 
+FieldTrialMap* ParseFieldTrials(const std::string& trials_string) {
+  FieldTrialMap* field_trials = new FieldTrialMap();
   static const char kPersistentStringSeparator = '/';
   size_t next_item = 0;
   while (next_item < trials_string.length()) {
@@ -47,15 +51,29 @@ std::string FindFullName(const std::string& name) {
         field_value_end - field_name_end - 1);
     next_item = field_value_end + 1;
 
-    if (name == field_name)
-      return field_value;
+    // If a trial is listed more than once, the first group is used.
+    field_trials->insert(std::make_pair(field_name, field_value));
   }
-  return std::string();
+  return field_trials;
+}
+
+}  // namespace
+
+std::string FindFullName(const std::string& name) {
+  if (trials == NULL)
+    return std::string();
+
+  FieldTrialMap::const_iterator it = trials->find(name);
+  if (it == trials->end())
+    return std::string();
+  return it->second;
 }
 
 // Optionally initialize field trial from a string.
 void InitFieldTrialsFromString(const char* trials_string) {
   trials_init_string = trials_string;
+  delete trials;
+  trials = trials_string ? ParseFieldTrials(trials_string) : NULL;
 }
 
 const char* GetFieldTrialString() {
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/field_trial_default.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace field_trial {
+
+class FieldTrialDefaultTest : public ::testing::Test {
+ public:
+  FieldTrialDefaultTest() : previous_trials_(GetFieldTrialString()) {}
+  ~FieldTrialDefaultTest() override {
+    InitFieldTrialsFromString(previous_trials_);
+  }
+
+ private:
+  const char* const previous_trials_;
+};
+
+TEST_F(FieldTrialDefaultTest, FindsGroups) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled/WebRTC-B/Enabled-50,100/");
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+  EXPECT_EQ("Enabled-50,100", FindFullName("WebRTC-B"));
+  EXPECT_EQ("", FindFullName("WebRTC-C"));
+  EXPECT_TRUE(IsEnabled("WebRTC-B"));
+  EXPECT_FALSE(IsEnabled("WebRTC-C"));
+}
+
+TEST_F(FieldTrialDefaultTest, UsesFirstGroupOfRepeatedTrial) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled/WebRTC-A/Disabled/");
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+}
+
+TEST_F(FieldTrialDefaultTest, StopsAtMalformedTrial) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled/WebRTC-B//WebRTC-C/Enabled/");
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+  EXPECT_EQ("", FindFullName("WebRTC-B"));
+  EXPECT_EQ("", FindFullName("WebRTC-C"));
+}
+
+TEST_F(FieldTrialDefaultTest, ReplacesTrialsOnInit) {
+  const char kTrials[] = "WebRTC-A/Enabled/";
+  InitFieldTrialsFromString(kTrials);
+  EXPECT_EQ(kTrials, GetFieldTrialString());
+  EXPECT_TRUE(IsEnabled("WebRTC-A"));
+
+  InitFieldTrialsFromString("WebRTC-B/Enabled/");
+  EXPECT_FALSE(IsEnabled("WebRTC-A"));
+  EXPECT_TRUE(IsEnabled("WebRTC-B"));
+
+  InitFieldTrialsFromString(nullptr);
+  EXPECT_EQ(nullptr, GetFieldTrialString());
+  EXPECT_FALSE(IsEnabled("WebRTC-B"));
+}
+
+}  // namespace field_trial
+}  // namespace webrtc
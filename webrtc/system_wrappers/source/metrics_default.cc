@@ -11,6 +11,7 @@
 
 #include <algorithm>
 
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/system_wrappers/include/metrics.h"
@@ -28,17 +29,43 @@ namespace {
 // linearly/exponentially spaced buckets) if samples are logged more frequently.
 const int kMaxSampleMapSize = 300;
 
+// Atomically sets |*value| to 0 and returns what it was.
+int ExchangeWithZero(volatile int* value) {
+  int old_value = rtc::AtomicOps::AcquireLoad(value);
+  while (true) {
+    int previous = rtc::AtomicOps::CompareAndSwap(value, old_value, 0);
+    if (previous == old_value)
+      return old_value;
+    old_value = previous;
+  }
+}
+
 class RtcHistogram {
  public:
   RtcHistogram(const std::string& name, int min, int max, int bucket_count)
       : min_(min), max_(max), info_(name, min, max, bucket_count) {
     RTC_DCHECK_GT(bucket_count, 0);
+    RTC_DCHECK_LE(min, max);
+    // If every value a sample can take, including the underflow bucket, fits
+    // within the sample limit, count each one in its own atomic counter. This
+    // covers enumerations and booleans, which are the histograms most often
+    // added to from hot paths, and keeps Add() free of locking for them.
+    int64_t num_values = static_cast<int64_t>(max_) - min_ + 2;
+    if (num_values <= kMaxSampleMapSize) {
+      num_counters_ = static_cast<int>(num_values);
+      counters_.reset(new volatile int[num_counters_]());
+    }
   }
 
   void Add(int sample) {
     sample = std::min(sample, max_);
     sample = std::max(sample, min_ - 1);  // Underflow bucket.
 
+    if (counters_) {
+      rtc::AtomicOps::Increment(&counters_[sample - (min_ - 1)]);
+      return;
+    }
+
     rtc::CritScope cs(&crit_);
     if (info_.samples.size() == kMaxSampleMapSize &&
         info_.samples.find(sample) == info_.samples.end()) {
@@ -50,15 +77,20 @@ class RtcHistogram {
   // Returns a copy (or nullptr if there are no samples) and clears samples.
   std::unique_ptr<SampleInfo> GetAndReset() {
     rtc::CritScope cs(&crit_);
-    if (info_.samples.empty())
+    std::unique_ptr<SampleInfo> copy(
+        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count));
+    if (counters_) {
+      for (int i = 0; i < num_counters_; ++i) {
+        int count = ExchangeWithZero(&counters_[i]);
+        if (count > 0)
+          copy->samples[i + min_ - 1] = count;
+      }
+    } else {
+      std::swap(info_.samples, copy->samples);
+    }
+    if (copy->samples.empty())
       return nullptr;
-
-    SampleInfo* copy =
-        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
-
-    std::swap(info_.samples, copy->samples);
-
-    return std::unique_ptr<SampleInfo>(copy);
+    return copy;
   }
 
   const std::string& name() const { return info_.name; }
@@ -66,10 +98,17 @@ class RtcHistogram {
   // Functions only for testing.
   void Reset() {
     rtc::CritScope cs(&crit_);
+    for (int i = 0; i < num_counters_; ++i)
+      ExchangeWithZero(&counters_[i]);
     info_.samples.clear();
   }
 
   int NumEvents(int sample) const {
+    if (counters_) {
+      if (sample < min_ - 1 || sample > max_)
+        return 0;
+      return rtc::AtomicOps::AcquireLoad(&counters_[sample - (min_ - 1)]);
+    }
     rtc::CritScope cs(&crit_);
     const auto it = info_.samples.find(sample);
     return (it == info_.samples.end()) ? 0 : it->second;
@@ -77,6 +116,8 @@ class RtcHistogram {
 
   int NumSamples() const {
     int num_samples = 0;
+    for (int i = 0; i < num_counters_; ++i)
+      num_samples += rtc::AtomicOps::AcquireLoad(&counters_[i]);
     rtc::CritScope cs(&crit_);
     for (const auto& sample : info_.samples) {
       num_samples += sample.second;
@@ -85,6 +126,10 @@ class RtcHistogram {
   }
 
   int MinSample() const {
+    for (int i = 0; i < num_counters_; ++i) {
+      if (rtc::AtomicOps::AcquireLoad(&counters_[i]) > 0)
+        return i + min_ - 1;
+    }
     rtc::CritScope cs(&crit_);
     return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
   }
@@ -93,6 +138,10 @@ class RtcHistogram {
   rtc::CriticalSection crit_;
   const int min_;
   const int max_;
+  // One counter per value from |min_| - 1 to |max_|, or null if there are too
+  // many values, in which case samples are counted in |info_|.
+  int num_counters_ = 0;
+  std::unique_ptr<volatile int[]> counters_;
   SampleInfo info_ GUARDED_BY(crit_);
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
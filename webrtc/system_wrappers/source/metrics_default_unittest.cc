@@ -8,6 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <memory>
+#include <vector>
+
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/system_wrappers/include/metrics.h"
 #include "webrtc/system_wrappers/include/metrics_default.h"
 #include "webrtc/test/gtest.h"
@@ -47,6 +51,13 @@ int NumEvents(const std::string& name,
 
   return it_sample->second;
 }
+
+const int kNumAddsPerThread = 10000;
+
+void AddEnumerationSamples(void* /* obj */) {
+  for (int i = 0; i < kNumAddsPerThread; ++i)
+    RTC_HISTOGRAM_ENUMERATION("Concurrent", i % 3, 3);
+}
 }  // namespace
 
 class MetricsDefaultTest : public ::testing::Test {
@@ -113,6 +124,24 @@ TEST_F(MetricsDefaultTest, Underflow) {
   EXPECT_EQ(2, metrics::NumEvents(kName, 0));
 }
 
+TEST_F(MetricsDefaultTest, CountsSamplesAddedConcurrently) {
+  const int kNumThreads = 4;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(new rtc::PlatformThread(&AddEnumerationSamples,
+                                                 nullptr, "MetricsThread"));
+    threads.back()->Start();
+  }
+  for (const auto& thread : threads)
+    thread->Stop();
+
+  EXPECT_EQ(kNumThreads * kNumAddsPerThread,
+            metrics::NumSamples("Concurrent"));
+  EXPECT_EQ(0, metrics::MinSample("Concurrent"));
+  EXPECT_EQ(kNumThreads * (kNumAddsPerThread / 3),
+            metrics::NumEvents("Concurrent", 2));
+}
+
 TEST_F(MetricsDefaultTest, GetAndReset) {
   std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
   metrics::GetAndReset(&histograms);
@@ -16,21 +16,7 @@
 namespace webrtc {
 namespace {
 // Number of RTCP SR reports to use to map between RTP and NTP.
-const size_t kNumRtcpReportsToUse = 2;
-
-// Calculates the RTP timestamp frequency from two pairs of NTP/RTP timestamps.
-bool CalculateFrequency(int64_t ntp_ms1,
-                        uint32_t rtp_timestamp1,
-                        int64_t ntp_ms2,
-                        uint32_t rtp_timestamp2,
-                        double* frequency_khz) {
-  if (ntp_ms1 <= ntp_ms2)
-    return false;
-
-  *frequency_khz = static_cast<double>(rtp_timestamp1 - rtp_timestamp2) /
-                   static_cast<double>(ntp_ms1 - ntp_ms2);
-  return true;
-}
+const size_t kNumRtcpReportsToUse = 20;
 
 // Detects if there has been a wraparound between |old_timestamp| and
 // |new_timestamp|, and compensates by adding 2^32 if that is the case.
@@ -69,26 +55,64 @@ bool RtpToNtpEstimator::RtcpMeasurement::IsEqual(
 }
 
 // Class for converting an RTP timestamp to the NTP domain.
-RtpToNtpEstimator::RtpToNtpEstimator() : consecutive_invalid_samples_(0) {}
+RtpToNtpEstimator::RtpToNtpEstimator()
+    : consecutive_invalid_samples_(0), removed_since_rebase_(0) {}
 RtpToNtpEstimator::~RtpToNtpEstimator() {}
 
-void RtpToNtpEstimator::UpdateParameters() {
-  if (measurements_.size() != kNumRtcpReportsToUse)
-    return;
+void RtpToNtpEstimator::AddToSums(const RtcpMeasurement& measurement) {
+  const double x = measurement.ntp_ms_delta;
+  const double y = measurement.rtp_timestamp_delta;
+  sums_.x += x;
+  sums_.y += y;
+  sums_.xx += x * x;
+  sums_.xy += x * y;
+}
 
-  int64_t timestamp_new = measurements_.front().rtp_timestamp;
-  int64_t timestamp_old = measurements_.back().rtp_timestamp;
-  if (!CompensateForWrapAround(timestamp_new, timestamp_old, &timestamp_new))
+void RtpToNtpEstimator::RemoveFromSums(const RtcpMeasurement& measurement) {
+  const double x = measurement.ntp_ms_delta;
+  const double y = measurement.rtp_timestamp_delta;
+  sums_.x -= x;
+  sums_.y -= y;
+  sums_.xx -= x * x;
+  sums_.xy -= x * y;
+}
+
+void RtpToNtpEstimator::RebaseSums() {
+  sums_ = Sums();
+  removed_since_rebase_ = 0;
+  if (measurements_.empty())
     return;
+  const int64_t ntp_ms_delta = measurements_.back().ntp_ms_delta;
+  const int64_t rtp_timestamp_delta = measurements_.back().rtp_timestamp_delta;
+  for (auto& measurement : measurements_) {
+    measurement.ntp_ms_delta -= ntp_ms_delta;
+    measurement.rtp_timestamp_delta -= rtp_timestamp_delta;
+    AddToSums(measurement);
+  }
+}
 
-  int64_t ntp_ms_new = measurements_.front().ntp_time.ToMs();
-  int64_t ntp_ms_old = measurements_.back().ntp_time.ToMs();
+void RtpToNtpEstimator::UpdateParameters() {
+  if (measurements_.size() < 2)
+    return;
 
-  if (!CalculateFrequency(ntp_ms_new, timestamp_new, ntp_ms_old, timestamp_old,
-                          &params_.frequency_khz)) {
+  const double n = static_cast<double>(measurements_.size());
+  const double denominator = n * sums_.xx - sums_.x * sums_.x;
+  if (denominator <= 0)
     return;
-  }
-  params_.offset_ms = timestamp_new - params_.frequency_khz * ntp_ms_new;
+  const double frequency_khz =
+      (n * sums_.xy - sums_.x * sums_.y) / denominator;
+  if (frequency_khz <= 0)
+    return;
+  // The fit is rtp_timestamp_delta = frequency_khz * ntp_ms_delta + offset,
+  // which Estimate() needs for RTP timestamps unwrapped against the oldest
+  // report, and NTP times in ms.
+  const double offset = (sums_.y - frequency_khz * sums_.x) / n;
+  const RtcpMeasurement& oldest = measurements_.back();
+  const int64_t reference_ntp_ms =
+      oldest.ntp_time.ToMs() - oldest.ntp_ms_delta;
+  params_.frequency_khz = frequency_khz;
+  params_.offset_ms = oldest.rtp_timestamp - oldest.rtp_timestamp_delta +
+                      offset - frequency_khz * reference_ntp_ms;
   params_.calculated = true;
 }
 
@@ -106,25 +130,28 @@ bool RtpToNtpEstimator::UpdateMeasurements(uint32_t ntp_secs,
   if (!new_measurement.ntp_time.Valid())
     return false;
 
+  // The reports are in order, so a new report only needs to be newer than the
+  // newest one.
   int64_t ntp_ms_new = new_measurement.ntp_time.ToMs();
   bool invalid_sample = false;
-  for (const auto& measurement : measurements_) {
-    if (ntp_ms_new <= measurement.ntp_time.ToMs()) {
+  if (!measurements_.empty()) {
+    const RtcpMeasurement& newest = measurements_.front();
+    int64_t timestamp_new = new_measurement.rtp_timestamp;
+    if (ntp_ms_new <= newest.ntp_time.ToMs()) {
       // Old report.
       invalid_sample = true;
-      break;
-    }
-    int64_t timestamp_new = new_measurement.rtp_timestamp;
-    if (!CompensateForWrapAround(timestamp_new, measurement.rtp_timestamp,
-                                 &timestamp_new)) {
+    } else if (!CompensateForWrapAround(timestamp_new, newest.rtp_timestamp,
+                                        &timestamp_new)) {
       invalid_sample = true;
-      break;
-    }
-    if (timestamp_new <= measurement.rtp_timestamp) {
+    } else if (timestamp_new <= newest.rtp_timestamp) {
       LOG(LS_WARNING)
           << "Newer RTCP SR report with older RTP timestamp, dropping";
       invalid_sample = true;
-      break;
+    } else {
+      new_measurement.ntp_ms_delta =
+          newest.ntp_ms_delta + ntp_ms_new - newest.ntp_time.ToMs();
+      new_measurement.rtp_timestamp_delta =
+          newest.rtp_timestamp_delta + timestamp_new - newest.rtp_timestamp;
     }
   }
   if (invalid_sample) {
@@ -135,14 +162,24 @@ bool RtpToNtpEstimator::UpdateMeasurements(uint32_t ntp_secs,
     LOG(LS_WARNING) << "Multiple consecutively invalid RTCP SR reports, "
                        "clearing measurements.";
     measurements_.clear();
+    RebaseSums();
+    // The new report is the reference of the sums.
+    new_measurement.ntp_ms_delta = 0;
+    new_measurement.rtp_timestamp_delta = 0;
   }
   consecutive_invalid_samples_ = 0;
 
   // Insert new RTCP SR report.
-  if (measurements_.size() == kNumRtcpReportsToUse)
+  if (measurements_.size() == kNumRtcpReportsToUse) {
+    RemoveFromSums(measurements_.back());
     measurements_.pop_back();
+    ++removed_since_rebase_;
+  }
 
   measurements_.push_front(new_measurement);
+  AddToSums(new_measurement);
+  if (removed_since_rebase_ == kNumRtcpReportsToUse)
+    RebaseSums();
   *new_rtcp_sr = true;
 
   // List updated, calculate new parameters.
@@ -291,4 +291,33 @@ TEST(RtpToNtpTests, FailsForNoParameters) {
   EXPECT_FALSE(estimator.Estimate(timestamp, &timestamp_ms));
 }
 
+TEST(RtpToNtpTests, FitsOverReportsWithJitterAndWrapAround) {
+  RtpToNtpEstimator estimator;
+  const uint32_t kNtpSec = 1000;
+  const int64_t kReportIntervalMs = 1000;
+  // Wraps around after 50 reports.
+  const uint32_t kFirstTimestamp =
+      0xFFFFFFFF - 50 * kReportIntervalMs * kTimestampTicksPerMs;
+  for (int i = 0; i < 100; ++i) {
+    // The send time of the reports is off by 2 ms, alternately early and late.
+    const int64_t ntp_ms = i * kReportIntervalMs + (i % 2 == 0 ? 2 : -2);
+    const NtpTime ntp(
+        static_cast<uint64_t>(kNtpSec) * NtpTime::kFractionsPerSecond +
+        ntp_ms * NtpTime::kFractionsPerSecond / 1000);
+    const uint32_t timestamp =
+        kFirstTimestamp + i * kReportIntervalMs * kTimestampTicksPerMs;
+    bool new_sr;
+    EXPECT_TRUE(estimator.UpdateMeasurements(ntp.seconds(), ntp.fractions(),
+                                             timestamp, &new_sr));
+    EXPECT_TRUE(new_sr);
+  }
+  // Two reports alone would be off by 0.4%.
+  EXPECT_NEAR(90.0, estimator.params().frequency_khz, 0.01);
+  int64_t timestamp_ms = -1;
+  EXPECT_TRUE(estimator.Estimate(
+      kFirstTimestamp + 99 * kReportIntervalMs * kTimestampTicksPerMs,
+      &timestamp_ms));
+  EXPECT_NEAR(kNtpSec * 1000 + 99 * kReportIntervalMs, timestamp_ms, 1);
+}
+
 };  // namespace webrtc
@@ -26,6 +26,10 @@ namespace webrtc {
 
 namespace {
 constexpr int64_t kDefaultProcessIntervalMs = 5;
+// Enough for any packet that fits in an Ethernet frame; larger packets get
+// storage of their own.
+constexpr size_t kPacketPoolBufferCapacity = 1500;
+constexpr size_t kPacketPoolMaxFreeBuffers = 256;
 }
 
 DemuxerImpl::DemuxerImpl(const std::map<uint8_t, MediaType>& payload_type_map)
@@ -70,6 +74,7 @@ FakeNetworkPipe::FakeNetworkPipe(Clock* clock,
       demuxer_(std::move(demuxer)),
       random_(seed),
       config_(),
+      packet_pool_(kPacketPoolBufferCapacity, kPacketPoolMaxFreeBuffers),
       dropped_packets_(0),
       sent_packets_(0),
       total_packet_delay_(0),
@@ -143,9 +148,11 @@ void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
     network_start_time = capacity_link_.back()->arrival_time();
 
   int64_t arrival_time = network_start_time + capacity_delay_ms;
-  NetworkPacket* packet = new NetworkPacket(data, data_length, time_now,
-                                            arrival_time);
+  NetworkPacket* packet =
+      new NetworkPacket(packet_pool_.CreateBuffer(data, data_length), time_now,
+                        arrival_time);
   capacity_link_.push(packet);
+  next_process_time_ = std::min(next_process_time_, arrival_time);
 }
 
 float FakeNetworkPipe::PercentageLoss() {
@@ -225,6 +232,19 @@ void FakeNetworkPipe::Process() {
       total_packet_delay_ += packet->arrival_time() - packet->send_time();
     }
     sent_packets_ += packets_to_deliver.size();
+
+    // Wake up for whichever packet is due first, be it the next one to leave
+    // the capacity link or the next one to arrive.
+    if (!capacity_link_.empty() && !delay_link_.empty()) {
+      next_process_time_ = std::min(capacity_link_.front()->arrival_time(),
+                                    (*delay_link_.begin())->arrival_time());
+    } else if (!capacity_link_.empty()) {
+      next_process_time_ = capacity_link_.front()->arrival_time();
+    } else if (!delay_link_.empty()) {
+      next_process_time_ = (*delay_link_.begin())->arrival_time();
+    } else {
+      next_process_time_ = time_now + kDefaultProcessIntervalMs;
+    }
   }
   while (!packets_to_deliver.empty()) {
     NetworkPacket* packet = packets_to_deliver.front();
@@ -232,10 +252,6 @@ void FakeNetworkPipe::Process() {
     demuxer_->DeliverPacket(packet, PacketTime());
     delete packet;
   }
-
-  next_process_time_ = !delay_link_.empty()
-                           ? (*delay_link_.begin())->arrival_time()
-                           : time_now + kDefaultProcessIntervalMs;
 }
 
 int64_t FakeNetworkPipe::TimeUntilNextProcess() const {
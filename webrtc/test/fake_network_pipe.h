@@ -11,14 +11,16 @@
 #ifndef WEBRTC_TEST_FAKE_NETWORK_PIPE_H_
 #define WEBRTC_TEST_FAKE_NETWORK_PIPE_H_
 
-#include <string.h>
 #include <map>
 #include <memory>
 #include <queue>
 #include <set>
+#include <utility>
 
 #include "webrtc/common_types.h"
 #include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/copyonwritebuffer.h"
+#include "webrtc/rtc_base/copyonwritebufferpool.h"
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/random.h"
 #include "webrtc/typedefs.h"
@@ -35,15 +37,18 @@ class NetworkPacket {
                 size_t length,
                 int64_t send_time,
                 int64_t arrival_time)
-      : data_(new uint8_t[length]),
-        data_length_(length),
+      : NetworkPacket(rtc::CopyOnWriteBuffer(data, length),
+                      send_time,
+                      arrival_time) {}
+  NetworkPacket(rtc::CopyOnWriteBuffer data,
+                int64_t send_time,
+                int64_t arrival_time)
+      : data_(std::move(data)),
         send_time_(send_time),
-        arrival_time_(arrival_time) {
-    memcpy(data_.get(), data, length);
-  }
+        arrival_time_(arrival_time) {}
 
-  uint8_t* data() const { return data_.get(); }
-  size_t data_length() const { return data_length_; }
+  const uint8_t* data() const { return data_.cdata(); }
+  size_t data_length() const { return data_.size(); }
   int64_t send_time() const { return send_time_; }
   int64_t arrival_time() const { return arrival_time_; }
   void IncrementArrivalTime(int64_t extra_delay) {
@@ -52,9 +57,7 @@ class NetworkPacket {
 
  private:
   // The packet data.
-  std::unique_ptr<uint8_t[]> data_;
-  // Length of data_.
-  size_t data_length_;
+  rtc::CopyOnWriteBuffer data_;
   // The time the packet was sent out on the network.
   const int64_t send_time_;
   // The time the packet should arrive at the receiver.
@@ -157,6 +160,10 @@ class FakeNetworkPipe {
   // Link configuration.
   Config config_;
 
+  // Storage for the packets on the link, so that a steady flow of packets
+  // doesn't allocate a buffer for each one.
+  rtc::CopyOnWriteBufferPool packet_pool_;
+
   // Statistics.
   size_t dropped_packets_;
   size_t sent_packets_;
@@ -172,7 +179,7 @@ class FakeNetworkPipe {
   // The probability to drop a burst of packets.
   double prob_start_bursting_;
 
-  int64_t next_process_time_;
+  int64_t next_process_time_ GUARDED_BY(lock_);
 
   int64_t last_log_time_;
 
@@ -318,6 +318,49 @@ TEST_F(FakeNetworkPipeTest, ChangingCapacityWithPacketsInPipeTest) {
   pipe->Process();
 }
 
+// Verify that the pipe asks to be processed when the next packet is due, on
+// either link, rather than at a fixed interval.
+TEST_F(FakeNetworkPipeTest, TimeUntilNextProcessFollowsPackets) {
+  FakeNetworkPipe::Config config;
+  config.queue_length_packets = 20;
+  config.queue_delay_ms = 50;
+  config.link_capacity_kbps = 80;
+  TestDemuxer* demuxer = new TestDemuxer();
+  std::unique_ptr<FakeNetworkPipe> pipe(new FakeNetworkPipe(
+      &fake_clock_, config, std::unique_ptr<Demuxer>(demuxer)));
+
+  const int kPacketSize = 1000;
+  const int kPacketTimeMs = PacketTimeMs(config.link_capacity_kbps,
+                                         kPacketSize);
+  SendPackets(pipe.get(), 1, kPacketSize);
+  EXPECT_CALL(*demuxer, DeliverPacket(_, _)).Times(0);
+  pipe->Process();
+  EXPECT_EQ(kPacketTimeMs, pipe->TimeUntilNextProcess());
+
+  // The packet leaves the capacity link, and is due after the extra delay.
+  fake_clock_.AdvanceTimeMilliseconds(kPacketTimeMs);
+  EXPECT_CALL(*demuxer, DeliverPacket(_, _)).Times(0);
+  pipe->Process();
+  EXPECT_EQ(config.queue_delay_ms, pipe->TimeUntilNextProcess());
+
+  // A packet sent meanwhile is due on the capacity link first.
+  SendPackets(pipe.get(), 1, kPacketSize);
+  EXPECT_EQ(config.queue_delay_ms, pipe->TimeUntilNextProcess());
+  fake_clock_.AdvanceTimeMilliseconds(config.queue_delay_ms);
+  EXPECT_CALL(*demuxer, DeliverPacket(_, _)).Times(1);
+  pipe->Process();
+  EXPECT_EQ(kPacketTimeMs - config.queue_delay_ms,
+            pipe->TimeUntilNextProcess());
+
+  fake_clock_.AdvanceTimeMilliseconds(pipe->TimeUntilNextProcess());
+  EXPECT_CALL(*demuxer, DeliverPacket(_, _)).Times(0);
+  pipe->Process();
+  fake_clock_.AdvanceTimeMilliseconds(pipe->TimeUntilNextProcess());
+  EXPECT_CALL(*demuxer, DeliverPacket(_, _)).Times(1);
+  pipe->Process();
+  EXPECT_EQ(2u, pipe->sent_packets());
+}
+
 // At first disallow reordering and then allow reordering.
 TEST_F(FakeNetworkPipeTest, DisallowReorderingThenAllowReordering) {
   FakeNetworkPipe::Config config;
@@ -14,6 +14,7 @@
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/refcountedobject.h"
 
 namespace webrtc {
 namespace test {
@@ -32,6 +33,17 @@ class FakeNativeBuffer : public VideoFrameBuffer {
   int width() const override { return width_; }
   int height() const override { return height_; }
 
+  // Keeps the buffer native, as a GPU-backed buffer would.
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(int offset_x,
+                                                    int offset_y,
+                                                    int crop_width,
+                                                    int crop_height,
+                                                    int scaled_width,
+                                                    int scaled_height) override {
+    return new rtc::RefCountedObject<FakeNativeBuffer>(scaled_width,
+                                                       scaled_height);
+  }
+
  private:
   rtc::scoped_refptr<I420BufferInterface> ToI420() override {
     rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width_, height_);
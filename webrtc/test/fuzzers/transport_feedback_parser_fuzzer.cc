@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+// Checks that TransportFeedback::ParseReceivedPackets() accepts exactly the
+// packets TransportFeedback::Parse() accepts, and reports the same packets.
+void FuzzOneInput(const uint8_t* data, size_t size) {
+  rtcp::CommonHeader rtcp_block;
+  for (const uint8_t* next = data; next < data + size;
+       next = rtcp_block.NextPacket()) {
+    if (!rtcp_block.Parse(next, data + size - next))
+      return;
+    if (rtcp_block.type() != rtcp::TransportFeedback::kPacketType ||
+        rtcp_block.fmt() != rtcp::TransportFeedback::kFeedbackMessageType) {
+      continue;
+    }
+
+    rtcp::TransportFeedback feedback;
+    bool parsed = feedback.Parse(rtcp_block);
+
+    std::vector<rtcp::TransportFeedback::ReceivedPacket> packets;
+    rtcp::TransportFeedback::Header header;
+    bool streamed = rtcp::TransportFeedback::ParseReceivedPackets(
+        rtcp_block, &header, [&](uint16_t sequence_number, int16_t delta) {
+          packets.emplace_back(sequence_number, delta);
+        });
+
+    RTC_CHECK_EQ(parsed, streamed);
+    if (!parsed)
+      continue;
+    RTC_CHECK_EQ(feedback.GetBaseSequence(), header.base_sequence);
+    RTC_CHECK_EQ(feedback.GetBaseTimeUs(), header.base_time_us);
+    RTC_CHECK_EQ(feedback.GetPacketStatusCount(), header.packet_status_count);
+    const auto& expected = feedback.GetReceivedPackets();
+    RTC_CHECK_EQ(expected.size(), packets.size());
+    for (size_t i = 0; i < packets.size(); ++i) {
+      RTC_CHECK_EQ(expected[i].sequence_number(), packets[i].sequence_number());
+      RTC_CHECK_EQ(expected[i].delta_ticks(), packets[i].delta_ticks());
+    }
+  }
+}
+
+}  // namespace webrtc
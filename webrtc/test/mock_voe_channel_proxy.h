@@ -81,6 +81,7 @@ class MockVoEChannelProxy : public voe::ChannelProxy {
   MOCK_METHOD1(AssociateSendChannel,
                void(const ChannelProxy& send_channel_proxy));
   MOCK_METHOD0(DisassociateSendChannel, void());
+  MOCK_METHOD1(SetEncodeFanoutSource, bool(const ChannelProxy* source));
   MOCK_CONST_METHOD2(GetRtpRtcp, void(RtpRtcp** rtp_rtcp,
                                       RtpReceiver** rtp_receiver));
   MOCK_CONST_METHOD0(GetPlayoutTimestamp, uint32_t());
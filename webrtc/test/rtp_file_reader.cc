@@ -11,6 +11,10 @@
 #include "webrtc/test/rtp_file_reader.h"
 
 #include <stdio.h>
+#include <string.h>
+#if defined(WEBRTC_POSIX)
+#include <sys/mman.h>
+#endif
 
 #include <map>
 #include <string>
@@ -64,6 +68,25 @@ class RtpFileReaderImpl : public RtpFileReader {
  public:
   virtual bool Init(const std::string& filename,
                     const std::set<uint32_t>& ssrc_filter) = 0;
+  // Only the pcap reader makes use of an index.
+  virtual bool InitWithIndex(const std::string& filename,
+                             const std::set<uint32_t>& ssrc_filter,
+                             const std::string& index_filename) {
+    return Init(filename, ssrc_filter);
+  }
+
+  bool NextPacketView(RtpPacketView* packet) override {
+    if (!NextPacket(&buffer_))
+      return false;
+    packet->data = buffer_.data;
+    packet->length = buffer_.length;
+    packet->original_length = buffer_.original_length;
+    packet->time_ms = buffer_.time_ms;
+    return true;
+  }
+
+ private:
+  RtpPacket buffer_;
 };
 
 class InterleavedRtpFileReader : public RtpFileReaderImpl {
@@ -225,6 +248,10 @@ enum {
 const uint32_t kPcapBOMSwapOrder = 0xd4c3b2a1UL;
 const uint32_t kPcapBOMNoSwapOrder = 0xa1b2c3d4UL;
 
+// Identifies a packet index written by PcapReader, and the layout of its
+// entries.
+const char kPcapIndexMagic[8] = {'R', 'T', 'P', 'I', 'D', 'X', '0', '1'};
+
 #define TRY_PCAP(expr)                                 \
   do {                                                 \
     int r = (expr);                                    \
@@ -238,10 +265,17 @@ const uint32_t kPcapBOMNoSwapOrder = 0xa1b2c3d4UL;
 
 // Read RTP packets from file in tcpdump/libpcap format, as documented at:
 // http://wiki.wireshark.org/Development/LibpcapFileFormat
+// Where supported, the file is memory mapped, and NextPacketView() points into
+// the mapping.
 class PcapReader : public RtpFileReaderImpl {
  public:
   PcapReader()
     : file_(NULL),
+      mapping_(nullptr),
+      mapping_size_(0),
+      read_pos_(0),
+      read_past_end_(false),
+      total_packet_count_(0),
       swap_pcap_byte_order_(false),
 #ifdef WEBRTC_ARCH_BIG_ENDIAN
       swap_network_byte_order_(false),
@@ -255,6 +289,12 @@ class PcapReader : public RtpFileReaderImpl {
   }
 
   virtual ~PcapReader() {
+#if defined(WEBRTC_POSIX)
+    if (mapping_) {
+      munmap(const_cast<uint8_t*>(mapping_), mapping_size_);
+      mapping_ = nullptr;
+    }
+#endif
     if (file_ != NULL) {
       fclose(file_);
       file_ = NULL;
@@ -263,51 +303,72 @@ class PcapReader : public RtpFileReaderImpl {
 
   bool Init(const std::string& filename,
             const std::set<uint32_t>& ssrc_filter) override {
-    return Initialize(filename, ssrc_filter) == kResultSuccess;
+    return Initialize(filename, ssrc_filter, "") == kResultSuccess;
+  }
+
+  bool InitWithIndex(const std::string& filename,
+                     const std::set<uint32_t>& ssrc_filter,
+                     const std::string& index_filename) override {
+    return Initialize(filename, ssrc_filter, index_filename) == kResultSuccess;
   }
 
   int Initialize(const std::string& filename,
-                 const std::set<uint32_t>& ssrc_filter) {
+                 const std::set<uint32_t>& ssrc_filter,
+                 const std::string& index_filename) {
     file_ = fopen(filename.c_str(), "rb");
     if (file_ == NULL) {
       printf("ERROR: Can't open file: %s\n", filename.c_str());
       return kResultFail;
     }
+    const int64_t file_size = FileSize();
+    MapFile(file_size);
 
     if (ReadGlobalHeader() < 0) {
       return kResultFail;
     }
 
-    int total_packet_count = 0;
-    uint32_t stream_start_ms = 0;
-    int32_t next_packet_pos = ftell(file_);
-    for (;;) {
-      TRY_PCAP(fseek(file_, next_packet_pos, SEEK_SET));
-      int result = ReadPacket(&next_packet_pos, stream_start_ms,
-                              ++total_packet_count, ssrc_filter);
-      if (result == kResultFail) {
-        break;
-      } else if (result == kResultSuccess && packets_.size() == 1) {
-        assert(stream_start_ms == 0);
-        PacketIterator it = packets_.begin();
-        stream_start_ms = it->time_offset_ms;
-        it->time_offset_ms = 0;
+    // All packets are indexed, also those the filter drops, so that an index
+    // written to |index_filename| serves any filter.
+    std::vector<RtpPacketMarker> markers;
+    if (index_filename.empty() ||
+        !ReadIndex(index_filename, file_size, &markers)) {
+      if (ScanPackets(&markers) != kResultSuccess)
+        return kResultFail;
+      if (!index_filename.empty() &&
+          !WriteIndex(index_filename, file_size, markers)) {
+        printf("Failed writing index file %s\n", index_filename.c_str());
       }
     }
 
-    if (feof(file_) == 0) {
-      printf("Failed reading file!\n");
-      return kResultFail;
+    for (const RtpPacketMarker& marker : markers) {
+      if (!marker.rtcp) {
+        if (!ssrc_filter.empty() &&
+            ssrc_filter.find(marker.ssrc) == ssrc_filter.end()) {
+          continue;
+        }
+        packets_by_ssrc_[marker.ssrc].push_back(
+            static_cast<uint32_t>(packets_.size()));
+      }
+      packets_.push_back(marker);
+    }
+    // Timestamps are relative to the first packet that passes the filter.
+    if (!packets_.empty()) {
+      const uint64_t stream_start_ms = packets_.front().time_ms;
+      for (RtpPacketMarker& marker : packets_) {
+        marker.time_ms = marker.time_ms > stream_start_ms
+                             ? marker.time_ms - stream_start_ms
+                             : 0;
+      }
     }
 
-    printf("Total packets in file: %d\n", total_packet_count);
+    printf("Total packets in file: %u\n", total_packet_count_);
     printf("Total RTP/RTCP packets: %" PRIuS "\n", packets_.size());
 
     for (SsrcMapIterator mit = packets_by_ssrc_.begin();
         mit != packets_by_ssrc_.end(); ++mit) {
       uint32_t ssrc = mit->first;
       const std::vector<uint32_t>& packet_indices = mit->second;
-      uint8_t pt = packets_[packet_indices[0]].rtp_header.payloadType;
+      uint8_t pt = packets_[packet_indices[0]].payload_type;
       printf("SSRC: %08x, %" PRIuS " packets, pt=%d\n", ssrc,
              packet_indices.size(), pt);
     }
@@ -333,52 +394,155 @@ class PcapReader : public RtpFileReaderImpl {
   }
 
   bool NextPacket(RtpPacket* packet) override {
-    uint32_t length = RtpPacket::kMaxPacketBufferSize;
-    if (NextPcap(packet->data, &length, &packet->time_ms) != kResultSuccess)
+    RtpPacketView view;
+    if (!NextPacketView(&view) || view.length > RtpPacket::kMaxPacketBufferSize)
       return false;
-    packet->length = static_cast<size_t>(length);
-    packet->original_length = packet->length;
+    memcpy(packet->data, view.data, view.length);
+    packet->length = view.length;
+    packet->original_length = view.original_length;
+    packet->time_ms = view.time_ms;
     return true;
   }
 
-  virtual int NextPcap(uint8_t* data, uint32_t* length, uint32_t* time_ms) {
-    assert(data);
-    assert(length);
-    assert(time_ms);
-
+  bool NextPacketView(RtpPacketView* packet) override {
     if (next_packet_it_ == packets_.end()) {
-      return -1;
+      return false;
     }
-    if (*length < next_packet_it_->payload_length) {
-      return -1;
+    const RtpPacketMarker& marker = *next_packet_it_;
+    if (Seek(marker.pos_in_file) != kResultSuccess)
+      return false;
+    if (mapping_) {
+      if (Read(nullptr, marker.payload_length) != kResultSuccess)
+        return false;
+      packet->data = mapping_ + marker.pos_in_file;
+    } else {
+      if (Read(read_buffer_, marker.payload_length) != kResultSuccess)
+        return false;
+      packet->data = read_buffer_;
     }
-    TRY_PCAP(fseek(file_, next_packet_it_->pos_in_file, SEEK_SET));
-    TRY_PCAP(Read(data, next_packet_it_->payload_length));
-    *length = next_packet_it_->payload_length;
-    *time_ms = next_packet_it_->time_offset_ms;
+    packet->length = marker.payload_length;
+    packet->original_length = marker.payload_length;
+    packet->time_ms = static_cast<uint32_t>(marker.time_ms);
     next_packet_it_++;
-
-    return 0;
+    return true;
   }
 
  private:
   // A marker of an RTP packet within the file.
   struct RtpPacketMarker {
     uint32_t packet_number;   // One-based index (like in WireShark)
-    uint32_t time_offset_ms;
     uint32_t source_ip;
     uint32_t dest_ip;
     uint16_t source_port;
     uint16_t dest_port;
-    RTPHeader rtp_header;
-    int32_t pos_in_file;      // Byte offset of payload from start of file.
+    // Capture time, which once the packets are filtered is made relative to
+    // the first packet.
+    uint64_t time_ms;
+    int64_t pos_in_file;      // Byte offset of payload from start of file.
     uint32_t payload_length;
+    uint32_t ssrc;            // The sender's SSRC for RTCP packets.
+    uint8_t payload_type;
+    bool rtcp;
   };
 
   typedef std::vector<RtpPacketMarker>::iterator PacketIterator;
   typedef std::map<uint32_t, std::vector<uint32_t> > SsrcMap;
   typedef std::map<uint32_t, std::vector<uint32_t> >::iterator SsrcMapIterator;
 
+  int64_t FileSize() {
+    if (fseek(file_, 0, SEEK_END) != 0)
+      return -1;
+    const int64_t file_size = ftell(file_);
+    if (fseek(file_, 0, SEEK_SET) != 0)
+      return -1;
+    return file_size;
+  }
+
+  void MapFile(int64_t file_size) {
+#if defined(WEBRTC_POSIX)
+    if (file_size <= 0)
+      return;
+    void* mapping = mmap(nullptr, static_cast<size_t>(file_size), PROT_READ,
+                         MAP_PRIVATE, fileno(file_), 0);
+    if (mapping == MAP_FAILED)
+      return;
+    mapping_ = static_cast<const uint8_t*>(mapping);
+    mapping_size_ = static_cast<size_t>(file_size);
+#endif
+  }
+
+  // Reads all packet headers of the file into |markers|.
+  int ScanPackets(std::vector<RtpPacketMarker>* markers) {
+    int64_t next_packet_pos = Tell();
+    for (;;) {
+      TRY_PCAP(Seek(next_packet_pos));
+      int result = ReadPacket(&next_packet_pos, ++total_packet_count_, markers);
+      if (result == kResultFail)
+        break;
+    }
+
+    if (mapping_ ? !read_past_end_ : feof(file_) == 0) {
+      printf("Failed reading file!\n");
+      return kResultFail;
+    }
+    return kResultSuccess;
+  }
+
+  // The index starts with kPcapIndexMagic, the size of the pcap file, the
+  // number of packets in it and the number of markers, which then follow as they are in memory. It's only
+  // meant to be read back on the same machine.
+  bool ReadIndex(const std::string& index_filename,
+                 int64_t file_size,
+                 std::vector<RtpPacketMarker>* markers) {
+    FILE* index_file = fopen(index_filename.c_str(), "rb");
+    if (index_file == NULL)
+      return false;
+    char magic[sizeof(kPcapIndexMagic)];
+    int64_t indexed_file_size;
+    uint64_t num_markers;
+    bool success =
+        fread(magic, sizeof(magic), 1, index_file) == 1 &&
+        memcmp(magic, kPcapIndexMagic, sizeof(magic)) == 0 &&
+        fread(&indexed_file_size, sizeof(indexed_file_size), 1, index_file) ==
+            1 &&
+        indexed_file_size == file_size &&
+        fread(&total_packet_count_, sizeof(total_packet_count_), 1,
+              index_file) == 1 &&
+        fread(&num_markers, sizeof(num_markers), 1, index_file) == 1;
+    if (success) {
+      markers->resize(static_cast<size_t>(num_markers));
+      success = num_markers == 0 ||
+                fread(markers->data(), sizeof(RtpPacketMarker),
+                      markers->size(), index_file) == markers->size();
+    }
+    fclose(index_file);
+    if (!success) {
+      markers->clear();
+      printf("Ignoring outdated or corrupt index file %s\n",
+             index_filename.c_str());
+    }
+    return success;
+  }
+
+  bool WriteIndex(const std::string& index_filename,
+                  int64_t file_size,
+                  const std::vector<RtpPacketMarker>& markers) {
+    FILE* index_file = fopen(index_filename.c_str(), "wb");
+    if (index_file == NULL)
+      return false;
+    const uint64_t num_markers = markers.size();
+    bool success =
+        fwrite(kPcapIndexMagic, sizeof(kPcapIndexMagic), 1, index_file) == 1 &&
+        fwrite(&file_size, sizeof(file_size), 1, index_file) == 1 &&
+        fwrite(&total_packet_count_, sizeof(total_packet_count_), 1,
+               index_file) == 1 &&
+        fwrite(&num_markers, sizeof(num_markers), 1, index_file) == 1 &&
+        (markers.empty() ||
+         fwrite(markers.data(), sizeof(RtpPacketMarker), markers.size(),
+                index_file) == markers.size());
+    return fclose(index_file) == 0 && success;
+  }
+
   int ReadGlobalHeader() {
     uint32_t magic;
     TRY_PCAP(Read(&magic, false));
@@ -417,10 +581,9 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
-  int ReadPacket(int32_t* next_packet_pos,
-                 uint32_t stream_start_ms,
+  int ReadPacket(int64_t* next_packet_pos,
                  uint32_t number,
-                 const std::set<uint32_t>& ssrc_filter) {
+                 std::vector<RtpPacketMarker>* markers) {
     assert(next_packet_pos);
 
     uint32_t ts_sec;    // Timestamp seconds.
@@ -432,45 +595,47 @@ class PcapReader : public RtpFileReaderImpl {
     TRY_PCAP(Read(&incl_len, false));
     TRY_PCAP(Read(&orig_len, false));
 
-    *next_packet_pos = ftell(file_) + incl_len;
+    *next_packet_pos = Tell() + incl_len;
 
-    RtpPacketMarker marker = {0};
+    RtpPacketMarker marker;
+    memset(&marker, 0, sizeof(marker));
     marker.packet_number = number;
-    marker.time_offset_ms = CalcTimeDelta(ts_sec, ts_usec, stream_start_ms);
+    // Round to nearest ms.
+    marker.time_ms =
+        ((static_cast<uint64_t>(ts_sec) * 1000000) + ts_usec + 500) / 1000;
     TRY_PCAP(ReadPacketHeader(&marker));
-    marker.pos_in_file = ftell(file_);
+    marker.pos_in_file = Tell();
 
     if (marker.payload_length > sizeof(read_buffer_)) {
       printf("Packet too large!\n");
       return kResultFail;
     }
-    TRY_PCAP(Read(read_buffer_, marker.payload_length));
-
-    RtpUtility::RtpHeaderParser rtp_parser(read_buffer_, marker.payload_length);
-    if (rtp_parser.RTCP()) {
-      rtp_parser.ParseRtcp(&marker.rtp_header);
-      packets_.push_back(marker);
+    const uint8_t* payload = read_buffer_;
+    if (mapping_) {
+      TRY_PCAP(Read(nullptr, marker.payload_length));
+      payload = mapping_ + marker.pos_in_file;
     } else {
-      if (!rtp_parser.Parse(&marker.rtp_header, nullptr)) {
-        LOG(LS_INFO) << "Not recognized as RTP/RTCP";
-        return kResultSkip;
-      }
+      TRY_PCAP(Read(read_buffer_, marker.payload_length));
+    }
 
-      uint32_t ssrc = marker.rtp_header.ssrc;
-      if (ssrc_filter.empty() || ssrc_filter.find(ssrc) != ssrc_filter.end()) {
-        packets_by_ssrc_[ssrc].push_back(
-            static_cast<uint32_t>(packets_.size()));
-        packets_.push_back(marker);
-      } else {
-        return kResultSkip;
-      }
+    RTPHeader rtp_header;
+    RtpUtility::RtpHeaderParser rtp_parser(payload, marker.payload_length);
+    if (rtp_parser.RTCP()) {
+      rtp_parser.ParseRtcp(&rtp_header);
+      marker.rtcp = true;
+    } else if (!rtp_parser.Parse(&rtp_header, nullptr)) {
+      LOG(LS_INFO) << "Not recognized as RTP/RTCP";
+      return kResultSkip;
     }
+    marker.ssrc = rtp_header.ssrc;
+    marker.payload_type = rtp_header.payloadType;
+    markers->push_back(marker);
 
     return kResultSuccess;
   }
 
   int ReadPacketHeader(RtpPacketMarker* marker) {
-    int32_t file_pos = ftell(file_);
+    int64_t file_pos = Tell();
 
     // Check for BSD null/loopback frame header. The header is just 4 bytes in
     // native byte order, so we check for both versions as we don't care about
@@ -486,7 +651,7 @@ class PcapReader : public RtpFileReaderImpl {
       }
     }
 
-    TRY_PCAP(fseek(file_, file_pos, SEEK_SET));
+    TRY_PCAP(Seek(file_pos));
 
     // Check for Ethernet II, IP frame header.
     uint16_t type;
@@ -503,18 +668,6 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSkip;
   }
 
-  uint32_t CalcTimeDelta(uint32_t ts_sec, uint32_t ts_usec, uint32_t start_ms) {
-    // Round to nearest ms.
-    uint64_t t2_ms = ((static_cast<uint64_t>(ts_sec) * 1000000) + ts_usec +
-        500) / 1000;
-    uint64_t t1_ms = static_cast<uint64_t>(start_ms);
-    if (t2_ms < t1_ms) {
-      return 0;
-    } else {
-      return t2_ms - t1_ms;
-    }
-  }
-
   int ReadXxpIpHeader(RtpPacketMarker* marker) {
     assert(marker);
 
@@ -571,9 +724,7 @@ class PcapReader : public RtpFileReaderImpl {
 
   int Read(uint32_t* out, bool expect_network_order) {
     uint32_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint32_t), file_) != sizeof(uint32_t)) {
-      return kResultFail;
-    }
+    TRY_PCAP(ReadBytes(&tmp, sizeof(uint32_t)));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 24) & 0x000000ff) | (tmp << 24) |
@@ -585,9 +736,7 @@ class PcapReader : public RtpFileReaderImpl {
 
   int Read(uint16_t* out, bool expect_network_order) {
     uint16_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint16_t), file_) != sizeof(uint16_t)) {
-      return kResultFail;
-    }
+    TRY_PCAP(ReadBytes(&tmp, sizeof(uint16_t)));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 8) & 0x00ff) | (tmp << 8);
@@ -596,18 +745,15 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
+  // Reads |count| bytes into |out|. When the file is mapped, |out| may be null
+  // to only check that the bytes are there and move past them.
   int Read(uint8_t* out, uint32_t count) {
-    if (fread(out, 1, count, file_) != count) {
-      return kResultFail;
-    }
-    return kResultSuccess;
+    return ReadBytes(out, count);
   }
 
   int Read(int32_t* out, bool expect_network_order) {
     int32_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint32_t), file_) != sizeof(uint32_t)) {
-      return kResultFail;
-    }
+    TRY_PCAP(ReadBytes(&tmp, sizeof(uint32_t)));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 24) & 0x000000ff) | (tmp << 24) |
@@ -617,7 +763,45 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
+  int ReadBytes(void* out, size_t count) {
+    if (!mapping_) {
+      RTC_DCHECK(out);
+      if (fread(out, 1, count, file_) != count) {
+        return kResultFail;
+      }
+      return kResultSuccess;
+    }
+    if (read_pos_ < 0 || read_pos_ > static_cast<int64_t>(mapping_size_) ||
+        count > mapping_size_ - static_cast<size_t>(read_pos_)) {
+      read_past_end_ = true;
+      return kResultFail;
+    }
+    if (out)
+      memcpy(out, mapping_ + read_pos_, count);
+    read_pos_ += count;
+    return kResultSuccess;
+  }
+
+  int64_t Tell() const {
+    return mapping_ ? read_pos_ : ftell(file_);
+  }
+
+  int Seek(int64_t pos) {
+    if (mapping_) {
+      read_pos_ = pos;
+      return kResultSuccess;
+    }
+    if (fseek(file_, static_cast<long>(pos), SEEK_SET) != 0) {  // NOLINT
+      return kResultFail;
+    }
+    return kResultSuccess;
+  }
+
   int Skip(uint32_t length) {
+    if (mapping_) {
+      read_pos_ += length;
+      return kResultSuccess;
+    }
     if (fseek(file_, length, SEEK_CUR) != 0) {
       return kResultFail;
     }
@@ -625,6 +809,13 @@ class PcapReader : public RtpFileReaderImpl {
   }
 
   FILE* file_;
+  // The whole file, if it could be mapped. Otherwise it's read through
+  // |file_|.
+  const uint8_t* mapping_;
+  size_t mapping_size_;
+  int64_t read_pos_;
+  bool read_past_end_;
+  uint32_t total_packet_count_;
   bool swap_pcap_byte_order_;
   const bool swap_network_byte_order_;
   uint8_t read_buffer_[kMaxReadBufferSize];
@@ -638,7 +829,8 @@ class PcapReader : public RtpFileReaderImpl {
 
 RtpFileReader* RtpFileReader::Create(FileFormat format,
                                      const std::string& filename,
-                                     const std::set<uint32_t>& ssrc_filter) {
+                                     const std::set<uint32_t>& ssrc_filter,
+                                     const std::string& index_filename) {
   RtpFileReaderImpl* reader = NULL;
   switch (format) {
     case kPcap:
@@ -651,13 +843,19 @@ RtpFileReader* RtpFileReader::Create(FileFormat format,
       reader = new InterleavedRtpFileReader();
       break;
   }
-  if (!reader->Init(filename, ssrc_filter)) {
+  if (!reader->InitWithIndex(filename, ssrc_filter, index_filename)) {
     delete reader;
     return NULL;
   }
   return reader;
 }
 
+RtpFileReader* RtpFileReader::Create(FileFormat format,
+                                     const std::string& filename,
+                                     const std::set<uint32_t>& ssrc_filter) {
+  return RtpFileReader::Create(format, filename, ssrc_filter, "");
+}
+
 RtpFileReader* RtpFileReader::Create(FileFormat format,
                                      const std::string& filename) {
   return RtpFileReader::Create(format, filename, std::set<uint32_t>());
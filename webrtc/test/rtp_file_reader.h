@@ -31,6 +31,16 @@ struct RtpPacket {
   uint32_t time_ms;
 };
 
+// Like RtpPacket, but refers to the packet data where the reader holds it.
+// |data| is valid until the next call to the reader.
+struct RtpPacketView {
+  const uint8_t* data;
+  size_t length;
+  size_t original_length;
+
+  uint32_t time_ms;
+};
+
 class RtpFileReader {
  public:
   enum FileFormat { kPcap, kRtpDump, kLengthPacketInterleaved };
@@ -41,8 +51,19 @@ class RtpFileReader {
   static RtpFileReader* Create(FileFormat format,
                                const std::string& filename,
                                const std::set<uint32_t>& ssrc_filter);
+  // For kPcap, the offsets of the packets in the file are read from
+  // |index_filename| when it is an index of this very file, and otherwise
+  // written to it once the file has been scanned. This saves scanning large
+  // captures each time they are replayed. Other formats ignore the index.
+  static RtpFileReader* Create(FileFormat format,
+                               const std::string& filename,
+                               const std::set<uint32_t>& ssrc_filter,
+                               const std::string& index_filename);
 
   virtual bool NextPacket(RtpPacket* packet) = 0;
+  // Avoids copying the packet where the reader can. The pcap reader memory
+  // maps the file, where supported.
+  virtual bool NextPacketView(RtpPacketView* packet) = 0;
 };
 }  // namespace test
 }  // namespace webrtc
@@ -8,9 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include <map>
 #include <memory>
+#include <vector>
 
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/rtp_file_reader.h"
@@ -123,4 +127,183 @@ TEST_F(TestPcapFileReader, TestThreeSsrc) {
   EXPECT_EQ(113, pps[0x59fe6ef0]);
   EXPECT_EQ(61, pps[0xed2bd2ac]);
 }
+// Writes a capture of RTP packets in BSD loopback frames, so that the tests
+// don't depend on resources.
+class PcapFileWriter {
+ public:
+  explicit PcapFileWriter(const std::string& filename)
+      : file_(fopen(filename.c_str(), "wb")) {
+    // Global header: magic, version 2.4, zone, sigfigs, snaplen, LINKTYPE_NULL.
+    const uint32_t kMagic = 0xa1b2c3d4;
+    const uint16_t kVersion[] = {2, 4};
+    const uint32_t kRest[] = {0, 0, 65535, 0};
+    fwrite(&kMagic, sizeof(kMagic), 1, file_);
+    fwrite(kVersion, sizeof(kVersion), 1, file_);
+    fwrite(kRest, sizeof(kRest), 1, file_);
+  }
+  ~PcapFileWriter() { fclose(file_); }
+
+  void WriteRtpPacket(uint32_t ssrc,
+                      uint16_t sequence_number,
+                      uint32_t time_ms,
+                      size_t payload_size) {
+    const size_t kRtpHeaderSize = 12;
+    const size_t kIpHeaderSize = 20;
+    const size_t kUdpHeaderSize = 8;
+    const size_t rtp_size = kRtpHeaderSize + payload_size;
+    std::vector<uint8_t> frame(4 + kIpHeaderSize + kUdpHeaderSize + rtp_size);
+    // BSD loopback header, in native byte order.
+    const uint32_t kLoopback = 0x00000002;
+    memcpy(&frame[0], &kLoopback, sizeof(kLoopback));
+    uint8_t* ip = &frame[4];
+    ip[0] = 0x45;  // IPv4, 20 byte header.
+    ByteWriter<uint16_t>::WriteBigEndian(
+        &ip[2], kIpHeaderSize + kUdpHeaderSize + rtp_size);
+    ip[8] = 64;    // TTL.
+    ip[9] = 0x11;  // UDP.
+    ByteWriter<uint32_t>::WriteBigEndian(&ip[12], 0x7f000001);
+    ByteWriter<uint32_t>::WriteBigEndian(&ip[16], 0x7f000001);
+    uint8_t* udp = ip + kIpHeaderSize;
+    ByteWriter<uint16_t>::WriteBigEndian(&udp[0], 5000);
+    ByteWriter<uint16_t>::WriteBigEndian(&udp[2], 5001);
+    ByteWriter<uint16_t>::WriteBigEndian(&udp[4], kUdpHeaderSize + rtp_size);
+    uint8_t* rtp = udp + kUdpHeaderSize;
+    rtp[0] = 0x80;
+    rtp[1] = 100;
+    ByteWriter<uint16_t>::WriteBigEndian(&rtp[2], sequence_number);
+    ByteWriter<uint32_t>::WriteBigEndian(&rtp[4], time_ms * 90);
+    ByteWriter<uint32_t>::WriteBigEndian(&rtp[8], ssrc);
+    for (size_t i = 0; i < payload_size; ++i)
+      rtp[kRtpHeaderSize + i] = static_cast<uint8_t>(sequence_number + i);
+
+    const uint32_t record_header[] = {
+        1000 + time_ms / 1000, (time_ms % 1000) * 1000,
+        static_cast<uint32_t>(frame.size()),
+        static_cast<uint32_t>(frame.size())};
+    fwrite(record_header, sizeof(record_header), 1, file_);
+    fwrite(frame.data(), 1, frame.size(), file_);
+  }
+
+ private:
+  FILE* const file_;
+};
+
+class TestGeneratedPcapFileReader : public ::testing::Test {
+ public:
+  static const uint32_t kSsrc1 = 0x11111111;
+  static const uint32_t kSsrc2 = 0x22222222;
+  static const int kNumPackets = 30;
+
+  void SetUp() override {
+    filename_ = test::TempFilename(test::OutputPath(), "rtp_file_reader");
+    index_filename_ = filename_ + ".index";
+    PcapFileWriter writer(filename_);
+    for (int i = 0; i < kNumPackets; ++i) {
+      writer.WriteRtpPacket(i % 3 == 0 ? kSsrc2 : kSsrc1, i, 10 + 5 * i,
+                            100 + 30 * i);
+    }
+  }
+
+  void TearDown() override {
+    remove(filename_.c_str());
+    remove(index_filename_.c_str());
+  }
+
+  std::vector<std::vector<uint8_t>> ReadPackets(
+      test::RtpFileReader* reader,
+      std::vector<uint32_t>* times_ms) {
+    std::vector<std::vector<uint8_t>> packets;
+    test::RtpPacketView packet;
+    while (reader->NextPacketView(&packet)) {
+      EXPECT_EQ(packet.length, packet.original_length);
+      packets.emplace_back(packet.data, packet.data + packet.length);
+      times_ms->push_back(packet.time_ms);
+    }
+    return packets;
+  }
+
+ protected:
+  std::string filename_;
+  std::string index_filename_;
+};
+
+TEST_F(TestGeneratedPcapFileReader, ViewsMatchCopiedPackets) {
+  std::unique_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kPcap, filename_));
+  ASSERT_TRUE(reader);
+  std::vector<uint32_t> times_ms;
+  std::vector<std::vector<uint8_t>> views = ReadPackets(reader.get(),
+                                                        &times_ms);
+  ASSERT_EQ(static_cast<size_t>(kNumPackets), views.size());
+
+  reader.reset(
+      test::RtpFileReader::Create(test::RtpFileReader::kPcap, filename_));
+  ASSERT_TRUE(reader);
+  test::RtpPacket packet;
+  for (int i = 0; i < kNumPackets; ++i) {
+    ASSERT_TRUE(reader->NextPacket(&packet));
+    EXPECT_EQ(views[i],
+              std::vector<uint8_t>(packet.data, packet.data + packet.length));
+    EXPECT_EQ(static_cast<uint32_t>(5 * i), packet.time_ms);
+    EXPECT_EQ(packet.time_ms, times_ms[i]);
+  }
+  EXPECT_FALSE(reader->NextPacket(&packet));
+}
+
+TEST_F(TestGeneratedPcapFileReader, FiltersSsrc) {
+  std::unique_ptr<test::RtpFileReader> reader(test::RtpFileReader::Create(
+      test::RtpFileReader::kPcap, filename_, {kSsrc2}));
+  ASSERT_TRUE(reader);
+  std::vector<uint32_t> times_ms;
+  EXPECT_EQ(static_cast<size_t>(kNumPackets / 3),
+            ReadPackets(reader.get(), &times_ms).size());
+  // Times are relative to the first packet of the stream.
+  EXPECT_EQ(0u, times_ms.front());
+  EXPECT_EQ(15u, times_ms[1]);
+}
+
+TEST_F(TestGeneratedPcapFileReader, IndexGivesSamePackets) {
+  std::unique_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kPcap, filename_));
+  ASSERT_TRUE(reader);
+  std::vector<uint32_t> times_ms;
+  std::vector<std::vector<uint8_t>> packets = ReadPackets(reader.get(),
+                                                          &times_ms);
+
+  // The first reader writes the index, the second one reads it.
+  for (int i = 0; i < 2; ++i) {
+    reader.reset(test::RtpFileReader::Create(test::RtpFileReader::kPcap,
+                                             filename_, std::set<uint32_t>(),
+                                             index_filename_));
+    ASSERT_TRUE(reader);
+    std::vector<uint32_t> indexed_times_ms;
+    EXPECT_EQ(packets, ReadPackets(reader.get(), &indexed_times_ms));
+    EXPECT_EQ(times_ms, indexed_times_ms);
+    FILE* index_file = fopen(index_filename_.c_str(), "rb");
+    ASSERT_TRUE(index_file);
+    fclose(index_file);
+  }
+
+  // The index serves any filter.
+  reader.reset(test::RtpFileReader::Create(
+      test::RtpFileReader::kPcap, filename_, {kSsrc1}, index_filename_));
+  ASSERT_TRUE(reader);
+  times_ms.clear();
+  EXPECT_EQ(static_cast<size_t>(kNumPackets - kNumPackets / 3),
+            ReadPackets(reader.get(), &times_ms).size());
+}
+
+TEST_F(TestGeneratedPcapFileReader, IgnoresIndexOfOtherFile) {
+  {
+    PcapFileWriter writer(index_filename_);
+    writer.WriteRtpPacket(kSsrc1, 0, 0, 10);
+  }
+  std::unique_ptr<test::RtpFileReader> reader(test::RtpFileReader::Create(
+      test::RtpFileReader::kPcap, filename_, std::set<uint32_t>(),
+      index_filename_));
+  ASSERT_TRUE(reader);
+  std::vector<uint32_t> times_ms;
+  EXPECT_EQ(static_cast<size_t>(kNumPackets),
+            ReadPackets(reader.get(), &times_ms).size());
+}
 }  // namespace webrtc
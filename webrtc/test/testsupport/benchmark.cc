@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/testsupport/benchmark.h"
+
+#include <math.h>
+
+#include <sstream>
+#include <vector>
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+int64_t TimeCalls(int64_t calls, rtc::FunctionView<void()> function) {
+  const int64_t start_ns = rtc::TimeNanos();
+  for (int64_t i = 0; i < calls; ++i)
+    function();
+  return rtc::TimeNanos() - start_ns;
+}
+
+std::string ToString(double value) {
+  std::ostringstream stream;
+  stream << value;
+  return stream.str();
+}
+
+}  // namespace
+
+BenchmarkResult RunBenchmark(const std::string& name,
+                             size_t bytes_per_call,
+                             rtc::FunctionView<void()> function,
+                             int repetitions,
+                             int min_repetition_ms) {
+  RTC_DCHECK_GT(repetitions, 0);
+  const int64_t min_repetition_ns =
+      min_repetition_ms * rtc::kNumNanosecsPerMillisec;
+
+  // Also warms up caches and lazily allocated state.
+  int64_t calls_per_repetition = 1;
+  while (TimeCalls(calls_per_repetition, function) < min_repetition_ns)
+    calls_per_repetition *= 2;
+
+  std::vector<double> ns_per_call(repetitions);
+  double sum = 0;
+  for (double& ns : ns_per_call) {
+    ns = static_cast<double>(TimeCalls(calls_per_repetition, function)) /
+         calls_per_repetition;
+    sum += ns;
+  }
+  const double mean = sum / repetitions;
+  double sum_of_squares = 0;
+  for (double ns : ns_per_call)
+    sum_of_squares += (ns - mean) * (ns - mean);
+
+  BenchmarkResult result;
+  result.calls = calls_per_repetition * repetitions;
+  result.mean_ns_per_call = mean;
+  result.stddev_ns_per_call = sqrt(sum_of_squares / repetitions);
+
+  PrintResultMeanAndError(
+      "time_per_call", "", name,
+      ToString(result.mean_ns_per_call) + "," +
+          ToString(result.stddev_ns_per_call),
+      "ns",
+      true);
+  if (bytes_per_call > 0 && mean > 0) {
+    // Bytes per ns are GB/s.
+    PrintResult("throughput", "", name,
+                ToString(1000.0 * bytes_per_call / mean), "MBps", true);
+  }
+  return result;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_TEST_TESTSUPPORT_BENCHMARK_H_
+#define WEBRTC_TEST_TESTSUPPORT_BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "webrtc/rtc_base/function_view.h"
+
+namespace webrtc {
+namespace test {
+
+struct BenchmarkResult {
+  // The number of calls that were timed.
+  int64_t calls;
+  // Mean and standard deviation over the repetitions.
+  double mean_ns_per_call;
+  double stddev_ns_per_call;
+};
+
+// Times |function| for a microbenchmark, and prints the result with
+// PrintResultMeanAndError() so that it can be tracked for regressions.
+//
+// The number of calls per repetition is doubled until a repetition takes at
+// least |min_repetition_ms|; the time per call is then measured over
+// |repetitions| repetitions. The graph is "time_per_call" with |name| as
+// trace, in ns. If |bytes_per_call| is non-zero, the throughput is printed
+// to the "throughput" graph as well, in MB/s.
+BenchmarkResult RunBenchmark(const std::string& name,
+                             size_t bytes_per_call,
+                             rtc::FunctionView<void()> function,
+                             int repetitions = 10,
+                             int min_repetition_ms = 20);
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_TESTSUPPORT_BENCHMARK_H_
@@ -0,0 +1,34 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/testsupport/benchmark.h"
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace test {
+
+TEST(BenchmarkTest, TimesRepeatedCalls) {
+  int64_t calls = 0;
+  volatile int sink = 0;
+  BenchmarkResult result = RunBenchmark("BenchmarkTest", 100, [&] {
+    ++calls;
+    for (int i = 0; i < 100; ++i)
+      sink = sink + i;
+  }, 3, 1);
+  // The calibration calls aren't included in the result.
+  EXPECT_GT(calls, result.calls);
+  EXPECT_EQ(0, result.calls % 3);
+  EXPECT_GT(result.mean_ns_per_call, 0);
+  EXPECT_GE(result.stddev_ns_per_call, 0);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -15,11 +15,15 @@
 
 #include <algorithm>  // min_element, max_element
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "webrtc/api/video/i420_buffer.h"
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/test/frame_utils.h"
+#include "webrtc/test/testsupport/fileutils.h"
 #include "libyuv/convert.h"
 
 namespace webrtc {
@@ -157,6 +161,50 @@ int CalculateMetrics(VideoMetricsType video_metrics_type,
   return return_code;
 }
 
+// The frames [first_frame, first_frame + num_frames) of a pair of files, which
+// one thread of I420MetricsFromFilesMultiThreaded compares.
+struct FrameRange {
+  const char* ref_filename;
+  const char* test_filename;
+  int width;
+  int height;
+  int first_frame;
+  int num_frames;
+  QualityMetricsResult psnr_result;
+  QualityMetricsResult ssim_result;
+};
+
+void CalculateFrameRange(void* obj) {
+  FrameRange* range = static_cast<FrameRange*>(obj);
+  FILE* ref_fp = fopen(range->ref_filename, "rb");
+  FILE* test_fp = fopen(range->test_filename, "rb");
+  if (ref_fp != NULL && test_fp != NULL) {
+    const long offset = static_cast<long>(
+        CalcBufferSize(VideoType::kI420, range->width, range->height) *
+        range->first_frame);
+    if (fseek(ref_fp, offset, SEEK_SET) == 0 &&
+        fseek(test_fp, offset, SEEK_SET) == 0) {
+      for (int i = 0; i < range->num_frames; ++i) {
+        rtc::scoped_refptr<I420Buffer> ref_i420_buffer(
+            test::ReadI420Buffer(range->width, range->height, ref_fp));
+        rtc::scoped_refptr<I420Buffer> test_i420_buffer(
+            test::ReadI420Buffer(range->width, range->height, test_fp));
+        if (!ref_i420_buffer || !test_i420_buffer)
+          break;
+        const int frame_number = range->first_frame + i;
+        CalculateFrame(kPSNR, *ref_i420_buffer, *test_i420_buffer,
+                       frame_number, &range->psnr_result);
+        CalculateFrame(kSSIM, *ref_i420_buffer, *test_i420_buffer,
+                       frame_number, &range->ssim_result);
+      }
+    }
+  }
+  if (ref_fp != NULL)
+    fclose(ref_fp);
+  if (test_fp != NULL)
+    fclose(test_fp);
+}
+
 int I420MetricsFromFiles(const char* ref_filename,
                          const char* test_filename,
                          int width,
@@ -189,5 +237,85 @@ int I420SSIMFromFiles(const char* ref_filename,
                           NULL, result);
 }
 
+int I420MetricsFromFilesMultiThreaded(const char* ref_filename,
+                                      const char* test_filename,
+                                      int width,
+                                      int height,
+                                      int num_threads,
+                                      QualityMetricsResult* psnr_result,
+                                      QualityMetricsResult* ssim_result) {
+  assert(ref_filename != NULL);
+  assert(test_filename != NULL);
+  assert(width > 0);
+  assert(height > 0);
+  assert(psnr_result != NULL);
+  assert(ssim_result != NULL);
+
+  FILE* ref_fp = fopen(ref_filename, "rb");
+  if (ref_fp == NULL) {
+    fprintf(stderr, "Cannot open file %s\n", ref_filename);
+    return -1;
+  }
+  fclose(ref_fp);
+  FILE* test_fp = fopen(test_filename, "rb");
+  if (test_fp == NULL) {
+    fprintf(stderr, "Cannot open file %s\n", test_filename);
+    return -2;
+  }
+  fclose(test_fp);
+
+  const size_t frame_length = CalcBufferSize(VideoType::kI420, width, height);
+  const int num_frames = static_cast<int>(
+      std::min(GetFileSize(ref_filename), GetFileSize(test_filename)) /
+      frame_length);
+  if (num_frames == 0) {
+    fprintf(stderr, "Tried to measure video metrics from empty files "
+            "(reference file: %s  test file: %s)\n", ref_filename,
+            test_filename);
+    return -3;
+  }
+
+  num_threads = std::max(1, std::min(num_threads, num_frames));
+  std::vector<FrameRange> ranges(num_threads);
+  int first_frame = 0;
+  for (int i = 0; i < num_threads; ++i) {
+    FrameRange& range = ranges[i];
+    range.ref_filename = ref_filename;
+    range.test_filename = test_filename;
+    range.width = width;
+    range.height = height;
+    range.first_frame = first_frame;
+    range.num_frames = num_frames / num_threads + (i < num_frames % num_threads);
+    first_frame += range.num_frames;
+  }
+
+  // The first range is compared on the calling thread.
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back(new rtc::PlatformThread(
+        &CalculateFrameRange, &ranges[i], "I420MetricsWorker"));
+    threads.back()->Start();
+  }
+  CalculateFrameRange(&ranges[0]);
+  for (const auto& thread : threads)
+    thread->Stop();
+
+  // Stop at the first range that is cut short, so that the frame numbers stay
+  // consecutive, like when the files are compared on a single thread.
+  for (const FrameRange& range : ranges) {
+    psnr_result->frames.insert(psnr_result->frames.end(),
+                               range.psnr_result.frames.begin(),
+                               range.psnr_result.frames.end());
+    ssim_result->frames.insert(ssim_result->frames.end(),
+                               range.ssim_result.frames.begin(),
+                               range.ssim_result.frames.end());
+    if (static_cast<int>(range.psnr_result.frames.size()) != range.num_frames)
+      break;
+  }
+  CalculateStats(psnr_result);
+  CalculateStats(ssim_result);
+  return 0;
+}
+
 }  // namespace test
 }  // namespace webrtc
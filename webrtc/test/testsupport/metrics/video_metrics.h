@@ -70,6 +70,17 @@ int I420MetricsFromFiles(const char* ref_filename,
                          QualityMetricsResult* psnr_result,
                          QualityMetricsResult* ssim_result);
 
+// Same as I420MetricsFromFiles, but splits the frames into |num_threads|
+// consecutive ranges that are compared concurrently, each on its own thread.
+// The results are the same as those of I420MetricsFromFiles.
+int I420MetricsFromFilesMultiThreaded(const char* ref_filename,
+                                      const char* test_filename,
+                                      int width,
+                                      int height,
+                                      int num_threads,
+                                      QualityMetricsResult* psnr_result,
+                                      QualityMetricsResult* ssim_result);
+
 // Calculates PSNR values for the reference and test video files (must be in
 // I420 format). All calculated values are filled into the QualityMetricsResult
 // struct.
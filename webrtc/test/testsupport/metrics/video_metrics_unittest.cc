@@ -10,6 +10,10 @@
 
 #include "webrtc/test/testsupport/metrics/video_metrics.h"
 
+#include <stdio.h>
+
+#include <string>
+
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -144,4 +148,58 @@ TEST_F(VideoMetricsTest, EmptyFilesBothMetrics) {
                                    &psnr_result_, &ssim_result_));
 }
 
+
+TEST_F(VideoMetricsTest, MultiThreadedMatchesSingleThreaded) {
+  // Make a test file that differs from the reference in every frame.
+  std::string distorted_file = webrtc::test::TempFilename(
+      webrtc::test::OutputPath(), "video_metrics_unittest_distorted_file");
+  FILE* ref_fp = fopen(video_file_.c_str(), "rb");
+  ASSERT_TRUE(ref_fp != NULL);
+  FILE* distorted_fp = fopen(distorted_file.c_str(), "wb");
+  ASSERT_TRUE(distorted_fp != NULL);
+  int c;
+  for (int i = 0; (c = fgetc(ref_fp)) != EOF; ++i)
+    fputc(i % 7 == 0 ? c ^ (i % 13) : c, distorted_fp);
+  fclose(ref_fp);
+  fclose(distorted_fp);
+
+  EXPECT_EQ(0, I420MetricsFromFiles(video_file_.c_str(),
+                                    distorted_file.c_str(), kWidth, kHeight,
+                                    &psnr_result_, &ssim_result_));
+  webrtc::test::QualityMetricsResult psnr_result;
+  webrtc::test::QualityMetricsResult ssim_result;
+  EXPECT_EQ(0, I420MetricsFromFilesMultiThreaded(
+                   video_file_.c_str(), distorted_file.c_str(), kWidth,
+                   kHeight, 3, &psnr_result, &ssim_result));
+  remove(distorted_file.c_str());
+
+  ASSERT_EQ(psnr_result_.frames.size(), psnr_result.frames.size());
+  ASSERT_EQ(ssim_result_.frames.size(), ssim_result.frames.size());
+  for (size_t i = 0; i < psnr_result.frames.size(); ++i) {
+    EXPECT_EQ(psnr_result_.frames[i].frame_number,
+              psnr_result.frames[i].frame_number);
+    EXPECT_EQ(psnr_result_.frames[i].value, psnr_result.frames[i].value);
+    EXPECT_EQ(ssim_result_.frames[i].value, ssim_result.frames[i].value);
+  }
+  EXPECT_EQ(psnr_result_.average, psnr_result.average);
+  EXPECT_EQ(psnr_result_.min_frame_number, psnr_result.min_frame_number);
+  EXPECT_EQ(ssim_result_.average, ssim_result.average);
+  EXPECT_EQ(ssim_result_.min_frame_number, ssim_result.min_frame_number);
+}
+
+TEST_F(VideoMetricsTest, MultiThreadedReturnCodes) {
+  EXPECT_EQ(kMissingReferenceFileReturnCode,
+            I420MetricsFromFilesMultiThreaded(
+                non_existing_file_.c_str(), video_file_.c_str(), kWidth,
+                kHeight, 4, &psnr_result_, &ssim_result_));
+  EXPECT_EQ(kMissingTestFileReturnCode,
+            I420MetricsFromFilesMultiThreaded(
+                video_file_.c_str(), non_existing_file_.c_str(), kWidth,
+                kHeight, 4, &psnr_result_, &ssim_result_));
+  EXPECT_EQ(kEmptyFileReturnCode,
+            I420MetricsFromFilesMultiThreaded(
+                video_file_.c_str(), empty_file_.c_str(), kWidth, kHeight, 4,
+                &psnr_result_, &ssim_result_));
+}
+
 }  // namespace webrtc
@@ -33,13 +33,11 @@ rtc::Optional<VideoFrame> VideoCapturer::AdaptFrame(const VideoFrame& frame) {
 
   rtc::Optional<VideoFrame> out_frame;
   if (out_height != frame.height() || out_width != frame.width()) {
-    // Video adapter has requested a down-scale. Allocate a new buffer and
-    // return scaled version.
-    rtc::scoped_refptr<I420Buffer> scaled_buffer =
-        I420Buffer::Create(out_width, out_height);
-    scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
-    out_frame.emplace(
-        VideoFrame(scaled_buffer, kVideoRotation_0, frame.timestamp_us()));
+    // Video adapter has requested a down-scale. Native buffers may only
+    // record the request, to be scaled by the sink.
+    out_frame.emplace(VideoFrame(
+        frame.video_frame_buffer()->Scale(out_width, out_height),
+        kVideoRotation_0, frame.timestamp_us()));
   } else {
     // No adaptations needed, just return the frame as is.
     out_frame.emplace(frame);
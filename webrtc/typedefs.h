@@ -57,7 +57,8 @@
 
 // TODO(zhongwei.yao): WEBRTC_CPU_DETECTION is only used in one place; we should
 // probably just remove it.
-#if (defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__))
+// x86 needs run time detection even with an SSE2 baseline, to pick AVX2.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
 #define WEBRTC_CPU_DETECTION
 #endif
 
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/decode_scheduler.h"
+
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/location.h"
+#include "webrtc/rtc_base/ptr_util.h"
+#include "webrtc/rtc_base/thread_cpu_accounting.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/rtc_base/trace_event.h"
+
+namespace webrtc {
+namespace {
+const char kThreadName[] = "DecodingThread";
+}  // namespace
+
+DecodeScheduler::DecodeScheduler(int num_threads)
+    : stopping_(false),
+      wake_up_event_(false, false),
+      stream_returned_event_(true, false) {
+  RTC_DCHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.push_back(rtc::MakeUnique<rtc::PlatformThread>(
+        &WorkerThreadFunction, this, kThreadName, rtc::kHighestPriority));
+    threads_.back()->Start();
+  }
+}
+
+DecodeScheduler::~DecodeScheduler() {
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(streams_.empty());
+    stopping_ = true;
+  }
+  // Each worker passes the event on to the next one as it stops.
+  wake_up_event_.Set();
+  for (auto& thread : threads_)
+    thread->Stop();
+}
+
+void DecodeScheduler::AddStream(Stream* stream) {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(streams_.find(stream) == streams_.end());
+  Schedule(stream, &streams_[stream], rtc::TimeMillis());
+}
+
+void DecodeScheduler::RemoveStream(Stream* stream) {
+  while (true) {
+    {
+      rtc::CritScope lock(&crit_);
+      auto it = streams_.find(stream);
+      RTC_DCHECK(it != streams_.end());
+      if (!it->second.running) {
+        Schedule(stream, &it->second, -1);
+        streams_.erase(it);
+        return;
+      }
+      // Keeps the stream from being queued again as it returns.
+      it->second.removed = true;
+      stream_returned_event_.Reset();
+    }
+    stream_returned_event_.Wait(rtc::Event::kForever);
+  }
+}
+
+void DecodeScheduler::WakeUp(Stream* stream) {
+  rtc::CritScope lock(&crit_);
+  auto it = streams_.find(stream);
+  if (it == streams_.end() || it->second.removed)
+    return;
+  if (it->second.running) {
+    it->second.woken_up = true;
+    return;
+  }
+  const int64_t now_ms = rtc::TimeMillis();
+  if (it->second.due_ms < 0 || it->second.due_ms > now_ms)
+    Schedule(stream, &it->second, now_ms);
+}
+
+void DecodeScheduler::WorkerThreadFunction(void* ptr) {
+  static_cast<DecodeScheduler*>(ptr)->RunWorker();
+}
+
+void DecodeScheduler::RunWorker() {
+  while (true) {
+    Stream* stream = nullptr;
+    int wait_ms = rtc::Event::kForever;
+    {
+      rtc::CritScope lock(&crit_);
+      if (stopping_) {
+        wake_up_event_.Set();
+        return;
+      }
+      const int64_t now_ms = rtc::TimeMillis();
+      if (!queue_.empty()) {
+        if (queue_.begin()->first <= now_ms) {
+          stream = queue_.begin()->second;
+          queue_.erase(queue_.begin());
+          StreamState& state = streams_[stream];
+          state.due_ms = -1;
+          state.running = true;
+          state.woken_up = false;
+          // Let another worker take the next stream that is due.
+          if (!queue_.empty() && queue_.begin()->first <= now_ms)
+            wake_up_event_.Set();
+        } else {
+          wait_ms = static_cast<int>(queue_.begin()->first - now_ms);
+        }
+      }
+    }
+    if (!stream) {
+      wake_up_event_.Wait(wait_ms);
+      continue;
+    }
+
+    int64_t next_run_ms;
+    {
+      TRACE_EVENT0("webrtc", "DecodeScheduler::RunStream");
+      rtc::ThreadCpuAccounting::ScopedTask cpu_task(kThreadName,
+                                                    RTC_FROM_HERE);
+      next_run_ms = stream->DecodeNextFrame();
+    }
+
+    rtc::CritScope lock(&crit_);
+    StreamState& state = streams_[stream];
+    state.running = false;
+    if (!state.removed) {
+      const int64_t now_ms = rtc::TimeMillis();
+      if (state.woken_up)
+        Schedule(stream, &state, now_ms);
+      else if (next_run_ms >= 0)
+        Schedule(stream, &state, now_ms + next_run_ms);
+    }
+    stream_returned_event_.Set();
+  }
+}
+
+void DecodeScheduler::Schedule(Stream* stream,
+                               StreamState* state,
+                               int64_t due_ms) {
+  if (state->due_ms >= 0)
+    queue_.erase(std::make_pair(state->due_ms, stream));
+  state->due_ms = due_ms;
+  if (due_ms < 0)
+    return;
+  auto it = queue_.insert(std::make_pair(due_ms, stream)).first;
+  // Workers wait for the first stream of the queue only.
+  if (it == queue_.begin())
+    wake_up_event_.Set();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_DECODE_SCHEDULER_H_
+#define WEBRTC_VIDEO_DECODE_SCHEDULER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Runs the decoding of many video receive streams on a fixed number of
+// threads, instead of each stream blocking a thread of its own while waiting
+// for frames. A stream is run when its next frame is due for decoding, which
+// the stream tells from the render time VCMTiming gives the frame; when
+// several streams are due, the one due first runs first. A stream is never
+// run on two threads at once, so its frames are decoded in order.
+class DecodeScheduler {
+ public:
+  class Stream {
+   public:
+    // Decodes the frame of the stream that is due, if any. Returns the time
+    // until the stream is to be run again, or -1 if that's when WakeUp() is
+    // called.
+    virtual int64_t DecodeNextFrame() = 0;
+
+   protected:
+    virtual ~Stream() {}
+  };
+
+  explicit DecodeScheduler(int num_threads);
+  ~DecodeScheduler();
+
+  // Starts running |stream|, right away.
+  void AddStream(Stream* stream);
+  // Stops running |stream|, and waits for it to return if it is running.
+  void RemoveStream(Stream* stream);
+  // Runs |stream| as soon as possible, e.g. because it has a new frame.
+  // Streams that have not been added or already have been removed are
+  // ignored.
+  void WakeUp(Stream* stream);
+
+ private:
+  struct StreamState {
+    // When the stream is to be run next, or -1 if not until woken up.
+    int64_t due_ms = -1;
+    bool running = false;
+    // Set if woken up while running, to run it again right after.
+    bool woken_up = false;
+    // Set once RemoveStream() waits for the stream to return.
+    bool removed = false;
+  };
+
+  static void WorkerThreadFunction(void* ptr);
+  void RunWorker();
+  // Queues |stream| to be run at |due_ms|, or not if it is -1.
+  void Schedule(Stream* stream, StreamState* state, int64_t due_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  rtc::CriticalSection crit_;
+  std::map<Stream*, StreamState> streams_ GUARDED_BY(crit_);
+  // The streams that are not running and have a time to run, earliest first.
+  std::set<std::pair<int64_t, Stream*>> queue_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+  // Signaled when there may be a stream to run, or when stopping.
+  rtc::Event wake_up_event_;
+  // Signaled, and never reset by the workers, when a stream has returned.
+  rtc::Event stream_returned_event_;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DecodeScheduler);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_DECODE_SCHEDULER_H_
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/decode_scheduler.h"
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/thread.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kTimeoutMs = 5000;
+
+class FakeStream : public DecodeScheduler::Stream {
+ public:
+  // Returns |next_run_ms| from DecodeNextFrame(), and signals |run_event_|
+  // once it has been run |num_runs_to_signal| times.
+  FakeStream(int64_t next_run_ms, int num_runs_to_signal)
+      : next_run_ms_(next_run_ms),
+        num_runs_to_signal_(num_runs_to_signal),
+        run_event_(false, false) {}
+
+  int64_t DecodeNextFrame() override {
+    if (decode_time_ms_ > 0)
+      rtc::Thread::SleepMs(decode_time_ms_);
+    if (rtc::AtomicOps::Increment(&num_runs_) == num_runs_to_signal_)
+      run_event_.Set();
+    return next_run_ms_;
+  }
+
+  void set_decode_time_ms(int decode_time_ms) {
+    decode_time_ms_ = decode_time_ms;
+  }
+  int num_runs() const { return rtc::AtomicOps::AcquireLoad(&num_runs_); }
+  rtc::Event* run_event() { return &run_event_; }
+
+ private:
+  const int64_t next_run_ms_;
+  const int num_runs_to_signal_;
+  int decode_time_ms_ = 0;
+  volatile int num_runs_ = 0;
+  rtc::Event run_event_;
+};
+
+}  // namespace
+
+TEST(DecodeSchedulerTest, RunsStreamAgainWhenDue) {
+  DecodeScheduler scheduler(1);
+  FakeStream stream(5, 3);
+  scheduler.AddStream(&stream);
+  EXPECT_TRUE(stream.run_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream);
+}
+
+TEST(DecodeSchedulerTest, RunsStreamWhenWokenUp) {
+  DecodeScheduler scheduler(2);
+  FakeStream stream(-1, 2);
+  scheduler.AddStream(&stream);
+  // Not run again until woken up.
+  EXPECT_FALSE(stream.run_event()->Wait(50));
+  EXPECT_EQ(1, stream.num_runs());
+  scheduler.WakeUp(&stream);
+  EXPECT_TRUE(stream.run_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream);
+}
+
+TEST(DecodeSchedulerTest, SharesThreadsBetweenStreams) {
+  DecodeScheduler scheduler(2);
+  FakeStream stream1(1, 10);
+  FakeStream stream2(1, 10);
+  FakeStream stream3(1, 10);
+  scheduler.AddStream(&stream1);
+  scheduler.AddStream(&stream2);
+  scheduler.AddStream(&stream3);
+  EXPECT_TRUE(stream1.run_event()->Wait(kTimeoutMs));
+  EXPECT_TRUE(stream2.run_event()->Wait(kTimeoutMs));
+  EXPECT_TRUE(stream3.run_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream1);
+  scheduler.RemoveStream(&stream2);
+  scheduler.RemoveStream(&stream3);
+}
+
+TEST(DecodeSchedulerTest, RemoveStreamWaitsForRunningStream) {
+  DecodeScheduler scheduler(1);
+  FakeStream stream(0, 1);
+  stream.set_decode_time_ms(50);
+  scheduler.AddStream(&stream);
+  EXPECT_TRUE(stream.run_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream);
+  const int num_runs = stream.num_runs();
+  // Never run after having been removed.
+  rtc::Thread::SleepMs(100);
+  EXPECT_EQ(num_runs, stream.num_runs());
+  // Waking up a removed stream is ignored.
+  scheduler.WakeUp(&stream);
+}
+
+}  // namespace webrtc
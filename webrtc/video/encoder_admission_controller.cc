@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/encoder_admission_controller.h"
+
+#include <math.h>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+EncoderAdmissionController::EncoderAdmissionController() {}
+
+EncoderAdmissionController::~EncoderAdmissionController() {
+  RTC_DCHECK(encoders_.empty());
+}
+
+void EncoderAdmissionController::AddEncoder(Encoder* encoder,
+                                            double priority) {
+  RTC_DCHECK_GT(priority, 0);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(encoders_.find(encoder) == encoders_.end());
+  encoders_[encoder].priority = priority;
+}
+
+void EncoderAdmissionController::RemoveEncoder(Encoder* encoder) {
+  rtc::CritScope lock(&crit_);
+  encoders_.erase(encoder);
+}
+
+void EncoderAdmissionController::SetPriority(Encoder* encoder,
+                                             double priority) {
+  RTC_DCHECK_GT(priority, 0);
+  rtc::CritScope lock(&crit_);
+  auto it = encoders_.find(encoder);
+  if (it != encoders_.end())
+    it->second.priority = priority;
+}
+
+void EncoderAdmissionController::OnOveruse(Encoder* source) {
+  rtc::CritScope lock(&crit_);
+  auto source_it = encoders_.find(source);
+  if (source_it == encoders_.end())
+    return;
+  auto target = source_it;
+  for (auto it = encoders_.begin(); it != encoders_.end(); ++it) {
+    if (Weight(it->second, it->second.num_adaptations) <
+        Weight(target->second, target->second.num_adaptations)) {
+      target = it;
+    }
+  }
+  ++target->second.num_adaptations;
+  target->first->AdaptDownForAdmissionControl();
+}
+
+void EncoderAdmissionController::OnUnderuse(Encoder* source) {
+  rtc::CritScope lock(&crit_);
+  auto target = encoders_.end();
+  for (auto it = encoders_.begin(); it != encoders_.end(); ++it) {
+    if (it->second.num_adaptations == 0)
+      continue;
+    if (target == encoders_.end()) {
+      target = it;
+      continue;
+    }
+    const double weight = Weight(it->second, it->second.num_adaptations - 1);
+    const double target_weight =
+        Weight(target->second, target->second.num_adaptations - 1);
+    if (weight > target_weight ||
+        (weight == target_weight && it->first == source)) {
+      target = it;
+    }
+  }
+  if (target == encoders_.end()) {
+    // Nothing adapted down by this controller; the source may still have
+    // adaptations from before it was added.
+    auto source_it = encoders_.find(source);
+    if (source_it != encoders_.end())
+      source->AdaptUpForAdmissionControl();
+    return;
+  }
+  --target->second.num_adaptations;
+  target->first->AdaptUpForAdmissionControl();
+}
+
+// static
+double EncoderAdmissionController::Weight(const EncoderState& state,
+                                          int num_adaptations) {
+  return ldexp(state.priority, num_adaptations);
+}
+
+}  // namespace webrtc
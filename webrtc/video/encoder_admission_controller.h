@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENCODER_ADMISSION_CONTROLLER_H_
+#define WEBRTC_VIDEO_ENCODER_ADMISSION_CONTROLLER_H_
+
+#include <map>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Decides which of the encoders of a Call adapts when any of them detects CPU
+// overuse or underuse, so that the available CPU goes to the streams with the
+// highest priority.
+//
+// Every step down roughly halves the encoding cost of a stream, so an encoder
+// that has been adapted down n times counts as priority * 2^n. Overuse adapts
+// down the encoder with the lowest such weight, and underuse adapts up the
+// encoder that would have been chosen last. A stream with four times the
+// priority of another thus stays at full quality until the other has been
+// adapted down twice. Equal weights favor the encoder that detected the
+// overuse or underuse, which makes a single stream behave as if it adapted on
+// its own.
+//
+// All methods are thread safe.
+class EncoderAdmissionController {
+ public:
+  class Encoder {
+   public:
+    // Adapts the encoder for CPU reasons. Called with the lock of the
+    // controller held, so the work must be posted to the encoder's own queue.
+    virtual void AdaptDownForAdmissionControl() = 0;
+    virtual void AdaptUpForAdmissionControl() = 0;
+
+   protected:
+    virtual ~Encoder() {}
+  };
+
+  EncoderAdmissionController();
+  ~EncoderAdmissionController();
+
+  void AddEncoder(Encoder* encoder, double priority);
+  void RemoveEncoder(Encoder* encoder);
+  void SetPriority(Encoder* encoder, double priority);
+
+  // Called by an encoder that has detected CPU overuse or underuse, instead
+  // of adapting itself.
+  void OnOveruse(Encoder* source);
+  void OnUnderuse(Encoder* source);
+
+ private:
+  struct EncoderState {
+    double priority = 1.0;
+    // Number of steps down requested by this controller and not yet undone.
+    int num_adaptations = 0;
+  };
+
+  static double Weight(const EncoderState& state, int num_adaptations);
+
+  rtc::CriticalSection crit_;
+  std::map<Encoder*, EncoderState> encoders_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(EncoderAdmissionController);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENCODER_ADMISSION_CONTROLLER_H_
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/encoder_admission_controller.h"
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+class FakeEncoder : public EncoderAdmissionController::Encoder {
+ public:
+  void AdaptDownForAdmissionControl() override { ++num_adaptations; }
+  void AdaptUpForAdmissionControl() override { --num_adaptations; }
+
+  int num_adaptations = 0;
+};
+
+}  // namespace
+
+class EncoderAdmissionControllerTest : public ::testing::Test {
+ protected:
+  ~EncoderAdmissionControllerTest() override {
+    controller_.RemoveEncoder(&low_);
+    controller_.RemoveEncoder(&high_);
+  }
+
+  FakeEncoder low_;
+  FakeEncoder high_;
+  EncoderAdmissionController controller_;
+};
+
+TEST_F(EncoderAdmissionControllerTest, SingleEncoderAdaptsItself) {
+  controller_.AddEncoder(&low_, 1.0);
+  controller_.OnOveruse(&low_);
+  controller_.OnOveruse(&low_);
+  EXPECT_EQ(2, low_.num_adaptations);
+  controller_.OnUnderuse(&low_);
+  EXPECT_EQ(1, low_.num_adaptations);
+}
+
+TEST_F(EncoderAdmissionControllerTest, LowPriorityEncoderAdaptsFirst) {
+  controller_.AddEncoder(&low_, 1.0);
+  controller_.AddEncoder(&high_, 4.0);
+
+  // The high priority encoder keeps full quality until the low priority one
+  // has been adapted down twice, regardless of which one detects overuse.
+  controller_.OnOveruse(&high_);
+  controller_.OnOveruse(&high_);
+  EXPECT_EQ(2, low_.num_adaptations);
+  EXPECT_EQ(0, high_.num_adaptations);
+  controller_.OnOveruse(&high_);
+  EXPECT_EQ(2, low_.num_adaptations);
+  EXPECT_EQ(1, high_.num_adaptations);
+
+  // Underuse undoes the adaptations in reverse order.
+  controller_.OnUnderuse(&low_);
+  EXPECT_EQ(2, low_.num_adaptations);
+  EXPECT_EQ(0, high_.num_adaptations);
+  controller_.OnUnderuse(&high_);
+  EXPECT_EQ(1, low_.num_adaptations);
+  EXPECT_EQ(0, high_.num_adaptations);
+}
+
+TEST_F(EncoderAdmissionControllerTest, EqualPriorityPrefersSource) {
+  controller_.AddEncoder(&low_, 1.0);
+  controller_.AddEncoder(&high_, 1.0);
+  controller_.OnOveruse(&high_);
+  EXPECT_EQ(0, low_.num_adaptations);
+  EXPECT_EQ(1, high_.num_adaptations);
+  controller_.OnOveruse(&high_);
+  EXPECT_EQ(1, low_.num_adaptations);
+  EXPECT_EQ(1, high_.num_adaptations);
+}
+
+TEST_F(EncoderAdmissionControllerTest, PriorityChangeAppliesToNextAdaptation) {
+  controller_.AddEncoder(&low_, 1.0);
+  controller_.AddEncoder(&high_, 1.0);
+  controller_.SetPriority(&high_, 4.0);
+  controller_.OnOveruse(&high_);
+  EXPECT_EQ(1, low_.num_adaptations);
+  EXPECT_EQ(0, high_.num_adaptations);
+}
+
+TEST_F(EncoderAdmissionControllerTest, RemovedEncoderIsNotAdapted) {
+  controller_.AddEncoder(&low_, 1.0);
+  controller_.AddEncoder(&high_, 4.0);
+  controller_.RemoveEncoder(&low_);
+  controller_.OnOveruse(&high_);
+  controller_.OnOveruse(&low_);
+  EXPECT_EQ(0, low_.num_adaptations);
+  EXPECT_EQ(1, high_.num_adaptations);
+}
+
+}  // namespace webrtc
@@ -22,9 +22,11 @@
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/common_video/include/frame_callback.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/numerics/exp_filter.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/system_wrappers/include/field_trial.h"
 
 #if defined(WEBRTC_MAC) && !defined(WEBRTC_IOS)
@@ -65,6 +67,42 @@ const int kMinFramerate = 7;
 const int kMaxFramerate = 30;
 
 const auto kScaleReasonCpu = AdaptationObserverInterface::AdaptReason::kCpu;
+
+// The median usage of all OveruseFrameDetectors in the process that use
+// encode time percentiles. The detectors may run on different task queues.
+class SharedCpuBudget {
+ public:
+  static SharedCpuBudget* Get() {
+    static SharedCpuBudget* const budget = new SharedCpuBudget();
+    return budget;
+  }
+
+  void SetUsage(const OveruseFrameDetector* detector, int usage_percent) {
+    rtc::CritScope lock(&crit_);
+    usage_percent_[detector] = usage_percent;
+  }
+
+  void Remove(const OveruseFrameDetector* detector) {
+    rtc::CritScope lock(&crit_);
+    usage_percent_.erase(detector);
+  }
+
+  // Returns the total usage and sets |num_detectors| to the number of
+  // detectors that contribute to it.
+  int TotalUsage(size_t* num_detectors) const {
+    rtc::CritScope lock(&crit_);
+    int total_usage_percent = 0;
+    for (const auto& usage : usage_percent_)
+      total_usage_percent += usage.second;
+    *num_detectors = usage_percent_.size();
+    return total_usage_percent;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  std::map<const OveruseFrameDetector*, int> usage_percent_ GUARDED_BY(crit_);
+};
+
 }  // namespace
 
 CpuOveruseOptions::CpuOveruseOptions()
@@ -72,7 +110,9 @@ CpuOveruseOptions::CpuOveruseOptions()
       frame_timeout_interval_ms(1500),
       min_frame_samples(120),
       min_process_count(3),
-      high_threshold_consecutive_count(2) {
+      high_threshold_consecutive_count(2),
+      use_encode_time_percentiles(
+          field_trial::IsEnabled("WebRTC-CpuOveruse-EncodeTimePercentiles")) {
 #if defined(WEBRTC_MAC) && !defined(WEBRTC_IOS)
   // This is proof-of-concept code for letting the physical core count affect
   // the interval into which we attempt to scale. For now, the code is Mac OS
@@ -114,6 +154,9 @@ CpuOveruseOptions::CpuOveruseOptions()
   // scaling up or down does not jump all the way across the interval.
   low_encode_usage_threshold_percent =
       (high_encode_usage_threshold_percent - 1) / 2;
+
+  cpu_budget_percent =
+      high_encode_usage_threshold_percent * CpuInfo::DetectNumberOfCores();
 }
 
 // Class for calculating the processing usage on the send-side (the average
@@ -353,12 +396,15 @@ OveruseFrameDetector::OveruseFrameDetector(
       last_rampup_time_ms_(-1),
       in_quick_rampup_(false),
       current_rampup_delay_ms_(kStandardRampUpDelayMs),
-      usage_(CreateSendProcessingUsage(options)) {
+      usage_(CreateSendProcessingUsage(options)),
+      encode_time_p50_(0.5f),
+      encode_time_p95_(0.95f) {
   task_checker_.Detach();
 }
 
 OveruseFrameDetector::~OveruseFrameDetector() {
   RTC_DCHECK(!check_overuse_task_) << "StopCheckForOverUse must be called.";
+  SharedCpuBudget::Get()->Remove(this);
 }
 
 void OveruseFrameDetector::StartCheckForOveruse() {
@@ -381,6 +427,28 @@ void OveruseFrameDetector::EncodedFrameTimeMeasured(int encode_duration_ms) {
   metrics_observer_->OnEncodedFrameTimeMeasured(encode_duration_ms, *metrics_);
 }
 
+void OveruseFrameDetector::AddEncodeTimeSample(int64_t encode_duration_us) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
+  encode_times_us_.push_back(encode_duration_us);
+  encode_time_p50_.Insert(encode_duration_us);
+  encode_time_p95_.Insert(encode_duration_us);
+  while (encode_times_us_.size() >
+         static_cast<size_t>(std::max(1, options_.min_frame_samples))) {
+    encode_time_p50_.Erase(encode_times_us_.front());
+    encode_time_p95_.Erase(encode_times_us_.front());
+    encode_times_us_.pop_front();
+  }
+}
+
+int OveruseFrameDetector::EncodeTimePercentile(
+    const PercentileFilter<int64_t>& filter) const {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
+  const int64_t frame_interval_us =
+      rtc::kNumMicrosecsPerSec / std::max(kMinFramerate, max_framerate_);
+  return static_cast<int>(100 * filter.GetPercentileValue() /
+                          frame_interval_us);
+}
+
 bool OveruseFrameDetector::FrameSizeChanged(int num_pixels) const {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
   if (num_pixels != num_pixels_) {
@@ -408,6 +476,12 @@ void OveruseFrameDetector::ResetAll(int num_pixels) {
   last_processed_capture_time_us_ = -1;
   num_process_times_ = 0;
   metrics_ = rtc::Optional<CpuOveruseMetrics>();
+  while (!encode_times_us_.empty()) {
+    encode_time_p50_.Erase(encode_times_us_.front());
+    encode_time_p95_.Erase(encode_times_us_.front());
+    encode_times_us_.pop_front();
+  }
+  SharedCpuBudget::Get()->Remove(this);
   OnTargetFramerateUpdated(max_framerate_);
 }
 
@@ -480,6 +554,8 @@ void OveruseFrameDetector::FrameSent(uint32_t timestamp,
         usage_->AddSample(1e-3 * encode_duration_us, 1e-3 * diff_us);
       }
       last_processed_capture_time_us_ = timing.capture_us;
+      if (options_.use_encode_time_percentiles)
+        AddEncodeTimeSample(encode_duration_us);
       EncodedFrameTimeMeasured(encode_duration_us /
                                rtc::kNumMicrosecsPerMillisec);
     }
@@ -492,6 +568,14 @@ void OveruseFrameDetector::CheckForOveruse() {
   ++num_process_times_;
   if (num_process_times_ <= options_.min_process_count || !metrics_)
     return;
+  if (options_.use_encode_time_percentiles) {
+    if (encode_times_us_.size() <
+        static_cast<size_t>(options_.min_frame_samples)) {
+      return;
+    }
+    SharedCpuBudget::Get()->SetUsage(this,
+                                     EncodeTimePercentile(encode_time_p50_));
+  }
 
   int64_t now_ms = rtc::TimeMillis();
 
@@ -540,8 +624,23 @@ void OveruseFrameDetector::CheckForOveruse() {
 bool OveruseFrameDetector::IsOverusing(const CpuOveruseMetrics& metrics) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
 
-  if (metrics.encode_usage_percent >=
-      options_.high_encode_usage_threshold_percent) {
+  bool above_threshold = metrics.encode_usage_percent >=
+                         options_.high_encode_usage_threshold_percent;
+  if (options_.use_encode_time_percentiles) {
+    // Slow frames predict dropped frames before the average gets there.
+    above_threshold = EncodeTimePercentile(encode_time_p95_) >=
+                      options_.high_encode_usage_threshold_percent;
+    size_t num_detectors;
+    const int total_usage_percent =
+        SharedCpuBudget::Get()->TotalUsage(&num_detectors);
+    if (total_usage_percent > options_.cpu_budget_percent &&
+        EncodeTimePercentile(encode_time_p50_) *
+                static_cast<int>(num_detectors) >=
+            total_usage_percent) {
+      above_threshold = true;
+    }
+  }
+  if (above_threshold) {
     ++checks_above_threshold_;
   } else {
     checks_above_threshold_ = 0;
@@ -556,6 +655,17 @@ bool OveruseFrameDetector::IsUnderusing(const CpuOveruseMetrics& metrics,
   if (time_now < last_rampup_time_ms_ + delay)
     return false;
 
+  if (options_.use_encode_time_percentiles) {
+    const int usage_percent = EncodeTimePercentile(encode_time_p50_);
+    size_t num_detectors;
+    const int total_usage_percent =
+        SharedCpuBudget::Get()->TotalUsage(&num_detectors);
+    // Adapting up about doubles the number of pixels, and the usage with it.
+    return usage_percent < options_.low_encode_usage_threshold_percent &&
+           EncodeTimePercentile(encode_time_p95_) <
+               options_.high_encode_usage_threshold_percent &&
+           total_usage_percent + usage_percent <= options_.cpu_budget_percent;
+  }
   return metrics.encode_usage_percent <
          options_.low_encode_usage_threshold_percent;
 }
@@ -11,12 +11,14 @@
 #ifndef WEBRTC_VIDEO_OVERUSE_FRAME_DETECTOR_H_
 #define WEBRTC_VIDEO_OVERUSE_FRAME_DETECTOR_H_
 
+#include <deque>
 #include <list>
 #include <memory>
 
 #include "webrtc/modules/video_coding/utility/quality_scaler.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/numerics/exp_filter.h"
+#include "webrtc/rtc_base/numerics/percentile_filter.h"
 #include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/sequenced_task_checker.h"
 #include "webrtc/rtc_base/task_queue.h"
@@ -41,6 +43,15 @@ struct CpuOveruseOptions {
   int high_threshold_consecutive_count;  // The number of consecutive checks
                                          // above the high threshold before
                                          // triggering an overuse.
+  // If true, overuse is detected when the 95th percentile of the encode times
+  // of the last |min_frame_samples| frames is above the high threshold, in
+  // percent of the frame interval, and underuse when the median is below the
+  // low threshold. Otherwise the smoothed usage is compared to the thresholds.
+  bool use_encode_time_percentiles;
+  // Total median usage of all detectors in the process that use encode time
+  // percentiles, in percent of one core. Above it, the detectors using at
+  // least their fair share adapt down, and none adapt up beyond it.
+  int cpu_budget_percent;
 };
 
 struct CpuOveruseMetrics {
@@ -113,6 +124,10 @@ class OveruseFrameDetector {
   bool IsOverusing(const CpuOveruseMetrics& metrics);
   bool IsUnderusing(const CpuOveruseMetrics& metrics, int64_t time_now);
 
+  // Percentile of the recent encode times in percent of the frame interval.
+  int EncodeTimePercentile(const PercentileFilter<int64_t>& filter) const;
+  void AddEncodeTimeSample(int64_t encode_duration_us);
+
   bool FrameTimeoutDetected(int64_t now) const;
   bool FrameSizeChanged(int num_pixels) const;
 
@@ -155,6 +170,12 @@ class OveruseFrameDetector {
   const std::unique_ptr<SendProcessingUsage> usage_ GUARDED_BY(task_checker_);
   std::list<FrameTiming> frame_timing_ GUARDED_BY(task_checker_);
 
+  // Encode times of the last |options_.min_frame_samples| frames, if
+  // |options_.use_encode_time_percentiles|.
+  std::deque<int64_t> encode_times_us_ GUARDED_BY(task_checker_);
+  PercentileFilter<int64_t> encode_time_p50_ GUARDED_BY(task_checker_);
+  PercentileFilter<int64_t> encode_time_p95_ GUARDED_BY(task_checker_);
+
   RTC_DISALLOW_COPY_AND_ASSIGN(OveruseFrameDetector);
 };
 
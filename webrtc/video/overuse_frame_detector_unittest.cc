@@ -9,6 +9,7 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/api/video/i420_buffer.h"
 #include "webrtc/common_video/include/video_frame.h"
@@ -110,6 +111,24 @@ class OveruseFrameDetectorTest : public ::testing::Test,
     }
   }
 
+  // Cycles through |delays_us| for the encode times of the frames.
+  void InsertAndSendFramesWithDelays(OveruseFrameDetector* detector,
+                                     int num_frames,
+                                     const std::vector<int>& delays_us) {
+    VideoFrame frame(I420Buffer::Create(kWidth, kHeight),
+                     webrtc::kVideoRotation_0, 0);
+    uint32_t timestamp = 0;
+    for (int i = 0; i < num_frames; ++i) {
+      const int delay_us = delays_us[i % delays_us.size()];
+      frame.set_timestamp(timestamp);
+      detector->FrameCaptured(frame, rtc::TimeMicros());
+      clock_.AdvanceTimeMicros(delay_us);
+      detector->FrameSent(timestamp, rtc::TimeMicros());
+      clock_.AdvanceTimeMicros(kFrameIntervalUs - delay_us);
+      timestamp += kFrameIntervalUs * 90 / 1000;
+    }
+  }
+
   void ForceUpdate(int width, int height) {
     // Insert one frame, wait a second and then put in another to force update
     // the usage. From the tests where these are used, adding another sample
@@ -480,4 +499,64 @@ TEST_F(OveruseFrameDetectorTest, LimitsMaxFrameInterval) {
   }
 }
 
+TEST_F(OveruseFrameDetectorTest, PercentilesTriggerOveruseOnSlowFrames) {
+  // One frame in ten is close to the frame interval, while the average usage
+  // is below the underuse threshold.
+  const std::vector<int> kDelaysUs = {5000, 5000, 5000, 5000, 5000,
+                                      5000, 5000, 5000, 5000, 32000};
+  options_.use_encode_time_percentiles = true;
+  options_.cpu_budget_percent = 1000;
+  ReinitializeOveruseDetector();
+  EXPECT_CALL(*(observer_.get()), AdaptUp(reason_)).Times(0);
+  EXPECT_CALL(*(observer_.get()), AdaptDown(reason_)).Times(1);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndSendFramesWithDelays(overuse_detector_.get(), 1000, kDelaysUs);
+    overuse_detector_->CheckForOveruse();
+  }
+  EXPECT_LT(UsagePercent(), options_.low_encode_usage_threshold_percent);
+}
+
+TEST_F(OveruseFrameDetectorTest, PercentilesAdaptDownWhenCpuBudgetIsExceeded) {
+  // 60% usage each, which is between the thresholds.
+  const std::vector<int> kDelaysUs = {20000};
+  options_.use_encode_time_percentiles = true;
+  options_.cpu_budget_percent = 100;
+  options_.high_threshold_consecutive_count = 1;
+  ReinitializeOveruseDetector();
+  CpuOveruseObserverImpl other_observer;
+  OveruseFrameDetectorUnderTest other_detector(options_, &other_observer,
+                                               nullptr, this);
+
+  InsertAndSendFramesWithDelays(overuse_detector_.get(), 1000, kDelaysUs);
+  InsertAndSendFramesWithDelays(&other_detector, 1000, kDelaysUs);
+  // Within the budget as long as the other detector hasn't reported.
+  EXPECT_CALL(*(observer_.get()), AdaptDown(reason_)).Times(0);
+  overuse_detector_->CheckForOveruse();
+  testing::Mock::VerifyAndClearExpectations(observer_.get());
+
+  EXPECT_CALL(*(observer_.get()), AdaptDown(reason_)).Times(1);
+  other_detector.CheckForOveruse();
+  overuse_detector_->CheckForOveruse();
+  EXPECT_EQ(1, other_observer.overuse_);
+}
+
+TEST_F(OveruseFrameDetectorTest, PercentilesCpuBudgetLimitsUnderuse) {
+  // 30% usage each, which is below the underuse threshold.
+  const std::vector<int> kDelaysUs = {10000};
+  options_.use_encode_time_percentiles = true;
+  options_.cpu_budget_percent = 80;
+  ReinitializeOveruseDetector();
+  CpuOveruseObserverImpl other_observer;
+  OveruseFrameDetectorUnderTest other_detector(options_, &other_observer,
+                                               nullptr, this);
+
+  InsertAndSendFramesWithDelays(overuse_detector_.get(), 1300, kDelaysUs);
+  InsertAndSendFramesWithDelays(&other_detector, 1300, kDelaysUs);
+  // The first to adapt up would stay within the budget, the second would not.
+  other_detector.CheckForOveruse();
+  EXPECT_EQ(1, other_observer.normaluse_);
+  EXPECT_CALL(*(observer_.get()), AdaptUp(reason_)).Times(0);
+  overuse_detector_->CheckForOveruse();
+}
+
 }  // namespace webrtc
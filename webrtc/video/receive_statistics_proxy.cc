@@ -207,6 +207,34 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
   if (delay_ms != -1)
     RTC_HISTOGRAM_COUNTS_10000("WebRTC.Video.OnewayDelayInMs", delay_ms);
 
+  if (timing_frame_stage_counters_.num_frames >= kMinRequiredSamples) {
+    TimingFrameStageDelays stage_delays = timing_frame_stage_counters_.Avg();
+    const struct {
+      const char* name;
+      int delay_ms;
+    } stages[] = {
+        {"WebRTC.Video.TimingFrames.CaptureToEncodeDelayInMs",
+         stage_delays.capture_to_encode_ms},
+        {"WebRTC.Video.TimingFrames.EncodeDelayInMs", stage_delays.encode_ms},
+        {"WebRTC.Video.TimingFrames.PacketizationDelayInMs",
+         stage_delays.packetization_ms},
+        {"WebRTC.Video.TimingFrames.PacingDelayInMs", stage_delays.pacing_ms},
+        {"WebRTC.Video.TimingFrames.NetworkDelayInMs", stage_delays.network_ms},
+        {"WebRTC.Video.TimingFrames.FrameBufferDelayInMs",
+         stage_delays.frame_buffer_ms},
+        {"WebRTC.Video.TimingFrames.DecodeDelayInMs", stage_delays.decode_ms},
+        {"WebRTC.Video.TimingFrames.RenderWaitDelayInMs",
+         stage_delays.render_wait_ms},
+    };
+    for (const auto& stage : stages) {
+      // A negative average (e.g. frames rendered late) can't be recorded.
+      if (stage.delay_ms < 0)
+        continue;
+      RTC_HISTOGRAM_COUNTS_SPARSE_10000(stage.name, stage.delay_ms);
+      LOG(LS_INFO) << stage.name << " " << stage.delay_ms;
+    }
+  }
+
   // Aggregate content_specific_stats_ by removing experiment or simulcast
   // information;
   std::map<VideoContentType, ContentSpecificStats> aggregated_stats;
@@ -501,6 +529,10 @@ VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
   stats_.interframe_delay_max_ms =
       interframe_delay_max_moving_.Max(now_ms).value_or(-1);
   stats_.timing_frame_info = timing_frame_info_counter_.Max(now_ms);
+  if (timing_frame_stage_counters_.num_frames > 0) {
+    stats_.timing_frame_stage_delays.emplace(
+        timing_frame_stage_counters_.Avg());
+  }
   stats_.content_type = last_content_type_;
   return stats_;
 }
@@ -515,6 +547,21 @@ void ReceiveStatisticsProxy::OnDecoderImplementationName(
   rtc::CritScope lock(&crit_);
   stats_.decoder_implementation_name = implementation_name;
 }
+
+void ReceiveStatisticsProxy::OnDecoderFallback(DecoderFallbackReason reason) {
+  rtc::CritScope lock(&crit_);
+  switch (reason) {
+    case DecoderFallbackReason::kInitDecode:
+      ++stats_.decoder_fallbacks_init_error;
+      break;
+    case DecoderFallbackReason::kDecode:
+      ++stats_.decoder_fallbacks_decode_error;
+      break;
+    case DecoderFallbackReason::kSlowDecoding:
+      ++stats_.decoder_fallbacks_slow_decoding;
+      break;
+  }
+}
 void ReceiveStatisticsProxy::OnIncomingRate(unsigned int framerate,
                                             unsigned int bitrate_bps) {
   rtc::CritScope lock(&crit_);
@@ -552,6 +599,12 @@ void ReceiveStatisticsProxy::OnTimingFrameInfoUpdated(
   int64_t now_ms = clock_->TimeInMilliseconds();
   rtc::CritScope lock(&crit_);
   timing_frame_info_counter_.Add(info, now_ms);
+  if (last_timing_frame_rtp_timestamp_ &&
+      *last_timing_frame_rtp_timestamp_ == info.rtp_timestamp) {
+    return;
+  }
+  last_timing_frame_rtp_timestamp_.emplace(info.rtp_timestamp);
+  timing_frame_stage_counters_.Add(info);
 }
 
 void ReceiveStatisticsProxy::RtcpPacketTypesCounterUpdated(
@@ -782,6 +835,46 @@ void ReceiveStatisticsProxy::SampleCounter::Reset() {
   max.reset();
 }
 
+void ReceiveStatisticsProxy::TimingFrameStageCounters::Add(
+    const TimingFrameInfo& info) {
+  ++num_frames;
+  capture_to_encode_counter.Add(
+      static_cast<int>(info.encode_start_ms - info.capture_time_ms));
+  encode_counter.Add(
+      static_cast<int>(info.encode_finish_ms - info.encode_start_ms));
+  packetization_counter.Add(
+      static_cast<int>(info.packetization_finish_ms - info.encode_finish_ms));
+  pacing_counter.Add(
+      static_cast<int>(info.pacer_exit_ms - info.packetization_finish_ms));
+  // Sender timestamps are negative until the sender clock is estimated, in
+  // which case they can't be compared with the receiver timestamps.
+  if (info.capture_time_ms >= 0) {
+    network_counter.Add(
+        static_cast<int>(info.receive_finish_ms - info.pacer_exit_ms));
+  }
+  frame_buffer_counter.Add(
+      static_cast<int>(info.decode_start_ms - info.receive_finish_ms));
+  decode_counter.Add(
+      static_cast<int>(info.decode_finish_ms - info.decode_start_ms));
+  render_wait_counter.Add(
+      static_cast<int>(info.render_time_ms - info.decode_finish_ms));
+}
+
+TimingFrameStageDelays ReceiveStatisticsProxy::TimingFrameStageCounters::Avg()
+    const {
+  TimingFrameStageDelays delays;
+  delays.num_frames = num_frames;
+  delays.capture_to_encode_ms = capture_to_encode_counter.Avg(1);
+  delays.encode_ms = encode_counter.Avg(1);
+  delays.packetization_ms = packetization_counter.Avg(1);
+  delays.pacing_ms = pacing_counter.Avg(1);
+  delays.network_ms = network_counter.Avg(1);
+  delays.frame_buffer_ms = frame_buffer_counter.Avg(1);
+  delays.decode_ms = decode_counter.Avg(1);
+  delays.render_wait_ms = render_wait_counter.Avg(1);
+  return delays;
+}
+
 void ReceiveStatisticsProxy::OnRttUpdate(int64_t avg_rtt_ms,
                                          int64_t max_rtt_ms) {
   rtc::CritScope lock(&crit_);
@@ -53,6 +53,7 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   void OnRenderedFrame(const VideoFrame& frame);
   void OnIncomingPayloadType(int payload_type);
   void OnDecoderImplementationName(const char* implementation_name);
+  void OnDecoderFallback(DecoderFallbackReason reason);
   void OnIncomingRate(unsigned int framerate, unsigned int bitrate_bps);
 
   void OnPreDecode(const EncodedImage& encoded_image,
@@ -113,6 +114,22 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
     SampleCounter vp8;
   };
 
+  // Time spent by timing frames in each stage of the pipeline.
+  struct TimingFrameStageCounters {
+    void Add(const TimingFrameInfo& info);
+    TimingFrameStageDelays Avg() const;
+
+    int num_frames = 0;
+    SampleCounter capture_to_encode_counter;
+    SampleCounter encode_counter;
+    SampleCounter packetization_counter;
+    SampleCounter pacing_counter;
+    SampleCounter network_counter;
+    SampleCounter frame_buffer_counter;
+    SampleCounter decode_counter;
+    SampleCounter render_wait_counter;
+  };
+
   struct ContentSpecificStats {
     void Add(const ContentSpecificStats& other);
 
@@ -181,6 +198,10 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   // called from const GetStats().
   mutable rtc::MovingMaxCounter<TimingFrameInfo> timing_frame_info_counter_
       GUARDED_BY(&crit_);
+  TimingFrameStageCounters timing_frame_stage_counters_ GUARDED_BY(&crit_);
+  // The same timing frame is reported once per decoded frame until the next
+  // one arrives, so only its first report is added to the stage counters.
+  rtc::Optional<uint32_t> last_timing_frame_rtp_timestamp_ GUARDED_BY(&crit_);
 };
 
 }  // namespace webrtc
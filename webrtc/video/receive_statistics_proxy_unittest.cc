@@ -216,6 +216,17 @@ TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsDecoderImplementationName) {
       kName, statistics_proxy_->GetStats().decoder_implementation_name.c_str());
 }
 
+TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsDecoderFallbacks) {
+  statistics_proxy_->OnDecoderFallback(DecoderFallbackReason::kInitDecode);
+  statistics_proxy_->OnDecoderFallback(DecoderFallbackReason::kDecode);
+  statistics_proxy_->OnDecoderFallback(DecoderFallbackReason::kDecode);
+  statistics_proxy_->OnDecoderFallback(DecoderFallbackReason::kSlowDecoding);
+  VideoReceiveStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(1u, stats.decoder_fallbacks_init_error);
+  EXPECT_EQ(2u, stats.decoder_fallbacks_decode_error);
+  EXPECT_EQ(1u, stats.decoder_fallbacks_slow_decoding);
+}
+
 TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsOnCompleteFrame) {
   const int kFrameSizeBytes = 1000;
   statistics_proxy_->OnCompleteFrame(true, kFrameSizeBytes,
@@ -369,6 +380,63 @@ TEST_F(ReceiveStatisticsProxyTest, RespectsReportingIntervalForTimingFrames) {
   EXPECT_FALSE(result);
 }
 
+TEST_F(ReceiveStatisticsProxyTest, ReportsAverageTimingFrameStageDelays) {
+  EXPECT_FALSE(statistics_proxy_->GetStats().timing_frame_stage_delays);
+  TimingFrameInfo info;
+  for (uint32_t i = 0; i < 2; ++i) {
+    info.rtp_timestamp = i;
+    info.capture_time_ms = 1000;
+    info.encode_start_ms = 1001;
+    info.encode_finish_ms = 1011 + 2 * i;
+    info.packetization_finish_ms = info.encode_finish_ms + 1;
+    info.pacer_exit_ms = info.packetization_finish_ms + 5;
+    info.receive_start_ms = info.pacer_exit_ms + 10;
+    info.receive_finish_ms = info.pacer_exit_ms + 30;
+    info.decode_start_ms = info.receive_finish_ms + 20;
+    info.decode_finish_ms = info.decode_start_ms + 4;
+    info.render_time_ms = info.decode_finish_ms + 8;
+    // The last timing frame is reported again for each decoded frame.
+    statistics_proxy_->OnTimingFrameInfoUpdated(info);
+    statistics_proxy_->OnTimingFrameInfoUpdated(info);
+  }
+  rtc::Optional<TimingFrameStageDelays> delays =
+      statistics_proxy_->GetStats().timing_frame_stage_delays;
+  ASSERT_TRUE(delays);
+  EXPECT_EQ(2, delays->num_frames);
+  EXPECT_EQ(1, delays->capture_to_encode_ms);
+  EXPECT_EQ(11, delays->encode_ms);
+  EXPECT_EQ(1, delays->packetization_ms);
+  EXPECT_EQ(5, delays->pacing_ms);
+  EXPECT_EQ(30, delays->network_ms);
+  EXPECT_EQ(20, delays->frame_buffer_ms);
+  EXPECT_EQ(4, delays->decode_ms);
+  EXPECT_EQ(8, delays->render_wait_ms);
+}
+
+TEST_F(ReceiveStatisticsProxyTest,
+       NoTimingFrameNetworkDelayWithoutSenderClockEstimate) {
+  TimingFrameInfo info;
+  // Sender timestamps are negative until the sender clock is estimated.
+  info.capture_time_ms = -20;
+  info.encode_start_ms = -15;
+  info.encode_finish_ms = -5;
+  info.packetization_finish_ms = -4;
+  info.pacer_exit_ms = -1;
+  info.receive_start_ms = 100;
+  info.receive_finish_ms = 110;
+  info.decode_start_ms = 120;
+  info.decode_finish_ms = 125;
+  info.render_time_ms = 130;
+  statistics_proxy_->OnTimingFrameInfoUpdated(info);
+  rtc::Optional<TimingFrameStageDelays> delays =
+      statistics_proxy_->GetStats().timing_frame_stage_delays;
+  ASSERT_TRUE(delays);
+  EXPECT_EQ(5, delays->capture_to_encode_ms);
+  EXPECT_EQ(3, delays->pacing_ms);
+  EXPECT_EQ(-1, delays->network_ms);
+  EXPECT_EQ(10, delays->frame_buffer_ms);
+}
+
 TEST_F(ReceiveStatisticsProxyTest, LifetimeHistogramIsUpdated) {
   const int64_t kTimeSec = 3;
   fake_clock_.AdvanceTimeMilliseconds(kTimeSec * 1000);
@@ -19,9 +19,16 @@
 #include "webrtc/call/call.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_payload_registry.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_receiver.h"
+#include "webrtc/modules/video_coding/include/video_coding.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/format_macros.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/event_wrapper.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/call_test.h"
 #include "webrtc/test/encoder_settings.h"
@@ -151,6 +158,19 @@ static std::string DecoderBitstreamFilename() {
 DEFINE_string(codec, "VP8", "Video codec");
 static std::string Codec() { return static_cast<std::string>(FLAGS_codec); }
 
+DEFINE_bool(simulated_time,
+            false,
+            "Replay on a simulated clock, as fast as the frames can be "
+            "decoded, and print when each frame is decoded and rendered. "
+            "RTX, RED and FEC packets are not handled in this mode.");
+static bool SimulatedTime() { return FLAGS_simulated_time; }
+
+DEFINE_bool(frame_buffer,
+            false,
+            "With --simulated_time, assemble frames with the packet buffer "
+            "and frame buffer instead of the legacy jitter buffer.");
+static bool FrameBuffer() { return FLAGS_frame_buffer; }
+
 }  // namespace flags
 
 static const uint32_t kReceiverLocalSsrc = 0x123456;
@@ -204,7 +224,225 @@ class DecoderBitstreamFileWriter : public EncodedFrameObserver {
   FILE* file_;
 };
 
+std::unique_ptr<test::RtpFileReader> CreateRtpReader() {
+  std::unique_ptr<test::RtpFileReader> rtp_reader(test::RtpFileReader::Create(
+      test::RtpFileReader::kRtpDump, flags::InputFile()));
+  if (!rtp_reader) {
+    rtp_reader.reset(test::RtpFileReader::Create(test::RtpFileReader::kPcap,
+                                                 flags::InputFile()));
+    if (!rtp_reader) {
+      fprintf(stderr,
+              "Couldn't open input file as either a rtpdump or .pcap. Note "
+              "that .pcapng is not supported.\nTrying to interpret the file as "
+              "length/packet interleaved.\n");
+      rtp_reader.reset(test::RtpFileReader::Create(
+          test::RtpFileReader::kLengthPacketInterleaved, flags::InputFile()));
+      if (!rtp_reader) {
+        fprintf(stderr,
+                "Unable to open input file with any supported format\n");
+      }
+    }
+  }
+  return rtp_reader;
+}
+
+void PrintUnknownPackets(const std::map<uint32_t, int>& unknown_packets) {
+  for (std::map<uint32_t, int>::const_iterator it = unknown_packets.begin();
+       it != unknown_packets.end();
+       ++it) {
+    fprintf(
+        stderr, "Packets for unknown ssrc '%u': %d\n", it->first, it->second);
+  }
+}
+
+// Events that never block. On a simulated clock, time only moves when the
+// replay loop advances it, so the VCM must not wait for it to pass.
+class NonBlockingEventFactory : public EventFactory {
+ public:
+  EventWrapper* CreateEvent() override { return new NonBlockingEvent(); }
+
+ private:
+  class NonBlockingEvent : public EventWrapper {
+   public:
+    bool Set() override { return true; }
+    EventTypeWrapper Wait(unsigned long max_time) override {  // NOLINT
+      return kEventTimeout;
+    }
+  };
+};
+
+// Receives the depacketized video of the replayed stream on a simulated
+// clock, and reports when the jitter buffer releases each frame.
+class SimulatedTimeReceiver : public RtpData, public VCMReceiveCallback {
+ public:
+  SimulatedTimeReceiver(Clock* clock,
+                        VideoCodingModule* vcm,
+                        rtc::VideoSinkInterface<VideoFrame>* renderer)
+      : clock_(clock), vcm_(vcm), renderer_(renderer), num_frames_(0) {}
+
+  int32_t OnReceivedPayloadData(const uint8_t* payload_data,
+                                size_t payload_size,
+                                const WebRtcRTPHeader* rtp_header) override {
+    return vcm_->IncomingPacket(payload_data, payload_size, *rtp_header);
+  }
+
+  int32_t FrameToRender(VideoFrame& video_frame,  // NOLINT
+                        rtc::Optional<uint8_t> qp,
+                        VideoContentType content_type) override {
+    const int64_t now_ms = clock_->TimeInMilliseconds();
+    // The time the frame is held back for rendering, and the delay the
+    // jitter buffer aims for, are what it decided on for this frame.
+    printf("frame %d: timestamp=%u decoded_ms=%" PRId64
+           " render_ms=%" PRId64 " render_wait_ms=%" PRId64
+           " target_delay_ms=%d qp=%d\n",
+           num_frames_, video_frame.timestamp(), now_ms,
+           video_frame.render_time_ms(),
+           video_frame.render_time_ms() - now_ms, vcm_->Delay(),
+           qp ? static_cast<int>(*qp) : -1);
+    ++num_frames_;
+    renderer_->OnFrame(video_frame);
+    return 0;
+  }
+
+  int num_frames() const { return num_frames_; }
+
+ private:
+  Clock* const clock_;
+  VideoCodingModule* const vcm_;
+  rtc::VideoSinkInterface<VideoFrame>* const renderer_;
+  int num_frames_;
+};
+
+// Replays the file through the jitter buffer and decoder on a simulated clock,
+// which is advanced in steps of 1 ms. Packets are delivered in the step of
+// their capture time, so a replay is deterministic no matter how fast it runs.
+void RtpReplayOnSimulatedClock() {
+  std::unique_ptr<test::RtpFileReader> rtp_reader = CreateRtpReader();
+  if (!rtp_reader)
+    return;
+  FileRenderPassthrough file_passthrough(flags::OutBase(), nullptr);
+
+  SimulatedClock clock(0);
+  NonBlockingEventFactory event_factory;
+  std::unique_ptr<VideoCodingModule> vcm(
+      flags::FrameBuffer()
+          ? VideoCodingModule::CreateWithFrameBuffer(&clock, &event_factory)
+          : VideoCodingModule::Create(&clock, &event_factory));
+  SimulatedTimeReceiver receiver(&clock, vcm.get(), &file_passthrough);
+
+  VideoSendStream::Config::EncoderSettings encoder_settings;
+  encoder_settings.payload_name = flags::Codec();
+  encoder_settings.payload_type = flags::PayloadType();
+  VideoReceiveStream::Decoder decoder =
+      test::CreateMatchingDecoder(encoder_settings);
+  VideoCodec codec;
+  memset(&codec, 0, sizeof(codec));
+  codec.plType = decoder.payload_type;
+  strncpy(codec.plName, decoder.payload_name.c_str(), sizeof(codec.plName));
+  codec.codecType = PayloadStringToCodecType(decoder.payload_name);
+  vcm->RegisterExternalDecoder(decoder.decoder, decoder.payload_type);
+  RTC_CHECK_EQ(VCM_OK, vcm->RegisterReceiveCodec(&codec, 1, false));
+  RTC_CHECK_EQ(VCM_OK, vcm->RegisterReceiveCallback(&receiver));
+
+  RTPPayloadRegistry payload_registry;
+  RTC_CHECK_EQ(0, payload_registry.RegisterReceivePayload(codec));
+  NullRtpFeedback rtp_feedback;
+  std::unique_ptr<RtpReceiver> rtp_receiver(RtpReceiver::CreateVideoReceiver(
+      &clock, &receiver, &rtp_feedback, &payload_registry));
+  std::unique_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
+  if (flags::TransmissionOffsetId() != -1) {
+    parser->RegisterRtpHeaderExtension(kRtpExtensionTransmissionTimeOffset,
+                                       flags::TransmissionOffsetId());
+  }
+  if (flags::AbsSendTimeId() != -1) {
+    parser->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                       flags::AbsSendTimeId());
+  }
+
+  // Frames still in the jitter buffer when the file ends get this long to be
+  // decoded.
+  const int64_t kDrainTimeMs = 1000;
+  int num_packets = 0;
+  int num_decode_errors = 0;
+  std::map<uint32_t, int> unknown_packets;
+  rtc::Optional<uint16_t> last_sequence_number;
+  int64_t decode_time_us = 0;
+  const int64_t start_time_us = rtc::TimeMicros();
+
+  test::RtpPacketView packet;
+  bool have_packet = rtp_reader->NextPacketView(&packet);
+  int64_t end_time_ms = have_packet ? packet.time_ms + kDrainTimeMs : 0;
+  while (clock.TimeInMilliseconds() < end_time_ms) {
+    while (have_packet && packet.time_ms <= clock.TimeInMilliseconds()) {
+      ++num_packets;
+      RTPHeader header;
+      if (parser->Parse(packet.data, packet.length, &header)) {
+        if (header.ssrc != flags::Ssrc()) {
+          ++unknown_packets[header.ssrc];
+        } else {
+          header.payload_type_frequency = kVideoPayloadTypeFrequency;
+          bool in_order =
+              !last_sequence_number ||
+              IsNewerSequenceNumber(header.sequenceNumber,
+                                    *last_sequence_number);
+          if (in_order) {
+            last_sequence_number =
+                rtc::Optional<uint16_t>(header.sequenceNumber);
+          }
+          PayloadUnion payload_specific;
+          if (payload_registry.GetPayloadSpecifics(header.payloadType,
+                                                   &payload_specific)) {
+            rtp_receiver->IncomingRtpPacket(
+                header, packet.data + header.headerLength,
+                packet.length - header.headerLength, payload_specific,
+                in_order);
+          }
+        }
+      }
+      have_packet = rtp_reader->NextPacketView(&packet);
+      if (have_packet)
+        end_time_ms = packet.time_ms + kDrainTimeMs;
+    }
+
+    // Decode all frames that the jitter buffer releases at this time.
+    for (;;) {
+      const int64_t decode_start_us = rtc::TimeMicros();
+      int32_t result = vcm->Decode(0);
+      if (result == VCM_FRAME_NOT_READY)
+        break;
+      decode_time_us += rtc::TimeMicros() - decode_start_us;
+      if (result != VCM_OK)
+        ++num_decode_errors;
+    }
+    if (vcm->TimeUntilNextProcess() <= 0)
+      vcm->Process();
+    clock.AdvanceTimeMilliseconds(1);
+  }
+  const int64_t replay_time_us = rtc::TimeMicros() - start_time_us;
+
+  fprintf(stderr, "num_packets: %d\n", num_packets);
+  PrintUnknownPackets(unknown_packets);
+  fprintf(stderr,
+          "Decoded %d frames (%d errors) in %" PRId64 " ms of decoding, "
+          "%.1f fps. Replayed %" PRId64 " ms of video in %" PRId64 " ms.\n",
+          receiver.num_frames(), num_decode_errors,
+          decode_time_us / rtc::kNumMicrosecsPerMillisec,
+          decode_time_us > 0
+              ? receiver.num_frames() * 1e6 / decode_time_us
+              : 0.0,
+          clock.TimeInMilliseconds(),
+          replay_time_us / rtc::kNumMicrosecsPerMillisec);
+
+  vcm.reset();
+  delete decoder.decoder;
+}
+
 void RtpReplay() {
+  if (flags::SimulatedTime()) {
+    RtpReplayOnSimulatedClock();
+    return;
+  }
+
   std::unique_ptr<test::VideoRenderer> playback_video(
       test::VideoRenderer::Create("Playback Video", 640, 480));
   FileRenderPassthrough file_passthrough(flags::OutBase(),
@@ -255,33 +493,17 @@ void RtpReplay() {
   VideoReceiveStream* receive_stream =
       call->CreateVideoReceiveStream(std::move(receive_config));
 
-  std::unique_ptr<test::RtpFileReader> rtp_reader(test::RtpFileReader::Create(
-      test::RtpFileReader::kRtpDump, flags::InputFile()));
-  if (!rtp_reader) {
-    rtp_reader.reset(test::RtpFileReader::Create(test::RtpFileReader::kPcap,
-                                                 flags::InputFile()));
-    if (!rtp_reader) {
-      fprintf(stderr,
-              "Couldn't open input file as either a rtpdump or .pcap. Note "
-              "that .pcapng is not supported.\nTrying to interpret the file as "
-              "length/packet interleaved.\n");
-      rtp_reader.reset(test::RtpFileReader::Create(
-          test::RtpFileReader::kLengthPacketInterleaved, flags::InputFile()));
-      if (!rtp_reader) {
-        fprintf(stderr,
-                "Unable to open input file with any supported format\n");
-        return;
-      }
-    }
-  }
+  std::unique_ptr<test::RtpFileReader> rtp_reader = CreateRtpReader();
+  if (!rtp_reader)
+    return;
   receive_stream->Start();
 
   uint32_t last_time_ms = 0;
   int num_packets = 0;
   std::map<uint32_t, int> unknown_packets;
   while (true) {
-    test::RtpPacket packet;
-    if (!rtp_reader->NextPacket(&packet))
+    test::RtpPacketView packet;
+    if (!rtp_reader->NextPacketView(&packet))
       break;
     ++num_packets;
     switch (call->Receiver()->DeliverPacket(
@@ -314,13 +536,7 @@ void RtpReplay() {
     last_time_ms = packet.time_ms;
   }
   fprintf(stderr, "num_packets: %d\n", num_packets);
-
-  for (std::map<uint32_t, int>::const_iterator it = unknown_packets.begin();
-       it != unknown_packets.end();
-       ++it) {
-    fprintf(
-        stderr, "Packets for unknown ssrc '%u': %d\n", it->first, it->second);
-  }
+  PrintUnknownPackets(unknown_packets);
 
   call->DestroyVideoReceiveStream(receive_stream);
 
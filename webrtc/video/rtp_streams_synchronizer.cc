@@ -20,15 +20,15 @@
 namespace webrtc {
 namespace {
 bool UpdateMeasurements(StreamSynchronization::Measurements* stream,
-                        const Syncable::Info& info) {
+                        const Syncable::Info& info,
+                        bool* new_rtcp_sr) {
   RTC_DCHECK(stream);
   stream->latest_timestamp = info.latest_received_capture_timestamp;
   stream->latest_receive_time_ms = info.latest_receive_time_ms;
-  bool new_rtcp_sr = false;
   if (!stream->rtp_to_ntp.UpdateMeasurements(info.capture_time_ntp_secs,
                                              info.capture_time_ntp_frac,
                                              info.capture_time_source_clock,
-                                             &new_rtcp_sr)) {
+                                             new_rtcp_sr)) {
     return false;
   }
   return true;
@@ -39,6 +39,7 @@ RtpStreamsSynchronizer::RtpStreamsSynchronizer(Syncable* syncable_video)
     : syncable_video_(syncable_video),
       syncable_audio_(nullptr),
       sync_(),
+      new_rtcp_sr_(false),
       last_sync_time_(rtc::TimeNanos()) {
   RTC_DCHECK(syncable_video);
   process_thread_checker_.DetachFromThread();
@@ -76,28 +77,40 @@ void RtpStreamsSynchronizer::Process() {
   }
   RTC_DCHECK(sync_.get());
 
+  bool new_audio_rtcp_sr = false;
   rtc::Optional<Syncable::Info> audio_info = syncable_audio_->GetInfo();
-  if (!audio_info || !UpdateMeasurements(&audio_measurement_, *audio_info)) {
+  if (!audio_info || !UpdateMeasurements(&audio_measurement_, *audio_info,
+                                         &new_audio_rtcp_sr)) {
     return;
   }
 
+  bool new_video_rtcp_sr = false;
   int64_t last_video_receive_ms = video_measurement_.latest_receive_time_ms;
   rtc::Optional<Syncable::Info> video_info = syncable_video_->GetInfo();
-  if (!video_info || !UpdateMeasurements(&video_measurement_, *video_info)) {
+  if (!video_info || !UpdateMeasurements(&video_measurement_, *video_info,
+                                         &new_video_rtcp_sr)) {
     return;
   }
+  new_rtcp_sr_ |= new_audio_rtcp_sr || new_video_rtcp_sr;
 
   if (last_video_receive_ms == video_measurement_.latest_receive_time_ms) {
     // No new video packet has been received since last update.
     return;
   }
 
+  if (!new_rtcp_sr_) {
+    // The delays are only updated as RTCP SR reports update the mapping of the
+    // streams to NTP time, which senders do about every second for video.
+    return;
+  }
+
   int relative_delay_ms;
   // Calculate how much later or earlier the audio stream is compared to video.
   if (!sync_->ComputeRelativeDelay(audio_measurement_, video_measurement_,
                                    &relative_delay_ms)) {
     return;
   }
+  new_rtcp_sr_ = false;
 
   TRACE_COUNTER1("webrtc", "SyncCurrentVideoDelay",
       video_info->current_delay_ms);
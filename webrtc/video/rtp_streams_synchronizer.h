@@ -56,6 +56,9 @@ class RtpStreamsSynchronizer : public Module {
   std::unique_ptr<StreamSynchronization> sync_ GUARDED_BY(crit_);
   StreamSynchronization::Measurements audio_measurement_ GUARDED_BY(crit_);
   StreamSynchronization::Measurements video_measurement_ GUARDED_BY(crit_);
+  // Set when a new RTCP SR report has been received for either stream since
+  // the delays were last updated.
+  bool new_rtcp_sr_ GUARDED_BY(crit_);
 
   rtc::ThreadChecker process_thread_checker_;
   int64_t last_sync_time_ ACCESS_ON(&process_thread_checker_);
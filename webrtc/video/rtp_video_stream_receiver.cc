@@ -21,7 +21,6 @@
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 #include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_cvo.h"
-#include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_receiver.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp.h"
 #include "webrtc/modules/rtp_rtcp/include/ulpfec_receiver.h"
@@ -47,6 +46,16 @@ namespace {
 //                 crbug.com/752886
 constexpr int kPacketBufferStartSize = 512;
 constexpr int kPacketBufferMaxSixe = 2048;
+// Start size used by the compact receive mode. The packet buffer grows on
+// demand, so receivers that are memory constrained, e.g. with many streams per
+// process, can start small and only pay for the capacity their bitrate needs.
+constexpr int kCompactPacketBufferStartSize = 32;
+
+int PacketBufferStartSize() {
+  return field_trial::IsEnabled("WebRTC-Video-CompactPacketBuffer")
+             ? kCompactPacketBufferStartSize
+             : kPacketBufferStartSize;
+}
 }
 
 std::unique_ptr<RtpRtcp> CreateRtpRtcpModule(
@@ -97,7 +106,6 @@ RtpVideoStreamReceiver::RtpVideoStreamReceiver(
       packet_router_(packet_router),
       process_thread_(process_thread),
       ntp_estimator_(clock_),
-      rtp_header_parser_(RtpHeaderParser::Create()),
       rtp_receiver_(RtpReceiver::CreateVideoReceiver(clock_,
                                                      this,
                                                      this,
@@ -190,7 +198,9 @@ RtpVideoStreamReceiver::RtpVideoStreamReceiver(
   }
 
   packet_buffer_ = video_coding::PacketBuffer::Create(
-      clock_, kPacketBufferStartSize, kPacketBufferMaxSixe, this);
+      clock_, PacketBufferStartSize(), kPacketBufferMaxSixe, this);
+  // The bitstream is assembled by VideoReceiveStream right before decoding.
+  packet_buffer_->SetDeferBitstreamCopy(true);
   reference_finder_.reset(new video_coding::RtpFrameReferenceFinder(this));
 }
 
@@ -290,10 +300,14 @@ int32_t RtpVideoStreamReceiver::OnReceivedPayloadData(
 // for callbacks from |ulpfec_receiver_|.
 void RtpVideoStreamReceiver::OnRecoveredPacket(const uint8_t* rtp_packet,
                                                size_t rtp_packet_length) {
-  RTPHeader header;
-  if (!rtp_header_parser_->Parse(rtp_packet, rtp_packet_length, &header)) {
+  // Parsed the same way as packets passed to OnRtpPacket, so that the header
+  // is only parsed once.
+  RtpPacketReceived packet(&rtp_header_extensions_);
+  if (!packet.Parse(rtp_packet, rtp_packet_length)) {
     return;
   }
+  RTPHeader header;
+  packet.GetHeader(&header);
   header.payload_type_frequency = kVideoPayloadTypeFrequency;
   bool in_order = IsPacketInOrder(header);
   ReceivePacket(rtp_packet, rtp_packet_length, header, in_order);
@@ -432,6 +446,10 @@ rtc::Optional<int64_t> RtpVideoStreamReceiver::LastReceivedPacketMs() const {
   return packet_buffer_->LastReceivedPacketMs();
 }
 
+size_t RtpVideoStreamReceiver::PacketBufferMemoryUsageBytes() const {
+  return packet_buffer_->MemoryUsageBytes();
+}
+
 rtc::Optional<int64_t> RtpVideoStreamReceiver::LastReceivedKeyframePacketMs()
     const {
   return packet_buffer_->LastReceivedKeyframePacketMs();
@@ -466,9 +484,15 @@ void RtpVideoStreamReceiver::ReceivePacket(const uint8_t* packet,
     ParseAndHandleEncapsulatingHeader(packet, packet_length, header);
     return;
   }
-  const uint8_t* payload = packet + header.headerLength;
   assert(packet_length >= header.headerLength);
-  size_t payload_length = packet_length - header.headerLength;
+  ReceivePayload(header, packet + header.headerLength,
+                 packet_length - header.headerLength, in_order);
+}
+
+void RtpVideoStreamReceiver::ReceivePayload(const RTPHeader& header,
+                                            const uint8_t* payload,
+                                            size_t payload_length,
+                                            bool in_order) {
   PayloadUnion payload_specific;
   if (!rtp_payload_registry_.GetPayloadSpecifics(header.payloadType,
                                                  &payload_specific)) {
@@ -489,10 +513,23 @@ void RtpVideoStreamReceiver::ParseAndHandleEncapsulatingHeader(
       // packets.
       NotifyReceiverOfFecPacket(header);
     }
-    if (ulpfec_receiver_->AddReceivedRedPacket(header, packet, packet_length,
-                                               ulpfec_pt) != 0) {
+    // The media is passed on from within the RED packet, rather than copied
+    // without the RED header and parsed again.
+    RTPHeader media_header;
+    rtc::ArrayView<const uint8_t> media_payload;
+    if (ulpfec_receiver_->AddReceivedRedPacketInPlace(
+            header, packet, packet_length, ulpfec_pt, &media_header,
+            &media_payload) != 0) {
       return;
     }
+    if (!media_payload.empty()) {
+      if (rtp_payload_registry_.IsEncapsulated(media_header)) {
+        LOG(LS_WARNING) << "Encapsulated media in RED packet; dropping.";
+      } else {
+        ReceivePayload(media_header, media_payload.data(),
+                       media_payload.size(), IsPacketInOrder(media_header));
+      }
+    }
     ulpfec_receiver_->ProcessReceivedFec();
   } else if (rtp_payload_registry_.IsRtx(header)) {
     if (header.headerLength + header.paddingLength == packet_length) {
@@ -688,8 +725,8 @@ void RtpVideoStreamReceiver::EnableReceiveRtpHeaderExtension(
   RTC_DCHECK_GE(id, 1);
   RTC_DCHECK_LE(id, 14);
   RTC_DCHECK(RtpExtension::IsSupportedForVideo(extension));
-  RTC_CHECK(rtp_header_parser_->RegisterRtpHeaderExtension(
-      StringToRtpExtensionType(extension), id));
+  RTC_CHECK(rtp_header_extensions_.RegisterByType(
+      id, StringToRtpExtensionType(extension)));
 }
 
 void RtpVideoStreamReceiver::InsertSpsPpsIntoTracker(uint8_t payload_type) {
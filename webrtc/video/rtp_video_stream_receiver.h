@@ -22,6 +22,7 @@
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
 #include "webrtc/modules/rtp_rtcp/include/remote_ntp_time_estimator.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_payload_registry.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -45,7 +46,6 @@ class ReceiveStatistics;
 class ReceiveStatisticsProxy;
 class RemoteNtpTimeEstimator;
 class RtcpRttStats;
-class RtpHeaderParser;
 class RtpPacketReceived;
 class RTPPayloadRegistry;
 class RtpReceiver;
@@ -142,6 +142,7 @@ class RtpVideoStreamReceiver : public RtpData,
 
   rtc::Optional<int64_t> LastReceivedPacketMs() const;
   rtc::Optional<int64_t> LastReceivedKeyframePacketMs() const;
+  size_t PacketBufferMemoryUsageBytes() const;
 
   // RtpDemuxer only forwards a given RTP packet to one sink. However, some
   // sinks, such as FlexFEC, might wish to be informed of all of the packets
@@ -156,6 +157,10 @@ class RtpVideoStreamReceiver : public RtpData,
                      size_t packet_length,
                      const RTPHeader& header,
                      bool in_order);
+  void ReceivePayload(const RTPHeader& header,
+                      const uint8_t* payload,
+                      size_t payload_length,
+                      bool in_order);
   // Parses and handles for instance RTX and RED headers.
   // This function assumes that it's being called from only one thread.
   void ParseAndHandleEncapsulatingHeader(const uint8_t* packet,
@@ -178,7 +183,7 @@ class RtpVideoStreamReceiver : public RtpData,
   RemoteNtpTimeEstimator ntp_estimator_;
   RTPPayloadRegistry rtp_payload_registry_;
 
-  const std::unique_ptr<RtpHeaderParser> rtp_header_parser_;
+  RtpHeaderExtensionMap rtp_header_extensions_;
   const std::unique_ptr<RtpReceiver> rtp_receiver_;
   const std::unique_ptr<ReceiveStatistics> rtp_receive_statistics_;
   std::unique_ptr<UlpfecReceiver> ulpfec_receiver_;
@@ -215,6 +215,21 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
                                encode_ms);
     LOG(LS_INFO) << uma_prefix_ << "EncodeTimeInMs " << encode_ms;
   }
+  int packetizer_queue_ms =
+      packetizer_queue_time_counter_.Avg(kMinRequiredMetricsSamples);
+  if (packetizer_queue_ms != -1) {
+    RTC_HISTOGRAMS_COUNTS_1000(kIndex,
+                               uma_prefix_ + "PacketizerQueueTimeInMs",
+                               packetizer_queue_ms);
+    LOG(LS_INFO) << uma_prefix_ << "PacketizerQueueTimeInMs "
+                 << packetizer_queue_ms;
+  }
+  int packetize_ms = packetize_time_counter_.Avg(kMinRequiredMetricsSamples);
+  if (packetize_ms != -1) {
+    RTC_HISTOGRAMS_COUNTS_1000(kIndex, uma_prefix_ + "PacketizeTimeInMs",
+                               packetize_ms);
+    LOG(LS_INFO) << uma_prefix_ << "PacketizeTimeInMs " << packetize_ms;
+  }
   int key_frames_permille =
       key_frame_counter_.Permille(kMinRequiredMetricsSamples);
   if (key_frames_permille != -1) {
@@ -499,6 +514,13 @@ void SendStatisticsProxy::OnEncodedFrameTimeMeasured(
   stats_.encode_usage_percent = metrics.encode_usage_percent;
 }
 
+void SendStatisticsProxy::OnPacketizationTimeMeasured(int queue_time_ms,
+                                                      int packetize_time_ms) {
+  rtc::CritScope lock(&crit_);
+  uma_container_->packetizer_queue_time_counter_.Add(queue_time_ms);
+  uma_container_->packetize_time_counter_.Add(packetize_time_ms);
+}
+
 void SendStatisticsProxy::OnSuspendChange(bool is_suspended) {
   int64_t now_ms = clock_->TimeInMilliseconds();
   rtc::CritScope lock(&crit_);
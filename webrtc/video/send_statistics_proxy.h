@@ -84,6 +84,11 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   void OnEncodedFrameTimeMeasured(int encode_time_ms,
                                   const CpuOveruseMetrics& metrics) override;
 
+  // Used when encoded images are packetized on a separate task queue. Takes
+  // the time an image waited for the packetizer and the time it took to
+  // packetize it.
+  void OnPacketizationTimeMeasured(int queue_time_ms, int packetize_time_ms);
+
   int GetSendFrameRate() const;
 
  protected:
@@ -210,6 +215,8 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
     SampleCounter sent_width_counter_;
     SampleCounter sent_height_counter_;
     SampleCounter encode_time_counter_;
+    SampleCounter packetizer_queue_time_counter_;
+    SampleCounter packetize_time_counter_;
     BoolSampleCounter key_frame_counter_;
     BoolSampleCounter quality_limited_frame_counter_;
     SampleCounter quality_downscales_counter_;
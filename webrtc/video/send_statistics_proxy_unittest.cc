@@ -324,6 +324,22 @@ TEST_F(SendStatisticsProxyTest, OnEncodedFrameTimeMeasured) {
   EXPECT_EQ(metrics.encode_usage_percent, stats.encode_usage_percent);
 }
 
+TEST_F(SendStatisticsProxyTest, PacketizationTimeHistogramsAreUpdated) {
+  const int kQueueTimeMs = 3;
+  const int kPacketizeTimeMs = 5;
+  for (int i = 0; i < SendStatisticsProxy::kMinRequiredMetricsSamples; ++i)
+    statistics_proxy_->OnPacketizationTimeMeasured(kQueueTimeMs,
+                                                   kPacketizeTimeMs);
+
+  statistics_proxy_.reset();
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.PacketizerQueueTimeInMs"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.PacketizerQueueTimeInMs",
+                                  kQueueTimeMs));
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.PacketizeTimeInMs"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.PacketizeTimeInMs",
+                                  kPacketizeTimeMs));
+}
+
 TEST_F(SendStatisticsProxyTest, OnEncoderReconfiguredChangePreferredBitrate) {
   VideoSendStream::Stats stats = statistics_proxy_->GetStats();
   EXPECT_EQ(0, stats.preferred_media_bitrate_bps);
@@ -12,6 +12,7 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <utility>
@@ -70,6 +71,10 @@ VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
 }  // namespace
 
 namespace internal {
+namespace {
+constexpr int kMaxWaitForFrameMs = 3000;
+constexpr int kMaxWaitForKeyFrameMs = 200;
+}  // namespace
 
 VideoReceiveStream::VideoReceiveStream(
     RtpStreamReceiverControllerInterface* receiver_controller,
@@ -77,7 +82,8 @@ VideoReceiveStream::VideoReceiveStream(
     PacketRouter* packet_router,
     VideoReceiveStream::Config config,
     ProcessThread* process_thread,
-    CallStats* call_stats)
+    CallStats* call_stats,
+    DecodeScheduler* decode_scheduler)
     : transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
       num_cpu_cores_(num_cpu_cores),
@@ -87,6 +93,7 @@ VideoReceiveStream::VideoReceiveStream(
                      this,
                      "DecodingThread",
                      rtc::kHighestPriority),
+      decode_scheduler_(decode_scheduler),
       call_stats_(call_stats),
       timing_(new VCMTiming(clock_)),
       video_receiver_(clock_, nullptr, this, timing_.get(), this, this),
@@ -125,6 +132,8 @@ VideoReceiveStream::VideoReceiveStream(
   jitter_estimator_.reset(new VCMJitterEstimator(clock_));
   frame_buffer_.reset(new video_coding::FrameBuffer(
       clock_, jitter_estimator_.get(), timing_.get(), &stats_proxy_));
+  frame_buffer_->SetMaxDecodeFramerate(config_.max_decode_framerate);
+  frame_buffer_->SetMaxDecodePixels(config_.max_decode_pixels);
 
   process_thread_->RegisterModule(&rtp_stream_sync_, RTC_FROM_HERE);
 
@@ -161,7 +170,7 @@ void VideoReceiveStream::SetSync(Syncable* audio_syncable) {
 
 void VideoReceiveStream::Start() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
-  if (decode_thread_.IsRunning())
+  if (decode_thread_.IsRunning() || scheduled_)
     return;
 
   bool protected_by_fec = config_.rtp.protected_by_flexfec ||
@@ -208,8 +217,14 @@ void VideoReceiveStream::Start() {
 
   process_thread_->RegisterModule(&video_receiver_, RTC_FROM_HERE);
 
-  // Start the decode thread
-  decode_thread_.Start();
+  // Start the decode thread, or have the shared decode threads run the stream.
+  if (decode_scheduler_) {
+    last_decode_progress_ms_ = clock_->TimeInMilliseconds();
+    decode_scheduler_->AddStream(this);
+    scheduled_ = true;
+  } else {
+    decode_thread_.Start();
+  }
   rtp_video_stream_receiver_.StartReceive();
 }
 
@@ -234,6 +249,13 @@ void VideoReceiveStream::Stop() {
     // running.
     for (const Decoder& decoder : config_.decoders)
       video_receiver_.RegisterExternalDecoder(nullptr, decoder.payload_type);
+  } else if (scheduled_) {
+    // Waits for the stream to return if it is decoding.
+    decode_scheduler_->RemoveStream(this);
+    scheduled_ = false;
+    for (const Decoder& decoder : config_.decoders)
+      video_receiver_.RegisterExternalDecoder(nullptr, decoder.payload_type);
+    video_receiver_.DecodingStopped();
   }
 
   call_stats_->DeregisterStatsObserver(video_stream_decoder_.get());
@@ -243,7 +265,10 @@ void VideoReceiveStream::Stop() {
 }
 
 VideoReceiveStream::Stats VideoReceiveStream::GetStats() const {
-  return stats_proxy_.GetStats();
+  Stats stats = stats_proxy_.GetStats();
+  stats.packet_buffer_bytes =
+      rtp_video_stream_receiver_.PacketBufferMemoryUsageBytes();
+  return stats;
 }
 
 void VideoReceiveStream::EnableEncodedFrameRecording(rtc::PlatformFile file,
@@ -338,6 +363,8 @@ void VideoReceiveStream::OnCompleteFrame(
   int last_continuous_pid = frame_buffer_->InsertFrame(std::move(frame));
   if (last_continuous_pid != -1)
     rtp_video_stream_receiver_.FrameContinuous(last_continuous_pid);
+  if (decode_scheduler_)
+    decode_scheduler_->WakeUp(this);
 }
 
 int VideoReceiveStream::id() const {
@@ -387,9 +414,6 @@ void VideoReceiveStream::DecodeThreadFunction(void* ptr) {
 
 bool VideoReceiveStream::Decode() {
   TRACE_EVENT0("webrtc", "VideoReceiveStream::Decode");
-  static const int kMaxWaitForFrameMs = 3000;
-  static const int kMaxWaitForKeyFrameMs = 200;
-
   int wait_ms = keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
   std::unique_ptr<video_coding::FrameObject> frame;
   // TODO(philipel): Call NextFrame with |keyframe_required| argument when
@@ -404,43 +428,85 @@ bool VideoReceiveStream::Decode() {
 
   if (frame) {
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kFrameFound);
-    if (video_receiver_.Decode(frame.get()) == VCM_OK) {
-      keyframe_required_ = false;
-      frame_decoded_ = true;
-      rtp_video_stream_receiver_.FrameDecoded(frame->picture_id);
-    } else if (!keyframe_required_ || !frame_decoded_) {
-      keyframe_required_ = true;
-      // TODO(philipel): Remove this keyframe request when downstream project
-      //                 has been fixed.
-      RequestKeyFrame();
-    }
+    DecodeFrame(std::move(frame));
   } else {
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kTimeout);
-    int64_t now_ms = clock_->TimeInMilliseconds();
-    rtc::Optional<int64_t> last_packet_ms =
-        rtp_video_stream_receiver_.LastReceivedPacketMs();
-    rtc::Optional<int64_t> last_keyframe_packet_ms =
-        rtp_video_stream_receiver_.LastReceivedKeyframePacketMs();
-
-    // To avoid spamming keyframe requests for a stream that is not active we
-    // check if we have received a packet within the last 5 seconds.
-    bool stream_is_active = last_packet_ms && now_ms - *last_packet_ms < 5000;
-    if (!stream_is_active)
-      stats_proxy_.OnStreamInactive();
-
-    // If we recently have been receiving packets belonging to a keyframe then
-    // we assume a keyframe is currently being received.
-    bool receiving_keyframe =
-        last_keyframe_packet_ms &&
-        now_ms - *last_keyframe_packet_ms < kMaxWaitForKeyFrameMs;
-
-    if (stream_is_active && !receiving_keyframe) {
-      LOG(LS_WARNING) << "No decodable frame in " << wait_ms
-                      << " ms, requesting keyframe.";
-      RequestKeyFrame();
-    }
+    HandleNoDecodableFrame(wait_ms);
   }
   return true;
 }
+
+int64_t VideoReceiveStream::DecodeNextFrame() {
+  TRACE_EVENT0("webrtc", "VideoReceiveStream::DecodeNextFrame");
+  std::unique_ptr<video_coding::FrameObject> frame;
+  int64_t frame_wait_ms;
+  video_coding::FrameBuffer::ReturnReason res =
+      frame_buffer_->NextFrameIfDue(&frame, &frame_wait_ms);
+  if (res == video_coding::FrameBuffer::ReturnReason::kStopped)
+    return -1;
+
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  if (frame) {
+    RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kFrameFound);
+    DecodeFrame(std::move(frame));
+    last_decode_progress_ms_ = now_ms;
+    // More frames may be due already.
+    return 0;
+  }
+
+  // Same timeouts as when waiting for frames on the stream's own thread.
+  int max_wait_ms =
+      keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
+  int64_t timeout_ms = last_decode_progress_ms_ + max_wait_ms - now_ms;
+  if (timeout_ms <= 0) {
+    HandleNoDecodableFrame(max_wait_ms);
+    last_decode_progress_ms_ = now_ms;
+    timeout_ms = max_wait_ms;
+  }
+  return frame_wait_ms < 0 ? timeout_ms : std::min(frame_wait_ms, timeout_ms);
+}
+
+void VideoReceiveStream::DecodeFrame(
+    std::unique_ptr<video_coding::FrameObject> frame) {
+  // The frame's bitstream is only copied out of the packet buffer here, so
+  // that frames dropped by |frame_buffer_| are never copied.
+  if (frame->AssembleBitstream() &&
+      video_receiver_.Decode(frame.get()) == VCM_OK) {
+    keyframe_required_ = false;
+    frame_decoded_ = true;
+    rtp_video_stream_receiver_.FrameDecoded(frame->picture_id);
+  } else if (!keyframe_required_ || !frame_decoded_) {
+    keyframe_required_ = true;
+    // TODO(philipel): Remove this keyframe request when downstream project
+    //                 has been fixed.
+    RequestKeyFrame();
+  }
+}
+
+void VideoReceiveStream::HandleNoDecodableFrame(int max_wait_ms) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  rtc::Optional<int64_t> last_packet_ms =
+      rtp_video_stream_receiver_.LastReceivedPacketMs();
+  rtc::Optional<int64_t> last_keyframe_packet_ms =
+      rtp_video_stream_receiver_.LastReceivedKeyframePacketMs();
+
+  // To avoid spamming keyframe requests for a stream that is not active we
+  // check if we have received a packet within the last 5 seconds.
+  bool stream_is_active = last_packet_ms && now_ms - *last_packet_ms < 5000;
+  if (!stream_is_active)
+    stats_proxy_.OnStreamInactive();
+
+  // If we recently have been receiving packets belonging to a keyframe then
+  // we assume a keyframe is currently being received.
+  bool receiving_keyframe =
+      last_keyframe_packet_ms &&
+      now_ms - *last_keyframe_packet_ms < kMaxWaitForKeyFrameMs;
+
+  if (stream_is_active && !receiving_keyframe) {
+    LOG(LS_WARNING) << "No decodable frame in " << max_wait_ms
+                    << " ms, requesting keyframe.";
+    RequestKeyFrame();
+  }
+}
 }  // namespace internal
 }  // namespace webrtc
@@ -24,6 +24,7 @@
 #include "webrtc/modules/video_coding/video_coding_impl.h"
 #include "webrtc/rtc_base/sequenced_task_checker.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/video/decode_scheduler.h"
 #include "webrtc/video/receive_statistics_proxy.h"
 #include "webrtc/video/rtp_streams_synchronizer.h"
 #include "webrtc/video/rtp_video_stream_receiver.h"
@@ -49,14 +50,18 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
                            public NackSender,
                            public KeyFrameRequestSender,
                            public video_coding::OnCompleteFrameCallback,
-                           public Syncable {
+                           public Syncable,
+                           public DecodeScheduler::Stream {
  public:
+  // Frames are decoded on |decode_scheduler| if it is set, and on a thread of
+  // the stream's own otherwise.
   VideoReceiveStream(RtpStreamReceiverControllerInterface* receiver_controller,
                      int num_cpu_cores,
                      PacketRouter* packet_router,
                      VideoReceiveStream::Config config,
                      ProcessThread* process_thread,
-                     CallStats* call_stats);
+                     CallStats* call_stats,
+                     DecodeScheduler* decode_scheduler = nullptr);
   ~VideoReceiveStream() override;
 
   const Config& config() const { return config_; }
@@ -108,9 +113,15 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   uint32_t GetPlayoutTimestamp() const override;
   void SetMinimumPlayoutDelay(int delay_ms) override;
 
+  // Implements DecodeScheduler::Stream.
+  int64_t DecodeNextFrame() override;
+
  private:
   static void DecodeThreadFunction(void* ptr);
   bool Decode();
+  void DecodeFrame(std::unique_ptr<video_coding::FrameObject> frame);
+  // Requests a keyframe, unless the stream is inactive or one is on its way.
+  void HandleNoDecodableFrame(int max_wait_ms);
 
   rtc::SequencedTaskChecker worker_sequence_checker_;
   rtc::SequencedTaskChecker module_process_sequence_checker_;
@@ -122,6 +133,12 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   Clock* const clock_;
 
   rtc::PlatformThread decode_thread_;
+  DecodeScheduler* const decode_scheduler_;
+  // Whether the stream has been added to |decode_scheduler_|.
+  bool scheduled_ = false;
+  // When a frame was decoded or a keyframe was requested last, when decoding
+  // on |decode_scheduler_|.
+  int64_t last_decode_progress_ms_ = -1;
 
   CallStats* const call_stats_;
 
@@ -500,6 +500,7 @@ VideoSendStream::VideoSendStream(
     BitrateAllocator* bitrate_allocator,
     SendDelayStats* send_delay_stats,
     RtcEventLog* event_log,
+    EncoderAdmissionController* admission_controller,
     VideoSendStream::Config config,
     VideoEncoderConfig encoder_config,
     const std::map<uint32_t, RtpState>& suspended_ssrcs)
@@ -534,6 +535,8 @@ VideoSendStream::VideoSendStream(
     video_stream_encoder_->SetBitrateObserver(send_stream_.get());
   }
   video_stream_encoder_->RegisterProcessThread(module_process_thread);
+  if (admission_controller)
+    video_stream_encoder_->SetAdmissionController(admission_controller);
 
   ReconfigureVideoEncoder(std::move(encoder_config));
 }
@@ -31,6 +31,7 @@
 namespace webrtc {
 
 class CallStats;
+class EncoderAdmissionController;
 class SendSideCongestionController;
 class IvfFileWriter;
 class ProcessThread;
@@ -56,6 +57,7 @@ class VideoSendStream : public webrtc::VideoSendStream {
                   BitrateAllocator* bitrate_allocator,
                   SendDelayStats* send_delay_stats,
                   RtcEventLog* event_log,
+                  EncoderAdmissionController* admission_controller,
                   VideoSendStream::Config config,
                   VideoEncoderConfig encoder_config,
                   const std::map<uint32_t, RtpState>& suspended_ssrcs);
@@ -98,6 +98,10 @@ void VideoStreamDecoder::OnDecoderImplementationName(
   receive_stats_callback_->OnDecoderImplementationName(implementation_name);
 }
 
+void VideoStreamDecoder::OnDecoderFallback(DecoderFallbackReason reason) {
+  receive_stats_callback_->OnDecoderFallback(reason);
+}
+
 void VideoStreamDecoder::OnReceiveRatesUpdated(uint32_t bit_rate,
                                                uint32_t frame_rate) {
   receive_stats_callback_->OnIncomingRate(frame_rate, bit_rate);
@@ -64,6 +64,7 @@ class VideoStreamDecoder : public VCMReceiveCallback,
   int32_t ReceivedDecodedReferenceFrame(const uint64_t picture_id) override;
   void OnIncomingPayloadType(int payload_type) override;
   void OnDecoderImplementationName(const char* implementation_name) override;
+  void OnDecoderFallback(DecoderFallbackReason reason) override;
 
   // Implements VCMReceiveStatisticsCallback.
   void OnReceiveRatesUpdated(uint32_t bit_rate, uint32_t frame_rate) override;
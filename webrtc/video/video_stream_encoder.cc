@@ -10,12 +10,13 @@
 
 #include "webrtc/video/video_stream_encoder.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <limits>
 #include <numeric>
 #include <utility>
 
-#include "webrtc/api/video/i420_buffer.h"
 #include "webrtc/common_video/include/video_bitrate_allocator.h"
 #include "webrtc/common_video/include/video_frame.h"
 #include "webrtc/modules/pacing/paced_sender.h"
@@ -29,6 +30,7 @@
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/video/overuse_frame_detector.h"
 #include "webrtc/video/send_statistics_proxy.h"
 
@@ -45,6 +47,10 @@ const int kMaxFramerateFps = 120;
 // to try and achieve desired bitrate.
 const int kMaxInitialFramedrop = 4;
 
+// Enables packetization of encoded images on a separate task queue.
+const char kPipelinedPacketizationFieldTrial[] =
+    "WebRTC-VideoStreamEncoder-PipelinedPacketization";
+
 uint32_t MaximumFrameSizeForBitrate(uint32_t kbps) {
   if (kbps > 0) {
     if (kbps < 300 /* qvga */) {
@@ -168,6 +174,54 @@ class VideoStreamEncoder::EncodeTask : public rtc::QueuedTask {
   const bool log_stats_;
 };
 
+// Hands a copy of an encoded image to the sink on |packetizer_queue_|. The
+// encoder may reuse its output buffer as soon as OnEncodedImage returns.
+class VideoStreamEncoder::PacketizeTask : public rtc::QueuedTask {
+ public:
+  PacketizeTask(VideoStreamEncoder* video_stream_encoder,
+                const EncodedImage& encoded_image,
+                const CodecSpecificInfo* codec_specific_info,
+                const RTPFragmentationHeader* fragmentation)
+      : video_stream_encoder_(video_stream_encoder),
+        encoded_image_(encoded_image),
+        buffer_(new uint8_t[encoded_image._length]),
+        has_codec_specific_info_(codec_specific_info != nullptr),
+        has_fragmentation_(fragmentation != nullptr),
+        time_when_posted_us_(rtc::TimeMicros()) {
+    memcpy(buffer_.get(), encoded_image._buffer, encoded_image._length);
+    encoded_image_._buffer = buffer_.get();
+    encoded_image_._size = encoded_image._length;
+    if (codec_specific_info)
+      codec_specific_info_ = *codec_specific_info;
+    if (fragmentation)
+      fragmentation_.CopyFrom(*fragmentation);
+  }
+
+ private:
+  bool Run() override {
+    RTC_DCHECK(video_stream_encoder_->packetizer_queue_->IsCurrent());
+    const int64_t start_us = rtc::TimeMicros();
+    video_stream_encoder_->sink_->OnEncodedImage(
+        encoded_image_,
+        has_codec_specific_info_ ? &codec_specific_info_ : nullptr,
+        has_fragmentation_ ? &fragmentation_ : nullptr);
+    const int64_t end_us = rtc::TimeMicros();
+    video_stream_encoder_->stats_proxy_->OnPacketizationTimeMeasured(
+        (start_us - time_when_posted_us_) / rtc::kNumMicrosecsPerMillisec,
+        (end_us - start_us) / rtc::kNumMicrosecsPerMillisec);
+    return true;
+  }
+
+  VideoStreamEncoder* const video_stream_encoder_;
+  EncodedImage encoded_image_;
+  const std::unique_ptr<uint8_t[]> buffer_;
+  CodecSpecificInfo codec_specific_info_;
+  const bool has_codec_specific_info_;
+  RTPFragmentationHeader fragmentation_;
+  const bool has_fragmentation_;
+  const int64_t time_when_posted_us_;
+};
+
 // VideoSourceProxy is responsible ensuring thread safety between calls to
 // VideoStreamEncoder::SetSource that will happen on libjingle's worker thread
 // when a video capturer is connected to the encoder and the encoder task queue
@@ -397,6 +451,7 @@ VideoStreamEncoder::VideoStreamEncoder(uint32_t number_of_cores,
                     this,
                     encoder_timing,
                     stats_proxy)),
+      admission_controller_(nullptr),
       stats_proxy_(stats_proxy),
       pre_encode_callback_(pre_encode_callback),
       module_process_thread_(nullptr),
@@ -407,6 +462,7 @@ VideoStreamEncoder::VideoStreamEncoder(uint32_t number_of_cores,
       nack_enabled_(false),
       last_observed_bitrate_bps_(0),
       encoder_paused_and_dropped_frame_(false),
+      accumulated_update_rect_{0, 0, 0, 0},
       clock_(Clock::GetRealTimeClock()),
       degradation_preference_(
           VideoSendStream::DegradationPreference::kDegradationDisabled),
@@ -417,6 +473,10 @@ VideoStreamEncoder::VideoStreamEncoder(uint32_t number_of_cores,
       captured_frame_count_(0),
       dropped_frame_count_(0),
       bitrate_observer_(nullptr),
+      packetizer_queue_(
+          field_trial::IsEnabled(kPipelinedPacketizationFieldTrial)
+              ? new rtc::TaskQueue("PacketizerQueue")
+              : nullptr),
       encoder_queue_("EncoderQueue") {
   RTC_DCHECK(stats_proxy);
   encoder_queue_.PostTask([this] {
@@ -453,12 +513,21 @@ void VideoStreamEncoder::Stop() {
   encoder_queue_.PostTask([this] {
     RTC_DCHECK_RUN_ON(&encoder_queue_);
     overuse_detector_->StopCheckForOveruse();
+    if (admission_controller_) {
+      admission_controller_->RemoveEncoder(this);
+      admission_controller_ = nullptr;
+    }
     rate_allocator_.reset();
     bitrate_observer_ = nullptr;
     video_sender_.RegisterExternalEncoder(nullptr, settings_.payload_type,
                                           false);
     quality_scaler_ = nullptr;
-    shutdown_event_.Set();
+    if (packetizer_queue_) {
+      // Let the images that are already encoded reach the sink first.
+      packetizer_queue_->PostTask([this] { shutdown_event_.Set(); });
+    } else {
+      shutdown_event_.Set();
+    }
   });
 
   shutdown_event_.Wait(rtc::Event::kForever);
@@ -488,6 +557,17 @@ void VideoStreamEncoder::SetBitrateObserver(
   });
 }
 
+void VideoStreamEncoder::SetAdmissionController(
+    EncoderAdmissionController* admission_controller) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  encoder_queue_.PostTask([this, admission_controller] {
+    RTC_DCHECK_RUN_ON(&encoder_queue_);
+    RTC_DCHECK(!admission_controller_);
+    admission_controller_ = admission_controller;
+    admission_controller_->AddEncoder(this, encoder_config_.bitrate_priority);
+  });
+}
+
 void VideoStreamEncoder::SetSource(
     rtc::VideoSourceInterface<VideoFrame>* source,
     const VideoSendStream::DegradationPreference& degradation_preference) {
@@ -557,6 +637,10 @@ void VideoStreamEncoder::ConfigureEncoderOnTaskQueue(
   nack_enabled_ = nack_enabled;
   encoder_config_ = std::move(config);
   pending_encoder_reconfiguration_ = true;
+  if (admission_controller_) {
+    admission_controller_->SetPriority(this,
+                                       encoder_config_.bitrate_priority);
+  }
 
   // Reconfigure the encoder now if the encoder has an internal source or
   // if the frame resolution is known. Otherwise, the reconfiguration is
@@ -708,6 +792,11 @@ void VideoStreamEncoder::OnFrame(const VideoFrame& video_frame) {
                     << incoming_frame.ntp_time_ms()
                     << " <= " << last_captured_timestamp_
                     << ") for incoming frame. Dropping.";
+    VideoFrame::UpdateRect update_rect = incoming_frame.update_rect();
+    encoder_queue_.PostTask([this, update_rect] {
+      RTC_DCHECK_RUN_ON(&encoder_queue_);
+      accumulated_update_rect_.Union(update_rect);
+    });
     return;
   }
 
@@ -773,6 +862,7 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
     LOG(LS_INFO) << "Dropping frame. Too large for target bitrate.";
     AdaptDown(kQuality);
     ++initial_rampup_;
+    accumulated_update_rect_.Union(video_frame.update_rect());
     return;
   }
   initial_rampup_ = kMaxInitialFramedrop;
@@ -791,6 +881,7 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 
   if (EncoderPaused()) {
     TraceFrameDropStart();
+    accumulated_update_rect_.Union(video_frame.update_rect());
     return;
   }
   TraceFrameDropEnd();
@@ -800,23 +891,29 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
   if (crop_width_ > 0 || crop_height_ > 0) {
     int cropped_width = video_frame.width() - crop_width_;
     int cropped_height = video_frame.height() - crop_height_;
-    rtc::scoped_refptr<I420Buffer> cropped_buffer =
-        I420Buffer::Create(cropped_width, cropped_height);
+    // Crop through the buffer itself, so that native (e.g. texture) buffers
+    // can record the crop instead of being read back and converted to I420.
+    rtc::scoped_refptr<VideoFrameBuffer> cropped_buffer;
     // TODO(ilnik): Remove scaling if cropping is too big, as it should never
     // happen after SinkWants signaled correctly from ReconfigureEncoder.
     if (crop_width_ < 4 && crop_height_ < 4) {
-      cropped_buffer->CropAndScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420(), crop_width_ / 2,
-          crop_height_ / 2, cropped_width, cropped_height);
+      cropped_buffer = video_frame.video_frame_buffer()->CropAndScale(
+          crop_width_ / 2, crop_height_ / 2, cropped_width, cropped_height,
+          cropped_width, cropped_height);
     } else {
-      cropped_buffer->ScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420().get());
+      cropped_buffer = video_frame.video_frame_buffer()->Scale(cropped_width,
+                                                               cropped_height);
     }
     out_frame =
         VideoFrame(cropped_buffer, video_frame.timestamp(),
                    video_frame.render_time_ms(), video_frame.rotation());
     out_frame.set_ntp_time_ms(video_frame.ntp_time_ms());
+  } else if (!accumulated_update_rect_.IsEmpty()) {
+    VideoFrame::UpdateRect update_rect = accumulated_update_rect_;
+    update_rect.Union(video_frame.update_rect());
+    out_frame.set_update_rect(update_rect);
   }
+  accumulated_update_rect_ = VideoFrame::UpdateRect{0, 0, 0, 0};
 
   TRACE_EVENT_ASYNC_STEP0("webrtc", "Video", video_frame.render_time_ms(),
                           "Encode");
@@ -844,8 +941,17 @@ EncodedImageCallback::Result VideoStreamEncoder::OnEncodedImage(
   // running in parallel on different threads.
   stats_proxy_->OnSendEncodedImage(encoded_image, codec_specific_info);
 
-  EncodedImageCallback::Result result =
-      sink_->OnEncodedImage(encoded_image, codec_specific_info, fragmentation);
+  EncodedImageCallback::Result result(EncodedImageCallback::Result::OK,
+                                      encoded_image._timeStamp);
+  if (packetizer_queue_) {
+    // The sink's result is only informational, so it's not waited for.
+    packetizer_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(
+        new PacketizeTask(this, encoded_image, codec_specific_info,
+                          fragmentation)));
+  } else {
+    result = sink_->OnEncodedImage(encoded_image, codec_specific_info,
+                                   fragmentation);
+  }
 
   int64_t time_sent_us = rtc::TimeMicros();
   uint32_t timestamp = encoded_image._timeStamp;
@@ -921,6 +1027,41 @@ void VideoStreamEncoder::OnBitrateUpdated(uint32_t bitrate_bps,
 }
 
 void VideoStreamEncoder::AdaptDown(AdaptReason reason) {
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (reason == kCpu && admission_controller_) {
+    admission_controller_->OnOveruse(this);
+    return;
+  }
+  DoAdaptDown(reason);
+}
+
+void VideoStreamEncoder::AdaptUp(AdaptReason reason) {
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (reason == kCpu && admission_controller_) {
+    admission_controller_->OnUnderuse(this);
+    return;
+  }
+  DoAdaptUp(reason);
+}
+
+void VideoStreamEncoder::AdaptDownForAdmissionControl() {
+  encoder_queue_.PostTask([this] {
+    RTC_DCHECK_RUN_ON(&encoder_queue_);
+    // Nothing to adapt before the first frame or after Stop().
+    if (admission_controller_ && last_frame_info_)
+      DoAdaptDown(kCpu);
+  });
+}
+
+void VideoStreamEncoder::AdaptUpForAdmissionControl() {
+  encoder_queue_.PostTask([this] {
+    RTC_DCHECK_RUN_ON(&encoder_queue_);
+    if (admission_controller_ && last_frame_info_)
+      DoAdaptUp(kCpu);
+  });
+}
+
+void VideoStreamEncoder::DoAdaptDown(AdaptReason reason) {
   RTC_DCHECK_RUN_ON(&encoder_queue_);
   AdaptationRequest adaptation_request = {
       last_frame_info_->pixel_count(),
@@ -1012,7 +1153,7 @@ void VideoStreamEncoder::AdaptDown(AdaptReason reason) {
   LOG(LS_INFO) << GetConstAdaptCounter().ToString();
 }
 
-void VideoStreamEncoder::AdaptUp(AdaptReason reason) {
+void VideoStreamEncoder::DoAdaptUp(AdaptReason reason) {
   RTC_DCHECK_RUN_ON(&encoder_queue_);
 
   const AdaptCounter& adapt_counter = GetConstAdaptCounter();
@@ -31,6 +31,7 @@
 #include "webrtc/rtc_base/task_queue.h"
 #include "webrtc/system_wrappers/include/atomic32.h"
 #include "webrtc/typedefs.h"
+#include "webrtc/video/encoder_admission_controller.h"
 #include "webrtc/video/overuse_frame_detector.h"
 #include "webrtc/call/video_send_stream.h"
 
@@ -51,7 +52,8 @@ class VideoBitrateAllocationObserver;
 class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
                            public EncodedImageCallback,
                            public VCMSendStatisticsCallback,
-                           public AdaptationObserverInterface {
+                           public AdaptationObserverInterface,
+                           public EncoderAdmissionController::Encoder {
  public:
   // Interface for receiving encoded video frames and notifications about
   // configuration changes.
@@ -104,6 +106,10 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
 
   void SetBitrateObserver(VideoBitrateAllocationObserver* bitrate_observer);
 
+  // Lets |admission_controller| decide which encoder of the call adapts on CPU
+  // overuse and underuse, instead of this encoder always adapting itself.
+  void SetAdmissionController(EncoderAdmissionController* admission_controller);
+
   void ConfigureEncoder(VideoEncoderConfig config,
                         size_t max_data_payload_length,
                         bool nack_enabled);
@@ -130,11 +136,17 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   // These methods are protected for easier testing.
   void AdaptUp(AdaptReason reason) override;
   void AdaptDown(AdaptReason reason) override;
+
+  // EncoderAdmissionController::Encoder implementation.
+  void AdaptDownForAdmissionControl() override;
+  void AdaptUpForAdmissionControl() override;
+
   static CpuOveruseOptions GetCpuOveruseOptions(bool full_overuse_time);
 
  private:
   class ConfigureEncoderTask;
   class EncodeTask;
+  class PacketizeTask;
   class VideoSourceProxy;
 
   class VideoFrameInfo {
@@ -158,6 +170,11 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
 
   void ConfigureQualityScaler();
 
+  // Adapt the input unconditionally, also for CPU reasons when there is an
+  // |admission_controller_|.
+  void DoAdaptUp(AdaptReason reason) RUN_ON(&encoder_queue_);
+  void DoAdaptDown(AdaptReason reason) RUN_ON(&encoder_queue_);
+
   // Implements VideoSinkInterface.
   void OnFrame(const VideoFrame& video_frame) override;
 
@@ -237,6 +254,8 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   std::unique_ptr<OveruseFrameDetector> overuse_detector_
       ACCESS_ON(&encoder_queue_);
   std::unique_ptr<QualityScaler> quality_scaler_ ACCESS_ON(&encoder_queue_);
+  // Decides which encoder adapts on CPU overuse, if set. Reset by Stop().
+  EncoderAdmissionController* admission_controller_ ACCESS_ON(&encoder_queue_);
 
   SendStatisticsProxy* const stats_proxy_;
   rtc::VideoSinkInterface<VideoFrame>* const pre_encode_callback_;
@@ -264,6 +283,9 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   bool nack_enabled_ ACCESS_ON(&encoder_queue_);
   uint32_t last_observed_bitrate_bps_ ACCESS_ON(&encoder_queue_);
   bool encoder_paused_and_dropped_frame_ ACCESS_ON(&encoder_queue_);
+  // The union of the update rects of the frames dropped since the last frame
+  // was passed to the encoder, which is added to the next one's.
+  VideoFrame::UpdateRect accumulated_update_rect_ ACCESS_ON(&encoder_queue_);
   Clock* const clock_;
   // Counters used for deciding if the video resolution or framerate is
   // currently restricted, and if so, why, on a per degradation preference
@@ -304,6 +326,11 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   VideoBitrateAllocationObserver* bitrate_observer_ ACCESS_ON(&encoder_queue_);
   rtc::Optional<int64_t> last_parameters_update_ms_ ACCESS_ON(&encoder_queue_);
 
+  // Set if encoded images are handed to the sink on a separate queue, so that
+  // encoding of the next frame can start while the previous one is being
+  // packetized. Destroyed right after |encoder_queue_|.
+  const std::unique_ptr<rtc::TaskQueue> packetizer_queue_;
+
   // All public methods are proxied to |encoder_queue_|. It must must be
   // destroyed first to make sure no tasks are run that use other members.
   rtc::TaskQueue encoder_queue_;
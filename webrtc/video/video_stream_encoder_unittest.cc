@@ -22,6 +22,8 @@
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/encoder_settings.h"
 #include "webrtc/test/fake_encoder.h"
+#include "webrtc/test/fake_texture_frame.h"
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/frame_generator.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
@@ -251,6 +253,37 @@ class MockableSendStatisticsProxy : public SendStatisticsProxy {
   rtc::Optional<VideoSendStream::Stats> mock_stats_ GUARDED_BY(lock_);
 };
 
+// Simulates simulcast behavior and makes highest stream resolutions divisible
+// by 4.
+class CroppingVideoStreamFactory
+    : public VideoEncoderConfig::VideoStreamFactoryInterface {
+ public:
+  explicit CroppingVideoStreamFactory(size_t num_temporal_layers,
+                                      int framerate)
+      : num_temporal_layers_(num_temporal_layers), framerate_(framerate) {
+    EXPECT_GT(num_temporal_layers, 0u);
+    EXPECT_GT(framerate, 0);
+  }
+
+ private:
+  std::vector<VideoStream> CreateEncoderStreams(
+      int width,
+      int height,
+      const VideoEncoderConfig& encoder_config) override {
+    std::vector<VideoStream> streams =
+        test::CreateVideoStreams(width - width % 4, height - height % 4,
+                                 encoder_config);
+    for (VideoStream& stream : streams) {
+      stream.temporal_layer_thresholds_bps.resize(num_temporal_layers_ - 1);
+      stream.max_framerate = framerate_;
+    }
+    return streams;
+  }
+
+  const size_t num_temporal_layers_;
+  const int framerate_;
+};
+
 class MockBitrateObserver : public VideoBitrateAllocationObserver {
  public:
   MOCK_METHOD1(OnBitrateAllocationUpdated, void(const BitrateAllocation&));
@@ -503,6 +536,16 @@ class VideoStreamEncoderTest : public ::testing::Test {
       force_init_encode_failed_ = force_failure;
     }
 
+    rtc::Optional<VideoFrame::UpdateRect> last_update_rect() const {
+      rtc::CritScope lock(&local_crit_sect_);
+      return last_update_rect_;
+    }
+
+    VideoFrameBuffer::Type last_input_buffer_type() const {
+      rtc::CritScope lock(&local_crit_sect_);
+      return last_input_buffer_type_;
+    }
+
    private:
     int32_t Encode(const VideoFrame& input_image,
                    const CodecSpecificInfo* codec_specific_info,
@@ -518,6 +561,12 @@ class VideoStreamEncoderTest : public ::testing::Test {
         ntp_time_ms_ = input_image.ntp_time_ms();
         last_input_width_ = input_image.width();
         last_input_height_ = input_image.height();
+        last_input_buffer_type_ = input_image.video_frame_buffer()->type();
+        last_update_rect_ =
+            input_image.has_update_rect()
+                ? rtc::Optional<VideoFrame::UpdateRect>(
+                      input_image.update_rect())
+                : rtc::Optional<VideoFrame::UpdateRect>();
         block_encode = block_next_encode_;
         block_next_encode_ = false;
       }
@@ -557,6 +606,10 @@ class VideoStreamEncoderTest : public ::testing::Test {
     int64_t ntp_time_ms_ GUARDED_BY(local_crit_sect_) = 0;
     int last_input_width_ GUARDED_BY(local_crit_sect_) = 0;
     int last_input_height_ GUARDED_BY(local_crit_sect_) = 0;
+    VideoFrameBuffer::Type last_input_buffer_type_ GUARDED_BY(
+        local_crit_sect_) = VideoFrameBuffer::Type::kI420;
+    rtc::Optional<VideoFrame::UpdateRect> last_update_rect_
+        GUARDED_BY(local_crit_sect_);
     bool quality_scaling_ GUARDED_BY(local_crit_sect_) = true;
     std::vector<std::unique_ptr<TemporalLayers>> allocated_temporal_layers_
         GUARDED_BY(local_crit_sect_);
@@ -708,6 +761,38 @@ TEST_F(VideoStreamEncoderTest, DropsFramesWhenRateSetToZero) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, AddsUpdateRectsOfDroppedFramesToNextFrame) {
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  VideoFrame frame = CreateFrame(1, nullptr);
+  frame.set_update_rect(VideoFrame::UpdateRect{0, 0, 16, 16});
+  video_source_.IncomingCapturedFrame(frame);
+  WaitForEncodedFrame(1);
+  rtc::Optional<VideoFrame::UpdateRect> update_rect =
+      fake_encoder_.last_update_rect();
+  ASSERT_TRUE(update_rect);
+  EXPECT_EQ(0, update_rect->offset_x);
+  EXPECT_EQ(16, update_rect->width);
+
+  video_stream_encoder_->OnBitrateUpdated(0, 0, 0);
+  // Dropped since bitrate is zero.
+  frame = CreateFrame(2, nullptr);
+  frame.set_update_rect(VideoFrame::UpdateRect{32, 32, 16, 16});
+  video_source_.IncomingCapturedFrame(frame);
+
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  frame = CreateFrame(3, nullptr);
+  frame.set_update_rect(VideoFrame::UpdateRect{64, 16, 16, 16});
+  video_source_.IncomingCapturedFrame(frame);
+  WaitForEncodedFrame(3);
+  update_rect = fake_encoder_.last_update_rect();
+  ASSERT_TRUE(update_rect);
+  EXPECT_EQ(32, update_rect->offset_x);
+  EXPECT_EQ(16, update_rect->offset_y);
+  EXPECT_EQ(48, update_rect->width);
+  EXPECT_EQ(32, update_rect->height);
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, DropsFramesWithSameOrOldNtpTimestamp) {
   video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
   video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
@@ -734,6 +819,19 @@ TEST_F(VideoStreamEncoderTest, DropsFrameAfterStop) {
   EXPECT_TRUE(frame_destroyed_event.Wait(kDefaultTimeoutMs));
 }
 
+TEST_F(VideoStreamEncoderTest, PipelinedPacketizationDeliversAllFrames) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-VideoStreamEncoder-PipelinedPacketization/Enabled/");
+  ConfigureEncoder(video_encoder_config_.Copy(), true /* nack_enabled */);
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  for (int64_t ntp_time_ms = 1; ntp_time_ms <= 3; ++ntp_time_ms) {
+    video_source_.IncomingCapturedFrame(CreateFrame(ntp_time_ms, nullptr));
+    WaitForEncodedFrame(ntp_time_ms);
+  }
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, DropsPendingFramesOnSlowEncode) {
   video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
 
@@ -3123,37 +3221,6 @@ TEST_F(VideoStreamEncoderTest,
 }
 
 TEST_F(VideoStreamEncoderTest, AcceptsFullHdAdaptedDownSimulcastFrames) {
-  // Simulates simulcast behavior and makes highest stream resolutions divisible
-  // by 4.
-  class CroppingVideoStreamFactory
-      : public VideoEncoderConfig::VideoStreamFactoryInterface {
-   public:
-    explicit CroppingVideoStreamFactory(size_t num_temporal_layers,
-                                        int framerate)
-        : num_temporal_layers_(num_temporal_layers), framerate_(framerate) {
-      EXPECT_GT(num_temporal_layers, 0u);
-      EXPECT_GT(framerate, 0);
-    }
-
-   private:
-    std::vector<VideoStream> CreateEncoderStreams(
-        int width,
-        int height,
-        const VideoEncoderConfig& encoder_config) override {
-      std::vector<VideoStream> streams =
-          test::CreateVideoStreams(width - width % 4, height - height % 4,
-                                   encoder_config);
-      for (VideoStream& stream : streams) {
-        stream.temporal_layer_thresholds_bps.resize(num_temporal_layers_ - 1);
-        stream.max_framerate = framerate_;
-      }
-      return streams;
-    }
-
-    const size_t num_temporal_layers_;
-    const int framerate_;
-  };
-
   const int kFrameWidth = 1920;
   const int kFrameHeight = 1080;
   // 3/4 of 1920.
@@ -3188,6 +3255,27 @@ TEST_F(VideoStreamEncoderTest, AcceptsFullHdAdaptedDownSimulcastFrames) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, CropsNativeFramesWithoutConvertingToI420) {
+  const int kFrameWidth = 1282;
+  const int kFrameHeight = 722;
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  VideoEncoderConfig video_encoder_config;
+  test::FillEncoderConfiguration(1, &video_encoder_config);
+  video_encoder_config.video_stream_factory =
+      new rtc::RefCountedObject<CroppingVideoStreamFactory>(1, 30);
+  video_stream_encoder_->ConfigureEncoder(std::move(video_encoder_config),
+                                          kMaxPayloadLength, false);
+  video_stream_encoder_->WaitUntilTaskQueueIsIdle();
+
+  video_source_.IncomingCapturedFrame(test::FakeNativeBuffer::CreateFrame(
+      kFrameWidth, kFrameHeight, 99, 1, kVideoRotation_0));
+  WaitForEncodedFrame(kFrameWidth - 2, kFrameHeight - 2);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNative,
+            fake_encoder_.last_input_buffer_type());
+
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, PeriodicallyUpdatesChannelParameters) {
   const int kFrameWidth = 1280;
   const int kFrameHeight = 720;
@@ -76,6 +76,8 @@ class RtcEventLogProxy final : public webrtc::RtcEventLog {
 
   void StopLogging() override { RTC_NOTREACHED(); }
 
+  void SetColumnarFormat(bool enable) override { RTC_NOTREACHED(); }
+
   void LogVideoReceiveStreamConfig(
       const webrtc::rtclog::StreamConfig&) override {
     RTC_NOTREACHED();
@@ -186,6 +188,13 @@ class RtcEventLogProxy final : public webrtc::RtcEventLog {
     }
   };
 
+  void LogAlrState(bool in_alr) override {
+    rtc::CritScope lock(&crit_);
+    if (event_log_) {
+      event_log_->LogAlrState(in_alr);
+    }
+  };
+
   void SetEventLog(RtcEventLog* event_log) {
     rtc::CritScope lock(&crit_);
     event_log_ = event_log;
@@ -409,15 +418,24 @@ class Channel::ProcessAndEncodeAudioTask : public rtc::QueuedTask {
       : audio_frame_(std::move(audio_frame)), channel_(channel) {
     RTC_DCHECK(channel_);
   }
+  ProcessAndEncodeAudioTask(std::shared_ptr<const AudioFrame> audio_frame,
+                            Channel* channel)
+      : shared_audio_frame_(std::move(audio_frame)), channel_(channel) {
+    RTC_DCHECK(channel_);
+  }
 
  private:
   bool Run() override {
     RTC_DCHECK_RUN_ON(channel_->encoder_queue_);
-    channel_->ProcessAndEncodeAudioOnTaskQueue(audio_frame_.get());
+    if (shared_audio_frame_)
+      channel_->ProcessAndEncodeAudioOnTaskQueue(*shared_audio_frame_);
+    else
+      channel_->ProcessAndEncodeAudioOnTaskQueue(audio_frame_.get());
     return true;
   }
 
   std::unique_ptr<AudioFrame> audio_frame_;
+  std::shared_ptr<const AudioFrame> shared_audio_frame_;
   Channel* const channel_;
 };
 
@@ -433,22 +451,65 @@ int32_t Channel::SendData(FrameType frameType,
                " payloadSize=%" PRIuS ", fragmentation=0x%x)",
                frameType, payloadType, timeStamp, payloadSize, fragmentation);
 
+  // The audio level is measured once for this channel and for the channels
+  // that send its encoded output.
+  rtc::CritScope lock(&fanout_lock_);
+  const int audio_level =
+      _includeAudioLevelIndication || !fanout_channels_.empty()
+          ? rms_level_.Average()
+          : 0;
+  const int32_t result =
+      SendEncodedData(frameType, payloadType, timeStamp, payloadData,
+                      payloadSize, fragmentation, audio_level);
+  for (Channel* channel : fanout_channels_) {
+    channel->SendFanoutData(frameType, payloadType, timeStamp, payloadData,
+                            payloadSize, fragmentation, audio_level);
+  }
+  return result;
+}
+
+void Channel::SendFanoutData(FrameType frame_type,
+                             uint8_t payload_type,
+                             uint32_t timestamp,
+                             const uint8_t* payload_data,
+                             size_t payload_size,
+                             const RTPFragmentationHeader* fragmentation,
+                             int audio_level) {
+  RTC_DCHECK_RUN_ON(encoder_queue_);
+  {
+    // Drop the data once sending was stopped in StopSend().
+    rtc::CritScope cs(&encoder_queue_lock_);
+    if (!encoder_queue_is_active_) {
+      return;
+    }
+  }
+  SendEncodedData(frame_type, payload_type, timestamp, payload_data,
+                  payload_size, fragmentation, audio_level);
+}
+
+int32_t Channel::SendEncodedData(FrameType frame_type,
+                                 uint8_t payload_type,
+                                 uint32_t timestamp,
+                                 const uint8_t* payload_data,
+                                 size_t payload_size,
+                                 const RTPFragmentationHeader* fragmentation,
+                                 int audio_level) {
   if (_includeAudioLevelIndication) {
     // Store current audio level in the RTP/RTCP module.
     // The level will be used in combination with voice-activity state
     // (frameType) to add an RTP header extension
-    _rtpRtcpModule->SetAudioLevel(rms_level_.Average());
+    _rtpRtcpModule->SetAudioLevel(audio_level);
   }
 
   // Push data from ACM to RTP/RTCP-module to deliver audio frame for
   // packetization.
   // This call will trigger Transport::SendPacket() from the RTP/RTCP module.
   if (!_rtpRtcpModule->SendOutgoingData(
-          (FrameType&)frameType, payloadType, timeStamp,
+          frame_type, payload_type, timestamp,
           // Leaving the time when this frame was
           // received from the capture device as
           // undefined for voice for now.
-          -1, payloadData, payloadSize, fragmentation, nullptr, nullptr)) {
+          -1, payload_data, payload_size, fragmentation, nullptr, nullptr)) {
     _engineStatisticsPtr->SetLastError(
         VE_RTP_RTCP_MODULE_ERROR, kTraceWarning,
         "Channel::SendData() failed to send data to RTP/RTCP module");
@@ -658,9 +719,10 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
     // Pass the audio buffers to an optional sink callback, before applying
     // scaling/panning, as that applies to the mix operation.
     // External recipients of the audio (e.g. via AudioTrack), will do their
-    // own mixing/dynamic processing.
-    rtc::CritScope cs(&_callbackCritSect);
-    if (audio_sink_) {
+    // own mixing/dynamic processing. The frame is skipped while the sink is
+    // being replaced.
+    rtc::TryCritScope lock(&audio_sink_lock_);
+    if (lock.locked() && audio_sink_) {
       AudioSinkInterface::Data data(
           audioFrame->data(), audioFrame->samples_per_channel_,
           audioFrame->sample_rate_hz_, audioFrame->num_channels_,
@@ -669,11 +731,7 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
     }
   }
 
-  float output_gain = 1.0f;
-  {
-    rtc::CritScope cs(&volume_settings_critsect_);
-    output_gain = _outputGain;
-  }
+  const float output_gain = _outputGain.load(std::memory_order_relaxed);
 
   // Output volume scaling
   if (output_gain < 0.99f || output_gain > 1.01f) {
@@ -717,8 +775,8 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
         (unwrap_timestamp - capture_start_rtp_time_stamp_) /
         (GetRtpTimestampRateHz() / 1000);
 
-    {
-      rtc::CritScope lock(&ts_stats_lock_);
+    rtc::TryCritScope lock(&ts_stats_lock_);
+    if (lock.locked()) {
       // Compute ntp time.
       audioFrame->ntp_time_ms_ =
           ntp_estimator_.Estimate(audioFrame->timestamp_);
@@ -726,8 +784,18 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
       if (audioFrame->ntp_time_ms_ > 0) {
         // Compute |capture_start_ntp_time_ms_| so that
         // |capture_start_ntp_time_ms_| + |elapsed_time_ms_| == |ntp_time_ms_|
-        capture_start_ntp_time_ms_ =
-            audioFrame->ntp_time_ms_ - audioFrame->elapsed_time_ms_;
+        capture_start_ntp_time_ms_.store(
+            audioFrame->ntp_time_ms_ - audioFrame->elapsed_time_ms_,
+            std::memory_order_relaxed);
+      }
+    } else {
+      // An RTCP sender report is being added to the estimator, which hardly
+      // moves the capture start from one frame to the next.
+      const int64_t capture_start_ntp_time_ms =
+          capture_start_ntp_time_ms_.load(std::memory_order_relaxed);
+      if (capture_start_ntp_time_ms >= 0) {
+        audioFrame->ntp_time_ms_ =
+            capture_start_ntp_time_ms + audioFrame->elapsed_time_ms_;
       }
     }
   }
@@ -908,6 +976,7 @@ Channel::Channel(int32_t channelId,
       restored_packet_in_use_(false),
       rtcp_observer_(new VoERtcpObserver(this)),
       associate_send_channel_(ChannelOwner(nullptr)),
+      fanout_source_(ChannelOwner(nullptr)),
       pacing_enabled_(config.enable_voice_pacing),
       feedback_observer_proxy_(new TransportFeedbackProxy()),
       seq_num_allocator_proxy_(new TransportSequenceNumberProxy()),
@@ -1090,6 +1159,18 @@ void Channel::Terminate() {
   StopSend();
   StopPlayout();
 
+  // Stop sharing encoded output with other channels. The channels that sent
+  // the output of this channel encode their own audio again.
+  SetEncodeFanoutSource(ChannelOwner(nullptr));
+  std::vector<Channel*> fanout_channels;
+  {
+    rtc::CritScope lock(&fanout_lock_);
+    fanout_channels.swap(fanout_channels_);
+  }
+  for (Channel* channel : fanout_channels) {
+    channel->SetEncodeFanoutSource(ChannelOwner(nullptr));
+  }
+
   {
     rtc::CritScope cs(&_fileCritSect);
     if (input_file_player_) {
@@ -1151,7 +1232,7 @@ int32_t Channel::SetEngineInformation(Statistics& engineStatistics,
 }
 
 void Channel::SetSink(std::unique_ptr<AudioSinkInterface> sink) {
-  rtc::CritScope cs(&_callbackCritSect);
+  rtc::CritScope lock(&audio_sink_lock_);
   audio_sink_ = std::move(sink);
 }
 
@@ -2383,18 +2464,15 @@ double Channel::GetTotalOutputDuration() const {
 }
 
 void Channel::SetInputMute(bool enable) {
-  rtc::CritScope cs(&volume_settings_critsect_);
-  input_mute_ = enable;
+  input_mute_.store(enable, std::memory_order_relaxed);
 }
 
 bool Channel::InputMute() const {
-  rtc::CritScope cs(&volume_settings_critsect_);
-  return input_mute_;
+  return input_mute_.load(std::memory_order_relaxed);
 }
 
 void Channel::SetChannelOutputVolumeScaling(float scaling) {
-  rtc::CritScope cs(&volume_settings_critsect_);
-  _outputGain = scaling;
+  _outputGain.store(scaling, std::memory_order_relaxed);
 }
 
 int Channel::SendTelephoneEventOutband(int event, int duration_ms) {
@@ -2709,10 +2787,8 @@ int Channel::GetRTPStatistics(CallStatistics& stats) {
   stats.packetsReceived = packetsReceived;
 
   // --- Timestamps
-  {
-    rtc::CritScope lock(&ts_stats_lock_);
-    stats.capture_start_ntp_time_ms_ = capture_start_ntp_time_ms_;
-  }
+  stats.capture_start_ntp_time_ms_ =
+      capture_start_ntp_time_ms_.load(std::memory_order_relaxed);
   return 0;
 }
 
@@ -2751,25 +2827,29 @@ int Channel::ResendPackets(const uint16_t* sequence_numbers, int length) {
   return _rtpRtcpModule->SendNACK(sequence_numbers, length);
 }
 
-void Channel::ProcessAndEncodeAudio(const AudioFrame& audio_input) {
+void Channel::ProcessAndEncodeAudio(
+    std::shared_ptr<const AudioFrame> audio_input) {
+  // The encoded output of the fanout source is sent instead.
+  if (HasEncodeFanoutSource()) {
+    return;
+  }
   // Avoid posting any new tasks if sending was already stopped in StopSend().
   rtc::CritScope cs(&encoder_queue_lock_);
   if (!encoder_queue_is_active_) {
     return;
   }
-  std::unique_ptr<AudioFrame> audio_frame(new AudioFrame());
-  // TODO(henrika): try to avoid copying by moving ownership of audio frame
-  // either into pool of frames or into the task itself.
-  audio_frame->CopyFrom(audio_input);
-  audio_frame->id_ = ChannelId();
   encoder_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(
-      new ProcessAndEncodeAudioTask(std::move(audio_frame), this)));
+      new ProcessAndEncodeAudioTask(std::move(audio_input), this)));
 }
 
 void Channel::ProcessAndEncodeAudio(const int16_t* audio_data,
                                     int sample_rate,
                                     size_t number_of_frames,
                                     size_t number_of_channels) {
+  // The encoded output of the fanout source is sent instead.
+  if (HasEncodeFanoutSource()) {
+    return;
+  }
   // Avoid posting as new task if sending was already stopped in StopSend().
   rtc::CritScope cs(&encoder_queue_lock_);
   if (!encoder_queue_is_active_) {
@@ -2795,6 +2875,15 @@ void Channel::ProcessAndEncodeAudio(const int16_t* audio_data,
       new ProcessAndEncodeAudioTask(std::move(audio_frame), this)));
 }
 
+void Channel::ProcessAndEncodeAudioOnTaskQueue(
+    const AudioFrame& shared_audio_input) {
+  RTC_DCHECK_RUN_ON(encoder_queue_);
+  // The frame is muted, mixed with the input file and stamped in place.
+  shared_input_copy_.CopyFrom(shared_audio_input);
+  shared_input_copy_.id_ = ChannelId();
+  ProcessAndEncodeAudioOnTaskQueue(&shared_input_copy_);
+}
+
 void Channel::ProcessAndEncodeAudioOnTaskQueue(AudioFrame* audio_input) {
   RTC_DCHECK_RUN_ON(encoder_queue_);
   RTC_DCHECK_GT(audio_input->samples_per_channel_, 0);
@@ -2808,7 +2897,12 @@ void Channel::ProcessAndEncodeAudioOnTaskQueue(AudioFrame* audio_input) {
   bool is_muted = InputMute();
   AudioFrameOperations::Mute(audio_input, previous_frame_muted_, is_muted);
 
-  if (_includeAudioLevelIndication) {
+  bool measure_audio_level = _includeAudioLevelIndication;
+  if (!measure_audio_level) {
+    rtc::CritScope lock(&fanout_lock_);
+    measure_audio_level = !fanout_channels_.empty();
+  }
+  if (measure_audio_level) {
     size_t length =
         audio_input->samples_per_channel_ * audio_input->num_channels_;
     RTC_CHECK_LE(length, AudioFrame::kMaxDataSizeBytes);
@@ -2854,6 +2948,67 @@ void Channel::DisassociateSendChannel(int channel_id) {
   }
 }
 
+bool Channel::SetEncodeFanoutSource(const ChannelOwner& source) {
+  Channel* const source_channel = source.channel();
+  RTC_DCHECK(source_channel != this);
+  if (source_channel) {
+    CodecInst codec;
+    CodecInst source_codec;
+    if (GetSendCodec(codec) != 0 ||
+        source_channel->GetSendCodec(source_codec) != 0 ||
+        codec != source_codec) {
+      LOG(LS_WARNING) << "Channel " << _channelId
+                      << " can't send the encoded output of channel "
+                      << source_channel->ChannelId()
+                      << ": the send codecs differ.";
+      return false;
+    }
+  }
+
+  ChannelOwner previous_source(nullptr);
+  {
+    rtc::CritScope lock(&fanout_lock_);
+    if (source_channel && !fanout_channels_.empty()) {
+      return false;
+    }
+    previous_source = fanout_source_;
+    fanout_source_ = source;
+  }
+  if (previous_source.channel()) {
+    previous_source.channel()->RemoveFanoutChannel(this);
+  }
+  if (source_channel && !source_channel->AddFanoutChannel(this)) {
+    rtc::CritScope lock(&fanout_lock_);
+    fanout_source_ = ChannelOwner(nullptr);
+    return false;
+  }
+  return true;
+}
+
+bool Channel::AddFanoutChannel(Channel* channel) {
+  rtc::CritScope lock(&fanout_lock_);
+  if (fanout_source_.channel()) {
+    return false;
+  }
+  RTC_DCHECK(std::find(fanout_channels_.begin(), fanout_channels_.end(),
+                       channel) == fanout_channels_.end());
+  fanout_channels_.push_back(channel);
+  return true;
+}
+
+void Channel::RemoveFanoutChannel(Channel* channel) {
+  // Once the lock is taken, SendData() isn't forwarding any data to |channel|.
+  rtc::CritScope lock(&fanout_lock_);
+  fanout_channels_.erase(
+      std::remove(fanout_channels_.begin(), fanout_channels_.end(), channel),
+      fanout_channels_.end());
+}
+
+bool Channel::HasEncodeFanoutSource() const {
+  rtc::CritScope lock(&fanout_lock_);
+  return fanout_source_.channel() != nullptr;
+}
+
 void Channel::SetRtcEventLog(RtcEventLog* event_log) {
   event_log_proxy_->SetEventLog(event_log);
 }
@@ -11,7 +11,9 @@
 #ifndef WEBRTC_VOICE_ENGINE_CHANNEL_H_
 #define WEBRTC_VOICE_ENGINE_CHANNEL_H_
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "webrtc/api/audio/audio_mixer.h"
 #include "webrtc/api/audio_codecs/audio_encoder.h"
@@ -364,8 +366,9 @@ class Channel
   RtpRtcp* RtpRtcpModulePtr() const { return _rtpRtcpModule.get(); }
   int8_t OutputEnergyLevel() const { return _outputAudioLevel.Level(); }
 
-  // ProcessAndEncodeAudio() creates an audio frame copy and posts a task
-  // on the shared encoder task queue, wich in turn calls (on the queue)
+  // ProcessAndEncodeAudio() posts a task with |audio_input|, which may be
+  // shared with other channels and is only copied once on the queue, on the
+  // shared encoder task queue, wich in turn calls (on the queue)
   // ProcessAndEncodeAudioOnTaskQueue() where the actual processing of the
   // audio takes place. The processing mainly consists of encoding and preparing
   // the result for sending by adding it to a send queue.
@@ -373,13 +376,13 @@ class Channel
   // OS-specific, audio capture thread as soon as possible to ensure that it
   // can go back to sleep and be prepared to deliver an new captured audio
   // packet.
-  void ProcessAndEncodeAudio(const AudioFrame& audio_input);
+  void ProcessAndEncodeAudio(std::shared_ptr<const AudioFrame> audio_input);
 
   // This version of ProcessAndEncodeAudio() is used by PushCaptureData() in
   // VoEBase and the audio in |audio_data| has not been subject to any APM
   // processing. Some extra steps are therfore needed when building up the
   // audio frame copy before using the same task as in the default call to
-  // ProcessAndEncodeAudio(const AudioFrame& audio_input).
+  // ProcessAndEncodeAudio(std::shared_ptr<const AudioFrame> audio_input).
   void ProcessAndEncodeAudio(const int16_t* audio_data,
                              int sample_rate,
                              size_t number_of_frames,
@@ -391,6 +394,14 @@ class Channel
   // Disassociate a send channel if it was associated.
   void DisassociateSendChannel(int channel_id);
 
+  // Makes this channel send the encoded output of |source| with its own
+  // RTP/RTCP module instead of encoding the same audio again; a null |source|
+  // makes it encode its own audio again. Both channels must have the same send
+  // codec, and packets are only forwarded while both are sending. A channel
+  // that is a source can't be forwarded itself and vice versa. Returns false
+  // if the channels can't share an encoder.
+  bool SetEncodeFanoutSource(const ChannelOwner& source);
+
   // Set a RtcEventLog logging object.
   void SetRtcEventLog(RtcEventLog* event_log);
 
@@ -450,13 +461,35 @@ class Channel
   // Called on the encoder task queue when a new input audio frame is ready
   // for encoding.
   void ProcessAndEncodeAudioOnTaskQueue(AudioFrame* audio_input);
+  // Same as above, for a frame shared with other channels.
+  void ProcessAndEncodeAudioOnTaskQueue(const AudioFrame& shared_audio_input);
+
+  // Packetizes an encoded frame from the encode fanout source, together with
+  // the audio level it measured.
+  void SendFanoutData(FrameType frame_type,
+                      uint8_t payload_type,
+                      uint32_t timestamp,
+                      const uint8_t* payload_data,
+                      size_t payload_size,
+                      const RTPFragmentationHeader* fragmentation,
+                      int audio_level);
+  // Sends an encoded frame with the RTP/RTCP module.
+  int32_t SendEncodedData(FrameType frame_type,
+                          uint8_t payload_type,
+                          uint32_t timestamp,
+                          const uint8_t* payload_data,
+                          size_t payload_size,
+                          const RTPFragmentationHeader* fragmentation,
+                          int audio_level);
+  bool AddFanoutChannel(Channel* channel);
+  void RemoveFanoutChannel(Channel* channel);
+  bool HasEncodeFanoutSource() const;
 
   uint32_t _instanceId;
   int32_t _channelId;
 
   rtc::CriticalSection _fileCritSect;
   rtc::CriticalSection _callbackCritSect;
-  rtc::CriticalSection volume_settings_critsect_;
 
   ChannelState channel_state_;
 
@@ -472,7 +505,9 @@ class Channel
   std::unique_ptr<AudioCodingModule> audio_coding_;
   acm2::CodecManager codec_manager_;
   acm2::RentACodec rent_a_codec_;
-  std::unique_ptr<AudioSinkInterface> audio_sink_;
+  // Only tried by the playout, so that SetSink() never blocks it.
+  rtc::CriticalSection audio_sink_lock_;
+  std::unique_ptr<AudioSinkInterface> audio_sink_ GUARDED_BY(audio_sink_lock_);
   AudioLevel _outputAudioLevel;
   bool _externalTransport;
   // Downsamples to the codec rate if necessary.
@@ -485,6 +520,9 @@ class Channel
   int _outputFileRecorderId;
   bool _outputFileRecording;
   uint32_t _timeStamp ACCESS_ON(encoder_queue_);
+  // The copy of the shared frames given to ProcessAndEncodeAudio(), reused
+  // for every frame.
+  AudioFrame shared_input_copy_ ACCESS_ON(encoder_queue_);
 
   RemoteNtpTimeEstimator ntp_estimator_ GUARDED_BY(ts_stats_lock_);
 
@@ -497,6 +535,8 @@ class Channel
   uint16_t send_sequence_number_;
   uint8_t restored_packet_[kVoiceEngineMaxIpPacketSizeBytes];
 
+  // Only tried by the playout, which falls back to the capture start of the
+  // previous frames while the estimator is updated.
   rtc::CriticalSection ts_stats_lock_;
 
   std::unique_ptr<rtc::TimestampWrapAroundHandler> rtp_ts_wraparound_handler_;
@@ -504,7 +544,7 @@ class Channel
   int64_t capture_start_rtp_time_stamp_;
   // The capture ntp time (in local timebase) of the first played out audio
   // frame.
-  int64_t capture_start_ntp_time_ms_ GUARDED_BY(ts_stats_lock_);
+  std::atomic<int64_t> capture_start_ntp_time_ms_;
 
   // uses
   Statistics* _engineStatisticsPtr;
@@ -515,9 +555,10 @@ class Channel
   rtc::CriticalSection* _callbackCritSectPtr;    // owned by base
   Transport* _transportPtr;  // WebRtc socket or external transport
   RmsLevel rms_level_ ACCESS_ON(encoder_queue_);
-  bool input_mute_ GUARDED_BY(volume_settings_critsect_);
+  // Set on the worker thread, read by the capture and playout.
+  std::atomic<bool> input_mute_;
   bool previous_frame_muted_ ACCESS_ON(encoder_queue_);
-  float _outputGain GUARDED_BY(volume_settings_critsect_);
+  std::atomic<float> _outputGain;
   // VoEBase
   bool _mixFileWithMicrophone;
   // VoeRTP_RTCP
@@ -536,6 +577,11 @@ class Channel
   // An associated send channel.
   rtc::CriticalSection assoc_send_channel_lock_;
   ChannelOwner associate_send_channel_ GUARDED_BY(assoc_send_channel_lock_);
+  // The channel whose encoded output this channel sends, and the channels
+  // that send the encoded output of this channel.
+  rtc::CriticalSection fanout_lock_;
+  ChannelOwner fanout_source_ GUARDED_BY(fanout_lock_);
+  std::vector<Channel*> fanout_channels_ GUARDED_BY(fanout_lock_);
 
   bool pacing_enabled_;
   PacketRouter* packet_router_ = nullptr;
@@ -280,6 +280,12 @@ void ChannelProxy::DisassociateSendChannel() {
   channel()->set_associate_send_channel(ChannelOwner(nullptr));
 }
 
+bool ChannelProxy::SetEncodeFanoutSource(const ChannelProxy* source) {
+  RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  return channel()->SetEncodeFanoutSource(
+      source ? source->channel_owner_ : ChannelOwner(nullptr));
+}
+
 void ChannelProxy::GetRtpRtcp(RtpRtcp** rtp_rtcp,
                               RtpReceiver** rtp_receiver) const {
   RTC_DCHECK(module_process_thread_checker_.CalledOnValidThread());
@@ -114,6 +114,7 @@ class ChannelProxy : public RtpPacketSinkInterface {
   virtual void SetTransportOverhead(int transport_overhead_per_packet);
   virtual void AssociateSendChannel(const ChannelProxy& send_channel_proxy);
   virtual void DisassociateSendChannel();
+  virtual bool SetEncodeFanoutSource(const ChannelProxy* source);
   virtual void GetRtpRtcp(RtpRtcp** rtp_rtcp,
                           RtpReceiver** rtp_receiver) const;
   virtual uint32_t GetPlayoutTimestamp() const;
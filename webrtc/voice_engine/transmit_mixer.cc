@@ -321,12 +321,44 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
 
 void TransmitMixer::ProcessAndEncodeAudio() {
   RTC_DCHECK_GT(_audioFrame.samples_per_channel_, 0);
+  // The frames handed to the channels, by sample rate and number of channels.
+  std::map<std::pair<int, size_t>, std::shared_ptr<const AudioFrame>>
+      send_frames;
   for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
        it.Increment()) {
     Channel* const channel = it.GetChannel();
-    if (channel->Sending()) {
-      channel->ProcessAndEncodeAudio(_audioFrame);
+    if (!channel->Sending())
+      continue;
+    std::pair<int, size_t> format(_audioFrame.sample_rate_hz_,
+                                  _audioFrame.num_channels_);
+    CodecInst codec;
+    // TODO(ossu): Investigate how this could happen. b/62909493
+    if (channel->GetSendCodec(codec) == 0) {
+      format.first = std::min(codec.plfreq, _audioFrame.sample_rate_hz_);
+      format.second = std::min(codec.channels, _audioFrame.num_channels_);
+    } else {
+      LOG(LS_WARNING) << "Unable to get send codec for channel "
+                      << channel->ChannelId();
+      RTC_NOTREACHED();
+    }
+    std::shared_ptr<const AudioFrame>& send_frame = send_frames[format];
+    if (!send_frame) {
+      std::shared_ptr<AudioFrame> frame = std::make_shared<AudioFrame>();
+      if (format.first == _audioFrame.sample_rate_hz_ &&
+          format.second == _audioFrame.num_channels_) {
+        frame->CopyFrom(_audioFrame);
+      } else {
+        std::unique_ptr<PushResampler<int16_t>>& resampler =
+            send_resamplers_[format];
+        if (!resampler)
+          resampler.reset(new PushResampler<int16_t>());
+        frame->sample_rate_hz_ = format.first;
+        frame->num_channels_ = format.second;
+        RemixAndResample(_audioFrame, resampler.get(), frame.get());
+      }
+      send_frame = std::move(frame);
     }
+    channel->ProcessAndEncodeAudio(send_frame);
   }
 }
 
@@ -11,7 +11,9 @@
 #ifndef WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 #define WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 
+#include <map>
 #include <memory>
+#include <utility>
 
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/common_types.h"
@@ -63,6 +65,9 @@ public:
                          uint16_t currentMicLevel,
                          bool keyPressed);
 
+    // Hands the processed frame to the sending channels, resampled to the
+    // rate and number of channels of their send codec, once for all the
+    // channels sending with the same ones.
     void ProcessAndEncodeAudio();
 
     // Must be called on the same thread as PrepareDemux().
@@ -187,6 +192,9 @@ private:
     // owns
     AudioFrame _audioFrame;
     PushResampler<int16_t> resampler_;  // ADM sample rate -> mixing rate
+    // Mixing rate -> send codec rates, by sample rate and number of channels.
+    std::map<std::pair<int, size_t>, std::unique_ptr<PushResampler<int16_t>>>
+        send_resamplers_;
     std::unique_ptr<FilePlayer> file_player_;
     std::unique_ptr<FileRecorder> file_recorder_;
     std::unique_ptr<FileRecorder> file_call_recorder_;